@@ -391,12 +391,16 @@
         'cancelable_callback_unittest.cc',
         'command_line_unittest.cc',
         'containers/adapters_unittest.cc',
+        'containers/flat_hash_map_unittest.cc',
+        'containers/flat_map_unittest.cc',
+        'containers/flat_set_unittest.cc',
         'containers/hash_tables_unittest.cc',
         'containers/linked_list_unittest.cc',
         'containers/mru_cache_unittest.cc',
         'containers/scoped_ptr_hash_map_unittest.cc',
         'containers/small_map_unittest.cc',
         'containers/stack_container_unittest.cc',
+        'containers/timer_wheel_unittest.cc',
         'cpu_unittest.cc',
         'debug/crash_logging_unittest.cc',
         'debug/debugger_unittest.cc',
@@ -435,11 +439,14 @@
         'i18n/time_formatting_unittest.cc',
         'i18n/timezone_unittest.cc',
         'id_map_unittest.cc',
+        'inline_closure_unittest.cc',
         'ios/crb_protocol_observers_unittest.mm',
         'ios/device_util_unittest.mm',
         'ios/weak_nsobject_unittest.mm',
+        'json/json_document_unittest.cc',
         'json/json_parser_unittest.cc',
         'json/json_reader_unittest.cc',
+        'json/json_string_scan_unittest.cc',
         'json/json_value_converter_unittest.cc',
         'json/json_value_serializer_unittest.cc',
         'json/json_writer_unittest.cc',
@@ -465,6 +472,7 @@
         'memory/memory_pressure_monitor_chromeos_unittest.cc',
         'memory/memory_pressure_monitor_mac_unittest.cc',
         'memory/memory_pressure_monitor_win_unittest.cc',
+        'memory/memory_purge_coordinator_unittest.cc',
         'memory/ptr_util_unittest.cc',
         'memory/ref_counted_memory_unittest.cc',
         'memory/ref_counted_unittest.cc',
@@ -473,8 +481,11 @@
         'memory/shared_memory_unittest.cc',
         'memory/shared_memory_win_unittest.cc',
         'memory/singleton_unittest.cc',
+        'memory/task_node_allocator_unittest.cc',
         'memory/weak_ptr_unittest.cc',
         'memory/weak_ptr_unittest.nc',
+        'message_loop/delayed_work_queue_unittest.cc',
+        'message_loop/lock_free_task_queue_unittest.cc',
         'message_loop/message_loop_task_runner_unittest.cc',
         'message_loop/message_loop_unittest.cc',
         'message_loop/message_pump_glib_unittest.cc',
@@ -522,6 +533,7 @@
         'security_unittest.cc',
         'sequence_checker_unittest.cc',
         'sha1_unittest.cc',
+        'startup_snapshot_unittest.cc',
         'stl_util_unittest.cc',
         'strings/nullable_string16_unittest.cc',
         'strings/pattern_unittest.cc',
@@ -549,9 +561,12 @@
         'sys_info_unittest.cc',
         'system_monitor/system_monitor_unittest.cc',
         'task/cancelable_task_tracker_unittest.cc',
+        'task/task_coroutine_unittest.cc',
         'task_runner_util_unittest.cc',
+        'task_scheduler/boostable_thread_priority_unittest.cc',
         'task_scheduler/delayed_task_manager_unittest.cc',
         'task_scheduler/priority_queue_unittest.cc',
+        'task_scheduler/scheduler_affinity_policy_unittest.cc',
         'task_scheduler/scheduler_lock_unittest.cc',
         'task_scheduler/scheduler_service_thread_unittest.cc',
         'task_scheduler/scheduler_thread_pool_impl_unittest.cc',
@@ -572,6 +587,7 @@
         'test/user_action_tester_unittest.cc',
         'threading/non_thread_safe_unittest.cc',
         'threading/platform_thread_unittest.cc',
+        'threading/scoped_blocking_call_unittest.cc',
         'threading/sequenced_worker_pool_unittest.cc',
         'threading/sequenced_task_runner_handle_unittest.cc',
         'threading/simple_thread_unittest.cc',
@@ -793,9 +809,21 @@
         '../testing/gtest.gyp:gtest',
       ],
       'sources': [
+        'callback_perftest.cc',
+        'containers/flat_map_perftest.cc',
+        'containers/hash_tables_perftest.cc',
+        'containers/timer_wheel_perftest.cc',
+        'hash_perftest.cc',
+        'inline_closure_perftest.cc',
+        'json/json_perftest.cc',
         'message_loop/message_pump_perftest.cc',
+        'pickle_perftest.cc',
+        'strings/stringprintf_perftest.cc',
+        'task/task_coroutine_perftest.cc',
         'test/run_all_unittests.cc',
+        'threading/thread_local_storage_perftest.cc',
         'threading/thread_perftest.cc',
+        'values_perftest.cc',
         '../testing/perf/perf_test.cc'
       ],
       'conditions': [
@@ -24,6 +24,11 @@ const char kEnableHeapProfiling[]           = "enable-heap-profiling";
 // derived from trace events are reported.
 const char kEnableHeapProfilingModeNative[] = "native";
 
+// Report pseudo stacks for a sample of the allocations, one every 128 KiB
+// allocated on average, and scale the reported totals accordingly. This is
+// cheap enough to leave on.
+const char kEnableHeapProfilingModeSampled[] = "sampled";
+
 // Generates full memory crash dump.
 const char kFullMemoryCrashReport[]         = "full-memory-crash-report";
 
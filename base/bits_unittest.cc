@@ -61,5 +61,14 @@ TEST(BitsTest, Align) {
   EXPECT_EQ(kSizeTMax / 2 + 1, Align(1, kSizeTMax / 2 + 1));
 }
 
+TEST(BitsTest, CountTrailingZeroBits) {
+  EXPECT_EQ(0, CountTrailingZeroBits(1u));
+  EXPECT_EQ(0, CountTrailingZeroBits(0xffffffffu));
+  EXPECT_EQ(4, CountTrailingZeroBits(0x30u));
+  EXPECT_EQ(31, CountTrailingZeroBits(0x80000000u));
+  for (int i = 0; i < 32; ++i)
+    EXPECT_EQ(i, CountTrailingZeroBits(1u << i));
+}
+
 }  // namespace bits
 }  // namespace base
@@ -0,0 +1,96 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumCalls = 1000000;
+
+int Add(int a, int b) {
+  return a + b;
+}
+
+class Receiver : public RefCounted<Receiver> {
+ public:
+  Receiver() : sum_(0) {}
+
+  void Accumulate(int value) { sum_ += value; }
+
+  int sum() const { return sum_; }
+
+ private:
+  friend class RefCounted<Receiver>;
+  ~Receiver() {}
+
+  int sum_;
+};
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 TimeDelta elapsed) {
+  perf_test::PrintResult(measurement, "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / kNumCalls,
+                         "ns/call", true);
+}
+
+}  // namespace
+
+// The cost of running a callback, without binding it.
+TEST(CallbackPerfTest, Run) {
+  const Callback<int(int)> add_one = Bind(&Add, 1);
+  int sum = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    sum = add_one.Run(sum);
+  PrintResult("run", "bound_int", TimeTicks::Now() - start);
+  EXPECT_EQ(kNumCalls, sum);
+}
+
+// The cost of binding a callback, which allocates its BindState, running it
+// once and destroying it: the life of most posted tasks.
+TEST(CallbackPerfTest, BindAndRun) {
+  int sum = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    sum = Bind(&Add, 1, sum).Run();
+  PrintResult("bind_run", "function", TimeTicks::Now() - start);
+  EXPECT_EQ(kNumCalls, sum);
+
+  scoped_refptr<Receiver> receiver(new Receiver);
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    Bind(&Receiver::Accumulate, Unretained(receiver.get()), 1).Run();
+  PrintResult("bind_run", "unretained_method", TimeTicks::Now() - start);
+  EXPECT_EQ(kNumCalls, receiver->sum());
+
+  // Binding a scoped_refptr adds a reference count round trip.
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    Bind(&Receiver::Accumulate, receiver, 1).Run();
+  PrintResult("bind_run", "refcounted_method", TimeTicks::Now() - start);
+  EXPECT_EQ(2 * kNumCalls, receiver->sum());
+}
+
+// Copying a callback only adds a reference to its BindState.
+TEST(CallbackPerfTest, Copy) {
+  const Callback<int()> callback = Bind(&Add, 1, 2);
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i) {
+    Callback<int()> copy = callback;
+    ASSERT_FALSE(copy.is_null());
+  }
+  PrintResult("copy", "bound_ints", TimeTicks::Now() - start);
+}
+
+}  // namespace base
@@ -0,0 +1,536 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_MAP_H_
+#define BASE_CONTAINERS_FLAT_HASH_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/containers/hash_tables.h"
+#include "base/logging.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace base {
+
+namespace internal {
+
+// Each slot of a flat_hash_map has a control byte. Full slots store 7 bits of
+// the hash of their key (see HashGroup), which are non-negative; the other
+// states are negative.
+enum : int8_t {
+  kHashCtrlEmpty = -128,
+  kHashCtrlDeleted = -2,
+  // Follows the last slot, to stop iteration.
+  kHashCtrlSentinel = -1,
+};
+
+// A group of kWidth consecutive control bytes, which is probed as a whole.
+// With SSE2 each query is a couple of instructions.
+class HashGroup {
+ public:
+  static const size_t kWidth = 16;
+
+  explicit HashGroup(const int8_t* ctrl) {
+#if defined(ARCH_CPU_X86_FAMILY)
+    ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+    memcpy(ctrl_, ctrl, kWidth);
+#endif
+  }
+
+  // Each of these returns a mask with bit i set iff control byte i matches.
+
+  uint32_t Match(int8_t h2) const {
+#if defined(ARCH_CPU_X86_FAMILY)
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+    return MatchIf([h2](int8_t ctrl) { return ctrl == h2; });
+#endif
+  }
+
+  uint32_t MatchEmpty() const { return Match(kHashCtrlEmpty); }
+
+  uint32_t MatchEmptyOrDeleted() const {
+#if defined(ARCH_CPU_X86_FAMILY)
+    // Empty and deleted are the only states below the sentinel.
+    return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(kHashCtrlSentinel), ctrl_)));
+#else
+    return MatchIf(
+        [](int8_t ctrl) { return ctrl < kHashCtrlSentinel; });
+#endif
+  }
+
+ private:
+#if defined(ARCH_CPU_X86_FAMILY)
+  __m128i ctrl_;
+#else
+  template <class Predicate>
+  uint32_t MatchIf(Predicate predicate) const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kWidth; ++i) {
+      if (predicate(ctrl_[i]))
+        mask |= 1u << i;
+    }
+    return mask;
+  }
+
+  int8_t ctrl_[kWidth];
+#endif
+};
+
+}  // namespace internal
+
+// A hash map with open addressing, after the "Swiss table" design: slots live
+// in a flat array next to an array of one control byte per slot. A lookup
+// probes groups of 16 control bytes, compares 7 bits of the hash against all
+// of them at once, and only compares keys for the (usually zero or one)
+// matching slots. Compared to base::hash_map, which allocates a node per value
+// and chases a pointer per bucket, this is faster and smaller for small keys
+// and values.
+//
+// The interface is the subset of std::unordered_map that is commonly used.
+// Differences:
+//  - Growing the table, i.e. inserting, moves the values and invalidates all
+//    iterators, pointers and references. Erasing only invalidates those to the
+//    erased value.
+//  - Keys are copied when the table grows.
+//  - There are no bucket or load factor accessors. The table grows by
+//    doubling when 7/8 of the slots are taken.
+//
+// The order of iteration is unspecified, as for base::hash_map.
+template <class Key,
+          class T,
+          class Hash = BASE_HASH_NAMESPACE::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+ private:
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  flat_hash_map() = default;
+
+  flat_hash_map(const flat_hash_map& other)
+      : hash_(other.hash_), key_eq_(other.key_eq_) {
+    reserve(other.size());
+    for (const value_type& value : other)
+      InsertUnique(value);
+  }
+
+  flat_hash_map(flat_hash_map&& other) { swap(other); }
+
+  ~flat_hash_map() {
+    DestroyAll();
+    FreeArrays();
+  }
+
+  flat_hash_map& operator=(const flat_hash_map& other) {
+    if (this != &other) {
+      flat_hash_map copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  flat_hash_map& operator=(flat_hash_map&& other) {
+    flat_hash_map moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  // Iterators -----------------------------------------------------------------
+
+  iterator begin() { return MakeIterator(FirstFull()); }
+  const_iterator begin() const { return MakeIterator(FirstFull()); }
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return MakeIterator(capacity_); }
+  const_iterator end() const { return MakeIterator(capacity_); }
+  const_iterator cend() const { return end(); }
+
+  // Capacity ------------------------------------------------------------------
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  // Returns the number of slots, i.e. the size the table can grow to without
+  // rehashing is 7/8 of it.
+  size_type capacity() const { return capacity_; }
+
+  // Makes room for |count| values without rehashing.
+  void reserve(size_type count) {
+    if (count <= MaxLoad(capacity_))
+      return;
+    size_t capacity = internal::HashGroup::kWidth;
+    while (MaxLoad(capacity) < count)
+      capacity *= 2;
+    Resize(capacity);
+  }
+
+  // Modifiers -----------------------------------------------------------------
+
+  // Destroys all the values but keeps the capacity.
+  void clear() {
+    DestroyAll();
+    if (capacity_)
+      ResetCtrl();
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return InsertKey(value.first, value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return InsertKey(value.first, std::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  // Returns the iterator following |position|.
+  iterator erase(const_iterator position) {
+    const size_t index = position.slot_ - slots_;
+    EraseAt(index);
+    return MakeIterator(NextFull(index));
+  }
+
+  iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+  size_type erase(const key_type& key) {
+    const size_t index = FindIndex(key);
+    if (index == capacity_)
+      return 0;
+    EraseAt(index);
+    return 1;
+  }
+
+  void swap(flat_hash_map& other) {
+    using std::swap;
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+    swap(hash_, other.hash_);
+    swap(key_eq_, other.key_eq_);
+  }
+
+  // Lookup --------------------------------------------------------------------
+
+  mapped_type& operator[](const key_type& key) {
+    return InsertKey(key, std::piecewise_construct, std::forward_as_tuple(key),
+                     std::tuple<>())
+        .first->second;
+  }
+
+  mapped_type& at(const key_type& key) {
+    const size_t index = FindIndex(key);
+    CHECK_NE(index, capacity_);
+    return slots_[index].second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    const size_t index = FindIndex(key);
+    CHECK_NE(index, capacity_);
+    return slots_[index].second;
+  }
+
+  size_type count(const key_type& key) const {
+    return FindIndex(key) == capacity_ ? 0 : 1;
+  }
+
+  iterator find(const key_type& key) { return MakeIterator(FindIndex(key)); }
+
+  const_iterator find(const key_type& key) const {
+    return MakeIterator(FindIndex(key));
+  }
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return key_eq_; }
+
+  friend void swap(flat_hash_map& lhs, flat_hash_map& rhs) { lhs.swap(rhs); }
+
+ private:
+  template <bool kIsConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename flat_hash_map::value_type;
+    using difference_type = ptrdiff_t;
+    using reference = typename std::
+        conditional<kIsConst, const value_type&, value_type&>::type;
+    using pointer = typename std::
+        conditional<kIsConst, const value_type*, value_type*>::type;
+
+    Iterator() : ctrl_(nullptr), slot_(nullptr) {}
+
+    // Allows converting an iterator to a const_iterator.
+    Iterator(const Iterator<false>& other)
+        : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    Iterator& operator++() {
+      do {
+        ++ctrl_;
+        ++slot_;
+      } while (*ctrl_ < internal::kHashCtrlSentinel);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return ctrl_ == other.ctrl_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return ctrl_ != other.ctrl_;
+    }
+
+   private:
+    friend class flat_hash_map;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(const int8_t* ctrl, pointer slot) : ctrl_(ctrl), slot_(slot) {}
+
+    const int8_t* ctrl_;
+    pointer slot_;
+  };
+
+  // Returns the most a table of |capacity| slots holds before it grows.
+  static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+  // Spreads the bits of the hash, since std::hash is the identity for
+  // integers. Slots are picked with the low bits and the control byte is the
+  // top 7 bits.
+  uint64_t HashOf(const key_type& key) const {
+    const uint64_t product =
+        static_cast<uint64_t>(hash_(key)) * UINT64_C(0x9E3779B97F4A7C15);
+    return product ^ (product >> 32);
+  }
+
+  static int8_t H2(uint64_t hash) { return static_cast<int8_t>(hash >> 57); }
+
+  iterator MakeIterator(size_t index) {
+    return iterator(ctrl_ + index, slots_ + index);
+  }
+
+  const_iterator MakeIterator(size_t index) const {
+    return const_iterator(ctrl_ + index, slots_ + index);
+  }
+
+  size_t FirstFull() const {
+    return capacity_ && ctrl_[0] < 0 ? NextFull(0) : 0;
+  }
+
+  // Returns the index of the first full slot after |index|, or |capacity_|.
+  size_t NextFull(size_t index) const {
+    do {
+      ++index;
+    } while (ctrl_[index] < internal::kHashCtrlSentinel);
+    return index;
+  }
+
+  // Returns the index of the value for |key|, or |capacity_|.
+  size_t FindIndex(const key_type& key) const {
+    if (!capacity_)
+      return 0;
+    const uint64_t hash = HashOf(key);
+    const int8_t h2 = H2(hash);
+    const size_t group_mask = capacity_ / internal::HashGroup::kWidth - 1;
+    size_t group = static_cast<size_t>(hash) & group_mask;
+    // Triangular probing visits each group once, since there's a power of two
+    // of them.
+    for (size_t step = 1;; ++step) {
+      const size_t offset = group * internal::HashGroup::kWidth;
+      internal::HashGroup probe(ctrl_ + offset);
+      for (uint32_t match = probe.Match(h2); match; match &= match - 1) {
+        const size_t index = offset + bits::CountTrailingZeroBits(match);
+        if (key_eq_(slots_[index].first, key))
+          return index;
+      }
+      // There's always an empty slot, since the table grows before filling.
+      if (probe.MatchEmpty())
+        return capacity_;
+      group = (group + step) & group_mask;
+    }
+  }
+
+  // Returns the first empty or deleted slot on the probe sequence of |hash|.
+  size_t FindFirstNonFull(uint64_t hash) const {
+    const size_t group_mask = capacity_ / internal::HashGroup::kWidth - 1;
+    size_t group = static_cast<size_t>(hash) & group_mask;
+    for (size_t step = 1;; ++step) {
+      const size_t offset = group * internal::HashGroup::kWidth;
+      const uint32_t mask =
+          internal::HashGroup(ctrl_ + offset).MatchEmptyOrDeleted();
+      if (mask)
+        return offset + bits::CountTrailingZeroBits(mask);
+      group = (group + step) & group_mask;
+    }
+  }
+
+  // Inserts the value constructed from |args| unless there already is one for
+  // |key|.
+  template <class... Args>
+  std::pair<iterator, bool> InsertKey(const key_type& key, Args&&... args) {
+    const size_t found = FindIndex(key);
+    if (found != capacity_)
+      return std::make_pair(MakeIterator(found), false);
+    const size_t index = PrepareInsert(HashOf(key));
+    new (slots_ + index) value_type(std::forward<Args>(args)...);
+    return std::make_pair(MakeIterator(index), true);
+  }
+
+  // Inserts |value| without looking for an existing value with its key.
+  void InsertUnique(const value_type& value) {
+    const size_t index = PrepareInsert(HashOf(value.first));
+    new (slots_ + index) value_type(value);
+  }
+
+  // Marks a slot for a value with |hash| as full and returns it, growing or
+  // cleaning up the table first if needed.
+  size_t PrepareInsert(uint64_t hash) {
+    if (!growth_left_) {
+      if (!capacity_)
+        Resize(internal::HashGroup::kWidth);
+      else if (size_ <= MaxLoad(capacity_) / 2)
+        Resize(capacity_);  // Mostly deleted slots.
+      else
+        Resize(capacity_ * 2);
+    }
+    const size_t index = FindFirstNonFull(hash);
+    if (ctrl_[index] == internal::kHashCtrlEmpty)
+      --growth_left_;
+    ctrl_[index] = H2(hash);
+    ++size_;
+    return index;
+  }
+
+  void EraseAt(size_t index) {
+    slots_[index].~value_type();
+    --size_;
+    // Lookups stop at the first group with an empty slot, so the slot can
+    // only become empty again if its group already has one.
+    const size_t offset = index & ~(internal::HashGroup::kWidth - 1);
+    if (internal::HashGroup(ctrl_ + offset).MatchEmpty()) {
+      ctrl_[index] = internal::kHashCtrlEmpty;
+      ++growth_left_;
+    } else {
+      ctrl_[index] = internal::kHashCtrlDeleted;
+    }
+  }
+
+  // Moves the values to new arrays of |new_capacity| slots, which drops the
+  // deleted slots.
+  void Resize(size_t new_capacity) {
+    DCHECK_GE(MaxLoad(new_capacity), size_);
+    int8_t* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    const size_t old_capacity = capacity_;
+
+    ctrl_ = new int8_t[new_capacity + 1];
+    slots_ = static_cast<value_type*>(
+        ::operator new(new_capacity * sizeof(value_type)));
+    capacity_ = new_capacity;
+    ResetCtrl();
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] < 0)
+        continue;
+      const uint64_t hash = HashOf(old_slots[i].first);
+      const size_t index = FindFirstNonFull(hash);
+      ctrl_[index] = H2(hash);
+      new (slots_ + index) value_type(std::move(old_slots[i]));
+      old_slots[i].~value_type();
+    }
+    growth_left_ -= size_;
+
+    delete[] old_ctrl;
+    ::operator delete(old_slots);
+  }
+
+  // Marks all the slots empty.
+  void ResetCtrl() {
+    memset(ctrl_, internal::kHashCtrlEmpty, capacity_);
+    ctrl_[capacity_] = internal::kHashCtrlSentinel;
+    growth_left_ = MaxLoad(capacity_);
+  }
+
+  void DestroyAll() {
+    for (size_t i = 0; i < capacity_ && size_; ++i) {
+      if (ctrl_[i] >= 0) {
+        slots_[i].~value_type();
+        --size_;
+      }
+    }
+  }
+
+  void FreeArrays() {
+    delete[] ctrl_;
+    ::operator delete(slots_);
+  }
+
+  // |capacity_| control bytes followed by a sentinel, or null.
+  int8_t* ctrl_ = nullptr;
+  value_type* slots_ = nullptr;
+
+  // The number of slots, a power of two and a multiple of the group width.
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+
+  // The number of empty slots that can be filled before the table grows.
+  size_t growth_left_ = 0;
+
+  hasher hash_;
+  key_equal key_eq_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_MAP_H_
@@ -0,0 +1,170 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_map.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Sends all keys to the same group, to exercise probing.
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+}  // namespace
+
+TEST(FlatHashMapTest, Basic) {
+  flat_hash_map<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_EQ(0u, map.erase(1));
+
+  EXPECT_TRUE(map.insert(std::make_pair(1, std::string("one"))).second);
+  EXPECT_TRUE(map.emplace(2, "two").second);
+  map[3] = "three";
+  std::pair<flat_hash_map<int, std::string>::iterator, bool> result =
+      map.emplace(2, "deux");
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("two", result.first->second);
+
+  EXPECT_EQ(3u, map.size());
+  EXPECT_EQ("one", map.find(1)->second);
+  EXPECT_EQ("three", map.at(3));
+  EXPECT_EQ(1u, map.count(2));
+  EXPECT_EQ(0u, map.count(4));
+
+  EXPECT_EQ(1u, map.erase(2));
+  EXPECT_EQ(map.end(), map.find(2));
+  EXPECT_EQ(2u, map.size());
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_LT(0u, map.capacity());
+}
+
+TEST(FlatHashMapTest, Iteration) {
+  flat_hash_map<int, int> map;
+  for (int i = 0; i < 100; ++i)
+    map[i] = i * 2;
+
+  int sum = 0;
+  size_t count = 0;
+  for (const auto& pair : map) {
+    EXPECT_EQ(pair.first * 2, pair.second);
+    sum += pair.first;
+    ++count;
+  }
+  EXPECT_EQ(100u, count);
+  EXPECT_EQ(4950, sum);
+
+  // Erasing while iterating, like with std::unordered_map.
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 2)
+      it = map.erase(it);
+    else
+      ++it;
+  }
+  EXPECT_EQ(50u, map.size());
+  for (const auto& pair : map)
+    EXPECT_EQ(0, pair.first % 2);
+
+  const flat_hash_map<int, int>& const_map = map;
+  flat_hash_map<int, int>::const_iterator it = const_map.find(4);
+  ASSERT_NE(const_map.end(), it);
+  EXPECT_EQ(8, it->second);
+}
+
+TEST(FlatHashMapTest, Collisions) {
+  flat_hash_map<int, int, CollidingHash> map;
+  for (int i = 0; i < 200; ++i)
+    EXPECT_TRUE(map.emplace(i, i).second);
+  for (int i = 0; i < 200; i += 3)
+    EXPECT_EQ(1u, map.erase(i));
+  for (int i = 0; i < 200; ++i)
+    EXPECT_EQ(i % 3 ? 1u : 0u, map.count(i)) << i;
+}
+
+// Compares against std::map under random inserts and erases, which also
+// exercises the reuse of deleted slots and the rehashing in place.
+TEST(FlatHashMapTest, MatchesStdMap) {
+  flat_hash_map<uint64_t, uint64_t> map;
+  std::map<uint64_t, uint64_t> reference;
+  for (int i = 0; i < 20000; ++i) {
+    const uint64_t key = RandGenerator(500);
+    if (RandGenerator(3)) {
+      map[key] = i;
+      reference[key] = i;
+    } else {
+      EXPECT_EQ(reference.erase(key), map.erase(key));
+    }
+    ASSERT_EQ(reference.size(), map.size());
+  }
+  for (const auto& pair : reference)
+    EXPECT_EQ(pair.second, map.at(pair.first));
+  size_t count = 0;
+  for (const auto& pair : map) {
+    EXPECT_EQ(reference[pair.first], pair.second);
+    ++count;
+  }
+  EXPECT_EQ(reference.size(), count);
+}
+
+TEST(FlatHashMapTest, Reserve) {
+  flat_hash_map<int, int> map;
+  map.reserve(0);
+  EXPECT_EQ(0u, map.capacity());
+  map.reserve(100);
+  const size_t capacity = map.capacity();
+  EXPECT_LE(100u, capacity - capacity / 8);
+  for (int i = 0; i < 100; ++i)
+    map[i] = i;
+  EXPECT_EQ(capacity, map.capacity());
+}
+
+TEST(FlatHashMapTest, CopyAndMove) {
+  flat_hash_map<std::string, std::unique_ptr<int>> move_only;
+  move_only.emplace("a", std::unique_ptr<int>(new int(1)));
+  flat_hash_map<std::string, std::unique_ptr<int>> moved(std::move(move_only));
+  EXPECT_TRUE(move_only.empty());
+  EXPECT_EQ(1, *moved.at("a"));
+  for (int i = 0; i < 50; ++i)
+    moved.emplace(IntToString(i), std::unique_ptr<int>(new int(i)));
+  EXPECT_EQ(51u, moved.size());
+  EXPECT_EQ(42, *moved.at("42"));
+
+  flat_hash_map<std::string, int> map;
+  for (int i = 0; i < 50; ++i)
+    map[IntToString(i)] = i;
+  flat_hash_map<std::string, int> copy(map);
+  EXPECT_EQ(50u, copy.size());
+  EXPECT_EQ(7, copy.at("7"));
+
+  flat_hash_map<std::string, int> assigned;
+  assigned["x"] = 1;
+  assigned = copy;
+  EXPECT_EQ(50u, assigned.size());
+  EXPECT_EQ(0u, assigned.count("x"));
+
+  flat_hash_map<std::string, int> empty;
+  swap(empty, assigned);
+  EXPECT_TRUE(assigned.empty());
+  EXPECT_EQ(50u, empty.size());
+}
+
+}  // namespace base
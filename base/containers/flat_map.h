@@ -0,0 +1,141 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_MAP_H_
+#define BASE_CONTAINERS_FLAT_MAP_H_
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_tree.h"
+#include "base/logging.h"
+
+namespace base {
+
+namespace internal {
+
+template <class Key, class Mapped>
+struct GetKeyFromValuePairFirst {
+  const Key& operator()(const std::pair<Key, Mapped>& p) const {
+    return p.first;
+  }
+};
+
+}  // namespace internal
+
+// A std::map look-alike that keeps its key/value pairs sorted in a single
+// std::vector. See flat_set.h for when a flat container beats std::map; the
+// same trade-offs apply.
+//
+// Differences from std::map:
+//  - value_type is std::pair<Key, Mapped>, not std::pair<const Key, Mapped>,
+//    since the values have to be movable. Don't modify keys through
+//    iterators.
+//  - Any insertion or erasure, including operator[] for a missing key,
+//    invalidates iterators and references.
+//  - reserve(), capacity(), shrink_to_fit() and a constructor that adopts a
+//    std::vector of pairs are available.
+//
+// SMALL MAPS
+// ----------
+//
+// flat_map can back a SmallMap, which keeps up to N pairs inline in the
+// object and only allocates the vector once it outgrows them:
+//
+//   base::SmallMap<base::flat_map<std::string, int>, 4> map;
+//
+// This combination suits maps that are usually tiny but occasionally large.
+template <class Key, class Mapped, class Compare = std::less<Key>>
+class flat_map : public internal::flat_tree<
+                     Key,
+                     std::pair<Key, Mapped>,
+                     internal::GetKeyFromValuePairFirst<Key, Mapped>,
+                     Compare> {
+ private:
+  using tree = internal::flat_tree<
+      Key,
+      std::pair<Key, Mapped>,
+      internal::GetKeyFromValuePairFirst<Key, Mapped>,
+      Compare>;
+
+ public:
+  using key_type = typename tree::key_type;
+  using mapped_type = Mapped;
+  using value_type = typename tree::value_type;
+  using key_compare = typename tree::key_compare;
+  using iterator = typename tree::iterator;
+  using const_iterator = typename tree::const_iterator;
+
+  flat_map() = default;
+
+  explicit flat_map(const key_compare& comp) : tree(comp) {}
+
+  // Bulk construction sorts in O(N log N). The first of several pairs with
+  // equivalent keys wins.
+  template <class InputIterator>
+  flat_map(InputIterator first,
+           InputIterator last,
+           const key_compare& comp = key_compare())
+      : tree(first, last, comp) {}
+
+  explicit flat_map(std::vector<value_type> items,
+                    const key_compare& comp = key_compare())
+      : tree(std::move(items), comp) {}
+
+  flat_map(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare())
+      : tree(ilist, comp) {}
+
+  flat_map(const flat_map&) = default;
+  flat_map(flat_map&&) = default;
+
+  ~flat_map() = default;
+
+  flat_map& operator=(const flat_map&) = default;
+  flat_map& operator=(flat_map&&) = default;
+
+  flat_map& operator=(std::initializer_list<value_type> ilist) {
+    tree::operator=(ilist);
+    return *this;
+  }
+
+  // Returns the value for |key|, inserting a value-initialized one if there
+  // is none. O(N) when it inserts, O(log N) otherwise.
+  mapped_type& operator[](const key_type& key) {
+    iterator found = tree::lower_bound(key);
+    if (found == tree::end() || tree::key_comp()(key, found->first))
+      found = tree::unsafe_emplace(found, key, mapped_type());
+    return found->second;
+  }
+
+  mapped_type& operator[](key_type&& key) {
+    iterator found = tree::lower_bound(key);
+    if (found == tree::end() || tree::key_comp()(key, found->first))
+      found = tree::unsafe_emplace(found, std::move(key), mapped_type());
+    return found->second;
+  }
+
+  // Returns the value for |key|, which must be in the map.
+  mapped_type& at(const key_type& key) {
+    iterator found = tree::find(key);
+    CHECK(found != tree::end());
+    return found->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    const_iterator found = tree::find(key);
+    CHECK(found != tree::cend());
+    return found->second;
+  }
+
+  void swap(flat_map& other) { tree::swap(other); }
+
+  friend void swap(flat_map& lhs, flat_map& rhs) { lhs.swap(rhs); }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_MAP_H_
@@ -0,0 +1,161 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Map sizes to measure, from a handful of entries to well past the caches of
+// a small core.
+const size_t kSizes[] = {8, 64, 512, 4096, 32768};
+
+// Roughly the number of operations each measurement does, whatever the size.
+const size_t kOperationsPerMeasurement = 2 * 1000 * 1000;
+
+using Pairs = std::vector<std::pair<uint32_t, uint32_t>>;
+
+Pairs MakeShuffledPairs(size_t size) {
+  Pairs pairs;
+  for (size_t i = 0; i < size; ++i)
+    pairs.push_back(std::make_pair(static_cast<uint32_t>(i * 7919),
+                                   static_cast<uint32_t>(i)));
+  std::random_shuffle(pairs.begin(), pairs.end(), RandGenerator);
+  return pairs;
+}
+
+void PrintResult(const std::string& measurement,
+                 size_t size,
+                 TimeDelta elapsed,
+                 size_t num_operations) {
+  perf_test::PrintResult(measurement, "", "size_" + SizeTToString(size),
+                         elapsed.InMillisecondsF() * 1000000 / num_operations,
+                         "ns/op", true);
+}
+
+template <class Map>
+void BuildByInsertion(const Pairs& pairs, Map* map) {
+  for (const auto& pair : pairs)
+    map->insert(pair);
+}
+
+template <class Map>
+uint32_t LookUpAll(const Map& map, const Pairs& pairs) {
+  uint32_t sum = 0;
+  for (const auto& pair : pairs)
+    sum += map.find(pair.first)->second;
+  return sum;
+}
+
+template <class Map>
+uint32_t SumAll(const Map& map) {
+  uint32_t sum = 0;
+  for (const auto& pair : map)
+    sum += pair.second;
+  return sum;
+}
+
+}  // namespace
+
+TEST(FlatMapPerfTest, Build) {
+  for (size_t size : kSizes) {
+    const Pairs pairs = MakeShuffledPairs(size);
+    const size_t rounds = std::max<size_t>(1, kOperationsPerMeasurement / size);
+
+    TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      std::map<uint32_t, uint32_t> map(pairs.begin(), pairs.end());
+      ASSERT_EQ(size, map.size());
+    }
+    PrintResult("build_std_map", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      flat_map<uint32_t, uint32_t> map(pairs.begin(), pairs.end());
+      ASSERT_EQ(size, map.size());
+    }
+    PrintResult("build_flat_map_bulk", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    // Inserting one by one is quadratic, so skip the largest sizes.
+    if (size > 4096)
+      continue;
+    start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      flat_map<uint32_t, uint32_t> map;
+      BuildByInsertion(pairs, &map);
+      ASSERT_EQ(size, map.size());
+    }
+    PrintResult("build_flat_map_insert", size, TimeTicks::Now() - start,
+                rounds * size);
+  }
+}
+
+TEST(FlatMapPerfTest, Lookup) {
+  for (size_t size : kSizes) {
+    const Pairs pairs = MakeShuffledPairs(size);
+    const size_t rounds = std::max<size_t>(1, kOperationsPerMeasurement / size);
+    const std::map<uint32_t, uint32_t> std_map(pairs.begin(), pairs.end());
+    const flat_map<uint32_t, uint32_t> flat(pairs.begin(), pairs.end());
+
+    uint32_t std_sum = 0;
+    TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round)
+      std_sum += LookUpAll(std_map, pairs);
+    PrintResult("lookup_std_map", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    uint32_t flat_sum = 0;
+    start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round)
+      flat_sum += LookUpAll(flat, pairs);
+    PrintResult("lookup_flat_map", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    EXPECT_EQ(std_sum, flat_sum);
+  }
+}
+
+TEST(FlatMapPerfTest, Iterate) {
+  for (size_t size : kSizes) {
+    const Pairs pairs = MakeShuffledPairs(size);
+    const size_t rounds = std::max<size_t>(1, kOperationsPerMeasurement / size);
+    const std::map<uint32_t, uint32_t> std_map(pairs.begin(), pairs.end());
+    const flat_map<uint32_t, uint32_t> flat(pairs.begin(), pairs.end());
+
+    uint32_t std_sum = 0;
+    TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round)
+      std_sum += SumAll(std_map);
+    PrintResult("iterate_std_map", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    uint32_t flat_sum = 0;
+    start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round)
+      flat_sum += SumAll(flat);
+    PrintResult("iterate_flat_map", size, TimeTicks::Now() - start,
+                rounds * size);
+
+    EXPECT_EQ(std_sum, flat_sum);
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,111 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_map.h"
+
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/small_map.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+using IntMap = flat_map<int, int>;
+
+std::vector<std::pair<int, int>> ToVector(const IntMap& map) {
+  return std::vector<std::pair<int, int>>(map.begin(), map.end());
+}
+
+}  // namespace
+
+TEST(FlatMapTest, BulkConstruction) {
+  IntMap map({{3, 30}, {1, 10}, {3, 31}, {2, 20}});
+  EXPECT_EQ((std::vector<std::pair<int, int>>({{1, 10}, {2, 20}, {3, 30}})),
+            ToVector(map));
+
+  std::vector<std::pair<int, int>> pairs = {{2, 1}, {1, 2}};
+  IntMap from_vector(std::move(pairs));
+  EXPECT_EQ((std::vector<std::pair<int, int>>({{1, 2}, {2, 1}})),
+            ToVector(from_vector));
+
+  IntMap from_range(from_vector.rbegin(), from_vector.rend());
+  EXPECT_EQ(from_vector, from_range);
+}
+
+TEST(FlatMapTest, Subscript) {
+  flat_map<std::string, int> map;
+  map["b"] = 2;
+  map["a"] = 1;
+  map["c"];
+  ++map["b"];
+  ASSERT_EQ(3u, map.size());
+  EXPECT_EQ("a", map.begin()->first);
+  EXPECT_EQ(1, map["a"]);
+  EXPECT_EQ(3, map["b"]);
+  EXPECT_EQ(0, map["c"]);
+
+  std::string key("d");
+  map[std::move(key)] = 4;
+  EXPECT_EQ(4, map.at("d"));
+  const flat_map<std::string, int>& const_map = map;
+  EXPECT_EQ(3, const_map.at("b"));
+}
+
+TEST(FlatMapTest, InsertAndFind) {
+  IntMap map;
+  EXPECT_TRUE(map.insert(std::make_pair(2, 20)).second);
+  EXPECT_TRUE(map.emplace(1, 10).second);
+  std::pair<IntMap::iterator, bool> result = map.emplace(2, 21);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(20, result.first->second);
+
+  EXPECT_EQ(10, map.find(1)->second);
+  EXPECT_EQ(map.end(), map.find(3));
+  map.find(1)->second = 11;
+  EXPECT_EQ(11, map.at(1));
+
+  EXPECT_EQ(1u, map.erase(1));
+  EXPECT_EQ((std::vector<std::pair<int, int>>({{2, 20}})), ToVector(map));
+}
+
+TEST(FlatMapTest, InsertRange) {
+  IntMap map({{1, 1}, {4, 4}});
+  const std::pair<int, int> kInput[] = {{3, 3}, {4, 5}, {2, 2}, {3, 6}};
+  map.insert(std::begin(kInput), std::end(kInput));
+  EXPECT_EQ(
+      (std::vector<std::pair<int, int>>({{1, 1}, {2, 2}, {3, 3}, {4, 4}})),
+      ToVector(map));
+}
+
+// SmallMap keeps the first few pairs inline and falls back to the flat_map
+// once it grows.
+TEST(FlatMapTest, BacksSmallMap) {
+  SmallMap<flat_map<int, int>, 2> map;
+  map[3] = 30;
+  map[1] = 10;
+  EXPECT_FALSE(map.UsingFullMap());
+  map[2] = 20;
+  EXPECT_TRUE(map.UsingFullMap());
+  map.insert(std::make_pair(0, 0));
+
+  EXPECT_EQ(4u, map.size());
+  EXPECT_EQ(20, map.find(2)->second);
+  EXPECT_EQ(map.end(), map.find(4));
+
+  std::vector<int> keys;
+  for (const auto& pair : map)
+    keys.push_back(pair.first);
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), keys);
+
+  map.erase(map.find(1));
+  EXPECT_EQ(3u, map.size());
+  EXPECT_EQ(0u, map.count(1));
+}
+
+}  // namespace base
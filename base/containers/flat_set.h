@@ -0,0 +1,57 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_SET_H_
+#define BASE_CONTAINERS_FLAT_SET_H_
+
+#include <functional>
+
+#include "base/containers/flat_tree.h"
+
+namespace base {
+
+namespace internal {
+
+struct GetKeyFromValueIdentity {
+  template <class T>
+  const T& operator()(const T& t) const {
+    return t;
+  }
+};
+
+}  // namespace internal
+
+// A std::set look-alike that keeps its values sorted in a single std::vector
+// instead of a tree of nodes.
+//
+// WHEN TO USE A FLAT CONTAINER
+// ----------------------------
+//
+// Lookups do a binary search over contiguous memory, and iterating is a walk
+// over an array, so both are considerably faster than with std::set, which
+// chases a pointer and likely takes a cache miss per node. A flat_set also
+// does a single heap allocation instead of one per value, and has no
+// per-value overhead, making it much smaller.
+//
+// On the other hand, inserting or erasing a single value moves all the values
+// after it, i.e. takes O(N). Prefer flat_set when the set is built once (use
+// the range or vector constructors, which sort in O(N log N)) or stays small,
+// and looked up or iterated a lot. Large sets that keep changing should stay
+// std::set or base::hash_set.
+//
+// Unlike with std::set, iterators and references are invalidated by any
+// insertion or erasure, like those of std::vector.
+//
+// Values must not be modified through iterators in ways that change their
+// order.
+//
+// Beyond std::set, flat_set offers reserve(), capacity() and shrink_to_fit(),
+// and a constructor that adopts a std::vector of values.
+template <class Key, class Compare = std::less<Key>>
+using flat_set = internal::
+    flat_tree<Key, Key, internal::GetKeyFromValueIdentity, Compare>;
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_SET_H_
@@ -0,0 +1,181 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_set.h"
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Orders by |key| only, so that tests can tell equivalent values apart.
+struct KeyedValue {
+  int key;
+  int tag;
+};
+
+struct KeyedValueLess {
+  bool operator()(const KeyedValue& left, const KeyedValue& right) const {
+    return left.key < right.key;
+  }
+};
+
+using KeyedSet = flat_set<KeyedValue, KeyedValueLess>;
+
+std::vector<int> ToVector(const flat_set<int>& set) {
+  return std::vector<int>(set.begin(), set.end());
+}
+
+}  // namespace
+
+TEST(FlatSetTest, RangeConstructorSortsAndRemovesDuplicates) {
+  const int kInput[] = {5, 1, 4, 1, 3, 5, 2};
+  flat_set<int> set(std::begin(kInput), std::end(kInput));
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5}), ToVector(set));
+
+  flat_set<int> from_list({3, 3, 1});
+  EXPECT_EQ(std::vector<int>({1, 3}), ToVector(from_list));
+
+  flat_set<int> from_vector(std::vector<int>({9, 7, 8, 7}));
+  EXPECT_EQ(std::vector<int>({7, 8, 9}), ToVector(from_vector));
+
+  from_vector = {2, 1};
+  EXPECT_EQ(std::vector<int>({1, 2}), ToVector(from_vector));
+}
+
+TEST(FlatSetTest, BulkConstructionKeepsFirstOfEquivalentValues) {
+  KeyedSet set({{2, 0}, {1, 1}, {2, 2}, {1, 3}, {2, 4}});
+  ASSERT_EQ(2u, set.size());
+  EXPECT_EQ(1, set.begin()->tag);
+  EXPECT_EQ(0, std::next(set.begin())->tag);
+}
+
+TEST(FlatSetTest, Insert) {
+  flat_set<int> set;
+  std::pair<flat_set<int>::iterator, bool> result = set.insert(2);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(2, *result.first);
+
+  EXPECT_TRUE(set.insert(1).second);
+  EXPECT_TRUE(set.insert(3).second);
+  result = set.insert(2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(set.begin() + 1, result.first);
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), ToVector(set));
+
+  // A correct hint and a wrong one.
+  EXPECT_EQ(5, *set.insert(set.end(), 5));
+  EXPECT_EQ(0, *set.insert(set.end(), 0));
+  EXPECT_EQ(4, *set.emplace_hint(set.begin(), 4));
+  EXPECT_EQ(3, *set.insert(set.begin(), 3));
+  EXPECT_TRUE(set.emplace(6).second);
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6}), ToVector(set));
+}
+
+TEST(FlatSetTest, InsertRange) {
+  flat_set<int> set({1, 5, 9});
+  const int kInput[] = {8, 5, 2, 8, 0};
+  set.insert(std::begin(kInput), std::end(kInput));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 5, 8, 9}), ToVector(set));
+
+  set.insert(std::begin(kInput), std::begin(kInput));
+  EXPECT_EQ(6u, set.size());
+
+  // Values already in the set win over inserted ones.
+  KeyedSet keyed({{1, 0}, {3, 0}});
+  const KeyedValue kKeyed[] = {{3, 1}, {2, 1}, {2, 2}};
+  keyed.insert(std::begin(kKeyed), std::end(kKeyed));
+  ASSERT_EQ(3u, keyed.size());
+  EXPECT_EQ(1, keyed.find({2, 0})->tag);
+  EXPECT_EQ(0, keyed.find({3, 0})->tag);
+}
+
+TEST(FlatSetTest, MoveOnlyValues) {
+  using PtrSet = flat_set<std::unique_ptr<int>>;
+  std::vector<std::unique_ptr<int>> values;
+  values.push_back(std::unique_ptr<int>(new int(1)));
+  values.push_back(std::unique_ptr<int>(new int(2)));
+  PtrSet set(std::move(values));
+  EXPECT_EQ(2u, set.size());
+  EXPECT_TRUE(set.insert(std::unique_ptr<int>(new int(3))).second);
+  EXPECT_EQ(3u, set.size());
+}
+
+TEST(FlatSetTest, Erase) {
+  flat_set<int> set({1, 2, 3, 4, 5});
+  EXPECT_EQ(3, *set.erase(set.begin() + 1));
+  EXPECT_EQ(1u, set.erase(3));
+  EXPECT_EQ(0u, set.erase(3));
+  EXPECT_EQ(std::vector<int>({1, 4, 5}), ToVector(set));
+
+  EXPECT_EQ(set.end(), set.erase(set.cbegin() + 1, set.cend()));
+  EXPECT_EQ(std::vector<int>({1}), ToVector(set));
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(FlatSetTest, Search) {
+  const flat_set<int> set({10, 20, 30});
+  EXPECT_EQ(1u, set.count(20));
+  EXPECT_EQ(0u, set.count(25));
+  EXPECT_EQ(set.begin() + 1, set.find(20));
+  EXPECT_EQ(set.end(), set.find(5));
+  EXPECT_EQ(set.end(), set.find(35));
+
+  EXPECT_EQ(set.begin(), set.lower_bound(5));
+  EXPECT_EQ(set.begin() + 1, set.lower_bound(20));
+  EXPECT_EQ(set.begin() + 2, set.upper_bound(20));
+  EXPECT_EQ(set.end(), set.lower_bound(35));
+
+  auto range = set.equal_range(20);
+  EXPECT_EQ(set.begin() + 1, range.first);
+  EXPECT_EQ(set.begin() + 2, range.second);
+  range = set.equal_range(25);
+  EXPECT_EQ(range.first, range.second);
+  EXPECT_EQ(set.begin() + 2, range.first);
+}
+
+TEST(FlatSetTest, CustomComparator) {
+  flat_set<int, std::greater<int>> set({1, 3, 2});
+  EXPECT_EQ(std::vector<int>({3, 2, 1}),
+            std::vector<int>(set.begin(), set.end()));
+  EXPECT_EQ(set.begin() + 1, set.find(2));
+  EXPECT_TRUE(set.key_comp()(3, 2));
+  EXPECT_TRUE(set.value_comp()(3, 2));
+}
+
+TEST(FlatSetTest, Capacity) {
+  flat_set<int> set;
+  set.reserve(10);
+  EXPECT_LE(10u, set.capacity());
+  set.insert(1);
+  set.shrink_to_fit();
+  EXPECT_EQ(1u, set.size());
+}
+
+TEST(FlatSetTest, Comparisons) {
+  flat_set<int> a({1, 2});
+  flat_set<int> b({1, 3});
+  EXPECT_TRUE(a == a);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_TRUE(b > a);
+  EXPECT_TRUE(b >= a);
+
+  swap(a, b);
+  EXPECT_EQ(std::vector<int>({1, 3}), ToVector(a));
+  EXPECT_EQ(std::vector<int>({1, 2}), ToVector(b));
+}
+
+}  // namespace base
@@ -0,0 +1,394 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_TREE_H_
+#define BASE_CONTAINERS_FLAT_TREE_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace base {
+namespace internal {
+
+// The implementation of flat_set and flat_map: a sorted vector of unique
+// values, ordered by the keys that |GetKeyFromValue| extracts from them. See
+// flat_set.h for the trade-offs against the node based containers.
+template <class Key, class Value, class GetKeyFromValue, class KeyCompare>
+class flat_tree {
+ private:
+  using underlying_type = std::vector<Value>;
+
+ public:
+  using key_type = Key;
+  using key_compare = KeyCompare;
+  using value_type = Value;
+
+  // Compares values by their keys.
+  class value_compare {
+   public:
+    explicit value_compare(const key_compare& key_comp) : key_comp_(key_comp) {}
+
+    bool operator()(const value_type& left, const value_type& right) const {
+      GetKeyFromValue extractor;
+      return key_comp_(extractor(left), extractor(right));
+    }
+
+   private:
+    key_compare key_comp_;
+  };
+
+  using pointer = typename underlying_type::pointer;
+  using const_pointer = typename underlying_type::const_pointer;
+  using reference = typename underlying_type::reference;
+  using const_reference = typename underlying_type::const_reference;
+  using size_type = typename underlying_type::size_type;
+  using difference_type = typename underlying_type::difference_type;
+  using iterator = typename underlying_type::iterator;
+  using const_iterator = typename underlying_type::const_iterator;
+  using reverse_iterator = typename underlying_type::reverse_iterator;
+  using const_reverse_iterator =
+      typename underlying_type::const_reverse_iterator;
+
+  // Lifetime ------------------------------------------------------------------
+
+  flat_tree() : flat_tree(key_compare()) {}
+
+  explicit flat_tree(const key_compare& comp) : impl_(comp) {}
+
+  // Constructs the tree from a range in O(N log N), keeping the first of
+  // several values with equivalent keys.
+  template <class InputIterator>
+  flat_tree(InputIterator first,
+            InputIterator last,
+            const key_compare& comp = key_compare())
+      : impl_(comp, first, last) {
+    SortAndUnique();
+  }
+
+  // Takes over the values of |items|, likewise in O(N log N).
+  explicit flat_tree(underlying_type items,
+                     const key_compare& comp = key_compare())
+      : impl_(comp, std::move(items)) {
+    SortAndUnique();
+  }
+
+  flat_tree(std::initializer_list<value_type> ilist,
+            const key_compare& comp = key_compare())
+      : flat_tree(ilist.begin(), ilist.end(), comp) {}
+
+  flat_tree(const flat_tree&) = default;
+  flat_tree(flat_tree&&) = default;
+
+  ~flat_tree() = default;
+
+  flat_tree& operator=(const flat_tree&) = default;
+  flat_tree& operator=(flat_tree&&) = default;
+
+  flat_tree& operator=(std::initializer_list<value_type> ilist) {
+    impl_.body_.assign(ilist.begin(), ilist.end());
+    SortAndUnique();
+    return *this;
+  }
+
+  // Memory management ---------------------------------------------------------
+
+  void reserve(size_type new_capacity) { impl_.body_.reserve(new_capacity); }
+  size_type capacity() const { return impl_.body_.capacity(); }
+  void shrink_to_fit() { impl_.body_.shrink_to_fit(); }
+
+  // Size management -----------------------------------------------------------
+
+  void clear() { impl_.body_.clear(); }
+  size_type size() const { return impl_.body_.size(); }
+  size_type max_size() const { return impl_.body_.max_size(); }
+  bool empty() const { return impl_.body_.empty(); }
+
+  // Iterators -----------------------------------------------------------------
+
+  iterator begin() { return impl_.body_.begin(); }
+  const_iterator begin() const { return impl_.body_.begin(); }
+  const_iterator cbegin() const { return impl_.body_.cbegin(); }
+
+  iterator end() { return impl_.body_.end(); }
+  const_iterator end() const { return impl_.body_.end(); }
+  const_iterator cend() const { return impl_.body_.cend(); }
+
+  reverse_iterator rbegin() { return impl_.body_.rbegin(); }
+  const_reverse_iterator rbegin() const { return impl_.body_.rbegin(); }
+  const_reverse_iterator crbegin() const { return impl_.body_.crbegin(); }
+
+  reverse_iterator rend() { return impl_.body_.rend(); }
+  const_reverse_iterator rend() const { return impl_.body_.rend(); }
+  const_reverse_iterator crend() const { return impl_.body_.crend(); }
+
+  // Insert operations ---------------------------------------------------------
+  //
+  // All of these invalidate iterators and move the values after the insertion
+  // point, i.e. they take O(N).
+
+  std::pair<iterator, bool> insert(const value_type& val) {
+    return emplace_key_args(GetKeyFromValue()(val), val);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& val) {
+    return emplace_key_args(GetKeyFromValue()(val), std::move(val));
+  }
+
+  // The hint is only used to avoid the search if the value belongs right
+  // before it.
+  iterator insert(const_iterator position_hint, const value_type& val) {
+    return emplace_hint_key_args(position_hint, GetKeyFromValue()(val), val);
+  }
+
+  iterator insert(const_iterator position_hint, value_type&& val) {
+    return emplace_hint_key_args(position_hint, GetKeyFromValue()(val),
+                                 std::move(val));
+  }
+
+  // Inserts a range in O(M log M + N), which is much cheaper than inserting
+  // the M values one by one. Existing values win over inserted ones with
+  // equivalent keys, as for std::map.
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    if (first == last)
+      return;
+
+    const size_type old_size = size();
+    impl_.body_.insert(impl_.body_.end(), first, last);
+    const iterator middle = begin() + old_size;
+    std::stable_sort(middle, end(), value_comp());
+    std::inplace_merge(begin(), middle, end(), value_comp());
+    EraseDuplicates();
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  template <class... Args>
+  iterator emplace_hint(const_iterator position_hint, Args&&... args) {
+    return insert(position_hint, value_type(std::forward<Args>(args)...));
+  }
+
+  // Erase operations ----------------------------------------------------------
+  //
+  // These invalidate the iterators at and after the erased values.
+
+  iterator erase(iterator position) { return impl_.body_.erase(position); }
+
+  iterator erase(const_iterator position) {
+    return impl_.body_.erase(position);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return impl_.body_.erase(first, last);
+  }
+
+  size_type erase(const key_type& key) {
+    std::pair<iterator, iterator> range = equal_range(key);
+    size_type count = static_cast<size_type>(range.second - range.first);
+    erase(range.first, range.second);
+    return count;
+  }
+
+  // Comparators ---------------------------------------------------------------
+
+  key_compare key_comp() const { return impl_.get_key_comp(); }
+  value_compare value_comp() const { return value_compare(key_comp()); }
+
+  // Search operations ---------------------------------------------------------
+  //
+  // These take O(log N).
+
+  size_type count(const key_type& key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  iterator find(const key_type& key) {
+    return const_cast_it(static_cast<const flat_tree*>(this)->find(key));
+  }
+
+  const_iterator find(const key_type& key) const {
+    const_iterator position = lower_bound(key);
+    if (position == end() ||
+        impl_.get_key_comp()(key, GetKeyFromValue()(*position))) {
+      return end();
+    }
+    return position;
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    std::pair<const_iterator, const_iterator> range =
+        static_cast<const flat_tree*>(this)->equal_range(key);
+    return std::make_pair(const_cast_it(range.first),
+                          const_cast_it(range.second));
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    const_iterator lower = lower_bound(key);
+    if (lower == end() ||
+        impl_.get_key_comp()(key, GetKeyFromValue()(*lower))) {
+      return std::make_pair(lower, lower);
+    }
+    return std::make_pair(lower, std::next(lower));
+  }
+
+  iterator lower_bound(const key_type& key) {
+    return const_cast_it(static_cast<const flat_tree*>(this)->lower_bound(key));
+  }
+
+  const_iterator lower_bound(const key_type& key) const {
+    ValueKeyCompare value_key(impl_.get_key_comp());
+    return std::lower_bound(begin(), end(), key, value_key);
+  }
+
+  iterator upper_bound(const key_type& key) {
+    return const_cast_it(static_cast<const flat_tree*>(this)->upper_bound(key));
+  }
+
+  const_iterator upper_bound(const key_type& key) const {
+    KeyValueCompare key_value(impl_.get_key_comp());
+    return std::upper_bound(begin(), end(), key, key_value);
+  }
+
+  // General operations --------------------------------------------------------
+
+  void swap(flat_tree& other) { std::swap(impl_, other.impl_); }
+
+  friend bool operator==(const flat_tree& lhs, const flat_tree& rhs) {
+    return lhs.impl_.body_ == rhs.impl_.body_;
+  }
+
+  friend bool operator!=(const flat_tree& lhs, const flat_tree& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const flat_tree& lhs, const flat_tree& rhs) {
+    return lhs.impl_.body_ < rhs.impl_.body_;
+  }
+
+  friend bool operator>(const flat_tree& lhs, const flat_tree& rhs) {
+    return rhs < lhs;
+  }
+
+  friend bool operator>=(const flat_tree& lhs, const flat_tree& rhs) {
+    return !(lhs < rhs);
+  }
+
+  friend bool operator<=(const flat_tree& lhs, const flat_tree& rhs) {
+    return !(lhs > rhs);
+  }
+
+  friend void swap(flat_tree& lhs, flat_tree& rhs) { lhs.swap(rhs); }
+
+ protected:
+  // Inserts |args| as a value unless there's already one for |key|, which
+  // must be the key of the value that |args| construct.
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace_key_args(const K& key, Args&&... args) {
+    iterator lower = lower_bound(key);
+    if (lower == end() || impl_.get_key_comp()(key, GetKeyFromValue()(*lower)))
+      return std::make_pair(unsafe_emplace(lower, std::forward<Args>(args)...),
+                            true);
+    return std::make_pair(lower, false);
+  }
+
+  template <class K, class... Args>
+  iterator emplace_hint_key_args(const_iterator hint,
+                                 const K& key,
+                                 Args&&... args) {
+    const key_compare& comp = impl_.get_key_comp();
+    if ((hint == end() || comp(key, GetKeyFromValue()(*hint))) &&
+        (hint == begin() || comp(GetKeyFromValue()(*std::prev(hint)), key))) {
+      return unsafe_emplace(hint, std::forward<Args>(args)...);
+    }
+    return emplace_key_args(key, std::forward<Args>(args)...).first;
+  }
+
+  // Inserts a value at |position| without checking the order.
+  template <class... Args>
+  iterator unsafe_emplace(const_iterator position, Args&&... args) {
+    return impl_.body_.emplace(position, std::forward<Args>(args)...);
+  }
+
+ private:
+  // Compares values with keys for std::lower_bound() and std::upper_bound()
+  // respectively. These are separate classes because key_type and value_type
+  // are the same type for flat_set.
+  class ValueKeyCompare {
+   public:
+    explicit ValueKeyCompare(const key_compare& key_comp)
+        : key_comp_(key_comp) {}
+
+    bool operator()(const value_type& left, const key_type& right) const {
+      return key_comp_(GetKeyFromValue()(left), right);
+    }
+
+   private:
+    const key_compare& key_comp_;
+  };
+
+  class KeyValueCompare {
+   public:
+    explicit KeyValueCompare(const key_compare& key_comp)
+        : key_comp_(key_comp) {}
+
+    bool operator()(const key_type& left, const value_type& right) const {
+      return key_comp_(left, GetKeyFromValue()(right));
+    }
+
+   private:
+    const key_compare& key_comp_;
+  };
+
+  iterator const_cast_it(const_iterator c_it) {
+    return impl_.body_.begin() + (c_it - cbegin());
+  }
+
+  // Sorts the values, keeping the first of several with equivalent keys.
+  void SortAndUnique() {
+    std::stable_sort(begin(), end(), value_comp());
+    EraseDuplicates();
+  }
+
+  // Erases all but the first of each run of values with equivalent keys from
+  // sorted values.
+  void EraseDuplicates() {
+    value_compare comp = value_comp();
+    iterator last = std::unique(
+        begin(), end(), [&comp](const value_type& left,
+                                const value_type& right) {
+          return !comp(left, right);
+        });
+    impl_.body_.erase(last, end());
+  }
+
+  // Holds the comparator through the empty base optimization, since it is
+  // usually an empty class.
+  struct Impl : private key_compare {
+    Impl() = default;
+
+    template <class Cmp, class... Body>
+    explicit Impl(Cmp&& compare_arg, Body&&... underlying_type_args)
+        : key_compare(std::forward<Cmp>(compare_arg)),
+          body_(std::forward<Body>(underlying_type_args)...) {}
+
+    const key_compare& get_key_comp() const { return *this; }
+
+    underlying_type body_;
+  } impl_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_TREE_H_
@@ -0,0 +1,135 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_hash_map.h"
+#include "base/containers/hash_tables.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Map sizes to measure, from the typical IDMap to a large disk cache index.
+const size_t kSizes[] = {4, 64, 1024, 16384, 262144};
+
+// Roughly the number of operations each measurement does, whatever the size.
+const size_t kOperationsPerMeasurement = 4 * 1000 * 1000;
+
+// Random keys, like the entry hashes of the simple cache index.
+std::vector<uint64_t> MakeKeys(size_t size) {
+  std::vector<uint64_t> keys;
+  for (size_t i = 0; i < size; ++i)
+    keys.push_back(RandUint64());
+  return keys;
+}
+
+void PrintResult(const std::string& measurement,
+                 size_t size,
+                 TimeDelta elapsed,
+                 size_t num_operations) {
+  perf_test::PrintResult(measurement, "", "size_" + SizeTToString(size),
+                         elapsed.InMillisecondsF() * 1000000 / num_operations,
+                         "ns/op", true);
+}
+
+size_t NumRounds(size_t size) {
+  return std::max<size_t>(1, kOperationsPerMeasurement / size);
+}
+
+template <class Map>
+void RunInsertErase(const std::string& name) {
+  for (size_t size : kSizes) {
+    const std::vector<uint64_t> keys = MakeKeys(size);
+    const size_t rounds = NumRounds(size);
+    const TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      Map map;
+      for (uint64_t key : keys)
+        map[key] = key;
+      ASSERT_EQ(size, map.size());
+      for (uint64_t key : keys)
+        map.erase(key);
+      ASSERT_TRUE(map.empty());
+    }
+    PrintResult("insert_erase_" + name, size, TimeTicks::Now() - start,
+                rounds * size);
+  }
+}
+
+// Looks up keys that are in the map and, as often, keys that aren't.
+template <class Map>
+void RunLookup(const std::string& name) {
+  for (size_t size : kSizes) {
+    const std::vector<uint64_t> keys = MakeKeys(size);
+    std::vector<uint64_t> lookups = MakeKeys(size);
+    lookups.insert(lookups.end(), keys.begin(), keys.end());
+    std::random_shuffle(lookups.begin(), lookups.end(), RandGenerator);
+    const size_t rounds = NumRounds(lookups.size());
+
+    Map map;
+    for (uint64_t key : keys)
+      map[key] = key;
+
+    size_t found = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (uint64_t key : lookups)
+        found += map.count(key);
+    }
+    PrintResult("lookup_" + name, size, TimeTicks::Now() - start,
+                rounds * lookups.size());
+    EXPECT_EQ(rounds * size, found);
+  }
+}
+
+template <class Map>
+void RunIterate(const std::string& name) {
+  for (size_t size : kSizes) {
+    const std::vector<uint64_t> keys = MakeKeys(size);
+    const size_t rounds = NumRounds(size);
+    Map map;
+    for (uint64_t key : keys)
+      map[key] = 1;
+
+    uint64_t sum = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (const auto& pair : map)
+        sum += pair.second;
+    }
+    PrintResult("iterate_" + name, size, TimeTicks::Now() - start,
+                rounds * size);
+    EXPECT_EQ(rounds * size, sum);
+  }
+}
+
+}  // namespace
+
+TEST(HashTablesPerfTest, InsertErase) {
+  RunInsertErase<hash_map<uint64_t, uint64_t>>("hash_map");
+  RunInsertErase<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map");
+}
+
+TEST(HashTablesPerfTest, Lookup) {
+  RunLookup<hash_map<uint64_t, uint64_t>>("hash_map");
+  RunLookup<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map");
+}
+
+TEST(HashTablesPerfTest, Iterate) {
+  RunIterate<hash_map<uint64_t, uint64_t>>("hash_map");
+  RunIterate<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map");
+}
+
+}  // namespace base
@@ -0,0 +1,396 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// TimerWheel is a priority queue of values keyed by a deadline, implemented as
+// a hierarchical timer wheel. Unlike a binary heap, insertion and cancellation
+// don't depend on the number of values in the queue:
+//
+//   Push()    O(1), or O(log k) if the deadline isn't after the current tick,
+//   Cancel()  where k is the number of such values. The current tick is the
+//             tick of the earliest deadline when Top() was last called.
+//   Top()     Amortized O(1). Reaching the next non-empty tick moves each value
+//             at most once per level.
+//   Pop()     O(log k).
+//
+// Values are popped in order of deadline. Values with the same deadline are
+// popped in the order in which they were pushed.
+//
+// Example:
+//
+//   TimerWheel<std::string> wheel;
+//   TimerWheel<std::string>::Handle handle =
+//       wheel.Push(now + TimeDelta::FromSeconds(30), "timeout");
+//   wheel.Push(now + TimeDelta::FromSeconds(1), "alarm");
+//   wheel.Cancel(handle);
+//   std::string value = wheel.Pop();  // "alarm".
+//
+// This class is not thread-safe.
+
+#ifndef BASE_CONTAINERS_TIMER_WHEEL_H_
+#define BASE_CONTAINERS_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bits.h"
+#include "base/containers/linked_list.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+
+namespace base {
+
+template <typename T>
+class TimerWheel {
+ private:
+  struct Entry;
+
+ public:
+  // Identifies a value pushed in a TimerWheel. Only valid until the value is
+  // popped or cancelled.
+  using Handle = Entry*;
+
+  TimerWheel() = default;
+  ~TimerWheel() { Clear(); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Adds |value| with |deadline| to the wheel. Returns a handle which can be
+  // passed to Cancel() until |value| is popped.
+  Handle Push(TimeTicks deadline, T value) {
+    Entry* entry = new Entry(deadline, ToTick(deadline), next_sequence_num_++,
+                             std::move(value));
+    // An empty wheel can be moved back to any tick. It isn't moved forward to
+    // the tick of |entry| since values with earlier deadlines pushed next
+    // would have to go through the ready heap.
+    if (empty())
+      current_tick_ = std::min(current_tick_, entry->tick);
+    ++size_;
+
+    if (entry->tick <= current_tick_)
+      PushInReadyHeap(entry);
+    else
+      InsertInWheel(entry);
+    return entry;
+  }
+
+  // Removes the value identified by |handle| from the wheel.
+  void Cancel(Handle handle) {
+    DCHECK(handle);
+    DCHECK(!empty());
+    if (handle->level == kReadyLevel) {
+      RemoveFromReadyHeap(handle);
+    } else {
+      handle->RemoveFromList();
+      if (handle->level < kNumLevels &&
+          slots_[handle->level][handle->slot].empty()) {
+        occupied_slots_[handle->level] &= ~(uint64_t(1) << handle->slot);
+      }
+    }
+    delete handle;
+    --size_;
+  }
+
+  // Returns the value with the earliest deadline. The wheel must not be empty.
+  const T& Top() const { return GetTopEntry()->value; }
+
+  // Returns the deadline of Top(). The wheel must not be empty.
+  TimeTicks TopDeadline() const { return GetTopEntry()->deadline; }
+
+  // Removes and returns the value with the earliest deadline. The wheel must
+  // not be empty.
+  T Pop() {
+    Entry* entry = GetTopEntry();
+    RemoveFromReadyHeap(entry);
+    T value = std::move(entry->value);
+    delete entry;
+    --size_;
+    return value;
+  }
+
+  // Removes all values from the wheel.
+  void Clear() {
+    for (Entry* entry : ready_heap_)
+      delete entry;
+    ready_heap_.clear();
+    for (int level = 0; level < kNumLevels; ++level) {
+      for (int slot = 0; slot < kSlotsPerLevel; ++slot)
+        DeleteEntries(&slots_[level][slot]);
+      occupied_slots_[level] = 0;
+    }
+    DeleteEntries(&overflow_list_);
+    size_ = 0;
+  }
+
+ private:
+  // Number of levels of the wheel. Level |n| has slots that each span
+  // kSlotsPerLevel^n ticks.
+  static const int kNumLevels = 6;
+  static const int kBitsPerLevel = 6;
+  static const int kSlotsPerLevel = 1 << kBitsPerLevel;
+  static const int64_t kSlotMask = kSlotsPerLevel - 1;
+
+  // Duration of a tick, in microseconds. Values whose deadlines are in the same
+  // tick are sorted by the ready heap when the wheel reaches that tick.
+  static const int64_t kMicrosecondsPerTick = Time::kMicrosecondsPerMillisecond;
+
+  // Levels of entries which aren't in a slot of the wheel.
+  static const int kReadyLevel = -1;
+  static const int kOverflowLevel = kNumLevels;
+
+  struct Entry : public LinkNode<Entry> {
+    Entry(TimeTicks deadline, int64_t tick, uint64_t sequence_num, T value)
+        : deadline(deadline),
+          tick(tick),
+          sequence_num(sequence_num),
+          value(std::move(value)) {}
+
+    const TimeTicks deadline;
+    const int64_t tick;
+
+    // Breaks ties between entries with the same |deadline|.
+    const uint64_t sequence_num;
+
+    // Location of the entry: kReadyLevel, kOverflowLevel or the level of the
+    // slot of the wheel that contains it.
+    int level = kReadyLevel;
+    int slot = 0;
+
+    // Index of the entry in |ready_heap_| if |level| is kReadyLevel.
+    size_t heap_index = 0;
+
+    T value;
+  };
+
+  static int64_t ToTick(TimeTicks deadline) {
+    const int64_t microseconds = (deadline - TimeTicks()).InMicroseconds();
+    // Round towards negative infinity.
+    if (microseconds < 0)
+      return (microseconds - kMicrosecondsPerTick + 1) / kMicrosecondsPerTick;
+    return microseconds / kMicrosecondsPerTick;
+  }
+
+  // Returns true if |a| must be popped before |b|.
+  static bool IsBefore(const Entry* a, const Entry* b) {
+    if (a->deadline != b->deadline)
+      return a->deadline < b->deadline;
+    return a->sequence_num < b->sequence_num;
+  }
+
+  // Returns the index of the lowest bit set in |bits|, which must not be 0.
+  static int LowestSetBit(uint64_t bits) {
+    DCHECK(bits);
+    int index = 0;
+    if (!(bits & 0xFFFFFFFFu)) {
+      bits >>= 32;
+      index = 32;
+    }
+    const uint32_t low_bits = static_cast<uint32_t>(bits);
+    return index + bits::Log2Floor(low_bits & (~low_bits + 1));
+  }
+
+  static void DeleteEntries(LinkedList<Entry>* list) {
+    while (!list->empty()) {
+      Entry* entry = list->head()->value();
+      entry->RemoveFromList();
+      delete entry;
+    }
+  }
+
+  // Moves the entry at |index| of |ready_heap_| up until its parent isn't
+  // after it.
+  void SiftUp(size_t index) const {
+    Entry* entry = ready_heap_[index];
+    while (index > 0) {
+      const size_t parent = (index - 1) / 2;
+      if (!IsBefore(entry, ready_heap_[parent]))
+        break;
+      PlaceInReadyHeap(ready_heap_[parent], index);
+      index = parent;
+    }
+    PlaceInReadyHeap(entry, index);
+  }
+
+  // Moves the entry at |index| of |ready_heap_| down until none of its
+  // children is before it.
+  void SiftDown(size_t index) const {
+    Entry* entry = ready_heap_[index];
+    for (;;) {
+      size_t child = 2 * index + 1;
+      if (child >= ready_heap_.size())
+        break;
+      if (child + 1 < ready_heap_.size() &&
+          IsBefore(ready_heap_[child + 1], ready_heap_[child])) {
+        ++child;
+      }
+      if (!IsBefore(ready_heap_[child], entry))
+        break;
+      PlaceInReadyHeap(ready_heap_[child], index);
+      index = child;
+    }
+    PlaceInReadyHeap(entry, index);
+  }
+
+  void PlaceInReadyHeap(Entry* entry, size_t index) const {
+    ready_heap_[index] = entry;
+    entry->heap_index = index;
+  }
+
+  // Pushes |entry|, whose tick isn't after |current_tick_|, in |ready_heap_|.
+  void PushInReadyHeap(Entry* entry) const {
+    DCHECK_LE(entry->tick, current_tick_);
+    entry->level = kReadyLevel;
+    ready_heap_.push_back(entry);
+    SiftUp(ready_heap_.size() - 1);
+  }
+
+  void RemoveFromReadyHeap(Entry* entry) const {
+    DCHECK(entry->level == kReadyLevel);
+    DCHECK_EQ(entry, ready_heap_[entry->heap_index]);
+    const size_t index = entry->heap_index;
+    Entry* last_entry = ready_heap_.back();
+    ready_heap_.pop_back();
+    if (last_entry == entry)
+      return;
+    PlaceInReadyHeap(last_entry, index);
+    if (index > 0 && IsBefore(last_entry, ready_heap_[(index - 1) / 2]))
+      SiftUp(index);
+    else
+      SiftDown(index);
+  }
+
+  // Inserts |entry|, whose tick is after |current_tick_|, in the slot of the
+  // lowest level of the wheel that can hold it, or in |overflow_list_|.
+  void InsertInWheel(Entry* entry) const {
+    DCHECK_GT(entry->tick, current_tick_);
+    for (int level = 0; level < kNumLevels; ++level) {
+      // |entry| belongs to |level| if its tick only differs from
+      // |current_tick_| in the bits of |level| and of lower levels.
+      const int higher_levels_shift = kBitsPerLevel * (level + 1);
+      if ((entry->tick >> higher_levels_shift) !=
+          (current_tick_ >> higher_levels_shift)) {
+        continue;
+      }
+      const int slot = static_cast<int>(
+          (entry->tick >> (kBitsPerLevel * level)) & kSlotMask);
+      entry->level = level;
+      entry->slot = slot;
+      slots_[level][slot].Append(entry);
+      occupied_slots_[level] |= uint64_t(1) << slot;
+      return;
+    }
+    entry->level = kOverflowLevel;
+    overflow_list_.Append(entry);
+  }
+
+  // Moves all entries of |list| to the ready heap or to lower levels of the
+  // wheel, according to |current_tick_|.
+  void Redistribute(LinkedList<Entry>* list) const {
+    while (!list->empty()) {
+      Entry* entry = list->head()->value();
+      entry->RemoveFromList();
+      if (entry->tick <= current_tick_)
+        PushInReadyHeap(entry);
+      else
+        InsertInWheel(entry);
+    }
+  }
+
+  // Advances |current_tick_| to the next tick which has entries and moves these
+  // entries to the ready heap. Must be called when the ready heap is empty and
+  // the wheel isn't.
+  void AdvanceToNextTick() const {
+    DCHECK(ready_heap_.empty());
+    DCHECK(!empty());
+
+    while (ready_heap_.empty()) {
+      bool found_slot = false;
+      for (int level = 0; level < kNumLevels; ++level) {
+        const int level_shift = kBitsPerLevel * level;
+        const int current_slot =
+            static_cast<int>((current_tick_ >> level_shift) & kSlotMask);
+        // Slots at or before |current_slot| are always empty.
+        const uint64_t next_slots =
+            current_slot == kSlotsPerLevel - 1
+                ? 0
+                : occupied_slots_[level] &
+                      (~uint64_t(0) << (current_slot + 1));
+        if (!next_slots)
+          continue;
+
+        // Move to the first tick of the next occupied slot and move its
+        // entries to lower levels.
+        const int slot = LowestSetBit(next_slots);
+        const int higher_levels_shift = level_shift + kBitsPerLevel;
+        current_tick_ = ((current_tick_ >> higher_levels_shift)
+                         << higher_levels_shift) |
+                        (static_cast<int64_t>(slot) << level_shift);
+        occupied_slots_[level] &= ~(uint64_t(1) << slot);
+        Redistribute(&slots_[level][slot]);
+        found_slot = true;
+        break;
+      }
+
+      if (!found_slot) {
+        // All remaining entries are too far in the future for the wheel. Move
+        // to the earliest of them and insert them again.
+        DCHECK(!overflow_list_.empty());
+        int64_t earliest_tick = overflow_list_.head()->value()->tick;
+        for (LinkNode<Entry>* node = overflow_list_.head();
+             node != overflow_list_.end(); node = node->next()) {
+          earliest_tick = std::min(earliest_tick, node->value()->tick);
+        }
+        current_tick_ = earliest_tick;
+        // Entries which still don't fit in the wheel are appended to
+        // |overflow_list_| again, so redistribute a copy of the list.
+        LinkedList<Entry> overflow_list;
+        while (!overflow_list_.empty()) {
+          Entry* entry = overflow_list_.head()->value();
+          entry->RemoveFromList();
+          overflow_list.Append(entry);
+        }
+        Redistribute(&overflow_list);
+      }
+    }
+  }
+
+  Entry* GetTopEntry() const {
+    DCHECK(!empty());
+    if (ready_heap_.empty())
+      AdvanceToNextTick();
+    return ready_heap_.front();
+  }
+
+  // The members below are mutable because finding the top entry reorganizes
+  // the wheel without changing its contents.
+
+  // Binary heap of the entries whose tick is at or before |current_tick_|. The
+  // earliest entry is at the front.
+  mutable std::vector<Entry*> ready_heap_;
+
+  // Entries whose tick is after |current_tick_|. |occupied_slots_[level]| has
+  // bit |slot| set if |slots_[level][slot]| isn't empty.
+  mutable LinkedList<Entry> slots_[kNumLevels][kSlotsPerLevel];
+  mutable uint64_t occupied_slots_[kNumLevels] = {};
+
+  // Entries whose tick is too far from |current_tick_| to fit in the wheel.
+  mutable LinkedList<Entry> overflow_list_;
+
+  // Tick that the wheel has reached.
+  mutable int64_t current_tick_ = 0;
+
+  size_t size_ = 0;
+  uint64_t next_sequence_num_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_TIMER_WHEEL_H_
@@ -0,0 +1,163 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/timer_wheel.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Simulated duration of the workload, in ticks of 1 ms.
+const int kNumTicks = 60 * 1000;
+
+// Number of timeouts set at each tick.
+const int kTimeoutsPerTick = 50;
+
+// Timeouts expire between 1 and 30 seconds after being set.
+const int kMinTimeoutMs = 1000;
+const int kMaxTimeoutMs = 30 * 1000;
+
+// Most timeouts are cancelled a few ms after being set, like the timeout of a
+// request which gets a timely response. 1 in |kCancelRatio| timeouts expires.
+const int kCancelAfterMs = 20;
+const int kCancelRatio = 10;
+
+TimeTicks TickToTimeTicks(int tick) {
+  return TimeTicks() + TimeDelta::FromMilliseconds(tick);
+}
+
+// Timeouts stored in a TimerWheel. Cancel() removes the timeout.
+class TimerWheelTimeouts {
+ public:
+  TimerWheelTimeouts() = default;
+
+  void Set(TimeTicks deadline, size_t id) {
+    handles_.push_back(timer_wheel_.Push(deadline, id));
+  }
+
+  void Cancel(size_t id) { timer_wheel_.Cancel(handles_[id]); }
+
+  // Returns the number of timeouts which expired at or before |now|.
+  size_t Expire(TimeTicks now) {
+    size_t num_expired = 0;
+    while (!timer_wheel_.empty() && timer_wheel_.TopDeadline() <= now) {
+      timer_wheel_.Pop();
+      ++num_expired;
+    }
+    return num_expired;
+  }
+
+  size_t size() const { return timer_wheel_.size(); }
+
+ private:
+  TimerWheel<size_t> timer_wheel_;
+  std::vector<TimerWheel<size_t>::Handle> handles_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheelTimeouts);
+};
+
+// Timeouts stored in a binary heap. A heap can't remove an arbitrary value
+// efficiently. Instead, Cancel() marks the timeout and it is discarded when it
+// reaches the top of the heap.
+class HeapTimeouts {
+ public:
+  HeapTimeouts() = default;
+
+  void Set(TimeTicks deadline, size_t id) {
+    heap_.push(std::make_pair(deadline, id));
+    cancelled_.push_back(false);
+  }
+
+  void Cancel(size_t id) { cancelled_[id] = true; }
+
+  // Returns the number of timeouts which expired at or before |now|.
+  size_t Expire(TimeTicks now) {
+    size_t num_expired = 0;
+    while (!heap_.empty() && heap_.top().first <= now) {
+      if (!cancelled_[heap_.top().second])
+        ++num_expired;
+      heap_.pop();
+    }
+    return num_expired;
+  }
+
+  size_t size() const { return heap_.size(); }
+
+ private:
+  using Timeout = std::pair<TimeTicks, size_t>;
+  std::priority_queue<Timeout, std::vector<Timeout>, std::greater<Timeout>>
+      heap_;
+  std::vector<bool> cancelled_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapTimeouts);
+};
+
+template <typename Timeouts>
+void RunCancelHeavyWorkload(const std::string& trace) {
+  Timeouts timeouts;
+  uint64_t random_state = 1;
+  size_t num_expired = 0;
+  size_t max_size = 0;
+
+  const TimeTicks start = TimeTicks::Now();
+  for (int tick = 0; tick < kNumTicks; ++tick) {
+    for (int i = 0; i < kTimeoutsPerTick; ++i) {
+      random_state = random_state * 6364136223846793005ULL + 1;
+      const int timeout_ms =
+          kMinTimeoutMs +
+          static_cast<int>((random_state >> 33) %
+                           (kMaxTimeoutMs - kMinTimeoutMs));
+      timeouts.Set(TickToTimeTicks(tick + timeout_ms),
+                   static_cast<size_t>(tick) * kTimeoutsPerTick + i);
+    }
+
+    if (tick >= kCancelAfterMs) {
+      const size_t first_id =
+          static_cast<size_t>(tick - kCancelAfterMs) * kTimeoutsPerTick;
+      for (size_t id = first_id; id < first_id + kTimeoutsPerTick; ++id) {
+        if (id % kCancelRatio)
+          timeouts.Cancel(id);
+      }
+    }
+
+    num_expired += timeouts.Expire(TickToTimeTicks(tick));
+    max_size = std::max(max_size, timeouts.size());
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_GT(num_expired, 0U);
+  const double num_timeouts =
+      static_cast<double>(kNumTicks) * kTimeoutsPerTick;
+  perf_test::PrintResult("timeout_set_cancel_expire", "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / num_timeouts,
+                         "ns/timeout", true);
+  perf_test::PrintResult("timeout_queue_max_size", "", trace, max_size,
+                         "timeouts", false);
+}
+
+}  // namespace
+
+TEST(TimerWheelPerfTest, CancelHeavyTimerWheel) {
+  RunCancelHeavyWorkload<TimerWheelTimeouts>("timer_wheel");
+}
+
+TEST(TimerWheelPerfTest, CancelHeavyHeap) {
+  RunCancelHeavyWorkload<HeapTimeouts>("heap");
+}
+
+}  // namespace base
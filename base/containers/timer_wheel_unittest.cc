@@ -0,0 +1,208 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/timer_wheel.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "base/memory/ptr_util.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+TimeTicks Deadline(int64_t microseconds) {
+  return TimeTicks() + TimeDelta::FromMicroseconds(microseconds);
+}
+
+// Deterministic pseudo-random generator for the randomized tests.
+class SimpleRandom {
+ public:
+  explicit SimpleRandom(uint64_t seed) : state_(seed) {}
+
+  uint64_t Next() {
+    state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state_ >> 33;
+  }
+
+ private:
+  uint64_t state_;
+};
+
+}  // namespace
+
+TEST(TimerWheelTest, Empty) {
+  TimerWheel<int> wheel;
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(0U, wheel.size());
+
+  wheel.Push(Deadline(1000), 1);
+  EXPECT_FALSE(wheel.empty());
+  EXPECT_EQ(1U, wheel.size());
+
+  EXPECT_EQ(1, wheel.Pop());
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(TimerWheelTest, PopInDeadlineOrder) {
+  TimerWheel<int> wheel;
+  // Deadlines in the same tick, in lower and higher levels of the wheel and
+  // beyond the range of the wheel.
+  const int64_t kDeadlines[] = {5000,
+                                 10,
+                                 2000000000,
+                                 64000,
+                                 999,
+                                 4096000,
+                                 5001,
+                                 3,
+                                 Time::kMicrosecondsPerDay * 1000,
+                                 262144000,
+                                 4096001,
+                                 0,
+                                 Time::kMicrosecondsPerDay * 2000};
+  for (int64_t deadline : kDeadlines)
+    wheel.Push(Deadline(deadline), static_cast<int>(deadline % 1000000007));
+
+  std::vector<int64_t> sorted_deadlines(std::begin(kDeadlines),
+                                        std::end(kDeadlines));
+  std::sort(sorted_deadlines.begin(), sorted_deadlines.end());
+  for (int64_t deadline : sorted_deadlines) {
+    ASSERT_FALSE(wheel.empty());
+    EXPECT_EQ(Deadline(deadline), wheel.TopDeadline());
+    EXPECT_EQ(static_cast<int>(deadline % 1000000007), wheel.Top());
+    wheel.Pop();
+  }
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, SameDeadlinePopInPushOrder) {
+  TimerWheel<int> wheel;
+  for (int i = 0; i < 10; ++i)
+    wheel.Push(Deadline(i % 2 ? 1000000 : 2000000), i);
+
+  for (int i = 1; i < 10; i += 2)
+    EXPECT_EQ(i, wheel.Pop());
+  for (int i = 0; i < 10; i += 2)
+    EXPECT_EQ(i, wheel.Pop());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, PushBeforeTop) {
+  TimerWheel<int> wheel;
+  wheel.Push(Deadline(1000000), 1);
+  wheel.Push(Deadline(3000000), 3);
+  EXPECT_EQ(1, wheel.Pop());
+  EXPECT_EQ(3, wheel.Top());
+
+  // Deadlines earlier than the last popped deadline are allowed.
+  wheel.Push(Deadline(2000000), 2);
+  wheel.Push(Deadline(500000), 0);
+  EXPECT_EQ(0, wheel.Pop());
+  EXPECT_EQ(2, wheel.Pop());
+  EXPECT_EQ(3, wheel.Pop());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, Cancel) {
+  TimerWheel<int> wheel;
+  TimerWheel<int>::Handle handle_1 = wheel.Push(Deadline(1000), 1);
+  wheel.Push(Deadline(2000), 2);
+  TimerWheel<int>::Handle handle_3 = wheel.Push(Deadline(3000000), 3);
+  wheel.Push(Deadline(4000000), 4);
+  EXPECT_EQ(4U, wheel.size());
+
+  // Cancel the top value and a value that is still in the wheel.
+  EXPECT_EQ(1, wheel.Top());
+  wheel.Cancel(handle_1);
+  wheel.Cancel(handle_3);
+  EXPECT_EQ(2U, wheel.size());
+
+  EXPECT_EQ(2, wheel.Pop());
+  EXPECT_EQ(4, wheel.Pop());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, MoveOnlyValues) {
+  TimerWheel<std::unique_ptr<int>> wheel;
+  wheel.Push(Deadline(2000), WrapUnique(new int(2)));
+  wheel.Push(Deadline(1000), WrapUnique(new int(1)));
+
+  std::unique_ptr<int> value = wheel.Pop();
+  EXPECT_EQ(1, *value);
+  value = wheel.Pop();
+  EXPECT_EQ(2, *value);
+}
+
+TEST(TimerWheelTest, Clear) {
+  TimerWheel<std::unique_ptr<int>> wheel;
+  wheel.Push(Deadline(1000), WrapUnique(new int(1)));
+  wheel.Push(Deadline(1000000000), WrapUnique(new int(2)));
+  wheel.Clear();
+  EXPECT_TRUE(wheel.empty());
+
+  wheel.Push(Deadline(5000), WrapUnique(new int(3)));
+  EXPECT_EQ(3, *wheel.Pop());
+}
+
+// Verify that a TimerWheel and a std::priority_queue pop the same values when
+// they receive the same random sequence of pushes, pops and cancellations.
+TEST(TimerWheelTest, MatchesPriorityQueue) {
+  using Value = std::pair<int64_t, uint64_t>;  // (deadline, push order)
+
+  // std::priority_queue pops the largest value first.
+  std::priority_queue<Value, std::vector<Value>, std::greater<Value>> queue;
+  std::vector<bool> cancelled;
+  std::vector<TimerWheel<uint64_t>::Handle> handles;
+  TimerWheel<uint64_t> wheel;
+
+  SimpleRandom random(42);
+  int64_t now = 0;
+  for (int i = 0; i < 100000; ++i) {
+    const uint64_t action = random.Next() % 10;
+    if (action < 5) {
+      // Mix deadlines in the current tick, the near future and the far future.
+      const int64_t range = static_cast<int64_t>(1) << (random.Next() % 40);
+      const int64_t deadline =
+          now + static_cast<int64_t>(random.Next() % range);
+      const uint64_t push_order = handles.size();
+      handles.push_back(wheel.Push(Deadline(deadline), push_order));
+      cancelled.push_back(false);
+      queue.push(Value(deadline, push_order));
+    } else if (action < 7) {
+      if (handles.empty())
+        continue;
+      const uint64_t push_order = random.Next() % handles.size();
+      if (cancelled[push_order])
+        continue;
+      wheel.Cancel(handles[push_order]);
+      cancelled[push_order] = true;
+    } else {
+      while (!queue.empty() && cancelled[queue.top().second])
+        queue.pop();
+      ASSERT_EQ(queue.empty(), wheel.empty());
+      if (queue.empty())
+        continue;
+      EXPECT_EQ(Deadline(queue.top().first), wheel.TopDeadline());
+      const uint64_t push_order = wheel.Pop();
+      ASSERT_EQ(queue.top().second, push_order);
+      cancelled[push_order] = true;
+      now = queue.top().first;
+      queue.pop();
+    }
+  }
+}
+
+}  // namespace base
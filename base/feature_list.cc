@@ -11,6 +11,8 @@
 
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
+#include "base/startup_snapshot.h"
+#include "base/stl_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 
@@ -23,6 +25,10 @@ namespace {
 // have more control over initialization timing. Leaky.
 FeatureList* g_instance = nullptr;
 
+// Incremented whenever |g_instance| changes, so that FeatureHandles look their
+// feature up again.
+subtle::Atomic32 g_instance_generation = 1;
+
 // Some characters are not allowed to appear in feature names or the associated
 // field trial names, as they are used as special characters for command-line
 // serialization. This function checks that the strings are ASCII (since they
@@ -33,6 +39,35 @@ bool IsValidFeatureOrFieldTrialName(const std::string& name) {
   return IsStringASCII(name) && name.find_first_of(",<*") == std::string::npos;
 }
 
+// Appends an override to the list it belongs to, in the format of
+// FeatureList::GetFeatureOverrides().
+void AppendOverride(StringPiece feature_name,
+                    FeatureList::OverrideState overridden_state,
+                    FieldTrial* field_trial,
+                    std::string* enable_overrides,
+                    std::string* disable_overrides) {
+  std::string* target_list = nullptr;
+  switch (overridden_state) {
+    case FeatureList::OVERRIDE_USE_DEFAULT:
+    case FeatureList::OVERRIDE_ENABLE_FEATURE:
+      target_list = enable_overrides;
+      break;
+    case FeatureList::OVERRIDE_DISABLE_FEATURE:
+      target_list = disable_overrides;
+      break;
+  }
+
+  if (!target_list->empty())
+    target_list->push_back(',');
+  if (overridden_state == FeatureList::OVERRIDE_USE_DEFAULT)
+    target_list->push_back('*');
+  feature_name.AppendToString(target_list);
+  if (field_trial) {
+    target_list->push_back('<');
+    target_list->append(field_trial->trial_name());
+  }
+}
+
 }  // namespace
 
 FeatureList::FeatureList()
@@ -55,12 +90,37 @@ void FeatureList::InitializeFromCommandLine(
   initialized_from_command_line_ = true;
 }
 
+void FeatureList::InitializeFromStartupSnapshot(
+    std::unique_ptr<StartupSnapshot> snapshot) {
+  DCHECK(!initialized_);
+  DCHECK(!startup_snapshot_);
+
+  // Overrides associated with a field trial need it looked up, so they are
+  // registered like command-line ones.
+  for (size_t i = 0; i < snapshot->feature_override_count(); ++i) {
+    const StartupSnapshot::FeatureOverride entry =
+        snapshot->GetFeatureOverride(i);
+    if (entry.trial_name.empty())
+      continue;
+    RegisterOverride(entry.feature_name, entry.state,
+                     FieldTrialList::Find(entry.trial_name.as_string()));
+  }
+  startup_snapshot_ = std::move(snapshot);
+
+  initialized_from_command_line_ = true;
+}
+
 bool FeatureList::IsFeatureOverriddenFromCommandLine(
     const std::string& feature_name,
     OverrideState state) const {
   auto it = overrides_.find(feature_name);
-  return it != overrides_.end() && it->second.overridden_state == state &&
-         !it->second.overridden_by_field_trial;
+  if (it != overrides_.end()) {
+    return it->second.overridden_state == state &&
+           !it->second.overridden_by_field_trial;
+  }
+  OverrideState snapshot_state;
+  return FindSnapshotOverride(feature_name, &snapshot_state) &&
+         snapshot_state == state;
 }
 
 void FeatureList::AssociateReportingFieldTrial(
@@ -70,9 +130,16 @@ void FeatureList::AssociateReportingFieldTrial(
   DCHECK(
       IsFeatureOverriddenFromCommandLine(feature_name, for_overridden_state));
 
+  // Overrides from the startup snapshot are copied to be associated.
+  auto it = overrides_.find(feature_name);
+  if (it == overrides_.end()) {
+    it = overrides_.insert(std::make_pair(
+        feature_name, OverrideEntry(for_overridden_state, nullptr))).first;
+  }
+
   // Only one associated field trial is supported per feature. This is generally
   // enforced server-side.
-  OverrideEntry* entry = &overrides_.find(feature_name)->second;
+  OverrideEntry* entry = &it->second;
   if (entry->field_trial) {
     NOTREACHED() << "Feature " << feature_name
                  << " already has trial: " << entry->field_trial->trial_name()
@@ -108,25 +175,19 @@ void FeatureList::GetFeatureOverrides(std::string* enable_overrides,
   // order. This not guaranteed to users of this function, but is useful for
   // tests to assume the order.
   for (const auto& entry : overrides_) {
-    std::string* target_list = nullptr;
-    switch (entry.second.overridden_state) {
-      case OVERRIDE_USE_DEFAULT:
-      case OVERRIDE_ENABLE_FEATURE:
-        target_list = enable_overrides;
-        break;
-      case OVERRIDE_DISABLE_FEATURE:
-        target_list = disable_overrides;
-        break;
-    }
+    AppendOverride(entry.first, entry.second.overridden_state,
+                   entry.second.field_trial, enable_overrides,
+                   disable_overrides);
+  }
 
-    if (!target_list->empty())
-      target_list->push_back(',');
-    if (entry.second.overridden_state == OVERRIDE_USE_DEFAULT)
-      target_list->push_back('*');
-    target_list->append(entry.first);
-    if (entry.second.field_trial) {
-      target_list->push_back('<');
-      target_list->append(entry.second.field_trial->trial_name());
+  if (!startup_snapshot_)
+    return;
+  for (size_t i = 0; i < startup_snapshot_->feature_override_count(); ++i) {
+    const StartupSnapshot::FeatureOverride entry =
+        startup_snapshot_->GetFeatureOverride(i);
+    if (!ContainsKey(overrides_, entry.feature_name.as_string())) {
+      AppendOverride(entry.feature_name, entry.state, nullptr,
+                     enable_overrides, disable_overrides);
     }
   }
 }
@@ -186,12 +247,14 @@ void FeatureList::SetInstance(std::unique_ptr<FeatureList> instance) {
 
   // Note: Intentional leak of global singleton.
   g_instance = instance.release();
+  subtle::Barrier_AtomicIncrement(&g_instance_generation, 1);
 }
 
 // static
 void FeatureList::ClearInstanceForTesting() {
   delete g_instance;
   g_instance = nullptr;
+  subtle::Barrier_AtomicIncrement(&g_instance_generation, 1);
 }
 
 void FeatureList::FinalizeInitialization() {
@@ -217,6 +280,12 @@ bool FeatureList::IsFeatureEnabled(const Feature& feature) {
     // If marked as OVERRIDE_USE_DEFAULT, simply return the default state below.
     if (entry.overridden_state != OVERRIDE_USE_DEFAULT)
       return entry.overridden_state == OVERRIDE_ENABLE_FEATURE;
+  } else {
+    OverrideState state;
+    if (FindSnapshotOverride(feature.name, &state) &&
+        state != OVERRIDE_USE_DEFAULT) {
+      return state == OVERRIDE_ENABLE_FEATURE;
+    }
   }
   // Otherwise, return the default state.
   return feature.default_state == FEATURE_ENABLED_BY_DEFAULT;
@@ -268,6 +337,12 @@ void FeatureList::RegisterOverride(StringPiece feature_name,
     overridden_state = OVERRIDE_USE_DEFAULT;
   }
 
+  // Overrides from the startup snapshot were registered first, so they take
+  // precedence like command-line ones.
+  OverrideState snapshot_state;
+  if (FindSnapshotOverride(feature_name, &snapshot_state))
+    return;
+
   // Note: The semantics of insert() is that it does not overwrite the entry if
   // one already exists for the key. Thus, only the first override for a given
   // feature name takes effect.
@@ -275,6 +350,17 @@ void FeatureList::RegisterOverride(StringPiece feature_name,
       feature_name.as_string(), OverrideEntry(overridden_state, field_trial)));
 }
 
+bool FeatureList::FindSnapshotOverride(StringPiece feature_name,
+                                       OverrideState* state) const {
+  StartupSnapshot::FeatureOverride entry;
+  if (!startup_snapshot_ ||
+      !startup_snapshot_->FindFeatureOverride(feature_name, &entry)) {
+    return false;
+  }
+  *state = entry.state;
+  return true;
+}
+
 bool FeatureList::CheckFeatureIdentity(const Feature& feature) {
   AutoLock auto_lock(feature_identity_tracker_lock_);
 
@@ -294,4 +380,18 @@ FeatureList::OverrideEntry::OverrideEntry(OverrideState overridden_state,
       field_trial(field_trial),
       overridden_by_field_trial(field_trial != nullptr) {}
 
+bool FeatureHandle::IsEnabled() {
+  const subtle::Atomic32 generation =
+      subtle::Acquire_Load(&g_instance_generation);
+  const subtle::Atomic32 state = subtle::NoBarrier_Load(&state_);
+  if (state >> 1 == generation)
+    return state & 1;
+
+  // Concurrent lookups store the same state, or a stale one that just makes
+  // the next call look the feature up again.
+  const bool enabled = FeatureList::IsEnabled(feature_);
+  subtle::NoBarrier_Store(&state_, generation << 1 | enabled);
+  return enabled;
+}
+
 }  // namespace base
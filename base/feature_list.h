@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
@@ -19,6 +20,7 @@
 namespace base {
 
 class FieldTrial;
+class StartupSnapshot;
 
 // Specifies whether a given feature is enabled or disabled by default.
 enum FeatureState {
@@ -92,6 +94,14 @@ class BASE_EXPORT FeatureList {
   void InitializeFromCommandLine(const std::string& enable_features,
                                  const std::string& disable_features);
 
+  // Initializes feature overrides from |snapshot|, with the same result as
+  // InitializeFromCommandLine() with the lists it was created from. Overrides
+  // aren't copied but looked up in |snapshot| instead, except those associated
+  // with a field trial, which must already exist (see
+  // StartupSnapshot::CreateFieldTrials()). Must only be invoked during the
+  // initialization phase.
+  void InitializeFromStartupSnapshot(std::unique_ptr<StartupSnapshot> snapshot);
+
   // Specifies whether a feature override enables or disables the feature.
   enum OverrideState {
     OVERRIDE_USE_DEFAULT,
@@ -100,7 +110,7 @@ class BASE_EXPORT FeatureList {
   };
 
   // Returns true if the state of |feature_name| has been overridden via
-  // |InitializeFromCommandLine()|.
+  // |InitializeFromCommandLine()| or |InitializeFromStartupSnapshot()|.
   bool IsFeatureOverriddenFromCommandLine(const std::string& feature_name,
                                           OverrideState state) const;
 
@@ -228,6 +238,11 @@ class BASE_EXPORT FeatureList {
                         OverrideState overridden_state,
                         FieldTrial* field_trial);
 
+  // Returns true if the startup snapshot overrides |feature_name|, and sets
+  // |state| to the override.
+  bool FindSnapshotOverride(StringPiece feature_name,
+                            OverrideState* state) const;
+
   // Verifies that there's only a single definition of a Feature struct for a
   // given feature name. Keeps track of the first seen Feature struct for each
   // feature. Returns false when called on a Feature struct with a different
@@ -239,6 +254,10 @@ class BASE_EXPORT FeatureList {
   // exists.
   std::map<std::string, OverrideEntry> overrides_;
 
+  // Overrides from InitializeFromStartupSnapshot(), when they aren't in
+  // |overrides_|.
+  std::unique_ptr<StartupSnapshot> startup_snapshot_;
+
   // Locked map that keeps track of seen features, to ensure a single feature is
   // only defined once. This verification is only done in builds with DCHECKs
   // enabled.
@@ -255,6 +274,40 @@ class BASE_EXPORT FeatureList {
   DISALLOW_COPY_AND_ASSIGN(FeatureList);
 };
 
+// A handle to a Feature, for code that checks it on hot paths. The state of
+// the feature is looked up with FeatureList::IsEnabled() the first time, which
+// activates its field trial, and is then read from the handle with a single
+// atomic load, until another FeatureList instance is registered:
+//
+//   const base::Feature kMyGreatFeature {
+//     "MyGreatFeature", base::FEATURE_ENABLED_BY_DEFAULT
+//   };
+//   base::FeatureHandle g_my_great_feature(kMyGreatFeature);
+//
+//   if (g_my_great_feature.IsEnabled()) {
+//     // Feature code goes here.
+//   }
+//
+// The constructor is constexpr and there is no destructor, so handles can be
+// globals without static initializers. IsEnabled() is thread safe.
+class BASE_EXPORT FeatureHandle {
+ public:
+  constexpr explicit FeatureHandle(const Feature& feature)
+      : feature_(feature), state_(0) {}
+
+  // Returns whether the feature is enabled, as FeatureList::IsEnabled() does.
+  bool IsEnabled();
+
+ private:
+  const Feature& feature_;
+
+  // The FeatureList instance generation the state was looked up at, times
+  // two, plus one if the feature is enabled. Generations start at 1.
+  subtle::Atomic32 state_;
+
+  DISALLOW_COPY_AND_ASSIGN(FeatureHandle);
+};
+
 }  // namespace base
 
 #endif  // BASE_FEATURE_LIST_H_
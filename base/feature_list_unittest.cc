@@ -13,6 +13,7 @@
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/field_trial.h"
+#include "base/startup_snapshot.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -438,6 +439,81 @@ TEST_F(FeatureListTest, InitializeFromCommandLine_UseDefault) {
   EXPECT_TRUE(FieldTrialList::IsTrialActive("T2"));
 }
 
+TEST_F(FeatureListTest, InitializeFromStartupSnapshot) {
+  struct {
+    const char* enable_features;
+    const char* disable_features;
+    bool expected_feature_on_state;
+    bool expected_feature_off_state;
+  } test_cases[] = {
+      {"", "", true, false},
+      {"OffByDefault", "", true, true},
+      {"OffByDefault", "OnByDefault", false, true},
+      {"", "OnByDefault,OffByDefault", false, false},
+      // In the case an entry is both, disable takes precedence.
+      {"OnByDefault", "OnByDefault,OffByDefault", false, false},
+      {"*OffByDefault", "", true, false},
+  };
+
+  for (size_t i = 0; i < arraysize(test_cases); ++i) {
+    const auto& test_case = test_cases[i];
+    SCOPED_TRACE(base::StringPrintf("Test[%" PRIuS "]: [%s] [%s]", i,
+                                    test_case.enable_features,
+                                    test_case.disable_features));
+
+    ClearFeatureListInstance();
+    const std::string snapshot_data = StartupSnapshot::Create(
+        "", test_case.enable_features, test_case.disable_features);
+    std::unique_ptr<FeatureList> feature_list(new FeatureList);
+    feature_list->InitializeFromStartupSnapshot(
+        StartupSnapshot::FromMemory(snapshot_data.data(),
+                                    snapshot_data.size()));
+    RegisterFeatureListInstance(std::move(feature_list));
+
+    EXPECT_EQ(test_case.expected_feature_on_state,
+              FeatureList::IsEnabled(kFeatureOnByDefault));
+    EXPECT_EQ(test_case.expected_feature_off_state,
+              FeatureList::IsEnabled(kFeatureOffByDefault));
+    ClearFeatureListInstance();
+  }
+}
+
+TEST_F(FeatureListTest, InitializeFromStartupSnapshot_WithFieldTrials) {
+  ClearFeatureListInstance();
+  FieldTrialList field_trial_list(nullptr);
+  const std::string snapshot_data = StartupSnapshot::Create(
+      "Trial/Group/", "A,OffByDefault<Trial,X", "D");
+  std::unique_ptr<StartupSnapshot> snapshot =
+      StartupSnapshot::FromMemory(snapshot_data.data(), snapshot_data.size());
+  ASSERT_TRUE(snapshot);
+  EXPECT_TRUE(snapshot->CreateFieldTrials());
+
+  std::unique_ptr<FeatureList> feature_list(new FeatureList);
+  feature_list->InitializeFromStartupSnapshot(std::move(snapshot));
+  EXPECT_TRUE(feature_list->IsFeatureOverriddenFromCommandLine(
+      "A", FeatureList::OVERRIDE_ENABLE_FEATURE));
+  EXPECT_FALSE(feature_list->IsFeatureOverriddenFromCommandLine(
+      "A", FeatureList::OVERRIDE_DISABLE_FEATURE));
+
+  // The snapshot takes precedence over field trials, like the command-line.
+  FieldTrial* trial = FieldTrialList::CreateFieldTrial("Trial2", "A");
+  feature_list->RegisterFieldTrialOverride(
+      "D", FeatureList::OVERRIDE_ENABLE_FEATURE, trial);
+  RegisterFeatureListInstance(std::move(feature_list));
+
+  EXPECT_FALSE(FieldTrialList::IsTrialActive("Trial"));
+  EXPECT_TRUE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  EXPECT_TRUE(FieldTrialList::IsTrialActive("Trial"));
+
+  std::string enable_features;
+  std::string disable_features;
+  FeatureList::GetInstance()->GetFeatureOverrides(&enable_features,
+                                                  &disable_features);
+  EXPECT_EQ("A,OffByDefault<Trial,X", SortFeatureListString(enable_features));
+  EXPECT_EQ("D", SortFeatureListString(disable_features));
+  ClearFeatureListInstance();
+}
+
 TEST_F(FeatureListTest, InitializeInstance) {
   ClearFeatureListInstance();
 
@@ -457,4 +533,30 @@ TEST_F(FeatureListTest, InitializeInstance) {
   EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
 }
 
+TEST_F(FeatureListTest, FeatureHandle) {
+  FeatureHandle on_handle(kFeatureOnByDefault);
+  FeatureHandle off_handle(kFeatureOffByDefault);
+  EXPECT_TRUE(on_handle.IsEnabled());
+  EXPECT_FALSE(off_handle.IsEnabled());
+  EXPECT_TRUE(on_handle.IsEnabled());
+  EXPECT_FALSE(off_handle.IsEnabled());
+
+  // Handles look their feature up again in a new instance, and activate its
+  // field trial when they do.
+  ClearFeatureListInstance();
+  FieldTrialList field_trial_list(nullptr);
+  FieldTrial* trial = FieldTrialList::CreateFieldTrial("TrialExample", "A");
+  std::unique_ptr<FeatureList> feature_list(new FeatureList);
+  feature_list->RegisterFieldTrialOverride(
+      kFeatureOnByDefaultName, FeatureList::OVERRIDE_DISABLE_FEATURE, trial);
+  feature_list->InitializeFromCommandLine(kFeatureOffByDefaultName, "");
+  RegisterFeatureListInstance(std::move(feature_list));
+
+  EXPECT_FALSE(FieldTrialList::IsTrialActive(trial->trial_name()));
+  EXPECT_FALSE(on_handle.IsEnabled());
+  EXPECT_TRUE(FieldTrialList::IsTrialActive(trial->trial_name()));
+  EXPECT_FALSE(on_handle.IsEnabled());
+  EXPECT_TRUE(off_handle.IsEnabled());
+}
+
 }  // namespace base
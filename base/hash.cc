@@ -4,6 +4,10 @@
 
 #include "base/hash.h"
 
+#include <string.h>
+
+#include "base/sys_byteorder.h"
+
 // Definition in base/third_party/superfasthash/superfasthash.c. (Third-party
 // code did not come with its own header file, so declaring the function here.)
 // Note: This algorithm is also in Blink under Source/wtf/StringHasher.h.
@@ -11,6 +15,44 @@ extern "C" uint32_t SuperFastHash(const char* data, int len);
 
 namespace base {
 
+namespace {
+
+// The XXH64 primes.
+const uint64_t kPrime1 = UINT64_C(0x9E3779B185EBCA87);
+const uint64_t kPrime2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+const uint64_t kPrime3 = UINT64_C(0x165667B19E3779F9);
+const uint64_t kPrime4 = UINT64_C(0x85EBCA77C2B2AE63);
+const uint64_t kPrime5 = UINT64_C(0x27D4EB2F165667C5);
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// Reads in little-endian order, so that the hash is the same everywhere.
+inline uint64_t Read64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return ByteSwapToLE64(value);
+}
+
+inline uint32_t Read32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return ByteSwapToLE32(value);
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * kPrime2;
+  return RotateLeft(accumulator, 31) * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+  hash ^= Round(0, accumulator);
+  return hash * kPrime1 + kPrime4;
+}
+
+}  // namespace
+
 uint32_t SuperFastHash(const char* data, size_t length) {
   if (length > static_cast<size_t>(std::numeric_limits<int>::max())) {
     NOTREACHED();
@@ -19,4 +61,59 @@ uint32_t SuperFastHash(const char* data, size_t length) {
   return ::SuperFastHash(data, static_cast<int>(length));
 }
 
+uint64_t Hash64(const void* data, size_t length, uint64_t seed) {
+  const uint8_t* input = static_cast<const uint8_t*>(data);
+  const uint8_t* const end = input + length;
+  uint64_t hash;
+
+  if (length >= 32) {
+    // Four independent lanes, which keeps several multipliers busy.
+    uint64_t lane1 = seed + kPrime1 + kPrime2;
+    uint64_t lane2 = seed + kPrime2;
+    uint64_t lane3 = seed;
+    uint64_t lane4 = seed - kPrime1;
+    const uint8_t* const last_stripe = end - 32;
+    do {
+      lane1 = Round(lane1, Read64(input));
+      lane2 = Round(lane2, Read64(input + 8));
+      lane3 = Round(lane3, Read64(input + 16));
+      lane4 = Round(lane4, Read64(input + 24));
+      input += 32;
+    } while (input <= last_stripe);
+
+    hash = RotateLeft(lane1, 1) + RotateLeft(lane2, 7) +
+           RotateLeft(lane3, 12) + RotateLeft(lane4, 18);
+    hash = MergeRound(hash, lane1);
+    hash = MergeRound(hash, lane2);
+    hash = MergeRound(hash, lane3);
+    hash = MergeRound(hash, lane4);
+  } else {
+    hash = seed + kPrime5;
+  }
+
+  hash += static_cast<uint64_t>(length);
+
+  for (; input + 8 <= end; input += 8) {
+    hash ^= Round(0, Read64(input));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+  }
+  if (input + 4 <= end) {
+    hash ^= static_cast<uint64_t>(Read32(input)) * kPrime1;
+    hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+    input += 4;
+  }
+  for (; input < end; ++input) {
+    hash ^= *input * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+  }
+
+  // Final avalanche.
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
 }  // namespace base
@@ -0,0 +1,64 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/hash.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Input lengths to measure, from short keys to URLs to whole buffers.
+const size_t kLengths[] = {8, 32, 128, 1024, 64 * 1024};
+
+// Roughly the number of bytes hashed by each measurement.
+const size_t kBytesPerMeasurement = 256 * 1024 * 1024;
+
+template <class HashFunction>
+void RunHash(const std::string& name, HashFunction hash_function) {
+  for (size_t length : kLengths) {
+    const std::string data = RandBytesAsString(length);
+    const size_t rounds = kBytesPerMeasurement / length;
+    uint64_t sum = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (size_t round = 0; round < rounds; ++round)
+      sum += hash_function(data.data(), length);
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+    perf_test::PrintResult(
+        name, "", "length_" + SizeTToString(length),
+        kBytesPerMeasurement / elapsed.InSecondsF() / (1024 * 1024), "MB/s",
+        true);
+    // Keeps the compiler from dropping the loop.
+    EXPECT_NE(0u, sum + 1);
+  }
+}
+
+uint64_t SuperFastHashAdapter(const char* data, size_t length) {
+  return SuperFastHash(data, length);
+}
+
+uint64_t Hash64Adapter(const char* data, size_t length) {
+  return Hash64(data, length);
+}
+
+}  // namespace
+
+TEST(HashPerfTest, SuperFastHash) {
+  RunHash("super_fast_hash", &SuperFastHashAdapter);
+}
+
+TEST(HashPerfTest, Hash64) {
+  RunHash("hash64", &Hash64Adapter);
+}
+
+}  // namespace base
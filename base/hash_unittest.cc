@@ -4,6 +4,7 @@
 
 #include "base/hash.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -79,4 +80,35 @@ TEST(HashTest, CString) {
   EXPECT_EQ(2794219650u, Hash(str, strlen("hello world")));
 }
 
+TEST(HashTest, Hash64) {
+  // Reference values of XXH64.
+  EXPECT_EQ(UINT64_C(0xEF46DB3751D8E999), Hash64(""));
+  EXPECT_EQ(UINT64_C(0xD24EC4F1A98C6E5B), Hash64("a"));
+  EXPECT_EQ(UINT64_C(0x44BC2CF5AD770999), Hash64("abc"));
+  EXPECT_EQ(UINT64_C(0xFBCEA83C8A378BF1),
+            Hash64("Nobody inspects the spammish repetition"));
+
+  // The seed changes the hash.
+  EXPECT_NE(Hash64("abc", 3, 0), Hash64("abc", 3, 1));
+  EXPECT_EQ(Hash64("abc", 3, 1), Hash64("abc", 3, 1));
+
+  // Ensure that it stops reading after the given length.
+  const char kStr[] = "hello world; don't read this part";
+  EXPECT_EQ(Hash64(std::string("hello world")), Hash64(kStr, 11));
+
+  // All lengths up to a few stripes of 32 bytes give distinct hashes, and
+  // every byte contributes.
+  std::string data;
+  std::set<uint64_t> hashes;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(hashes.insert(Hash64(data)).second) << i;
+    if (i) {
+      std::string changed = data;
+      changed[i / 2] ^= 0x80;
+      EXPECT_NE(Hash64(data), Hash64(changed)) << i;
+    }
+    data.push_back(static_cast<char>(i * 7));
+  }
+}
+
 }  // namespace base
@@ -9,7 +9,7 @@
 #include <stdint.h>
 #include <set>
 
-#include "base/containers/hash_tables.h"
+#include "base/containers/flat_hash_map.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/sequence_checker.h"
@@ -40,7 +40,7 @@ class IDMap {
   using KeyType = K;
 
  private:
-  typedef base::hash_map<KeyType, T*> HashTable;
+  typedef base::flat_hash_map<KeyType, T*> HashTable;
 
  public:
   IDMap() : iteration_depth_(0), next_id_(1), check_on_null_data_(false) {
@@ -67,6 +67,7 @@ class IDMap {
   KeyType Add(T* data) {
     DCHECK(sequence_checker_.CalledOnValidSequencedThread());
     DCHECK(!check_on_null_data_ || data);
+    DCHECK_EQ(0, iteration_depth_) << "Adding would invalidate iterators";
     KeyType this_id = next_id_;
     DCHECK(data_.find(this_id) == data_.end()) << "Inserting duplicate item";
     data_[this_id] = data;
@@ -81,6 +82,7 @@ class IDMap {
   void AddWithID(T* data, KeyType id) {
     DCHECK(sequence_checker_.CalledOnValidSequencedThread());
     DCHECK(!check_on_null_data_ || data);
+    DCHECK_EQ(0, iteration_depth_) << "Adding would invalidate iterators";
     DCHECK(data_.find(id) == data_.end()) << "Inserting duplicate item";
     data_[id] = data;
   }
@@ -156,7 +158,8 @@ class IDMap {
 #endif  // defined(UNIT_TEST)
 
   // It is safe to remove elements from the map during iteration. All iterators
-  // will remain valid.
+  // will remain valid. Adding elements during iteration is not allowed, since
+  // growing the table would invalidate the iterators.
   template<class ReturnType>
   class Iterator {
    public:
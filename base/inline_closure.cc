@@ -0,0 +1,55 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/inline_closure.h"
+
+#include "base/logging.h"
+
+namespace base {
+
+InlineClosure::InlineClosure() = default;
+
+InlineClosure::InlineClosure(Closure closure) {
+  if (closure.is_null())
+    return;
+  new (storage_.void_data()) internal::ClosureInlineState(std::move(closure));
+  ops_ = &internal::InlineClosureOpsFor<internal::ClosureInlineState>::kOps;
+}
+
+InlineClosure::InlineClosure(InlineClosure&& other) {
+  *this = std::move(other);
+}
+
+InlineClosure& InlineClosure::operator=(InlineClosure&& other) {
+  if (this == &other)
+    return *this;
+  Reset();
+  if (other.ops_) {
+    other.ops_->move(other.storage_.void_data(), storage_.void_data());
+    ops_ = other.ops_;
+    other.ops_ = nullptr;
+  }
+  return *this;
+}
+
+InlineClosure::~InlineClosure() {
+  Reset();
+}
+
+void InlineClosure::Reset() {
+  if (!ops_)
+    return;
+  // Clear |ops_| first, since the bound state may hold the last ref to
+  // whatever object owns us, and we may be deleted after that.
+  const internal::InlineClosureOps* ops = ops_;
+  ops_ = nullptr;
+  ops->destroy(storage_.void_data());
+}
+
+void InlineClosure::Run() const {
+  DCHECK(ops_);
+  ops_->run(storage_.void_data());
+}
+
+}  // namespace base
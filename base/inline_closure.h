@@ -0,0 +1,234 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// InlineClosure is a move-only alternative to Closure which stores its functor
+// and bound arguments in a fixed buffer inside the InlineClosure object, rather
+// than in a heap-allocated, refcounted BindState. It is created by
+// BindInline(), which accepts the same functors, bound arguments and wrappers
+// (Unretained(), Owned(), Passed(), WeakPtr receivers...) as Bind() for a
+// closure that takes no unbound arguments:
+//
+//   InlineClosure task = BindInline(&Foo::Bar, weak_factory_.GetWeakPtr(), 42);
+//   ...
+//   task.Run();
+//
+// Storing an InlineClosure in a container (e.g. a std::deque<InlineClosure>
+// used as a task queue) costs no allocation beyond the container's own. When
+// the bound state doesn't fit in the buffer, BindInline() falls back to Bind()
+// and the InlineClosure stores the resulting Closure, which does allocate.
+//
+// Unlike a Closure, an InlineClosure can't be copied: its bound arguments are
+// owned by exactly one object. Moving an InlineClosure moves its bound
+// arguments.
+
+#ifndef BASE_INLINE_CLOSURE_H_
+#define BASE_INLINE_CLOSURE_H_
+
+#include <stddef.h>
+
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/bind_internal.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/macros.h"
+#include "base/memory/aligned_memory.h"
+#include "base/tuple.h"
+
+namespace base {
+
+namespace internal {
+
+// Type-erased operations on the state stored in an InlineClosure. There is one
+// static instance per stored type.
+struct InlineClosureOps {
+  // Runs the stored functor.
+  void (*run)(void* state);
+
+  // Move-constructs the state at |to| from the state at |from|, then destroys
+  // the state at |from|.
+  void (*move)(void* from, void* to);
+
+  void (*destroy)(void* state);
+
+  // True if the stored state refers to a heap-allocated BindState.
+  bool has_bind_state;
+};
+
+template <typename State>
+struct InlineClosureOpsFor {
+  static void Run(void* state) { static_cast<State*>(state)->Run(); }
+
+  static void Move(void* from, void* to) {
+    State* from_state = static_cast<State*>(from);
+    new (to) State(std::move(*from_state));
+    from_state->~State();
+  }
+
+  static void Destroy(void* state) { static_cast<State*>(state)->~State(); }
+
+  static const InlineClosureOps kOps;
+};
+
+template <typename State>
+const InlineClosureOps InlineClosureOpsFor<State>::kOps = {
+    &InlineClosureOpsFor<State>::Run, &InlineClosureOpsFor<State>::Move,
+    &InlineClosureOpsFor<State>::Destroy, State::kHasBindState};
+
+// State of an InlineClosure created from a Closure.
+struct ClosureInlineState {
+  static constexpr bool kHasBindState = true;
+
+  explicit ClosureInlineState(Closure closure) : closure(std::move(closure)) {}
+
+  void Run() { closure.Run(); }
+
+  Closure closure;
+};
+
+// State of an InlineClosure created by BindInline(). The equivalent of a
+// BindState<> without the refcount.
+template <bool is_weak_call, typename Runnable, typename BoundArgsTuple>
+struct InlineBindState {
+  static constexpr bool kHasBindState = false;
+
+  template <typename... ForwardArgs>
+  explicit InlineBindState(Runnable runnable, ForwardArgs&&... bound_args)
+      : runnable_(std::move(runnable)),
+        bound_args_(std::forward<ForwardArgs>(bound_args)...) {}
+
+  void Run() {
+    RunImpl(MakeIndexSequence<std::tuple_size<BoundArgsTuple>::value>());
+  }
+
+  template <size_t... bound_indices>
+  void RunImpl(IndexSequence<bound_indices...>) {
+    InvokeHelper<is_weak_call, void>::MakeItSo(
+        runnable_, Unwrap(std::get<bound_indices>(bound_args_))...);
+  }
+
+  Runnable runnable_;
+  BoundArgsTuple bound_args_;
+};
+
+}  // namespace internal
+
+class BASE_EXPORT InlineClosure {
+ public:
+  // Size of the buffer which holds the bound state. Fits a method pointer, a
+  // WeakPtr receiver and a few words of arguments.
+  enum { kInlineStorageSize = 6 * sizeof(void*) };
+
+  InlineClosure();
+
+  // Stores |closure|, which shares its BindState with other copies of it.
+  explicit InlineClosure(Closure closure);
+
+  InlineClosure(InlineClosure&& other);
+  InlineClosure& operator=(InlineClosure&& other);
+
+  ~InlineClosure();
+
+  bool is_null() const { return !ops_; }
+
+  // Destroys the bound state and makes this InlineClosure null.
+  void Reset();
+
+  void Run() const;
+
+  // Returns true if this InlineClosure refers to a heap-allocated BindState,
+  // i.e. it was constructed from a Closure or its bound state didn't fit
+  // inline.
+  bool has_bind_state() const { return ops_ && ops_->has_bind_state; }
+
+  // Constructs an InlineClosure which stores a State constructed from |args|.
+  // Use BindInline() instead.
+  template <typename State, typename... Args>
+  static InlineClosure CreateForBindInline(Args&&... args) {
+    static_assert(sizeof(State) <= kInlineStorageSize,
+                  "bound state doesn't fit inline");
+    static_assert(ALIGNOF(State) <= ALIGNOF(void*),
+                  "bound state is overaligned");
+    InlineClosure inline_closure;
+    new (inline_closure.storage_.void_data())
+        State(std::forward<Args>(args)...);
+    inline_closure.ops_ = &internal::InlineClosureOpsFor<State>::kOps;
+    return inline_closure;
+  }
+
+ private:
+  const internal::InlineClosureOps* ops_ = nullptr;
+
+  // mutable so that Run() can be const like Callback::Run(), which runs the
+  // functor on a non-const BindState.
+  mutable AlignedMemory<kInlineStorageSize, ALIGNOF(void*)> storage_;
+
+  DISALLOW_COPY_AND_ASSIGN(InlineClosure);
+};
+
+namespace internal {
+
+template <typename State, typename Functor, typename... Args>
+InlineClosure BindInlineImpl(std::true_type /* fits_inline */,
+                             Functor functor,
+                             Args&&... args) {
+  return InlineClosure::CreateForBindInline<State>(
+      MakeRunnable(functor), std::forward<Args>(args)...);
+}
+
+template <typename State, typename Functor, typename... Args>
+InlineClosure BindInlineImpl(std::false_type /* fits_inline */,
+                             Functor functor,
+                             Args&&... args) {
+  return InlineClosure(Bind(functor, std::forward<Args>(args)...));
+}
+
+}  // namespace internal
+
+// Binds |args| to |functor| like Bind() and returns an InlineClosure.
+template <typename Functor, typename... Args>
+InlineClosure BindInline(Functor functor, Args&&... args) {
+  using RunnableType = typename internal::FunctorTraits<Functor>::RunnableType;
+  using BoundRunType = typename RunnableType::RunType;
+  using BoundArgs =
+      internal::TakeTypeListItem<sizeof...(Args),
+                                 internal::ExtractArgs<BoundRunType>>;
+
+  // Same restrictions as Bind(). See base/bind.h.
+  static_assert(std::is_same<MakeUnboundRunType<Functor, Args...>,
+                             void()>::value,
+                "BindInline() must bind all arguments of a void function");
+  static_assert(!internal::HasNonConstReferenceItem<BoundArgs>::value,
+                "do not bind functions with nonconst ref");
+
+  const bool is_method = internal::HasIsMethodTag<RunnableType>::value;
+  static_assert(!internal::BindsArrayToFirstArg<is_method, Args...>::value,
+                "first bound argument to method cannot be array");
+  static_assert(
+      !internal::HasRefCountedParamAsRawPtr<is_method, Args...>::value,
+      "a parameter is a refcounted type and needs scoped_refptr");
+
+  const bool is_weak_call =
+      internal::IsWeakMethod<is_method,
+                             typename std::decay<Args>::type...>::value;
+  using State = internal::InlineBindState<
+      is_weak_call, RunnableType,
+      internal::MakeArgsStorage<is_method, Args...>>;
+  using FitsInline = std::integral_constant<
+      bool, sizeof(State) <= InlineClosure::kInlineStorageSize &&
+                ALIGNOF(State) <= ALIGNOF(void*)>;
+
+  return internal::BindInlineImpl<State>(FitsInline(), functor,
+                                         std::forward<Args>(args)...);
+}
+
+}  // namespace base
+
+#endif  // BASE_INLINE_CLOSURE_H_
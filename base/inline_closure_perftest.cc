@@ -0,0 +1,109 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <deque>
+#include <string>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/inline_closure.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Number of closures bound, queued and run.
+const int kNumClosures = 1000 * 1000;
+
+// Number of closures in the queue at any time, like a busy task queue.
+const int kQueueLength = 100;
+
+class Counter {
+ public:
+  Counter() : weak_factory_(this) {}
+
+  void Add(int value) { sum_ += value; }
+
+  int sum() const { return sum_; }
+
+  WeakPtr<Counter> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+
+ private:
+  int sum_ = 0;
+  WeakPtrFactory<Counter> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(Counter);
+};
+
+Closure BindWeakClosure(Counter* counter) {
+  return Bind(&Counter::Add, counter->GetWeakPtr(), 1);
+}
+
+InlineClosure BindWeakInlineClosure(Counter* counter) {
+  return BindInline(&Counter::Add, counter->GetWeakPtr(), 1);
+}
+
+Closure BindUnretainedClosure(Counter* counter) {
+  return Bind(&Counter::Add, Unretained(counter), 1);
+}
+
+InlineClosure BindUnretainedInlineClosure(Counter* counter) {
+  return BindInline(&Counter::Add, Unretained(counter), 1);
+}
+
+// Binds closures with |bind| and runs them through a queue.
+template <typename ClosureType>
+void RunBindQueueRun(ClosureType (*bind)(Counter*),
+                     const std::string& trace) {
+  Counter counter;
+  std::deque<ClosureType> queue;
+
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kQueueLength; ++i)
+    queue.push_back(bind(&counter));
+  for (int i = kQueueLength; i < kNumClosures; ++i) {
+    queue.front().Run();
+    queue.pop_front();
+    queue.push_back(bind(&counter));
+  }
+  while (!queue.empty()) {
+    queue.front().Run();
+    queue.pop_front();
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_EQ(kNumClosures, counter.sum());
+  perf_test::PrintResult("bind_queue_run", "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / kNumClosures,
+                         "ns/closure", true);
+}
+
+}  // namespace
+
+// A WeakPtr receiver and an int, the typical shape of a posted task.
+TEST(InlineClosurePerfTest, WeakClosure) {
+  RunBindQueueRun<Closure>(&BindWeakClosure, "weak_closure");
+}
+
+TEST(InlineClosurePerfTest, WeakInlineClosure) {
+  RunBindQueueRun<InlineClosure>(&BindWeakInlineClosure,
+                                 "weak_inline_closure");
+}
+
+// Without the cost of WeakPtr checks, the BindState allocation dominates.
+TEST(InlineClosurePerfTest, UnretainedClosure) {
+  RunBindQueueRun<Closure>(&BindUnretainedClosure, "unretained_closure");
+}
+
+TEST(InlineClosurePerfTest, UnretainedInlineClosure) {
+  RunBindQueueRun<InlineClosure>(&BindUnretainedInlineClosure,
+                                 "unretained_inline_closure");
+}
+
+}  // namespace base
@@ -0,0 +1,214 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/inline_closure.h"
+
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+void Append(std::vector<int>* values, int value) {
+  values->push_back(value);
+}
+
+void AppendSum(std::vector<int>* values, int a, int b, int c) {
+  values->push_back(a + b + c);
+}
+
+void AppendUniquePtr(std::vector<int>* values, std::unique_ptr<int> value) {
+  values->push_back(*value);
+}
+
+struct LargeArgument {
+  int values[32];
+};
+
+void AppendLargeArgument(std::vector<int>* values,
+                         const LargeArgument& large) {
+  values->push_back(large.values[31]);
+}
+
+class Appender {
+ public:
+  explicit Appender(std::vector<int>* values)
+      : values_(values), weak_factory_(this) {}
+
+  void Append(int value) { values_->push_back(value); }
+
+  WeakPtr<Appender> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+
+  void InvalidateWeakPtrs() { weak_factory_.InvalidateWeakPtrs(); }
+
+ private:
+  std::vector<int>* const values_;
+  WeakPtrFactory<Appender> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(Appender);
+};
+
+class RefCountedAppender : public RefCounted<RefCountedAppender> {
+ public:
+  explicit RefCountedAppender(std::vector<int>* values) : values_(values) {}
+
+  void Append(int value) { values_->push_back(value); }
+
+ private:
+  friend class RefCounted<RefCountedAppender>;
+  ~RefCountedAppender() = default;
+
+  std::vector<int>* const values_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefCountedAppender);
+};
+
+class DeleteCounter {
+ public:
+  explicit DeleteCounter(int* deletes) : deletes_(deletes) {}
+  ~DeleteCounter() { ++(*deletes_); }
+
+  void VoidMethod0() {}
+
+ private:
+  int* const deletes_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeleteCounter);
+};
+
+}  // namespace
+
+TEST(InlineClosureTest, Null) {
+  InlineClosure inline_closure;
+  EXPECT_TRUE(inline_closure.is_null());
+  EXPECT_FALSE(inline_closure.has_bind_state());
+
+  InlineClosure from_null_closure((Closure()));
+  EXPECT_TRUE(from_null_closure.is_null());
+}
+
+TEST(InlineClosureTest, FunctionWithBoundArguments) {
+  std::vector<int> values;
+  InlineClosure inline_closure = BindInline(&AppendSum, &values, 1, 2, 3);
+  EXPECT_FALSE(inline_closure.is_null());
+  EXPECT_FALSE(inline_closure.has_bind_state());
+
+  inline_closure.Run();
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{6, 6}), values);
+}
+
+TEST(InlineClosureTest, Unretained) {
+  std::vector<int> values;
+  Appender appender(&values);
+  InlineClosure inline_closure =
+      BindInline(&Appender::Append, Unretained(&appender), 1);
+  EXPECT_FALSE(inline_closure.has_bind_state());
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{1}), values);
+}
+
+TEST(InlineClosureTest, WeakPtr) {
+  std::vector<int> values;
+  Appender appender(&values);
+  InlineClosure inline_closure =
+      BindInline(&Appender::Append, appender.GetWeakPtr(), 1);
+  EXPECT_FALSE(inline_closure.has_bind_state());
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{1}), values);
+
+  // Like Bind(), the call is skipped once the WeakPtr is invalidated.
+  appender.InvalidateWeakPtrs();
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{1}), values);
+}
+
+TEST(InlineClosureTest, RefCountedReceiver) {
+  std::vector<int> values;
+  RefCountedAppender* appender = new RefCountedAppender(&values);
+  scoped_refptr<RefCountedAppender> ref(appender);
+  InlineClosure inline_closure =
+      BindInline(&RefCountedAppender::Append, appender, 1);
+  EXPECT_FALSE(appender->HasOneRef());
+
+  inline_closure.Reset();
+  EXPECT_TRUE(inline_closure.is_null());
+  EXPECT_TRUE(appender->HasOneRef());
+}
+
+TEST(InlineClosureTest, Owned) {
+  int deletes = 0;
+  InlineClosure inline_closure = BindInline(
+      &DeleteCounter::VoidMethod0, Owned(new DeleteCounter(&deletes)));
+  inline_closure.Run();
+  EXPECT_EQ(0, deletes);
+
+  // Moving the InlineClosure moves ownership.
+  InlineClosure moved(std::move(inline_closure));
+  EXPECT_TRUE(inline_closure.is_null());
+  EXPECT_EQ(0, deletes);
+  moved.Run();
+
+  moved.Reset();
+  EXPECT_EQ(1, deletes);
+}
+
+TEST(InlineClosureTest, Passed) {
+  std::vector<int> values;
+  InlineClosure inline_closure = BindInline(
+      &AppendUniquePtr, &values, Passed(WrapUnique(new int(42))));
+  InlineClosure moved;
+  moved = std::move(inline_closure);
+  EXPECT_TRUE(inline_closure.is_null());
+  moved.Run();
+  EXPECT_EQ((std::vector<int>{42}), values);
+}
+
+TEST(InlineClosureTest, FromClosure) {
+  std::vector<int> values;
+  InlineClosure inline_closure(Bind(&Append, &values, 1));
+  EXPECT_TRUE(inline_closure.has_bind_state());
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{1}), values);
+}
+
+TEST(InlineClosureTest, LargeBoundStateFallsBackToBind) {
+  std::vector<int> values;
+  LargeArgument large = {};
+  large.values[31] = 31;
+  InlineClosure inline_closure =
+      BindInline(&AppendLargeArgument, &values, large);
+  EXPECT_TRUE(inline_closure.has_bind_state());
+  inline_closure.Run();
+  EXPECT_EQ((std::vector<int>{31}), values);
+}
+
+TEST(InlineClosureTest, Queue) {
+  std::vector<int> values;
+  Appender appender(&values);
+  std::deque<InlineClosure> queue;
+  for (int i = 0; i < 100; ++i)
+    queue.push_back(BindInline(&Appender::Append, appender.GetWeakPtr(), i));
+
+  std::vector<int> expected_values;
+  for (int i = 0; i < 100; ++i) {
+    queue.front().Run();
+    queue.pop_front();
+    expected_values.push_back(i);
+  }
+  EXPECT_EQ(expected_values, values);
+}
+
+}  // namespace base
@@ -0,0 +1,293 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_document.h"
+
+#include <limits>
+
+#include "base/json/json_parser.h"
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+
+namespace base {
+
+// Appends the nodes of the values reported by the parser to a document.
+class JSONDocument::Builder : public JSONReaderHandler {
+ public:
+  Builder(StringPiece input, JSONDocument* document)
+      : input_(input), document_(document) {}
+  ~Builder() override {}
+
+  // JSONReaderHandler:
+  void OnNull() override { AddNode(Value::TYPE_NULL); }
+
+  void OnBoolean(bool value) override {
+    AddNode(Value::TYPE_BOOLEAN)->boolean_value = value;
+  }
+
+  void OnInteger(int value) override {
+    AddNode(Value::TYPE_INTEGER)->integer_value = value;
+  }
+
+  void OnDouble(double value) override {
+    AddNode(Value::TYPE_DOUBLE)->double_value = value;
+  }
+
+  void OnString(StringPiece value) override { AddString(value); }
+
+  void OnDictionaryBegin() override { OpenContainer(Value::TYPE_DICTIONARY); }
+
+  void OnDictionaryKey(StringPiece key) override {
+    ++document_->nodes_[open_containers_.back()].size;
+    AddString(key);
+  }
+
+  void OnDictionaryEnd() override { CloseContainer(); }
+
+  void OnListBegin() override { OpenContainer(Value::TYPE_LIST); }
+
+  void OnListEnd() override { CloseContainer(); }
+
+ private:
+  // Appends a node of |type| that has no descendants. The node is counted as
+  // an item of its parent if that is a list; members of dictionaries are
+  // counted by their key.
+  Node* AddNode(Value::Type type) {
+    std::vector<Node>& nodes = document_->nodes_;
+    DCHECK_LT(nodes.size(), std::numeric_limits<uint32_t>::max());
+    if (!open_containers_.empty() &&
+        nodes[open_containers_.back()].type == Value::TYPE_LIST) {
+      ++nodes[open_containers_.back()].size;
+    }
+    nodes.push_back(Node());
+    Node* node = &nodes.back();
+    node->type = type;
+    node->is_decoded = false;
+    node->size = 0;
+    node->end = static_cast<uint32_t>(nodes.size());
+    return node;
+  }
+
+  void AddString(StringPiece value) {
+    Node* node = AddNode(Value::TYPE_STRING);
+    node->size = static_cast<uint32_t>(value.size());
+
+    // The parser only copies strings that had escape sequences. Compare
+    // addresses as integers, as |value| may not point into |input_|.
+    uintptr_t begin = reinterpret_cast<uintptr_t>(value.data());
+    uintptr_t input_begin = reinterpret_cast<uintptr_t>(input_.data());
+    if (begin >= input_begin && begin + value.size() <=
+                                    input_begin + input_.size()) {
+      node->string_data = value.data();
+    } else {
+      node->is_decoded = true;
+      node->string_offset = document_->decoded_strings_.size();
+      value.AppendToString(&document_->decoded_strings_);
+    }
+  }
+
+  void OpenContainer(Value::Type type) {
+    AddNode(type);
+    open_containers_.push_back(document_->nodes_.size() - 1);
+  }
+
+  void CloseContainer() {
+    std::vector<Node>& nodes = document_->nodes_;
+    nodes[open_containers_.back()].end = static_cast<uint32_t>(nodes.size());
+    open_containers_.pop_back();
+  }
+
+  const StringPiece input_;
+  JSONDocument* const document_;
+
+  // The indices of the lists and dictionaries whose end wasn't reached yet.
+  std::vector<size_t> open_containers_;
+
+  DISALLOW_COPY_AND_ASSIGN(Builder);
+};
+
+// JSONValueView::ListIterator /////////////////////////////////////////////////
+
+JSONValueView::ListIterator::ListIterator(const JSONValueView& list)
+    : document_(list.document_),
+      index_(list.index_ + 1),
+      end_(list.document_->nodes_[list.index_].end) {
+  DCHECK(list.IsType(Value::TYPE_LIST));
+}
+
+void JSONValueView::ListIterator::Advance() {
+  DCHECK(!IsAtEnd());
+  index_ = document_->nodes_[index_].end;
+}
+
+JSONValueView JSONValueView::ListIterator::value() const {
+  DCHECK(!IsAtEnd());
+  return JSONValueView(document_, index_);
+}
+
+// JSONValueView::DictionaryIterator ///////////////////////////////////////////
+
+JSONValueView::DictionaryIterator::DictionaryIterator(
+    const JSONValueView& dictionary)
+    : document_(dictionary.document_),
+      index_(dictionary.index_ + 1),
+      end_(dictionary.document_->nodes_[dictionary.index_].end) {
+  DCHECK(dictionary.IsType(Value::TYPE_DICTIONARY));
+}
+
+void JSONValueView::DictionaryIterator::Advance() {
+  DCHECK(!IsAtEnd());
+  index_ = document_->nodes_[index_ + 1].end;
+}
+
+StringPiece JSONValueView::DictionaryIterator::key() const {
+  DCHECK(!IsAtEnd());
+  return document_->GetString(index_);
+}
+
+JSONValueView JSONValueView::DictionaryIterator::value() const {
+  DCHECK(!IsAtEnd());
+  return JSONValueView(document_, index_ + 1);
+}
+
+// JSONValueView ///////////////////////////////////////////////////////////////
+
+JSONValueView::JSONValueView(const JSONDocument* document, size_t index)
+    : document_(document), index_(index) {
+  DCHECK_LT(index_, document_->nodes_.size());
+}
+
+Value::Type JSONValueView::GetType() const {
+  return document_->nodes_[index_].type;
+}
+
+bool JSONValueView::GetAsBoolean(bool* out_value) const {
+  const JSONDocument::Node& node = document_->nodes_[index_];
+  if (node.type != Value::TYPE_BOOLEAN)
+    return false;
+  *out_value = node.boolean_value;
+  return true;
+}
+
+bool JSONValueView::GetAsInteger(int* out_value) const {
+  const JSONDocument::Node& node = document_->nodes_[index_];
+  if (node.type != Value::TYPE_INTEGER)
+    return false;
+  *out_value = node.integer_value;
+  return true;
+}
+
+bool JSONValueView::GetAsDouble(double* out_value) const {
+  const JSONDocument::Node& node = document_->nodes_[index_];
+  if (node.type == Value::TYPE_INTEGER) {
+    *out_value = node.integer_value;
+    return true;
+  }
+  if (node.type != Value::TYPE_DOUBLE)
+    return false;
+  *out_value = node.double_value;
+  return true;
+}
+
+bool JSONValueView::GetAsString(StringPiece* out_value) const {
+  if (!IsType(Value::TYPE_STRING))
+    return false;
+  *out_value = document_->GetString(index_);
+  return true;
+}
+
+size_t JSONValueView::GetSize() const {
+  const JSONDocument::Node& node = document_->nodes_[index_];
+  if (node.type != Value::TYPE_LIST && node.type != Value::TYPE_DICTIONARY)
+    return 0;
+  return node.size;
+}
+
+bool JSONValueView::Get(StringPiece key, JSONValueView* out_value) const {
+  if (!IsType(Value::TYPE_DICTIONARY))
+    return false;
+  bool found = false;
+  for (DictionaryIterator it(*this); !it.IsAtEnd(); it.Advance()) {
+    if (it.key() == key) {
+      *out_value = it.value();
+      found = true;
+    }
+  }
+  return found;
+}
+
+std::unique_ptr<Value> JSONValueView::CreateValue() const {
+  const JSONDocument::Node& node = document_->nodes_[index_];
+  switch (node.type) {
+    case Value::TYPE_NULL:
+      return Value::CreateNullValue();
+    case Value::TYPE_BOOLEAN:
+      return WrapUnique(new FundamentalValue(node.boolean_value));
+    case Value::TYPE_INTEGER:
+      return WrapUnique(new FundamentalValue(node.integer_value));
+    case Value::TYPE_DOUBLE:
+      return WrapUnique(new FundamentalValue(node.double_value));
+    case Value::TYPE_STRING:
+      return WrapUnique(
+          new StringValue(document_->GetString(index_).as_string()));
+    case Value::TYPE_DICTIONARY: {
+      std::unique_ptr<DictionaryValue> dictionary(new DictionaryValue);
+      for (DictionaryIterator it(*this); !it.IsAtEnd(); it.Advance()) {
+        dictionary->SetWithoutPathExpansion(it.key().as_string(),
+                                            it.value().CreateValue());
+      }
+      return std::move(dictionary);
+    }
+    case Value::TYPE_LIST: {
+      std::unique_ptr<ListValue> list(new ListValue);
+      for (ListIterator it(*this); !it.IsAtEnd(); it.Advance())
+        list->Append(it.value().CreateValue());
+      return std::move(list);
+    }
+    default:
+      NOTREACHED();
+      return nullptr;
+  }
+}
+
+// JSONDocument ////////////////////////////////////////////////////////////////
+
+JSONDocument::JSONDocument() {}
+
+JSONDocument::~JSONDocument() {}
+
+// static
+std::unique_ptr<JSONDocument> JSONDocument::Parse(StringPiece json,
+                                                  int options,
+                                                  int* error_code_out,
+                                                  std::string* error_msg_out) {
+  std::unique_ptr<JSONDocument> document(new JSONDocument);
+  Builder builder(json, document.get());
+  internal::JSONParser parser(options);
+  if (!parser.ParseWithHandler(json, &builder)) {
+    if (error_code_out)
+      *error_code_out = parser.error_code();
+    if (error_msg_out)
+      *error_msg_out = parser.GetErrorMessage();
+    return nullptr;
+  }
+  DCHECK(!document->nodes_.empty());
+  return document;
+}
+
+size_t JSONDocument::EstimateMemoryUsage() const {
+  return sizeof(*this) + nodes_.capacity() * sizeof(Node) +
+         decoded_strings_.capacity();
+}
+
+StringPiece JSONDocument::GetString(size_t index) const {
+  const Node& node = nodes_[index];
+  DCHECK_EQ(Value::TYPE_STRING, node.type);
+  if (node.is_decoded)
+    return StringPiece(decoded_strings_.data() + node.string_offset, node.size);
+  return StringPiece(node.string_data, node.size);
+}
+
+}  // namespace base
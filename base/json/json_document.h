@@ -0,0 +1,171 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A read-only, lazily accessed alternative to the Value trees of JSONReader.
+// JSONDocument parses the input into a flat array of nodes that refer to the
+// strings of the input rather than copying them, so that a document costs one
+// allocation per growth of the array instead of one or more per value. The
+// contents are accessed through JSONValueView. Use this to read large
+// documents that don't need to be modified; JSONValueView::CreateValue()
+// converts the parts that do.
+
+#ifndef BASE_JSON_JSON_DOCUMENT_H_
+#define BASE_JSON_JSON_DOCUMENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+
+namespace base {
+
+class JSONDocument;
+
+// A view of a value of a JSONDocument. Views are cheap to copy and remain
+// valid as long as their document.
+class BASE_EXPORT JSONValueView {
+ public:
+  // Iterates over the items of a list.
+  class BASE_EXPORT ListIterator {
+   public:
+    // |list| must be a list.
+    explicit ListIterator(const JSONValueView& list);
+
+    bool IsAtEnd() const { return index_ == end_; }
+    void Advance();
+
+    JSONValueView value() const;
+
+   private:
+    const JSONDocument* document_;
+    size_t index_;
+    size_t end_;
+  };
+
+  // Iterates over the members of a dictionary in document order.
+  class BASE_EXPORT DictionaryIterator {
+   public:
+    // |dictionary| must be a dictionary.
+    explicit DictionaryIterator(const JSONValueView& dictionary);
+
+    bool IsAtEnd() const { return index_ == end_; }
+    void Advance();
+
+    StringPiece key() const;
+    JSONValueView value() const;
+
+   private:
+    const JSONDocument* document_;
+    size_t index_;
+    size_t end_;
+  };
+
+  Value::Type GetType() const;
+  bool IsType(Value::Type type) const { return GetType() == type; }
+
+  // These return false if the value is not of the matching type. Like
+  // FundamentalValue, GetAsDouble() also accepts integers. The string of
+  // GetAsString() points into the input of the document unless it had escape
+  // sequences.
+  bool GetAsBoolean(bool* out_value) const;
+  bool GetAsInteger(int* out_value) const;
+  bool GetAsDouble(double* out_value) const;
+  bool GetAsString(StringPiece* out_value) const;
+
+  // Returns the number of items of a list or members of a dictionary, and 0
+  // for other values.
+  size_t GetSize() const;
+
+  // Looks up the member |key| of a dictionary, without path expansion. This
+  // takes time linear in the number of members, as nested values are skipped
+  // in constant time. Returns false if there's no such member or if this is
+  // not a dictionary. If a key occurs several times, the last one wins, as for
+  // JSONReader.
+  bool Get(StringPiece key, JSONValueView* out_value) const;
+
+  // Converts the value and its descendants to a Value owned by the caller.
+  std::unique_ptr<Value> CreateValue() const;
+
+ private:
+  friend class JSONDocument;
+
+  JSONValueView(const JSONDocument* document, size_t index);
+
+  const JSONDocument* document_;
+  size_t index_;
+};
+
+class BASE_EXPORT JSONDocument {
+ public:
+  ~JSONDocument();
+
+  // Parses |json| according to |options| (JSONParserOptions; the
+  // JSON_DETACHABLE_CHILDREN option is meaningless here). |json| must outlive
+  // the document, which refers to its strings. Returns null if |json| is not
+  // properly formed, in which case the optional |error_code_out| and
+  // |error_msg_out| are populated as by JSONReader::ReadAndReturnError().
+  static std::unique_ptr<JSONDocument> Parse(StringPiece json,
+                                             int options,
+                                             int* error_code_out,
+                                             std::string* error_msg_out);
+
+  JSONValueView root() const { return JSONValueView(this, 0); }
+
+  // Returns the memory used by the document, not counting the input.
+  size_t EstimateMemoryUsage() const;
+
+ private:
+  friend class JSONValueView;
+  class Builder;
+
+  // A value of the document. The nodes of the values are stored in document
+  // order, so that the descendants of a list or dictionary directly follow
+  // it. Each member of a dictionary is a string node for its key followed by
+  // the node of its value.
+  struct Node {
+    Value::Type type;
+
+    // Whether a string is stored in |decoded_strings_| rather than the input.
+    bool is_decoded;
+
+    // The number of items or members of a list or dictionary, or the length
+    // of a string.
+    uint32_t size;
+
+    // The index of the node that follows this one and its descendants.
+    uint32_t end;
+
+    union {
+      bool boolean_value;
+      int integer_value;
+      double double_value;
+      // The start of a string in the input, or its offset in
+      // |decoded_strings_|.
+      const char* string_data;
+      size_t string_offset;
+    };
+  };
+
+  JSONDocument();
+
+  StringPiece GetString(size_t index) const;
+
+  std::vector<Node> nodes_;
+
+  // The strings that had escape sequences, decoded, one after another.
+  std::string decoded_strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONDocument);
+};
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_DOCUMENT_H_
@@ -0,0 +1,162 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_document.h"
+
+#include <memory>
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/macros.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const char kDocument[] =
+    "{"
+    "  \"null\": null,"
+    "  \"bool\": true,"
+    "  \"int\": 42,"
+    "  \"double\": 0.5,"
+    "  \"string\": \"plain\","
+    "  \"escaped\": \"a\\tb\","
+    "  \"list\": [1, [2, {\"nested\": 3}], {}, \"four\"],"
+    "  \"dict\": {\"x\": 1, \"y\": [], \"x\": 2}"
+    "}";
+
+}  // namespace
+
+TEST(JSONDocumentTest, Scalars) {
+  std::unique_ptr<JSONDocument> document =
+      JSONDocument::Parse(kDocument, JSON_PARSE_RFC, nullptr, nullptr);
+  ASSERT_TRUE(document);
+  JSONValueView root = document->root();
+  ASSERT_TRUE(root.IsType(Value::TYPE_DICTIONARY));
+  EXPECT_EQ(8u, root.GetSize());
+
+  JSONValueView value = root;
+  ASSERT_TRUE(root.Get("null", &value));
+  EXPECT_TRUE(value.IsType(Value::TYPE_NULL));
+  EXPECT_EQ(0u, value.GetSize());
+
+  bool bool_value = false;
+  ASSERT_TRUE(root.Get("bool", &value));
+  EXPECT_TRUE(value.GetAsBoolean(&bool_value));
+  EXPECT_TRUE(bool_value);
+
+  int int_value = 0;
+  double double_value = 0;
+  ASSERT_TRUE(root.Get("int", &value));
+  EXPECT_TRUE(value.GetAsInteger(&int_value));
+  EXPECT_EQ(42, int_value);
+  EXPECT_TRUE(value.GetAsDouble(&double_value));
+  EXPECT_EQ(42.0, double_value);
+  EXPECT_FALSE(value.GetAsBoolean(&bool_value));
+
+  ASSERT_TRUE(root.Get("double", &value));
+  EXPECT_FALSE(value.GetAsInteger(&int_value));
+  EXPECT_TRUE(value.GetAsDouble(&double_value));
+  EXPECT_EQ(0.5, double_value);
+
+  // Strings without escape sequences point into the input.
+  StringPiece string_value;
+  ASSERT_TRUE(root.Get("string", &value));
+  EXPECT_TRUE(value.GetAsString(&string_value));
+  EXPECT_EQ("plain", string_value);
+  EXPECT_GE(string_value.data(), kDocument);
+  EXPECT_LT(string_value.data(), kDocument + sizeof(kDocument));
+
+  ASSERT_TRUE(root.Get("escaped", &value));
+  EXPECT_TRUE(value.GetAsString(&string_value));
+  EXPECT_EQ("a\tb", string_value);
+
+  EXPECT_FALSE(root.Get("missing", &value));
+  EXPECT_FALSE(value.Get("string", &value));
+}
+
+TEST(JSONDocumentTest, Containers) {
+  std::unique_ptr<JSONDocument> document =
+      JSONDocument::Parse(kDocument, JSON_PARSE_RFC, nullptr, nullptr);
+  ASSERT_TRUE(document);
+
+  JSONValueView list = document->root();
+  ASSERT_TRUE(document->root().Get("list", &list));
+  ASSERT_TRUE(list.IsType(Value::TYPE_LIST));
+  EXPECT_EQ(4u, list.GetSize());
+
+  // The iterators skip over nested values.
+  Value::Type expected_types[] = {Value::TYPE_INTEGER, Value::TYPE_LIST,
+                                  Value::TYPE_DICTIONARY, Value::TYPE_STRING};
+  size_t i = 0;
+  for (JSONValueView::ListIterator it(list); !it.IsAtEnd(); it.Advance()) {
+    ASSERT_LT(i, arraysize(expected_types));
+    EXPECT_EQ(expected_types[i++], it.value().GetType());
+  }
+  EXPECT_EQ(arraysize(expected_types), i);
+
+  JSONValueView::ListIterator it(list);
+  it.Advance();
+  JSONValueView nested_list = it.value();
+  EXPECT_EQ(2u, nested_list.GetSize());
+  JSONValueView::ListIterator nested_it(nested_list);
+  nested_it.Advance();
+  JSONValueView nested = nested_it.value();
+  int int_value = 0;
+  ASSERT_TRUE(nested_it.value().Get("nested", &nested));
+  EXPECT_TRUE(nested.GetAsInteger(&int_value));
+  EXPECT_EQ(3, int_value);
+
+  // Duplicate keys are iterated over, but the last one wins for lookups.
+  JSONValueView dict = document->root();
+  ASSERT_TRUE(document->root().Get("dict", &dict));
+  EXPECT_EQ(3u, dict.GetSize());
+  std::string keys;
+  for (JSONValueView::DictionaryIterator it(dict); !it.IsAtEnd(); it.Advance())
+    keys += it.key().as_string();
+  EXPECT_EQ("xyx", keys);
+  JSONValueView x = dict;
+  ASSERT_TRUE(dict.Get("x", &x));
+  EXPECT_TRUE(x.GetAsInteger(&int_value));
+  EXPECT_EQ(2, int_value);
+}
+
+TEST(JSONDocumentTest, CreateValue) {
+  std::unique_ptr<JSONDocument> document =
+      JSONDocument::Parse(kDocument, JSON_PARSE_RFC, nullptr, nullptr);
+  ASSERT_TRUE(document);
+  std::unique_ptr<Value> expected = JSONReader::Read(kDocument);
+  ASSERT_TRUE(expected);
+  std::unique_ptr<Value> value = document->root().CreateValue();
+  ASSERT_TRUE(value);
+  EXPECT_TRUE(value->Equals(expected.get()));
+
+  // Scalar roots work as well.
+  document = JSONDocument::Parse("\"root\"", JSON_PARSE_RFC, nullptr, nullptr);
+  ASSERT_TRUE(document);
+  value = document->root().CreateValue();
+  std::string string_value;
+  ASSERT_TRUE(value && value->GetAsString(&string_value));
+  EXPECT_EQ("root", string_value);
+}
+
+TEST(JSONDocumentTest, Errors) {
+  int error_code = 0;
+  std::string error_message;
+  EXPECT_FALSE(JSONDocument::Parse("{\"a\": [1, 2}", JSON_PARSE_RFC,
+                                   &error_code, &error_message));
+  EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, error_code);
+  EXPECT_EQ("Line: 1, column: 12, Syntax error.", error_message);
+
+  EXPECT_FALSE(
+      JSONDocument::Parse("[1,]", JSON_PARSE_RFC, &error_code, nullptr));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, error_code);
+  EXPECT_TRUE(
+      JSONDocument::Parse("[1,]", JSON_ALLOW_TRAILING_COMMAS, nullptr, nullptr));
+  EXPECT_FALSE(JSONDocument::Parse("", JSON_PARSE_RFC, nullptr, nullptr));
+}
+
+}  // namespace base
@@ -53,6 +53,11 @@ class BASE_EXPORT JSONParser {
   // result as a Value owned by the caller.
   std::unique_ptr<Value> Parse(StringPiece input);
 
+  // Parses the input string according to the set options and reports its
+  // contents to |handler|. Strings are reported as StringPieces into |input|
+  // where possible. Returns false on error.
+  bool ParseWithHandler(StringPiece input, JSONReaderHandler* handler);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -108,6 +113,10 @@ class BASE_EXPORT JSONParser {
     // AppendString below.
     void Append(const char& c);
 
+    // Appends |length| characters of the input, starting at |chars|. Like for
+    // Append(), the characters must be in the basic ASCII plane.
+    void AppendChars(const char* chars, size_t length);
+
     // Appends a string to the std::string. Must be Convert()ed to use.
     void AppendString(const std::string& str);
 
@@ -138,6 +147,14 @@ class BASE_EXPORT JSONParser {
     std::string* string_;
   };
 
+  // Winds the parser to the start of |input|, past any Byte-Order-Mark, and
+  // resets the error information.
+  void BeginParse(StringPiece input);
+
+  // Checks that only whitespace and comments follow the root value. Returns
+  // false with error information set otherwise.
+  bool CheckEndOfInput();
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -167,6 +184,11 @@ class BASE_EXPORT JSONParser {
   // caller owns.
   Value* ParseToken(Token token);
 
+  // Like ParseNextToken() and ParseToken(), but report the value to |handler|
+  // instead of building it. Return false on error.
+  bool ParseNextTokenWithHandler(JSONReaderHandler* handler);
+  bool ParseTokenWithHandler(Token token, JSONReaderHandler* handler);
+
   // Assuming that the parser is currently wound to '{', this parses a JSON
   // object into a DictionaryValue.
   Value* ConsumeDictionary();
@@ -175,6 +197,11 @@ class BASE_EXPORT JSONParser {
   // ListValue.
   Value* ConsumeList();
 
+  // Like ConsumeDictionary() and ConsumeList(), but report the members to
+  // |handler|. Return false on error.
+  bool ConsumeDictionaryWithHandler(JSONReaderHandler* handler);
+  bool ConsumeListWithHandler(JSONReaderHandler* handler);
+
   // Calls through ConsumeStringRaw and wraps it in a value.
   Value* ConsumeString();
 
@@ -197,6 +224,9 @@ class BASE_EXPORT JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Helper for ConsumeNumber() that consumes a number and places its digits
+  // in |out|. Returns false with error information set on failure.
+  bool ConsumeNumberRaw(StringPiece* out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -204,6 +234,9 @@ class BASE_EXPORT JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Helper for ConsumeLiteral() that consumes |literal| from the input.
+  // Returns false with error information set if the input doesn't match.
+  bool ConsumeLiteralRaw(const char* literal);
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
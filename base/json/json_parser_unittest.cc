@@ -56,6 +56,21 @@ TEST_F(JSONParserTest, ConsumeString) {
   std::string str;
   EXPECT_TRUE(value->GetAsString(&str));
   EXPECT_EQ("test", str);
+
+  // Long strings are consumed in runs, which must stop at escape sequences and
+  // at non-ASCII characters.
+  input =
+      "\"0123456789abcdefghij\\n0123456789abcdef\xC3\xA9-0123456789abcdef\",|";
+  parser.reset(NewTestParser(input));
+  value.reset(parser->ConsumeString());
+  EXPECT_EQ('"', *parser->pos_);
+
+  TestLastThree(parser.get());
+
+  ASSERT_TRUE(value.get());
+  EXPECT_TRUE(value->GetAsString(&str));
+  EXPECT_EQ("0123456789abcdefghij\n0123456789abcdef\xC3\xA9-0123456789abcdef",
+            str);
 }
 
 TEST_F(JSONParserTest, ConsumeList) {
@@ -0,0 +1,87 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+
+#include "base/json/json_document.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumRounds = 200;
+
+// Builds a document shaped like a preferences file: dictionaries of
+// dictionaries, with strings, numbers, booleans and short lists as leaves.
+std::unique_ptr<DictionaryValue> BuildDocument() {
+  std::unique_ptr<DictionaryValue> document(new DictionaryValue);
+  for (int i = 0; i < 50; ++i) {
+    std::unique_ptr<DictionaryValue> section(new DictionaryValue);
+    for (int j = 0; j < 20; ++j) {
+      std::unique_ptr<DictionaryValue> entry(new DictionaryValue);
+      entry->SetString("url",
+                       StringPrintf("https://www.example%d.com/%d", i, j));
+      entry->SetInteger("count", i * j);
+      entry->SetDouble("last_visit", 13100000000.0 + i * 1000 + j);
+      entry->SetBoolean("enabled", (i + j) % 2 == 0);
+      std::unique_ptr<ListValue> list(new ListValue);
+      for (int k = 0; k < 4; ++k)
+        list->AppendInteger(k);
+      entry->Set("list", std::move(list));
+      section->SetWithoutPathExpansion(StringPrintf("entry_%d", j),
+                                       std::move(entry));
+    }
+    document->SetWithoutPathExpansion(StringPrintf("section_%d", i),
+                                      std::move(section));
+  }
+  return document;
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 TimeDelta elapsed,
+                 size_t json_size) {
+  perf_test::PrintResult(
+      measurement, "", trace,
+      json_size * kNumRounds / elapsed.InSecondsF() / (1024 * 1024), "MB/s",
+      true);
+}
+
+}  // namespace
+
+TEST(JSONPerfTest, Write) {
+  const std::unique_ptr<DictionaryValue> document = BuildDocument();
+  std::string json;
+  const TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round)
+    ASSERT_TRUE(JSONWriter::Write(*document, &json));
+  PrintResult("write", "prefs_like", TimeTicks::Now() - start, json.size());
+}
+
+TEST(JSONPerfTest, Read) {
+  std::string json;
+  ASSERT_TRUE(JSONWriter::Write(*BuildDocument(), &json));
+
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round)
+    ASSERT_TRUE(JSONReader::Read(json));
+  PrintResult("read", "prefs_like", TimeTicks::Now() - start, json.size());
+
+  // Read-only parsing, without building Values.
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round)
+    ASSERT_TRUE(JSONDocument::Parse(json, JSON_PARSE_RFC, nullptr, nullptr));
+  PrintResult("parse_document", "prefs_like", TimeTicks::Now() - start,
+              json.size());
+}
+
+}  // namespace base
@@ -79,6 +79,22 @@ std::unique_ptr<Value> JSONReader::ReadAndReturnError(
   return root;
 }
 
+// static
+bool JSONReader::ReadWithHandler(StringPiece json,
+                                 int options,
+                                 JSONReaderHandler* handler,
+                                 int* error_code_out,
+                                 std::string* error_msg_out) {
+  internal::JSONParser parser(options);
+  if (parser.ParseWithHandler(json, handler))
+    return true;
+  if (error_code_out)
+    *error_code_out = parser.error_code();
+  if (error_msg_out)
+    *error_msg_out = parser.GetErrorMessage();
+  return false;
+}
+
 // static
 std::string JSONReader::ErrorCodeToString(JsonParseError error_code) {
   switch (error_code) {
@@ -57,6 +57,31 @@ enum JSONParserOptions {
   JSON_DETACHABLE_CHILDREN = 1 << 1,
 };
 
+// Receives the contents of a JSON document from JSONReader::ReadWithHandler()
+// in document order, without any Value being built. A dictionary is reported
+// as OnDictionaryBegin(), then OnDictionaryKey() followed by the value of each
+// member, then OnDictionaryEnd(); a list likewise as OnListBegin(), its items
+// and OnListEnd().
+class BASE_EXPORT JSONReaderHandler {
+ public:
+  virtual ~JSONReaderHandler() {}
+
+  virtual void OnNull() = 0;
+  virtual void OnBoolean(bool value) = 0;
+  virtual void OnInteger(int value) = 0;
+  virtual void OnDouble(double value) = 0;
+
+  // |value| and |key| are only valid for the duration of the call. They point
+  // into the input unless the string contained escape sequences.
+  virtual void OnString(StringPiece value) = 0;
+
+  virtual void OnDictionaryBegin() = 0;
+  virtual void OnDictionaryKey(StringPiece key) = 0;
+  virtual void OnDictionaryEnd() = 0;
+  virtual void OnListBegin() = 0;
+  virtual void OnListEnd() = 0;
+};
+
 class BASE_EXPORT JSONReader {
  public:
   // Error codes during parsing.
@@ -112,6 +137,18 @@ class BASE_EXPORT JSONReader {
       int* error_line_out = nullptr,
       int* error_column_out = nullptr);
 
+  // Reads and parses |json| like ReadAndReturnError(), but reports its
+  // contents to |handler| instead of building a Value, which avoids the
+  // allocations of a Value tree. Returns false if |json| is not properly
+  // formed, in which case |handler| may have received part of the document.
+  // |error_code_out| and |error_msg_out| are optional and populated on
+  // failure.
+  static bool ReadWithHandler(StringPiece json,
+                              int options,  // JSONParserOptions
+                              JSONReaderHandler* handler,
+                              int* error_code_out,
+                              std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
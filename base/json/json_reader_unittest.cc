@@ -13,6 +13,7 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
@@ -21,6 +22,49 @@
 
 namespace base {
 
+namespace {
+
+// Records the calls of JSONReader::ReadWithHandler() as a string.
+class RecordingHandler : public JSONReaderHandler {
+ public:
+  RecordingHandler() {}
+  ~RecordingHandler() override {}
+
+  const std::string& events() const { return events_; }
+  StringPiece last_string() const { return last_string_; }
+
+  // JSONReaderHandler:
+  void OnNull() override { events_ += "null "; }
+  void OnBoolean(bool value) override {
+    events_ += value ? "true " : "false ";
+  }
+  void OnInteger(int value) override {
+    events_ += "i" + IntToString(value) + " ";
+  }
+  void OnDouble(double value) override {
+    events_ += "d" + DoubleToString(value) + " ";
+  }
+  void OnString(StringPiece value) override {
+    last_string_ = value;
+    events_ += "\"" + value.as_string() + "\" ";
+  }
+  void OnDictionaryBegin() override { events_ += "{ "; }
+  void OnDictionaryKey(StringPiece key) override {
+    events_ += key.as_string() + ": ";
+  }
+  void OnDictionaryEnd() override { events_ += "} "; }
+  void OnListBegin() override { events_ += "[ "; }
+  void OnListEnd() override { events_ += "] "; }
+
+ private:
+  std::string events_;
+  StringPiece last_string_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingHandler);
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   std::unique_ptr<Value> root = JSONReader().ReadToValue("   null   ");
@@ -657,4 +701,46 @@ TEST(JSONReaderTest, IllegalTrailingNull) {
   EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, reader.error_code());
 }
 
+TEST(JSONReaderTest, ReadWithHandler) {
+  RecordingHandler handler;
+  EXPECT_TRUE(JSONReader::ReadWithHandler(
+      "{\"a\": [1, 2.5, -3e2, true, false, null], \"b\\n\": {},"
+      " \"c\": \"x\\u00e9\"}",
+      JSON_PARSE_RFC, &handler, nullptr, nullptr));
+  EXPECT_EQ(
+      "{ a: [ i1 d2.5 d-300 true false null ] b\n: { } c: \"x\xC3\xA9\" } ",
+      handler.events());
+
+  // Unescaped strings point into the input.
+  const char kList[] = "[\"abc\"]";
+  RecordingHandler string_handler;
+  EXPECT_TRUE(JSONReader::ReadWithHandler(kList, JSON_PARSE_RFC,
+                                          &string_handler, nullptr, nullptr));
+  EXPECT_EQ(kList + 2, string_handler.last_string().data());
+
+  // Errors are reported like for ReadAndReturnError().
+  RecordingHandler failing_handler;
+  int error_code = 0;
+  std::string error_message;
+  EXPECT_FALSE(JSONReader::ReadWithHandler("[1, 2,]", JSON_PARSE_RFC,
+                                           &failing_handler, &error_code,
+                                           &error_message));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, error_code);
+  EXPECT_EQ("Line: 1, column: 7, Trailing comma not allowed.", error_message);
+  EXPECT_EQ("[ i1 i2 ", failing_handler.events());
+
+  RecordingHandler trailing_comma_handler;
+  EXPECT_TRUE(JSONReader::ReadWithHandler("[1, 2,]",
+                                          JSON_ALLOW_TRAILING_COMMAS,
+                                          &trailing_comma_handler, nullptr,
+                                          nullptr));
+  EXPECT_EQ("[ i1 i2 ] ", trailing_comma_handler.events());
+
+  RecordingHandler trailing_data_handler;
+  EXPECT_FALSE(JSONReader::ReadWithHandler("[1] 2", JSON_PARSE_RFC,
+                                           &trailing_data_handler,
+                                           &error_code, nullptr));
+  EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, error_code);
+}
+
 }  // namespace base
@@ -0,0 +1,124 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_string_scan.h"
+
+#include "build/build_config.h"
+
+// SSE2 is part of the baseline of all x86 builds, so it needs no runtime
+// check through base::CPU.
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#define JSON_STRING_SCAN_SSE2
+#elif defined(ARCH_CPU_ARM64) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define JSON_STRING_SCAN_NEON
+#endif
+
+namespace base {
+namespace internal {
+
+namespace {
+
+const size_t kBlockSize = 16;
+
+#if defined(JSON_STRING_SCAN_NEON)
+// Returns whether any byte of |mask| is set.
+inline bool AnyByteSet(uint8x16_t mask) {
+  uint8x8_t halves = vorr_u8(vget_low_u8(mask), vget_high_u8(mask));
+  return vget_lane_u64(vreinterpret_u64_u8(halves), 0) != 0;
+}
+#endif
+
+}  // namespace
+
+size_t CountUnescapedJSONChars(const char* data, size_t length) {
+  size_t i = 0;
+
+  // Skip the blocks without a special character; the first one that has one
+  // is searched below.
+#if defined(JSON_STRING_SCAN_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Non-ASCII bytes have their top bit set, as do the matches.
+    __m128i special = _mm_or_si128(
+        chars, _mm_or_si128(_mm_cmpeq_epi8(chars, quote),
+                            _mm_cmpeq_epi8(chars, backslash)));
+    if (_mm_movemask_epi8(special))
+      break;
+  }
+#elif defined(JSON_STRING_SCAN_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t ascii_end = vdupq_n_u8(0x80);
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+    uint8x16_t special = vorrq_u8(
+        vcgeq_u8(chars, ascii_end),
+        vorrq_u8(vceqq_u8(chars, quote), vceqq_u8(chars, backslash)));
+    if (AnyByteSet(special))
+      break;
+  }
+#endif
+
+  for (; i < length; ++i) {
+    unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c >= 0x80 || c == '"' || c == '\\')
+      break;
+  }
+  return i;
+}
+
+size_t CountVerbatimJSONChars(const char* data, size_t length) {
+  size_t i = 0;
+
+#if defined(JSON_STRING_SCAN_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i less_than = _mm_set1_epi8('<');
+  const __m128i space = _mm_set1_epi8(' ');
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // As signed bytes, both control characters and non-ASCII bytes are less
+    // than a space.
+    __m128i special = _mm_or_si128(
+        _mm_cmplt_epi8(chars, space),
+        _mm_or_si128(_mm_cmpeq_epi8(chars, quote),
+                     _mm_or_si128(_mm_cmpeq_epi8(chars, backslash),
+                                  _mm_cmpeq_epi8(chars, less_than))));
+    if (_mm_movemask_epi8(special))
+      break;
+  }
+#elif defined(JSON_STRING_SCAN_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t less_than = vdupq_n_u8('<');
+  const uint8x16_t space = vdupq_n_u8(' ');
+  const uint8x16_t ascii_end = vdupq_n_u8(0x80);
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+    uint8x16_t special = vorrq_u8(
+        vorrq_u8(vcltq_u8(chars, space), vcgeq_u8(chars, ascii_end)),
+        vorrq_u8(vceqq_u8(chars, quote),
+                 vorrq_u8(vceqq_u8(chars, backslash),
+                          vceqq_u8(chars, less_than))));
+    if (AnyByteSet(special))
+      break;
+  }
+#endif
+
+  for (; i < length; ++i) {
+    unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\' || c == '<')
+      break;
+  }
+  return i;
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,32 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Helpers for the JSON parser and string escaping that find the end of a run
+// of characters which can be copied as-is. They look at 16 bytes at a time
+// with SSE2 or NEON where available.
+
+#ifndef BASE_JSON_JSON_STRING_SCAN_H_
+#define BASE_JSON_JSON_STRING_SCAN_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace internal {
+
+// Returns the number of leading bytes of |data| that are basic ASCII and
+// neither '"' nor '\\', i.e. which a JSON string can contain without any
+// decoding.
+BASE_EXPORT size_t CountUnescapedJSONChars(const char* data, size_t length);
+
+// Returns the number of leading bytes of |data| that are ASCII but neither
+// control characters nor any of '"', '\\' and '<', i.e. which
+// EscapeJSONString() writes unchanged.
+BASE_EXPORT size_t CountVerbatimJSONChars(const char* data, size_t length);
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_STRING_SCAN_H_
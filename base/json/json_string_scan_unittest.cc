@@ -0,0 +1,68 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_string_scan.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+TEST(JSONStringScanTest, CountUnescapedJSONChars) {
+  EXPECT_EQ(0u, CountUnescapedJSONChars("", 0));
+
+  const char kSpecial[] = {'"', '\\', '\x80', '\xC3', '\xFF'};
+  // Put the special character at every position of the first blocks, so that
+  // both the vector and the scalar loops find it.
+  for (char special : kSpecial) {
+    for (size_t position = 0; position < 40; ++position) {
+      std::string input(position, 'a');
+      if (position)
+        input[position / 2] = '\t';
+      input += special;
+      input += std::string(20, 'b');
+      EXPECT_EQ(position, CountUnescapedJSONChars(input.data(), input.size()))
+          << "special " << static_cast<int>(special) << " at " << position;
+    }
+  }
+
+  // Control characters need no decoding.
+  std::string plain(37, '\n');
+  plain[20] = '\x7F';
+  EXPECT_EQ(plain.size(), CountUnescapedJSONChars(plain.data(), plain.size()));
+
+  // Bytes past |length| aren't looked at.
+  const char kTruncated[] = "0123456789abcdefghijklmnop\"";
+  EXPECT_EQ(26u, CountUnescapedJSONChars(kTruncated, 26));
+}
+
+TEST(JSONStringScanTest, CountVerbatimJSONChars) {
+  EXPECT_EQ(0u, CountVerbatimJSONChars("", 0));
+
+  const char kSpecial[] = {'"', '\\', '<', '\0', '\n', '\x1F', '\x80', '\xFF'};
+  for (char special : kSpecial) {
+    for (size_t position = 0; position < 40; ++position) {
+      std::string input(position, 'a');
+      if (position)
+        input[position / 2] = '>';
+      input += special;
+      input += std::string(20, 'b');
+      EXPECT_EQ(position, CountVerbatimJSONChars(input.data(), input.size()))
+          << "special " << static_cast<int>(special) << " at " << position;
+    }
+  }
+
+  std::string printable;
+  for (int c = ' '; c < 0x80; ++c) {
+    if (c != '"' && c != '\\' && c != '<')
+      printable += static_cast<char>(c);
+  }
+  EXPECT_EQ(printable.size(),
+            CountVerbatimJSONChars(printable.data(), printable.size()));
+}
+
+}  // namespace internal
+}  // namespace base
@@ -10,6 +10,7 @@
 #include <limits>
 #include <string>
 
+#include "base/json/json_string_scan.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversion_utils.h"
@@ -77,6 +78,17 @@ bool EscapeSpecialCodePoint(uint32_t code_point, std::string* dest) {
   return true;
 }
 
+// Returns the number of leading code units of |str|, starting at |index|, that
+// EscapeJSONStringImpl() can copy to its output as they are.
+size_t CountVerbatimCodeUnits(const StringPiece& str, int32_t index) {
+  return internal::CountVerbatimJSONChars(str.data() + index,
+                                          str.length() - index);
+}
+
+size_t CountVerbatimCodeUnits(const StringPiece16& str, int32_t index) {
+  return 0;
+}
+
 template <typename S>
 bool EscapeJSONStringImpl(const S& str, bool put_in_quotes, std::string* dest) {
   bool did_replacement = false;
@@ -90,6 +102,13 @@ bool EscapeJSONStringImpl(const S& str, bool put_in_quotes, std::string* dest) {
   const int32_t length = static_cast<int32_t>(str.length());
 
   for (int32_t i = 0; i < length; ++i) {
+    size_t run_length = CountVerbatimCodeUnits(str, i);
+    if (run_length) {
+      dest->append(str.data() + i, str.data() + i + run_length);
+      i += static_cast<int32_t>(run_length) - 1;
+      continue;
+    }
+
     uint32_t code_point;
     if (!ReadUnicodeCharacter(str.data(), length, &i, &code_point)) {
       code_point = kReplacementCodePoint;
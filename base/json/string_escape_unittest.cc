@@ -26,6 +26,10 @@ TEST(JSONStringEscapeTest, EscapeUTF8) {
     {"c<>d", "c\\u003C>d"},
     {"Hello\xe2\x80\xa8world", "Hello\\u2028world"},
     {"\xe2\x80\xa9purple", "\\u2029purple"},
+    // Long enough for the characters to be copied in runs.
+    {"0123456789abcdefghijklmnopqrstuvwxyz\"0123456789abcdef\xc3\xa9-<-0123",
+        "0123456789abcdefghijklmnopqrstuvwxyz\\\"0123456789abcdef\xc3\xa9-"
+        "\\u003C-0123"},
   };
 
   for (size_t i = 0; i < arraysize(cases); ++i) {
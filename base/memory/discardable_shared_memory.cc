@@ -88,10 +88,12 @@ struct SharedState {
   } value;
 };
 
-// Shared state is stored at offset 0 in shared memory segments.
-SharedState* SharedStateFromSharedMemory(const SharedMemory& shared_memory) {
+// Returns the shared state stored at |offset| in shared memory segments.
+SharedState* SharedStateFromSharedMemory(const SharedMemory& shared_memory,
+                                         size_t offset) {
   DCHECK(shared_memory.memory());
-  return static_cast<SharedState*>(shared_memory.memory());
+  return reinterpret_cast<SharedState*>(
+      static_cast<uint8_t*>(shared_memory.memory()) + offset);
 }
 
 // Round up |size| to a multiple of page size.
@@ -99,35 +101,86 @@ size_t AlignToPageSize(size_t size) {
   return bits::Align(size, base::GetPageSize());
 }
 
+// Size of the part of a mapping that holds the shared state.
+size_t SharedStateSize() {
+  return AlignToPageSize(sizeof(SharedState));
+}
+
+// Returns the size of the mapping needed for |size| bytes of data in a segment
+// of |page_type|. The result is invalid on overflow.
+CheckedNumeric<size_t> MappingSize(DiscardableSharedMemory::PageType page_type,
+                                   size_t size) {
+  CheckedNumeric<size_t> mapping_size = size;
+  if (page_type == DiscardableSharedMemory::HUGE_PAGES) {
+    // Round up to a multiple of kHugePageSize.
+    mapping_size += DiscardableSharedMemory::kHugePageSize - 1;
+    mapping_size -= mapping_size.ValueOrDefault(0) %
+                    DiscardableSharedMemory::kHugePageSize;
+  }
+  return mapping_size + SharedStateSize();
+}
+
+size_t LockGranularity(DiscardableSharedMemory::PageType page_type) {
+  return page_type == DiscardableSharedMemory::HUGE_PAGES
+             ? DiscardableSharedMemory::kHugePageSize
+             : base::GetPageSize();
+}
+
+// Asks the kernel to back |length| bytes at |address| with transparent huge
+// pages. The kernel itself aligns shmem mappings that can use huge pages to a
+// huge page boundary. Failure is fine: not all kernels support huge pages for
+// shared memory, and the segment then simply uses regular pages.
+void AdviseHugePages(void* address, size_t length) {
+#if (defined(OS_LINUX) || defined(OS_ANDROID)) && defined(MADV_HUGEPAGE)
+  if (length)
+    madvise(address, length, MADV_HUGEPAGE);
+#endif
+}
+
 }  // namespace
 
+// static
+const size_t DiscardableSharedMemory::kHugePageSize;
+
 DiscardableSharedMemory::DiscardableSharedMemory()
-    : mapped_size_(0), locked_page_count_(0) {
-}
+    : DiscardableSharedMemory(REGULAR_PAGES) {}
+
+DiscardableSharedMemory::DiscardableSharedMemory(PageType page_type)
+    : page_type_(page_type),
+      lock_granularity_(LockGranularity(page_type)),
+      mapped_size_(0),
+      locked_page_count_(0) {}
 
 DiscardableSharedMemory::DiscardableSharedMemory(
     SharedMemoryHandle shared_memory_handle)
-    : shared_memory_(shared_memory_handle, false),
+    : DiscardableSharedMemory(shared_memory_handle, REGULAR_PAGES) {}
+
+DiscardableSharedMemory::DiscardableSharedMemory(
+    SharedMemoryHandle shared_memory_handle,
+    PageType page_type)
+    : page_type_(page_type),
+      lock_granularity_(LockGranularity(page_type)),
+      shared_memory_(shared_memory_handle, false),
       mapped_size_(0),
-      locked_page_count_(0) {
-}
+      locked_page_count_(0) {}
 
 DiscardableSharedMemory::~DiscardableSharedMemory() {
 }
 
 bool DiscardableSharedMemory::CreateAndMap(size_t size) {
-  CheckedNumeric<size_t> checked_size = size;
-  checked_size += AlignToPageSize(sizeof(SharedState));
+  CheckedNumeric<size_t> checked_size = MappingSize(page_type_, size);
   if (!checked_size.IsValid())
     return false;
 
   if (!shared_memory_.CreateAndMapAnonymous(checked_size.ValueOrDie()))
     return false;
 
-  mapped_size_ =
-      shared_memory_.mapped_size() - AlignToPageSize(sizeof(SharedState));
+  mapped_size_ = shared_memory_.mapped_size() - SharedStateSize();
+  if (page_type_ == HUGE_PAGES)
+    AdviseHugePages(memory(), mapped_size_);
 
-  locked_page_count_ = AlignToPageSize(mapped_size_) / base::GetPageSize();
+  locked_page_count_ =
+      bits::Align(mapped_size_, lock_granularity_) / lock_granularity_;
 #if DCHECK_IS_ON()
   for (size_t page = 0; page < locked_page_count_; ++page)
     locked_pages_.insert(page);
@@ -135,19 +188,27 @@ bool DiscardableSharedMemory::CreateAndMap(size_t size) {
 
   DCHECK(last_known_usage_.is_null());
   SharedState new_state(SharedState::LOCKED, Time());
-  subtle::Release_Store(&SharedStateFromSharedMemory(shared_memory_)->value.i,
-                        new_state.value.i);
+  subtle::Release_Store(
+      &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+           ->value.i,
+      new_state.value.i);
   return true;
 }
 
 bool DiscardableSharedMemory::Map(size_t size) {
-  if (!shared_memory_.Map(AlignToPageSize(sizeof(SharedState)) + size))
+  CheckedNumeric<size_t> checked_size = MappingSize(page_type_, size);
+  if (!checked_size.IsValid())
     return false;
 
-  mapped_size_ =
-      shared_memory_.mapped_size() - AlignToPageSize(sizeof(SharedState));
+  if (!shared_memory_.Map(checked_size.ValueOrDie()))
+    return false;
+
+  mapped_size_ = shared_memory_.mapped_size() - SharedStateSize();
+  if (page_type_ == HUGE_PAGES)
+    AdviseHugePages(memory(), mapped_size_);
 
-  locked_page_count_ = AlignToPageSize(mapped_size_) / base::GetPageSize();
+  locked_page_count_ =
+      bits::Align(mapped_size_, lock_granularity_) / lock_granularity_;
 #if DCHECK_IS_ON()
   for (size_t page = 0; page < locked_page_count_; ++page)
     locked_pages_.insert(page);
@@ -166,8 +227,8 @@ bool DiscardableSharedMemory::Unmap() {
 
 DiscardableSharedMemory::LockResult DiscardableSharedMemory::Lock(
     size_t offset, size_t length) {
-  DCHECK_EQ(AlignToPageSize(offset), offset);
-  DCHECK_EQ(AlignToPageSize(length), length);
+  DCHECK_EQ(bits::Align(offset, lock_granularity_), offset);
+  DCHECK_EQ(bits::Align(length, lock_granularity_), length);
 
   // Calls to this function must be synchronized properly.
   DFAKE_SCOPED_LOCK(thread_collision_warner_);
@@ -185,7 +246,8 @@ DiscardableSharedMemory::LockResult DiscardableSharedMemory::Lock(
     SharedState old_state(SharedState::UNLOCKED, last_known_usage_);
     SharedState new_state(SharedState::LOCKED, Time());
     SharedState result(subtle::Acquire_CompareAndSwap(
-        &SharedStateFromSharedMemory(shared_memory_)->value.i,
+        &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+             ->value.i,
         old_state.value.i,
         new_state.value.i));
     if (result.value.u != old_state.value.u) {
@@ -198,12 +260,13 @@ DiscardableSharedMemory::LockResult DiscardableSharedMemory::Lock(
 
   // Zero for length means "everything onward".
   if (!length)
-    length = AlignToPageSize(mapped_size_) - offset;
+    length = bits::Align(mapped_size_, lock_granularity_) - offset;
 
-  size_t start = offset / base::GetPageSize();
-  size_t end = start + length / base::GetPageSize();
+  size_t start = offset / lock_granularity_;
+  size_t end = start + length / lock_granularity_;
   DCHECK_LE(start, end);
-  DCHECK_LE(end, AlignToPageSize(mapped_size_) / base::GetPageSize());
+  DCHECK_LE(end, bits::Align(mapped_size_, lock_granularity_) /
+                     lock_granularity_);
 
   // Add pages to |locked_page_count_|.
   // Note: Locking a page that is already locked is an error.
@@ -226,7 +289,7 @@ DiscardableSharedMemory::LockResult DiscardableSharedMemory::Lock(
   SharedMemoryHandle handle = shared_memory_.handle();
   if (SharedMemory::IsHandleValid(handle)) {
     if (ashmem_pin_region(
-            handle.fd, AlignToPageSize(sizeof(SharedState)) + offset, length)) {
+            handle.fd, DataOffset() + offset, length)) {
       return PURGED;
     }
   }
@@ -236,15 +299,15 @@ DiscardableSharedMemory::LockResult DiscardableSharedMemory::Lock(
 }
 
 void DiscardableSharedMemory::Unlock(size_t offset, size_t length) {
-  DCHECK_EQ(AlignToPageSize(offset), offset);
-  DCHECK_EQ(AlignToPageSize(length), length);
+  DCHECK_EQ(bits::Align(offset, lock_granularity_), offset);
+  DCHECK_EQ(bits::Align(length, lock_granularity_), length);
 
   // Calls to this function must be synchronized properly.
   DFAKE_SCOPED_LOCK(thread_collision_warner_);
 
   // Zero for length means "everything onward".
   if (!length)
-    length = AlignToPageSize(mapped_size_) - offset;
+    length = bits::Align(mapped_size_, lock_granularity_) - offset;
 
   DCHECK(shared_memory_.memory());
 
@@ -253,16 +316,17 @@ void DiscardableSharedMemory::Unlock(size_t offset, size_t length) {
   SharedMemoryHandle handle = shared_memory_.handle();
   if (SharedMemory::IsHandleValid(handle)) {
     if (ashmem_unpin_region(
-            handle.fd, AlignToPageSize(sizeof(SharedState)) + offset, length)) {
+            handle.fd, DataOffset() + offset, length)) {
       DPLOG(ERROR) << "ashmem_unpin_region() failed";
     }
   }
 #endif
 
-  size_t start = offset / base::GetPageSize();
-  size_t end = start + length / base::GetPageSize();
+  size_t start = offset / lock_granularity_;
+  size_t end = start + length / lock_granularity_;
   DCHECK_LE(start, end);
-  DCHECK_LE(end, AlignToPageSize(mapped_size_) / base::GetPageSize());
+  DCHECK_LE(end, bits::Align(mapped_size_, lock_granularity_) /
+                     lock_granularity_);
 
   // Remove pages from |locked_page_count_|.
   // Note: Unlocking a page that is not locked is an error.
@@ -294,7 +358,8 @@ void DiscardableSharedMemory::Unlock(size_t offset, size_t length) {
   DCHECK_EQ((new_state.GetTimestamp() - Time::UnixEpoch()).InSeconds(),
             (current_time - Time::UnixEpoch()).InSeconds());
   SharedState result(subtle::Release_CompareAndSwap(
-      &SharedStateFromSharedMemory(shared_memory_)->value.i,
+      &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+           ->value.i,
       old_state.value.i,
       new_state.value.i));
 
@@ -304,8 +369,7 @@ void DiscardableSharedMemory::Unlock(size_t offset, size_t length) {
 }
 
 void* DiscardableSharedMemory::memory() const {
-  return reinterpret_cast<uint8_t*>(shared_memory_.memory()) +
-         AlignToPageSize(sizeof(SharedState));
+  return reinterpret_cast<uint8_t*>(shared_memory_.memory()) + DataOffset();
 }
 
 bool DiscardableSharedMemory::Purge(Time current_time) {
@@ -316,7 +380,8 @@ bool DiscardableSharedMemory::Purge(Time current_time) {
   SharedState old_state(SharedState::UNLOCKED, last_known_usage_);
   SharedState new_state(SharedState::UNLOCKED, Time());
   SharedState result(subtle::Acquire_CompareAndSwap(
-      &SharedStateFromSharedMemory(shared_memory_)->value.i,
+      &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+           ->value.i,
       old_state.value.i,
       new_state.value.i));
 
@@ -350,8 +415,7 @@ bool DiscardableSharedMemory::Purge(Time current_time) {
   // Advise the kernel to remove resources associated with purged pages.
   // Subsequent accesses of memory pages will succeed, but might result in
   // zero-fill-on-demand pages.
-  if (madvise(reinterpret_cast<char*>(shared_memory_.memory()) +
-                  AlignToPageSize(sizeof(SharedState)),
+  if (madvise(reinterpret_cast<char*>(shared_memory_.memory()) + DataOffset(),
               AlignToPageSize(mapped_size_), MADV_PURGE_ARGUMENT)) {
     DPLOG(ERROR) << "madvise() failed";
   }
@@ -359,7 +423,7 @@ bool DiscardableSharedMemory::Purge(Time current_time) {
   // MEM_DECOMMIT the purged pages to release the physical storage,
   // either in memory or in the paging file on disk.  Pages remain RESERVED.
   if (!VirtualFree(reinterpret_cast<char*>(shared_memory_.memory()) +
-                       AlignToPageSize(sizeof(SharedState)),
+                       DataOffset(),
                    AlignToPageSize(mapped_size_), MEM_DECOMMIT)) {
     DPLOG(ERROR) << "VirtualFree() MEM_DECOMMIT failed in Purge()";
   }
@@ -373,7 +437,8 @@ bool DiscardableSharedMemory::IsMemoryResident() const {
   DCHECK(shared_memory_.memory());
 
   SharedState result(subtle::NoBarrier_Load(
-      &SharedStateFromSharedMemory(shared_memory_)->value.i));
+      &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+           ->value.i));
 
   return result.GetLockState() == SharedState::LOCKED ||
          !result.GetTimestamp().is_null();
@@ -383,7 +448,8 @@ bool DiscardableSharedMemory::IsMemoryLocked() const {
   DCHECK(shared_memory_.memory());
 
   SharedState result(subtle::NoBarrier_Load(
-      &SharedStateFromSharedMemory(shared_memory_)->value.i));
+      &SharedStateFromSharedMemory(shared_memory_, SharedStateOffset())
+           ->value.i));
 
   return result.GetLockState() == SharedState::LOCKED;
 }
@@ -396,4 +462,15 @@ Time DiscardableSharedMemory::Now() const {
   return Time::Now();
 }
 
+// The shared state comes first in REGULAR_PAGES segments. HUGE_PAGES segments
+// keep it on a page of its own after the data, so that the data starts on a
+// huge page boundary.
+size_t DiscardableSharedMemory::DataOffset() const {
+  return page_type_ == HUGE_PAGES ? 0 : SharedStateSize();
+}
+
+size_t DiscardableSharedMemory::SharedStateOffset() const {
+  return page_type_ == HUGE_PAGES ? mapped_size_ : 0;
+}
+
 }  // namespace base
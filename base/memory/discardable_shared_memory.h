@@ -40,11 +40,25 @@ class BASE_EXPORT DiscardableSharedMemory {
  public:
   enum LockResult { SUCCESS, PURGED, FAILED };
 
+  // The kind of pages backing the memory of a segment.
+  // HUGE_PAGES segments are sized and aligned to kHugePageSize, and where
+  // the platform supports it (Linux) they are backed by transparent huge
+  // pages. They are locked and unlocked at that granularity. Use them for
+  // large segments, such as image decode caches, where TLB misses are
+  // significant. All the instances mapping a segment must use the same
+  // kind of pages.
+  enum PageType { REGULAR_PAGES, HUGE_PAGES };
+
+  // Size of the pages of HUGE_PAGES segments.
+  static const size_t kHugePageSize = 2 * 1024 * 1024;
+
   DiscardableSharedMemory();
+  explicit DiscardableSharedMemory(PageType page_type);
 
   // Create a new DiscardableSharedMemory object from an existing, open shared
   // memory file. Memory must be locked.
   explicit DiscardableSharedMemory(SharedMemoryHandle handle);
+  DiscardableSharedMemory(SharedMemoryHandle handle, PageType page_type);
 
   // Closes any open files.
   virtual ~DiscardableSharedMemory();
@@ -65,13 +79,20 @@ class BASE_EXPORT DiscardableSharedMemory {
   // The actual size of the mapped memory (may be larger than requested).
   size_t mapped_size() const { return mapped_size_; }
 
+  PageType page_type() const { return page_type_; }
+
+  // The size that ranges passed to Lock() and Unlock() must be a multiple
+  // of. This is the page size returned by GetPageSize() for REGULAR_PAGES
+  // segments and kHugePageSize for HUGE_PAGES segments.
+  size_t lock_granularity() const { return lock_granularity_; }
+
   // Returns a shared memory handle for this DiscardableSharedMemory object.
   SharedMemoryHandle handle() const { return shared_memory_.handle(); }
 
   // Locks a range of memory so that it will not be purged by the system.
   // The range of memory must be unlocked. The result of trying to lock an
   // already locked range is undefined. |offset| and |length| must both be
-  // a multiple of the page size as returned by GetPageSize().
+  // a multiple of lock_granularity().
   // Passing 0 for |length| means "everything onward".
   // Returns SUCCESS if range was successfully locked and the memory is still
   // resident, PURGED if range was successfully locked but has been purged
@@ -85,8 +106,7 @@ class BASE_EXPORT DiscardableSharedMemory {
   // Unlock a previously successfully locked range of memory. The range of
   // memory must be locked. The result of trying to unlock a not
   // previously locked range is undefined.
-  // |offset| and |length| must both be a multiple of the page size as returned
-  // by GetPageSize().
+  // |offset| and |length| must both be a multiple of lock_granularity().
   // Passing 0 for |length| means "everything onward".
   void Unlock(size_t offset, size_t length);
 
@@ -137,6 +157,12 @@ class BASE_EXPORT DiscardableSharedMemory {
   // Virtual for tests.
   virtual Time Now() const;
 
+  // Offsets of the data and of the shared lock state in the mapping.
+  size_t DataOffset() const;
+  size_t SharedStateOffset() const;
+
+  const PageType page_type_;
+  const size_t lock_granularity_;
   SharedMemory shared_memory_;
   size_t mapped_size_;
   size_t locked_page_count_;
@@ -15,9 +15,15 @@ class TestDiscardableSharedMemory : public DiscardableSharedMemory {
  public:
   TestDiscardableSharedMemory() {}
 
+  explicit TestDiscardableSharedMemory(PageType page_type)
+      : DiscardableSharedMemory(page_type) {}
+
   explicit TestDiscardableSharedMemory(SharedMemoryHandle handle)
       : DiscardableSharedMemory(handle) {}
 
+  TestDiscardableSharedMemory(SharedMemoryHandle handle, PageType page_type)
+      : DiscardableSharedMemory(handle, page_type) {}
+
   void SetNow(Time now) { now_ = now; }
 
  private:
@@ -363,6 +369,58 @@ TEST(DiscardableSharedMemoryTest, ZeroSize) {
   memory.Unlock(0, 0);
 }
 
+TEST(DiscardableSharedMemoryTest, HugePages) {
+  const size_t kDataSize = DiscardableSharedMemory::kHugePageSize + 1024;
+
+  TestDiscardableSharedMemory memory1(DiscardableSharedMemory::HUGE_PAGES);
+  bool rv = memory1.CreateAndMap(kDataSize);
+  ASSERT_TRUE(rv);
+  EXPECT_EQ(DiscardableSharedMemory::kHugePageSize, memory1.lock_granularity());
+  EXPECT_EQ(2 * DiscardableSharedMemory::kHugePageSize, memory1.mapped_size());
+  EXPECT_TRUE(memory1.IsMemoryLocked());
+
+  SharedMemoryHandle shared_handle;
+  ASSERT_TRUE(
+      memory1.ShareToProcess(GetCurrentProcessHandle(), &shared_handle));
+  ASSERT_TRUE(SharedMemory::IsHandleValid(shared_handle));
+
+  TestDiscardableSharedMemory memory2(shared_handle,
+                                      DiscardableSharedMemory::HUGE_PAGES);
+  rv = memory2.Map(kDataSize);
+  ASSERT_TRUE(rv);
+  EXPECT_EQ(memory1.mapped_size(), memory2.mapped_size());
+
+  // Both instances see the same data, and the shared state doesn't overlap
+  // it.
+  memset(memory1.memory(), 0xaa, memory1.mapped_size());
+  EXPECT_EQ(0xaa, static_cast<uint8_t*>(memory2.memory())[0]);
+  EXPECT_EQ(0xaa, static_cast<uint8_t*>(
+                      memory2.memory())[memory2.mapped_size() - 1]);
+  EXPECT_TRUE(memory2.IsMemoryLocked());
+
+  // Unlock the first huge page.
+  memory2.SetNow(Time::FromDoubleT(1));
+  memory2.Unlock(0, DiscardableSharedMemory::kHugePageSize);
+  EXPECT_TRUE(memory1.IsMemoryLocked());
+
+  rv = memory1.Purge(Time::FromDoubleT(2));
+  EXPECT_FALSE(rv);
+
+  // Unlock anything onwards.
+  memory2.SetNow(Time::FromDoubleT(3));
+  memory2.Unlock(DiscardableSharedMemory::kHugePageSize, 0);
+  EXPECT_FALSE(memory1.IsMemoryLocked());
+
+  // Memory is unlocked, but our usage timestamp is incorrect.
+  rv = memory1.Purge(Time::FromDoubleT(4));
+  EXPECT_FALSE(rv);
+  EXPECT_EQ(Time::FromDoubleT(3), memory1.last_known_usage());
+
+  rv = memory1.Purge(Time::FromDoubleT(5));
+  EXPECT_TRUE(rv);
+  EXPECT_FALSE(memory2.IsMemoryResident());
+}
+
 // This test checks that zero-filled pages are returned after purging a segment
 // when DISCARDABLE_SHARED_MEMORY_ZERO_FILL_ON_DEMAND_PAGES_AFTER_PURGE is
 // defined and MADV_REMOVE is supported.
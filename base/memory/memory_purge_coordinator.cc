@@ -0,0 +1,133 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_purge_coordinator.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+#include "base/trace_event/trace_event.h"
+
+namespace base {
+
+namespace {
+
+struct Candidate {
+  MemoryPurgeClient* client;
+  MemoryPurgeClient::Estimate estimate;
+};
+
+// Reclaimable bytes per microsecond of re-creation cost. Free to re-create
+// memory counts as costing one microsecond, so that it sorts by size first.
+double BytesPerCost(const MemoryPurgeClient::Estimate& estimate) {
+  const int64_t cost_us =
+      std::max<int64_t>(estimate.recreation_cost.InMicroseconds(), 1);
+  return static_cast<double>(estimate.reclaimable_bytes) / cost_us;
+}
+
+bool HasBetterRatio(const Candidate& a, const Candidate& b) {
+  return BytesPerCost(a.estimate) > BytesPerCost(b.estimate);
+}
+
+}  // namespace
+
+MemoryPurgeCoordinator::PurgeRecord::PurgeRecord()
+    : level(MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE),
+      target_bytes(0),
+      purged_clients(0),
+      estimated_bytes(0),
+      freed_bytes(0) {}
+
+// static
+MemoryPurgeCoordinator* MemoryPurgeCoordinator::GetInstance() {
+  return Singleton<MemoryPurgeCoordinator,
+                   LeakySingletonTraits<MemoryPurgeCoordinator>>::get();
+}
+
+MemoryPurgeCoordinator::MemoryPurgeCoordinator()
+    : memory_pressure_listener_(new MemoryPressureListener(
+          Bind(&MemoryPurgeCoordinator::OnMemoryPressure, Unretained(this)))) {
+}
+
+MemoryPurgeCoordinator::~MemoryPurgeCoordinator() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+}
+
+void MemoryPurgeCoordinator::RegisterClient(MemoryPurgeClient* client) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK(!IsRegistered(client));
+  clients_.push_back(client);
+}
+
+void MemoryPurgeCoordinator::UnregisterClient(MemoryPurgeClient* client) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  auto it = std::find(clients_.begin(), clients_.end(), client);
+  DCHECK(it != clients_.end());
+  clients_.erase(it);
+}
+
+size_t MemoryPurgeCoordinator::PurgeUntil(size_t target_bytes) {
+  Purge(MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE, target_bytes);
+  return last_purge_.freed_bytes;
+}
+
+void MemoryPurgeCoordinator::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  size_t target_bytes = std::numeric_limits<size_t>::max();
+  if (level == MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE) {
+    size_t reclaimable_bytes = 0;
+    for (const MemoryPurgeClient* client : clients_)
+      reclaimable_bytes += client->EstimatePurge().reclaimable_bytes;
+    target_bytes = reclaimable_bytes / 2;
+  }
+  Purge(level, target_bytes);
+}
+
+void MemoryPurgeCoordinator::Purge(
+    MemoryPressureListener::MemoryPressureLevel level,
+    size_t target_bytes) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(clients_.size());
+  for (MemoryPurgeClient* client : clients_) {
+    Candidate candidate = {client, client->EstimatePurge()};
+    if (candidate.estimate.reclaimable_bytes)
+      candidates.push_back(candidate);
+  }
+  std::stable_sort(candidates.begin(), candidates.end(), &HasBetterRatio);
+
+  PurgeRecord record;
+  record.level = level;
+  record.target_bytes = target_bytes;
+  for (const Candidate& candidate : candidates) {
+    if (record.freed_bytes >= target_bytes)
+      break;
+    // An earlier client may have unregistered this one while purging.
+    if (!IsRegistered(candidate.client))
+      continue;
+    record.freed_bytes += candidate.client->Purge();
+    record.estimated_bytes += candidate.estimate.reclaimable_bytes;
+    ++record.purged_clients;
+  }
+  last_purge_ = record;
+
+  TRACE_EVENT_INSTANT2(TRACE_DISABLED_BY_DEFAULT("memory-infra"),
+                       "MemoryPurgeCoordinator::Purge",
+                       TRACE_EVENT_SCOPE_THREAD, "estimated_bytes",
+                       record.estimated_bytes, "freed_bytes",
+                       record.freed_bytes);
+}
+
+bool MemoryPurgeCoordinator::IsRegistered(MemoryPurgeClient* client) const {
+  return std::find(clients_.begin(), clients_.end(), client) != clients_.end();
+}
+
+}  // namespace base
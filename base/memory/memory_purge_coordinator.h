@@ -0,0 +1,113 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_MEMORY_PURGE_COORDINATOR_H_
+#define BASE_MEMORY_MEMORY_PURGE_COORDINATOR_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/threading/thread_checker.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// A subsystem holding memory that it can free and later re-create, such as a
+// cache. Register it with MemoryPurgeCoordinator instead of listening to
+// MemoryPressureListener directly to only be purged when that is worth it.
+class BASE_EXPORT MemoryPurgeClient {
+ public:
+  struct Estimate {
+    // How many bytes Purge() would free right now.
+    size_t reclaimable_bytes;
+
+    // How long it would take to re-create what Purge() frees, once it is
+    // needed again.
+    TimeDelta recreation_cost;
+  };
+
+  // Returns what purging would free and cost. Should be cheap to call.
+  virtual Estimate EstimatePurge() const = 0;
+
+  // Frees as much memory as possible and returns how many bytes were
+  // actually freed.
+  virtual size_t Purge() = 0;
+
+ protected:
+  virtual ~MemoryPurgeClient() {}
+};
+
+// Decides which clients to purge under memory pressure. Rather than having
+// every subsystem drop everything at once, and pay to reload it all
+// afterwards, the coordinator purges the clients that free the most memory
+// for the least re-creation cost first, and stops once enough has been freed:
+// - Under MEMORY_PRESSURE_LEVEL_MODERATE, until half of the estimated
+//   reclaimable memory is freed.
+// - Under MEMORY_PRESSURE_LEVEL_CRITICAL, everything is purged, since the
+//   alternative is being killed.
+//
+// All methods must be called on the thread the coordinator was created on,
+// which is also the thread clients are purged on.
+class BASE_EXPORT MemoryPurgeCoordinator {
+ public:
+  // What a purge did.
+  struct PurgeRecord {
+    PurgeRecord();
+
+    MemoryPressureListener::MemoryPressureLevel level;
+    size_t target_bytes;
+    // Number of clients that were purged.
+    size_t purged_clients;
+    // Sum of the estimates of the purged clients.
+    size_t estimated_bytes;
+    // What the purged clients reported actually freeing.
+    size_t freed_bytes;
+  };
+
+  // Returns the coordinator of the process, which must first be called on the
+  // main thread.
+  static MemoryPurgeCoordinator* GetInstance();
+
+  // Starts listening to memory pressure notifications.
+  MemoryPurgeCoordinator();
+  ~MemoryPurgeCoordinator();
+
+  // |client| must be unregistered before it is destroyed. It may unregister
+  // from within Purge().
+  void RegisterClient(MemoryPurgeClient* client);
+  void UnregisterClient(MemoryPurgeClient* client);
+
+  // Purges clients in order of decreasing reclaimable bytes per unit of cost
+  // until at least |target_bytes| have been freed or all are purged.
+  // Returns the number of bytes freed.
+  size_t PurgeUntil(size_t target_bytes);
+
+  // Purges clients as described above for |level|.
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+
+  // The last purge, for memory reporting and tests.
+  const PurgeRecord& last_purge() const { return last_purge_; }
+
+ private:
+  void Purge(MemoryPressureListener::MemoryPressureLevel level,
+             size_t target_bytes);
+
+  bool IsRegistered(MemoryPurgeClient* client) const;
+
+  std::vector<MemoryPurgeClient*> clients_;
+  PurgeRecord last_purge_;
+  std::unique_ptr<MemoryPressureListener> memory_pressure_listener_;
+  ThreadChecker thread_checker_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPurgeCoordinator);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_MEMORY_PURGE_COORDINATOR_H_
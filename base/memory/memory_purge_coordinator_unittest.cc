@@ -0,0 +1,162 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_purge_coordinator.h"
+
+#include <memory>
+
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class TestClient : public MemoryPurgeClient {
+ public:
+  TestClient(size_t reclaimable_bytes, int recreation_cost_ms)
+      : reclaimable_bytes_(reclaimable_bytes),
+        freed_bytes_(reclaimable_bytes),
+        recreation_cost_(TimeDelta::FromMilliseconds(recreation_cost_ms)),
+        purge_count_(0),
+        client_to_unregister_(nullptr),
+        coordinator_(nullptr) {}
+
+  // MemoryPurgeClient:
+  Estimate EstimatePurge() const override {
+    Estimate estimate = {reclaimable_bytes_, recreation_cost_};
+    return estimate;
+  }
+  size_t Purge() override {
+    ++purge_count_;
+    if (client_to_unregister_)
+      coordinator_->UnregisterClient(client_to_unregister_);
+    reclaimable_bytes_ = 0;
+    return freed_bytes_;
+  }
+
+  void set_freed_bytes(size_t freed_bytes) { freed_bytes_ = freed_bytes; }
+  void UnregisterWhenPurged(MemoryPurgeCoordinator* coordinator,
+                            MemoryPurgeClient* client) {
+    coordinator_ = coordinator;
+    client_to_unregister_ = client;
+  }
+
+  int purge_count() const { return purge_count_; }
+
+ private:
+  size_t reclaimable_bytes_;
+  size_t freed_bytes_;
+  TimeDelta recreation_cost_;
+  int purge_count_;
+  MemoryPurgeClient* client_to_unregister_;
+  MemoryPurgeCoordinator* coordinator_;
+};
+
+}  // namespace
+
+class MemoryPurgeCoordinatorTest : public testing::Test {
+ protected:
+  MessageLoop message_loop_;
+  MemoryPurgeCoordinator coordinator_;
+};
+
+TEST_F(MemoryPurgeCoordinatorTest, PurgesBestRatioFirst) {
+  TestClient expensive(1000, 100);  // 10 bytes/ms.
+  TestClient cheap(1000, 1);        // 1000 bytes/ms.
+  TestClient large(50000, 10);      // 5000 bytes/ms.
+  coordinator_.RegisterClient(&expensive);
+  coordinator_.RegisterClient(&cheap);
+  coordinator_.RegisterClient(&large);
+
+  EXPECT_EQ(50000u, coordinator_.PurgeUntil(40000));
+  EXPECT_EQ(1, large.purge_count());
+  EXPECT_EQ(0, cheap.purge_count());
+  EXPECT_EQ(0, expensive.purge_count());
+
+  EXPECT_EQ(1000u, coordinator_.PurgeUntil(1));
+  EXPECT_EQ(1, large.purge_count());
+  EXPECT_EQ(1, cheap.purge_count());
+  EXPECT_EQ(0, expensive.purge_count());
+
+  coordinator_.UnregisterClient(&expensive);
+  coordinator_.UnregisterClient(&cheap);
+  coordinator_.UnregisterClient(&large);
+}
+
+TEST_F(MemoryPurgeCoordinatorTest, RecordsFreedBytes) {
+  TestClient first(1000, 1);
+  TestClient second(1000, 10);
+  first.set_freed_bytes(400);
+  coordinator_.RegisterClient(&first);
+  coordinator_.RegisterClient(&second);
+
+  // The first client freeing less than estimated makes the second one be
+  // purged too.
+  EXPECT_EQ(1400u, coordinator_.PurgeUntil(1000));
+  const MemoryPurgeCoordinator::PurgeRecord& record =
+      coordinator_.last_purge();
+  EXPECT_EQ(1000u, record.target_bytes);
+  EXPECT_EQ(2u, record.purged_clients);
+  EXPECT_EQ(2000u, record.estimated_bytes);
+  EXPECT_EQ(1400u, record.freed_bytes);
+
+  coordinator_.UnregisterClient(&first);
+  coordinator_.UnregisterClient(&second);
+}
+
+TEST_F(MemoryPurgeCoordinatorTest, ModeratePressurePurgesHalf) {
+  TestClient clients[] = {{1000, 1}, {1000, 2}, {1000, 3}, {1000, 4}};
+  for (TestClient& client : clients)
+    coordinator_.RegisterClient(&client);
+
+  coordinator_.OnMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(2000u, coordinator_.last_purge().freed_bytes);
+  EXPECT_EQ(1, clients[0].purge_count());
+  EXPECT_EQ(1, clients[1].purge_count());
+  EXPECT_EQ(0, clients[2].purge_count());
+  EXPECT_EQ(0, clients[3].purge_count());
+
+  for (TestClient& client : clients)
+    coordinator_.UnregisterClient(&client);
+}
+
+TEST_F(MemoryPurgeCoordinatorTest, CriticalPressurePurgesEverything) {
+  TestClient clients[] = {{1000, 1}, {1000, 2}, {1000, 3}, {0, 4}};
+  for (TestClient& client : clients)
+    coordinator_.RegisterClient(&client);
+
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+            coordinator_.last_purge().level);
+  EXPECT_EQ(3000u, coordinator_.last_purge().freed_bytes);
+  EXPECT_EQ(1, clients[0].purge_count());
+  EXPECT_EQ(1, clients[1].purge_count());
+  EXPECT_EQ(1, clients[2].purge_count());
+  // Clients with nothing to free aren't purged.
+  EXPECT_EQ(0, clients[3].purge_count());
+
+  for (TestClient& client : clients)
+    coordinator_.UnregisterClient(&client);
+}
+
+TEST_F(MemoryPurgeCoordinatorTest, UnregisterWhilePurging) {
+  TestClient first(1000, 1);
+  TestClient second(1000, 2);
+  first.UnregisterWhenPurged(&coordinator_, &second);
+  coordinator_.RegisterClient(&first);
+  coordinator_.RegisterClient(&second);
+
+  EXPECT_EQ(1000u, coordinator_.PurgeUntil(2000));
+  EXPECT_EQ(1, first.purge_count());
+  EXPECT_EQ(0, second.purge_count());
+
+  coordinator_.UnregisterClient(&first);
+}
+
+}  // namespace base
@@ -0,0 +1,293 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/task_node_allocator.h"
+
+#include <atomic>
+#include <new>
+
+#include "base/containers/linked_list.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/aligned_memory.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Size of the header which precedes each node. Keeps nodes aligned like malloc
+// memory.
+const size_t kHeaderSize = 16;
+
+// Distance between two nodes of a slab.
+const size_t kNodeStride = kHeaderSize + TaskNodeAllocator::kMaxNodeSize;
+
+class Slab;
+
+struct NodeHeader {
+  // Slab which contains the node, or nullptr if the node was allocated with
+  // operator new.
+  Slab* slab;
+
+  // Next node in the same free list, while the node is free.
+  NodeHeader* next_free;
+};
+
+static_assert(sizeof(NodeHeader) <= kHeaderSize, "NodeHeader is too large");
+static_assert(kNodeStride % kHeaderSize == 0, "nodes are misaligned");
+
+void* NodeFromHeader(NodeHeader* header) {
+  return reinterpret_cast<char*>(header) + kHeaderSize;
+}
+
+NodeHeader* HeaderFromNode(void* node) {
+  return reinterpret_cast<NodeHeader*>(static_cast<char*>(node) - kHeaderSize);
+}
+
+// Nodes of one thread. Nodes are carved from |storage_| on demand. Nodes freed
+// on the owning thread go to |local_free_|, which doesn't require
+// synchronization. Nodes freed on other threads go to |remote_free_|, which is
+// protected by |lock_|, and are moved to |local_free_| when it is empty.
+//
+// When the owning thread exits, nodes of the slab may still be in use on other
+// threads. The slab is then deleted by whichever thread frees the last of them.
+class Slab : public LinkNode<Slab> {
+ public:
+  explicit Slab(PlatformThreadId thread_id)
+      : thread_id_(thread_id),
+        storage_(static_cast<char*>(AlignedAlloc(
+            TaskNodeAllocator::kNodesPerSlab * kNodeStride, kHeaderSize))) {}
+
+  ~Slab() { AlignedFree(storage_); }
+
+  // Allocates a node of |size| bytes. Must be called on the owning thread.
+  void* Allocate(size_t size) {
+    NodeHeader* header =
+        size <= TaskNodeAllocator::kMaxNodeSize ? TakeFreeNode() : nullptr;
+    if (!header) {
+      num_fallback_allocations_.store(
+          num_fallback_allocations_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      header = static_cast<NodeHeader*>(::operator new(kHeaderSize + size));
+      header->slab = nullptr;
+    }
+    return NodeFromHeader(header);
+  }
+
+  // Frees a node of this slab. Must be called on the owning thread.
+  void FreeLocal(NodeHeader* header) {
+    DCHECK_EQ(this, header->slab);
+    header->next_free = local_free_;
+    local_free_ = header;
+    num_local_free_.store(num_local_free_.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+  }
+
+  // Frees a node of this slab on a thread other than the owning thread, or
+  // after the owning thread has exited. Returns true if the slab must be
+  // deleted.
+  bool FreeRemote(NodeHeader* header) {
+    DCHECK_EQ(this, header->slab);
+    AutoLock auto_lock(lock_);
+    if (owner_exited_) {
+      DCHECK_GT(num_nodes_in_use_after_exit_, 0U);
+      return --num_nodes_in_use_after_exit_ == 0;
+    }
+    header->next_free = remote_free_;
+    remote_free_ = header;
+    num_remote_free_.store(num_remote_free_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    return false;
+  }
+
+  // Called on the owning thread when it exits. Returns true if the slab must be
+  // deleted.
+  bool OnOwnerExit() {
+    AutoLock auto_lock(lock_);
+    DCHECK(!owner_exited_);
+    owner_exited_ = true;
+    num_nodes_in_use_after_exit_ =
+        num_carved_.load(std::memory_order_relaxed) -
+        num_local_free_.load(std::memory_order_relaxed) -
+        num_remote_free_.load(std::memory_order_relaxed);
+    return num_nodes_in_use_after_exit_ == 0;
+  }
+
+  // Can be called on any thread while the owning thread is alive. The stats
+  // are approximate when nodes are concurrently allocated or freed.
+  void GetStats(TaskNodeAllocator::SlabStats* stats) const {
+    stats->thread_id = thread_id_;
+    stats->reserved_size = TaskNodeAllocator::kNodesPerSlab * kNodeStride;
+    const size_t num_carved = num_carved_.load(std::memory_order_relaxed);
+    const size_t num_free = num_local_free_.load(std::memory_order_relaxed) +
+                            num_remote_free_.load(std::memory_order_relaxed);
+    stats->nodes_in_use = num_carved > num_free ? num_carved - num_free : 0;
+    stats->num_fallback_allocations =
+        num_fallback_allocations_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Returns a free node of this slab, or nullptr if there is none.
+  NodeHeader* TakeFreeNode() {
+    // |num_remote_free_| is checked first to avoid locking when no node was
+    // freed remotely. A remote free that is missed here is seen by a later
+    // call.
+    if (!local_free_ && num_remote_free_.load(std::memory_order_relaxed)) {
+      AutoLock auto_lock(lock_);
+      local_free_ = remote_free_;
+      remote_free_ = nullptr;
+      num_local_free_.store(num_remote_free_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+      num_remote_free_.store(0, std::memory_order_relaxed);
+    }
+
+    if (local_free_) {
+      NodeHeader* const header = local_free_;
+      local_free_ = header->next_free;
+      num_local_free_.store(
+          num_local_free_.load(std::memory_order_relaxed) - 1,
+          std::memory_order_relaxed);
+      return header;
+    }
+
+    const size_t num_carved = num_carved_.load(std::memory_order_relaxed);
+    if (num_carved == TaskNodeAllocator::kNodesPerSlab)
+      return nullptr;
+    NodeHeader* const header =
+        reinterpret_cast<NodeHeader*>(storage_ + num_carved * kNodeStride);
+    header->slab = this;
+    num_carved_.store(num_carved + 1, std::memory_order_relaxed);
+    return header;
+  }
+
+  const PlatformThreadId thread_id_;
+  char* const storage_;
+
+  // Free nodes freed on the owning thread. Only accessed on the owning thread.
+  NodeHeader* local_free_ = nullptr;
+
+  // Written only on the owning thread. Read by GetStats() on any thread.
+  std::atomic<size_t> num_carved_{0};
+  std::atomic<size_t> num_local_free_{0};
+  std::atomic<uint64_t> num_fallback_allocations_{0};
+
+  // Number of nodes in |remote_free_|. Written with |lock_| held.
+  std::atomic<size_t> num_remote_free_{0};
+
+  mutable Lock lock_;
+
+  // Nodes freed on other threads. Protected by |lock_|.
+  NodeHeader* remote_free_ = nullptr;
+
+  // True once the owning thread has exited. Protected by |lock_|.
+  bool owner_exited_ = false;
+
+  // Number of nodes not freed yet, once the owning thread has exited.
+  // Protected by |lock_|.
+  size_t num_nodes_in_use_after_exit_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Slab);
+};
+
+// Owns the thread-local slot which points to the Slab of each thread, and
+// keeps track of the Slabs of live threads.
+class SlabRegistry {
+ public:
+  SlabRegistry() : tls_slab_(&OnTLSDestroy) {}
+
+  Slab* GetCurrentThreadSlab() {
+    return static_cast<Slab*>(tls_slab_.Get());
+  }
+
+  Slab* GetOrCreateCurrentThreadSlab() {
+    Slab* slab = GetCurrentThreadSlab();
+    if (slab)
+      return slab;
+    slab = new Slab(PlatformThread::CurrentId());
+    {
+      AutoLock auto_lock(lock_);
+      slabs_.Append(slab);
+    }
+    tls_slab_.Set(slab);
+    return slab;
+  }
+
+  void GetSlabStats(std::vector<TaskNodeAllocator::SlabStats>* stats) {
+    AutoLock auto_lock(lock_);
+    for (LinkNode<Slab>* node = slabs_.head(); node != slabs_.end();
+         node = node->next()) {
+      stats->emplace_back();
+      node->value()->GetStats(&stats->back());
+    }
+  }
+
+ private:
+  static void OnTLSDestroy(void* value);
+
+  void RemoveSlab(Slab* slab) {
+    AutoLock auto_lock(lock_);
+    slab->RemoveFromList();
+  }
+
+  // Protects |slabs_|.
+  Lock lock_;
+
+  // Slabs of live threads.
+  LinkedList<Slab> slabs_;
+
+  ThreadLocalStorage::Slot tls_slab_;
+
+  DISALLOW_COPY_AND_ASSIGN(SlabRegistry);
+};
+
+LazyInstance<SlabRegistry>::Leaky g_slab_registry = LAZY_INSTANCE_INITIALIZER;
+
+// static
+void SlabRegistry::OnTLSDestroy(void* value) {
+  Slab* const slab = static_cast<Slab*>(value);
+  g_slab_registry.Get().RemoveSlab(slab);
+  if (slab->OnOwnerExit())
+    delete slab;
+}
+
+}  // namespace
+
+// static
+const size_t TaskNodeAllocator::kMaxNodeSize;
+// static
+const size_t TaskNodeAllocator::kNodesPerSlab;
+
+// static
+void* TaskNodeAllocator::Allocate(size_t size) {
+  return g_slab_registry.Get().GetOrCreateCurrentThreadSlab()->Allocate(size);
+}
+
+// static
+void TaskNodeAllocator::Free(void* node) {
+  if (!node)
+    return;
+  NodeHeader* const header = HeaderFromNode(node);
+  Slab* const slab = header->slab;
+  if (!slab) {
+    ::operator delete(header);
+    return;
+  }
+  if (slab == g_slab_registry.Get().GetCurrentThreadSlab()) {
+    slab->FreeLocal(header);
+    return;
+  }
+  if (slab->FreeRemote(header))
+    delete slab;
+}
+
+// static
+void TaskNodeAllocator::GetSlabStats(std::vector<SlabStats>* stats) {
+  g_slab_registry.Get().GetSlabStats(stats);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,77 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_TASK_NODE_ALLOCATOR_H_
+#define BASE_MEMORY_TASK_NODE_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/threading/platform_thread.h"
+
+namespace base {
+namespace internal {
+
+// Allocator for the nodes which hold queued tasks, e.g. the nodes of
+// MessageLoop's incoming queue and TaskScheduler Tasks. Each thread that
+// allocates nodes gets a slab of kNodesPerSlab nodes, and nodes freed back to
+// the slab are reused by later allocations on that thread instead of going
+// through malloc for every posted task. A node freed on another thread returns
+// to the slab of the thread that allocated it. Allocations fall back to malloc
+// when the slab of the current thread is exhausted or when they are larger than
+// kMaxNodeSize.
+//
+// A class allocates its instances with it by declaring:
+//
+//   static void* operator new(size_t size) {
+//     return TaskNodeAllocator::Allocate(size);
+//   }
+//   static void operator delete(void* node) { TaskNodeAllocator::Free(node); }
+//
+// Slabs are reported to memory-infra by TaskNodeAllocatorDumpProvider.
+class BASE_EXPORT TaskNodeAllocator {
+ public:
+  // Largest allocation served from a slab.
+  static const size_t kMaxNodeSize = 128;
+
+  // Number of nodes in the slab of a thread.
+  static const size_t kNodesPerSlab = 64;
+
+  struct SlabStats {
+    // Thread which owns the slab.
+    PlatformThreadId thread_id;
+
+    // Memory reserved for the slab, in bytes.
+    size_t reserved_size;
+
+    // Number of nodes of the slab that haven't been freed, on any thread.
+    size_t nodes_in_use;
+
+    // Number of allocations on the owning thread that fell back to malloc
+    // because the slab was exhausted or the allocation was too large.
+    uint64_t num_fallback_allocations;
+  };
+
+  // Returns memory for a node of |size| bytes, aligned like malloc memory.
+  // Never returns nullptr.
+  static void* Allocate(size_t size);
+
+  // Frees |node|, returned by Allocate() on any thread.
+  static void Free(void* node);
+
+  // Appends the stats of the slab of each live thread to |stats|. Thread-safe.
+  static void GetSlabStats(std::vector<SlabStats>* stats);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(TaskNodeAllocator);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_MEMORY_TASK_NODE_ALLOCATOR_H_
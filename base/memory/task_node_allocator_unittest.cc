@@ -0,0 +1,162 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/task_node_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/single_thread_task_runner.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+const size_t kNodeSize = TaskNodeAllocator::kMaxNodeSize;
+
+// Returns the stats of the slab of the current thread.
+TaskNodeAllocator::SlabStats GetCurrentThreadSlabStats() {
+  std::vector<TaskNodeAllocator::SlabStats> all_stats;
+  TaskNodeAllocator::GetSlabStats(&all_stats);
+  for (const auto& stats : all_stats) {
+    if (stats.thread_id == PlatformThread::CurrentId())
+      return stats;
+  }
+  ADD_FAILURE() << "No slab for the current thread.";
+  return TaskNodeAllocator::SlabStats();
+}
+
+bool HasSlabForThread(PlatformThreadId thread_id) {
+  std::vector<TaskNodeAllocator::SlabStats> all_stats;
+  TaskNodeAllocator::GetSlabStats(&all_stats);
+  for (const auto& stats : all_stats) {
+    if (stats.thread_id == thread_id)
+      return true;
+  }
+  return false;
+}
+
+void AllocateNodes(size_t num_nodes, std::vector<void*>* nodes) {
+  for (size_t i = 0; i < num_nodes; ++i)
+    nodes->push_back(TaskNodeAllocator::Allocate(kNodeSize));
+}
+
+void FreeNodes(std::vector<void*>* nodes) {
+  for (void* node : *nodes)
+    TaskNodeAllocator::Free(node);
+  nodes->clear();
+}
+
+void GetThreadId(PlatformThreadId* thread_id) {
+  *thread_id = PlatformThread::CurrentId();
+}
+
+class TaskNodeAllocatorTest : public testing::Test {
+ protected:
+  TaskNodeAllocatorTest() = default;
+
+  void SetUp() override {
+    // Make sure that the current thread has a slab.
+    TaskNodeAllocator::Free(TaskNodeAllocator::Allocate(kNodeSize));
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TaskNodeAllocatorTest);
+};
+
+}  // namespace
+
+TEST_F(TaskNodeAllocatorTest, ReusesFreedNode) {
+  void* const node = TaskNodeAllocator::Allocate(kNodeSize);
+  memset(node, 0xAB, kNodeSize);
+  TaskNodeAllocator::Free(node);
+  EXPECT_EQ(node, TaskNodeAllocator::Allocate(kNodeSize));
+  TaskNodeAllocator::Free(node);
+}
+
+TEST_F(TaskNodeAllocatorTest, Alignment) {
+  std::vector<void*> nodes;
+  AllocateNodes(3, &nodes);
+  nodes.push_back(TaskNodeAllocator::Allocate(kNodeSize + 1));
+  for (void* node : nodes)
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(node) % sizeof(void*));
+  FreeNodes(&nodes);
+}
+
+TEST_F(TaskNodeAllocatorTest, FallbackWhenExhausted) {
+  const TaskNodeAllocator::SlabStats initial_stats =
+      GetCurrentThreadSlabStats();
+
+  // The slab has room for |kNodesPerSlab - initial_stats.nodes_in_use| nodes.
+  std::vector<void*> nodes;
+  AllocateNodes(TaskNodeAllocator::kNodesPerSlab + 1, &nodes);
+  TaskNodeAllocator::SlabStats stats = GetCurrentThreadSlabStats();
+  EXPECT_EQ(TaskNodeAllocator::kNodesPerSlab, stats.nodes_in_use);
+  EXPECT_EQ(initial_stats.num_fallback_allocations +
+                initial_stats.nodes_in_use + 1,
+            stats.num_fallback_allocations);
+  FreeNodes(&nodes);
+  EXPECT_EQ(initial_stats.nodes_in_use,
+            GetCurrentThreadSlabStats().nodes_in_use);
+
+  // Allocations larger than kMaxNodeSize always fall back.
+  TaskNodeAllocator::Free(TaskNodeAllocator::Allocate(kNodeSize + 1));
+  EXPECT_EQ(stats.num_fallback_allocations + 1,
+            GetCurrentThreadSlabStats().num_fallback_allocations);
+}
+
+TEST_F(TaskNodeAllocatorTest, FreeOnOtherThread) {
+  const TaskNodeAllocator::SlabStats initial_stats =
+      GetCurrentThreadSlabStats();
+  std::vector<void*> nodes;
+  AllocateNodes(TaskNodeAllocator::kNodesPerSlab - initial_stats.nodes_in_use,
+                &nodes);
+  EXPECT_EQ(TaskNodeAllocator::kNodesPerSlab,
+            GetCurrentThreadSlabStats().nodes_in_use);
+
+  Thread thread("TaskNodeAllocatorTest");
+  thread.Start();
+  thread.task_runner()->PostTask(FROM_HERE, Bind(&FreeNodes, &nodes));
+  thread.Stop();
+
+  // The freed nodes are back in the slab of this thread and are reused without
+  // falling back.
+  const TaskNodeAllocator::SlabStats stats = GetCurrentThreadSlabStats();
+  EXPECT_EQ(initial_stats.nodes_in_use, stats.nodes_in_use);
+  AllocateNodes(TaskNodeAllocator::kNodesPerSlab - initial_stats.nodes_in_use,
+                &nodes);
+  EXPECT_EQ(stats.num_fallback_allocations,
+            GetCurrentThreadSlabStats().num_fallback_allocations);
+  FreeNodes(&nodes);
+}
+
+TEST_F(TaskNodeAllocatorTest, FreeAfterOwnerExit) {
+  std::vector<void*> nodes;
+  PlatformThreadId thread_id = kInvalidThreadId;
+  Thread thread("TaskNodeAllocatorTest");
+  thread.Start();
+  thread.task_runner()->PostTask(FROM_HERE, Bind(&AllocateNodes, 3, &nodes));
+  thread.task_runner()->PostTask(FROM_HERE, Bind(&GetThreadId, &thread_id));
+  thread.Stop();
+
+  // The slab of an exited thread isn't reported, but its nodes stay valid until
+  // they are freed.
+  EXPECT_EQ(3U, nodes.size());
+  EXPECT_FALSE(HasSlabForThread(thread_id));
+  memset(nodes[0], 0xAB, kNodeSize);
+  FreeNodes(&nodes);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,55 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/delayed_work_queue.h"
+
+#include "base/logging.h"
+
+namespace base {
+
+DelayedWorkQueue::DelayedWorkQueue() = default;
+
+DelayedWorkQueue::~DelayedWorkQueue() = default;
+
+void DelayedWorkQueue::SetType(DelayedWorkQueueType type) {
+  DCHECK(empty());
+  type_ = type;
+}
+
+void DelayedWorkQueue::push(const PendingTask& pending_task) {
+  DCHECK(!pending_task.delayed_run_time.is_null());
+  if (type_ == DelayedWorkQueueType::TIMER_WHEEL)
+    timer_wheel_.Push(pending_task.delayed_run_time, pending_task);
+  else
+    heap_.push(pending_task);
+}
+
+const PendingTask& DelayedWorkQueue::top() const {
+  DCHECK(!empty());
+  if (type_ == DelayedWorkQueueType::TIMER_WHEEL)
+    return timer_wheel_.Top();
+  return heap_.top();
+}
+
+void DelayedWorkQueue::pop() {
+  DCHECK(!empty());
+  if (type_ == DelayedWorkQueueType::TIMER_WHEEL)
+    timer_wheel_.Pop();
+  else
+    heap_.pop();
+}
+
+bool DelayedWorkQueue::empty() const {
+  if (type_ == DelayedWorkQueueType::TIMER_WHEEL)
+    return timer_wheel_.empty();
+  return heap_.empty();
+}
+
+size_t DelayedWorkQueue::size() const {
+  if (type_ == DelayedWorkQueueType::TIMER_WHEEL)
+    return timer_wheel_.size();
+  return heap_.size();
+}
+
+}  // namespace base
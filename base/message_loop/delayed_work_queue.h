@@ -0,0 +1,65 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MESSAGE_LOOP_DELAYED_WORK_QUEUE_H_
+#define BASE_MESSAGE_LOOP_DELAYED_WORK_QUEUE_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+#include "base/containers/timer_wheel.h"
+#include "base/macros.h"
+#include "base/pending_task.h"
+
+namespace base {
+
+// Data structure used by a MessageLoop to sort its delayed tasks.
+enum class DelayedWorkQueueType {
+  // Binary heap. Insertion is O(log n).
+  HEAP,
+
+  // Hierarchical timer wheel. Insertion is O(1), which is cheaper on loops
+  // that have many pending delayed tasks (e.g. timeouts).
+  TIMER_WHEEL,
+};
+
+// A queue of delayed PendingTasks sorted by |delayed_run_time|, and then by
+// |sequence_num|. The tasks must be pushed in order of |sequence_num|. This
+// class is not thread-safe.
+class BASE_EXPORT DelayedWorkQueue {
+ public:
+  DelayedWorkQueue();
+  ~DelayedWorkQueue();
+
+  // Changes the data structure used to sort the tasks. The queue must be
+  // empty.
+  void SetType(DelayedWorkQueueType type);
+  DelayedWorkQueueType type() const { return type_; }
+
+  void push(const PendingTask& pending_task);
+
+  // Returns the task with the earliest |delayed_run_time|. The queue must not
+  // be empty.
+  const PendingTask& top() const;
+
+  void pop();
+
+  bool empty() const;
+  size_t size() const;
+
+ private:
+  DelayedWorkQueueType type_ = DelayedWorkQueueType::HEAP;
+
+  // Only the member that matches |type_| is used. TimerWheel pops values with
+  // the same deadline in insertion order, which is also |sequence_num|
+  // order.
+  DelayedTaskQueue heap_;
+  TimerWheel<PendingTask> timer_wheel_;
+
+  DISALLOW_COPY_AND_ASSIGN(DelayedWorkQueue);
+};
+
+}  // namespace base
+
+#endif  // BASE_MESSAGE_LOOP_DELAYED_WORK_QUEUE_H_
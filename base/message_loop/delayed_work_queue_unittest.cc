@@ -0,0 +1,77 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/delayed_work_queue.h"
+
+#include <stdint.h>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/location.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class DelayedWorkQueueTest
+    : public testing::TestWithParam<DelayedWorkQueueType> {
+ protected:
+  DelayedWorkQueueTest() { queue_.SetType(GetParam()); }
+
+  void Push(int64_t delay_ms) {
+    PendingTask pending_task(
+        FROM_HERE, Bind(&DoNothing),
+        TimeTicks() + TimeDelta::FromMilliseconds(delay_ms), true);
+    pending_task.sequence_num = next_sequence_num_++;
+    queue_.push(pending_task);
+  }
+
+  // Pops the top task and returns its sequence number.
+  int Pop() {
+    const int sequence_num = queue_.top().sequence_num;
+    queue_.pop();
+    return sequence_num;
+  }
+
+  DelayedWorkQueue queue_;
+
+ private:
+  int next_sequence_num_ = 0;
+};
+
+}  // namespace
+
+TEST_P(DelayedWorkQueueTest, PopInDelayedRunTimeOrder) {
+  EXPECT_EQ(GetParam(), queue_.type());
+  EXPECT_TRUE(queue_.empty());
+
+  Push(30);
+  Push(10);
+  Push(20);
+  Push(10);
+  Push(100000);
+  EXPECT_EQ(5U, queue_.size());
+
+  EXPECT_EQ(1, Pop());
+  EXPECT_EQ(3, Pop());
+  EXPECT_EQ(2, Pop());
+
+  // A task pushed after some tasks were popped can be the next one to run.
+  Push(15);
+  EXPECT_EQ(5, Pop());
+  EXPECT_EQ(0, Pop());
+  EXPECT_EQ(4, Pop());
+  EXPECT_TRUE(queue_.empty());
+}
+
+INSTANTIATE_TEST_CASE_P(Heap,
+                        DelayedWorkQueueTest,
+                        ::testing::Values(DelayedWorkQueueType::HEAP));
+INSTANTIATE_TEST_CASE_P(TimerWheel,
+                        DelayedWorkQueueTest,
+                        ::testing::Values(DelayedWorkQueueType::TIMER_WHEEL));
+
+}  // namespace base
@@ -82,34 +82,45 @@ bool IncomingTaskQueue::AddToIncomingQueue(
   return PostPendingTask(&pending_task);
 }
 
+bool IncomingTaskQueue::AddTasksToIncomingQueue(
+    const tracked_objects::Location& from_here,
+    const std::vector<Closure>& tasks) {
+  std::vector<PendingTask> pending_tasks;
+  pending_tasks.reserve(tasks.size());
+  for (const Closure& task : tasks)
+    pending_tasks.push_back(PendingTask(from_here, task));
+  return PostPendingTasks(&pending_tasks);
+}
+
 bool IncomingTaskQueue::HasHighResolutionTasks() {
-  AutoLock lock(incoming_queue_lock_);
-  return high_res_task_count_ > 0;
+  return high_res_task_count_.load(std::memory_order_relaxed) > 0;
 }
 
 bool IncomingTaskQueue::IsIdleForTesting() {
-  AutoLock lock(incoming_queue_lock_);
-  return incoming_queue_.empty();
+  return incoming_queue_.IsEmpty();
 }
 
 int IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
   // Make sure no tasks are lost.
   DCHECK(work_queue->empty());
 
-  // Acquire all we can from the inter-thread queue with one lock acquisition.
-  AutoLock lock(incoming_queue_lock_);
-  if (incoming_queue_.empty()) {
+  // Acquire all we can from the inter-thread queue without taking a lock.
+  if (!incoming_queue_.PopAll(work_queue)) {
     // If the loop attempts to reload but there are no tasks in the incoming
     // queue, that means it will go to sleep waiting for more work. If the
     // incoming queue becomes nonempty we need to schedule it again.
-    message_loop_scheduled_ = false;
-  } else {
-    incoming_queue_.swap(*work_queue);
+    message_loop_scheduled_.store(false);
+
+    // A task may have been pushed after PopAll() returned but before
+    // |message_loop_scheduled_| was cleared, by a thread which then saw
+    // |message_loop_scheduled_| == true and didn't schedule work. Pick it up
+    // now. Any task pushed after this point sees the cleared flag and
+    // schedules work. Both sides use sequentially consistent operations so
+    // that at least one of them observes the other.
+    incoming_queue_.PopAll(work_queue);
   }
   // Reset the count of high resolution tasks since our queue is now empty.
-  int high_res_tasks = high_res_task_count_;
-  high_res_task_count_ = 0;
-  return high_res_tasks;
+  return high_res_task_count_.exchange(0, std::memory_order_relaxed);
 }
 
 void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
@@ -118,14 +129,15 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
 }
 
 void IncomingTaskQueue::StartScheduling() {
-  bool schedule_work;
-  {
-    AutoLock lock(incoming_queue_lock_);
-    DCHECK(!is_ready_for_scheduling_);
-    DCHECK(!message_loop_scheduled_);
-    is_ready_for_scheduling_ = true;
-    schedule_work = !incoming_queue_.empty();
-  }
+  DCHECK(!is_ready_for_scheduling_.load());
+  DCHECK(!message_loop_scheduled_.load());
+  is_ready_for_scheduling_.store(true);
+
+  // Tasks posted before |is_ready_for_scheduling_| was set didn't schedule
+  // work. Tasks posted after it was set schedule work unless this does it
+  // first.
+  const bool schedule_work =
+      !incoming_queue_.IsEmpty() && !message_loop_scheduled_.exchange(true);
   if (schedule_work) {
     DCHECK(message_loop_);
     // Don't need to lock |message_loop_lock_| here because this function is
@@ -152,47 +164,69 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
     return false;
   }
 
-  bool schedule_work = false;
-  {
-    AutoLock hold(incoming_queue_lock_);
+  WillQueuePendingTask(pending_task);
+  incoming_queue_.Push(*pending_task);
+  pending_task->task.Reset();
+
+  ScheduleWork();
+  return true;
+}
+
+bool IncomingTaskQueue::PostPendingTasks(
+    std::vector<PendingTask>* pending_tasks) {
+  if (pending_tasks->empty())
+    return true;
+
+  // Ensures |message_loop_| isn't destroyed while running.
+  base::subtle::AutoReadLock hold_message_loop(message_loop_lock_);
+
+  if (!message_loop_) {
+    pending_tasks->clear();
+    return false;
+  }
+
+  for (PendingTask& pending_task : *pending_tasks)
+    WillQueuePendingTask(&pending_task);
+  incoming_queue_.PushAll(*pending_tasks);
+  pending_tasks->clear();
+
+  ScheduleWork();
+  return true;
+}
 
+void IncomingTaskQueue::WillQueuePendingTask(PendingTask* pending_task) {
 #if defined(OS_WIN)
-    if (pending_task->is_high_res)
-      ++high_res_task_count_;
+  if (pending_task->is_high_res)
+    high_res_task_count_.fetch_add(1, std::memory_order_relaxed);
 #endif
 
-    // Initialize the sequence number. The sequence number is used for delayed
-    // tasks (to facilitate FIFO sorting when two tasks have the same
-    // delayed_run_time value) and for identifying the task in about:tracing.
-    pending_task->sequence_num = next_sequence_num_++;
-
-    message_loop_->task_annotator()->DidQueueTask("MessageLoop::PostTask",
-                                                  *pending_task);
-
-    bool was_empty = incoming_queue_.empty();
-    incoming_queue_.push(std::move(*pending_task));
-
-    if (is_ready_for_scheduling_ &&
-        (always_schedule_work_ || (!message_loop_scheduled_ && was_empty))) {
-      schedule_work = true;
-      // After we've scheduled the message loop, we do not need to do so again
-      // until we know it has processed all of the work in our queue and is
-      // waiting for more work again. The message loop will always attempt to
-      // reload from the incoming queue before waiting again so we clear this
-      // flag in ReloadWorkQueue().
-      message_loop_scheduled_ = true;
-    }
-  }
+  // Initialize the sequence number. The sequence number is used for delayed
+  // tasks (to facilitate FIFO sorting when two tasks have the same
+  // delayed_run_time value) and for identifying the task in about:tracing.
+  // Sequence numbers are increasing for tasks posted from the same thread,
+  // which is the only ordering guaranteed between posted tasks.
+  pending_task->sequence_num =
+      next_sequence_num_.fetch_add(1, std::memory_order_relaxed);
+
+  message_loop_->task_annotator()->DidQueueTask("MessageLoop::PostTask",
+                                                *pending_task);
+}
 
-  // Wake up the message loop and schedule work. This is done outside
-  // |incoming_queue_lock_| because signaling the message loop may cause this
-  // thread to be switched. If |incoming_queue_lock_| is held, any other thread
-  // that wants to post a task will be blocked until this thread switches back
-  // in and releases |incoming_queue_lock_|.
+void IncomingTaskQueue::ScheduleWork() {
+  // After we've scheduled the message loop, we do not need to do so again
+  // until we know it has processed all of the work in our queue and is
+  // waiting for more work again. The message loop will always attempt to
+  // reload from the incoming queue before waiting again so we clear
+  // |message_loop_scheduled_| in ReloadWorkQueue().
+  const bool schedule_work =
+      is_ready_for_scheduling_.load() &&
+      (always_schedule_work_ || !message_loop_scheduled_.exchange(true));
+
+  // Wake up the message loop and schedule work. Signaling the message loop may
+  // cause this thread to be switched; since no lock is held here, other threads
+  // can keep posting tasks in the meantime.
   if (schedule_work)
     message_loop_->ScheduleWork();
-
-  return true;
 }
 
 }  // namespace internal
@@ -5,11 +5,14 @@
 #ifndef BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 #define BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 
+#include <atomic>
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/lock_free_task_queue.h"
 #include "base/pending_task.h"
-#include "base/synchronization/lock.h"
 #include "base/synchronization/read_write_lock.h"
 #include "base/time/time.h"
 
@@ -22,7 +25,8 @@ namespace internal {
 
 // Implements a queue of tasks posted to the message loop running on the current
 // thread. This class takes care of synchronizing posting tasks from different
-// threads and together with MessageLoop ensures clean shutdown.
+// threads and together with MessageLoop ensures clean shutdown. Posting a task
+// doesn't take any lock other than the reader side of |message_loop_lock_|.
 class BASE_EXPORT IncomingTaskQueue
     : public RefCountedThreadSafe<IncomingTaskQueue> {
  public:
@@ -40,11 +44,18 @@ class BASE_EXPORT IncomingTaskQueue
                           TimeDelta delay,
                           bool nestable);
 
+  // Appends all of |tasks| to the incoming queue as nestable non-delayed tasks.
+  // The tasks are pushed together and the message loop is woken up at most
+  // once. Returns true if the tasks were successfully added to the queue.
+  bool AddTasksToIncomingQueue(const tracked_objects::Location& from_here,
+                               const std::vector<Closure>& tasks);
+
   // Returns true if the queue contains tasks that require higher than default
   // timer resolution. Currently only needed for Windows.
   bool HasHighResolutionTasks();
 
-  // Returns true if the message loop is "idle". Provided for testing.
+  // Returns true if the message loop is "idle". Provided for testing. Must be
+  // called from the thread that is running the loop.
   bool IsIdleForTesting();
 
   // Loads tasks from the |incoming_queue_| into |*work_queue|. Must be called
@@ -69,42 +80,50 @@ class BASE_EXPORT IncomingTaskQueue
   // does not retain |pending_task->task| beyond this function call.
   bool PostPendingTask(PendingTask* pending_task);
 
-  // Wakes up the message loop and schedules work.
+  // Adds all of |pending_tasks| to |incoming_queue_| with a single push and
+  // clears |pending_tasks|.
+  bool PostPendingTasks(std::vector<PendingTask>* pending_tasks);
+
+  // Assigns a sequence number to |pending_task| and notifies the task
+  // annotator that it is being queued. Must be called with
+  // |message_loop_lock_| held and |message_loop_| non-null.
+  void WillQueuePendingTask(PendingTask* pending_task);
+
+  // Wakes up the message loop and schedules work, unless it is already
+  // scheduled. Must be called with |message_loop_lock_| held and
+  // |message_loop_| non-null, after tasks have been pushed to
+  // |incoming_queue_|.
   void ScheduleWork();
 
   // Number of tasks that require high resolution timing. This value is kept
   // so that ReloadWorkQueue() completes in constant time.
-  int high_res_task_count_;
-
-  // The lock that protects access to the members of this class, except
-  // |message_loop_|.
-  base::Lock incoming_queue_lock_;
+  std::atomic<int> high_res_task_count_;
 
   // Lock that protects |message_loop_| to prevent it from being deleted while a
   // task is being posted.
   base::subtle::ReadWriteLock message_loop_lock_;
 
-  // An incoming queue of tasks that are acquired under a mutex for processing
-  // on this instance's thread. These tasks have not yet been been pushed to
-  // |message_loop_|.
-  TaskQueue incoming_queue_;
+  // An incoming queue of tasks that are pushed without a lock from any thread
+  // and popped for processing on this instance's thread. These tasks have not
+  // yet been been pushed to |message_loop_|.
+  LockFreeTaskQueue incoming_queue_;
 
   // Points to the message loop that owns |this|.
   MessageLoop* message_loop_;
 
   // The next sequence number to use for delayed tasks.
-  int next_sequence_num_;
+  std::atomic<int> next_sequence_num_;
 
   // True if our message loop has already been scheduled and does not need to be
   // scheduled again until an empty reload occurs.
-  bool message_loop_scheduled_;
+  std::atomic<bool> message_loop_scheduled_;
 
   // True if we always need to call ScheduleWork when receiving a new task, even
   // if the incoming queue was not empty.
   const bool always_schedule_work_;
 
   // False until StartScheduling() is called.
-  bool is_ready_for_scheduling_;
+  std::atomic<bool> is_ready_for_scheduling_;
 
   DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
 };
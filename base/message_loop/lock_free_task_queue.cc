@@ -0,0 +1,115 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/lock_free_task_queue.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/task_node_allocator.h"
+
+namespace base {
+namespace internal {
+
+struct LockFreeTaskQueue::Node : public NodeBase {
+  explicit Node(const PendingTask& pending_task) : pending_task(pending_task) {}
+
+  // Nodes are allocated on the posting thread and usually freed on the thread
+  // of the MessageLoop.
+  static void* operator new(size_t size) {
+    return TaskNodeAllocator::Allocate(size);
+  }
+  static void operator delete(void* node) { TaskNodeAllocator::Free(node); }
+
+  PendingTask pending_task;
+};
+
+LockFreeTaskQueue::LockFreeTaskQueue() : head_(&stub_), tail_(&stub_) {}
+
+LockFreeTaskQueue::~LockFreeTaskQueue() {
+  while (Node* node = PopNode())
+    delete node;
+  DCHECK(IsEmpty());
+}
+
+void LockFreeTaskQueue::Push(const PendingTask& pending_task) {
+  Node* const node = new Node(pending_task);
+  PushNodes(node, node);
+}
+
+void LockFreeTaskQueue::PushAll(const std::vector<PendingTask>& pending_tasks) {
+  if (pending_tasks.empty())
+    return;
+
+  // Link the nodes together before publishing them. The chain only becomes
+  // reachable by the consumer in PushNodes().
+  Node* const first = new Node(pending_tasks.front());
+  Node* last = first;
+  for (size_t i = 1; i < pending_tasks.size(); ++i) {
+    Node* const node = new Node(pending_tasks[i]);
+    last->next.store(node, std::memory_order_relaxed);
+    last = node;
+  }
+  PushNodes(first, last);
+}
+
+bool LockFreeTaskQueue::PopAll(TaskQueue* work_queue) {
+  DCHECK(work_queue);
+  bool popped = false;
+  while (Node* node = PopNode()) {
+    work_queue->push(std::move(node->pending_task));
+    delete node;
+    popped = true;
+  }
+  return popped;
+}
+
+bool LockFreeTaskQueue::IsEmpty() const {
+  return tail_ == &stub_ && head_.load() == &stub_;
+}
+
+void LockFreeTaskQueue::PushNodes(NodeBase* first, NodeBase* last) {
+  last->next.store(nullptr, std::memory_order_relaxed);
+  NodeBase* const previous_head = head_.exchange(last);
+  // Between the exchange above and the store below, the queue is transiently
+  // split: the consumer can't reach |first| until |previous_head| points to it.
+  previous_head->next.store(first);
+}
+
+LockFreeTaskQueue::Node* LockFreeTaskQueue::PopNode() {
+  NodeBase* tail = tail_;
+  NodeBase* next = tail->next.load();
+
+  // Skip |stub_| if it is at the tail.
+  if (tail == &stub_) {
+    if (!next)
+      return nullptr;
+    tail_ = next;
+    tail = next;
+    next = next->next.load();
+  }
+
+  if (next) {
+    tail_ = next;
+    return static_cast<Node*>(tail);
+  }
+
+  // |tail| is the last linked node. If it isn't the head, a producer is in the
+  // middle of PushNodes() and the nodes after |tail| can't be reached yet.
+  if (tail != head_.load())
+    return nullptr;
+
+  // Re-insert |stub_| so that |tail| can be unlinked without leaving the queue
+  // without a node.
+  PushNodes(&stub_, &stub_);
+  next = tail->next.load();
+  if (next) {
+    tail_ = next;
+    return static_cast<Node*>(tail);
+  }
+  return nullptr;
+}
+
+}  // namespace internal
+}  // namespace base
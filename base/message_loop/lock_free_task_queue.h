@@ -0,0 +1,86 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MESSAGE_LOOP_LOCK_FREE_TASK_QUEUE_H_
+#define BASE_MESSAGE_LOOP_LOCK_FREE_TASK_QUEUE_H_
+
+#include <atomic>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/pending_task.h"
+
+namespace base {
+namespace internal {
+
+// An unbounded multi-producer/single-consumer queue of PendingTasks. Push()
+// can be called concurrently from any number of threads without taking a lock.
+// PopAll() and IsEmpty() must only be called from the single consumer thread.
+//
+// PendingTasks pushed from the same thread are popped in the order in which
+// they were pushed. The queue is intrusive: each PendingTask is stored in a
+// node which is linked into the queue with a single atomic exchange.
+//
+// A Push() becomes visible to the consumer once the producer has linked its
+// node. A producer can be preempted between the exchange and the link, in
+// which case PopAll() doesn't see the PendingTask (nor the ones pushed after
+// it) until the link is done; callers that need a wake-up guarantee must
+// synchronize with the consumer after Push() returns (see IncomingTaskQueue).
+class BASE_EXPORT LockFreeTaskQueue {
+ public:
+  LockFreeTaskQueue();
+
+  // Deletes all PendingTasks still in the queue. Must not race with Push().
+  ~LockFreeTaskQueue();
+
+  // Adds a copy of |pending_task| at the end of the queue. Thread-safe.
+  void Push(const PendingTask& pending_task);
+
+  // Adds copies of |pending_tasks| at the end of the queue, in order, with a
+  // single atomic exchange. The PendingTasks aren't interleaved with
+  // PendingTasks pushed concurrently by other threads. Thread-safe.
+  void PushAll(const std::vector<PendingTask>& pending_tasks);
+
+  // Moves all PendingTasks visible to the consumer to the end of |work_queue|,
+  // in FIFO order. Returns true if at least one PendingTask was moved.
+  bool PopAll(TaskQueue* work_queue);
+
+  // Returns true if no PendingTask has been pushed since the last PopAll() that
+  // emptied the queue. Unlike PopAll(), this also accounts for a Push() whose
+  // node isn't linked yet.
+  bool IsEmpty() const;
+
+ private:
+  struct NodeBase {
+    std::atomic<NodeBase*> next{nullptr};
+  };
+  struct Node;
+
+  // Links the chain of nodes from |first| to |last| at the head of the queue.
+  // |last->next| is reset; the nodes before |last| must already be linked.
+  void PushNodes(NodeBase* first, NodeBase* last);
+
+  // Unlinks and returns the node at the tail of the queue, or nullptr if no
+  // node is visible to the consumer. Never returns |stub_|.
+  Node* PopNode();
+
+  // Node pointed to by |head_| and |tail_| when the queue is empty. Always
+  // part of the queue so that producers never have to deal with an empty list.
+  NodeBase stub_;
+
+  // Most recently pushed node. Modified by producers.
+  std::atomic<NodeBase*> head_;
+
+  // Least recently pushed node that hasn't been popped. Only accessed by the
+  // consumer.
+  NodeBase* tail_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockFreeTaskQueue);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_MESSAGE_LOOP_LOCK_FREE_TASK_QUEUE_H_
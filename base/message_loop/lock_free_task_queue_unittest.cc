@@ -0,0 +1,169 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/lock_free_task_queue.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/pending_task.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+const int kNumThreadsPushing = 4;
+const int kNumTasksPushedPerThread = 1000;
+
+PendingTask CreatePendingTask(int sequence_num) {
+  PendingTask pending_task(FROM_HERE, Bind(&DoNothing));
+  pending_task.sequence_num = sequence_num;
+  return pending_task;
+}
+
+// Pushes |kNumTasksPushedPerThread| PendingTasks in |queue|. The sequence
+// number of each PendingTask encodes the index of the thread and the index of
+// the PendingTask for that thread.
+class ThreadPushingTasks : public SimpleThread {
+ public:
+  ThreadPushingTasks(LockFreeTaskQueue* queue, int index)
+      : SimpleThread("ThreadPushingTasks"), queue_(queue), index_(index) {}
+
+  void Run() override {
+    for (int i = 0; i < kNumTasksPushedPerThread; ++i)
+      queue_->Push(CreatePendingTask(index_ * kNumTasksPushedPerThread + i));
+  }
+
+ private:
+  LockFreeTaskQueue* const queue_;
+  const int index_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPushingTasks);
+};
+
+class RefCountedObject : public RefCountedThreadSafe<RefCountedObject> {
+ public:
+  RefCountedObject() = default;
+
+ private:
+  friend class RefCountedThreadSafe<RefCountedObject>;
+  ~RefCountedObject() = default;
+
+  DISALLOW_COPY_AND_ASSIGN(RefCountedObject);
+};
+
+void DoNothingWithObject(scoped_refptr<RefCountedObject> object) {}
+
+}  // namespace
+
+TEST(LockFreeTaskQueueTest, PushPopAll) {
+  LockFreeTaskQueue queue;
+  TaskQueue work_queue;
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(work_queue.empty());
+
+  for (int i = 0; i < 3; ++i)
+    queue.Push(CreatePendingTask(i));
+  EXPECT_FALSE(queue.IsEmpty());
+
+  EXPECT_TRUE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(3U, work_queue.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, work_queue.front().sequence_num);
+    work_queue.pop();
+  }
+
+  // The queue can be reused once it has been emptied.
+  queue.Push(CreatePendingTask(3));
+  EXPECT_FALSE(queue.IsEmpty());
+  EXPECT_TRUE(queue.PopAll(&work_queue));
+  ASSERT_EQ(1U, work_queue.size());
+  EXPECT_EQ(3, work_queue.front().sequence_num);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Verify that PendingTasks pushed with PushAll() are popped in order, after the
+// PendingTasks pushed before them.
+TEST(LockFreeTaskQueueTest, PushAll) {
+  LockFreeTaskQueue queue;
+  TaskQueue work_queue;
+
+  queue.PushAll(std::vector<PendingTask>());
+  EXPECT_TRUE(queue.IsEmpty());
+
+  queue.Push(CreatePendingTask(0));
+  std::vector<PendingTask> pending_tasks;
+  for (int i = 1; i < 4; ++i)
+    pending_tasks.push_back(CreatePendingTask(i));
+  queue.PushAll(pending_tasks);
+  EXPECT_FALSE(queue.IsEmpty());
+
+  EXPECT_TRUE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(4U, work_queue.size());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i, work_queue.front().sequence_num);
+    work_queue.pop();
+  }
+}
+
+// Verify that PendingTasks pushed concurrently from multiple threads are all
+// popped and that PendingTasks pushed from the same thread are popped in order.
+TEST(LockFreeTaskQueueTest, ConcurrentPush) {
+  LockFreeTaskQueue queue;
+
+  std::vector<std::unique_ptr<ThreadPushingTasks>> threads;
+  for (int i = 0; i < kNumThreadsPushing; ++i) {
+    threads.push_back(WrapUnique(new ThreadPushingTasks(&queue, i)));
+    threads.back()->Start();
+  }
+
+  std::vector<int> next_task_index(kNumThreadsPushing, 0);
+  int num_popped = 0;
+  while (num_popped < kNumThreadsPushing * kNumTasksPushedPerThread) {
+    TaskQueue work_queue;
+    queue.PopAll(&work_queue);
+    while (!work_queue.empty()) {
+      const int sequence_num = work_queue.front().sequence_num;
+      const int thread_index = sequence_num / kNumTasksPushedPerThread;
+      EXPECT_EQ(next_task_index[thread_index],
+                sequence_num % kNumTasksPushedPerThread);
+      ++next_task_index[thread_index];
+      ++num_popped;
+      work_queue.pop();
+    }
+  }
+
+  for (const auto& thread : threads)
+    thread->Join();
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Verify that PendingTasks left in the queue are deleted with it.
+TEST(LockFreeTaskQueueTest, DeleteWithPendingTasks) {
+  scoped_refptr<RefCountedObject> object(new RefCountedObject);
+  {
+    LockFreeTaskQueue queue;
+    queue.Push(PendingTask(FROM_HERE, Bind(&DoNothingWithObject, object)));
+    queue.Push(PendingTask(FROM_HERE, Bind(&DoNothingWithObject, object)));
+    EXPECT_FALSE(object->HasOneRef());
+  }
+  EXPECT_TRUE(object->HasOneRef());
+}
+
+}  // namespace internal
+}  // namespace base
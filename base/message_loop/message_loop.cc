@@ -332,6 +332,11 @@ Closure MessageLoop::QuitWhenIdleClosure() {
   return Bind(&QuitCurrentWhenIdle);
 }
 
+void MessageLoop::SetDelayedWorkQueueType(DelayedWorkQueueType type) {
+  DCHECK_EQ(this, current());
+  delayed_work_queue_.SetType(type);
+}
+
 void MessageLoop::SetNestableTasksAllowed(bool allowed) {
   if (allowed) {
     // Kick the native pump just in case we enter a OS-driven nested message
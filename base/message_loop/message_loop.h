@@ -16,6 +16,7 @@
 #include "base/location.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/delayed_work_queue.h"
 #include "base/message_loop/incoming_task_queue.h"
 #include "base/message_loop/message_loop_task_runner.h"
 #include "base/message_loop/message_pump.h"
@@ -284,6 +285,11 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
     pump_->SetTimerSlack(timer_slack);
   }
 
+  // Set the data structure used to sort the delayed tasks of this message
+  // loop. Must be called on the thread to which the message loop is bound,
+  // before any delayed task has been moved out of the incoming queue.
+  void SetDelayedWorkQueueType(DelayedWorkQueueType type);
+
   // Returns true if this loop is |type|. This allows subclasses (especially
   // those in tests) to specialize how they are identified.
   virtual bool IsType(Type type) const;
@@ -493,7 +499,7 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
 #endif
 
   // Contains delayed tasks, sorted by their 'delayed_run_time' property.
-  DelayedTaskQueue delayed_work_queue_;
+  DelayedWorkQueue delayed_work_queue_;
 
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   TimeTicks recent_time_;
@@ -4,6 +4,8 @@
 
 #include "base/message_loop/message_loop_task_runner.h"
 
+#include <algorithm>
+
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop/incoming_task_queue.h"
@@ -38,6 +40,15 @@ bool MessageLoopTaskRunner::PostNonNestableDelayedTask(
   return incoming_queue_->AddToIncomingQueue(from_here, task, delay, false);
 }
 
+bool MessageLoopTaskRunner::PostTasks(
+    const tracked_objects::Location& from_here,
+    const std::vector<Closure>& tasks) {
+  DCHECK(std::none_of(tasks.begin(), tasks.end(),
+                      [](const Closure& task) { return task.is_null(); }))
+      << from_here.ToString();
+  return incoming_queue_->AddTasksToIncomingQueue(from_here, tasks);
+}
+
 bool MessageLoopTaskRunner::RunsTasksOnCurrentThread() const {
   AutoLock lock(valid_thread_id_lock_);
   return valid_thread_id_ == PlatformThread::CurrentId();
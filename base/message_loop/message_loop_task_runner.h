@@ -5,6 +5,8 @@
 #ifndef BASE_MESSAGE_LOOP_MESSAGE_LOOP_TASK_RUNNER_H_
 #define BASE_MESSAGE_LOOP_MESSAGE_LOOP_TASK_RUNNER_H_
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -36,6 +38,8 @@ class BASE_EXPORT MessageLoopTaskRunner : public SingleThreadTaskRunner {
   bool PostNonNestableDelayedTask(const tracked_objects::Location& from_here,
                                   const base::Closure& task,
                                   base::TimeDelta delay) override;
+  bool PostTasks(const tracked_objects::Location& from_here,
+                 const std::vector<Closure>& tasks) override;
   bool RunsTasksOnCurrentThread() const override;
 
  private:
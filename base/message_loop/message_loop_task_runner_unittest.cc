@@ -5,6 +5,7 @@
 #include "base/message_loop/message_loop_task_runner.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/atomic_sequence_num.h"
 #include "base/bind.h"
@@ -289,6 +290,13 @@ class MessageLoopTaskRunnerThreadingTest : public testing::Test {
     test->Quit();
   }
 
+  static void RecordTask(MessageLoopTaskRunnerThreadingTest* test,
+                         std::vector<int>* run_order,
+                         int task_index) {
+    test->AssertOnFileThread();
+    run_order->push_back(task_index);
+  }
+
   static void AssertNotRun() { FAIL() << "Callback Should not get executed."; }
 
   class DeletedOnFile {
@@ -331,6 +339,24 @@ TEST_F(MessageLoopTaskRunnerThreadingTest, PostTask) {
   MessageLoop::current()->Run();
 }
 
+TEST_F(MessageLoopTaskRunnerThreadingTest, PostTasks) {
+  const int kNumTasks = 5;
+  std::vector<int> run_order;
+  std::vector<Closure> tasks;
+  for (int i = 0; i < kNumTasks; ++i) {
+    tasks.push_back(Bind(&MessageLoopTaskRunnerThreadingTest::RecordTask,
+                         Unretained(this), Unretained(&run_order), i));
+  }
+  tasks.push_back(Bind(&MessageLoopTaskRunnerThreadingTest::BasicFunction,
+                       Unretained(this)));
+  EXPECT_TRUE(file_thread_->task_runner()->PostTasks(FROM_HERE, tasks));
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(static_cast<size_t>(kNumTasks), run_order.size());
+  for (int i = 0; i < kNumTasks; ++i)
+    EXPECT_EQ(i, run_order[i]);
+}
+
 TEST_F(MessageLoopTaskRunnerThreadingTest, PostTaskAfterThreadExits) {
   std::unique_ptr<Thread> test_thread(
       new Thread("MessageLoopTaskRunnerThreadingTest_Dummy"));
@@ -357,4 +383,17 @@ TEST_F(MessageLoopTaskRunnerThreadingTest, PostTaskAfterThreadIsDeleted) {
   EXPECT_FALSE(ret);
 }
 
+TEST_F(MessageLoopTaskRunnerThreadingTest, PostTasksAfterThreadExits) {
+  std::unique_ptr<Thread> test_thread(
+      new Thread("MessageLoopTaskRunnerThreadingTest_Dummy"));
+  test_thread->Start();
+  scoped_refptr<SingleThreadTaskRunner> task_runner =
+      test_thread->task_runner();
+  test_thread->Stop();
+
+  std::vector<Closure> tasks(
+      2, Bind(&MessageLoopTaskRunnerThreadingTest::AssertNotRun));
+  EXPECT_FALSE(task_runner->PostTasks(FROM_HERE, tasks));
+}
+
 }  // namespace base
@@ -9,10 +9,12 @@
 #include "base/format_macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/scoped_vector.h"
+#include "base/message_loop/lock_free_task_queue.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/simple_thread.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -302,4 +304,111 @@ TEST_F(PostTaskTest, OneHundredTasksPerReload) {
   Run(1000, 100);
 }
 
+// A TaskQueue protected by a Lock, with the same interface as
+// LockFreeTaskQueue. This is how IncomingTaskQueue stored incoming tasks before
+// it switched to LockFreeTaskQueue.
+class LockedTaskQueue {
+ public:
+  LockedTaskQueue() = default;
+
+  void Push(const PendingTask& pending_task) {
+    AutoLock auto_lock(lock_);
+    queue_.push(pending_task);
+  }
+
+  bool PopAll(TaskQueue* work_queue) {
+    AutoLock auto_lock(lock_);
+    if (queue_.empty())
+      return false;
+    queue_.swap(*work_queue);
+    return true;
+  }
+
+ private:
+  Lock lock_;
+  TaskQueue queue_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockedTaskQueue);
+};
+
+// Measures the throughput of a queue of PendingTasks pushed to concurrently by
+// several threads and drained by a single consumer, like the incoming queue of
+// a MessageLoop.
+template <typename QueueType>
+class ConcurrentPushTest : public testing::Test {
+ public:
+  void Run(const char* queue_name, int num_pushing_threads) {
+    QueueType queue;
+    std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+    std::vector<std::unique_ptr<PushTasksDelegate>> delegates;
+    for (int i = 0; i < num_pushing_threads; ++i) {
+      delegates.push_back(WrapUnique(new PushTasksDelegate(&queue)));
+      threads.push_back(WrapUnique(
+          new DelegateSimpleThread(delegates.back().get(), "PushingThread")));
+    }
+
+    const TimeTicks start = TimeTicks::Now();
+    for (const auto& thread : threads)
+      thread->Start();
+
+    const size_t expected_num_tasks = num_pushing_threads * kNumTasksPerThread;
+    size_t num_popped = 0;
+    while (num_popped < expected_num_tasks) {
+      TaskQueue work_queue;
+      queue.PopAll(&work_queue);
+      num_popped += work_queue.size();
+    }
+    const TimeDelta duration = TimeTicks::Now() - start;
+
+    for (const auto& thread : threads)
+      thread->Join();
+
+    perf_test::PrintResult(
+        "task", "",
+        StringPrintf("%d_threads_pushing_to_%s", num_pushing_threads,
+                     queue_name),
+        duration.InMicroseconds() / static_cast<double>(expected_num_tasks),
+        "us/task", true);
+  }
+
+ private:
+  class PushTasksDelegate : public DelegateSimpleThread::Delegate {
+   public:
+    explicit PushTasksDelegate(QueueType* queue) : queue_(queue) {}
+
+    void Run() override {
+      const PendingTask pending_task(FROM_HERE, Bind(&DoNothing));
+      for (size_t i = 0; i < kNumTasksPerThread; ++i)
+        queue_->Push(pending_task);
+    }
+
+   private:
+    QueueType* const queue_;
+
+    DISALLOW_COPY_AND_ASSIGN(PushTasksDelegate);
+  };
+
+  static const size_t kNumTasksPerThread = 500000;
+};
+
+using LockedTaskQueuePerfTest = ConcurrentPushTest<LockedTaskQueue>;
+using LockFreeTaskQueuePerfTest =
+    ConcurrentPushTest<internal::LockFreeTaskQueue>;
+
+TEST_F(LockedTaskQueuePerfTest, OneThread) {
+  Run("locked_queue", 1);
+}
+
+TEST_F(LockedTaskQueuePerfTest, FourThreads) {
+  Run("locked_queue", 4);
+}
+
+TEST_F(LockFreeTaskQueuePerfTest, OneThread) {
+  Run("lock_free_queue", 1);
+}
+
+TEST_F(LockFreeTaskQueuePerfTest, FourThreads) {
+  Run("lock_free_queue", 4);
+}
+
 }  // namespace base
@@ -298,6 +298,9 @@ FieldTrialList* FieldTrialList::global_ = NULL;
 // static
 bool FieldTrialList::used_without_global_ = false;
 
+// static
+subtle::Atomic32 FieldTrialList::registration_sequence_ = 1;
+
 FieldTrialList::Observer::~Observer() {
 }
 
@@ -309,6 +312,7 @@ FieldTrialList::FieldTrialList(
   DCHECK(!global_);
   DCHECK(!used_without_global_);
   global_ = this;
+  subtle::Barrier_AtomicIncrement(&registration_sequence_, 1);
 
   Time two_years_from_build_time = GetBuildTime() + TimeDelta::FromDays(730);
   Time::Exploded exploded;
@@ -325,6 +329,7 @@ FieldTrialList::~FieldTrialList() {
   }
   DCHECK_EQ(this, global_);
   global_ = NULL;
+  subtle::Barrier_AtomicIncrement(&registration_sequence_, 1);
 }
 
 // static
@@ -518,6 +523,13 @@ void FieldTrialList::GetActiveFieldTrialGroupsFromString(
   }
 }
 
+// static
+bool FieldTrialList::GetStatesFromString(
+    const std::string& trials_string,
+    std::vector<FieldTrial::State>* states) {
+  return ParseFieldTrialsString(trials_string, states);
+}
+
 // static
 bool FieldTrialList::CreateTrialsFromString(
     const std::string& trials_string,
@@ -647,6 +659,48 @@ void FieldTrialList::Register(FieldTrial* trial) {
   trial->AddRef();
   trial->SetTrialRegistered();
   global_->registered_[trial->trial_name()] = trial;
+  subtle::Barrier_AtomicIncrement(&registration_sequence_, 1);
+}
+
+// static
+const std::string* FieldTrialList::ResolveGroupHandle(
+    FieldTrialGroupHandle* handle) {
+  if (!global_)
+    return nullptr;
+
+  FieldTrial* field_trial;
+  subtle::Atomic32 sequence;
+  {
+    AutoLock auto_lock(global_->lock_);
+    sequence = subtle::NoBarrier_Load(&registration_sequence_);
+    field_trial = global_->PreLockedFind(handle->trial_name_);
+  }
+  // Activating the trial takes |lock_|. The group name doesn't change once
+  // chosen.
+  const std::string* group_name =
+      field_trial ? &field_trial->group_name() : nullptr;
+
+  // Only the lookup made at the current sequence number is stored, so that a
+  // concurrent lookup made before a registration can't overwrite a later one.
+  AutoLock auto_lock(global_->lock_);
+  if (subtle::NoBarrier_Load(&registration_sequence_) == sequence) {
+    subtle::Release_Store(&handle->group_name_,
+                          reinterpret_cast<subtle::AtomicWord>(group_name));
+    subtle::Release_Store(&handle->sequence_, sequence);
+  }
+  return group_name;
+}
+
+const std::string& FieldTrialGroupHandle::group_name() {
+  const std::string* group_name;
+  if (subtle::Acquire_Load(&sequence_) ==
+      subtle::Acquire_Load(&FieldTrialList::registration_sequence_)) {
+    group_name = reinterpret_cast<const std::string*>(
+        subtle::Acquire_Load(&group_name_));
+  } else {
+    group_name = FieldTrialList::ResolveGroupHandle(this);
+  }
+  return group_name ? *group_name : EmptyString();
 }
 
 }  // namespace base
@@ -62,6 +62,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
@@ -73,6 +74,7 @@
 
 namespace base {
 
+class FieldTrialGroupHandle;
 class FieldTrialList;
 
 class BASE_EXPORT FieldTrial : public RefCounted<FieldTrial> {
@@ -449,6 +451,12 @@ class BASE_EXPORT FieldTrialList {
       const std::string& trials_string,
       FieldTrial::ActiveGroups* active_groups);
 
+  // Fills in |states| with all the field trials in |trials_string|, in the
+  // format of AllStatesToString(). The states point into |trials_string|.
+  // Returns false if |trials_string| is malformed.
+  static bool GetStatesFromString(const std::string& trials_string,
+                                  std::vector<FieldTrial::State>* states);
+
   // Use a state string (re: StatesToString()) to augment the current list of
   // field trials to include the supplied trials, and using a 100% probability
   // for each trial, force them to have the same group string. This is commonly
@@ -486,6 +494,8 @@ class BASE_EXPORT FieldTrialList {
   static size_t GetFieldTrialCount();
 
  private:
+  friend class FieldTrialGroupHandle;
+
   // A map from FieldTrial names to the actual instances.
   typedef std::map<std::string, FieldTrial*> RegistrationMap;
 
@@ -502,8 +512,17 @@ class BASE_EXPORT FieldTrialList {
   // This should always be called after creating a new FieldTrial instance.
   static void Register(FieldTrial* trial);
 
+  // Looks up the group of |handle|'s trial, activating it, and stores it in
+  // |handle| unless trials were registered meanwhile. Returns the group name,
+  // or null if the trial doesn't exist.
+  static const std::string* ResolveGroupHandle(FieldTrialGroupHandle* handle);
+
   static FieldTrialList* global_;  // The singleton of this class.
 
+  // Incremented whenever a trial is registered or |global_| changes, so that
+  // FieldTrialGroupHandles look their trial up again.
+  static subtle::Atomic32 registration_sequence_;
+
   // This will tell us if there is an attempt to register a field
   // trial or check if one-time randomization is enabled without
   // creating the FieldTrialList. This is not an error, unless a
@@ -526,6 +545,45 @@ class BASE_EXPORT FieldTrialList {
   DISALLOW_COPY_AND_ASSIGN(FieldTrialList);
 };
 
+// A handle to the group of a named field trial, for code that looks it up on
+// hot paths, where FieldTrialList::FindFullName() takes a lock and searches
+// the trials by name. The group is looked up with FindFullName() semantics the
+// first time, which activates the trial, and is then read from the handle with
+// two atomic loads, until more trials are registered:
+//
+//   base::FieldTrialGroupHandle g_memory_experiment("MemoryExperiment");
+//
+//   if (g_memory_experiment.group_name() == "HighMem")
+//     SetPruningAlgorithm(kType1);
+//
+// The constructor is constexpr and there is no destructor, so handles can be
+// globals without static initializers. group_name() is thread safe.
+class BASE_EXPORT FieldTrialGroupHandle {
+ public:
+  constexpr explicit FieldTrialGroupHandle(const char* trial_name)
+      : trial_name_(trial_name), sequence_(0), group_name_(0) {}
+
+  // Returns the group name chosen for the trial, or the empty string if the
+  // trial does not exist. The result remains valid as long as the
+  // FieldTrialList does.
+  const std::string& group_name();
+
+ private:
+  friend class FieldTrialList;
+
+  const char* const trial_name_;
+
+  // The FieldTrialList registration sequence number |group_name_| was looked
+  // up at, or 0.
+  subtle::Atomic32 sequence_;
+
+  // The const std::string* group name of the trial, or null if it doesn't
+  // exist.
+  subtle::AtomicWord group_name_;
+
+  DISALLOW_COPY_AND_ASSIGN(FieldTrialGroupHandle);
+};
+
 }  // namespace base
 
 #endif  // BASE_METRICS_FIELD_TRIAL_H_
@@ -414,6 +414,27 @@ TEST_F(FieldTrialTest, GetGroupNameWithoutActivation) {
   EXPECT_TRUE(FieldTrialList::IsTrialActive(kTrialName));
 }
 
+TEST_F(FieldTrialTest, GroupHandle) {
+  const char kTrialName[] = "TestTrial";
+  const char kGroupName[] = "TestGroup";
+  FieldTrialGroupHandle handle(kTrialName);
+
+  // The trial doesn't exist yet.
+  EXPECT_TRUE(handle.group_name().empty());
+  EXPECT_TRUE(handle.group_name().empty());
+
+  // Registering the trial makes the handle look it up again, which activates
+  // it.
+  FieldTrialList::CreateFieldTrial(kTrialName, kGroupName);
+  EXPECT_FALSE(FieldTrialList::IsTrialActive(kTrialName));
+  EXPECT_EQ(kGroupName, handle.group_name());
+  EXPECT_TRUE(FieldTrialList::IsTrialActive(kTrialName));
+  EXPECT_EQ(&handle.group_name(), &handle.group_name());
+
+  FieldTrialList::CreateFieldTrial("OtherTrial", "OtherGroup");
+  EXPECT_EQ(kGroupName, handle.group_name());
+}
+
 TEST_F(FieldTrialTest, Save) {
   std::string save_string;
 
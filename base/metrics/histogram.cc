@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/debug/alias.h"
@@ -433,6 +434,31 @@ void Histogram::AddCount(int value, int count) {
   FindAndRunCallback(value);
 }
 
+void Histogram::AddValues(const Sample* values, size_t num_values) {
+  DCHECK_EQ(0, ranges(0));
+  DCHECK_EQ(kSampleType_MAX, ranges(bucket_count()));
+
+  // Clamp the values like AddCount() does. Only copy them when necessary,
+  // which it rarely is.
+  std::vector<Sample> clamped_values;
+  for (size_t i = 0; i < num_values; ++i) {
+    if (values[i] >= 0 && values[i] <= kSampleType_MAX - 1)
+      continue;
+    if (clamped_values.empty())
+      clamped_values.assign(values, values + num_values);
+    clamped_values[i] = values[i] < 0 ? 0 : kSampleType_MAX - 1;
+  }
+  if (!clamped_values.empty())
+    values = clamped_values.data();
+
+  samples_->AccumulateValues(values, num_values);
+
+  if (flags() & kCallbackExists) {
+    for (size_t i = 0; i < num_values; ++i)
+      FindAndRunCallback(values[i]);
+  }
+}
+
 std::unique_ptr<HistogramSamples> Histogram::SnapshotSamples() const {
   return SnapshotSampleVector();
 }
@@ -83,6 +83,11 @@ void HistogramBase::ClearFlags(int32_t flags) {
   subtle::NoBarrier_Store(&flags_, old_flags & ~flags);
 }
 
+void HistogramBase::AddValues(const Sample* values, size_t num_values) {
+  for (size_t i = 0; i < num_values; ++i)
+    Add(values[i]);
+}
+
 void HistogramBase::AddTime(const TimeDelta& time) {
   Add(static_cast<Sample>(time.InMilliseconds()));
 }
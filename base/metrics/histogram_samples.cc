@@ -82,6 +82,12 @@ HistogramSamples::HistogramSamples(uint64_t id, Metadata* meta)
 
 HistogramSamples::~HistogramSamples() {}
 
+void HistogramSamples::AccumulateValues(const HistogramBase::Sample* values,
+                                        size_t num_values) {
+  for (size_t i = 0; i < num_values; ++i)
+    Accumulate(values[i], 1);
+}
+
 void HistogramSamples::Add(const HistogramSamples& other) {
   IncreaseSum(other.sum());
   subtle::NoBarrier_AtomicIncrement(&meta_->redundant_count,
@@ -64,6 +64,11 @@ class BASE_EXPORT HistogramSamples {
 
   virtual void Accumulate(HistogramBase::Sample value,
                           HistogramBase::Count count) = 0;
+
+  // Accumulates a count of 1 for each of the |num_values| samples in
+  // |values|. The default implementation calls Accumulate() for each of them.
+  virtual void AccumulateValues(const HistogramBase::Sample* values,
+                                size_t num_values);
   virtual HistogramBase::Count GetCount(HistogramBase::Sample value) const = 0;
   virtual HistogramBase::Count TotalCount() const = 0;
 
@@ -400,6 +400,32 @@ TEST_P(HistogramTest, AddCount_LargeValuesDontOverflow) {
   EXPECT_EQ(19400000000LL, samples2->sum());
 }
 
+TEST_P(HistogramTest, AddValuesTest) {
+  const size_t kBucketCount = 50;
+  HistogramBase* histogram =
+      Histogram::FactoryGet("AddValuesHistogram", 10, 100, kBucketCount,
+                            HistogramBase::kNoFlags);
+  HistogramBase* expected_histogram =
+      Histogram::FactoryGet("AddValuesExpectedHistogram", 10, 100,
+                            kBucketCount, HistogramBase::kNoFlags);
+
+  // Out-of-bounds values are clamped like they are by Add().
+  const HistogramBase::Sample kValues[] = {20, 30, 20, -5, 1000, INT_MAX, 99};
+  histogram->AddValues(kValues, arraysize(kValues));
+  for (HistogramBase::Sample value : kValues)
+    expected_histogram->Add(value);
+
+  std::unique_ptr<HistogramSamples> samples = histogram->SnapshotSamples();
+  std::unique_ptr<HistogramSamples> expected_samples =
+      expected_histogram->SnapshotSamples();
+  EXPECT_EQ(7, samples->TotalCount());
+  EXPECT_EQ(2, samples->GetCount(20));
+  EXPECT_EQ(samples->TotalCount(), samples->redundant_count());
+  EXPECT_EQ(expected_samples->sum(), samples->sum());
+  for (HistogramBase::Sample value : {0, 10, 20, 30, 99, 100, INT_MAX - 1})
+    EXPECT_EQ(expected_samples->GetCount(value), samples->GetCount(value));
+}
+
 // Make sure histogram handles out-of-bounds data gracefully.
 TEST_P(HistogramTest, BoundsTest) {
   const size_t kBucketCount = 50;
@@ -4,6 +4,8 @@
 
 #include "base/metrics/sample_vector.h"
 
+#include <limits>
+
 #include "base/logging.h"
 #include "base/metrics/bucket_ranges.h"
 
@@ -46,6 +48,27 @@ void SampleVector::Accumulate(Sample value, Count count) {
   IncreaseRedundantCount(count);
 }
 
+void SampleVector::AccumulateValues(const Sample* values, size_t num_values) {
+  DCHECK_LE(num_values,
+            static_cast<size_t>(std::numeric_limits<Count>::max()));
+
+  // Count the samples of each bucket locally first, so that each bucket which
+  // was hit gets a single atomic increment rather than one per sample.
+  std::vector<Count> counts(counts_size_);
+  int64_t sum = 0;
+  for (size_t i = 0; i < num_values; ++i) {
+    ++counts[GetBucketIndex(values[i])];
+    sum += values[i];
+  }
+
+  for (size_t i = 0; i < counts_size_; ++i) {
+    if (counts[i])
+      subtle::NoBarrier_AtomicIncrement(&counts_[i], counts[i]);
+  }
+  IncreaseSum(sum);
+  IncreaseRedundantCount(static_cast<Count>(num_values));
+}
+
 Count SampleVector::GetCount(Sample value) const {
   size_t bucket_index = GetBucketIndex(value);
   return subtle::NoBarrier_Load(&counts_[bucket_index]);
@@ -106,23 +129,20 @@ size_t SampleVector::GetBucketIndex(Sample value) const {
   CHECK_GE(value, bucket_ranges_->range(0));
   CHECK_LT(value, bucket_ranges_->range(bucket_count));
 
-  size_t under = 0;
-  size_t over = bucket_count;
-  size_t mid;
-  do {
-    DCHECK_GE(over, under);
-    mid = under + (over - under)/2;
-    if (mid == under)
-      break;
-    if (bucket_ranges_->range(mid) <= value)
-      under = mid;
-    else
-      over = mid;
-  } while (true);
-
-  DCHECK_LE(bucket_ranges_->range(mid), value);
-  CHECK_GT(bucket_ranges_->range(mid + 1), value);
-  return mid;
+  // The bucket is in [index, index + size). Each iteration halves |size|. The
+  // choice of the half is a conditional move rather than a branch, since which
+  // half it is can't be predicted for random samples.
+  size_t index = 0;
+  size_t size = bucket_count;
+  while (size > 1) {
+    const size_t half = size / 2;
+    index = bucket_ranges_->range(index + half) <= value ? index + half : index;
+    size -= half;
+  }
+
+  DCHECK_LE(bucket_ranges_->range(index), value);
+  CHECK_GT(bucket_ranges_->range(index + 1), value);
+  return index;
 }
 
 SampleVectorIterator::SampleVectorIterator(
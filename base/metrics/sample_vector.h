@@ -38,6 +38,8 @@ class BASE_EXPORT SampleVector : public HistogramSamples {
   // HistogramSamples implementation:
   void Accumulate(HistogramBase::Sample value,
                   HistogramBase::Count count) override;
+  void AccumulateValues(const HistogramBase::Sample* values,
+                        size_t num_values) override;
   HistogramBase::Count GetCount(HistogramBase::Sample value) const override;
   HistogramBase::Count TotalCount() const override;
   std::unique_ptr<SampleCountIterator> Iterator() const override;
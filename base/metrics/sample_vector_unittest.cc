@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 
+#include "base/macros.h"
 #include "base/metrics/bucket_ranges.h"
 #include "base/metrics/histogram.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -71,6 +72,58 @@ TEST(SampleVectorTest, Accumulate_LargeValuesDontOverflow) {
   EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
 }
 
+TEST(SampleVectorTest, AccumulateValuesTest) {
+  // 8 buckets with exponential layout:
+  // [0, 1) [1, 2) [2, 4) [4, 8) [8, 16) [16, 32) [32, 64) [64, INT_MAX)
+  BucketRanges ranges(9);
+  Histogram::InitializeBucketRanges(1, 64, &ranges);
+  SampleVector samples(1, &ranges);
+  SampleVector expected_samples(2, &ranges);
+
+  const HistogramBase::Sample kValues[] = {0, 1, 3, 3, 2, 7, 63, 64, 1000, 3};
+  samples.AccumulateValues(kValues, arraysize(kValues));
+  for (HistogramBase::Sample value : kValues)
+    expected_samples.Accumulate(value, 1);
+
+  for (size_t i = 0; i < ranges.bucket_count(); ++i) {
+    EXPECT_EQ(expected_samples.GetCountAtIndex(i), samples.GetCountAtIndex(i))
+        << "bucket " << i;
+  }
+  EXPECT_EQ(4, samples.GetCount(2));
+  EXPECT_EQ(expected_samples.sum(), samples.sum());
+  EXPECT_EQ(static_cast<HistogramBase::Count>(arraysize(kValues)),
+            samples.redundant_count());
+  EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
+
+  // Accumulating no value doesn't change anything.
+  samples.AccumulateValues(kValues, 0);
+  EXPECT_EQ(expected_samples.sum(), samples.sum());
+  EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
+}
+
+TEST(SampleVectorTest, BucketIndexMatchesRanges) {
+  // Check every value against layouts with an even and odd number of buckets.
+  for (size_t bucket_count = 1; bucket_count <= 9; ++bucket_count) {
+    BucketRanges ranges(bucket_count + 1);
+    for (size_t i = 0; i <= bucket_count; ++i)
+      ranges.set_range(i, static_cast<HistogramBase::Sample>(i * i));
+
+    for (HistogramBase::Sample value = 0;
+         value < ranges.range(bucket_count); ++value) {
+      SampleVector samples(1, &ranges);
+      samples.Accumulate(value, 1);
+
+      std::unique_ptr<SampleCountIterator> it = samples.Iterator();
+      ASSERT_FALSE(it->Done());
+      HistogramBase::Sample min;
+      HistogramBase::Sample max;
+      it->Get(&min, &max, nullptr);
+      EXPECT_LE(min, value);
+      EXPECT_GT(max, value);
+    }
+  }
+}
+
 TEST(SampleVectorTest, AddSubtractTest) {
   // Custom buckets: [0, 1) [1, 2) [2, 3) [3, INT_MAX)
   BucketRanges ranges(5);
@@ -8,6 +8,7 @@
 
 #include "base/at_exit.h"
 #include "base/debug/leak_annotations.h"
+#include "base/hash.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
@@ -34,6 +35,101 @@ bool HistogramNameLesser(const base::HistogramBase* a,
 
 namespace base {
 
+// A hash table with a fixed number of buckets, each of which is a singly
+// linked list of the histograms whose name falls in it. Nodes are only
+// inserted at the head of a list, with a release store, once fully built. A
+// reader which loads a head with an acquire load can thus walk the list
+// without any lock, while a writer, which must hold |lock_|, is inserting.
+//
+// SuperFastHash is used rather than HashMetricName(), which is MD5 based and
+// would cost more than the lock this avoids.
+class StatisticsRecorder::HistogramLookupTable {
+ public:
+  HistogramLookupTable() {
+    for (std::atomic<Node*>& bucket : buckets_)
+      bucket.store(nullptr, std::memory_order_relaxed);
+  }
+
+  ~HistogramLookupTable() {
+    for (std::atomic<Node*>& bucket : buckets_) {
+      Node* node = bucket.load(std::memory_order_relaxed);
+      while (node) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+      }
+    }
+  }
+
+  // Returns the histogram named |name|, or nullptr if there is none. Can be
+  // called without holding |lock_|.
+  HistogramBase* Find(StringPiece name) const {
+    const uint32_t hash = Hash(name.data(), name.size());
+    for (const Node* node = GetBucket(hash).load(std::memory_order_acquire);
+         node; node = node->next) {
+      if (node->hash == hash && node->histogram->histogram_name() == name)
+        return node->histogram;
+    }
+    return nullptr;
+  }
+
+  // Adds |histogram|, whose name must not be in the table yet. |lock_| must be
+  // held.
+  void Insert(HistogramBase* histogram) {
+    lock_->AssertAcquired();
+    const std::string& name = histogram->histogram_name();
+    const uint32_t hash = Hash(name);
+    DCHECK(!Find(name));
+    std::atomic<Node*>& bucket = GetBucket(hash);
+    bucket.store(
+        new Node(hash, histogram, bucket.load(std::memory_order_relaxed)),
+        std::memory_order_release);
+  }
+
+  // Removes the histogram named |name|, if any. Unlike the other methods, this
+  // isn't safe against concurrent readers. For testing only.
+  void RemoveForTesting(StringPiece name) {
+    std::atomic<Node*>& bucket = GetBucket(Hash(name.data(), name.size()));
+    Node* previous = nullptr;
+    for (Node* node = bucket.load(std::memory_order_relaxed); node;
+         previous = node, node = node->next) {
+      if (node->histogram->histogram_name() != name)
+        continue;
+      if (previous)
+        previous->next = node->next;
+      else
+        bucket.store(node->next, std::memory_order_relaxed);
+      delete node;
+      return;
+    }
+  }
+
+ private:
+  struct Node {
+    Node(uint32_t hash, HistogramBase* histogram, Node* next)
+        : hash(hash), histogram(histogram), next(next) {}
+
+    const uint32_t hash;
+    HistogramBase* const histogram;
+    Node* next;
+  };
+
+  // Must be a power of 2. Large enough for the number of histograms a process
+  // typically registers to keep the lists short.
+  static const size_t kNumBuckets = 1024;
+
+  std::atomic<Node*>& GetBucket(uint32_t hash) {
+    return buckets_[hash & (kNumBuckets - 1)];
+  }
+  const std::atomic<Node*>& GetBucket(uint32_t hash) const {
+    return buckets_[hash & (kNumBuckets - 1)];
+  }
+
+  std::atomic<Node*> buckets_[kNumBuckets];
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramLookupTable);
+};
+
 StatisticsRecorder::HistogramIterator::HistogramIterator(
     const HistogramMap::iterator& iter, bool include_persistent)
     : iter_(iter),
@@ -89,6 +185,8 @@ StatisticsRecorder::~StatisticsRecorder() {
   histograms_ = existing_histograms_.release();
   callbacks_ = existing_callbacks_.release();
   ranges_ = existing_ranges_.release();
+  lookup_table_.store(existing_lookup_table_.release(),
+                      std::memory_order_release);
 }
 
 // static
@@ -131,6 +229,7 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
         // The StringKey references the name within |histogram| rather than
         // making a copy.
         (*histograms_)[name] = histogram;
+        lookup_table_.load(std::memory_order_relaxed)->Insert(histogram);
         ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
         // If there are callbacks for this histogram, we set the kCallbackExists
         // flag.
@@ -301,16 +400,11 @@ HistogramBase* StatisticsRecorder::FindHistogram(base::StringPiece name) {
   // will acquire the lock at that time.
   ImportGlobalPersistentHistograms();
 
-  if (lock_ == NULL)
-    return NULL;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  const HistogramLookupTable* lookup_table =
+      lookup_table_.load(std::memory_order_acquire);
+  if (lookup_table == NULL)
     return NULL;
-
-  HistogramMap::iterator it = histograms_->find(name);
-  if (histograms_->end() == it)
-    return NULL;
-  return it->second;
+  return lookup_table->Find(name);
 }
 
 // static
@@ -419,6 +513,10 @@ size_t StatisticsRecorder::GetHistogramCount() {
 void StatisticsRecorder::ForgetHistogramForTesting(base::StringPiece name) {
   if (histograms_)
     histograms_->erase(name);
+  HistogramLookupTable* lookup_table =
+      lookup_table_.load(std::memory_order_relaxed);
+  if (lookup_table)
+    lookup_table->RemoveForTesting(name);
 }
 
 // static
@@ -477,10 +575,13 @@ StatisticsRecorder::StatisticsRecorder() {
   existing_histograms_.reset(histograms_);
   existing_callbacks_.reset(callbacks_);
   existing_ranges_.reset(ranges_);
+  existing_lookup_table_.reset(
+      lookup_table_.load(std::memory_order_relaxed));
 
   histograms_ = new HistogramMap;
   callbacks_ = new CallbackMap;
   ranges_ = new RangesMap;
+  lookup_table_.store(new HistogramLookupTable, std::memory_order_release);
 
   if (VLOG_IS_ON(1))
     AtExitManager::RegisterCallback(&DumpHistogramsToVlog, this);
@@ -495,6 +596,7 @@ void StatisticsRecorder::Reset() {
   std::unique_ptr<HistogramMap> histograms_deleter;
   std::unique_ptr<CallbackMap> callbacks_deleter;
   std::unique_ptr<RangesMap> ranges_deleter;
+  std::unique_ptr<HistogramLookupTable> lookup_table_deleter;
   // We don't delete lock_ on purpose to avoid having to properly protect
   // against it going away after we checked for NULL in the static methods.
   {
@@ -502,9 +604,14 @@ void StatisticsRecorder::Reset() {
     histograms_deleter.reset(histograms_);
     callbacks_deleter.reset(callbacks_);
     ranges_deleter.reset(ranges_);
+    // FindHistogram() may have loaded the table without |lock_|. That's only
+    // a problem in tests, since the global StatisticsRecorder is never reset
+    // in production, and tests reset it when they are done with histograms.
+    lookup_table_deleter.reset(lookup_table_.load(std::memory_order_relaxed));
     histograms_ = NULL;
     callbacks_ = NULL;
     ranges_ = NULL;
+    lookup_table_.store(nullptr, std::memory_order_relaxed);
   }
   // We are going to leak the histograms and the ranges.
 }
@@ -525,5 +632,8 @@ StatisticsRecorder::CallbackMap* StatisticsRecorder::callbacks_ = NULL;
 StatisticsRecorder::RangesMap* StatisticsRecorder::ranges_ = NULL;
 // static
 base::Lock* StatisticsRecorder::lock_ = NULL;
+// static
+std::atomic<StatisticsRecorder::HistogramLookupTable*>
+    StatisticsRecorder::lookup_table_(nullptr);
 
 }  // namespace base
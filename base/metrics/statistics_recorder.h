@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
@@ -133,7 +134,9 @@ class BASE_EXPORT StatisticsRecorder {
   static void GetBucketRanges(std::vector<const BucketRanges*>* output);
 
   // Find a histogram by name. It matches the exact name. This method is thread
-  // safe.  It returns NULL if a matching histogram is not found.
+  // safe and doesn't acquire any lock, so it can be called at a high frequency
+  // (e.g. by histograms with runtime-generated names) from many threads. It
+  // returns NULL if a matching histogram is not found.
   static HistogramBase* FindHistogram(base::StringPiece name);
 
   // Support for iterating over known histograms.
@@ -194,6 +197,10 @@ class BASE_EXPORT StatisticsRecorder {
   // |bucket_ranges_|.
   typedef std::map<uint32_t, std::list<const BucketRanges*>*> RangesMap;
 
+  // An insert-only hash table of the registered histograms, which can be
+  // searched without holding |lock_|. Defined in the .cc file.
+  class HistogramLookupTable;
+
   friend struct DefaultLazyInstanceTraits<StatisticsRecorder>;
 
   // Imports histograms from global persistent memory. The global lock must
@@ -211,6 +218,7 @@ class BASE_EXPORT StatisticsRecorder {
   std::unique_ptr<HistogramMap> existing_histograms_;
   std::unique_ptr<CallbackMap> existing_callbacks_;
   std::unique_ptr<RangesMap> existing_ranges_;
+  std::unique_ptr<HistogramLookupTable> existing_lookup_table_;
 
   static void Reset();
   static void DumpHistogramsToVlog(void* instance);
@@ -222,6 +230,10 @@ class BASE_EXPORT StatisticsRecorder {
   // Lock protects access to above maps.
   static base::Lock* lock_;
 
+  // Holds the same histograms as |histograms_|. Modified with |lock_| held but
+  // read without it. Null whenever |histograms_| is.
+  static std::atomic<HistogramLookupTable*> lookup_table_;
+
   DISALLOW_COPY_AND_ASSIGN(StatisticsRecorder);
 };
 
@@ -14,6 +14,8 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/persistent_histogram_allocator.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -212,6 +214,72 @@ TEST_P(StatisticsRecorderTest, FindHistogram) {
   EXPECT_FALSE(StatisticsRecorder::FindHistogram("TestHistogram"));
 }
 
+TEST_P(StatisticsRecorderTest, ForgetHistogram) {
+  Histogram::FactoryGet("TestHistogram1", 1, 1000, 10,
+                        HistogramBase::kNoFlags);
+  HistogramBase* histogram2 = Histogram::FactoryGet(
+      "TestHistogram2", 1, 1000, 10, HistogramBase::kNoFlags);
+
+  StatisticsRecorder::ForgetHistogramForTesting("TestHistogram1");
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("TestHistogram1"));
+  EXPECT_EQ(histogram2, StatisticsRecorder::FindHistogram("TestHistogram2"));
+  EXPECT_EQ(1u, StatisticsRecorder::GetHistogramCount());
+
+  StatisticsRecorder::ForgetHistogramForTesting("TestHistogram2");
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("TestHistogram2"));
+  EXPECT_EQ(0u, StatisticsRecorder::GetHistogramCount());
+}
+
+namespace {
+
+const int kNumConcurrentHistograms = 50;
+
+// Gets the histograms "ConcurrentHistogram0" to "ConcurrentHistogram49",
+// creating them if they don't exist yet.
+class HistogramGetter : public DelegateSimpleThread::Delegate {
+ public:
+  HistogramGetter() = default;
+
+  void Run() override {
+    for (int i = 0; i < kNumConcurrentHistograms; ++i) {
+      histograms_[i] = Histogram::FactoryGet(
+          StringPrintf("ConcurrentHistogram%d", i), 1, 1000, 10,
+          HistogramBase::kNoFlags);
+    }
+  }
+
+  HistogramBase* histogram(int i) const { return histograms_[i]; }
+
+ private:
+  HistogramBase* histograms_[kNumConcurrentHistograms] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramGetter);
+};
+
+}  // namespace
+
+// Verify that histograms looked up concurrently with their registration are
+// registered once.
+TEST_P(StatisticsRecorderTest, ConcurrentFactoryGet) {
+  const int kNumThreads = 4;
+  HistogramGetter getters[kNumThreads];
+  DelegateSimpleThreadPool pool("HistogramGetter", kNumThreads);
+  for (HistogramGetter& getter : getters)
+    pool.AddWork(&getter);
+  pool.Start();
+  pool.JoinAll();
+
+  EXPECT_EQ(static_cast<size_t>(kNumConcurrentHistograms),
+            StatisticsRecorder::GetHistogramCount());
+  for (int i = 0; i < kNumConcurrentHistograms; ++i) {
+    HistogramBase* histogram = StatisticsRecorder::FindHistogram(
+        StringPrintf("ConcurrentHistogram%d", i));
+    ASSERT_TRUE(histogram);
+    for (const HistogramGetter& getter : getters)
+      EXPECT_EQ(histogram, getter.histogram(i));
+  }
+}
+
 TEST_P(StatisticsRecorderTest, GetSnapshot) {
   Histogram::FactoryGet("TestHistogram1", 1, 1000, 10, Histogram::kNoFlags);
   Histogram::FactoryGet("TestHistogram2", 1, 1000, 10, Histogram::kNoFlags);
@@ -0,0 +1,50 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/observer_list_threadsafe.h"
+
+namespace base {
+namespace internal {
+
+SnapshotEpoch::SnapshotEpoch() : current_(0) {
+  num_readers_[0].store(0);
+  num_readers_[1].store(0);
+}
+
+size_t SnapshotEpoch::BeginRead() {
+  // A writer may make the other version current between the load of
+  // |current_| and the increment. The reader then retries, since the writer
+  // may already be updating the version it loaded. All accesses are
+  // sequentially consistent so that a writer which sees no reader of a
+  // version can't be missed by a reader of that version.
+  for (;;) {
+    const size_t index = current_.load();
+    num_readers_[index].fetch_add(1);
+    if (current_.load() == index)
+      return index;
+    num_readers_[index].fetch_sub(1);
+  }
+}
+
+void SnapshotEpoch::EndRead(size_t index) {
+  DCHECK_GT(num_readers_[index].load(std::memory_order_relaxed), 0);
+  num_readers_[index].fetch_sub(1);
+}
+
+size_t SnapshotEpoch::BeginWrite() {
+  const size_t index = 1 - current_.load();
+  // Readers of |index| started before the last EndWrite() and don't block, so
+  // this doesn't wait long.
+  while (num_readers_[index].load() != 0)
+    PlatformThread::YieldCurrentThread();
+  return index;
+}
+
+void SnapshotEpoch::EndWrite(size_t index) {
+  DCHECK_NE(index, current_.load(std::memory_order_relaxed));
+  current_.store(index);
+}
+
+}  // namespace internal
+}  // namespace base
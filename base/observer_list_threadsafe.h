@@ -5,19 +5,26 @@
 #ifndef BASE_OBSERVER_LIST_THREADSAFE_H_
 #define BASE_OBSERVER_LIST_THREADSAFE_H_
 
+#include <stddef.h>
+
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <tuple>
+#include <vector>
 
+#include "base/base_export.h"
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/lock_free_task_queue.h"
 #include "base/message_loop/message_loop.h"
 #include "base/observer_list.h"
+#include "base/pending_task.h"
 #include "base/single_thread_task_runner.h"
-#include "base/stl_util.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_task_runner_handle.h"
 
@@ -49,8 +56,16 @@
 //   IMPLEMENTATION NOTES
 //   The ObserverListThreadSafe maintains an ObserverList for each thread
 //   which uses the ThreadSafeObserver.  When Notifying the observers,
-//   we simply call PostTask to each registered thread, and then each thread
-//   will notify its regular ObserverList.
+//   we queue the notification for each registered thread, and then each
+//   thread will notify its regular ObserverList.
+//
+//   Notify() doesn't take a lock. It reads an immutable snapshot of the
+//   registered threads, which is republished (under a lock) only when a
+//   thread is registered or unregistered. The previous snapshot is reused for
+//   the next update once the Notify() calls reading it have returned; see
+//   SnapshotEpoch. Notifications for a thread are pushed on a lock-free queue
+//   and a task is posted to the thread only when its queue was empty, so that
+//   a burst of notifications is dispatched by a single task.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -79,6 +94,36 @@ class UnboundMethod {
   Params p_;
 };
 
+// Lets readers access the current version of a data structure without taking a
+// lock while a writer prepares the next version. There are two versions,
+// indexed 0 and 1. Readers bracket their accesses with BeginRead() and
+// EndRead(). A writer, serialized with other writers by the caller, calls
+// BeginWrite(), updates the returned version and publishes it with EndWrite().
+// BeginWrite() waits until the readers of the version it returns, which was
+// current before the last EndWrite(), are done.
+class BASE_EXPORT SnapshotEpoch {
+ public:
+  SnapshotEpoch();
+
+  // Returns the index of the current version, which can be read until the
+  // matching EndRead(). Doesn't block.
+  size_t BeginRead();
+  void EndRead(size_t index);
+
+  // Returns the index of the version which isn't current, once no reader is
+  // reading it. Blocks.
+  size_t BeginWrite();
+
+  // Makes the version at |index|, returned by BeginWrite(), current.
+  void EndWrite(size_t index);
+
+ private:
+  std::atomic<size_t> current_;
+  std::atomic<int> num_readers_[2];
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotEpoch);
+};
+
 }  // namespace internal
 
 // This class is used to work around VS2005 not accepting:
@@ -122,9 +167,12 @@ class ObserverListThreadSafe
     PlatformThreadId thread_id = PlatformThread::CurrentId();
     {
       AutoLock lock(list_lock_);
-      if (observer_lists_.find(thread_id) == observer_lists_.end())
-        observer_lists_[thread_id] = new ObserverListContext(type_);
-      list = &(observer_lists_[thread_id]->list);
+      scoped_refptr<ObserverListContext>& context = observer_lists_[thread_id];
+      if (!context) {
+        context = new ObserverListContext(type_);
+        PublishContexts();
+      }
+      list = &context->list;
     }
     list->AddObserver(obs);
   }
@@ -135,8 +183,7 @@ class ObserverListThreadSafe
   // If the observer to be removed is in the list, RemoveObserver MUST
   // be called from the same thread which called AddObserver.
   void RemoveObserver(ObserverType* obs) {
-    ObserverListContext* context = nullptr;
-    ObserverList<ObserverType>* list = nullptr;
+    scoped_refptr<ObserverListContext> context;
     PlatformThreadId thread_id = PlatformThread::CurrentId();
     {
       AutoLock lock(list_lock_);
@@ -147,20 +194,19 @@ class ObserverListThreadSafe
         return;
       }
       context = it->second;
-      list = &context->list;
 
       // If we're about to remove the last observer from the list,
-      // then we can remove this observer_list entirely.
-      if (list->HasObserver(obs) && list->size() == 1)
+      // then we can remove this observer_list entirely. Notifications which
+      // are still queued for it are dropped.
+      if (context->list.HasObserver(obs) && context->list.size() == 1) {
+        context->is_registered = false;
         observer_lists_.erase(it);
+        PublishContexts();
+      }
     }
-    list->RemoveObserver(obs);
-
-    // If RemoveObserver is called from a notification, the size will be
-    // nonzero.  Instead of deleting here, the NotifyWrapper will delete
-    // when it finishes iterating.
-    if (list->size() == 0)
-      delete context;
+    // If RemoveObserver is called from a notification, |context| is kept
+    // alive by the task which runs the notification.
+    context->list.RemoveObserver(obs);
   }
 
   // Verifies that the list is currently empty (i.e. there are no observers).
@@ -181,34 +227,87 @@ class ObserverListThreadSafe
     internal::UnboundMethod<ObserverType, Method, std::tuple<Params...>> method(
         m, std::make_tuple(params...));
 
-    AutoLock lock(list_lock_);
-    for (const auto& entry : observer_lists_) {
-      ObserverListContext* context = entry.second;
-      context->task_runner->PostTask(
+    const size_t index = epoch_.BeginRead();
+    for (const scoped_refptr<ObserverListContext>& context : contexts_[index]) {
+      // The notification doesn't need to hold a ref to |this| or |context|:
+      // it is owned by |context| until the task posted by PostNotifications()
+      // runs it, and that task holds the refs.
+      context->notifications.Push(PendingTask(
           from_here,
           Bind(&ObserverListThreadSafe<ObserverType>::template NotifyWrapper<
                    Method, std::tuple<Params...>>,
-               this, context, method));
+               Unretained(this), Unretained(context.get()), method)));
+      if (context->num_pending_notifications.fetch_add(1) == 0)
+        PostNotifications(from_here, context);
     }
+    epoch_.EndRead(index);
   }
 
  private:
   // See comment above ObserverListThreadSafeTraits' definition.
   friend struct ObserverListThreadSafeTraits<ObserverType>;
 
-  struct ObserverListContext {
+  struct ObserverListContext
+      : public RefCountedThreadSafe<ObserverListContext> {
     explicit ObserverListContext(NotificationType type)
         : task_runner(ThreadTaskRunnerHandle::Get()), list(type) {}
 
-    scoped_refptr<SingleThreadTaskRunner> task_runner;
+    const scoped_refptr<SingleThreadTaskRunner> task_runner;
     ObserverList<ObserverType> list;
 
+    // Notifications queued by Notify() on any thread and not run yet.
+    internal::LockFreeTaskQueue notifications;
+
+    // Number of notifications pushed on |notifications| that haven't been
+    // popped by RunNotifications(). The task which runs them is posted when
+    // this goes from 0 to 1.
+    std::atomic<size_t> num_pending_notifications{0};
+
+    // False once the context has been removed from |observer_lists_|. Only
+    // accessed on the thread which owns the context, which is the only one
+    // that can remove it.
+    bool is_registered = true;
+
    private:
+    friend class RefCountedThreadSafe<ObserverListContext>;
+
+    // Not reached while a Notify() call can push to |notifications|, since
+    // Notify() reads a snapshot which holds a ref.
+    ~ObserverListContext() {}
+
     DISALLOW_COPY_AND_ASSIGN(ObserverListContext);
   };
 
-  ~ObserverListThreadSafe() {
-    STLDeleteValues(&observer_lists_);
+  ~ObserverListThreadSafe() {}
+
+  // Posts a task which runs the notifications queued for |context|.
+  void PostNotifications(const tracked_objects::Location& from_here,
+                         const scoped_refptr<ObserverListContext>& context) {
+    context->task_runner->PostTask(
+        from_here,
+        Bind(&ObserverListThreadSafe<ObserverType>::RunNotifications, this,
+             context));
+  }
+
+  // Runs the notifications queued for |context|. This function MUST be called
+  // on the thread which owns |context|.
+  void RunNotifications(const scoped_refptr<ObserverListContext>& context) {
+    TaskQueue notifications;
+    context->notifications.PopAll(&notifications);
+    const size_t num_notifications = notifications.size();
+    while (!notifications.empty()) {
+      notifications.front().task.Run();
+      notifications.pop();
+    }
+
+    // Notifications pushed since the PopAll() above, including the ones pushed
+    // by the observers, didn't post a task since the count was nonzero. They
+    // may also not be visible to PopAll() yet (see LockFreeTaskQueue).
+    // Either way, run them from another task.
+    if (context->num_pending_notifications.fetch_sub(num_notifications) !=
+        num_notifications) {
+      PostNotifications(FROM_HERE, context);
+    }
   }
 
   // Wrapper which is called to fire the notifications for each thread's
@@ -218,19 +317,11 @@ class ObserverListThreadSafe
   void NotifyWrapper(
       ObserverListContext* context,
       const internal::UnboundMethod<ObserverType, Method, Params>& method) {
-    // Check that this list still needs notifications.
-    {
-      AutoLock lock(list_lock_);
-      typename ObserversListMap::iterator it =
-          observer_lists_.find(PlatformThread::CurrentId());
-
-      // The ObserverList could have been removed already.  In fact, it could
-      // have been removed and then re-added!  If the master list's loop
-      // does not match this one, then we do not need to finish this
-      // notification.
-      if (it == observer_lists_.end() || it->second != context)
-        return;
-    }
+    // The ObserverList could have been removed already.  In fact, it could
+    // have been removed and then re-added!  In either case, we do not need to
+    // finish this notification.
+    if (!context->is_registered)
+      return;
 
     {
       typename ObserverList<ObserverType>::Iterator it(&context->list);
@@ -239,30 +330,45 @@ class ObserverListThreadSafe
         method.Run(obs);
     }
 
-    // If there are no more observers on the list, we can now delete it.
-    if (context->list.size() == 0) {
-      {
-        AutoLock lock(list_lock_);
-        // Remove |list| if it's not already removed.
-        // This can happen if multiple observers got removed in a notification.
-        // See http://crbug.com/55725.
-        typename ObserversListMap::iterator it =
-            observer_lists_.find(PlatformThread::CurrentId());
-        if (it != observer_lists_.end() && it->second == context)
-          observer_lists_.erase(it);
-      }
-      delete context;
+    // If there are no more observers on the list, we can now remove it.
+    // Removing it here is needed when multiple observers got removed in a
+    // notification. See http://crbug.com/55725.
+    if (context->list.size() == 0 && context->is_registered) {
+      AutoLock lock(list_lock_);
+      context->is_registered = false;
+      observer_lists_.erase(PlatformThread::CurrentId());
+      PublishContexts();
     }
   }
 
+  // Makes Notify() see the contexts currently in |observer_lists_|. Waits for
+  // the Notify() calls that read the snapshot before the previous one.
+  void PublishContexts() {
+    list_lock_.AssertAcquired();
+    const size_t index = epoch_.BeginWrite();
+    std::vector<scoped_refptr<ObserverListContext>>& contexts =
+        contexts_[index];
+    contexts.clear();
+    for (const auto& entry : observer_lists_)
+      contexts.push_back(entry.second);
+    epoch_.EndWrite(index);
+  }
+
   // Key by PlatformThreadId because in tests, clients can attempt to remove
   // observers without a MessageLoop. If this were keyed by MessageLoop, that
   // operation would be silently ignored, leaving garbage in the ObserverList.
-  typedef std::map<PlatformThreadId, ObserverListContext*>
+  typedef std::map<PlatformThreadId, scoped_refptr<ObserverListContext>>
       ObserversListMap;
 
-  mutable Lock list_lock_;  // Protects the observer_lists_.
+  // Protects the observer_lists_ and serializes updates of |contexts_|.
+  mutable Lock list_lock_;
   ObserversListMap observer_lists_;
+
+  // Snapshots of the contexts in |observer_lists_|, read by Notify(). Indexed
+  // by |epoch_|.
+  std::vector<scoped_refptr<ObserverListContext>> contexts_[2];
+  internal::SnapshotEpoch epoch_;
+
   const NotificationType type_;
 
   DISALLOW_COPY_AND_ASSIGN(ObserverListThreadSafe);
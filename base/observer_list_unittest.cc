@@ -5,14 +5,18 @@
 #include "base/observer_list.h"
 #include "base/observer_list_threadsafe.h"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/location.h"
+#include "base/memory/ptr_util.h"
 #include "base/memory/weak_ptr.h"
 #include "base/run_loop.h"
 #include "base/single_thread_task_runner.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -474,6 +478,154 @@ TEST(ObserverListThreadSafeTest, Existing) {
   EXPECT_EQ(1, b.adder.total);
 }
 
+class Recorder : public Foo {
+ public:
+  explicit Recorder(std::vector<int>* values) : values_(values) {}
+  ~Recorder() override {}
+  void Observe(int x) override { values_->push_back(x); }
+
+ private:
+  std::vector<int>* values_;
+};
+
+void RecordValue(std::vector<int>* values, int x) {
+  values->push_back(x);
+}
+
+// Notifications to a thread are run by a single task, in the order in which
+// they were sent.
+TEST(ObserverListThreadSafeTest, BatchedNotifications) {
+  MessageLoop loop;
+  scoped_refptr<ObserverListThreadSafe<Foo>> observer_list(
+      new ObserverListThreadSafe<Foo>);
+  std::vector<int> values;
+  Recorder a(&values);
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  loop.task_runner()->PostTask(FROM_HERE, Bind(&RecordValue, &values, -1));
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 2);
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 3);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(std::vector<int>({1, 2, 3, -1}), values);
+}
+
+class NotifyInObserve : public Foo {
+ public:
+  explicit NotifyInObserve(ObserverListThreadSafe<Foo>* observer_list)
+      : observer_list_(observer_list) {}
+  ~NotifyInObserve() override {}
+
+  void Observe(int x) override {
+    values.push_back(x);
+    if (x > 0)
+      observer_list_->Notify(FROM_HERE, &Foo::Observe, x - 1);
+  }
+
+  std::vector<int> values;
+
+ private:
+  ObserverListThreadSafe<Foo>* observer_list_;
+};
+
+TEST(ObserverListThreadSafeTest, NotifyInObserve) {
+  MessageLoop loop;
+  scoped_refptr<ObserverListThreadSafe<Foo>> observer_list(
+      new ObserverListThreadSafe<Foo>);
+  NotifyInObserve a(observer_list.get());
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 3);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(std::vector<int>({3, 2, 1, 0}), a.values);
+}
+
+// Notifications queued for a thread are dropped once its last observer is
+// removed, even if an observer is added again before they would run.
+TEST(ObserverListThreadSafeTest, RemoveAndAddWithQueuedNotifications) {
+  MessageLoop loop;
+  scoped_refptr<ObserverListThreadSafe<Foo>> observer_list(
+      new ObserverListThreadSafe<Foo>);
+  Adder a(1);
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 10);
+  observer_list->RemoveObserver(&a);
+  observer_list->AddObserver(&a);
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(1, a.total);
+}
+
+// Each version of the data read by the readers of a SnapshotEpoch holds two
+// equal values, unless a writer modifies a version while it is read.
+class SnapshotEpochReader : public DelegateSimpleThread::Delegate {
+ public:
+  SnapshotEpochReader(internal::SnapshotEpoch* epoch,
+                      const std::atomic<int> (*versions)[2],
+                      const std::atomic<bool>* done)
+      : epoch_(epoch), versions_(versions), done_(done) {}
+
+  void Run() override {
+    while (!done_->load()) {
+      const size_t index = epoch_->BeginRead();
+      const int first = versions_[index][0].load(std::memory_order_relaxed);
+      PlatformThread::YieldCurrentThread();
+      const int second = versions_[index][1].load(std::memory_order_relaxed);
+      epoch_->EndRead(index);
+      if (first != second)
+        ++num_inconsistent_reads;
+    }
+  }
+
+  int num_inconsistent_reads = 0;
+
+ private:
+  internal::SnapshotEpoch* const epoch_;
+  const std::atomic<int> (*const versions_)[2];
+  const std::atomic<bool>* const done_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotEpochReader);
+};
+
+TEST(ObserverListThreadSafeTest, SnapshotEpochReadersDontSeeWrites) {
+  internal::SnapshotEpoch epoch;
+  std::atomic<int> versions[2][2];
+  for (auto& version : versions) {
+    version[0].store(0);
+    version[1].store(0);
+  }
+  std::atomic<bool> done(false);
+
+  const int kNumReaders = 4;
+  std::vector<std::unique_ptr<SnapshotEpochReader>> readers;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < kNumReaders; ++i) {
+    readers.push_back(
+        WrapUnique(new SnapshotEpochReader(&epoch, versions, &done)));
+    threads.push_back(WrapUnique(
+        new DelegateSimpleThread(readers.back().get(), "SnapshotEpochReader")));
+    threads.back()->Start();
+  }
+
+  for (int value = 1; value <= 10000; ++value) {
+    const size_t index = epoch.BeginWrite();
+    versions[index][0].store(value, std::memory_order_relaxed);
+    PlatformThread::YieldCurrentThread();
+    versions[index][1].store(value, std::memory_order_relaxed);
+    epoch.EndWrite(index);
+  }
+  done.store(true);
+
+  for (int i = 0; i < kNumReaders; ++i) {
+    threads[i]->Join();
+    EXPECT_EQ(0, readers[i]->num_inconsistent_reads);
+  }
+}
+
 class AddInClearObserve : public Foo {
  public:
   explicit AddInClearObserve(ObserverList<Foo>* list)
@@ -8,6 +8,7 @@
 
 #include <algorithm>  // for max()
 #include <limits>
+#include <utility>
 
 #include "base/bits.h"
 #include "base/macros.h"
@@ -21,10 +22,41 @@ const int Pickle::kPayloadUnit = 64;
 
 static const size_t kCapacityReadOnly = static_cast<size_t>(-1);
 
+// Padding of external data, which isn't written to the pickle's buffer.
+static const char kExternalDataPadding[sizeof(uint32_t)] = {0};
+
 PickleIterator::PickleIterator(const Pickle& pickle)
     : payload_(pickle.payload()),
       read_index_(0),
-      end_index_(pickle.payload_size()) {
+      end_index_(pickle.payload_size()),
+      pickle_(NULL),
+      piece_(0) {
+  if (pickle.has_external_data()) {
+    pickle_ = &pickle;
+    end_index_ = pickle.external_segments_[0].offset;
+  }
+}
+
+void PickleIterator::MoveToNextPiece() {
+  const std::vector<Pickle::ExternalSegment>& segments =
+      pickle_->external_segments_;
+  ++piece_;
+  if (piece_ > 2 * segments.size()) {
+    pickle_ = NULL;
+    return;
+  }
+  const Pickle::ExternalSegment& segment = segments[(piece_ - 1) / 2];
+  if (piece_ % 2) {
+    payload_ = segment.data->front_as<char>();
+    read_index_ = 0;
+    end_index_ = segment.data->size();
+    return;
+  }
+  payload_ = pickle_->payload();
+  read_index_ = segment.offset;
+  end_index_ = piece_ / 2 < segments.size()
+                   ? segments[piece_ / 2].offset
+                   : pickle_->payload_size() - pickle_->external_size_;
 }
 
 template <typename Type>
@@ -50,8 +82,9 @@ inline void PickleIterator::Advance(size_t size) {
 
 template<typename Type>
 inline const char* PickleIterator::GetReadPointerAndAdvance() {
+  MaybeMoveToNextPiece();
   if (sizeof(Type) > end_index_ - read_index_) {
-    read_index_ = end_index_;
+    Fail();
     return NULL;
   }
   const char* current_read_ptr = payload_ + read_index_;
@@ -60,9 +93,10 @@ inline const char* PickleIterator::GetReadPointerAndAdvance() {
 }
 
 const char* PickleIterator::GetReadPointerAndAdvance(int num_bytes) {
+  MaybeMoveToNextPiece();
   if (num_bytes < 0 ||
       end_index_ - read_index_ < static_cast<size_t>(num_bytes)) {
-    read_index_ = end_index_;
+    Fail();
     return NULL;
   }
   const char* current_read_ptr = payload_ + read_index_;
@@ -256,7 +290,8 @@ Pickle::Pickle()
     : header_(NULL),
       header_size_(sizeof(Header)),
       capacity_after_header_(0),
-      write_offset_(0) {
+      write_offset_(0),
+      external_size_(0) {
   static_assert((Pickle::kPayloadUnit & (Pickle::kPayloadUnit - 1)) == 0,
                 "Pickle::kPayloadUnit must be a power of two");
   Resize(kPayloadUnit);
@@ -267,7 +302,8 @@ Pickle::Pickle(int header_size)
     : header_(NULL),
       header_size_(bits::Align(header_size, sizeof(uint32_t))),
       capacity_after_header_(0),
-      write_offset_(0) {
+      write_offset_(0),
+      external_size_(0) {
   DCHECK_GE(static_cast<size_t>(header_size), sizeof(Header));
   DCHECK_LE(header_size, kPayloadUnit);
   Resize(kPayloadUnit);
@@ -278,7 +314,8 @@ Pickle::Pickle(const char* data, int data_len)
     : header_(reinterpret_cast<Header*>(const_cast<char*>(data))),
       header_size_(0),
       capacity_after_header_(kCapacityReadOnly),
-      write_offset_(0) {
+      write_offset_(0),
+      external_size_(0) {
   if (data_len >= static_cast<int>(sizeof(Header)))
     header_size_ = data_len - header_->payload_size;
 
@@ -297,9 +334,13 @@ Pickle::Pickle(const Pickle& other)
     : header_(NULL),
       header_size_(other.header_size_),
       capacity_after_header_(0),
-      write_offset_(other.write_offset_) {
-  Resize(other.header_->payload_size);
-  memcpy(header_, other.header_, header_size_ + other.header_->payload_size);
+      write_offset_(other.write_offset_),
+      external_segments_(other.external_segments_),
+      external_size_(other.external_size_) {
+  const size_t inline_payload_size =
+      other.header_->payload_size - other.external_size_;
+  Resize(inline_payload_size);
+  memcpy(header_, other.header_, header_size_ + inline_payload_size);
 }
 
 Pickle::~Pickle() {
@@ -321,10 +362,13 @@ Pickle& Pickle::operator=(const Pickle& other) {
     header_ = NULL;
     header_size_ = other.header_size_;
   }
-  Resize(other.header_->payload_size);
-  memcpy(header_, other.header_,
-         other.header_size_ + other.header_->payload_size);
+  const size_t inline_payload_size =
+      other.header_->payload_size - other.external_size_;
+  Resize(inline_payload_size);
+  memcpy(header_, other.header_, other.header_size_ + inline_payload_size);
   write_offset_ = other.write_offset_;
+  external_segments_ = other.external_segments_;
+  external_size_ = other.external_size_;
   return *this;
 }
 
@@ -352,6 +396,71 @@ bool Pickle::WriteBytes(const void* data, int length) {
   return true;
 }
 
+bool Pickle::WriteExternalData(scoped_refptr<RefCountedMemory> data) {
+  DCHECK(data);
+  const size_t length = data->size();
+  if (length > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+      !WriteInt(static_cast<int>(length))) {
+    return false;
+  }
+  if (!length)
+    return true;
+  const size_t aligned_length = bits::Align(length, sizeof(uint32_t));
+  DCHECK_LE(aligned_length, std::numeric_limits<uint32_t>::max() -
+                                header_->payload_size);
+  ExternalSegment segment = {write_offset_, std::move(data)};
+  external_segments_.push_back(std::move(segment));
+  external_size_ += aligned_length;
+  header_->payload_size = static_cast<uint32_t>(write_offset_ + external_size_);
+  return true;
+}
+
+void Pickle::GetPieces(std::vector<StringPiece>* pieces) const {
+  const char* buffer = reinterpret_cast<const char*>(header_);
+  size_t start = 0;
+  for (const ExternalSegment& segment : external_segments_) {
+    const size_t end = header_size_ + segment.offset;
+    pieces->push_back(StringPiece(buffer + start, end - start));
+    const size_t length = segment.data->size();
+    pieces->push_back(StringPiece(segment.data->front_as<char>(), length));
+    const size_t padding = bits::Align(length, sizeof(uint32_t)) - length;
+    if (padding)
+      pieces->push_back(StringPiece(kExternalDataPadding, padding));
+    start = end;
+  }
+  pieces->push_back(
+      StringPiece(buffer + start, size() - external_size_ - start));
+}
+
+void Pickle::FlattenExternalData() {
+  if (external_segments_.empty())
+    return;
+  std::vector<ExternalSegment> segments;
+  segments.swap(external_segments_);
+
+  // Moves the inline pieces into place from the last one, copying the
+  // padded external data in front of each.
+  size_t src_end = write_offset_;
+  size_t dest_end = write_offset_ + external_size_;
+  if (dest_end > capacity_after_header_)
+    Resize(dest_end);
+  char* payload = mutable_payload();
+  for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+    const size_t inline_size = src_end - it->offset;
+    dest_end -= inline_size;
+    memmove(payload + dest_end, payload + it->offset, inline_size);
+    const size_t length = it->data->size();
+    const size_t aligned_length = bits::Align(length, sizeof(uint32_t));
+    dest_end -= aligned_length;
+    memcpy(payload + dest_end, it->data->front(), length);
+    memset(payload + dest_end + length, 0, aligned_length - length);
+    src_end = it->offset;
+  }
+  DCHECK_EQ(src_end, dest_end);
+  write_offset_ += external_size_;
+  external_size_ = 0;
+}
+
 void Pickle::Reserve(size_t length) {
   size_t data_len = bits::Align(length, sizeof(uint32_t));
   DCHECK_GE(data_len, length);
@@ -467,7 +576,7 @@ inline void* Pickle::ClaimUninitializedBytesInternal(size_t length) {
 
   char* write = mutable_payload() + write_offset_;
   memset(write + length, 0, data_len - length);  // Always initialize padding
-  header_->payload_size = static_cast<uint32_t>(new_size);
+  header_->payload_size = static_cast<uint32_t>(new_size + external_size_);
   write_offset_ = new_size;
   return write;
 }
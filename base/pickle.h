@@ -9,12 +9,14 @@
 #include <stdint.h>
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
 
@@ -30,7 +32,12 @@ class Pickle;
 // while the PickleIterator object is in use.
 class BASE_EXPORT PickleIterator {
  public:
-  PickleIterator() : payload_(NULL), read_index_(0), end_index_(0) {}
+  PickleIterator()
+      : payload_(NULL),
+        read_index_(0),
+        end_index_(0),
+        pickle_(NULL),
+        piece_(0) {}
   explicit PickleIterator(const Pickle& pickle);
 
   // Methods for reading the payload of the Pickle. To read from the start of
@@ -101,9 +108,28 @@ class BASE_EXPORT PickleIterator {
   const char* GetReadPointerAndAdvance(int num_elements,
                                        size_t size_element);
 
-  const char* payload_;  // Start of our pickle's payload.
+  // Moves to the next piece of a pickle with external data once the current
+  // one has been read entirely. Reads never straddle two pieces.
+  void MaybeMoveToNextPiece() {
+    if (read_index_ == end_index_ && pickle_)
+      MoveToNextPiece();
+  }
+  void MoveToNextPiece();
+
+  // Marks the iterator as having failed: nothing can be read after that.
+  void Fail() {
+    read_index_ = end_index_;
+    pickle_ = NULL;
+  }
+
+  const char* payload_;  // Start of the piece being read.
   size_t read_index_;  // Offset of the next readable byte in payload.
-  size_t end_index_;  // Payload size.
+  size_t end_index_;  // Piece size.
+
+  // The pickle being read, if it has external data, and the index of the
+  // piece being read. Even pieces are inline payload, odd ones external data.
+  const Pickle* pickle_;
+  size_t piece_;
 
   FRIEND_TEST_ALL_PREFIXES(PickleTest, GetReadPointerAndAdvance);
 };
@@ -192,7 +218,8 @@ class BASE_EXPORT Pickle {
   // padding size is deduced from the data length.
   Pickle(const char* data, int data_len);
 
-  // Initializes a Pickle as a deep copy of another Pickle.
+  // Initializes a Pickle as a deep copy of another Pickle. External data is
+  // shared, not copied.
   Pickle(const Pickle& other);
 
   // Note: There are no virtual methods in this class.  This destructor is
@@ -208,8 +235,12 @@ class BASE_EXPORT Pickle {
   // Returns the number of bytes written in the Pickle, including the header.
   size_t size() const { return header_size_ + header_->payload_size; }
 
-  // Returns the data for this Pickle.
-  const void* data() const { return header_; }
+  // Returns the data for this Pickle. Pickles with external data aren't
+  // contiguous: use GetPieces() or FlattenExternalData() first.
+  const void* data() const {
+    DCHECK(external_segments_.empty());
+    return header_;
+  }
 
   // Returns the effective memory capacity of this Pickle, that is, the total
   // number of bytes currently dynamically allocated or 0 in the case of a
@@ -252,6 +283,25 @@ class BASE_EXPORT Pickle {
   // when reading and writing. It is normally used to serialize PoD types of a
   // known size. See also WriteData.
   bool WriteBytes(const void* data, int length);
+  // Like WriteData(), but references |data| instead of copying it into the
+  // pickle's buffer, which avoids copying large blobs. |data| must not change
+  // until the pickle is destroyed. It is read back with ReadData() and
+  // serializes exactly like WriteData() would, once flattened or sent as
+  // pieces.
+  bool WriteExternalData(scoped_refptr<RefCountedMemory> data);
+
+  // Whether WriteExternalData() was used, in which case the pickle is made of
+  // several pieces rather than the single buffer returned by data().
+  bool has_external_data() const { return !external_segments_.empty(); }
+
+  // Appends the pieces of the pickle to |pieces|, in order and header
+  // included. Their concatenation is the flattened pickle, so that they can be
+  // written with a single gathering write such as sendmsg().
+  void GetPieces(std::vector<StringPiece>* pieces) const;
+
+  // Copies the external data into the pickle's buffer, after which data()
+  // holds the whole pickle.
+  void FlattenExternalData();
 
   // WriteAttachment appends |attachment| to the pickle. It returns
   // false iff the set is full or if the Pickle implementation does not support
@@ -350,14 +400,25 @@ class BASE_EXPORT Pickle {
  private:
   friend class PickleIterator;
 
+  // Data written with WriteExternalData(). It goes, padded, before the inline
+  // payload at |offset|, which therefore stays aligned.
+  struct ExternalSegment {
+    size_t offset;
+    scoped_refptr<RefCountedMemory> data;
+  };
+
   Header* header_;
   size_t header_size_;  // Supports extra data between header and payload.
   // Allocation size of payload (or -1 if allocation is const). Note: this
   // doesn't count the header.
   size_t capacity_after_header_;
   // The offset at which we will write the next field. Note: this doesn't count
-  // the header.
+  // the header, nor external data.
   size_t write_offset_;
+  std::vector<ExternalSegment> external_segments_;
+  // The number of bytes of padded external data, which
+  // header_->payload_size counts.
+  size_t external_size_;
 
   // Just like WriteBytes, but with a compile-time size, for performance.
   template<size_t length> void BASE_EXPORT WriteBytesStatic(const void* data);
@@ -0,0 +1,98 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/pickle.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumRounds = 10000;
+
+// Number of fields of each message, about the size of an IPC message with a
+// few structs.
+const int kNumFields = 100;
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 TimeDelta elapsed) {
+  perf_test::PrintResult(
+      measurement, "", trace,
+      elapsed.InMillisecondsF() * 1000000 / (kNumRounds * kNumFields),
+      "ns/field", true);
+}
+
+}  // namespace
+
+TEST(PicklePerfTest, Ints) {
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    Pickle pickle;
+    for (int i = 0; i < kNumFields; ++i)
+      pickle.WriteInt(i);
+    ASSERT_EQ(kNumFields * sizeof(int), pickle.payload_size());
+  }
+  PrintResult("write", "int", TimeTicks::Now() - start);
+
+  Pickle pickle;
+  for (int i = 0; i < kNumFields; ++i)
+    pickle.WriteInt(i);
+  int64_t sum = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    PickleIterator iter(pickle);
+    for (int i = 0; i < kNumFields; ++i) {
+      int value;
+      ASSERT_TRUE(iter.ReadInt(&value));
+      sum += value;
+    }
+  }
+  PrintResult("read", "int", TimeTicks::Now() - start);
+  EXPECT_EQ(static_cast<int64_t>(kNumRounds) * kNumFields * (kNumFields - 1) /
+                2,
+            sum);
+}
+
+TEST(PicklePerfTest, Strings) {
+  const std::string string = "https://www.example.com/path?query";
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    Pickle pickle;
+    for (int i = 0; i < kNumFields; ++i)
+      pickle.WriteString(string);
+  }
+  PrintResult("write", "string", TimeTicks::Now() - start);
+
+  Pickle pickle;
+  for (int i = 0; i < kNumFields; ++i)
+    pickle.WriteString(string);
+  std::string value;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    PickleIterator iter(pickle);
+    for (int i = 0; i < kNumFields; ++i)
+      ASSERT_TRUE(iter.ReadString(&value));
+  }
+  PrintResult("read", "string", TimeTicks::Now() - start);
+  EXPECT_EQ(string, value);
+
+  StringPiece piece;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    PickleIterator iter(pickle);
+    for (int i = 0; i < kNumFields; ++i)
+      ASSERT_TRUE(iter.ReadStringPiece(&piece));
+  }
+  PrintResult("read", "string_piece", TimeTicks::Now() - start);
+  EXPECT_EQ(string, piece);
+}
+
+}  // namespace base
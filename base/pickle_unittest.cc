@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/strings/string16.h"
@@ -570,6 +571,113 @@ TEST(PickleTest, ClaimBytes) {
   EXPECT_EQ(42, out_value);
 }
 
+namespace {
+
+scoped_refptr<RefCountedMemory> MakeExternalData(const std::string& data) {
+  std::string copy(data);
+  return RefCountedString::TakeString(&copy);
+}
+
+std::string JoinPieces(const Pickle& pickle) {
+  std::vector<StringPiece> pieces;
+  pickle.GetPieces(&pieces);
+  std::string joined;
+  for (const StringPiece& piece : pieces)
+    piece.AppendToString(&joined);
+  return joined;
+}
+
+}  // namespace
+
+// Tests that external data reads back like WriteData() and serializes to the
+// same bytes.
+TEST(PickleTest, ExternalData) {
+  const std::string external1(1000, 'x');
+  const std::string external2("odd");
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  EXPECT_TRUE(pickle.WriteExternalData(MakeExternalData(external1)));
+  EXPECT_TRUE(pickle.WriteExternalData(MakeExternalData(external2)));
+  EXPECT_TRUE(pickle.WriteString(teststring));
+  EXPECT_TRUE(pickle.has_external_data());
+  // The external data isn't in the pickle's buffer.
+  EXPECT_LT(pickle.GetTotalAllocatedSize(), external1.size());
+
+  Pickle expected;
+  EXPECT_TRUE(expected.WriteInt(testint));
+  EXPECT_TRUE(expected.WriteData(external1.data(), external1.size()));
+  EXPECT_TRUE(expected.WriteData(external2.data(), external2.size()));
+  EXPECT_TRUE(expected.WriteString(teststring));
+  EXPECT_EQ(expected.size(), pickle.size());
+  EXPECT_EQ(std::string(static_cast<const char*>(expected.data()),
+                        expected.size()),
+            JoinPieces(pickle));
+
+  PickleIterator iter(pickle);
+  int outint;
+  const char* data;
+  int length;
+  std::string outstring;
+  EXPECT_TRUE(iter.ReadInt(&outint));
+  EXPECT_EQ(testint, outint);
+  EXPECT_TRUE(iter.ReadData(&data, &length));
+  EXPECT_EQ(external1, std::string(data, length));
+  EXPECT_TRUE(iter.ReadData(&data, &length));
+  EXPECT_EQ(external2, std::string(data, length));
+  EXPECT_TRUE(iter.ReadString(&outstring));
+  EXPECT_EQ(teststring, outstring);
+  EXPECT_FALSE(iter.ReadInt(&outint));
+
+  // Copies share the external data.
+  Pickle copy(pickle);
+  EXPECT_EQ(JoinPieces(pickle), JoinPieces(copy));
+
+  pickle.FlattenExternalData();
+  EXPECT_FALSE(pickle.has_external_data());
+  EXPECT_EQ(expected.size(), pickle.size());
+  EXPECT_EQ(0, memcmp(expected.data(), pickle.data(), pickle.size()));
+
+  // Writes after flattening go after the flattened data.
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  PickleIterator flat_iter(pickle);
+  EXPECT_TRUE(flat_iter.ReadInt(&outint));
+  EXPECT_TRUE(flat_iter.ReadData(&data, &length));
+  EXPECT_TRUE(flat_iter.ReadData(&data, &length));
+  EXPECT_TRUE(flat_iter.ReadString(&outstring));
+  EXPECT_TRUE(flat_iter.ReadInt(&outint));
+  EXPECT_EQ(testint, outint);
+}
+
+// Tests that reads can't straddle the inline payload and external data, and
+// that nothing can be read after such a failure.
+TEST(PickleTest, ExternalDataStraddlingRead) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteExternalData(MakeExternalData("abcdefgh")));
+  EXPECT_TRUE(pickle.WriteInt(testint));
+
+  PickleIterator iter(pickle);
+  int length;
+  const char* data;
+  EXPECT_TRUE(iter.ReadInt(&length));
+  EXPECT_EQ(8, length);
+  EXPECT_FALSE(iter.ReadBytes(&data, 12));
+  int outint;
+  EXPECT_FALSE(iter.ReadInt(&outint));
+}
+
+// Tests that empty external data is written inline.
+TEST(PickleTest, EmptyExternalData) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteExternalData(MakeExternalData(std::string())));
+  EXPECT_FALSE(pickle.has_external_data());
+
+  PickleIterator iter(pickle);
+  const char* data;
+  int length;
+  EXPECT_TRUE(iter.ReadData(&data, &length));
+  EXPECT_EQ(0, length);
+}
+
 // Checks that PickleSizer and Pickle agree on the size of things.
 TEST(PickleTest, PickleSizer) {
   {
@@ -14,6 +14,13 @@ bool SequencedTaskRunner::PostNonNestableTask(
   return PostNonNestableDelayedTask(from_here, task, base::TimeDelta());
 }
 
+bool SequencedTaskRunner::PostCoalescedTask(
+    const tracked_objects::Location& from_here,
+    const void* coalescing_token,
+    const Closure& task) {
+  return PostTask(from_here, task);
+}
+
 bool SequencedTaskRunner::DeleteSoonInternal(
     const tracked_objects::Location& from_here,
     void(*deleter)(const void*),
@@ -116,6 +116,19 @@ class BASE_EXPORT SequencedTaskRunner : public TaskRunner {
       const Closure& task,
       base::TimeDelta delay) = 0;
 
+  // Posts |task| unless a task posted with the same |coalescing_token| through
+  // this method is pending, i.e. hasn't started running yet. This avoids
+  // redundant work when a "flush" or "recompute" task is posted many times
+  // before it runs. Tasks posted with the same token must therefore be
+  // interchangeable. Returns true if |task| or the pending task with the same
+  // token may be run at some point in the future, and false if |task|
+  // definitely will not be run.
+  //
+  // The default implementation doesn't coalesce tasks: it calls PostTask().
+  virtual bool PostCoalescedTask(const tracked_objects::Location& from_here,
+                                 const void* coalescing_token,
+                                 const Closure& task);
+
   // Submits a non-nestable task to delete the given object.  Returns
   // true if the object may be deleted at some point in the future,
   // and false if the object definitely will not be deleted.
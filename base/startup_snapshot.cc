@@ -0,0 +1,313 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/startup_snapshot.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+
+namespace base {
+
+namespace {
+
+// "SSNP", followed by the format version.
+const uint32_t kMagic = 0x534e5053;
+const uint32_t kVersion = 1;
+
+// A string of the string area, which follows the records.
+struct StringRef {
+  uint32_t offset;  // From the start of the snapshot.
+  uint32_t length;
+};
+
+struct FieldTrialRecord {
+  StringRef trial_name;
+  StringRef group_name;
+  uint32_t activated;
+};
+
+struct FeatureOverrideRecord {
+  StringRef feature_name;
+  StringRef trial_name;
+  uint32_t state;
+};
+
+// The snapshot starts with the header, followed by |field_trial_count| field
+// trial records, |feature_override_count| feature override records and the
+// strings they refer to.
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t field_trial_count;
+  uint32_t feature_override_count;
+};
+
+const Header* GetHeader(const uint8_t* data) {
+  return reinterpret_cast<const Header*>(data);
+}
+
+const FieldTrialRecord* GetFieldTrialRecords(const uint8_t* data) {
+  return reinterpret_cast<const FieldTrialRecord*>(data + sizeof(Header));
+}
+
+const FeatureOverrideRecord* GetFeatureOverrideRecords(const uint8_t* data) {
+  return reinterpret_cast<const FeatureOverrideRecord*>(
+      GetFieldTrialRecords(data) + GetHeader(data)->field_trial_count);
+}
+
+StringPiece GetString(const uint8_t* data, const StringRef& ref) {
+  return StringPiece(reinterpret_cast<const char*>(data) + ref.offset,
+                     ref.length);
+}
+
+bool IsValidString(const StringRef& ref, size_t strings_offset, size_t size) {
+  return ref.offset >= strings_offset && ref.offset <= size &&
+         ref.length <= size - ref.offset;
+}
+
+// Returns true if |data| holds a snapshot of this version whose strings are
+// all in bounds and whose feature overrides are sorted, which lookups rely
+// on.
+bool IsValidSnapshot(const uint8_t* data, size_t size) {
+  if (size < sizeof(Header))
+    return false;
+  const Header* header = GetHeader(data);
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->size != size) {
+    return false;
+  }
+
+  CheckedNumeric<size_t> strings_offset = header->field_trial_count;
+  strings_offset *= sizeof(FieldTrialRecord);
+  strings_offset += CheckedNumeric<size_t>(header->feature_override_count) *
+                    sizeof(FeatureOverrideRecord);
+  strings_offset += sizeof(Header);
+  if (!strings_offset.IsValid() || strings_offset.ValueOrDie() > size)
+    return false;
+
+  const FieldTrialRecord* trials = GetFieldTrialRecords(data);
+  for (size_t i = 0; i < header->field_trial_count; ++i) {
+    if (!IsValidString(trials[i].trial_name, strings_offset.ValueOrDie(),
+                       size) ||
+        !IsValidString(trials[i].group_name, strings_offset.ValueOrDie(),
+                       size)) {
+      return false;
+    }
+  }
+
+  const FeatureOverrideRecord* overrides = GetFeatureOverrideRecords(data);
+  for (size_t i = 0; i < header->feature_override_count; ++i) {
+    if (!IsValidString(overrides[i].feature_name, strings_offset.ValueOrDie(),
+                       size) ||
+        !IsValidString(overrides[i].trial_name, strings_offset.ValueOrDie(),
+                       size) ||
+        overrides[i].state > FeatureList::OVERRIDE_ENABLE_FEATURE) {
+      return false;
+    }
+    if (i && GetString(data, overrides[i - 1].feature_name) >=
+                 GetString(data, overrides[i].feature_name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Appends |string| to |strings|, which start |strings_offset| bytes into the
+// snapshot.
+StringRef AppendString(StringPiece string,
+                       size_t strings_offset,
+                       std::string* strings) {
+  StringRef ref = {static_cast<uint32_t>(strings_offset + strings->size()),
+                   static_cast<uint32_t>(string.size())};
+  string.AppendToString(strings);
+  return ref;
+}
+
+typedef std::map<std::string,
+                 std::pair<FeatureList::OverrideState, std::string>>
+    OverrideMap;
+
+// Adds the overrides in the comma-separated |feature_list| to |overrides|,
+// like FeatureList::RegisterOverridesFromCommandLine() does.
+void AddOverrides(const std::string& feature_list,
+                  FeatureList::OverrideState overridden_state,
+                  OverrideMap* overrides) {
+  for (const auto& value : FeatureList::SplitFeatureListString(feature_list)) {
+    StringPiece feature_name(value);
+    StringPiece trial_name;
+    std::string::size_type pos = feature_name.find('<');
+    if (pos != std::string::npos) {
+      trial_name = feature_name.substr(pos + 1);
+      feature_name = feature_name.substr(0, pos);
+    }
+    FeatureList::OverrideState state = overridden_state;
+    if (feature_name.starts_with("*")) {
+      feature_name = feature_name.substr(1);
+      state = FeatureList::OVERRIDE_USE_DEFAULT;
+    }
+    // Only the first override for a given feature takes effect.
+    overrides->insert(std::make_pair(
+        feature_name.as_string(),
+        std::make_pair(state, trial_name.as_string())));
+  }
+}
+
+}  // namespace
+
+StartupSnapshot::StartupSnapshot(const uint8_t* data) : data_(data) {}
+
+StartupSnapshot::~StartupSnapshot() {}
+
+// static
+std::string StartupSnapshot::Create(const std::string& field_trial_states,
+                                    const std::string& enable_features,
+                                    const std::string& disable_features) {
+  std::vector<FieldTrial::State> trials;
+  if (!FieldTrialList::GetStatesFromString(field_trial_states, &trials))
+    return std::string();
+
+  // Disabled features take precedence over enabled ones, as in FeatureList.
+  OverrideMap overrides;
+  AddOverrides(disable_features, FeatureList::OVERRIDE_DISABLE_FEATURE,
+               &overrides);
+  AddOverrides(enable_features, FeatureList::OVERRIDE_ENABLE_FEATURE,
+               &overrides);
+
+  const size_t strings_offset = sizeof(Header) +
+                                trials.size() * sizeof(FieldTrialRecord) +
+                                overrides.size() * sizeof(FeatureOverrideRecord);
+  std::string strings;
+  std::vector<FieldTrialRecord> trial_records;
+  trial_records.reserve(trials.size());
+  for (const FieldTrial::State& trial : trials) {
+    FieldTrialRecord record = {
+        AppendString(trial.trial_name, strings_offset, &strings),
+        AppendString(trial.group_name, strings_offset, &strings),
+        trial.activated};
+    trial_records.push_back(record);
+  }
+  // |overrides| is sorted by feature name, which lookups rely on.
+  std::vector<FeatureOverrideRecord> override_records;
+  override_records.reserve(overrides.size());
+  for (const auto& entry : overrides) {
+    FeatureOverrideRecord record = {
+        AppendString(entry.first, strings_offset, &strings),
+        AppendString(entry.second.second, strings_offset, &strings),
+        entry.second.first};
+    override_records.push_back(record);
+  }
+
+  Header header = {kMagic, kVersion,
+                   static_cast<uint32_t>(strings_offset + strings.size()),
+                   static_cast<uint32_t>(trial_records.size()),
+                   static_cast<uint32_t>(override_records.size())};
+  std::string snapshot;
+  snapshot.reserve(header.size);
+  snapshot.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!trial_records.empty()) {
+    snapshot.append(reinterpret_cast<const char*>(&trial_records[0]),
+                    trial_records.size() * sizeof(FieldTrialRecord));
+  }
+  if (!override_records.empty()) {
+    snapshot.append(reinterpret_cast<const char*>(&override_records[0]),
+                    override_records.size() * sizeof(FeatureOverrideRecord));
+  }
+  snapshot.append(strings);
+  DCHECK_EQ(header.size, snapshot.size());
+  return snapshot;
+}
+
+// static
+std::unique_ptr<StartupSnapshot> StartupSnapshot::FromMemory(const void* data,
+                                                             size_t size) {
+  DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(data) % sizeof(uint32_t));
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  if (!IsValidSnapshot(bytes, size))
+    return nullptr;
+  return std::unique_ptr<StartupSnapshot>(new StartupSnapshot(bytes));
+}
+
+// static
+std::unique_ptr<StartupSnapshot> StartupSnapshot::FromFile(File file) {
+  std::unique_ptr<MemoryMappedFile> mapped_file(new MemoryMappedFile);
+  if (!mapped_file->Initialize(std::move(file)) ||
+      !IsValidSnapshot(mapped_file->data(), mapped_file->length())) {
+    return nullptr;
+  }
+  std::unique_ptr<StartupSnapshot> snapshot(
+      new StartupSnapshot(mapped_file->data()));
+  snapshot->mapped_file_ = std::move(mapped_file);
+  return snapshot;
+}
+
+size_t StartupSnapshot::field_trial_count() const {
+  return GetHeader(data_)->field_trial_count;
+}
+
+FieldTrial::State StartupSnapshot::GetFieldTrial(size_t index) const {
+  DCHECK_LT(index, field_trial_count());
+  const FieldTrialRecord& record = GetFieldTrialRecords(data_)[index];
+  FieldTrial::State state;
+  state.trial_name = GetString(data_, record.trial_name);
+  state.group_name = GetString(data_, record.group_name);
+  state.activated = !!record.activated;
+  return state;
+}
+
+bool StartupSnapshot::CreateFieldTrials() const {
+  for (size_t i = 0; i < field_trial_count(); ++i) {
+    const FieldTrial::State state = GetFieldTrial(i);
+    FieldTrial* trial = FieldTrialList::CreateFieldTrial(
+        state.trial_name.as_string(), state.group_name.as_string());
+    if (!trial)
+      return false;
+    // Marks the trial as used, see FieldTrialList::CreateTrialsFromString().
+    if (state.activated)
+      trial->group();
+  }
+  return true;
+}
+
+size_t StartupSnapshot::feature_override_count() const {
+  return GetHeader(data_)->feature_override_count;
+}
+
+StartupSnapshot::FeatureOverride StartupSnapshot::GetFeatureOverride(
+    size_t index) const {
+  DCHECK_LT(index, feature_override_count());
+  const FeatureOverrideRecord& record = GetFeatureOverrideRecords(data_)[index];
+  FeatureOverride result;
+  result.feature_name = GetString(data_, record.feature_name);
+  result.state = static_cast<FeatureList::OverrideState>(record.state);
+  result.trial_name = GetString(data_, record.trial_name);
+  return result;
+}
+
+bool StartupSnapshot::FindFeatureOverride(StringPiece feature_name,
+                                          FeatureOverride* result) const {
+  const FeatureOverrideRecord* begin = GetFeatureOverrideRecords(data_);
+  const FeatureOverrideRecord* end = begin + feature_override_count();
+  const uint8_t* data = data_;
+  const FeatureOverrideRecord* it = std::lower_bound(
+      begin, end, feature_name,
+      [data](const FeatureOverrideRecord& record, StringPiece name) {
+        return GetString(data, record.feature_name) < name;
+      });
+  if (it == end || GetString(data_, it->feature_name) != feature_name)
+    return false;
+  *result = GetFeatureOverride(it - begin);
+  return true;
+}
+
+}  // namespace base
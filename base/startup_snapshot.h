@@ -0,0 +1,94 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STARTUP_SNAPSHOT_H_
+#define BASE_STARTUP_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/base_export.h"
+#include "base/feature_list.h"
+#include "base/macros.h"
+#include "base/metrics/field_trial.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+
+class File;
+class MemoryMappedFile;
+
+// A compact, read-only serialization of the state that child processes
+// otherwise rebuild from command-line strings at startup: the field trials
+// and the feature overrides.
+//
+// The browser creates it once with Create() and shares it, e.g. as a file or
+// read-only shared memory, and children map it. The snapshot is used in place
+// from the mapping: children create their field trials from it without
+// parsing, and FeatureList looks overrides up in it rather than copying them
+// into private memory (see FeatureList::InitializeFromStartupSnapshot()).
+//
+// The format is specific to the build that wrote it, and is validated when a
+// snapshot is opened.
+class BASE_EXPORT StartupSnapshot {
+ public:
+  struct FeatureOverride {
+    StringPiece feature_name;
+    FeatureList::OverrideState state;
+    // The field trial associated with the override, if any.
+    StringPiece trial_name;
+  };
+
+  ~StartupSnapshot();
+
+  // Returns the serialization of the field trials in |field_trial_states|, in
+  // the format of FieldTrialList::AllStatesToString(), and of the feature
+  // overrides in |enable_features| and |disable_features|, in the format of
+  // FeatureList::InitializeFromCommandLine(). Returns an empty string if
+  // |field_trial_states| is malformed.
+  static std::string Create(const std::string& field_trial_states,
+                            const std::string& enable_features,
+                            const std::string& disable_features);
+
+  // Returns the snapshot in |data|, which must remain valid and unchanged as
+  // long as the snapshot is used, or null if |data| isn't a valid snapshot.
+  static std::unique_ptr<StartupSnapshot> FromMemory(const void* data,
+                                                     size_t size);
+
+  // Maps |file| read-only and returns the snapshot it holds, or null if it
+  // can't be mapped or isn't a valid snapshot.
+  static std::unique_ptr<StartupSnapshot> FromFile(File file);
+
+  size_t field_trial_count() const;
+  FieldTrial::State GetFieldTrial(size_t index) const;
+
+  // Creates the field trials of the snapshot, like
+  // FieldTrialList::CreateTrialsFromString() does for the state string.
+  bool CreateFieldTrials() const;
+
+  // Feature overrides are sorted by feature name.
+  size_t feature_override_count() const;
+  FeatureOverride GetFeatureOverride(size_t index) const;
+
+  // Looks up the override for |feature_name|, in logarithmic time. Returns
+  // false if there is none.
+  bool FindFeatureOverride(StringPiece feature_name,
+                           FeatureOverride* result) const;
+
+ private:
+  explicit StartupSnapshot(const uint8_t* data);
+
+  const uint8_t* const data_;
+  // Set when the snapshot was mapped from a file.
+  std::unique_ptr<MemoryMappedFile> mapped_file_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupSnapshot);
+};
+
+}  // namespace base
+
+#endif  // BASE_STARTUP_SNAPSHOT_H_
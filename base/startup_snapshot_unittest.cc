@@ -0,0 +1,135 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/startup_snapshot.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const char kFieldTrialStates[] = "*Trial1/Group1/Trial2/Group2/";
+const char kEnableFeatures[] = "B<Trial1,A,*C";
+const char kDisableFeatures[] = "D,B";
+
+std::unique_ptr<StartupSnapshot> FromString(const std::string& data) {
+  return StartupSnapshot::FromMemory(data.data(), data.size());
+}
+
+void ExpectSnapshotContents(const StartupSnapshot& snapshot) {
+  ASSERT_EQ(2u, snapshot.field_trial_count());
+  FieldTrial::State trial = snapshot.GetFieldTrial(0);
+  EXPECT_EQ("Trial1", trial.trial_name);
+  EXPECT_EQ("Group1", trial.group_name);
+  EXPECT_TRUE(trial.activated);
+  trial = snapshot.GetFieldTrial(1);
+  EXPECT_EQ("Trial2", trial.trial_name);
+  EXPECT_EQ("Group2", trial.group_name);
+  EXPECT_FALSE(trial.activated);
+
+  // Sorted, with disabled features taking precedence.
+  ASSERT_EQ(4u, snapshot.feature_override_count());
+  StartupSnapshot::FeatureOverride entry = snapshot.GetFeatureOverride(0);
+  EXPECT_EQ("A", entry.feature_name);
+  EXPECT_EQ(FeatureList::OVERRIDE_ENABLE_FEATURE, entry.state);
+  EXPECT_TRUE(entry.trial_name.empty());
+  entry = snapshot.GetFeatureOverride(1);
+  EXPECT_EQ("B", entry.feature_name);
+  EXPECT_EQ(FeatureList::OVERRIDE_DISABLE_FEATURE, entry.state);
+  entry = snapshot.GetFeatureOverride(2);
+  EXPECT_EQ("C", entry.feature_name);
+  EXPECT_EQ(FeatureList::OVERRIDE_USE_DEFAULT, entry.state);
+  entry = snapshot.GetFeatureOverride(3);
+  EXPECT_EQ("D", entry.feature_name);
+  EXPECT_EQ(FeatureList::OVERRIDE_DISABLE_FEATURE, entry.state);
+}
+
+}  // namespace
+
+TEST(StartupSnapshotTest, FromMemory) {
+  const std::string data = StartupSnapshot::Create(
+      kFieldTrialStates, kEnableFeatures, kDisableFeatures);
+  std::unique_ptr<StartupSnapshot> snapshot = FromString(data);
+  ASSERT_TRUE(snapshot);
+  ExpectSnapshotContents(*snapshot);
+}
+
+TEST(StartupSnapshotTest, FromFile) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath path = temp_dir.path().AppendASCII("snapshot");
+  const std::string data = StartupSnapshot::Create(
+      kFieldTrialStates, kEnableFeatures, kDisableFeatures);
+  ASSERT_EQ(static_cast<int>(data.size()),
+            WriteFile(path, data.data(), data.size()));
+
+  std::unique_ptr<StartupSnapshot> snapshot = StartupSnapshot::FromFile(
+      File(path, File::FLAG_OPEN | File::FLAG_READ));
+  ASSERT_TRUE(snapshot);
+  ExpectSnapshotContents(*snapshot);
+}
+
+TEST(StartupSnapshotTest, FindFeatureOverride) {
+  const std::string data =
+      StartupSnapshot::Create("", "F5,F1,F3<T", "F2,F4");
+  std::unique_ptr<StartupSnapshot> snapshot = FromString(data);
+  ASSERT_TRUE(snapshot);
+
+  StartupSnapshot::FeatureOverride entry;
+  ASSERT_TRUE(snapshot->FindFeatureOverride("F3", &entry));
+  EXPECT_EQ("F3", entry.feature_name);
+  EXPECT_EQ(FeatureList::OVERRIDE_ENABLE_FEATURE, entry.state);
+  EXPECT_EQ("T", entry.trial_name);
+  ASSERT_TRUE(snapshot->FindFeatureOverride("F4", &entry));
+  EXPECT_EQ(FeatureList::OVERRIDE_DISABLE_FEATURE, entry.state);
+  ASSERT_TRUE(snapshot->FindFeatureOverride("F5", &entry));
+  EXPECT_FALSE(snapshot->FindFeatureOverride("F", &entry));
+  EXPECT_FALSE(snapshot->FindFeatureOverride("F0", &entry));
+  EXPECT_FALSE(snapshot->FindFeatureOverride("F6", &entry));
+}
+
+TEST(StartupSnapshotTest, MalformedFieldTrialStates) {
+  EXPECT_TRUE(StartupSnapshot::Create("Trial//", "", "").empty());
+}
+
+TEST(StartupSnapshotTest, InvalidData) {
+  const std::string data = StartupSnapshot::Create(
+      kFieldTrialStates, kEnableFeatures, kDisableFeatures);
+  ASSERT_TRUE(FromString(data));
+
+  // Truncated.
+  EXPECT_FALSE(FromString(data.substr(0, data.size() - 1)));
+  EXPECT_FALSE(FromString(data.substr(0, 8)));
+
+  // Wrong magic.
+  std::string corrupt = data;
+  corrupt[0] ^= 1;
+  EXPECT_FALSE(FromString(corrupt));
+
+  // A string reaching past the end. The first field trial record follows the
+  // 20-byte header and starts with its name's offset and length.
+  corrupt = data;
+  uint32_t length = 0xffff;
+  corrupt.replace(24, sizeof(length), reinterpret_cast<const char*>(&length),
+                  sizeof(length));
+  EXPECT_FALSE(FromString(corrupt));
+
+  // Unsorted feature overrides: swaps the names of the first two.
+  corrupt = data;
+  const size_t first_override = 20 + 2 * 20;
+  std::string first_name = corrupt.substr(first_override, 8);
+  corrupt.replace(first_override, 8, corrupt.substr(first_override + 20, 8));
+  corrupt.replace(first_override + 20, 8, first_name);
+  EXPECT_FALSE(FromString(corrupt));
+}
+
+}  // namespace base
@@ -0,0 +1,74 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumCalls = 1000000;
+
+void PrintResult(const std::string& trace, TimeDelta elapsed) {
+  perf_test::PrintResult("format", "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / kNumCalls,
+                         "ns/call", true);
+}
+
+}  // namespace
+
+TEST(StringPrintfPerfTest, Format) {
+  size_t total_size = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    total_size += StringPrintf("%d", i).size();
+  PrintResult("stringprintf_int", TimeTicks::Now() - start);
+
+  // The usual alternative for numbers.
+  size_t int_to_string_size = 0;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i)
+    int_to_string_size += IntToString(i).size();
+  PrintResult("int_to_string", TimeTicks::Now() - start);
+  EXPECT_EQ(total_size, int_to_string_size);
+
+  // A typical log or histogram name, with strings and numbers.
+  const std::string name = "Renderer";
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i) {
+    total_size +=
+        StringPrintf("%s.Memory.%s:%d", name.c_str(), "Total", i).size();
+  }
+  PrintResult("stringprintf_mixed", TimeTicks::Now() - start);
+
+  // Longer than the stack buffer StringAppendV() tries first.
+  const std::string long_string(2000, 'a');
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls / 10; ++i)
+    total_size += StringPrintf("%s%d", long_string.c_str(), i).size();
+  PrintResult("stringprintf_long", (TimeTicks::Now() - start) * 10);
+  EXPECT_GT(total_size, 0u);
+}
+
+TEST(StringPrintfPerfTest, Append) {
+  std::string result;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumCalls; ++i) {
+    if (result.size() > 4096)
+      result.clear();
+    StringAppendF(&result, "%d,", i);
+  }
+  PrintResult("stringappendf_int", TimeTicks::Now() - start);
+  EXPECT_FALSE(result.empty());
+}
+
+}  // namespace base
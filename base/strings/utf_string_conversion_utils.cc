@@ -5,9 +5,97 @@
 #include "base/strings/utf_string_conversion_utils.h"
 
 #include "base/third_party/icu/icu_utf.h"
+#include "build/build_config.h"
+
+// SSE2 is part of the baseline of all x86 builds, so it needs no runtime
+// check through base::CPU.
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#define UTF_SCAN_SSE2
+#elif defined(ARCH_CPU_ARM64) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define UTF_SCAN_NEON
+#endif
 
 namespace base {
 
+namespace {
+
+const size_t kBlockSize = 16;
+
+#if defined(UTF_SCAN_NEON)
+// Returns whether any byte of |mask| is set.
+inline bool AnyByteSet(uint8x16_t mask) {
+  uint8x8_t halves = vorr_u8(vget_low_u8(mask), vget_high_u8(mask));
+  return vget_lane_u64(vreinterpret_u64_u8(halves), 0) != 0;
+}
+#endif
+
+}  // namespace
+
+// CountLeadingASCII -----------------------------------------------------------
+
+size_t CountLeadingASCII(const char* src, size_t src_len) {
+  size_t i = 0;
+
+  // Skip the blocks that are all ASCII; the first one that isn't is searched
+  // below.
+#if defined(UTF_SCAN_SSE2)
+  for (; i + kBlockSize <= src_len; i += kBlockSize) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(chars))
+      break;
+  }
+#elif defined(UTF_SCAN_NEON)
+  const uint8x16_t ascii_end = vdupq_n_u8(0x80);
+  for (; i + kBlockSize <= src_len; i += kBlockSize) {
+    uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    if (AnyByteSet(vcgeq_u8(chars, ascii_end)))
+      break;
+  }
+#endif
+
+  while (i < src_len && static_cast<unsigned char>(src[i]) < 0x80)
+    ++i;
+  return i;
+}
+
+size_t CountLeadingASCII(const char16* src, size_t src_len) {
+  size_t i = 0;
+  const size_t block_chars = kBlockSize / sizeof(char16);
+
+#if defined(UTF_SCAN_SSE2)
+  const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + block_chars <= src_len; i += block_chars) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(chars, non_ascii_bits), zero);
+    if (_mm_movemask_epi8(ascii) != 0xFFFF)
+      break;
+  }
+#elif defined(UTF_SCAN_NEON)
+  const uint16x8_t ascii_end = vdupq_n_u16(0x80);
+  for (; i + block_chars <= src_len; i += block_chars) {
+    uint16x8_t chars = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    if (AnyByteSet(vreinterpretq_u8_u16(vcgeq_u16(chars, ascii_end))))
+      break;
+  }
+#endif
+
+  while (i < src_len && src[i] < 0x80)
+    ++i;
+  return i;
+}
+
+#if defined(WCHAR_T_IS_UTF32)
+size_t CountLeadingASCII(const wchar_t* src, size_t src_len) {
+  size_t i = 0;
+  while (i < src_len && static_cast<uint32_t>(src[i]) < 0x80)
+    ++i;
+  return i;
+}
+#endif  // defined(WCHAR_T_IS_UTF32)
+
 // ReadUnicodeCharacter --------------------------------------------------------
 
 bool ReadUnicodeCharacter(const char* src,
@@ -31,6 +31,18 @@ inline bool IsValidCharacter(uint32_t code_point) {
       code_point <= 0x10FFFFu && (code_point & 0xFFFEu) != 0xFFFEu);
 }
 
+// CountLeadingASCII -----------------------------------------------------------
+
+// Returns the number of leading ASCII characters of |src|, so that the
+// converters can copy runs of them at once. Looks at 16 bytes at a time with
+// SSE2 or NEON.
+BASE_EXPORT size_t CountLeadingASCII(const char* src, size_t src_len);
+BASE_EXPORT size_t CountLeadingASCII(const char16* src, size_t src_len);
+
+#if defined(WCHAR_T_IS_UTF32)
+BASE_EXPORT size_t CountLeadingASCII(const wchar_t* src, size_t src_len);
+#endif  // defined(WCHAR_T_IS_UTF32)
+
 // ReadUnicodeCharacter --------------------------------------------------------
 
 // Reads a UTF-8 stream, placing the next code point into the given output
@@ -6,6 +6,8 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversion_utils.h"
@@ -17,6 +19,26 @@ namespace {
 
 // Generalized Unicode converter -----------------------------------------------
 
+// Returns whether all the characters of |src| are ASCII. Unlike
+// IsStringASCII(), stops at the first one that isn't.
+template <typename SRC_CHAR>
+bool IsASCII(const SRC_CHAR* src, size_t src_len) {
+  return CountLeadingASCII(src, src_len) == src_len;
+}
+
+// Runs of ASCII characters at least this long are scanned and copied as a
+// whole. Shorter ones are cheaper to copy one by one.
+const size_t kMinBulkASCIIRun = 8;
+
+// Appends the |length| ASCII characters at |src| to |output|, which has
+// usually reserved room for them.
+template <typename SRC_CHAR, typename DEST_STRING>
+void AppendASCII(const SRC_CHAR* src, size_t length, DEST_STRING* output) {
+  const size_t old_size = output->size();
+  output->resize(old_size + length);
+  std::copy(src, src + length, &(*output)[old_size]);
+}
+
 // Converts the given source Unicode character type to the given destination
 // Unicode character type as a STL string. The given input buffer and size
 // determine the source, and the given output STL string will be replaced by
@@ -28,7 +50,23 @@ bool ConvertUnicode(const SRC_CHAR* src,
   // ICU requires 32-bit numbers.
   bool success = true;
   int32_t src_len32 = static_cast<int32_t>(src_len);
+  size_t ascii_run = 0;
   for (int32_t i = 0; i < src_len32; i++) {
+    if (static_cast<uint32_t>(src[i]) < 0x80) {
+      // Long runs of ASCII, which are the bulk of most strings, are copied at
+      // once.
+      if (++ascii_run < kMinBulkASCIIRun) {
+        output->push_back(static_cast<typename DEST_STRING::value_type>(src[i]));
+      } else {
+        const size_t ascii_len = CountLeadingASCII(src + i, src_len - i);
+        AppendASCII(src + i, ascii_len, output);
+        i += static_cast<int32_t>(ascii_len) - 1;
+        ascii_run = 0;
+      }
+      continue;
+    }
+    ascii_run = 0;
+
     uint32_t code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
@@ -46,7 +84,7 @@ bool ConvertUnicode(const SRC_CHAR* src,
 // UTF-8 <-> Wide --------------------------------------------------------------
 
 bool WideToUTF8(const wchar_t* src, size_t src_len, std::string* output) {
-  if (IsStringASCII(std::wstring(src, src_len))) {
+  if (IsASCII(src, src_len)) {
     output->assign(src, src + src_len);
     return true;
   } else {
@@ -56,7 +94,7 @@ bool WideToUTF8(const wchar_t* src, size_t src_len, std::string* output) {
 }
 
 std::string WideToUTF8(const std::wstring& wide) {
-  if (IsStringASCII(wide)) {
+  if (IsASCII(wide.data(), wide.length())) {
     return std::string(wide.data(), wide.data() + wide.length());
   }
 
@@ -67,7 +105,7 @@ std::string WideToUTF8(const std::wstring& wide) {
 }
 
 bool UTF8ToWide(const char* src, size_t src_len, std::wstring* output) {
-  if (IsStringASCII(StringPiece(src, src_len))) {
+  if (IsASCII(src, src_len)) {
     output->assign(src, src + src_len);
     return true;
   } else {
@@ -77,7 +115,7 @@ bool UTF8ToWide(const char* src, size_t src_len, std::wstring* output) {
 }
 
 std::wstring UTF8ToWide(StringPiece utf8) {
-  if (IsStringASCII(utf8)) {
+  if (IsASCII(utf8.data(), utf8.length())) {
     return std::wstring(utf8.begin(), utf8.end());
   }
 
@@ -147,7 +185,7 @@ std::wstring UTF16ToWide(const string16& utf16) {
 #if defined(WCHAR_T_IS_UTF32)
 
 bool UTF8ToUTF16(const char* src, size_t src_len, string16* output) {
-  if (IsStringASCII(StringPiece(src, src_len))) {
+  if (IsASCII(src, src_len)) {
     output->assign(src, src + src_len);
     return true;
   } else {
@@ -157,7 +195,7 @@ bool UTF8ToUTF16(const char* src, size_t src_len, string16* output) {
 }
 
 string16 UTF8ToUTF16(StringPiece utf8) {
-  if (IsStringASCII(utf8)) {
+  if (IsASCII(utf8.data(), utf8.length())) {
     return string16(utf8.begin(), utf8.end());
   }
 
@@ -170,7 +208,7 @@ string16 UTF8ToUTF16(StringPiece utf8) {
 }
 
 bool UTF16ToUTF8(const char16* src, size_t src_len, std::string* output) {
-  if (IsStringASCII(StringPiece16(src, src_len))) {
+  if (IsASCII(src, src_len)) {
     output->assign(src, src + src_len);
     return true;
   } else {
@@ -180,7 +218,7 @@ bool UTF16ToUTF8(const char16* src, size_t src_len, std::string* output) {
 }
 
 std::string UTF16ToUTF8(StringPiece16 utf16) {
-  if (IsStringASCII(utf16)) {
+  if (IsASCII(utf16.data(), utf16.length())) {
     return std::string(utf16.begin(), utf16.end());
   }
 
@@ -207,7 +245,7 @@ bool UTF16ToUTF8(const char16* src, size_t src_len, std::string* output) {
 }
 
 std::string UTF16ToUTF8(StringPiece16 utf16) {
-  if (IsStringASCII(utf16))
+  if (IsASCII(utf16.data(), utf16.length()))
     return std::string(utf16.data(), utf16.data() + utf16.length());
 
   std::string ret;
@@ -8,6 +8,7 @@
 #include "base/macros.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversion_utils.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -208,4 +209,54 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+TEST(UTFStringConversionsTest, CountLeadingASCII) {
+  EXPECT_EQ(0u, CountLeadingASCII("", 0));
+  // Put a non-ASCII character at every position of the first blocks, so that
+  // both the vector and the scalar loops find it.
+  for (size_t position = 0; position < 40; ++position) {
+    std::string utf8(position, '\x7F');
+    utf8 += "\xC3\xA9";
+    utf8 += std::string(20, 'a');
+    EXPECT_EQ(position, CountLeadingASCII(utf8.data(), utf8.size()));
+
+    string16 utf16(position, 'a');
+    for (char16 non_ascii : {0x80, 0xFF, 0x100, 0xD800, 0xFFFF}) {
+      string16 with_non_ascii = utf16 + non_ascii + string16(20, 'b');
+      EXPECT_EQ(position, CountLeadingASCII(with_non_ascii.data(),
+                                            with_non_ascii.size()))
+          << non_ascii;
+    }
+  }
+
+  const std::string ascii(37, 'x');
+  EXPECT_EQ(ascii.size(), CountLeadingASCII(ascii.data(), ascii.size()));
+  const string16 ascii16(37, 'x');
+  EXPECT_EQ(ascii16.size(), CountLeadingASCII(ascii16.data(), ascii16.size()));
+}
+
+// The converters copy runs of ASCII at once; make sure the characters around
+// them survive, wherever they fall relative to the blocks.
+TEST(UTFStringConversionsTest, ConvertMixedASCII) {
+  const std::string kNonASCII[] = {"\xC3\xA9", "\xE2\x82\xAC",
+                                   "\xF0\x9F\x98\x80"};
+  for (const std::string& non_ascii : kNonASCII) {
+    for (size_t run = 0; run < 35; ++run) {
+      std::string utf8 = non_ascii + std::string(run, 'a') + non_ascii +
+                         std::string(run / 2, 'b');
+      string16 utf16 = UTF8ToUTF16(utf8);
+      EXPECT_EQ(utf8, UTF16ToUTF8(utf16));
+      EXPECT_EQ(utf8, WideToUTF8(UTF8ToWide(utf8)));
+      EXPECT_TRUE(IsStringUTF8(utf8));
+
+      // An invalid byte after a run of ASCII is still replaced.
+      std::string invalid = std::string(run, 'c') + "\xFF" + utf8;
+      EXPECT_FALSE(IsStringUTF8(invalid));
+      string16 converted;
+      EXPECT_FALSE(UTF8ToUTF16(invalid.data(), invalid.size(), &converted));
+      EXPECT_EQ(string16(run, 'c') + static_cast<char16>(0xFFFD) + utf16,
+                converted);
+    }
+  }
+}
+
 }  // namespace base
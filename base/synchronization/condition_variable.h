@@ -71,7 +71,11 @@
 #include "base/synchronization/lock.h"
 #include "build/build_config.h"
 
-#if defined(OS_POSIX)
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <stdint.h>
+
+#include <atomic>
+#elif defined(OS_POSIX)
 #include <pthread.h>
 #endif
 
@@ -105,6 +109,16 @@ class BASE_EXPORT ConditionVariable {
 #if defined(OS_WIN)
   CONDITION_VARIABLE cv_;
   SRWLOCK* const srwlock_;
+#elif defined(OS_LINUX) || defined(OS_ANDROID)
+  // Futex word, incremented by each Signal() and Broadcast(). See
+  // condition_variable_linux.cc.
+  std::atomic<int32_t> sequence_;
+
+  // Number of threads in Wait() or TimedWait(), which Signal() and Broadcast()
+  // don't need to wake when it is zero.
+  std::atomic<int32_t> num_waiters_;
+
+  internal::LockImpl* const user_lock_impl_;
 #elif defined(OS_POSIX)
   pthread_cond_t condition_;
   pthread_mutex_t* user_mutex_;
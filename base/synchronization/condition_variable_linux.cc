@@ -0,0 +1,89 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/condition_variable.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/synchronization/futex_linux.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+
+// -----------------------------------------------------------------------------
+// ConditionVariable on Linux and Android waits on a futex word, |sequence_|,
+// which every Signal() and Broadcast() increments. A waiter reads |sequence_|
+// while it holds the user lock and blocks until it changes, so a signal sent
+// after the waiter released the user lock can't be missed: either the waiter
+// wasn't blocked yet and the kernel sees that |sequence_| changed, or it is
+// blocked and gets woken.
+//
+// |num_waiters_| lets Signal() and Broadcast() skip the system call when no
+// thread is waiting, which is frequent for condition variables that are
+// signaled on every state change.
+// -----------------------------------------------------------------------------
+
+namespace base {
+
+ConditionVariable::ConditionVariable(Lock* user_lock)
+    : sequence_(0),
+      num_waiters_(0),
+      user_lock_impl_(&user_lock->lock_)
+#if DCHECK_IS_ON()
+    , user_lock_(user_lock)
+#endif
+{
+}
+
+ConditionVariable::~ConditionVariable() {
+  DCHECK_EQ(0, num_waiters_.load(std::memory_order_relaxed));
+}
+
+void ConditionVariable::Wait() {
+  base::ThreadRestrictions::AssertWaitAllowed();
+#if DCHECK_IS_ON()
+  user_lock_->CheckHeldAndUnmark();
+#endif
+  num_waiters_.fetch_add(1);
+  const int32_t sequence = sequence_.load();
+  user_lock_impl_->Unlock();
+  internal::FutexWait(&sequence_, sequence);
+  num_waiters_.fetch_sub(1);
+  user_lock_impl_->Lock();
+#if DCHECK_IS_ON()
+  user_lock_->CheckUnheldAndMark();
+#endif
+}
+
+void ConditionVariable::TimedWait(const TimeDelta& max_time) {
+  base::ThreadRestrictions::AssertWaitAllowed();
+#if DCHECK_IS_ON()
+  user_lock_->CheckHeldAndUnmark();
+#endif
+  num_waiters_.fetch_add(1);
+  const int32_t sequence = sequence_.load();
+  user_lock_impl_->Unlock();
+  internal::FutexTimedWait(&sequence_, sequence,
+                           std::max(max_time, TimeDelta()));
+  num_waiters_.fetch_sub(1);
+  user_lock_impl_->Lock();
+#if DCHECK_IS_ON()
+  user_lock_->CheckUnheldAndMark();
+#endif
+}
+
+void ConditionVariable::Broadcast() {
+  sequence_.fetch_add(1);
+  if (num_waiters_.load())
+    internal::FutexWake(&sequence_, std::numeric_limits<int>::max());
+}
+
+void ConditionVariable::Signal() {
+  sequence_.fetch_add(1);
+  if (num_waiters_.load())
+    internal::FutexWake(&sequence_, 1);
+}
+
+}  // namespace base
@@ -0,0 +1,80 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This file contains the futex primitives which base::Lock,
+// base::ConditionVariable and base::WaitableEvent are built on on Linux and
+// Android. Don't use them directly.
+
+#ifndef BASE_SYNCHRONIZATION_FUTEX_LINUX_H_
+#define BASE_SYNCHRONIZATION_FUTEX_LINUX_H_
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "base/logging.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+
+namespace base {
+namespace internal {
+
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+              "a futex word must be a plain 32-bit integer");
+
+// Blocks until |word| is woken by FutexWake(), if |word| holds |expected|.
+// Returns immediately otherwise. May also return spuriously.
+inline void FutexWait(std::atomic<int32_t>* word, int32_t expected) {
+  int rv = syscall(SYS_futex, reinterpret_cast<int32_t*>(word),
+                   FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected, nullptr,
+                   nullptr, 0);
+  DCHECK(rv == 0 || errno == EAGAIN || errno == EINTR) << errno;
+}
+
+// Same as FutexWait(), but doesn't block longer than |timeout|.
+inline void FutexTimedWait(std::atomic<int32_t>* word,
+                           int32_t expected,
+                           const TimeDelta& timeout) {
+  DCHECK_GE(timeout, TimeDelta());
+  const int64_t usecs = timeout.InMicroseconds();
+  struct timespec relative_time;
+  relative_time.tv_sec = usecs / Time::kMicrosecondsPerSecond;
+  relative_time.tv_nsec =
+      (usecs % Time::kMicrosecondsPerSecond) * Time::kNanosecondsPerMicrosecond;
+  int rv = syscall(SYS_futex, reinterpret_cast<int32_t*>(word),
+                   FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected, &relative_time,
+                   nullptr, 0);
+  DCHECK(rv == 0 || errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT)
+      << errno;
+}
+
+// Wakes up to |count| threads blocked in FutexWait() on |word|.
+inline void FutexWake(std::atomic<int32_t>* word, int count) {
+  int rv = syscall(SYS_futex, reinterpret_cast<int32_t*>(word),
+                   FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, nullptr, nullptr,
+                   0);
+  DCHECK_GE(rv, 0) << errno;
+}
+
+// Tells the processor that the caller is spinning, which lets a hyperthread
+// sibling make progress and saves power.
+inline void SpinPause() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  __asm__ __volatile__("pause");
+#elif defined(ARCH_CPU_ARM_FAMILY) && __ARM_ARCH >= 7
+  __asm__ __volatile__("yield");
+#else
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_FUTEX_LINUX_H_
@@ -11,6 +11,10 @@
 
 #if defined(OS_WIN)
 #include <windows.h>
+#elif defined(OS_LINUX) || defined(OS_ANDROID)
+#include <stdint.h>
+
+#include <atomic>
 #elif defined(OS_POSIX)
 #include <pthread.h>
 #endif
@@ -25,6 +29,9 @@ class BASE_EXPORT LockImpl {
  public:
 #if defined(OS_WIN)
   using NativeHandle = SRWLOCK;
+#elif defined(OS_LINUX) || defined(OS_ANDROID)
+  // A futex word. See lock_impl_linux.cc.
+  using NativeHandle = std::atomic<int32_t>;
 #elif defined(OS_POSIX)
   using NativeHandle =  pthread_mutex_t;
 #endif
@@ -37,11 +44,31 @@ class BASE_EXPORT LockImpl {
   bool Try();
 
   // Take the lock, blocking until it is available if necessary.
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  void Lock() {
+    int32_t expected = kUnlocked;
+    if (!native_handle_.compare_exchange_strong(expected, kLocked,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+      LockSlow();
+    }
+  }
+#else
   void Lock();
+#endif
 
   // Release the lock.  This must only be called by the lock's holder: after
   // a successful call to Try, or a call to Lock.
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  void Unlock() {
+    if (native_handle_.exchange(kUnlocked, std::memory_order_release) ==
+        kLockedWithWaiters) {
+      WakeWaiter();
+    }
+  }
+#else
   void Unlock();
+#endif
 
   // Return the native underlying lock.
   // TODO(awalker): refactor lock and condition variables so that this is
@@ -49,6 +76,22 @@ class BASE_EXPORT LockImpl {
   NativeHandle* native_handle() { return &native_handle_; }
 
  private:
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Values of |native_handle_|. Threads blocked in LockSlow() wait for the
+  // value to change from kLockedWithWaiters.
+  enum : int32_t { kUnlocked = 0, kLocked = 1, kLockedWithWaiters = 2 };
+
+  // Spins, then blocks until the lock is available.
+  void LockSlow();
+
+  // Wakes a thread blocked in LockSlow().
+  void WakeWaiter();
+
+  // Moving average of the number of spins it took to take the lock in
+  // LockSlow(), which bounds the number of spins of the next LockSlow().
+  std::atomic<int32_t> spin_estimate_;
+#endif
+
   NativeHandle native_handle_;
 
   DISALLOW_COPY_AND_ASSIGN(LockImpl);
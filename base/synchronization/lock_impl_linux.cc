@@ -0,0 +1,87 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/lock_impl.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/synchronization/futex_linux.h"
+
+// -----------------------------------------------------------------------------
+// LockImpl on Linux and Android is a futex-based mutex, as described in
+// "Futexes Are Tricky" (Drepper). |native_handle_| is:
+//   kUnlocked:          the lock is free.
+//   kLocked:            the lock is held and no thread is blocked on it.
+//   kLockedWithWaiters: the lock is held and threads may be blocked on it, in
+//                       which case Unlock() must wake one of them.
+//
+// Taking and releasing an uncontended lock is a single atomic operation, and
+// no system call is made unless a thread actually has to block. Before
+// blocking, a thread spins for a while in case the holder releases the lock
+// soon, which is the common case for the short critical sections of Chromium.
+// Like glibc's adaptive mutexes, the number of spins adapts to the number of
+// spins that were needed by previous contended acquisitions of the same lock.
+// -----------------------------------------------------------------------------
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Bounds of the number of times LockSlow() checks the lock before blocking.
+const int32_t kMinSpins = 10;
+const int32_t kMaxSpins = 1000;
+
+}  // namespace
+
+LockImpl::LockImpl() : spin_estimate_(0), native_handle_(kUnlocked) {}
+
+LockImpl::~LockImpl() {
+  DCHECK_EQ(kUnlocked, native_handle_.load(std::memory_order_relaxed));
+}
+
+bool LockImpl::Try() {
+  int32_t expected = kUnlocked;
+  return native_handle_.compare_exchange_strong(expected, kLocked,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed);
+}
+
+void LockImpl::LockSlow() {
+  const int32_t estimate = spin_estimate_.load(std::memory_order_relaxed);
+  const int32_t max_spins = std::min(kMaxSpins, estimate * 2 + kMinSpins);
+  for (int32_t spins = 0; spins < max_spins; ++spins) {
+    SpinPause();
+    // Only attempt the exchange when the lock looks free, to avoid taking the
+    // cache line away from the holder.
+    int32_t expected = kUnlocked;
+    if (native_handle_.load(std::memory_order_relaxed) == kUnlocked &&
+        native_handle_.compare_exchange_weak(expected, kLocked,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+      // Move the estimate an eighth of the way towards this acquisition.
+      spin_estimate_.store(estimate + (spins - estimate) / 8,
+                           std::memory_order_relaxed);
+      return;
+    }
+  }
+  spin_estimate_.store(estimate + (max_spins - estimate) / 8,
+                       std::memory_order_relaxed);
+
+  // Block. As it can't tell whether other threads are still blocked, a thread
+  // which takes the lock here leaves it in the kLockedWithWaiters state, which
+  // at worst costs an unnecessary wake in Unlock().
+  while (native_handle_.exchange(kLockedWithWaiters,
+                                 std::memory_order_acquire) != kUnlocked) {
+    FutexWait(&native_handle_, kLockedWithWaiters);
+  }
+}
+
+void LockImpl::WakeWaiter() {
+  FutexWake(&native_handle_, 1);
+}
+
+}  // namespace internal
+}  // namespace base
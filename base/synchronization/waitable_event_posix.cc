@@ -7,11 +7,23 @@
 #include <algorithm>
 #include <vector>
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <stdint.h>
+
+#include <atomic>
+#endif
+
 #include "base/logging.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "base/threading/thread_restrictions.h"
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include "base/synchronization/futex_linux.h"
+#endif
 
 // -----------------------------------------------------------------------------
 // A WaitableEvent on POSIX is implemented as a wait-list. Currently we don't
@@ -79,6 +91,97 @@ bool WaitableEvent::IsSignaled() {
 // -----------------------------------------------------------------------------
 // Synchronous waits
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// -----------------------------------------------------------------------------
+// This is a synchronous waiter. The thread waits on a futex word which holds
+// the state of the waiter, so that waking it takes a single system call, and
+// none if it was still spinning.
+// -----------------------------------------------------------------------------
+class SyncWaiter : public WaitableEvent::Waiter {
+ public:
+  SyncWaiter() : state_(kWaiting), signaling_event_(NULL) {}
+
+  bool Fire(WaitableEvent* signaling_event) override {
+    // Several events may fire this waiter concurrently (see WaitMany). Only
+    // the first one to leave the kWaiting state sets |signaling_event_|.
+    int32_t expected = kWaiting;
+    if (!state_.compare_exchange_strong(expected, kFiring,
+                                        std::memory_order_relaxed)) {
+      return false;
+    }
+    signaling_event_ = signaling_event;
+    state_.store(kFired, std::memory_order_release);
+
+    // The waiting thread can't return, and destroy this object, before the
+    // signaling event's lock, which is held by our caller, is released.
+    internal::FutexWake(&state_, 1);
+    return true;
+  }
+
+  WaitableEvent* signaling_event() const {
+    return signaling_event_;
+  }
+
+  // ---------------------------------------------------------------------------
+  // These waiters are always stack allocated and don't delete themselves. Thus
+  // there's no problem and the ABA tag is the same as the object pointer.
+  // ---------------------------------------------------------------------------
+  bool Compare(void* tag) override { return this == tag; }
+
+  // ---------------------------------------------------------------------------
+  // Waits until the waiter is fired, or until |end_time| if |finite_time|.
+  // Returns true if the waiter was fired. Otherwise, the waiter was disabled so
+  // that an auto-reset WaitableEvent doesn't think that it has been signaled
+  // between the timeout and its removal from the wait-list.
+  // ---------------------------------------------------------------------------
+  bool Wait(TimeTicks end_time, bool finite_time) {
+    // Signals usually come shortly after Wait() in ping-pong patterns, so spin
+    // briefly before blocking.
+    for (int spins = 0; spins < kSpins; ++spins) {
+      if (state_.load(std::memory_order_acquire) == kFired)
+        return true;
+      internal::SpinPause();
+    }
+
+    for (;;) {
+      const int32_t state = state_.load(std::memory_order_acquire);
+      if (state == kFired)
+        return true;
+      if (state == kFiring) {
+        // Fire() is about to store kFired and wake us.
+        internal::FutexWait(&state_, kFiring);
+        continue;
+      }
+
+      DCHECK_EQ(kWaiting, state);
+      if (!finite_time) {
+        internal::FutexWait(&state_, kWaiting);
+        continue;
+      }
+      const TimeTicks current_time(TimeTicks::Now());
+      if (current_time >= end_time) {
+        int32_t expected = kWaiting;
+        if (state_.compare_exchange_strong(expected, kDisabled,
+                                           std::memory_order_relaxed)) {
+          return false;
+        }
+        continue;
+      }
+      internal::FutexTimedWait(&state_, kWaiting, end_time - current_time);
+    }
+  }
+
+ private:
+  // Number of times to check for a signal before blocking.
+  static const int kSpins = 100;
+
+  enum : int32_t { kWaiting, kFiring, kFired, kDisabled };
+
+  // Futex word.
+  std::atomic<int32_t> state_;
+  WaitableEvent* signaling_event_;  // The WaitableEvent which woke us
+};
+#else
 // -----------------------------------------------------------------------------
 // This is a synchronous waiter. The thread is waiting on the given condition
 // variable and the fired flag in this object.
@@ -121,27 +224,35 @@ class SyncWaiter : public WaitableEvent::Waiter {
   bool Compare(void* tag) override { return this == tag; }
 
   // ---------------------------------------------------------------------------
-  // Called with lock held.
-  // ---------------------------------------------------------------------------
-  bool fired() const {
-    return fired_;
-  }
-
-  // ---------------------------------------------------------------------------
-  // During a TimedWait, we need a way to make sure that an auto-reset
-  // WaitableEvent doesn't think that this event has been signaled between
-  // unlocking it and removing it from the wait-list. Called with lock held.
+  // Waits until the waiter is fired, or until |end_time| if |finite_time|.
+  // Returns true if the waiter was fired. Otherwise, the waiter was disabled so
+  // that an auto-reset WaitableEvent doesn't think that it has been signaled
+  // between the timeout and its removal from the wait-list.
   // ---------------------------------------------------------------------------
-  void Disable() {
-    fired_ = true;
-  }
-
-  base::Lock* lock() {
-    return &lock_;
-  }
-
-  base::ConditionVariable* cv() {
-    return &cv_;
+  bool Wait(TimeTicks end_time, bool finite_time) {
+    base::AutoLock locked(lock_);
+    for (;;) {
+      const TimeTicks current_time(TimeTicks::Now());
+
+      if (fired_ || (finite_time && current_time >= end_time)) {
+        const bool return_value = fired_;
+
+        // We can't acquire the WaitableEvent's lock before releasing @lock_
+        // (because of locking order), however, in between the two a signal
+        // could be fired and we would accept it, however we will still return
+        // false, so the signal would be lost on an auto-reset WaitableEvent.
+        // Thus we disable ourselves, which makes Fire return false.
+        fired_ = true;
+        return return_value;
+      }
+
+      if (finite_time) {
+        const TimeDelta max_wait(end_time - current_time);
+        cv_.TimedWait(max_wait);
+      } else {
+        cv_.Wait();
+      }
+    }
   }
 
  private:
@@ -150,6 +261,7 @@ class SyncWaiter : public WaitableEvent::Waiter {
   base::Lock lock_;
   base::ConditionVariable cv_;
 };
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
 
 void WaitableEvent::Wait() {
   bool result = TimedWait(TimeDelta::FromSeconds(-1));
@@ -173,48 +285,24 @@ bool WaitableEvent::TimedWait(const TimeDelta& max_time) {
     return true;
   }
 
+  ScopedBlockingCall blocking_call;
   SyncWaiter sw;
-  sw.lock()->Acquire();
 
   Enqueue(&sw);
   kernel_->lock_.Release();
-  // We are violating locking order here by holding the SyncWaiter lock but not
-  // the WaitableEvent lock. However, this is safe because we don't lock @lock_
-  // again before unlocking it.
 
-  for (;;) {
-    const TimeTicks current_time(TimeTicks::Now());
-
-    if (sw.fired() || (finite_time && current_time >= end_time)) {
-      const bool return_value = sw.fired();
-
-      // We can't acquire @lock_ before releasing the SyncWaiter lock (because
-      // of locking order), however, in between the two a signal could be fired
-      // and @sw would accept it, however we will still return false, so the
-      // signal would be lost on an auto-reset WaitableEvent. Thus we call
-      // Disable which makes sw::Fire return false.
-      sw.Disable();
-      sw.lock()->Release();
-
-      // This is a bug that has been enshrined in the interface of
-      // WaitableEvent now: |Dequeue| is called even when |sw.fired()| is true,
-      // even though it'll always return false in that case. However, taking
-      // the lock ensures that |Signal| has completed before we return and
-      // means that a WaitableEvent can synchronise its own destruction.
-      kernel_->lock_.Acquire();
-      kernel_->Dequeue(&sw, &sw);
-      kernel_->lock_.Release();
-
-      return return_value;
-    }
+  const bool return_value = sw.Wait(end_time, finite_time);
 
-    if (finite_time) {
-      const TimeDelta max_wait(end_time - current_time);
-      sw.cv()->TimedWait(max_wait);
-    } else {
-      sw.cv()->Wait();
-    }
-  }
+  // This is a bug that has been enshrined in the interface of WaitableEvent
+  // now: |Dequeue| is called even when |sw| was fired, even though it'll
+  // always return false in that case. However, taking the lock ensures that
+  // |Signal| has completed before we return and means that a WaitableEvent can
+  // synchronise its own destruction.
+  kernel_->lock_.Acquire();
+  kernel_->Dequeue(&sw, &sw);
+  kernel_->lock_.Release();
+
+  return return_value;
 }
 
 // -----------------------------------------------------------------------------
@@ -251,6 +339,7 @@ size_t WaitableEvent::WaitMany(WaitableEvent** raw_waitables,
     DCHECK(waitables[i].first != waitables[i+1].first);
   }
 
+  ScopedBlockingCall blocking_call;
   SyncWaiter sw;
 
   const size_t r = EnqueueMany(&waitables[0], count, &sw);
@@ -264,19 +353,13 @@ size_t WaitableEvent::WaitMany(WaitableEvent** raw_waitables,
 
   // At this point, we hold the locks on all the WaitableEvents and we have
   // enqueued our waiter in them all.
-  sw.lock()->Acquire();
-    // Release the WaitableEvent locks in the reverse order
-    for (size_t i = 0; i < count; ++i) {
-      waitables[count - (1 + i)].first->kernel_->lock_.Release();
-    }
-
-    for (;;) {
-      if (sw.fired())
-        break;
+  // Release the WaitableEvent locks in the reverse order
+  for (size_t i = 0; i < count; ++i) {
+    waitables[count - (1 + i)].first->kernel_->lock_.Release();
+  }
 
-      sw.cv()->Wait();
-    }
-  sw.lock()->Release();
+  const bool fired = sw.Wait(TimeTicks(), false);
+  DCHECK(fired);
 
   // The address of the WaitableEvent which fired is stored in the SyncWaiter.
   WaitableEvent *const signaled_event = sw.signaling_event();
@@ -11,6 +11,7 @@
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/time/time.h"
 
@@ -43,11 +44,17 @@ void WaitableEvent::Signal() {
 }
 
 bool WaitableEvent::IsSignaled() {
-  return TimedWait(TimeDelta());
+  // Not implemented with TimedWait() since checking the state of the event
+  // doesn't block.
+  DWORD result = WaitForSingleObject(handle_.Get(), 0);
+  DCHECK(result == WAIT_OBJECT_0 || result == WAIT_TIMEOUT)
+      << "WaitForSingleObject failed";
+  return result == WAIT_OBJECT_0;
 }
 
 void WaitableEvent::Wait() {
   base::ThreadRestrictions::AssertWaitAllowed();
+  ScopedBlockingCall blocking_call;
   DWORD result = WaitForSingleObject(handle_.Get(), INFINITE);
   // It is most unexpected that this should ever fail.  Help consumers learn
   // about it if it should ever fail.
@@ -62,6 +69,7 @@ bool WaitableEvent::TimedWait(const TimeDelta& max_time) {
   // is the maximum time that a caller is willing to wait.
   DWORD timeout = saturated_cast<DWORD>(max_time.InMilliseconds());
 
+  ScopedBlockingCall blocking_call;
   DWORD result = WaitForSingleObject(handle_.Get(), timeout);
   switch (result) {
     case WAIT_OBJECT_0:
@@ -85,6 +93,7 @@ size_t WaitableEvent::WaitMany(WaitableEvent** events, size_t count) {
   for (size_t i = 0; i < count; ++i)
     handles[i] = events[i]->handle();
 
+  ScopedBlockingCall blocking_call;
   // The cast is safe because count is small - see the CHECK above.
   DWORD result =
       WaitForMultipleObjects(static_cast<DWORD>(count),
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/files/file_path.h"
@@ -97,6 +98,19 @@ class BASE_EXPORT SysInfo {
   // allocate.
   static size_t VMAllocationGranularity();
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Returns the indices of the logical processors that belong to NUMA node
+  // |numa_node|, in ascending order. Returns an empty vector if the node
+  // doesn't exist or if the NUMA topology can't be read.
+  static std::vector<int> GetProcessorsOfNumaNode(int numa_node);
+
+  // Returns the indices of the logical processors with the highest maximum
+  // frequency, in ascending order. On a heterogeneous system (e.g. big.LITTLE)
+  // these are the big cores. All processors are returned if their frequencies
+  // can't be read.
+  static std::vector<int> GetFastestProcessors();
+#endif
+
 #if defined(OS_CHROMEOS)
   typedef std::map<std::string, std::string> LsbReleaseMap;
 
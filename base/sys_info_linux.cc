@@ -14,6 +14,9 @@
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/sys_info_internal.h"
 #include "build/build_config.h"
 
@@ -37,6 +40,29 @@ base::LazyInstance<
     base::internal::LazySysInfoValue<int64_t, AmountOfPhysicalMemory>>::Leaky
     g_lazy_physical_memory = LAZY_INSTANCE_INITIALIZER;
 
+// Parses a list of processors in the sysfs "cpulist" format (e.g. "0-3,8,10")
+// and appends them to |processors|. Returns false if |cpu_list| is malformed.
+bool ParseProcessorList(const std::string& cpu_list,
+                        std::vector<int>* processors) {
+  for (const base::StringPiece& range :
+       base::SplitStringPiece(cpu_list, ",", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    const std::vector<base::StringPiece> bounds = base::SplitStringPiece(
+        range, "-", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+    int first = 0;
+    int last = 0;
+    if (bounds.empty() || bounds.size() > 2 ||
+        !base::StringToInt(bounds.front(), &first) ||
+        !base::StringToInt(bounds.back(), &last) || first < 0 ||
+        last < first) {
+      return false;
+    }
+    for (int processor = first; processor <= last; ++processor)
+      processors->push_back(processor);
+  }
+  return true;
+}
+
 }  // namespace
 
 namespace base {
@@ -51,6 +77,53 @@ int64_t SysInfo::AmountOfPhysicalMemory() {
   return g_lazy_physical_memory.Get().value();
 }
 
+// static
+std::vector<int> SysInfo::GetProcessorsOfNumaNode(int numa_node) {
+  std::vector<int> processors;
+  std::string cpu_list;
+  if (numa_node < 0 ||
+      !ReadFileToString(
+          FilePath(StringPrintf("/sys/devices/system/node/node%d/cpulist",
+                                numa_node)),
+          &cpu_list) ||
+      !ParseProcessorList(cpu_list, &processors)) {
+    return std::vector<int>();
+  }
+  return processors;
+}
+
+// static
+std::vector<int> SysInfo::GetFastestProcessors() {
+  const int num_processors = NumberOfProcessors();
+  std::vector<int> fastest_processors;
+  int64_t highest_max_frequency = -1;
+  for (int processor = 0; processor < num_processors; ++processor) {
+    std::string contents;
+    int64_t max_frequency = 0;
+    if (!ReadFileToString(
+            FilePath(StringPrintf(
+                "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq",
+                processor)),
+            &contents) ||
+        !StringToInt64(TrimWhitespaceASCII(contents, TRIM_ALL),
+                       &max_frequency)) {
+      // Without the frequency of every processor, fall back to considering
+      // all processors equally fast.
+      fastest_processors.clear();
+      for (int i = 0; i < num_processors; ++i)
+        fastest_processors.push_back(i);
+      return fastest_processors;
+    }
+    if (max_frequency > highest_max_frequency) {
+      highest_max_frequency = max_frequency;
+      fastest_processors.clear();
+    }
+    if (max_frequency == highest_max_frequency)
+      fastest_processors.push_back(processor);
+  }
+  return fastest_processors;
+}
+
 // static
 std::string SysInfo::CPUModelName() {
 #if defined(OS_CHROMEOS) && defined(ARCH_CPU_ARMEL)
@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/environment.h"
 #include "base/files/file_util.h"
 #include "base/sys_info.h"
@@ -69,6 +71,30 @@ TEST_F(SysInfoTest, Uptime) {
   EXPECT_GT(up_time_2.InMicroseconds(), up_time_1.InMicroseconds());
 }
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+TEST_F(SysInfoTest, GetProcessorsOfNumaNode) {
+  // We aren't actually testing that it's correct, just that it's sane. The
+  // NUMA topology isn't exposed on all kernels, so node 0 may be empty.
+  const int num_processors = base::SysInfo::NumberOfProcessors();
+  for (int processor : base::SysInfo::GetProcessorsOfNumaNode(0)) {
+    EXPECT_GE(processor, 0);
+    EXPECT_LT(processor, num_processors);
+  }
+  EXPECT_TRUE(base::SysInfo::GetProcessorsOfNumaNode(-1).empty());
+}
+
+TEST_F(SysInfoTest, GetFastestProcessors) {
+  const int num_processors = base::SysInfo::NumberOfProcessors();
+  const std::vector<int> fastest_processors =
+      base::SysInfo::GetFastestProcessors();
+  EXPECT_FALSE(fastest_processors.empty());
+  for (int processor : fastest_processors) {
+    EXPECT_GE(processor, 0);
+    EXPECT_LT(processor, num_processors);
+  }
+}
+#endif
+
 #if defined(OS_MACOSX) && !defined(OS_IOS)
 TEST_F(SysInfoTest, HardwareModelName) {
   std::string hardware_model = base::SysInfo::HardwareModelName();
@@ -0,0 +1,95 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/task_coroutine.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/sequenced_task_runner.h"
+
+namespace base {
+
+TaskCoroutine::~TaskCoroutine() {
+  DCHECK(sequence_checker_.CalledOnValidSequencedThread());
+}
+
+void TaskCoroutine::Start() {
+  DCHECK(sequence_checker_.CalledOnValidSequencedThread());
+  DCHECK(!started_);
+  started_ = true;
+  yielded_ = true;
+  task_runner_->PostTask(FROM_HERE, resume_closure_);
+}
+
+void TaskCoroutine::WillAwaitForMacros(int resume_point) {
+  DCHECK(running_);
+  DCHECK(!awaiting_);
+  resume_point_ = resume_point;
+  awaiting_ = true;
+}
+
+void TaskCoroutine::DidCompleteSynchronouslyForMacros(int result) {
+  DCHECK(running_);
+  DCHECK(awaiting_);
+  awaiting_ = false;
+  result_ = result;
+}
+
+void TaskCoroutine::WillYieldForMacros(int resume_point) {
+  DCHECK(running_);
+  DCHECK(!awaiting_);
+  resume_point_ = resume_point;
+  yielded_ = true;
+  task_runner_->PostTask(FROM_HERE, resume_closure_);
+}
+
+TaskCoroutine::TaskCoroutine(scoped_refptr<SequencedTaskRunner> task_runner)
+    : task_runner_(std::move(task_runner)), weak_factory_(this) {
+  DCHECK(task_runner_);
+  resume_callback_ =
+      Bind(&TaskCoroutine::OnResumeCallback, weak_factory_.GetWeakPtr());
+  resume_closure_ =
+      Bind(&TaskCoroutine::OnResumeClosure, weak_factory_.GetWeakPtr());
+}
+
+void TaskCoroutine::OnResumeCallback(int result) {
+  DCHECK(sequence_checker_.CalledOnValidSequencedThread());
+  DCHECK(awaiting_);
+  awaiting_ = false;
+  result_ = result;
+
+  // When the callback runs synchronously from the awaited expression, Run()
+  // notices that it no longer awaits and continues without suspending.
+  if (!running_)
+    Resume();
+}
+
+void TaskCoroutine::OnResumeClosure() {
+  DCHECK(sequence_checker_.CalledOnValidSequencedThread());
+  DCHECK(yielded_);
+  yielded_ = false;
+  Resume();
+}
+
+void TaskCoroutine::Resume() {
+  DCHECK(!running_);
+  DCHECK(!awaiting_);
+  DCHECK(!yielded_);
+  DCHECK(!done_);
+
+  // Run() may delete |this|.
+  WeakPtr<TaskCoroutine> self = weak_factory_.GetWeakPtr();
+  running_ = true;
+  Run();
+  if (!self)
+    return;
+  running_ = false;
+
+  if (!awaiting_ && !yielded_)
+    done_ = true;
+}
+
+}  // namespace base
@@ -0,0 +1,213 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// EXPERIMENTAL. TaskCoroutine allows a chain of asynchronous steps to be
+// written as straight-line code instead of a DoLoop state machine that binds a
+// new completion callback at every step.
+//
+// A TaskCoroutine is stackless: its body is the Run() method, which is entered
+// from the top every time the coroutine resumes. The TASK_COROUTINE_* macros
+// jump to the statement that follows the point where the coroutine suspended.
+// Local variables of Run() don't survive a suspension; state that must survive
+// belongs in members.
+//
+// The completion callback returned by resume_callback() and the closure used to
+// resume after TASK_COROUTINE_YIELD() are bound once, when the TaskCoroutine is
+// constructed. Suspending and resuming doesn't allocate. When the completion
+// callback runs synchronously, the coroutine continues without returning from
+// Run(). When it runs later, the coroutine resumes from within the callback,
+// on the sequence of the TaskCoroutine's SequencedTaskRunner.
+//
+// Example:
+//
+//   class CopyFile : public TaskCoroutine {
+//    public:
+//     CopyFile(Reader* reader, Writer* writer)
+//         : TaskCoroutine(ThreadTaskRunnerHandle::Get()),
+//           reader_(reader),
+//           writer_(writer) {}
+//
+//    private:
+//     void Run() override {
+//       TASK_COROUTINE_BEGIN();
+//       while (true) {
+//         // Reader::Read() runs the callback with the number of bytes read.
+//         TASK_COROUTINE_AWAIT(reader_->Read(buffer_, resume_callback()));
+//         if (result() <= 0)
+//           break;
+//         // Writer::Write() returns its result synchronously or returns
+//         // ERR_IO_PENDING and runs the callback with the result later.
+//         TASK_COROUTINE_AWAIT_RESULT(
+//             writer_->Write(buffer_, result(), resume_callback()),
+//             ERR_IO_PENDING);
+//         if (result() < 0)
+//           break;
+//       }
+//       TASK_COROUTINE_END();
+//     }
+//
+//     Reader* const reader_;
+//     Writer* const writer_;
+//     char buffer_[kBufferSize];
+//   };
+//
+//   std::unique_ptr<CopyFile> copy(new CopyFile(reader, writer));
+//   copy->Start();
+//
+// Returning from Run() other than through a suspension, e.g. with a plain
+// return statement or by reaching TASK_COROUTINE_END(), completes the
+// coroutine. There can be at most one TASK_COROUTINE_* suspension point per
+// line.
+//
+// A TaskCoroutine must be started, resumed and deleted on the sequence of its
+// SequencedTaskRunner. Deleting it cancels a pending resumption. It can be
+// deleted from within Run() as long as Run() returns immediately afterwards.
+
+#ifndef BASE_TASK_TASK_COROUTINE_H_
+#define BASE_TASK_TASK_COROUTINE_H_
+
+#include "base/base_export.h"
+#include "base/callback.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+class SequencedTaskRunner;
+
+class BASE_EXPORT TaskCoroutine {
+ public:
+  virtual ~TaskCoroutine();
+
+  // Runs the coroutine until its first suspension in a task posted to its
+  // SequencedTaskRunner. Can only be called once.
+  void Start();
+
+  // Returns true once Run() has returned without suspending.
+  bool is_done() const { return done_; }
+
+  // Implementation details of the TASK_COROUTINE_* macros. Don't call.
+  int resume_point_for_macros() const { return resume_point_; }
+  void WillAwaitForMacros(int resume_point);
+  void DidCompleteSynchronouslyForMacros(int result);
+  bool ShouldSuspendForMacros() const { return awaiting_; }
+  void WillYieldForMacros(int resume_point);
+
+ protected:
+  // The coroutine resumes on the sequence of |task_runner|.
+  explicit TaskCoroutine(scoped_refptr<SequencedTaskRunner> task_runner);
+
+  // Body of the coroutine. Must start with TASK_COROUTINE_BEGIN() and end with
+  // TASK_COROUTINE_END().
+  virtual void Run() = 0;
+
+  // Returns a callback that resumes the coroutine with an int result when it
+  // is suspended in TASK_COROUTINE_AWAIT() or TASK_COROUTINE_AWAIT_RESULT().
+  // The same callback is returned every time. It must be run on the sequence of
+  // the coroutine; it does nothing once the coroutine is deleted.
+  const Callback<void(int)>& resume_callback() const {
+    return resume_callback_;
+  }
+
+  // Returns the result of the last TASK_COROUTINE_AWAIT() or
+  // TASK_COROUTINE_AWAIT_RESULT().
+  int result() const { return result_; }
+
+ private:
+  // Runs |resume_callback_|.
+  void OnResumeCallback(int result);
+
+  // Runs |resume_closure_|.
+  void OnResumeClosure();
+
+  // Enters Run() and determines whether the coroutine is done when it returns.
+  void Resume();
+
+  const scoped_refptr<SequencedTaskRunner> task_runner_;
+
+  // Identifies the statement at which Run() continues when it is entered. Zero
+  // before the first suspension.
+  int resume_point_ = 0;
+
+  // Result passed to the last run of |resume_callback_|.
+  int result_ = 0;
+
+  bool started_ = false;
+
+  // True while Run() is on the stack.
+  bool running_ = false;
+
+  // True from the moment the coroutine awaits until |resume_callback_| runs.
+  bool awaiting_ = false;
+
+  // True from the moment the coroutine yields until |resume_closure_| runs.
+  bool yielded_ = false;
+
+  bool done_ = false;
+
+  // Bound once, in the constructor.
+  Callback<void(int)> resume_callback_;
+  Closure resume_closure_;
+
+  SequenceChecker sequence_checker_;
+
+  WeakPtrFactory<TaskCoroutine> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskCoroutine);
+};
+
+}  // namespace base
+
+// Starts the body of a TaskCoroutine's Run() method.
+#define TASK_COROUTINE_BEGIN()               \
+  switch (this->resume_point_for_macros()) { \
+    default:                                 \
+      NOTREACHED();                          \
+      return;                                \
+    case 0:
+
+// Suspends the coroutine until resume_callback() is run. |expression| must
+// arrange for it to be run exactly once. The coroutine doesn't suspend if the
+// callback is run synchronously by |expression|.
+#define TASK_COROUTINE_AWAIT(expression)     \
+  do {                                       \
+    this->WillAwaitForMacros(__LINE__);      \
+    expression;                              \
+    if (this->ShouldSuspendForMacros())      \
+      return;                                \
+    case __LINE__:;                          \
+  } while (false)
+
+// Like TASK_COROUTINE_AWAIT() for an int |expression| which either returns its
+// result synchronously or returns |pending_value| and runs resume_callback()
+// with its result later.
+#define TASK_COROUTINE_AWAIT_RESULT(expression, pending_value)          \
+  do {                                                                  \
+    this->WillAwaitForMacros(__LINE__);                                 \
+    {                                                                   \
+      const int task_coroutine_result = (expression);                   \
+      if (task_coroutine_result != (pending_value))                     \
+        this->DidCompleteSynchronouslyForMacros(task_coroutine_result); \
+    }                                                                   \
+    if (this->ShouldSuspendForMacros())                                 \
+      return;                                                           \
+    case __LINE__:;                                                     \
+  } while (false)
+
+// Suspends the coroutine and resumes it in a task posted to its
+// SequencedTaskRunner, to let other tasks run.
+#define TASK_COROUTINE_YIELD()            \
+  do {                                    \
+    this->WillYieldForMacros(__LINE__);   \
+    return;                               \
+    case __LINE__:;                       \
+  } while (false)
+
+// Ends the body of a TaskCoroutine's Run() method.
+#define TASK_COROUTINE_END() }
+
+#endif  // BASE_TASK_TASK_COROUTINE_H_
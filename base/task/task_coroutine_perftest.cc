@@ -0,0 +1,202 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/single_thread_task_runner.h"
+#include "base/task/task_coroutine.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Number of steps in a chain.
+const int kNumSteps = 200 * 1000;
+
+// Returned by FakeAsyncOperation::Start() when it completes asynchronously.
+const int kPending = -1;
+
+// Operation which completes asynchronously once every |async_period| starts and
+// synchronously otherwise, like net/ APIs which return ERR_IO_PENDING. When
+// asynchronous, it runs its completion callback in a posted task. The posted
+// closure is bound once so that the operation itself doesn't allocate a
+// BindState per step; only the caller's completion callback differs between the
+// two implementations below.
+class FakeAsyncOperation {
+ public:
+  explicit FakeAsyncOperation(int async_period)
+      : async_period_(async_period),
+        complete_closure_(
+            Bind(&FakeAsyncOperation::Complete, Unretained(this))) {}
+
+  // Returns 1 or |kPending|.
+  int Start(const Callback<void(int)>& callback) {
+    DCHECK(callback_.is_null());
+    if (++num_starts_ % async_period_)
+      return 1;
+    callback_ = callback;
+    ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE, complete_closure_);
+    return kPending;
+  }
+
+ private:
+  void Complete() {
+    Callback<void(int)> callback = callback_;
+    callback_.Reset();
+    callback.Run(1);
+  }
+
+  const int async_period_;
+  const Closure complete_closure_;
+  Callback<void(int)> callback_;
+  int num_starts_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeAsyncOperation);
+};
+
+// Chain of steps written as a DoLoop state machine which binds a completion
+// callback at every step, the pattern used throughout net/ and storage/.
+class DoLoopChain {
+ public:
+  DoLoopChain(int async_period, const Closure& on_done)
+      : operation_(async_period), on_done_(on_done), weak_factory_(this) {}
+
+  void Start() { DoLoop(1); }
+
+  int sum() const { return sum_; }
+
+ private:
+  enum State {
+    STATE_NONE,
+    STATE_START_OPERATION,
+    STATE_START_OPERATION_COMPLETE,
+  };
+
+  void OnIOComplete(int result) { DoLoop(result); }
+
+  void DoLoop(int result) {
+    int rv = result;
+    do {
+      State state = next_state_;
+      next_state_ = STATE_NONE;
+      switch (state) {
+        case STATE_START_OPERATION:
+          rv = DoStartOperation();
+          break;
+        case STATE_START_OPERATION_COMPLETE:
+          rv = DoStartOperationComplete(rv);
+          break;
+        default:
+          NOTREACHED();
+          break;
+      }
+    } while (rv != kPending && next_state_ != STATE_NONE);
+
+    if (rv != kPending)
+      on_done_.Run();
+  }
+
+  int DoStartOperation() {
+    next_state_ = STATE_START_OPERATION_COMPLETE;
+    return operation_.Start(
+        Bind(&DoLoopChain::OnIOComplete, weak_factory_.GetWeakPtr()));
+  }
+
+  int DoStartOperationComplete(int result) {
+    sum_ += result;
+    if (++num_steps_ < kNumSteps)
+      next_state_ = STATE_START_OPERATION;
+    return 0;
+  }
+
+  State next_state_ = STATE_START_OPERATION;
+  FakeAsyncOperation operation_;
+  const Closure on_done_;
+  int num_steps_ = 0;
+  int sum_ = 0;
+
+  WeakPtrFactory<DoLoopChain> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DoLoopChain);
+};
+
+// The same chain of steps written as a TaskCoroutine.
+class CoroutineChain : public TaskCoroutine {
+ public:
+  CoroutineChain(int async_period, const Closure& on_done)
+      : TaskCoroutine(ThreadTaskRunnerHandle::Get()),
+        operation_(async_period),
+        on_done_(on_done) {}
+
+  int sum() const { return sum_; }
+
+ private:
+  void Run() override {
+    TASK_COROUTINE_BEGIN();
+    for (num_steps_ = 0; num_steps_ < kNumSteps; ++num_steps_) {
+      TASK_COROUTINE_AWAIT_RESULT(operation_.Start(resume_callback()),
+                                  kPending);
+      sum_ += result();
+    }
+    on_done_.Run();
+    TASK_COROUTINE_END();
+  }
+
+  FakeAsyncOperation operation_;
+  const Closure on_done_;
+  int num_steps_ = 0;
+  int sum_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CoroutineChain);
+};
+
+template <typename Chain>
+void RunChain(int async_period, const std::string& trace) {
+  MessageLoop message_loop;
+  RunLoop run_loop;
+  Chain chain(async_period, run_loop.QuitClosure());
+
+  const TimeTicks start = TimeTicks::Now();
+  chain.Start();
+  run_loop.Run();
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_EQ(kNumSteps, chain.sum());
+  perf_test::PrintResult("step", async_period == 1 ? "_async" : "_mostly_sync",
+                         trace,
+                         elapsed.InMillisecondsF() * 1000000 / kNumSteps,
+                         "ns/step", true);
+}
+
+}  // namespace
+
+TEST(TaskCoroutinePerfTest, AsyncDoLoopCallbacks) {
+  RunChain<DoLoopChain>(1, "do_loop_callbacks");
+}
+
+TEST(TaskCoroutinePerfTest, AsyncCoroutine) {
+  RunChain<CoroutineChain>(1, "task_coroutine");
+}
+
+// 1 in 8 steps completes asynchronously.
+TEST(TaskCoroutinePerfTest, MostlySyncDoLoopCallbacks) {
+  RunChain<DoLoopChain>(8, "do_loop_callbacks");
+}
+
+TEST(TaskCoroutinePerfTest, MostlySyncCoroutine) {
+  RunChain<CoroutineChain>(8, "task_coroutine");
+}
+
+}  // namespace base
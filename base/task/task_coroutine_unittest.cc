@@ -0,0 +1,246 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/task_coroutine.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/sequenced_task_runner.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kPending = -1;
+
+// Asynchronous operation which runs its completion callback with a result in a
+// posted task, or synchronously when |synchronous| is true.
+class FakeOperation {
+ public:
+  FakeOperation() = default;
+
+  void Start(int result,
+             bool synchronous,
+             const Callback<void(int)>& callback) {
+    if (synchronous) {
+      callback.Run(result);
+      return;
+    }
+    ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE, Bind(callback, result));
+  }
+
+  // Returns |result| synchronously or returns |kPending| and runs |callback|
+  // with |result| in a posted task.
+  int StartWithResult(int result,
+                      bool synchronous,
+                      const Callback<void(int)>& callback) {
+    if (synchronous)
+      return result;
+    ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE, Bind(callback, result));
+    return kPending;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FakeOperation);
+};
+
+// Awaits FakeOperation 3 times, alternating asynchronous and synchronous
+// completions, and records the results.
+class AwaitingCoroutine : public TaskCoroutine {
+ public:
+  AwaitingCoroutine(bool first_synchronous, const Closure& on_done)
+      : TaskCoroutine(ThreadTaskRunnerHandle::Get()),
+        first_synchronous_(first_synchronous),
+        on_done_(on_done) {}
+
+  const std::vector<int>& results() const { return results_; }
+  int num_runs() const { return num_runs_; }
+
+ private:
+  void Run() override {
+    ++num_runs_;
+    TASK_COROUTINE_BEGIN();
+    TASK_COROUTINE_AWAIT(
+        operation_.Start(1, first_synchronous_, resume_callback()));
+    results_.push_back(result());
+    TASK_COROUTINE_AWAIT(
+        operation_.Start(2, !first_synchronous_, resume_callback()));
+    results_.push_back(result());
+    TASK_COROUTINE_AWAIT_RESULT(
+        operation_.StartWithResult(3, first_synchronous_, resume_callback()),
+        kPending);
+    results_.push_back(result());
+    on_done_.Run();
+    TASK_COROUTINE_END();
+  }
+
+  FakeOperation operation_;
+  const bool first_synchronous_;
+  const Closure on_done_;
+  std::vector<int> results_;
+  int num_runs_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(AwaitingCoroutine);
+};
+
+// Yields |num_yields| times and records its progress in |steps|.
+class YieldingCoroutine : public TaskCoroutine {
+ public:
+  YieldingCoroutine(int num_yields, std::vector<int>* steps)
+      : TaskCoroutine(ThreadTaskRunnerHandle::Get()),
+        num_yields_(num_yields),
+        steps_(steps) {}
+
+ private:
+  void Run() override {
+    TASK_COROUTINE_BEGIN();
+    for (i_ = 0; i_ < num_yields_; ++i_) {
+      steps_->push_back(i_);
+      TASK_COROUTINE_YIELD();
+    }
+    TASK_COROUTINE_END();
+  }
+
+  const int num_yields_;
+  std::vector<int>* const steps_;
+  int i_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(YieldingCoroutine);
+};
+
+// Awaits a callback stored in |pending_callback| and deletes itself when
+// resumed with a non-zero result.
+class SelfDeletingCoroutine : public TaskCoroutine {
+ public:
+  SelfDeletingCoroutine(Callback<void(int)>* pending_callback, bool* deleted)
+      : TaskCoroutine(ThreadTaskRunnerHandle::Get()),
+        pending_callback_(pending_callback),
+        deleted_(deleted) {}
+  ~SelfDeletingCoroutine() override { *deleted_ = true; }
+
+ private:
+  void Run() override {
+    TASK_COROUTINE_BEGIN();
+    TASK_COROUTINE_AWAIT(*pending_callback_ = resume_callback());
+    if (result()) {
+      delete this;
+      return;
+    }
+    TASK_COROUTINE_END();
+  }
+
+  Callback<void(int)>* const pending_callback_;
+  bool* const deleted_;
+
+  DISALLOW_COPY_AND_ASSIGN(SelfDeletingCoroutine);
+};
+
+void AppendValue(std::vector<int>* values, int value) {
+  values->push_back(value);
+}
+
+}  // namespace
+
+TEST(TaskCoroutineTest, AwaitAsynchronousFirst) {
+  MessageLoop message_loop;
+  RunLoop run_loop;
+  AwaitingCoroutine coroutine(false, run_loop.QuitClosure());
+  coroutine.Start();
+  EXPECT_EQ(0, coroutine.num_runs());
+  EXPECT_FALSE(coroutine.is_done());
+  run_loop.Run();
+
+  EXPECT_TRUE(coroutine.is_done());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), coroutine.results());
+  // Start, the first completion and the last completion enter Run(). The second
+  // completion is synchronous.
+  EXPECT_EQ(3, coroutine.num_runs());
+}
+
+TEST(TaskCoroutineTest, AwaitSynchronousFirst) {
+  MessageLoop message_loop;
+  RunLoop run_loop;
+  AwaitingCoroutine coroutine(true, run_loop.QuitClosure());
+  coroutine.Start();
+  run_loop.Run();
+
+  EXPECT_TRUE(coroutine.is_done());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), coroutine.results());
+  // Start and the second completion enter Run().
+  EXPECT_EQ(2, coroutine.num_runs());
+}
+
+TEST(TaskCoroutineTest, YieldLetsOtherTasksRun) {
+  MessageLoop message_loop;
+  std::vector<int> steps;
+  YieldingCoroutine coroutine(3, &steps);
+  coroutine.Start();
+
+  // The first step runs in the task posted by Start(). Its yield posts a task
+  // after the tasks below.
+  ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                          Bind(&AppendValue, &steps, 10));
+  ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                          Bind(&AppendValue, &steps, 11));
+  RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(coroutine.is_done());
+  EXPECT_EQ((std::vector<int>{0, 10, 11, 1, 2}), steps);
+}
+
+TEST(TaskCoroutineTest, DeleteFromRun) {
+  MessageLoop message_loop;
+  Callback<void(int)> pending_callback;
+  bool deleted = false;
+  SelfDeletingCoroutine* coroutine =
+      new SelfDeletingCoroutine(&pending_callback, &deleted);
+  coroutine->Start();
+  RunLoop().RunUntilIdle();
+  ASSERT_FALSE(pending_callback.is_null());
+  EXPECT_FALSE(coroutine->is_done());
+
+  // Resuming with a non-zero result deletes the coroutine from Run().
+  pending_callback.Run(1);
+  EXPECT_TRUE(deleted);
+}
+
+TEST(TaskCoroutineTest, DeleteWhileAwaiting) {
+  MessageLoop message_loop;
+  Callback<void(int)> pending_callback;
+  bool deleted = false;
+  std::unique_ptr<SelfDeletingCoroutine> coroutine(
+      new SelfDeletingCoroutine(&pending_callback, &deleted));
+  coroutine->Start();
+  RunLoop().RunUntilIdle();
+  ASSERT_FALSE(pending_callback.is_null());
+
+  coroutine.reset();
+  EXPECT_TRUE(deleted);
+
+  // The resume callback does nothing once the coroutine is deleted.
+  pending_callback.Run(0);
+}
+
+TEST(TaskCoroutineTest, DeleteBeforeStart) {
+  MessageLoop message_loop;
+  std::vector<int> steps;
+  std::unique_ptr<YieldingCoroutine> coroutine(
+      new YieldingCoroutine(1, &steps));
+  coroutine->Start();
+  coroutine.reset();
+  RunLoop().RunUntilIdle();
+  EXPECT_TRUE(steps.empty());
+}
+
+}  // namespace base
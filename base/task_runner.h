@@ -7,6 +7,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/callback_forward.h"
 #include "base/location.h"
@@ -73,6 +75,16 @@ class BASE_EXPORT TaskRunner
                                const Closure& task,
                                base::TimeDelta delay) = 0;
 
+  // Posts all of |tasks| to be run, in order, as if by calling PostTask() for
+  // each of them. Returns true if all tasks may be run at some point in the
+  // future, and false if at least one task definitely will not be run.
+  //
+  // The default implementation calls PostTask() once per task. Implementations
+  // for which posting a task has a fixed cost (e.g. taking a lock or waking up
+  // a thread) should override this to pay that cost once per batch.
+  virtual bool PostTasks(const tracked_objects::Location& from_here,
+                         const std::vector<Closure>& tasks);
+
   // Returns true if the current thread is a thread on which a task
   // may be run, and false if no task will be run on the current
   // thread.
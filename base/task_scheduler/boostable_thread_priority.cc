@@ -0,0 +1,117 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task_scheduler/boostable_thread_priority.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/threading/thread_local.h"
+#include "build/build_config.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// BoostableThreadPriority bound to the current thread.
+LazyInstance<ThreadLocalPointer<BoostableThreadPriority>>::Leaky
+    tls_current_boostable_thread_priority = LAZY_INSTANCE_INITIALIZER;
+
+// Set to false once changing the priority of another thread failed. Such a
+// failure means that the process isn't allowed to raise priorities, which
+// won't change, so there is no point in making more system calls.
+std::atomic<bool> g_can_boost(true);
+
+}  // namespace
+
+BoostableThreadPriority::BoostableThreadPriority(ThreadPriority base_priority)
+    : base_priority_(base_priority),
+      current_priority_(static_cast<int>(base_priority)) {}
+
+BoostableThreadPriority::~BoostableThreadPriority() {
+  AutoLock auto_lock(lock_);
+  DCHECK_EQ(kInvalidThreadId, thread_id_);
+}
+
+void BoostableThreadPriority::BindToCurrentThread() {
+  DCHECK(!tls_current_boostable_thread_priority.Get().Get());
+  tls_current_boostable_thread_priority.Get().Set(this);
+
+  AutoLock auto_lock(lock_);
+  DCHECK_EQ(kInvalidThreadId, thread_id_);
+  DCHECK(base_priority_ == current_priority());
+  thread_id_ = PlatformThread::CurrentId();
+}
+
+void BoostableThreadPriority::UnbindFromCurrentThread() {
+  DCHECK_EQ(this, tls_current_boostable_thread_priority.Get().Get());
+  {
+    AutoLock auto_lock(lock_);
+    // Resetting the boost with |lock_| held guarantees that no Boost() which
+    // raced with this is left behind, since Boost() is a no-op once
+    // |thread_id_| is reset.
+    ResetBoostLockRequired();
+    thread_id_ = kInvalidThreadId;
+  }
+  tls_current_boostable_thread_priority.Get().Set(nullptr);
+}
+
+// static
+BoostableThreadPriority* BoostableThreadPriority::GetForCurrentThread() {
+  return tls_current_boostable_thread_priority.Get().Get();
+}
+
+void BoostableThreadPriority::Boost(ThreadPriority priority) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  if (priority <= current_priority() ||
+      !g_can_boost.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  AutoLock auto_lock(lock_);
+  // Holding |lock_| guarantees that the bound thread, if any, doesn't exit or
+  // reset its priority while its priority is being changed.
+  if (thread_id_ == kInvalidThreadId || priority <= current_priority())
+    return;
+  if (!PlatformThread::SetThreadPriority(thread_id_, priority)) {
+    g_can_boost.store(false, std::memory_order_relaxed);
+    return;
+  }
+  current_priority_.store(static_cast<int>(priority),
+                          std::memory_order_relaxed);
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+}
+
+// static
+void BoostableThreadPriority::BoostToCurrentThreadPriority(
+    BoostableThreadPriority* target) {
+  if (!target || !g_can_boost.load(std::memory_order_relaxed))
+    return;
+
+  // Scheduler threads know their priority. Other threads have to ask the OS.
+  const BoostableThreadPriority* current = GetForCurrentThread();
+  target->Boost(current ? current->current_priority()
+                        : PlatformThread::GetCurrentThreadPriority());
+}
+
+void BoostableThreadPriority::ResetBoost() {
+  if (current_priority() == base_priority_)
+    return;
+
+  AutoLock auto_lock(lock_);
+  ResetBoostLockRequired();
+}
+
+void BoostableThreadPriority::ResetBoostLockRequired() {
+  lock_.AssertAcquired();
+  DCHECK_EQ(PlatformThread::CurrentId(), thread_id_);
+  if (current_priority() == base_priority_)
+    return;
+  PlatformThread::SetCurrentThreadPriority(base_priority_);
+  current_priority_.store(static_cast<int>(base_priority_),
+                          std::memory_order_relaxed);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,93 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SCHEDULER_BOOSTABLE_THREAD_PRIORITY_H_
+#define BASE_TASK_SCHEDULER_BOOSTABLE_THREAD_PRIORITY_H_
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+
+namespace base {
+namespace internal {
+
+// The priority of a scheduler thread, which threads waiting for it can
+// temporarily raise to their own priority. This undoes priority inversions,
+// where a high priority thread waits for a low priority thread which doesn't
+// get to run because threads of intermediate priority keep the CPUs busy.
+//
+// Boosting is best-effort. It only has an effect on platforms where a thread
+// can change the priority of another thread (Linux and Android), and only if
+// the process has the permission to raise priorities. After a boost failed,
+// Boost() is a no-op for the rest of the process' lifetime.
+//
+// This class is thread-safe.
+class BASE_EXPORT BoostableThreadPriority {
+ public:
+  // |base_priority| is the priority at which the bound thread normally runs.
+  explicit BoostableThreadPriority(ThreadPriority base_priority);
+
+  // No thread can be bound when this is destroyed.
+  ~BoostableThreadPriority();
+
+  // Binds the current thread, which must run at the base priority, to this
+  // BoostableThreadPriority. No other thread can be bound.
+  void BindToCurrentThread();
+
+  // Resets the boost of the current thread and unbinds it. Must be called by
+  // the bound thread before it exits.
+  void UnbindFromCurrentThread();
+
+  // Returns the BoostableThreadPriority bound to the current thread, or nullptr
+  // if there is none.
+  static BoostableThreadPriority* GetForCurrentThread();
+
+  // Raises the priority of the bound thread to |priority| until the next call
+  // to ResetBoost(), if it currently runs at a lower priority. No-op if no
+  // thread is bound.
+  void Boost(ThreadPriority priority);
+
+  // Boosts |target| to the priority of the current thread. No-op if |target|
+  // is nullptr.
+  static void BoostToCurrentThreadPriority(BoostableThreadPriority* target);
+
+  // Restores the base priority of the bound thread. Must be called by the
+  // bound thread. A Boost() concurrent with this may or may not be undone.
+  void ResetBoost();
+
+  ThreadPriority base_priority() const { return base_priority_; }
+
+  // Returns the priority of the bound thread, including its boost.
+  ThreadPriority current_priority() const {
+    return static_cast<ThreadPriority>(
+        current_priority_.load(std::memory_order_relaxed));
+  }
+
+ private:
+  // Restores the base priority of the bound thread, which must be the current
+  // thread. |lock_| must be held.
+  void ResetBoostLockRequired();
+
+  const ThreadPriority base_priority_;
+
+  // Synchronizes access to |thread_id_| and changes of the priority of the
+  // bound thread.
+  Lock lock_;
+
+  // Id of the bound thread. kInvalidThreadId if there is none.
+  PlatformThreadId thread_id_ = kInvalidThreadId;
+
+  // Priority of the bound thread. Only modified with |lock_| held.
+  std::atomic<int> current_priority_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoostableThreadPriority);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_SCHEDULER_BOOSTABLE_THREAD_PRIORITY_H_
@@ -0,0 +1,271 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task_scheduler/boostable_thread_priority.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task_scheduler/scheduler_lock.h"
+#include "base/task_scheduler/sequence.h"
+#include "base/task_scheduler/task.h"
+#include "base/task_scheduler/task_traits.h"
+#include "base/test/test_timeouts.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
+
+namespace base {
+namespace internal {
+
+namespace {
+
+bool IsBoostingAllowed() {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Only root can raise thread priority on POSIX environment. On Linux, users
+  // who have CAP_SYS_NICE permission also can raise the thread priority, but
+  // libcap.so would be needed to check the capability.
+  return geteuid() == 0;
+#else
+  // Other platforms don't support boosting.
+  return false;
+#endif
+}
+
+// Waits until the priority of |priority|'s bound thread is at least
+// |expected_priority|. Gives up after the action timeout.
+void WaitForBoost(const BoostableThreadPriority* priority,
+                  ThreadPriority expected_priority) {
+  const TimeTicks deadline = TimeTicks::Now() + TestTimeouts::action_timeout();
+  while (priority->current_priority() < expected_priority &&
+         TimeTicks::Now() < deadline) {
+    PlatformThread::Sleep(TimeDelta::FromMilliseconds(1));
+  }
+}
+
+// A thread which runs at the base priority of a BoostableThreadPriority and is
+// bound to it. The thread calls OnBound() and waits until ResetBoostAndExit()
+// is called. It then calls OnExit() and resets its boost.
+class BoundThread : public SimpleThread {
+ public:
+  explicit BoundThread(BoostableThreadPriority* priority)
+      : SimpleThread("BoundThread"),
+        priority_(priority),
+        on_bound_done_(WaitableEvent::ResetPolicy::MANUAL,
+                       WaitableEvent::InitialState::NOT_SIGNALED),
+        should_exit_(WaitableEvent::ResetPolicy::MANUAL,
+                     WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void WaitForOnBoundDone() { on_bound_done_.Wait(); }
+
+  // Resets the boost of the thread and joins it.
+  void ResetBoostAndExit() {
+    should_exit_.Signal();
+    Join();
+  }
+
+  // Priorities of the thread, as reported by the OS, before and after it reset
+  // its boost.
+  ThreadPriority priority_before_reset() const {
+    return priority_before_reset_;
+  }
+  ThreadPriority priority_after_reset() const { return priority_after_reset_; }
+
+ protected:
+  virtual void OnBound() {}
+  virtual void OnExit() {}
+
+  BoostableThreadPriority* const priority_;
+
+ private:
+  void Run() override {
+    PlatformThread::SetCurrentThreadPriority(priority_->base_priority());
+    EXPECT_FALSE(BoostableThreadPriority::GetForCurrentThread());
+    priority_->BindToCurrentThread();
+    EXPECT_EQ(priority_, BoostableThreadPriority::GetForCurrentThread());
+
+    OnBound();
+    on_bound_done_.Signal();
+
+    should_exit_.Wait();
+    OnExit();
+    priority_before_reset_ = PlatformThread::GetCurrentThreadPriority();
+    priority_->ResetBoost();
+    priority_after_reset_ = PlatformThread::GetCurrentThreadPriority();
+    EXPECT_TRUE(priority_->base_priority() == priority_->current_priority());
+
+    priority_->UnbindFromCurrentThread();
+    EXPECT_FALSE(BoostableThreadPriority::GetForCurrentThread());
+  }
+
+  WaitableEvent on_bound_done_;
+  WaitableEvent should_exit_;
+  ThreadPriority priority_before_reset_ = ThreadPriority::NORMAL;
+  ThreadPriority priority_after_reset_ = ThreadPriority::NORMAL;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundThread);
+};
+
+// A BoundThread which holds |lock| until its priority is boosted.
+class LockHoldingThread : public BoundThread {
+ public:
+  LockHoldingThread(BoostableThreadPriority* priority, SchedulerLock* lock)
+      : BoundThread(priority),
+        lock_(lock),
+        lock_acquired_(WaitableEvent::ResetPolicy::MANUAL,
+                       WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void WaitForLockAcquisition() { lock_acquired_.Wait(); }
+
+ private:
+  void OnBound() override {
+    lock_->Acquire();
+    lock_acquired_.Signal();
+    WaitForBoost(priority_, ThreadPriority::NORMAL);
+    lock_->Release();
+  }
+
+  SchedulerLock* const lock_;
+  WaitableEvent lock_acquired_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockHoldingThread);
+};
+
+// A BoundThread which runs the first task of |sequence| until it exits.
+class SequenceRunningThread : public BoundThread {
+ public:
+  SequenceRunningThread(BoostableThreadPriority* priority,
+                        scoped_refptr<Sequence> sequence)
+      : BoundThread(priority), sequence_(std::move(sequence)) {}
+
+ private:
+  void OnBound() override { sequence_->BeginTask(); }
+  void OnExit() override { sequence_->PopTask(); }
+
+  scoped_refptr<Sequence> sequence_;
+
+  DISALLOW_COPY_AND_ASSIGN(SequenceRunningThread);
+};
+
+std::unique_ptr<Task> CreateTask(TaskPriority priority) {
+  return WrapUnique(new Task(FROM_HERE, Bind(&DoNothing),
+                             TaskTraits().WithPriority(priority),
+                             TimeDelta()));
+}
+
+}  // namespace
+
+TEST(TaskSchedulerBoostableThreadPriorityTest, BindAndUnbind) {
+  EXPECT_FALSE(BoostableThreadPriority::GetForCurrentThread());
+
+  BoostableThreadPriority priority(ThreadPriority::NORMAL);
+  BoundThread thread(&priority);
+  thread.Start();
+  thread.WaitForOnBoundDone();
+  thread.ResetBoostAndExit();
+
+  EXPECT_FALSE(BoostableThreadPriority::GetForCurrentThread());
+}
+
+TEST(TaskSchedulerBoostableThreadPriorityTest, BoostUnbound) {
+  BoostableThreadPriority priority(ThreadPriority::BACKGROUND);
+  priority.Boost(ThreadPriority::NORMAL);
+  EXPECT_EQ(ThreadPriority::BACKGROUND, priority.current_priority());
+}
+
+TEST(TaskSchedulerBoostableThreadPriorityTest, BoostToLowerPriority) {
+  BoostableThreadPriority priority(ThreadPriority::NORMAL);
+  BoundThread thread(&priority);
+  thread.Start();
+  thread.WaitForOnBoundDone();
+
+  priority.Boost(ThreadPriority::BACKGROUND);
+  EXPECT_EQ(ThreadPriority::NORMAL, priority.current_priority());
+
+  thread.ResetBoostAndExit();
+  EXPECT_EQ(ThreadPriority::NORMAL, thread.priority_before_reset());
+  EXPECT_EQ(ThreadPriority::NORMAL, thread.priority_after_reset());
+}
+
+TEST(TaskSchedulerBoostableThreadPriorityTest, Boost) {
+  if (!IsBoostingAllowed())
+    return;
+
+  BoostableThreadPriority priority(ThreadPriority::BACKGROUND);
+  BoundThread thread(&priority);
+  thread.Start();
+  thread.WaitForOnBoundDone();
+
+  priority.Boost(ThreadPriority::NORMAL);
+  EXPECT_EQ(ThreadPriority::NORMAL, priority.current_priority());
+
+  thread.ResetBoostAndExit();
+  EXPECT_EQ(ThreadPriority::NORMAL, thread.priority_before_reset());
+  EXPECT_EQ(ThreadPriority::BACKGROUND, thread.priority_after_reset());
+}
+
+// Verify that a thread waiting for a SchedulerLock boosts the holder of the
+// lock to its own priority.
+TEST(TaskSchedulerBoostableThreadPriorityTest, SchedulerLockBoostsHolder) {
+  if (!IsBoostingAllowed())
+    return;
+  ASSERT_EQ(ThreadPriority::NORMAL, PlatformThread::GetCurrentThreadPriority());
+
+  SchedulerLock lock;
+  BoostableThreadPriority priority(ThreadPriority::BACKGROUND);
+  LockHoldingThread thread(&priority, &lock);
+  thread.Start();
+  thread.WaitForLockAcquisition();
+
+  // The holder only releases |lock| once it is boosted.
+  lock.Acquire();
+  EXPECT_EQ(ThreadPriority::NORMAL, priority.current_priority());
+  lock.Release();
+
+  thread.ResetBoostAndExit();
+  EXPECT_EQ(ThreadPriority::NORMAL, thread.priority_before_reset());
+  EXPECT_EQ(ThreadPriority::BACKGROUND, thread.priority_after_reset());
+}
+
+// Verify that pushing a task in a Sequence boosts the thread running a task
+// from the Sequence to the priority of the pushed task.
+TEST(TaskSchedulerBoostableThreadPriorityTest, SequenceBoostsRunningThread) {
+  if (!IsBoostingAllowed())
+    return;
+
+  scoped_refptr<Sequence> sequence(new Sequence);
+  sequence->PushTask(CreateTask(TaskPriority::BACKGROUND));
+
+  BoostableThreadPriority priority(ThreadPriority::BACKGROUND);
+  SequenceRunningThread thread(&priority, sequence);
+  thread.Start();
+  thread.WaitForOnBoundDone();
+
+  // A BACKGROUND task doesn't need a boost.
+  sequence->PushTask(CreateTask(TaskPriority::BACKGROUND));
+  EXPECT_EQ(ThreadPriority::BACKGROUND, priority.current_priority());
+
+  // A USER_BLOCKING task does.
+  sequence->PushTask(CreateTask(TaskPriority::USER_BLOCKING));
+  EXPECT_EQ(ThreadPriority::NORMAL, priority.current_priority());
+
+  thread.ResetBoostAndExit();
+  EXPECT_EQ(ThreadPriority::NORMAL, thread.priority_before_reset());
+  EXPECT_EQ(ThreadPriority::BACKGROUND, thread.priority_after_reset());
+}
+
+}  // namespace internal
+}  // namespace base
@@ -5,6 +5,7 @@
 #include "base/task_scheduler/delayed_task_manager.h"
 
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/task_scheduler/scheduler_thread_pool.h"
@@ -16,13 +17,11 @@ struct DelayedTaskManager::DelayedTask {
   DelayedTask(std::unique_ptr<Task> task,
               scoped_refptr<Sequence> sequence,
               SchedulerWorkerThread* worker_thread,
-              SchedulerThreadPool* thread_pool,
-              uint64_t index)
+              SchedulerThreadPool* thread_pool)
       : task(std::move(task)),
         sequence(std::move(sequence)),
         worker_thread(worker_thread),
-        thread_pool(thread_pool),
-        index(index) {}
+        thread_pool(thread_pool) {}
 
   DelayedTask(DelayedTask&& other) = default;
 
@@ -37,10 +36,6 @@ struct DelayedTaskManager::DelayedTask {
   SchedulerWorkerThread* worker_thread;
   SchedulerThreadPool* thread_pool;
 
-  // Ensures that tasks that have the same |delayed_run_time| are sorted
-  // according to the order in which they were added to the DelayedTaskManager.
-  uint64_t index;
-
  private:
   DISALLOW_COPY_AND_ASSIGN(DelayedTask);
 };
@@ -68,10 +63,11 @@ void DelayedTaskManager::AddDelayedTask(std::unique_ptr<Task> task,
     AutoSchedulerLock auto_lock(lock_);
 
     if (!delayed_tasks_.empty())
-      current_delayed_run_time = delayed_tasks_.top().task->delayed_run_time;
+      current_delayed_run_time = delayed_tasks_.TopDeadline();
 
-    delayed_tasks_.emplace(std::move(task), std::move(sequence), worker_thread,
-                           thread_pool, ++delayed_task_index_);
+    delayed_tasks_.Push(new_task_delayed_run_time,
+                        DelayedTask(std::move(task), std::move(sequence),
+                                    worker_thread, thread_pool));
   }
 
   if (current_delayed_run_time.is_null() ||
@@ -91,13 +87,8 @@ void DelayedTaskManager::PostReadyTasks() {
   {
     AutoSchedulerLock auto_lock(lock_);
     while (!delayed_tasks_.empty() &&
-           delayed_tasks_.top().task->delayed_run_time <= now) {
-      // The const_cast for std::move is okay since we're immediately popping
-      // the task from |delayed_tasks_|. See DelayedTaskComparator::operator()
-      // for minor debug-check implications.
-      ready_tasks.push_back(
-          std::move(const_cast<DelayedTask&>(delayed_tasks_.top())));
-      delayed_tasks_.pop();
+           delayed_tasks_.TopDeadline() <= now) {
+      ready_tasks.push_back(delayed_tasks_.Pop());
     }
   }
 
@@ -115,34 +106,7 @@ TimeTicks DelayedTaskManager::GetDelayedRunTime() const {
   if (delayed_tasks_.empty())
     return TimeTicks();
 
-  return delayed_tasks_.top().task->delayed_run_time;
-}
-
-// In std::priority_queue, the largest element is on top. Therefore, this
-// comparator returns true if the delayed run time of |right| is earlier than
-// the delayed run time of |left|.
-bool DelayedTaskManager::DelayedTaskComparator::operator()(
-    const DelayedTask& left,
-    const DelayedTask& right) const {
-#ifndef NDEBUG
-  // Due to STL consistency checks in Windows and const_cast'ing right before
-  // popping the DelayedTask, a null task can be passed to this comparator in
-  // Debug builds. To satisfy these consistency checks, this comparator
-  // considers null tasks to be the larger than anything.
-  DCHECK(left.task || right.task);
-  if (!left.task)
-    return false;
-  if (!right.task)
-    return true;
-#else
-  DCHECK(left.task);
-  DCHECK(right.task);
-#endif  // NDEBUG
-  if (left.task->delayed_run_time > right.task->delayed_run_time)
-    return true;
-  if (left.task->delayed_run_time < right.task->delayed_run_time)
-    return false;
-  return left.index > right.index;
+  return delayed_tasks_.TopDeadline();
 }
 
 TimeTicks DelayedTaskManager::Now() const {
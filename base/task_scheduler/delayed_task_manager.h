@@ -5,14 +5,11 @@
 #ifndef BASE_TASK_SCHEDULER_DELAYED_TASK_MANAGER_H_
 #define BASE_TASK_SCHEDULER_DELAYED_TASK_MANAGER_H_
 
-#include <stdint.h>
-
 #include <memory>
-#include <queue>
-#include <vector>
 
 #include "base/base_export.h"
 #include "base/callback.h"
+#include "base/containers/timer_wheel.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/task_scheduler/scheduler_lock.h"
@@ -61,24 +58,17 @@ class BASE_EXPORT DelayedTaskManager {
 
  private:
   struct DelayedTask;
-  struct DelayedTaskComparator {
-    bool operator()(const DelayedTask& left, const DelayedTask& right) const;
-  };
 
   const Closure on_delayed_run_time_updated_;
 
   // Synchronizes access to all members below.
   mutable SchedulerLock lock_;
 
-  // Priority queue of delayed tasks. The delayed task with the smallest
-  // |task->delayed_run_time| is in front of the priority queue.
-  using DelayedTaskQueue = std::priority_queue<DelayedTask,
-                                               std::vector<DelayedTask>,
-                                               DelayedTaskComparator>;
-  DelayedTaskQueue delayed_tasks_;
-
-  // The index to assign to the next delayed task added to the manager.
-  uint64_t delayed_task_index_ = 0;
+  // Delayed tasks keyed by |task->delayed_run_time|. Tasks that have the same
+  // delayed run time are sorted according to the order in which they were
+  // added to the manager. A timer wheel keeps insertion cost constant when
+  // many delayed tasks are pending.
+  TimerWheel<DelayedTask> delayed_tasks_;
 
   DISALLOW_COPY_AND_ASSIGN(DelayedTaskManager);
 };
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
@@ -71,6 +72,12 @@ class MockSchedulerThreadPool : public SchedulerThreadPool {
     PostTaskWithSequenceNowMock(task.get(), sequence.get(), worker_thread);
   }
 
+  bool PostTasksWithOneOffSequences(
+      std::vector<std::unique_ptr<Task>> tasks) override {
+    NOTREACHED();
+    return true;
+  }
+
   MOCK_METHOD3(PostTaskWithSequenceNowMock,
                void(const Task*,
                     const Sequence*,
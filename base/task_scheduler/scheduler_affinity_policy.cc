@@ -0,0 +1,74 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task_scheduler/scheduler_affinity_policy.h"
+
+#include "base/logging.h"
+#include "base/sys_info.h"
+#include "build/build_config.h"
+
+namespace base {
+namespace internal {
+
+// static
+SchedulerAffinityPolicy SchedulerAffinityPolicy::None() {
+  return SchedulerAffinityPolicy(Type::NONE, std::vector<int>(), -1);
+}
+
+// static
+SchedulerAffinityPolicy SchedulerAffinityPolicy::Processors(
+    const std::vector<int>& processors) {
+  DCHECK(!processors.empty());
+  return SchedulerAffinityPolicy(Type::PROCESSORS, processors, -1);
+}
+
+// static
+SchedulerAffinityPolicy SchedulerAffinityPolicy::NumaNode(int numa_node) {
+  DCHECK_GE(numa_node, 0);
+  return SchedulerAffinityPolicy(Type::NUMA_NODE, std::vector<int>(),
+                                 numa_node);
+}
+
+// static
+SchedulerAffinityPolicy SchedulerAffinityPolicy::FastestProcessors() {
+  return SchedulerAffinityPolicy(Type::FASTEST_PROCESSORS, std::vector<int>(),
+                                 -1);
+}
+
+SchedulerAffinityPolicy::SchedulerAffinityPolicy(
+    const SchedulerAffinityPolicy& other) = default;
+
+SchedulerAffinityPolicy::~SchedulerAffinityPolicy() = default;
+
+std::vector<int> SchedulerAffinityPolicy::GetProcessors() const {
+  switch (type_) {
+    case Type::NONE:
+      return std::vector<int>();
+    case Type::PROCESSORS:
+      return processors_;
+    case Type::NUMA_NODE:
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+      return SysInfo::GetProcessorsOfNumaNode(numa_node_);
+#else
+      return std::vector<int>();
+#endif
+    case Type::FASTEST_PROCESSORS:
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+      return SysInfo::GetFastestProcessors();
+#else
+      return std::vector<int>();
+#endif
+  }
+  NOTREACHED();
+  return std::vector<int>();
+}
+
+SchedulerAffinityPolicy::SchedulerAffinityPolicy(
+    Type type,
+    const std::vector<int>& processors,
+    int numa_node)
+    : type_(type), processors_(processors), numa_node_(numa_node) {}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,73 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SCHEDULER_SCHEDULER_AFFINITY_POLICY_H_
+#define BASE_TASK_SCHEDULER_SCHEDULER_AFFINITY_POLICY_H_
+
+#include <vector>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace internal {
+
+// Describes the logical processors on which the worker threads of a thread
+// pool are allowed to run. Policies are only enforced on platforms that
+// support thread affinity (Linux and Android); elsewhere they have no effect.
+class BASE_EXPORT SchedulerAffinityPolicy {
+ public:
+  enum class Type {
+    // Worker threads can run on any processor.
+    NONE,
+    // Worker threads are pinned to an explicit set of processors.
+    PROCESSORS,
+    // Worker threads are pinned to the processors of a NUMA node.
+    NUMA_NODE,
+    // Worker threads are pinned to the processors with the highest maximum
+    // frequency (e.g. the big cores of a big.LITTLE system).
+    FASTEST_PROCESSORS,
+  };
+
+  // Returns a policy which doesn't restrict worker threads.
+  static SchedulerAffinityPolicy None();
+
+  // Returns a policy which pins worker threads to |processors|.
+  static SchedulerAffinityPolicy Processors(const std::vector<int>& processors);
+
+  // Returns a policy which pins worker threads to the processors of NUMA node
+  // |numa_node|.
+  static SchedulerAffinityPolicy NumaNode(int numa_node);
+
+  // Returns a policy which pins worker threads to the fastest processors.
+  static SchedulerAffinityPolicy FastestProcessors();
+
+  SchedulerAffinityPolicy(const SchedulerAffinityPolicy& other);
+  ~SchedulerAffinityPolicy();
+
+  Type type() const { return type_; }
+
+  // Returns the processors to which worker threads should be pinned on the
+  // current machine. An empty vector means that worker threads shouldn't be
+  // pinned, either because the policy is NONE or because the processors it
+  // designates couldn't be determined.
+  std::vector<int> GetProcessors() const;
+
+ private:
+  SchedulerAffinityPolicy(Type type,
+                          const std::vector<int>& processors,
+                          int numa_node);
+
+  Type type_;
+
+  // Processors of a PROCESSORS policy.
+  std::vector<int> processors_;
+
+  // NUMA node of a NUMA_NODE policy.
+  int numa_node_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_SCHEDULER_SCHEDULER_AFFINITY_POLICY_H_
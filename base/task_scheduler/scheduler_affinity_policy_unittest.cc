@@ -0,0 +1,57 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task_scheduler/scheduler_affinity_policy.h"
+
+#include <vector>
+
+#include "base/sys_info.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+TEST(TaskSchedulerAffinityPolicyTest, None) {
+  const SchedulerAffinityPolicy policy = SchedulerAffinityPolicy::None();
+  EXPECT_EQ(SchedulerAffinityPolicy::Type::NONE, policy.type());
+  EXPECT_TRUE(policy.GetProcessors().empty());
+}
+
+TEST(TaskSchedulerAffinityPolicyTest, Processors) {
+  const std::vector<int> processors = {0, 2};
+  const SchedulerAffinityPolicy policy =
+      SchedulerAffinityPolicy::Processors(processors);
+  EXPECT_EQ(SchedulerAffinityPolicy::Type::PROCESSORS, policy.type());
+  EXPECT_EQ(processors, policy.GetProcessors());
+
+  // A copy designates the same processors.
+  const SchedulerAffinityPolicy copy(policy);
+  EXPECT_EQ(SchedulerAffinityPolicy::Type::PROCESSORS, copy.type());
+  EXPECT_EQ(processors, copy.GetProcessors());
+}
+
+TEST(TaskSchedulerAffinityPolicyTest, NumaNode) {
+  const SchedulerAffinityPolicy policy = SchedulerAffinityPolicy::NumaNode(0);
+  EXPECT_EQ(SchedulerAffinityPolicy::Type::NUMA_NODE, policy.type());
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  EXPECT_EQ(SysInfo::GetProcessorsOfNumaNode(0), policy.GetProcessors());
+#else
+  EXPECT_TRUE(policy.GetProcessors().empty());
+#endif
+}
+
+TEST(TaskSchedulerAffinityPolicyTest, FastestProcessors) {
+  const SchedulerAffinityPolicy policy =
+      SchedulerAffinityPolicy::FastestProcessors();
+  EXPECT_EQ(SchedulerAffinityPolicy::Type::FASTEST_PROCESSORS, policy.type());
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  EXPECT_EQ(SysInfo::GetFastestProcessors(), policy.GetProcessors());
+#else
+  EXPECT_TRUE(policy.GetProcessors().empty());
+#endif
+}
+
+}  // namespace internal
+}  // namespace base
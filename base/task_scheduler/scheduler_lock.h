@@ -5,12 +5,14 @@
 #ifndef BASE_TASK_SCHEDULER_SCHEDULER_LOCK_H
 #define BASE_TASK_SCHEDULER_SCHEDULER_LOCK_H
 
+#include <atomic>
 #include <memory>
 
 #include "base/base_export.h"
 #include "base/macros.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/task_scheduler/boostable_thread_priority.h"
 #include "base/task_scheduler/scheduler_lock_impl.h"
 
 namespace base {
@@ -18,7 +20,10 @@ namespace internal {
 
 // SchedulerLock should be used anywhere a lock would be used in the scheduler.
 // When DCHECK_IS_ON(), lock checking occurs. Otherwise, SchedulerLock is
-// equivalent to base::Lock.
+// equivalent to base::Lock, except for priority boosting: a thread which finds
+// the lock held by a thread with a BoostableThreadPriority boosts the holder
+// to its own priority before waiting. A thread waiting on a ConditionVariable
+// created by the lock is still considered to be its holder.
 //
 // The shape of SchedulerLock is as follows:
 // SchedulerLock()
@@ -58,9 +63,28 @@ class SchedulerLock : public Lock {
   SchedulerLock() = default;
   explicit SchedulerLock(const SchedulerLock*) {}
 
+  void Acquire() {
+    if (!Try()) {
+      BoostableThreadPriority::BoostToCurrentThreadPriority(
+          holder_priority_.load(std::memory_order_relaxed));
+      Lock::Acquire();
+    }
+    holder_priority_.store(BoostableThreadPriority::GetForCurrentThread(),
+                           std::memory_order_relaxed);
+  }
+
+  void Release() {
+    holder_priority_.store(nullptr, std::memory_order_relaxed);
+    Lock::Release();
+  }
+
   std::unique_ptr<ConditionVariable> CreateConditionVariable() {
     return std::unique_ptr<ConditionVariable>(new ConditionVariable(this));
   }
+
+ private:
+  // BoostableThreadPriority of the thread holding the lock, if any.
+  std::atomic<BoostableThreadPriority*> holder_priority_{nullptr};
 };
 #endif  // DCHECK_IS_ON()
 
@@ -11,6 +11,7 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/synchronization/condition_variable.h"
+#include "base/task_scheduler/boostable_thread_priority.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_local_storage.h"
 
@@ -114,7 +115,8 @@ LazyInstance<SafeAcquisitionTracker>::Leaky g_safe_acquisition_tracker =
 
 SchedulerLockImpl::SchedulerLockImpl() : SchedulerLockImpl(nullptr) {}
 
-SchedulerLockImpl::SchedulerLockImpl(const SchedulerLockImpl* predecessor) {
+SchedulerLockImpl::SchedulerLockImpl(const SchedulerLockImpl* predecessor)
+    : holder_priority_(nullptr) {
   g_safe_acquisition_tracker.Get().RegisterLock(this, predecessor);
 }
 
@@ -123,11 +125,18 @@ SchedulerLockImpl::~SchedulerLockImpl() {
 }
 
 void SchedulerLockImpl::Acquire() {
-  lock_.Acquire();
+  if (!lock_.Try()) {
+    BoostableThreadPriority::BoostToCurrentThreadPriority(
+        holder_priority_.load(std::memory_order_relaxed));
+    lock_.Acquire();
+  }
+  holder_priority_.store(BoostableThreadPriority::GetForCurrentThread(),
+                         std::memory_order_relaxed);
   g_safe_acquisition_tracker.Get().RecordAcquisition(this);
 }
 
 void SchedulerLockImpl::Release() {
+  holder_priority_.store(nullptr, std::memory_order_relaxed);
   lock_.Release();
   g_safe_acquisition_tracker.Get().RecordRelease(this);
 }
@@ -5,6 +5,7 @@
 #ifndef BASE_TASK_SCHEDULER_SCHEDULER_LOCK_IMPL_H
 #define BASE_TASK_SCHEDULER_SCHEDULER_LOCK_IMPL_H
 
+#include <atomic>
 #include <memory>
 
 #include "base/base_export.h"
@@ -17,6 +18,8 @@ class ConditionVariable;
 
 namespace internal {
 
+class BoostableThreadPriority;
+
 // A regular lock with simple deadlock correctness checking.
 // This lock tracks all of the available locks to make sure that any locks are
 // acquired in an expected order.
@@ -37,6 +40,10 @@ class BASE_EXPORT SchedulerLockImpl {
  private:
   Lock lock_;
 
+  // BoostableThreadPriority of the thread holding the lock, if any. A thread
+  // which has to wait for the lock boosts it.
+  std::atomic<BoostableThreadPriority*> holder_priority_;
+
   DISALLOW_COPY_AND_ASSIGN(SchedulerLockImpl);
 };
 
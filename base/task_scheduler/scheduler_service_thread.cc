@@ -52,6 +52,15 @@ class ServiceThreadDelegate : public SchedulerWorkerThread::Delegate {
     return sleep_time < zero_delta ? zero_delta : sleep_time;
   }
 
+  bool CanDetach(SchedulerWorkerThread* worker_thread) override {
+    // The service thread must always be able to post ready delayed tasks.
+    return false;
+  }
+
+  void OnDetach() override {
+    NOTREACHED() << "CanDetach() always returns false.";
+  }
+
  private:
   DelayedTaskManager* const delayed_task_manager_;
 
@@ -69,7 +78,7 @@ std::unique_ptr<SchedulerServiceThread> SchedulerServiceThread::Create(
       SchedulerWorkerThread::Create(
           ThreadPriority::NORMAL,
           WrapUnique(new ServiceThreadDelegate(delayed_task_manager)),
-          task_tracker);
+          task_tracker, SchedulerWorkerThread::InitialState::ALIVE);
   if (!worker_thread)
     return nullptr;
 
@@ -56,8 +56,10 @@ class TaskSchedulerServiceThreadTest : public testing::Test {
     scheduler_thread_pool_ = SchedulerThreadPoolImpl::Create(
         "TestThreadPoolForSchedulerThread", ThreadPriority::BACKGROUND, 1u,
         SchedulerThreadPoolImpl::IORestriction::DISALLOWED,
-        Bind(&ReEnqueueSequenceCallback), &task_tracker_,
-        &delayed_task_manager_);
+        SchedulerThreadPoolImpl::WorkStealing::DISABLED,
+        SchedulerThreadPoolImpl::AdaptiveThreads::DISABLED,
+        SchedulerAffinityPolicy::None(), Bind(&ReEnqueueSequenceCallback),
+        &task_tracker_, &delayed_task_manager_);
     ASSERT_TRUE(scheduler_thread_pool_);
     service_thread_ = SchedulerServiceThread::Create(
         &task_tracker_, &delayed_task_manager_);
@@ -6,6 +6,7 @@
 #define BASE_TASK_SCHEDULER_SCHEDULER_THREAD_POOL_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
@@ -59,6 +60,15 @@ class BASE_EXPORT SchedulerThreadPool {
       std::unique_ptr<Task> task,
       scoped_refptr<Sequence> sequence,
       SchedulerWorkerThread* worker_thread) = 0;
+
+  // Posts each Task of |tasks| to be executed by this SchedulerThreadPool as
+  // part of its own one-off single-task Sequence. Unlike calling
+  // PostTaskWithSequence() for each Task, the Tasks that are ready to run are
+  // inserted in a PriorityQueue within a single Transaction and idle worker
+  // threads are woken up with a single acquisition of the lock that protects
+  // them. Returns true if all Tasks are posted.
+  virtual bool PostTasksWithOneOffSequences(
+      std::vector<std::unique_ptr<Task>> tasks) = 0;
 };
 
 }  // namespace internal
@@ -13,12 +13,17 @@
 #include "base/bind_helpers.h"
 #include "base/lazy_instance.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/sparse_histogram.h"
+#include "base/optional.h"
 #include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/stringprintf.h"
 #include "base/task_scheduler/delayed_task_manager.h"
 #include "base/task_scheduler/task_tracker.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/scoped_blocking_call.h"
 #include "base/threading/thread_local.h"
 #include "base/threading/thread_restrictions.h"
 
@@ -27,6 +32,27 @@ namespace internal {
 
 namespace {
 
+// Prefixes of the names of the histograms that record the number of alive and
+// blocked worker threads. The name of the thread pool is appended to them.
+const char kNumThreadsHistogramPrefix[] = "TaskScheduler.NumThreads.";
+const char kNumBlockedWorkerThreadsHistogramPrefix[] =
+    "TaskScheduler.NumBlockedWorkers.";
+
+// Time after which an idle worker thread is reclaimed when adaptive threads are
+// enabled.
+const int kDefaultReclaimTimeSeconds = 30;
+
+// When adaptive threads are enabled, a thread pool has this many worker threads
+// per allowed concurrent Task so that blocked worker threads can be
+// compensated.
+const size_t kAdaptiveWorkerThreadsFactor = 2;
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// Prefix of the name of the histogram that records the processor on which each
+// Task starts running. The name of the thread pool is appended to it.
+const char kTaskProcessorHistogramPrefix[] = "TaskScheduler.TaskProcessor.";
+#endif
+
 // SchedulerThreadPool that owns the current thread, if any.
 LazyInstance<ThreadLocalPointer<const SchedulerThreadPool>>::Leaky
     tls_current_thread_pool = LAZY_INSTANCE_INITIALIZER;
@@ -35,6 +61,11 @@ LazyInstance<ThreadLocalPointer<const SchedulerThreadPool>>::Leaky
 LazyInstance<ThreadLocalPointer<const SchedulerWorkerThread>>::Leaky
     tls_current_worker_thread = LAZY_INSTANCE_INITIALIZER;
 
+// Local PriorityQueue of the SchedulerWorkerThread that owns the current
+// thread, if it belongs to a thread pool with work stealing enabled.
+LazyInstance<ThreadLocalPointer<PriorityQueue>>::Leaky
+    tls_current_local_priority_queue = LAZY_INSTANCE_INITIALIZER;
+
 // A task runner that runs tasks with the PARALLEL ExecutionMode.
 class SchedulerParallelTaskRunner : public TaskRunner {
  public:
@@ -55,6 +86,16 @@ class SchedulerParallelTaskRunner : public TaskRunner {
         make_scoped_refptr(new Sequence), nullptr);
   }
 
+  bool PostTasks(const tracked_objects::Location& from_here,
+                 const std::vector<Closure>& closures) override {
+    std::vector<std::unique_ptr<Task>> tasks;
+    tasks.reserve(closures.size());
+    for (const Closure& closure : closures)
+      tasks.push_back(
+          WrapUnique(new Task(from_here, closure, traits_, TimeDelta())));
+    return thread_pool_->PostTasksWithOneOffSequences(std::move(tasks));
+  }
+
   bool RunsTasksOnCurrentThread() const override {
     return tls_current_thread_pool.Get().Get() == thread_pool_;
   }
@@ -90,6 +131,26 @@ class SchedulerSequencedTaskRunner : public SequencedTaskRunner {
                                               nullptr);
   }
 
+  bool PostCoalescedTask(const tracked_objects::Location& from_here,
+                         const void* coalescing_token,
+                         const Closure& closure) override {
+    // Don't create a Task if an equivalent Task is pending in |sequence_|.
+    if (!sequence_->BeginCoalescedPost(coalescing_token))
+      return true;
+
+    std::unique_ptr<Task> task(
+        new Task(from_here, closure, traits_, TimeDelta()));
+    task->sequenced_task_runner_ref = this;
+    task->coalescing_token = coalescing_token;
+
+    if (!thread_pool_->PostTaskWithSequence(std::move(task), sequence_,
+                                            nullptr)) {
+      sequence_->CancelCoalescedPost(coalescing_token);
+      return false;
+    }
+    return true;
+  }
+
   bool PostNonNestableDelayedTask(const tracked_objects::Location& from_here,
                                   const Closure& closure,
                                   base::TimeDelta delay) override {
@@ -139,6 +200,26 @@ class SchedulerSingleThreadTaskRunner : public SingleThreadTaskRunner {
                                               worker_thread_);
   }
 
+  bool PostCoalescedTask(const tracked_objects::Location& from_here,
+                         const void* coalescing_token,
+                         const Closure& closure) override {
+    // Don't create a Task if an equivalent Task is pending in |sequence_|.
+    if (!sequence_->BeginCoalescedPost(coalescing_token))
+      return true;
+
+    std::unique_ptr<Task> task(
+        new Task(from_here, closure, traits_, TimeDelta()));
+    task->single_thread_task_runner_ref = this;
+    task->coalescing_token = coalescing_token;
+
+    if (!thread_pool_->PostTaskWithSequence(std::move(task), sequence_,
+                                            worker_thread_)) {
+      sequence_->CancelCoalescedPost(coalescing_token);
+      return false;
+    }
+    return true;
+  }
+
   bool PostNonNestableDelayedTask(const tracked_objects::Location& from_here,
                                   const Closure& closure,
                                   base::TimeDelta delay) override {
@@ -178,7 +259,8 @@ bool ContainsWorkerThread(
 }  // namespace
 
 class SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl
-    : public SchedulerWorkerThread::Delegate {
+    : public SchedulerWorkerThread::Delegate,
+      public BlockingObserver {
  public:
   // |outer| owns the worker thread for which this delegate is constructed.
   // |re_enqueue_sequence_callback| is invoked when ReEnqueueSequence() is
@@ -197,24 +279,62 @@ class SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl
     return &single_threaded_priority_queue_;
   }
 
+  PriorityQueue* local_priority_queue() { return &local_priority_queue_; }
+
   // SchedulerWorkerThread::Delegate:
   void OnMainEntry(SchedulerWorkerThread* worker_thread) override;
   scoped_refptr<Sequence> GetWork(
       SchedulerWorkerThread* worker_thread) override;
   void ReEnqueueSequence(scoped_refptr<Sequence> sequence) override;
   TimeDelta GetSleepTimeout() override;
+  bool CanDetach(SchedulerWorkerThread* worker_thread) override;
+  void OnDetach() override;
+
+  // BlockingObserver:
+  void BlockingStarted() override;
+  void BlockingEnded() override;
 
  private:
+  // Returns true if the worker thread can be reclaimed, i.e. adaptive threads
+  // are enabled and it isn't assigned to a single-threaded TaskRunner.
+  bool CanBeReclaimed() const;
+
+  // Returns the Sequence with the highest priority from
+  // |outer_->shared_priority_queue_|, |single_threaded_priority_queue_| and,
+  // if work stealing is enabled, |local_priority_queue_|. If all these
+  // PriorityQueues are empty, returns nullptr and, if
+  // |add_to_idle_stack_if_empty| is true, adds |worker_thread| to
+  // |outer_->idle_worker_threads_stack_|.
+  scoped_refptr<Sequence> GetWorkFromPriorityQueues(
+      SchedulerWorkerThread* worker_thread,
+      bool add_to_idle_stack_if_empty);
+
   SchedulerThreadPoolImpl* outer_;
   const ReEnqueueSequenceCallback re_enqueue_sequence_callback_;
 
   // Single-threaded PriorityQueue for the worker thread.
   PriorityQueue single_threaded_priority_queue_;
 
+  // PriorityQueue in which Sequences posted or re-enqueued from the worker
+  // thread are inserted when work stealing is enabled. Other worker threads of
+  // the pool steal Sequences from it when they run out of work. Has
+  // |single_threaded_priority_queue_| as predecessor so that it can be part of
+  // the same set of Transactions in GetWorkFromPriorityQueues().
+  PriorityQueue local_priority_queue_;
+
   // True if the last Sequence returned by GetWork() was extracted from
   // |single_threaded_priority_queue_|.
   bool last_sequence_is_single_threaded_ = false;
 
+  // True from the moment GetWork() returns a Sequence until it is called
+  // again. Blocking calls made by the worker thread outside of Tasks (e.g.
+  // while it sleeps) must not be compensated.
+  bool is_running_task_ = false;
+
+  // Number of nested ScopedBlockingCalls on the worker thread while it is
+  // running a Task.
+  int blocking_depth_ = 0;
+
   const int index_;
 
   DISALLOW_COPY_AND_ASSIGN(SchedulerWorkerThreadDelegateImpl);
@@ -232,12 +352,16 @@ std::unique_ptr<SchedulerThreadPoolImpl> SchedulerThreadPoolImpl::Create(
     ThreadPriority thread_priority,
     size_t max_threads,
     IORestriction io_restriction,
+    WorkStealing work_stealing,
+    AdaptiveThreads adaptive_threads,
+    const SchedulerAffinityPolicy& affinity_policy,
     const ReEnqueueSequenceCallback& re_enqueue_sequence_callback,
     TaskTracker* task_tracker,
     DelayedTaskManager* delayed_task_manager) {
   std::unique_ptr<SchedulerThreadPoolImpl> thread_pool(
-      new SchedulerThreadPoolImpl(name, io_restriction, task_tracker,
-                                  delayed_task_manager));
+      new SchedulerThreadPoolImpl(name, io_restriction, work_stealing,
+                                  adaptive_threads, affinity_policy,
+                                  task_tracker, delayed_task_manager));
   if (thread_pool->Initialize(thread_priority, max_threads,
                               re_enqueue_sequence_callback)) {
     return thread_pool;
@@ -245,6 +369,11 @@ std::unique_ptr<SchedulerThreadPoolImpl> SchedulerThreadPoolImpl::Create(
   return nullptr;
 }
 
+void SchedulerThreadPoolImpl::SetReclaimTimeForTesting(
+    TimeDelta reclaim_time) {
+  reclaim_time_ = reclaim_time;
+}
+
 void SchedulerThreadPoolImpl::WaitForAllWorkerThreadsIdleForTesting() {
   AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
   while (idle_worker_threads_stack_.Size() < worker_threads_.size())
@@ -259,6 +388,16 @@ void SchedulerThreadPoolImpl::JoinForTesting() {
   join_for_testing_returned_.Signal();
 }
 
+void SchedulerThreadPoolImpl::GetHistograms(
+    std::vector<const HistogramBase*>* histograms) const {
+  DCHECK(histograms);
+  histograms->push_back(num_threads_histogram_);
+  histograms->push_back(num_blocked_worker_threads_histogram_);
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  histograms->push_back(task_processor_histogram_);
+#endif
+}
+
 scoped_refptr<TaskRunner> SchedulerThreadPoolImpl::CreateTaskRunnerWithTraits(
     const TaskTraits& traits,
     ExecutionMode execution_mode) {
@@ -271,15 +410,18 @@ scoped_refptr<TaskRunner> SchedulerThreadPoolImpl::CreateTaskRunnerWithTraits(
 
     case ExecutionMode::SINGLE_THREADED: {
       // TODO(fdoray): Find a way to take load into account when assigning a
-      // SchedulerWorkerThread to a SingleThreadTaskRunner. Also, this code
-      // assumes that all SchedulerWorkerThreads are alive. Eventually, we might
-      // decide to tear down threads that haven't run tasks for a long time.
+      // SchedulerWorkerThread to a SingleThreadTaskRunner. Only the first
+      // |max_threads_| SchedulerWorkerThreads are used: the others compensate
+      // blocked worker threads when adaptive threads are enabled.
       size_t worker_thread_index;
       {
         AutoSchedulerLock auto_lock(next_worker_thread_index_lock_);
         worker_thread_index = next_worker_thread_index_;
         next_worker_thread_index_ =
-            (next_worker_thread_index_ + 1) % worker_threads_.size();
+            (next_worker_thread_index_ + 1) % max_threads_;
+        num_single_threaded_worker_threads_ =
+            std::max(num_single_threaded_worker_threads_,
+                     worker_thread_index + 1);
       }
       return make_scoped_refptr(new SchedulerSingleThreadTaskRunner(
           traits, this, worker_threads_[worker_thread_index].get()));
@@ -293,6 +435,18 @@ scoped_refptr<TaskRunner> SchedulerThreadPoolImpl::CreateTaskRunnerWithTraits(
 void SchedulerThreadPoolImpl::ReEnqueueSequence(
     scoped_refptr<Sequence> sequence,
     const SequenceSortKey& sequence_sort_key) {
+  // When work stealing is enabled and the current thread belongs to this pool,
+  // |sequence| is re-enqueued in the current worker thread's local
+  // PriorityQueue. The current worker thread will get it from there on its
+  // next call to GetWork(), unless an idle worker thread steals it first.
+  PriorityQueue* const local_priority_queue =
+      GetCurrentThreadLocalPriorityQueue();
+  if (local_priority_queue) {
+    local_priority_queue->BeginTransaction()->Push(std::move(sequence),
+                                                   sequence_sort_key);
+    return;
+  }
+
   shared_priority_queue_.BeginTransaction()->Push(std::move(sequence),
                                                   sequence_sort_key);
 
@@ -345,13 +499,19 @@ void SchedulerThreadPoolImpl::PostTaskWithSequenceNow(
   DCHECK_LE(task->delayed_run_time, delayed_task_manager_->Now());
 
   // Because |worker_thread| belongs to this thread pool, we know that the type
-  // of its delegate is SchedulerWorkerThreadDelegateImpl.
+  // of its delegate is SchedulerWorkerThreadDelegateImpl. When no
+  // |worker_thread| is specified and work stealing is enabled, a Sequence
+  // posted from a worker thread of this pool goes to that worker thread's
+  // local PriorityQueue.
+  PriorityQueue* const local_priority_queue =
+      worker_thread ? nullptr : GetCurrentThreadLocalPriorityQueue();
   PriorityQueue* const priority_queue =
       worker_thread
           ? static_cast<SchedulerWorkerThreadDelegateImpl*>(
                 worker_thread->delegate())
                 ->single_threaded_priority_queue()
-          : &shared_priority_queue_;
+          : (local_priority_queue ? local_priority_queue
+                                  : &shared_priority_queue_);
   DCHECK(priority_queue);
 
   const bool sequence_was_empty = sequence->PushTask(std::move(task));
@@ -366,7 +526,9 @@ void SchedulerThreadPoolImpl::PostTaskWithSequenceNow(
     priority_queue->BeginTransaction()->Push(std::move(sequence),
                                              sequence_sort_key);
 
-    // Wake up a worker thread to process |sequence|.
+    // Wake up a worker thread to process |sequence|. When |sequence| was
+    // inserted in a local PriorityQueue, the woken up worker thread will steal
+    // it if the current worker thread is still busy.
     if (worker_thread)
       worker_thread->WakeUp();
     else
@@ -374,6 +536,60 @@ void SchedulerThreadPoolImpl::PostTaskWithSequenceNow(
   }
 }
 
+bool SchedulerThreadPoolImpl::PostTasksWithOneOffSequences(
+    std::vector<std::unique_ptr<Task>> tasks) {
+  bool all_posted = true;
+
+  // Put each Task that is ready to run in its own Sequence. This is done
+  // before creating a Transaction because TaskTracker, DelayedTaskManager and
+  // Sequence have locks that can't be acquired while a PriorityQueue's lock is
+  // held.
+  std::vector<std::pair<scoped_refptr<Sequence>, SequenceSortKey>> sequences;
+  sequences.reserve(tasks.size());
+  for (std::unique_ptr<Task>& task : tasks) {
+    DCHECK(task);
+    if (!task_tracker_->WillPostTask(task.get())) {
+      all_posted = false;
+      continue;
+    }
+
+    scoped_refptr<Sequence> sequence(new Sequence);
+    if (!task->delayed_run_time.is_null()) {
+      delayed_task_manager_->AddDelayedTask(std::move(task),
+                                            std::move(sequence), nullptr, this);
+      continue;
+    }
+
+    sequence->PushTask(std::move(task));
+    const SequenceSortKey sequence_sort_key = sequence->GetSortKey();
+    sequences.emplace_back(std::move(sequence), sequence_sort_key);
+  }
+
+  if (sequences.empty())
+    return all_posted;
+
+  // As in PostTaskWithSequenceNow(), Sequences posted from a worker thread of
+  // this pool go to its local PriorityQueue when work stealing is enabled.
+  PriorityQueue* const local_priority_queue =
+      GetCurrentThreadLocalPriorityQueue();
+  PriorityQueue* const priority_queue =
+      local_priority_queue ? local_priority_queue : &shared_priority_queue_;
+  {
+    std::unique_ptr<PriorityQueue::Transaction> transaction(
+        priority_queue->BeginTransaction());
+    for (auto& sequence_and_sort_key : sequences) {
+      transaction->Push(std::move(sequence_and_sort_key.first),
+                        sequence_and_sort_key.second);
+    }
+  }
+
+  // Wake up one worker thread per Sequence, as there would be after as many
+  // calls to PostTaskWithSequence(). The Sequences can run in parallel so
+  // waking up a single worker thread would serialize them.
+  WakeUpThreads(sequences.size());
+  return all_posted;
+}
+
 SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
     SchedulerWorkerThreadDelegateImpl(
         SchedulerThreadPoolImpl* outer,
@@ -383,6 +599,7 @@ SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
     : outer_(outer),
       re_enqueue_sequence_callback_(re_enqueue_sequence_callback),
       single_threaded_priority_queue_(shared_priority_queue),
+      local_priority_queue_(&single_threaded_priority_queue_),
       index_(index) {}
 
 SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
@@ -404,65 +621,128 @@ void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::OnMainEntry(
   DCHECK(!tls_current_thread_pool.Get().Get());
   tls_current_worker_thread.Get().Set(worker_thread);
   tls_current_thread_pool.Get().Set(outer_);
+  if (outer_->work_stealing_ == WorkStealing::ENABLED)
+    tls_current_local_priority_queue.Get().Set(&local_priority_queue_);
+  if (outer_->adaptive_threads_ == AdaptiveThreads::ENABLED)
+    SetBlockingObserverForCurrentThread(this);
 
   ThreadRestrictions::SetIOAllowed(outer_->io_restriction_ ==
                                    IORestriction::ALLOWED);
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  if (!outer_->affinity_processors_.empty() &&
+      !PlatformThread::SetCurrentThreadAffinity(
+          outer_->affinity_processors_)) {
+    DLOG(WARNING) << "Failed to set the affinity of a worker thread of "
+                  << outer_->name_;
+  }
+#endif
+
+  outer_->OnNumAliveThreadsChanged(1);
 }
 
 scoped_refptr<Sequence>
 SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::GetWork(
     SchedulerWorkerThread* worker_thread) {
   DCHECK(ContainsWorkerThread(outer_->worker_threads_, worker_thread));
+  DCHECK_EQ(0, blocking_depth_);
+  is_running_task_ = false;
+
+  const bool work_stealing_enabled =
+      outer_->work_stealing_ == WorkStealing::ENABLED;
+
+  scoped_refptr<Sequence> sequence =
+      GetWorkFromPriorityQueues(worker_thread, !work_stealing_enabled);
+
+  if (!sequence && work_stealing_enabled) {
+    // This worker thread's PriorityQueues and the shared PriorityQueue are
+    // empty. Try to steal a Sequence from another worker thread. StealWork()
+    // must be called without an active Transaction since the local
+    // PriorityQueues of other worker threads don't have any of this worker
+    // thread's PriorityQueues as predecessor.
+    sequence = outer_->StealWork(this);
+
+    // Check this worker thread's PriorityQueues again before going idle. A
+    // Sequence inserted in the shared PriorityQueue after the first check is
+    // guaranteed to be seen here or to wake up this worker thread (see
+    // GetWorkFromPriorityQueues()). A Sequence inserted in the local
+    // PriorityQueue of another worker thread will at worst be run by that
+    // worker thread.
+    if (!sequence)
+      sequence = GetWorkFromPriorityQueues(worker_thread, true);
+  }
 
-  scoped_refptr<Sequence> sequence;
-  {
-    std::unique_ptr<PriorityQueue::Transaction> shared_transaction(
-        outer_->shared_priority_queue_.BeginTransaction());
-    std::unique_ptr<PriorityQueue::Transaction> single_threaded_transaction(
-        single_threaded_priority_queue_.BeginTransaction());
-
-    if (shared_transaction->IsEmpty() &&
-        single_threaded_transaction->IsEmpty()) {
-      single_threaded_transaction.reset();
-
-      // |shared_transaction| is kept alive while |worker_thread| is added to
-      // |idle_worker_threads_stack_| to avoid this race:
-      // 1. This thread creates a Transaction, finds |shared_priority_queue_|
-      //    empty and ends the Transaction.
-      // 2. Other thread creates a Transaction, inserts a Sequence into
-      //    |shared_priority_queue_| and ends the Transaction. This can't happen
-      //    if the Transaction of step 1 is still active because because there
-      //    can only be one active Transaction per PriorityQueue at a time.
-      // 3. Other thread calls WakeUpOneThread(). No thread is woken up because
-      //    |idle_worker_threads_stack_| is empty.
-      // 4. This thread adds itself to |idle_worker_threads_stack_| and goes to
-      //    sleep. No thread runs the Sequence inserted in step 2.
+  if (!sequence)
+    return nullptr;
+
+  outer_->RemoveFromIdleWorkerThreadsStack(worker_thread);
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // The Task is about to run. Record where it runs to verify the effect of
+  // |outer_->affinity_processors_|.
+  const int processor = PlatformThread::GetCurrentProcessor();
+  if (processor >= 0)
+    outer_->task_processor_histogram_->Add(processor);
+#endif
+
+  is_running_task_ = true;
+  return sequence;
+}
+
+scoped_refptr<Sequence> SchedulerThreadPoolImpl::
+    SchedulerWorkerThreadDelegateImpl::GetWorkFromPriorityQueues(
+        SchedulerWorkerThread* worker_thread,
+        bool add_to_idle_stack_if_empty) {
+  std::unique_ptr<PriorityQueue::Transaction> shared_transaction(
+      outer_->shared_priority_queue_.BeginTransaction());
+  std::unique_ptr<PriorityQueue::Transaction> single_threaded_transaction(
+      single_threaded_priority_queue_.BeginTransaction());
+  std::unique_ptr<PriorityQueue::Transaction> local_transaction;
+  if (outer_->work_stealing_ == WorkStealing::ENABLED)
+    local_transaction = local_priority_queue_.BeginTransaction();
+
+  if (shared_transaction->IsEmpty() &&
+      single_threaded_transaction->IsEmpty() &&
+      (!local_transaction || local_transaction->IsEmpty())) {
+    local_transaction.reset();
+    single_threaded_transaction.reset();
+
+    // |shared_transaction| is kept alive while |worker_thread| is added to
+    // |idle_worker_threads_stack_| to avoid this race:
+    // 1. This thread creates a Transaction, finds |shared_priority_queue_|
+    //    empty and ends the Transaction.
+    // 2. Other thread creates a Transaction, inserts a Sequence into
+    //    |shared_priority_queue_| and ends the Transaction. This can't happen
+    //    if the Transaction of step 1 is still active because because there
+    //    can only be one active Transaction per PriorityQueue at a time.
+    // 3. Other thread calls WakeUpOneThread(). No thread is woken up because
+    //    |idle_worker_threads_stack_| is empty.
+    // 4. This thread adds itself to |idle_worker_threads_stack_| and goes to
+    //    sleep. No thread runs the Sequence inserted in step 2.
+    if (add_to_idle_stack_if_empty)
       outer_->AddToIdleWorkerThreadsStack(worker_thread);
-      return nullptr;
-    }
+    return nullptr;
+  }
 
-    // True if both PriorityQueues have Sequences and the Sequence at the top of
-    // the shared PriorityQueue is more important.
-    const bool shared_sequence_is_more_important =
-        !shared_transaction->IsEmpty() &&
-        !single_threaded_transaction->IsEmpty() &&
-        shared_transaction->PeekSortKey() >
-            single_threaded_transaction->PeekSortKey();
-
-    if (single_threaded_transaction->IsEmpty() ||
-        shared_sequence_is_more_important) {
-      sequence = shared_transaction->PopSequence();
-      last_sequence_is_single_threaded_ = false;
-    } else {
-      DCHECK(!single_threaded_transaction->IsEmpty());
-      sequence = single_threaded_transaction->PopSequence();
-      last_sequence_is_single_threaded_ = true;
+  // Pick the PriorityQueue whose top Sequence is the most important. Ties are
+  // broken in favor of the single-threaded PriorityQueue, then the local
+  // PriorityQueue.
+  PriorityQueue::Transaction* best_transaction = nullptr;
+  for (PriorityQueue::Transaction* transaction :
+       {single_threaded_transaction.get(), local_transaction.get(),
+        shared_transaction.get()}) {
+    if (!transaction || transaction->IsEmpty())
+      continue;
+    if (!best_transaction ||
+        transaction->PeekSortKey() > best_transaction->PeekSortKey()) {
+      best_transaction = transaction;
     }
   }
-  DCHECK(sequence);
+  DCHECK(best_transaction);
 
-  outer_->RemoveFromIdleWorkerThreadsStack(worker_thread);
-  return sequence;
+  last_sequence_is_single_threaded_ =
+      best_transaction == single_threaded_transaction.get();
+  return best_transaction->PopSequence();
 }
 
 void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
@@ -482,16 +762,80 @@ void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
 
 TimeDelta SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
     GetSleepTimeout() {
-  return TimeDelta::Max();
+  return CanBeReclaimed() ? outer_->reclaim_time_ : TimeDelta::Max();
+}
+
+bool SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::CanDetach(
+    SchedulerWorkerThread* worker_thread) {
+  // The worker thread may have been assigned to a single-threaded TaskRunner
+  // since GetSleepTimeout() was called.
+  return CanBeReclaimed();
+}
+
+void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::OnDetach() {
+  // The platform thread is about to exit. The thread-local state set in
+  // OnMainEntry() goes away with it.
+  SetBlockingObserverForCurrentThread(nullptr);
+  outer_->OnNumAliveThreadsChanged(-1);
+}
+
+void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
+    BlockingStarted() {
+  if (!is_running_task_)
+    return;
+  if (blocking_depth_++ == 0)
+    outer_->OnWorkerThreadBlocked();
+}
+
+void SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
+    BlockingEnded() {
+  if (!is_running_task_)
+    return;
+  DCHECK_GT(blocking_depth_, 0);
+  if (--blocking_depth_ == 0)
+    outer_->OnWorkerThreadUnblocked();
+}
+
+bool SchedulerThreadPoolImpl::SchedulerWorkerThreadDelegateImpl::
+    CanBeReclaimed() const {
+  if (outer_->adaptive_threads_ == AdaptiveThreads::DISABLED)
+    return false;
+  AutoSchedulerLock auto_lock(outer_->next_worker_thread_index_lock_);
+  return static_cast<size_t>(index_) >=
+         outer_->num_single_threaded_worker_threads_;
 }
 
 SchedulerThreadPoolImpl::SchedulerThreadPoolImpl(
     StringPiece name,
     IORestriction io_restriction,
+    WorkStealing work_stealing,
+    AdaptiveThreads adaptive_threads,
+    const SchedulerAffinityPolicy& affinity_policy,
     TaskTracker* task_tracker,
     DelayedTaskManager* delayed_task_manager)
     : name_(name.as_string()),
       io_restriction_(io_restriction),
+      work_stealing_(work_stealing),
+      adaptive_threads_(adaptive_threads),
+      reclaim_time_(TimeDelta::FromSeconds(kDefaultReclaimTimeSeconds)),
+      affinity_processors_(affinity_policy.GetProcessors()),
+      num_threads_histogram_(Histogram::FactoryGet(
+          kNumThreadsHistogramPrefix + name_,
+          1,
+          100,
+          50,
+          HistogramBase::kUmaTargetedHistogramFlag)),
+      num_blocked_worker_threads_histogram_(Histogram::FactoryGet(
+          kNumBlockedWorkerThreadsHistogramPrefix + name_,
+          1,
+          100,
+          50,
+          HistogramBase::kUmaTargetedHistogramFlag)),
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+      task_processor_histogram_(SparseHistogram::FactoryGet(
+          kTaskProcessorHistogramPrefix + name_,
+          HistogramBase::kUmaTargetedHistogramFlag)),
+#endif
       idle_worker_threads_stack_lock_(shared_priority_queue_.container_lock()),
       idle_worker_threads_stack_cv_for_testing_(
           idle_worker_threads_stack_lock_.CreateConditionVariable()),
@@ -511,23 +855,44 @@ bool SchedulerThreadPoolImpl::Initialize(
     ThreadPriority thread_priority,
     size_t max_threads,
     const ReEnqueueSequenceCallback& re_enqueue_sequence_callback) {
-  AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
-
   DCHECK(worker_threads_.empty());
 
-  for (size_t i = 0; i < max_threads; ++i) {
+  // When adaptive threads are enabled, platform threads are only created when
+  // worker threads are woken up.
+  const bool adaptive_threads_enabled =
+      adaptive_threads_ == AdaptiveThreads::ENABLED;
+  const size_t num_worker_threads =
+      adaptive_threads_enabled ? kAdaptiveWorkerThreadsFactor * max_threads
+                               : max_threads;
+  const SchedulerWorkerThread::InitialState initial_state =
+      adaptive_threads_enabled
+          ? SchedulerWorkerThread::InitialState::DETACHED
+          : SchedulerWorkerThread::InitialState::ALIVE;
+
+  for (size_t i = 0; i < num_worker_threads; ++i) {
     std::unique_ptr<SchedulerWorkerThread> worker_thread =
         SchedulerWorkerThread::Create(
             thread_priority, WrapUnique(new SchedulerWorkerThreadDelegateImpl(
                                  this, re_enqueue_sequence_callback,
                                  &shared_priority_queue_, static_cast<int>(i))),
-            task_tracker_);
+            task_tracker_, initial_state);
     if (!worker_thread)
       break;
-    idle_worker_threads_stack_.Push(worker_thread.get());
     worker_threads_.push_back(std::move(worker_thread));
   }
 
+  // All worker threads start out idle. |idle_worker_threads_stack_lock_| isn't
+  // held while they are created because SchedulerWorkerThread::Create()
+  // acquires a lock that doesn't have it as predecessor.
+  {
+    AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
+    for (const auto& worker_thread : worker_threads_)
+      idle_worker_threads_stack_.Push(worker_thread.get());
+  }
+
+  max_threads_ = adaptive_threads_enabled ? max_threads
+                                          : worker_threads_.size();
+
 #if DCHECK_IS_ON()
   threads_created_.Signal();
 #endif
@@ -539,12 +904,116 @@ void SchedulerThreadPoolImpl::WakeUpOneThread() {
   SchedulerWorkerThread* worker_thread;
   {
     AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
+    if (!CanWakeUpThreadLockRequired())
+      return;
     worker_thread = idle_worker_threads_stack_.Pop();
   }
   if (worker_thread)
     worker_thread->WakeUp();
 }
 
+void SchedulerThreadPoolImpl::WakeUpThreads(size_t num_threads) {
+  std::vector<SchedulerWorkerThread*> worker_threads;
+  {
+    AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
+    while (worker_threads.size() < num_threads &&
+           !idle_worker_threads_stack_.IsEmpty() &&
+           CanWakeUpThreadLockRequired()) {
+      worker_threads.push_back(idle_worker_threads_stack_.Pop());
+    }
+  }
+  for (SchedulerWorkerThread* worker_thread : worker_threads)
+    worker_thread->WakeUp();
+}
+
+bool SchedulerThreadPoolImpl::CanWakeUpThreadLockRequired() const {
+  idle_worker_threads_stack_lock_.AssertAcquired();
+  if (adaptive_threads_ == AdaptiveThreads::DISABLED)
+    return true;
+
+  // A Sequence that can't get a worker thread here will be picked up by one of
+  // the active worker threads, which all look for work before going idle.
+  const size_t num_active_worker_threads =
+      worker_threads_.size() - idle_worker_threads_stack_.Size();
+  return num_active_worker_threads < max_threads_ + num_blocked_worker_threads_;
+}
+
+void SchedulerThreadPoolImpl::OnWorkerThreadBlocked() {
+  DCHECK_EQ(AdaptiveThreads::ENABLED, adaptive_threads_);
+  size_t num_blocked_worker_threads;
+  {
+    AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
+    num_blocked_worker_threads = ++num_blocked_worker_threads_;
+  }
+  num_blocked_worker_threads_histogram_->Add(
+      static_cast<int>(num_blocked_worker_threads));
+
+  // Let another worker thread run the pending Sequences while this one is
+  // blocked.
+  if (!shared_priority_queue_.BeginTransaction()->IsEmpty())
+    WakeUpOneThread();
+}
+
+void SchedulerThreadPoolImpl::OnWorkerThreadUnblocked() {
+  DCHECK_EQ(AdaptiveThreads::ENABLED, adaptive_threads_);
+  AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
+  DCHECK_GT(num_blocked_worker_threads_, 0U);
+  --num_blocked_worker_threads_;
+}
+
+void SchedulerThreadPoolImpl::OnNumAliveThreadsChanged(int delta) {
+  const subtle::Atomic32 num_alive_threads =
+      subtle::NoBarrier_AtomicIncrement(&num_alive_threads_, delta);
+  DCHECK_GE(num_alive_threads, 0);
+  num_threads_histogram_->Add(num_alive_threads);
+}
+
+PriorityQueue* SchedulerThreadPoolImpl::GetCurrentThreadLocalPriorityQueue()
+    const {
+  if (work_stealing_ == WorkStealing::DISABLED ||
+      tls_current_thread_pool.Get().Get() != this) {
+    return nullptr;
+  }
+  return tls_current_local_priority_queue.Get().Get();
+}
+
+scoped_refptr<Sequence> SchedulerThreadPoolImpl::StealWork(
+    const SchedulerWorkerThreadDelegateImpl* thief) {
+  DCHECK_EQ(WorkStealing::ENABLED, work_stealing_);
+
+  // Find the victim whose most important Sequence has the highest priority, to
+  // preserve TaskTraits priority ordering across the pool. Transactions are
+  // never nested here: each local PriorityQueue is inspected on its own.
+  SchedulerWorkerThreadDelegateImpl* victim = nullptr;
+  Optional<SequenceSortKey> victim_sort_key;
+  for (const auto& worker_thread : worker_threads_) {
+    SchedulerWorkerThreadDelegateImpl* const delegate =
+        static_cast<SchedulerWorkerThreadDelegateImpl*>(
+            worker_thread->delegate());
+    if (delegate == thief)
+      continue;
+
+    std::unique_ptr<PriorityQueue::Transaction> transaction(
+        delegate->local_priority_queue()->BeginTransaction());
+    if (transaction->IsEmpty())
+      continue;
+    if (!victim_sort_key || transaction->PeekSortKey() > *victim_sort_key) {
+      victim = delegate;
+      victim_sort_key = transaction->PeekSortKey();
+    }
+  }
+
+  if (!victim)
+    return nullptr;
+
+  // The victim may have emptied its local PriorityQueue in the meantime.
+  std::unique_ptr<PriorityQueue::Transaction> transaction(
+      victim->local_priority_queue()->BeginTransaction());
+  if (transaction->IsEmpty())
+    return nullptr;
+  return transaction->PopSequence();
+}
+
 void SchedulerThreadPoolImpl::AddToIdleWorkerThreadsStack(
     SchedulerWorkerThread* worker_thread) {
   AutoSchedulerLock auto_lock(idle_worker_threads_stack_lock_);
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/callback.h"
 #include "base/logging.h"
@@ -20,6 +21,7 @@
 #include "base/synchronization/condition_variable.h"
 #include "base/task_runner.h"
 #include "base/task_scheduler/priority_queue.h"
+#include "base/task_scheduler/scheduler_affinity_policy.h"
 #include "base/task_scheduler/scheduler_lock.h"
 #include "base/task_scheduler/scheduler_thread_pool.h"
 #include "base/task_scheduler/scheduler_worker_thread.h"
@@ -28,8 +30,13 @@
 #include "base/task_scheduler/task.h"
 #include "base/task_scheduler/task_traits.h"
 #include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
 
 namespace base {
+
+class HistogramBase;
+
 namespace internal {
 
 class DelayedTaskManager;
@@ -43,6 +50,27 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
     DISALLOWED,
   };
 
+  // Indicates whether idle worker threads of a thread pool steal Sequences
+  // from the local PriorityQueues of other worker threads. When ENABLED, a
+  // Sequence posted or re-enqueued from a worker thread of the pool goes to
+  // that worker thread's local PriorityQueue instead of the shared
+  // PriorityQueue, which reduces contention on the shared PriorityQueue's lock.
+  enum class WorkStealing {
+    DISABLED,
+    ENABLED,
+  };
+
+  // Indicates whether the number of threads of a thread pool adapts to its
+  // load. When ENABLED, worker threads are created when they are first woken
+  // up and are reclaimed after being idle for some time. Also, while a worker
+  // thread is blocked in a ScopedBlockingCall (e.g. ScopedAllowIO or a wait
+  // on a WaitableEvent), an additional worker thread can be woken up to run
+  // pending Sequences, up to twice the maximum number of threads.
+  enum class AdaptiveThreads {
+    DISABLED,
+    ENABLED,
+  };
+
   // Callback invoked when a Sequence isn't empty after a worker thread pops a
   // Task from it.
   using ReEnqueueSequenceCallback = Callback<void(scoped_refptr<Sequence>)>;
@@ -55,20 +83,32 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
   // Creates a SchedulerThreadPool labeled |name| with up to |max_threads|
   // threads of priority |thread_priority|. |io_restriction| indicates whether
   // Tasks on the constructed thread pool are allowed to make I/O calls.
-  // |re_enqueue_sequence_callback| will be invoked after a thread of this
-  // thread pool tries to run a Task. |task_tracker| is used to handle shutdown
-  // behavior of Tasks. |delayed_task_manager| handles Tasks posted with a
-  // delay. Returns nullptr on failure to create a thread pool with at least one
-  // thread.
+  // |work_stealing| indicates whether worker threads have local PriorityQueues
+  // from which other worker threads can steal work. |adaptive_threads|
+  // indicates whether worker threads are created and reclaimed on demand.
+  // |affinity_policy| indicates on which processors worker threads are allowed
+  // to run. |re_enqueue_sequence_callback| will be invoked after a thread of
+  // this thread pool tries to run a Task. |task_tracker| is used to handle
+  // shutdown behavior of Tasks. |delayed_task_manager| handles Tasks posted
+  // with a delay. Returns nullptr on failure to create a thread pool with at
+  // least one thread.
   static std::unique_ptr<SchedulerThreadPoolImpl> Create(
       StringPiece name,
       ThreadPriority thread_priority,
       size_t max_threads,
       IORestriction io_restriction,
+      WorkStealing work_stealing,
+      AdaptiveThreads adaptive_threads,
+      const SchedulerAffinityPolicy& affinity_policy,
       const ReEnqueueSequenceCallback& re_enqueue_sequence_callback,
       TaskTracker* task_tracker,
       DelayedTaskManager* delayed_task_manager);
 
+  // Sets the time after which an idle worker thread is reclaimed when adaptive
+  // threads are enabled. Must be called before any Task is posted to this
+  // thread pool.
+  void SetReclaimTimeForTesting(TimeDelta reclaim_time);
+
   // Waits until all threads are idle.
   void WaitForAllWorkerThreadsIdleForTesting();
 
@@ -76,6 +116,13 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
   // allowed to complete their execution. This can only be called once.
   void JoinForTesting();
 
+  // Appends the histograms recorded by this thread pool to |histograms|. They
+  // record the number of alive worker threads each time a worker thread is
+  // created or reclaimed, the number of blocked worker threads each time a
+  // worker thread becomes blocked and, on Linux and Android, the processor on
+  // which each Task starts running.
+  void GetHistograms(std::vector<const HistogramBase*>* histograms) const;
+
   // SchedulerThreadPool:
   scoped_refptr<TaskRunner> CreateTaskRunnerWithTraits(
       const TaskTraits& traits,
@@ -88,12 +135,17 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
   void PostTaskWithSequenceNow(std::unique_ptr<Task> task,
                                scoped_refptr<Sequence> sequence,
                                SchedulerWorkerThread* worker_thread) override;
+  bool PostTasksWithOneOffSequences(
+      std::vector<std::unique_ptr<Task>> tasks) override;
 
  private:
   class SchedulerWorkerThreadDelegateImpl;
 
   SchedulerThreadPoolImpl(StringPiece name,
                           IORestriction io_restriction,
+                          WorkStealing work_stealing,
+                          AdaptiveThreads adaptive_threads,
+                          const SchedulerAffinityPolicy& affinity_policy,
                           TaskTracker* task_tracker,
                           DelayedTaskManager* delayed_task_manager);
 
@@ -102,9 +154,44 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
       size_t max_threads,
       const ReEnqueueSequenceCallback& re_enqueue_sequence_callback);
 
-  // Wakes up the last thread from this thread pool to go idle, if any.
+  // Wakes up the last thread from this thread pool to go idle, if any. When
+  // adaptive threads are enabled, no thread is woken up if the number of
+  // non-blocked active threads already reaches the maximum.
   void WakeUpOneThread();
 
+  // Wakes up the |num_threads| last threads from this thread pool to go idle,
+  // or all idle threads if there are fewer of them. The limit of
+  // WakeUpOneThread() applies.
+  void WakeUpThreads(size_t num_threads);
+
+  // Returns true if an idle worker thread can be woken up without exceeding
+  // the capacity of this thread pool. |idle_worker_threads_stack_lock_| must
+  // be held.
+  bool CanWakeUpThreadLockRequired() const;
+
+  // Called when a worker thread running a Task becomes blocked. Wakes up
+  // another worker thread if Sequences are waiting in |shared_priority_queue_|.
+  void OnWorkerThreadBlocked();
+
+  // Called when a worker thread running a Task is no longer blocked.
+  void OnWorkerThreadUnblocked();
+
+  // Called when a worker thread is created or reclaimed. Records the number of
+  // alive worker threads in |num_threads_histogram_|.
+  void OnNumAliveThreadsChanged(int delta);
+
+  // Returns the local PriorityQueue of the worker thread of this thread pool
+  // running on the current thread, or nullptr if work stealing is disabled or
+  // if the current thread doesn't belong to this thread pool.
+  PriorityQueue* GetCurrentThreadLocalPriorityQueue() const;
+
+  // Tries to steal the Sequence with the highest priority from the local
+  // PriorityQueue of a worker thread other than |thief|. Returns nullptr if
+  // no Sequence could be stolen. Must be called without any active
+  // Transaction.
+  scoped_refptr<Sequence> StealWork(
+      const SchedulerWorkerThreadDelegateImpl* thief);
+
   // Adds |worker_thread| to |idle_worker_threads_stack_|.
   void AddToIdleWorkerThreadsStack(SchedulerWorkerThread* worker_thread);
 
@@ -118,19 +205,62 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
   // initialization of the thread pool.
   std::vector<std::unique_ptr<SchedulerWorkerThread>> worker_threads_;
 
-  // Synchronizes access to |next_worker_thread_index_|.
+  // Maximum number of non-blocked worker threads that run Tasks at the same
+  // time. Only modified during initialization of the thread pool. When
+  // adaptive threads are disabled, equal to the size of |worker_threads_|.
+  size_t max_threads_ = 0;
+
+  // Synchronizes access to |next_worker_thread_index_| and
+  // |num_single_threaded_worker_threads_|.
   SchedulerLock next_worker_thread_index_lock_;
 
   // Index of the worker thread that will be assigned to the next single-
   // threaded TaskRunner returned by this pool.
   size_t next_worker_thread_index_ = 0;
 
+  // Number of worker threads, starting from the first one, that have been
+  // assigned to a single-threaded TaskRunner. These worker threads are never
+  // reclaimed so that all Tasks of a single-threaded TaskRunner run on the
+  // same platform thread.
+  size_t num_single_threaded_worker_threads_ = 0;
+
   // PriorityQueue from which all threads of this thread pool get work.
   PriorityQueue shared_priority_queue_;
 
   // Indicates whether Tasks on this thread pool are allowed to make I/O calls.
   const IORestriction io_restriction_;
 
+  // Indicates whether worker threads of this thread pool steal work from each
+  // other's local PriorityQueues.
+  const WorkStealing work_stealing_;
+
+  // Indicates whether worker threads of this thread pool are created and
+  // reclaimed on demand.
+  const AdaptiveThreads adaptive_threads_;
+
+  // Time after which an idle worker thread is reclaimed when adaptive threads
+  // are enabled.
+  TimeDelta reclaim_time_;
+
+  // Number of worker threads that have an underlying platform thread.
+  subtle::Atomic32 num_alive_threads_ = 0;
+
+  // Processors to which worker threads are pinned when they start. Empty if
+  // worker threads aren't pinned.
+  const std::vector<int> affinity_processors_;
+
+  // Records the number of alive worker threads each time it changes.
+  HistogramBase* const num_threads_histogram_;
+
+  // Records the number of blocked worker threads each time a worker thread
+  // becomes blocked.
+  HistogramBase* const num_blocked_worker_threads_histogram_;
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Records the processor on which each Task starts running.
+  HistogramBase* const task_processor_histogram_;
+#endif
+
   // Synchronizes access to |idle_worker_threads_stack_| and
   // |idle_worker_threads_stack_cv_for_testing_|. Has |shared_priority_queue_|'s
   // lock as its predecessor so that a thread can be pushed to
@@ -138,9 +268,14 @@ class BASE_EXPORT SchedulerThreadPoolImpl : public SchedulerThreadPool {
   // details in GetWork()).
   SchedulerLock idle_worker_threads_stack_lock_;
 
-  // Stack of idle worker threads.
+  // Stack of idle worker threads. Reclaimed worker threads stay in it.
   SchedulerWorkerThreadStack idle_worker_threads_stack_;
 
+  // Number of worker threads blocked in a ScopedBlockingCall while running a
+  // Task. Only tracked when adaptive threads are enabled. Protected by
+  // |idle_worker_threads_stack_lock_|.
+  size_t num_blocked_worker_threads_ = 0;
+
   // Signaled when all worker threads become idle.
   std::unique_ptr<ConditionVariable> idle_worker_threads_stack_cv_for_testing_;
 
@@ -7,15 +7,21 @@
 #include <stddef.h>
 
 #include <memory>
+#include <string>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
+#include "base/atomic_ref_count.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/sequenced_task_runner.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
@@ -29,6 +35,7 @@
 #include "base/threading/platform_thread.h"
 #include "base/threading/simple_thread.h"
 #include "base/threading/thread_restrictions.h"
+#include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -40,6 +47,8 @@ const size_t kNumThreadsPostingTasks = 4;
 const size_t kNumTasksPostedPerThread = 150;
 
 using IORestriction = SchedulerThreadPoolImpl::IORestriction;
+using WorkStealing = SchedulerThreadPoolImpl::WorkStealing;
+using AdaptiveThreads = SchedulerThreadPoolImpl::AdaptiveThreads;
 
 class TestDelayedTaskManager : public DelayedTaskManager {
  public:
@@ -57,14 +66,16 @@ class TestDelayedTaskManager : public DelayedTaskManager {
 };
 
 class TaskSchedulerThreadPoolImplTest
-    : public testing::TestWithParam<ExecutionMode> {
+    : public testing::TestWithParam<
+          std::tuple<ExecutionMode, WorkStealing, AdaptiveThreads>> {
  protected:
   TaskSchedulerThreadPoolImplTest() = default;
 
   void SetUp() override {
     thread_pool_ = SchedulerThreadPoolImpl::Create(
         "TestThreadPoolWithFileIO", ThreadPriority::NORMAL,
-        kNumThreadsInThreadPool, IORestriction::ALLOWED,
+        kNumThreadsInThreadPool, IORestriction::ALLOWED, work_stealing(),
+        adaptive_threads(), SchedulerAffinityPolicy::None(),
         Bind(&TaskSchedulerThreadPoolImplTest::ReEnqueueSequenceCallback,
              Unretained(this)),
         &task_tracker_, &delayed_task_manager_);
@@ -76,6 +87,12 @@ class TaskSchedulerThreadPoolImplTest
     thread_pool_->JoinForTesting();
   }
 
+  ExecutionMode execution_mode() const { return std::get<0>(GetParam()); }
+  WorkStealing work_stealing() const { return std::get<1>(GetParam()); }
+  AdaptiveThreads adaptive_threads() const {
+    return std::get<2>(GetParam());
+  }
+
   std::unique_ptr<SchedulerThreadPoolImpl> thread_pool_;
 
   TaskTracker task_tracker_;
@@ -158,7 +175,7 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostTasks) {
   std::vector<std::unique_ptr<ThreadPostingTasks>> threads_posting_tasks;
   for (size_t i = 0; i < kNumThreadsPostingTasks; ++i) {
     threads_posting_tasks.push_back(WrapUnique(new ThreadPostingTasks(
-        thread_pool_.get(), GetParam(), WaitBeforePostTask::NO_WAIT,
+        thread_pool_.get(), execution_mode(), WaitBeforePostTask::NO_WAIT,
         PostNestedTask::NO)));
     threads_posting_tasks.back()->Start();
   }
@@ -181,7 +198,7 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostTasksWaitAllThreadsIdle) {
   std::vector<std::unique_ptr<ThreadPostingTasks>> threads_posting_tasks;
   for (size_t i = 0; i < kNumThreadsPostingTasks; ++i) {
     threads_posting_tasks.push_back(WrapUnique(new ThreadPostingTasks(
-        thread_pool_.get(), GetParam(),
+        thread_pool_.get(), execution_mode(),
         WaitBeforePostTask::WAIT_FOR_ALL_THREADS_IDLE, PostNestedTask::NO)));
     threads_posting_tasks.back()->Start();
   }
@@ -203,7 +220,7 @@ TEST_P(TaskSchedulerThreadPoolImplTest, NestedPostTasks) {
   std::vector<std::unique_ptr<ThreadPostingTasks>> threads_posting_tasks;
   for (size_t i = 0; i < kNumThreadsPostingTasks; ++i) {
     threads_posting_tasks.push_back(WrapUnique(new ThreadPostingTasks(
-        thread_pool_.get(), GetParam(), WaitBeforePostTask::NO_WAIT,
+        thread_pool_.get(), execution_mode(), WaitBeforePostTask::NO_WAIT,
         PostNestedTask::YES)));
     threads_posting_tasks.back()->Start();
   }
@@ -228,8 +245,9 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostTasksWithOneAvailableThread) {
   std::vector<std::unique_ptr<test::TestTaskFactory>> blocked_task_factories;
   for (size_t i = 0; i < (kNumThreadsInThreadPool - 1); ++i) {
     blocked_task_factories.push_back(WrapUnique(new test::TestTaskFactory(
-        thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), GetParam()),
-        GetParam())));
+        thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(),
+                                                 execution_mode()),
+        execution_mode())));
     EXPECT_TRUE(blocked_task_factories.back()->PostTask(
         PostNestedTask::NO, Bind(&WaitableEvent::Wait, Unretained(&event))));
     blocked_task_factories.back()->WaitForAllTasksToRun();
@@ -238,8 +256,8 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostTasksWithOneAvailableThread) {
   // Post |kNumTasksPostedPerThread| tasks that should all run despite the fact
   // that only one thread in |thread_pool_| isn't busy.
   test::TestTaskFactory short_task_factory(
-      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), GetParam()),
-      GetParam());
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), execution_mode()),
+      execution_mode());
   for (size_t i = 0; i < kNumTasksPostedPerThread; ++i)
     EXPECT_TRUE(short_task_factory.PostTask(PostNestedTask::NO, Closure()));
   short_task_factory.WaitForAllTasksToRun();
@@ -262,8 +280,9 @@ TEST_P(TaskSchedulerThreadPoolImplTest, Saturate) {
   std::vector<std::unique_ptr<test::TestTaskFactory>> factories;
   for (size_t i = 0; i < kNumThreadsInThreadPool; ++i) {
     factories.push_back(WrapUnique(new test::TestTaskFactory(
-        thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), GetParam()),
-        GetParam())));
+        thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(),
+                                                 execution_mode()),
+        execution_mode())));
     EXPECT_TRUE(factories.back()->PostTask(
         PostNestedTask::NO, Bind(&WaitableEvent::Wait, Unretained(&event))));
     factories.back()->WaitForAllTasksToRun();
@@ -280,7 +299,7 @@ TEST_P(TaskSchedulerThreadPoolImplTest, Saturate) {
 // Verify that a Task can't be posted after shutdown.
 TEST_P(TaskSchedulerThreadPoolImplTest, PostTaskAfterShutdown) {
   auto task_runner =
-      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), GetParam());
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), execution_mode());
   task_tracker_.Shutdown();
   EXPECT_FALSE(task_runner->PostTask(FROM_HERE, Bind(&ShouldNotRunCallback)));
 }
@@ -293,10 +312,11 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostDelayedTask) {
   // Post a delayed task.
   WaitableEvent task_ran(WaitableEvent::ResetPolicy::MANUAL,
                          WaitableEvent::InitialState::NOT_SIGNALED);
-  EXPECT_TRUE(thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), GetParam())
-                  ->PostDelayedTask(FROM_HERE, Bind(&WaitableEvent::Signal,
-                                                    Unretained(&task_ran)),
-                                    TimeDelta::FromSeconds(10)));
+  EXPECT_TRUE(
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), execution_mode())
+          ->PostDelayedTask(FROM_HERE,
+                            Bind(&WaitableEvent::Signal, Unretained(&task_ran)),
+                            TimeDelta::FromSeconds(10)));
 
   // The task should have been added to the DelayedTaskManager.
   EXPECT_FALSE(delayed_task_manager_.GetDelayedRunTime().is_null());
@@ -313,15 +333,82 @@ TEST_P(TaskSchedulerThreadPoolImplTest, PostDelayedTask) {
   task_ran.Wait();
 }
 
-INSTANTIATE_TEST_CASE_P(Parallel,
-                        TaskSchedulerThreadPoolImplTest,
-                        ::testing::Values(ExecutionMode::PARALLEL));
-INSTANTIATE_TEST_CASE_P(Sequenced,
-                        TaskSchedulerThreadPoolImplTest,
-                        ::testing::Values(ExecutionMode::SEQUENCED));
-INSTANTIATE_TEST_CASE_P(SingleThreaded,
-                        TaskSchedulerThreadPoolImplTest,
-                        ::testing::Values(ExecutionMode::SINGLE_THREADED));
+namespace {
+
+void IncrementCounter(int* counter) {
+  ++*counter;
+}
+
+}  // namespace
+
+// Verify that coalesced tasks posted while an equivalent task is pending don't
+// run, and that a coalesced task posted after it began running does.
+TEST_P(TaskSchedulerThreadPoolImplTest, PostCoalescedTask) {
+  // PARALLEL TaskRunners aren't SequencedTaskRunners.
+  if (execution_mode() == ExecutionMode::PARALLEL)
+    return;
+
+  auto task_runner =
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(), execution_mode());
+  SequencedTaskRunner* const sequenced_task_runner =
+      static_cast<SequencedTaskRunner*>(task_runner.get());
+
+  // Block the sequence so that the coalesced tasks are pending.
+  WaitableEvent unblock_sequence(WaitableEvent::ResetPolicy::MANUAL,
+                                 WaitableEvent::InitialState::NOT_SIGNALED);
+  EXPECT_TRUE(sequenced_task_runner->PostTask(
+      FROM_HERE,
+      Bind(&WaitableEvent::Wait, Unretained(&unblock_sequence))));
+
+  const int coalescing_token = 0;
+  int num_runs = 0;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(sequenced_task_runner->PostCoalescedTask(
+        FROM_HERE, &coalescing_token, Bind(&IncrementCounter, &num_runs)));
+  }
+
+  // Tasks run in posting order: once |sequence_done| is signaled, the
+  // coalesced task has run.
+  WaitableEvent sequence_done(WaitableEvent::ResetPolicy::AUTOMATIC,
+                              WaitableEvent::InitialState::NOT_SIGNALED);
+  const Closure signal_sequence_done =
+      Bind(&WaitableEvent::Signal, Unretained(&sequence_done));
+  EXPECT_TRUE(sequenced_task_runner->PostTask(FROM_HERE, signal_sequence_done));
+  unblock_sequence.Signal();
+  sequence_done.Wait();
+  EXPECT_EQ(1, num_runs);
+
+  EXPECT_TRUE(sequenced_task_runner->PostCoalescedTask(
+      FROM_HERE, &coalescing_token, Bind(&IncrementCounter, &num_runs)));
+  EXPECT_TRUE(sequenced_task_runner->PostTask(FROM_HERE, signal_sequence_done));
+  sequence_done.Wait();
+  EXPECT_EQ(2, num_runs);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Parallel,
+    TaskSchedulerThreadPoolImplTest,
+    ::testing::Combine(::testing::Values(ExecutionMode::PARALLEL),
+                       ::testing::Values(WorkStealing::DISABLED,
+                                         WorkStealing::ENABLED),
+                       ::testing::Values(AdaptiveThreads::DISABLED,
+                                         AdaptiveThreads::ENABLED)));
+INSTANTIATE_TEST_CASE_P(
+    Sequenced,
+    TaskSchedulerThreadPoolImplTest,
+    ::testing::Combine(::testing::Values(ExecutionMode::SEQUENCED),
+                       ::testing::Values(WorkStealing::DISABLED,
+                                         WorkStealing::ENABLED),
+                       ::testing::Values(AdaptiveThreads::DISABLED,
+                                         AdaptiveThreads::ENABLED)));
+INSTANTIATE_TEST_CASE_P(
+    SingleThreaded,
+    TaskSchedulerThreadPoolImplTest,
+    ::testing::Combine(::testing::Values(ExecutionMode::SINGLE_THREADED),
+                       ::testing::Values(WorkStealing::DISABLED,
+                                         WorkStealing::ENABLED),
+                       ::testing::Values(AdaptiveThreads::DISABLED,
+                                         AdaptiveThreads::ENABLED)));
 
 namespace {
 
@@ -364,6 +451,8 @@ TEST_P(TaskSchedulerThreadPoolImplIORestrictionTest, IORestriction) {
 
   auto thread_pool = SchedulerThreadPoolImpl::Create(
       "TestThreadPoolWithParam", ThreadPriority::NORMAL, 1U, GetParam(),
+      WorkStealing::DISABLED, AdaptiveThreads::DISABLED,
+      SchedulerAffinityPolicy::None(),
       Bind(&NotReachedReEnqueueSequenceCallback), &task_tracker,
       &delayed_task_manager);
   ASSERT_TRUE(thread_pool);
@@ -384,5 +473,300 @@ INSTANTIATE_TEST_CASE_P(IODisallowed,
                         TaskSchedulerThreadPoolImplIORestrictionTest,
                         ::testing::Values(IORestriction::DISALLOWED));
 
+namespace {
+
+// Decrements |num_remaining_tasks| and signals |tasks_ran| when it reaches 0.
+void DecrementAndSignalIfZero(AtomicRefCount* num_remaining_tasks,
+                              WaitableEvent* tasks_ran) {
+  if (!AtomicRefCountDec(num_remaining_tasks))
+    tasks_ran->Signal();
+}
+
+// Posts |num_tasks| tasks through |task_runner|, waits until they have all run
+// and signals |all_tasks_ran|. Since the tasks are posted from a worker thread
+// which is blocked until they complete, they can only run if other worker
+// threads steal them.
+void PostTasksAndWaitUntilTheyRun(scoped_refptr<TaskRunner> task_runner,
+                                  size_t num_tasks,
+                                  WaitableEvent* all_tasks_ran) {
+  AtomicRefCount num_remaining_tasks = static_cast<AtomicRefCount>(num_tasks);
+  WaitableEvent tasks_ran(WaitableEvent::ResetPolicy::MANUAL,
+                          WaitableEvent::InitialState::NOT_SIGNALED);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE, Bind(&DecrementAndSignalIfZero,
+                        Unretained(&num_remaining_tasks),
+                        Unretained(&tasks_ran))));
+  }
+  tasks_ran.Wait();
+  all_tasks_ran->Signal();
+}
+
+}  // namespace
+
+// Verify that tasks posted from a worker thread which is busy are stolen and
+// run by other worker threads when work stealing is enabled.
+TEST(TaskSchedulerThreadPoolImplWorkStealingTest, IdleThreadsStealWork) {
+  TaskTracker task_tracker;
+  DelayedTaskManager delayed_task_manager(Bind(&DoNothing));
+
+  auto thread_pool = SchedulerThreadPoolImpl::Create(
+      "TestThreadPoolWithWorkStealing", ThreadPriority::NORMAL,
+      kNumThreadsInThreadPool, IORestriction::ALLOWED, WorkStealing::ENABLED,
+      AdaptiveThreads::DISABLED, SchedulerAffinityPolicy::None(),
+      Bind(&NotReachedReEnqueueSequenceCallback), &task_tracker,
+      &delayed_task_manager);
+  ASSERT_TRUE(thread_pool);
+
+  scoped_refptr<TaskRunner> task_runner =
+      thread_pool->CreateTaskRunnerWithTraits(TaskTraits(),
+                                              ExecutionMode::PARALLEL);
+  WaitableEvent all_tasks_ran(WaitableEvent::ResetPolicy::MANUAL,
+                              WaitableEvent::InitialState::NOT_SIGNALED);
+  task_runner->PostTask(
+      FROM_HERE, Bind(&PostTasksAndWaitUntilTheyRun, task_runner,
+                      kNumTasksPostedPerThread, Unretained(&all_tasks_ran)));
+  all_tasks_ran.Wait();
+
+  thread_pool->WaitForAllWorkerThreadsIdleForTesting();
+  thread_pool->JoinForTesting();
+}
+
+namespace {
+
+const char kAdaptiveThreadPoolName[] = "TestThreadPoolWithAdaptiveThreads";
+
+// Returns the samples of the histogram named |histogram_name| among the
+// histograms of |thread_pool|.
+std::unique_ptr<HistogramSamples> GetHistogramSamples(
+    const SchedulerThreadPoolImpl* thread_pool,
+    const std::string& histogram_name) {
+  std::vector<const HistogramBase*> histograms;
+  thread_pool->GetHistograms(&histograms);
+  for (const HistogramBase* histogram : histograms) {
+    if (histogram->histogram_name() == histogram_name)
+      return histogram->SnapshotSamples();
+  }
+  ADD_FAILURE() << "No histogram named " << histogram_name;
+  return nullptr;
+}
+
+class TaskSchedulerThreadPoolImplAdaptiveThreadsTest : public testing::Test {
+ protected:
+  TaskSchedulerThreadPoolImplAdaptiveThreadsTest()
+      : delayed_task_manager_(Bind(&DoNothing)) {}
+
+  void CreateThreadPool(size_t max_threads) {
+    thread_pool_ = SchedulerThreadPoolImpl::Create(
+        kAdaptiveThreadPoolName, ThreadPriority::NORMAL, max_threads,
+        IORestriction::ALLOWED, WorkStealing::DISABLED,
+        AdaptiveThreads::ENABLED, SchedulerAffinityPolicy::None(),
+        Bind(&NotReachedReEnqueueSequenceCallback), &task_tracker_,
+        &delayed_task_manager_);
+    ASSERT_TRUE(thread_pool_);
+  }
+
+  void TearDown() override {
+    thread_pool_->WaitForAllWorkerThreadsIdleForTesting();
+    thread_pool_->JoinForTesting();
+  }
+
+  std::unique_ptr<HistogramSamples> GetNumThreadsSamples() const {
+    return GetHistogramSamples(
+        thread_pool_.get(),
+        std::string("TaskScheduler.NumThreads.") + kAdaptiveThreadPoolName);
+  }
+
+  std::unique_ptr<HistogramSamples> GetNumBlockedWorkersSamples() const {
+    return GetHistogramSamples(thread_pool_.get(),
+                               std::string("TaskScheduler.NumBlockedWorkers.") +
+                                   kAdaptiveThreadPoolName);
+  }
+
+  // Sleeps until the number of alive worker threads has been recorded as 0
+  // at least |num_samples| times.
+  void WaitForNumThreadsZeroSamples(HistogramBase::Count num_samples) {
+    while (GetNumThreadsSamples()->GetCount(0) < num_samples)
+      PlatformThread::Sleep(TimeDelta::FromMilliseconds(1));
+  }
+
+  std::unique_ptr<SchedulerThreadPoolImpl> thread_pool_;
+
+ private:
+  TaskTracker task_tracker_;
+  DelayedTaskManager delayed_task_manager_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskSchedulerThreadPoolImplAdaptiveThreadsTest);
+};
+
+// Signals |started| and blocks until |event| is signaled.
+void SignalAndWait(WaitableEvent* started, WaitableEvent* event) {
+  started->Signal();
+  event->Wait();
+}
+
+// Stores the id of the current thread in |thread_id| and signals |event|.
+void StoreCurrentThreadId(PlatformThreadId* thread_id, WaitableEvent* event) {
+  *thread_id = PlatformThread::CurrentId();
+  event->Signal();
+}
+
+}  // namespace
+
+// Verify that a Task can run while the only allowed worker thread of an
+// adaptive thread pool is blocked on a WaitableEvent.
+TEST_F(TaskSchedulerThreadPoolImplAdaptiveThreadsTest,
+       CompensatesBlockedWorkerThread) {
+  CreateThreadPool(1U);
+  scoped_refptr<TaskRunner> task_runner =
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(),
+                                               ExecutionMode::PARALLEL);
+
+  WaitableEvent blocked_task_started(WaitableEvent::ResetPolicy::MANUAL,
+                                     WaitableEvent::InitialState::NOT_SIGNALED);
+  WaitableEvent unblock(WaitableEvent::ResetPolicy::MANUAL,
+                        WaitableEvent::InitialState::NOT_SIGNALED);
+  WaitableEvent other_task_ran(WaitableEvent::ResetPolicy::MANUAL,
+                               WaitableEvent::InitialState::NOT_SIGNALED);
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, Bind(&SignalAndWait, Unretained(&blocked_task_started),
+                      Unretained(&unblock))));
+  blocked_task_started.Wait();
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE,
+      Bind(&WaitableEvent::Signal, Unretained(&other_task_ran))));
+
+  // Without compensation, this would never return.
+  other_task_ran.Wait();
+  unblock.Signal();
+  thread_pool_->WaitForAllWorkerThreadsIdleForTesting();
+
+  std::unique_ptr<HistogramSamples> samples = GetNumBlockedWorkersSamples();
+  ASSERT_TRUE(samples);
+  EXPECT_GE(samples->GetCount(1), 1);
+}
+
+// Verify that idle worker threads are reclaimed and recreated on demand, and
+// that the number of alive worker threads is recorded each time.
+TEST_F(TaskSchedulerThreadPoolImplAdaptiveThreadsTest, ReclaimIdleThreads) {
+  CreateThreadPool(kNumThreadsInThreadPool);
+  thread_pool_->SetReclaimTimeForTesting(TimeDelta::FromMilliseconds(10));
+  scoped_refptr<TaskRunner> task_runner =
+      thread_pool_->CreateTaskRunnerWithTraits(TaskTraits(),
+                                               ExecutionMode::PARALLEL);
+
+  // No platform thread is created before a Task is posted.
+  EXPECT_EQ(0, GetNumThreadsSamples()->TotalCount());
+
+  for (HistogramBase::Count i = 1; i <= 3; ++i) {
+    WaitableEvent task_ran(WaitableEvent::ResetPolicy::MANUAL,
+                           WaitableEvent::InitialState::NOT_SIGNALED);
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE, Bind(&WaitableEvent::Signal, Unretained(&task_ran))));
+    task_ran.Wait();
+
+    // The only alive worker thread is reclaimed once it has been idle for the
+    // reclaim time.
+    WaitForNumThreadsZeroSamples(i);
+    EXPECT_EQ(i, GetNumThreadsSamples()->GetCount(1));
+  }
+}
+
+// Verify that the worker thread of a single-threaded TaskRunner isn't
+// reclaimed.
+TEST_F(TaskSchedulerThreadPoolImplAdaptiveThreadsTest,
+       SingleThreadedWorkerThreadNotReclaimed) {
+  CreateThreadPool(kNumThreadsInThreadPool);
+  thread_pool_->SetReclaimTimeForTesting(TimeDelta::FromMilliseconds(1));
+  scoped_refptr<TaskRunner> task_runner =
+      thread_pool_->CreateTaskRunnerWithTraits(
+          TaskTraits(), ExecutionMode::SINGLE_THREADED);
+
+  WaitableEvent task_ran(WaitableEvent::ResetPolicy::AUTOMATIC,
+                         WaitableEvent::InitialState::NOT_SIGNALED);
+  PlatformThreadId first_thread_id = kInvalidThreadId;
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, Bind(&StoreCurrentThreadId, Unretained(&first_thread_id),
+                      Unretained(&task_ran))));
+  task_ran.Wait();
+
+  PlatformThread::Sleep(TimeDelta::FromMilliseconds(50));
+
+  PlatformThreadId second_thread_id = kInvalidThreadId;
+  EXPECT_TRUE(task_runner->PostTask(
+      FROM_HERE, Bind(&StoreCurrentThreadId, Unretained(&second_thread_id),
+                      Unretained(&task_ran))));
+  task_ran.Wait();
+
+  EXPECT_EQ(first_thread_id, second_thread_id);
+  EXPECT_EQ(0, GetNumThreadsSamples()->GetCount(0));
+}
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+
+namespace {
+
+// Verifies that the current thread runs on |processor| and decrements
+// |num_remaining_tasks|.
+void VerifyProcessorAndDecrement(int processor,
+                                 AtomicRefCount* num_remaining_tasks,
+                                 WaitableEvent* tasks_ran) {
+  EXPECT_EQ(processor, PlatformThread::GetCurrentProcessor());
+  DecrementAndSignalIfZero(num_remaining_tasks, tasks_ran);
+}
+
+}  // namespace
+
+// Verify that the worker threads of a thread pool pinned to a processor only
+// run Tasks on that processor and that the processor is recorded in the
+// thread pool's histogram.
+TEST(TaskSchedulerThreadPoolImplAffinityTest, TasksRunOnPinnedProcessor) {
+  TaskTracker task_tracker;
+  DelayedTaskManager delayed_task_manager(Bind(&DoNothing));
+
+  // The processor on which the main thread runs is available to the process.
+  const int processor = PlatformThread::GetCurrentProcessor();
+  ASSERT_GE(processor, 0);
+
+  auto thread_pool = SchedulerThreadPoolImpl::Create(
+      "TestThreadPoolWithAffinity", ThreadPriority::NORMAL,
+      kNumThreadsInThreadPool, IORestriction::ALLOWED, WorkStealing::DISABLED,
+      AdaptiveThreads::DISABLED,
+      SchedulerAffinityPolicy::Processors(std::vector<int>(1, processor)),
+      Bind(&NotReachedReEnqueueSequenceCallback), &task_tracker,
+      &delayed_task_manager);
+  ASSERT_TRUE(thread_pool);
+
+  scoped_refptr<TaskRunner> task_runner =
+      thread_pool->CreateTaskRunnerWithTraits(TaskTraits(),
+                                              ExecutionMode::PARALLEL);
+  AtomicRefCount num_remaining_tasks =
+      static_cast<AtomicRefCount>(kNumTasksPostedPerThread);
+  WaitableEvent tasks_ran(WaitableEvent::ResetPolicy::MANUAL,
+                          WaitableEvent::InitialState::NOT_SIGNALED);
+  for (size_t i = 0; i < kNumTasksPostedPerThread; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(
+        FROM_HERE, Bind(&VerifyProcessorAndDecrement, processor,
+                        Unretained(&num_remaining_tasks),
+                        Unretained(&tasks_ran))));
+  }
+  tasks_ran.Wait();
+
+  std::vector<const HistogramBase*> histograms;
+  thread_pool->GetHistograms(&histograms);
+  // The processor histogram is the last one.
+  ASSERT_FALSE(histograms.empty());
+  std::unique_ptr<HistogramSamples> samples =
+      histograms.back()->SnapshotSamples();
+  EXPECT_GE(samples->TotalCount(),
+            static_cast<HistogramBase::Count>(kNumTasksPostedPerThread));
+  EXPECT_EQ(samples->TotalCount(), samples->GetCount(processor));
+
+  thread_pool->WaitForAllWorkerThreadsIdleForTesting();
+  thread_pool->JoinForTesting();
+}
+
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 }  // namespace internal
 }  // namespace base
@@ -17,13 +17,20 @@ namespace internal {
 std::unique_ptr<SchedulerWorkerThread> SchedulerWorkerThread::Create(
     ThreadPriority thread_priority,
     std::unique_ptr<Delegate> delegate,
-    TaskTracker* task_tracker) {
+    TaskTracker* task_tracker,
+    InitialState initial_state) {
   std::unique_ptr<SchedulerWorkerThread> worker_thread(
       new SchedulerWorkerThread(thread_priority, std::move(delegate),
                                 task_tracker));
+  if (initial_state == InitialState::DETACHED)
+    return worker_thread;
 
-  if (worker_thread->thread_handle_.is_null())
-    return nullptr;
+  {
+    AutoSchedulerLock auto_lock(worker_thread->thread_lock_);
+    worker_thread->CreateThread();
+    if (worker_thread->thread_handle_.is_null())
+      return nullptr;
+  }
   return worker_thread;
 }
 
@@ -32,6 +39,16 @@ SchedulerWorkerThread::~SchedulerWorkerThread() {
 }
 
 void SchedulerWorkerThread::WakeUp() {
+  AutoSchedulerLock auto_lock(thread_lock_);
+  if (thread_handle_.is_null()) {
+    // Don't recreate the platform thread once JoinForTesting() has been
+    // called.
+    if (ShouldExitForTesting())
+      return;
+    CreateThread();
+  }
+  // |wake_up_event_| is signaled with |thread_lock_| held so that TryDetach()
+  // can't miss it.
   wake_up_event_.Signal();
 }
 
@@ -40,26 +57,59 @@ void SchedulerWorkerThread::JoinForTesting() {
     AutoSchedulerLock auto_lock(should_exit_for_testing_lock_);
     should_exit_for_testing_ = true;
   }
-  WakeUp();
-  PlatformThread::Join(thread_handle_);
+
+  PlatformThreadHandle thread_handle;
+  {
+    AutoSchedulerLock auto_lock(thread_lock_);
+    thread_handle = thread_handle_;
+    wake_up_event_.Signal();
+  }
+
+  // A detached SchedulerWorkerThread has no platform thread to join.
+  if (!thread_handle.is_null())
+    PlatformThread::Join(thread_handle);
 }
 
 SchedulerWorkerThread::SchedulerWorkerThread(ThreadPriority thread_priority,
                                              std::unique_ptr<Delegate> delegate,
                                              TaskTracker* task_tracker)
-    : wake_up_event_(WaitableEvent::ResetPolicy::AUTOMATIC,
+    : priority_(thread_priority),
+      wake_up_event_(WaitableEvent::ResetPolicy::AUTOMATIC,
                      WaitableEvent::InitialState::NOT_SIGNALED),
       delegate_(std::move(delegate)),
-      task_tracker_(task_tracker) {
+      task_tracker_(task_tracker),
+      should_exit_for_testing_lock_(&thread_lock_) {
   DCHECK(delegate_);
   DCHECK(task_tracker_);
+}
+
+void SchedulerWorkerThread::CreateThread() {
+  thread_lock_.AssertAcquired();
+  DCHECK(thread_handle_.is_null());
 
   const size_t kDefaultStackSize = 0;
   PlatformThread::CreateWithPriority(kDefaultStackSize, this, &thread_handle_,
-                                     thread_priority);
+                                     priority_.base_priority());
+}
+
+bool SchedulerWorkerThread::TryDetach() {
+  AutoSchedulerLock auto_lock(thread_lock_);
+
+  // Don't detach if WakeUp() or JoinForTesting() was called since the sleep
+  // timeout expired. Checking |wake_up_event_| resets it, which is fine since
+  // the caller looks for work when this returns false.
+  if (wake_up_event_.IsSignaled() || ShouldExitForTesting())
+    return false;
+
+  priority_.UnbindFromCurrentThread();
+  delegate_->OnDetach();
+  PlatformThread::Detach(thread_handle_);
+  thread_handle_ = PlatformThreadHandle();
+  return true;
 }
 
 void SchedulerWorkerThread::ThreadMain() {
+  priority_.BindToCurrentThread();
   delegate_->OnMainEntry(this);
 
   // A SchedulerWorkerThread starts out sleeping.
@@ -75,13 +125,19 @@ void SchedulerWorkerThread::ThreadMain() {
         // Calling TimedWait with TimeDelta::Max is not recommended per
         // http://crbug.com/465948.
         wake_up_event_.Wait();
-      } else {
-        wake_up_event_.TimedWait(sleep_time);
+      } else if (!wake_up_event_.TimedWait(sleep_time) &&
+                 delegate_->CanDetach(this) && TryDetach()) {
+        // |this| may be destroyed or get a new platform thread as soon as
+        // TryDetach() returns. Don't access it.
+        return;
       }
       continue;
     }
 
-    task_tracker_->RunTask(sequence->PeekTask());
+    // Don't run the Task with a boost received while getting work.
+    priority_.ResetBoost();
+
+    task_tracker_->RunTask(sequence->BeginTask());
 
     const bool sequence_became_empty = sequence->PopTask();
 
@@ -93,6 +149,9 @@ void SchedulerWorkerThread::ThreadMain() {
     if (!sequence_became_empty)
       delegate_->ReEnqueueSequence(std::move(sequence));
 
+    // Boosts received while running the Task are no longer needed.
+    priority_.ResetBoost();
+
     // Calling WakeUp() guarantees that this SchedulerWorkerThread will run
     // Tasks from Sequences returned by the GetWork() method of |delegate_|
     // until it returns nullptr. Resetting |wake_up_event_| here doesn't break
@@ -100,6 +159,8 @@ void SchedulerWorkerThread::ThreadMain() {
     // if WakeUp() is called while this SchedulerWorkerThread is awake.
     wake_up_event_.Reset();
   }
+
+  priority_.UnbindFromCurrentThread();
 }
 
 bool SchedulerWorkerThread::ShouldExitForTesting() const {
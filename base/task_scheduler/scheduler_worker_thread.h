@@ -11,6 +11,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/task_scheduler/boostable_thread_priority.h"
 #include "base/task_scheduler/scheduler_lock.h"
 #include "base/task_scheduler/sequence.h"
 #include "base/threading/platform_thread.h"
@@ -29,6 +30,10 @@ class TaskTracker;
 // nullptr. It also periodically checks with its TaskTracker whether shutdown
 // has completed and exits when it has.
 //
+// A SchedulerWorkerThread can be detached from its underlying platform thread
+// when its delegate allows it after a sleep timeout. The platform thread exits
+// and a new one is created the next time WakeUp() is called.
+//
 // This class is thread-safe.
 class BASE_EXPORT SchedulerWorkerThread : public PlatformThread::Delegate {
  public:
@@ -53,25 +58,44 @@ class BASE_EXPORT SchedulerWorkerThread : public PlatformThread::Delegate {
     // call to GetWork(). GetWork() may be called before this timeout expires
     // if the thread's WakeUp() method is called.
     virtual TimeDelta GetSleepTimeout() = 0;
+
+    // Called by |worker_thread| when the timeout returned by GetSleepTimeout()
+    // expires without a wake-up. Returns true if the underlying platform
+    // thread can exit. It will be recreated on the next WakeUp().
+    virtual bool CanDetach(SchedulerWorkerThread* worker_thread) = 0;
+
+    // Called by |worker_thread| right before its underlying platform thread
+    // exits after CanDetach() returned true.
+    virtual void OnDetach() = 0;
+  };
+
+  enum class InitialState {
+    // The underlying platform thread is created by Create().
+    ALIVE,
+
+    // The underlying platform thread is created on the first WakeUp().
+    DETACHED,
   };
 
   // Creates a SchedulerWorkerThread with priority |thread_priority| that runs
   // Tasks from Sequences returned by |delegate|. |task_tracker| is used to
-  // handle shutdown behavior of Tasks. Returns nullptr if creating the
-  // underlying platform thread fails.
+  // handle shutdown behavior of Tasks. If |initial_state| is ALIVE, returns
+  // nullptr if creating the underlying platform thread fails.
   static std::unique_ptr<SchedulerWorkerThread> Create(
       ThreadPriority thread_priority,
       std::unique_ptr<Delegate> delegate,
-      TaskTracker* task_tracker);
+      TaskTracker* task_tracker,
+      InitialState initial_state);
 
   // Destroying a SchedulerWorkerThread in production is not allowed; it is
   // always leaked. In tests, it can only be destroyed after JoinForTesting()
   // has returned.
   ~SchedulerWorkerThread() override;
 
-  // Wakes up this SchedulerWorkerThread if it wasn't already awake. After this
-  // is called, this SchedulerWorkerThread will run Tasks from Sequences
-  // returned by the GetWork() method of its delegate until it returns nullptr.
+  // Wakes up this SchedulerWorkerThread if it wasn't already awake, creating a
+  // platform thread for it if it is detached. After this is called, this
+  // SchedulerWorkerThread will run Tasks from Sequences returned by the
+  // GetWork() method of its delegate until it returns nullptr.
   void WakeUp();
 
   SchedulerWorkerThread::Delegate* delegate() { return delegate_.get(); }
@@ -85,12 +109,28 @@ class BASE_EXPORT SchedulerWorkerThread : public PlatformThread::Delegate {
                         std::unique_ptr<Delegate> delegate,
                         TaskTracker* task_tracker);
 
+  // Creates the underlying platform thread. |thread_lock_| must be held.
+  void CreateThread();
+
+  // Detaches the underlying platform thread unless a wake-up or a join is
+  // pending. Returns true if the platform thread must exit.
+  bool TryDetach();
+
   // PlatformThread::Delegate:
   void ThreadMain() override;
 
   bool ShouldExitForTesting() const;
 
-  // Platform thread managed by this SchedulerWorkerThread.
+  // Priority of the underlying platform thread. Threads waiting for a Task
+  // or a SchedulerLock of this SchedulerWorkerThread can boost it until the
+  // end of the current Task.
+  BoostableThreadPriority priority_;
+
+  // Synchronizes access to |thread_handle_|.
+  mutable SchedulerLock thread_lock_;
+
+  // Platform thread managed by this SchedulerWorkerThread. Null while this
+  // SchedulerWorkerThread is detached.
   PlatformThreadHandle thread_handle_;
 
   // Event signaled to wake up this SchedulerWorkerThread.
@@ -99,7 +139,8 @@ class BASE_EXPORT SchedulerWorkerThread : public PlatformThread::Delegate {
   const std::unique_ptr<Delegate> delegate_;
   TaskTracker* const task_tracker_;
 
-  // Synchronizes access to |should_exit_for_testing_|.
+  // Synchronizes access to |should_exit_for_testing_|. Has |thread_lock_| as
+  // predecessor so that TryDetach() can check for a pending join.
   mutable SchedulerLock should_exit_for_testing_lock_;
 
   // True once JoinForTesting() has been called.
@@ -36,6 +36,12 @@ class MockSchedulerWorkerThreadDelegate
         "The mock thread is not expected to be woken before it is shutdown";
     return TimeDelta::Max();
   }
+  bool CanDetach(SchedulerWorkerThread* worker_thread) override {
+    return false;
+  }
+  void OnDetach() override {
+    ADD_FAILURE() << "This delegate never allows detaching.";
+  }
 };
 
 class TaskSchedulerWorkerThreadStackTest : public testing::Test {
@@ -43,15 +49,18 @@ class TaskSchedulerWorkerThreadStackTest : public testing::Test {
   void SetUp() override {
     thread_a_ = SchedulerWorkerThread::Create(
         ThreadPriority::NORMAL,
-        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_);
+        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_,
+        SchedulerWorkerThread::InitialState::ALIVE);
     ASSERT_TRUE(thread_a_);
     thread_b_ = SchedulerWorkerThread::Create(
         ThreadPriority::NORMAL,
-        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_);
+        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_,
+        SchedulerWorkerThread::InitialState::ALIVE);
     ASSERT_TRUE(thread_b_);
     thread_c_ = SchedulerWorkerThread::Create(
         ThreadPriority::NORMAL,
-        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_);
+        WrapUnique(new MockSchedulerWorkerThreadDelegate), &task_tracker_,
+        SchedulerWorkerThread::InitialState::ALIVE);
     ASSERT_TRUE(thread_c_);
   }
 
@@ -41,7 +41,7 @@ class TaskSchedulerWorkerThreadTest : public testing::TestWithParam<size_t> {
     worker_thread_ = SchedulerWorkerThread::Create(
         ThreadPriority::NORMAL,
         WrapUnique(new TestSchedulerWorkerThreadDelegate(this)),
-        &task_tracker_);
+        &task_tracker_, SchedulerWorkerThread::InitialState::ALIVE);
     ASSERT_TRUE(worker_thread_);
     worker_thread_set_.Signal();
     main_entry_called_.Wait();
@@ -172,6 +172,14 @@ class TaskSchedulerWorkerThreadTest : public testing::TestWithParam<size_t> {
       return TimeDelta::Max();
     }
 
+    bool CanDetach(SchedulerWorkerThread* worker_thread) override {
+      return false;
+    }
+
+    void OnDetach() override {
+      ADD_FAILURE() << "CanDetach() always returns false.";
+    }
+
    private:
     TaskSchedulerWorkerThreadTest* outer_;
   };
@@ -286,6 +294,68 @@ INSTANTIATE_TEST_CASE_P(TwoTasksPerSequence,
                         TaskSchedulerWorkerThreadTest,
                         ::testing::Values(2));
 
+// A delegate that lets its SchedulerWorkerThread detach as soon as it has been
+// idle for 1 ms.
+class DetachingSchedulerWorkerThreadDelegate
+    : public SchedulerWorkerThread::Delegate {
+ public:
+  DetachingSchedulerWorkerThreadDelegate()
+      : main_entry_called_(WaitableEvent::ResetPolicy::AUTOMATIC,
+                           WaitableEvent::InitialState::NOT_SIGNALED),
+        detached_(WaitableEvent::ResetPolicy::AUTOMATIC,
+                  WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  // SchedulerWorkerThread::Delegate:
+  void OnMainEntry(SchedulerWorkerThread* worker_thread) override {
+    main_entry_called_.Signal();
+  }
+  scoped_refptr<Sequence> GetWork(
+      SchedulerWorkerThread* worker_thread) override {
+    return nullptr;
+  }
+  void ReEnqueueSequence(scoped_refptr<Sequence> sequence) override {
+    ADD_FAILURE() << "GetWork() never returns a Sequence.";
+  }
+  TimeDelta GetSleepTimeout() override {
+    return TimeDelta::FromMilliseconds(1);
+  }
+  bool CanDetach(SchedulerWorkerThread* worker_thread) override {
+    return true;
+  }
+  void OnDetach() override { detached_.Signal(); }
+
+  WaitableEvent main_entry_called_;
+  WaitableEvent detached_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(DetachingSchedulerWorkerThreadDelegate);
+};
+
+// Verify that a detached SchedulerWorkerThread gets a new platform thread when
+// it is woken up and that it detaches again when its delegate allows it.
+TEST(TaskSchedulerWorkerThreadDetachTest, DetachAndRecreate) {
+  TaskTracker task_tracker;
+  DetachingSchedulerWorkerThreadDelegate* delegate =
+      new DetachingSchedulerWorkerThreadDelegate;
+  std::unique_ptr<SchedulerWorkerThread> worker_thread =
+      SchedulerWorkerThread::Create(
+          ThreadPriority::NORMAL, WrapUnique(delegate), &task_tracker,
+          SchedulerWorkerThread::InitialState::DETACHED);
+  ASSERT_TRUE(worker_thread);
+
+  // No platform thread is created until the first wake-up.
+  EXPECT_FALSE(delegate->main_entry_called_.TimedWait(
+      TimeDelta::FromMilliseconds(10)));
+
+  for (int i = 0; i < 3; ++i) {
+    worker_thread->WakeUp();
+    delegate->main_entry_called_.Wait();
+    delegate->detached_.Wait();
+  }
+
+  worker_thread->JoinForTesting();
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace base
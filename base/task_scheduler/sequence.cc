@@ -4,14 +4,27 @@
 
 #include "base/task_scheduler/sequence.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/logging.h"
+#include "base/task_scheduler/boostable_thread_priority.h"
 #include "base/time/time.h"
 
 namespace base {
 namespace internal {
 
+namespace {
+
+// Returns the priority of the threads which run tasks with |priority|. Mirrors
+// the thread pools of TaskSchedulerImpl.
+ThreadPriority GetThreadPriorityForTaskPriority(TaskPriority priority) {
+  return priority == TaskPriority::BACKGROUND ? ThreadPriority::BACKGROUND
+                                              : ThreadPriority::NORMAL;
+}
+
+}  // namespace
+
 Sequence::Sequence() = default;
 
 bool Sequence::PushTask(std::unique_ptr<Task> task) {
@@ -20,6 +33,15 @@ bool Sequence::PushTask(std::unique_ptr<Task> task) {
 
   AutoSchedulerLock auto_lock(lock_);
   ++num_tasks_per_priority_[static_cast<int>(task->traits.priority())];
+
+  // If a thread is running a task from the sequence, |task| can't run before
+  // that thread is done. Make sure the thread runs at least at the priority
+  // that |task| will run at.
+  if (running_thread_priority_) {
+    running_thread_priority_->Boost(
+        GetThreadPriorityForTaskPriority(task->traits.priority()));
+  }
+
   queue_.push(std::move(task));
 
   // Return true if the sequence was empty before the push.
@@ -35,6 +57,22 @@ const Task* Sequence::PeekTask() const {
   return queue_.front().get();
 }
 
+const Task* Sequence::BeginTask() {
+  AutoSchedulerLock auto_lock(lock_);
+  DCHECK(!queue_.empty());
+
+  const Task* task = queue_.front().get();
+  if (task->coalescing_token) {
+    auto it = std::find(pending_coalescing_tokens_.begin(),
+                        pending_coalescing_tokens_.end(),
+                        task->coalescing_token);
+    DCHECK(it != pending_coalescing_tokens_.end());
+    pending_coalescing_tokens_.erase(it);
+  }
+  running_thread_priority_ = BoostableThreadPriority::GetForCurrentThread();
+  return task;
+}
+
 bool Sequence::PopTask() {
   AutoSchedulerLock auto_lock(lock_);
   DCHECK(!queue_.empty());
@@ -44,6 +82,7 @@ bool Sequence::PopTask() {
   DCHECK_GT(num_tasks_per_priority_[priority_index], 0U);
   --num_tasks_per_priority_[priority_index];
 
+  running_thread_priority_ = nullptr;
   queue_.pop();
   return queue_.empty();
 }
@@ -73,6 +112,27 @@ SequenceSortKey Sequence::GetSortKey() const {
   return SequenceSortKey(priority, next_task_sequenced_time);
 }
 
+bool Sequence::BeginCoalescedPost(const void* coalescing_token) {
+  DCHECK(coalescing_token);
+
+  AutoSchedulerLock auto_lock(lock_);
+  if (std::find(pending_coalescing_tokens_.begin(),
+                pending_coalescing_tokens_.end(),
+                coalescing_token) != pending_coalescing_tokens_.end()) {
+    return false;
+  }
+  pending_coalescing_tokens_.push_back(coalescing_token);
+  return true;
+}
+
+void Sequence::CancelCoalescedPost(const void* coalescing_token) {
+  AutoSchedulerLock auto_lock(lock_);
+  auto it = std::find(pending_coalescing_tokens_.begin(),
+                      pending_coalescing_tokens_.end(), coalescing_token);
+  DCHECK(it != pending_coalescing_tokens_.end());
+  pending_coalescing_tokens_.erase(it);
+}
+
 Sequence::~Sequence() = default;
 
 }  // namespace internal
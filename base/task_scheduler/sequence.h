@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/macros.h"
@@ -21,6 +22,8 @@
 namespace base {
 namespace internal {
 
+class BoostableThreadPriority;
+
 // A sequence holds tasks that must be executed in posting order.
 //
 // Note: there is a known refcounted-ownership cycle in the Scheduler
@@ -47,15 +50,33 @@ class BASE_EXPORT Sequence : public RefCountedThreadSafe<Sequence> {
   // Returns the task in front of the sequence's queue, if any.
   const Task* PeekTask() const;
 
+  // Returns the task in front of the sequence's queue, which is about to run
+  // on the current thread. Once this is called, a new task with the same
+  // coalescing token can be added to the sequence, and adding a task of higher
+  // priority boosts the current thread's BoostableThreadPriority, if any.
+  // Cannot be called on an empty sequence.
+  const Task* BeginTask();
+
   // Removes the task in front of the sequence's queue. Returns true if the
   // sequence is empty after this operation. Cannot be called on an empty
-  // sequence.
+  // sequence. Must be called on the thread that called BeginTask().
   bool PopTask();
 
   // Returns a SequenceSortKey representing the priority of the sequence. Cannot
   // be called on an empty sequence.
   SequenceSortKey GetSortKey() const;
 
+  // Returns false if a task with |coalescing_token| is in the sequence's queue
+  // and hasn't begun running, or if another post with |coalescing_token| is in
+  // progress. Otherwise, returns true and prevents other posts with
+  // |coalescing_token| until the task posted with it begins running or
+  // CancelCoalescedPost() is called. |coalescing_token| must not be null.
+  bool BeginCoalescedPost(const void* coalescing_token);
+
+  // Allows new posts with |coalescing_token| after BeginCoalescedPost()
+  // returned true but the task couldn't be posted.
+  void CancelCoalescedPost(const void* coalescing_token);
+
  private:
   friend class RefCountedThreadSafe<Sequence>;
   ~Sequence();
@@ -70,6 +91,15 @@ class BASE_EXPORT Sequence : public RefCountedThreadSafe<Sequence> {
   size_t num_tasks_per_priority_[static_cast<int>(TaskPriority::HIGHEST) + 1] =
       {};
 
+  // Coalescing tokens of tasks which are being posted or haven't begun running.
+  // Few tokens are expected to be pending at any given time.
+  std::vector<const void*> pending_coalescing_tokens_;
+
+  // BoostableThreadPriority of the thread running a task from the sequence,
+  // between BeginTask() and PopTask(). Holding |lock_| guarantees that the
+  // thread doesn't exit while it is boosted.
+  BoostableThreadPriority* running_thread_priority_ = nullptr;
+
   DISALLOW_COPY_AND_ASSIGN(Sequence);
 };
 
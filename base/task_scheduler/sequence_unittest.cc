@@ -185,5 +185,38 @@ TEST_F(TaskSchedulerSequenceTest, GetSortKey) {
             sequence->GetSortKey());
 }
 
+TEST_F(TaskSchedulerSequenceTest, CoalescedPost) {
+  scoped_refptr<Sequence> sequence(new Sequence);
+  int token_a = 0;
+  int token_b = 0;
+
+  // Only one post with a given token can be in progress.
+  EXPECT_TRUE(sequence->BeginCoalescedPost(&token_a));
+  EXPECT_FALSE(sequence->BeginCoalescedPost(&token_a));
+  EXPECT_TRUE(sequence->BeginCoalescedPost(&token_b));
+
+  // Cancelling the post of token B allows new posts with token B.
+  sequence->CancelCoalescedPost(&token_b);
+  EXPECT_TRUE(sequence->BeginCoalescedPost(&token_b));
+  sequence->CancelCoalescedPost(&token_b);
+
+  // Push task A with token A. Token A stays pending until task A begins.
+  task_a_owned_->coalescing_token = &token_a;
+  sequence->PushTask(std::move(task_a_owned_));
+  sequence->PushTask(std::move(task_b_owned_));
+  EXPECT_FALSE(sequence->BeginCoalescedPost(&token_a));
+
+  EXPECT_EQ(task_a_, sequence->BeginTask());
+  EXPECT_TRUE(sequence->BeginCoalescedPost(&token_a));
+  sequence->CancelCoalescedPost(&token_a);
+
+  // Beginning a task without a token doesn't affect pending tokens.
+  EXPECT_FALSE(sequence->PopTask());
+  EXPECT_TRUE(sequence->BeginCoalescedPost(&token_a));
+  EXPECT_EQ(task_b_, sequence->BeginTask());
+  EXPECT_FALSE(sequence->BeginCoalescedPost(&token_a));
+  EXPECT_TRUE(sequence->PopTask());
+}
+
 }  // namespace internal
 }  // namespace base
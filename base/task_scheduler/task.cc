@@ -4,6 +4,8 @@
 
 #include "base/task_scheduler/task.h"
 
+#include "base/memory/task_node_allocator.h"
+
 namespace base {
 namespace internal {
 
@@ -19,5 +21,15 @@ Task::Task(const tracked_objects::Location& posted_from,
 
 Task::~Task() = default;
 
+// static
+void* Task::operator new(size_t size) {
+  return TaskNodeAllocator::Allocate(size);
+}
+
+// static
+void Task::operator delete(void* task) {
+  TaskNodeAllocator::Free(task);
+}
+
 }  // namespace internal
 }  // namespace base
@@ -5,6 +5,8 @@
 #ifndef BASE_TASK_SCHEDULER_TASK_H_
 #define BASE_TASK_SCHEDULER_TASK_H_
 
+#include <stddef.h>
+
 #include "base/base_export.h"
 #include "base/callback_forward.h"
 #include "base/location.h"
@@ -31,6 +33,11 @@ struct BASE_EXPORT Task : public PendingTask {
        const TimeDelta& delay);
   ~Task();
 
+  // Tasks are allocated with TaskNodeAllocator to avoid a malloc per posted
+  // task.
+  static void* operator new(size_t size);
+  static void operator delete(void* task);
+
   // The TaskTraits of this task.
   const TaskTraits traits;
 
@@ -52,6 +59,11 @@ struct BASE_EXPORT Task : public PendingTask {
   scoped_refptr<SequencedTaskRunner> sequenced_task_runner_ref;
   scoped_refptr<SingleThreadTaskRunner> single_thread_task_runner_ref;
 
+  // Token passed to SequencedTaskRunner::PostCoalescedTask(), if any. The
+  // Sequence that contains this task doesn't accept other tasks with the same
+  // token until this task starts running.
+  const void* coalescing_token = nullptr;
+
  private:
   // Disallow copies to make sure no unnecessary ref-bumps are incurred. Making
   // it move-only would be an option, but isn't necessary for now.
@@ -6,6 +6,7 @@
 #define BASE_TASK_SCHEDULER_TASK_SCHEDULER_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/callback_forward.h"
@@ -31,6 +32,13 @@ class BASE_EXPORT TaskScheduler {
                                   const TaskTraits& traits,
                                   const Closure& task) = 0;
 
+  // Posts each of |tasks| with specific |traits|, as if by calling
+  // PostTaskWithTraits() for each of them. The implementation is expected to
+  // amortize the cost of posting over the whole batch.
+  virtual void PostTasksWithTraits(const tracked_objects::Location& from_here,
+                                   const TaskTraits& traits,
+                                   const std::vector<Closure>& tasks) = 0;
+
   // Returns a TaskRunner whose PostTask invocations will result in scheduling
   // Tasks with |traits| which will be executed according to |execution_mode|.
   virtual scoped_refptr<TaskRunner> CreateTaskRunnerWithTraits(
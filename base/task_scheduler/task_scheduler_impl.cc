@@ -41,6 +41,21 @@ void TaskSchedulerImpl::PostTaskWithTraits(
       make_scoped_refptr(new Sequence), nullptr);
 }
 
+void TaskSchedulerImpl::PostTasksWithTraits(
+    const tracked_objects::Location& from_here,
+    const TaskTraits& traits,
+    const std::vector<Closure>& tasks) {
+  // Post each task as part of its own one-off single-task Sequence.
+  std::vector<std::unique_ptr<Task>> scheduler_tasks;
+  scheduler_tasks.reserve(tasks.size());
+  for (const Closure& task : tasks) {
+    scheduler_tasks.push_back(
+        WrapUnique(new Task(from_here, task, traits, TimeDelta())));
+  }
+  GetThreadPoolForTraits(traits)->PostTasksWithOneOffSequences(
+      std::move(scheduler_tasks));
+}
+
 scoped_refptr<TaskRunner> TaskSchedulerImpl::CreateTaskRunnerWithTraits(
     const TaskTraits& traits,
     ExecutionMode execution_mode) {
@@ -80,6 +95,8 @@ TaskSchedulerImpl::TaskSchedulerImpl()
 
 void TaskSchedulerImpl::Initialize() {
   using IORestriction = SchedulerThreadPoolImpl::IORestriction;
+  using WorkStealing = SchedulerThreadPoolImpl::WorkStealing;
+  using AdaptiveThreads = SchedulerThreadPoolImpl::AdaptiveThreads;
 
   const SchedulerThreadPoolImpl::ReEnqueueSequenceCallback
       re_enqueue_sequence_callback =
@@ -93,26 +110,30 @@ void TaskSchedulerImpl::Initialize() {
   // be deleted before all its thread pools have been joined.
   background_thread_pool_ = SchedulerThreadPoolImpl::Create(
       "TaskSchedulerBackground", ThreadPriority::BACKGROUND, 1U,
-      IORestriction::DISALLOWED, re_enqueue_sequence_callback, &task_tracker_,
-      &delayed_task_manager_);
+      IORestriction::DISALLOWED, WorkStealing::DISABLED,
+      AdaptiveThreads::DISABLED, SchedulerAffinityPolicy::None(),
+      re_enqueue_sequence_callback, &task_tracker_, &delayed_task_manager_);
   CHECK(background_thread_pool_);
 
   background_file_io_thread_pool_ = SchedulerThreadPoolImpl::Create(
       "TaskSchedulerBackgroundFileIO", ThreadPriority::BACKGROUND, 1U,
-      IORestriction::ALLOWED, re_enqueue_sequence_callback, &task_tracker_,
-      &delayed_task_manager_);
+      IORestriction::ALLOWED, WorkStealing::DISABLED,
+      AdaptiveThreads::ENABLED, SchedulerAffinityPolicy::None(),
+      re_enqueue_sequence_callback, &task_tracker_, &delayed_task_manager_);
   CHECK(background_file_io_thread_pool_);
 
   normal_thread_pool_ = SchedulerThreadPoolImpl::Create(
       "TaskSchedulerForeground", ThreadPriority::NORMAL, 4U,
-      IORestriction::DISALLOWED, re_enqueue_sequence_callback, &task_tracker_,
-      &delayed_task_manager_);
+      IORestriction::DISALLOWED, WorkStealing::ENABLED,
+      AdaptiveThreads::DISABLED, SchedulerAffinityPolicy::None(),
+      re_enqueue_sequence_callback, &task_tracker_, &delayed_task_manager_);
   CHECK(normal_thread_pool_);
 
   normal_file_io_thread_pool_ = SchedulerThreadPoolImpl::Create(
       "TaskSchedulerForegroundFileIO", ThreadPriority::NORMAL, 12U,
-      IORestriction::ALLOWED, re_enqueue_sequence_callback, &task_tracker_,
-      &delayed_task_manager_);
+      IORestriction::ALLOWED, WorkStealing::ENABLED,
+      AdaptiveThreads::ENABLED, SchedulerAffinityPolicy::None(),
+      re_enqueue_sequence_callback, &task_tracker_, &delayed_task_manager_);
   CHECK(normal_file_io_thread_pool_);
 
   service_thread_ = SchedulerServiceThread::Create(&task_tracker_,
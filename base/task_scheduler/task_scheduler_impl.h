@@ -6,6 +6,7 @@
 #define BASE_TASK_SCHEDULER_TASK_SCHEDULER_IMPL_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/logging.h"
@@ -41,6 +42,9 @@ class BASE_EXPORT TaskSchedulerImpl : public TaskScheduler {
   void PostTaskWithTraits(const tracked_objects::Location& from_here,
                           const TaskTraits& traits,
                           const Closure& task) override;
+  void PostTasksWithTraits(const tracked_objects::Location& from_here,
+                           const TaskTraits& traits,
+                           const std::vector<Closure>& tasks) override;
   scoped_refptr<TaskRunner> CreateTaskRunnerWithTraits(
       const TaskTraits& traits,
       ExecutionMode execution_mode) override;
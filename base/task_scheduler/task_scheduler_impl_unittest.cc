@@ -6,6 +6,7 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -167,6 +168,26 @@ TEST_P(TaskSchedulerImplTest, PostTaskWithTraits) {
   task_ran.Wait();
 }
 
+// Verifies that Tasks posted via PostTasksWithTraits with parameterized
+// TaskTraits all run on a thread with the expected priority and I/O
+// restrictions. The ExecutionMode parameter is ignored by this test.
+TEST_P(TaskSchedulerImplTest, PostTasksWithTraits) {
+  const size_t kNumTasks = 10;
+  std::vector<std::unique_ptr<WaitableEvent>> tasks_ran;
+  std::vector<Closure> tasks;
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    tasks_ran.push_back(WrapUnique(
+        new WaitableEvent(WaitableEvent::ResetPolicy::MANUAL,
+                          WaitableEvent::InitialState::NOT_SIGNALED)));
+    tasks.push_back(Bind(&VerifyTaskEnvironementAndSignalEvent,
+                         GetParam().traits,
+                         Unretained(tasks_ran.back().get())));
+  }
+  scheduler_->PostTasksWithTraits(FROM_HERE, GetParam().traits, tasks);
+  for (const auto& task_ran : tasks_ran)
+    task_ran->Wait();
+}
+
 // Verifies that Tasks posted via a TaskRunner with parameterized TaskTraits and
 // ExecutionMode run on a thread with the expected priority and I/O restrictions
 // and respect the characteristics of their ExecutionMode.
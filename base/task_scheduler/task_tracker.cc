@@ -4,9 +4,17 @@
 
 #include "base/task_scheduler/task_tracker.h"
 
+#include <stdint.h>
+
+#include <iterator>
+#include <string>
+
 #include "base/callback.h"
 #include "base/debug/task_annotator.h"
+#include "base/hash.h"
+#include "base/metrics/histogram.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/metrics/sparse_histogram.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -27,6 +35,25 @@ const char kRunFunctionName[] = "TaskSchedulerRunTask";
 // TaskScheduler.BlockShutdownTasksPostedDuringShutdown histogram.
 const HistogramBase::Sample kMaxBlockShutdownTasksPostedDuringShutdown = 1000;
 
+// Category of the trace flow that connects the post and the run of a task.
+const char kTaskFlowCategory[] =
+    TRACE_DISABLED_BY_DEFAULT("task_scheduler.flow");
+
+// Prefixes of the names of the histograms that record the latency and the run
+// duration of tasks. They are suffixed by the task's priority.
+const char kTaskLatencyHistogramPrefix[] = "TaskScheduler.TaskLatency.";
+const char kTaskRunDurationHistogramPrefix[] = "TaskScheduler.TaskRunDuration.";
+
+// Suffixes of the names of per-priority histograms, indexed by TaskPriority.
+const char* const kTaskPriorityHistogramSuffixes[] = {
+    "BackgroundTaskPriority", "UserVisibleTaskPriority",
+    "UserBlockingTaskPriority"};
+
+// A task whose latency or run duration reaches these thresholds gets the hash
+// of its posting location recorded in a sparse histogram.
+const int kLongTaskLatencyMs = 100;
+const int kLongTaskRunDurationMs = 100;
+
 void RecordNumBlockShutdownTasksPostedDuringShutdown(
     HistogramBase::Sample value) {
   UMA_HISTOGRAM_CUSTOM_COUNTS(
@@ -34,9 +61,44 @@ void RecordNumBlockShutdownTasksPostedDuringShutdown(
       kMaxBlockShutdownTasksPostedDuringShutdown, 50);
 }
 
+HistogramBase* GetTaskTimeHistogram(const char* prefix, size_t priority_index) {
+  return Histogram::FactoryTimeGet(
+      prefix + std::string(kTaskPriorityHistogramSuffixes[priority_index]),
+      TimeDelta::FromMilliseconds(1), TimeDelta::FromSeconds(10), 50,
+      HistogramBase::kUmaTargetedHistogramFlag);
+}
+
+// Returns the sample that identifies |posted_from| in a sparse histogram: the
+// hash of its "function@file:line" representation.
+HistogramBase::Sample GetLocationSample(
+    const tracked_objects::Location& posted_from) {
+  return static_cast<HistogramBase::Sample>(Hash(posted_from.ToString()));
+}
+
+// Returns the ID of the trace flow of |task|.
+uint64_t GetTaskFlowID(const Task* task) {
+  return reinterpret_cast<uintptr_t>(task);
+}
+
 }  // namespace
 
-TaskTracker::TaskTracker() = default;
+TaskTracker::TaskTracker()
+    : long_task_latency_location_histogram_(SparseHistogram::FactoryGet(
+          "TaskScheduler.LongTaskLatencyLocation",
+          HistogramBase::kUmaTargetedHistogramFlag)),
+      long_task_run_duration_location_histogram_(SparseHistogram::FactoryGet(
+          "TaskScheduler.LongTaskRunDurationLocation",
+          HistogramBase::kUmaTargetedHistogramFlag)) {
+  static_assert(arraysize(kTaskPriorityHistogramSuffixes) == kNumTaskPriorities,
+                "Each TaskPriority needs a histogram suffix.");
+  for (size_t i = 0; i < kNumTaskPriorities; ++i) {
+    task_latency_histograms_[i] =
+        GetTaskTimeHistogram(kTaskLatencyHistogramPrefix, i);
+    task_run_duration_histograms_[i] =
+        GetTaskTimeHistogram(kTaskRunDurationHistogramPrefix, i);
+  }
+}
+
 TaskTracker::~TaskTracker() = default;
 
 void TaskTracker::Shutdown() {
@@ -75,6 +137,10 @@ bool TaskTracker::WillPostTask(const Task* task) {
   debug::TaskAnnotator task_annotator;
   task_annotator.DidQueueTask(kQueueFunctionName, *task);
 
+  TRACE_EVENT_WITH_FLOW0(kTaskFlowCategory, kQueueFunctionName,
+                         TRACE_ID_MANGLE(GetTaskFlowID(task)),
+                         TRACE_EVENT_FLAG_FLOW_OUT);
+
   return true;
 }
 
@@ -93,7 +159,13 @@ void TaskTracker::RunTask(const Task* task) {
       task->traits.shutdown_behavior() !=
       TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN);
 
+  const TimeTicks start_time = TimeTicks::Now();
+
   {
+    TRACE_EVENT_WITH_FLOW0(kTaskFlowCategory, kRunFunctionName,
+                           TRACE_ID_MANGLE(GetTaskFlowID(task)),
+                           TRACE_EVENT_FLAG_FLOW_IN);
+
     // Set up TaskRunnerHandle as expected for the scope of the task.
     std::unique_ptr<SequencedTaskRunnerHandle> sequenced_task_runner_handle;
     std::unique_ptr<ThreadTaskRunnerHandle> single_thread_task_runner_handle;
@@ -113,6 +185,7 @@ void TaskTracker::RunTask(const Task* task) {
     task_annotator.RunTask(kQueueFunctionName, *task);
   }
 
+  RecordTaskTimes(task, start_time, TimeTicks::Now());
   AfterRunTask(shutdown_behavior);
 }
 
@@ -121,6 +194,18 @@ bool TaskTracker::IsShuttingDownForTesting() const {
   return !!shutdown_cv_;
 }
 
+void TaskTracker::GetHistograms(
+    std::vector<const HistogramBase*>* histograms) const {
+  DCHECK(histograms);
+  histograms->insert(histograms->end(), std::begin(task_latency_histograms_),
+                     std::end(task_latency_histograms_));
+  histograms->insert(histograms->end(),
+                     std::begin(task_run_duration_histograms_),
+                     std::end(task_run_duration_histograms_));
+  histograms->push_back(long_task_latency_location_histogram_);
+  histograms->push_back(long_task_run_duration_location_histogram_);
+}
+
 bool TaskTracker::BeforePostTask(TaskShutdownBehavior shutdown_behavior) {
   AutoSchedulerLock auto_lock(lock_);
 
@@ -197,6 +282,30 @@ bool TaskTracker::BeforeRunTask(TaskShutdownBehavior shutdown_behavior) {
   return false;
 }
 
+void TaskTracker::RecordTaskTimes(const Task* task,
+                                  TimeTicks start_time,
+                                  TimeTicks end_time) {
+  const size_t priority_index = static_cast<size_t>(task->traits.priority());
+  DCHECK_LT(priority_index, arraysize(task_latency_histograms_));
+
+  // A task that wasn't inserted in a Sequence has no latency.
+  if (!task->sequenced_time.is_null()) {
+    const TimeDelta latency = start_time - task->sequenced_time;
+    task_latency_histograms_[priority_index]->AddTime(latency);
+    if (latency >= TimeDelta::FromMilliseconds(kLongTaskLatencyMs)) {
+      long_task_latency_location_histogram_->Add(
+          GetLocationSample(task->posted_from));
+    }
+  }
+
+  const TimeDelta run_duration = end_time - start_time;
+  task_run_duration_histograms_[priority_index]->AddTime(run_duration);
+  if (run_duration >= TimeDelta::FromMilliseconds(kLongTaskRunDurationMs)) {
+    long_task_run_duration_location_histogram_->Add(
+        GetLocationSample(task->posted_from));
+  }
+}
+
 void TaskTracker::AfterRunTask(TaskShutdownBehavior shutdown_behavior) {
   if (shutdown_behavior == TaskShutdownBehavior::BLOCK_SHUTDOWN ||
       shutdown_behavior == TaskShutdownBehavior::SKIP_ON_SHUTDOWN) {
@@ -5,7 +5,10 @@
 #ifndef BASE_TASK_SCHEDULER_TASK_TRACKER_H_
 #define BASE_TASK_SCHEDULER_TASK_TRACKER_H_
 
+#include <stddef.h>
+
 #include <memory>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/callback_forward.h"
@@ -15,13 +18,20 @@
 #include "base/task_scheduler/scheduler_lock.h"
 #include "base/task_scheduler/task.h"
 #include "base/task_scheduler/task_traits.h"
+#include "base/time/time.h"
 
 namespace base {
 namespace internal {
 
 // All tasks go through the scheduler's TaskTracker when they are posted and
 // when they are executed. The TaskTracker enforces shutdown semantics and takes
-// care of tracing and profiling. This class is thread-safe.
+// care of tracing and profiling. It records the latency (delay between the
+// moment a task is inserted in its Sequence and the moment it starts running)
+// and the run duration of each task, per TaskPriority. The posting locations
+// of tasks with a long latency or run duration are recorded in sparse
+// histograms. A trace flow connects the post and the run of each task when the
+// "disabled-by-default-task_scheduler.flow" category is enabled. This class is
+// thread-safe.
 class BASE_EXPORT TaskTracker {
  public:
   TaskTracker();
@@ -48,6 +58,9 @@ class BASE_EXPORT TaskTracker {
   // but hasn't returned).
   bool IsShuttingDownForTesting() const;
 
+  // Appends the histograms recorded by this TaskTracker to |histograms|.
+  void GetHistograms(std::vector<const HistogramBase*>* histograms) const;
+
   bool shutdown_completed() const {
     AutoSchedulerLock auto_lock(lock_);
     return shutdown_completed_;
@@ -69,6 +82,23 @@ class BASE_EXPORT TaskTracker {
   // necessary.
   void AfterRunTask(TaskShutdownBehavior shutdown_behavior);
 
+  // Records the latency and the run duration of |task|, which started running
+  // at |start_time| and completed at |end_time|.
+  void RecordTaskTimes(const Task* task, TimeTicks start_time,
+                       TimeTicks end_time);
+
+  static const size_t kNumTaskPriorities =
+      static_cast<size_t>(TaskPriority::HIGHEST) + 1;
+
+  // Histograms of task latencies and run durations, indexed by TaskPriority.
+  HistogramBase* task_latency_histograms_[kNumTaskPriorities];
+  HistogramBase* task_run_duration_histograms_[kNumTaskPriorities];
+
+  // Sparse histograms of the hashed posting locations of tasks whose latency
+  // or run duration is long.
+  HistogramBase* const long_task_latency_location_histogram_;
+  HistogramBase* const long_task_run_duration_location_histogram_;
+
   // Synchronizes access to all members.
   mutable SchedulerLock lock_;
 
@@ -5,12 +5,16 @@
 #include "base/task_scheduler/task_tracker.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/bind.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/histogram_samples.h"
 #include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
 #include "base/synchronization/waitable_event.h"
@@ -409,6 +413,86 @@ TEST_P(TaskSchedulerTaskTrackerTest,
   RunTaskRunnerHandleVerificationTask(&tracker_, verify_task.get());
 }
 
+namespace {
+
+// Indexes of the histograms returned by TaskTracker::GetHistograms().
+enum TaskTrackerHistogram {
+  BACKGROUND_LATENCY_HISTOGRAM,
+  USER_VISIBLE_LATENCY_HISTOGRAM,
+  USER_BLOCKING_LATENCY_HISTOGRAM,
+  BACKGROUND_RUN_DURATION_HISTOGRAM,
+  USER_VISIBLE_RUN_DURATION_HISTOGRAM,
+  USER_BLOCKING_RUN_DURATION_HISTOGRAM,
+  LONG_LATENCY_LOCATION_HISTOGRAM,
+  LONG_RUN_DURATION_LOCATION_HISTOGRAM,
+  NUM_TASK_TRACKER_HISTOGRAMS,
+};
+
+// Returns the number of samples recorded in each histogram of |tracker|. The
+// histograms are shared by all TaskTrackers.
+std::vector<HistogramBase::Count> GetHistogramTotalCounts(
+    const TaskTracker& tracker) {
+  std::vector<const HistogramBase*> histograms;
+  tracker.GetHistograms(&histograms);
+  EXPECT_EQ(static_cast<size_t>(NUM_TASK_TRACKER_HISTOGRAMS),
+            histograms.size());
+  std::vector<HistogramBase::Count> total_counts;
+  for (const HistogramBase* histogram : histograms)
+    total_counts.push_back(histogram->SnapshotSamples()->TotalCount());
+  return total_counts;
+}
+
+void SleepForLongTaskRunDuration() {
+  PlatformThread::Sleep(TimeDelta::FromMilliseconds(100));
+}
+
+}  // namespace
+
+// Verify that the latency and the run duration of a task are recorded in the
+// histograms of its priority and that the location of a long task is recorded.
+TEST(TaskSchedulerTaskTrackerHistogramTest, TaskTimes) {
+  TaskTracker tracker;
+  std::vector<HistogramBase::Count> expected_counts =
+      GetHistogramTotalCounts(tracker);
+
+  const tracked_objects::Location posted_from = FROM_HERE;
+  Task task(posted_from, Bind(&SleepForLongTaskRunDuration),
+            TaskTraits().WithPriority(TaskPriority::USER_BLOCKING),
+            TimeDelta());
+  EXPECT_TRUE(tracker.WillPostTask(&task));
+
+  // Pretend that |task| was inserted in a Sequence a long time ago.
+  task.sequenced_time = TimeTicks::Now() - TimeDelta::FromSeconds(1);
+  tracker.RunTask(&task);
+
+  ++expected_counts[USER_BLOCKING_LATENCY_HISTOGRAM];
+  ++expected_counts[USER_BLOCKING_RUN_DURATION_HISTOGRAM];
+  ++expected_counts[LONG_LATENCY_LOCATION_HISTOGRAM];
+  ++expected_counts[LONG_RUN_DURATION_LOCATION_HISTOGRAM];
+  EXPECT_EQ(expected_counts, GetHistogramTotalCounts(tracker));
+
+  std::vector<const HistogramBase*> histograms;
+  tracker.GetHistograms(&histograms);
+  const HistogramBase::Sample location_sample =
+      static_cast<HistogramBase::Sample>(Hash(posted_from.ToString()));
+  EXPECT_LE(1, histograms[LONG_LATENCY_LOCATION_HISTOGRAM]
+                   ->SnapshotSamples()
+                   ->GetCount(location_sample));
+  EXPECT_LE(1, histograms[LONG_RUN_DURATION_LOCATION_HISTOGRAM]
+                   ->SnapshotSamples()
+                   ->GetCount(location_sample));
+
+  // A task that wasn't inserted in a Sequence only has a run duration.
+  Task unsequenced_task(FROM_HERE, Bind(&DoNothing),
+                        TaskTraits().WithPriority(TaskPriority::BACKGROUND),
+                        TimeDelta());
+  EXPECT_TRUE(tracker.WillPostTask(&unsequenced_task));
+  tracker.RunTask(&unsequenced_task);
+
+  ++expected_counts[BACKGROUND_RUN_DURATION_HISTOGRAM];
+  EXPECT_EQ(expected_counts, GetHistogramTotalCounts(tracker));
+}
+
 INSTANTIATE_TEST_CASE_P(
     ContinueOnShutdown,
     TaskSchedulerTaskTrackerTest,
@@ -11,6 +11,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/macros.h"
 #include "base/time/time.h"
@@ -195,6 +197,29 @@ class BASE_EXPORT PlatformThread {
 
   static ThreadPriority GetCurrentThreadPriority();
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Restricts the current thread to run on the logical processors whose
+  // indices are in |processors|. Returns false if |processors| doesn't contain
+  // any valid index or if the affinity can't be changed (e.g. none of
+  // |processors| is available to the process).
+  static bool SetCurrentThreadAffinity(const std::vector<int>& processors);
+
+  // Returns the index of the logical processor on which the current thread is
+  // running, or -1 on failure. The thread may be migrated to another processor
+  // at any time, so the returned value can be stale.
+  static int GetCurrentProcessor();
+
+  // Toggles the priority of the thread of the current process whose id is
+  // |thread_id|. Returns false if the priority can't be changed, e.g. because
+  // the process doesn't have the permission to raise priorities or is
+  // sandboxed (https://crbug.com/399473). SetCurrentThreadPriority() should be
+  // preferred. This is meant for undoing a priority inversion, where a low
+  // priority thread holds up a high priority thread. Don't use this for the
+  // main thread, since that would change the priority of the whole process.
+  static bool SetThreadPriority(PlatformThreadId thread_id,
+                                ThreadPriority priority);
+#endif
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(PlatformThread);
 };
@@ -5,6 +5,7 @@
 #include "base/threading/platform_thread.h"
 
 #include <errno.h>
+#include <sched.h>
 #include <stddef.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
@@ -78,6 +79,34 @@ void PlatformThread::SetName(const std::string& name) {
     DPLOG(ERROR) << "prctl(PR_SET_NAME)";
 }
 
+// static
+bool PlatformThread::SetCurrentThreadAffinity(
+    const std::vector<int>& processors) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  bool has_valid_processor = false;
+  for (int processor : processors) {
+    if (processor < 0 || processor >= CPU_SETSIZE)
+      continue;
+    CPU_SET(processor, &cpu_set);
+    has_valid_processor = true;
+  }
+  if (!has_valid_processor)
+    return false;
+
+  // A pid of 0 designates the calling thread.
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    DPLOG(ERROR) << "sched_setaffinity";
+    return false;
+  }
+  return true;
+}
+
+// static
+int PlatformThread::GetCurrentProcessor() {
+  return sched_getcpu();
+}
+
 
 void InitThreading() {
 }
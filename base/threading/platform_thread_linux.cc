@@ -90,6 +90,36 @@ void PlatformThread::SetName(const std::string& name) {
 #endif  //  !defined(OS_NACL)
 }
 
+#if !defined(OS_NACL)
+// static
+bool PlatformThread::SetCurrentThreadAffinity(
+    const std::vector<int>& processors) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  bool has_valid_processor = false;
+  for (int processor : processors) {
+    if (processor < 0 || processor >= CPU_SETSIZE)
+      continue;
+    CPU_SET(processor, &cpu_set);
+    has_valid_processor = true;
+  }
+  if (!has_valid_processor)
+    return false;
+
+  // A pid of 0 designates the calling thread.
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    DPLOG(ERROR) << "sched_setaffinity";
+    return false;
+  }
+  return true;
+}
+
+// static
+int PlatformThread::GetCurrentProcessor() {
+  return sched_getcpu();
+}
+#endif  // !defined(OS_NACL)
+
 void InitThreading() {}
 
 void TerminateOnThread() {}
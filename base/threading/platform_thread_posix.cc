@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include <memory>
 
@@ -266,6 +267,23 @@ ThreadPriority PlatformThread::GetCurrentThreadPriority() {
 #endif  // !defined(OS_NACL)
 }
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// static
+bool PlatformThread::SetThreadPriority(PlatformThreadId thread_id,
+                                       ThreadPriority priority) {
+  DCHECK_NE(thread_id, getpid());
+  // Unlike SetCurrentThreadPriority(), this only uses nice values. Realtime
+  // scheduling policies are never applied to another thread.
+  const int nice_setting = internal::ThreadPriorityToNiceValue(priority);
+  if (setpriority(PRIO_PROCESS, thread_id, nice_setting)) {
+    DVPLOG(1) << "Failed to set nice value of thread (" << thread_id
+              << ") to " << nice_setting;
+    return false;
+  }
+  return true;
+}
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 #endif  // !defined(OS_MACOSX)
 
 }  // namespace base
@@ -4,6 +4,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/macros.h"
 #include "base/synchronization/waitable_event.h"
@@ -12,6 +14,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 
 #if defined(OS_POSIX)
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include "base/threading/platform_thread_internal_posix.h"
@@ -302,6 +305,33 @@ TEST(PlatformThreadTest, ThreadPriorityCurrentThread) {
   }
 }
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// Test changing the priority of another thread.
+TEST(PlatformThreadTest, SetThreadPriority) {
+  FunctionTestThread thread;
+  PlatformThreadHandle handle;
+
+  ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+  thread.WaitForTerminationReady();
+
+  // Lowering the priority of a thread is always allowed.
+  EXPECT_TRUE(PlatformThread::SetThreadPriority(thread.thread_id(),
+                                                ThreadPriority::BACKGROUND));
+  EXPECT_EQ(internal::ThreadPriorityToNiceValue(ThreadPriority::BACKGROUND),
+            getpriority(PRIO_PROCESS, thread.thread_id()));
+
+  if (IsBumpingPriorityAllowed()) {
+    EXPECT_TRUE(PlatformThread::SetThreadPriority(thread.thread_id(),
+                                                  ThreadPriority::NORMAL));
+    EXPECT_EQ(internal::ThreadPriorityToNiceValue(ThreadPriority::NORMAL),
+              getpriority(PRIO_PROCESS, thread.thread_id()));
+  }
+
+  thread.MarkForTermination();
+  PlatformThread::Join(handle);
+}
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 // Test for a function defined in platform_thread_internal_posix.cc. On OSX and
 // iOS, platform_thread_internal_posix.cc is not compiled, so these platforms
 // are excluded here, too.
@@ -362,4 +392,49 @@ TEST(PlatformThreadTest, GetNiceValueToThreadPriority) {
 }
 #endif
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+
+namespace {
+
+// Pins itself to the processor it starts running on.
+class AffinityTestThread : public PlatformThread::Delegate {
+ public:
+  AffinityTestThread() = default;
+
+  void ThreadMain() override {
+    initial_processor_ = PlatformThread::GetCurrentProcessor();
+    affinity_set_ = PlatformThread::SetCurrentThreadAffinity(
+        std::vector<int>(1, initial_processor_));
+    processor_after_affinity_set_ = PlatformThread::GetCurrentProcessor();
+  }
+
+  int initial_processor_ = -1;
+  bool affinity_set_ = false;
+  int processor_after_affinity_set_ = -1;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AffinityTestThread);
+};
+
+}  // namespace
+
+TEST(PlatformThreadTest, SetCurrentThreadAffinity) {
+  EXPECT_FALSE(PlatformThread::SetCurrentThreadAffinity(std::vector<int>()));
+  EXPECT_FALSE(
+      PlatformThread::SetCurrentThreadAffinity(std::vector<int>(1, -1)));
+
+  // Change the affinity of a separate thread so that the affinity of the main
+  // thread is left untouched.
+  AffinityTestThread thread;
+  PlatformThreadHandle handle;
+  ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+  PlatformThread::Join(handle);
+
+  ASSERT_GE(thread.initial_processor_, 0);
+  EXPECT_TRUE(thread.affinity_set_);
+  EXPECT_EQ(thread.initial_processor_, thread.processor_after_affinity_set_);
+}
+
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 }  // namespace base
@@ -0,0 +1,41 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/threading/scoped_blocking_call.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+
+namespace {
+
+LazyInstance<ThreadLocalPointer<internal::BlockingObserver>>::Leaky
+    tls_blocking_observer = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+namespace internal {
+
+void SetBlockingObserverForCurrentThread(
+    BlockingObserver* blocking_observer) {
+  DCHECK(!blocking_observer || !tls_blocking_observer.Get().Get());
+  tls_blocking_observer.Get().Set(blocking_observer);
+}
+
+}  // namespace internal
+
+ScopedBlockingCall::ScopedBlockingCall()
+    : blocking_observer_(tls_blocking_observer.Get().Get()) {
+  if (blocking_observer_)
+    blocking_observer_->BlockingStarted();
+}
+
+ScopedBlockingCall::~ScopedBlockingCall() {
+  if (blocking_observer_)
+    blocking_observer_->BlockingEnded();
+}
+
+}  // namespace base
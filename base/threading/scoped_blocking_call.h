@@ -0,0 +1,53 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_THREADING_SCOPED_BLOCKING_CALL_H_
+#define BASE_THREADING_SCOPED_BLOCKING_CALL_H_
+
+#include "base/base_export.h"
+#include "base/macros.h"
+
+namespace base {
+
+namespace internal {
+
+// Interface for an observer that is notified when the thread on which it is
+// registered enters and leaves a ScopedBlockingCall. Calls can be nested.
+class BASE_EXPORT BlockingObserver {
+ public:
+  virtual ~BlockingObserver() = default;
+
+  // Invoked when a ScopedBlockingCall is constructed on the observed thread.
+  virtual void BlockingStarted() = 0;
+
+  // Invoked when a ScopedBlockingCall is destroyed on the observed thread.
+  virtual void BlockingEnded() = 0;
+};
+
+// Registers |blocking_observer| on the current thread. Pass nullptr to
+// unregister the current observer. It is invalid to register an observer on a
+// thread that already has one.
+BASE_EXPORT void SetBlockingObserverForCurrentThread(
+    BlockingObserver* blocking_observer);
+
+}  // namespace internal
+
+// A ScopedBlockingCall annotates a scope in which the current thread may block
+// (e.g. on I/O or on another thread). It is instantiated by ScopedAllowIO and
+// by waits on a WaitableEvent. Thread pools use it to add capacity while one
+// of their threads is blocked.
+class BASE_EXPORT ScopedBlockingCall {
+ public:
+  ScopedBlockingCall();
+  ~ScopedBlockingCall();
+
+ private:
+  internal::BlockingObserver* const blocking_observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedBlockingCall);
+};
+
+}  // namespace base
+
+#endif  // BASE_THREADING_SCOPED_BLOCKING_CALL_H_
@@ -0,0 +1,89 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/threading/scoped_blocking_call.h"
+
+#include "base/macros.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class CountingBlockingObserver : public internal::BlockingObserver {
+ public:
+  CountingBlockingObserver() = default;
+
+  // internal::BlockingObserver:
+  void BlockingStarted() override {
+    ++num_started_;
+    ++depth_;
+  }
+  void BlockingEnded() override {
+    EXPECT_GT(depth_, 0);
+    --depth_;
+  }
+
+  int num_started() const { return num_started_; }
+  int depth() const { return depth_; }
+
+ private:
+  int num_started_ = 0;
+  int depth_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingBlockingObserver);
+};
+
+class ScopedBlockingCallTest : public testing::Test {
+ protected:
+  ScopedBlockingCallTest() {
+    internal::SetBlockingObserverForCurrentThread(&observer_);
+  }
+
+  ~ScopedBlockingCallTest() override {
+    internal::SetBlockingObserverForCurrentThread(nullptr);
+  }
+
+  CountingBlockingObserver observer_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedBlockingCallTest);
+};
+
+}  // namespace
+
+TEST_F(ScopedBlockingCallTest, Nested) {
+  {
+    ScopedBlockingCall outer;
+    EXPECT_EQ(1, observer_.depth());
+    {
+      ScopedBlockingCall inner;
+      EXPECT_EQ(2, observer_.depth());
+    }
+    EXPECT_EQ(1, observer_.depth());
+  }
+  EXPECT_EQ(0, observer_.depth());
+  EXPECT_EQ(2, observer_.num_started());
+}
+
+TEST_F(ScopedBlockingCallTest, ScopedAllowIO) {
+  {
+    ThreadRestrictions::ScopedAllowIO allow_io;
+    EXPECT_EQ(1, observer_.depth());
+  }
+  EXPECT_EQ(0, observer_.depth());
+}
+
+TEST_F(ScopedBlockingCallTest, WaitableEvent) {
+  WaitableEvent event(WaitableEvent::ResetPolicy::MANUAL,
+                      WaitableEvent::InitialState::NOT_SIGNALED);
+  EXPECT_FALSE(event.TimedWait(TimeDelta::FromMilliseconds(1)));
+  EXPECT_EQ(0, observer_.depth());
+  EXPECT_EQ(1, observer_.num_started());
+}
+
+}  // namespace base
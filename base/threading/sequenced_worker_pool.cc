@@ -25,6 +25,8 @@
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/task_scheduler/task_scheduler.h"
+#include "base/task_scheduler/task_traits.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/simple_thread.h"
 #include "base/threading/thread_local.h"
@@ -50,6 +52,36 @@ namespace base {
 
 namespace {
 
+// Whether SequencedWorkerPools constructed from now on post their tasks to
+// TaskScheduler. See SequencedWorkerPool::RedirectToTaskSchedulerForProcess().
+bool g_redirect_to_task_scheduler = false;
+
+// Describes the task redirected to TaskScheduler that is running on the current
+// thread. Plays the role of SequencedWorkerPool::Worker for such tasks.
+struct RedirectedTaskInfo {
+  SequencedWorkerPool* pool;
+  int sequence_token_id;
+  SequencedWorkerPool::WorkerShutdown shutdown_behavior;
+};
+
+LazyInstance<ThreadLocalPointer<RedirectedTaskInfo>>::Leaky
+    g_redirected_task_info = LAZY_INSTANCE_INITIALIZER;
+
+// Returns the TaskShutdownBehavior equivalent to |shutdown_behavior|.
+TaskShutdownBehavior ToTaskShutdownBehavior(
+    SequencedWorkerPool::WorkerShutdown shutdown_behavior) {
+  switch (shutdown_behavior) {
+    case SequencedWorkerPool::CONTINUE_ON_SHUTDOWN:
+      return TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN;
+    case SequencedWorkerPool::SKIP_ON_SHUTDOWN:
+      return TaskShutdownBehavior::SKIP_ON_SHUTDOWN;
+    case SequencedWorkerPool::BLOCK_SHUTDOWN:
+      return TaskShutdownBehavior::BLOCK_SHUTDOWN;
+  }
+  NOTREACHED();
+  return TaskShutdownBehavior::BLOCK_SHUTDOWN;
+}
+
 struct SequencedTask : public TrackingInfo  {
   SequencedTask()
       : sequence_token_id(0),
@@ -349,6 +381,26 @@ class SequencedWorkerPool::Inner {
     CLEANUP_DONE,
   };
 
+  // Called from within the lock when this pool is redirected to TaskScheduler.
+  // Returns the TaskRunner to which a task with |sequence_token_id| and
+  // |shutdown_behavior| must be posted and counts the task as pending.
+  scoped_refptr<TaskRunner> LockedGetRedirectedTaskRunner(
+      int sequence_token_id,
+      WorkerShutdown shutdown_behavior,
+      bool is_delayed);
+
+  // Called from within the lock when a task returned by
+  // LockedGetRedirectedTaskRunner() has run or couldn't be posted.
+  void LockedDidRunRedirectedTask(int sequence_token_id, bool is_delayed);
+
+  // Runs |task| on a TaskScheduler thread on behalf of this pool. |pool| keeps
+  // this pool alive until the task has run or has been deleted.
+  void RunRedirectedTask(scoped_refptr<SequencedWorkerPool> pool,
+                         int sequence_token_id,
+                         WorkerShutdown shutdown_behavior,
+                         bool is_delayed,
+                         const Closure& task);
+
   // Called from within the lock, this converts the given token name into a
   // token ID, creating a new one if necessary.
   int LockedGetNamedTokenID(const std::string& name);
@@ -417,6 +469,10 @@ class SequencedWorkerPool::Inner {
 
   SequencedWorkerPool* const worker_pool_;
 
+  // True if the tasks of this pool run in TaskScheduler instead of on
+  // |threads_|. In that case, |pending_tasks_| and |threads_| remain empty.
+  const bool redirected_to_task_scheduler_;
+
   // The last sequence number used. Managed by GetSequenceToken, since this
   // only does threadsafe increment operations, you do not need to hold the
   // lock. This is class-static to make SequenceTokens issued by
@@ -495,6 +551,42 @@ class SequencedWorkerPool::Inner {
   size_t cleanup_idlers_;
   ConditionVariable cleanup_cv_;
 
+  // A TaskScheduler Sequence used by the tasks of a sequence token when this
+  // pool is redirected to TaskScheduler.
+  struct RedirectedSequence {
+    scoped_refptr<TaskRunner> task_runner;
+
+    // Number of tasks posted to |task_runner| or held in |deferred_tasks|
+    // that haven't run yet, plus one while |bound_to_running_task| is true.
+    // The RedirectedSequence is deleted when this reaches zero.
+    size_t num_pending_tasks = 0;
+
+    // True while the unsequenced task that got this sequence token from
+    // GetSequencedTaskRunnerForCurrentThread() is running. Tasks posted with
+    // the token in the meantime are held in |deferred_tasks| and posted to
+    // |task_runner| once that task has run.
+    bool bound_to_running_task = false;
+
+    struct DeferredTask {
+      tracked_objects::Location from_here;
+      Closure task;
+      TimeDelta delay;
+    };
+    std::vector<DeferredTask> deferred_tasks;
+  };
+
+  // RedirectedSequences indexed by sequence token ID.
+  std::map<int, RedirectedSequence> redirected_sequences_;
+
+  // TaskRunners for unsequenced tasks redirected to TaskScheduler, indexed by
+  // shutdown behavior.
+  scoped_refptr<TaskRunner>
+      redirected_unsequenced_task_runners_[BLOCK_SHUTDOWN + 1];
+
+  // Number of non-delayed tasks redirected to TaskScheduler that haven't run
+  // yet. CleanupForTesting() waits for it to reach zero on |cleanup_cv_|.
+  size_t num_pending_redirected_tasks_ = 0;
+
   TestingObserver* const testing_observer_;
 
   DISALLOW_COPY_AND_ASSIGN(Inner);
@@ -558,6 +650,7 @@ SequencedWorkerPool::Inner::Inner(
     const std::string& thread_name_prefix,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
+      redirected_to_task_scheduler_(g_redirect_to_task_scheduler),
       lock_(),
       has_work_cv_(&lock_),
       can_shutdown_cv_(&lock_),
@@ -622,6 +715,8 @@ bool SequencedWorkerPool::Inner::PostTask(
   sequenced.time_to_run = TimeTicks::Now() + delay;
 
   int create_thread_id = 0;
+  scoped_refptr<TaskRunner> redirected_task_runner;
+  Closure redirected_task;
   {
     AutoLock lock(lock_);
     if (shutdown_called_) {
@@ -631,11 +726,21 @@ bool SequencedWorkerPool::Inner::PostTask(
 
       // If the current thread is running a task, and that task doesn't block
       // shutdown, then it shouldn't be allowed to post any more tasks.
-      ThreadMap::const_iterator found =
-          threads_.find(PlatformThread::CurrentId());
-      if (found != threads_.end() && found->second->is_processing_task() &&
-          found->second->task_shutdown_behavior() != BLOCK_SHUTDOWN) {
-        return false;
+      if (redirected_to_task_scheduler_) {
+        const RedirectedTaskInfo* const redirected_task_info =
+            g_redirected_task_info.Get().Get();
+        if (redirected_task_info &&
+            redirected_task_info->pool == worker_pool_ &&
+            redirected_task_info->shutdown_behavior != BLOCK_SHUTDOWN) {
+          return false;
+        }
+      } else {
+        ThreadMap::const_iterator found =
+            threads_.find(PlatformThread::CurrentId());
+        if (found != threads_.end() && found->second->is_processing_task() &&
+            found->second->task_shutdown_behavior() != BLOCK_SHUTDOWN) {
+          return false;
+        }
       }
 
       if (max_blocking_tasks_after_shutdown_ <= 0) {
@@ -659,11 +764,43 @@ bool SequencedWorkerPool::Inner::PostTask(
     if (optional_token_name)
       sequenced.sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
 
-    pending_tasks_.insert(sequenced);
-    if (shutdown_behavior == BLOCK_SHUTDOWN)
-      blocking_shutdown_pending_task_count_++;
+    if (redirected_to_task_scheduler_) {
+      redirected_task_runner = LockedGetRedirectedTaskRunner(
+          sequenced.sequence_token_id, shutdown_behavior, !delay.is_zero());
+      redirected_task = Bind(&Inner::RunRedirectedTask, Unretained(this),
+                             make_scoped_refptr(worker_pool_),
+                             sequenced.sequence_token_id, shutdown_behavior,
+                             !delay.is_zero(), sequenced.task);
+      if (sequenced.sequence_token_id != 0) {
+        RedirectedSequence& sequence =
+            redirected_sequences_[sequenced.sequence_token_id];
+        if (sequence.bound_to_running_task) {
+          sequence.deferred_tasks.push_back(
+              {sequenced.posted_from, redirected_task, delay});
+          return true;
+        }
+      }
+    } else {
+      pending_tasks_.insert(sequenced);
+      if (shutdown_behavior == BLOCK_SHUTDOWN)
+        blocking_shutdown_pending_task_count_++;
+
+      create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+    }
+  }
 
-    create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+  if (redirected_task_runner) {
+    // TaskScheduler handles the sequencing, delay and shutdown behavior of the
+    // task. It is posted outside the lock since TaskScheduler has its own
+    // locks.
+    if (!redirected_task_runner->PostDelayedTask(sequenced.posted_from,
+                                                 redirected_task, delay)) {
+      AutoLock lock(lock_);
+      LockedDidRunRedirectedTask(sequenced.sequence_token_id,
+                                 !delay.is_zero());
+      return false;
+    }
+    return true;
   }
 
   // Actually start the additional thread or signal an existing one now that
@@ -677,12 +814,25 @@ bool SequencedWorkerPool::Inner::PostTask(
 }
 
 bool SequencedWorkerPool::Inner::RunsTasksOnCurrentThread() const {
+  if (redirected_to_task_scheduler_) {
+    const RedirectedTaskInfo* const redirected_task_info =
+        g_redirected_task_info.Get().Get();
+    return redirected_task_info && redirected_task_info->pool == worker_pool_;
+  }
+
   AutoLock lock(lock_);
   return ContainsKey(threads_, PlatformThread::CurrentId());
 }
 
 bool SequencedWorkerPool::Inner::IsRunningSequenceOnCurrentThread(
     SequenceToken sequence_token) const {
+  if (redirected_to_task_scheduler_) {
+    const RedirectedTaskInfo* const redirected_task_info =
+        g_redirected_task_info.Get().Get();
+    return redirected_task_info && redirected_task_info->pool == worker_pool_ &&
+           sequence_token.id_ == redirected_task_info->sequence_token_id;
+  }
+
   AutoLock lock(lock_);
   ThreadMap::const_iterator found = threads_.find(PlatformThread::CurrentId());
   if (found == threads_.end())
@@ -702,11 +852,29 @@ void SequencedWorkerPool::Inner::SetRunningTaskInfoForCurrentThread(
     SequenceToken sequence_token,
     WorkerShutdown shutdown_behavior) {
   AutoLock lock(lock_);
-  ThreadMap::const_iterator found = threads_.find(PlatformThread::CurrentId());
-  DCHECK(found != threads_.end());
-  DCHECK(found->second->is_processing_task());
-  DCHECK(!found->second->task_sequence_token().IsValid());
-  found->second->set_running_task_info(sequence_token, shutdown_behavior);
+  if (redirected_to_task_scheduler_) {
+    RedirectedTaskInfo* const redirected_task_info =
+        g_redirected_task_info.Get().Get();
+    DCHECK(redirected_task_info);
+    DCHECK_EQ(worker_pool_, redirected_task_info->pool);
+    DCHECK_EQ(0, redirected_task_info->sequence_token_id);
+    redirected_task_info->sequence_token_id = sequence_token.id_;
+    redirected_task_info->shutdown_behavior = shutdown_behavior;
+
+    // The new sequence token has no task yet. Hold the tasks posted with it
+    // until the current task has run.
+    RedirectedSequence& sequence = redirected_sequences_[sequence_token.id_];
+    DCHECK_EQ(0U, sequence.num_pending_tasks);
+    sequence.bound_to_running_task = true;
+    ++sequence.num_pending_tasks;
+  } else {
+    ThreadMap::const_iterator found =
+        threads_.find(PlatformThread::CurrentId());
+    DCHECK(found != threads_.end());
+    DCHECK(found->second->is_processing_task());
+    DCHECK(!found->second->task_sequence_token().IsValid());
+    found->second->set_running_task_info(sequence_token, shutdown_behavior);
+  }
 
   // Mark the sequence token as in use.
   bool success = current_sequences_.insert(sequence_token.id_).second;
@@ -721,6 +889,11 @@ void SequencedWorkerPool::Inner::CleanupForTesting() {
   CHECK_EQ(CLEANUP_DONE, cleanup_state_);
   if (shutdown_called_)
     return;
+  if (redirected_to_task_scheduler_) {
+    while (num_pending_redirected_tasks_ > 0)
+      cleanup_cv_.Wait();
+    return;
+  }
   if (pending_tasks_.empty() && waiting_thread_count_ == threads_.size())
     return;
   cleanup_state_ = CLEANUP_REQUESTED;
@@ -746,6 +919,11 @@ void SequencedWorkerPool::Inner::Shutdown(
     shutdown_called_ = true;
     max_blocking_tasks_after_shutdown_ = max_new_blocking_tasks_after_shutdown;
 
+    // TaskScheduler::Shutdown() waits for the BLOCK_SHUTDOWN tasks of a pool
+    // redirected to TaskScheduler.
+    if (redirected_to_task_scheduler_)
+      return;
+
     // Tickle the threads. This will wake up a waiting one so it will know that
     // it can exit, which in turn will wake up any other waiting ones.
     SignalHasWork();
@@ -977,6 +1155,127 @@ int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
   return result.id_;
 }
 
+scoped_refptr<TaskRunner>
+SequencedWorkerPool::Inner::LockedGetRedirectedTaskRunner(
+    int sequence_token_id,
+    WorkerShutdown shutdown_behavior,
+    bool is_delayed) {
+  lock_.AssertAcquired();
+  DCHECK(redirected_to_task_scheduler_);
+
+  TaskScheduler* const task_scheduler = TaskScheduler::GetInstance();
+  DCHECK(task_scheduler);
+  // SequencedWorkerPool has no notion of priority and allows blocking. Its
+  // tasks run in the foreground pools of TaskScheduler that allow file I/O.
+  const TaskTraits traits =
+      TaskTraits()
+          .WithFileIO()
+          .WithPriority(TaskPriority::USER_VISIBLE)
+          .WithShutdownBehavior(ToTaskShutdownBehavior(shutdown_behavior));
+
+  if (!is_delayed)
+    ++num_pending_redirected_tasks_;
+
+  if (sequence_token_id == 0) {
+    scoped_refptr<TaskRunner>& task_runner =
+        redirected_unsequenced_task_runners_[shutdown_behavior];
+    if (!task_runner) {
+      task_runner = task_scheduler->CreateTaskRunnerWithTraits(
+          traits, ExecutionMode::PARALLEL);
+    }
+    return task_runner;
+  }
+
+  // All the tasks of a sequence token share a TaskScheduler Sequence for as
+  // long as some of them haven't run. The Sequence has the shutdown behavior
+  // of the task that created it.
+  RedirectedSequence& sequence = redirected_sequences_[sequence_token_id];
+  if (!sequence.task_runner) {
+    sequence.task_runner = task_scheduler->CreateTaskRunnerWithTraits(
+        traits, ExecutionMode::SEQUENCED);
+  }
+  ++sequence.num_pending_tasks;
+  return sequence.task_runner;
+}
+
+void SequencedWorkerPool::Inner::LockedDidRunRedirectedTask(
+    int sequence_token_id,
+    bool is_delayed) {
+  lock_.AssertAcquired();
+  DCHECK(redirected_to_task_scheduler_);
+
+  if (sequence_token_id != 0) {
+    auto it = redirected_sequences_.find(sequence_token_id);
+    DCHECK(it != redirected_sequences_.end());
+    DCHECK_GT(it->second.num_pending_tasks, 0U);
+    if (--it->second.num_pending_tasks == 0)
+      redirected_sequences_.erase(it);
+  }
+
+  if (!is_delayed) {
+    DCHECK_GT(num_pending_redirected_tasks_, 0U);
+    if (--num_pending_redirected_tasks_ == 0)
+      cleanup_cv_.Broadcast();
+  }
+}
+
+void SequencedWorkerPool::Inner::RunRedirectedTask(
+    scoped_refptr<SequencedWorkerPool> pool,
+    int sequence_token_id,
+    WorkerShutdown shutdown_behavior,
+    bool is_delayed,
+    const Closure& task) {
+  DCHECK_EQ(worker_pool_, pool.get());
+  DCHECK(!g_redirected_task_info.Get().Get());
+
+  {
+    AutoLock lock(lock_);
+    if (sequence_token_id != 0) {
+      bool success = current_sequences_.insert(sequence_token_id).second;
+      DCHECK(success);
+    }
+  }
+
+  RedirectedTaskInfo redirected_task_info = {worker_pool_, sequence_token_id,
+                                             shutdown_behavior};
+  g_redirected_task_info.Get().Set(&redirected_task_info);
+  task.Run();
+  g_redirected_task_info.Get().Set(nullptr);
+
+  // Deleted outside the lock since a task may own a reference to the pool.
+  std::vector<RedirectedSequence::DeferredTask> deferred_tasks;
+
+  AutoLock lock(lock_);
+  if (redirected_task_info.sequence_token_id != 0)
+    current_sequences_.erase(redirected_task_info.sequence_token_id);
+
+  // Post the tasks held while the sequence token assigned by
+  // GetSequencedTaskRunnerForCurrentThread() was bound to |task|. They are
+  // posted within the lock so that tasks posted concurrently with the token
+  // can't get ahead of them.
+  if (redirected_task_info.sequence_token_id != sequence_token_id) {
+    const int bound_sequence_token_id = redirected_task_info.sequence_token_id;
+    RedirectedSequence& sequence =
+        redirected_sequences_[bound_sequence_token_id];
+    DCHECK(sequence.bound_to_running_task);
+    sequence.bound_to_running_task = false;
+    deferred_tasks.swap(sequence.deferred_tasks);
+    for (const auto& deferred_task : deferred_tasks) {
+      if (!sequence.task_runner->PostDelayedTask(deferred_task.from_here,
+                                                 deferred_task.task,
+                                                 deferred_task.delay)) {
+        LockedDidRunRedirectedTask(bound_sequence_token_id,
+                                   !deferred_task.delay.is_zero());
+      }
+    }
+    // Release the count held by SetRunningTaskInfoForCurrentThread(). Like a
+    // delayed task, it isn't counted by FlushForTesting().
+    LockedDidRunRedirectedTask(bound_sequence_token_id, true);
+  }
+
+  LockedDidRunRedirectedTask(sequence_token_id, is_delayed);
+}
+
 int64_t SequencedWorkerPool::Inner::LockedGetNextSequenceTaskNumber() {
   lock_.AssertAcquired();
   // We assume that we never create enough tasks to wrap around.
@@ -1202,6 +1501,16 @@ SequencedWorkerPool::Inner::g_last_sequence_number_;
 
 // SequencedWorkerPool --------------------------------------------------------
 
+// static
+void SequencedWorkerPool::RedirectToTaskSchedulerForProcess() {
+  g_redirect_to_task_scheduler = true;
+}
+
+// static
+void SequencedWorkerPool::ResetRedirectToTaskSchedulerForProcessForTesting() {
+  g_redirect_to_task_scheduler = false;
+}
+
 std::string SequencedWorkerPool::SequenceToken::ToString() const {
   return base::StringPrintf("[%d]", id_);
 }
@@ -1210,8 +1519,13 @@ std::string SequencedWorkerPool::SequenceToken::ToString() const {
 SequencedWorkerPool::SequenceToken
 SequencedWorkerPool::GetSequenceTokenForCurrentThread() {
   Worker* worker = Worker::GetForCurrentThread();
-  if (!worker)
-    return SequenceToken();
+  if (!worker) {
+    const RedirectedTaskInfo* const redirected_task_info =
+        g_redirected_task_info.Get().Get();
+    if (!redirected_task_info)
+      return SequenceToken();
+    return SequenceToken(redirected_task_info->sequence_token_id);
+  }
 
   return worker->task_sequence_token();
 }
@@ -1220,8 +1534,13 @@ SequencedWorkerPool::GetSequenceTokenForCurrentThread() {
 scoped_refptr<SequencedWorkerPool>
 SequencedWorkerPool::GetWorkerPoolForCurrentThread() {
   Worker* worker = Worker::GetForCurrentThread();
-  if (!worker)
-    return nullptr;
+  if (!worker) {
+    const RedirectedTaskInfo* const redirected_task_info =
+        g_redirected_task_info.Get().Get();
+    if (!redirected_task_info)
+      return nullptr;
+    return redirected_task_info->pool;
+  }
 
   return worker->worker_pool();
 }
@@ -1230,15 +1549,27 @@ SequencedWorkerPool::GetWorkerPoolForCurrentThread() {
 scoped_refptr<SequencedTaskRunner>
 SequencedWorkerPool::GetSequencedTaskRunnerForCurrentThread() {
   Worker* worker = Worker::GetForCurrentThread();
+  const RedirectedTaskInfo* const redirected_task_info =
+      g_redirected_task_info.Get().Get();
 
-  // If there is no worker, this thread is not a worker thread. Otherwise, it is
-  // currently running a task (sequenced or unsequenced).
-  if (!worker)
+  // If there is no worker and no redirected task, this thread is not running a
+  // task of a SequencedWorkerPool. Otherwise, it is currently running a task
+  // (sequenced or unsequenced).
+  if (!worker && !redirected_task_info)
     return nullptr;
 
-  scoped_refptr<SequencedWorkerPool> pool = worker->worker_pool();
-  SequenceToken sequence_token = worker->task_sequence_token();
-  WorkerShutdown shutdown_behavior = worker->task_shutdown_behavior();
+  scoped_refptr<SequencedWorkerPool> pool;
+  SequenceToken sequence_token;
+  WorkerShutdown shutdown_behavior;
+  if (worker) {
+    pool = worker->worker_pool();
+    sequence_token = worker->task_sequence_token();
+    shutdown_behavior = worker->task_shutdown_behavior();
+  } else {
+    pool = redirected_task_info->pool;
+    sequence_token = SequenceToken(redirected_task_info->sequence_token_id);
+    shutdown_behavior = redirected_task_info->shutdown_behavior;
+  }
   if (!sequence_token.IsValid()) {
     // Create a new sequence token and bind this thread to it, to make sure that
     // a task posted to the SequencedTaskRunner we are going to return is not
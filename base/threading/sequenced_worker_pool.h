@@ -181,6 +181,25 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
   // current thread is not a SequencedWorkerPool worker thread.
   static scoped_refptr<SequencedWorkerPool> GetWorkerPoolForCurrentThread();
 
+  // Makes the SequencedWorkerPools constructed from now on post their tasks to
+  // TaskScheduler instead of running them on their own threads. A sequence
+  // token maps onto a TaskScheduler Sequence and the shutdown behavior of a
+  // task maps onto the equivalent TaskShutdownBehavior. Must be called before
+  // any SequencedWorkerPool is constructed and TaskScheduler::GetInstance()
+  // must be set before a task is posted.
+  //
+  // When redirected:
+  // - Tasks have USER_VISIBLE priority and are allowed to do file I/O.
+  // - Shutdown() doesn't wait for BLOCK_SHUTDOWN tasks; TaskScheduler's
+  //   Shutdown() does.
+  // - The tasks of a sequence token get the shutdown behavior of the first
+  //   task posted with the token while none of its tasks were pending.
+  static void RedirectToTaskSchedulerForProcess();
+
+  // Undoes RedirectToTaskSchedulerForProcess() for SequencedWorkerPools
+  // constructed from now on.
+  static void ResetRedirectToTaskSchedulerForProcessForTesting();
+
   // When constructing a SequencedWorkerPool, there must be a
   // ThreadTaskRunnerHandle on the current thread unless you plan to
   // deliberately leak it.
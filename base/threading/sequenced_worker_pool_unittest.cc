@@ -19,6 +19,8 @@
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/task_scheduler/task_scheduler.h"
+#include "base/task_scheduler/task_scheduler_impl.h"
 #include "base/test/sequenced_task_runner_test_template.h"
 #include "base/test/sequenced_worker_pool_owner.h"
 #include "base/test/task_runner_test_template.h"
@@ -957,6 +959,15 @@ void VerifyCurrentSequencedTaskRunnerForUnsequencedTask(
                              expected_equal, callback));
 }
 
+// Posts a task to the SequencedTaskRunner of the current unsequenced task and
+// blocks on |blocker|.
+void PostToCurrentSequenceAndBlock(scoped_refptr<TestTracker> tracker,
+                                   ThreadBlocker* blocker) {
+  SequencedWorkerPool::GetSequencedTaskRunnerForCurrentThread()->PostTask(
+      FROM_HERE, Bind(&TestTracker::FastTask, tracker, 2));
+  tracker->BlockTask(1, blocker);
+}
+
 TEST_F(SequencedWorkerPoolTest, GetSequencedTaskRunnerForCurrentThread) {
   EnsureAllWorkersCreated();
 
@@ -1043,6 +1054,194 @@ TEST_F(SequencedWorkerPoolTest, ShutsDownCleanWithContinueOnShutdown) {
   pool()->Shutdown();
 }
 
+// Fixture for tests of a SequencedWorkerPool redirected to TaskScheduler.
+class SequencedWorkerPoolRedirectedTest : public testing::Test {
+ public:
+  SequencedWorkerPoolRedirectedTest() : tracker_(new TestTracker) {}
+
+  void SetUp() override {
+    std::unique_ptr<internal::TaskSchedulerImpl> task_scheduler =
+        internal::TaskSchedulerImpl::Create();
+    task_scheduler_ = task_scheduler.get();
+    TaskScheduler::SetInstance(std::move(task_scheduler));
+    SequencedWorkerPool::RedirectToTaskSchedulerForProcess();
+    pool_owner_.reset(new SequencedWorkerPoolOwner(kNumWorkerThreads, "test"));
+  }
+
+  void TearDown() override {
+    pool()->Shutdown();
+    if (!task_scheduler_shut_down_)
+      ShutdownTaskScheduler();
+    task_scheduler_->JoinForTesting();
+
+    // Deleting the TaskScheduler deletes the tasks that didn't run and the
+    // references to the pool that they own.
+    TaskScheduler::SetInstance(nullptr);
+    pool_owner_.reset();
+    SequencedWorkerPool::ResetRedirectToTaskSchedulerForProcessForTesting();
+  }
+
+  const scoped_refptr<SequencedWorkerPool>& pool() {
+    return pool_owner_->pool();
+  }
+  TestTracker* tracker() { return tracker_.get(); }
+
+  void ShutdownTaskScheduler() {
+    DCHECK(!task_scheduler_shut_down_);
+    task_scheduler_->Shutdown();
+    task_scheduler_shut_down_ = true;
+  }
+
+ private:
+  MessageLoop message_loop_;
+  internal::TaskSchedulerImpl* task_scheduler_ = nullptr;
+  bool task_scheduler_shut_down_ = false;
+  std::unique_ptr<SequencedWorkerPoolOwner> pool_owner_;
+  const scoped_refptr<TestTracker> tracker_;
+};
+
+// Verify that tasks posted with the same sequence token run in order and that
+// unsequenced tasks aren't blocked by a sequence.
+TEST_F(SequencedWorkerPoolRedirectedTest, Sequence) {
+  ThreadBlocker blocker;
+  SequencedWorkerPool::SequenceToken token = pool()->GetSequenceToken();
+  pool()->PostSequencedWorkerTask(
+      token, FROM_HERE,
+      base::Bind(&TestTracker::BlockTask, tracker(), 100, &blocker));
+  pool()->PostSequencedWorkerTask(
+      token, FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 101));
+  tracker()->WaitUntilTasksBlocked(1);
+
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::FastTask, tracker(), 200));
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(1);
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(200, result[0]);
+
+  blocker.Unblock(1);
+  result = tracker()->WaitUntilTasksComplete(3);
+  ASSERT_EQ(3u, result.size());
+  EXPECT_EQ(100, result[1]);
+  EXPECT_EQ(101, result[2]);
+}
+
+TEST_F(SequencedWorkerPoolRedirectedTest, IsRunningOnCurrentThread) {
+  SequencedWorkerPool::SequenceToken token1 = pool()->GetSequenceToken();
+  SequencedWorkerPool::SequenceToken token2 = pool()->GetSequenceToken();
+  SequencedWorkerPool::SequenceToken unsequenced_token;
+
+  SequencedWorkerPoolOwner unused_pool_owner(2, "unused_pool");
+
+  EXPECT_FALSE(pool()->RunsTasksOnCurrentThread());
+  EXPECT_FALSE(pool()->IsRunningSequenceOnCurrentThread(token1));
+
+  pool()->PostSequencedWorkerTask(
+      token1, FROM_HERE,
+      base::Bind(&IsRunningOnCurrentThreadTask, token1, token2,
+                 base::RetainedRef(pool()),
+                 base::RetainedRef(unused_pool_owner.pool())));
+  pool()->PostSequencedWorkerTask(
+      token2, FROM_HERE,
+      base::Bind(&IsRunningOnCurrentThreadTask, token2, unsequenced_token,
+                 base::RetainedRef(pool()),
+                 base::RetainedRef(unused_pool_owner.pool())));
+  pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&IsRunningOnCurrentThreadTask, unsequenced_token,
+                            token1, base::RetainedRef(pool()),
+                            base::RetainedRef(unused_pool_owner.pool())));
+
+  // |unused_pool_owner| must outlive the tasks.
+  pool()->FlushForTesting();
+}
+
+TEST_F(SequencedWorkerPoolRedirectedTest, FlushForTesting) {
+  pool()->FlushForTesting();
+
+  pool()->PostDelayedWorkerTask(
+      FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 0),
+      TimeDelta::FromMinutes(5));
+  const size_t kNumFastTasks = 20;
+  for (size_t i = 0; i < kNumFastTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), 0));
+  }
+  pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&TestTracker::PostAdditionalTasks, tracker(), 0,
+                            base::RetainedRef(pool()), true));
+
+  // All the tasks except the delayed one, including those posted by
+  // PostAdditionalTasks(), should have run.
+  pool()->FlushForTesting();
+  EXPECT_EQ(kNumFastTasks + 1 + 3, tracker()->GetTasksCompletedCount());
+
+  pool()->Shutdown();
+  pool()->FlushForTesting();
+}
+
+TEST_F(SequencedWorkerPoolRedirectedTest,
+       GetSequencedTaskRunnerForCurrentThread) {
+  EXPECT_FALSE(SequencedWorkerPool::GetSequencedTaskRunnerForCurrentThread());
+
+  WaitableEvent event(WaitableEvent::ResetPolicy::AUTOMATIC,
+                      WaitableEvent::InitialState::NOT_SIGNALED);
+  Closure signal = Bind(&WaitableEvent::Signal, Unretained(&event));
+  scoped_refptr<SequencedTaskRunner> task_runner_1 =
+      pool()->GetSequencedTaskRunner(SequencedWorkerPool::GetSequenceToken());
+  scoped_refptr<SequencedTaskRunner> task_runner_2 =
+      pool()->GetSequencedTaskRunner(SequencedWorkerPool::GetSequenceToken());
+  task_runner_1->PostTask(
+      FROM_HERE, Bind(&VerifyCurrentSequencedTaskRunner,
+                      base::Unretained(task_runner_1.get()), true, signal));
+  event.Wait();
+  task_runner_1->PostTask(
+      FROM_HERE, Bind(&VerifyCurrentSequencedTaskRunner,
+                      base::Unretained(task_runner_2.get()), false, signal));
+  event.Wait();
+
+  pool()->PostWorkerTask(
+      FROM_HERE, Bind(&VerifyCurrentSequencedTaskRunnerForUnsequencedTask,
+                      RetainedRef(pool()), signal));
+  event.Wait();
+}
+
+// Verify that the tasks posted to the SequencedTaskRunner of an unsequenced
+// task only run once that task has run.
+TEST_F(SequencedWorkerPoolRedirectedTest,
+       CurrentSequencedTaskRunnerOfUnsequencedTask) {
+  ThreadBlocker blocker;
+  pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&PostToCurrentSequenceAndBlock,
+                            make_scoped_refptr(tracker()), &blocker));
+  tracker()->WaitUntilTasksBlocked(1);
+
+  // Give the task posted to the current sequence a chance to run early.
+  PlatformThread::Sleep(TestTimeouts::tiny_timeout());
+  blocker.Unblock(1);
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(2);
+  ASSERT_EQ(2u, result.size());
+  EXPECT_EQ(1, result[0]);
+  EXPECT_EQ(2, result[1]);
+}
+
+// Verify that the BLOCK_SHUTDOWN tasks of a redirected pool are run by
+// TaskScheduler's Shutdown() rather than by the pool's.
+TEST_F(SequencedWorkerPoolRedirectedTest, BlockShutdown) {
+  const size_t kNumTasks = 5;
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    pool()->PostWorkerTaskWithShutdownBehavior(
+        FROM_HERE, base::Bind(&TestTracker::SlowTask, tracker(), i),
+        SequencedWorkerPool::BLOCK_SHUTDOWN);
+  }
+
+  pool()->Shutdown();
+  EXPECT_FALSE(pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 100)));
+
+  ShutdownTaskScheduler();
+  EXPECT_EQ(kNumTasks, tracker()->GetTasksCompletedCount());
+}
+
 class SequencedWorkerPoolTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerTestDelegate() {}
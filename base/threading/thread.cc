@@ -40,6 +40,7 @@ void ThreadQuitHelper() {
 Thread::Options::Options()
     : message_loop_type(MessageLoop::TYPE_DEFAULT),
       timer_slack(TIMER_SLACK_NONE),
+      delayed_work_queue_type(DelayedWorkQueueType::HEAP),
       stack_size(0),
       priority(ThreadPriority::NORMAL) {
 }
@@ -48,6 +49,7 @@ Thread::Options::Options(MessageLoop::Type type,
                          size_t size)
     : message_loop_type(type),
       timer_slack(TIMER_SLACK_NONE),
+      delayed_work_queue_type(DelayedWorkQueueType::HEAP),
       stack_size(size),
       priority(ThreadPriority::NORMAL) {
 }
@@ -70,6 +72,7 @@ Thread::Thread(const std::string& name)
                 WaitableEvent::InitialState::NOT_SIGNALED),
       message_loop_(nullptr),
       message_loop_timer_slack_(TIMER_SLACK_NONE),
+      message_loop_delayed_work_queue_type_(DelayedWorkQueueType::HEAP),
       name_(name),
       start_event_(WaitableEvent::ResetPolicy::MANUAL,
                    WaitableEvent::InitialState::NOT_SIGNALED) {
@@ -106,6 +109,7 @@ bool Thread::StartWithOptions(const Options& options) {
     type = MessageLoop::TYPE_CUSTOM;
 
   message_loop_timer_slack_ = options.timer_slack;
+  message_loop_delayed_work_queue_type_ = options.delayed_work_queue_type;
   std::unique_ptr<MessageLoop> message_loop =
       MessageLoop::CreateUnbound(type, options.message_pump_factory);
   message_loop_ = message_loop.get();
@@ -232,6 +236,8 @@ void Thread::ThreadMain() {
   std::unique_ptr<MessageLoop> message_loop(message_loop_);
   message_loop_->BindToCurrentThread();
   message_loop_->SetTimerSlack(message_loop_timer_slack_);
+  message_loop_->SetDelayedWorkQueueType(
+      message_loop_delayed_work_queue_type_);
 
 #if defined(OS_WIN)
   std::unique_ptr<win::ScopedCOMInitializer> com_initializer;
@@ -13,6 +13,7 @@
 #include "base/base_export.h"
 #include "base/callback.h"
 #include "base/macros.h"
+#include "base/message_loop/delayed_work_queue.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/timer_slack.h"
 #include "base/single_thread_task_runner.h"
@@ -55,6 +56,10 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
     // Specifies timer slack for thread message loop.
     TimerSlack timer_slack;
 
+    // Specifies the data structure used to sort the delayed tasks of the
+    // thread message loop.
+    DelayedWorkQueueType delayed_work_queue_type;
+
     // Used to create the MessagePump for the MessageLoop. The callback is Run()
     // on the thread. If message_pump_factory.is_null(), then a MessagePump
     // appropriate for |message_loop_type| is created. Setting this forces the
@@ -246,6 +251,10 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
   // a thread.
   TimerSlack message_loop_timer_slack_;
 
+  // Stores Options::delayed_work_queue_type until the message loop has been
+  // bound to a thread.
+  DelayedWorkQueueType message_loop_delayed_work_queue_type_;
+
   // The name of the thread.  Used for debugging purposes.
   std::string name_;
 
@@ -4,11 +4,16 @@
 
 #include "base/threading/thread_local_storage.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/atomicops.h"
 #include "base/logging.h"
 #include "build/build_config.h"
 
 using base::internal::PlatformThreadLocalStorage;
+using TLSDestructorFunc = base::ThreadLocalStorage::TLSDestructorFunc;
 
 namespace {
 // In order to make TLS destructors work, we need to keep around a function
@@ -31,9 +36,18 @@ base::subtle::Atomic32 g_native_tls_key =
 // g_last_used_tls_key, so that the first issued index will be 1.
 base::subtle::Atomic32 g_last_used_tls_key = 0;
 
-// The maximum number of 'slots' in our thread local storage stack.
+// The number of 'slots' stored directly in the per-thread table. Since slot 0
+// is never issued, entry 0 of the table points to the OverflowValues of the
+// thread instead, which hold the slots beyond this number.
 const int kThreadLocalStorageSize = 256;
 
+// The maximum number of 'slots' in our thread local storage stack. Destructors
+// are stored in chunks of kThreadLocalStorageSize, which are allocated when
+// the first slot of the chunk is issued.
+const int kMaxDestructorChunks = 64;
+const int kThreadLocalStorageMaxSize =
+    kMaxDestructorChunks * kThreadLocalStorageSize;
+
 // The maximum number of times to try to clear slots by calling destructors.
 // Use pthread naming convention for clarity.
 const int kMaxDestructorIterations = kThreadLocalStorageSize;
@@ -47,9 +61,113 @@ const int kMaxDestructorIterations = kThreadLocalStorageSize;
 // re-fetch an array element, and I want to be sure a call to free the key
 // (i.e., null out the destructor entry) that happens on a separate thread can't
 // hurt the racy calls to the destructors on another thread.
+// This is the first chunk of destructors. It is static so that the slots used
+// by early services (like an allocator) don't depend on the allocator.
 volatile base::ThreadLocalStorage::TLSDestructorFunc
     g_tls_destructors[kThreadLocalStorageSize];
 
+// The other chunks of destructors, allocated as slots are issued and never
+// freed. Entry 0 is unused.
+base::subtle::AtomicWord g_tls_destructor_chunks[kMaxDestructorChunks];
+
+// Returns the destructor entry of |slot|, whose chunk must have been
+// allocated.
+volatile TLSDestructorFunc* GetDestructorEntry(int slot) {
+  if (slot < kThreadLocalStorageSize)
+    return &g_tls_destructors[slot];
+  volatile TLSDestructorFunc* chunk =
+      reinterpret_cast<volatile TLSDestructorFunc*>(base::subtle::Acquire_Load(
+          &g_tls_destructor_chunks[slot / kThreadLocalStorageSize]));
+  DCHECK(chunk);
+  return &chunk[slot % kThreadLocalStorageSize];
+}
+
+// Allocates the chunk of destructors of |slot| if needed. Called when |slot|
+// is issued.
+void EnsureDestructorChunk(int slot) {
+  const int chunk_index = slot / kThreadLocalStorageSize;
+  if (chunk_index == 0 ||
+      base::subtle::Acquire_Load(&g_tls_destructor_chunks[chunk_index])) {
+    return;
+  }
+  TLSDestructorFunc* chunk = new TLSDestructorFunc[kThreadLocalStorageSize]();
+  // Another thread may be issuing a slot of the same chunk.
+  if (base::subtle::Release_CompareAndSwap(
+          &g_tls_destructor_chunks[chunk_index], 0,
+          reinterpret_cast<base::subtle::AtomicWord>(chunk)) != 0) {
+    delete[] chunk;
+  }
+}
+
+// Values of the slots beyond kThreadLocalStorageSize for one thread, allocated
+// when the thread first sets one of them.
+struct OverflowValues {
+  // Number of entries in |values|.
+  int size;
+
+  // Values of slots kThreadLocalStorageSize to
+  // kThreadLocalStorageSize + size - 1.
+  void** values;
+};
+
+OverflowValues* GetOverflowValues(void** tls_data) {
+  return static_cast<OverflowValues*>(tls_data[0]);
+}
+
+// Returns the entry of |slot|, which is beyond kThreadLocalStorageSize, in the
+// OverflowValues of |tls_data|. Returns nullptr if the entry doesn't exist and
+// |create| is false.
+void** GetOverflowEntry(void** tls_data, int slot, bool create) {
+  const int index = slot - kThreadLocalStorageSize;
+  OverflowValues* overflow = GetOverflowValues(tls_data);
+  if (overflow && index < overflow->size)
+    return &overflow->values[index];
+  if (!create)
+    return nullptr;
+
+  int new_size = overflow ? overflow->size * 2 : kThreadLocalStorageSize;
+  while (new_size <= index)
+    new_size *= 2;
+  void** new_values = new void*[new_size]();
+  if (overflow) {
+    memcpy(new_values, overflow->values, overflow->size * sizeof(void*));
+    delete[] overflow->values;
+  } else {
+    overflow = new OverflowValues;
+    tls_data[0] = overflow;
+  }
+  overflow->size = new_size;
+  overflow->values = new_values;
+  return &overflow->values[index];
+}
+
+#if defined(OS_LINUX) && !defined(COMPONENT_BUILD)
+// The per-thread table is also stored in compiler TLS, which spares Get() and
+// Set() a call to the OS TLS API. In a component build, accessing compiler TLS
+// from a shared library may allocate on first use, which we can't do here
+// (see ConstructTlsVector() below). Android doesn't support compiler TLS
+// without emulation, which allocates as well.
+#define TLS_USE_COMPILER_TLS
+__thread void** g_thread_tls_data = nullptr;
+#endif
+
+// Returns the per-thread table, or nullptr if it hasn't been constructed.
+void** GetTlsVector() {
+#if defined(TLS_USE_COMPILER_TLS)
+  return g_thread_tls_data;
+#else
+  return static_cast<void**>(PlatformThreadLocalStorage::GetTLSValue(
+      base::subtle::NoBarrier_Load(&g_native_tls_key)));
+#endif
+}
+
+void SetTlsVector(PlatformThreadLocalStorage::TLSKey key, void** tls_data) {
+  PlatformThreadLocalStorage::SetTLSValue(key, tls_data);
+#if defined(TLS_USE_COMPILER_TLS)
+  g_thread_tls_data = tls_data;
+#endif
+}
+
 // This function is called to initialize our entire Chromium TLS system.
 // It may be called very early, and we need to complete most all of the setup
 // (initialization) before calling *any* memory allocator functions, which may
@@ -101,18 +219,69 @@ void** ConstructTlsVector() {
   void* stack_allocated_tls_data[kThreadLocalStorageSize];
   memset(stack_allocated_tls_data, 0, sizeof(stack_allocated_tls_data));
   // Ensure that any rentrant calls change the temp version.
-  PlatformThreadLocalStorage::SetTLSValue(key, stack_allocated_tls_data);
+  SetTlsVector(key, stack_allocated_tls_data);
 
   // Allocate an array to store our data.
   void** tls_data = new void*[kThreadLocalStorageSize];
   memcpy(tls_data, stack_allocated_tls_data, sizeof(stack_allocated_tls_data));
-  PlatformThreadLocalStorage::SetTLSValue(key, tls_data);
+  SetTlsVector(key, tls_data);
   return tls_data;
 }
 
+// Calls the destructors of the slots beyond kThreadLocalStorageSize which are
+// set in |tls_data|, until none is set, then frees the OverflowValues. Returns
+// false if it gave up because destructors kept setting slots.
+bool DestroyOverflowValues(void** tls_data) {
+  int remaining_attempts = kMaxDestructorIterations;
+  bool need_to_scan_destructors = true;
+  while (need_to_scan_destructors) {
+    need_to_scan_destructors = false;
+    base::subtle::Atomic32 last_used_tls_key =
+        base::subtle::NoBarrier_Load(&g_last_used_tls_key);
+    for (int slot = last_used_tls_key; slot >= kThreadLocalStorageSize;
+         --slot) {
+      // Looked up in each iteration, since destructors may grow the values.
+      void** entry = GetOverflowEntry(tls_data, slot, false);
+      if (!entry || *entry == NULL)
+        continue;
+      void* tls_value = *entry;
+
+      TLSDestructorFunc destructor = *GetDestructorEntry(slot);
+      if (destructor == NULL)
+        continue;
+      *entry = NULL;  // pre-clear the slot.
+      destructor(tls_value);
+      need_to_scan_destructors = true;
+    }
+    if (--remaining_attempts <= 0)
+      return false;
+  }
+
+  OverflowValues* overflow = GetOverflowValues(tls_data);
+  if (overflow) {
+    tls_data[0] = NULL;
+    delete[] overflow->values;
+    delete overflow;
+  }
+  return true;
+}
+
+
 void OnThreadExitInternal(void* value) {
   DCHECK(value);
   void** tls_data = static_cast<void**>(value);
+  PlatformThreadLocalStorage::TLSKey key =
+      base::subtle::NoBarrier_Load(&g_native_tls_key);
+  // The slots beyond kThreadLocalStorageSize were issued after all the others,
+  // so they are destroyed first, while services used by the others (like an
+  // allocator) are still running. Their destructors may use TLS, which must
+  // find |tls_data| (the OS may have reset the native TLS value).
+  if (tls_data[0]) {
+    SetTlsVector(key, tls_data);
+    if (!DestroyOverflowValues(tls_data))
+      NOTREACHED();  // Destructors might not have been called.
+  }
+
   // Some allocators, such as TCMalloc, use TLS.  As a result, when a thread
   // terminates, one of the destructor calls we make may be to shut down an
   // allocator.  We have to be careful that after we've shutdown all of the
@@ -125,9 +294,7 @@ void OnThreadExitInternal(void* value) {
   void* stack_allocated_tls_data[kThreadLocalStorageSize];
   memcpy(stack_allocated_tls_data, tls_data, sizeof(stack_allocated_tls_data));
   // Ensure that any re-entrant calls change the temp version.
-  PlatformThreadLocalStorage::TLSKey key =
-      base::subtle::NoBarrier_Load(&g_native_tls_key);
-  PlatformThreadLocalStorage::SetTLSValue(key, stack_allocated_tls_data);
+  SetTlsVector(key, stack_allocated_tls_data);
   delete[] tls_data;  // Our last dependence on an allocator.
 
   int remaining_attempts = kMaxDestructorIterations;
@@ -141,7 +308,8 @@ void OnThreadExitInternal(void* value) {
     // then we'll itterate several more times, so it is really not that
     // critical (but it might help).
     base::subtle::Atomic32 last_used_tls_key =
-        base::subtle::NoBarrier_Load(&g_last_used_tls_key);
+        std::min(base::subtle::NoBarrier_Load(&g_last_used_tls_key),
+                 kThreadLocalStorageSize - 1);
     for (int slot = last_used_tls_key; slot > 0; --slot) {
       void* tls_value = stack_allocated_tls_data[slot];
       if (tls_value == NULL)
@@ -158,6 +326,12 @@ void OnThreadExitInternal(void* value) {
       // the whole vector again.  This is a pthread standard.
       need_to_scan_destructors = true;
     }
+    // A destructor might also have set a slot beyond kThreadLocalStorageSize.
+    if (stack_allocated_tls_data[0]) {
+      if (!DestroyOverflowValues(stack_allocated_tls_data))
+        NOTREACHED();  // Destructors might not have been called.
+      need_to_scan_destructors = true;
+    }
     if (--remaining_attempts <= 0) {
       NOTREACHED();  // Destructors might not have been called.
       break;
@@ -165,7 +339,7 @@ void OnThreadExitInternal(void* value) {
   }
 
   // Remove our stack allocated vector.
-  PlatformThreadLocalStorage::SetTLSValue(key, NULL);
+  SetTlsVector(key, NULL);
 }
 
 }  // namespace
@@ -204,16 +378,17 @@ void ThreadLocalStorage::StaticSlot::Initialize(TLSDestructorFunc destructor) {
   PlatformThreadLocalStorage::TLSKey key =
       base::subtle::NoBarrier_Load(&g_native_tls_key);
   if (key == PlatformThreadLocalStorage::TLS_KEY_OUT_OF_INDEXES ||
-      !PlatformThreadLocalStorage::GetTLSValue(key))
+      !GetTlsVector())
     ConstructTlsVector();
 
   // Grab a new slot.
   slot_ = base::subtle::NoBarrier_AtomicIncrement(&g_last_used_tls_key, 1);
   DCHECK_GT(slot_, 0);
-  CHECK_LT(slot_, kThreadLocalStorageSize);
+  CHECK_LT(slot_, kThreadLocalStorageMaxSize);
+  EnsureDestructorChunk(slot_);
 
   // Setup our destructor.
-  g_tls_destructors[slot_] = destructor;
+  *GetDestructorEntry(slot_) = destructor;
   base::subtle::Release_Store(&initialized_, 1);
 }
 
@@ -221,32 +396,38 @@ void ThreadLocalStorage::StaticSlot::Free() {
   // At this time, we don't reclaim old indices for TLS slots.
   // So all we need to do is wipe the destructor.
   DCHECK_GT(slot_, 0);
-  DCHECK_LT(slot_, kThreadLocalStorageSize);
-  g_tls_destructors[slot_] = NULL;
+  DCHECK_LT(slot_, kThreadLocalStorageMaxSize);
+  *GetDestructorEntry(slot_) = NULL;
   slot_ = 0;
   base::subtle::Release_Store(&initialized_, 0);
 }
 
 void* ThreadLocalStorage::StaticSlot::Get() const {
-  void** tls_data = static_cast<void**>(
-      PlatformThreadLocalStorage::GetTLSValue(
-          base::subtle::NoBarrier_Load(&g_native_tls_key)));
+  void** tls_data = GetTlsVector();
   if (!tls_data)
     tls_data = ConstructTlsVector();
   DCHECK_GT(slot_, 0);
-  DCHECK_LT(slot_, kThreadLocalStorageSize);
-  return tls_data[slot_];
+  if (slot_ < kThreadLocalStorageSize)
+    return tls_data[slot_];
+  DCHECK_LT(slot_, kThreadLocalStorageMaxSize);
+  void** entry = GetOverflowEntry(tls_data, slot_, false);
+  return entry ? *entry : NULL;
 }
 
 void ThreadLocalStorage::StaticSlot::Set(void* value) {
-  void** tls_data = static_cast<void**>(
-      PlatformThreadLocalStorage::GetTLSValue(
-          base::subtle::NoBarrier_Load(&g_native_tls_key)));
+  void** tls_data = GetTlsVector();
   if (!tls_data)
     tls_data = ConstructTlsVector();
   DCHECK_GT(slot_, 0);
-  DCHECK_LT(slot_, kThreadLocalStorageSize);
-  tls_data[slot_] = value;
+  if (slot_ < kThreadLocalStorageSize) {
+    tls_data[slot_] = value;
+    return;
+  }
+  DCHECK_LT(slot_, kThreadLocalStorageMaxSize);
+  // Don't allocate the OverflowValues to clear a slot.
+  void** entry = GetOverflowEntry(tls_data, slot_, value != NULL);
+  if (entry)
+    *entry = value;
 }
 
 }  // namespace base
@@ -0,0 +1,81 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/threading/thread_local_storage.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Number of Get() and Set() pairs.
+const int kNumIterations = 10 * 1000 * 1000;
+
+// Slots allocated before measuring a slot stored in the overflow values of the
+// per-thread table, which stores 256 slots inline.
+const int kNumOverflowSlots = 300;
+
+// Increments the value of |slot| |kNumIterations| times.
+template <typename GetFunction, typename SetFunction>
+void RunGetSet(GetFunction get, SetFunction set, const std::string& trace) {
+  set(nullptr);
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i)
+    set(reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(get()) + 1));
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_EQ(static_cast<uintptr_t>(kNumIterations),
+            reinterpret_cast<uintptr_t>(get()));
+  perf_test::PrintResult("get_set", "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / kNumIterations,
+                         "ns/iteration", true);
+}
+
+void RunSlotGetSet(ThreadLocalStorage::Slot* slot, const std::string& trace) {
+  RunGetSet([slot]() { return slot->Get(); },
+            [slot](void* value) { slot->Set(value); }, trace);
+  slot->Set(nullptr);
+}
+
+}  // namespace
+
+// The OS TLS API, which ThreadLocalStorage uses to find the per-thread table
+// where compiler TLS isn't used.
+TEST(ThreadLocalStoragePerfTest, PlatformThreadLocalStorage) {
+  using internal::PlatformThreadLocalStorage;
+  PlatformThreadLocalStorage::TLSKey key;
+  ASSERT_TRUE(PlatformThreadLocalStorage::AllocTLS(&key));
+  RunGetSet([key]() { return PlatformThreadLocalStorage::GetTLSValue(key); },
+            [key](void* value) {
+              PlatformThreadLocalStorage::SetTLSValue(key, value);
+            },
+            "platform_tls");
+  PlatformThreadLocalStorage::FreeTLS(key);
+}
+
+TEST(ThreadLocalStoragePerfTest, Slot) {
+  ThreadLocalStorage::Slot slot;
+  RunSlotGetSet(&slot, "slot");
+}
+
+TEST(ThreadLocalStoragePerfTest, OverflowSlot) {
+  std::vector<std::unique_ptr<ThreadLocalStorage::Slot>> slots;
+  for (int i = 0; i < kNumOverflowSlots; ++i)
+    slots.push_back(WrapUnique(new ThreadLocalStorage::Slot));
+  RunSlotGetSet(slots.back().get(), "overflow_slot");
+  for (const auto& slot : slots)
+    slot->Free();
+}
+
+}  // namespace base
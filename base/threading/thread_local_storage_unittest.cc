@@ -7,7 +7,11 @@
 #include <process.h>
 #endif
 
+#include <memory>
+#include <vector>
+
 #include "base/macros.h"
+#include "base/memory/ptr_util.h"
 #include "base/threading/simple_thread.h"
 #include "base/threading/thread_local_storage.h"
 #include "build/build_config.h"
@@ -72,6 +76,38 @@ void ThreadLocalStorageCleanup(void *value) {
   tls_slot.Set(value);
 }
 
+// More slots than are stored inline in the per-thread table, so that some of
+// them are stored in its overflow values whatever the slots issued earlier.
+const int kNumManySlots = 300;
+
+int g_num_many_slots_destroyed = 0;
+
+void ManySlotsCleanup(void* value) {
+  ++g_num_many_slots_destroyed;
+}
+
+class ManySlotsRunner : public DelegateSimpleThread::Delegate {
+ public:
+  explicit ManySlotsRunner(
+      std::vector<std::unique_ptr<ThreadLocalStorage::Slot>>* slots)
+      : slots_(slots) {}
+
+  ~ManySlotsRunner() override {}
+
+  void Run() override {
+    for (size_t i = 0; i < slots_->size(); ++i) {
+      EXPECT_EQ(nullptr, (*slots_)[i]->Get());
+      (*slots_)[i]->Set(reinterpret_cast<void*>(i + 1));
+    }
+    for (size_t i = 0; i < slots_->size(); ++i)
+      EXPECT_EQ(reinterpret_cast<void*>(i + 1), (*slots_)[i]->Get());
+  }
+
+ private:
+  std::vector<std::unique_ptr<ThreadLocalStorage::Slot>>* slots_;
+  DISALLOW_COPY_AND_ASSIGN(ManySlotsRunner);
+};
+
 }  // namespace
 
 TEST(ThreadLocalStorageTest, Basics) {
@@ -127,4 +163,27 @@ TEST(ThreadLocalStorageTest, MAYBE_TLSDestructors) {
   tls_slot.Free();  // Stop doing callbacks to cleanup threads.
 }
 
+TEST(ThreadLocalStorageTest, ManySlots) {
+  std::vector<std::unique_ptr<ThreadLocalStorage::Slot>> slots;
+  for (int i = 0; i < kNumManySlots; ++i)
+    slots.push_back(WrapUnique(new ThreadLocalStorage::Slot(ManySlotsCleanup)));
+
+  // The values of this thread are independent from those of |thread|.
+  slots.back()->Set(slots.back().get());
+
+  g_num_many_slots_destroyed = 0;
+  ManySlotsRunner delegate(&slots);
+  DelegateSimpleThread thread(&delegate, "tls thread");
+  thread.Start();
+  thread.Join();
+
+  // Destructors were called on exit of |thread|, for all the slots.
+  EXPECT_EQ(kNumManySlots, g_num_many_slots_destroyed);
+  EXPECT_EQ(slots.back().get(), slots.back()->Get());
+
+  slots.back()->Set(nullptr);
+  for (const auto& slot : slots)
+    slot->Free();
+}
+
 }  // namespace base
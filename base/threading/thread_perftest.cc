@@ -265,6 +265,65 @@ typedef EventPerfTest<ConditionVariableEvent> ConditionVariablePerfTest;
 TEST_F(ConditionVariablePerfTest, EventPingPong) {
   RunPingPongTest("4_ConditionVariable_Threads", 4);
 }
+
+// Class to test lock performance under contention: every thread repeatedly
+// takes the same lock to increment a shared counter. LockType is templated so
+// we can compare base::Lock with the platform mutex.
+template <typename LockType>
+class LockContentionPerfTest : public testing::Test {
+ public:
+  void IncrementOnThread(int increments, WaitableEvent* done) {
+    for (int i = 0; i < increments; ++i) {
+      lock_.Acquire();
+      ++counter_;
+      lock_.Release();
+    }
+    done->Signal();
+  }
+
+  void RunContentionTest(const std::string& name, int num_threads) {
+    ScopedVector<Thread> threads;
+    ScopedVector<WaitableEvent> done;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(new Thread("LockContender"));
+      threads.back()->Start();
+      done.push_back(
+          new WaitableEvent(WaitableEvent::ResetPolicy::MANUAL,
+                            WaitableEvent::InitialState::NOT_SIGNALED));
+    }
+
+    counter_ = 0;
+    const int increments = kNumRuns * 10 / num_threads;
+    TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < num_threads; ++i) {
+      threads[i]->task_runner()->PostTask(
+          FROM_HERE, Bind(&LockContentionPerfTest::IncrementOnThread,
+                          Unretained(this), increments, done[i]));
+    }
+    for (WaitableEvent* event : done)
+      event->Wait();
+    TimeTicks end = TimeTicks::Now();
+    EXPECT_EQ(increments * num_threads, counter_);
+
+    perf_test::PrintResult(
+        "lock", "", name + "_time ",
+        (end - start).InMicroseconds() * 1000.0 / counter_, "ns/acquire",
+        true);
+  }
+
+ private:
+  LockType lock_;
+  int counter_ = 0;
+};
+
+typedef LockContentionPerfTest<Lock> LockPerfTest;
+TEST_F(LockPerfTest, Contention) {
+  RunContentionTest("1_Lock_Threads", 1);
+  RunContentionTest("2_Lock_Threads", 2);
+  RunContentionTest("4_Lock_Threads", 4);
+  RunContentionTest("8_Lock_Threads", 8);
+}
+
 #if defined(OS_POSIX)
 
 // Absolutely 100% minimal posix waitable event. If there is a better/faster
@@ -313,6 +372,27 @@ TEST_F(PthreadEventPerfTest, EventPingPong) {
   RunPingPongTest("4_PthreadCondVar_Threads", 4);
 }
 
+// The platform mutex, as a baseline for LockPerfTest.
+class PthreadMutex {
+ public:
+  PthreadMutex() { pthread_mutex_init(&mutex_, 0); }
+  ~PthreadMutex() { pthread_mutex_destroy(&mutex_); }
+
+  void Acquire() { pthread_mutex_lock(&mutex_); }
+  void Release() { pthread_mutex_unlock(&mutex_); }
+
+ private:
+  pthread_mutex_t mutex_;
+};
+
+typedef LockContentionPerfTest<PthreadMutex> PthreadMutexPerfTest;
+TEST_F(PthreadMutexPerfTest, Contention) {
+  RunContentionTest("1_PthreadMutex_Threads", 1);
+  RunContentionTest("2_PthreadMutex_Threads", 2);
+  RunContentionTest("4_PthreadMutex_Threads", 4);
+  RunContentionTest("8_PthreadMutex_Threads", 8);
+}
+
 #endif
 
 }  // namespace
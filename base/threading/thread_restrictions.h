@@ -7,6 +7,7 @@
 
 #include "base/base_export.h"
 #include "base/macros.h"
+#include "base/threading/scoped_blocking_call.h"
 
 // See comment at top of thread_checker.h
 #if (!defined(NDEBUG) || defined(DCHECK_ALWAYS_ON))
@@ -23,6 +24,7 @@ class ScopedAllowWaitForLegacyWebViewApi;
 namespace cc {
 class CompletionEvent;
 class SingleThreadTaskGraphRunner;
+class WorkStealingTaskGraphRunner;
 }
 namespace chromeos {
 class BlockingMethodCaller;
@@ -135,6 +137,9 @@ class BASE_EXPORT ThreadRestrictions {
     // Whether IO is allowed when the ScopedAllowIO was constructed.
     bool previous_value_;
 
+    // IO may block the current thread.
+    ScopedBlockingCall blocking_call_;
+
     DISALLOW_COPY_AND_ASSIGN(ScopedAllowIO);
   };
 
@@ -201,6 +206,7 @@ class BASE_EXPORT ThreadRestrictions {
   friend class ::ScopedAllowWaitForLegacyWebViewApi;
   friend class cc::CompletionEvent;
   friend class cc::SingleThreadTaskGraphRunner;
+  friend class cc::WorkStealingTaskGraphRunner;
   friend class content::CategorizedWorkerPool;
   friend class remoting::AutoThread;
   friend class ui::WindowResizeHelperMac;
@@ -109,6 +109,15 @@ void RegisterDestructionObserver(
   base::MessageLoop::current()->AddDestructionObserver(observer);
 }
 
+// Task that appends |value| to |values| and signals |event| if it isn't null.
+void AppendValue(int value,
+                 std::vector<int>* values,
+                 base::WaitableEvent* event) {
+  values->push_back(value);
+  if (event)
+    event->Signal();
+}
+
 // Task that calls GetThreadId() of |thread|, stores the result into |id|, then
 // signal |event|.
 void ReturnThreadId(base::Thread* thread,
@@ -169,6 +178,30 @@ TEST_F(ThreadTest, StartWithOptions_StackSize) {
   EXPECT_TRUE(was_invoked);
 }
 
+TEST_F(ThreadTest, StartWithOptions_DelayedWorkQueueType) {
+  Thread a("StartWithDelayedWorkQueueType");
+  Thread::Options options;
+  options.delayed_work_queue_type = base::DelayedWorkQueueType::TIMER_WHEEL;
+  EXPECT_TRUE(a.StartWithOptions(options));
+
+  // Delayed tasks run in order of delay, and then in posting order.
+  std::vector<int> values;
+  base::WaitableEvent event(base::WaitableEvent::ResetPolicy::MANUAL,
+                            base::WaitableEvent::InitialState::NOT_SIGNALED);
+  a.task_runner()->PostDelayedTask(
+      FROM_HERE, base::Bind(&AppendValue, 2, &values, &event),
+      base::TimeDelta::FromMilliseconds(40));
+  a.task_runner()->PostDelayedTask(
+      FROM_HERE, base::Bind(&AppendValue, 0, &values, nullptr),
+      base::TimeDelta::FromMilliseconds(10));
+  a.task_runner()->PostDelayedTask(
+      FROM_HERE, base::Bind(&AppendValue, 1, &values, nullptr),
+      base::TimeDelta::FromMilliseconds(10));
+  event.Wait();
+
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), values);
+}
+
 TEST_F(ThreadTest, TwoTasks) {
   bool was_invoked = false;
   {
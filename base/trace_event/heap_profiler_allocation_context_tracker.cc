@@ -4,8 +4,11 @@
 
 #include "base/trace_event/heap_profiler_allocation_context_tracker.h"
 
+#include <math.h>
+
 #include <algorithm>
 #include <iterator>
+#include <limits>
 
 #include "base/atomicops.h"
 #include "base/debug/leak_annotations.h"
@@ -22,6 +25,10 @@ namespace trace_event {
 
 subtle::Atomic32 AllocationContextTracker::capture_mode_ =
     static_cast<int32_t>(AllocationContextTracker::CaptureMode::DISABLED);
+subtle::AtomicWord AllocationContextTracker::sampling_interval_ = 0;
+
+// static
+const size_t AllocationContextTracker::kDefaultSamplingInterval;
 
 namespace {
 
@@ -82,7 +89,12 @@ AllocationContextTracker::GetInstanceForCurrentThread() {
 }
 
 AllocationContextTracker::AllocationContextTracker()
-    : thread_name_(nullptr), ignore_scope_depth_(0) {
+    : thread_name_(nullptr),
+      ignore_scope_depth_(0),
+      bytes_until_next_sample_(0),
+      // Any non-zero seed which differs across threads will do.
+      random_state_(reinterpret_cast<uintptr_t>(this) ^
+                    0x9e3779b97f4a7c15ull) {
   pseudo_stack_.reserve(kMaxStackDepth);
   task_contexts_.reserve(kMaxTaskDepth);
 }
@@ -107,6 +119,53 @@ void AllocationContextTracker::SetCaptureMode(CaptureMode mode) {
   subtle::Release_Store(&capture_mode_, static_cast<int32_t>(mode));
 }
 
+// static
+void AllocationContextTracker::SetSamplingInterval(size_t sampling_interval) {
+  subtle::NoBarrier_Store(&sampling_interval_,
+                          static_cast<subtle::AtomicWord>(sampling_interval));
+}
+
+// static
+double AllocationContextTracker::GetSamplingProbability(size_t size) {
+  size_t interval = sampling_interval();
+  if (!interval)
+    return 1.0;
+  // The probability that a Poisson process has an event in |size| bytes.
+  return -expm1(-static_cast<double>(size) / interval);
+}
+
+bool AllocationContextTracker::ShouldSampleAllocation(size_t size) {
+  size_t interval = sampling_interval();
+  if (!interval)
+    return true;
+
+  if (!bytes_until_next_sample_)
+    bytes_until_next_sample_ = GetBytesUntilNextSample(interval);
+  if (size < bytes_until_next_sample_) {
+    bytes_until_next_sample_ -= size;
+    return false;
+  }
+  // The distance from the end of this allocation to the next sample is
+  // distributed like the distance between two samples.
+  bytes_until_next_sample_ = GetBytesUntilNextSample(interval);
+  return true;
+}
+
+size_t AllocationContextTracker::GetBytesUntilNextSample(
+    size_t sampling_interval) {
+  // xorshift64*, which is cheap and random enough for this.
+  random_state_ ^= random_state_ >> 12;
+  random_state_ ^= random_state_ << 25;
+  random_state_ ^= random_state_ >> 27;
+  uint64_t random = random_state_ * 0x2545f4914f6cdd1dull;
+  // A uniform number in (0, 1].
+  double uniform = ((random >> 11) + 1) * (1.0 / (UINT64_C(1) << 53));
+  double bytes = -log(uniform) * sampling_interval;
+  if (bytes >= static_cast<double>(std::numeric_limits<size_t>::max()))
+    return std::numeric_limits<size_t>::max();
+  return std::max<size_t>(1, static_cast<size_t>(bytes));
+}
+
 void AllocationContextTracker::PushPseudoStackFrame(
     const char* trace_event_name) {
   // Impose a limit on the height to verify that every push is popped, because
@@ -5,6 +5,9 @@
 #ifndef BASE_TRACE_EVENT_HEAP_PROFILER_ALLOCATION_CONTEXT_TRACKER_H_
 #define BASE_TRACE_EVENT_HEAP_PROFILER_ALLOCATION_CONTEXT_TRACKER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <vector>
 
 #include "base/atomicops.h"
@@ -50,6 +53,24 @@ class BASE_EXPORT AllocationContextTracker {
     return static_cast<CaptureMode>(subtle::Acquire_Load(&capture_mode_));
   }
 
+  // The sampling interval of --enable-heap-profiling=sampled.
+  static const size_t kDefaultSamplingInterval = 128 * 1024;
+
+  // Globally sets the mean number of bytes allocated between two allocations
+  // which ShouldSampleAllocation() samples, or 0 to sample every allocation.
+  // Must be called before capturing is enabled.
+  static void SetSamplingInterval(size_t sampling_interval);
+
+  // Returns the global sampling interval, 0 if every allocation is sampled.
+  inline static size_t sampling_interval() {
+    return static_cast<size_t>(subtle::NoBarrier_Load(&sampling_interval_));
+  }
+
+  // Returns the probability that ShouldSampleAllocation() samples an
+  // allocation of |size| bytes. The heap profiler divides the size and count
+  // of the sampled allocations by it to estimate the total ones.
+  static double GetSamplingProbability(size_t size);
+
   // Returns the thread-local instance, creating one if necessary. Returns
   // always a valid instance, unless it is called re-entrantly, in which case
   // returns nullptr in the nested calls.
@@ -82,12 +103,24 @@ class BASE_EXPORT AllocationContextTracker {
   // Returns a snapshot of the current thread-local context.
   AllocationContext GetContextSnapshot();
 
+  // Returns whether an allocation of |size| bytes by the current thread should
+  // be recorded. The bytes allocated by the thread are sampled as a Poisson
+  // process, with a mean of one sample every sampling_interval() bytes, and the
+  // allocations which contain a sample are recorded. This is much cheaper than
+  // GetContextSnapshot() for the allocations which aren't.
+  bool ShouldSampleAllocation(size_t size);
+
   ~AllocationContextTracker();
 
  private:
   AllocationContextTracker();
 
+  // Returns a random number of bytes until the next sample, exponentially
+  // distributed with a mean of |sampling_interval|.
+  size_t GetBytesUntilNextSample(size_t sampling_interval);
+
   static subtle::Atomic32 capture_mode_;
+  static subtle::AtomicWord sampling_interval_;
 
   // The pseudo stack where frames are |TRACE_EVENT| names.
   std::vector<const char*> pseudo_stack_;
@@ -101,6 +134,12 @@ class BASE_EXPORT AllocationContextTracker {
 
   uint32_t ignore_scope_depth_;
 
+  // Bytes which the thread will allocate before the next sample, 0 until the
+  // first allocation is sampled, and the state of the generator of the random
+  // numbers of bytes between samples.
+  size_t bytes_until_next_sample_;
+  uint64_t random_state_;
+
   DISALLOW_COPY_AND_ASSIGN(AllocationContextTracker);
 };
 
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <math.h>
 #include <stddef.h>
 
 #include <iterator>
@@ -281,5 +282,44 @@ TEST_F(AllocationContextTrackerTest, IgnoreAllocationTest) {
   ASSERT_EQ(1u, ctx.backtrace.frame_count);
 }
 
+TEST_F(AllocationContextTrackerTest, SamplingDisabled) {
+  AllocationContextTracker* tracker =
+      AllocationContextTracker::GetInstanceForCurrentThread();
+  ASSERT_EQ(0u, AllocationContextTracker::sampling_interval());
+  for (size_t size = 1; size < 1000; size++)
+    ASSERT_TRUE(tracker->ShouldSampleAllocation(size));
+  ASSERT_EQ(1.0, AllocationContextTracker::GetSamplingProbability(1));
+}
+
+TEST_F(AllocationContextTrackerTest, SampledAllocations) {
+  const size_t kInterval = 1024;
+  const size_t kAllocationSize = 64;
+  const size_t kNumAllocations = 100000;
+  AllocationContextTracker::SetSamplingInterval(kInterval);
+  AllocationContextTracker* tracker =
+      AllocationContextTracker::GetInstanceForCurrentThread();
+
+  // An allocation as large as the interval is sampled with probability
+  // 1 - 1/e, and much larger ones almost surely.
+  double probability =
+      AllocationContextTracker::GetSamplingProbability(kInterval);
+  EXPECT_NEAR(1 - exp(-1.0), probability, 1e-9);
+  EXPECT_NEAR(1.0, AllocationContextTracker::GetSamplingProbability(
+                       kInterval * 100), 1e-9);
+  EXPECT_TRUE(tracker->ShouldSampleAllocation(kInterval * 100));
+
+  // On average one allocation is sampled every |kInterval| bytes.
+  size_t num_sampled = 0;
+  for (size_t i = 0; i < kNumAllocations; i++) {
+    if (tracker->ShouldSampleAllocation(kAllocationSize))
+      num_sampled++;
+  }
+  const double expected = kNumAllocations * kAllocationSize / kInterval;
+  EXPECT_GT(num_sampled, expected * 0.8);
+  EXPECT_LT(num_sampled, expected * 1.2);
+
+  AllocationContextTracker::SetSamplingInterval(0);
+}
+
 }  // namespace trace_event
 }  // namespace base
@@ -306,17 +306,75 @@ std::unique_ptr<TracedValue> Serialize(const std::set<Entry>& entries) {
   return traced_value;
 }
 
+std::set<Entry> ComputeDelta(const std::set<Entry>& last_entries,
+                             const std::set<Entry>& entries) {
+  std::set<Entry> delta;
+
+  // Both sets are ordered by backtrace and type, so walk them in lockstep.
+  auto last_it = last_entries.begin();
+  for (const Entry& entry : entries) {
+    for (; last_it != last_entries.end() && *last_it < entry; ++last_it) {
+      Entry removed = *last_it;
+      removed.size = 0;
+      removed.count = 0;
+      delta.insert(delta.end(), removed);
+    }
+    if (last_it != last_entries.end() && !(entry < *last_it)) {
+      bool changed = last_it->size != entry.size ||
+                     last_it->count != entry.count;
+      ++last_it;
+      if (!changed)
+        continue;
+    }
+    delta.insert(delta.end(), entry);
+  }
+  for (; last_it != last_entries.end(); ++last_it) {
+    Entry removed = *last_it;
+    removed.size = 0;
+    removed.count = 0;
+    delta.insert(delta.end(), removed);
+  }
+
+  return delta;
+}
+
 }  // namespace internal
 
+HeapDumpHistory::HeapDumpHistory() {}
+
+HeapDumpHistory::~HeapDumpHistory() {}
+
+std::set<internal::Entry>* HeapDumpHistory::GetLastEntries(
+    const std::string& allocator_name) {
+  return &last_entries_[allocator_name];
+}
+
 std::unique_ptr<TracedValue> ExportHeapDump(
     const hash_map<AllocationContext, AllocationMetrics>& metrics_by_context,
-    const MemoryDumpSessionState& session_state) {
+    const char* allocator_name,
+    MemoryDumpSessionState* session_state) {
+  const TraceConfig::MemoryDumpConfig::HeapProfiler& options =
+      session_state->memory_dump_config().heap_profiler_options;
   internal::HeapDumpWriter writer(
-      session_state.stack_frame_deduplicator(),
-      session_state.type_name_deduplicator(),
-      session_state.memory_dump_config().heap_profiler_options
-          .breakdown_threshold_bytes);
-  return Serialize(writer.Summarize(metrics_by_context));
+      session_state->stack_frame_deduplicator(),
+      session_state->type_name_deduplicator(),
+      options.breakdown_threshold_bytes);
+  const std::set<internal::Entry>& entries =
+      writer.Summarize(metrics_by_context);
+  if (!options.delta_heap_dumps)
+    return Serialize(entries);
+
+  std::set<internal::Entry>* last_entries =
+      session_state->heap_dump_history()->GetLastEntries(allocator_name);
+  std::unique_ptr<TracedValue> traced_value;
+  if (last_entries->empty()) {
+    traced_value = Serialize(entries);
+  } else {
+    traced_value = Serialize(ComputeDelta(*last_entries, entries));
+    traced_value->SetBoolean("is_delta", true);
+  }
+  *last_entries = entries;
+  return traced_value;
 }
 
 }  // namespace trace_event
@@ -7,8 +7,10 @@
 
 #include <stddef.h>
 
+#include <map>
 #include <memory>
 #include <set>
+#include <string>
 
 #include "base/base_export.h"
 #include "base/containers/hash_tables.h"
@@ -27,9 +29,16 @@ class TypeNameDeduplicator;
 // returns a traced value with an "entries" array that can be dumped in the
 // trace log, following the format described in https://goo.gl/KY7zVE. The
 // number of entries is kept reasonable because long tails are not included.
+//
+// If delta heap dumps are enabled in the memory dump config of
+// |session_state|, all but the first dump of |allocator_name| in the session
+// only contain the entries which are new or changed since the previous dump,
+// plus entries with a zero size and count for the ones that disappeared. These
+// dumps have an "is_delta" key set to true.
 BASE_EXPORT std::unique_ptr<TracedValue> ExportHeapDump(
     const hash_map<AllocationContext, AllocationMetrics>& metrics_by_context,
-    const MemoryDumpSessionState& session_state);
+    const char* allocator_name,
+    MemoryDumpSessionState* session_state);
 
 namespace internal {
 
@@ -57,6 +66,12 @@ BASE_EXPORT bool operator<(Entry lhs, Entry rhs);
 // Serializes entries to an "entries" array in a traced value.
 BASE_EXPORT std::unique_ptr<TracedValue> Serialize(const std::set<Entry>& dump);
 
+// Returns the entries of |entries| which are not in |last_entries| or whose
+// size or count differ there, and an entry with a zero size and count for each
+// entry of |last_entries| which is not in |entries|.
+BASE_EXPORT std::set<Entry> ComputeDelta(const std::set<Entry>& last_entries,
+                                         const std::set<Entry>& entries);
+
 // Helper class to dump a snapshot of an |AllocationRegister| or other heap
 // bookkeeping structure into a |TracedValue|. This class is intended to be
 // used as a one-shot local instance on the stack.
@@ -107,6 +122,24 @@ class BASE_EXPORT HeapDumpWriter {
 };
 
 }  // namespace internal
+
+// The entries of the last heap dump of each allocator in a tracing session,
+// which delta heap dumps are computed from.
+class BASE_EXPORT HeapDumpHistory {
+ public:
+  HeapDumpHistory();
+  ~HeapDumpHistory();
+
+  // Returns the entries of the last heap dump of |allocator_name|, which are
+  // empty if there was none.
+  std::set<internal::Entry>* GetLastEntries(const std::string& allocator_name);
+
+ private:
+  std::map<std::string, std::set<internal::Entry>> last_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapDumpHistory);
+};
+
 }  // namespace trace_event
 }  // namespace base
 
@@ -13,10 +13,12 @@
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
 #include "base/trace_event/heap_profiler_allocation_context.h"
 #include "base/trace_event/heap_profiler_stack_frame_deduplicator.h"
 #include "base/trace_event/heap_profiler_type_name_deduplicator.h"
 #include "base/trace_event/memory_dump_session_state.h"
+#include "base/trace_event/trace_config.h"
 #include "base/trace_event/trace_event_argument.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -70,6 +72,17 @@ std::unique_ptr<const DictionaryValue> WriteAndReadBackEntry(Entry entry) {
   return json_entry->CreateDeepCopy();
 }
 
+std::unique_ptr<const DictionaryValue> ExportAndReadBack(
+    const hash_map<AllocationContext, AllocationMetrics>& metrics_by_context,
+    const char* allocator_name,
+    MemoryDumpSessionState* session_state) {
+  std::unique_ptr<TracedValue> traced_value =
+      ExportHeapDump(metrics_by_context, allocator_name, session_state);
+  std::string json;
+  traced_value->AppendAsTraceFormat(&json);
+  return DictionaryValue::From(JSONReader::Read(json));
+}
+
 // Given a desired stack frame ID and type ID, looks up the entry in the set and
 // asserts that it is present and has the expected size and count.
 void AssertSizeAndCountEq(const std::set<Entry>& entries,
@@ -328,6 +341,78 @@ TEST(HeapDumpWriterTest, InsignificantValuesNotDumped) {
   AssertNotDumped(dump, bt_initialize, -1);
 }
 
+TEST(HeapDumpWriterTest, ComputeDelta) {
+  std::set<Entry> last_entries;
+  last_entries.insert({10, 1, 1 /* stack_frame_id */, -1 /* type_id */});
+  last_entries.insert({20, 2, 2, -1});
+  last_entries.insert({30, 3, 3, -1});
+
+  std::set<Entry> entries;
+  entries.insert({10, 1, 1, -1});  // Unchanged.
+  entries.insert({25, 2, 2, -1});  // Size changed.
+  entries.insert({40, 4, 4, -1});  // New.
+
+  std::set<Entry> delta = ComputeDelta(last_entries, entries);
+  ASSERT_EQ(3u, delta.size());
+  AssertNotDumped(delta, 1, -1);
+  AssertSizeAndCountEq(delta, 2, -1, {25, 2});
+  AssertSizeAndCountEq(delta, 3, -1, {0, 0});  // Disappeared.
+  AssertSizeAndCountEq(delta, 4, -1, {40, 4});
+
+  EXPECT_TRUE(ComputeDelta(entries, entries).empty());
+  EXPECT_EQ(3u, ComputeDelta(std::set<Entry>(), entries).size());
+}
+
+TEST(HeapDumpWriterTest, DeltaHeapDumps) {
+  scoped_refptr<MemoryDumpSessionState> session_state(
+      new MemoryDumpSessionState);
+  session_state->SetStackFrameDeduplicator(
+      WrapUnique(new StackFrameDeduplicator));
+  session_state->SetTypeNameDeduplicator(WrapUnique(new TypeNameDeduplicator));
+  TraceConfig::MemoryDumpConfig config;
+  config.heap_profiler_options.delta_heap_dumps = true;
+  session_state->SetMemoryDumpConfig(config);
+
+  hash_map<AllocationContext, AllocationMetrics> metrics_by_context;
+  AllocationContext ctx;
+  ctx.backtrace.frames[0] = kBrowserMain;
+  ctx.backtrace.frame_count = 1;
+  metrics_by_context[ctx] = {4096, 1};
+  ctx.backtrace.frames[0] = kRendererMain;
+  metrics_by_context[ctx] = {8192, 1};
+
+  // The first dump of each allocator is complete.
+  std::unique_ptr<const DictionaryValue> dump =
+      ExportAndReadBack(metrics_by_context, "malloc", session_state.get());
+  const ListValue* entries = nullptr;
+  ASSERT_TRUE(dump->GetList("entries", &entries));
+  size_t num_entries = entries->GetSize();
+  EXPECT_LT(2u, num_entries);
+  EXPECT_FALSE(dump->HasKey("is_delta"));
+
+  // Nothing changed since the previous dump of "malloc".
+  dump = ExportAndReadBack(metrics_by_context, "malloc", session_state.get());
+  ASSERT_TRUE(dump->GetList("entries", &entries));
+  EXPECT_EQ(0u, entries->GetSize());
+  bool is_delta = false;
+  EXPECT_TRUE(dump->GetBoolean("is_delta", &is_delta));
+  EXPECT_TRUE(is_delta);
+
+  dump = ExportAndReadBack(metrics_by_context, "partition_alloc",
+                           session_state.get());
+  ASSERT_TRUE(dump->GetList("entries", &entries));
+  EXPECT_EQ(num_entries, entries->GetSize());
+  EXPECT_FALSE(dump->HasKey("is_delta"));
+
+  // Only the entries which changed are dumped, and the one of BrowserMain did
+  // not.
+  metrics_by_context[ctx] = {16384, 2};
+  dump = ExportAndReadBack(metrics_by_context, "malloc", session_state.get());
+  ASSERT_TRUE(dump->GetList("entries", &entries));
+  EXPECT_LT(0u, entries->GetSize());
+  EXPECT_GT(num_entries, entries->GetSize());
+}
+
 }  // namespace internal
 }  // namespace trace_event
 }  // namespace base
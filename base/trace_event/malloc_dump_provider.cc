@@ -5,6 +5,9 @@
 #include "base/trace_event/malloc_dump_provider.h"
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
 
 #include "base/allocator/allocator_extension.h"
 #include "base/allocator/allocator_shim.h"
@@ -26,6 +29,24 @@
 namespace base {
 namespace trace_event {
 
+namespace {
+
+// When allocations are sampled, most of the freed addresses were never
+// recorded. This counts the recorded addresses by hash, so that
+// RemoveAllocation() can skip the others without taking the lock of the
+// register. The counters are only modified with the lock held, and they
+// saturate rather than wrap around.
+const size_t kSampledAddressFilterBits = 18;
+std::atomic<uint8_t> g_sampled_address_filter[1 << kSampledAddressFilterBits];
+
+std::atomic<uint8_t>& GetSampledAddressFilterCounter(const void* address) {
+  uint64_t hash =
+      reinterpret_cast<uintptr_t>(address) * UINT64_C(0x9e3779b97f4a7c15);
+  return g_sampled_address_filter[hash >> (64 - kSampledAddressFilterBits)];
+}
+
+}  // namespace
+
 #if BUILDFLAG(USE_EXPERIMENTAL_ALLOCATOR_SHIM)
 namespace {
 
@@ -183,10 +204,21 @@ bool MallocDumpProvider::OnMemoryDump(const MemoryDumpArgs& args,
       AutoLock lock(allocation_register_lock_);
       if (allocation_register_) {
         if (args.level_of_detail == MemoryDumpLevelOfDetail::DETAILED) {
+          bool sampled = AllocationContextTracker::sampling_interval() != 0;
           for (const auto& alloc_size : *allocation_register_) {
             AllocationMetrics& metrics = metrics_by_context[alloc_size.context];
-            metrics.size += alloc_size.size;
-            metrics.count++;
+            if (!sampled) {
+              metrics.size += alloc_size.size;
+              metrics.count++;
+              continue;
+            }
+            // Each sampled allocation stands for 1 / probability allocations
+            // of its size.
+            double weight =
+                1 / AllocationContextTracker::GetSamplingProbability(
+                        alloc_size.size);
+            metrics.size += static_cast<size_t>(alloc_size.size * weight + 0.5);
+            metrics.count += static_cast<size_t>(weight + 0.5);
           }
         }
         allocation_register_->EstimateTraceMemoryOverhead(&overhead);
@@ -230,7 +262,7 @@ void MallocDumpProvider::InsertAllocation(void* address, size_t size) {
   // first time, which causes a new() inside the tracker which re-enters the
   // heap profiler, in which case we just want to early out.
   auto tracker = AllocationContextTracker::GetInstanceForCurrentThread();
-  if (!tracker)
+  if (!tracker || !tracker->ShouldSampleAllocation(size))
     return;
   AllocationContext context = tracker->GetContextSnapshot();
 
@@ -238,6 +270,13 @@ void MallocDumpProvider::InsertAllocation(void* address, size_t size) {
   if (!allocation_register_)
     return;
 
+  if (AllocationContextTracker::sampling_interval() &&
+      !allocation_register_->Get(address)) {
+    std::atomic<uint8_t>& counter = GetSampledAddressFilterCounter(address);
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    if (count != UINT8_MAX)
+      counter.store(count + 1, std::memory_order_relaxed);
+  }
   allocation_register_->Insert(address, size, context);
 }
 
@@ -247,9 +286,24 @@ void MallocDumpProvider::RemoveAllocation(void* address) {
   if (tid_dumping_heap_ != kInvalidThreadId &&
       tid_dumping_heap_ == PlatformThread::CurrentId())
     return;
+
+  bool sampled = AllocationContextTracker::sampling_interval() != 0;
+  // The allocation of |address| happened before this call, so the store of its
+  // counter is visible even with a relaxed load.
+  if (sampled && !GetSampledAddressFilterCounter(address).load(
+                     std::memory_order_relaxed)) {
+    return;
+  }
+
   AutoLock lock(allocation_register_lock_);
   if (!allocation_register_)
     return;
+  if (sampled && allocation_register_->Get(address)) {
+    std::atomic<uint8_t>& counter = GetSampledAddressFilterCounter(address);
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    if (count && count != UINT8_MAX)
+      counter.store(count - 1, std::memory_order_relaxed);
+  }
   allocation_register_->Remove(address);
 }
 
@@ -25,6 +25,7 @@
 #include "base/trace_event/memory_dump_session_state.h"
 #include "base/trace_event/memory_infra_background_whitelist.h"
 #include "base/trace_event/process_memory_dump.h"
+#include "base/trace_event/task_node_allocator_dump_provider.h"
 #include "base/trace_event/trace_event.h"
 #include "base/trace_event/trace_event_argument.h"
 #include "build/build_config.h"
@@ -163,6 +164,12 @@ void MemoryDumpManager::EnableHeapProfilingIfNeeded() {
     AllocationContextTracker::SetCaptureMode(
         AllocationContextTracker::CaptureMode::PSEUDO_STACK);
   }
+  else if (profiling_mode == switches::kEnableHeapProfilingModeSampled) {
+    AllocationContextTracker::SetSamplingInterval(
+        AllocationContextTracker::kDefaultSamplingInterval);
+    AllocationContextTracker::SetCaptureMode(
+        AllocationContextTracker::CaptureMode::PSEUDO_STACK);
+  }
   else if (profiling_mode == switches::kEnableHeapProfilingModeNative) {
 #if HAVE_TRACE_STACK_FRAME_POINTERS && \
     (BUILDFLAG(ENABLE_PROFILING) || !defined(NDEBUG))
@@ -201,6 +208,9 @@ void MemoryDumpManager::Initialize(MemoryDumpManagerDelegate* delegate,
   RegisterDumpProvider(MallocDumpProvider::GetInstance(), "Malloc", nullptr);
 #endif
 
+  RegisterDumpProvider(TaskNodeAllocatorDumpProvider::GetInstance(),
+                       "TaskNodeAllocator", nullptr);
+
 #if defined(OS_ANDROID)
   RegisterDumpProvider(JavaHeapDumpProvider::GetInstance(), "JavaHeap",
                        nullptr);
@@ -4,10 +4,13 @@
 
 #include "base/trace_event/memory_dump_session_state.h"
 
+#include "base/trace_event/heap_profiler_heap_dump_writer.h"
+
 namespace base {
 namespace trace_event {
 
-MemoryDumpSessionState::MemoryDumpSessionState() {}
+MemoryDumpSessionState::MemoryDumpSessionState()
+    : heap_dump_history_(new HeapDumpHistory) {}
 
 MemoryDumpSessionState::~MemoryDumpSessionState() {}
 
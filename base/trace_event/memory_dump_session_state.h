@@ -15,6 +15,8 @@
 namespace base {
 namespace trace_event {
 
+class HeapDumpHistory;
+
 // Container for state variables that should be shared across all the memory
 // dumps in a tracing session.
 class BASE_EXPORT MemoryDumpSessionState
@@ -46,6 +48,13 @@ class BASE_EXPORT MemoryDumpSessionState
 
   void SetMemoryDumpConfig(const TraceConfig::MemoryDumpConfig& config);
 
+  // Returns the last heap dumps of this session, which delta heap dumps are
+  // computed from. Like the deduplicators, it is only used while dumping, and
+  // dumps are never concurrent.
+  HeapDumpHistory* heap_dump_history() const {
+    return heap_dump_history_.get();
+  }
+
  private:
   friend class RefCountedThreadSafe<MemoryDumpSessionState>;
   ~MemoryDumpSessionState();
@@ -61,6 +70,8 @@ class BASE_EXPORT MemoryDumpSessionState
   // The memory dump config, copied at the time when the tracing session was
   // started.
   TraceConfig::MemoryDumpConfig memory_dump_config_;
+
+  std::unique_ptr<HeapDumpHistory> heap_dump_history_;
 };
 
 }  // namespace trace_event
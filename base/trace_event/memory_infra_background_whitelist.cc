@@ -29,6 +29,7 @@ const char* const kDumpProviderWhitelist[] = {
     "ProcessMemoryMetrics",
     "Skia",
     "Sql",
+    "TaskNodeAllocator",
     "V8Isolate",
     "WinHeap",
     nullptr  // End of list marker.
@@ -63,6 +64,8 @@ const char* const kAllocatorDumpNameWhitelist[] = {
     "skia/sk_glyph_cache",
     "skia/sk_resource_cache",
     "sqlite",
+    "task_node_allocator",
+    "task_node_allocator/thread_0x?",
     "v8/isolate_0x?/heap_spaces",
     "v8/isolate_0x?/heap_spaces/code_space",
     "v8/isolate_0x?/heap_spaces/large_object_space",
@@ -252,7 +252,7 @@ void ProcessMemoryDump::DumpHeapUsage(
   if (!metrics_by_context.empty()) {
     DCHECK_EQ(0ul, heap_dumps_.count(allocator_name));
     std::unique_ptr<TracedValue> heap_dump = ExportHeapDump(
-        metrics_by_context, *session_state());
+        metrics_by_context, allocator_name, session_state().get());
     heap_dumps_[allocator_name] = std::move(heap_dump);
   }
 
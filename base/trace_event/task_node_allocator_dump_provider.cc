@@ -0,0 +1,85 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/task_node_allocator_dump_provider.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/memory/task_node_allocator.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+const char kDumpName[] = "task_node_allocator";
+
+void AddSlabScalars(MemoryAllocatorDump* dump,
+                    size_t reserved_size,
+                    size_t nodes_in_use,
+                    uint64_t num_fallback_allocations) {
+  dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes, reserved_size);
+  dump->AddScalar(MemoryAllocatorDump::kNameObjectCount,
+                  MemoryAllocatorDump::kUnitsObjects, nodes_in_use);
+  dump->AddScalar("fallback_allocations", MemoryAllocatorDump::kUnitsObjects,
+                  num_fallback_allocations);
+}
+
+}  // namespace
+
+// static
+TaskNodeAllocatorDumpProvider* TaskNodeAllocatorDumpProvider::GetInstance() {
+  return Singleton<TaskNodeAllocatorDumpProvider,
+                   LeakySingletonTraits<TaskNodeAllocatorDumpProvider>>::get();
+}
+
+TaskNodeAllocatorDumpProvider::TaskNodeAllocatorDumpProvider() {}
+
+TaskNodeAllocatorDumpProvider::~TaskNodeAllocatorDumpProvider() {}
+
+bool TaskNodeAllocatorDumpProvider::OnMemoryDump(const MemoryDumpArgs& args,
+                                                 ProcessMemoryDump* pmd) {
+  std::vector<internal::TaskNodeAllocator::SlabStats> slab_stats;
+  internal::TaskNodeAllocator::GetSlabStats(&slab_stats);
+
+  size_t total_reserved_size = 0;
+  size_t total_nodes_in_use = 0;
+  uint64_t total_fallback_allocations = 0;
+  for (const auto& stats : slab_stats) {
+    total_reserved_size += stats.reserved_size;
+    total_nodes_in_use += stats.nodes_in_use;
+    total_fallback_allocations += stats.num_fallback_allocations;
+
+    // The thread id is printed in hex to match the "0x?" pattern of the
+    // background mode whitelist.
+    MemoryAllocatorDump* thread_dump = pmd->CreateAllocatorDump(
+        StringPrintf("%s/thread_0x%" PRIx64, kDumpName,
+                     static_cast<uint64_t>(stats.thread_id)));
+    AddSlabScalars(thread_dump, stats.reserved_size, stats.nodes_in_use,
+                   stats.num_fallback_allocations);
+  }
+
+  MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(kDumpName);
+  AddSlabScalars(dump, total_reserved_size, total_nodes_in_use,
+                 total_fallback_allocations);
+
+  // Slabs are allocated with malloc.
+  const char* system_allocator_name =
+      MemoryDumpManager::GetInstance()->system_allocator_pool_name();
+  if (system_allocator_name)
+    pmd->AddSuballocation(dump->guid(), system_allocator_name);
+  return true;
+}
+
+}  // namespace trace_event
+}  // namespace base
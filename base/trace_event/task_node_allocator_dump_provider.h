@@ -0,0 +1,38 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TRACE_EVENT_TASK_NODE_ALLOCATOR_DUMP_PROVIDER_H_
+#define BASE_TRACE_EVENT_TASK_NODE_ALLOCATOR_DUMP_PROVIDER_H_
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/memory/singleton.h"
+#include "base/trace_event/memory_dump_provider.h"
+
+namespace base {
+namespace trace_event {
+
+// Dump provider which reports the per-thread slabs of
+// internal::TaskNodeAllocator.
+class BASE_EXPORT TaskNodeAllocatorDumpProvider : public MemoryDumpProvider {
+ public:
+  static TaskNodeAllocatorDumpProvider* GetInstance();
+
+  // MemoryDumpProvider implementation.
+  bool OnMemoryDump(const MemoryDumpArgs& args,
+                    ProcessMemoryDump* pmd) override;
+
+ private:
+  friend struct DefaultSingletonTraits<TaskNodeAllocatorDumpProvider>;
+
+  TaskNodeAllocatorDumpProvider();
+  ~TaskNodeAllocatorDumpProvider() override;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskNodeAllocatorDumpProvider);
+};
+
+}  // namespace trace_event
+}  // namespace base
+
+#endif  // BASE_TRACE_EVENT_TASK_NODE_ALLOCATOR_DUMP_PROVIDER_H_
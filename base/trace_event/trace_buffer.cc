@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/memory/ptr_util.h"
 #include "base/trace_event/heap_profiler.h"
 #include "base/trace_event/trace_event_impl.h"
 
@@ -19,12 +20,16 @@ namespace {
 
 class TraceBufferRingBuffer : public TraceBuffer {
  public:
-  TraceBufferRingBuffer(size_t max_chunks)
+  // If |evict_chunks| is true, the oldest chunks of events are evicted instead
+  // of being overwritten.
+  TraceBufferRingBuffer(size_t max_chunks, bool evict_chunks)
       : max_chunks_(max_chunks),
+        evict_chunks_(evict_chunks),
         recyclable_chunks_queue_(new size_t[queue_capacity()]),
         queue_head_(0),
         queue_tail_(max_chunks),
         current_iteration_index_(0),
+        evicted_chunks_iteration_index_(0),
         current_chunk_seq_(1) {
     chunks_.reserve(max_chunks);
     for (size_t i = 0; i < max_chunks; ++i)
@@ -47,6 +52,10 @@ class TraceBufferRingBuffer : public TraceBuffer {
 
     TraceBufferChunk* chunk = chunks_[*index].release();
     chunks_[*index] = NULL;  // Put NULL in the slot of a in-flight chunk.
+    if (chunk && chunk->size() && evict_chunks_) {
+      evicted_chunks_.push_back(WrapUnique(chunk));
+      chunk = NULL;
+    }
     if (chunk)
       chunk->Reset(current_chunk_seq_++);
     else
@@ -89,6 +98,9 @@ class TraceBufferRingBuffer : public TraceBuffer {
   }
 
   const TraceBufferChunk* NextChunk() override {
+    if (evicted_chunks_iteration_index_ < evicted_chunks_.size())
+      return evicted_chunks_[evicted_chunks_iteration_index_++].get();
+
     if (chunks_.empty())
       return NULL;
 
@@ -113,6 +125,18 @@ class TraceBufferRingBuffer : public TraceBuffer {
         continue;
       chunks_[chunk_index]->EstimateTraceMemoryOverhead(overhead);
     }
+    for (const auto& chunk : evicted_chunks_)
+      chunk->EstimateTraceMemoryOverhead(overhead);
+  }
+
+  bool HasEvictedChunks() const override { return !evicted_chunks_.empty(); }
+
+  void TakeEvictedChunks(
+      std::vector<std::unique_ptr<TraceBufferChunk>>* chunks) override {
+    DCHECK(!evicted_chunks_iteration_index_);
+    for (auto& chunk : evicted_chunks_)
+      chunks->push_back(std::move(chunk));
+    evicted_chunks_.clear();
   }
 
  private:
@@ -139,6 +163,7 @@ class TraceBufferRingBuffer : public TraceBuffer {
   }
 
   size_t max_chunks_;
+  const bool evict_chunks_;
   std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
 
   std::unique_ptr<size_t[]> recyclable_chunks_queue_;
@@ -146,6 +171,12 @@ class TraceBufferRingBuffer : public TraceBuffer {
   size_t queue_tail_;
 
   size_t current_iteration_index_;
+
+  // The evicted chunks, from the oldest, and the index of the next one to be
+  // iterated.
+  std::vector<std::unique_ptr<TraceBufferChunk>> evicted_chunks_;
+  size_t evicted_chunks_iteration_index_;
+
   uint32_t current_chunk_seq_;
 
   DISALLOW_COPY_AND_ASSIGN(TraceBufferRingBuffer);
@@ -231,6 +262,11 @@ class TraceBufferVector : public TraceBuffer {
     }
   }
 
+  bool HasEvictedChunks() const override { return false; }
+
+  void TakeEvictedChunks(
+      std::vector<std::unique_ptr<TraceBufferChunk>>* chunks) override {}
+
  private:
   size_t in_flight_chunk_count_;
   size_t current_iteration_index_;
@@ -333,7 +369,12 @@ void TraceResultBuffer::Finish() {
 }
 
 TraceBuffer* TraceBuffer::CreateTraceBufferRingBuffer(size_t max_chunks) {
-  return new TraceBufferRingBuffer(max_chunks);
+  return new TraceBufferRingBuffer(max_chunks, false);
+}
+
+TraceBuffer* TraceBuffer::CreateTraceBufferStreamingRingBuffer(
+    size_t max_chunks) {
+  return new TraceBufferRingBuffer(max_chunks, true);
 }
 
 TraceBuffer* TraceBuffer::CreateTraceBufferVectorOfSize(size_t max_chunks) {
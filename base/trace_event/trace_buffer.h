@@ -8,6 +8,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/trace_event/trace_event.h"
 #include "base/trace_event/trace_event_impl.h"
@@ -77,7 +80,16 @@ class BASE_EXPORT TraceBuffer {
   virtual void EstimateTraceMemoryOverhead(
       TraceEventMemoryOverhead* overhead) = 0;
 
+  // A streaming ring buffer evicts its oldest chunks of events instead of
+  // overwriting them. The evicted chunks are iterated first by NextChunk(),
+  // unless they have been taken with TakeEvictedChunks(). Other buffers never
+  // evict chunks.
+  virtual bool HasEvictedChunks() const = 0;
+  virtual void TakeEvictedChunks(
+      std::vector<std::unique_ptr<TraceBufferChunk>>* chunks) = 0;
+
   static TraceBuffer* CreateTraceBufferRingBuffer(size_t max_chunks);
+  static TraceBuffer* CreateTraceBufferStreamingRingBuffer(size_t max_chunks);
   static TraceBuffer* CreateTraceBufferVectorOfSize(size_t max_chunks);
 };
 
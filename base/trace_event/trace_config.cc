@@ -32,12 +32,14 @@ const char kTraceToConsole[] = "trace-to-console";
 const char kEnableSampling[] = "enable-sampling";
 const char kEnableSystrace[] = "enable-systrace";
 const char kEnableArgumentFilter[] = "enable-argument-filter";
+const char kEnableHardwareCounters[] = "enable-hardware-counters";
 
 // String parameters that can be used to parse the trace config string.
 const char kRecordModeParam[] = "record_mode";
 const char kEnableSamplingParam[] = "enable_sampling";
 const char kEnableSystraceParam[] = "enable_systrace";
 const char kEnableArgumentFilterParam[] = "enable_argument_filter";
+const char kEnableHardwareCountersParam[] = "enable_hardware_counters";
 const char kIncludedCategoriesParam[] = "included_categories";
 const char kExcludedCategoriesParam[] = "excluded_categories";
 const char kSyntheticDelaysParam[] = "synthetic_delays";
@@ -52,6 +54,7 @@ const char kPeriodicIntervalParam[] = "periodic_interval_ms";
 const char kModeParam[] = "mode";
 const char kHeapProfilerOptions[] = "heap_profiler_options";
 const char kBreakdownThresholdBytes[] = "breakdown_threshold_bytes";
+const char kDeltaHeapDumps[] = "delta_heap_dumps";
 
 // Default configuration of memory dumps.
 const TraceConfig::MemoryDumpConfig::Trigger kDefaultHeavyMemoryDumpTrigger = {
@@ -79,10 +82,12 @@ class ConvertableTraceConfigToTraceFormat
 
 
 TraceConfig::MemoryDumpConfig::HeapProfiler::HeapProfiler() :
-    breakdown_threshold_bytes(kDefaultBreakdownThresholdBytes) {};
+    breakdown_threshold_bytes(kDefaultBreakdownThresholdBytes),
+    delta_heap_dumps(false) {};
 
 void TraceConfig::MemoryDumpConfig::HeapProfiler::Clear() {
   breakdown_threshold_bytes = kDefaultBreakdownThresholdBytes;
+  delta_heap_dumps = false;
 }
 
 void TraceConfig::ResetMemoryDumpConfig(
@@ -150,6 +155,7 @@ TraceConfig::TraceConfig(const TraceConfig& tc)
       enable_sampling_(tc.enable_sampling_),
       enable_systrace_(tc.enable_systrace_),
       enable_argument_filter_(tc.enable_argument_filter_),
+      enable_hardware_counters_(tc.enable_hardware_counters_),
       memory_dump_config_(tc.memory_dump_config_),
       included_categories_(tc.included_categories_),
       disabled_categories_(tc.disabled_categories_),
@@ -167,6 +173,7 @@ TraceConfig& TraceConfig::operator=(const TraceConfig& rhs) {
   enable_sampling_ = rhs.enable_sampling_;
   enable_systrace_ = rhs.enable_systrace_;
   enable_argument_filter_ = rhs.enable_argument_filter_;
+  enable_hardware_counters_ = rhs.enable_hardware_counters_;
   memory_dump_config_ = rhs.memory_dump_config_;
   included_categories_ = rhs.included_categories_;
   disabled_categories_ = rhs.disabled_categories_;
@@ -269,7 +276,8 @@ void TraceConfig::Merge(const TraceConfig& config) {
   if (record_mode_ != config.record_mode_
       || enable_sampling_ != config.enable_sampling_
       || enable_systrace_ != config.enable_systrace_
-      || enable_argument_filter_ != config.enable_argument_filter_) {
+      || enable_argument_filter_ != config.enable_argument_filter_
+      || enable_hardware_counters_ != config.enable_hardware_counters_) {
     DLOG(ERROR) << "Attempting to merge trace config with a different "
                 << "set of options.";
   }
@@ -305,6 +313,7 @@ void TraceConfig::Clear() {
   enable_sampling_ = false;
   enable_systrace_ = false;
   enable_argument_filter_ = false;
+  enable_hardware_counters_ = false;
   included_categories_.clear();
   disabled_categories_.clear();
   excluded_categories_.clear();
@@ -317,6 +326,7 @@ void TraceConfig::InitializeDefault() {
   enable_sampling_ = false;
   enable_systrace_ = false;
   enable_argument_filter_ = false;
+  enable_hardware_counters_ = false;
 }
 
 void TraceConfig::InitializeFromConfigDict(const DictionaryValue& dict) {
@@ -352,6 +362,13 @@ void TraceConfig::InitializeFromConfigDict(const DictionaryValue& dict) {
   else
     enable_argument_filter_ = enable_argument_filter;
 
+  bool enable_hardware_counters;
+  if (!dict.GetBoolean(kEnableHardwareCountersParam,
+                       &enable_hardware_counters))
+    enable_hardware_counters_ = false;
+  else
+    enable_hardware_counters_ = enable_hardware_counters;
+
   const base::ListValue* category_list = nullptr;
   if (dict.GetList(kIncludedCategoriesParam, &category_list))
     SetCategoriesFromIncludedList(*category_list);
@@ -428,6 +445,7 @@ void TraceConfig::InitializeFromStrings(
   enable_sampling_ = false;
   enable_systrace_ = false;
   enable_argument_filter_ = false;
+  enable_hardware_counters_ = false;
   if(!trace_options_string.empty()) {
     std::vector<std::string> split = base::SplitString(
         trace_options_string, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
@@ -447,6 +465,8 @@ void TraceConfig::InitializeFromStrings(
         enable_systrace_ = true;
       } else if (*iter == kEnableArgumentFilter) {
         enable_argument_filter_ = true;
+      } else if (*iter == kEnableHardwareCounters) {
+        enable_hardware_counters_ = true;
       }
     }
   }
@@ -556,6 +576,11 @@ void TraceConfig::SetMemoryDumpConfigFromConfigDict(
       memory_dump_config_.heap_profiler_options.breakdown_threshold_bytes =
           MemoryDumpConfig::HeapProfiler::kDefaultBreakdownThresholdBytes;
     }
+    bool delta_heap_dumps = false;
+    if (heap_profiler_options->GetBoolean(kDeltaHeapDumps, &delta_heap_dumps)) {
+      memory_dump_config_.heap_profiler_options.delta_heap_dumps =
+          delta_heap_dumps;
+    }
   }
 }
 
@@ -598,6 +623,10 @@ void TraceConfig::ToDict(base::DictionaryValue& dict) const {
   else
     dict.SetBoolean(kEnableArgumentFilterParam, false);
 
+  // Only written when set, so that existing configs round-trip unchanged.
+  if (enable_hardware_counters_)
+    dict.SetBoolean(kEnableHardwareCountersParam, true);
+
   StringList categories(included_categories_);
   categories.insert(categories.end(),
                     disabled_categories_.begin(),
@@ -625,13 +654,20 @@ void TraceConfig::ToDict(base::DictionaryValue& dict) const {
     // the periodic dumps are not enabled.
     memory_dump_config->Set(kTriggersParam, std::move(triggers_list));
 
-    if (memory_dump_config_.heap_profiler_options.breakdown_threshold_bytes !=
-        MemoryDumpConfig::HeapProfiler::kDefaultBreakdownThresholdBytes) {
+    const MemoryDumpConfig::HeapProfiler& heap_profiler =
+        memory_dump_config_.heap_profiler_options;
+    if (heap_profiler.breakdown_threshold_bytes !=
+            MemoryDumpConfig::HeapProfiler::kDefaultBreakdownThresholdBytes ||
+        heap_profiler.delta_heap_dumps) {
       std::unique_ptr<base::DictionaryValue> heap_profiler_options(
           new base::DictionaryValue());
-      heap_profiler_options->SetInteger(
-          kBreakdownThresholdBytes,
-          memory_dump_config_.heap_profiler_options.breakdown_threshold_bytes);
+      if (heap_profiler.breakdown_threshold_bytes !=
+          MemoryDumpConfig::HeapProfiler::kDefaultBreakdownThresholdBytes) {
+        heap_profiler_options->SetInteger(
+            kBreakdownThresholdBytes, heap_profiler.breakdown_threshold_bytes);
+      }
+      if (heap_profiler.delta_heap_dumps)
+        heap_profiler_options->SetBoolean(kDeltaHeapDumps, true);
       memory_dump_config->Set(kHeapProfilerOptions,
                               std::move(heap_profiler_options));
     }
@@ -663,6 +699,8 @@ std::string TraceConfig::ToTraceOptionsString() const {
     ret = ret + "," + kEnableSystrace;
   if (enable_argument_filter_)
     ret = ret + "," + kEnableArgumentFilter;
+  if (enable_hardware_counters_)
+    ret = ret + "," + kEnableHardwareCounters;
   return ret;
 }
 
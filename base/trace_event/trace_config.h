@@ -64,6 +64,11 @@ class BASE_EXPORT TraceConfig {
       void Clear();
 
       uint32_t breakdown_threshold_bytes;
+
+      // If set, heap dumps after the first one of each allocator only contain
+      // the entries which changed since the previous dump. See
+      // ExportHeapDump().
+      bool delta_heap_dumps;
     };
 
     // Reset the values in the config.
@@ -87,7 +92,7 @@ class BASE_EXPORT TraceConfig {
   // |trace_options_string| is a comma-delimited list of trace options.
   // Possible options are: "record-until-full", "record-continuously",
   // "record-as-much-as-possible", "trace-to-console", "enable-sampling",
-  // "enable-systrace" and "enable-argument-filter".
+  // "enable-systrace", "enable-argument-filter" and "enable-hardware-counters".
   // The first 4 options are trace recoding modes and hence
   // mutually exclusive. If more than one trace recording modes appear in the
   // options_string, the last one takes precedence. If none of the trace
@@ -95,9 +100,10 @@ class BASE_EXPORT TraceConfig {
   //
   // The trace option will first be reset to the default option
   // (record_mode set to RECORD_UNTIL_FULL, enable_sampling, enable_systrace,
-  // and enable_argument_filter set to false) before options parsed from
-  // |trace_options_string| are applied on it. If |trace_options_string| is
-  // invalid, the final state of trace options is undefined.
+  // enable_argument_filter and enable_hardware_counters set to false) before
+  // options parsed from |trace_options_string| are applied on it. If
+  // |trace_options_string| is invalid, the final state of trace options is
+  // undefined.
   //
   // Example: TraceConfig("test_MyTest*", "record-until-full");
   // Example: TraceConfig("test_MyTest*,test_OtherStuff",
@@ -135,6 +141,7 @@ class BASE_EXPORT TraceConfig {
   //     "enable_sampling": true,
   //     "enable_systrace": true,
   //     "enable_argument_filter": true,
+  //     "enable_hardware_counters": true,
   //     "included_categories": ["included",
   //                             "inc_pattern*",
   //                             "disabled-by-default-memory-infra"],
@@ -171,11 +178,13 @@ class BASE_EXPORT TraceConfig {
   bool IsSamplingEnabled() const { return enable_sampling_; }
   bool IsSystraceEnabled() const { return enable_systrace_; }
   bool IsArgumentFilterEnabled() const { return enable_argument_filter_; }
+  bool IsHardwareCountersEnabled() const { return enable_hardware_counters_; }
 
   void SetTraceRecordMode(TraceRecordMode mode) { record_mode_ = mode; }
   void EnableSampling() { enable_sampling_ = true; }
   void EnableSystrace() { enable_systrace_ = true; }
   void EnableArgumentFilter() { enable_argument_filter_ = true; }
+  void EnableHardwareCounters() { enable_hardware_counters_ = true; }
 
   // Writes the string representation of the TraceConfig. The string is JSON
   // formatted.
@@ -215,6 +224,7 @@ class BASE_EXPORT TraceConfig {
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest, TraceConfigFromMemoryConfigString);
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest, LegacyStringToMemoryDumpConfig);
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest, EmptyMemoryDumpConfigTest);
+  FRIEND_TEST_ALL_PREFIXES(TraceConfigTest, DeltaHeapDumpsConfigTest);
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest,
                            EmptyAndAsteriskCategoryFilterString);
 
@@ -270,6 +280,7 @@ class BASE_EXPORT TraceConfig {
   bool enable_sampling_ : 1;
   bool enable_systrace_ : 1;
   bool enable_argument_filter_ : 1;
+  bool enable_hardware_counters_ : 1;
 
   MemoryDumpConfig memory_dump_config_;
 
@@ -668,6 +668,50 @@ TEST(TraceConfigTest, EmptyMemoryDumpConfigTest) {
             .breakdown_threshold_bytes);
 }
 
+TEST(TraceConfigTest, HardwareCountersConfigTest) {
+  TraceConfig tc("*", "record-continuously,enable-hardware-counters");
+  EXPECT_TRUE(tc.IsHardwareCountersEnabled());
+  EXPECT_EQ(RECORD_CONTINUOUSLY, tc.GetTraceRecordMode());
+
+  TraceConfig tc_from_string(tc.ToString());
+  EXPECT_TRUE(tc_from_string.IsHardwareCountersEnabled());
+  EXPECT_EQ(tc.ToString(), tc_from_string.ToString());
+
+  // The option is only written when it is set.
+  TraceConfig default_tc;
+  EXPECT_FALSE(default_tc.IsHardwareCountersEnabled());
+  EXPECT_EQ(std::string::npos,
+            default_tc.ToString().find("enable_hardware_counters"));
+}
+
+TEST(TraceConfigTest, DeltaHeapDumpsConfigTest) {
+  const char kConfig[] =
+      "{"
+        "\"enable_argument_filter\":false,"
+        "\"enable_sampling\":false,"
+        "\"enable_systrace\":false,"
+        "\"included_categories\":[\"disabled-by-default-memory-infra\"],"
+        "\"memory_dump_config\":{"
+          "\"heap_profiler_options\":{"
+            "\"delta_heap_dumps\":true"
+          "},"
+          "\"triggers\":[]"
+        "},"
+        "\"record_mode\":\"record-until-full\""
+      "}";
+  TraceConfig tc(kConfig);
+  EXPECT_EQ(kConfig, tc.ToString());
+  EXPECT_TRUE(tc.memory_dump_config_.heap_profiler_options.delta_heap_dumps);
+  EXPECT_EQ(TraceConfig::MemoryDumpConfig::HeapProfiler
+            ::kDefaultBreakdownThresholdBytes,
+            tc.memory_dump_config_.heap_profiler_options
+            .breakdown_threshold_bytes);
+
+  TraceConfig default_tc(MemoryDumpManager::kTraceCategory, "");
+  EXPECT_FALSE(
+      default_tc.memory_dump_config_.heap_profiler_options.delta_heap_dumps);
+}
+
 TEST(TraceConfigTest, LegacyStringToMemoryDumpConfig) {
   TraceConfig tc(MemoryDumpManager::kTraceCategory, "");
   EXPECT_TRUE(tc.IsCategoryGroupEnabled(MemoryDumpManager::kTraceCategory));
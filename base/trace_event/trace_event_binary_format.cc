@@ -0,0 +1,576 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_event_binary_format.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/format_macros.h"
+#include "base/json/string_escape.h"
+#include "base/logging.h"
+#include "base/process/process_handle.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_hardware_counters.h"
+#include "base/trace_event/trace_log.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+// A stream starts with this magic, followed by the default process id.
+const char kMagic[] = {'T', 'R', 'B', '1'};
+
+// Bits of the field mask of an event, which tells which optional fields were
+// written.
+const uint8_t kHasProcessId = 1 << 0;
+const uint8_t kArgsStripped = 1 << 1;
+const uint8_t kHasDuration = 1 << 2;
+const uint8_t kHasThreadDuration = 1 << 3;
+const uint8_t kHasThreadTimestamp = 1 << 4;
+const uint8_t kHasHardwareCounters = 1 << 5;
+
+// Type of an argument whose value was stripped by the argument name filter.
+// TRACE_VALUE_TYPE_* values start at 1.
+const uint8_t kStrippedArgType = 0;
+
+// A string starts with one of these, or with the id of an interned string plus
+// kFirstInternedString. The first use of an interned string is followed by the
+// string, like an inline string.
+const uint64_t kNullString = 0;
+const uint64_t kInlineString = 1;
+const uint64_t kFirstInternedString = 2;
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Uses zigzag encoding, so that small negative values are short too.
+void AppendSignedVarint(int64_t value, std::string* out) {
+  AppendVarint((static_cast<uint64_t>(value) << 1) ^
+                   static_cast<uint64_t>(value >> 63),
+               out);
+}
+
+void AppendFixed64(uint64_t value, std::string* out) {
+  for (int i = 0; i < 8; ++i)
+    out->push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void AppendInlineString(StringPiece str, std::string* out) {
+  AppendVarint(str.size(), out);
+  str.AppendToString(out);
+}
+
+// Decodes a stream of TraceEventBinaryWriter back to JSON.
+class BinaryTraceReader {
+ public:
+  explicit BinaryTraceReader(StringPiece binary) : binary_(binary) {}
+
+  bool AtEnd() const { return position_ == binary_.size(); }
+
+  bool ReadHeader();
+
+  // Appends the JSON of the next event to |out|.
+  bool ReadEventAsJSON(std::string* out);
+
+ private:
+  bool ReadBytes(size_t size, StringPiece* bytes);
+  bool ReadByte(uint8_t* value);
+  bool ReadVarint(uint64_t* value);
+  bool ReadSignedVarint(int64_t* value);
+  bool ReadFixed64(uint64_t* value);
+
+  // Reads a string written by TraceEventBinaryWriter::AppendString().
+  // |*is_null| is set to whether it was null.
+  bool ReadString(std::string* value, bool* is_null);
+
+  const StringPiece binary_;
+  size_t position_ = 0;
+
+  int process_id_ = 0;
+  int64_t last_timestamp_ = 0;
+  int64_t last_thread_timestamp_ = 0;
+  std::vector<std::string> interned_strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryTraceReader);
+};
+
+bool BinaryTraceReader::ReadBytes(size_t size, StringPiece* bytes) {
+  if (binary_.size() - position_ < size)
+    return false;
+  *bytes = binary_.substr(position_, size);
+  position_ += size;
+  return true;
+}
+
+bool BinaryTraceReader::ReadByte(uint8_t* value) {
+  StringPiece byte;
+  if (!ReadBytes(1, &byte))
+    return false;
+  *value = static_cast<uint8_t>(byte[0]);
+  return true;
+}
+
+bool BinaryTraceReader::ReadVarint(uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    if (!ReadByte(&byte))
+      return false;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool BinaryTraceReader::ReadSignedVarint(int64_t* value) {
+  uint64_t zigzag;
+  if (!ReadVarint(&zigzag))
+    return false;
+  *value =
+      static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+  return true;
+}
+
+bool BinaryTraceReader::ReadFixed64(uint64_t* value) {
+  StringPiece bytes;
+  if (!ReadBytes(8, &bytes))
+    return false;
+  *value = 0;
+  for (int i = 0; i < 8; ++i) {
+    *value |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i]))
+              << (8 * i);
+  }
+  return true;
+}
+
+bool BinaryTraceReader::ReadString(std::string* value, bool* is_null) {
+  uint64_t ref;
+  if (!ReadVarint(&ref))
+    return false;
+  *is_null = ref == kNullString;
+  value->clear();
+  if (*is_null)
+    return true;
+
+  if (ref >= kFirstInternedString) {
+    const uint64_t id = ref - kFirstInternedString;
+    if (id < interned_strings_.size()) {
+      *value = interned_strings_[id];
+      return true;
+    }
+    // Otherwise, this is the first use of the next interned string.
+    if (id != interned_strings_.size())
+      return false;
+  }
+
+  uint64_t size;
+  StringPiece bytes;
+  if (!ReadVarint(&size) || !ReadBytes(size, &bytes))
+    return false;
+  bytes.CopyToString(value);
+  if (ref >= kFirstInternedString)
+    interned_strings_.push_back(*value);
+  return true;
+}
+
+bool BinaryTraceReader::ReadHeader() {
+  StringPiece magic;
+  int64_t process_id;
+  if (!ReadBytes(sizeof(kMagic), &magic) ||
+      magic != StringPiece(kMagic, sizeof(kMagic)) ||
+      !ReadSignedVarint(&process_id)) {
+    return false;
+  }
+  process_id_ = static_cast<int>(process_id);
+  return true;
+}
+
+// Mirrors TraceEvent::AppendAsJSON().
+bool BinaryTraceReader::ReadEventAsJSON(std::string* out) {
+  uint8_t phase;
+  uint64_t flags;
+  uint8_t fields;
+  int64_t thread_or_process_id;
+  int64_t timestamp_delta;
+  std::string category_group_name;
+  std::string name;
+  bool is_null;
+  if (!ReadByte(&phase) || !ReadVarint(&flags) || !ReadByte(&fields) ||
+      !ReadSignedVarint(&thread_or_process_id) ||
+      !ReadSignedVarint(&timestamp_delta) ||
+      !ReadString(&category_group_name, &is_null) ||
+      !ReadString(&name, &is_null)) {
+    return false;
+  }
+
+  int process_id = process_id_;
+  int thread_id = static_cast<int>(thread_or_process_id);
+  if (fields & kHasProcessId) {
+    process_id = static_cast<int>(thread_or_process_id);
+    thread_id = -1;
+  }
+  last_timestamp_ += timestamp_delta;
+  StringAppendF(out, "{\"pid\":%i,\"tid\":%i,\"ts\":%" PRId64
+                     ",\"ph\":\"%c\",\"cat\":\"%s\",\"name\":",
+                process_id, thread_id, last_timestamp_, phase,
+                category_group_name.c_str());
+  EscapeJSONString(name, true, out);
+  *out += ",\"args\":";
+
+  if (fields & kArgsStripped) {
+    *out += "\"__stripped__\"";
+  } else {
+    uint64_t num_args;
+    if (!ReadVarint(&num_args) || num_args > kTraceMaxNumArgs)
+      return false;
+    *out += "{";
+    for (uint64_t i = 0; i < num_args; ++i) {
+      std::string arg_name;
+      uint8_t type;
+      if (!ReadString(&arg_name, &is_null) || !ReadByte(&type))
+        return false;
+      if (i > 0)
+        *out += ",";
+      *out += "\"";
+      *out += arg_name;
+      *out += "\":";
+
+      TraceEvent::TraceValue value;
+      std::string str;
+      switch (type) {
+        case kStrippedArgType:
+          *out += "\"__stripped__\"";
+          break;
+        case TRACE_VALUE_TYPE_BOOL: {
+          uint8_t byte;
+          if (!ReadByte(&byte))
+            return false;
+          value.as_bool = byte != 0;
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_UINT: {
+          uint64_t uint_value;
+          if (!ReadVarint(&uint_value))
+            return false;
+          value.as_uint = uint_value;
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_INT: {
+          int64_t int_value;
+          if (!ReadSignedVarint(&int_value))
+            return false;
+          value.as_int = int_value;
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_DOUBLE: {
+          uint64_t bits;
+          if (!ReadFixed64(&bits))
+            return false;
+          memcpy(&value.as_double, &bits, sizeof(bits));
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_POINTER: {
+          uint64_t pointer;
+          if (!ReadVarint(&pointer))
+            return false;
+          value.as_pointer =
+              reinterpret_cast<const void*>(static_cast<uintptr_t>(pointer));
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_STRING:
+        case TRACE_VALUE_TYPE_COPY_STRING:
+          if (!ReadString(&str, &is_null))
+            return false;
+          value.as_string = is_null ? nullptr : str.c_str();
+          TraceEvent::AppendValueAsJSON(type, value, out);
+          break;
+        case TRACE_VALUE_TYPE_CONVERTABLE:
+          if (!ReadString(&str, &is_null))
+            return false;
+          *out += str;
+          break;
+        default:
+          // Values of unknown types have no JSON, and aren't written either.
+          break;
+      }
+    }
+    *out += "}";
+  }
+
+  int64_t duration;
+  if (fields & kHasDuration) {
+    if (!ReadSignedVarint(&duration))
+      return false;
+    StringAppendF(out, ",\"dur\":%" PRId64, duration);
+  }
+  if (fields & kHasThreadDuration) {
+    if (!ReadSignedVarint(&duration))
+      return false;
+    StringAppendF(out, ",\"tdur\":%" PRId64, duration);
+  }
+  if (fields & kHasHardwareCounters) {
+    HardwareCounters counters;
+    for (uint64_t& value : counters.values) {
+      if (!ReadVarint(&value))
+        return false;
+    }
+    *out += ",\"hwc\":";
+    counters.AppendAsJSON(out);
+  }
+  if (fields & kHasThreadTimestamp) {
+    int64_t thread_timestamp_delta;
+    if (!ReadSignedVarint(&thread_timestamp_delta))
+      return false;
+    last_thread_timestamp_ += thread_timestamp_delta;
+    StringAppendF(out, ",\"tts\":%" PRId64, last_thread_timestamp_);
+  }
+
+  if (flags & TRACE_EVENT_FLAG_ASYNC_TTS)
+    StringAppendF(out, ", \"use_async_tts\":1");
+
+  if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    std::string scope;
+    uint64_t id;
+    if (!ReadString(&scope, &is_null) || !ReadVarint(&id))
+      return false;
+    if (!is_null)
+      StringAppendF(out, ",\"scope\":\"%s\"", scope.c_str());
+    StringAppendF(out, ",\"id\":\"0x%" PRIx64 "\"", id);
+  }
+
+  if (flags & TRACE_EVENT_FLAG_BIND_TO_ENCLOSING)
+    StringAppendF(out, ",\"bp\":\"e\"");
+
+  if ((flags & TRACE_EVENT_FLAG_FLOW_OUT) ||
+      (flags & TRACE_EVENT_FLAG_FLOW_IN)) {
+    uint64_t bind_id;
+    if (!ReadVarint(&bind_id))
+      return false;
+    StringAppendF(out, ",\"bind_id\":\"0x%" PRIx64 "\"", bind_id);
+  }
+  if (flags & TRACE_EVENT_FLAG_FLOW_IN)
+    StringAppendF(out, ",\"flow_in\":true");
+  if (flags & TRACE_EVENT_FLAG_FLOW_OUT)
+    StringAppendF(out, ",\"flow_out\":true");
+
+  if (phase == TRACE_EVENT_PHASE_INSTANT) {
+    char scope = '?';
+    switch (flags & TRACE_EVENT_FLAG_SCOPE_MASK) {
+      case TRACE_EVENT_SCOPE_GLOBAL:
+        scope = TRACE_EVENT_SCOPE_NAME_GLOBAL;
+        break;
+
+      case TRACE_EVENT_SCOPE_PROCESS:
+        scope = TRACE_EVENT_SCOPE_NAME_PROCESS;
+        break;
+
+      case TRACE_EVENT_SCOPE_THREAD:
+        scope = TRACE_EVENT_SCOPE_NAME_THREAD;
+        break;
+    }
+    StringAppendF(out, ",\"s\":\"%c\"", scope);
+  }
+
+  *out += "}";
+  return true;
+}
+
+}  // namespace
+
+TraceEventBinaryWriter::TraceEventBinaryWriter(
+    int process_id,
+    const ArgumentFilterPredicate& argument_filter_predicate)
+    : process_id_(process_id),
+      argument_filter_predicate_(argument_filter_predicate) {}
+
+TraceEventBinaryWriter::~TraceEventBinaryWriter() {}
+
+void TraceEventBinaryWriter::AppendHeader(std::string* out) const {
+  out->append(kMagic, sizeof(kMagic));
+  AppendSignedVarint(process_id_, out);
+}
+
+// Mirrors TraceEvent::AppendAsJSON().
+void TraceEventBinaryWriter::AppendEvent(const TraceEvent& event,
+                                         std::string* out) {
+  const unsigned int flags = event.flags_;
+  const bool is_copy = !!(flags & TRACE_EVENT_FLAG_COPY);
+  const char* category_group_name =
+      TraceLog::GetCategoryGroupName(event.category_group_enabled_);
+
+  ArgumentNameFilterPredicate argument_name_filter_predicate;
+  const bool strip_args =
+      event.arg_names_[0] && !argument_filter_predicate_.is_null() &&
+      !argument_filter_predicate_.Run(category_group_name, event.name_,
+                                      &argument_name_filter_predicate);
+
+  const bool has_process_id = (flags & TRACE_EVENT_FLAG_HAS_PROCESS_ID) &&
+                              event.process_id_ != kNullProcessId;
+  const bool is_complete = event.phase_ == TRACE_EVENT_PHASE_COMPLETE;
+  const bool has_thread_timestamp = !event.thread_timestamp_.is_null();
+  const int64_t duration = event.duration_.ToInternalValue();
+  const int64_t thread_duration = event.thread_duration_.ToInternalValue();
+
+  uint8_t fields = 0;
+  if (has_process_id)
+    fields |= kHasProcessId;
+  if (strip_args)
+    fields |= kArgsStripped;
+  if (is_complete && duration != -1)
+    fields |= kHasDuration;
+  if (is_complete && has_thread_timestamp && thread_duration != -1)
+    fields |= kHasThreadDuration;
+  if (has_thread_timestamp)
+    fields |= kHasThreadTimestamp;
+  if (is_complete && duration != -1 && event.hardware_counters_)
+    fields |= kHasHardwareCounters;
+
+  out->push_back(event.phase_);
+  AppendVarint(flags, out);
+  out->push_back(static_cast<char>(fields));
+  AppendSignedVarint(has_process_id ? event.process_id_ : event.thread_id_,
+                     out);
+  const int64_t timestamp = event.timestamp_.ToInternalValue();
+  AppendSignedVarint(timestamp - last_timestamp_, out);
+  last_timestamp_ = timestamp;
+  AppendString(category_group_name, false, out);
+  AppendString(event.name_, is_copy, out);
+
+  if (!strip_args) {
+    int num_args = 0;
+    while (num_args < kTraceMaxNumArgs && event.arg_names_[num_args])
+      ++num_args;
+    AppendVarint(num_args, out);
+
+    for (int i = 0; i < num_args; ++i) {
+      AppendString(event.arg_names_[i], is_copy, out);
+      if (!argument_name_filter_predicate.is_null() &&
+          !argument_name_filter_predicate.Run(event.arg_names_[i])) {
+        out->push_back(static_cast<char>(kStrippedArgType));
+        continue;
+      }
+
+      const unsigned char type = event.arg_types_[i];
+      const TraceEvent::TraceValue& value = event.arg_values_[i];
+      out->push_back(static_cast<char>(type));
+      switch (type) {
+        case TRACE_VALUE_TYPE_BOOL:
+          out->push_back(value.as_bool ? 1 : 0);
+          break;
+        case TRACE_VALUE_TYPE_UINT:
+          AppendVarint(value.as_uint, out);
+          break;
+        case TRACE_VALUE_TYPE_INT:
+          AppendSignedVarint(value.as_int, out);
+          break;
+        case TRACE_VALUE_TYPE_DOUBLE: {
+          uint64_t bits;
+          memcpy(&bits, &value.as_double, sizeof(bits));
+          AppendFixed64(bits, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_POINTER:
+          AppendVarint(reinterpret_cast<uintptr_t>(value.as_pointer), out);
+          break;
+        case TRACE_VALUE_TYPE_STRING:
+          AppendString(value.as_string, false, out);
+          break;
+        case TRACE_VALUE_TYPE_COPY_STRING:
+          AppendString(value.as_string, true, out);
+          break;
+        case TRACE_VALUE_TYPE_CONVERTABLE: {
+          std::string json;
+          event.convertable_values_[i]->AppendAsTraceFormat(&json);
+          AppendVarint(kInlineString, out);
+          AppendInlineString(json, out);
+          break;
+        }
+        default:
+          NOTREACHED() << "Don't know how to write this value";
+          break;
+      }
+    }
+  }
+
+  if (fields & kHasDuration)
+    AppendSignedVarint(duration, out);
+  if (fields & kHasThreadDuration)
+    AppendSignedVarint(thread_duration, out);
+  if (fields & kHasHardwareCounters) {
+    for (uint64_t value : event.hardware_counters_->values)
+      AppendVarint(value, out);
+  }
+  if (has_thread_timestamp) {
+    const int64_t thread_timestamp = event.thread_timestamp_.ToInternalValue();
+    AppendSignedVarint(thread_timestamp - last_thread_timestamp_, out);
+    last_thread_timestamp_ = thread_timestamp;
+  }
+
+  if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    AppendString(event.scope_, is_copy, out);
+    AppendVarint(event.id_, out);
+  }
+  if ((flags & TRACE_EVENT_FLAG_FLOW_OUT) ||
+      (flags & TRACE_EVENT_FLAG_FLOW_IN)) {
+    AppendVarint(event.bind_id_, out);
+  }
+}
+
+void TraceEventBinaryWriter::AppendString(const char* str,
+                                          bool is_copy,
+                                          std::string* out) {
+  if (!str) {
+    AppendVarint(kNullString, out);
+    return;
+  }
+  if (is_copy) {
+    AppendVarint(kInlineString, out);
+    AppendInlineString(str, out);
+    return;
+  }
+
+  auto it = string_ids_.find(str);
+  if (it != string_ids_.end()) {
+    AppendVarint(kFirstInternedString + it->second, out);
+    return;
+  }
+  const uint32_t id = static_cast<uint32_t>(string_ids_.size());
+  string_ids_[str] = id;
+  AppendVarint(kFirstInternedString + id, out);
+  AppendInlineString(str, out);
+}
+
+bool ConvertBinaryTraceToJSON(StringPiece binary, std::string* json) {
+  BinaryTraceReader reader(binary);
+  if (!reader.ReadHeader())
+    return false;
+
+  std::string events;
+  while (!reader.AtEnd()) {
+    if (!events.empty())
+      events += ",\n";
+    if (!reader.ReadEventAsJSON(&events))
+      return false;
+  }
+  json->append(events);
+  return true;
+}
+
+}  // namespace trace_event
+}  // namespace base
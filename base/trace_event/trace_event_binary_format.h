@@ -0,0 +1,79 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TRACE_EVENT_TRACE_EVENT_BINARY_FORMAT_H_
+#define BASE_TRACE_EVENT_TRACE_EVENT_BINARY_FORMAT_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+
+#include "base/base_export.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/trace_event/trace_event_impl.h"
+
+namespace base {
+namespace trace_event {
+
+// Serializes TraceEvents into a compact binary stream, which is much cheaper
+// to produce and smaller than the JSON of TraceEvent::AppendAsJSON().
+// ConvertBinaryTraceToJSON() turns the stream into that JSON offline.
+//
+// Integers are varints, and timestamps are deltas from the previous event.
+// Category groups and the names and string arguments of events which weren't
+// copied are interned by address: the first event which uses a string writes
+// it, later ones only write its id. A stream can therefore only be decoded as
+// a whole, from its header on.
+//
+// The writer holds on to the addresses of the strings it interned, so the
+// events it serializes must outlive it. This is the case when serializing a
+// TraceBuffer which is being flushed.
+class BASE_EXPORT TraceEventBinaryWriter {
+ public:
+  // |process_id| is output for events which don't have their own. Arguments
+  // are stripped as in TraceEvent::AppendAsJSON() according to
+  // |argument_filter_predicate|, which can be null.
+  TraceEventBinaryWriter(
+      int process_id,
+      const ArgumentFilterPredicate& argument_filter_predicate);
+  ~TraceEventBinaryWriter();
+
+  // Appends the header of the stream to |out|. Must be called once, before
+  // AppendEvent().
+  void AppendHeader(std::string* out) const;
+
+  // Appends |event| to |out|.
+  void AppendEvent(const TraceEvent& event, std::string* out);
+
+ private:
+  // Appends |str|, which can be null, to |out|. |str| is interned unless
+  // |is_copy| is true.
+  void AppendString(const char* str, bool is_copy, std::string* out);
+
+  const int process_id_;
+  const ArgumentFilterPredicate argument_filter_predicate_;
+
+  // Ids of the interned strings.
+  std::unordered_map<const char*, uint32_t> string_ids_;
+
+  // Timestamps of the last event, from which the next one is encoded.
+  int64_t last_timestamp_ = 0;
+  int64_t last_thread_timestamp_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceEventBinaryWriter);
+};
+
+// Converts a whole stream of TraceEventBinaryWriter to the comma-separated
+// JSON trace events which TraceLog::Flush() would have output, and appends
+// them to |json|, e.g. to be added to a TraceResultBuffer. Returns false if
+// |binary| is malformed or truncated.
+BASE_EXPORT bool ConvertBinaryTraceToJSON(StringPiece binary,
+                                          std::string* json);
+
+}  // namespace trace_event
+}  // namespace base
+
+#endif  // BASE_TRACE_EVENT_TRACE_EVENT_BINARY_FORMAT_H_
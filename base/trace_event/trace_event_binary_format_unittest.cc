@@ -0,0 +1,356 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_event_binary_format.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/json/json_reader.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_util.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_argument.h"
+#include "base/trace_event/trace_event_hardware_counters.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+const char kCategory[] = "binary_format_test";
+
+class TraceEventBinaryFormatTest : public testing::Test {
+ public:
+  TraceEventBinaryFormatTest() = default;
+
+ protected:
+  // Adds an event with no arguments.
+  TraceEvent* AddEvent(char phase, const char* name, unsigned int flags) {
+    return AddEventWithArgs(phase, name, flags, 0, nullptr, nullptr, nullptr,
+                            nullptr);
+  }
+
+  TraceEvent* AddEventWithArgs(
+      char phase,
+      const char* name,
+      unsigned int flags,
+      int num_args,
+      const char** arg_names,
+      const unsigned char* arg_types,
+      const unsigned long long* arg_values,
+      std::unique_ptr<ConvertableToTraceFormat>* convertable_values) {
+    std::unique_ptr<TraceEvent> event(new TraceEvent);
+    const int64_t index = static_cast<int64_t>(events_.size());
+    event->Initialize(
+        42, TimeTicks::FromInternalValue(1000000 + 25 * index),
+        ThreadTicks::FromInternalValue(500 + 10 * index), phase,
+        TraceLog::GetCategoryGroupEnabled(kCategory), name,
+        trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+        trace_event_internal::kNoId, num_args, arg_names, arg_types,
+        arg_values, convertable_values, flags);
+    events_.push_back(std::move(event));
+    return events_.back().get();
+  }
+
+  // Verifies that converting the binary stream of |events_| gives their JSON.
+  void ExpectBinaryMatchesJSON(const ArgumentFilterPredicate& predicate) {
+    std::string expected_json;
+    TraceEventBinaryWriter writer(TraceLog::GetInstance()->process_id(),
+                                  predicate);
+    std::string binary;
+    writer.AppendHeader(&binary);
+    for (const auto& event : events_) {
+      if (!expected_json.empty())
+        expected_json += ",\n";
+      event->AppendAsJSON(&expected_json, predicate);
+      writer.AppendEvent(*event, &binary);
+    }
+    if (!events_.empty())
+      EXPECT_LT(binary.size(), expected_json.size());
+
+    std::string json;
+    ASSERT_TRUE(ConvertBinaryTraceToJSON(binary, &json));
+    EXPECT_EQ(expected_json, json);
+  }
+
+  std::vector<std::unique_ptr<TraceEvent>> events_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TraceEventBinaryFormatTest);
+};
+
+bool IsArgumentNameAllowed(const char* arg_name) {
+  return strcmp(arg_name, "allowed") == 0;
+}
+
+// Strips all the arguments of "stripped" events, and filters the arguments of
+// "filtered" events by name.
+bool FilterArguments(const char* category_group_name,
+                     const char* event_name,
+                     ArgumentNameFilterPredicate* arg_name_filter) {
+  if (strcmp(event_name, "filtered") == 0) {
+    *arg_name_filter = Bind(&IsArgumentNameAllowed);
+    return true;
+  }
+  return strcmp(event_name, "stripped") != 0;
+}
+
+void AppendFlushedData(std::string* out,
+                       const scoped_refptr<RefCountedString>& data,
+                       bool has_more_events) {
+  out->append(data->data());
+}
+
+}  // namespace
+
+TEST_F(TraceEventBinaryFormatTest, Empty) {
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, Phases) {
+  AddEvent(TRACE_EVENT_PHASE_BEGIN, "begin", TRACE_EVENT_FLAG_NONE);
+  AddEvent(TRACE_EVENT_PHASE_END, "begin", TRACE_EVENT_FLAG_NONE);
+  AddEvent(TRACE_EVENT_PHASE_INSTANT, "instant", TRACE_EVENT_SCOPE_THREAD);
+  AddEvent(TRACE_EVENT_PHASE_INSTANT, "instant", TRACE_EVENT_SCOPE_PROCESS);
+  AddEvent(TRACE_EVENT_PHASE_INSTANT, "instant", TRACE_EVENT_SCOPE_GLOBAL);
+
+  TraceEvent* complete = AddEvent(TRACE_EVENT_PHASE_COMPLETE, "complete",
+                                  TRACE_EVENT_FLAG_NONE);
+  complete->UpdateDuration(
+      complete->timestamp() + TimeDelta::FromInternalValue(7),
+      complete->thread_timestamp() + TimeDelta::FromInternalValue(3));
+  // A complete event whose duration was never set.
+  AddEvent(TRACE_EVENT_PHASE_COMPLETE, "complete", TRACE_EVENT_FLAG_NONE);
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, HardwareCounters) {
+  HardwareCounters start;
+  HardwareCounters end;
+  for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i) {
+    start.values[i] = 1000 * i;
+    end.values[i] = 1500 * i + 1;
+  }
+  TraceEvent* complete = AddEvent(TRACE_EVENT_PHASE_COMPLETE, "complete",
+                                  TRACE_EVENT_FLAG_NONE);
+  complete->SetHardwareCounters(start);
+  complete->UpdateDuration(
+      complete->timestamp() + TimeDelta::FromInternalValue(7),
+      complete->thread_timestamp() + TimeDelta::FromInternalValue(3));
+  complete->UpdateHardwareCounters(&end);
+  ASSERT_TRUE(complete->hardware_counters());
+  EXPECT_EQ(501u, complete->hardware_counters()->values[1]);
+
+  // The counters of an event which didn't end aren't written.
+  AddEvent(TRACE_EVENT_PHASE_COMPLETE, "complete", TRACE_EVENT_FLAG_NONE)
+      ->SetHardwareCounters(start);
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, IdsAndFlags) {
+  std::unique_ptr<TraceEvent> event(new TraceEvent);
+  event->Initialize(
+      42, TimeTicks::FromInternalValue(1000), ThreadTicks(),
+      TRACE_EVENT_PHASE_ASYNC_BEGIN,
+      TraceLog::GetCategoryGroupEnabled(kCategory), "async", "scope",
+      0x1234567890ull, 0xabcdefull, 0, nullptr, nullptr, nullptr, nullptr,
+      TRACE_EVENT_FLAG_HAS_ID | TRACE_EVENT_FLAG_FLOW_OUT |
+          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_BIND_TO_ENCLOSING |
+          TRACE_EVENT_FLAG_ASYNC_TTS);
+  events_.push_back(std::move(event));
+
+  // An id in the global scope.
+  event.reset(new TraceEvent);
+  event->Initialize(
+      42, TimeTicks::FromInternalValue(900), ThreadTicks(),
+      TRACE_EVENT_PHASE_ASYNC_END,
+      TraceLog::GetCategoryGroupEnabled(kCategory), "async",
+      trace_event_internal::kGlobalScope, 0x1234567890ull,
+      trace_event_internal::kNoId, 0, nullptr, nullptr, nullptr, nullptr,
+      TRACE_EVENT_FLAG_HAS_ID);
+  events_.push_back(std::move(event));
+
+  // An event of another process.
+  event.reset(new TraceEvent);
+  event->Initialize(
+      1234, TimeTicks::FromInternalValue(800), ThreadTicks(),
+      TRACE_EVENT_PHASE_INSTANT,
+      TraceLog::GetCategoryGroupEnabled(kCategory), "other process",
+      trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+      trace_event_internal::kNoId, 0, nullptr, nullptr, nullptr, nullptr,
+      TRACE_EVENT_FLAG_HAS_PROCESS_ID);
+  events_.push_back(std::move(event));
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, Arguments) {
+  const char* arg_names[] = {"first", "second"};
+  unsigned char arg_types[2];
+  unsigned long long arg_values[2];
+
+  trace_event_internal::SetTraceValue(-12345, &arg_types[0], &arg_values[0]);
+  trace_event_internal::SetTraceValue(std::numeric_limits<uint64_t>::max(),
+                                      &arg_types[1], &arg_values[1]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "ints", TRACE_EVENT_FLAG_NONE, 2,
+                   arg_names, arg_types, arg_values, nullptr);
+
+  trace_event_internal::SetTraceValue(-0.25, &arg_types[0], &arg_values[0]);
+  trace_event_internal::SetTraceValue(true, &arg_types[1], &arg_values[1]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "double and bool",
+                   TRACE_EVENT_FLAG_NONE, 2, arg_names, arg_types, arg_values,
+                   nullptr);
+
+  static const int kPointee = 0;
+  trace_event_internal::SetTraceValue(static_cast<const void*>(&kPointee),
+                                      &arg_types[0], &arg_values[0]);
+  trace_event_internal::SetTraceValue("a \"string\"", &arg_types[1],
+                                      &arg_values[1]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "pointer and string",
+                   TRACE_EVENT_FLAG_NONE, 2, arg_names, arg_types, arg_values,
+                   nullptr);
+
+  trace_event_internal::SetTraceValue(static_cast<const char*>(nullptr),
+                                      &arg_types[0], &arg_values[0]);
+  trace_event_internal::SetTraceValue(
+      trace_event_internal::TraceStringWithCopy("copied"), &arg_types[1],
+      &arg_values[1]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "null and copied strings",
+                   TRACE_EVENT_FLAG_NONE, 2, arg_names, arg_types, arg_values,
+                   nullptr);
+
+  std::unique_ptr<TracedValue> value(new TracedValue);
+  value->SetInteger("int", 2016);
+  value->SetString("string", "value");
+  std::unique_ptr<ConvertableToTraceFormat> convertable_values[2];
+  convertable_values[0] = std::move(value);
+  arg_types[0] = TRACE_VALUE_TYPE_CONVERTABLE;
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "convertable",
+                   TRACE_EVENT_FLAG_NONE, 1, arg_names, arg_types, arg_values,
+                   convertable_values);
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, CopiedStrings) {
+  std::string name = "copied name";
+  std::string arg_name = "copied arg";
+  const char* arg_names[] = {arg_name.c_str()};
+  unsigned char arg_types[1];
+  unsigned long long arg_values[1];
+  trace_event_internal::SetTraceValue("value", &arg_types[0], &arg_values[0]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, name.c_str(),
+                   TRACE_EVENT_FLAG_COPY, 1, arg_names, arg_types, arg_values,
+                   nullptr);
+
+  // The event owns copies of the strings.
+  name = "overwritten";
+  arg_name = "overwritten";
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, name.c_str(),
+                   TRACE_EVENT_FLAG_COPY, 1, arg_names, arg_types, arg_values,
+                   nullptr);
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, ArgumentFilter) {
+  const char* arg_names[] = {"allowed", "not allowed"};
+  unsigned char arg_types[2];
+  unsigned long long arg_values[2];
+  trace_event_internal::SetTraceValue(1, &arg_types[0], &arg_values[0]);
+  trace_event_internal::SetTraceValue(2, &arg_types[1], &arg_values[1]);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "stripped", TRACE_EVENT_FLAG_NONE,
+                   2, arg_names, arg_types, arg_values, nullptr);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "filtered", TRACE_EVENT_FLAG_NONE,
+                   2, arg_names, arg_types, arg_values, nullptr);
+  AddEventWithArgs(TRACE_EVENT_PHASE_INSTANT, "unfiltered",
+                   TRACE_EVENT_FLAG_NONE, 2, arg_names, arg_types, arg_values,
+                   nullptr);
+  // Events without arguments are never stripped.
+  AddEvent(TRACE_EVENT_PHASE_INSTANT, "stripped", TRACE_EVENT_FLAG_NONE);
+
+  ExpectBinaryMatchesJSON(Bind(&FilterArguments));
+}
+
+TEST_F(TraceEventBinaryFormatTest, InternsStrings) {
+  for (int i = 0; i < 10; ++i)
+    AddEvent(TRACE_EVENT_PHASE_INSTANT, "interned", TRACE_EVENT_FLAG_NONE);
+
+  TraceEventBinaryWriter writer(0, ArgumentFilterPredicate());
+  std::string first_event;
+  writer.AppendEvent(*events_[0], &first_event);
+  std::string second_event;
+  writer.AppendEvent(*events_[1], &second_event);
+  EXPECT_LT(second_event.size() + strlen(kCategory) + strlen("interned"),
+            first_event.size());
+
+  ExpectBinaryMatchesJSON(ArgumentFilterPredicate());
+}
+
+TEST_F(TraceEventBinaryFormatTest, MalformedInput) {
+  std::string json;
+  EXPECT_FALSE(ConvertBinaryTraceToJSON(std::string(), &json));
+  EXPECT_FALSE(ConvertBinaryTraceToJSON("not a trace", &json));
+
+  AddEvent(TRACE_EVENT_PHASE_INSTANT, "event", TRACE_EVENT_FLAG_NONE);
+  TraceEventBinaryWriter writer(0, ArgumentFilterPredicate());
+  std::string binary;
+  writer.AppendHeader(&binary);
+  EXPECT_TRUE(ConvertBinaryTraceToJSON(binary, &json));
+  EXPECT_TRUE(json.empty());
+
+  const size_t header_size = binary.size();
+  writer.AppendEvent(*events_[0], &binary);
+  for (size_t size = header_size + 1; size < binary.size(); ++size)
+    EXPECT_FALSE(ConvertBinaryTraceToJSON(binary.substr(0, size), &json));
+  EXPECT_TRUE(json.empty());
+}
+
+TEST_F(TraceEventBinaryFormatTest, FlushAsBinary) {
+  TraceLog::GetInstance()->SetEnabled(TraceConfig(kCategory, ""),
+                                      TraceLog::RECORDING_MODE);
+  TRACE_EVENT_INSTANT1(kCategory, "flushed", TRACE_EVENT_SCOPE_THREAD, "arg",
+                       1);
+  { TRACE_EVENT0(kCategory, "flushed complete"); }
+  TraceLog::GetInstance()->SetDisabled();
+
+  std::string binary;
+  TraceLog::GetInstance()->FlushAsBinary(Bind(&AppendFlushedData, &binary));
+
+  std::string json = "[";
+  ASSERT_TRUE(ConvertBinaryTraceToJSON(binary, &json));
+  json += "]";
+  std::unique_ptr<Value> trace = JSONReader::Read(json);
+  ASSERT_TRUE(trace);
+  ListValue* events;
+  ASSERT_TRUE(trace->GetAsList(&events));
+
+  std::vector<std::string> names;
+  for (const auto& event : *events) {
+    DictionaryValue* dict;
+    std::string name;
+    ASSERT_TRUE(event->GetAsDictionary(&dict));
+    ASSERT_TRUE(dict->GetString("name", &name));
+    names.push_back(name);
+  }
+  EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "flushed"));
+  EXPECT_NE(names.end(),
+            std::find(names.begin(), names.end(), "flushed complete"));
+}
+
+}  // namespace trace_event
+}  // namespace base
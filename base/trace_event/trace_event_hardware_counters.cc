@@ -0,0 +1,174 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_event_hardware_counters.h"
+
+#include <string.h>
+
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/threading/thread_local_storage.h"
+#endif
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+const char* const kCounterNames[] = {
+    "instructions", "cycles", "llc_misses", "branch_misses",
+};
+static_assert(arraysize(kCounterNames) == HardwareCounters::COUNTER_COUNT,
+              "kCounterNames must have a name for each counter");
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+
+// The perf_event_open() configs of the counters, by HardwareCounters::Counter.
+const uint64_t kCounterConfigs[] = {
+    PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+};
+static_assert(arraysize(kCounterConfigs) == HardwareCounters::COUNTER_COUNT,
+              "kCounterConfigs must have a config for each counter");
+
+// The file descriptors of the counters of a thread. They form a group led by
+// the first one, so that they are all scheduled on the PMU at the same time
+// and can be read at once.
+struct ThreadCounters {
+  int fds[HardwareCounters::COUNTER_COUNT];
+};
+
+// Stored in the slot of a thread whose counters couldn't be opened.
+ThreadCounters g_unavailable_counters;
+
+// Set once opening counters failed, which is usually for a reason that holds
+// for all threads, so that other threads don't retry.
+subtle::Atomic32 g_counters_unavailable = 0;
+
+void CloseThreadCounters(void* value) {
+  ThreadCounters* counters = static_cast<ThreadCounters*>(value);
+  if (counters == &g_unavailable_counters)
+    return;
+  for (int fd : counters->fds)
+    IGNORE_EINTR(close(fd));
+  delete counters;
+}
+
+class ThreadCountersSlot : public ThreadLocalStorage::Slot {
+ public:
+  ThreadCountersSlot() : ThreadLocalStorage::Slot(&CloseThreadCounters) {}
+};
+
+LazyInstance<ThreadCountersSlot>::Leaky g_thread_counters_slot =
+    LAZY_INSTANCE_INITIALIZER;
+
+int OpenCounter(uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // Only count user space, which is allowed with the default
+  // perf_event_paranoid setting of most Linux distributions.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // pid 0 and cpu -1 count the calling thread on any CPU.
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1,
+                                  group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+// Returns null if the counters can't be opened.
+ThreadCounters* OpenThreadCounters() {
+  if (subtle::NoBarrier_Load(&g_counters_unavailable))
+    return nullptr;
+
+  ThreadCounters* counters = new ThreadCounters;
+  for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i) {
+    counters->fds[i] =
+        OpenCounter(kCounterConfigs[i], i == 0 ? -1 : counters->fds[0]);
+    if (counters->fds[i] >= 0)
+      continue;
+    DPLOG(WARNING) << "Hardware counters are unavailable";
+    subtle::NoBarrier_Store(&g_counters_unavailable, 1);
+    while (i--)
+      IGNORE_EINTR(close(counters->fds[i]));
+    delete counters;
+    return nullptr;
+  }
+  return counters;
+}
+
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+  memset(values, 0, sizeof(values));
+}
+
+// static
+const char* HardwareCounters::GetCounterName(Counter counter) {
+  DCHECK_LT(counter, COUNTER_COUNT);
+  return kCounterNames[counter];
+}
+
+// static
+bool HardwareCounters::ReadForCurrentThread(HardwareCounters* counters) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  ThreadCountersSlot& slot = g_thread_counters_slot.Get();
+  ThreadCounters* thread_counters = static_cast<ThreadCounters*>(slot.Get());
+  if (!thread_counters) {
+    thread_counters = OpenThreadCounters();
+    slot.Set(thread_counters ? thread_counters : &g_unavailable_counters);
+    if (!thread_counters)
+      return false;
+  } else if (thread_counters == &g_unavailable_counters) {
+    return false;
+  }
+
+  // With PERF_FORMAT_GROUP, the leader reads the number of counters followed
+  // by their values.
+  uint64_t buffer[1 + COUNTER_COUNT];
+  ssize_t size =
+      HANDLE_EINTR(read(thread_counters->fds[0], buffer, sizeof(buffer)));
+  if (size != static_cast<ssize_t>(sizeof(buffer)) ||
+      buffer[0] != COUNTER_COUNT) {
+    return false;
+  }
+  memcpy(counters->values, buffer + 1, sizeof(counters->values));
+  return true;
+#else
+  return false;
+#endif
+}
+
+void HardwareCounters::SubtractStart(const HardwareCounters& start) {
+  for (int i = 0; i < COUNTER_COUNT; ++i)
+    values[i] -= start.values[i];
+}
+
+void HardwareCounters::AppendAsJSON(std::string* out) const {
+  *out += "{";
+  for (int i = 0; i < COUNTER_COUNT; ++i) {
+    StringAppendF(out, "%s\"%s\":%" PRIu64, i ? "," : "", kCounterNames[i],
+                  values[i]);
+  }
+  *out += "}";
+}
+
+}  // namespace trace_event
+}  // namespace base
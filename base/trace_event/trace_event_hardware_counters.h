@@ -0,0 +1,52 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TRACE_EVENT_TRACE_EVENT_HARDWARE_COUNTERS_H_
+#define BASE_TRACE_EVENT_TRACE_EVENT_HARDWARE_COUNTERS_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace trace_event {
+
+// Values of the hardware performance counters of a thread, either as read at
+// one point or as the difference between two readings.
+struct BASE_EXPORT HardwareCounters {
+  enum Counter {
+    INSTRUCTIONS,
+    CYCLES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNTER_COUNT
+  };
+
+  HardwareCounters();
+
+  // Returns the name of |counter| in traces.
+  static const char* GetCounterName(Counter counter);
+
+  // Reads the counters of the current thread into |counters|. The counters are
+  // opened on the first call on each thread and closed when it exits. Returns
+  // false if they are not available, which is the case on platforms other than
+  // Linux and Android, and where perf events are not allowed, e.g. because of
+  // the kernel.perf_event_paranoid setting.
+  static bool ReadForCurrentThread(HardwareCounters* counters);
+
+  // Sets the counters to the differences from |start| to the current values.
+  void SubtractStart(const HardwareCounters& start);
+
+  // Appends the counters as a JSON dictionary to |out|.
+  void AppendAsJSON(std::string* out) const;
+
+  uint64_t values[COUNTER_COUNT];
+};
+
+}  // namespace trace_event
+}  // namespace base
+
+#endif  // BASE_TRACE_EVENT_TRACE_EVENT_HARDWARE_COUNTERS_H_
@@ -0,0 +1,133 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_event_hardware_counters.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/json/json_reader.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+const char kCategory[] = "hardware_counters_test";
+
+// Does some work that the counters can see through the optimizer.
+uint64_t Spin() {
+  volatile uint64_t sum = 0;
+  for (int i = 0; i < 100000; ++i)
+    sum = sum + i;
+  return sum;
+}
+
+void AppendFlushedData(std::string* out,
+                       const scoped_refptr<RefCountedString>& data,
+                       bool has_more_events) {
+  if (!out->empty() && !data->data().empty())
+    *out += ",";
+  out->append(data->data());
+}
+
+}  // namespace
+
+TEST(TraceEventHardwareCountersTest, AppendAsJSON) {
+  HardwareCounters counters;
+  counters.values[HardwareCounters::INSTRUCTIONS] = 1000;
+  counters.values[HardwareCounters::CYCLES] = 2000;
+  counters.values[HardwareCounters::LLC_MISSES] = 3;
+  counters.values[HardwareCounters::BRANCH_MISSES] = 4;
+
+  std::string json;
+  counters.AppendAsJSON(&json);
+  EXPECT_EQ(
+      "{\"instructions\":1000,\"cycles\":2000,\"llc_misses\":3,"
+      "\"branch_misses\":4}",
+      json);
+  EXPECT_STREQ("llc_misses",
+               HardwareCounters::GetCounterName(HardwareCounters::LLC_MISSES));
+}
+
+TEST(TraceEventHardwareCountersTest, SubtractStart) {
+  HardwareCounters start;
+  HardwareCounters end;
+  for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i) {
+    start.values[i] = 10 * i;
+    end.values[i] = 25 * i;
+  }
+  end.SubtractStart(start);
+  for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i)
+    EXPECT_EQ(15u * i, end.values[i]);
+}
+
+TEST(TraceEventHardwareCountersTest, ReadForCurrentThread) {
+  HardwareCounters start;
+  // The counters are unavailable on most bots, which is fine.
+  if (!HardwareCounters::ReadForCurrentThread(&start))
+    return;
+
+  Spin();
+  HardwareCounters end;
+  ASSERT_TRUE(HardwareCounters::ReadForCurrentThread(&end));
+  EXPECT_LT(start.values[HardwareCounters::INSTRUCTIONS],
+            end.values[HardwareCounters::INSTRUCTIONS]);
+  EXPECT_LT(start.values[HardwareCounters::CYCLES],
+            end.values[HardwareCounters::CYCLES]);
+}
+
+TEST(TraceEventHardwareCountersTest, CompleteEventsHaveCounters) {
+  HardwareCounters counters;
+  const bool available = HardwareCounters::ReadForCurrentThread(&counters);
+
+  TraceLog::GetInstance()->SetEnabled(
+      TraceConfig(kCategory, "record-until-full,enable-hardware-counters"),
+      TraceLog::RECORDING_MODE);
+  {
+    TRACE_EVENT0(kCategory, "complete");
+    Spin();
+  }
+  TRACE_EVENT_INSTANT0(kCategory, "instant", TRACE_EVENT_SCOPE_THREAD);
+  TraceLog::GetInstance()->SetDisabled();
+
+  std::string json;
+  TraceLog::GetInstance()->Flush(Bind(&AppendFlushedData, &json));
+  std::unique_ptr<Value> trace = JSONReader::Read("[" + json + "]");
+  ASSERT_TRUE(trace);
+  ListValue* events;
+  ASSERT_TRUE(trace->GetAsList(&events));
+
+  int num_events = 0;
+  for (const auto& event : *events) {
+    DictionaryValue* dict;
+    std::string name;
+    ASSERT_TRUE(event->GetAsDictionary(&dict));
+    if (!dict->GetString("name", &name) || (name != "complete" &&
+                                            name != "instant")) {
+      continue;
+    }
+    ++num_events;
+    DictionaryValue* hardware_counters = nullptr;
+    if (name == "instant" || !available) {
+      EXPECT_FALSE(dict->GetDictionary("hwc", &hardware_counters));
+      continue;
+    }
+    ASSERT_TRUE(dict->GetDictionary("hwc", &hardware_counters));
+    double instructions = 0;
+    EXPECT_TRUE(hardware_counters->GetDouble("instructions", &instructions));
+    EXPECT_LT(100000, instructions);
+  }
+  EXPECT_EQ(2, num_events);
+}
+
+}  // namespace trace_event
+}  // namespace base
@@ -71,6 +71,7 @@ void TraceEvent::MoveFrom(std::unique_ptr<TraceEvent> other) {
   phase_ = other->phase_;
   flags_ = other->flags_;
   parameter_copy_storage_ = std::move(other->parameter_copy_storage_);
+  hardware_counters_ = std::move(other->hardware_counters_);
 
   for (int i = 0; i < kTraceMaxNumArgs; ++i) {
     arg_names_[i] = other->arg_names_[i];
@@ -107,6 +108,7 @@ void TraceEvent::Initialize(
   phase_ = phase;
   flags_ = flags;
   bind_id_ = bind_id;
+  hardware_counters_.reset();
 
   // Clamp num_args since it may have been set by a third_party library.
   num_args = (num_args > kTraceMaxNumArgs) ? kTraceMaxNumArgs : num_args;
@@ -179,6 +181,7 @@ void TraceEvent::Reset() {
   // hold references to other objects.
   duration_ = TimeDelta::FromInternalValue(-1);
   parameter_copy_storage_.reset();
+  hardware_counters_.reset();
   for (int i = 0; i < kTraceMaxNumArgs; ++i)
     convertable_values_[i].reset();
 }
@@ -194,6 +197,23 @@ void TraceEvent::UpdateDuration(const TimeTicks& now,
     thread_duration_ = thread_now - thread_timestamp_;
 }
 
+void TraceEvent::SetHardwareCounters(const HardwareCounters& start) {
+  DCHECK_EQ(TRACE_EVENT_PHASE_COMPLETE, phase_);
+  hardware_counters_.reset(new HardwareCounters(start));
+}
+
+void TraceEvent::UpdateHardwareCounters(const HardwareCounters* now) {
+  if (!hardware_counters_)
+    return;
+  if (!now) {
+    hardware_counters_.reset();
+    return;
+  }
+  HardwareCounters start = *hardware_counters_;
+  *hardware_counters_ = *now;
+  hardware_counters_->SubtractStart(start);
+}
+
 void TraceEvent::EstimateTraceMemoryOverhead(
     TraceEventMemoryOverhead* overhead) {
   overhead->Add("TraceEvent", sizeof(*this));
@@ -201,6 +221,9 @@ void TraceEvent::EstimateTraceMemoryOverhead(
   if (parameter_copy_storage_)
     overhead->AddString(*parameter_copy_storage_);
 
+  if (hardware_counters_)
+    overhead->Add("HardwareCounters", sizeof(*hardware_counters_));
+
   for (size_t i = 0; i < kTraceMaxNumArgs; ++i) {
     if (arg_types_[i] == TRACE_VALUE_TYPE_CONVERTABLE)
       convertable_values_[i]->EstimateTraceMemoryOverhead(overhead);
@@ -343,6 +366,10 @@ void TraceEvent::AppendAsJSON(
       if (thread_duration != -1)
         StringAppendF(out, ",\"tdur\":%" PRId64, thread_duration);
     }
+    if (hardware_counters_ && duration != -1) {
+      *out += ",\"hwc\":";
+      hardware_counters_->AppendAsJSON(out);
+    }
   }
 
   // Output tts if thread_timestamp is valid.
@@ -25,6 +25,7 @@
 #include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_local.h"
+#include "base/trace_event/trace_event_hardware_counters.h"
 #include "base/trace_event/trace_event_memory_overhead.h"
 #include "build/build_config.h"
 
@@ -114,6 +115,12 @@ class BASE_EXPORT TraceEvent {
 
   void UpdateDuration(const TimeTicks& now, const ThreadTicks& thread_now);
 
+  // Attaches the hardware counters of the thread at the start of a complete
+  // event. UpdateHardwareCounters() then turns them into the counts during
+  // the event, or drops them if |now| is null.
+  void SetHardwareCounters(const HardwareCounters& start);
+  void UpdateHardwareCounters(const HardwareCounters* now);
+
   void EstimateTraceMemoryOverhead(TraceEventMemoryOverhead* overhead);
 
   // Serialize event data to JSON
@@ -132,6 +139,9 @@ class BASE_EXPORT TraceEvent {
   int thread_id() const { return thread_id_; }
   TimeDelta duration() const { return duration_; }
   TimeDelta thread_duration() const { return thread_duration_; }
+  const HardwareCounters* hardware_counters() const {
+    return hardware_counters_.get();
+  }
   const char* scope() const { return scope_; }
   unsigned long long id() const { return id_; }
   unsigned int flags() const { return flags_; }
@@ -153,6 +163,8 @@ class BASE_EXPORT TraceEvent {
 #endif
 
  private:
+  friend class TraceEventBinaryWriter;
+
   // Note: these are ordered by size (largest first) for optimal packing.
   TimeTicks timestamp_;
   ThreadTicks thread_timestamp_;
@@ -168,6 +180,8 @@ class BASE_EXPORT TraceEvent {
   const unsigned char* category_group_enabled_;
   const char* name_;
   std::unique_ptr<std::string> parameter_copy_storage_;
+  // Only allocated for complete events when hardware counters are enabled.
+  std::unique_ptr<HardwareCounters> hardware_counters_;
   // Depending on TRACE_EVENT_FLAG_HAS_PROCESS_ID the event will have either:
   //  tid: thread_id_, pid: current_process_id (default case).
   //  tid: -1, pid: process_id_ (when flags_ & TRACE_EVENT_FLAG_HAS_PROCESS_ID).
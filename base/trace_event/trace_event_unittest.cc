@@ -18,6 +18,7 @@
 #include "base/json/json_writer.h"
 #include "base/location.h"
 #include "base/macros.h"
+#include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/singleton.h"
 #include "base/process/process_handle.h"
@@ -27,6 +28,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_buffer.h"
@@ -1682,6 +1684,71 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
   }
 }
 
+// Emits instant events on a thread without a message loop, and optionally
+// blocks the thread until |stop_event| is signaled.
+class InstantEventsDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  InstantEventsDelegate(int thread_id,
+                        int num_events,
+                        WaitableEvent* stop_event)
+      : thread_id_(thread_id),
+        num_events_(num_events),
+        stop_event_(stop_event),
+        events_added_(WaitableEvent::ResetPolicy::MANUAL,
+                      WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void WaitForEventsAdded() { events_added_.Wait(); }
+
+ private:
+  // DelegateSimpleThread::Delegate:
+  void Run() override {
+    TraceManyInstantEvents(thread_id_, num_events_, &events_added_);
+    if (stop_event_)
+      stop_event_->Wait();
+  }
+
+  const int thread_id_;
+  const int num_events_;
+  WaitableEvent* const stop_event_;
+  WaitableEvent events_added_;
+
+  DISALLOW_COPY_AND_ASSIGN(InstantEventsDelegate);
+};
+
+// Test that data sent from multiple threads without a message loop is gathered,
+// whether or not the threads are still running during the flush.
+TEST_F(TraceEventTestFixture, DataCapturedManyThreadsWithoutMessageLoop) {
+  BeginTrace();
+
+  const int num_threads = 4;
+  const int num_events = 4000;
+  WaitableEvent stop_event(WaitableEvent::ResetPolicy::MANUAL,
+                           WaitableEvent::InitialState::NOT_SIGNALED);
+  std::vector<std::unique_ptr<InstantEventsDelegate>> delegates;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < num_threads; i++) {
+    // Half of the threads keep running until after the flush.
+    delegates.push_back(WrapUnique(new InstantEventsDelegate(
+        i, num_events, i < num_threads / 2 ? nullptr : &stop_event)));
+    threads.push_back(WrapUnique(new DelegateSimpleThread(
+        delegates.back().get(), StringPrintf("Thread %d", i))));
+    threads.back()->Start();
+  }
+
+  for (int i = 0; i < num_threads; i++)
+    delegates[i]->WaitForEventsAdded();
+  for (int i = 0; i < num_threads / 2; i++)
+    threads[i]->Join();
+
+  EndTraceAndFlush();
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_,
+                                           num_threads, num_events);
+
+  stop_event.Signal();
+  for (int i = num_threads / 2; i < num_threads; i++)
+    threads[i]->Join();
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   // Create threads before we enable tracing to make sure
@@ -2869,6 +2936,79 @@ TEST_F(TraceEventTestFixture, TraceBufferRingBufferFullIteration) {
   TraceLog::GetInstance()->SetDisabled();
 }
 
+TEST_F(TraceEventTestFixture, TraceBufferStreamingRingBufferEvictsChunks) {
+  const size_t num_chunks = 4;
+  std::unique_ptr<TraceBuffer> buffer(
+      TraceBuffer::CreateTraceBufferStreamingRingBuffer(num_chunks));
+  size_t chunk_index;
+  size_t event_index;
+
+  // Fill the buffer. The last chunk is left empty.
+  std::unique_ptr<TraceBufferChunk* []> chunks(
+      new TraceBufferChunk*[num_chunks]);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    chunks[i] = buffer->GetChunk(&chunk_index).release();
+    if (i < num_chunks - 1)
+      EXPECT_TRUE(chunks[i]->AddTraceEvent(&event_index));
+  }
+  for (size_t i = 0; i < num_chunks; ++i)
+    buffer->ReturnChunk(i, std::unique_ptr<TraceBufferChunk>(chunks[i]));
+  EXPECT_FALSE(buffer->HasEvictedChunks());
+
+  // Getting chunks evicts the oldest non-empty ones instead of recycling them.
+  std::unique_ptr<TraceBufferChunk> chunk = buffer->GetChunk(&chunk_index);
+  EXPECT_NE(chunks[0], chunk.get());
+  EXPECT_EQ(0u, chunk->size());
+  buffer->ReturnChunk(chunk_index, std::move(chunk));
+  EXPECT_TRUE(buffer->HasEvictedChunks());
+
+  std::vector<std::unique_ptr<TraceBufferChunk>> evicted_chunks;
+  buffer->TakeEvictedChunks(&evicted_chunks);
+  ASSERT_EQ(1u, evicted_chunks.size());
+  EXPECT_EQ(chunks[0], evicted_chunks[0].get());
+  EXPECT_FALSE(buffer->HasEvictedChunks());
+
+  chunk = buffer->GetChunk(&chunk_index);
+  buffer->ReturnChunk(chunk_index, std::move(chunk));
+  EXPECT_TRUE(buffer->HasEvictedChunks());
+
+  // The evicted chunks which weren't taken are iterated first.
+  EXPECT_EQ(chunks[1], buffer->NextChunk());
+  EXPECT_EQ(chunks[2], buffer->NextChunk());
+  EXPECT_EQ(chunks[3], buffer->NextChunk());
+  EXPECT_TRUE(buffer->NextChunk());
+  EXPECT_TRUE(buffer->NextChunk());
+  EXPECT_FALSE(buffer->NextChunk());
+}
+
+// Test that the events which the trace buffer evicts while tracing and the
+// events which remain in it are output once.
+TEST_F(TraceEventTestFixture, StreamingCallback) {
+  Thread stream_thread("stream");
+  stream_thread.Start();
+  TraceLog::GetInstance()->SetStreamingCallback(
+      Bind(&TraceEventTestFixture::OnTraceDataCollected, Unretained(this),
+           nullptr),
+      stream_thread.task_runner());
+  BeginTrace();
+
+  // Record more events than the trace buffer can hold.
+  TraceBuffer* buffer = TraceLog::GetInstance()->trace_buffer();
+  const int num_events = static_cast<int>(buffer->Capacity() * 3 / 2);
+  TraceManyInstantEvents(0, num_events, nullptr);
+  EXPECT_GE(buffer->Capacity(), buffer->Size());
+
+  TraceLog::GetInstance()->SetDisabled();
+  // Let the stream tasks run.
+  stream_thread.Stop();
+  EXPECT_GT(num_flush_callbacks_, 0u);
+
+  EndTraceAndFlush();
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_, 1, num_events);
+  TraceLog::GetInstance()->SetStreamingCallback(TraceLog::OutputCallback(),
+                                                nullptr);
+}
+
 TEST_F(TraceEventTestFixture, TraceRecordAsMuchAsPossibleMode) {
   TraceLog::GetInstance()->SetEnabled(
     TraceConfig(kRecordAllCategoryFilter, RECORD_AS_MUCH_AS_POSSIBLE),
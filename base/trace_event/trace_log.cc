@@ -19,6 +19,7 @@
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/singleton.h"
 #include "base/process/process_metrics.h"
+#include "base/sequenced_task_runner.h"
 #include "base/stl_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_tokenizer.h"
@@ -37,6 +38,8 @@
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_buffer.h"
 #include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_binary_format.h"
+#include "base/trace_event/trace_event_hardware_counters.h"
 #include "base/trace_event/trace_event_synthetic_delay.h"
 #include "base/trace_event/trace_sampling_thread.h"
 #include "build/build_config.h"
@@ -86,6 +89,15 @@ const size_t kEchoToConsoleTraceEventBufferChunks = 256;
 const size_t kTraceEventBufferSizeInBytes = 100 * 1024;
 const int kThreadFlushTimeoutMs = 3000;
 
+// A thread local buffer gets this many chunks at a time from the trace buffer,
+// and returns its full chunks when it gets the next ones, so that |lock_| is
+// acquired once every few chunks. Smaller trace buffers, like the one of
+// ECHO_TO_CONSOLE, are given chunks one by one so that threads don't exhaust
+// them.
+const size_t kThreadLocalChunkBatchSize = 4;
+const size_t kMinChunksForThreadLocalChunkBatches =
+    kTraceEventRingBufferChunks / 2;
+
 #define MAX_CATEGORY_GROUPS 200
 
 // Parallel arrays g_category_groups and g_category_group_enabled are separate
@@ -214,18 +226,26 @@ class TraceLog::ThreadLocalEventBuffer
 
   TraceEvent* AddTraceEvent(TraceEventHandle* handle);
 
-  TraceEvent* GetEventByHandle(TraceEventHandle handle) {
-    if (!chunk_ || handle.chunk_seq != chunk_->seq() ||
-        handle.chunk_index != chunk_index_) {
-      return nullptr;
-    }
+  TraceEvent* GetEventByHandle(TraceEventHandle handle);
 
-    return chunk_->GetEventAt(handle.event_index);
-  }
+  // The lock which the thread of a buffer without a message loop holds while it
+  // adds or updates an event. A buffer with a message loop is only accessed
+  // from its thread and doesn't need it.
+  Lock* lock() { return &lock_; }
+
+  // Called on the flushing thread to return the chunks of a buffer without a
+  // message loop to the trace buffer.
+  void FlushFromFlushingThread();
 
+  bool has_message_loop() const { return !!message_loop_; }
   int generation() const { return generation_; }
 
+  // ThreadLocalStorage destructor of |loopless_event_buffer_tls_|.
+  static void DeleteOnThreadExit(void* buffer);
+
  private:
+  using IndexedChunk = std::pair<size_t, std::unique_ptr<TraceBufferChunk>>;
+
   // MessageLoop::DestructionObserver
   void WillDestroyCurrentMessageLoop() override;
 
@@ -242,8 +262,22 @@ class TraceLog::ThreadLocalEventBuffer
   // Since TraceLog is a leaky singleton, trace_log_ will always be valid
   // as long as the thread exists.
   TraceLog* trace_log_;
+
+  // Null if the thread has no message loop or blocks it.
+  MessageLoop* const message_loop_;
+
+  // See lock().
+  Lock lock_;
+
   std::unique_ptr<TraceBufferChunk> chunk_;
   size_t chunk_index_;
+
+  // Chunks which were filled after |chunk_| was taken from the trace buffer,
+  // and chunks which will be used after |chunk_|. Both are exchanged with the
+  // trace buffer when |spare_chunks_| runs out.
+  std::vector<IndexedChunk> full_chunks_;
+  std::vector<IndexedChunk> spare_chunks_;
+
   int generation_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadLocalEventBuffer);
@@ -251,30 +285,48 @@ class TraceLog::ThreadLocalEventBuffer
 
 TraceLog::ThreadLocalEventBuffer::ThreadLocalEventBuffer(TraceLog* trace_log)
     : trace_log_(trace_log),
+      message_loop_(trace_log->thread_blocks_message_loop_.Get()
+                        ? nullptr
+                        : MessageLoop::current()),
       chunk_index_(0),
       generation_(trace_log->generation()) {
-  // ThreadLocalEventBuffer is created only if the thread has a message loop, so
-  // the following message_loop won't be NULL.
-  MessageLoop* message_loop = MessageLoop::current();
-  message_loop->AddDestructionObserver(this);
+  if (!message_loop_) {
+    // The flushing thread can't post a task to this thread, so it takes the
+    // chunks of this buffer itself.
+    trace_log->loopless_event_buffer_tls_.Set(this);
+    AutoLock lock(trace_log->loopless_event_buffers_lock_);
+    trace_log->loopless_event_buffers_.insert(this);
+    return;
+  }
+
+  message_loop_->AddDestructionObserver(this);
 
   // This is to report the local memory usage when memory-infra is enabled.
   MemoryDumpManager::GetInstance()->RegisterDumpProvider(
       this, "ThreadLocalEventBuffer", ThreadTaskRunnerHandle::Get());
 
   AutoLock lock(trace_log->lock_);
-  trace_log->thread_message_loops_.insert(message_loop);
+  trace_log->thread_message_loops_.insert(message_loop_);
 }
 
 TraceLog::ThreadLocalEventBuffer::~ThreadLocalEventBuffer() {
   CheckThisIsCurrentBuffer();
-  MessageLoop::current()->RemoveDestructionObserver(this);
-  MemoryDumpManager::GetInstance()->UnregisterDumpProvider(this);
+  if (message_loop_) {
+    message_loop_->RemoveDestructionObserver(this);
+    MemoryDumpManager::GetInstance()->UnregisterDumpProvider(this);
+  } else {
+    trace_log_->loopless_event_buffer_tls_.Set(nullptr);
+    // Once this buffer is removed, the flushing thread doesn't access it, so
+    // there is no need for |lock_| below.
+    AutoLock lock(trace_log_->loopless_event_buffers_lock_);
+    trace_log_->loopless_event_buffers_.erase(this);
+  }
 
   {
     AutoLock lock(trace_log_->lock_);
     FlushWhileLocked();
-    trace_log_->thread_message_loops_.erase(MessageLoop::current());
+    if (message_loop_)
+      trace_log_->thread_message_loops_.erase(message_loop_);
   }
   trace_log_->thread_local_event_buffer_.Set(NULL);
 }
@@ -283,15 +335,46 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
     TraceEventHandle* handle) {
   CheckThisIsCurrentBuffer();
 
-  if (chunk_ && chunk_->IsFull()) {
-    AutoLock lock(trace_log_->lock_);
-    FlushWhileLocked();
-    chunk_.reset();
+  if (chunk_ && chunk_->IsFull())
+    full_chunks_.push_back(IndexedChunk(chunk_index_, std::move(chunk_)));
+  if (!chunk_ && !spare_chunks_.empty()) {
+    chunk_index_ = spare_chunks_.back().first;
+    chunk_ = std::move(spare_chunks_.back().second);
+    spare_chunks_.pop_back();
   }
   if (!chunk_) {
-    AutoLock lock(trace_log_->lock_);
-    chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
-    trace_log_->CheckIfBufferIsFullWhileLocked();
+    scoped_refptr<SequencedTaskRunner> stream_task_runner;
+    {
+      AutoLock lock(trace_log_->lock_);
+      FlushWhileLocked();
+      TraceBuffer* logged_events = trace_log_->logged_events_.get();
+      size_t batch_size = logged_events->Capacity() >=
+                                  kMinChunksForThreadLocalChunkBatches *
+                                      kTraceBufferChunkSize
+                              ? kThreadLocalChunkBatchSize
+                              : 1;
+      chunk_ = logged_events->GetChunk(&chunk_index_);
+      // Only take the chunks which the trace buffer can hold.
+      while (chunk_ && spare_chunks_.size() + 1 < batch_size &&
+             !logged_events->IsFull()) {
+        size_t index;
+        std::unique_ptr<TraceBufferChunk> chunk =
+            logged_events->GetChunk(&index);
+        if (!chunk)
+          break;
+        spare_chunks_.push_back(IndexedChunk(index, std::move(chunk)));
+      }
+      // Events are added to the chunks in the order they were taken.
+      std::reverse(spare_chunks_.begin(), spare_chunks_.end());
+      trace_log_->CheckIfBufferIsFullWhileLocked();
+      stream_task_runner = trace_log_->GetStreamTaskRunnerWhileLocked();
+    }
+    // Post outside of |lock_|, since posting may need other locks.
+    if (stream_task_runner) {
+      stream_task_runner->PostTask(FROM_HERE,
+                                   Bind(&TraceLog::StreamEvictedChunks,
+                                        Unretained(trace_log_)));
+    }
   }
   if (!chunk_)
     return NULL;
@@ -304,30 +387,75 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
   return trace_event;
 }
 
+TraceEvent* TraceLog::ThreadLocalEventBuffer::GetEventByHandle(
+    TraceEventHandle handle) {
+  if (chunk_ && handle.chunk_seq == chunk_->seq() &&
+      handle.chunk_index == chunk_index_) {
+    return chunk_->GetEventAt(handle.event_index);
+  }
+  for (const IndexedChunk& full_chunk : full_chunks_) {
+    if (handle.chunk_seq == full_chunk.second->seq() &&
+        handle.chunk_index == full_chunk.first) {
+      return full_chunk.second->GetEventAt(handle.event_index);
+    }
+  }
+  return nullptr;
+}
+
+void TraceLog::ThreadLocalEventBuffer::FlushFromFlushingThread() {
+  DCHECK(!message_loop_);
+  AutoLock lock(lock_);
+  AutoLock trace_log_lock(trace_log_->lock_);
+  FlushWhileLocked();
+}
+
+// static
+void TraceLog::ThreadLocalEventBuffer::DeleteOnThreadExit(void* buffer) {
+  ThreadLocalEventBuffer* thread_local_event_buffer =
+      static_cast<ThreadLocalEventBuffer*>(buffer);
+  // The OS may have reset |thread_local_event_buffer_| already.
+  thread_local_event_buffer->trace_log_->thread_local_event_buffer_.Set(
+      thread_local_event_buffer);
+  delete thread_local_event_buffer;
+}
+
 void TraceLog::ThreadLocalEventBuffer::WillDestroyCurrentMessageLoop() {
   delete this;
 }
 
 bool TraceLog::ThreadLocalEventBuffer::OnMemoryDump(const MemoryDumpArgs& args,
                                                     ProcessMemoryDump* pmd) {
-  if (!chunk_)
+  if (!chunk_ && full_chunks_.empty())
     return true;
   std::string dump_base_name = StringPrintf(
       "tracing/thread_%d", static_cast<int>(PlatformThread::CurrentId()));
   TraceEventMemoryOverhead overhead;
-  chunk_->EstimateTraceMemoryOverhead(&overhead);
+  if (chunk_)
+    chunk_->EstimateTraceMemoryOverhead(&overhead);
+  for (const IndexedChunk& full_chunk : full_chunks_)
+    full_chunk.second->EstimateTraceMemoryOverhead(&overhead);
   overhead.DumpInto(dump_base_name.c_str(), pmd);
   return true;
 }
 
 void TraceLog::ThreadLocalEventBuffer::FlushWhileLocked() {
-  if (!chunk_)
+  if (!chunk_ && full_chunks_.empty() && spare_chunks_.empty())
     return;
 
   trace_log_->lock_.AssertAcquired();
   if (trace_log_->CheckGeneration(generation_)) {
-    // Return the chunk to the buffer only if the generation matches.
-    trace_log_->logged_events_->ReturnChunk(chunk_index_, std::move(chunk_));
+    // Return the chunks to the buffer only if the generation matches.
+    TraceBuffer* logged_events = trace_log_->logged_events_.get();
+    for (IndexedChunk& full_chunk : full_chunks_)
+      logged_events->ReturnChunk(full_chunk.first, std::move(full_chunk.second));
+    full_chunks_.clear();
+    if (chunk_)
+      logged_events->ReturnChunk(chunk_index_, std::move(chunk_));
+    for (IndexedChunk& spare_chunk : spare_chunks_) {
+      logged_events->ReturnChunk(spare_chunk.first,
+                                 std::move(spare_chunk.second));
+    }
+    spare_chunks_.clear();
   }
   // Otherwise this method may be called from the destructor, or TraceLog will
   // find the generation mismatch and delete this buffer soon.
@@ -364,7 +492,10 @@ TraceLog::TraceLog()
       sampling_thread_handle_(0),
       trace_config_(TraceConfig()),
       event_callback_trace_config_(TraceConfig()),
+      loopless_event_buffer_tls_(&ThreadLocalEventBuffer::DeleteOnThreadExit),
       thread_shared_chunk_index_(0),
+      flush_as_binary_(false),
+      stream_task_posted_(false),
       generation_(0),
       use_worker_thread_(false) {
   // Trace is enabled or disabled on one thread while other threads are
@@ -394,17 +525,20 @@ TraceLog::TraceLog()
 TraceLog::~TraceLog() {}
 
 void TraceLog::InitializeThreadLocalEventBufferIfSupported() {
-  // A ThreadLocalEventBuffer needs the message loop
+  // A ThreadLocalEventBuffer uses the message loop, if any,
   // - to know when the thread exits;
   // - to handle the final flush.
-  // For a thread without a message loop or the message loop may be blocked, the
-  // trace events will be added into the main buffer directly.
-  if (thread_blocks_message_loop_.Get() || !MessageLoop::current())
-    return;
+  // For a thread without a message loop or whose message loop may be blocked,
+  // the buffer is deleted by ThreadLocalStorage when the thread exits, and the
+  // flushing thread takes its chunks.
   HEAP_PROFILER_SCOPED_IGNORE;
   auto thread_local_event_buffer = thread_local_event_buffer_.Get();
   if (thread_local_event_buffer &&
-      !CheckGeneration(thread_local_event_buffer->generation())) {
+      (!CheckGeneration(thread_local_event_buffer->generation()) ||
+       (!thread_local_event_buffer->has_message_loop() &&
+        !thread_blocks_message_loop_.Get() && MessageLoop::current()))) {
+    // Let a thread which created a message loop after its first event flush
+    // its buffer from the message loop.
     delete thread_local_event_buffer;
     thread_local_event_buffer = NULL;
   }
@@ -681,6 +815,8 @@ TraceLog::InternalTraceOptions TraceLog::GetInternalOptionsFromTraceConfig(
       config.IsSamplingEnabled() ? kInternalEnableSampling : kInternalNone;
   if (config.IsArgumentFilterEnabled())
     ret |= kInternalEnableArgumentFilter;
+  if (config.IsHardwareCountersEnabled())
+    ret |= kInternalEnableHardwareCounters;
   switch (config.GetTraceRecordMode()) {
     case RECORD_UNTIL_FULL:
       return ret | kInternalRecordUntilFull;
@@ -836,6 +972,52 @@ void TraceLog::CheckIfBufferIsFullWhileLocked() {
   }
 }
 
+scoped_refptr<SequencedTaskRunner> TraceLog::GetStreamTaskRunnerWhileLocked() {
+  lock_.AssertAcquired();
+  if (stream_task_posted_ || !stream_task_runner_ ||
+      !logged_events_->HasEvictedChunks()) {
+    return nullptr;
+  }
+  stream_task_posted_ = true;
+  return stream_task_runner_;
+}
+
+void TraceLog::StreamEvictedChunks() {
+  std::vector<std::unique_ptr<TraceBufferChunk>> chunks;
+  OutputCallback stream_output_callback;
+  ArgumentFilterPredicate argument_filter_predicate;
+  {
+    AutoLock lock(lock_);
+    stream_task_posted_ = false;
+    // The chunks which are still in the buffer when it's flushed are output by
+    // the flush.
+    if (logged_events_)
+      logged_events_->TakeEvictedChunks(&chunks);
+    stream_output_callback = stream_output_callback_;
+    if (trace_options() & kInternalEnableArgumentFilter)
+      argument_filter_predicate = argument_filter_predicate_;
+  }
+  if (chunks.empty() || stream_output_callback.is_null())
+    return;
+
+  HEAP_PROFILER_SCOPED_IGNORE;
+  scoped_refptr<RefCountedString> json_events_str_ptr = new RefCountedString();
+  for (const auto& chunk : chunks) {
+    for (size_t j = 0; j < chunk->size(); ++j) {
+      size_t size = json_events_str_ptr->size();
+      if (size > kTraceEventBufferSizeInBytes) {
+        stream_output_callback.Run(json_events_str_ptr, true);
+        json_events_str_ptr = new RefCountedString();
+      } else if (size) {
+        json_events_str_ptr->data().append(",\n");
+      }
+      chunk->GetEventAt(j)->AppendAsJSON(&(json_events_str_ptr->data()),
+                                         argument_filter_predicate);
+    }
+  }
+  stream_output_callback.Run(json_events_str_ptr, true);
+}
+
 void TraceLog::SetEventCallbackEnabled(const TraceConfig& trace_config,
                                        EventCallback cb) {
   AutoLock lock(lock_);
@@ -863,16 +1045,33 @@ void TraceLog::SetEventCallbackDisabled() {
 // 4. If any thread hasn't finish its flush in time, finish the flush.
 void TraceLog::Flush(const TraceLog::OutputCallback& cb,
                      bool use_worker_thread) {
-  FlushInternal(cb, use_worker_thread, false);
+  FlushInternal(cb, use_worker_thread, false, false);
+}
+
+void TraceLog::FlushAsBinary(const TraceLog::OutputCallback& cb,
+                             bool use_worker_thread) {
+  FlushInternal(cb, use_worker_thread, true, false);
 }
 
 void TraceLog::CancelTracing(const OutputCallback& cb) {
   SetDisabled();
-  FlushInternal(cb, false, true);
+  FlushInternal(cb, false, false, true);
+}
+
+void TraceLog::SetStreamingCallback(
+    const OutputCallback& cb,
+    scoped_refptr<SequencedTaskRunner> task_runner) {
+  DCHECK(cb.is_null() || task_runner);
+  AutoLock lock(lock_);
+  DCHECK(!IsEnabled());
+  stream_output_callback_ = cb;
+  stream_task_runner_ = cb.is_null() ? nullptr : std::move(task_runner);
+  UseNextTraceBuffer();
 }
 
 void TraceLog::FlushInternal(const TraceLog::OutputCallback& cb,
                              bool use_worker_thread,
+                             bool as_binary,
                              bool discard_events) {
   use_worker_thread_ = use_worker_thread;
   if (IsEnabled()) {
@@ -888,6 +1087,15 @@ void TraceLog::FlushInternal(const TraceLog::OutputCallback& cb,
   }
 
   int generation = this->generation();
+
+  // Threads without a message loop can't flush their buffers, so take their
+  // chunks from here.
+  {
+    AutoLock lock(loopless_event_buffers_lock_);
+    for (ThreadLocalEventBuffer* buffer : loopless_event_buffers_)
+      buffer->FlushFromFlushingThread();
+  }
+
   // Copy of thread_message_loops_ to be used without locking.
   std::vector<scoped_refptr<SingleThreadTaskRunner>>
       thread_message_loop_task_runners;
@@ -899,6 +1107,7 @@ void TraceLog::FlushInternal(const TraceLog::OutputCallback& cb,
                              : nullptr;
     DCHECK(!thread_message_loops_.size() || flush_task_runner_);
     flush_output_callback_ = cb;
+    flush_as_binary_ = as_binary;
 
     if (thread_shared_chunk_) {
       logged_events_->ReturnChunk(thread_shared_chunk_index_,
@@ -934,7 +1143,8 @@ void TraceLog::FlushInternal(const TraceLog::OutputCallback& cb,
 void TraceLog::ConvertTraceEventsToTraceFormat(
     std::unique_ptr<TraceBuffer> logged_events,
     const OutputCallback& flush_output_callback,
-    const ArgumentFilterPredicate& argument_filter_predicate) {
+    const ArgumentFilterPredicate& argument_filter_predicate,
+    bool as_binary) {
   if (flush_output_callback.is_null())
     return;
 
@@ -942,17 +1152,28 @@ void TraceLog::ConvertTraceEventsToTraceFormat(
   // The callback need to be called at least once even if there is no events
   // to let the caller know the completion of flush.
   scoped_refptr<RefCountedString> json_events_str_ptr = new RefCountedString();
+  std::unique_ptr<TraceEventBinaryWriter> binary_writer;
+  if (as_binary) {
+    binary_writer.reset(new TraceEventBinaryWriter(
+        TraceLog::GetInstance()->process_id(), argument_filter_predicate));
+    binary_writer->AppendHeader(&json_events_str_ptr->data());
+  }
   while (const TraceBufferChunk* chunk = logged_events->NextChunk()) {
     for (size_t j = 0; j < chunk->size(); ++j) {
       size_t size = json_events_str_ptr->size();
       if (size > kTraceEventBufferSizeInBytes) {
         flush_output_callback.Run(json_events_str_ptr, true);
         json_events_str_ptr = new RefCountedString();
-      } else if (size) {
+      } else if (size && !binary_writer) {
         json_events_str_ptr->data().append(",\n");
       }
-      chunk->GetEventAt(j)->AppendAsJSON(&(json_events_str_ptr->data()),
-                                         argument_filter_predicate);
+      if (binary_writer) {
+        binary_writer->AppendEvent(*chunk->GetEventAt(j),
+                                   &json_events_str_ptr->data());
+      } else {
+        chunk->GetEventAt(j)->AppendAsJSON(&(json_events_str_ptr->data()),
+                                           argument_filter_predicate);
+      }
     }
   }
   flush_output_callback.Run(json_events_str_ptr, false);
@@ -962,6 +1183,7 @@ void TraceLog::FinishFlush(int generation, bool discard_events) {
   std::unique_ptr<TraceBuffer> previous_logged_events;
   OutputCallback flush_output_callback;
   ArgumentFilterPredicate argument_filter_predicate;
+  bool as_binary;
 
   if (!CheckGeneration(generation))
     return;
@@ -976,6 +1198,7 @@ void TraceLog::FinishFlush(int generation, bool discard_events) {
     flush_task_runner_ = NULL;
     flush_output_callback = flush_output_callback_;
     flush_output_callback_.Reset();
+    as_binary = flush_as_binary_;
 
     if (trace_options() & kInternalEnableArgumentFilter) {
       CHECK(!argument_filter_predicate_.is_null());
@@ -995,14 +1218,15 @@ void TraceLog::FinishFlush(int generation, bool discard_events) {
       WorkerPool::PostTask(
           FROM_HERE, Bind(&TraceLog::ConvertTraceEventsToTraceFormat,
                           Passed(&previous_logged_events),
-                          flush_output_callback, argument_filter_predicate),
+                          flush_output_callback, argument_filter_predicate,
+                          as_binary),
           true)) {
     return;
   }
 
   ConvertTraceEventsToTraceFormat(std::move(previous_logged_events),
                                   flush_output_callback,
-                                  argument_filter_predicate);
+                                  argument_filter_predicate, as_binary);
 }
 
 // Run in each thread holding a local event buffer.
@@ -1224,8 +1448,6 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamp(
   TimeTicks offset_event_timestamp = OffsetTimestamp(timestamp);
   ThreadTicks thread_now = ThreadNow();
 
-  // |thread_local_event_buffer_| can be null if the current thread doesn't have
-  // a message loop or the message loop is blocked.
   InitializeThreadLocalEventBufferIfSupported();
   auto thread_local_event_buffer = thread_local_event_buffer_.Get();
 
@@ -1275,17 +1497,26 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamp(
                                   convertable_values);
 #endif  // OS_WIN
 
+  // Read as late as possible, so that the counters of a complete event cover
+  // as little of the tracing overhead as possible.
+  HardwareCounters hardware_counters;
+  bool has_hardware_counters =
+      phase == TRACE_EVENT_PHASE_COMPLETE &&
+      (*category_group_enabled & ENABLED_FOR_RECORDING) &&
+      (trace_options() & kInternalEnableHardwareCounters) &&
+      thread_id == static_cast<int>(PlatformThread::CurrentId()) &&
+      HardwareCounters::ReadForCurrentThread(&hardware_counters);
+
   std::string console_message;
   if (*category_group_enabled & ENABLED_FOR_RECORDING) {
+    // Only the flushing thread contends for the lock of a buffer without a
+    // message loop, so adding an event usually doesn't wait for other threads.
+    OptionalAutoLock buffer_lock(thread_local_event_buffer->lock());
+    if (!thread_local_event_buffer->has_message_loop())
+      buffer_lock.EnsureAcquired();
     OptionalAutoLock lock(&lock_);
 
-    TraceEvent* trace_event = NULL;
-    if (thread_local_event_buffer) {
-      trace_event = thread_local_event_buffer->AddTraceEvent(&handle);
-    } else {
-      lock.EnsureAcquired();
-      trace_event = AddEventToThreadSharedChunkWhileLocked(&handle, true);
-    }
+    TraceEvent* trace_event = thread_local_event_buffer->AddTraceEvent(&handle);
 
     if (trace_event) {
       trace_event->Initialize(thread_id,
@@ -1303,6 +1534,8 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamp(
                               arg_values,
                               convertable_values,
                               flags);
+      if (has_hardware_counters)
+        trace_event->SetHardwareCounters(hardware_counters);
 
 #if defined(OS_ANDROID)
       trace_event->SendToATrace();
@@ -1455,6 +1688,11 @@ void TraceLog::UpdateTraceEventDuration(
 
   AutoThreadLocalBoolean thread_is_in_trace_event(&thread_is_in_trace_event_);
 
+  HardwareCounters hardware_counters;
+  bool has_hardware_counters =
+      (category_group_enabled_local & ENABLED_FOR_RECORDING) &&
+      (trace_options() & kInternalEnableHardwareCounters) &&
+      HardwareCounters::ReadForCurrentThread(&hardware_counters);
   ThreadTicks thread_now = ThreadNow();
   TimeTicks now = OffsetNow();
 
@@ -1466,12 +1704,23 @@ void TraceLog::UpdateTraceEventDuration(
 
   std::string console_message;
   if (category_group_enabled_local & ENABLED_FOR_RECORDING) {
+    ThreadLocalEventBuffer* thread_local_event_buffer =
+        thread_local_event_buffer_.Get();
+    OptionalAutoLock buffer_lock(
+        thread_local_event_buffer ? thread_local_event_buffer->lock()
+                                  : nullptr);
+    if (thread_local_event_buffer &&
+        !thread_local_event_buffer->has_message_loop()) {
+      buffer_lock.EnsureAcquired();
+    }
     OptionalAutoLock lock(&lock_);
 
     TraceEvent* trace_event = GetEventByHandleInternal(handle, &lock);
     if (trace_event) {
       DCHECK(trace_event->phase() == TRACE_EVENT_PHASE_COMPLETE);
       trace_event->UpdateDuration(now, thread_now);
+      trace_event->UpdateHardwareCounters(
+          has_hardware_counters ? &hardware_counters : nullptr);
 #if defined(OS_ANDROID)
       trace_event->SendToATrace();
 #endif
@@ -1702,7 +1951,10 @@ void TraceLog::SetCurrentThreadBlocksMessageLoop() {
 TraceBuffer* TraceLog::CreateTraceBuffer() {
   HEAP_PROFILER_SCOPED_IGNORE;
   InternalTraceOptions options = trace_options();
-  if (options & kInternalRecordContinuously)
+  if (stream_task_runner_)
+    return TraceBuffer::CreateTraceBufferStreamingRingBuffer(
+        kTraceEventRingBufferChunks);
+  else if (options & kInternalRecordContinuously)
     return TraceBuffer::CreateTraceBufferRingBuffer(
         kTraceEventRingBufferChunks);
   else if (options & kInternalEchoToConsole)
@@ -17,6 +17,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/scoped_vector.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "base/trace_event/trace_config.h"
 #include "base/trace_event/trace_event_impl.h"
@@ -27,6 +28,7 @@ namespace base {
 template <typename Type>
 struct DefaultSingletonTraits;
 class RefCountedString;
+class SequencedTaskRunner;
 
 namespace trace_event {
 
@@ -72,8 +74,9 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
   // Retrieves a copy (for thread-safety) of the current TraceConfig.
   TraceConfig GetCurrentTraceConfig() const;
 
-  // Initializes the thread-local event buffer, if not already initialized and
-  // if the current thread supports that (has a message loop).
+  // Initializes the thread-local event buffer, if not already initialized. The
+  // buffer of a thread without a message loop, or whose message loop is
+  // blocked, is flushed by the thread which calls Flush().
   void InitializeThreadLocalEventBufferIfSupported();
 
   // Enables normal tracing (recording trace events in the trace buffer).
@@ -190,9 +193,26 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
                               bool has_more_events)> OutputCallback;
   void Flush(const OutputCallback& cb, bool use_worker_thread = false);
 
+  // Same as Flush(), but outputs the events in the binary format of
+  // TraceEventBinaryWriter, which is much cheaper to produce and smaller than
+  // JSON. The output chunks form a single stream, which
+  // ConvertBinaryTraceToJSON() converts to JSON once concatenated.
+  void FlushAsBinary(const OutputCallback& cb, bool use_worker_thread = false);
+
   // Cancels tracing and discards collected data.
   void CancelTracing(const OutputCallback& cb);
 
+  // Streams the events while tracing, which keeps the memory used by long
+  // traces bounded. After this is called, trace events are recorded in a ring
+  // buffer which evicts its oldest chunks of events instead of overwriting
+  // them. The evicted events are passed to |cb| on |task_runner| in the format
+  // of Flush(), with |has_more_events| set. Flush() outputs the remaining
+  // events. Events which completed after their chunk was evicted have no
+  // duration. Must be called while tracing is disabled, and discards the
+  // events which haven't been flushed. A null |cb| stops streaming.
+  void SetStreamingCallback(const OutputCallback& cb,
+                            scoped_refptr<SequencedTaskRunner> task_runner);
+
   // Called by TRACE_EVENT* macros, don't call this directly.
   // The name parameter is a category group for example:
   // TRACE_EVENT0("renderer,webkit", "WebViewImpl::HandleInputEvent")
@@ -361,6 +381,7 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
                            ConvertTraceConfigToInternalOptions);
   FRIEND_TEST_ALL_PREFIXES(TraceEventTestFixture,
                            TraceRecordAsMuchAsPossibleMode);
+  FRIEND_TEST_ALL_PREFIXES(TraceEventTestFixture, StreamingCallback);
 
   // This allows constructor and destructor to be private and usable only
   // by the Singleton class.
@@ -409,6 +430,10 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
   TraceEvent* AddEventToThreadSharedChunkWhileLocked(TraceEventHandle* handle,
                                                      bool check_buffer_is_full);
   void CheckIfBufferIsFullWhileLocked();
+  // Returns the task runner to post StreamEvictedChunks() to, if the trace
+  // buffer evicted chunks since that task last ran.
+  scoped_refptr<SequencedTaskRunner> GetStreamTaskRunnerWhileLocked();
+  void StreamEvictedChunks();
   void SetDisabledWhileLocked();
 
   TraceEvent* GetEventByHandleInternal(TraceEventHandle handle,
@@ -416,6 +441,7 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
 
   void FlushInternal(const OutputCallback& cb,
                      bool use_worker_thread,
+                     bool as_binary,
                      bool discard_events);
 
   // |generation| is used in the following callbacks to check if the callback
@@ -425,7 +451,8 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
   static void ConvertTraceEventsToTraceFormat(
       std::unique_ptr<TraceBuffer> logged_events,
       const TraceLog::OutputCallback& flush_output_callback,
-      const ArgumentFilterPredicate& argument_filter_predicate);
+      const ArgumentFilterPredicate& argument_filter_predicate,
+      bool as_binary);
   void FinishFlush(int generation, bool discard_events);
   void OnFlushTimeout(int generation, bool discard_events);
 
@@ -451,6 +478,7 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
   static const InternalTraceOptions kInternalEnableSampling;
   static const InternalTraceOptions kInternalRecordAsMuchAsPossible;
   static const InternalTraceOptions kInternalEnableArgumentFilter;
+  static const InternalTraceOptions kInternalEnableHardwareCounters;
 
   // This lock protects TraceLog member accesses (except for members protected
   // by thread_info_lock_) from arbitrary threads.
@@ -510,15 +538,33 @@ class BASE_EXPORT TraceLog : public MemoryDumpProvider {
   // because we need to know the life time of the message loops.
   hash_set<MessageLoop*> thread_message_loops_;
 
-  // For events which can't be added into the thread local buffer, e.g. events
-  // from threads without a message loop.
+  // Contains the thread local buffers of threads without a message loop, or
+  // whose message loop is blocked. Flush() takes their chunks from the flushing
+  // thread. |loopless_event_buffers_lock_| is acquired before the lock of any
+  // buffer, which is itself acquired before |lock_|.
+  Lock loopless_event_buffers_lock_;
+  hash_set<ThreadLocalEventBuffer*> loopless_event_buffers_;
+
+  // Deletes the thread local buffer of a thread without a message loop when
+  // the thread exits.
+  ThreadLocalStorage::Slot loopless_event_buffer_tls_;
+
+  // For events which can't be added into the thread local buffer, i.e. metadata
+  // events.
   std::unique_ptr<TraceBufferChunk> thread_shared_chunk_;
   size_t thread_shared_chunk_index_;
 
   // Set when asynchronous Flush is in progress.
   OutputCallback flush_output_callback_;
+  bool flush_as_binary_;
   scoped_refptr<SingleThreadTaskRunner> flush_task_runner_;
   ArgumentFilterPredicate argument_filter_predicate_;
+
+  // Set by SetStreamingCallback().
+  OutputCallback stream_output_callback_;
+  scoped_refptr<SequencedTaskRunner> stream_task_runner_;
+  bool stream_task_posted_;
+
   subtle::AtomicWord generation_;
   bool use_worker_thread_;
 
@@ -7,6 +7,8 @@
 #include <limits.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "base/atomicops.h"
 #include "base/base_switches.h"
 #include "base/command_line.h"
@@ -125,24 +127,35 @@ DeathData::~DeathData() {
 #define CONDITIONAL_ASSIGN(assign_it, target, source) \
   ((target) ^= ((target) ^ (source)) & -static_cast<int32_t>(assign_it))
 
-void DeathData::RecordDeath(const int32_t queue_duration,
-                            const int32_t run_duration,
-                            const uint32_t random_number) {
+namespace {
+
+// Returns |value| + |count| * |amount|, clamped at INT_MAX.
+int32_t SaturatedAdd(int32_t value, int count, int32_t amount) {
+  int64_t result = value + static_cast<int64_t>(count) * amount;
+  return static_cast<int32_t>(std::min<int64_t>(result, INT_MAX));
+}
+
+}  // namespace
+
+void DeathData::RecordDeaths(const int count,
+                             const int32_t queue_duration,
+                             const int32_t run_duration,
+                             const uint32_t random_number) {
+  DCHECK_GT(count, 0);
+
   // We'll just clamp at INT_MAX, but we should note this in the UI as such.
-  if (count_ < INT_MAX)
-    base::subtle::NoBarrier_Store(&count_, count_ + 1);
+  base::subtle::NoBarrier_Store(&count_, SaturatedAdd(count_, count, 1));
 
-  int sample_probability_count =
-      base::subtle::NoBarrier_Load(&sample_probability_count_);
-  if (sample_probability_count < INT_MAX)
-    ++sample_probability_count;
+  int sample_probability_count = SaturatedAdd(
+      base::subtle::NoBarrier_Load(&sample_probability_count_), count, 1);
   base::subtle::NoBarrier_Store(&sample_probability_count_,
                                 sample_probability_count);
 
-  base::subtle::NoBarrier_Store(&queue_duration_sum_,
-                                queue_duration_sum_ + queue_duration);
-  base::subtle::NoBarrier_Store(&run_duration_sum_,
-                                run_duration_sum_ + run_duration);
+  base::subtle::NoBarrier_Store(
+      &queue_duration_sum_,
+      SaturatedAdd(queue_duration_sum_, count, queue_duration));
+  base::subtle::NoBarrier_Store(
+      &run_duration_sum_, SaturatedAdd(run_duration_sum_, count, run_duration));
 
   if (queue_duration_max() < queue_duration)
     base::subtle::NoBarrier_Store(&queue_duration_max_, queue_duration);
@@ -152,13 +165,14 @@ void DeathData::RecordDeath(const int32_t queue_duration,
   // Take a uniformly distributed sample over all durations ever supplied during
   // the current profiling phase.
   // The probability that we (instead) use this new sample is
-  // 1/sample_probability_count_. This results in a completely uniform selection
+  // count/sample_probability_count_. This results in a completely uniform selection
   // of the sample (at least when we don't clamp sample_probability_count_...
   // but that should be inconsequentially likely).  We ignore the fact that we
   // correlated our selection of a sample to the run and queue times (i.e., we
   // used them to generate random_number).
   CHECK_GT(sample_probability_count, 0);
-  if (0 == (random_number % sample_probability_count)) {
+  if (random_number % sample_probability_count <
+      static_cast<uint32_t>(count)) {
     base::subtle::NoBarrier_Store(&queue_duration_sample_, queue_duration);
     base::subtle::NoBarrier_Store(&run_duration_sample_, run_duration);
   }
@@ -261,11 +275,13 @@ BirthOnThreadSnapshot::~BirthOnThreadSnapshot() {
 //------------------------------------------------------------------------------
 Births::Births(const Location& location, const ThreadData& current)
     : BirthOnThread(location, current),
-      birth_count_(1) { }
+      birth_count_(0) { }
 
 int Births::birth_count() const { return birth_count_; }
 
-void Births::RecordBirth() { ++birth_count_; }
+void Births::RecordBirths(int count) {
+  birth_count_ = SaturatedAdd(birth_count_, count, 1);
+}
 
 //------------------------------------------------------------------------------
 // ThreadData maintains the central data for all births and deaths on a single
@@ -306,10 +322,15 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 base::subtle::Atomic32 ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+base::subtle::Atomic32 ThreadData::sampling_interval_ =
+    ThreadData::kDefaultSamplingInterval;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
+      births_until_next_sample_(0),
       incarnation_count_for_pool_(-1),
       current_stopwatch_(NULL) {
   DCHECK_GE(suggested_name.size(), 0u);
@@ -321,6 +342,7 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
+      births_until_next_sample_(0),
       incarnation_count_for_pool_(-1),
       current_stopwatch_(NULL) {
   CHECK_GT(thread_number, 0);
@@ -477,12 +499,11 @@ void ThreadData::OnProfilingPhaseCompleted(int profiling_phase) {
   }
 }
 
-Births* ThreadData::TallyABirth(const Location& location) {
+Births* ThreadData::TallyABirth(const Location& location, int count) {
   BirthMap::iterator it = birth_map_.find(location);
   Births* child;
   if (it != birth_map_.end()) {
     child =  it->second;
-    child->RecordBirth();
   } else {
     child = new Births(location, *this);  // Leak this.
     // Lock since the map may get relocated now, and other threads sometimes
@@ -490,10 +511,24 @@ Births* ThreadData::TallyABirth(const Location& location) {
     base::AutoLock lock(map_lock_);
     birth_map_[location] = child;
   }
+  child->RecordBirths(count);
 
   return child;
 }
 
+bool ThreadData::ShouldSampleBirth(int interval) {
+  if (--births_until_next_sample_ > 0)
+    return false;
+
+  // Pick the gap to the next sampled birth uniformly in [1, 2 * interval - 1],
+  // so that its mean is |interval| but tasks which are posted periodically
+  // don't always get the same one of them sampled.
+  random_number_ = random_number_ * 1103515245u + 12345u;
+  births_until_next_sample_ =
+      1 + static_cast<int>((random_number_ >> 8) % (2 * interval - 1));
+  return true;
+}
+
 void ThreadData::TallyADeath(const Births& births,
                              int32_t queue_duration,
                              const TaskStopwatch& stopwatch) {
@@ -514,17 +549,30 @@ void ThreadData::TallyADeath(const Births& births,
     base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
     death_data = &death_map_[&births];
   }  // Release lock ASAP.
-  death_data->RecordDeath(queue_duration, run_duration, random_number_);
+
+  // Only sampled births were tallied, so a death stands for as many deaths as
+  // its birth stood for births. This is only approximate if the status or the
+  // sampling interval changed while the task was pending.
+  const int count = status() == PROFILING_SAMPLED ? sampling_interval() : 1;
+  death_data->RecordDeaths(count, queue_duration, run_duration,
+                           random_number_);
 }
 
 // static
 Births* ThreadData::TallyABirthIfActive(const Location& location) {
-  if (!TrackingStatus())
+  const Status current_status = status();
+  if (current_status <= DEACTIVATED)
     return NULL;
   ThreadData* current_thread_data = Get();
   if (!current_thread_data)
     return NULL;
-  return current_thread_data->TallyABirth(location);
+  if (current_status != PROFILING_SAMPLED)
+    return current_thread_data->TallyABirth(location, 1);
+
+  const int interval = sampling_interval();
+  if (!current_thread_data->ShouldSampleBirth(interval))
+    return NULL;
+  return current_thread_data->TallyABirth(location, interval);
 }
 
 // static
@@ -710,15 +758,24 @@ void ThreadData::EnsureTlsInitialization() {
 // static
 void ThreadData::InitializeAndSetTrackingStatus(Status status) {
   DCHECK_GE(status, DEACTIVATED);
-  DCHECK_LE(status, PROFILING_ACTIVE);
+  DCHECK_LE(status, STATUS_LAST);
 
   EnsureTlsInitialization();  // No-op if already initialized.
 
-  if (status > DEACTIVATED)
-    status = PROFILING_ACTIVE;
   base::subtle::Release_Store(&status_, status);
 }
 
+// static
+void ThreadData::SetSamplingInterval(int interval) {
+  DCHECK_GT(interval, 0);
+  base::subtle::NoBarrier_Store(&sampling_interval_, interval);
+}
+
+// static
+int ThreadData::sampling_interval() {
+  return base::subtle::NoBarrier_Load(&sampling_interval_);
+}
+
 // static
 ThreadData::Status ThreadData::status() {
   return static_cast<ThreadData::Status>(base::subtle::Acquire_Load(&status_));
@@ -786,6 +843,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   tls_index_.Set(NULL);
   // Almost UNINITIALIZED.
   base::subtle::Release_Store(&status_, DORMANT_DURING_TESTS);
+  base::subtle::NoBarrier_Store(&sampling_interval_, kDefaultSamplingInterval);
 
   // To avoid any chance of racing in unit tests, which is the only place we
   // call this function, we may sometimes leak all the data structures we
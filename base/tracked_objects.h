@@ -238,8 +238,10 @@ class BASE_EXPORT Births: public BirthOnThread {
 
   int birth_count() const;
 
-  // When we have a birth we update the count for this birthplace.
-  void RecordBirth();
+  // When we have births we update the count for this birthplace. |count| is
+  // greater than 1 when profiling is sampled, and each recorded birth stands
+  // for that many births.
+  void RecordBirths(int count);
 
  private:
   // The number of births on this thread for our location_.
@@ -328,7 +330,17 @@ class BASE_EXPORT DeathData {
   // |duration|, and has had a queueing delay of |queue_duration|.
   void RecordDeath(const int32_t queue_duration,
                    const int32_t run_duration,
-                   const uint32_t random_number);
+                   const uint32_t random_number) {
+    RecordDeaths(1, queue_duration, run_duration, random_number);
+  }
+
+  // Same as RecordDeath(), but the death stands for |count| deaths with the
+  // same durations. Used when profiling is sampled. Counts and sums saturate
+  // at INT_MAX.
+  void RecordDeaths(const int count,
+                    const int32_t queue_duration,
+                    const int32_t run_duration,
+                    const uint32_t random_number);
 
   // Metrics and past snapshots accessors, used only for serialization and in
   // tests.
@@ -442,9 +454,14 @@ class BASE_EXPORT ThreadData {
     DORMANT_DURING_TESTS,  // Only used during testing.
     DEACTIVATED,           // No longer recording profiling.
     PROFILING_ACTIVE,      // Recording profiles.
-    STATUS_LAST = PROFILING_ACTIVE
+    PROFILING_SAMPLED,     // Recording profiles of 1 in sampling_interval()
+                           // tasks, which is cheap enough for production.
+    STATUS_LAST = PROFILING_SAMPLED
   };
 
+  // Default value of sampling_interval().
+  static const int kDefaultSamplingInterval = 100;
+
   typedef base::hash_map<Location, Births*, Location::Hash> BirthMap;
   typedef std::map<const Births*, DeathData> DeathMap;
 
@@ -516,11 +533,18 @@ class BASE_EXPORT ThreadData {
   // while we are single threaded).
   static void EnsureTlsInitialization();
 
-  // Sets internal status_.
-  // If |status| is false, then status_ is set to DEACTIVATED.
-  // If |status| is true, then status_ is set to PROFILING_ACTIVE.
+  // Sets internal status_ to |status|, which must be DEACTIVATED,
+  // PROFILING_ACTIVE or PROFILING_SAMPLED.
   static void InitializeAndSetTrackingStatus(Status status);
 
+  // In the PROFILING_SAMPLED state, on average 1 in |interval| births is
+  // tallied, and so are the deaths of these tasks. Each tallied birth and
+  // death is counted |interval| times, so that the snapshotted counts and
+  // duration sums are estimates of the real ones, and averages are unbiased.
+  // Only affects the current process. |interval| must be positive.
+  static void SetSamplingInterval(int interval);
+  static int sampling_interval();
+
   static Status status();
 
   // Indicate if any sort of profiling is being done (i.e., we are more than
@@ -579,8 +603,13 @@ class BASE_EXPORT ThreadData {
   ThreadData* next() const;
 
 
-  // In this thread's data, record a new birth.
-  Births* TallyABirth(const Location& location);
+  // In this thread's data, record a new birth which stands for |count|
+  // births.
+  Births* TallyABirth(const Location& location, int count);
+
+  // Returns true if the next birth on this thread should be tallied when
+  // profiling is sampled with |interval|.
+  bool ShouldSampleBirth(int interval);
 
   // Find a place to record a death on this thread.
   void TallyADeath(const Births& births,
@@ -669,6 +698,9 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static base::subtle::Atomic32 status_;
 
+  // See SetSamplingInterval().
+  static base::subtle::Atomic32 sampling_interval_;
+
   // Link to next instance (null terminated list).  Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -715,6 +747,10 @@ class BASE_EXPORT ThreadData {
   // we stir in more and more as we go.
   uint32_t random_number_;
 
+  // Number of births on this thread until the next one is tallied, when
+  // profiling is sampled. Only accessed on this thread.
+  int births_until_next_sample_;
+
   // Record of what the incarnation_counter_ was when this instance was created.
   // If the incarnation_counter_ has changed, then we avoid pushing into the
   // pool (this is only critical in tests which go through multiple
@@ -6,6 +6,7 @@
 
 #include "base/tracked_objects.h"
 
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -276,6 +277,30 @@ TEST_F(TrackedObjectsTest, DeathDataTestRecordDeath) {
   EXPECT_EQ(nullptr, data->last_phase_snapshot());
 }
 
+TEST_F(TrackedObjectsTest, DeathDataTestRecordDeaths) {
+  ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_SAMPLED);
+
+  std::unique_ptr<DeathData> data(new DeathData());
+  int32_t run_ms = 42;
+  int32_t queue_ms = 8;
+
+  const int kUnrandomInt = 0;  // Fake random int that ensure we sample data.
+  data->RecordDeaths(10, queue_ms, run_ms, kUnrandomInt);
+  EXPECT_EQ(data->run_duration_sum(), 10 * run_ms);
+  EXPECT_EQ(data->run_duration_max(), run_ms);
+  EXPECT_EQ(data->run_duration_sample(), run_ms);
+  EXPECT_EQ(data->queue_duration_sum(), 10 * queue_ms);
+  EXPECT_EQ(data->queue_duration_max(), queue_ms);
+  EXPECT_EQ(data->queue_duration_sample(), queue_ms);
+  EXPECT_EQ(data->count(), 10);
+
+  // Counts and sums saturate.
+  data->RecordDeaths(INT_MAX, queue_ms, run_ms, kUnrandomInt);
+  EXPECT_EQ(data->run_duration_sum(), INT_MAX);
+  EXPECT_EQ(data->queue_duration_sum(), INT_MAX);
+  EXPECT_EQ(data->count(), INT_MAX);
+}
+
 TEST_F(TrackedObjectsTest, DeathDataTest2Phases) {
   ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_ACTIVE);
 
@@ -471,6 +496,69 @@ TEST_F(TrackedObjectsTest, LifeCycleToSnapshotMainThread) {
                           kMainThreadName, 1, 2, 4);
 }
 
+TEST_F(TrackedObjectsTest, SampledLifeCycleToSnapshotMainThread) {
+  ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_SAMPLED);
+  ThreadData::InitializeThreadContext(kMainThreadName);
+  const int kSamplingInterval = 4;
+  ThreadData::SetSamplingInterval(kSamplingInterval);
+
+  const char kFunction[] = "SampledLifeCycleToSnapshotMainThread";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+
+  const unsigned int kTimePosted = 1;
+  const unsigned int kStartOfRun = 5;
+  const unsigned int kEndOfRun = 7;
+  const int kNumTasks = 1000;
+  int num_sampled_tasks = 0;
+  for (int i = 0; i < kNumTasks; ++i) {
+    SetTestTime(kTimePosted);
+    // TrackingInfo will call TallyABirth() during construction.
+    base::TrackingInfo pending_task(location, base::TimeTicks());
+    if (pending_task.birth_tally) {
+      ++num_sampled_tasks;
+      EXPECT_FALSE(pending_task.time_posted.is_null());
+    } else {
+      // The clock isn't read for tasks which aren't sampled.
+      EXPECT_TRUE(pending_task.time_posted.is_null());
+    }
+
+    SetTestTime(kStartOfRun);
+    TaskStopwatch stopwatch;
+    stopwatch.Start();
+    SetTestTime(kEndOfRun);
+    stopwatch.Stop();
+
+    ThreadData::TallyRunOnNamedThreadIfTracking(pending_task, stopwatch);
+  }
+
+  // Gaps between sampled tasks are in [1, 2 * kSamplingInterval - 1].
+  EXPECT_GE(num_sampled_tasks, kNumTasks / (2 * kSamplingInterval - 1));
+  EXPECT_LE(num_sampled_tasks, kNumTasks);
+
+  // Each sampled task stands for |kSamplingInterval| tasks.
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(0, &process_data);
+  ExpectSimpleProcessData(process_data, kFunction, kMainThreadName,
+                          kMainThreadName,
+                          num_sampled_tasks * kSamplingInterval, 2, 4);
+}
+
+TEST_F(TrackedObjectsTest, SampledWithIntervalOfOne) {
+  ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_SAMPLED);
+  ThreadData::SetSamplingInterval(1);
+
+  // Every birth is tallied.
+  const char kFunction[] = "SampledWithIntervalOfOne";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+  for (int i = 0; i < 10; ++i)
+    TallyABirth(location, kMainThreadName);
+
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(0, &process_data);
+  ExpectSimpleProcessData(process_data, kFunction, kMainThreadName, kStillAlive,
+                          10, 0, 0);
+}
+
 TEST_F(TrackedObjectsTest, TwoPhases) {
   ThreadData::InitializeAndSetTrackingStatus(ThreadData::PROFILING_ACTIVE);
 
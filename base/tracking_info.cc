@@ -18,8 +18,11 @@ TrackingInfo::TrackingInfo(
     base::TimeTicks delayed_run_time)
     : birth_tally(
           tracked_objects::ThreadData::TallyABirthIfActive(posted_from)),
-      time_posted(tracked_objects::ThreadData::Now()),
       delayed_run_time(delayed_run_time) {
+  // The post time is only needed to profile the task, so don't read the clock
+  // for tasks which aren't tracked, e.g. when profiling is sampled.
+  if (birth_tally)
+    time_posted = tracked_objects::ThreadData::Now();
 }
 
 TrackingInfo::~TrackingInfo() {}
@@ -366,7 +366,7 @@ bool DictionaryValue::GetAsDictionary(const DictionaryValue** out_value) const {
 
 bool DictionaryValue::HasKey(const std::string& key) const {
   DCHECK(IsStringUTF8(key));
-  auto current_entry = dictionary_.find(key);
+  auto current_entry = Find(key);
   DCHECK((current_entry == dictionary_.end()) || current_entry->second);
   return current_entry != dictionary_.end();
 }
@@ -429,7 +429,11 @@ void DictionaryValue::SetString(const std::string& path,
 
 void DictionaryValue::SetWithoutPathExpansion(const std::string& key,
                                               std::unique_ptr<Value> in_value) {
-  dictionary_[key] = std::move(in_value);
+  auto entry = LowerBound(key);
+  if (entry != dictionary_.end() && entry->first == key)
+    entry->second = std::move(in_value);
+  else
+    dictionary_.emplace(entry, key, std::move(in_value));
 }
 
 void DictionaryValue::SetWithoutPathExpansion(const std::string& key,
@@ -613,7 +617,7 @@ bool DictionaryValue::GetList(const std::string& path, ListValue** out_value) {
 bool DictionaryValue::GetWithoutPathExpansion(const std::string& key,
                                               const Value** out_value) const {
   DCHECK(IsStringUTF8(key));
-  auto entry_iterator = dictionary_.find(key);
+  auto entry_iterator = Find(key);
   if (entry_iterator == dictionary_.end())
     return false;
 
@@ -742,7 +746,7 @@ bool DictionaryValue::RemoveWithoutPathExpansion(
     const std::string& key,
     std::unique_ptr<Value>* out_value) {
   DCHECK(IsStringUTF8(key));
-  auto entry_iterator = dictionary_.find(key);
+  auto entry_iterator = Find(key);
   if (entry_iterator == dictionary_.end())
     return false;
 
@@ -802,6 +806,40 @@ void DictionaryValue::Swap(DictionaryValue* other) {
   dictionary_.swap(other->dictionary_);
 }
 
+DictionaryValue::Storage::iterator DictionaryValue::LowerBound(
+    const std::string& key) {
+  return std::lower_bound(
+      dictionary_.begin(), dictionary_.end(), key,
+      [](const Storage::value_type& entry, const std::string& key) {
+        return entry.first < key;
+      });
+}
+
+DictionaryValue::Storage::const_iterator DictionaryValue::LowerBound(
+    const std::string& key) const {
+  return std::lower_bound(
+      dictionary_.begin(), dictionary_.end(), key,
+      [](const Storage::value_type& entry, const std::string& key) {
+        return entry.first < key;
+      });
+}
+
+DictionaryValue::Storage::iterator DictionaryValue::Find(
+    const std::string& key) {
+  auto entry = LowerBound(key);
+  if (entry != dictionary_.end() && entry->first != key)
+    return dictionary_.end();
+  return entry;
+}
+
+DictionaryValue::Storage::const_iterator DictionaryValue::Find(
+    const std::string& key) const {
+  auto entry = LowerBound(key);
+  if (entry != dictionary_.end() && entry->first != key)
+    return dictionary_.end();
+  return entry;
+}
+
 DictionaryValue::Iterator::Iterator(const DictionaryValue& target)
     : target_(target),
       it_(target.dictionary_.begin()) {}
@@ -813,9 +851,11 @@ DictionaryValue::Iterator::~Iterator() {}
 DictionaryValue* DictionaryValue::DeepCopy() const {
   DictionaryValue* result = new DictionaryValue;
 
+  // The entries are already sorted, so they can be appended directly.
+  result->dictionary_.reserve(dictionary_.size());
   for (const auto& current_entry : dictionary_) {
-    result->SetWithoutPathExpansion(current_entry.first,
-                                    current_entry.second->CreateDeepCopy());
+    result->dictionary_.emplace_back(current_entry.first,
+                                     current_entry.second->CreateDeepCopy());
   }
 
   return result;
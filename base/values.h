@@ -206,9 +206,14 @@ class BASE_EXPORT BinaryValue: public Value {
 // DictionaryValue provides a key-value dictionary with (optional) "path"
 // parsing for recursive access; see the comment at the top of the file. Keys
 // are |std::string|s and should be UTF-8 encoded.
+//
+// The entries are kept in a vector sorted by key, so that a dictionary costs
+// one allocation for its entries plus one per value, and lookups don't chase
+// pointers through tree nodes. Values keep their address while they are in the
+// dictionary, but setting or removing a key invalidates Iterators.
 class BASE_EXPORT DictionaryValue : public Value {
  public:
-  using Storage = std::map<std::string, std::unique_ptr<Value>>;
+  using Storage = std::vector<std::pair<std::string, std::unique_ptr<Value>>>;
   // Returns |value| if it is a dictionary, nullptr otherwise.
   static std::unique_ptr<DictionaryValue> From(std::unique_ptr<Value> value);
 
@@ -381,6 +386,15 @@ class BASE_EXPORT DictionaryValue : public Value {
   bool Equals(const Value* other) const override;
 
  private:
+  // Returns the first entry whose key is not less than |key|, which is where
+  // an entry for |key| is or would be inserted.
+  Storage::iterator LowerBound(const std::string& key);
+  Storage::const_iterator LowerBound(const std::string& key) const;
+
+  // Returns the entry for |key|, or the end of |dictionary_|.
+  Storage::iterator Find(const std::string& key);
+  Storage::const_iterator Find(const std::string& key) const;
+
   Storage dictionary_;
 
   DISALLOW_COPY_AND_ASSIGN(DictionaryValue);
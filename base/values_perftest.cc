@@ -0,0 +1,147 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/memory/ptr_util.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Number of keys of the dictionaries, about the size of a large prefs
+// dictionary.
+const int kNumKeys = 500;
+
+// Number of times each benchmark is repeated.
+const int kNumRounds = 2000;
+
+// The layout of DictionaryValue before it used a sorted vector, for
+// comparison.
+using MapStorage = std::map<std::string, std::unique_ptr<Value>>;
+
+std::vector<std::string> MakeKeys(bool shuffled) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < kNumKeys; ++i)
+    keys.push_back(StringPrintf("profile.content_settings.key_%04d", i));
+  if (shuffled)
+    std::random_shuffle(keys.begin(), keys.end(), RandGenerator);
+  return keys;
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 TimeDelta elapsed,
+                 int num_operations) {
+  perf_test::PrintResult(measurement, "", trace,
+                         elapsed.InMillisecondsF() * 1000000 / num_operations,
+                         "ns/op", true);
+}
+
+void BuildDictionary(const std::vector<std::string>& keys,
+                     DictionaryValue* dictionary) {
+  for (size_t i = 0; i < keys.size(); ++i)
+    dictionary->SetIntegerWithoutPathExpansion(keys[i], static_cast<int>(i));
+}
+
+void BuildMap(const std::vector<std::string>& keys, MapStorage* map) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    (*map)[keys[i]] =
+        WrapUnique(new FundamentalValue(static_cast<int>(i)));
+  }
+}
+
+void RunBuild(bool shuffled, const std::string& trace) {
+  const std::vector<std::string> keys = MakeKeys(shuffled);
+
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    DictionaryValue dictionary;
+    BuildDictionary(keys, &dictionary);
+    ASSERT_EQ(static_cast<size_t>(kNumKeys), dictionary.size());
+  }
+  PrintResult("build_dictionary", trace, TimeTicks::Now() - start,
+              kNumRounds * kNumKeys);
+
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    MapStorage map;
+    BuildMap(keys, &map);
+    ASSERT_EQ(static_cast<size_t>(kNumKeys), map.size());
+  }
+  PrintResult("build_map", trace, TimeTicks::Now() - start,
+              kNumRounds * kNumKeys);
+}
+
+}  // namespace
+
+TEST(ValuesPerfTest, BuildInOrder) {
+  RunBuild(false, "in_order");
+}
+
+TEST(ValuesPerfTest, BuildShuffled) {
+  RunBuild(true, "shuffled");
+}
+
+TEST(ValuesPerfTest, Lookup) {
+  const std::vector<std::string> keys = MakeKeys(false);
+  const std::vector<std::string> lookups = MakeKeys(true);
+
+  DictionaryValue dictionary;
+  BuildDictionary(keys, &dictionary);
+  int sum = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const std::string& key : lookups) {
+      int value = 0;
+      dictionary.GetIntegerWithoutPathExpansion(key, &value);
+      sum += value;
+    }
+  }
+  PrintResult("lookup_dictionary", "shuffled", TimeTicks::Now() - start,
+              kNumRounds * kNumKeys);
+
+  MapStorage map;
+  BuildMap(keys, &map);
+  int map_sum = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const std::string& key : lookups) {
+      int value = 0;
+      auto entry = map.find(key);
+      if (entry != map.end())
+        entry->second->GetAsInteger(&value);
+      map_sum += value;
+    }
+  }
+  PrintResult("lookup_map", "shuffled", TimeTicks::Now() - start,
+              kNumRounds * kNumKeys);
+
+  EXPECT_EQ(sum, map_sum);
+}
+
+TEST(ValuesPerfTest, DeepCopy) {
+  DictionaryValue dictionary;
+  BuildDictionary(MakeKeys(false), &dictionary);
+
+  const TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    std::unique_ptr<DictionaryValue> copy = dictionary.CreateDeepCopy();
+    ASSERT_EQ(dictionary.size(), copy->size());
+  }
+  PrintResult("deep_copy_dictionary", "", TimeTicks::Now() - start,
+              kNumRounds * kNumKeys);
+}
+
+}  // namespace base
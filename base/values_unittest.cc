@@ -12,6 +12,7 @@
 
 #include "base/memory/ptr_util.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -868,6 +869,42 @@ TEST(ValuesTest, DictionaryIterator) {
   EXPECT_TRUE(seen2);
 }
 
+TEST(ValuesTest, DictionaryKeyOrder) {
+  DictionaryValue dict;
+  const char* const kKeys[] = {"m", "b", "x", "a", "mm", "c", ""};
+  for (size_t i = 0; i < arraysize(kKeys); ++i)
+    dict.SetIntegerWithoutPathExpansion(kKeys[i], static_cast<int>(i));
+
+  // Values keep their address when other keys are added or removed.
+  Value* m_value = nullptr;
+  ASSERT_TRUE(dict.GetWithoutPathExpansion("m", &m_value));
+  for (int i = 0; i < 100; ++i)
+    dict.SetIntegerWithoutPathExpansion("k" + IntToString(i), i);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(dict.RemoveWithoutPathExpansion("k" + IntToString(i), NULL));
+  Value* m_value_again = nullptr;
+  ASSERT_TRUE(dict.GetWithoutPathExpansion("m", &m_value_again));
+  EXPECT_EQ(m_value, m_value_again);
+
+  // Setting an existing key replaces its value.
+  dict.SetIntegerWithoutPathExpansion("b", 42);
+  EXPECT_EQ(arraysize(kKeys), dict.size());
+
+  // Keys are iterated over in order regardless of insertion order.
+  std::string keys;
+  for (DictionaryValue::Iterator it(dict); !it.IsAtEnd(); it.Advance())
+    keys += "<" + it.key() + ">";
+  EXPECT_EQ("<><a><b><c><m><mm><x>", keys);
+
+  int value = 0;
+  EXPECT_TRUE(dict.GetIntegerWithoutPathExpansion("", &value));
+  EXPECT_EQ(6, value);
+  EXPECT_TRUE(dict.GetIntegerWithoutPathExpansion("b", &value));
+  EXPECT_EQ(42, value);
+  EXPECT_FALSE(dict.HasKey("n"));
+  EXPECT_FALSE(dict.HasKey("z"));
+}
+
 // DictionaryValue/ListValue's Get*() methods should accept NULL as an out-value
 // and still return true/false based on success.
 TEST(ValuesTest, GetWithNullOutValue) {
@@ -600,9 +600,9 @@ void Layer::SetPosition(const gfx::PointF& position) {
         property_trees->transform_tree.Node(transform_tree_index());
     transform_node->data.update_post_local_transform(position,
                                                      transform_origin());
-    transform_node->data.needs_local_transform_update = true;
     transform_node->data.transform_changed = true;
-    layer_tree_host_->property_trees()->transform_tree.set_needs_update(true);
+    layer_tree_host_->property_trees()
+        ->transform_tree.SetNeedsLocalTransformUpdate(transform_node);
     SetNeedsCommitNoRebuild();
     return;
   }
@@ -653,9 +653,9 @@ void Layer::SetTransform(const gfx::Transform& transform) {
       bool preserves_2d_axis_alignment =
           Are2dAxisAligned(transform_, transform);
       transform_node->data.local = transform;
-      transform_node->data.needs_local_transform_update = true;
       transform_node->data.transform_changed = true;
-      layer_tree_host_->property_trees()->transform_tree.set_needs_update(true);
+      layer_tree_host_->property_trees()
+          ->transform_tree.SetNeedsLocalTransformUpdate(transform_node);
       if (preserves_2d_axis_alignment)
         SetNeedsCommitNoRebuild();
       else
@@ -690,9 +690,9 @@ void Layer::SetTransformOrigin(const gfx::Point3F& transform_origin) {
     transform_node->data.update_pre_local_transform(transform_origin);
     transform_node->data.update_post_local_transform(position(),
                                                      transform_origin);
-    transform_node->data.needs_local_transform_update = true;
     transform_node->data.transform_changed = true;
-    layer_tree_host_->property_trees()->transform_tree.set_needs_update(true);
+    layer_tree_host_->property_trees()
+        ->transform_tree.SetNeedsLocalTransformUpdate(transform_node);
     SetNeedsCommitNoRebuild();
     return;
   }
@@ -819,8 +819,7 @@ void Layer::SetScrollOffset(const gfx::ScrollOffset& scroll_offset) {
     TransformNode* transform_node =
         property_trees->transform_tree.Node(transform_tree_index());
     transform_node->data.scroll_offset = CurrentScrollOffset();
-    transform_node->data.needs_local_transform_update = true;
-    property_trees->transform_tree.set_needs_update(true);
+    property_trees->transform_tree.SetNeedsLocalTransformUpdate(transform_node);
     SetNeedsCommitNoRebuild();
     return;
   }
@@ -852,8 +851,7 @@ void Layer::SetScrollOffsetFromImplSide(
     TransformNode* transform_node =
         property_trees->transform_tree.Node(transform_tree_index());
     transform_node->data.scroll_offset = CurrentScrollOffset();
-    transform_node->data.needs_local_transform_update = true;
-    property_trees->transform_tree.set_needs_update(true);
+    property_trees->transform_tree.SetNeedsLocalTransformUpdate(transform_node);
     needs_rebuild = false;
   }
 
@@ -1651,9 +1649,8 @@ void Layer::OnTransformAnimated(const gfx::Transform& transform) {
       TransformNode* node =
           property_trees->transform_tree.Node(transform_tree_index());
       node->data.local = transform;
-      node->data.needs_local_transform_update = true;
       node->data.has_potential_animation = true;
-      property_trees->transform_tree.set_needs_update(true);
+      property_trees->transform_tree.SetNeedsLocalTransformUpdate(node);
     }
   }
 }
@@ -528,10 +528,9 @@ void LayerImpl::UpdatePropertyTreeTransform() {
         property_trees->transform_id_to_index_map[id()]);
     if (node->data.local != transform_) {
       node->data.local = transform_;
-      node->data.needs_local_transform_update = true;
       node->data.transform_changed = true;
       property_trees->changed = true;
-      property_trees->transform_tree.set_needs_update(true);
+      property_trees->transform_tree.SetNeedsLocalTransformUpdate(node);
       // TODO(ajuma): The current criteria for creating clip nodes means that
       // property trees may need to be rebuilt when the new transform isn't
       // axis-aligned wrt the old transform (see Layer::SetTransform). Since
@@ -991,8 +990,7 @@ void LayerImpl::UpdatePropertyTreeScrollOffset() {
   gfx::ScrollOffset current_offset = CurrentScrollOffset();
   if (node->data.scroll_offset != current_offset) {
     node->data.scroll_offset = current_offset;
-    node->data.needs_local_transform_update = true;
-    transform_tree.set_needs_update(true);
+    transform_tree.SetNeedsLocalTransformUpdate(node);
   }
 }
 
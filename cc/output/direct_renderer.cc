@@ -18,6 +18,7 @@
 #include "cc/output/bsp_walk_action.h"
 #include "cc/output/copy_output_request.h"
 #include "cc/quads/draw_quad.h"
+#include "cc/quads/render_pass_draw_quad.h"
 #include "ui/gfx/geometry/quad_f.h"
 #include "ui/gfx/geometry/rect_conversions.h"
 #include "ui/gfx/transform.h"
@@ -342,13 +343,27 @@ bool DirectRenderer::ShouldSkipQuad(const DrawQuad& quad,
   if (render_pass_scissor.IsEmpty())
     return true;
 
+  gfx::Rect r = render_pass_scissor;
   if (quad.shared_quad_state->is_clipped) {
-    gfx::Rect r = quad.shared_quad_state->clip_rect;
-    r.Intersect(render_pass_scissor);
-    return r.IsEmpty();
+    r.Intersect(quad.shared_quad_state->clip_rect);
+    if (r.IsEmpty())
+      return true;
   }
 
-  return false;
+  // Filters can draw a render pass quad outside of its rect, so only skip
+  // those for their clip rect.
+  if (quad.material == DrawQuad::RENDER_PASS &&
+      !RenderPassDrawQuad::MaterialCast(&quad)->filters.IsEmpty()) {
+    return false;
+  }
+
+  // Skip quads which are entirely outside of the damaged part of the pass,
+  // rather than drawing them with everything scissored away. The extra pixel
+  // around the quad covers anti-aliased edges.
+  gfx::Rect quad_rect = MathUtil::MapEnclosingClippedRect(
+      quad.shared_quad_state->quad_to_target_transform, quad.visible_rect);
+  quad_rect.Inset(-1, -1);
+  return !quad_rect.Intersects(r);
 }
 
 void DirectRenderer::SetScissorStateForQuad(
@@ -1295,6 +1295,56 @@ TEST_F(GLRendererTest, NoDiscardOnPartialUpdates) {
   }
 }
 
+class PartialSwapMockContext : public TestWebGraphicsContext3D {
+ public:
+  PartialSwapMockContext() { set_have_post_sub_buffer(true); }
+
+  MOCK_METHOD4(drawElements,
+               void(GLenum mode, GLsizei count, GLenum type, GLintptr offset));
+};
+
+TEST_F(GLRendererTest, NoDrawForQuadsOutsidePartialDamage) {
+  std::unique_ptr<PartialSwapMockContext> context_owned(
+      new PartialSwapMockContext);
+  PartialSwapMockContext* context = context_owned.get();
+
+  FakeOutputSurfaceClient output_surface_client;
+  std::unique_ptr<NonReshapableOutputSurface> output_surface(
+      new NonReshapableOutputSurface(std::move(context_owned)));
+  CHECK(output_surface->BindToClient(&output_surface_client));
+  output_surface->set_fixed_size(gfx::Size(100, 100));
+
+  std::unique_ptr<SharedBitmapManager> shared_bitmap_manager(
+      new TestSharedBitmapManager());
+  std::unique_ptr<ResourceProvider> resource_provider =
+      FakeResourceProvider::Create(output_surface.get(),
+                                   shared_bitmap_manager.get());
+
+  RendererSettings settings;
+  settings.partial_swap_enabled = true;
+  FakeRendererClient renderer_client;
+  FakeRendererGL renderer(&renderer_client, &settings, output_surface.get(),
+                          resource_provider.get());
+  EXPECT_TRUE(renderer.Capabilities().using_partial_swap);
+
+  gfx::Rect viewport_rect(100, 100);
+  RenderPassId root_pass_id(1, 0);
+  RenderPass* root_pass =
+      AddRenderPass(&render_passes_in_draw_order_, root_pass_id, viewport_rect,
+                    gfx::Transform());
+  AddQuad(root_pass, gfx::Rect(0, 0, 20, 20), SK_ColorGREEN);
+  AddQuad(root_pass, gfx::Rect(60, 60, 20, 20), SK_ColorBLUE);
+  root_pass->damage_rect = gfx::Rect(5, 5, 10, 10);
+
+  // Only the quad which intersects the damage should be drawn.
+  EXPECT_CALL(*context, drawElements(_, _, _, _)).Times(1);
+
+  renderer.DecideRenderPassAllocationsForFrame(render_passes_in_draw_order_);
+  renderer.DrawFrame(&render_passes_in_draw_order_, 1.f, viewport_rect,
+                     viewport_rect, false);
+  Mock::VerifyAndClearExpectations(context);
+}
+
 class FlippedScissorAndViewportContext : public TestWebGraphicsContext3D {
  public:
   MOCK_METHOD4(viewport, void(GLint x, GLint y, GLsizei width, GLsizei height));
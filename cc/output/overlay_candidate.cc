@@ -174,7 +174,6 @@ OverlayCandidate::OverlayCandidate()
       use_output_surface_for_resource(false),
       resource_id(0),
       plane_z_order(0),
-      is_unoccluded(false),
       overlay_handled(false) {}
 
 OverlayCandidate::OverlayCandidate(const OverlayCandidate& other) = default;
@@ -243,6 +242,25 @@ bool OverlayCandidate::IsOccluded(const OverlayCandidate& candidate,
   return false;
 }
 
+// static
+gfx::Rect OverlayCandidate::GetOccludedRect(
+    const OverlayCandidate& candidate,
+    QuadList::ConstIterator quad_list_begin,
+    QuadList::ConstIterator quad_list_end) {
+  gfx::RectF occluded_rect;
+  for (auto overlap_iter = quad_list_begin; overlap_iter != quad_list_end;
+       ++overlap_iter) {
+    if (OverlayCandidate::IsInvisibleQuad(*overlap_iter))
+      continue;
+    gfx::RectF overlap_rect = MathUtil::MapClippedRect(
+        overlap_iter->shared_quad_state->quad_to_target_transform,
+        gfx::RectF(overlap_iter->rect));
+    overlap_rect.Intersect(candidate.display_rect);
+    occluded_rect.Union(overlap_rect);
+  }
+  return gfx::ToEnclosingRect(occluded_rect);
+}
+
 // static
 bool OverlayCandidate::FromTextureQuad(ResourceProvider* resource_provider,
                                        const TextureDrawQuad* quad,
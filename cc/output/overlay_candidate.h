@@ -43,6 +43,11 @@ class CC_EXPORT OverlayCandidate {
   static bool IsOccluded(const OverlayCandidate& candidate,
                          QuadList::ConstIterator quad_list_begin,
                          QuadList::ConstIterator quad_list_end);
+  // Returns the bounds of the parts of |candidate| which visible quads in the
+  // list given by |quad_list_begin| and |quad_list_end| are on top of.
+  static gfx::Rect GetOccludedRect(const OverlayCandidate& candidate,
+                                   QuadList::ConstIterator quad_list_begin,
+                                   QuadList::ConstIterator quad_list_end);
 
   OverlayCandidate();
   OverlayCandidate(const OverlayCandidate& other);
@@ -73,10 +78,10 @@ class CC_EXPORT OverlayCandidate {
   // Stacking order of the overlay plane relative to the main surface,
   // which is 0. Signed to allow for "underlays".
   int plane_z_order;
-  // True if the overlay does not have any visible quads on top of it. Set by
-  // the strategy so the OverlayProcessor can consider subtracting damage caused
-  // by underlay quads.
-  bool is_unoccluded;
+  // Bounds of the parts of the overlay which have visible quads on top of it.
+  // Set by the strategy so the OverlayProcessor can consider subtracting damage
+  // caused by underlay quads.
+  gfx::Rect occluded_rect;
 
   // To be modified by the implementer if this candidate can go into
   // an overlay.
@@ -70,6 +70,7 @@ void OverlayProcessor::ProcessForOverlays(ResourceProvider* resource_provider,
     // If overlay processing was skipped for a frame there's no way to be sure
     // of the state of the previous frame, so reset.
     previous_frame_underlay_rect_ = gfx::Rect();
+    previous_frame_underlay_occluded_rect_ = gfx::Rect();
     return;
   }
 
@@ -87,20 +88,28 @@ void OverlayProcessor::ProcessForOverlays(ResourceProvider* resource_provider,
     UpdateDamageRect(candidates, damage_rect);
     return;
   }
+
+  // Nothing was promoted, so the underlay quad, if any, was drawn into the
+  // framebuffer this frame.
+  previous_frame_underlay_rect_ = gfx::Rect();
+  previous_frame_underlay_occluded_rect_ = gfx::Rect();
 }
 
 // Subtract on-top overlays from the damage rect, unless the overlays use
 // the backbuffer as their content (in which case, add their combined rect
 // back to the damage at the end).
-// Also subtract unoccluded underlays from the damage rect if we know that the
-// same underlay was scheduled on the previous frame. If the renderer decides
-// not to swap the framebuffer there will still be a transparent hole in the
-// previous frame. This only handles the common case of a single underlay quad
-// for fullscreen video.
+// Also subtract underlays from the damage rect if we know that the same
+// underlay was scheduled on the previous frame. If the renderer decides not to
+// swap the framebuffer there will still be a transparent hole in the previous
+// frame. Only the damage under quads on top of the underlay, this frame or the
+// previous one, has to be kept, so that small UI updates over a video don't
+// redraw the whole video rect. This only handles the common case of a single
+// underlay quad for fullscreen video.
 void OverlayProcessor::UpdateDamageRect(OverlayCandidateList* candidates,
                                         gfx::Rect* damage_rect) {
   gfx::Rect output_surface_overlay_damage_rect;
   gfx::Rect this_frame_underlay_rect;
+  gfx::Rect this_frame_underlay_occluded_rect;
   for (const OverlayCandidate& overlay : *candidates) {
     if (overlay.plane_z_order > 0) {
       const gfx::Rect overlay_display_rect =
@@ -109,15 +118,22 @@ void OverlayProcessor::UpdateDamageRect(OverlayCandidateList* candidates,
       damage_rect->Subtract(overlay_display_rect);
       if (overlay.use_output_surface_for_resource)
         output_surface_overlay_damage_rect.Union(overlay_display_rect);
-    } else if (overlay.plane_z_order < 0 && overlay.is_unoccluded &&
+    } else if (overlay.plane_z_order < 0 &&
                this_frame_underlay_rect.IsEmpty()) {
       this_frame_underlay_rect = ToEnclosedRect(overlay.display_rect);
+      this_frame_underlay_occluded_rect = overlay.occluded_rect;
     }
   }
 
-  if (this_frame_underlay_rect == previous_frame_underlay_rect_)
+  if (this_frame_underlay_rect == previous_frame_underlay_rect_) {
+    gfx::Rect occluded_damage_rect = this_frame_underlay_occluded_rect;
+    occluded_damage_rect.Union(previous_frame_underlay_occluded_rect_);
+    occluded_damage_rect.Intersect(*damage_rect);
     damage_rect->Subtract(this_frame_underlay_rect);
+    damage_rect->Union(occluded_damage_rect);
+  }
   previous_frame_underlay_rect_ = this_frame_underlay_rect;
+  previous_frame_underlay_occluded_rect_ = this_frame_underlay_occluded_rect;
 
   damage_rect->Union(output_surface_overlay_damage_rect);
 }
@@ -52,6 +52,7 @@ class CC_EXPORT OverlayProcessor {
   OutputSurface* surface_;
   gfx::Rect overlay_damage_rect_;
   gfx::Rect previous_frame_underlay_rect_;
+  gfx::Rect previous_frame_underlay_occluded_rect_;
 
  private:
   bool ProcessForCALayers(ResourceProvider* resource_provider,
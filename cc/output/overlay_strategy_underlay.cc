@@ -38,8 +38,8 @@ bool OverlayStrategyUnderlay::Attempt(ResourceProvider* resource_provider,
     // If the candidate can be handled by an overlay, create a pass for it. We
     // need to switch out the video quad with a black transparent one.
     if (new_candidate_list.back().overlay_handled) {
-      new_candidate_list.back().is_unoccluded =
-          !OverlayCandidate::IsOccluded(candidate, quad_list.cbegin(), it);
+      new_candidate_list.back().occluded_rect =
+          OverlayCandidate::GetOccludedRect(candidate, quad_list.cbegin(), it);
       const SharedQuadState* shared_quad_state = it->shared_quad_state;
       gfx::Rect rect = it->visible_rect;
       SolidColorDrawQuad* replacement =
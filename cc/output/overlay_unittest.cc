@@ -1019,6 +1019,54 @@ TEST_F(UnderlayTest, DamageSubtractedWhenQuadsAboveDontOverlap) {
   EXPECT_TRUE(damage_rect_.IsEmpty());
 }
 
+// Only the damage under quads on top of an underlay has to be kept.
+TEST_F(UnderlayTest, DamageSubtractedOutsideQuadsAbove) {
+  for (int i = 0; i < 2; ++i) {
+    std::unique_ptr<RenderPass> pass = CreateRenderPass();
+    // Add a quad above part of the candidate.
+    CreateOpaqueQuadAt(resource_provider_.get(),
+                       pass->shared_quad_state_list.back(), pass.get(),
+                       kOverlayTopLeftRect);
+    CreateFullscreenCandidateQuad(resource_provider_.get(),
+                                  pass->shared_quad_state_list.back(),
+                                  pass.get());
+
+    damage_rect_ = kOverlayRect;
+
+    OverlayCandidateList candidate_list;
+    overlay_processor_->ProcessForOverlays(resource_provider_.get(), pass.get(),
+                                           &candidate_list, nullptr,
+                                           &damage_rect_);
+  }
+
+  EXPECT_EQ(kOverlayTopLeftRect, damage_rect_);
+}
+
+// The damage under a quad which was on top of the underlay in the previous
+// frame must be kept, so that the quad is removed from the framebuffer.
+TEST_F(UnderlayTest, DamageKeptUnderPreviousQuadsAbove) {
+  for (int i = 0; i < 2; ++i) {
+    std::unique_ptr<RenderPass> pass = CreateRenderPass();
+    if (i == 0) {
+      CreateOpaqueQuadAt(resource_provider_.get(),
+                         pass->shared_quad_state_list.back(), pass.get(),
+                         kOverlayTopLeftRect);
+    }
+    CreateFullscreenCandidateQuad(resource_provider_.get(),
+                                  pass->shared_quad_state_list.back(),
+                                  pass.get());
+
+    damage_rect_ = kOverlayRect;
+
+    OverlayCandidateList candidate_list;
+    overlay_processor_->ProcessForOverlays(resource_provider_.get(), pass.get(),
+                                           &candidate_list, nullptr,
+                                           &damage_rect_);
+  }
+
+  EXPECT_EQ(kOverlayTopLeftRect, damage_rect_);
+}
+
 OverlayCandidateList BackbufferOverlayList(const RenderPass* root_render_pass) {
   OverlayCandidateList list;
   OverlayCandidate output_surface_plane;
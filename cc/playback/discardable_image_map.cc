@@ -167,7 +167,26 @@ sk_sp<SkCanvas> DiscardableImageMap::BeginGeneratingMetadata(
       bounds.width(), bounds.height(), &all_images_);
 }
 
-void DiscardableImageMap::EndGeneratingMetadata() {
+void DiscardableImageMap::EndGeneratingMetadata(
+    const DiscardableImageMap* previous_image_map,
+    const gfx::Rect& invalidated_rect) {
+  if (previous_image_map) {
+    // Images outside of |invalidated_rect| are unchanged, so they are taken
+    // from the previous map even if they were drawn again while generating
+    // this one.
+    auto is_outside_invalidated_rect =
+        [&invalidated_rect](const std::pair<DrawImage, gfx::Rect>& image) {
+          return !image.second.Intersects(invalidated_rect);
+        };
+    all_images_.erase(std::remove_if(all_images_.begin(), all_images_.end(),
+                                     is_outside_invalidated_rect),
+                      all_images_.end());
+    for (const auto& image : previous_image_map->all_images_) {
+      if (is_outside_invalidated_rect(image))
+        all_images_.push_back(image);
+    }
+  }
+
   images_rtree_.Build(all_images_,
                       [](const std::pair<DrawImage, gfx::Rect>& image) {
                         return image.second;
@@ -188,10 +207,25 @@ DiscardableImageMap::ScopedMetadataGenerator::ScopedMetadataGenerator(
     DiscardableImageMap* image_map,
     const gfx::Size& bounds)
     : image_map_(image_map),
-      metadata_canvas_(image_map->BeginGeneratingMetadata(bounds)) {}
+      metadata_canvas_(image_map->BeginGeneratingMetadata(bounds)),
+      previous_image_map_(nullptr) {}
+
+DiscardableImageMap::ScopedMetadataGenerator::ScopedMetadataGenerator(
+    DiscardableImageMap* image_map,
+    const gfx::Size& bounds,
+    const DiscardableImageMap& previous_image_map,
+    const gfx::Rect& invalidated_rect)
+    : image_map_(image_map),
+      metadata_canvas_(image_map->BeginGeneratingMetadata(bounds)),
+      previous_image_map_(&previous_image_map),
+      invalidated_rect_(invalidated_rect) {
+  // Lets pictures skip the ops outside of |invalidated_rect| while they are
+  // played back into the canvas.
+  metadata_canvas_->clipRect(gfx::RectToSkRect(invalidated_rect_));
+}
 
 DiscardableImageMap::ScopedMetadataGenerator::~ScopedMetadataGenerator() {
-  image_map_->EndGeneratingMetadata();
+  image_map_->EndGeneratingMetadata(previous_image_map_, invalidated_rect_);
 }
 
 }  // namespace cc
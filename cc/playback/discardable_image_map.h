@@ -30,6 +30,14 @@ class CC_EXPORT DiscardableImageMap {
    public:
     ScopedMetadataGenerator(DiscardableImageMap* image_map,
                             const gfx::Size& bounds);
+    // Only looks for images drawn in |invalidated_rect|, and takes the images
+    // outside of it from |previous_image_map|, which must have been generated
+    // with the same |bounds| for contents that only changed in
+    // |invalidated_rect|.
+    ScopedMetadataGenerator(DiscardableImageMap* image_map,
+                            const gfx::Size& bounds,
+                            const DiscardableImageMap& previous_image_map,
+                            const gfx::Rect& invalidated_rect);
     ~ScopedMetadataGenerator();
 
     SkCanvas* canvas() { return metadata_canvas_.get(); }
@@ -37,6 +45,8 @@ class CC_EXPORT DiscardableImageMap {
    private:
     DiscardableImageMap* image_map_;
     sk_sp<SkCanvas> metadata_canvas_;
+    const DiscardableImageMap* previous_image_map_;
+    gfx::Rect invalidated_rect_;
   };
 
   DiscardableImageMap();
@@ -52,7 +62,8 @@ class CC_EXPORT DiscardableImageMap {
   friend class DiscardableImageMapTest;
 
   sk_sp<SkCanvas> BeginGeneratingMetadata(const gfx::Size& bounds);
-  void EndGeneratingMetadata();
+  void EndGeneratingMetadata(const DiscardableImageMap* previous_image_map,
+                             const gfx::Rect& invalidated_rect);
 
   std::vector<std::pair<DrawImage, gfx::Rect>> all_images_;
   RTree images_rtree_;
@@ -85,7 +85,8 @@ DisplayItemList::DisplayItemList(gfx::Rect layer_rect,
       layer_rect_(layer_rect),
       is_suitable_for_gpu_rasterization_(true),
       approximate_op_count_(0),
-      picture_memory_usage_(0) {
+      picture_memory_usage_(0),
+      has_discardable_images_metadata_(false) {
   if (settings_.use_cached_picture) {
     SkRTreeFactory factory;
     recorder_.reset(new SkPictureRecorder());
@@ -290,6 +291,7 @@ void DisplayItemList::GenerateDiscardableImagesMetadata() {
   // This should be only called once, and only after CreateAndCacheSkPicture.
   DCHECK(image_map_.empty());
   DCHECK(!settings_.use_cached_picture || picture_);
+  has_discardable_images_metadata_ = true;
   if (settings_.use_cached_picture && !picture_->willPlayBackBitmaps())
     return;
 
@@ -302,6 +304,29 @@ void DisplayItemList::GenerateDiscardableImagesMetadata() {
          gfx::Rect(layer_rect_.right(), layer_rect_.bottom()), 1.f);
 }
 
+void DisplayItemList::GenerateDiscardableImagesMetadataFromPrevious(
+    const DisplayItemList& previous_list,
+    const gfx::Rect& invalidated_rect) {
+  gfx::Rect bounds(layer_rect_.right(), layer_rect_.bottom());
+  if (!previous_list.has_discardable_images_metadata_ ||
+      previous_list.layer_rect_ != layer_rect_ ||
+      invalidated_rect.Contains(bounds)) {
+    GenerateDiscardableImagesMetadata();
+    return;
+  }
+
+  DCHECK(image_map_.empty());
+  DCHECK(!settings_.use_cached_picture || picture_);
+  has_discardable_images_metadata_ = true;
+  if (settings_.use_cached_picture && !picture_->willPlayBackBitmaps())
+    return;
+
+  DiscardableImageMap::ScopedMetadataGenerator generator(
+      &image_map_, bounds.size(), previous_list.image_map_, invalidated_rect);
+  Raster(generator.canvas(), nullptr,
+         gfx::IntersectRects(invalidated_rect, bounds), 1.f);
+}
+
 void DisplayItemList::GetDiscardableImagesInRect(
     const gfx::Rect& rect,
     float raster_scale,
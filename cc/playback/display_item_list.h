@@ -103,6 +103,13 @@ class CC_EXPORT DisplayItemList
   void EmitTraceSnapshot() const;
 
   void GenerateDiscardableImagesMetadata();
+  // Like GenerateDiscardableImagesMetadata(), but only rasters the part of the
+  // list in |invalidated_rect| and reuses the metadata of |previous_list| for
+  // the rest. |previous_list| must have recorded the same contents outside of
+  // |invalidated_rect|.
+  void GenerateDiscardableImagesMetadataFromPrevious(
+      const DisplayItemList& previous_list,
+      const gfx::Rect& invalidated_rect);
   void GetDiscardableImagesInRect(const gfx::Rect& rect,
                                   float raster_scale,
                                   std::vector<DrawImage>* images);
@@ -138,6 +145,7 @@ class CC_EXPORT DisplayItemList
   size_t picture_memory_usage_;
 
   DiscardableImageMap image_map_;
+  bool has_discardable_images_metadata_;
 
   friend class base::RefCountedThreadSafe<DisplayItemList>;
   FRIEND_TEST_ALL_PREFIXES(DisplayItemListTest, ApproximateMemoryUsage);
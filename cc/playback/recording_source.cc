@@ -7,6 +7,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <utility>
 
 #include "base/numerics/safe_math.h"
 #include "cc/base/region.h"
@@ -83,7 +84,7 @@ void RecordingSource::FromProtobuf(
   if (proto.has_display_list()) {
     display_list_ = DisplayItemList::CreateFromProto(
         proto.display_list(), image_serialization_processor);
-    FinishDisplayItemListUpdate();
+    FinishDisplayItemListUpdate(nullptr, Region());
   } else {
     display_list_ = nullptr;
   }
@@ -103,12 +104,20 @@ void RecordingSource::UpdateInvalidationForNewViewport(
   invalidation->Union(no_longer_exposed_region);
 }
 
-void RecordingSource::FinishDisplayItemListUpdate() {
+void RecordingSource::FinishDisplayItemListUpdate(
+    const DisplayItemList* previous_display_list,
+    const Region& invalidation) {
   TRACE_EVENT0("cc", "RecordingSource::FinishDisplayItemListUpdate");
   DetermineIfSolidColor();
   display_list_->EmitTraceSnapshot();
-  if (generate_discardable_images_metadata_)
-    display_list_->GenerateDiscardableImagesMetadata();
+  if (generate_discardable_images_metadata_) {
+    if (previous_display_list) {
+      display_list_->GenerateDiscardableImagesMetadataFromPrevious(
+          *previous_display_list, invalidation.bounds());
+    } else {
+      display_list_->GenerateDiscardableImagesMetadata();
+    }
+  }
 }
 
 void RecordingSource::SetNeedsDisplayRect(const gfx::Rect& layer_rect) {
@@ -170,12 +179,18 @@ bool RecordingSource::UpdateAndExpandInvalidation(
       NOTREACHED();
   }
 
+  // Only a normal recording draws the same contents as the previous one
+  // outside of the invalidation.
+  scoped_refptr<DisplayItemList> previous_display_list;
+  if (recording_mode == RECORD_NORMALLY)
+    previous_display_list = std::move(display_list_);
+
   // TODO(vmpstr): Add a slow_down_recording_scale_factor_for_debug_ to be able
   // to slow down recording.
   display_list_ = painter->PaintContentsToDisplayList(painting_control);
   painter_reported_memory_usage_ = painter->GetApproximateUnsharedMemoryUsage();
 
-  FinishDisplayItemListUpdate();
+  FinishDisplayItemListUpdate(previous_display_list.get(), *invalidation);
 
   return true;
 }
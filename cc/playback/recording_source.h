@@ -93,7 +93,12 @@ class CC_EXPORT RecordingSource {
   void UpdateInvalidationForNewViewport(const gfx::Rect& old_recorded_viewport,
                                         const gfx::Rect& new_recorded_viewport,
                                         Region* invalidation);
-  void FinishDisplayItemListUpdate();
+  // Finishes the update of |display_list_|. If |previous_display_list| is
+  // given, it recorded the same contents as |display_list_| outside of
+  // |invalidation|.
+  void FinishDisplayItemListUpdate(
+      const DisplayItemList* previous_display_list,
+      const Region& invalidation);
 
   friend class RasterSource;
 
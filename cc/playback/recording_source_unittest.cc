@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <vector>
 
 #include "base/memory/ptr_util.h"
@@ -361,6 +362,62 @@ TEST(RecordingSourceTest, DiscardableImages) {
   }
 }
 
+TEST(RecordingSourceTest, DiscardableImagesAfterPartialInvalidation) {
+  gfx::Rect recorded_viewport(0, 0, 256, 256);
+
+  std::unique_ptr<FakeRecordingSource> recording_source =
+      CreateRecordingSource(recorded_viewport);
+
+  sk_sp<SkImage> discardable_image[2][2];
+  discardable_image[0][0] = CreateDiscardableImage(gfx::Size(32, 32));
+  discardable_image[1][0] = CreateDiscardableImage(gfx::Size(32, 32));
+  discardable_image[1][1] = CreateDiscardableImage(gfx::Size(32, 32));
+
+  recording_source->add_draw_image(discardable_image[0][0], gfx::Point(0, 0));
+  recording_source->add_draw_image(discardable_image[1][0], gfx::Point(0, 130));
+  recording_source->add_draw_image(discardable_image[1][1],
+                                   gfx::Point(140, 140));
+  recording_source->SetGenerateDiscardableImagesMetadata(true);
+  recording_source->Rerecord();
+
+  // Replace the image in the bottom right cell, and only invalidate that cell.
+  sk_sp<SkImage> new_image = CreateDiscardableImage(gfx::Size(32, 32));
+  recording_source->reset_draws();
+  recording_source->add_draw_image(discardable_image[0][0], gfx::Point(0, 0));
+  recording_source->add_draw_image(discardable_image[1][0], gfx::Point(0, 130));
+  recording_source->add_draw_image(new_image, gfx::Point(140, 140));
+  recording_source->RerecordRect(gfx::Rect(128, 128, 128, 128));
+
+  scoped_refptr<RasterSource> raster_source =
+      CreateRasterSource(recording_source.get());
+
+  // The invalidated cell only has the new image.
+  {
+    std::vector<DrawImage> images;
+    raster_source->GetDiscardableImagesInRect(gfx::Rect(140, 140, 128, 128),
+                                              1.f, &images);
+    EXPECT_EQ(1u, images.size());
+    EXPECT_TRUE(images[0].image() == new_image);
+  }
+
+  // The other images are still found, and only once.
+  {
+    std::vector<DrawImage> images;
+    raster_source->GetDiscardableImagesInRect(gfx::Rect(0, 0, 256, 256), 1.f,
+                                              &images);
+    EXPECT_EQ(3u, images.size());
+    std::vector<const SkImage*> found_images;
+    for (const DrawImage& image : images)
+      found_images.push_back(image.image().get());
+    EXPECT_EQ(1, std::count(found_images.begin(), found_images.end(),
+                            discardable_image[0][0].get()));
+    EXPECT_EQ(1, std::count(found_images.begin(), found_images.end(),
+                            discardable_image[1][0].get()));
+    EXPECT_EQ(1, std::count(found_images.begin(), found_images.end(),
+                            new_image.get()));
+  }
+}
+
 TEST(RecordingSourceTest, DiscardableImagesBaseNonDiscardable) {
   gfx::Rect recorded_viewport(0, 0, 512, 512);
 
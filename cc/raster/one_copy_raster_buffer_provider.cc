@@ -35,11 +35,13 @@ OneCopyRasterBufferProvider::RasterBufferImpl::RasterBufferImpl(
     ResourceProvider* resource_provider,
     const Resource* resource,
     uint64_t previous_content_id,
-    bool async_worker_context_enabled)
+    bool async_worker_context_enabled,
+    bool resource_has_previous_content)
     : client_(client),
       resource_(resource),
       lock_(resource_provider, resource->id(), async_worker_context_enabled),
-      previous_content_id_(previous_content_id) {
+      previous_content_id_(previous_content_id),
+      resource_has_previous_content_(resource_has_previous_content) {
   client_->pending_raster_buffers_.insert(this);
 }
 
@@ -58,7 +60,7 @@ void OneCopyRasterBufferProvider::RasterBufferImpl::Playback(
   client_->PlaybackAndCopyOnWorkerThread(
       resource_, &lock_, sync_token_, raster_source, raster_full_rect,
       raster_dirty_rect, scale, playback_settings, previous_content_id_,
-      new_content_id);
+      new_content_id, resource_has_previous_content_);
 }
 
 OneCopyRasterBufferProvider::OneCopyRasterBufferProvider(
@@ -101,11 +103,11 @@ OneCopyRasterBufferProvider::AcquireBufferForRaster(
     const Resource* resource,
     uint64_t resource_content_id,
     uint64_t previous_content_id) {
-  // TODO(danakj): If resource_content_id != 0, we only need to copy/upload
-  // the dirty rect.
-  return base::WrapUnique(new RasterBufferImpl(this, resource_provider_,
-                                               resource, previous_content_id,
-                                               async_worker_context_enabled_));
+  bool resource_has_previous_content =
+      resource_content_id && resource_content_id == previous_content_id;
+  return base::WrapUnique(new RasterBufferImpl(
+      this, resource_provider_, resource, previous_content_id,
+      async_worker_context_enabled_, resource_has_previous_content));
 }
 
 void OneCopyRasterBufferProvider::ReleaseBufferForRaster(
@@ -164,7 +166,8 @@ void OneCopyRasterBufferProvider::PlaybackAndCopyOnWorkerThread(
     float scale,
     const RasterSource::PlaybackSettings& playback_settings,
     uint64_t previous_content_id,
-    uint64_t new_content_id) {
+    uint64_t new_content_id,
+    bool resource_has_previous_content) {
   std::unique_ptr<StagingBuffer> staging_buffer =
       staging_pool_.AcquireStagingBuffer(resource, previous_content_id);
 
@@ -173,8 +176,19 @@ void OneCopyRasterBufferProvider::PlaybackAndCopyOnWorkerThread(
                           playback_settings, previous_content_id,
                           new_content_id);
 
+  // The resource keeps its previous content outside of the dirty rect, so
+  // only the texels rastered for the dirty rect need to be copied into it.
+  gfx::Rect copy_rect(resource_lock->size());
+  if (resource_has_previous_content) {
+    gfx::Rect dirty_rect = raster_dirty_rect;
+    dirty_rect.Intersect(raster_full_rect);
+    dirty_rect.Offset(-raster_full_rect.OffsetFromOrigin());
+    copy_rect.Intersect(dirty_rect);
+  }
+
   CopyOnWorkerThread(staging_buffer.get(), resource_lock, sync_token,
-                     raster_source, previous_content_id, new_content_id);
+                     raster_source, copy_rect, previous_content_id,
+                     new_content_id);
 
   staging_pool_.ReleaseStagingBuffer(std::move(staging_buffer));
 }
@@ -235,6 +249,7 @@ void OneCopyRasterBufferProvider::CopyOnWorkerThread(
     ResourceProvider::ScopedWriteLockGL* resource_lock,
     const gpu::SyncToken& sync_token,
     const RasterSource* raster_source,
+    const gfx::Rect& copy_rect,
     uint64_t previous_content_id,
     uint64_t new_content_id) {
   ContextProvider::ScopedContextLock scoped_context(worker_context_provider_);
@@ -302,22 +317,24 @@ void OneCopyRasterBufferProvider::CopyOnWorkerThread(
     gl->CompressedCopyTextureCHROMIUM(staging_buffer->texture_id,
                                       resource_texture_id);
   } else {
+    DCHECK(!copy_rect.IsEmpty());
     int bytes_per_row = ResourceUtil::UncheckedWidthInBytes<int>(
-        resource_lock->size().width(), resource_lock->format());
+        copy_rect.width(), resource_lock->format());
     int chunk_size_in_rows =
         std::max(1, max_bytes_per_copy_operation_ / bytes_per_row);
     // Align chunk size to 4. Required to support compressed texture formats.
     chunk_size_in_rows = MathUtil::UncheckedRoundUp(chunk_size_in_rows, 4);
-    int y = 0;
-    int height = resource_lock->size().height();
-    while (y < height) {
+    int y = copy_rect.y();
+    int bottom = copy_rect.bottom();
+    while (y < bottom) {
       // Copy at most |chunk_size_in_rows|.
-      int rows_to_copy = std::min(chunk_size_in_rows, height - y);
+      int rows_to_copy = std::min(chunk_size_in_rows, bottom - y);
       DCHECK_GT(rows_to_copy, 0);
 
       gl->CopySubTextureCHROMIUM(
-          staging_buffer->texture_id, resource_texture_id, 0, y, 0, y,
-          resource_lock->size().width(), rows_to_copy, false, false, false);
+          staging_buffer->texture_id, resource_texture_id, copy_rect.x(), y,
+          copy_rect.x(), y, copy_rect.width(), rows_to_copy, false, false,
+          false);
       y += rows_to_copy;
 
       // Increment |bytes_scheduled_since_last_flush_| by the amount of memory
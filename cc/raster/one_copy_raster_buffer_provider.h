@@ -54,7 +54,8 @@ class CC_EXPORT OneCopyRasterBufferProvider : public RasterBufferProvider {
       float scale,
       const RasterSource::PlaybackSettings& playback_settings,
       uint64_t previous_content_id,
-      uint64_t new_content_id);
+      uint64_t new_content_id,
+      bool resource_has_previous_content);
 
  private:
   class RasterBufferImpl : public RasterBuffer {
@@ -63,7 +64,8 @@ class CC_EXPORT OneCopyRasterBufferProvider : public RasterBufferProvider {
                      ResourceProvider* resource_provider,
                      const Resource* resource,
                      uint64_t previous_content_id,
-                     bool async_worker_context_enabled);
+                     bool async_worker_context_enabled,
+                     bool resource_has_previous_content);
     ~RasterBufferImpl() override;
 
     // Overridden from RasterBuffer:
@@ -84,6 +86,7 @@ class CC_EXPORT OneCopyRasterBufferProvider : public RasterBufferProvider {
     const Resource* resource_;
     ResourceProvider::ScopedWriteLockGL lock_;
     uint64_t previous_content_id_;
+    bool resource_has_previous_content_;
 
     gpu::SyncToken sync_token_;
 
@@ -104,6 +107,7 @@ class CC_EXPORT OneCopyRasterBufferProvider : public RasterBufferProvider {
                           ResourceProvider::ScopedWriteLockGL* resource_lock,
                           const gpu::SyncToken& sync_token,
                           const RasterSource* raster_source,
+                          const gfx::Rect& copy_rect,
                           uint64_t previous_content_id,
                           uint64_t new_content_id);
 
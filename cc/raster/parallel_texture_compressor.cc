@@ -0,0 +1,151 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/parallel_texture_compressor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "cc/raster/task_category.h"
+
+namespace cc {
+
+namespace {
+
+// ETC1 packs each 4x4 block of texels into 8 bytes.
+const int kBytesPerBlock = 8;
+
+// Hands out the strips of a texture to the threads compressing it.
+class StripCompressor {
+ public:
+  StripCompressor(TextureCompressor* compressor,
+                  const uint8_t* src,
+                  uint8_t* dst,
+                  int width,
+                  int height,
+                  TextureCompressor::Quality quality)
+      : compressor_(compressor),
+        src_(src),
+        dst_(dst),
+        width_(width),
+        height_(height),
+        quality_(quality),
+        next_strip_(0) {}
+
+  static int NumStrips(int height) {
+    const int kStripHeight = ParallelTextureCompressor::kBlockRowsPerStrip * 4;
+    return (height + kStripHeight - 1) / kStripHeight;
+  }
+
+  // Compresses strips until every strip has been taken by some thread.
+  void CompressStrips() {
+    const int kStripHeight = ParallelTextureCompressor::kBlockRowsPerStrip * 4;
+    int num_strips = NumStrips(height_);
+    for (;;) {
+      int strip = base::subtle::NoBarrier_AtomicIncrement(&next_strip_, 1) - 1;
+      if (strip >= num_strips)
+        return;
+      int y = strip * kStripHeight;
+      int strip_height = std::min(kStripHeight, height_ - y);
+      compressor_->Compress(src_ + y * width_ * 4,
+                            dst_ + (y / 4) * (width_ / 4) * kBytesPerBlock,
+                            width_, strip_height, quality_);
+    }
+  }
+
+ private:
+  TextureCompressor* const compressor_;
+  const uint8_t* const src_;
+  uint8_t* const dst_;
+  const int width_;
+  const int height_;
+  const TextureCompressor::Quality quality_;
+  base::subtle::Atomic32 next_strip_;
+
+  DISALLOW_COPY_AND_ASSIGN(StripCompressor);
+};
+
+class CompressStripsTask : public Task {
+ public:
+  explicit CompressStripsTask(StripCompressor* strip_compressor)
+      : strip_compressor_(strip_compressor) {}
+
+  // Overridden from Task:
+  void RunOnWorkerThread() override {
+    TRACE_EVENT0("cc", "CompressStripsTask::RunOnWorkerThread");
+    strip_compressor_->CompressStrips();
+  }
+
+ private:
+  ~CompressStripsTask() override {}
+
+  StripCompressor* const strip_compressor_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompressStripsTask);
+};
+
+}  // namespace
+
+ParallelTextureCompressor::ParallelTextureCompressor(
+    std::unique_ptr<TextureCompressor> compressor,
+    TaskGraphRunner* task_graph_runner,
+    size_t max_tasks)
+    : compressor_(std::move(compressor)),
+      task_graph_runner_(task_graph_runner),
+      max_tasks_(max_tasks),
+      namespace_token_(task_graph_runner->GetNamespaceToken()) {}
+
+ParallelTextureCompressor::~ParallelTextureCompressor() {}
+
+void ParallelTextureCompressor::Compress(const uint8_t* src,
+                                         uint8_t* dst,
+                                         int width,
+                                         int height,
+                                         Quality quality) {
+  DCHECK_GE(width, 4);
+  DCHECK_EQ((width & 3), 0);
+  DCHECK_GE(height, 4);
+  DCHECK_EQ((height & 3), 0);
+  TRACE_EVENT2("cc", "ParallelTextureCompressor::Compress", "width", width,
+               "height", height);
+
+  StripCompressor strip_compressor(compressor_.get(), src, dst, width, height,
+                                   quality);
+
+  // The calling thread compresses a strip too, so there is no use for more
+  // tasks than the other strips.
+  size_t num_tasks =
+      std::min(max_tasks_,
+               static_cast<size_t>(StripCompressor::NumStrips(height) - 1));
+  if (!num_tasks) {
+    strip_compressor.CompressStrips();
+    return;
+  }
+
+  Task::Vector tasks;
+  TaskGraph graph;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    tasks.push_back(
+        make_scoped_refptr(new CompressStripsTask(&strip_compressor)));
+    graph.nodes.push_back(
+        TaskGraph::Node(tasks.back().get(), TASK_CATEGORY_FOREGROUND, 0u, 0u));
+  }
+  task_graph_runner_->ScheduleTasks(namespace_token_, &graph);
+
+  strip_compressor.CompressStrips();
+
+  // Every strip has been taken by now. Cancel the tasks which have not started
+  // yet, and wait for the others to finish the strips they took.
+  TaskGraph empty_graph;
+  task_graph_runner_->ScheduleTasks(namespace_token_, &empty_graph);
+  task_graph_runner_->WaitForTasksToFinishRunning(namespace_token_);
+  Task::Vector completed_tasks;
+  task_graph_runner_->CollectCompletedTasks(namespace_token_,
+                                            &completed_tasks);
+}
+
+}  // namespace cc
@@ -0,0 +1,57 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RASTER_PARALLEL_TEXTURE_COMPRESSOR_H_
+#define CC_RASTER_PARALLEL_TEXTURE_COMPRESSOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "cc/base/cc_export.h"
+#include "cc/raster/task_graph_runner.h"
+#include "cc/raster/texture_compressor.h"
+
+namespace cc {
+
+// Compresses a texture on up to |max_tasks| workers of a TaskGraphRunner and
+// the calling thread at once. The texture is split into strips of block rows,
+// and each thread compresses the next strip nobody has taken yet, so the
+// calling thread never waits for a busy worker to pick up a task. The output
+// is identical to that of the wrapped compressor.
+//
+// Compress() must not be called on a worker of |task_graph_runner|.
+class CC_EXPORT ParallelTextureCompressor : public TextureCompressor {
+ public:
+  // Number of 4x4 block rows compressed by a thread at a time.
+  static const int kBlockRowsPerStrip = 8;
+
+  // |compressor| is called on several threads at once, for different strips.
+  // The compressors returned by TextureCompressor::Create() have no state, so
+  // that is safe for them.
+  ParallelTextureCompressor(std::unique_ptr<TextureCompressor> compressor,
+                            TaskGraphRunner* task_graph_runner,
+                            size_t max_tasks);
+  ~ParallelTextureCompressor() override;
+
+  void Compress(const uint8_t* src,
+                uint8_t* dst,
+                int width,
+                int height,
+                Quality quality) override;
+
+ private:
+  std::unique_ptr<TextureCompressor> compressor_;
+  TaskGraphRunner* const task_graph_runner_;
+  const size_t max_tasks_;
+  const NamespaceToken namespace_token_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelTextureCompressor);
+};
+
+}  // namespace cc
+
+#endif  // CC_RASTER_PARALLEL_TEXTURE_COMPRESSOR_H_
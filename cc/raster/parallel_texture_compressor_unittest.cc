@@ -0,0 +1,63 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/parallel_texture_compressor.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "base/threading/simple_thread.h"
+#include "cc/raster/work_stealing_task_graph_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+void CompressAndCompare(TaskGraphRunner* task_graph_runner,
+                        size_t max_tasks,
+                        int width,
+                        int height) {
+  std::vector<uint8_t> src(width * height * 4);
+  srand(width * height);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = rand() % 256;  // NOLINT
+
+  std::vector<uint8_t> expected(width * height / 2);
+  TextureCompressor::Create(TextureCompressor::kFormatETC1)
+      ->Compress(src.data(), expected.data(), width, height,
+                 TextureCompressor::kQualityHigh);
+
+  ParallelTextureCompressor compressor(
+      TextureCompressor::Create(TextureCompressor::kFormatETC1),
+      task_graph_runner, max_tasks);
+  std::vector<uint8_t> dst(width * height / 2);
+  compressor.Compress(src.data(), dst.data(), width, height,
+                      TextureCompressor::kQualityHigh);
+
+  EXPECT_TRUE(expected == dst) << width << "x" << height << " with "
+                               << max_tasks << " tasks";
+}
+
+TEST(ParallelTextureCompressorTest, MatchesSerialCompression) {
+  WorkStealingTaskGraphRunner task_graph_runner(
+      WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks);
+  task_graph_runner.Start(3, "ParallelTextureCompressorTest",
+                          base::SimpleThread::Options());
+
+  const int kStripHeight = ParallelTextureCompressor::kBlockRowsPerStrip * 4;
+  for (size_t max_tasks = 0; max_tasks < 4; ++max_tasks) {
+    // A single strip, whole strips and a partial last strip.
+    CompressAndCompare(&task_graph_runner, max_tasks, 16, 4);
+    CompressAndCompare(&task_graph_runner, max_tasks, 64, kStripHeight * 4);
+    CompressAndCompare(&task_graph_runner, max_tasks, 256,
+                       kStripHeight * 5 + 12);
+  }
+
+  task_graph_runner.Shutdown();
+}
+
+}  // namespace
+}  // namespace cc
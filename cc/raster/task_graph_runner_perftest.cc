@@ -10,10 +10,14 @@
 
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "cc/base/completion_event.h"
 #include "cc/debug/lap_timer.h"
+#include "cc/raster/single_thread_task_graph_runner.h"
 #include "cc/raster/synchronous_task_graph_runner.h"
+#include "cc/raster/work_stealing_task_graph_runner.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
 
@@ -217,6 +221,64 @@ class TaskGraphRunnerPerfTest : public testing::Test {
                            true);
   }
 
+  // Same as RunScheduleAndExecuteTasksTest(), but with tasks run on the
+  // worker threads of |task_graph_runner|.
+  void RunScheduleAndExecuteTasksOnWorkersTest(
+      const std::string& test_name,
+      TaskGraphRunner* task_graph_runner,
+      int num_top_level_tasks,
+      int num_tasks,
+      int num_leaf_tasks) {
+    NamespaceToken namespace_token = task_graph_runner->GetNamespaceToken();
+    PerfTaskImpl::Vector top_level_tasks;
+    PerfTaskImpl::Vector tasks;
+    PerfTaskImpl::Vector leaf_tasks;
+    CreateTasks(num_top_level_tasks, &top_level_tasks);
+    CreateTasks(num_tasks, &tasks);
+    CreateTasks(num_leaf_tasks, &leaf_tasks);
+
+    // Avoid unnecessary heap allocations by reusing the same graph and
+    // completed tasks vector.
+    TaskGraph graph;
+    Task::Vector completed_tasks;
+
+    timer_.Reset();
+    do {
+      graph.Reset();
+      ResetTasks(top_level_tasks);
+      ResetTasks(tasks);
+      ResetTasks(leaf_tasks);
+      BuildTaskGraph(top_level_tasks, tasks, leaf_tasks, &graph);
+      task_graph_runner->ScheduleTasks(namespace_token, &graph);
+      task_graph_runner->WaitForTasksToFinishRunning(namespace_token);
+      task_graph_runner->CollectCompletedTasks(namespace_token,
+                                               &completed_tasks);
+      completed_tasks.clear();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult("execute_tasks_on_workers",
+                           TestModifierString(),
+                           test_name,
+                           timer_.LapsPerSecond(),
+                           "runs/s",
+                           true);
+  }
+
+  // Runs RunScheduleAndExecuteTasksOnWorkersTest() for a few graphs.
+  void RunScheduleAndExecuteTasksOnWorkersTests(
+      const std::string& runner_name,
+      TaskGraphRunner* task_graph_runner) {
+    RunScheduleAndExecuteTasksOnWorkersTest(runner_name + "_0_32_0",
+                                            task_graph_runner, 0, 32, 0);
+    RunScheduleAndExecuteTasksOnWorkersTest(runner_name + "_0_256_0",
+                                            task_graph_runner, 0, 256, 0);
+    RunScheduleAndExecuteTasksOnWorkersTest(runner_name + "_2_32_1",
+                                            task_graph_runner, 2, 32, 1);
+    RunScheduleAndExecuteTasksOnWorkersTest(runner_name + "_2_256_1",
+                                            task_graph_runner, 2, 256, 1);
+  }
+
  private:
   static std::string TestModifierString() {
     return std::string("_task_graph_runner");
@@ -326,5 +388,29 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
 }
 
+// Compares a single worker thread with 4 work stealing ones, claiming tasks one
+// at a time as when all workers share one queue, or a few at a time.
+TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasksOnWorkers) {
+  SingleThreadTaskGraphRunner single_thread_task_graph_runner;
+  single_thread_task_graph_runner.Start("PerfTestWorker",
+                                        base::SimpleThread::Options());
+  RunScheduleAndExecuteTasksOnWorkersTests("single_thread",
+                                           &single_thread_task_graph_runner);
+  single_thread_task_graph_runner.Shutdown();
+
+  const size_t kMaxClaimedTasks[] = {
+      1, WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks};
+  for (size_t max_claimed_tasks : kMaxClaimedTasks) {
+    WorkStealingTaskGraphRunner work_stealing_task_graph_runner(
+        max_claimed_tasks);
+    work_stealing_task_graph_runner.Start(4, "PerfTestWorker",
+                                          base::SimpleThread::Options());
+    RunScheduleAndExecuteTasksOnWorkersTests(
+        "work_stealing_4_threads_claim_" + base::SizeTToString(max_claimed_tasks),
+        &work_stealing_task_graph_runner);
+    work_stealing_task_graph_runner.Shutdown();
+  }
+}
+
 }  // namespace
 }  // namespace cc
@@ -6,11 +6,14 @@
 
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "build/build_config.h"
 #include "cc/raster/texture_compressor_etc1.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
 #include "base/cpu.h"
 #include "cc/raster/texture_compressor_etc1_sse.h"
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+#include "cc/raster/texture_compressor_etc1_neon.h"
 #endif
 
 namespace cc {
@@ -23,6 +26,8 @@ std::unique_ptr<TextureCompressor> TextureCompressor::Create(Format format) {
       if (cpu.has_sse2()) {
         return base::WrapUnique(new TextureCompressorETC1SSE());
       }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+      return base::WrapUnique(new TextureCompressorETC1NEON());
 #endif
       return base::WrapUnique(new TextureCompressorETC1());
     }
@@ -0,0 +1,376 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/texture_compressor_etc1_neon.h"
+
+#include <arm_neon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+// Using this header for common functions such as Color handling
+// and codeword table.
+#include "cc/raster/texture_compressor_etc1.h"
+
+namespace cc {
+
+namespace {
+
+// The channels of the 8 texels of a sub block, in the natural array order
+// described in texture_compressor_etc1.h.
+struct SubBlock {
+  int16x8_t blue;
+  int16x8_t green;
+  int16x8_t red;
+};
+
+inline int16x8_t Widen(uint8x8_t x) {
+  return vreinterpretq_s16_u16(vmovl_u8(x));
+}
+
+inline uint32_t Sum(uint32x4_t x) {
+  uint32x2_t sum = vadd_u32(vget_low_u32(x), vget_high_u32(x));
+  return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+inline uint32_t SumChannel(int16x8_t x) {
+  return Sum(vreinterpretq_u32_s32(vpaddlq_s16(x)));
+}
+
+// Constructs a color from a given base color and luminance value.
+inline Color MakeColor(const Color& base, int16_t lum) {
+  int b = static_cast<int>(base.channels.b) + lum;
+  int g = static_cast<int>(base.channels.g) + lum;
+  int r = static_cast<int>(base.channels.r) + lum;
+  Color color;
+  color.channels.b = static_cast<uint8_t>(clamp(b, 0, 255));
+  color.channels.g = static_cast<uint8_t>(clamp(g, 0, 255));
+  color.channels.r = static_cast<uint8_t>(clamp(r, 0, 255));
+  return color;
+}
+
+// Computes the error metric of each texel of |src| against |color|, for
+// texels 0-3 in |low| and texels 4-7 in |high|.
+inline void GetColorErrors(const SubBlock& src,
+                           const Color& color,
+                           uint32x4_t* low,
+                           uint32x4_t* high) {
+  int16x8_t delta_b = vsubq_s16(src.blue, vdupq_n_s16(color.channels.b));
+  int16x8_t delta_g = vsubq_s16(src.green, vdupq_n_s16(color.channels.g));
+  int16x8_t delta_r = vsubq_s16(src.red, vdupq_n_s16(color.channels.r));
+
+  int32x4_t error = vmull_s16(vget_low_s16(delta_b), vget_low_s16(delta_b));
+  error = vmlal_s16(error, vget_low_s16(delta_g), vget_low_s16(delta_g));
+  error = vmlal_s16(error, vget_low_s16(delta_r), vget_low_s16(delta_r));
+  *low = vreinterpretq_u32_s32(error);
+
+  error = vmull_s16(vget_high_s16(delta_b), vget_high_s16(delta_b));
+  error = vmlal_s16(error, vget_high_s16(delta_g), vget_high_s16(delta_g));
+  error = vmlal_s16(error, vget_high_s16(delta_r), vget_high_s16(delta_r));
+  *high = vreinterpretq_u32_s32(error);
+}
+
+inline uint32_t GetSubBlockError(const SubBlock& src, const Color& color) {
+  uint32x4_t low, high;
+  GetColorErrors(src, color, &low, &high);
+  return Sum(vaddq_u32(low, high));
+}
+
+void GetAverageColor(const SubBlock& src, float* avg_color) {
+  const float kInv8 = 1.0f / 8.0f;
+  avg_color[0] = static_cast<float>(SumChannel(src.blue)) * kInv8;
+  avg_color[1] = static_cast<float>(SumChannel(src.green)) * kInv8;
+  avg_color[2] = static_cast<float>(SumChannel(src.red)) * kInv8;
+}
+
+void ComputeLuminance(uint8_t* block,
+                      const SubBlock& src,
+                      const Color& base,
+                      int sub_block_id,
+                      const uint8_t* idx_to_num_tab) {
+  uint32_t best_tbl_err = std::numeric_limits<uint32_t>::max();
+  uint8_t best_tbl_idx = 0;
+  ALIGNAS(16) uint32_t best_mod_idx[8];  // [texel]
+
+  // Try all codeword tables to find the one giving the best results for this
+  // block. All 8 texels are matched against each modifier at once.
+  for (unsigned int tbl_idx = 0; tbl_idx < 8; ++tbl_idx) {
+    // The smallest error of each texel so far and the modifier giving it.
+    uint32x4_t min_err_low = vdupq_n_u32(std::numeric_limits<uint32_t>::max());
+    uint32x4_t min_err_high = min_err_low;
+    uint32x4_t mod_idx_low = vdupq_n_u32(0);
+    uint32x4_t mod_idx_high = mod_idx_low;
+
+    for (unsigned int mod_idx = 0; mod_idx < 4; ++mod_idx) {
+      int16_t lum = g_codeword_tables[tbl_idx][mod_idx];
+      uint32x4_t err_low, err_high;
+      GetColorErrors(src, MakeColor(base, lum), &err_low, &err_high);
+
+      // Like the scalar version, only switch to a later modifier when it is
+      // strictly better.
+      uint32x4_t better_low = vcltq_u32(err_low, min_err_low);
+      uint32x4_t better_high = vcltq_u32(err_high, min_err_high);
+      min_err_low = vminq_u32(err_low, min_err_low);
+      min_err_high = vminq_u32(err_high, min_err_high);
+      mod_idx_low = vbslq_u32(better_low, vdupq_n_u32(mod_idx), mod_idx_low);
+      mod_idx_high =
+          vbslq_u32(better_high, vdupq_n_u32(mod_idx), mod_idx_high);
+    }
+
+    uint32_t tbl_err = Sum(vaddq_u32(min_err_low, min_err_high));
+    if (tbl_err < best_tbl_err) {
+      best_tbl_err = tbl_err;
+      best_tbl_idx = tbl_idx;
+      vst1q_u32(best_mod_idx, mod_idx_low);
+      vst1q_u32(best_mod_idx + 4, mod_idx_high);
+
+      if (tbl_err == 0)
+        break;  // We cannot do any better than this.
+    }
+  }
+
+  WriteCodewordTable(block, sub_block_id, best_tbl_idx);
+
+  uint32_t pix_data = 0;
+
+  for (unsigned int i = 0; i < 8; ++i) {
+    uint8_t pix_idx = g_mod_to_pix[best_mod_idx[i]];
+
+    uint32_t lsb = pix_idx & 0x1;
+    uint32_t msb = pix_idx >> 1;
+
+    // Obtain the texel number as specified in the standard.
+    int texel_num = idx_to_num_tab[i];
+    pix_data |= msb << (texel_num + 16);
+    pix_data |= lsb << (texel_num);
+  }
+
+  WritePixelData(block, pix_data);
+}
+
+void CompressSolid(uint8_t* dst, const uint8_t* block) {
+  // Clear destination buffer so that we can "or" in the results.
+  memset(dst, 0, 8);
+
+  const float src_color_float[3] = {static_cast<float>(block[0]),
+                                    static_cast<float>(block[1]),
+                                    static_cast<float>(block[2])};
+  const Color base = MakeColor555(src_color_float);
+
+  WriteDiff(dst, true);
+  WriteFlip(dst, false);
+  WriteColors555(dst, base, base);
+
+  const int16x4_t zero = vdup_n_s16(0);
+  const int16x4_t color_max = vdup_n_s16(255);
+  const int16x4_t base_blue = vdup_n_s16(base.channels.b);
+  const int16x4_t base_green = vdup_n_s16(base.channels.g);
+  const int16x4_t base_red = vdup_n_s16(base.channels.r);
+  const int16x4_t src_blue = vdup_n_s16(block[0]);
+  const int16x4_t src_green = vdup_n_s16(block[1]);
+  const int16x4_t src_red = vdup_n_s16(block[2]);
+
+  uint8_t best_tbl_idx = 0;
+  uint8_t best_mod_idx = 0;
+  uint32_t best_mod_err = std::numeric_limits<uint32_t>::max();
+
+  for (unsigned int tbl_idx = 0; tbl_idx < 8; ++tbl_idx) {
+    // Compute the error of all four modifiers in the table at once.
+    int16x4_t lum = vld1_s16(g_codeword_tables[tbl_idx]);
+    int16x4_t delta_b = vsub_s16(
+        vmin_s16(vmax_s16(vadd_s16(base_blue, lum), zero), color_max),
+        src_blue);
+    int16x4_t delta_g = vsub_s16(
+        vmin_s16(vmax_s16(vadd_s16(base_green, lum), zero), color_max),
+        src_green);
+    int16x4_t delta_r = vsub_s16(
+        vmin_s16(vmax_s16(vadd_s16(base_red, lum), zero), color_max),
+        src_red);
+    int32x4_t error = vmull_s16(delta_b, delta_b);
+    error = vmlal_s16(error, delta_g, delta_g);
+    error = vmlal_s16(error, delta_r, delta_r);
+
+    ALIGNAS(16) uint32_t mod_err[4];
+    vst1q_u32(mod_err, vreinterpretq_u32_s32(error));
+    for (unsigned int mod_idx = 0; mod_idx < 4; ++mod_idx) {
+      if (mod_err[mod_idx] < best_mod_err) {
+        best_tbl_idx = tbl_idx;
+        best_mod_idx = mod_idx;
+        best_mod_err = mod_err[mod_idx];
+
+        if (best_mod_err == 0)
+          break;  // We cannot do any better than this.
+      }
+    }
+
+    if (best_mod_err == 0)
+      break;
+  }
+
+  WriteCodewordTable(dst, 0, best_tbl_idx);
+  WriteCodewordTable(dst, 1, best_tbl_idx);
+
+  uint8_t pix_idx = g_mod_to_pix[best_mod_idx];
+  uint32_t lsb = pix_idx & 0x1;
+  uint32_t msb = pix_idx >> 1;
+
+  uint32_t pix_data = 0;
+  for (unsigned int i = 0; i < 2; ++i) {
+    for (unsigned int j = 0; j < 8; ++j) {
+      // Obtain the texel number as specified in the standard.
+      int texel_num = g_idx_to_num[i][j];
+      pix_data |= msb << (texel_num + 16);
+      pix_data |= lsb << (texel_num);
+    }
+  }
+
+  WritePixelData(dst, pix_data);
+}
+
+// |sub_block_src| holds vertical block 0 and 1 followed by horizontal block 0
+// and 1.
+void CompressBlock(uint8_t* dst, const SubBlock* sub_block_src) {
+  Color sub_block_avg[4];
+  bool use_differential[2] = {true, true};
+
+  // Compute the average color for each sub block and determine if differential
+  // coding can be used.
+  for (unsigned int i = 0, j = 1; i < 4; i += 2, j += 2) {
+    float avg_color_0[3];
+    GetAverageColor(sub_block_src[i], avg_color_0);
+    Color avg_color_555_0 = MakeColor555(avg_color_0);
+
+    float avg_color_1[3];
+    GetAverageColor(sub_block_src[j], avg_color_1);
+    Color avg_color_555_1 = MakeColor555(avg_color_1);
+
+    for (unsigned int light_idx = 0; light_idx < 3; ++light_idx) {
+      int u = avg_color_555_0.components[light_idx] >> 3;
+      int v = avg_color_555_1.components[light_idx] >> 3;
+
+      int component_diff = v - u;
+      if (component_diff < -4 || component_diff > 3) {
+        use_differential[i / 2] = false;
+        sub_block_avg[i] = MakeColor444(avg_color_0);
+        sub_block_avg[j] = MakeColor444(avg_color_1);
+      } else {
+        sub_block_avg[i] = avg_color_555_0;
+        sub_block_avg[j] = avg_color_555_1;
+      }
+    }
+  }
+
+  // Compute the error of each sub block before adjusting for luminance. These
+  // error values are later used for determining if we should flip the sub
+  // block or not.
+  uint32_t sub_block_err[4];
+  for (unsigned int i = 0; i < 4; ++i)
+    sub_block_err[i] = GetSubBlockError(sub_block_src[i], sub_block_avg[i]);
+
+  bool flip =
+      sub_block_err[2] + sub_block_err[3] < sub_block_err[0] + sub_block_err[1];
+
+  // Clear destination buffer so that we can "or" in the results.
+  memset(dst, 0, 8);
+
+  WriteDiff(dst, use_differential[!!flip]);
+  WriteFlip(dst, flip);
+
+  uint8_t sub_block_off_0 = flip ? 2 : 0;
+  uint8_t sub_block_off_1 = sub_block_off_0 + 1;
+
+  if (use_differential[!!flip]) {
+    WriteColors555(dst, sub_block_avg[sub_block_off_0],
+                   sub_block_avg[sub_block_off_1]);
+  } else {
+    WriteColors444(dst, sub_block_avg[sub_block_off_0],
+                   sub_block_avg[sub_block_off_1]);
+  }
+
+  // Compute luminance for the first sub block.
+  ComputeLuminance(dst, sub_block_src[sub_block_off_0],
+                   sub_block_avg[sub_block_off_0], 0,
+                   g_idx_to_num[sub_block_off_0]);
+  // Compute luminance for the second sub block.
+  ComputeLuminance(dst, sub_block_src[sub_block_off_1],
+                   sub_block_avg[sub_block_off_1], 1,
+                   g_idx_to_num[sub_block_off_1]);
+}
+
+void ExtractBlock(uint8_t* dst, const uint8_t* src, int width) {
+  for (int j = 0; j < 4; ++j) {
+    memcpy(&dst[j * 4 * 4], src, 4 * 4);
+    src += width * 4;
+  }
+}
+
+inline bool IsSolidBlock(const uint8_t* block) {
+  const uint32_t* texels = reinterpret_cast<const uint32_t*>(block);
+  const uint32x4_t first = vdupq_n_u32(texels[0]);
+  uint32x4_t equal = vceqq_u32(vld1q_u32(texels), first);
+  for (int i = 4; i < 16; i += 4)
+    equal = vandq_u32(equal, vceqq_u32(vld1q_u32(texels + i), first));
+
+  uint32x2_t min = vmin_u32(vget_low_u32(equal), vget_high_u32(equal));
+  return vget_lane_u32(vpmin_u32(min, min), 0) != 0;
+}
+
+// Splits one channel of the 16 texels of a block, in row-major order, into
+// the sub blocks in the order expected by CompressBlock().
+inline void SplitChannel(uint8x16_t texels,
+                         int16x8_t* vertical0,
+                         int16x8_t* vertical1,
+                         int16x8_t* horizontal0,
+                         int16x8_t* horizontal1) {
+  // Separate the pairs of texels in the left half of each row from those in
+  // the right half.
+  uint16x4x2_t halves = vuzp_u16(vreinterpret_u16_u8(vget_low_u8(texels)),
+                                 vreinterpret_u16_u8(vget_high_u8(texels)));
+  *vertical0 = Widen(vreinterpret_u8_u16(halves.val[0]));
+  *vertical1 = Widen(vreinterpret_u8_u16(halves.val[1]));
+  *horizontal0 = Widen(vget_low_u8(texels));
+  *horizontal1 = Widen(vget_high_u8(texels));
+}
+
+}  // namespace
+
+void TextureCompressorETC1NEON::Compress(const uint8_t* src,
+                                         uint8_t* dst,
+                                         int width,
+                                         int height,
+                                         Quality quality) {
+  DCHECK_GE(width, 4);
+  DCHECK_EQ((width & 3), 0);
+  DCHECK_GE(height, 4);
+  DCHECK_EQ((height & 3), 0);
+
+  ALIGNAS(16) uint8_t block[64];
+  SubBlock sub_blocks[4];
+
+  for (int y = 0; y < height; y += 4, src += width * 4 * 4) {
+    for (int x = 0; x < width; x += 4, dst += 8) {
+      ExtractBlock(block, src + x * 4, width);
+      if (IsSolidBlock(block)) {
+        CompressSolid(dst, block);
+        continue;
+      }
+
+      // De-interleave the BGRA texels into one register per channel.
+      uint8x16x4_t texels = vld4q_u8(block);
+      SplitChannel(texels.val[0], &sub_blocks[0].blue, &sub_blocks[1].blue,
+                   &sub_blocks[2].blue, &sub_blocks[3].blue);
+      SplitChannel(texels.val[1], &sub_blocks[0].green, &sub_blocks[1].green,
+                   &sub_blocks[2].green, &sub_blocks[3].green);
+      SplitChannel(texels.val[2], &sub_blocks[0].red, &sub_blocks[1].red,
+                   &sub_blocks[2].red, &sub_blocks[3].red);
+
+      CompressBlock(dst, sub_blocks);
+    }
+  }
+}
+
+}  // namespace cc
@@ -4,9 +4,15 @@
 
 #include <stdint.h>
 
+#include <utility>
+
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/threading/simple_thread.h"
 #include "cc/debug/lap_timer.h"
+#include "cc/raster/parallel_texture_compressor.h"
 #include "cc/raster/texture_compressor.h"
+#include "cc/raster/work_stealing_task_graph_runner.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
 
@@ -22,6 +28,10 @@ const int kImageHeight = 256;
 const int kImageChannels = 4;
 const int kImageSizeInBytes = kImageWidth * kImageHeight * kImageChannels;
 
+// Worker threads used by the parallel compressor, which also compresses on the
+// calling thread.
+const int kNumWorkerThreads = 3;
+
 std::string FormatName(TextureCompressor::Format format) {
   switch (format) {
     case TextureCompressor::kFormatETC1:
@@ -49,16 +59,31 @@ std::string QualityName(TextureCompressor::Quality quality) {
 class TextureCompressorPerfTest
     : public testing::TestWithParam<
           ::testing::tuple<TextureCompressor::Quality,
-                           TextureCompressor::Format>> {
+                           TextureCompressor::Format,
+                           bool>> {
  public:
   TextureCompressorPerfTest()
       : timer_(kWarmupRuns,
                base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
-               kTimeCheckInterval) {}
+               kTimeCheckInterval),
+        task_graph_runner_(
+            WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks) {}
 
   void SetUp() override {
     TextureCompressor::Format format = ::testing::get<1>(GetParam());
     compressor_ = TextureCompressor::Create(format);
+    if (::testing::get<2>(GetParam())) {
+      task_graph_runner_.Start(kNumWorkerThreads, "TextureCompressorPerfTest",
+                               base::SimpleThread::Options());
+      compressor_ = base::WrapUnique(new ParallelTextureCompressor(
+          std::move(compressor_), &task_graph_runner_, kNumWorkerThreads));
+    }
+  }
+
+  void TearDown() override {
+    compressor_ = nullptr;
+    if (::testing::get<2>(GetParam()))
+      task_graph_runner_.Shutdown();
   }
 
   void RunTest(const std::string& name) {
@@ -71,12 +96,15 @@ class TextureCompressorPerfTest
 
     TextureCompressor::Format format = ::testing::get<1>(GetParam());
     std::string str = FormatName(format) + " " + QualityName(quality);
+    if (::testing::get<2>(GetParam()))
+      str += " Parallel";
     perf_test::PrintResult("Compress256x256", name, str, timer_.MsPerLap(),
                            "us", true);
   }
 
  protected:
   LapTimer timer_;
+  WorkStealingTaskGraphRunner task_graph_runner_;
   std::unique_ptr<TextureCompressor> compressor_;
   uint8_t src_[kImageSizeInBytes];
   uint8_t dst_[kImageSizeInBytes];
@@ -117,7 +145,8 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::Values(TextureCompressor::kQualityLow,
                                          TextureCompressor::kQualityMedium,
                                          TextureCompressor::kQualityHigh),
-                       ::testing::Values(TextureCompressor::kFormatETC1)));
+                       ::testing::Values(TextureCompressor::kFormatETC1),
+                       ::testing::Bool()));
 
 }  // namespace
 }  // namespace cc
@@ -0,0 +1,369 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/work_stealing_task_graph_runner.h"
+
+#include <deque>
+#include <utility>
+
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/trace_event/trace_event.h"
+
+namespace cc {
+namespace {
+
+// Categories in the order their tasks are claimed.
+const TaskCategory kCategories[] = {
+    TASK_CATEGORY_NONCONCURRENT_FOREGROUND, TASK_CATEGORY_FOREGROUND,
+    TASK_CATEGORY_BACKGROUND,
+};
+
+}  // namespace
+
+// A thread which forwards to WorkStealingTaskGraphRunner::Run.
+class WorkStealingTaskGraphRunner::WorkerThread : public base::SimpleThread {
+ public:
+  WorkerThread(const std::string& name,
+               const Options& options,
+               WorkStealingTaskGraphRunner* runner,
+               size_t worker_index)
+      : SimpleThread(name, options),
+        runner_(runner),
+        worker_index_(worker_index) {}
+
+  void Run() override { runner_->Run(worker_index_); }
+
+ private:
+  WorkStealingTaskGraphRunner* const runner_;
+  const size_t worker_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerThread);
+};
+
+struct WorkStealingTaskGraphRunner::Worker {
+  // Protects |claimed_tasks|, which other workers steal from.
+  base::Lock lock;
+
+  // Tasks claimed from |work_queue_| which haven't started running, in the
+  // order they were claimed.
+  std::deque<TaskGraphWorkQueue::PrioritizedTask> claimed_tasks;
+
+  // Tasks run by this worker but not yet reported to |work_queue_|. Only used
+  // on the worker's thread.
+  TaskGraphWorkQueue::PrioritizedTask::Vector completed_tasks;
+};
+
+const size_t WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks;
+
+WorkStealingTaskGraphRunner::WorkStealingTaskGraphRunner(
+    size_t max_claimed_tasks)
+    : max_claimed_tasks_(max_claimed_tasks),
+      num_claimed_tasks_(0),
+      has_ready_to_run_tasks_cv_(&lock_),
+      has_namespaces_with_finished_running_tasks_cv_(&lock_),
+      num_idle_workers_(0),
+      shutdown_(false) {
+  DCHECK_LT(0u, max_claimed_tasks_);
+}
+
+WorkStealingTaskGraphRunner::~WorkStealingTaskGraphRunner() {
+  DCHECK(threads_.empty());
+}
+
+void WorkStealingTaskGraphRunner::Start(
+    int num_threads,
+    const std::string& thread_name_prefix,
+    const base::SimpleThread::Options& thread_options) {
+  DCHECK(threads_.empty());
+  DCHECK_LT(0, num_threads);
+
+  // Create every worker before starting any thread, as workers look at each
+  // other to steal tasks.
+  for (int i = 0; i < num_threads; ++i)
+    workers_.push_back(std::unique_ptr<Worker>(new Worker));
+
+  for (int i = 0; i < num_threads; ++i) {
+    std::unique_ptr<base::SimpleThread> thread(new WorkerThread(
+        base::StringPrintf("%s%d", thread_name_prefix.c_str(), i + 1),
+        thread_options, this, i));
+    thread->Start();
+    threads_.push_back(std::move(thread));
+  }
+}
+
+void WorkStealingTaskGraphRunner::Shutdown() {
+  {
+    base::AutoLock lock(lock_);
+
+    DCHECK(!work_queue_.HasReadyToRunTasks());
+    DCHECK(!work_queue_.HasAnyNamespaces());
+
+    DCHECK(!shutdown_);
+    shutdown_ = true;
+
+    // Wake up all workers so they exit.
+    has_ready_to_run_tasks_cv_.Broadcast();
+  }
+  while (!threads_.empty()) {
+    threads_.back()->Join();
+    threads_.pop_back();
+  }
+}
+
+NamespaceToken WorkStealingTaskGraphRunner::GetNamespaceToken() {
+  base::AutoLock lock(lock_);
+  return work_queue_.GetNamespaceToken();
+}
+
+void WorkStealingTaskGraphRunner::ScheduleTasks(NamespaceToken token,
+                                                TaskGraph* graph) {
+  TRACE_EVENT2("disabled-by-default-cc.debug",
+               "WorkStealingTaskGraphRunner::ScheduleTasks", "num_nodes",
+               graph->nodes.size(), "num_edges", graph->edges.size());
+
+  DCHECK(token.IsValid());
+  DCHECK(!TaskGraphWorkQueue::DependencyMismatch(graph));
+
+  {
+    base::AutoLock lock(lock_);
+
+    DCHECK(!shutdown_);
+
+    work_queue_.ScheduleTasks(token, graph);
+    SignalIdleWorkerWithLockAcquired();
+  }
+}
+
+void WorkStealingTaskGraphRunner::WaitForTasksToFinishRunning(
+    NamespaceToken token) {
+  TRACE_EVENT0("disabled-by-default-cc.debug",
+               "WorkStealingTaskGraphRunner::WaitForTasksToFinishRunning");
+
+  DCHECK(token.IsValid());
+
+  {
+    base::AutoLock lock(lock_);
+    base::ThreadRestrictions::ScopedAllowWait allow_wait;
+
+    auto* task_namespace = work_queue_.GetNamespaceForToken(token);
+
+    if (!task_namespace)
+      return;
+
+    while (!work_queue_.HasFinishedRunningTasksInNamespace(task_namespace))
+      has_namespaces_with_finished_running_tasks_cv_.Wait();
+
+    // There may be other namespaces that have finished running tasks, so wake
+    // up another origin thread.
+    has_namespaces_with_finished_running_tasks_cv_.Signal();
+  }
+}
+
+void WorkStealingTaskGraphRunner::CollectCompletedTasks(
+    NamespaceToken token,
+    Task::Vector* completed_tasks) {
+  TRACE_EVENT0("disabled-by-default-cc.debug",
+               "WorkStealingTaskGraphRunner::CollectCompletedTasks");
+
+  DCHECK(token.IsValid());
+
+  {
+    base::AutoLock lock(lock_);
+    work_queue_.CollectCompletedTasks(token, completed_tasks);
+  }
+}
+
+void WorkStealingTaskGraphRunner::Run(size_t worker_index) {
+  Worker* worker = workers_[worker_index].get();
+
+  while (true) {
+    TaskGraphWorkQueue::PrioritizedTask task(nullptr, nullptr, 0u, 0u);
+    if (!TakeClaimedTask(worker, &task) &&
+        !StealClaimedTask(worker_index, &task)) {
+      base::AutoLock lock(lock_);
+
+      CompleteTasksWithLockAcquired(worker);
+      if (ClaimTasksWithLockAcquired(worker))
+        continue;
+
+      // Another worker may have claimed tasks after this one looked for some
+      // to steal, so look again rather than wait for a signal that was sent
+      // before waiting.
+      if (base::subtle::Acquire_Load(&num_claimed_tasks_))
+        continue;
+
+      // Exit when shutdown is set and no more tasks are pending.
+      if (shutdown_)
+        break;
+
+      // Wait for more tasks.
+      ++num_idle_workers_;
+      has_ready_to_run_tasks_cv_.Wait();
+      --num_idle_workers_;
+      continue;
+    }
+
+    {
+      TRACE_EVENT0("toplevel", "TaskGraphRunner::RunTask");
+      task.task->RunOnWorkerThread();
+    }
+    worker->completed_tasks.push_back(task);
+
+    // Report completed tasks right away if nobody else holds the lock, so that
+    // their dependents may run as early as possible. Otherwise, keep them for
+    // the next time the lock is taken, but not for too long, as origin
+    // threads may be waiting for them.
+    if (worker->completed_tasks.size() >= max_claimed_tasks_) {
+      base::AutoLock lock(lock_);
+      CompleteTasksWithLockAcquired(worker);
+    } else if (lock_.Try()) {
+      CompleteTasksWithLockAcquired(worker);
+      lock_.Release();
+    }
+  }
+
+  DCHECK(worker->completed_tasks.empty());
+}
+
+bool WorkStealingTaskGraphRunner::TakeClaimedTask(
+    Worker* worker,
+    TaskGraphWorkQueue::PrioritizedTask* task) {
+  base::AutoLock lock(worker->lock);
+  if (worker->claimed_tasks.empty())
+    return false;
+
+  *task = worker->claimed_tasks.front();
+  worker->claimed_tasks.pop_front();
+  base::subtle::Barrier_AtomicIncrement(&num_claimed_tasks_, -1);
+  return true;
+}
+
+bool WorkStealingTaskGraphRunner::StealClaimedTask(
+    size_t worker_index,
+    TaskGraphWorkQueue::PrioritizedTask* task) {
+  if (!base::subtle::Acquire_Load(&num_claimed_tasks_))
+    return false;
+
+  // Claimed tasks are in priority order, so steal the first one, which would
+  // otherwise run next.
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker* victim = workers_[(worker_index + i) % workers_.size()].get();
+    if (!victim->lock.Try())
+      continue;
+    bool stolen = !victim->claimed_tasks.empty();
+    if (stolen) {
+      *task = victim->claimed_tasks.front();
+      victim->claimed_tasks.pop_front();
+      base::subtle::Barrier_AtomicIncrement(&num_claimed_tasks_, -1);
+    }
+    victim->lock.Release();
+    if (stolen)
+      return true;
+  }
+  return false;
+}
+
+bool WorkStealingTaskGraphRunner::ClaimTasksWithLockAcquired(Worker* worker) {
+  lock_.AssertAcquired();
+
+  TaskGraphWorkQueue::PrioritizedTask::Vector tasks;
+  for (TaskCategory category : kCategories) {
+    while (tasks.size() < max_claimed_tasks_ &&
+           ShouldClaimTaskForCategoryWithLockAcquired(category)) {
+      tasks.push_back(work_queue_.GetNextTaskToRun(category));
+    }
+  }
+  if (tasks.empty())
+    return false;
+
+  {
+    base::AutoLock lock(worker->lock);
+    worker->claimed_tasks.insert(worker->claimed_tasks.end(), tasks.begin(),
+                                 tasks.end());
+    base::subtle::Barrier_AtomicIncrement(&num_claimed_tasks_,
+                                          static_cast<int32_t>(tasks.size()));
+  }
+
+  // Other workers may steal the tasks this one won't run right away, or claim
+  // the ones left.
+  if (tasks.size() > 1 || work_queue_.HasReadyToRunTasks())
+    SignalIdleWorkerWithLockAcquired();
+  return true;
+}
+
+bool WorkStealingTaskGraphRunner::ShouldClaimTaskForCategoryWithLockAcquired(
+    TaskCategory category) const {
+  lock_.AssertAcquired();
+
+  if (!work_queue_.HasReadyToRunTasksForCategory(category))
+    return false;
+
+  if (category == TASK_CATEGORY_BACKGROUND) {
+    // Only run background tasks if there are no foreground tasks running or
+    // ready to run.
+    size_t num_running_foreground_tasks =
+        work_queue_.NumRunningTasksForCategory(
+            TASK_CATEGORY_NONCONCURRENT_FOREGROUND) +
+        work_queue_.NumRunningTasksForCategory(TASK_CATEGORY_FOREGROUND);
+    bool has_ready_to_run_foreground_tasks =
+        work_queue_.HasReadyToRunTasksForCategory(
+            TASK_CATEGORY_NONCONCURRENT_FOREGROUND) ||
+        work_queue_.HasReadyToRunTasksForCategory(TASK_CATEGORY_FOREGROUND);
+
+    if (num_running_foreground_tasks > 0 || has_ready_to_run_foreground_tasks)
+      return false;
+  }
+
+  // Enforce that only one nonconcurrent task runs at a time.
+  if (category == TASK_CATEGORY_NONCONCURRENT_FOREGROUND &&
+      work_queue_.NumRunningTasksForCategory(
+          TASK_CATEGORY_NONCONCURRENT_FOREGROUND) > 0) {
+    return false;
+  }
+
+  return true;
+}
+
+void WorkStealingTaskGraphRunner::CompleteTasksWithLockAcquired(
+    Worker* worker) {
+  lock_.AssertAcquired();
+
+  if (worker->completed_tasks.empty())
+    return;
+
+  bool has_namespaces_with_finished_running_tasks = false;
+  for (const auto& task : worker->completed_tasks) {
+    work_queue_.CompleteTask(task);
+    if (work_queue_.HasFinishedRunningTasksInNamespace(task.task_namespace))
+      has_namespaces_with_finished_running_tasks = true;
+  }
+  worker->completed_tasks.clear();
+
+  // If a namespace has finished running all tasks, wake up origin threads.
+  if (has_namespaces_with_finished_running_tasks)
+    has_namespaces_with_finished_running_tasks_cv_.Signal();
+
+  // Completed tasks may have made others ready to run, or allowed another
+  // category to start running.
+  SignalIdleWorkerWithLockAcquired();
+}
+
+void WorkStealingTaskGraphRunner::SignalIdleWorkerWithLockAcquired() {
+  lock_.AssertAcquired();
+
+  if (!num_idle_workers_)
+    return;
+
+  bool has_work = base::subtle::NoBarrier_Load(&num_claimed_tasks_) > 0;
+  for (TaskCategory category : kCategories) {
+    if (has_work)
+      break;
+    has_work = ShouldClaimTaskForCategoryWithLockAcquired(category);
+  }
+  if (has_work)
+    has_ready_to_run_tasks_cv_.Signal();
+}
+
+}  // namespace cc
@@ -0,0 +1,129 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
+#define CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/macros.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
+#include "cc/base/cc_export.h"
+#include "cc/raster/task_category.h"
+#include "cc/raster/task_graph_runner.h"
+#include "cc/raster/task_graph_work_queue.h"
+
+namespace cc {
+
+// Runs TaskGraphs on a pool of worker threads without having every worker take
+// a shared lock twice per task. Each worker claims up to |max_claimed_tasks|
+// ready tasks at a time from the shared TaskGraphWorkQueue into a queue of its
+// own, and a worker which runs out steals from the others before going back to
+// the shared queue. Completed tasks are reported right away when the shared
+// lock is free, and along with the next claim otherwise.
+//
+// Tasks run in the order defined by the dependency graph, and categories are
+// prioritized as by content's CategorizedWorkerPool: at most one
+// TASK_CATEGORY_NONCONCURRENT_FOREGROUND task runs at a time, and
+// TASK_CATEGORY_BACKGROUND tasks only run when no foreground task is running or
+// ready to run. Claimed tasks count as running, so a task may still run after
+// being dropped from a new graph, or before a higher priority task scheduled
+// after it was claimed, by at most |max_claimed_tasks| tasks per worker.
+class CC_EXPORT WorkStealingTaskGraphRunner : public TaskGraphRunner {
+ public:
+  // Number of tasks a worker claims at a time by default.
+  static const size_t kDefaultMaxClaimedTasks = 4;
+
+  explicit WorkStealingTaskGraphRunner(size_t max_claimed_tasks);
+  ~WorkStealingTaskGraphRunner() override;
+
+  // Overridden from TaskGraphRunner:
+  NamespaceToken GetNamespaceToken() override;
+  void ScheduleTasks(NamespaceToken token, TaskGraph* graph) override;
+  void WaitForTasksToFinishRunning(NamespaceToken token) override;
+  void CollectCompletedTasks(NamespaceToken token,
+                             Task::Vector* completed_tasks) override;
+
+  // Spawns |num_threads| worker threads named after |thread_name_prefix|.
+  void Start(int num_threads,
+             const std::string& thread_name_prefix,
+             const base::SimpleThread::Options& thread_options);
+  void Shutdown();
+
+ private:
+  class WorkerThread;
+  struct Worker;
+
+  // Runs tasks on the worker thread of |workers_[worker_index]| until
+  // shutdown.
+  void Run(size_t worker_index);
+
+  // Takes the next task claimed by |worker|. Returns false if there is none.
+  bool TakeClaimedTask(Worker* worker,
+                       TaskGraphWorkQueue::PrioritizedTask* task);
+
+  // Takes the next task claimed by a worker other than
+  // |workers_[worker_index]|. Returns false if there is none.
+  bool StealClaimedTask(size_t worker_index,
+                        TaskGraphWorkQueue::PrioritizedTask* task);
+
+  // Claims ready tasks from |work_queue_| for |worker|. Returns false if no
+  // task could be claimed.
+  bool ClaimTasksWithLockAcquired(Worker* worker);
+
+  // Determines if a task of |category| can be claimed now. This factors in
+  // whether a task is available and whether the tasks running in other
+  // categories allow a new one to start.
+  bool ShouldClaimTaskForCategoryWithLockAcquired(TaskCategory category) const;
+
+  // Reports the tasks |worker| completed to |work_queue_|.
+  void CompleteTasksWithLockAcquired(Worker* worker);
+
+  // Wakes up an idle worker if there may be something for it to do.
+  void SignalIdleWorkerWithLockAcquired();
+
+  const size_t max_claimed_tasks_;
+
+  // The actual threads where work is done, and their state.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::unique_ptr<base::SimpleThread>> threads_;
+
+  // Number of claimed tasks which no worker has taken yet.
+  base::subtle::Atomic32 num_claimed_tasks_;
+
+  // Lock to exclusively access all the following members that are used to
+  // implement the TaskGraphRunner interface.
+  base::Lock lock_;
+
+  // Stores the tasks to be run, sorted by priority.
+  TaskGraphWorkQueue work_queue_;
+
+  // Condition variable that is waited on by idle workers until new tasks are
+  // ready to run or shutdown starts.
+  base::ConditionVariable has_ready_to_run_tasks_cv_;
+
+  // Condition variable that is waited on by origin threads until a namespace
+  // has finished running all associated tasks.
+  base::ConditionVariable has_namespaces_with_finished_running_tasks_cv_;
+
+  // Number of workers waiting on |has_ready_to_run_tasks_cv_|.
+  size_t num_idle_workers_;
+
+  // Set during shutdown. Tells workers to return when no more tasks are
+  // pending.
+  bool shutdown_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingTaskGraphRunner);
+};
+
+}  // namespace cc
+
+#endif  // CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
@@ -0,0 +1,150 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/work_stealing_task_graph_runner.h"
+
+#include <stddef.h>
+
+#include "base/atomicops.h"
+#include "base/macros.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "cc/raster/task_category.h"
+#include "cc/test/task_graph_runner_test_template.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+template <int NumThreads, size_t MaxClaimedTasks>
+class WorkStealingTaskGraphRunnerTestDelegate {
+ public:
+  WorkStealingTaskGraphRunnerTestDelegate()
+      : work_stealing_task_graph_runner_(MaxClaimedTasks) {}
+
+  void StartTaskGraphRunner() {
+    work_stealing_task_graph_runner_.Start(
+        NumThreads, "WorkStealingTaskGraphRunnerTestDelegate",
+        base::SimpleThread::Options());
+  }
+
+  TaskGraphRunner* GetTaskGraphRunner() {
+    return &work_stealing_task_graph_runner_;
+  }
+
+  void StopTaskGraphRunner() {}
+
+  ~WorkStealingTaskGraphRunnerTestDelegate() {
+    work_stealing_task_graph_runner_.Shutdown();
+  }
+
+ private:
+  WorkStealingTaskGraphRunner work_stealing_task_graph_runner_;
+};
+
+template <int NumThreads>
+using WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims =
+    WorkStealingTaskGraphRunnerTestDelegate<
+        NumThreads,
+        WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks>;
+
+// Multithreaded tests.
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner_1_Threads,
+    TaskGraphRunnerTest,
+    WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims<1>);
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner_2_Threads,
+    TaskGraphRunnerTest,
+    WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims<2>);
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner_3_Threads,
+    TaskGraphRunnerTest,
+    WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims<3>);
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner_4_Threads,
+    TaskGraphRunnerTest,
+    WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims<4>);
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner_5_Threads,
+    TaskGraphRunnerTest,
+    WorkStealingTaskGraphRunnerTestDelegateWithDefaultClaims<5>);
+
+// Single threaded tests. Tasks only run in strict priority order when claimed
+// one at a time.
+using SingleThreadWorkStealingTaskGraphRunnerTestDelegate =
+    WorkStealingTaskGraphRunnerTestDelegate<1, 1>;
+INSTANTIATE_TYPED_TEST_CASE_P(
+    WorkStealingTaskGraphRunner,
+    SingleThreadTaskGraphRunnerTest,
+    SingleThreadWorkStealingTaskGraphRunnerTestDelegate);
+
+// Records the most tasks it saw running at once.
+class ConcurrencyCheckingTask : public Task {
+ public:
+  ConcurrencyCheckingTask(base::subtle::Atomic32* num_running,
+                          base::subtle::Atomic32* max_running)
+      : num_running_(num_running), max_running_(max_running) {}
+
+  // Overridden from Task:
+  void RunOnWorkerThread() override {
+    base::subtle::Atomic32 running =
+        base::subtle::Barrier_AtomicIncrement(num_running_, 1);
+    base::subtle::Atomic32 max_running =
+        base::subtle::Acquire_Load(max_running_);
+    while (running > max_running) {
+      base::subtle::Atomic32 previous = base::subtle::Acquire_CompareAndSwap(
+          max_running_, max_running, running);
+      if (previous == max_running)
+        break;
+      max_running = previous;
+    }
+    // Give other workers a chance to start a task meanwhile.
+    base::PlatformThread::YieldCurrentThread();
+    base::subtle::Barrier_AtomicIncrement(num_running_, -1);
+  }
+
+ private:
+  ~ConcurrencyCheckingTask() override {}
+
+  base::subtle::Atomic32* const num_running_;
+  base::subtle::Atomic32* const max_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrencyCheckingTask);
+};
+
+TEST(WorkStealingTaskGraphRunnerTest, NonconcurrentTasksDoNotRunConcurrently) {
+  const int kNumThreads = 4;
+  const size_t kNumTasks = 100;
+
+  WorkStealingTaskGraphRunner runner(
+      WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks);
+  runner.Start(kNumThreads, "WorkStealingTaskGraphRunnerTest",
+               base::SimpleThread::Options());
+  NamespaceToken token = runner.GetNamespaceToken();
+
+  base::subtle::Atomic32 num_running = 0;
+  base::subtle::Atomic32 max_running = 0;
+  Task::Vector tasks;
+  TaskGraph graph;
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    tasks.push_back(
+        make_scoped_refptr(new ConcurrencyCheckingTask(&num_running,
+                                                       &max_running)));
+    graph.nodes.push_back(TaskGraph::Node(
+        tasks.back().get(), TASK_CATEGORY_NONCONCURRENT_FOREGROUND, 0u, 0u));
+  }
+  runner.ScheduleTasks(token, &graph);
+  runner.WaitForTasksToFinishRunning(token);
+
+  Task::Vector completed_tasks;
+  runner.CollectCompletedTasks(token, &completed_tasks);
+  EXPECT_EQ(kNumTasks, completed_tasks.size());
+  EXPECT_EQ(1, base::subtle::Acquire_Load(&max_running));
+
+  runner.Shutdown();
+}
+
+}  // namespace
+}  // namespace cc
@@ -25,6 +25,11 @@ namespace {
 // Delay before a resource is considered expired.
 const int kResourceExpirationDelayMs = 1000;
 
+// How much larger in area than requested an unused resource may be and still
+// be reused. Reusing such resources avoids reallocating textures when tile
+// sizes change slightly, as for edge tiles while pinch-zooming.
+const float kReuseAreaThreshold = 2.0f;
+
 }  // namespace
 
 void ResourcePool::PoolResource::OnMemoryDump(
@@ -63,6 +68,9 @@ ResourcePool::ResourcePool(ResourceProvider* resource_provider,
                            bool use_gpu_memory_buffers)
     : resource_provider_(resource_provider),
       use_gpu_memory_buffers_(use_gpu_memory_buffers),
+      // GpuMemoryBuffer-backed resources may be presented as is, so their size
+      // needs to match what was asked for.
+      disallow_non_exact_reuse_(use_gpu_memory_buffers),
       max_memory_usage_bytes_(0),
       max_resource_count_(0),
       in_use_memory_usage_bytes_(0),
@@ -98,7 +106,9 @@ Resource* ResourcePool::AcquireResource(const gfx::Size& size,
                                         ResourceFormat format) {
   // Finding resources in |unused_resources_| from MRU to LRU direction, touches
   // LRU resources only if needed, which increases possibility of expiring more
-  // LRU resources within kResourceExpirationDelayMs.
+  // LRU resources within kResourceExpirationDelayMs. An exact size match is
+  // preferred, and otherwise the smallest resource large enough is used.
+  ResourceDeque::iterator best = unused_resources_.end();
   for (ResourceDeque::iterator it = unused_resources_.begin();
        it != unused_resources_.end(); ++it) {
     ScopedResource* resource = it->get();
@@ -106,17 +116,40 @@ Resource* ResourcePool::AcquireResource(const gfx::Size& size,
 
     if (resource->format() != format)
       continue;
-    if (resource->size() != size)
+    if (!ResourceMeetsSizeRequirements(size, resource->size()))
+      continue;
+    if (best != unused_resources_.end() &&
+        (*best)->size().GetArea() <= resource->size().GetArea()) {
       continue;
+    }
+
+    best = it;
+    if (resource->size() == size)
+      break;
+  }
+  if (best != unused_resources_.end()) {
+    Resource* resource = best->get();
 
     // Transfer resource to |in_use_resources_|.
-    in_use_resources_[resource->id()] = std::move(*it);
-    unused_resources_.erase(it);
+    in_use_resources_[resource->id()] = std::move(*best);
+    unused_resources_.erase(best);
     in_use_memory_usage_bytes_ += ResourceUtil::UncheckedSizeInBytes<size_t>(
         resource->size(), resource->format());
     return resource;
   }
 
+  // Make room for the new resource within the limits by evicting the least
+  // recently used unused resources first, instead of going over them until
+  // the next ReduceResourceUsage().
+  size_t resource_bytes =
+      ResourceUtil::UncheckedSizeInBytes<size_t>(size, format);
+  while (!unused_resources_.empty() &&
+         (total_resource_count_ + 1 > max_resource_count_ ||
+          total_memory_usage_bytes_ + resource_bytes >
+              max_memory_usage_bytes_)) {
+    DeleteResource(PopBack(&unused_resources_));
+  }
+
   std::unique_ptr<PoolResource> pool_resource =
       PoolResource::Create(resource_provider_);
 
@@ -240,6 +273,21 @@ void ResourcePool::ReduceResourceUsage() {
   }
 }
 
+bool ResourcePool::ResourceMeetsSizeRequirements(
+    const gfx::Size& requested_size,
+    const gfx::Size& actual_size) const {
+  if (actual_size == requested_size)
+    return true;
+  if (disallow_non_exact_reuse_)
+    return false;
+  if (actual_size.width() < requested_size.width() ||
+      actual_size.height() < requested_size.height()) {
+    return false;
+  }
+  return actual_size.GetArea() <=
+         requested_size.GetArea() * kReuseAreaThreshold;
+}
+
 bool ResourcePool::ResourceUsageTooHigh() {
   if (total_resource_count_ > max_resource_count_)
     return true;
@@ -344,6 +392,39 @@ base::TimeTicks ResourcePool::GetUsageTimeForLRUResource() const {
 
 bool ResourcePool::OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
                                 base::trace_event::ProcessMemoryDump* pmd) {
+  // Break the pool's memory down by state, and against its limit.
+  size_t unused_bytes = 0;
+  for (const auto& resource : unused_resources_) {
+    unused_bytes += ResourceUtil::UncheckedSizeInBytes<size_t>(
+        resource->size(), resource->format());
+  }
+  size_t busy_bytes = 0;
+  for (const auto& resource : busy_resources_) {
+    busy_bytes += ResourceUtil::UncheckedSizeInBytes<size_t>(
+        resource->size(), resource->format());
+  }
+  // The size of this dump is the sum of the resource dumps below it.
+  std::string pool_dump_name = base::StringPrintf(
+      "cc/tile_memory/provider_%d", resource_provider_->tracing_id());
+  base::trace_event::MemoryAllocatorDump* pool_dump =
+      pmd->CreateAllocatorDump(pool_dump_name);
+  pool_dump->AddScalar("in_use_size",
+                       base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                       in_use_memory_usage_bytes_);
+  pool_dump->AddScalar("busy_size",
+                       base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                       busy_bytes);
+  pool_dump->AddScalar("free_size",
+                       base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                       unused_bytes);
+  pool_dump->AddScalar("limit_size",
+                       base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                       max_memory_usage_bytes_);
+  pool_dump->AddScalar(
+      base::trace_event::MemoryAllocatorDump::kNameObjectCount,
+      base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+      total_resource_count_);
+
   for (const auto& resource : unused_resources_) {
     resource->OnMemoryDump(pmd, resource_provider_, true /* is_free */);
   }
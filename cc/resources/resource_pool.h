@@ -78,6 +78,11 @@ class CC_EXPORT ResourcePool : public base::trace_event::MemoryDumpProvider {
 
   bool ResourceUsageTooHigh();
 
+  // Returns true if an unused resource of |actual_size| can be handed out for
+  // a request of |requested_size|.
+  bool ResourceMeetsSizeRequirements(const gfx::Size& requested_size,
+                                     const gfx::Size& actual_size) const;
+
  private:
   class PoolResource : public ScopedResource {
    public:
@@ -114,6 +119,7 @@ class CC_EXPORT ResourcePool : public base::trace_event::MemoryDumpProvider {
 
   ResourceProvider* resource_provider_;
   bool use_gpu_memory_buffers_;
+  bool disallow_non_exact_reuse_;
   size_t max_memory_usage_bytes_;
   size_t max_resource_count_;
   size_t in_use_memory_usage_bytes_;
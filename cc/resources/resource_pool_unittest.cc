@@ -120,6 +120,74 @@ TEST_F(ResourcePoolTest, SimpleResourceReuse) {
   EXPECT_EQ(2u, resource_provider_->num_resources());
 }
 
+TEST_F(ResourcePoolTest, SlightlyLargerResourceReuse) {
+  // Limits high enough to not be hit by this test.
+  size_t bytes_limit = 10 * 1024 * 1024;
+  size_t count_limit = 100;
+  resource_pool_->SetResourceUsageLimits(bytes_limit, count_limit);
+
+  ResourceFormat format = RGBA_8888;
+  Resource* large =
+      resource_pool_->AcquireResource(gfx::Size(100, 100), format);
+  Resource* exact = resource_pool_->AcquireResource(gfx::Size(90, 90), format);
+  resource_pool_->ReleaseResource(large, 0u);
+  resource_pool_->ReleaseResource(exact, 0u);
+  resource_pool_->CheckBusyResources();
+  EXPECT_EQ(2u, resource_provider_->num_resources());
+
+  // An exact match is preferred over a larger resource.
+  Resource* resource =
+      resource_pool_->AcquireResource(gfx::Size(90, 90), format);
+  EXPECT_EQ(gfx::Size(90, 90), resource->size());
+  EXPECT_EQ(2u, resource_provider_->num_resources());
+
+  // A slightly larger resource is reused instead of allocating a new one.
+  Resource* larger =
+      resource_pool_->AcquireResource(gfx::Size(80, 95), format);
+  EXPECT_EQ(gfx::Size(100, 100), larger->size());
+  EXPECT_EQ(2u, resource_provider_->num_resources());
+  EXPECT_EQ(ResourceUtil::UncheckedSizeInBytes<size_t>(gfx::Size(100, 100),
+                                                       format) +
+                ResourceUtil::UncheckedSizeInBytes<size_t>(gfx::Size(90, 90),
+                                                           format),
+            resource_pool_->memory_usage_bytes());
+  resource_pool_->ReleaseResource(resource, 0u);
+  resource_pool_->ReleaseResource(larger, 0u);
+  resource_pool_->CheckBusyResources();
+
+  // Resources which are much larger, or smaller in either dimension, are not
+  // reused.
+  resource = resource_pool_->AcquireResource(gfx::Size(40, 40), format);
+  EXPECT_EQ(gfx::Size(40, 40), resource->size());
+  EXPECT_EQ(3u, resource_provider_->num_resources());
+  resource_pool_->ReleaseResource(resource, 0u);
+  resource = resource_pool_->AcquireResource(gfx::Size(120, 60), format);
+  EXPECT_EQ(gfx::Size(120, 60), resource->size());
+  EXPECT_EQ(4u, resource_provider_->num_resources());
+  resource_pool_->ReleaseResource(resource, 0u);
+}
+
+TEST_F(ResourcePoolTest, AcquireEvictsUnusedResourcesOverLimits) {
+  gfx::Size size(100, 100);
+  size_t resource_bytes =
+      ResourceUtil::UncheckedSizeInBytes<size_t>(size, RGBA_8888);
+  resource_pool_->SetResourceUsageLimits(resource_bytes, 1u);
+
+  Resource* resource = resource_pool_->AcquireResource(size, RGBA_8888);
+  resource_pool_->ReleaseResource(resource, 0u);
+  resource_pool_->CheckBusyResources();
+  EXPECT_EQ(1u, resource_provider_->num_resources());
+
+  // The unused resource can't be reused, and keeping it would put the pool
+  // over its limits, so it is freed before allocating the new one.
+  resource = resource_pool_->AcquireResource(size, LUMINANCE_8);
+  EXPECT_EQ(1u, resource_provider_->num_resources());
+  EXPECT_EQ(1u, resource_pool_->GetTotalResourceCountForTesting());
+  EXPECT_EQ(ResourceUtil::UncheckedSizeInBytes<size_t>(size, LUMINANCE_8),
+            resource_pool_->GetTotalMemoryUsageForTesting());
+  resource_pool_->ReleaseResource(resource, 0u);
+}
+
 TEST_F(ResourcePoolTest, LostResource) {
   // Limits high enough to not be hit by this test.
   size_t bytes_limit = 10 * 1024 * 1024;
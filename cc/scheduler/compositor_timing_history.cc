@@ -10,6 +10,7 @@
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram.h"
 #include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_argument.h"
 #include "cc/debug/rendering_stats_instrumentation.h"
 
 namespace cc {
@@ -252,8 +253,46 @@ class NullUMAReporter : public CompositorTimingHistory::UMAReporter {
   void AddMainAndImplFrameTimeDelta(base::TimeDelta delta) override {}
 };
 
+void SetTimeIfNotNull(base::trace_event::TracedValue* state,
+                      const char* name,
+                      base::TimeTicks time) {
+  if (!time.is_null())
+    state->SetDouble(name, (time - base::TimeTicks()).InMillisecondsF());
+}
+
 }  // namespace
 
+const size_t CompositorTimingHistory::kMaxFrameTimingRecords;
+
+FrameTimingRecord::FrameTimingRecord()
+    : main_thread_missed_last_deadline(false) {}
+
+std::unique_ptr<base::trace_event::ConvertableToTraceFormat>
+FrameTimingRecord::AsValue() const {
+  std::unique_ptr<base::trace_event::TracedValue> state(
+      new base::trace_event::TracedValue());
+  AsValueInto(state.get());
+  return std::move(state);
+}
+
+void FrameTimingRecord::AsValueInto(
+    base::trace_event::TracedValue* state) const {
+  SetTimeIfNotNull(state, "begin_frame_time_ms", begin_frame_time);
+  SetTimeIfNotNull(state, "begin_main_frame_sent_time_ms",
+                   begin_main_frame_sent_time);
+  SetTimeIfNotNull(state, "begin_main_frame_start_time_ms",
+                   begin_main_frame_start_time);
+  SetTimeIfNotNull(state, "commit_time_ms", commit_time);
+  SetTimeIfNotNull(state, "ready_to_activate_time_ms", ready_to_activate_time);
+  SetTimeIfNotNull(state, "activate_time_ms", activate_time);
+  SetTimeIfNotNull(state, "draw_start_time_ms", draw_start_time);
+  SetTimeIfNotNull(state, "draw_end_time_ms", draw_end_time);
+  SetTimeIfNotNull(state, "swap_time_ms", swap_time);
+  SetTimeIfNotNull(state, "swap_ack_time_ms", swap_ack_time);
+  state->SetBoolean("main_thread_missed_last_deadline",
+                    main_thread_missed_last_deadline);
+}
+
 CompositorTimingHistory::CompositorTimingHistory(
     bool using_synchronous_renderer_compositor,
     UMACategory uma_category,
@@ -404,6 +443,10 @@ void CompositorTimingHistory::DidCreateAndInitializeOutputSurface() {
   // After we get a new output surface, we won't get a spurious
   // swap ack from the old output surface.
   swap_start_time_ = base::TimeTicks();
+  if (!swapped_frame_timing_.draw_end_time.is_null()) {
+    FinishFrameTiming(swapped_frame_timing_);
+    swapped_frame_timing_ = FrameTimingRecord();
+  }
 }
 
 void CompositorTimingHistory::WillBeginImplFrame(
@@ -462,10 +505,17 @@ void CompositorTimingHistory::BeginMainFrameAborted() {
 
 void CompositorTimingHistory::DidCommit() {
   DCHECK_EQ(base::TimeTicks(), pending_tree_main_frame_time_);
+  pending_tree_frame_timing_ = FrameTimingRecord();
+  pending_tree_frame_timing_.begin_main_frame_sent_time =
+      begin_main_frame_sent_time_;
+  pending_tree_frame_timing_.begin_main_frame_start_time =
+      begin_main_frame_start_time_;
+
   SetBeginMainFrameCommittingContinuously(true);
   DidBeginMainFrame();
   pending_tree_main_frame_time_ = begin_main_frame_frame_time_;
   begin_main_frame_frame_time_ = base::TimeTicks();
+  pending_tree_frame_timing_.commit_time = begin_main_frame_end_time_;
 }
 
 void CompositorTimingHistory::DidBeginMainFrame() {
@@ -572,7 +622,10 @@ void CompositorTimingHistory::ReadyToActivate() {
   if (begin_main_frame_end_time_ == base::TimeTicks())
     return;
 
-  base::TimeDelta time_since_commit = Now() - begin_main_frame_end_time_;
+  base::TimeTicks ready_to_activate_time = Now();
+  base::TimeDelta time_since_commit =
+      ready_to_activate_time - begin_main_frame_end_time_;
+  pending_tree_frame_timing_.ready_to_activate_time = ready_to_activate_time;
 
   // Before adding the new data point to the timing history, see what we would
   // have predicted for this frame. This allows us to keep track of the accuracy
@@ -601,7 +654,8 @@ void CompositorTimingHistory::WillActivate() {
 
 void CompositorTimingHistory::DidActivate() {
   DCHECK_NE(base::TimeTicks(), activate_start_time_);
-  base::TimeDelta activate_duration = Now() - activate_start_time_;
+  base::TimeTicks activate_end_time = Now();
+  base::TimeDelta activate_duration = activate_end_time - activate_start_time_;
 
   if (ShouldReportUma()) {
     uma_reporter_->AddActivateDuration(activate_duration);
@@ -613,9 +667,12 @@ void CompositorTimingHistory::DidActivate() {
   if (!using_synchronous_renderer_compositor_)
     DCHECK_EQ(base::TimeTicks(), active_tree_main_frame_time_);
   active_tree_main_frame_time_ = pending_tree_main_frame_time_;
+  active_tree_frame_timing_ = pending_tree_frame_timing_;
+  active_tree_frame_timing_.activate_time = activate_end_time;
 
   activate_start_time_ = base::TimeTicks();
   pending_tree_main_frame_time_ = base::TimeTicks();
+  pending_tree_frame_timing_ = FrameTimingRecord();
 }
 
 void CompositorTimingHistory::WillDraw() {
@@ -625,6 +682,7 @@ void CompositorTimingHistory::WillDraw() {
 
 void CompositorTimingHistory::DrawAborted() {
   active_tree_main_frame_time_ = base::TimeTicks();
+  active_tree_frame_timing_ = FrameTimingRecord();
 }
 
 void CompositorTimingHistory::DidDraw(bool used_new_active_tree,
@@ -657,6 +715,26 @@ void CompositorTimingHistory::DidDraw(bool used_new_active_tree,
   }
   draw_end_time_prev_ = draw_end_time;
 
+  FrameTimingRecord frame_timing;
+  if (used_new_active_tree) {
+    frame_timing = active_tree_frame_timing_;
+    active_tree_frame_timing_ = FrameTimingRecord();
+  }
+  frame_timing.begin_frame_time = impl_frame_time;
+  frame_timing.draw_start_time = draw_start_time_;
+  frame_timing.draw_end_time = draw_end_time;
+  frame_timing.main_thread_missed_last_deadline =
+      main_thread_missed_last_deadline;
+  // The swap happens inside the draw, so a swap which started after the draw
+  // did belongs to this frame. Otherwise the frame was not swapped and its
+  // timing is complete.
+  if (!swap_start_time_.is_null() && swap_start_time_ >= draw_start_time_) {
+    frame_timing.swap_time = swap_start_time_;
+    swapped_frame_timing_ = frame_timing;
+  } else {
+    FinishFrameTiming(frame_timing);
+  }
+
   if (used_new_active_tree) {
     DCHECK_NE(base::TimeTicks(), active_tree_main_frame_time_);
     base::TimeDelta main_and_impl_delta =
@@ -694,6 +772,29 @@ void CompositorTimingHistory::DidSwapBuffersComplete() {
     uma_reporter_->AddSwapToAckLatency(swap_to_ack_duration);
   }
   swap_start_time_ = base::TimeTicks();
+
+  if (!swapped_frame_timing_.draw_end_time.is_null()) {
+    swapped_frame_timing_.swap_ack_time = Now();
+    FinishFrameTiming(swapped_frame_timing_);
+    swapped_frame_timing_ = FrameTimingRecord();
+  }
+}
+
+void CompositorTimingHistory::TakeFrameTimingRecords(
+    std::vector<FrameTimingRecord>* records) {
+  records->assign(frame_timing_records_.begin(), frame_timing_records_.end());
+  frame_timing_records_.clear();
+}
+
+void CompositorTimingHistory::FinishFrameTiming(
+    const FrameTimingRecord& record) {
+  TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("cc.debug.scheduler.frames"),
+                       "FrameTiming", TRACE_EVENT_SCOPE_THREAD, "timing",
+                       record.AsValue());
+
+  if (frame_timing_records_.size() == kMaxFrameTimingRecords)
+    frame_timing_records_.pop_front();
+  frame_timing_records_.push_back(record);
 }
 
 bool CompositorTimingHistory::ShouldReportUma() const {
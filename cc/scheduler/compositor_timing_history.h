@@ -5,19 +5,49 @@
 #ifndef CC_SCHEDULER_COMPOSITOR_TIMING_HISTORY_H_
 #define CC_SCHEDULER_COMPOSITOR_TIMING_HISTORY_H_
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
+#include "base/time/time.h"
+#include "cc/base/cc_export.h"
 #include "cc/base/rolling_time_delta_history.h"
 
 namespace base {
 namespace trace_event {
+class ConvertableToTraceFormat;
 class TracedValue;
 }  // namespace trace_event
 }  // namespace base
 
 namespace cc {
 
+// When one drawn frame went through each stage of the pipeline, from the
+// BeginFrame it was drawn for to the ack of its swap. The swap ack is the
+// closest the scheduler gets to knowing when the frame was presented. Stages
+// the frame skipped are null: the main frame stages for a frame drawn without
+// a new commit, and the swap stages for a frame which was not swapped or whose
+// output surface was lost before the ack.
+struct CC_EXPORT FrameTimingRecord {
+  FrameTimingRecord();
+
+  std::unique_ptr<base::trace_event::ConvertableToTraceFormat> AsValue() const;
+  void AsValueInto(base::trace_event::TracedValue* state) const;
+
+  base::TimeTicks begin_frame_time;
+  base::TimeTicks begin_main_frame_sent_time;
+  base::TimeTicks begin_main_frame_start_time;
+  base::TimeTicks commit_time;
+  base::TimeTicks ready_to_activate_time;
+  base::TimeTicks activate_time;
+  base::TimeTicks draw_start_time;
+  base::TimeTicks draw_end_time;
+  base::TimeTicks swap_time;
+  base::TimeTicks swap_ack_time;
+  bool main_thread_missed_last_deadline;
+};
+
 class RenderingStatsInstrumentation;
 
 class CC_EXPORT CompositorTimingHistory {
@@ -77,8 +107,15 @@ class CC_EXPORT CompositorTimingHistory {
   void DidSwapBuffers();
   void DidSwapBuffersComplete();
 
+  // Moves the timing of the most recently finished frames, oldest first, into
+  // |records|. Only the last kMaxFrameTimingRecords frames are kept.
+  void TakeFrameTimingRecords(std::vector<FrameTimingRecord>* records);
+
+  static const size_t kMaxFrameTimingRecords = 120;
+
  protected:
   void DidBeginMainFrame();
+  void FinishFrameTiming(const FrameTimingRecord& record);
 
   void SetBeginMainFrameNeededContinuously(bool active);
   void SetBeginMainFrameCommittingContinuously(bool active);
@@ -126,6 +163,13 @@ class CC_EXPORT CompositorTimingHistory {
   base::TimeTicks draw_start_time_;
   base::TimeTicks swap_start_time_;
 
+  // The timing of the main frames committed to the pending and the active
+  // tree, and of the drawn frame whose swap has not been acked yet.
+  FrameTimingRecord pending_tree_frame_timing_;
+  FrameTimingRecord active_tree_frame_timing_;
+  FrameTimingRecord swapped_frame_timing_;
+  std::deque<FrameTimingRecord> frame_timing_records_;
+
   std::unique_ptr<UMAReporter> uma_reporter_;
   RenderingStatsInstrumentation* rendering_stats_instrumentation_;
 
@@ -4,6 +4,8 @@
 
 #include "cc/scheduler/compositor_timing_history.h"
 
+#include <vector>
+
 #include "base/macros.h"
 #include "cc/debug/rendering_stats_instrumentation.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -298,5 +300,97 @@ TEST_F(CompositorTimingHistoryTest, BeginMainFrames_NewCriticalSlower) {
             timing_history_.BeginMainFrameToCommitDurationEstimate());
 }
 
+TEST_F(CompositorTimingHistoryTest, FrameTimingRecords) {
+  base::TimeDelta one_millisecond = base::TimeDelta::FromMilliseconds(1);
+  std::vector<FrameTimingRecord> records;
+
+  // A frame drawn with a new commit records every stage.
+  base::TimeTicks begin_frame_time = Now();
+  timing_history_.WillBeginMainFrame(true, begin_frame_time);
+  base::TimeTicks sent_time = Now();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks start_time = Now();
+  timing_history_.BeginMainFrameStarted(start_time);
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks commit_time = Now();
+  timing_history_.DidCommit();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks ready_to_activate_time = Now();
+  timing_history_.ReadyToActivate();
+  timing_history_.WillActivate();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks activate_time = Now();
+  timing_history_.DidActivate();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks draw_start_time = Now();
+  timing_history_.WillDraw();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks swap_time = Now();
+  timing_history_.DidSwapBuffers();
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks draw_end_time = Now();
+  timing_history_.DidDraw(true, false, begin_frame_time);
+
+  // The frame is not done until its swap is acked.
+  timing_history_.TakeFrameTimingRecords(&records);
+  EXPECT_TRUE(records.empty());
+
+  AdvanceNowBy(one_millisecond);
+  base::TimeTicks swap_ack_time = Now();
+  timing_history_.DidSwapBuffersComplete();
+  timing_history_.TakeFrameTimingRecords(&records);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(begin_frame_time, records[0].begin_frame_time);
+  EXPECT_EQ(sent_time, records[0].begin_main_frame_sent_time);
+  EXPECT_EQ(start_time, records[0].begin_main_frame_start_time);
+  EXPECT_EQ(commit_time, records[0].commit_time);
+  EXPECT_EQ(ready_to_activate_time, records[0].ready_to_activate_time);
+  EXPECT_EQ(activate_time, records[0].activate_time);
+  EXPECT_EQ(draw_start_time, records[0].draw_start_time);
+  EXPECT_EQ(draw_end_time, records[0].draw_end_time);
+  EXPECT_EQ(swap_time, records[0].swap_time);
+  EXPECT_EQ(swap_ack_time, records[0].swap_ack_time);
+  EXPECT_FALSE(records[0].main_thread_missed_last_deadline);
+
+  // A frame drawn without a commit or a swap only records the draw.
+  begin_frame_time = Now();
+  timing_history_.WillDraw();
+  AdvanceNowBy(one_millisecond);
+  timing_history_.DidDraw(false, true, begin_frame_time);
+  timing_history_.TakeFrameTimingRecords(&records);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(begin_frame_time, records[0].begin_frame_time);
+  EXPECT_TRUE(records[0].begin_main_frame_sent_time.is_null());
+  EXPECT_TRUE(records[0].commit_time.is_null());
+  EXPECT_TRUE(records[0].activate_time.is_null());
+  EXPECT_EQ(begin_frame_time, records[0].draw_start_time);
+  EXPECT_EQ(Now(), records[0].draw_end_time);
+  EXPECT_TRUE(records[0].swap_time.is_null());
+  EXPECT_TRUE(records[0].swap_ack_time.is_null());
+  EXPECT_TRUE(records[0].main_thread_missed_last_deadline);
+
+  // A swapped frame is done without an ack if the output surface is lost.
+  timing_history_.WillDraw();
+  timing_history_.DidSwapBuffers();
+  AdvanceNowBy(one_millisecond);
+  timing_history_.DidDraw(false, false, Now());
+  timing_history_.DidCreateAndInitializeOutputSurface();
+  timing_history_.TakeFrameTimingRecords(&records);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_FALSE(records[0].swap_time.is_null());
+  EXPECT_TRUE(records[0].swap_ack_time.is_null());
+
+  // Only the most recent frames are kept.
+  for (size_t i = 0; i < CompositorTimingHistory::kMaxFrameTimingRecords + 1;
+       ++i) {
+    timing_history_.WillDraw();
+    AdvanceNowBy(one_millisecond);
+    timing_history_.DidDraw(false, false, Now());
+  }
+  timing_history_.TakeFrameTimingRecords(&records);
+  ASSERT_EQ(CompositorTimingHistory::kMaxFrameTimingRecords, records.size());
+  EXPECT_EQ(Now(), records.back().draw_end_time);
+}
+
 }  // namespace
 }  // namespace cc
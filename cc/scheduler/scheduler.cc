@@ -770,6 +770,11 @@ Scheduler::AsValue() const {
   return std::move(state);
 }
 
+void Scheduler::TakeFrameTimingRecords(
+    std::vector<FrameTimingRecord>* records) {
+  compositor_timing_history_->TakeFrameTimingRecords(records);
+}
+
 void Scheduler::UpdateCompositorTimingHistoryRecordingEnabled() {
   compositor_timing_history_->SetRecordingEnabled(
       state_machine_.HasInitializedOutputSurface() && state_machine_.visible());
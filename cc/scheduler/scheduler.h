@@ -8,6 +8,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/cancelable_callback.h"
 #include "base/macros.h"
@@ -32,6 +33,7 @@ class SingleThreadTaskRunner;
 namespace cc {
 
 class CompositorTimingHistory;
+struct FrameTimingRecord;
 
 class SchedulerClient {
  public:
@@ -136,6 +138,10 @@ class CC_EXPORT Scheduler : public BeginFrameObserverBase {
 
   std::unique_ptr<base::trace_event::ConvertableToTraceFormat> AsValue() const;
 
+  // Moves the per-stage timing of the frames drawn since the last call into
+  // |records|, oldest first.
+  void TakeFrameTimingRecords(std::vector<FrameTimingRecord>* records);
+
   void SetVideoNeedsBeginFrames(bool video_needs_begin_frames);
 
   const BeginFrameSource* begin_frame_source() const {
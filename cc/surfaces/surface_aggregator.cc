@@ -68,6 +68,11 @@ SurfaceAggregator::PrewalkResult::PrewalkResult() {}
 
 SurfaceAggregator::PrewalkResult::~PrewalkResult() {}
 
+SurfaceAggregator::ValidatedResources::ValidatedResources()
+    : frame_index(0), child_id(0), valid(false) {}
+
+SurfaceAggregator::ValidatedResources::~ValidatedResources() {}
+
 // Create a clip rect for an aggregated quad from the original clip rect and
 // the clip rect from the surface it's on.
 SurfaceAggregator::ClipData SurfaceAggregator::CalculateClipRect(
@@ -243,19 +248,12 @@ void SurfaceAggregator::HandleSurfaceQuad(
     copy_pass->transform_to_root_target.ConcatTransform(
         dest_pass->transform_to_root_target);
 
-    CopyQuadsToPass(source.quad_list, source.shared_quad_state_list,
-                    child_to_parent_map, gfx::Transform(), ClipData(),
-                    copy_pass.get(), surface_id);
-
-    if (!copy_request_passes_.count(remapped_pass_id) &&
-        !moved_pixel_passes_.count(remapped_pass_id)) {
-      gfx::Transform inverse_transform(gfx::Transform::kSkipInitialization);
-      if (copy_pass->transform_to_root_target.GetInverse(&inverse_transform)) {
-        gfx::Rect damage_rect_in_render_pass_space =
-            MathUtil::ProjectEnclosingClippedRect(inverse_transform,
-                                                  root_damage_rect_);
-        copy_pass->damage_rect.Intersect(damage_rect_in_render_pass_space);
-      }
+    ClipDamageRectToRootDamage(copy_pass.get());
+
+    if (!IsPassOutsideRootDamage(*copy_pass)) {
+      CopyQuadsToPass(source.quad_list, source.shared_quad_state_list,
+                      child_to_parent_map, gfx::Transform(), ClipData(),
+                      copy_pass.get(), surface_id);
     }
 
     dest_pass_list_->push_back(std::move(copy_pass));
@@ -470,6 +468,32 @@ void SurfaceAggregator::CopyQuadsToPass(
   }
 }
 
+void SurfaceAggregator::ClipDamageRectToRootDamage(RenderPass* pass) const {
+  if (copy_request_passes_.count(pass->id) ||
+      moved_pixel_passes_.count(pass->id)) {
+    return;
+  }
+  gfx::Transform inverse_transform(gfx::Transform::kSkipInitialization);
+  if (pass->transform_to_root_target.GetInverse(&inverse_transform)) {
+    gfx::Rect damage_rect_in_render_pass_space =
+        MathUtil::ProjectEnclosingClippedRect(inverse_transform,
+                                              root_damage_rect_);
+    pass->damage_rect.Intersect(damage_rect_in_render_pass_space);
+  }
+}
+
+bool SurfaceAggregator::IsPassOutsideRootDamage(const RenderPass& pass) const {
+  // These are the same conditions under which CopyQuadsToPass() drops the
+  // quads which don't intersect the root damage. The damage rect of such a
+  // pass has been clipped to the root damage, so if it is empty, all of its
+  // quads would be dropped one at a time.
+  if (!aggregate_only_damaged_ || has_copy_requests_ ||
+      moved_pixel_passes_.count(pass.id)) {
+    return false;
+  }
+  return pass.damage_rect.IsEmpty();
+}
+
 void SurfaceAggregator::CopyPasses(const DelegatedFrameData* frame_data,
                                    Surface* surface) {
   // The root surface is allowed to have copy output requests, so grab them
@@ -505,18 +529,12 @@ void SurfaceAggregator::CopyPasses(const DelegatedFrameData* frame_data,
                       source.transform_to_root_target,
                       source.has_transparent_background);
 
-    CopyQuadsToPass(source.quad_list, source.shared_quad_state_list,
-                    child_to_parent_map, gfx::Transform(), ClipData(),
-                    copy_pass.get(), surface->surface_id());
-    if (!copy_request_passes_.count(remapped_pass_id) &&
-        !moved_pixel_passes_.count(remapped_pass_id)) {
-      gfx::Transform inverse_transform(gfx::Transform::kSkipInitialization);
-      if (copy_pass->transform_to_root_target.GetInverse(&inverse_transform)) {
-        gfx::Rect damage_rect_in_render_pass_space =
-            MathUtil::ProjectEnclosingClippedRect(inverse_transform,
-                                                  root_damage_rect_);
-        copy_pass->damage_rect.Intersect(damage_rect_in_render_pass_space);
-      }
+    ClipDamageRectToRootDamage(copy_pass.get());
+
+    if (!IsPassOutsideRootDamage(*copy_pass)) {
+      CopyQuadsToPass(source.quad_list, source.shared_quad_state_list,
+                      child_to_parent_map, gfx::Transform(), ClipData(),
+                      copy_pass.get(), surface->surface_id());
     }
 
     dest_pass_list_->push_back(std::move(copy_pass));
@@ -526,6 +544,8 @@ void SurfaceAggregator::CopyPasses(const DelegatedFrameData* frame_data,
 void SurfaceAggregator::ProcessAddedAndRemovedSurfaces() {
   for (const auto& surface : previous_contained_surfaces_) {
     if (!contained_surfaces_.count(surface.first)) {
+      validated_resources_.erase(surface.first);
+
       // Release resources of removed surface.
       SurfaceToResourceChildIdMap::iterator it =
           surface_id_to_resource_child_id_.find(surface.first);
@@ -580,9 +600,25 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id,
   }
   CHECK(debug_weak_this.get());
 
+  // Validating the resources of a frame looks up every resource of every quad,
+  // so it is only done the first time the frame is aggregated. The resources
+  // received from the child can't change while the frame stays current, so
+  // neither can the outcome.
+  ValidatedResources* validated_resources = nullptr;
+  if (provider_) {
+    auto validated_it = validated_resources_.find(surface_id);
+    if (validated_it != validated_resources_.end() &&
+        validated_it->second.frame_index == surface->frame_index() &&
+        validated_it->second.child_id == child_id) {
+      validated_resources = &validated_it->second;
+    }
+  }
+
   ResourceProvider::ResourceIdSet referenced_resources;
-  size_t reserve_size = frame_data->resource_list.size();
-  referenced_resources.reserve(reserve_size);
+  if (!validated_resources) {
+    size_t reserve_size = frame_data->resource_list.size();
+    referenced_resources.reserve(reserve_size);
+  }
 
   bool invalid_frame = false;
   ResourceProvider::ResourceIdMap empty_map;
@@ -635,7 +671,7 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id,
             RemapPassId(render_pass_quad->render_pass_id, surface_id));
       }
 
-      if (!provider_)
+      if (!provider_ || validated_resources)
         continue;
       for (ResourceId resource_id : quad->resources) {
         if (!child_to_parent_map.count(resource_id)) {
@@ -647,13 +683,25 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id,
     }
   }
 
+  if (provider_ && !validated_resources) {
+    validated_resources = &validated_resources_[surface_id];
+    validated_resources->frame_index = surface->frame_index();
+    validated_resources->child_id = child_id;
+    validated_resources->valid = !invalid_frame;
+    validated_resources->referenced_resources.swap(referenced_resources);
+  }
+  if (validated_resources && !validated_resources->valid)
+    invalid_frame = true;
+
   if (invalid_frame)
     return gfx::Rect();
   CHECK(debug_weak_this.get());
   valid_surfaces_.insert(surface->surface_id());
 
-  if (provider_)
-    provider_->DeclareUsedResourcesFromChild(child_id, referenced_resources);
+  if (provider_) {
+    provider_->DeclareUsedResourcesFromChild(
+        child_id, validated_resources->referenced_resources);
+  }
   CHECK(debug_weak_this.get());
 
   gfx::Rect damage_rect;
@@ -829,6 +877,7 @@ std::unique_ptr<CompositorFrame> SurfaceAggregator::Aggregate(
 }
 
 void SurfaceAggregator::ReleaseResources(SurfaceId surface_id) {
+  validated_resources_.erase(surface_id);
   SurfaceToResourceChildIdMap::iterator it =
       surface_id_to_resource_child_id_.find(surface_id);
   if (it != surface_id_to_resource_child_id_.end()) {
@@ -62,6 +62,19 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
     std::set<SurfaceId> undrawn_surfaces;
   };
 
+  // The outcome of validating the resources of the frame with |frame_index|
+  // from a surface, against the resources received from it as |child_id|.
+  struct ValidatedResources {
+    ValidatedResources();
+    ~ValidatedResources();
+
+    int frame_index;
+    int child_id;
+    bool valid;
+    // The resources the quads of the frame use, if it is valid.
+    std::unordered_set<ResourceId> referenced_resources;
+  };
+
   ClipData CalculateClipRect(const ClipData& surface_clip,
                              const ClipData& quad_clip,
                              const gfx::Transform& target_transform);
@@ -90,6 +103,12 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
                         RenderPassId parent_pass,
                         PrewalkResult* result);
   void CopyUndrawnSurfaces(PrewalkResult* prewalk);
+  // Clips the damage rect of an aggregated pass to the root damage rect,
+  // unless the pass needs to be drawn in full.
+  void ClipDamageRectToRootDamage(RenderPass* pass) const;
+  // Returns true if none of the quads of an aggregated pass, whose damage rect
+  // has been clipped, would be kept, so copying them can be skipped.
+  bool IsPassOutsideRootDamage(const RenderPass& pass) const;
   void CopyPasses(const DelegatedFrameData* frame_data, Surface* surface);
 
   // Remove Surfaces that were referenced before but aren't currently
@@ -122,6 +141,11 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
       std::unordered_map<SurfaceId, int, SurfaceIdHash>;
   SurfaceToResourceChildIdMap surface_id_to_resource_child_id_;
 
+  // The last frame validated for each surface, so the resources of frames
+  // which are aggregated again are not looked up again.
+  std::unordered_map<SurfaceId, ValidatedResources, SurfaceIdHash>
+      validated_resources_;
+
   // The following state is only valid for the duration of one Aggregate call
   // and is only stored on the class to avoid having to pass through every
   // function call.
@@ -6,6 +6,7 @@
 #include "cc/debug/lap_timer.h"
 #include "cc/output/compositor_frame.h"
 #include "cc/output/delegated_frame_data.h"
+#include "cc/quads/render_pass_draw_quad.h"
 #include "cc/quads/surface_draw_quad.h"
 #include "cc/quads/texture_draw_quad.h"
 #include "cc/surfaces/surface_aggregator.h"
@@ -40,6 +41,38 @@ class SurfaceAggregatorPerfTest : public testing::Test {
         output_surface_.get(), shared_bitmap_manager_.get());
   }
 
+  // Appends |num_textures| texture quads and their resources to |pass|.
+  void AppendTextureQuads(int num_textures,
+                          RenderPass* pass,
+                          DelegatedFrameData* frame_data) {
+    SharedQuadState* sqs = pass->CreateAndAppendSharedQuadState();
+    for (int j = 0; j < num_textures; j++) {
+      TransferableResource resource;
+      resource.id = j;
+      resource.is_software = true;
+      frame_data->resource_list.push_back(resource);
+
+      TextureDrawQuad* quad = pass->CreateAndAppendDrawQuad<TextureDrawQuad>();
+      const gfx::Rect rect(0, 0, 1, 1);
+      const gfx::Rect opaque_rect;
+      // Half of rects should be visible with partial damage.
+      gfx::Rect visible_rect =
+          j % 2 == 0 ? gfx::Rect(0, 0, 1, 1) : gfx::Rect(1, 1, 1, 1);
+      bool needs_blending = false;
+      bool premultiplied_alpha = false;
+      const gfx::PointF uv_top_left;
+      const gfx::PointF uv_bottom_right;
+      SkColor background_color = SK_ColorGREEN;
+      const float vertex_opacity[4] = {0.f, 0.f, 1.f, 1.f};
+      bool flipped = false;
+      bool nearest_neighbor = false;
+      quad->SetAll(sqs, rect, opaque_rect, visible_rect, needs_blending, j,
+                   gfx::Size(), premultiplied_alpha, uv_top_left,
+                   uv_bottom_right, background_color, vertex_opacity, flipped,
+                   nearest_neighbor, false);
+    }
+  }
+
   void RunTest(int num_surfaces,
                int num_textures,
                float opacity,
@@ -53,34 +86,8 @@ class SurfaceAggregatorPerfTest : public testing::Test {
       std::unique_ptr<RenderPass> pass(RenderPass::Create());
       std::unique_ptr<DelegatedFrameData> frame_data(new DelegatedFrameData);
 
+      AppendTextureQuads(num_textures, pass.get(), frame_data.get());
       SharedQuadState* sqs = pass->CreateAndAppendSharedQuadState();
-      for (int j = 0; j < num_textures; j++) {
-        TransferableResource resource;
-        resource.id = j;
-        resource.is_software = true;
-        frame_data->resource_list.push_back(resource);
-
-        TextureDrawQuad* quad =
-            pass->CreateAndAppendDrawQuad<TextureDrawQuad>();
-        const gfx::Rect rect(0, 0, 1, 1);
-        const gfx::Rect opaque_rect;
-        // Half of rects should be visible with partial damage.
-        gfx::Rect visible_rect =
-            j % 2 == 0 ? gfx::Rect(0, 0, 1, 1) : gfx::Rect(1, 1, 1, 1);
-        bool needs_blending = false;
-        bool premultiplied_alpha = false;
-        const gfx::PointF uv_top_left;
-        const gfx::PointF uv_bottom_right;
-        SkColor background_color = SK_ColorGREEN;
-        const float vertex_opacity[4] = {0.f, 0.f, 1.f, 1.f};
-        bool flipped = false;
-        bool nearest_neighbor = false;
-        quad->SetAll(sqs, rect, opaque_rect, visible_rect, needs_blending, j,
-                     gfx::Size(), premultiplied_alpha, uv_top_left,
-                     uv_bottom_right, background_color, vertex_opacity, flipped,
-                     nearest_neighbor, false);
-      }
-      sqs = pass->CreateAndAppendSharedQuadState();
       sqs->opacity = opacity;
       if (i > 1) {
         SurfaceDrawQuad* surface_quad =
@@ -134,6 +141,88 @@ class SurfaceAggregatorPerfTest : public testing::Test {
       factory_.Destroy(SurfaceId(0, i, 0));
   }
 
+  // Like RunTest(), but with |num_surfaces| unchanging sibling surfaces side by
+  // side in the root surface, as with many out-of-process iframes. Each one
+  // draws |num_textures| quads into a contributing pass. With partial damage,
+  // only the area of the first surface is damaged.
+  void RunSiblingSurfacesTest(int num_surfaces,
+                              int num_textures,
+                              float opacity,
+                              bool optimize_damage,
+                              bool full_damage,
+                              const std::string& name) {
+    aggregator_.reset(new SurfaceAggregator(&manager_, resource_provider_.get(),
+                                            optimize_damage));
+    for (int i = 1; i <= num_surfaces; i++) {
+      factory_.Create(SurfaceId(0, i, 0));
+      std::unique_ptr<DelegatedFrameData> frame_data(new DelegatedFrameData);
+
+      std::unique_ptr<RenderPass> contributing_pass(RenderPass::Create());
+      contributing_pass->SetNew(RenderPassId(1, 1), gfx::Rect(0, 0, 10, 10),
+                                gfx::Rect(0, 0, 10, 10), gfx::Transform());
+      AppendTextureQuads(num_textures, contributing_pass.get(),
+                         frame_data.get());
+
+      std::unique_ptr<RenderPass> pass(RenderPass::Create());
+      pass->SetNew(RenderPassId(1, 2), gfx::Rect(0, 0, 10, 10),
+                   gfx::Rect(0, 0, 10, 10), gfx::Transform());
+      SharedQuadState* sqs = pass->CreateAndAppendSharedQuadState();
+      RenderPassDrawQuad* pass_quad =
+          pass->CreateAndAppendDrawQuad<RenderPassDrawQuad>();
+      pass_quad->SetNew(sqs, gfx::Rect(0, 0, 10, 10), gfx::Rect(0, 0, 10, 10),
+                        contributing_pass->id, 0, gfx::Vector2dF(),
+                        gfx::Size(), FilterOperations(), gfx::Vector2dF(),
+                        FilterOperations());
+
+      frame_data->render_pass_list.push_back(std::move(contributing_pass));
+      frame_data->render_pass_list.push_back(std::move(pass));
+      std::unique_ptr<CompositorFrame> frame(new CompositorFrame);
+      frame->delegated_frame_data = std::move(frame_data);
+      factory_.SubmitCompositorFrame(SurfaceId(0, i, 0), std::move(frame),
+                                     SurfaceFactory::DrawCallback());
+    }
+
+    SurfaceId root_surface_id(0, num_surfaces + 1, 0);
+    factory_.Create(root_surface_id);
+    timer_.Reset();
+    do {
+      std::unique_ptr<RenderPass> pass(RenderPass::Create());
+      pass->SetNew(RenderPassId(1, 1), gfx::Rect(0, 0, 100, 100),
+                   full_damage ? gfx::Rect(0, 0, 100, 100)
+                               : gfx::Rect(0, 0, 10, 10),
+                   gfx::Transform());
+      std::unique_ptr<DelegatedFrameData> frame_data(new DelegatedFrameData);
+
+      for (int i = 1; i <= num_surfaces; i++) {
+        SharedQuadState* sqs = pass->CreateAndAppendSharedQuadState();
+        sqs->opacity = opacity;
+        sqs->quad_to_target_transform.Translate(((i - 1) % 10) * 10,
+                                                ((i - 1) / 10) * 10);
+        SurfaceDrawQuad* surface_quad =
+            pass->CreateAndAppendDrawQuad<SurfaceDrawQuad>();
+        surface_quad->SetNew(sqs, gfx::Rect(0, 0, 10, 10),
+                             gfx::Rect(0, 0, 10, 10), SurfaceId(0, i, 0));
+      }
+
+      frame_data->render_pass_list.push_back(std::move(pass));
+      std::unique_ptr<CompositorFrame> frame(new CompositorFrame);
+      frame->delegated_frame_data = std::move(frame_data);
+      factory_.SubmitCompositorFrame(root_surface_id, std::move(frame),
+                                     SurfaceFactory::DrawCallback());
+
+      std::unique_ptr<CompositorFrame> aggregated =
+          aggregator_->Aggregate(root_surface_id);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult("aggregator_speed", "", name, timer_.LapsPerSecond(),
+                           "runs/s", true);
+
+    factory_.Destroy(root_surface_id);
+    for (int i = 1; i <= num_surfaces; i++)
+      factory_.Destroy(SurfaceId(0, i, 0));
+  }
+
  protected:
   SurfaceManager manager_;
   EmptySurfaceFactoryClient empty_client_;
@@ -174,5 +263,19 @@ TEST_F(SurfaceAggregatorPerfTest, FewSurfacesAggregateDamaged) {
   RunTest(3, 1000, 1.f, true, false, "few_surfaces_aggregate_damaged");
 }
 
+TEST_F(SurfaceAggregatorPerfTest, SiblingSurfaces) {
+  RunSiblingSurfacesTest(100, 100, 1.f, false, true, "sibling_surfaces");
+}
+
+TEST_F(SurfaceAggregatorPerfTest, SiblingSurfacesTransparent) {
+  RunSiblingSurfacesTest(100, 100, .5f, false, true,
+                         "sibling_surfaces_transparent");
+}
+
+TEST_F(SurfaceAggregatorPerfTest, SiblingSurfacesAggregateDamaged) {
+  RunSiblingSurfacesTest(100, 100, 1.f, true, false,
+                         "sibling_surfaces_aggregate_damaged");
+}
+
 }  // namespace
 }  // namespace cc
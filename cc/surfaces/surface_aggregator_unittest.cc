@@ -1862,6 +1862,59 @@ TEST_F(SurfaceAggregatorPartialSwapTest, IgnoreOutside) {
   factory_.Destroy(child_surface_id);
 }
 
+// Tests that a pass from a surface which lies entirely outside the damage rect
+// is aggregated without its quads.
+TEST_F(SurfaceAggregatorPartialSwapTest, PassOutsideDamage) {
+  SurfaceId child_surface_id = allocator_.GenerateId();
+  factory_.Create(child_surface_id);
+  {
+    RenderPassId child_pass_ids[] = {RenderPassId(1, 1), RenderPassId(1, 2)};
+    test::Quad child_quads1[] = {test::Quad::SolidColorQuad(SK_ColorGREEN)};
+    test::Quad child_quads2[] = {test::Quad::RenderPassQuad(child_pass_ids[0])};
+    test::Pass child_passes[] = {
+        test::Pass(child_quads1, arraysize(child_quads1), child_pass_ids[0]),
+        test::Pass(child_quads2, arraysize(child_quads2), child_pass_ids[1])};
+
+    RenderPassList child_pass_list;
+    AddPasses(&child_pass_list, gfx::Rect(SurfaceSize()), child_passes,
+              arraysize(child_passes));
+    child_pass_list[0]->transform_to_root_target.Translate(50, 50);
+    SubmitPassListAsFrame(child_surface_id, &child_pass_list);
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    test::Quad root_quads[] = {test::Quad::SurfaceQuad(child_surface_id, 1.f)};
+    test::Pass root_passes[] = {test::Pass(root_quads, arraysize(root_quads))};
+
+    RenderPassList root_pass_list;
+    AddPasses(&root_pass_list, gfx::Rect(SurfaceSize()), root_passes,
+              arraysize(root_passes));
+    root_pass_list[0]->damage_rect = gfx::Rect(0, 0, 1, 1);
+    SubmitPassListAsFrame(root_surface_id_, &root_pass_list);
+
+    std::unique_ptr<CompositorFrame> aggregated_frame =
+        aggregator_.Aggregate(root_surface_id_);
+    ASSERT_TRUE(aggregated_frame);
+    ASSERT_TRUE(aggregated_frame->delegated_frame_data);
+
+    const RenderPassList& aggregated_pass_list =
+        aggregated_frame->delegated_frame_data->render_pass_list;
+    ASSERT_EQ(2u, aggregated_pass_list.size());
+    EXPECT_EQ(1u, aggregated_pass_list[1]->quad_list.size());
+
+    if (i == 0) {
+      // The child surface is new, so all of it is damaged.
+      EXPECT_EQ(gfx::Rect(0, 0, 50, 50), aggregated_pass_list[0]->damage_rect);
+      EXPECT_EQ(1u, aggregated_pass_list[0]->quad_list.size());
+    } else {
+      // Only the root surface changed, and its damage doesn't reach the
+      // child's contributing pass.
+      EXPECT_TRUE(aggregated_pass_list[0]->damage_rect.IsEmpty());
+      EXPECT_EQ(0u, aggregated_pass_list[0]->quad_list.size());
+    }
+  }
+}
+
 class SurfaceAggregatorWithResourcesTest : public testing::Test {
  public:
   void SetUp() override {
@@ -2095,6 +2148,14 @@ TEST_F(SurfaceAggregatorWithResourcesTest, InvalidChildSurface) {
   EXPECT_EQ(1u, pass_list->back()->shared_quad_state_list.size());
   EXPECT_EQ(3u, pass_list->back()->quad_list.size());
 
+  // Aggregating the same frames again gives the same result.
+  frame = aggregator_->Aggregate(root_surface_id);
+
+  pass_list = &frame->delegated_frame_data->render_pass_list;
+  ASSERT_EQ(1u, pass_list->size());
+  EXPECT_EQ(1u, pass_list->back()->shared_quad_state_list.size());
+  EXPECT_EQ(3u, pass_list->back()->quad_list.size());
+
   SubmitCompositorFrameWithResources(ids2, arraysize(ids), true,
                                      child_surface_id, &factory,
                                      middle_surface_id);
@@ -2106,6 +2167,13 @@ TEST_F(SurfaceAggregatorWithResourcesTest, InvalidChildSurface) {
   EXPECT_EQ(3u, pass_list->back()->shared_quad_state_list.size());
   EXPECT_EQ(9u, pass_list->back()->quad_list.size());
 
+  frame = aggregator_->Aggregate(root_surface_id);
+
+  pass_list = &frame->delegated_frame_data->render_pass_list;
+  ASSERT_EQ(1u, pass_list->size());
+  EXPECT_EQ(3u, pass_list->back()->shared_quad_state_list.size());
+  EXPECT_EQ(9u, pass_list->back()->quad_list.size());
+
   factory.Destroy(root_surface_id);
   factory.Destroy(child_surface_id);
   factory.Destroy(middle_surface_id);
@@ -69,8 +69,10 @@ class FakeRecordingSource : public RecordingSource {
     clear_canvas_with_debug_color_ = clear;
   }
 
-  void Rerecord() {
-    SetNeedsDisplayRect(recorded_viewport_);
+  void Rerecord() { RerecordRect(recorded_viewport_); }
+
+  void RerecordRect(const gfx::Rect& invalidated_rect) {
+    SetNeedsDisplayRect(invalidated_rect);
     Region invalidation;
     UpdateAndExpandInvalidation(&client_, &invalidation, size_, 0,
                                 RECORD_NORMALLY);
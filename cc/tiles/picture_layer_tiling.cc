@@ -70,8 +70,7 @@ PictureLayerTiling::~PictureLayerTiling() {
 Tile* PictureLayerTiling::CreateTile(const Tile::CreateInfo& info) {
   const int i = info.tiling_i_index;
   const int j = info.tiling_j_index;
-  TileMapKey key(i, j);
-  DCHECK(tiles_.find(key) == tiles_.end());
+  DCHECK(!tiles_.Get(i, j));
 
   if (!raster_source_->CoversRect(info.enclosing_layer_rect))
     return nullptr;
@@ -79,7 +78,7 @@ Tile* PictureLayerTiling::CreateTile(const Tile::CreateInfo& info) {
   all_tiles_done_ = false;
   ScopedTilePtr tile = client_->CreateTile(info);
   Tile* raw_ptr = tile.get();
-  tiles_[key] = std::move(tile);
+  tiles_.Set(i, j, std::move(tile));
   return raw_ptr;
 }
 
@@ -95,8 +94,7 @@ void PictureLayerTiling::CreateMissingTilesInLiveTilesRect() {
                                  include_borders);
        iter; ++iter) {
     TileMapKey key(iter.index());
-    TileMap::iterator find = tiles_.find(key);
-    if (find != tiles_.end())
+    if (tiles_.Get(key.index_x, key.index_y))
       continue;
 
     Tile::CreateInfo info = CreateInfoForTile(key.index_x, key.index_y);
@@ -144,14 +142,15 @@ void PictureLayerTiling::TakeTilesAndPropertiesFrom(
   }
 
   if (tiles_.empty()) {
-    tiles_.swap(pending_twin->tiles_);
+    tiles_.swap(&pending_twin->tiles_);
     all_tiles_done_ = pending_twin->all_tiles_done_;
   } else {
-    while (!pending_twin->tiles_.empty()) {
-      auto pending_iter = pending_twin->tiles_.begin();
-      tiles_[pending_iter->first] = std::move(pending_iter->second);
-      pending_twin->tiles_.erase(pending_iter);
+    for (Tile* tile : pending_twin->tiles_) {
+      int i = tile->tiling_i_index();
+      int j = tile->tiling_j_index();
+      tiles_.Set(i, j, pending_twin->tiles_.Take(i, j));
     }
+    pending_twin->tiles_.clear();
     all_tiles_done_ &= pending_twin->all_tiles_done_;
   }
   DCHECK(pending_twin->tiles_.empty());
@@ -513,20 +512,11 @@ gfx::RectF PictureLayerTiling::CoverageIterator::texture_rect() const {
 }
 
 ScopedTilePtr PictureLayerTiling::TakeTileAt(int i, int j) {
-  TileMap::iterator found = tiles_.find(TileMapKey(i, j));
-  if (found == tiles_.end())
-    return nullptr;
-  ScopedTilePtr result = std::move(found->second);
-  tiles_.erase(found);
-  return result;
+  return tiles_.Take(i, j);
 }
 
 bool PictureLayerTiling::RemoveTileAt(int i, int j) {
-  TileMap::iterator found = tiles_.find(TileMapKey(i, j));
-  if (found == tiles_.end())
-    return false;
-  tiles_.erase(found);
-  return true;
+  return !!tiles_.Take(i, j);
 }
 
 void PictureLayerTiling::Reset() {
@@ -630,10 +620,8 @@ void PictureLayerTiling::SetLiveTilesRect(
 
 void PictureLayerTiling::VerifyLiveTilesRect(bool is_on_recycle_tree) const {
 #if DCHECK_IS_ON()
-  for (auto it = tiles_.begin(); it != tiles_.end(); ++it) {
-    if (!it->second)
-      continue;
-    TileMapKey key = it->first;
+  for (const Tile* tile : tiles_) {
+    TileMapKey key(tile->tiling_i_index(), tile->tiling_j_index());
     DCHECK(key.index_x < tiling_data_.num_tiles_x())
         << this << " " << key.index_x << "," << key.index_y << " num_tiles_x "
         << tiling_data_.num_tiles_x() << " live_tiles_rect "
@@ -786,8 +774,7 @@ PrioritizedTile PictureLayerTiling::MakePrioritizedTile(
 std::map<const Tile*, PrioritizedTile>
 PictureLayerTiling::UpdateAndGetAllPrioritizedTilesForTesting() const {
   std::map<const Tile*, PrioritizedTile> result;
-  for (const auto& key_tile_pair : tiles_) {
-    Tile* tile = key_tile_pair.second.get();
+  for (Tile* tile : tiles_) {
     UpdateRequiredStatesOnTile(tile);
     PrioritizedTile prioritized_tile =
         MakePrioritizedTile(tile, ComputePriorityRectTypeForTile(tile));
@@ -857,8 +844,7 @@ PictureLayerTiling::ComputePriorityRectTypeForTile(const Tile* tile) const {
 
 void PictureLayerTiling::GetAllPrioritizedTilesForTracing(
     std::vector<PrioritizedTile>* prioritized_tiles) const {
-  for (const auto& tile_pair : tiles_) {
-    Tile* tile = tile_pair.second.get();
+  for (Tile* tile : tiles_) {
     prioritized_tiles->push_back(
         MakePrioritizedTile(tile, ComputePriorityRectTypeForTile(tile)));
   }
@@ -878,10 +864,8 @@ void PictureLayerTiling::AsValueInto(
 
 size_t PictureLayerTiling::GPUMemoryUsageInBytes() const {
   size_t amount = 0;
-  for (TileMap::const_iterator it = tiles_.begin(); it != tiles_.end(); ++it) {
-    const Tile* tile = it->second.get();
+  for (const Tile* tile : tiles_)
     amount += tile->GPUMemoryUsageInBytes();
-  }
   return amount;
 }
 
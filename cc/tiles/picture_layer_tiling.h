@@ -19,6 +19,7 @@
 #include "cc/base/region.h"
 #include "cc/base/tiling_data.h"
 #include "cc/tiles/tile.h"
+#include "cc/tiles/tile_map.h"
 #include "cc/tiles/tile_priority.h"
 #include "cc/trees/occlusion.h"
 #include "ui/gfx/geometry/rect.h"
@@ -122,8 +123,7 @@ class CC_EXPORT PictureLayerTiling {
   const TilingData* tiling_data() const { return &tiling_data_; }
 
   Tile* TileAt(int i, int j) const {
-    TileMap::const_iterator iter = tiles_.find(TileMapKey(i, j));
-    return iter == tiles_.end() ? nullptr : iter->second.get();
+    return tiles_.Get(i, j);
   }
 
   bool has_tiles() const { return !tiles_.empty(); }
@@ -135,10 +135,8 @@ class CC_EXPORT PictureLayerTiling {
 
   void VerifyNoTileNeedsRaster() const {
 #if DCHECK_IS_ON()
-    for (const auto& tile_pair : tiles_) {
-      DCHECK(!tile_pair.second->draw_info().NeedsRaster() ||
-             IsTileOccluded(tile_pair.second.get()));
-    }
+    for (const Tile* tile : tiles_)
+      DCHECK(!tile->draw_info().NeedsRaster() || IsTileOccluded(tile));
 #endif  // DCHECK_IS_ON()
   }
 
@@ -149,14 +147,14 @@ class CC_EXPORT PictureLayerTiling {
   const TilingData& TilingDataForTesting() const { return tiling_data_; }
   std::vector<Tile*> AllTilesForTesting() const {
     std::vector<Tile*> all_tiles;
-    for (TileMap::const_iterator it = tiles_.begin(); it != tiles_.end(); ++it)
-      all_tiles.push_back(it->second.get());
+    for (Tile* tile : tiles_)
+      all_tiles.push_back(tile);
     return all_tiles;
   }
 
   void UpdateAllRequiredStateForTesting() {
-    for (const auto& key_tile_pair : tiles_)
-      UpdateRequiredStatesOnTile(key_tile_pair.second.get());
+    for (Tile* tile : tiles_)
+      UpdateRequiredStatesOnTile(tile);
   }
   std::map<const Tile*, PrioritizedTile>
   UpdateAndGetAllPrioritizedTilesForTesting() const;
@@ -260,8 +258,6 @@ class CC_EXPORT PictureLayerTiling {
     EVENTUALLY_RECT
   };
 
-  using TileMap = std::unordered_map<TileMapKey, ScopedTilePtr, TileMapKeyHash>;
-
   void SetLiveTilesRect(const gfx::Rect& live_tiles_rect);
   void VerifyLiveTilesRect(bool is_on_recycle_tree) const;
   Tile* CreateTile(const Tile::CreateInfo& info);
@@ -329,7 +325,7 @@ class CC_EXPORT PictureLayerTiling {
 
   // Internal data.
   TilingData tiling_data_;
-  TileMap tiles_;  // It is not legal to have a NULL tile in the tiles_ map.
+  TileMap tiles_;
   gfx::Rect live_tiles_rect_;
 
   bool can_require_tiles_for_activation_;
@@ -515,6 +515,36 @@ TEST_F(PictureLayerTilingIteratorTest, LiveTilesExactlyCoverLiveTileRect) {
   SetLiveRectAndVerifyTiles(gfx::Rect(201, 800));
 }
 
+TEST_F(PictureLayerTilingIteratorTest, LiveTilesFollowLiveTileRectAcrossTiling) {
+  Initialize(gfx::Size(100, 100), 1.f, gfx::Size(2000, 4000));
+  const TilingData& tiling_data = tiling_->TilingDataForTesting();
+
+  // Move the live tiles rect down and back up the tiling, as when scrolling.
+  // Exactly the tiles intersecting it should exist at each step.
+  for (int y = 0; y <= 3600; y += 250) {
+    gfx::Rect live_tiles_rect(300, y, 500, 400);
+    SetLiveRectAndVerifyTiles(live_tiles_rect);
+    for (int j = 0; j < tiling_data.num_tiles_y(); ++j) {
+      for (int i = 0; i < tiling_data.num_tiles_x(); ++i) {
+        bool intersects =
+            tiling_data.TileBounds(i, j).Intersects(live_tiles_rect);
+        EXPECT_EQ(intersects, !!tiling_->TileAt(i, j)) << i << "," << j;
+      }
+    }
+  }
+  for (int y = 3600; y >= 0; y -= 350) {
+    gfx::Rect live_tiles_rect(0, y, 2000, 300);
+    SetLiveRectAndVerifyTiles(live_tiles_rect);
+    for (int j = 0; j < tiling_data.num_tiles_y(); ++j) {
+      for (int i = 0; i < tiling_data.num_tiles_x(); ++i) {
+        bool intersects =
+            tiling_data.TileBounds(i, j).Intersects(live_tiles_rect);
+        EXPECT_EQ(intersects, !!tiling_->TileAt(i, j)) << i << "," << j;
+      }
+    }
+  }
+}
+
 TEST_F(PictureLayerTilingIteratorTest, IteratorCoversLayerBoundsNoScale) {
   Initialize(gfx::Size(100, 100), 1.f, gfx::Size(1099, 801));
   VerifyTilesExactlyCoverRect(1, gfx::Rect());
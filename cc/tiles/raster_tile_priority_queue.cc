@@ -14,12 +14,14 @@ std::unique_ptr<RasterTilePriorityQueue> RasterTilePriorityQueue::Create(
     const std::vector<PictureLayerImpl*>& active_layers,
     const std::vector<PictureLayerImpl*>& pending_layers,
     TreePriority tree_priority,
-    Type type) {
+    Type type,
+    TaskGraphRunner* task_graph_runner) {
   switch (type) {
     case Type::ALL: {
       std::unique_ptr<RasterTilePriorityQueueAll> queue(
           new RasterTilePriorityQueueAll);
-      queue->Build(active_layers, pending_layers, tree_priority);
+      queue->Build(active_layers, pending_layers, tree_priority,
+                   task_graph_runner);
       return std::move(queue);
     }
     case Type::REQUIRED_FOR_ACTIVATION:
@@ -14,16 +14,20 @@
 
 namespace cc {
 class PrioritizedTile;
+class TaskGraphRunner;
 
 class CC_EXPORT RasterTilePriorityQueue {
  public:
   enum class Type { ALL, REQUIRED_FOR_ACTIVATION, REQUIRED_FOR_DRAW };
 
+  // If |task_graph_runner| is not null, an ALL queue computes the priorities
+  // of the layers' tiles on its workers in parallel.
   static std::unique_ptr<RasterTilePriorityQueue> Create(
       const std::vector<PictureLayerImpl*>& active_layers,
       const std::vector<PictureLayerImpl*>& pending_layers,
       TreePriority tree_priority,
-      Type type);
+      Type type,
+      TaskGraphRunner* task_graph_runner);
 
   virtual ~RasterTilePriorityQueue() {}
 
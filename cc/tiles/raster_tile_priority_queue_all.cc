@@ -4,13 +4,26 @@
 
 #include "cc/tiles/raster_tile_priority_queue_all.h"
 
+#include <algorithm>
+
+#include "base/atomicops.h"
 #include "base/memory/ptr_util.h"
+#include "cc/raster/task_category.h"
+#include "cc/raster/task_graph_runner.h"
 #include "cc/tiles/tiling_set_raster_queue_all.h"
 
 namespace cc {
 
 namespace {
 
+// Creating the tiling set queues of fewer layers than this per task is not
+// worth the overhead of running tasks.
+const size_t kMinLayersPerTask = 16;
+
+// The most tasks creating tiling set queues on workers, besides the calling
+// thread.
+const size_t kMaxTasks = 3;
+
 class RasterOrderComparator {
  public:
   explicit RasterOrderComparator(TreePriority tree_priority)
@@ -50,6 +63,23 @@ class RasterOrderComparator {
   TreePriority tree_priority_;
 };
 
+std::unique_ptr<TilingSetRasterQueueAll> CreateTilingSetRasterQueue(
+    PictureLayerImpl* layer,
+    TreePriority tree_priority) {
+  if (!layer->HasValidTilePriorities())
+    return nullptr;
+
+  PictureLayerTilingSet* tiling_set = layer->picture_layer_tiling_set();
+  bool prioritize_low_res = tree_priority == SMOOTHNESS_TAKES_PRIORITY;
+  std::unique_ptr<TilingSetRasterQueueAll> tiling_set_queue =
+      base::WrapUnique(
+          new TilingSetRasterQueueAll(tiling_set, prioritize_low_res));
+  // Queues will only contain non empty tiling sets.
+  if (tiling_set_queue->IsEmpty())
+    return nullptr;
+  return tiling_set_queue;
+}
+
 void CreateTilingSetRasterQueues(
     const std::vector<PictureLayerImpl*>& layers,
     TreePriority tree_priority,
@@ -57,22 +87,124 @@ void CreateTilingSetRasterQueues(
   DCHECK(queues->empty());
 
   for (auto* layer : layers) {
-    if (!layer->HasValidTilePriorities())
-      continue;
-
-    PictureLayerTilingSet* tiling_set = layer->picture_layer_tiling_set();
-    bool prioritize_low_res = tree_priority == SMOOTHNESS_TAKES_PRIORITY;
     std::unique_ptr<TilingSetRasterQueueAll> tiling_set_queue =
-        base::WrapUnique(
-            new TilingSetRasterQueueAll(tiling_set, prioritize_low_res));
-    // Queues will only contain non empty tiling sets.
-    if (!tiling_set_queue->IsEmpty())
+        CreateTilingSetRasterQueue(layer, tree_priority);
+    if (tiling_set_queue)
       queues->push_back(std::move(tiling_set_queue));
   }
   std::make_heap(queues->begin(), queues->end(),
                  RasterOrderComparator(tree_priority));
 }
 
+// Creates the tiling set queues of |layers| on any number of threads at once.
+// Each thread takes the next layer whose queue nobody has started creating.
+// The tiling sets of different layers share no state which creating a queue
+// modifies.
+class TilingSetRasterQueueBuilder {
+ public:
+  TilingSetRasterQueueBuilder(const std::vector<PictureLayerImpl*>* layers,
+                              TreePriority tree_priority)
+      : layers_(layers),
+        tree_priority_(tree_priority),
+        queues_(layers->size()),
+        next_layer_index_(0) {}
+
+  // Creates queues until every layer has been taken by some thread.
+  void CreateQueues() {
+    for (;;) {
+      size_t index = static_cast<size_t>(
+          base::subtle::NoBarrier_AtomicIncrement(&next_layer_index_, 1) - 1);
+      if (index >= layers_->size())
+        return;
+      queues_[index] =
+          CreateTilingSetRasterQueue((*layers_)[index], tree_priority_);
+    }
+  }
+
+  // Moves the queues of the layers in [begin, end) to |queues|, in layer
+  // order. Only valid once no thread is creating queues anymore.
+  void TakeQueues(
+      size_t begin,
+      size_t end,
+      std::vector<std::unique_ptr<TilingSetRasterQueueAll>>* queues) {
+    DCHECK(queues->empty());
+    for (size_t i = begin; i < end; ++i) {
+      if (queues_[i])
+        queues->push_back(std::move(queues_[i]));
+    }
+    std::make_heap(queues->begin(), queues->end(),
+                   RasterOrderComparator(tree_priority_));
+  }
+
+ private:
+  const std::vector<PictureLayerImpl*>* const layers_;
+  const TreePriority tree_priority_;
+  std::vector<std::unique_ptr<TilingSetRasterQueueAll>> queues_;
+  base::subtle::Atomic32 next_layer_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(TilingSetRasterQueueBuilder);
+};
+
+class CreateTilingSetRasterQueuesTask : public Task {
+ public:
+  explicit CreateTilingSetRasterQueuesTask(
+      TilingSetRasterQueueBuilder* builder)
+      : builder_(builder) {}
+
+  // Overridden from Task:
+  void RunOnWorkerThread() override { builder_->CreateQueues(); }
+
+ private:
+  ~CreateTilingSetRasterQueuesTask() override {}
+
+  TilingSetRasterQueueBuilder* const builder_;
+
+  DISALLOW_COPY_AND_ASSIGN(CreateTilingSetRasterQueuesTask);
+};
+
+// Like CreateTilingSetRasterQueues() for both trees, but creates the queues on
+// up to |num_tasks| workers of |task_graph_runner| and the calling thread.
+void CreateTilingSetRasterQueuesInParallel(
+    const std::vector<PictureLayerImpl*>& active_layers,
+    const std::vector<PictureLayerImpl*>& pending_layers,
+    TreePriority tree_priority,
+    TaskGraphRunner* task_graph_runner,
+    size_t num_tasks,
+    std::vector<std::unique_ptr<TilingSetRasterQueueAll>>* active_queues,
+    std::vector<std::unique_ptr<TilingSetRasterQueueAll>>* pending_queues) {
+  std::vector<PictureLayerImpl*> layers;
+  layers.reserve(active_layers.size() + pending_layers.size());
+  layers.insert(layers.end(), active_layers.begin(), active_layers.end());
+  layers.insert(layers.end(), pending_layers.begin(), pending_layers.end());
+  TilingSetRasterQueueBuilder builder(&layers, tree_priority);
+
+  NamespaceToken token = task_graph_runner->GetNamespaceToken();
+  Task::Vector tasks;
+  TaskGraph graph;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    tasks.push_back(
+        make_scoped_refptr(new CreateTilingSetRasterQueuesTask(&builder)));
+    graph.nodes.push_back(
+        TaskGraph::Node(tasks.back().get(), TASK_CATEGORY_FOREGROUND, 0u, 0u));
+  }
+  task_graph_runner->ScheduleTasks(token, &graph);
+
+  // Workers may all be busy rastering, so this thread creates queues too
+  // rather than waiting for tasks to start.
+  builder.CreateQueues();
+
+  // Every layer has been taken by now. Cancel the tasks which have not started
+  // yet, and wait for the others to finish the layers they took.
+  TaskGraph empty_graph;
+  task_graph_runner->ScheduleTasks(token, &empty_graph);
+  task_graph_runner->WaitForTasksToFinishRunning(token);
+  Task::Vector completed_tasks;
+  task_graph_runner->CollectCompletedTasks(token, &completed_tasks);
+
+  builder.TakeQueues(0, active_layers.size(), active_queues);
+  builder.TakeQueues(active_layers.size(), layers.size(), pending_queues);
+}
+
 }  // namespace
 
 RasterTilePriorityQueueAll::RasterTilePriorityQueueAll() {
@@ -84,9 +216,23 @@ RasterTilePriorityQueueAll::~RasterTilePriorityQueueAll() {
 void RasterTilePriorityQueueAll::Build(
     const std::vector<PictureLayerImpl*>& active_layers,
     const std::vector<PictureLayerImpl*>& pending_layers,
-    TreePriority tree_priority) {
+    TreePriority tree_priority,
+    TaskGraphRunner* task_graph_runner) {
   tree_priority_ = tree_priority;
 
+  size_t num_tasks = 0;
+  if (task_graph_runner) {
+    num_tasks = std::min(
+        (active_layers.size() + pending_layers.size()) / kMinLayersPerTask,
+        kMaxTasks);
+  }
+  if (num_tasks) {
+    CreateTilingSetRasterQueuesInParallel(
+        active_layers, pending_layers, tree_priority_, task_graph_runner,
+        num_tasks, &active_queues_, &pending_queues_);
+    return;
+  }
+
   CreateTilingSetRasterQueues(active_layers, tree_priority_, &active_queues_);
   CreateTilingSetRasterQueues(pending_layers, tree_priority_, &pending_queues_);
 }
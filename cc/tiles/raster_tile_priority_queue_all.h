@@ -17,6 +17,7 @@
 #include "cc/tiles/tiling_set_raster_queue_all.h"
 
 namespace cc {
+class TaskGraphRunner;
 
 class CC_EXPORT RasterTilePriorityQueueAll : public RasterTilePriorityQueue {
  public:
@@ -30,9 +31,12 @@ class CC_EXPORT RasterTilePriorityQueueAll : public RasterTilePriorityQueue {
  private:
   friend class RasterTilePriorityQueue;
 
+  // If |task_graph_runner| is not null, the tiling set queues of many layers
+  // are created on its workers as well as on the calling thread.
   void Build(const std::vector<PictureLayerImpl*>& active_layers,
              const std::vector<PictureLayerImpl*>& pending_layers,
-             TreePriority tree_priority);
+             TreePriority tree_priority,
+             TaskGraphRunner* task_graph_runner);
 
   std::vector<std::unique_ptr<TilingSetRasterQueueAll>>& GetNextQueues();
   const std::vector<std::unique_ptr<TilingSetRasterQueueAll>>& GetNextQueues()
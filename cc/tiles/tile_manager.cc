@@ -37,6 +37,31 @@ namespace {
 // a tile is of solid color.
 const bool kUseColorEstimator = true;
 
+// Once no more tiles can be scheduled for raster, the images of up to this many
+// of the SOON tiles which would be rastered next are still decoded, so that
+// their raster does not wait on the decodes when it gets scheduled.
+const size_t kMaxTilesToPredecodePastRasterBudget = 32;
+
+// Adds |prioritized_tile| to the tiles whose images are decoded once the
+// raster budget is used up. Returns false if the tile is too far out or the
+// predecode budget is used up, in which case no more tiles should be added.
+bool AddTileToPredecodePastRasterBudget(
+    const PrioritizedTile& prioritized_tile,
+    size_t* num_tiles_predecoded,
+    std::vector<PrioritizedTile>* tiles_to_process_for_images) {
+  const TilePriority& priority = prioritized_tile.priority();
+  if (priority.priority_bin > TilePriority::SOON ||
+      *num_tiles_predecoded >= kMaxTilesToPredecodePastRasterBudget) {
+    return false;
+  }
+  // Low resolution tiles are rastered without images.
+  if (priority.resolution == LOW_RESOLUTION)
+    return true;
+  tiles_to_process_for_images->push_back(prioritized_tile);
+  ++*num_tiles_predecoded;
+  return true;
+}
+
 DEFINE_SCOPED_UMA_HISTOGRAM_AREA_TIMER(
     ScopedRasterTaskTimer,
     "Compositing.%s.RasterTask.RasterUs",
@@ -621,6 +646,8 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
                                 RasterTilePriorityQueue::Type::ALL));
   std::unique_ptr<EvictionTilePriorityQueue> eviction_priority_queue;
   PrioritizedWorkToSchedule work_to_schedule;
+  bool reached_raster_budget = false;
+  size_t num_tiles_predecoded_past_raster_budget = 0;
   for (; !raster_priority_queue->IsEmpty(); raster_priority_queue->Pop()) {
     const PrioritizedTile& prioritized_tile = raster_priority_queue->Top();
     Tile* tile = prioritized_tile.tile();
@@ -633,6 +660,15 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
       break;
     }
 
+    if (reached_raster_budget) {
+      if (!AddTileToPredecodePastRasterBudget(
+              prioritized_tile, &num_tiles_predecoded_past_raster_budget,
+              &work_to_schedule.tiles_to_process_for_images)) {
+        break;
+      }
+      continue;
+    }
+
     bool tile_is_needed_now = priority.priority_bin == TilePriority::NOW;
     if (tile->use_picture_analysis() && kUseColorEstimator) {
       // We analyze for solid color here, to decide to continue
@@ -661,11 +697,18 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
       continue;
     }
 
-    // We won't be able to schedule this tile, so break out early.
+    // We won't be able to schedule this tile, so only look at it and the
+    // following tiles for images.
     if (work_to_schedule.tiles_to_raster.size() >=
         scheduled_raster_task_limit_) {
       all_tiles_that_need_to_be_rasterized_are_scheduled_ = false;
-      break;
+      reached_raster_budget = true;
+      if (!AddTileToPredecodePastRasterBudget(
+              prioritized_tile, &num_tiles_predecoded_past_raster_budget,
+              &work_to_schedule.tiles_to_process_for_images)) {
+        break;
+      }
+      continue;
     }
 
     tile->scheduled_priority_ = schedule_priority++;
@@ -698,12 +741,19 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
         !memory_usage.Exceeds(scheduled_tile_memory_limit);
 
     // If we couldn't fit the tile into our current memory limit, then we're
-    // done.
+    // done rastering. Decoded images don't use the tile memory budget, so keep
+    // going for those.
     if (!memory_usage_is_within_limit) {
       if (tile_is_needed_now)
         had_enough_memory_to_schedule_tiles_needed_now = false;
       all_tiles_that_need_to_be_rasterized_are_scheduled_ = false;
-      break;
+      reached_raster_budget = true;
+      if (!AddTileToPredecodePastRasterBudget(
+              prioritized_tile, &num_tiles_predecoded_past_raster_budget,
+              &work_to_schedule.tiles_to_process_for_images)) {
+        break;
+      }
+      continue;
     }
 
     memory_usage += memory_required_by_tile_to_be_scheduled;
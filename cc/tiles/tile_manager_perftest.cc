@@ -11,6 +11,7 @@
 #include "base/time/time.h"
 #include "cc/debug/lap_timer.h"
 #include "cc/raster/raster_buffer.h"
+#include "cc/raster/work_stealing_task_graph_runner.h"
 #include "cc/test/begin_frame_args_test.h"
 #include "cc/test/fake_impl_task_runner_provider.h"
 #include "cc/test/fake_layer_tree_host_impl.h"
@@ -25,6 +26,7 @@
 #include "cc/test/test_shared_bitmap_manager.h"
 #include "cc/test/test_task_graph_runner.h"
 #include "cc/test/test_tile_priorities.h"
+#include "cc/tiles/raster_tile_priority_queue.h"
 #include "cc/tiles/tile.h"
 #include "cc/tiles/tile_priority.h"
 #include "cc/trees/layer_tree_impl.h"
@@ -69,7 +71,8 @@ class TileManagerPerfTest : public TestLayerTreeHostBase {
   }
 
   void RunRasterQueueConstructTest(const std::string& test_name,
-                                   int layer_count) {
+                                   int layer_count,
+                                   TaskGraphRunner* task_graph_runner) {
     TreePriority priorities[] = {SAME_PRIORITY_FOR_BOTH_TREES,
                                  SMOOTHNESS_TAKES_PRIORITY,
                                  NEW_CONTENT_TAKES_PRIORITY};
@@ -79,11 +82,16 @@ class TileManagerPerfTest : public TestLayerTreeHostBase {
     for (const auto& layer : layers)
       layer->UpdateTiles();
 
+    const std::vector<PictureLayerImpl*>& active_layers =
+        host_impl()->active_tree()->picture_layers();
+    const std::vector<PictureLayerImpl*>& pending_layers =
+        host_impl()->pending_tree()->picture_layers();
     timer_.Reset();
     do {
       std::unique_ptr<RasterTilePriorityQueue> queue(
-          host_impl()->BuildRasterQueue(priorities[priority_count],
-                                        RasterTilePriorityQueue::Type::ALL));
+          RasterTilePriorityQueue::Create(
+              active_layers, pending_layers, priorities[priority_count],
+              RasterTilePriorityQueue::Type::ALL, task_graph_runner));
       priority_count = (priority_count + 1) % arraysize(priorities);
       timer_.NextLap();
     } while (!timer_.HasTimeLimitExpired());
@@ -313,9 +321,24 @@ TEST_F(TileManagerPerfTest, PrepareTiles) {
 }
 
 TEST_F(TileManagerPerfTest, RasterTileQueueConstruct) {
-  RunRasterQueueConstructTest("2", 2);
-  RunRasterQueueConstructTest("10", 10);
-  RunRasterQueueConstructTest("50", 50);
+  RunRasterQueueConstructTest("2", 2, nullptr);
+  RunRasterQueueConstructTest("10", 10, nullptr);
+  RunRasterQueueConstructTest("50", 50, nullptr);
+  RunRasterQueueConstructTest("200", 200, nullptr);
+}
+
+TEST_F(TileManagerPerfTest, RasterTileQueueConstructInParallel) {
+  WorkStealingTaskGraphRunner task_graph_runner(
+      WorkStealingTaskGraphRunner::kDefaultMaxClaimedTasks);
+  task_graph_runner.Start(3, "TileManagerPerfTest",
+                          base::SimpleThread::Options());
+
+  RunRasterQueueConstructTest("parallel_2", 2, &task_graph_runner);
+  RunRasterQueueConstructTest("parallel_10", 10, &task_graph_runner);
+  RunRasterQueueConstructTest("parallel_50", 50, &task_graph_runner);
+  RunRasterQueueConstructTest("parallel_200", 200, &task_graph_runner);
+
+  task_graph_runner.Shutdown();
 }
 
 TEST_F(TileManagerPerfTest, RasterTileQueueConstructAndIterate) {
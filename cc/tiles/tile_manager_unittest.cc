@@ -1022,6 +1022,64 @@ TEST_F(TileManagerTilePriorityQueueTest, RasterTilePriorityQueueEmptyLayers) {
   EXPECT_EQ(16u, tile_count);
 }
 
+TEST_F(TileManagerTilePriorityQueueTest, RasterTilePriorityQueueInParallel) {
+  const gfx::Size layer_bounds(1000, 1000);
+  host_impl()->SetViewportSize(gfx::Size(500, 500));
+  SetupDefaultTrees(layer_bounds);
+
+  // Enough layers for the queues of some of them to be created on workers.
+  scoped_refptr<FakeRasterSource> raster_source =
+      FakeRasterSource::CreateFilled(layer_bounds);
+  std::vector<FakePictureLayerImpl*> layers;
+  for (int i = 1; i < 40; ++i) {
+    std::unique_ptr<FakePictureLayerImpl> pending_child_layer =
+        FakePictureLayerImpl::CreateWithRasterSource(
+            host_impl()->pending_tree(), layer_id() + i, raster_source);
+    pending_child_layer->SetBounds(layer_bounds);
+    pending_child_layer->SetDrawsContent(true);
+    layers.push_back(pending_child_layer.get());
+    pending_layer()->AddChild(std::move(pending_child_layer));
+  }
+  host_impl()->pending_tree()->property_trees()->needs_rebuild = true;
+  host_impl()->pending_tree()->BuildLayerListAndPropertyTreesForTesting();
+  bool update_lcd_text = false;
+  host_impl()->pending_tree()->UpdateDrawProperties(update_lcd_text);
+  for (FakePictureLayerImpl* layer : layers)
+    layer->CreateAllTiles();
+
+  const std::vector<PictureLayerImpl*>& active_layers =
+      host_impl()->active_tree()->picture_layers();
+  const std::vector<PictureLayerImpl*>& pending_layers =
+      host_impl()->pending_tree()->picture_layers();
+  TreePriority priorities[] = {SAME_PRIORITY_FOR_BOTH_TREES,
+                               SMOOTHNESS_TAKES_PRIORITY,
+                               NEW_CONTENT_TAKES_PRIORITY};
+  for (TreePriority tree_priority : priorities) {
+    std::unique_ptr<RasterTilePriorityQueue> serial_queue =
+        RasterTilePriorityQueue::Create(active_layers, pending_layers,
+                                        tree_priority,
+                                        RasterTilePriorityQueue::Type::ALL,
+                                        nullptr);
+    std::unique_ptr<RasterTilePriorityQueue> parallel_queue =
+        RasterTilePriorityQueue::Create(active_layers, pending_layers,
+                                        tree_priority,
+                                        RasterTilePriorityQueue::Type::ALL,
+                                        task_graph_runner());
+
+    // Both queues return the same tiles in the same order.
+    size_t tile_count = 0;
+    while (!serial_queue->IsEmpty()) {
+      ASSERT_FALSE(parallel_queue->IsEmpty());
+      EXPECT_EQ(serial_queue->Top().tile(), parallel_queue->Top().tile());
+      serial_queue->Pop();
+      parallel_queue->Pop();
+      ++tile_count;
+    }
+    EXPECT_TRUE(parallel_queue->IsEmpty());
+    EXPECT_LT(0u, tile_count);
+  }
+}
+
 TEST_F(TileManagerTilePriorityQueueTest, EvictionTilePriorityQueueEmptyLayers) {
   const gfx::Size layer_bounds(1000, 1000);
   host_impl()->SetViewportSize(layer_bounds);
@@ -0,0 +1,99 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/tiles/tile_map.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace cc {
+
+TileMap::TileMap() : num_tiles_(0) {}
+
+TileMap::~TileMap() {}
+
+void TileMap::Set(int i, int j, ScopedTilePtr tile) {
+  DCHECK(tile);
+  DCHECK_GE(i, 0);
+  DCHECK_GE(j, 0);
+  if (!index_bounds_.Contains(i, j))
+    GrowToContain(i, j);
+  ScopedTilePtr& slot = tiles_[SlotIndex(i, j)];
+  if (!slot)
+    ++num_tiles_;
+  slot = std::move(tile);
+}
+
+ScopedTilePtr TileMap::Take(int i, int j) {
+  if (!index_bounds_.Contains(i, j))
+    return nullptr;
+  ScopedTilePtr tile = std::move(tiles_[SlotIndex(i, j)]);
+  if (tile)
+    --num_tiles_;
+  return tile;
+}
+
+void TileMap::clear() {
+  tiles_.clear();
+  index_bounds_ = gfx::Rect();
+  num_tiles_ = 0;
+}
+
+void TileMap::swap(TileMap* other) {
+  std::swap(index_bounds_, other->index_bounds_);
+  tiles_.swap(other->tiles_);
+  std::swap(num_tiles_, other->num_tiles_);
+}
+
+void TileMap::GrowToContain(int i, int j) {
+  // Shrink to the tiles which are still in the map before growing, so that
+  // moving the live tiles rect across a tiling does not keep the whole path
+  // allocated.
+  gfx::Rect needed(i, j, 1, 1);
+  for (size_t index = 0; index < tiles_.size(); ++index) {
+    if (!tiles_[index])
+      continue;
+    int width = index_bounds_.width();
+    needed.Union(gfx::Rect(index_bounds_.x() + static_cast<int>(index % width),
+                           index_bounds_.y() + static_cast<int>(index / width),
+                           1, 1));
+  }
+
+  // Leave as much room again in the directions the grid grows in, so that
+  // filling a rect one tile at a time does not reallocate for every tile.
+  int left = needed.x();
+  int top = needed.y();
+  int right = needed.right();
+  int bottom = needed.bottom();
+  if (num_tiles_) {
+    if (i < index_bounds_.x())
+      left = std::max(0, left - needed.width());
+    if (i >= index_bounds_.right())
+      right += needed.width();
+    if (j < index_bounds_.y())
+      top = std::max(0, top - needed.height());
+    if (j >= index_bounds_.bottom())
+      bottom += needed.height();
+  }
+  gfx::Rect new_index_bounds(left, top, right - left, bottom - top);
+
+  std::vector<ScopedTilePtr> new_tiles(
+      static_cast<size_t>(new_index_bounds.width()) *
+      new_index_bounds.height());
+  gfx::Rect old_index_bounds = index_bounds_;
+  index_bounds_ = new_index_bounds;
+  for (size_t index = 0; index < tiles_.size(); ++index) {
+    if (!tiles_[index])
+      continue;
+    int width = old_index_bounds.width();
+    int old_i = old_index_bounds.x() + static_cast<int>(index % width);
+    int old_j = old_index_bounds.y() + static_cast<int>(index / width);
+    new_tiles[SlotIndex(old_i, old_j)] = std::move(tiles_[index]);
+  }
+  tiles_.swap(new_tiles);
+}
+
+}  // namespace cc
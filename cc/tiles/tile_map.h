@@ -0,0 +1,98 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_TILES_TILE_MAP_H_
+#define CC_TILES_TILE_MAP_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "cc/base/cc_export.h"
+#include "cc/tiles/tile.h"
+#include "ui/gfx/geometry/rect.h"
+
+namespace cc {
+
+// Owns the tiles of a PictureLayerTiling, keyed by their tiling indices. The
+// tiles are stored in a row-major grid covering a rect of indices around them,
+// so lookups are an index computation instead of a hash and walking all tiles
+// is a linear scan. The grid only grows when a tile is set outside of it, at
+// which point the rows and columns left empty by removed tiles are dropped.
+class CC_EXPORT TileMap {
+ public:
+  // Walks the tiles in the map in row-major order. Tiles may be taken from the
+  // map while iterating, but not set.
+  class CC_EXPORT Iterator {
+   public:
+    Tile* operator*() const { return (*tiles_)[index_].get(); }
+    Iterator& operator++() {
+      ++index_;
+      SkipEmptySlots();
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    friend class TileMap;
+
+    Iterator(const std::vector<ScopedTilePtr>* tiles, size_t index)
+        : tiles_(tiles), index_(index) {
+      SkipEmptySlots();
+    }
+    void SkipEmptySlots() {
+      while (index_ < tiles_->size() && !(*tiles_)[index_])
+        ++index_;
+    }
+
+    const std::vector<ScopedTilePtr>* tiles_;
+    size_t index_;
+  };
+
+  TileMap();
+  ~TileMap();
+
+  Tile* Get(int i, int j) const {
+    if (!index_bounds_.Contains(i, j))
+      return nullptr;
+    return tiles_[SlotIndex(i, j)].get();
+  }
+
+  // Stores |tile| at (i, j), deleting the tile which was there if any.
+  void Set(int i, int j, ScopedTilePtr tile);
+  // Removes the tile at (i, j) from the map and returns it, or returns null if
+  // there is none.
+  ScopedTilePtr Take(int i, int j);
+
+  bool empty() const { return !num_tiles_; }
+  size_t size() const { return num_tiles_; }
+  void clear();
+  void swap(TileMap* other);
+
+  Iterator begin() const { return Iterator(&tiles_, 0); }
+  Iterator end() const { return Iterator(&tiles_, tiles_.size()); }
+
+ private:
+  size_t SlotIndex(int i, int j) const {
+    return static_cast<size_t>(j - index_bounds_.y()) * index_bounds_.width() +
+           (i - index_bounds_.x());
+  }
+
+  // Reallocates the grid so that it contains (i, j).
+  void GrowToContain(int i, int j);
+
+  // The tiling indices covered by |tiles_|, with i along x and j along y.
+  gfx::Rect index_bounds_;
+  std::vector<ScopedTilePtr> tiles_;
+  size_t num_tiles_;
+
+  DISALLOW_COPY_AND_ASSIGN(TileMap);
+};
+
+}  // namespace cc
+
+#endif  // CC_TILES_TILE_MAP_H_
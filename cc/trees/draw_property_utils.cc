@@ -785,11 +785,16 @@ void ComputeClips(ClipTree* clip_tree,
 }
 
 void ComputeTransforms(TransformTree* transform_tree) {
-  if (!transform_tree->needs_update())
+  if (transform_tree->needs_update()) {
+    for (int i = 1; i < static_cast<int>(transform_tree->size()); ++i)
+      transform_tree->UpdateTransforms(i);
+  } else if (transform_tree->needs_partial_update()) {
+    transform_tree->UpdateChangedTransforms();
+  } else {
     return;
-  for (int i = 1; i < static_cast<int>(transform_tree->size()); ++i)
-    transform_tree->UpdateTransforms(i);
+  }
   transform_tree->set_needs_update(false);
+  transform_tree->set_needs_partial_update(false);
 }
 
 void UpdateRenderTarget(EffectTree* effect_tree,
@@ -898,7 +903,8 @@ static void ComputeVisibleRectsInternal(
     property_trees->non_root_surfaces_enabled = can_render_to_separate_surface;
     property_trees->transform_tree.set_needs_update(true);
   }
-  if (property_trees->transform_tree.needs_update()) {
+  if (property_trees->transform_tree.needs_update() ||
+      property_trees->transform_tree.needs_partial_update()) {
     property_trees->clip_tree.set_needs_update(true);
     property_trees->effect_tree.set_needs_update(true);
   }
@@ -929,7 +935,8 @@ void UpdatePropertyTrees(PropertyTrees* property_trees,
     property_trees->non_root_surfaces_enabled = can_render_to_separate_surface;
     property_trees->transform_tree.set_needs_update(true);
   }
-  if (property_trees->transform_tree.needs_update()) {
+  if (property_trees->transform_tree.needs_update() ||
+      property_trees->transform_tree.needs_partial_update()) {
     property_trees->clip_tree.set_needs_update(true);
     property_trees->effect_tree.set_needs_update(true);
   }
@@ -1358,8 +1365,7 @@ static void UpdateElasticOverscrollInternal(
     return;
 
   node->data.scroll_offset = gfx::ScrollOffset(elastic_overscroll);
-  node->data.needs_local_transform_update = true;
-  property_trees->transform_tree.set_needs_update(true);
+  property_trees->transform_tree.SetNeedsLocalTransformUpdate(node);
 }
 
 void UpdateElasticOverscroll(PropertyTrees* property_trees,
@@ -1291,11 +1291,20 @@ std::unique_ptr<RasterTilePriorityQueue> LayerTreeHostImpl::BuildRasterQueue(
   TRACE_EVENT0("disabled-by-default-cc.debug",
                "LayerTreeHostImpl::BuildRasterQueue");
 
+  // The synchronous task graph runner only runs tasks when this thread lets
+  // it, so the queue is built serially in that mode.
+  TaskGraphRunner* task_graph_runner = nullptr;
+  if (settings_.parallel_raster_queue_construction &&
+      !is_synchronous_single_threaded_) {
+    task_graph_runner = task_graph_runner_;
+  }
+
   return RasterTilePriorityQueue::Create(active_tree_->picture_layers(),
                                          pending_tree_
                                              ? pending_tree_->picture_layers()
                                              : std::vector<PictureLayerImpl*>(),
-                                         tree_priority, type);
+                                         tree_priority, type,
+                                         task_graph_runner);
 }
 
 std::unique_ptr<EvictionTilePriorityQueue>
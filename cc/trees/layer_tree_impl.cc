@@ -150,8 +150,7 @@ void LayerTreeImpl::DidUpdateScrollOffset(int layer_id, int transform_id) {
     if (node->data.scroll_offset !=
         scroll_tree.current_scroll_offset(layer_id)) {
       node->data.scroll_offset = scroll_tree.current_scroll_offset(layer_id);
-      node->data.needs_local_transform_update = true;
-      transform_tree.set_needs_update(true);
+      transform_tree.SetNeedsLocalTransformUpdate(node);
     }
     node->data.transform_changed = true;
     property_trees()->changed = true;
@@ -622,8 +621,7 @@ void LayerTreeImpl::UpdatePropertyTreeScrollingAndAnimationFromMainThread() {
           node->data.local == layer_id_to_transform.second)
         continue;
       node->data.local = layer_id_to_transform.second;
-      node->data.needs_local_transform_update = true;
-      property_trees_.transform_tree.set_needs_update(true);
+      property_trees_.transform_tree.SetNeedsLocalTransformUpdate(node);
     }
   }
   transform_animations_map_.clear();
@@ -113,6 +113,8 @@ bool LayerTreeSettings::operator==(const LayerTreeSettings& other) const {
          scheduled_raster_task_limit == other.scheduled_raster_task_limit &&
          use_occlusion_for_tile_prioritization ==
              other.use_occlusion_for_tile_prioritization &&
+         parallel_raster_queue_construction ==
+             other.parallel_raster_queue_construction &&
          verify_clip_tree_calculations == other.verify_clip_tree_calculations &&
          image_decode_tasks_enabled == other.image_decode_tasks_enabled &&
          wait_for_beginframe_interval == other.wait_for_beginframe_interval &&
@@ -173,6 +175,8 @@ void LayerTreeSettings::ToProtobuf(proto::LayerTreeSettings* proto) const {
   proto->set_scheduled_raster_task_limit(scheduled_raster_task_limit);
   proto->set_use_occlusion_for_tile_prioritization(
       use_occlusion_for_tile_prioritization);
+  proto->set_parallel_raster_queue_construction(
+      parallel_raster_queue_construction);
   proto->set_image_decode_tasks_enabled(image_decode_tasks_enabled);
   proto->set_wait_for_beginframe_interval(wait_for_beginframe_interval);
   proto->set_max_staging_buffer_usage_in_bytes(
@@ -236,6 +240,8 @@ void LayerTreeSettings::FromProtobuf(const proto::LayerTreeSettings& proto) {
   scheduled_raster_task_limit = proto.scheduled_raster_task_limit();
   use_occlusion_for_tile_prioritization =
       proto.use_occlusion_for_tile_prioritization();
+  parallel_raster_queue_construction =
+      proto.parallel_raster_queue_construction();
   image_decode_tasks_enabled = proto.image_decode_tasks_enabled();
   wait_for_beginframe_interval = proto.wait_for_beginframe_interval();
   max_staging_buffer_usage_in_bytes = proto.max_staging_buffer_usage_in_bytes();
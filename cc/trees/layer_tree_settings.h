@@ -90,6 +90,7 @@ class CC_EXPORT LayerTreeSettings {
   bool ignore_root_layer_flings = false;
   size_t scheduled_raster_task_limit = 32;
   bool use_occlusion_for_tile_prioritization = false;
+  bool parallel_raster_queue_construction = false;
   bool verify_clip_tree_calculations = false;
   bool image_decode_tasks_enabled = false;
   bool wait_for_beginframe_interval = true;
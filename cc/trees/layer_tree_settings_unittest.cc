@@ -84,6 +84,8 @@ TEST(LayerTreeSettingsTest, AllMembersChanged) {
       settings.scheduled_raster_task_limit * 3 + 1;
   settings.use_occlusion_for_tile_prioritization =
       !settings.use_occlusion_for_tile_prioritization;
+  settings.parallel_raster_queue_construction =
+      !settings.parallel_raster_queue_construction;
   settings.wait_for_beginframe_interval =
       !settings.wait_for_beginframe_interval;
   settings.max_staging_buffer_usage_in_bytes =
@@ -140,6 +142,7 @@ TEST(LayerTreeSettingsTest, ArbitraryValues) {
   settings.ignore_root_layer_flings = true;
   settings.scheduled_raster_task_limit = 41;
   settings.use_occlusion_for_tile_prioritization = true;
+  settings.parallel_raster_queue_construction = true;
   settings.wait_for_beginframe_interval = true;
   settings.max_staging_buffer_usage_in_bytes = 70;
   settings.memory_policy_ = ManagedMemoryPolicy(
@@ -77,6 +77,7 @@ PropertyTree<T>::~PropertyTree() {
 
 TransformTree::TransformTree()
     : source_to_parent_updates_allowed_(true),
+      needs_partial_update_(false),
       page_scale_factor_(1.f),
       device_scale_factor_(1.f),
       device_transform_scale_factor_(1.f) {
@@ -736,6 +737,8 @@ int TransformTree::Insert(const TransformNode& tree_node, int parent_id) {
 void TransformTree::clear() {
   PropertyTree<TransformNode>::clear();
 
+  needs_partial_update_ = false;
+
   nodes_affected_by_inner_viewport_bounds_delta_.clear();
   nodes_affected_by_outer_viewport_bounds_delta_.clear();
   cached_data_.clear();
@@ -829,6 +832,34 @@ void TransformTree::UpdateTransforms(int id) {
   UpdateNodeAndAncestorsAreAnimatedOrInvertible(node, parent_node);
 }
 
+void TransformTree::SetNeedsLocalTransformUpdate(TransformNode* node) {
+  node->data.needs_local_transform_update = true;
+  needs_partial_update_ = true;
+}
+
+void TransformTree::UpdateChangedTransforms() {
+  // Like a full update, this visits the nodes in id order, so updated nodes are
+  // seen before the nodes that depend on them.
+  std::vector<bool> updated(size(), false);
+  auto was_updated = [&updated](int dependency_id, int id) {
+    return dependency_id > 0 && dependency_id < id && updated[dependency_id];
+  };
+  for (int id = 1; id < static_cast<int>(size()); ++id) {
+    TransformNode* node = Node(id);
+    if (!node->data.needs_local_transform_update &&
+        !NeedsSourceToParentUpdate(node) &&
+        !was_updated(node->parent_id, id) && !was_updated(TargetId(id), id) &&
+        !was_updated(node->data.source_node_id, id)) {
+      // The change tracking is still propagated, as a full update would.
+      UpdateTransformChanged(node, parent(node),
+                             Node(node->data.source_node_id));
+      continue;
+    }
+    UpdateTransforms(id);
+    updated[id] = true;
+  }
+}
+
 bool TransformTree::IsDescendant(int desc_id, int source_id) const {
   while (desc_id != source_id) {
     if (desc_id < 0)
@@ -1262,18 +1293,16 @@ void TransformTree::UpdateInnerViewportContainerBoundsDelta() {
   if (nodes_affected_by_inner_viewport_bounds_delta_.empty())
     return;
 
-  set_needs_update(true);
   for (int i : nodes_affected_by_inner_viewport_bounds_delta_)
-    Node(i)->data.needs_local_transform_update = true;
+    SetNeedsLocalTransformUpdate(Node(i));
 }
 
 void TransformTree::UpdateOuterViewportContainerBoundsDelta() {
   if (nodes_affected_by_outer_viewport_bounds_delta_.empty())
     return;
 
-  set_needs_update(true);
   for (int i : nodes_affected_by_outer_viewport_bounds_delta_)
-    Node(i)->data.needs_local_transform_update = true;
+    SetNeedsLocalTransformUpdate(Node(i));
 }
 
 void TransformTree::AddNodeAffectedByInnerViewportBoundsDelta(int node_id) {
@@ -1373,6 +1402,7 @@ bool TransformTree::operator==(const TransformTree& other) const {
   return PropertyTree::operator==(other) &&
          source_to_parent_updates_allowed_ ==
              other.source_to_parent_updates_allowed() &&
+         needs_partial_update_ == other.needs_partial_update() &&
          page_scale_factor_ == other.page_scale_factor() &&
          device_scale_factor_ == other.device_scale_factor() &&
          device_transform_scale_factor_ ==
@@ -1392,6 +1422,7 @@ void TransformTree::ToProtobuf(proto::PropertyTree* proto) const {
   proto::TransformTreeData* data = proto->mutable_transform_tree_data();
 
   data->set_source_to_parent_updates_allowed(source_to_parent_updates_allowed_);
+  data->set_needs_partial_update(needs_partial_update_);
   data->set_page_scale_factor(page_scale_factor_);
   data->set_device_scale_factor(device_scale_factor_);
   data->set_device_transform_scale_factor(device_transform_scale_factor_);
@@ -1416,6 +1447,7 @@ void TransformTree::FromProtobuf(
   const proto::TransformTreeData& data = proto.transform_tree_data();
 
   source_to_parent_updates_allowed_ = data.source_to_parent_updates_allowed();
+  needs_partial_update_ = data.needs_partial_update();
   page_scale_factor_ = data.page_scale_factor();
   device_scale_factor_ = data.device_scale_factor();
   device_transform_scale_factor_ = data.device_transform_scale_factor();
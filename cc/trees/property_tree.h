@@ -460,6 +460,19 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   void ResetChangeTracking();
   // Updates the parent, target, and screen space transforms and snapping.
   void UpdateTransforms(int id);
+
+  // Marks |node| as needing its local transform recomputed. Unlike
+  // set_needs_update(true), only |node| and the nodes whose transforms depend
+  // on it are updated by the next UpdateChangedTransforms().
+  void SetNeedsLocalTransformUpdate(TransformNode* node);
+  void set_needs_partial_update(bool needs_partial_update) {
+    needs_partial_update_ = needs_partial_update;
+  }
+  bool needs_partial_update() const { return needs_partial_update_; }
+
+  // Calls UpdateTransforms() on the nodes that need a local transform update,
+  // and on the nodes whose parent, target or source node got updated.
+  void UpdateChangedTransforms();
   void UpdateTransformChanged(TransformNode* node,
                               TransformNode* parent_node,
                               TransformNode* source_node);
@@ -584,6 +597,9 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   bool NeedsSourceToParentUpdate(TransformNode* node);
 
   bool source_to_parent_updates_allowed_;
+  // Whether some nodes need an update, as opposed to needs_update(), which
+  // means that all the nodes do.
+  bool needs_partial_update_;
   // When to_screen transform has perspective, the transform node's sublayer
   // scale is calculated using page scale factor, device scale factor and the
   // scale factor of device transform. So we need to store them explicitly.
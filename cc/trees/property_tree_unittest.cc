@@ -91,6 +91,7 @@ TEST(PropertyTreeSerializationTest, TransformTreeSerialization) {
   original.SetTargetId(third.id, 0);
 
   original.set_needs_update(true);
+  original.set_needs_partial_update(true);
 
   original.set_page_scale_factor(0.5f);
   original.set_device_scale_factor(0.6f);
@@ -1156,6 +1157,55 @@ class PropertyTreeTestSingularTransformSnapTest : public PropertyTreeTest {
 DIRECT_AND_SERIALIZED_PROPERTY_TREE_TEST_F(
     PropertyTreeTestSingularTransformSnapTest);
 
+class PropertyTreeTestPartialTransformUpdate : public PropertyTreeTest {
+ protected:
+  void StartTest() override {
+    // This tests that a partial update recomputes the marked node and its
+    // subtree, and leaves the other nodes alone.
+    PropertyTrees property_trees;
+    TransformTree& tree = property_trees.transform_tree;
+
+    int parent = tree.Insert(TransformNode(), 0);
+    tree.SetTargetId(parent, 0);
+    tree.Node(parent)->data.local.Translate(1, 1);
+
+    int child = tree.Insert(TransformNode(), parent);
+    tree.SetTargetId(child, 0);
+    tree.Node(child)->data.local.Translate(2, 2);
+
+    int sibling = tree.Insert(TransformNode(), 0);
+    tree.SetTargetId(sibling, 0);
+    tree.Node(sibling)->data.local.Translate(3, 3);
+
+    tree.set_needs_update(true);
+    SetupTransformTreeForTest(&tree);
+    draw_property_utils::ComputeTransforms(&tree);
+
+    tree.Node(parent)->data.local.Translate(10, 10);
+    tree.SetNeedsLocalTransformUpdate(tree.Node(parent));
+    // Not marked, so not updated.
+    tree.Node(sibling)->data.local.Translate(10, 10);
+    EXPECT_FALSE(tree.needs_update());
+    EXPECT_TRUE(tree.needs_partial_update());
+
+    SetupTransformTreeForTest(&tree);
+    draw_property_utils::ComputeTransforms(&tree);
+    EXPECT_FALSE(tree.needs_partial_update());
+
+    gfx::Transform expected;
+    expected.Translate(11, 11);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(expected, tree.ToScreen(parent));
+    expected.Translate(2, 2);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(expected, tree.ToScreen(child));
+    expected.MakeIdentity();
+    expected.Translate(3, 3);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(expected, tree.ToScreen(sibling));
+  }
+};
+
+DIRECT_AND_SERIALIZED_PROPERTY_TREE_TEST_F(
+    PropertyTreeTestPartialTransformUpdate);
+
 #undef DIRECT_AND_SERIALIZED_PROPERTY_TREE_TEST_F
 #undef SERIALIZED_PROPERTY_TREE_TEST_F
 #undef DIRECT_PROPERTY_TREE_TEST_F
@@ -264,6 +264,12 @@ network_time::NetworkTimeTracker*
   return NULL;
 }
 
+subresource_filter::ContentRulesetService*
+    ChromeBrowserProcessStub::subresource_filter_ruleset_service() {
+  NOTIMPLEMENTED();
+  return NULL;
+}
+
 gcm::GCMDriver* ChromeBrowserProcessStub::gcm_driver() {
   NOTIMPLEMENTED();
   return NULL;
@@ -92,6 +92,8 @@ class ChromeBrowserProcessStub : public BrowserProcess {
   WebRtcLogUploader* webrtc_log_uploader() override;
 #endif
   network_time::NetworkTimeTracker* network_time_tracker() override;
+  subresource_filter::ContentRulesetService*
+      subresource_filter_ruleset_service() override;
   gcm::GCMDriver* gcm_driver() override;
   shell_integration::DefaultWebClientState
       CachedDefaultWebClientState() override;
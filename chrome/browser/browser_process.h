@@ -111,6 +111,10 @@ namespace safe_browsing {
 class ClientSideDetectionService;
 }
 
+namespace subresource_filter {
+class ContentRulesetService;
+}
+
 // NOT THREAD SAFE, call only from the main thread.
 // These functions shouldn't return NULL unless otherwise noted.
 class BrowserProcess {
@@ -255,6 +259,11 @@ class BrowserProcess {
 
   virtual network_time::NetworkTimeTracker* network_time_tracker() = 0;
 
+  // Returns the service that indexes the subresource filtering ruleset and
+  // distributes it to renderers. May be null in unit tests.
+  virtual subresource_filter::ContentRulesetService*
+  subresource_filter_ruleset_service() = 0;
+
   virtual gcm::GCMDriver* gcm_driver() = 0;
 
   // Returns the tab manager if it exists, null otherwise.
@@ -24,8 +24,10 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/path_service.h"
+#include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -98,6 +100,7 @@
 #include "components/prefs/pref_service.h"
 #include "components/safe_json/safe_json_parser.h"
 #include "components/signin/core/common/profile_management_switches.h"
+#include "components/subresource_filter/content/browser/content_ruleset_service.h"
 #include "components/translate/core/browser/translate_download_manager.h"
 #include "components/update_client/update_query_params.h"
 #include "components/web_resource/web_resource_pref_names.h"
@@ -280,6 +283,8 @@ void BrowserProcessImpl::StartTearDown() {
   if (safe_browsing_service_.get())
     safe_browsing_service()->ShutDown();
   network_time_tracker_.reset();
+  // Closes the ruleset file on the blocking pool, which is still running.
+  subresource_filter_ruleset_service_.reset();
 #if defined(ENABLE_PLUGIN_INSTALLATION)
   plugins_resource_service_.reset();
 #endif
@@ -747,6 +752,12 @@ network_time::NetworkTimeTracker* BrowserProcessImpl::network_time_tracker() {
   return network_time_tracker_.get();
 }
 
+subresource_filter::ContentRulesetService*
+BrowserProcessImpl::subresource_filter_ruleset_service() {
+  DCHECK(CalledOnValidThread());
+  return subresource_filter_ruleset_service_.get();
+}
+
 gcm::GCMDriver* BrowserProcessImpl::gcm_driver() {
   DCHECK(CalledOnValidThread());
   if (!gcm_driver_)
@@ -1047,6 +1058,8 @@ void BrowserProcessImpl::PreMainMessageLoopRun() {
 
   child_process_watcher_.reset(new ChromeChildProcessWatcher());
 
+  CreateSubresourceFilterRulesetService();
+
   CacheDefaultWebClientState();
 
   platform_part_->PreMainMessageLoopRun();
@@ -1157,6 +1170,26 @@ void BrowserProcessImpl::CreateGCMDriver() {
 #endif  // defined(OS_ANDROID)
 }
 
+void BrowserProcessImpl::CreateSubresourceFilterRulesetService() {
+  DCHECK(!subresource_filter_ruleset_service_);
+
+  base::FilePath user_data_dir;
+  PathService::Get(chrome::DIR_USER_DATA, &user_data_dir);
+  base::SequencedWorkerPool* worker_pool =
+      content::BrowserThread::GetBlockingPool();
+  scoped_refptr<base::SequencedTaskRunner> blocking_task_runner(
+      worker_pool->GetSequencedTaskRunnerWithShutdownBehavior(
+          worker_pool->GetSequenceToken(),
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN));
+
+  subresource_filter_ruleset_service_.reset(
+      new subresource_filter::ContentRulesetService(
+          user_data_dir.Append(FILE_PATH_LITERAL("Subresource Filter"))
+              .Append(FILE_PATH_LITERAL("Indexed Rules")),
+          blocking_task_runner));
+  subresource_filter_ruleset_service_->LoadStoredRuleset();
+}
+
 void BrowserProcessImpl::ApplyDefaultBrowserPolicy() {
   if (local_state()->GetBoolean(prefs::kDefaultBrowserSettingEnabled)) {
     // The worker pointer is reference counted. While it is running, the
@@ -147,6 +147,8 @@ class BrowserProcessImpl : public BrowserProcess,
   WebRtcLogUploader* webrtc_log_uploader() override;
 #endif
   network_time::NetworkTimeTracker* network_time_tracker() override;
+  subresource_filter::ContentRulesetService*
+  subresource_filter_ruleset_service() override;
   gcm::GCMDriver* gcm_driver() override;
   memory::TabManager* GetTabManager() override;
   shell_integration::DefaultWebClientState CachedDefaultWebClientState()
@@ -175,6 +177,7 @@ class BrowserProcessImpl : public BrowserProcess,
   void CreateStatusTray();
   void CreateBackgroundModeManager();
   void CreateGCMDriver();
+  void CreateSubresourceFilterRulesetService();
 
   void ApplyAllowCrossOriginAuthPromptPolicy();
   void ApplyDefaultBrowserPolicy();
@@ -323,6 +326,9 @@ class BrowserProcessImpl : public BrowserProcess,
 
   std::unique_ptr<network_time::NetworkTimeTracker> network_time_tracker_;
 
+  std::unique_ptr<subresource_filter::ContentRulesetService>
+      subresource_filter_ruleset_service_;
+
   std::unique_ptr<gcm::GCMDriver> gcm_driver_;
 
   std::unique_ptr<ChromeChildProcessWatcher> child_process_watcher_;
@@ -946,7 +946,9 @@ int ChromeBrowserMainParts::PreCreateThreadsImpl() {
     // Default to basic profiling (no parent child support).
     tracked_objects::ThreadData::Status status =
           tracked_objects::ThreadData::PROFILING_ACTIVE;
-    if (flag.compare("0") != 0)
+    if (flag == "sampled")
+      status = tracked_objects::ThreadData::PROFILING_SAMPLED;
+    else if (flag.compare("0") != 0)
       status = tracked_objects::ThreadData::DEACTIVATED;
     tracked_objects::ThreadData::InitializeAndSetTrackingStatus(status);
   }
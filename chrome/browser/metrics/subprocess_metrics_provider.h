@@ -10,9 +10,11 @@
 
 #include "base/gtest_prod_util.h"
 #include "base/id_map.h"
+#include "base/memory/weak_ptr.h"
 #include "base/scoped_observer.h"
 #include "base/threading/thread_checker.h"
 #include "components/metrics/metrics_provider.h"
+#include "content/public/browser/browser_child_process_observer.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
 #include "content/public/browser/render_process_host_observer.h"
@@ -26,9 +28,14 @@ class SharedPersistentMemoryAllocator;
 // memory segments between processes. Merging occurs when a process exits,
 // when metrics are being collected for upload, or when something else needs
 // combined metrics (such as the chrome://histograms page).
-class SubprocessMetricsProvider : public metrics::MetricsProvider,
-                                  public content::NotificationObserver,
-                                  public content::RenderProcessHostObserver {
+//
+// Renderers get their segment from the RenderProcessHost; all other child
+// processes (GPU, utility, plugins...) from their BrowserChildProcessHost.
+class SubprocessMetricsProvider
+    : public metrics::MetricsProvider,
+      public content::BrowserChildProcessObserver,
+      public content::NotificationObserver,
+      public content::RenderProcessHostObserver {
  public:
   SubprocessMetricsProvider();
   ~SubprocessMetricsProvider() override;
@@ -38,6 +45,7 @@ class SubprocessMetricsProvider : public metrics::MetricsProvider,
 
   // Indicates subprocess to be monitored with unique id for later reference.
   // Metrics reporting will read histograms from it and upload them to UMA.
+  // Does nothing if |allocator| is null.
   void RegisterSubprocessAllocator(
       int id,
       std::unique_ptr<base::PersistentHistogramAllocator> allocator);
@@ -56,6 +64,16 @@ class SubprocessMetricsProvider : public metrics::MetricsProvider,
   // metrics::MetricsProvider:
   void MergeHistogramDeltas() override;
 
+  // content::BrowserChildProcessObserver:
+  void BrowserChildProcessLaunchedAndConnected(
+      const content::ChildProcessData& data) override;
+  void BrowserChildProcessHostDisconnected(
+      const content::ChildProcessData& data) override;
+  void BrowserChildProcessCrashed(const content::ChildProcessData& data,
+                                  int exit_code) override;
+  void BrowserChildProcessKilled(const content::ChildProcessData& data,
+                                 int exit_code) override;
+
   // content::NotificationObserver:
   void Observe(int type,
                const content::NotificationSource& source,
@@ -68,6 +86,11 @@ class SubprocessMetricsProvider : public metrics::MetricsProvider,
                            int exit_code) override;
   void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
 
+  // Gets a histogram allocator from a subprocess. This must be called on
+  // the IO thread, where BrowserChildProcessHosts live.
+  static std::unique_ptr<base::PersistentHistogramAllocator>
+  GetSubprocessHistogramAllocatorOnIOThread(int id);
+
   base::ThreadChecker thread_checker_;
 
   // Object for registing notification requests.
@@ -82,6 +105,8 @@ class SubprocessMetricsProvider : public metrics::MetricsProvider,
   ScopedObserver<content::RenderProcessHost, SubprocessMetricsProvider>
       scoped_observer_;
 
+  base::WeakPtrFactory<SubprocessMetricsProvider> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(SubprocessMetricsProvider);
 };
 
@@ -13,6 +13,7 @@
 #include "base/metrics/persistent_histogram_allocator.h"
 #include "base/metrics/persistent_memory_allocator.h"
 #include "base/metrics/statistics_recorder.h"
+#include "content/public/test/test_browser_thread_bundle.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace {
@@ -117,6 +118,9 @@ class SubprocessMetricsProviderTest : public testing::Test {
   }
 
  private:
+  // The provider observes child processes, which requires a UI thread.
+  content::TestBrowserThreadBundle thread_bundle_;
+
   SubprocessMetricsProvider provider_;
   std::unique_ptr<base::StatisticsRecorder> test_recorder_;
 
@@ -161,3 +165,13 @@ TEST_F(SubprocessMetricsProviderTest, SnapshotMetrics) {
   bar->Add(20);
   EXPECT_EQ(0U, GetSnapshotHistogramCount());
 }
+
+TEST_F(SubprocessMetricsProviderTest, RegisterNullAllocator) {
+  // A process which wasn't given a segment has no allocator to register.
+  RegisterSubprocessAllocator(123, nullptr);
+  EXPECT_EQ(0U, GetSnapshotHistogramCount());
+
+  // Deregistering it is harmless.
+  DeregisterSubprocessAllocator(123);
+  EXPECT_EQ(0U, GetSnapshotHistogramCount());
+}
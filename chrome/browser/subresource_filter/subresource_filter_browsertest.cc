@@ -3,10 +3,15 @@
 // found in the LICENSE file.
 
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "chrome/browser/browser_process.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/ui_test_utils.h"
+#include "components/subresource_filter/content/browser/content_ruleset_service.h"
 #include "components/subresource_filter/core/browser/subresource_filter_features.h"
 #include "components/subresource_filter/core/browser/subresource_filter_features_test_support.h"
 #include "content/public/browser/render_frame_host.h"
@@ -27,6 +32,25 @@ class SubresourceFilterBrowserTest : public InProcessBrowserTest {
   void SetUpOnMainThread() override {
     scoped_feature_toggle_.reset(new ScopedSubresourceFilterFeatureToggle(
         base::FeatureList::OVERRIDE_ENABLE_FEATURE, kActivationStateEnabled));
+    ASSERT_NO_FATAL_FAILURE(PublishRuleset("included_script.js"));
+  }
+
+  // Indexes a filter list consisting of |rules|, and waits until the result is
+  // sent to all renderers.
+  void PublishRuleset(const std::string& rules) {
+    ASSERT_TRUE(filter_list_dir_.CreateUniqueTempDir());
+    base::FilePath filter_list_path =
+        filter_list_dir_.path().AppendASCII("filter_list.txt");
+    ASSERT_EQ(static_cast<int>(rules.size()),
+              base::WriteFile(filter_list_path, rules.data(), rules.size()));
+
+    ContentRulesetService* service =
+        g_browser_process->subresource_filter_ruleset_service();
+    ASSERT_TRUE(service);
+    base::RunLoop run_loop;
+    service->SetRulesetPublishedCallbackForTesting(run_loop.QuitClosure());
+    service->IndexAndStoreRuleset(filter_list_path);
+    run_loop.Run();
   }
 
   content::WebContents* web_contents() {
@@ -51,6 +75,7 @@ class SubresourceFilterBrowserTest : public InProcessBrowserTest {
 
  private:
   std::unique_ptr<ScopedSubresourceFilterFeatureToggle> scoped_feature_toggle_;
+  base::ScopedTempDir filter_list_dir_;
 
   DISALLOW_COPY_AND_ASSIGN(SubresourceFilterBrowserTest);
 };
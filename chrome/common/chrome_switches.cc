@@ -495,6 +495,8 @@ const char kEnablePrintPreviewRegisterPromos[] =
 // --enable-profiling=0
 // Some tracking will still take place at startup, but it will be turned off
 // during chrome_browser_main.
+// To only track a sample of the tasks, which is cheaper, use:
+// --enable-profiling=sampled
 const char kEnableProfiling[]               = "enable-profiling";
 
 // Enable or disable background mode for the Push API.
@@ -54,6 +54,10 @@ namespace safe_browsing {
 class PhishingClassifierFilter;
 }
 
+namespace subresource_filter {
+class RulesetDealer;
+}
+
 namespace visitedlink {
 class VisitedLinkSlave;
 }
@@ -212,6 +216,8 @@ class ChromeContentRendererClient : public content::ContentRendererClient {
   std::unique_ptr<visitedlink::VisitedLinkSlave> visited_link_slave_;
   std::unique_ptr<safe_browsing::PhishingClassifierFilter> phishing_classifier_;
   std::unique_ptr<prerender::PrerenderDispatcher> prerender_dispatcher_;
+  std::unique_ptr<subresource_filter::RulesetDealer>
+      subresource_filter_ruleset_dealer_;
 #if defined(ENABLE_WEBRTC)
   scoped_refptr<WebRtcLoggingMessageFilter> webrtc_logging_message_filter_;
 #endif
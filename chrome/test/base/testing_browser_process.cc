@@ -358,6 +358,11 @@ TestingBrowserProcess::network_time_tracker() {
   return network_time_tracker_.get();
 }
 
+subresource_filter::ContentRulesetService*
+TestingBrowserProcess::subresource_filter_ruleset_service() {
+  return nullptr;
+}
+
 gcm::GCMDriver* TestingBrowserProcess::gcm_driver() {
   return nullptr;
 }
@@ -122,6 +122,8 @@ class TestingBrowserProcess : public BrowserProcess {
 #endif
 
   network_time::NetworkTimeTracker* network_time_tracker() override;
+  subresource_filter::ContentRulesetService*
+  subresource_filter_ruleset_service() override;
 
   gcm::GCMDriver* gcm_driver() override;
   memory::TabManager* GetTabManager() override;
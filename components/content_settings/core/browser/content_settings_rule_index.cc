@@ -0,0 +1,138 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/content_settings/core/browser/content_settings_rule_index.h"
+
+#include <algorithm>
+
+#include "net/base/url_util.h"
+#include "url/gurl.h"
+
+namespace content_settings {
+
+namespace {
+
+// The number of lookup results that are cached. Pages mostly query the
+// settings of a handful of origins.
+const size_t kCacheSize = 128;
+
+// Returns the URL that patterns are matched against for |url|, see
+// ContentSettingsPattern::Matches().
+const GURL& GetMatchedURL(const GURL& url) {
+  if (url.SchemeIsFileSystem() && url.inner_url())
+    return *url.inner_url();
+  return url;
+}
+
+// Appends the parts of |url| that patterns look at to |key|. Two URLs with the
+// same parts are matched by the same patterns.
+void AppendCacheKey(const GURL& url, std::string* key) {
+  const GURL& matched_url = GetMatchedURL(url);
+  key->append(matched_url.scheme());
+  key->push_back(' ');
+  if (matched_url.SchemeIsFile()) {
+    key->append(matched_url.path());
+  } else {
+    key->append(matched_url.host());
+    key->push_back(' ');
+    key->append(matched_url.port());
+  }
+  key->push_back('\n');
+}
+
+void AppendRules(const std::map<std::string, std::vector<int>>& rules_by_host,
+                 const std::string& host,
+                 std::vector<int>* rules) {
+  auto it = rules_by_host.find(host);
+  if (it != rules_by_host.end())
+    rules->insert(rules->end(), it->second.begin(), it->second.end());
+}
+
+}  // namespace
+
+RuleIndex::RuleIndex() : cache_(kCacheSize) {}
+
+RuleIndex::~RuleIndex() {}
+
+void RuleIndex::AddRule(const Rule& rule, int source) {
+  DCHECK(sources_.empty() || sources_.back() <= source);
+  int position = static_cast<int>(rules_.size());
+  rules_.push_back(rule);
+  sources_.push_back(source);
+
+  std::string host;
+  bool include_subdomains;
+  if (!rule.primary_pattern.GetHostRestriction(&host, &include_subdomains))
+    rules_for_any_host_.push_back(position);
+  else if (include_subdomains)
+    rules_by_domain_[host].push_back(position);
+  else
+    rules_by_host_[host].push_back(position);
+}
+
+const Rule* RuleIndex::Lookup(const GURL& primary_url,
+                              const GURL& secondary_url,
+                              int* source) const {
+  std::string key;
+  AppendCacheKey(primary_url, &key);
+  AppendCacheKey(secondary_url, &key);
+
+  int position;
+  bool cached = false;
+  {
+    base::AutoLock auto_lock(cache_lock_);
+    auto it = cache_.Get(key);
+    if (it != cache_.end()) {
+      position = it->second;
+      cached = true;
+    }
+  }
+  if (!cached) {
+    position = FindRule(primary_url, secondary_url);
+    base::AutoLock auto_lock(cache_lock_);
+    cache_.Put(key, position);
+  }
+
+  if (position < 0)
+    return nullptr;
+  *source = sources_[position];
+  return &rules_[position];
+}
+
+int RuleIndex::FindRule(const GURL& primary_url,
+                        const GURL& secondary_url) const {
+  // Gather the rules that may match the host of |primary_url|: those for the
+  // host itself and for each of its parent domains.
+  const std::string host(
+      net::TrimEndingDot(GetMatchedURL(primary_url).host()));
+  std::vector<int> candidates(rules_for_any_host_);
+  AppendRules(rules_by_host_, host, &candidates);
+  for (size_t pos = 0;;) {
+    AppendRules(rules_by_domain_, host.substr(pos), &candidates);
+    pos = host.find('.', pos);
+    if (pos == std::string::npos)
+      break;
+    ++pos;
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  bool skipping_source = false;
+  int skipped_source = 0;
+  for (int position : candidates) {
+    if (skipping_source && sources_[position] == skipped_source)
+      continue;
+    const Rule& rule = rules_[position];
+    if (!rule.primary_pattern.Matches(primary_url) ||
+        !rule.secondary_pattern.Matches(secondary_url)) {
+      continue;
+    }
+    if (rule.value.get())
+      return position;
+    skipping_source = true;
+    skipped_source = sources_[position];
+  }
+  return -1;
+}
+
+}  // namespace content_settings
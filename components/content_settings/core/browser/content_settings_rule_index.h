@@ -0,0 +1,79 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_CONTENT_SETTINGS_RULE_INDEX_H_
+#define COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_CONTENT_SETTINGS_RULE_INDEX_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "components/content_settings/core/browser/content_settings_rule.h"
+
+class GURL;
+
+namespace content_settings {
+
+// The rules of all providers for one content type and resource identifier, in
+// order of precedence, indexed by the host that their primary pattern restricts
+// URLs to. Finding the rule that applies to a pair of URLs only matches the
+// rules for the host of the primary URL and its parent domains, plus the rules
+// that apply to any host, instead of every rule of every provider. The results
+// of the most recent lookups are cached.
+//
+// A RuleIndex is not modified once built, except for its cache, and can then be
+// used from any thread.
+class RuleIndex : public base::RefCountedThreadSafe<RuleIndex> {
+ public:
+  RuleIndex();
+
+  // Adds |rule|, which takes precedence over the rules that are added after
+  // it. |source| identifies the provider of the rule; the rules of a provider
+  // must be added consecutively. A rule with a null value makes the lookups it
+  // matches skip the rest of the rules of its provider.
+  void AddRule(const Rule& rule, int source);
+
+  // Returns the first rule with a value that matches |primary_url| and
+  // |secondary_url|, and sets |source| to its provider, or returns null if
+  // there is none. The rule is owned by the index.
+  const Rule* Lookup(const GURL& primary_url,
+                     const GURL& secondary_url,
+                     int* source) const;
+
+  size_t size() const { return rules_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<RuleIndex>;
+
+  ~RuleIndex();
+
+  // Returns the position in |rules_| of the rule that Lookup() returns, or -1.
+  int FindRule(const GURL& primary_url, const GURL& secondary_url) const;
+
+  std::vector<Rule> rules_;
+  std::vector<int> sources_;
+
+  // Positions in |rules_|, in increasing order, of the rules whose primary
+  // pattern matches exactly the host of the key, of the rules whose primary
+  // pattern matches the key and its subdomains, and of the other rules.
+  std::map<std::string, std::vector<int>> rules_by_host_;
+  std::map<std::string, std::vector<int>> rules_by_domain_;
+  std::vector<int> rules_for_any_host_;
+
+  // Maps the parts of the URLs that patterns match to the result of FindRule.
+  mutable base::Lock cache_lock_;
+  mutable base::MRUCache<std::string, int> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuleIndex);
+};
+
+}  // namespace content_settings
+
+#endif  // COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_CONTENT_SETTINGS_RULE_INDEX_H_
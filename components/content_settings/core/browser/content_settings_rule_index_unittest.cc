@@ -0,0 +1,106 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/content_settings/core/browser/content_settings_rule_index.h"
+
+#include "base/values.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace content_settings {
+
+namespace {
+
+Rule MakeRule(const std::string& primary_pattern,
+              const std::string& secondary_pattern,
+              int value) {
+  return Rule(ContentSettingsPattern::FromString(primary_pattern),
+              ContentSettingsPattern::FromString(secondary_pattern),
+              new base::FundamentalValue(value));
+}
+
+// Returns the value of the rule that |index| finds for the URLs, or -1.
+int Lookup(const RuleIndex& index,
+           const std::string& primary_url,
+           const std::string& secondary_url) {
+  int source;
+  const Rule* rule =
+      index.Lookup(GURL(primary_url), GURL(secondary_url), &source);
+  int value = -1;
+  if (rule)
+    EXPECT_TRUE(rule->value->GetAsInteger(&value));
+  return value;
+}
+
+}  // namespace
+
+TEST(RuleIndexTest, Empty) {
+  scoped_refptr<RuleIndex> index(new RuleIndex);
+  EXPECT_EQ(-1, Lookup(*index, "http://www.example.com/", "http://a.com/"));
+}
+
+TEST(RuleIndexTest, MatchesHostsAndDomains) {
+  scoped_refptr<RuleIndex> index(new RuleIndex);
+  index->AddRule(MakeRule("www.example.com", "*", 1), 0);
+  index->AddRule(MakeRule("[*.]example.com", "*", 2), 0);
+  index->AddRule(MakeRule("https://[*.]com", "*", 3), 0);
+  index->AddRule(MakeRule("file:///tmp/a.html", "*", 4), 0);
+  index->AddRule(MakeRule("*", "*", 5), 0);
+  EXPECT_EQ(5u, index->size());
+
+  EXPECT_EQ(1, Lookup(*index, "http://www.example.com/", "http://a.com/"));
+  EXPECT_EQ(1, Lookup(*index, "http://www.example.com./", "http://a.com/"));
+  EXPECT_EQ(2, Lookup(*index, "http://example.com/", "http://a.com/"));
+  EXPECT_EQ(2, Lookup(*index, "http://a.b.example.com/", "http://a.com/"));
+  EXPECT_EQ(3, Lookup(*index, "https://notexample.com/", "http://a.com/"));
+  EXPECT_EQ(5, Lookup(*index, "http://notexample.com/", "http://a.com/"));
+  EXPECT_EQ(5, Lookup(*index, "http://example.org/", "http://a.com/"));
+  EXPECT_EQ(4, Lookup(*index, "file:///tmp/a.html", "http://a.com/"));
+  EXPECT_EQ(5, Lookup(*index, "file:///tmp/b.html", "http://a.com/"));
+  EXPECT_EQ(2, Lookup(*index,
+                      "filesystem:http://www.sub.example.com/temporary/",
+                      "http://a.com/"));
+}
+
+TEST(RuleIndexTest, KeepsPrecedence) {
+  scoped_refptr<RuleIndex> index(new RuleIndex);
+  index->AddRule(MakeRule("[*.]example.com", "http://a.com", 1), 0);
+  index->AddRule(MakeRule("*", "http://b.com", 2), 0);
+  index->AddRule(MakeRule("www.example.com", "*", 3), 0);
+  index->AddRule(MakeRule("[*.]example.com", "*", 4), 1);
+
+  EXPECT_EQ(1, Lookup(*index, "http://www.example.com/", "http://a.com/"));
+  EXPECT_EQ(2, Lookup(*index, "http://www.example.com/", "http://b.com/"));
+  EXPECT_EQ(3, Lookup(*index, "http://www.example.com/", "http://c.com/"));
+  EXPECT_EQ(4, Lookup(*index, "http://example.com/", "http://c.com/"));
+  EXPECT_EQ(-1, Lookup(*index, "http://example.org/", "http://c.com/"));
+
+  // Cached results are the same.
+  EXPECT_EQ(2, Lookup(*index, "http://www.example.com/", "http://b.com/"));
+  EXPECT_EQ(3, Lookup(*index, "http://www.example.com/", "http://c.com/"));
+}
+
+TEST(RuleIndexTest, NullValueSkipsSource) {
+  scoped_refptr<RuleIndex> index(new RuleIndex);
+  Rule hidden_rule = MakeRule("www.example.com", "*", 0);
+  hidden_rule.value.reset();
+  index->AddRule(hidden_rule, 0);
+  index->AddRule(MakeRule("[*.]example.com", "*", 1), 0);
+  index->AddRule(MakeRule("*", "*", 2), 1);
+
+  int source = -1;
+  const Rule* rule = index->Lookup(GURL("http://www.example.com/"),
+                                   GURL("http://a.com/"), &source);
+  ASSERT_TRUE(rule);
+  EXPECT_EQ(1, source);
+  EXPECT_EQ(ContentSettingsPattern::Wildcard(), rule->primary_pattern);
+
+  rule = index->Lookup(GURL("http://mail.example.com/"), GURL("http://a.com/"),
+                       &source);
+  ASSERT_TRUE(rule);
+  EXPECT_EQ(0, source);
+}
+
+}  // namespace content_settings
@@ -26,6 +26,7 @@
 #include "components/content_settings/core/browser/content_settings_provider.h"
 #include "components/content_settings/core/browser/content_settings_registry.h"
 #include "components/content_settings/core/browser/content_settings_rule.h"
+#include "components/content_settings/core/browser/content_settings_rule_index.h"
 #include "components/content_settings/core/browser/content_settings_utils.h"
 #include "components/content_settings/core/browser/website_settings_registry.h"
 #include "components/content_settings/core/common/content_settings_pattern.h"
@@ -643,6 +644,19 @@ void HostContentSettingsMap::OnContentSettingChanged(
     const ContentSettingsPattern& secondary_pattern,
     ContentSettingsType content_type,
     std::string resource_identifier) {
+  {
+    base::AutoLock auto_lock(rule_indices_lock_);
+    for (RuleIndexMap::iterator it = rule_indices_.begin();
+         it != rule_indices_.end();) {
+      if (content_type == CONTENT_SETTINGS_TYPE_DEFAULT ||
+          it->first.first == content_type) {
+        it = rule_indices_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    ++rule_indices_generation_;
+  }
   FOR_EACH_OBSERVER(content_settings::Observer,
                     observers_,
                     OnContentSettingChanged(primary_pattern,
@@ -665,6 +679,9 @@ void HostContentSettingsMap::ShutdownOnUIThread() {
        ++it) {
     it->second->ShutdownOnUIThread();
   }
+  base::AutoLock auto_lock(rule_indices_lock_);
+  rule_indices_.clear();
+  ++rule_indices_generation_;
 }
 
 void HostContentSettingsMap::AddSettingsForOneType(
@@ -765,35 +782,92 @@ std::unique_ptr<base::Value> HostContentSettingsMap::GetWebsiteSettingInternal(
     const std::string& resource_identifier,
     content_settings::SettingInfo* info) const {
   UsedContentSettingsProviders();
-  ContentSettingsPattern* primary_pattern = NULL;
-  ContentSettingsPattern* secondary_pattern = NULL;
+
+  scoped_refptr<content_settings::RuleIndex> index =
+      GetRuleIndex(content_type, resource_identifier);
+  int provider_type;
+  const content_settings::Rule* rule =
+      index->Lookup(primary_url, secondary_url, &provider_type);
+  if (rule) {
+    if (info) {
+      info->source = kProviderNamesSourceMap[provider_type].provider_source;
+      info->primary_pattern = rule->primary_pattern;
+      info->secondary_pattern = rule->secondary_pattern;
+    }
+    return base::WrapUnique(rule->value->DeepCopy());
+  }
+
   if (info) {
-    primary_pattern = &info->primary_pattern;
-    secondary_pattern = &info->secondary_pattern;
+    info->source = content_settings::SETTING_SOURCE_NONE;
+    info->primary_pattern = ContentSettingsPattern();
+    info->secondary_pattern = ContentSettingsPattern();
+  }
+  return std::unique_ptr<base::Value>();
+}
+
+scoped_refptr<content_settings::RuleIndex>
+HostContentSettingsMap::GetRuleIndex(
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) const {
+  RuleIndexMap::key_type key(content_type, resource_identifier);
+  int generation;
+  {
+    base::AutoLock auto_lock(rule_indices_lock_);
+    RuleIndexMap::const_iterator it = rule_indices_.find(key);
+    if (it != rule_indices_.end())
+      return it->second;
+    generation = rule_indices_generation_;
   }
 
   // The list of |content_settings_providers_| is ordered according to their
   // precedence.
+  scoped_refptr<content_settings::RuleIndex> index(
+      new content_settings::RuleIndex);
   for (ConstProviderIterator provider = content_settings_providers_.begin();
        provider != content_settings_providers_.end();
        ++provider) {
-    std::unique_ptr<base::Value> value = GetContentSettingValueAndPatterns(
-        provider->second, primary_url, secondary_url, content_type,
-        resource_identifier, is_off_the_record_, primary_pattern,
-        secondary_pattern);
-    if (value) {
-      if (info)
-        info->source = kProviderNamesSourceMap[provider->first].provider_source;
-      return value;
-    }
+    AddRulesToIndex(provider->second, provider->first, content_type,
+                    resource_identifier, index.get());
   }
 
-  if (info) {
-    info->source = content_settings::SETTING_SOURCE_NONE;
-    info->primary_pattern = ContentSettingsPattern();
-    info->secondary_pattern = ContentSettingsPattern();
+  base::AutoLock auto_lock(rule_indices_lock_);
+  if (generation == rule_indices_generation_)
+    rule_indices_[key] = index;
+  return index;
+}
+
+void HostContentSettingsMap::AddRulesToIndex(
+    const content_settings::ProviderInterface* provider,
+    ProviderType provider_type,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier,
+    content_settings::RuleIndex* index) const {
+  if (is_off_the_record_) {
+    // Incognito-only settings take precedence. It's essential that the
+    // |RuleIterator| gets out of scope before we get a rule iterator for the
+    // normal mode.
+    std::unique_ptr<content_settings::RuleIterator> incognito_rule_iterator(
+        provider->GetRuleIterator(content_type, resource_identifier,
+                                  true /* incognito */));
+    while (incognito_rule_iterator->HasNext())
+      index->AddRule(incognito_rule_iterator->Next(), provider_type);
+  }
+
+  std::unique_ptr<content_settings::RuleIterator> rule_iterator(
+      provider->GetRuleIterator(content_type, resource_identifier,
+                                false /* incognito */));
+  while (rule_iterator->HasNext()) {
+    content_settings::Rule rule = rule_iterator->Next();
+    // A rule that is not inherited by the incognito mode is kept with a null
+    // value, so that it still hides the rules of the provider that follow it.
+    if (is_off_the_record_) {
+      rule.value.reset(
+          ProcessIncognitoInheritanceBehavior(
+              content_type, base::WrapUnique(rule.value->DeepCopy()))
+              .release());
+    }
+    index->AddRule(rule, provider_type);
   }
-  return std::unique_ptr<base::Value>();
 }
 
 // static
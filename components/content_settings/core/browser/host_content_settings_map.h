@@ -10,11 +10,13 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_checker.h"
 #include "components/content_settings/core/browser/content_settings_observer.h"
@@ -38,6 +40,7 @@ namespace content_settings {
 class ObservableProvider;
 class ProviderInterface;
 class PrefProvider;
+class RuleIndex;
 class TestUtils;
 }
 
@@ -289,6 +292,10 @@ class HostContentSettingsMap : public content_settings::Observer,
   typedef ProviderMap::iterator ProviderIterator;
   typedef ProviderMap::const_iterator ConstProviderIterator;
 
+  typedef std::map<std::pair<ContentSettingsType, std::string>,
+                   scoped_refptr<content_settings::RuleIndex>>
+      RuleIndexMap;
+
   ~HostContentSettingsMap() override;
 
   ContentSetting GetDefaultContentSettingFromProvider(
@@ -342,6 +349,22 @@ class HostContentSettingsMap : public content_settings::Observer,
       const std::string& resource_identifier,
       content_settings::SettingInfo* info) const;
 
+  // Returns the rules of all providers for |content_type| and
+  // |resource_identifier|, indexed by host. The index is built on first use,
+  // and dropped when any of these rules changes.
+  scoped_refptr<content_settings::RuleIndex> GetRuleIndex(
+      ContentSettingsType content_type,
+      const std::string& resource_identifier) const;
+
+  // Adds the rules of |provider| for |content_type| and |resource_identifier|
+  // to |index|, in the order in which GetContentSettingValueAndPatterns()
+  // matches them.
+  void AddRulesToIndex(const content_settings::ProviderInterface* provider,
+                       ProviderType provider_type,
+                       ContentSettingsType content_type,
+                       const std::string& resource_identifier,
+                       content_settings::RuleIndex* index) const;
+
   static std::unique_ptr<base::Value> GetContentSettingValueAndPatterns(
       const content_settings::ProviderInterface* provider,
       const GURL& primary_url,
@@ -387,6 +410,17 @@ class HostContentSettingsMap : public content_settings::Observer,
 
   base::ObserverList<content_settings::Observer> observers_;
 
+  // Guards |rule_indices_| and |rule_indices_generation_|, which are used from
+  // any thread.
+  mutable base::Lock rule_indices_lock_;
+
+  // The indices built by GetRuleIndex().
+  mutable RuleIndexMap rule_indices_;
+
+  // Incremented whenever rules change, so that an index that was being built
+  // from the previous rules meanwhile is not kept.
+  int rule_indices_generation_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(HostContentSettingsMap);
 };
 
@@ -529,6 +529,20 @@ bool ContentSettingsPattern::MatchesAllHosts() const {
   return parts_.has_domain_wildcard && parts_.host.empty();
 }
 
+bool ContentSettingsPattern::GetHostRestriction(
+    std::string* host,
+    bool* include_subdomains) const {
+  // Invalid patterns match nothing, and patterns for file URLs ignore the host,
+  // see Matches().
+  if (!is_valid_ || MatchesAllHosts())
+    return false;
+  if (!parts_.is_scheme_wildcard && parts_.scheme == url::kFileScheme)
+    return false;
+  *host = parts_.host;
+  *include_subdomains = parts_.has_domain_wildcard;
+  return true;
+}
+
 std::string ContentSettingsPattern::ToString() const {
   if (IsValid())
     return content_settings::PatternParser::ToString(parts_);
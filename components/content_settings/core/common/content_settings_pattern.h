@@ -167,6 +167,11 @@ class ContentSettingsPattern {
   // True if this pattern matches all hosts (i.e. it has a host wildcard).
   bool MatchesAllHosts() const;
 
+  // Returns true if this pattern only matches URLs whose host is |host| or, if
+  // |include_subdomains| is set, a subdomain of |host|. Returns false, leaving
+  // the out parameters untouched, if the pattern may match URLs of any host.
+  bool GetHostRestriction(std::string* host, bool* include_subdomains) const;
+
   // Returns a std::string representation of this pattern.
   std::string ToString() const;
 
@@ -217,6 +217,29 @@ TEST(ContentSettingsPatternTest, TrimEndingDotFromHost) {
   EXPECT_STREQ(".", Pattern(".").ToString().c_str());
 }
 
+TEST(ContentSettingsPatternTest, GetHostRestriction) {
+  std::string host;
+  bool include_subdomains = false;
+  EXPECT_TRUE(Pattern("http://www.example.com:80")
+                  .GetHostRestriction(&host, &include_subdomains));
+  EXPECT_EQ("www.example.com", host);
+  EXPECT_FALSE(include_subdomains);
+
+  EXPECT_TRUE(
+      Pattern("[*.]example.com").GetHostRestriction(&host, &include_subdomains));
+  EXPECT_EQ("example.com", host);
+  EXPECT_TRUE(include_subdomains);
+
+  EXPECT_FALSE(ContentSettingsPattern::Wildcard().GetHostRestriction(
+      &host, &include_subdomains));
+  EXPECT_FALSE(
+      Pattern("https://*:443").GetHostRestriction(&host, &include_subdomains));
+  EXPECT_FALSE(Pattern("file:///foo/bar.html")
+                   .GetHostRestriction(&host, &include_subdomains));
+  EXPECT_FALSE(ContentSettingsPattern().GetHostRestriction(
+      &host, &include_subdomains));
+}
+
 TEST(ContentSettingsPatternTest, FromString_WithNoWildcards) {
   // HTTP patterns with default port.
   EXPECT_TRUE(Pattern("http://www.example.com:80").IsValid());
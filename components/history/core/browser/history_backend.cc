@@ -374,11 +374,10 @@ SegmentID HistoryBackend::UpdateSegments(const GURL& url,
     return 0;
   }
 
-  // Finally, increase the counter for that segment / day.
-  if (!db_->IncreaseSegmentVisitCount(segment_id, ts, 1)) {
-    NOTREACHED();
-    return 0;
-  }
+  // Finally, increase the counter for that segment / day.  The count is
+  // written with the next commit, so a burst of navigations within a segment
+  // updates its row once.
+  db_->AddPendingSegmentVisitCount(segment_id, ts, 1);
   return segment_id;
 }
 
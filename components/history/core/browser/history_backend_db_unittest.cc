@@ -1153,5 +1153,43 @@ TEST_F(HistoryBackendDBTest, QuerySegmentUsage) {
   EXPECT_EQ(segment_id2, results2[0]->GetID());
 }
 
+// Segment visit counts that have not been written yet are still seen by
+// QuerySegmentUsage().
+TEST_F(HistoryBackendDBTest, QuerySegmentUsagePendingVisitCounts) {
+  CreateBackendAndDatabase();
+
+  const GURL url1("http://www.bar.com");
+  const GURL url2("http://www.foo.com");
+  const base::Time time(base::Time::Now());
+
+  URLID url_id1 = db_->AddURL(URLRow(url1));
+  ASSERT_NE(0, url_id1);
+  URLID url_id2 = db_->AddURL(URLRow(url2));
+  ASSERT_NE(0, url_id2);
+
+  SegmentID segment_id1 = db_->CreateSegment(
+      url_id1, VisitSegmentDatabase::ComputeSegmentName(url1));
+  ASSERT_NE(0, segment_id1);
+  SegmentID segment_id2 = db_->CreateSegment(
+      url_id2, VisitSegmentDatabase::ComputeSegmentName(url2));
+  ASSERT_NE(0, segment_id2);
+
+  ASSERT_TRUE(db_->IncreaseSegmentVisitCount(segment_id1, time, 2));
+  for (int i = 0; i < 3; ++i)
+    db_->AddPendingSegmentVisitCount(segment_id2, time, 1);
+
+  std::vector<std::unique_ptr<PageUsageData>> results =
+      db_->QuerySegmentUsage(time, 1, base::Callback<bool(const GURL&)>());
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(segment_id2, results[0]->GetID());
+
+  // The pending counts are only written once, so two more visits to the first
+  // segment make it win.
+  ASSERT_TRUE(db_->IncreaseSegmentVisitCount(segment_id1, time, 2));
+  results = db_->QuerySegmentUsage(time, 1, base::Callback<bool(const GURL&)>());
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(segment_id1, results[0]->GetID());
+}
+
 }  // namespace
 }  // namespace history
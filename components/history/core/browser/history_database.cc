@@ -255,10 +255,12 @@ void HistoryDatabase::BeginTransaction() {
 }
 
 void HistoryDatabase::CommitTransaction() {
+  CommitPendingSegmentVisitCounts();
   db_.CommitTransaction();
 }
 
 void HistoryDatabase::RollbackTransaction() {
+  DiscardPendingSegmentVisitCounts();
   db_.RollbackTransaction();
 }
 
@@ -90,6 +90,8 @@ bool VisitSegmentDatabase::InitSegmentTables() {
 }
 
 bool VisitSegmentDatabase::DropSegmentTables() {
+  DiscardPendingSegmentVisitCounts();
+
   // Dropping the tables will implicitly delete the indices.
   return GetDB().Execute("DROP TABLE segments") &&
          GetDB().Execute("DROP TABLE segment_usage");
@@ -201,11 +203,34 @@ bool VisitSegmentDatabase::IncreaseSegmentVisitCount(SegmentID segment_id,
   }
 }
 
+void VisitSegmentDatabase::AddPendingSegmentVisitCount(SegmentID segment_id,
+                                                       base::Time ts,
+                                                       int amount) {
+  pending_segment_visit_counts_[std::make_pair(segment_id,
+                                               ts.LocalMidnight())] += amount;
+}
+
+bool VisitSegmentDatabase::CommitPendingSegmentVisitCounts() {
+  bool ok = true;
+  for (const auto& count : pending_segment_visit_counts_) {
+    ok &= IncreaseSegmentVisitCount(count.first.first, count.first.second,
+                                    count.second);
+  }
+  pending_segment_visit_counts_.clear();
+  return ok;
+}
+
+void VisitSegmentDatabase::DiscardPendingSegmentVisitCounts() {
+  pending_segment_visit_counts_.clear();
+}
+
 std::vector<std::unique_ptr<PageUsageData>>
 VisitSegmentDatabase::QuerySegmentUsage(
     base::Time from_time,
     int max_result_count,
     const base::Callback<bool(const GURL&)>& url_filter) {
+  CommitPendingSegmentVisitCounts();
+
   // This function gathers the highest-ranked segments in two queries.
   // The first gathers scores for all segments.
   // The second gathers segment data (url, title, etc.) for the highest-ranked
@@ -286,6 +311,8 @@ VisitSegmentDatabase::QuerySegmentUsage(
 }
 
 bool VisitSegmentDatabase::DeleteSegmentData(base::Time older_than) {
+  CommitPendingSegmentVisitCounts();
+
   sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM segment_usage WHERE time_slot < ?"));
   statement.BindInt64(0, older_than.LocalMidnight().ToInternalValue());
@@ -294,6 +321,8 @@ bool VisitSegmentDatabase::DeleteSegmentData(base::Time older_than) {
 }
 
 bool VisitSegmentDatabase::DeleteSegmentForURL(URLID url_id) {
+  CommitPendingSegmentVisitCounts();
+
   sql::Statement delete_usage(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM segment_usage WHERE segment_id IN "
       "(SELECT id FROM segments WHERE url_id = ?)"));
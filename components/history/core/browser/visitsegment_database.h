@@ -5,7 +5,9 @@
 #ifndef COMPONENTS_HISTORY_CORE_BROWSER_VISITSEGMENT_DATABASE_H_
 #define COMPONENTS_HISTORY_CORE_BROWSER_VISITSEGMENT_DATABASE_H_
 
+#include <map>
 #include <memory>
+#include <utility>
 
 #include "base/callback_forward.h"
 #include "base/macros.h"
@@ -53,6 +55,21 @@ class VisitSegmentDatabase {
   bool IncreaseSegmentVisitCount(SegmentID segment_id, base::Time ts,
                                  int amount);
 
+  // Like IncreaseSegmentVisitCount(), but only adds to a count kept in memory.
+  // Repeated visits to a segment on the same day are merged, and written by
+  // CommitPendingSegmentVisitCounts().  The segment queries below commit the
+  // pending counts first, so they always see them.
+  void AddPendingSegmentVisitCount(SegmentID segment_id, base::Time ts,
+                                   int amount);
+
+  // Writes the counts added by AddPendingSegmentVisitCount().  Returns true on
+  // success.
+  bool CommitPendingSegmentVisitCounts();
+
+  // Forgets the counts added by AddPendingSegmentVisitCount(), for when the
+  // transaction holding the visits is rolled back.
+  void DiscardPendingSegmentVisitCounts();
+
   // Computes the segment usage since |from_time|. If |url_filter| is non-null,
   // then only URLs for which it returns true will be included.
   // Returns the highest-scored segments up to |max_result_count|.
@@ -88,6 +105,10 @@ class VisitSegmentDatabase {
   bool MigratePresentationIndex();
 
  private:
+  // Visit counts not written to segment_usage yet, keyed by segment and by
+  // the local midnight of the day they are counted for.
+  std::map<std::pair<SegmentID, base::Time>, int> pending_segment_visit_counts_;
+
   DISALLOW_COPY_AND_ASSIGN(VisitSegmentDatabase);
 };
 
@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "base/bind.h"
 #include "base/memory/ptr_util.h"
 #include "components/leveldb/env_mojo.h"
 #include "components/leveldb/leveldb_database_impl.h"
@@ -21,7 +22,10 @@ namespace leveldb {
 
 LevelDBServiceImpl::LevelDBServiceImpl(
     scoped_refptr<base::SingleThreadTaskRunner> task_runner)
-    : thread_(new LevelDBMojoProxy(std::move(task_runner))) {}
+    : thread_(new LevelDBMojoProxy(std::move(task_runner))),
+      memory_pressure_listener_(
+          base::Bind(&LevelDBServiceImpl::OnMemoryPressure,
+                     base::Unretained(this))) {}
 
 LevelDBServiceImpl::~LevelDBServiceImpl() {}
 
@@ -49,6 +53,10 @@ void LevelDBServiceImpl::OpenWithOptions(
   options.reuse_logs = leveldb_env::kDefaultLogReuseOptionValue;
   options.compression = leveldb::kSnappyCompression;
 
+  // Every database opened through the service shares one block cache, rather
+  // than each keeping its own.
+  options.block_cache = leveldb_env::SharedBlockCache();
+
   // Register our directory with the file thread.
   LevelDBMojoProxy::OpaqueDir* dir =
       thread_->RegisterDirectory(std::move(directory));
@@ -89,4 +97,10 @@ void LevelDBServiceImpl::OpenInMemory(
   callback.Run(LeveldbStatusToError(s));
 }
 
+void LevelDBServiceImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  // Blocks in use by iterators stay in the cache until they are released.
+  leveldb_env::SharedBlockCache()->Prune();
+}
+
 }  // namespace leveldb
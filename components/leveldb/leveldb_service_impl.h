@@ -5,6 +5,7 @@
 #ifndef COMPONENTS_LEVELDB_LEVELDB_SERVICE_IMPL_H_
 #define COMPONENTS_LEVELDB_LEVELDB_SERVICE_IMPL_H_
 
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
 #include "components/leveldb/leveldb_mojo_proxy.h"
 #include "components/leveldb/public/interfaces/leveldb.mojom.h"
@@ -32,11 +33,17 @@ class LevelDBServiceImpl : public mojom::LevelDBService {
                     const OpenInMemoryCallback& callback) override;
 
  private:
+  // Drops the unused entries of the block cache shared by the databases.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   // Thread to own the mojo message pipe. Because leveldb spawns multiple
   // threads that want to call file stuff, we create a dedicated thread to send
   // and receive mojo message calls.
   scoped_refptr<LevelDBMojoProxy> thread_;
 
+  base::MemoryPressureListener memory_pressure_listener_;
+
   DISALLOW_COPY_AND_ASSIGN(LevelDBServiceImpl);
 };
 
@@ -1242,7 +1242,7 @@ TEST_F(InMemoryURLIndexTest, AddHistoryMatch) {
     URLIndexPrivateData::AddHistoryMatch match(nullptr, nullptr,
                                                *GetPrivateData(),
                                                lower_string, lower_terms,
-                                               base::Time::Now());
+                                               base::Time::Now(), kMaxMatches);
 
     // Verify against expectations.
     EXPECT_EQ(test_cases[i].expected_word_starts_offsets_size,
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <limits>
@@ -250,25 +251,13 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     // but this is such a rare edge case that it's not worth the time.
     return scored_items;
   }
-  scored_items =
-      std::for_each(
-          history_id_set.begin(), history_id_set.end(),
-          AddHistoryMatch(bookmark_model, template_url_service, *this,
-                          lower_raw_string, lower_raw_terms,
-                          base::Time::Now())).ScoredMatches();
-
-  // Select and sort only the top |max_matches| results.
-  if (scored_items.size() > max_matches) {
-    std::partial_sort(scored_items.begin(),
-                      scored_items.begin() +
-                          max_matches,
-                      scored_items.end(),
-                      ScoredHistoryMatch::MatchScoreGreater);
-      scored_items.resize(max_matches);
-  } else {
-    std::sort(scored_items.begin(), scored_items.end(),
-              ScoredHistoryMatch::MatchScoreGreater);
-  }
+  // Only the top |max_matches| results are kept while scoring.
+  AddHistoryMatch add_history_match(bookmark_model, template_url_service,
+                                    *this, lower_raw_string, lower_raw_terms,
+                                    base::Time::Now(), max_matches);
+  for (HistoryID history_id : history_id_set)
+    add_history_match(history_id);
+  scored_items = add_history_match.TakeScoredMatches();
   post_scoring_item_count_ = scored_items.size();
 
   if (was_trimmed) {
@@ -828,15 +817,10 @@ void URLIndexPrivateData::UpdateWordHistory(WordID word_id,
 
 void URLIndexPrivateData::AddToHistoryIDWordMap(HistoryID history_id,
                                                 WordID word_id) {
-  HistoryIDWordMap::iterator iter = history_id_word_map_.find(history_id);
-  if (iter != history_id_word_map_.end()) {
-    WordIDSet& word_id_set(iter->second);
-    word_id_set.insert(word_id);
-  } else {
-    WordIDSet word_id_set;
-    word_id_set.insert(word_id);
-    history_id_word_map_[history_id] = word_id_set;
-  }
+  // Word IDs mostly come in increasing order, both when restoring the cache
+  // and when indexing new words, so hint that they go at the end.
+  WordIDSet& word_id_set(history_id_word_map_[history_id]);
+  word_id_set.insert(word_id_set.end(), word_id);
 }
 
 void URLIndexPrivateData::RemoveRowFromIndex(const history::URLRow& row) {
@@ -1078,6 +1062,7 @@ bool URLIndexPrivateData::RestoreWordList(
   if (actual_item_count == 0 || actual_item_count != expected_item_count)
     return false;
   const RepeatedPtrField<std::string>& words(list_item.word());
+  word_list_.reserve(actual_item_count);
   for (RepeatedPtrField<std::string>::const_iterator iter = words.begin();
        iter != words.end(); ++iter)
     word_list_.push_back(base::UTF8ToUTF16(*iter));
@@ -1093,10 +1078,15 @@ bool URLIndexPrivateData::RestoreWordMap(
   uint32_t actual_item_count = list_item.word_map_entry_size();
   if (actual_item_count == 0 || actual_item_count != expected_item_count)
     return false;
+  // The cache is written in sorted order, so each entry goes at the end of the
+  // map.
   const RepeatedPtrField<WordMapEntry>& entries(list_item.word_map_entry());
   for (RepeatedPtrField<WordMapEntry>::const_iterator iter = entries.begin();
-       iter != entries.end(); ++iter)
-    word_map_[base::UTF8ToUTF16(iter->word())] = iter->word_id();
+       iter != entries.end(); ++iter) {
+    word_map_.insert(word_map_.end(),
+                     std::make_pair(base::UTF8ToUTF16(iter->word()),
+                                    static_cast<WordID>(iter->word_id())));
+  }
   return true;
 }
 
@@ -1118,12 +1108,11 @@ bool URLIndexPrivateData::RestoreCharWordMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     base::char16 uni_char = static_cast<base::char16>(iter->char_16());
-    WordIDSet word_id_set;
+    WordIDSet& word_id_set(char_word_map_[uni_char]);
     const RepeatedField<int32_t>& word_ids(iter->word_id());
     for (RepeatedField<int32_t>::const_iterator jiter = word_ids.begin();
          jiter != word_ids.end(); ++jiter)
-      word_id_set.insert(*jiter);
-    char_word_map_[uni_char] = word_id_set;
+      word_id_set.insert(word_id_set.end(), *jiter);
   }
   return true;
 }
@@ -1146,14 +1135,13 @@ bool URLIndexPrivateData::RestoreWordIDHistoryMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     WordID word_id = iter->word_id();
-    HistoryIDSet history_id_set;
+    HistoryIDSet& history_id_set(word_id_history_map_[word_id]);
     const RepeatedField<int64_t>& history_ids(iter->history_id());
     for (RepeatedField<int64_t>::const_iterator jiter = history_ids.begin();
          jiter != history_ids.end(); ++jiter) {
-      history_id_set.insert(*jiter);
+      history_id_set.insert(history_id_set.end(), *jiter);
       AddToHistoryIDWordMap(*jiter, word_id);
     }
-    word_id_history_map_[word_id] = history_id_set;
   }
   return true;
 }
@@ -1169,6 +1157,7 @@ bool URLIndexPrivateData::RestoreHistoryInfoMap(
     return false;
   const RepeatedPtrField<HistoryInfoMapEntry>&
       entries(list_item.history_info_map_entry());
+  history_info_map_.reserve(actual_item_count);
   for (RepeatedPtrField<HistoryInfoMapEntry>::const_iterator iter =
        entries.begin(); iter != entries.end(); ++iter) {
     HistoryID history_id = iter->history_id();
@@ -1181,17 +1170,18 @@ bool URLIndexPrivateData::RestoreHistoryInfoMap(
       base::string16 title(base::UTF8ToUTF16(iter->title()));
       url_row.set_title(title);
     }
-    history_info_map_[history_id].url_row = url_row;
+    HistoryInfoMapValue& history_info = history_info_map_[history_id];
+    history_info.url_row = url_row;
 
     // Restore visits list.
-    VisitInfoVector visits;
+    VisitInfoVector& visits = history_info.visits;
+    visits.clear();
     visits.reserve(iter->visits_size());
     for (int i = 0; i < iter->visits_size(); ++i) {
       visits.push_back(std::make_pair(
           base::Time::FromInternalValue(iter->visits(i).visit_time()),
           ui::PageTransitionFromInt(iter->visits(i).transition_type())));
     }
-    history_info_map_[history_id].visits = visits;
   }
   return true;
 }
@@ -1211,19 +1201,22 @@ bool URLIndexPrivateData::RestoreWordStartsMap(
         entries(list_item.word_starts_map_entry());
     for (RepeatedPtrField<WordStartsMapEntry>::const_iterator iter =
          entries.begin(); iter != entries.end(); ++iter) {
-      HistoryID history_id = iter->history_id();
-      RowWordStarts word_starts;
+      RowWordStarts& word_starts =
+          word_starts_map_.insert(word_starts_map_.end(),
+                                  std::make_pair(iter->history_id(),
+                                                 RowWordStarts()))->second;
       // Restore the URL word starts.
       const RepeatedField<int32_t>& url_starts(iter->url_word_starts());
+      word_starts.url_word_starts_.reserve(url_starts.size());
       for (RepeatedField<int32_t>::const_iterator jiter = url_starts.begin();
            jiter != url_starts.end(); ++jiter)
         word_starts.url_word_starts_.push_back(*jiter);
       // Restore the page title word starts.
       const RepeatedField<int32_t>& title_starts(iter->title_word_starts());
+      word_starts.title_word_starts_.reserve(title_starts.size());
       for (RepeatedField<int32_t>::const_iterator jiter = title_starts.begin();
            jiter != title_starts.end(); ++jiter)
         word_starts.title_word_starts_.push_back(*jiter);
-      word_starts_map_[history_id] = word_starts;
     }
   } else {
     // Since the cache did not contain any word starts we must rebuild then from
@@ -1277,10 +1270,12 @@ URLIndexPrivateData::AddHistoryMatch::AddHistoryMatch(
     const URLIndexPrivateData& private_data,
     const base::string16& lower_string,
     const String16Vector& lower_terms,
-    const base::Time now)
+    const base::Time now,
+    size_t max_matches)
     : bookmark_model_(bookmark_model),
       template_url_service_(template_url_service),
       private_data_(private_data),
+      max_matches_(max_matches),
       lower_string_(lower_string),
       lower_terms_(lower_terms),
       now_(now) {
@@ -1324,11 +1319,33 @@ void URLIndexPrivateData::AddHistoryMatch::operator()(
         lower_terms_to_word_starts_offsets_, starts_pos->second,
         bookmark_model_ && bookmark_model_->IsBookmarked(hist_item.url()),
         template_url_service_, now_);
-    if (match.raw_score > 0)
+    if (match.raw_score <= 0)
+      return;
+    if (scored_matches_.size() < max_matches_) {
       scored_matches_.push_back(match);
+      std::push_heap(scored_matches_.begin(), scored_matches_.end(),
+                     ScoredHistoryMatch::MatchScoreGreater);
+    } else if (max_matches_ > 0 &&
+               ScoredHistoryMatch::MatchScoreGreater(
+                   match, scored_matches_.front())) {
+      // Replace the worst of the matches kept so far.
+      std::pop_heap(scored_matches_.begin(), scored_matches_.end(),
+                    ScoredHistoryMatch::MatchScoreGreater);
+      scored_matches_.back() = match;
+      std::push_heap(scored_matches_.begin(), scored_matches_.end(),
+                     ScoredHistoryMatch::MatchScoreGreater);
+    }
   }
 }
 
+ScoredHistoryMatches URLIndexPrivateData::AddHistoryMatch::TakeScoredMatches() {
+  std::sort_heap(scored_matches_.begin(), scored_matches_.end(),
+                 ScoredHistoryMatch::MatchScoreGreater);
+  ScoredHistoryMatches scored_matches;
+  scored_matches.swap(scored_matches_);
+  return scored_matches;
+}
+
 
 // URLIndexPrivateData::HistoryItemFactorGreater -------------------------------
 
@@ -195,13 +195,15 @@ class URLIndexPrivateData
                     const URLIndexPrivateData& private_data,
                     const base::string16& lower_string,
                     const String16Vector& lower_terms,
-                    const base::Time now);
+                    const base::Time now,
+                    size_t max_matches);
     AddHistoryMatch(const AddHistoryMatch& other);
     ~AddHistoryMatch();
 
     void operator()(const HistoryID history_id);
 
-    ScoredHistoryMatches ScoredMatches() const { return scored_matches_; }
+    // Returns the best |max_matches| matches, best first.
+    ScoredHistoryMatches TakeScoredMatches();
 
    private:
     friend class InMemoryURLIndexTest;
@@ -209,7 +211,10 @@ class URLIndexPrivateData
     bookmarks::BookmarkModel* bookmark_model_;
     TemplateURLService* template_url_service_;
     const URLIndexPrivateData& private_data_;
+    // The best matches so far, as a heap with the worst of them on top, so
+    // only |max_matches_| of them are ever kept.
     ScoredHistoryMatches scored_matches_;
+    const size_t max_matches_;
     const base::string16& lower_string_;
     const String16Vector& lower_terms_;
     WordStarts lower_terms_to_word_starts_offsets_;
@@ -75,8 +75,13 @@ class FetcherPool {
   // Returns the maximum size of the pool.
   size_t max_size() const { return max_size_; }
 
+  // Changes the maximum size of the pool. If it is made smaller than the
+  // current number of elements, none are deleted, but the pool won't accept
+  // new elements until enough have been deleted.
+  void set_max_size(size_t max_size) { max_size_ = max_size; }
+
  private:
-  const size_t max_size_;
+  size_t max_size_;
   std::unordered_map<const T*, std::unique_ptr<T>> elements_;
 
   DISALLOW_COPY_AND_ASSIGN(FetcherPool);
@@ -145,6 +145,35 @@ TEST(FetcherPoolTest, DeleteAll) {
   EXPECT_TRUE(pool.IsAvailable());
 }
 
+TEST(FetcherPoolTest, SetMaxSize) {
+  MockURLFetcherDelegate delegate;
+  FetcherPool<URLFetcher> pool(2);
+  std::unique_ptr<URLFetcher> url_fetcher1(
+      new FakeURLFetcher(GURL("http://a.com"), &delegate, "irrelevant",
+                         HTTP_OK, URLRequestStatus::SUCCESS));
+  URLFetcher* url_fetcher1_ptr = url_fetcher1.get();
+  std::unique_ptr<URLFetcher> url_fetcher2(
+      new FakeURLFetcher(GURL("http://b.com"), &delegate, "irrelevant",
+                         HTTP_OK, URLRequestStatus::SUCCESS));
+  pool.Add(std::move(url_fetcher1));
+  pool.Add(std::move(url_fetcher2));
+  EXPECT_FALSE(pool.IsAvailable());
+
+  pool.set_max_size(3);
+  EXPECT_EQ(3u, pool.max_size());
+  EXPECT_TRUE(pool.IsAvailable());
+
+  // Shrinking keeps the elements, but no new ones are accepted until enough
+  // have been deleted.
+  pool.set_max_size(1);
+  EXPECT_EQ(2u, pool.elements().size());
+  EXPECT_FALSE(pool.IsAvailable());
+  pool.Delete(*url_fetcher1_ptr);
+  EXPECT_FALSE(pool.IsAvailable());
+  pool.DeleteAll();
+  EXPECT_TRUE(pool.IsAvailable());
+}
+
 #if GTEST_HAS_DEATH_TEST && !defined(NDEBUG)
 
 TEST(FetcherPoolTest, AddTooManyURLFetchers) {
@@ -21,6 +21,7 @@
 #include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/task_runner_util.h"
 #include "components/precache/core/precache_switches.h"
 #include "components/precache/core/proto/precache.pb.h"
 #include "components/precache/core/proto/unfinished_work.pb.h"
@@ -30,7 +31,9 @@
 #include "net/base/load_flags.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_response_headers.h"
+#include "net/nqe/network_quality_estimator.h"
 #include "net/url_request/url_fetcher_response_writer.h"
+#include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_request_status.h"
 
@@ -51,6 +54,16 @@ namespace {
 // The maximum number of URLFetcher requests that can be on flight in parallel.
 const int kMaxParallelFetches = 10;
 
+// The maximum number of manifest requests that can be on flight in parallel.
+// Fetching the next manifests while the resources of the previous one finish
+// keeps the pool busy, but each manifest adds to |resource_urls_to_fetch_|.
+const size_t kMaxParallelManifestFetches = 3;
+
+// The downlink throughput that each parallel fetch is given, according to the
+// network quality estimator. Slow networks are not saturated by precaching,
+// and fast ones get up to kMaxParallelFetches.
+const int32_t kDownlinkKbpsPerParallelFetch = 500;
+
 // The maximum for the Precache.Fetch.ResponseBytes.* histograms. We set this to
 // a number we expect to be in the 99th percentile for the histogram, give or
 // take.
@@ -173,6 +186,22 @@ void AppendManifestURLIfValidAndNew(
   }
 }
 
+// Returns the downlink throughput estimate of the network quality estimator of
+// |request_context|, in kbps, or -1 if there is none. Must be called on the
+// network thread.
+int32_t GetDownlinkThroughputKbpsEstimate(
+    scoped_refptr<net::URLRequestContextGetter> request_context) {
+  const net::URLRequestContext* context =
+      request_context->GetURLRequestContext();
+  int32_t kbps;
+  if (!context || !context->network_quality_estimator() ||
+      !context->network_quality_estimator()->GetDownlinkThroughputKbpsEstimate(
+          &kbps)) {
+    return -1;
+  }
+  return kbps;
+}
+
 }  // namespace
 
 PrecacheFetcher::Fetcher::Fetcher(
@@ -379,6 +408,8 @@ std::unique_ptr<PrecacheUnfinishedWork> PrecacheFetcher::CancelPrecaching() {
 }
 
 void PrecacheFetcher::Start() {
+  UpdateMaxParallelFetches();
+
   if (unfinished_work_->has_config_settings()) {
     DCHECK(unfinished_work_->has_start_time());
     DetermineManifests();
@@ -423,16 +454,55 @@ void PrecacheFetcher::StartNextManifestFetch() {
   if (manifest_urls_to_fetch_.empty() || !pool_.IsAvailable())
     return;
 
-  // We only fetch one manifest at a time to keep the size of
-  // resource_urls_to_fetch_ as small as possible.
-  VLOG(3) << "Fetching " << manifest_urls_to_fetch_.front();
-  pool_.Add(base::WrapUnique(new Fetcher(
-      request_context_.get(), manifest_urls_to_fetch_.front(),
-      base::Bind(&PrecacheFetcher::OnManifestFetchComplete,
-                 base::Unretained(this)),
-      false /* is_resource_request */, std::numeric_limits<int32_t>::max())));
+  // We only fetch a few manifests at a time to keep the size of
+  // resource_urls_to_fetch_ small.
+  size_t manifests_in_pool = 0;
+  for (const auto& element_pair : pool_.elements()) {
+    const Fetcher* fetcher = element_pair.first;
+    if (!fetcher->is_resource_request() && fetcher->url() != config_url_)
+      manifests_in_pool++;
+  }
 
-  manifest_urls_to_fetch_.pop_front();
+  while (!manifest_urls_to_fetch_.empty() && pool_.IsAvailable() &&
+         manifests_in_pool < kMaxParallelManifestFetches) {
+    VLOG(3) << "Fetching " << manifest_urls_to_fetch_.front();
+    pool_.Add(base::WrapUnique(new Fetcher(
+        request_context_.get(), manifest_urls_to_fetch_.front(),
+        base::Bind(&PrecacheFetcher::OnManifestFetchComplete,
+                   base::Unretained(this)),
+        false /* is_resource_request */,
+        std::numeric_limits<int32_t>::max())));
+
+    manifest_urls_to_fetch_.pop_front();
+    manifests_in_pool++;
+  }
+}
+
+void PrecacheFetcher::UpdateMaxParallelFetches() {
+  base::PostTaskAndReplyWithResult(
+      request_context_->GetNetworkTaskRunner().get(), FROM_HERE,
+      base::Bind(&GetDownlinkThroughputKbpsEstimate, request_context_),
+      base::Bind(&PrecacheFetcher::OnDownlinkThroughputEstimate,
+                 AsWeakPtr()));
+}
+
+void PrecacheFetcher::OnDownlinkThroughputEstimate(int32_t downlink_kbps) {
+  // Without an estimate, keep the current size.
+  if (downlink_kbps < 0)
+    return;
+
+  const size_t max_parallel_fetches = std::max(
+      1, std::min(kMaxParallelFetches,
+                  downlink_kbps / kDownlinkKbpsPerParallelFetch));
+  const bool grew = max_parallel_fetches > pool_.max_size();
+  pool_.set_max_size(max_parallel_fetches);
+
+  // An empty pool means that precaching is not started or done. The next
+  // fetches are started as the config is fetched.
+  if (grew && !pool_.IsEmpty() && unfinished_work_->has_config_settings()) {
+    StartNextResourceFetch();
+    StartNextManifestFetch();
+  }
 }
 
 void PrecacheFetcher::NotifyDone(
@@ -531,6 +601,8 @@ void PrecacheFetcher::DetermineManifests() {
 void PrecacheFetcher::OnManifestFetchComplete(const Fetcher& source) {
   DCHECK(unfinished_work_->has_config_settings());
   UpdateStats(source.response_bytes(), source.network_response_bytes());
+  // Adapt to the network conditions once per manifest.
+  UpdateMaxParallelFetches();
   if (source.network_url_fetcher() == nullptr) {
     pool_.DeleteAll();  // Cancel any other ongoing request.
   } else {
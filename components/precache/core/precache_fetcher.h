@@ -132,15 +132,23 @@ class PrecacheFetcher : public base::SupportsWeakPtr<PrecacheFetcher> {
   void NotifyDone(size_t remaining_manifest_urls_to_fetch,
                   size_t remaining_resource_urls_to_fetch);
 
-  // Fetches the next resource or manifest URL, if any remain. Fetching is done
-  // sequentially and depth-first: all resources are fetched for a manifest
-  // before the next manifest is fetched. This is done to limit the length of
+  // Fetches the next resource or manifest URLs, if any remain. Fetching is
+  // done mostly depth-first: resources are fetched before manifests, and only
+  // a few manifests are fetched at a time. This is done to limit the length of
   // the |resource_urls_to_fetch_| list, reducing the memory usage.
   void StartNextFetch();
 
   void StartNextManifestFetch();
   void StartNextResourceFetch();
 
+  // Asynchronously reads the downlink throughput estimate of the network
+  // quality estimator, and sizes |pool_| according to it.
+  void UpdateMaxParallelFetches();
+
+  // Called with the downlink throughput estimate, in kbps, or a negative value
+  // if there is none. Starts more fetches if the pool has grown.
+  void OnDownlinkThroughputEstimate(int32_t downlink_kbps);
+
   // Called when the precache configuration settings have been fetched.
   // Determines the list of manifest URLs to fetch according to the list of
   // |starting_hosts_| and information from the precache configuration settings.
@@ -178,6 +186,8 @@ class PrecacheFetcher : public base::SupportsWeakPtr<PrecacheFetcher> {
   std::list<GURL> manifest_urls_to_fetch_;
   std::list<GURL> resource_urls_to_fetch_;
 
+  // Its size follows the network throughput estimate, up to
+  // kMaxParallelFetches.
   FetcherPool<Fetcher> pool_;
 
   std::unique_ptr<PrecacheUnfinishedWork> unfinished_work_;
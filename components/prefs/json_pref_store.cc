@@ -15,10 +15,13 @@
 #include "base/files/file_util.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram.h"
 #include "base/sequenced_task_runner.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task_runner_util.h"
@@ -171,6 +174,7 @@ JsonPrefStore::JsonPrefStore(
       filtering_in_progress_(false),
       pending_lossy_write_(false),
       read_error_(PREF_READ_ERROR_NONE),
+      all_dirty_(true),
       write_count_histogram_(writer_.commit_interval(), path_) {
   DCHECK(!path_.empty());
 }
@@ -216,6 +220,8 @@ bool JsonPrefStore::GetMutableValue(const std::string& key,
                                     base::Value** result) {
   DCHECK(CalledOnValidThread());
 
+  // The value is about to be changed.
+  MarkDirty(key);
   return prefs_->Get(key, result);
 }
 
@@ -243,6 +249,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   prefs_->Get(key, &old_value);
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, std::move(value));
+    MarkDirty(key);
     ScheduleWrite(flags);
   }
 }
@@ -259,6 +266,7 @@ void JsonPrefStore::RemoveValueSilently(const std::string& key,
   DCHECK(CalledOnValidThread());
 
   prefs_->RemovePath(key, nullptr);
+  MarkDirty(key);
   ScheduleWrite(flags);
 }
 
@@ -318,6 +326,8 @@ void JsonPrefStore::ReportValueChanged(const std::string& key, uint32_t flags) {
   if (pref_filter_)
     pref_filter_->FilterUpdate(key);
 
+  MarkDirty(key);
+
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
 
   ScheduleWrite(flags);
@@ -401,15 +411,57 @@ bool JsonPrefStore::SerializeData(std::string* output) {
 
   write_count_histogram_.RecordWriteOccured();
 
-  if (pref_filter_)
+  if (pref_filter_) {
     pref_filter_->FilterSerializeData(prefs_.get());
+    const std::string filtered_key = pref_filter_->GetSerializeDataKey();
+    if (filtered_key.empty())
+      all_dirty_ = true;
+    else
+      dirty_keys_.insert(filtered_key);
+  }
 
-  JSONStringValueSerializer serializer(output);
-  // Not pretty-printing prefs shrinks pref file size by ~30%. To obtain
+  return SerializeIncrementally(output);
+}
+
+bool JsonPrefStore::SerializeIncrementally(std::string* output) {
+  if (all_dirty_) {
+    serialized_prefs_.clear();
+  } else {
+    for (const std::string& key : dirty_keys_) {
+      if (!prefs_->HasKey(key))
+        serialized_prefs_.erase(key);
+    }
+  }
+
+  // Matches the output of JSONStringValueSerializer, without pretty-printing:
+  // not pretty-printing prefs shrinks pref file size by ~30%. To obtain
   // readable prefs for debugging purposes, you can dump your prefs into any
   // command-line or online JSON pretty printing tool.
-  serializer.set_pretty_print(false);
-  return serializer.Serialize(*prefs_);
+  bool result = true;
+  output->clear();
+  output->push_back('{');
+  for (base::DictionaryValue::Iterator it(*prefs_); !it.IsAtEnd();
+       it.Advance()) {
+    std::string& serialized_pref = serialized_prefs_[it.key()];
+    if (serialized_pref.empty() || ContainsKey(dirty_keys_, it.key())) {
+      serialized_pref.clear();
+      base::EscapeJSONString(it.key(), true, &serialized_pref);
+      serialized_pref.push_back(':');
+      std::string value_json;
+      if (!base::JSONWriter::Write(it.value(), &value_json))
+        result = false;
+      serialized_pref.append(value_json);
+    }
+    if (output->size() > 1)
+      output->push_back(',');
+    output->append(serialized_pref);
+  }
+  output->push_back('}');
+
+  dirty_keys_.clear();
+  // Don't keep what failed to serialize.
+  all_dirty_ = !result;
+  return result;
 }
 
 void JsonPrefStore::FinalizeFileRead(
@@ -428,6 +480,7 @@ void JsonPrefStore::FinalizeFileRead(
   }
 
   prefs_ = std::move(prefs);
+  all_dirty_ = true;
 
   initialized_ = true;
 
@@ -444,6 +497,10 @@ void JsonPrefStore::FinalizeFileRead(
   return;
 }
 
+void JsonPrefStore::MarkDirty(const std::string& path) {
+  dirty_keys_.insert(path.substr(0, path.find('.')));
+}
+
 void JsonPrefStore::ScheduleWrite(uint32_t flags) {
   if (read_only_)
     return;
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -41,6 +42,12 @@ FORWARD_DECLARE_TEST(JsonPrefStoreTest, WriteCountHistogramTestPeriodWithGaps);
 }
 
 // A writable PrefStore implementation that is used for user preferences.
+//
+// Writes serialize the whole pref tree, but the serialization of each
+// top-level pref is cached until it changes, so that writing a large tree
+// after a small change doesn't have to serialize it all again. Callers that
+// mutate a value obtained from GetMutableValue() must call
+// ReportValueChanged() before the next write, as PersistentPrefStore requires.
 class COMPONENTS_PREFS_EXPORT JsonPrefStore
     : public PersistentPrefStore,
       public base::ImportantFileWriter::DataSerializer,
@@ -200,6 +207,14 @@ class COMPONENTS_PREFS_EXPORT JsonPrefStore
   // WriteablePrefStore::LOSSY_PREF_WRITE_FLAG.
   void ScheduleWrite(uint32_t flags);
 
+  // Marks the top-level pref containing |path| as needing to be serialized
+  // again.
+  void MarkDirty(const std::string& path);
+
+  // Serializes |prefs_| to |output| as JSON, reusing the cached serialization
+  // of the top-level prefs that aren't dirty.
+  bool SerializeIncrementally(std::string* output);
+
   const base::FilePath path_;
   const base::FilePath alternate_path_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
@@ -223,6 +238,13 @@ class COMPONENTS_PREFS_EXPORT JsonPrefStore
 
   std::set<std::string> keys_need_empty_value_;
 
+  // The last serialization of each top-level pref, as a JSON "key":value
+  // member, and the top-level prefs changed since. All are dirty when
+  // |all_dirty_| is set.
+  std::map<std::string, std::string> serialized_prefs_;
+  std::set<std::string> dirty_keys_;
+  bool all_dirty_;
+
   WriteCountHistogram write_count_histogram_;
 
   DISALLOW_COPY_AND_ASSIGN(JsonPrefStore);
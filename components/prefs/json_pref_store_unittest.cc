@@ -967,4 +967,42 @@ TEST_F(JsonPrefStoreLossyWriteTest, ScheduleLossyWrite) {
   ASSERT_EQ("{\"lossy\":\"lossy\"}", GetTestFileContents());
 }
 
+class JsonPrefStoreIncrementalWriteTest : public JsonPrefStoreLossyWriteTest {};
+
+TEST_F(JsonPrefStoreIncrementalWriteTest, OnlyChangedPrefsAreReserialized) {
+  scoped_refptr<JsonPrefStore> pref_store = CreatePrefStore();
+  ImportantFileWriter* file_writer = GetImportantFileWriter(pref_store);
+
+  pref_store->SetValue("a", base::WrapUnique(new base::FundamentalValue(1)),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->SetValue("b.x", base::WrapUnique(new base::FundamentalValue(1)),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->SetValue("d", base::WrapUnique(new base::StringValue("d")),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  file_writer->DoScheduledWrite();
+  ASSERT_EQ("{\"a\":1,\"b\":{\"x\":1},\"d\":\"d\"}", GetTestFileContents());
+
+  // Change a nested value in place, remove a pref and add another.
+  base::Value* value = nullptr;
+  base::DictionaryValue* dictionary = nullptr;
+  ASSERT_TRUE(pref_store->GetMutableValue("b", &value));
+  ASSERT_TRUE(value->GetAsDictionary(&dictionary));
+  dictionary->SetInteger("y", 2);
+  pref_store->ReportValueChanged("b",
+                                 WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->RemoveValue("a", WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->SetValue("c", base::WrapUnique(new base::StringValue("c")),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  file_writer->DoScheduledWrite();
+  ASSERT_EQ("{\"b\":{\"x\":1,\"y\":2},\"c\":\"c\",\"d\":\"d\"}",
+            GetTestFileContents());
+
+  // Bring a removed pref back, with another value.
+  pref_store->SetValue("a", base::WrapUnique(new base::FundamentalValue(3)),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  file_writer->DoScheduledWrite();
+  ASSERT_EQ("{\"a\":3,\"b\":{\"x\":1,\"y\":2},\"c\":\"c\",\"d\":\"d\"}",
+            GetTestFileContents());
+}
+
 }  // namespace base
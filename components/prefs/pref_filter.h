@@ -51,6 +51,12 @@ class COMPONENTS_PREFS_EXPORT PrefFilter {
   // in-memory state.
   virtual void FilterSerializeData(
       base::DictionaryValue* pref_store_contents) = 0;
+
+  // Returns the top-level key of the only part of the pref store contents that
+  // FilterSerializeData() may modify, so that pref stores caching the
+  // serialization of the rest can keep it. Returns an empty string, by
+  // default, if it may modify anything.
+  virtual std::string GetSerializeDataKey() const { return std::string(); }
 };
 
 #endif  // COMPONENTS_PREFS_PREF_FILTER_H_
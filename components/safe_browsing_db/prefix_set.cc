@@ -5,6 +5,7 @@
 #include "components/safe_browsing_db/prefix_set.h"
 
 #include <limits.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
@@ -80,6 +81,37 @@ size_t EstimateFinalCount(SBPrefix current_prefix, size_t current_count) {
   return estimated_prefix_count + estimated_prefix_count / 100;
 }
 
+// The filter is made of cache line sized blocks of |kFilterBlockWords| words,
+// with |kFilterBitsPerPrefix| bits of filter per prefix in the set.  Each
+// prefix sets |kFilterProbes| bits in one block, picked from a hash of the
+// prefix.  About 3% of absent prefixes get past the filter.
+const size_t kFilterBlockWords = 8;
+const size_t kFilterBlockBits = kFilterBlockWords * 64;
+const size_t kFilterProbes = 4;
+const size_t kFilterBitsPerPrefix = 8;
+
+// Mixes the bits of |prefix|.  Prefixes are already hashes, but sets built
+// for tests are not always uniformly distributed.  This is the finalizer of
+// MurmurHash3.
+uint64_t FilterHash(SBPrefix prefix) {
+  uint64_t hash = prefix;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Each of the |kFilterProbes| bit positions within a block uses 9 of the low
+// bits of the hash, the block is picked with the 28 high bits.
+static_assert(kFilterBlockBits == 1 << 9, "bit positions use 9 bits of hash");
+static_assert(kFilterProbes * 9 <= 36, "block uses the high 28 bits");
+
+size_t FilterBlock(uint64_t hash, size_t blocks) {
+  return static_cast<size_t>(((hash >> 36) * blocks) >> 28);
+}
+
 }  // namespace
 
 // For |std::upper_bound()| to find a prefix w/in a vector of pairs.
@@ -88,16 +120,18 @@ bool PrefixSet::PrefixLess(const IndexPair& a, const IndexPair& b) {
   return a.first < b.first;
 }
 
-PrefixSet::PrefixSet() {
+PrefixSet::PrefixSet() : filter_blocks_(0) {
 }
 
 PrefixSet::PrefixSet(IndexVector* index,
                      std::vector<uint16_t>* deltas,
-                     std::vector<SBFullHash>* full_hashes) {
+                     std::vector<SBFullHash>* full_hashes)
+    : filter_blocks_(0) {
   DCHECK(index && deltas && full_hashes);
   index_.swap(*index);
   deltas_.swap(*deltas);
   full_hashes_.swap(*full_hashes);
+  BuildFilter();
 }
 
 PrefixSet::~PrefixSet() {}
@@ -106,6 +140,16 @@ bool PrefixSet::PrefixExists(SBPrefix prefix) const {
   if (index_.empty())
     return false;
 
+  if (!FilterMayContain(prefix))
+    return false;
+
+  return PrefixExistsInIndex(prefix);
+}
+
+bool PrefixSet::PrefixExistsInIndex(SBPrefix prefix) const {
+  if (index_.empty())
+    return false;
+
   // Find the first position after |prefix| in |index_|.
   IndexVector::const_iterator iter =
       std::upper_bound(index_.begin(), index_.end(),
@@ -160,6 +204,58 @@ void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
   }
 }
 
+void PrefixSet::BuildFilter() {
+  const size_t prefix_count = index_.size() + deltas_.size();
+  filter_blocks_ =
+      (prefix_count * kFilterBitsPerPrefix + kFilterBlockBits - 1) /
+      kFilterBlockBits;
+  filter_.reset();
+  if (!filter_blocks_)
+    return;
+
+  const size_t filter_bytes = filter_blocks_ * kFilterBlockWords * 8;
+  filter_.reset(static_cast<uint64_t*>(
+      base::AlignedAlloc(filter_bytes, kFilterBlockWords * 8)));
+  memset(filter_.get(), 0, filter_bytes);
+
+  // Walk the prefixes as |GetPrefixes()| does.
+  for (size_t ii = 0; ii < index_.size(); ++ii) {
+    const size_t deltas_end =
+        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_.size();
+
+    SBPrefix current = index_[ii].first;
+    size_t di = index_[ii].second;
+    while (true) {
+      const uint64_t hash = FilterHash(current);
+      uint64_t* block =
+          filter_.get() + FilterBlock(hash, filter_blocks_) * kFilterBlockWords;
+      for (size_t i = 0; i < kFilterProbes; ++i) {
+        const size_t bit = (hash >> (i * 9)) & (kFilterBlockBits - 1);
+        block[bit / 64] |= 1ULL << (bit % 64);
+      }
+
+      if (di == deltas_end)
+        break;
+      current += deltas_[di++];
+    }
+  }
+}
+
+bool PrefixSet::FilterMayContain(SBPrefix prefix) const {
+  if (!filter_blocks_)
+    return true;
+
+  const uint64_t hash = FilterHash(prefix);
+  const uint64_t* block =
+      filter_.get() + FilterBlock(hash, filter_blocks_) * kFilterBlockWords;
+  for (size_t i = 0; i < kFilterProbes; ++i) {
+    const size_t bit = (hash >> (i * 9)) & (kFilterBlockBits - 1);
+    if (!(block[bit / 64] & (1ULL << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
 // static
 std::unique_ptr<const PrefixSet> PrefixSet::LoadFile(
     const base::FilePath& filter_name) {
@@ -389,6 +485,8 @@ std::unique_ptr<const PrefixSet> PrefixSetBuilder::GetPrefixSet(
   // they're almost free.
   PrefixSet::IndexVector(prefix_set_->index_).swap(prefix_set_->index_);
 
+  prefix_set_->BuildFilter();
+
   prefix_set_->full_hashes_ = hashes;
   std::sort(prefix_set_->full_hashes_.begin(), prefix_set_->full_hashes_.end(),
             SBFullHashLess);
@@ -37,6 +37,13 @@
 // 2^16 apart, which would need 512k (versus 256k to store the raw
 // data).
 //
+// Most lookups are for prefixes which are not in the set, so a blocked
+// bloom filter is checked before the index.  Each prefix sets a few bits
+// in a single 64-byte block, so that a negative lookup usually costs one
+// cache line rather than a binary search of |index_| and a walk of
+// |deltas_|.  The filter uses 8 bits per prefix and is not stored on disk,
+// it is rebuilt when the set is loaded.
+//
 // The on-disk format looks like:
 //         4 byte magic number
 //         4 byte version number
@@ -58,6 +65,7 @@
 
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
+#include "base/memory/aligned_memory.h"
 #include "components/safe_browsing_db/util.h"
 
 namespace base {
@@ -86,6 +94,7 @@ class PrefixSet {
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, AllBig);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, EdgeCases);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, Empty);
+  FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, FilterRejectsMostAbsentPrefixes);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, FullHashBuild);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, IntMinMax);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, OneElement);
@@ -93,6 +102,8 @@ class PrefixSet {
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, ReadWriteSigned);
   FRIEND_TEST_ALL_PREFIXES(PrefixSetTest, Version3);
 
+  FRIEND_TEST_ALL_PREFIXES(PrefixSetPerfTest, Lookups);
+
   FRIEND_TEST_ALL_PREFIXES(SafeBrowsingStoreFileTest, BasicStore);
   FRIEND_TEST_ALL_PREFIXES(SafeBrowsingStoreFileTest, DeleteChunks);
   FRIEND_TEST_ALL_PREFIXES(SafeBrowsingStoreFileTest, DetectsCorruption);
@@ -122,6 +133,15 @@ class PrefixSet {
   // Provided for testing purposes.
   bool PrefixExists(SBPrefix prefix) const;
 
+  // Same as |PrefixExists()|, without checking |filter_| first.
+  bool PrefixExistsInIndex(SBPrefix prefix) const;
+
+  // Populate |filter_| from |index_| and |deltas_|.
+  void BuildFilter();
+
+  // |false| if |prefix| is definitely not in the set.
+  bool FilterMayContain(SBPrefix prefix) const;
+
   // Regenerate the vector of prefixes passed to the constructor into
   // |prefixes|.  Prefixes will be added in sorted order.  Useful for testing.
   void GetPrefixes(std::vector<SBPrefix>* prefixes) const;
@@ -148,6 +168,11 @@ class PrefixSet {
   // Full hashes ordered by SBFullHashLess.
   std::vector<SBFullHash> full_hashes_;
 
+  // Blocked bloom filter over the prefixes, |filter_blocks_| blocks of
+  // 64 bytes aligned on cache lines.
+  std::unique_ptr<uint64_t, base::AlignedFreeDeleter> filter_;
+  size_t filter_blocks_;
+
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
 
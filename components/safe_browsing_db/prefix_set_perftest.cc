@@ -0,0 +1,92 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing_db/prefix_set.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/rand_util.h"
+#include "base/time/time.h"
+#include "components/safe_browsing_db/util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace safe_browsing {
+
+namespace {
+
+// About the number of prefixes in a real browse list.
+const size_t kSetSize = 600 * 1000;
+
+const size_t kLookups = 4 * 1000 * 1000;
+
+}  // namespace
+
+class PrefixSetPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    std::vector<SBPrefix> prefixes;
+    prefixes.reserve(kSetSize);
+    for (size_t i = 0; i < kSetSize; ++i)
+      prefixes.push_back(static_cast<SBPrefix>(base::RandUint64()));
+    std::sort(prefixes.begin(), prefixes.end());
+
+    PrefixSetBuilder builder(prefixes);
+    prefix_set_ = builder.GetPrefixSetNoHashes();
+
+    // Lookups are mostly for prefixes which are not in the set, as for URLs
+    // being navigated to.
+    present_.assign(prefixes.begin(), prefixes.begin() + kLookups / 100);
+    std::random_shuffle(present_.begin(), present_.end());
+    for (size_t i = 0; i < kLookups; ++i)
+      absent_.push_back(static_cast<SBPrefix>(base::RandUint64()));
+  }
+
+  // Runs |prefix_exists| on each of |prefixes|, and reports the number of
+  // lookups per second as |trace|.
+  template <typename PrefixExists>
+  void Measure(const std::string& trace,
+               const std::vector<SBPrefix>& prefixes,
+               PrefixExists prefix_exists) {
+    size_t found = 0;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (SBPrefix prefix : prefixes) {
+      if (prefix_exists(prefix))
+        ++found;
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    // Keeps the loop from being optimized away.
+    EXPECT_LE(found, prefixes.size());
+    perf_test::PrintResult("prefix_set_lookups", "", trace,
+                           prefixes.size() / elapsed.InSecondsF(),
+                           "lookups/s", true);
+  }
+
+  std::unique_ptr<const PrefixSet> prefix_set_;
+  std::vector<SBPrefix> present_;
+  std::vector<SBPrefix> absent_;
+};
+
+TEST_F(PrefixSetPerfTest, Lookups) {
+  const PrefixSet* prefix_set = prefix_set_.get();
+  auto with_filter = [prefix_set](SBPrefix prefix) {
+    return prefix_set->PrefixExists(prefix);
+  };
+  auto without_filter = [prefix_set](SBPrefix prefix) {
+    return prefix_set->PrefixExistsInIndex(prefix);
+  };
+
+  Measure("absent_without_filter", absent_, without_filter);
+  Measure("absent_with_filter", absent_, with_filter);
+  Measure("present_without_filter", present_, without_filter);
+  Measure("present_with_filter", present_, with_filter);
+}
+
+}  // namespace safe_browsing
@@ -308,6 +308,31 @@ TEST_F(PrefixSetTest, AllBig) {
                          prefixes_copy.begin()));
 }
 
+// The filter lets all prefixes in the set through, and keeps most of the
+// others out.
+TEST_F(PrefixSetTest, FilterRejectsMostAbsentPrefixes) {
+  PrefixSetBuilder builder(shared_prefixes_);
+  std::unique_ptr<const PrefixSet> prefix_set = builder.GetPrefixSetNoHashes();
+  ASSERT_LT(0u, prefix_set->filter_blocks_);
+
+  for (size_t i = 0; i < shared_prefixes_.size(); ++i)
+    EXPECT_TRUE(prefix_set->FilterMayContain(shared_prefixes_[i]));
+
+  const std::set<SBPrefix> check(shared_prefixes_.begin(),
+                                 shared_prefixes_.end());
+  size_t absent = 0;
+  size_t false_positives = 0;
+  for (size_t i = 0; i < 100000; ++i) {
+    const SBPrefix prefix = static_cast<SBPrefix>(base::RandUint64());
+    if (check.count(prefix))
+      continue;
+    ++absent;
+    if (prefix_set->FilterMayContain(prefix))
+      ++false_positives;
+  }
+  EXPECT_LT(false_positives, absent / 10);
+}
+
 // Use artificial inputs to test various edge cases in PrefixExists().  Items
 // before the lowest item aren't present.  Items after the largest item aren't
 // present.  Create a sequence of items with deltas above and below 2^16, and
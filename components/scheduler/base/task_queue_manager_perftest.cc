@@ -87,6 +87,22 @@ class TaskQueueManagerPerfTest : public testing::Test {
     TestDelayedTask();
   }
 
+  void TestImmediateTask() {
+    if (--num_tasks_to_run_ == 0)
+      message_loop_->QuitWhenIdle();
+  }
+
+  // Posts the tasks round robin, so every queue has work and the selector has
+  // to pick the oldest task across all of them.
+  void PostImmediateTasks(unsigned int num_tasks_to_run) {
+    num_tasks_to_run_ = num_tasks_to_run;
+    for (unsigned int i = 0; i < num_tasks_to_run; i++) {
+      queues_[i % num_queues_]->PostTask(
+          FROM_HERE, base::Bind(&TaskQueueManagerPerfTest::TestImmediateTask,
+                                base::Unretained(this)));
+    }
+  }
+
   void Benchmark(const std::string& trace, const base::Closure& test_task) {
     base::ThreadTicks start = base::ThreadTicks::Now();
     base::ThreadTicks now;
@@ -157,6 +173,40 @@ TEST_F(TaskQueueManagerPerfTest, RunTenThousandDelayedTasks_ThirtyTwoQueues) {
                        base::Unretained(this), 10000));
 }
 
+// One queue per frame on a page with lots of iframes.
+TEST_F(TaskQueueManagerPerfTest,
+       RunTenThousandDelayedTasks_TwoHundredFiftySixQueues) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  Initialize(256u);
+
+  max_tasks_in_flight_ = 200;
+  Benchmark("run 10000 delayed tasks with 256 queues",
+            base::Bind(&TaskQueueManagerPerfTest::ResetAndCallTestDelayedTask,
+                       base::Unretained(this), 10000));
+}
+
+TEST_F(TaskQueueManagerPerfTest, RunTenThousandImmediateTasks_OneQueue) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  Initialize(1u);
+
+  Benchmark("run 10000 immediate tasks with one queue",
+            base::Bind(&TaskQueueManagerPerfTest::PostImmediateTasks,
+                       base::Unretained(this), 10000));
+}
+
+TEST_F(TaskQueueManagerPerfTest,
+       RunTenThousandImmediateTasks_TwoHundredFiftySixQueues) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  Initialize(256u);
+
+  Benchmark("run 10000 immediate tasks with 256 queues",
+            base::Bind(&TaskQueueManagerPerfTest::PostImmediateTasks,
+                       base::Unretained(this), 10000));
+}
+
 // TODO(alexclarke): Add additional tests with different mixes of non-delayed vs
 // delayed tasks.
 
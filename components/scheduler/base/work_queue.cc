@@ -13,6 +13,7 @@ WorkQueue::WorkQueue(TaskQueueImpl* task_queue, const char* name)
     : work_queue_sets_(nullptr),
       task_queue_(task_queue),
       work_queue_set_index_(0),
+      heap_index_(0),
       name_(name) {}
 
 void WorkQueue::AsValueInto(base::trace_event::TracedValue* state) const {
@@ -74,6 +74,12 @@ class SCHEDULER_EXPORT WorkQueue {
 
   size_t work_queue_set_index() const { return work_queue_set_index_; }
 
+  // Used by the WorkQueueSets to remember where this queue is in the heap for
+  // its set. Only meaningful while the queue is non-empty.
+  void AssignHeapIndex(size_t heap_index) { heap_index_ = heap_index; }
+
+  size_t heap_index() const { return heap_index_; }
+
   // Test support function. This should not be used in production code.
   void PopTaskForTest();
 
@@ -87,6 +93,7 @@ class SCHEDULER_EXPORT WorkQueue {
   WorkQueueSets* work_queue_sets_;  // NOT OWNED.
   TaskQueueImpl* task_queue_;       // NOT OWNED.
   size_t work_queue_set_index_;
+  size_t heap_index_;
   const char* name_;
 };
 
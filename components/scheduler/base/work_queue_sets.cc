@@ -11,21 +11,20 @@ namespace scheduler {
 namespace internal {
 
 WorkQueueSets::WorkQueueSets(size_t num_sets, const char* name)
-    : enqueue_order_to_work_queue_maps_(num_sets), name_(name) {}
+    : work_queue_heaps_(num_sets), name_(name) {}
 
 WorkQueueSets::~WorkQueueSets() {}
 
 void WorkQueueSets::AddQueue(WorkQueue* work_queue, size_t set_index) {
   DCHECK(!work_queue->work_queue_sets());
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size());
+  DCHECK_LT(set_index, work_queue_heaps_.size());
   EnqueueOrder enqueue_order;
   bool has_enqueue_order = work_queue->GetFrontTaskEnqueueOrder(&enqueue_order);
   work_queue->AssignToWorkQueueSets(this);
   work_queue->AssignSetIndex(set_index);
   if (!has_enqueue_order)
     return;
-  enqueue_order_to_work_queue_maps_[set_index].insert(
-      std::make_pair(enqueue_order, work_queue));
+  HeapInsert(set_index, enqueue_order, work_queue);
 }
 
 void WorkQueueSets::RemoveQueue(WorkQueue* work_queue) {
@@ -36,27 +35,23 @@ void WorkQueueSets::RemoveQueue(WorkQueue* work_queue) {
   if (!has_enqueue_order)
     return;
   size_t set_index = work_queue->work_queue_set_index();
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size());
-  DCHECK_EQ(
-      work_queue,
-      enqueue_order_to_work_queue_maps_[set_index].find(enqueue_order)->second);
-  enqueue_order_to_work_queue_maps_[set_index].erase(enqueue_order);
+  DCHECK_LT(set_index, work_queue_heaps_.size());
+  HeapErase(set_index, work_queue->heap_index());
 }
 
 void WorkQueueSets::ChangeSetIndex(WorkQueue* work_queue, size_t set_index) {
   DCHECK_EQ(this, work_queue->work_queue_sets());
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size());
+  DCHECK_LT(set_index, work_queue_heaps_.size());
   EnqueueOrder enqueue_order;
   bool has_enqueue_order = work_queue->GetFrontTaskEnqueueOrder(&enqueue_order);
   size_t old_set = work_queue->work_queue_set_index();
-  DCHECK_LT(old_set, enqueue_order_to_work_queue_maps_.size());
+  DCHECK_LT(old_set, work_queue_heaps_.size());
   DCHECK_NE(old_set, set_index);
   work_queue->AssignSetIndex(set_index);
   if (!has_enqueue_order)
     return;
-  enqueue_order_to_work_queue_maps_[old_set].erase(enqueue_order);
-  enqueue_order_to_work_queue_maps_[set_index].insert(
-      std::make_pair(enqueue_order, work_queue));
+  HeapErase(old_set, work_queue->heap_index());
+  HeapInsert(set_index, enqueue_order, work_queue);
 }
 
 void WorkQueueSets::OnPushQueue(WorkQueue* work_queue) {
@@ -67,52 +62,111 @@ void WorkQueueSets::OnPushQueue(WorkQueue* work_queue) {
   bool has_enqueue_order = work_queue->GetFrontTaskEnqueueOrder(&enqueue_order);
   DCHECK(has_enqueue_order);
   size_t set_index = work_queue->work_queue_set_index();
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size())
+  DCHECK_LT(set_index, work_queue_heaps_.size())
       << " set_index = " << set_index;
-  enqueue_order_to_work_queue_maps_[set_index].insert(
-      std::make_pair(enqueue_order, work_queue));
+  HeapInsert(set_index, enqueue_order, work_queue);
 }
 
 void WorkQueueSets::OnPopQueue(WorkQueue* work_queue) {
   size_t set_index = work_queue->work_queue_set_index();
   DCHECK_EQ(this, work_queue->work_queue_sets());
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size());
-  DCHECK(!enqueue_order_to_work_queue_maps_[set_index].empty())
+  DCHECK_LT(set_index, work_queue_heaps_.size());
+  WorkQueueHeap& heap = work_queue_heaps_[set_index];
+  DCHECK(!heap.empty()) << " set_index = " << set_index;
+  DCHECK_EQ(heap.front().work_queue, work_queue)
       << " set_index = " << set_index;
-  DCHECK_EQ(enqueue_order_to_work_queue_maps_[set_index].begin()->second,
-            work_queue)
-      << " set_index = " << set_index;
-  // O(1) amortised.
-  enqueue_order_to_work_queue_maps_[set_index].erase(
-      enqueue_order_to_work_queue_maps_[set_index].begin());
+  DCHECK_EQ(0u, work_queue->heap_index());
   EnqueueOrder enqueue_order;
   bool has_enqueue_order = work_queue->GetFrontTaskEnqueueOrder(&enqueue_order);
-  if (!has_enqueue_order)
+  if (!has_enqueue_order) {
+    HeapErase(set_index, 0);
     return;
-  enqueue_order_to_work_queue_maps_[set_index].insert(
-      std::make_pair(enqueue_order, work_queue));
+  }
+  // |work_queue| is at the top of the heap, so it can only move down.
+  heap.front().enqueue_order = enqueue_order;
+  HeapSiftDown(&heap, 0);
 }
 
 bool WorkQueueSets::GetOldestQueueInSet(size_t set_index,
                                         WorkQueue** out_work_queue) const {
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size());
-  if (enqueue_order_to_work_queue_maps_[set_index].empty())
+  DCHECK_LT(set_index, work_queue_heaps_.size());
+  if (work_queue_heaps_[set_index].empty())
     return false;
-  *out_work_queue =
-      enqueue_order_to_work_queue_maps_[set_index].begin()->second;
+  *out_work_queue = work_queue_heaps_[set_index].front().work_queue;
 #ifndef NDEBUG
   EnqueueOrder enqueue_order;
   DCHECK((*out_work_queue)->GetFrontTaskEnqueueOrder(&enqueue_order));
-  DCHECK_EQ(enqueue_order,
-            enqueue_order_to_work_queue_maps_[set_index].begin()->first);
+  DCHECK_EQ(enqueue_order, work_queue_heaps_[set_index].front().enqueue_order);
 #endif
   return true;
 }
 
 bool WorkQueueSets::IsSetEmpty(size_t set_index) const {
-  DCHECK_LT(set_index, enqueue_order_to_work_queue_maps_.size())
+  DCHECK_LT(set_index, work_queue_heaps_.size())
       << " set_index = " << set_index;
-  return enqueue_order_to_work_queue_maps_[set_index].empty();
+  return work_queue_heaps_[set_index].empty();
+}
+
+void WorkQueueSets::HeapInsert(size_t set_index,
+                               EnqueueOrder enqueue_order,
+                               WorkQueue* work_queue) {
+  WorkQueueHeap& heap = work_queue_heaps_[set_index];
+  heap.push_back({enqueue_order, work_queue});
+  HeapSiftUp(&heap, heap.size() - 1);
+}
+
+void WorkQueueSets::HeapErase(size_t set_index, size_t heap_index) {
+  WorkQueueHeap& heap = work_queue_heaps_[set_index];
+  DCHECK_LT(heap_index, heap.size());
+  OldestTaskEnqueueOrder last = heap.back();
+  heap.pop_back();
+  if (heap_index == heap.size())
+    return;
+  // Move the last element into the hole, then restore the heap property in
+  // whichever direction it's violated.
+  HeapMoveTo(&heap, heap_index, last);
+  HeapSiftUp(&heap, heap_index);
+  HeapSiftDown(&heap, last.work_queue->heap_index());
+}
+
+// static
+void WorkQueueSets::HeapSiftUp(WorkQueueHeap* heap, size_t heap_index) {
+  OldestTaskEnqueueOrder element = (*heap)[heap_index];
+  while (heap_index > 0) {
+    size_t parent = (heap_index - 1) / 2;
+    if ((*heap)[parent].enqueue_order < element.enqueue_order)
+      break;
+    HeapMoveTo(heap, heap_index, (*heap)[parent]);
+    heap_index = parent;
+  }
+  HeapMoveTo(heap, heap_index, element);
+}
+
+// static
+void WorkQueueSets::HeapSiftDown(WorkQueueHeap* heap, size_t heap_index) {
+  OldestTaskEnqueueOrder element = (*heap)[heap_index];
+  for (;;) {
+    size_t child = heap_index * 2 + 1;
+    if (child >= heap->size())
+      break;
+    if (child + 1 < heap->size() &&
+        (*heap)[child + 1].enqueue_order < (*heap)[child].enqueue_order) {
+      child++;
+    }
+    if (element.enqueue_order < (*heap)[child].enqueue_order)
+      break;
+    HeapMoveTo(heap, heap_index, (*heap)[child]);
+    heap_index = child;
+  }
+  HeapMoveTo(heap, heap_index, element);
+}
+
+// static
+void WorkQueueSets::HeapMoveTo(WorkQueueHeap* heap,
+                               size_t heap_index,
+                               const OldestTaskEnqueueOrder& element) {
+  (*heap)[heap_index] = element;
+  element.work_queue->AssignHeapIndex(heap_index);
 }
 
 #if DCHECK_IS_ON() || !defined(NDEBUG)
@@ -121,12 +175,11 @@ bool WorkQueueSets::ContainsWorkQueueForTest(
   EnqueueOrder enqueue_order;
   bool has_enqueue_order = work_queue->GetFrontTaskEnqueueOrder(&enqueue_order);
 
-  for (const EnqueueOrderToWorkQueueMap& map :
-       enqueue_order_to_work_queue_maps_) {
-    for (const EnqueueOrderToWorkQueueMap::value_type& key_value_pair : map) {
-      if (key_value_pair.second == work_queue) {
+  for (const WorkQueueHeap& heap : work_queue_heaps_) {
+    for (const OldestTaskEnqueueOrder& element : heap) {
+      if (element.work_queue == work_queue) {
         DCHECK(has_enqueue_order);
-        DCHECK_EQ(key_value_pair.first, enqueue_order);
+        DCHECK_EQ(element.enqueue_order, enqueue_order);
         DCHECK_EQ(this, work_queue->work_queue_sets());
         return true;
       }
@@ -7,7 +7,6 @@
 
 #include <stddef.h>
 
-#include <map>
 #include <vector>
 
 #include "base/logging.h"
@@ -37,7 +36,7 @@ class SCHEDULER_EXPORT WorkQueueSets {
   // O(log num queues)
   void OnPushQueue(WorkQueue* work_queue);
 
-  // If empty it's O(1) amortized, otherwise it's O(log num queues)
+  // O(log num queues)
   void OnPopQueue(WorkQueue* work_queue);
 
   // O(1)
@@ -47,7 +46,7 @@ class SCHEDULER_EXPORT WorkQueueSets {
   bool IsSetEmpty(size_t set_index) const;
 
 #if DCHECK_IS_ON() || !defined(NDEBUG)
-  // Note this iterates over everything in |enqueue_order_to_work_queue_maps_|.
+  // Note this iterates over everything in |work_queue_heaps_|.
   // It's intended for use with DCHECKS and for testing
   bool ContainsWorkQueueForTest(const WorkQueue* queue) const;
 #endif
@@ -55,8 +54,27 @@ class SCHEDULER_EXPORT WorkQueueSets {
   const char* name() const { return name_; }
 
  private:
-  typedef std::map<EnqueueOrder, WorkQueue*> EnqueueOrderToWorkQueueMap;
-  std::vector<EnqueueOrderToWorkQueueMap> enqueue_order_to_work_queue_maps_;
+  struct OldestTaskEnqueueOrder {
+    EnqueueOrder enqueue_order;
+    WorkQueue* work_queue;
+  };
+  typedef std::vector<OldestTaskEnqueueOrder> WorkQueueHeap;
+
+  void HeapInsert(size_t set_index,
+                  EnqueueOrder enqueue_order,
+                  WorkQueue* work_queue);
+  void HeapErase(size_t set_index, size_t heap_index);
+  static void HeapSiftUp(WorkQueueHeap* heap, size_t heap_index);
+  static void HeapSiftDown(WorkQueueHeap* heap, size_t heap_index);
+  static void HeapMoveTo(WorkQueueHeap* heap,
+                         size_t heap_index,
+                         const OldestTaskEnqueueOrder& element);
+
+  // A binary min-heap per set, keyed by the enqueue order of each non-empty
+  // work queue's front task. The work queues know their position in the heap
+  // (see WorkQueue::heap_index()), so none of the operations need to search
+  // and, once the vectors have grown, none of them allocate.
+  std::vector<WorkQueueHeap> work_queue_heaps_;
   const char* name_;
 
   DISALLOW_COPY_AND_ASSIGN(WorkQueueSets);
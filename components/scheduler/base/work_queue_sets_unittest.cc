@@ -255,5 +255,38 @@ TEST_F(WorkQueueSetsTest, IsSetEmpty_Work) {
   EXPECT_TRUE(work_queue_sets_->IsSetEmpty(set));
 }
 
+TEST_F(WorkQueueSetsTest, GetOldestQueueInSet_ManyQueues) {
+  // Enough queues for the heap to be several levels deep.
+  size_t set = 1;
+  std::vector<WorkQueue*> queues;
+  for (int i = 0; i < 100; i++) {
+    WorkQueue* queue = NewTaskQueue("queue");
+    // Interleave the enqueue orders so that the queues aren't inserted in
+    // order.
+    queue->Push(FakeTaskWithEnqueueOrder((i * 37) % 100 * 2));
+    queue->Push(FakeTaskWithEnqueueOrder((i * 37) % 100 * 2 + 201));
+    work_queue_sets_->ChangeSetIndex(queue, set);
+    queues.push_back(queue);
+  }
+
+  // Remove every third queue.
+  for (int i = 0; i < 100; i += 3)
+    work_queue_sets_->RemoveQueue(queues[i]);
+
+  EnqueueOrder last_enqueue_order = 0;
+  size_t tasks_run = 0;
+  WorkQueue* selected_work_queue;
+  while (work_queue_sets_->GetOldestQueueInSet(set, &selected_work_queue)) {
+    EnqueueOrder enqueue_order;
+    EXPECT_TRUE(selected_work_queue->GetFrontTaskEnqueueOrder(&enqueue_order));
+    EXPECT_LT(last_enqueue_order, enqueue_order);
+    last_enqueue_order = enqueue_order;
+    selected_work_queue->PopTaskForTest();
+    work_queue_sets_->OnPopQueue(selected_work_queue);
+    tasks_run++;
+  }
+  EXPECT_EQ(2u * 66u, tasks_run);
+}
+
 }  // namespace internal
 }  // namespace scheduler
@@ -93,6 +93,8 @@ RendererSchedulerImpl::~RendererSchedulerImpl() {
     timer_queue->RemoveTaskObserver(
         &MainThreadOnly().timer_task_cost_estimator);
   }
+  for (const auto& pair : MainThreadOnly().task_queue_cost_estimators)
+    pair.first->RemoveTaskObserver(pair.second.get());
 
   // Ensure the renderer scheduler was shut down explicitly, because otherwise
   // we could end up having stale pointers to the Blink heap which has been
@@ -206,6 +208,9 @@ scoped_refptr<TaskQueue> RendererSchedulerImpl::NewLoadingTaskRunner(
   }
   loading_task_queue->AddTaskObserver(
       &MainThreadOnly().loading_task_cost_estimator);
+  AddTaskQueueCostEstimator(loading_task_queue.get(),
+                            kLoadingTaskEstimationSampleCount,
+                            kLoadingTaskEstimationPercentile);
   return loading_task_queue;
 }
 
@@ -227,9 +232,23 @@ scoped_refptr<TaskQueue> RendererSchedulerImpl::NewTimerTaskRunner(
   }
   timer_task_queue->AddTaskObserver(
       &MainThreadOnly().timer_task_cost_estimator);
+  AddTaskQueueCostEstimator(timer_task_queue.get(),
+                            kTimerTaskEstimationSampleCount,
+                            kTimerTaskEstimationPercentile);
   return timer_task_queue;
 }
 
+void RendererSchedulerImpl::AddTaskQueueCostEstimator(
+    TaskQueue* task_queue,
+    int sample_count,
+    double estimation_percentile) {
+  std::unique_ptr<TaskCostEstimator>& estimator =
+      MainThreadOnly().task_queue_cost_estimators[task_queue];
+  estimator.reset(new TaskCostEstimator(helper_.scheduler_tqm_delegate().get(),
+                                        sample_count, estimation_percentile));
+  task_queue->AddTaskObserver(estimator.get());
+}
+
 std::unique_ptr<RenderWidgetSchedulingState>
 RendererSchedulerImpl::NewRenderWidgetSchedulingState() {
   return render_widget_scheduler_signals_.NewRenderWidgetSchedulingState();
@@ -249,6 +268,15 @@ void RendererSchedulerImpl::OnUnregisterTaskQueue(
     task_queue->RemoveTaskObserver(&MainThreadOnly().timer_task_cost_estimator);
     timer_task_runners_.erase(task_queue);
   }
+
+  auto it = MainThreadOnly().task_queue_cost_estimators.find(task_queue.get());
+  if (it != MainThreadOnly().task_queue_cost_estimators.end()) {
+    task_queue->RemoveTaskObserver(it->second.get());
+    MainThreadOnly().task_queue_cost_estimators.erase(it);
+  }
+  // A new queue could be allocated at the same address.
+  MainThreadOnly().current_policy.expensive_task_queues.erase(
+      task_queue.get());
 }
 
 bool RendererSchedulerImpl::CanExceedIdleDeadlineIfRequired() const {
@@ -703,6 +731,17 @@ void RendererSchedulerImpl::UpdatePolicyLocked(UpdateType update_type) {
   MainThreadOnly().timer_tasks_seem_expensive = timer_tasks_seem_expensive;
   MainThreadOnly().loading_tasks_seem_expensive = loading_tasks_seem_expensive;
 
+  // The expensive task policy below only applies to the queues whose own
+  // tasks are unlikely to finish before the next frame, so that one slow
+  // frame doesn't hold back the timers and loading tasks of the others.
+  std::set<TaskQueue*> expensive_task_queues;
+  for (const auto& pair : MainThreadOnly().task_queue_cost_estimators) {
+    if (pair.second->expected_task_duration() >
+        longest_jank_free_task_duration) {
+      expensive_task_queues.insert(pair.first);
+    }
+  }
+
   // The |new_policy_duration| is the minimum of |expected_use_case_duration|
   // and |touchstart_expected_flag_valid_for_duration| unless one is zero in
   // which case we choose the other.
@@ -806,6 +845,10 @@ void RendererSchedulerImpl::UpdatePolicyLocked(UpdateType update_type) {
       NOTREACHED();
   }
 
+  new_policy.expensive_loading_queue_policy = new_policy.loading_queue_policy;
+  new_policy.expensive_timer_queue_policy = new_policy.timer_queue_policy;
+  new_policy.expensive_task_queues.swap(expensive_task_queues);
+
   if (expensive_task_policy == ExpensiveTaskPolicy::BLOCK &&
       (!MainThreadOnly().expensive_task_blocking_allowed ||
        !MainThreadOnly().have_seen_a_begin_main_frame ||
@@ -818,21 +861,15 @@ void RendererSchedulerImpl::UpdatePolicyLocked(UpdateType update_type) {
       break;
 
     case ExpensiveTaskPolicy::BLOCK:
-      if (loading_tasks_seem_expensive)
-        new_policy.loading_queue_policy.is_enabled = false;
-      if (timer_tasks_seem_expensive)
-        new_policy.timer_queue_policy.is_enabled = false;
+      new_policy.expensive_loading_queue_policy.is_enabled = false;
+      new_policy.expensive_timer_queue_policy.is_enabled = false;
       break;
 
     case ExpensiveTaskPolicy::THROTTLE:
-      if (loading_tasks_seem_expensive) {
-        new_policy.loading_queue_policy.time_domain_type =
-            TimeDomainType::THROTTLED;
-      }
-      if (timer_tasks_seem_expensive) {
-        new_policy.timer_queue_policy.time_domain_type =
-            TimeDomainType::THROTTLED;
-      }
+      new_policy.expensive_loading_queue_policy.time_domain_type =
+          TimeDomainType::THROTTLED;
+      new_policy.expensive_timer_queue_policy.time_domain_type =
+          TimeDomainType::THROTTLED;
       break;
   }
 
@@ -842,10 +879,13 @@ void RendererSchedulerImpl::UpdatePolicyLocked(UpdateType update_type) {
       MainThreadOnly().timer_queue_suspended_when_backgrounded) {
     new_policy.timer_queue_policy.is_enabled = false;
     new_policy.timer_queue_policy.time_domain_type = TimeDomainType::REAL;
+    new_policy.expensive_timer_queue_policy =
+        new_policy.timer_queue_policy;
   }
 
   if (MainThreadOnly().renderer_suspended) {
     new_policy.loading_queue_policy.is_enabled = false;
+    new_policy.expensive_loading_queue_policy.is_enabled = false;
     DCHECK(!new_policy.timer_queue_policy.is_enabled);
   }
 
@@ -879,15 +919,18 @@ void RendererSchedulerImpl::UpdatePolicyLocked(UpdateType update_type) {
                        new_policy.compositor_queue_policy);
 
   for (const scoped_refptr<TaskQueue>& loading_queue : loading_task_runners_) {
-    ApplyTaskQueuePolicy(loading_queue.get(),
-                         MainThreadOnly().current_policy.loading_queue_policy,
-                         new_policy.loading_queue_policy);
+    ApplyTaskQueuePolicy(
+        loading_queue.get(),
+        MainThreadOnly().current_policy.GetLoadingQueuePolicy(
+            loading_queue.get()),
+        new_policy.GetLoadingQueuePolicy(loading_queue.get()));
   }
 
   for (const scoped_refptr<TaskQueue>& timer_queue : timer_task_runners_) {
-    ApplyTaskQueuePolicy(timer_queue.get(),
-                         MainThreadOnly().current_policy.timer_queue_policy,
-                         new_policy.timer_queue_policy);
+    ApplyTaskQueuePolicy(
+        timer_queue.get(),
+        MainThreadOnly().current_policy.GetTimerQueuePolicy(timer_queue.get()),
+        new_policy.GetTimerQueuePolicy(timer_queue.get()));
   }
   MainThreadOnly().have_reported_blocking_intervention_in_current_policy =
       false;
@@ -1100,6 +1143,10 @@ RendererSchedulerImpl::AsValueLocked(base::TimeTicks optional_now) const {
                     MainThreadOnly().loading_tasks_seem_expensive);
   state->SetBoolean("timer_tasks_seem_expensive",
                     MainThreadOnly().timer_tasks_seem_expensive);
+  state->SetInteger(
+      "expensive_task_queue_count",
+      static_cast<int>(
+          MainThreadOnly().current_policy.expensive_task_queues.size()));
   state->SetBoolean("begin_frame_not_expected_soon",
                     MainThreadOnly().begin_frame_not_expected_soon);
   state->SetBoolean("touchstart_expected_soon",
@@ -1251,6 +1298,8 @@ void RendererSchedulerImpl::ResetForNavigationLocked() {
   AnyThread().have_seen_touchstart = false;
   MainThreadOnly().loading_task_cost_estimator.Clear();
   MainThreadOnly().timer_task_cost_estimator.Clear();
+  for (const auto& pair : MainThreadOnly().task_queue_cost_estimators)
+    pair.second->Clear();
   MainThreadOnly().idle_time_estimator.Clear();
   MainThreadOnly().have_seen_a_begin_main_frame = false;
   MainThreadOnly().have_reported_blocking_intervention_since_navigation = false;
@@ -1319,10 +1368,8 @@ void RendererSchedulerImpl::OnTriedToExecuteBlockedTask(
       MainThreadOnly().timer_queue_suspended_when_backgrounded) {
     return;
   }
-  if (!MainThreadOnly().timer_tasks_seem_expensive &&
-      !MainThreadOnly().loading_tasks_seem_expensive) {
+  if (MainThreadOnly().current_policy.expensive_task_queues.empty())
     return;
-  }
   if (!MainThreadOnly().have_reported_blocking_intervention_in_current_policy) {
     MainThreadOnly().have_reported_blocking_intervention_in_current_policy =
         true;
@@ -5,6 +5,10 @@
 #ifndef COMPONENTS_SCHEDULER_RENDERER_RENDERER_SCHEDULER_IMPL_H_
 #define COMPONENTS_SCHEDULER_RENDERER_RENDERER_SCHEDULER_IMPL_H_
 
+#include <map>
+#include <memory>
+#include <set>
+
 #include "base/atomicops.h"
 #include "base/macros.h"
 #include "base/synchronization/lock.h"
@@ -156,11 +160,35 @@ class SCHEDULER_EXPORT RendererSchedulerImpl
     TaskQueuePolicy timer_queue_policy;
     TaskQueuePolicy default_queue_policy;
 
+    // The policies for the loading and timer queues in
+    // |expensive_task_queues|, i.e. the ones whose own tasks are expected to
+    // take longer than the time left before the next frame.
+    TaskQueuePolicy expensive_loading_queue_policy;
+    TaskQueuePolicy expensive_timer_queue_policy;
+    std::set<TaskQueue*> expensive_task_queues;
+
+    const TaskQueuePolicy& GetLoadingQueuePolicy(TaskQueue* task_queue) const {
+      return expensive_task_queues.count(task_queue)
+                 ? expensive_loading_queue_policy
+                 : loading_queue_policy;
+    }
+
+    const TaskQueuePolicy& GetTimerQueuePolicy(TaskQueue* task_queue) const {
+      return expensive_task_queues.count(task_queue)
+                 ? expensive_timer_queue_policy
+                 : timer_queue_policy;
+    }
+
     bool operator==(const Policy& other) const {
       return compositor_queue_policy == other.compositor_queue_policy &&
              loading_queue_policy == other.loading_queue_policy &&
              timer_queue_policy == other.timer_queue_policy &&
-             default_queue_policy == other.default_queue_policy;
+             default_queue_policy == other.default_queue_policy &&
+             expensive_loading_queue_policy ==
+                 other.expensive_loading_queue_policy &&
+             expensive_timer_queue_policy ==
+                 other.expensive_timer_queue_policy &&
+             expensive_task_queues == other.expensive_task_queues;
     }
   };
 
@@ -288,6 +316,11 @@ class SCHEDULER_EXPORT RendererSchedulerImpl
   // Log a console warning message to all WebViews in this process.
   void BroadcastConsoleWarning(const std::string& message);
 
+  // Starts estimating the cost of the tasks run by |task_queue| on its own.
+  void AddTaskQueueCostEstimator(TaskQueue* task_queue,
+                                 int sample_count,
+                                 double estimation_percentile);
+
   void ApplyTaskQueuePolicy(TaskQueue* task_queue,
                             const TaskQueuePolicy& old_task_queue_policy,
                             const TaskQueuePolicy& new_task_queue_policy) const;
@@ -322,6 +355,10 @@ class SCHEDULER_EXPORT RendererSchedulerImpl
 
     TaskCostEstimator loading_task_cost_estimator;
     TaskCostEstimator timer_task_cost_estimator;
+    // Per-queue estimates for the loading and timer queues, so that only the
+    // queues which actually run expensive tasks get blocked or throttled.
+    std::map<TaskQueue*, std::unique_ptr<TaskCostEstimator>>
+        task_queue_cost_estimators;
     IdleTimeEstimator idle_time_estimator;
     UseCase current_use_case;
     Policy current_policy;
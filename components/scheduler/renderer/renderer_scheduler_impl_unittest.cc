@@ -2336,6 +2336,29 @@ TEST_F(RendererSchedulerImplTest,
   EXPECT_THAT(run_order, testing::ElementsAre(std::string("D1")));
 }
 
+TEST_F(RendererSchedulerImplTest,
+       ExpensiveTimerTaskBlocked_OnlyOnTheExpensiveQueue) {
+  std::vector<std::string> run_order;
+  scoped_refptr<TaskQueue> other_timer_task_runner =
+      scheduler_->NewTimerTaskRunner("other_timer_tq");
+
+  scheduler_->SetHasVisibleRenderWidgetWithTouchHandler(true);
+  DoMainFrame();
+  SimulateExpensiveTasks(timer_task_runner_);
+  ForceTouchStartToBeExpectedSoon();
+
+  PostTestTasks(&run_order, "T1 D1");
+  other_timer_task_runner->PostTask(
+      FROM_HERE, base::Bind(&AppendToVectorTestTask, &run_order, "O1"));
+  RunUntilIdle();
+
+  EXPECT_EQ(UseCase::NONE, ForceUpdatePolicyAndGetCurrentUseCase());
+  EXPECT_TRUE(TimerTasksSeemExpensive());
+  EXPECT_THAT(run_order,
+              testing::ElementsAre(std::string("D1"), std::string("O1")));
+  other_timer_task_runner->UnregisterTaskQueue();
+}
+
 TEST_F(RendererSchedulerImplTest,
        ExpensiveTimerTaskNotBlocked_UseCase_NONE_PreviousMainThreadGesture) {
   std::vector<std::string> run_order;
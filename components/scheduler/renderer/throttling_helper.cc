@@ -4,7 +4,10 @@
 
 #include "components/scheduler/renderer/throttling_helper.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
 #include "components/scheduler/base/real_time_domain.h"
 #include "components/scheduler/child/scheduler_tqm_delegate.h"
 #include "components/scheduler/renderer/renderer_scheduler_impl.h"
@@ -14,6 +17,73 @@
 
 namespace scheduler {
 
+namespace {
+
+// Background pages get about 1% of the CPU for their throttled queues.
+const double kTimeBudgetRecoveryRate = 0.01;
+// Keeps a page that was idle for a long time from then running expensive
+// tasks for as long.
+const int kMaxTimeBudgetMilliseconds = 100;
+
+}  // namespace
+
+class ThrottlingHelper::TimeBudget : public base::MessageLoop::TaskObserver {
+ public:
+  TimeBudget(ThrottlingHelper* throttling_helper,
+             TaskQueue* task_queue,
+             base::TimeTicks now)
+      : throttling_helper_(throttling_helper),
+        task_queue_(task_queue),
+        last_update_time_(now) {
+    task_queue_->AddTaskObserver(this);
+  }
+
+  ~TimeBudget() override { task_queue_->RemoveTaskObserver(this); }
+
+  // Recovers the budget for the time elapsed since the last update.
+  void Update(base::TimeTicks now) {
+    budget_ = std::min(
+        base::TimeDelta::FromMilliseconds(kMaxTimeBudgetMilliseconds),
+        budget_ + base::TimeDelta::FromSecondsD(
+                      (now - last_update_time_).InSecondsF() *
+                      kTimeBudgetRecoveryRate));
+    last_update_time_ = now;
+  }
+
+  void Charge(base::TimeDelta task_run_time) { budget_ -= task_run_time; }
+
+  bool IsExhausted() const { return budget_ < base::TimeDelta(); }
+
+  // The time at which the budget will have recovered to zero.
+  base::TimeTicks RecoveryTime() const {
+    if (!IsExhausted())
+      return last_update_time_;
+    return last_update_time_ + base::TimeDelta::FromSecondsD(
+                                   -budget_.InSecondsF() /
+                                   kTimeBudgetRecoveryRate);
+  }
+
+  // TaskObserver implementation:
+  void WillProcessTask(const base::PendingTask& pending_task) override {
+    task_start_time_ = throttling_helper_->tick_clock_->NowTicks();
+  }
+
+  void DidProcessTask(const base::PendingTask& pending_task) override {
+    throttling_helper_->OnTaskRunTimeReported(
+        task_queue_, task_start_time_,
+        throttling_helper_->tick_clock_->NowTicks());
+  }
+
+ private:
+  ThrottlingHelper* throttling_helper_;  // NOT OWNED
+  TaskQueue* task_queue_;                // NOT OWNED
+  base::TimeDelta budget_;
+  base::TimeTicks last_update_time_;
+  base::TimeTicks task_start_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimeBudget);
+};
+
 ThrottlingHelper::ThrottlingHelper(RendererSchedulerImpl* renderer_scheduler,
                                    const char* tracing_category)
     : task_runner_(renderer_scheduler->ControlTaskRunner()),
@@ -39,6 +109,7 @@ ThrottlingHelper::~ThrottlingHelper() {
     task_queue->SetTimeDomain(renderer_scheduler_->real_time_domain());
     task_queue->SetPumpPolicy(TaskQueue::PumpPolicy::AUTO);
   }
+  time_budgets_.clear();
 
   renderer_scheduler_->UnregisterTimeDomain(time_domain_.get());
 }
@@ -103,6 +174,55 @@ void ThrottlingHelper::DecreaseThrottleRefCount(TaskQueue* task_queue) {
 
 void ThrottlingHelper::UnregisterTaskQueue(TaskQueue* task_queue) {
   throttled_queues_.erase(task_queue);
+  time_budgets_.erase(task_queue);
+}
+
+void ThrottlingHelper::EnableTimeBudget(TaskQueue* task_queue) {
+  DCHECK_NE(task_queue, task_runner_.get());
+  if (time_budgets_.find(task_queue) != time_budgets_.end())
+    return;
+  time_budgets_.insert(std::make_pair(
+      task_queue, base::WrapUnique(new TimeBudget(this, task_queue,
+                                                  tick_clock_->NowTicks()))));
+}
+
+void ThrottlingHelper::DisableTimeBudget(TaskQueue* task_queue) {
+  TimeBudgetMap::iterator find_it = time_budgets_.find(task_queue);
+  if (find_it == time_budgets_.end())
+    return;
+  bool was_exhausted = find_it->second->IsExhausted();
+  time_budgets_.erase(find_it);
+
+  // A throttled queue blocked on its budget would otherwise wait for a pump
+  // scheduled for when the budget recovers.
+  if (was_exhausted &&
+      throttled_queues_.find(task_queue) != throttled_queues_.end() &&
+      !task_queue->IsEmpty()) {
+    base::TimeTicks now = tick_clock_->NowTicks();
+    MaybeSchedulePumpThrottledTasksLocked(FROM_HERE, now, now);
+  }
+}
+
+void ThrottlingHelper::OnTaskRunTimeReported(TaskQueue* task_queue,
+                                             base::TimeTicks start_time,
+                                             base::TimeTicks end_time) {
+  // Tasks only count against the budget while the queue is throttled.
+  if (throttled_queues_.find(task_queue) == throttled_queues_.end())
+    return;
+  TimeBudgetMap::iterator find_it = time_budgets_.find(task_queue);
+  DCHECK(find_it != time_budgets_.end());
+  TimeBudget* time_budget = find_it->second.get();
+  time_budget->Update(end_time);
+  time_budget->Charge(end_time - start_time);
+  if (!time_budget->IsExhausted())
+    return;
+
+  TRACE_EVENT0(tracing_category_, "ThrottlingHelper::TimeBudgetExhausted");
+  // Block the tasks that were already pumped too.  PumpThrottledTasks
+  // re-enables the queue once the budget has recovered.
+  task_queue->SetQueueEnabled(false);
+  MaybeSchedulePumpThrottledTasksLocked(FROM_HERE, end_time,
+                                        time_budget->RecoveryTime());
 }
 
 void ThrottlingHelper::OnTimeDomainHasImmediateWork() {
@@ -140,6 +260,18 @@ void ThrottlingHelper::PumpThrottledTasks() {
     if (task_queue->IsEmpty())
       continue;
 
+    TimeBudgetMap::iterator budget_it = time_budgets_.find(task_queue);
+    if (budget_it != time_budgets_.end()) {
+      TimeBudget* time_budget = budget_it->second.get();
+      time_budget->Update(now);
+      if (time_budget->IsExhausted()) {
+        // Leave the queue blocked until the budget has recovered.
+        MaybeSchedulePumpThrottledTasksLocked(FROM_HERE, now,
+                                              time_budget->RecoveryTime());
+        continue;
+      }
+    }
+
     task_queue->SetQueueEnabled(map_entry.second.enabled);
     task_queue->PumpQueue(false);
   }
@@ -5,6 +5,8 @@
 #ifndef COMPONENTS_SCHEDULER_RENDERER_THROTTLING_HELPER_H_
 #define COMPONENTS_SCHEDULER_RENDERER_THROTTLING_HELPER_H_
 
+#include <map>
+#include <memory>
 #include <set>
 
 #include "base/macros.h"
@@ -47,9 +49,21 @@ class SCHEDULER_EXPORT ThrottlingHelper : public TimeDomain::Observer {
   // zero this function does nothing.
   void DecreaseThrottleRefCount(TaskQueue* task_queue);
 
-  // Removes |task_queue| from |throttled_queues_|.
+  // Removes |task_queue| from |throttled_queues_| and drops its time budget.
   void UnregisterTaskQueue(TaskQueue* task_queue);
 
+  // Gives |task_queue| a CPU time budget, which is enforced while the queue is
+  // throttled.  The time taken by the queue's tasks is charged to the budget,
+  // which recovers at 1% of wall time, up to 100ms.  Once the budget is
+  // negative, the queue is blocked until the budget has recovered, so a
+  // background page running expensive timers gets about 1% of the CPU instead
+  // of running them once a second however long they take.
+  void EnableTimeBudget(TaskQueue* task_queue);
+
+  // Drops the time budget of |task_queue|, unblocking it if the budget was
+  // exhausted.
+  void DisableTimeBudget(TaskQueue* task_queue);
+
   const ThrottledTimeDomain* time_domain() const { return time_domain_.get(); }
 
   static base::TimeTicks ThrottledRunTime(base::TimeTicks unthrottled_runtime);
@@ -68,8 +82,17 @@ class SCHEDULER_EXPORT ThrottlingHelper : public TimeDomain::Observer {
   };
   using TaskQueueMap = std::map<TaskQueue*, Metadata>;
 
+  class TimeBudget;
+  using TimeBudgetMap = std::map<TaskQueue*, std::unique_ptr<TimeBudget>>;
+
   void PumpThrottledTasks();
 
+  // Charges the time a task of |task_queue| took to the queue's time budget,
+  // and blocks the queue if that exhausts it.
+  void OnTaskRunTimeReported(TaskQueue* task_queue,
+                             base::TimeTicks start_time,
+                             base::TimeTicks end_time);
+
   // Note |unthrottled_runtime| might be in the past. When this happens we
   // compute the delay to the next runtime based on now rather than
   // unthrottled_runtime.
@@ -79,6 +102,7 @@ class SCHEDULER_EXPORT ThrottlingHelper : public TimeDomain::Observer {
       base::TimeTicks unthrottled_runtime);
 
   TaskQueueMap throttled_queues_;
+  TimeBudgetMap time_budgets_;
   base::Closure forward_immediate_work_closure_;
   scoped_refptr<TaskQueue> task_runner_;
   RendererSchedulerImpl* renderer_scheduler_;  // NOT OWNED
@@ -428,4 +428,77 @@ TEST_F(ThrottlingHelperTest, TaskQueueDisabledTillPump_ThenManuallyDisabled) {
   EXPECT_FALSE(timer_queue_->IsQueueEnabled());
 }
 
+namespace {
+void ExpensiveTestTask(std::vector<base::TimeTicks>* run_times,
+                       base::SimpleTestTickClock* clock) {
+  run_times->push_back(clock->NowTicks());
+  clock->Advance(base::TimeDelta::FromMilliseconds(250));
+}
+}  // namespace
+
+TEST_F(ThrottlingHelperTest, TimeBudget) {
+  std::vector<base::TimeTicks> run_times;
+
+  throttling_helper_->IncreaseThrottleRefCount(timer_queue_.get());
+  throttling_helper_->EnableTimeBudget(timer_queue_.get());
+
+  for (int i = 0; i < 3; ++i) {
+    timer_queue_->PostTask(
+        FROM_HERE, base::Bind(&ExpensiveTestTask, &run_times, clock_.get()));
+  }
+
+  mock_task_runner_->RunUntilIdle();
+
+  // Each task overspends the budget by about 240ms, which takes 24 seconds to
+  // recover at 1%.
+  EXPECT_THAT(run_times,
+              ElementsAre(base::TimeTicks() + base::TimeDelta::FromSeconds(1),
+                          base::TimeTicks() + base::TimeDelta::FromSeconds(26),
+                          base::TimeTicks() + base::TimeDelta::FromSeconds(51)));
+}
+
+TEST_F(ThrottlingHelperTest, TimeBudget_Unthrottled) {
+  std::vector<base::TimeTicks> run_times;
+  base::TimeTicks start_time = clock_->NowTicks();
+
+  throttling_helper_->EnableTimeBudget(timer_queue_.get());
+
+  timer_queue_->PostTask(
+      FROM_HERE, base::Bind(&ExpensiveTestTask, &run_times, clock_.get()));
+  timer_queue_->PostTask(
+      FROM_HERE, base::Bind(&ExpensiveTestTask, &run_times, clock_.get()));
+
+  mock_task_runner_->RunUntilIdle();
+
+  // The budget only applies while the queue is throttled.
+  EXPECT_THAT(run_times,
+              ElementsAre(start_time,
+                          start_time + base::TimeDelta::FromMilliseconds(250)));
+}
+
+TEST_F(ThrottlingHelperTest, DisableTimeBudget_UnblocksQueue) {
+  std::vector<base::TimeTicks> run_times;
+
+  throttling_helper_->IncreaseThrottleRefCount(timer_queue_.get());
+  throttling_helper_->EnableTimeBudget(timer_queue_.get());
+
+  timer_queue_->PostTask(
+      FROM_HERE, base::Bind(&ExpensiveTestTask, &run_times, clock_.get()));
+  timer_queue_->PostTask(
+      FROM_HERE, base::Bind(&ExpensiveTestTask, &run_times, clock_.get()));
+
+  mock_task_runner_->RunForPeriod(base::TimeDelta::FromSeconds(2));
+  EXPECT_THAT(run_times, ElementsAre(base::TimeTicks() +
+                                     base::TimeDelta::FromSeconds(1)));
+
+  throttling_helper_->DisableTimeBudget(timer_queue_.get());
+  mock_task_runner_->RunUntilIdle();
+
+  // The second task runs at the next aligned time rather than when the budget
+  // would have recovered.
+  EXPECT_THAT(run_times,
+              ElementsAre(base::TimeTicks() + base::TimeDelta::FromSeconds(1),
+                          base::TimeTicks() + base::TimeDelta::FromSeconds(2)));
+}
+
 }  // namespace scheduler
@@ -77,6 +77,8 @@ blink::WebTaskRunner* WebFrameSchedulerImpl::timerTaskRunner() {
     } else if (!page_visible_) {
       renderer_scheduler_->throttling_helper()->IncreaseThrottleRefCount(
           timer_task_queue_.get());
+      renderer_scheduler_->throttling_helper()->EnableTimeBudget(
+          timer_task_queue_.get());
     }
     timer_web_task_runner_.reset(new WebTaskRunnerImpl(timer_task_queue_));
   }
@@ -96,11 +98,15 @@ void WebFrameSchedulerImpl::setPageVisible(bool page_visible) {
   }
 
   if (page_visible_) {
+    renderer_scheduler_->throttling_helper()->DisableTimeBudget(
+        timer_task_queue_.get());
     renderer_scheduler_->throttling_helper()->DecreaseThrottleRefCount(
         timer_task_queue_.get());
   } else {
     renderer_scheduler_->throttling_helper()->IncreaseThrottleRefCount(
         timer_task_queue_.get());
+    renderer_scheduler_->throttling_helper()->EnableTimeBudget(
+        timer_task_queue_.get());
   }
 }
 
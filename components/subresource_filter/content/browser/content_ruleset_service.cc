@@ -0,0 +1,190 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/content/browser/content_ruleset_service.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
+#include "components/subresource_filter/content/common/subresource_filter_messages.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/browser/render_process_host.h"
+#include "ipc/ipc_platform_file.h"
+
+namespace subresource_filter {
+
+namespace {
+
+// Returns the versions of the indexed ruleset stored in |dir|, newest first.
+// Each version is stored in a file named after its version number.
+std::vector<std::pair<int64_t, base::FilePath>> GetStoredRulesets(
+    const base::FilePath& dir) {
+  std::vector<std::pair<int64_t, base::FilePath>> rulesets;
+  base::FileEnumerator enumerator(dir, false /* recursive */,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    int64_t version;
+    if (base::StringToInt64(path.BaseName().MaybeAsASCII(), &version))
+      rulesets.push_back(std::make_pair(version, path));
+  }
+  std::sort(rulesets.rbegin(), rulesets.rend());
+  return rulesets;
+}
+
+// Deletes the versions of the ruleset other than |current_path|. Fails for
+// those that are still open on some platforms, which are deleted next time.
+void DeleteObsoleteRulesets(const base::FilePath& dir,
+                            const base::FilePath& current_path) {
+  for (const auto& version_and_path : GetStoredRulesets(dir)) {
+    if (version_and_path.second != current_path)
+      base::DeleteFile(version_and_path.second, false /* recursive */);
+  }
+}
+
+base::File OpenStoredRuleset(const base::FilePath& dir) {
+  for (const auto& version_and_path : GetStoredRulesets(dir)) {
+    base::File file(version_and_path.second,
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (file.IsValid() &&
+        MemoryMappedRuleset::CreateAndInitialize(file.Duplicate())) {
+      DeleteObsoleteRulesets(dir, version_and_path.second);
+      return file;
+    }
+  }
+  return base::File();
+}
+
+base::File IndexAndWriteRuleset(const base::FilePath& filter_list_path,
+                                const base::FilePath& dir) {
+  std::string filter_list;
+  if (!base::ReadFileToString(filter_list_path, &filter_list))
+    return base::File();
+
+  RulesetIndexer indexer;
+  indexer.AddUrlRules(filter_list);
+  indexer.Finish();
+
+  if (!base::CreateDirectory(dir))
+    return base::File();
+  std::vector<std::pair<int64_t, base::FilePath>> stored_rulesets =
+      GetStoredRulesets(dir);
+  int64_t version =
+      stored_rulesets.empty() ? 1 : stored_rulesets.front().first + 1;
+  base::FilePath path = dir.AppendASCII(base::Int64ToString(version));
+
+  int size = base::checked_cast<int>(indexer.size());
+  if (base::WriteFile(path, reinterpret_cast<const char*>(indexer.data()),
+                      size) != size) {
+    base::DeleteFile(path, false /* recursive */);
+    return base::File();
+  }
+
+  DeleteObsoleteRulesets(dir, path);
+  return base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+}
+
+void CloseFile(base::File file) {
+  file.Close();
+}
+
+}  // namespace
+
+ContentRulesetService::ContentRulesetService(
+    const base::FilePath& indexed_ruleset_dir,
+    scoped_refptr<base::SequencedTaskRunner> blocking_task_runner)
+    : indexed_ruleset_dir_(indexed_ruleset_dir),
+      blocking_task_runner_(std::move(blocking_task_runner)),
+      weak_ptr_factory_(this) {
+  registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CREATED,
+                 content::NotificationService::AllBrowserContextsAndSources());
+}
+
+ContentRulesetService::~ContentRulesetService() {
+  if (ruleset_file_.IsValid()) {
+    blocking_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&CloseFile, base::Passed(&ruleset_file_)));
+  }
+}
+
+void ContentRulesetService::LoadStoredRuleset() {
+  base::PostTaskAndReplyWithResult(
+      blocking_task_runner_.get(), FROM_HERE,
+      base::Bind(&OpenStoredRuleset, indexed_ruleset_dir_),
+      base::Bind(&ContentRulesetService::PublishRuleset,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+void ContentRulesetService::IndexAndStoreRuleset(
+    const base::FilePath& filter_list_path) {
+  base::PostTaskAndReplyWithResult(
+      blocking_task_runner_.get(), FROM_HERE,
+      base::Bind(&IndexAndWriteRuleset, filter_list_path,
+                 indexed_ruleset_dir_),
+      base::Bind(&ContentRulesetService::PublishRuleset,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+void ContentRulesetService::SetRulesetPublishedCallbackForTesting(
+    const base::Closure& callback) {
+  ruleset_published_callback_ = callback;
+}
+
+void ContentRulesetService::PublishRuleset(base::File ruleset_file) {
+  if (!ruleset_file.IsValid())
+    return;
+
+  // Closing a file may block, so it is not done on this thread.
+  if (ruleset_file_.IsValid()) {
+    blocking_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&CloseFile, base::Passed(&ruleset_file_)));
+  }
+  ruleset_file_ = std::move(ruleset_file);
+
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    SendRulesetToRenderProcess(it.GetCurrentValue());
+  }
+
+  if (!ruleset_published_callback_.is_null())
+    ruleset_published_callback_.Run();
+}
+
+void ContentRulesetService::SendRulesetToRenderProcess(
+    content::RenderProcessHost* process) {
+  DCHECK(ruleset_file_.IsValid());
+  process->Send(new SubresourceFilterMsg_SetRulesetForProcess(
+      IPC::GetPlatformFileForTransit(ruleset_file_.GetPlatformFile(),
+                                     false /* close_source_handle */)));
+}
+
+void ContentRulesetService::Observe(
+    int type,
+    const content::NotificationSource& source,
+    const content::NotificationDetails& details) {
+  DCHECK_EQ(content::NOTIFICATION_RENDERER_PROCESS_CREATED, type);
+  if (ruleset_file_.IsValid()) {
+    SendRulesetToRenderProcess(
+        content::Source<content::RenderProcessHost>(source).ptr());
+  }
+}
+
+}  // namespace subresource_filter
@@ -0,0 +1,79 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SUBRESOURCE_FILTER_CONTENT_BROWSER_CONTENT_RULESET_SERVICE_H_
+#define COMPONENTS_SUBRESOURCE_FILTER_CONTENT_BROWSER_CONTENT_RULESET_SERVICE_H_
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace content {
+class RenderProcessHost;
+}  // namespace content
+
+namespace subresource_filter {
+
+// Indexes filter lists into the ruleset format that renderers match subresource
+// loads against, stores the indexed ruleset on disk, and sends a read-only file
+// handle to it to every renderer process, existing and future ones. Renderers
+// memory-map the file, so the ruleset is indexed once and shared by all of
+// them, without being copied into any of them.
+//
+// Each version of the indexed ruleset is written to a new file in
+// |indexed_ruleset_dir|, as the previous one may still be mapped by renderers.
+class ContentRulesetService : public content::NotificationObserver {
+ public:
+  // All file operations are done on |blocking_task_runner|.
+  ContentRulesetService(
+      const base::FilePath& indexed_ruleset_dir,
+      scoped_refptr<base::SequencedTaskRunner> blocking_task_runner);
+  ~ContentRulesetService() override;
+
+  // Publishes the most recent well-formed indexed ruleset stored by a previous
+  // session, if there is one. Should be called once, on start-up.
+  void LoadStoredRuleset();
+
+  // Indexes the filter list at |filter_list_path|, stores the result as the new
+  // version of the indexed ruleset, and publishes it.
+  void IndexAndStoreRuleset(const base::FilePath& filter_list_path);
+
+  // Runs |callback| whenever a new version of the ruleset has been published.
+  void SetRulesetPublishedCallbackForTesting(const base::Closure& callback);
+
+ private:
+  void PublishRuleset(base::File ruleset_file);
+  void SendRulesetToRenderProcess(content::RenderProcessHost* process);
+
+  // content::NotificationObserver:
+  void Observe(int type,
+               const content::NotificationSource& source,
+               const content::NotificationDetails& details) override;
+
+  const base::FilePath indexed_ruleset_dir_;
+  scoped_refptr<base::SequencedTaskRunner> blocking_task_runner_;
+
+  // The most recently published version of the indexed ruleset.
+  base::File ruleset_file_;
+
+  content::NotificationRegistrar registrar_;
+  base::Closure ruleset_published_callback_;
+
+  base::WeakPtrFactory<ContentRulesetService> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentRulesetService);
+};
+
+}  // namespace subresource_filter
+
+#endif  // COMPONENTS_SUBRESOURCE_FILTER_CONTENT_BROWSER_CONTENT_RULESET_SERVICE_H_
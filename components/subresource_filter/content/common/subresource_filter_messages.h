@@ -8,6 +8,7 @@
 #include "content/public/common/common_param_traits_macros.h"
 #include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message.h"
+#include "ipc/ipc_platform_file.h"
 
 #define IPC_MESSAGE_START SubresourceFilterMsgStart
 
@@ -18,6 +19,13 @@ IPC_ENUM_TRAITS_MAX_VALUE(subresource_filter::ActivationState,
 // Messages sent from the browser to the renderer.
 // ----------------------------------------------------------------------------
 
+// Sends a read-only file handle to the indexed ruleset to all renderers, on
+// start-up and whenever a new version of the ruleset is published. Renderers
+// memory-map the file when they first need to match subresource loads, so the
+// pages of the ruleset are shared by all of them.
+IPC_MESSAGE_CONTROL1(SubresourceFilterMsg_SetRulesetForProcess,
+                     IPC::PlatformFileForTransit /* ruleset_file */);
+
 // Instructs the renderer to activate subresource filtering for the currently
 // ongoing provisional document load in a frame. The message must arrive after
 // the provisional load starts, but before it is committed on the renderer side.
@@ -0,0 +1,84 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/content/renderer/document_subresource_filter.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+#include "third_party/WebKit/public/platform/WebURL.h"
+#include "url/gurl.h"
+
+namespace subresource_filter {
+
+namespace {
+
+ElementType ToElementType(blink::WebURLRequest::RequestContext request_context) {
+  switch (request_context) {
+    case blink::WebURLRequest::RequestContextAudio:
+    case blink::WebURLRequest::RequestContextVideo:
+    case blink::WebURLRequest::RequestContextTrack:
+      return ELEMENT_TYPE_MEDIA;
+    case blink::WebURLRequest::RequestContextBeacon:
+    case blink::WebURLRequest::RequestContextPing:
+      return ELEMENT_TYPE_PING;
+    case blink::WebURLRequest::RequestContextEmbed:
+    case blink::WebURLRequest::RequestContextObject:
+    case blink::WebURLRequest::RequestContextPlugin:
+      return ELEMENT_TYPE_OBJECT;
+    case blink::WebURLRequest::RequestContextEventSource:
+    case blink::WebURLRequest::RequestContextFetch:
+    case blink::WebURLRequest::RequestContextXMLHttpRequest:
+      return ELEMENT_TYPE_XMLHTTPREQUEST;
+    case blink::WebURLRequest::RequestContextFavicon:
+    case blink::WebURLRequest::RequestContextImage:
+    case blink::WebURLRequest::RequestContextImageSet:
+      return ELEMENT_TYPE_IMAGE;
+    case blink::WebURLRequest::RequestContextFont:
+      return ELEMENT_TYPE_FONT;
+    case blink::WebURLRequest::RequestContextFrame:
+    case blink::WebURLRequest::RequestContextForm:
+    case blink::WebURLRequest::RequestContextHyperlink:
+    case blink::WebURLRequest::RequestContextIframe:
+    case blink::WebURLRequest::RequestContextInternal:
+    case blink::WebURLRequest::RequestContextLocation:
+      return ELEMENT_TYPE_SUBDOCUMENT;
+    case blink::WebURLRequest::RequestContextScript:
+    case blink::WebURLRequest::RequestContextServiceWorker:
+    case blink::WebURLRequest::RequestContextSharedWorker:
+      return ELEMENT_TYPE_SCRIPT;
+    case blink::WebURLRequest::RequestContextStyle:
+    case blink::WebURLRequest::RequestContextXSLT:
+      return ELEMENT_TYPE_STYLESHEET;
+    default:
+      return ELEMENT_TYPE_OTHER;
+  }
+}
+
+}  // namespace
+
+DocumentSubresourceFilter::DocumentSubresourceFilter(
+    ActivationState activation_state,
+    scoped_refptr<const MemoryMappedRuleset> ruleset,
+    const url::Origin& document_origin)
+    : activation_state_(activation_state),
+      ruleset_(std::move(ruleset)),
+      matcher_(ruleset_->data(), ruleset_->length()),
+      document_origin_(document_origin) {
+  DCHECK_NE(activation_state_, ActivationState::DISABLED);
+}
+
+DocumentSubresourceFilter::~DocumentSubresourceFilter() = default;
+
+bool DocumentSubresourceFilter::allowLoad(
+    const blink::WebURL& resourceUrl,
+    blink::WebURLRequest::RequestContext request_context) {
+  bool disallow = matcher_.ShouldDisallowResourceLoad(
+      GURL(resourceUrl), ToElementType(request_context), document_origin_);
+  // In dry-run mode, loads are matched, but all of them are allowed.
+  return !disallow || activation_state_ == ActivationState::DRYRUN;
+}
+
+}  // namespace subresource_filter
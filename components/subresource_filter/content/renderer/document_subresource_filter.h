@@ -0,0 +1,46 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_DOCUMENT_SUBRESOURCE_FILTER_H_
+#define COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_DOCUMENT_SUBRESOURCE_FILTER_H_
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "components/subresource_filter/core/common/activation_state.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+#include "third_party/WebKit/public/platform/WebDocumentSubresourceFilter.h"
+#include "url/origin.h"
+
+namespace subresource_filter {
+
+class MemoryMappedRuleset;
+
+// Decides whether the subresource loads of a single document are allowed, by
+// matching them against the memory-mapped ruleset shared by the renderer.
+class DocumentSubresourceFilter : public blink::WebDocumentSubresourceFilter {
+ public:
+  DocumentSubresourceFilter(ActivationState activation_state,
+                            scoped_refptr<const MemoryMappedRuleset> ruleset,
+                            const url::Origin& document_origin);
+  ~DocumentSubresourceFilter() override;
+
+  // blink::WebDocumentSubresourceFilter:
+  bool allowLoad(const blink::WebURL& resourceUrl,
+                 blink::WebURLRequest::RequestContext) override;
+
+ private:
+  const ActivationState activation_state_;
+
+  // Keeps the ruleset mapped for the lifetime of the document, even if a new
+  // version is published in the meantime.
+  scoped_refptr<const MemoryMappedRuleset> ruleset_;
+  IndexedRulesetMatcher matcher_;
+  const url::Origin document_origin_;
+
+  DISALLOW_COPY_AND_ASSIGN(DocumentSubresourceFilter);
+};
+
+}  // namespace subresource_filter
+
+#endif  // COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_DOCUMENT_SUBRESOURCE_FILTER_H_
@@ -0,0 +1,45 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/content/renderer/ruleset_dealer.h"
+
+#include <utility>
+
+#include "components/subresource_filter/content/common/subresource_filter_messages.h"
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+#include "ipc/ipc_message.h"
+
+namespace subresource_filter {
+
+RulesetDealer::RulesetDealer() = default;
+
+RulesetDealer::~RulesetDealer() = default;
+
+scoped_refptr<const MemoryMappedRuleset> RulesetDealer::GetRuleset() {
+  if (!ruleset_ && ruleset_file_.IsValid()) {
+    ruleset_ = MemoryMappedRuleset::CreateAndInitialize(std::move(ruleset_file_));
+    // Do not try to map a malformed ruleset again for every document.
+    ruleset_file_.Close();
+  }
+  return ruleset_;
+}
+
+bool RulesetDealer::OnControlMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(RulesetDealer, message)
+    IPC_MESSAGE_HANDLER(SubresourceFilterMsg_SetRulesetForProcess,
+                        OnSetRulesetForProcess)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void RulesetDealer::OnSetRulesetForProcess(
+    const IPC::PlatformFileForTransit& ruleset_file) {
+  // Documents that are already loaded keep a reference to the old ruleset.
+  ruleset_ = nullptr;
+  ruleset_file_ = IPC::PlatformFileForTransitToFile(ruleset_file);
+}
+
+}  // namespace subresource_filter
@@ -0,0 +1,46 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_RULESET_DEALER_H_
+#define COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_RULESET_DEALER_H_
+
+#include "base/files/file.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/renderer/render_thread_observer.h"
+#include "ipc/ipc_platform_file.h"
+
+namespace subresource_filter {
+
+class MemoryMappedRuleset;
+
+// Receives the file handle to the indexed ruleset from the browser, and hands
+// out the memory-mapped ruleset to the SubresourceFilterAgents of all frames in
+// the renderer. The file is mapped on first use and then kept mapped: its pages
+// are backed by the file, so they are shared with other renderers and can be
+// dropped by the OS under memory pressure.
+class RulesetDealer : public content::RenderThreadObserver {
+ public:
+  RulesetDealer();
+  ~RulesetDealer() override;
+
+  // Returns the memory-mapped ruleset, or nullptr if no ruleset has been
+  // received yet, or it could not be mapped or is malformed.
+  scoped_refptr<const MemoryMappedRuleset> GetRuleset();
+
+  // content::RenderThreadObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
+
+ private:
+  void OnSetRulesetForProcess(const IPC::PlatformFileForTransit& ruleset_file);
+
+  base::File ruleset_file_;
+  scoped_refptr<const MemoryMappedRuleset> ruleset_;
+
+  DISALLOW_COPY_AND_ASSIGN(RulesetDealer);
+};
+
+}  // namespace subresource_filter
+
+#endif  // COMPONENTS_SUBRESOURCE_FILTER_CONTENT_RENDERER_RULESET_DEALER_H_
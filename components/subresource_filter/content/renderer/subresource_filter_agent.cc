@@ -4,40 +4,27 @@
 
 #include "components/subresource_filter/content/renderer/subresource_filter_agent.h"
 
+#include <utility>
+
 #include "components/subresource_filter/content/common/subresource_filter_messages.h"
+#include "components/subresource_filter/content/renderer/document_subresource_filter.h"
+#include "components/subresource_filter/content/renderer/ruleset_dealer.h"
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "content/public/renderer/render_frame.h"
 #include "ipc/ipc_message.h"
-#include "third_party/WebKit/public/platform/WebDocumentSubresourceFilter.h"
-#include "third_party/WebKit/public/platform/WebURL.h"
-#include "third_party/WebKit/public/platform/WebURLRequest.h"
+#include "third_party/WebKit/public/platform/WebSecurityOrigin.h"
 #include "third_party/WebKit/public/web/WebDataSource.h"
+#include "third_party/WebKit/public/web/WebDocument.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
+#include "url/origin.h"
 
 namespace subresource_filter {
 
-namespace {
-
-// Placeholder subresource filter implementation that disallows all loads.
-// TODO(engedy): Replace this with the actual filtering logic.
-class NaysayerFilter : public blink::WebDocumentSubresourceFilter {
- public:
-  NaysayerFilter() {}
-  ~NaysayerFilter() override {}
-
-  bool allowLoad(const blink::WebURL& resourceUrl,
-                 blink::WebURLRequest::RequestContext) override {
-    return false;
-  }
-
- private:
-  DISALLOW_COPY_AND_ASSIGN(NaysayerFilter);
-};
-
-}  // namespace
-
 SubresourceFilterAgent::SubresourceFilterAgent(
-    content::RenderFrame* render_frame)
+    content::RenderFrame* render_frame,
+    RulesetDealer* ruleset_dealer)
     : content::RenderFrameObserver(render_frame),
+      ruleset_dealer_(ruleset_dealer),
       activation_state_for_provisional_load_(ActivationState::DISABLED) {}
 
 SubresourceFilterAgent::~SubresourceFilterAgent() = default;
@@ -53,10 +40,19 @@ void SubresourceFilterAgent::DidStartProvisionalLoad() {
 void SubresourceFilterAgent::DidCommitProvisionalLoad(
     bool is_new_navigation,
     bool is_same_page_navigation) {
-  if (activation_state_for_provisional_load_ == ActivationState::ENABLED) {
-    blink::WebLocalFrame* web_frame = render_frame()->GetWebFrame();
-    web_frame->dataSource()->setSubresourceFilter(new NaysayerFilter);
-  }
+  if (activation_state_for_provisional_load_ == ActivationState::DISABLED)
+    return;
+
+  scoped_refptr<const MemoryMappedRuleset> ruleset =
+      ruleset_dealer_->GetRuleset();
+  if (!ruleset)
+    return;
+
+  blink::WebLocalFrame* web_frame = render_frame()->GetWebFrame();
+  url::Origin document_origin = web_frame->document().getSecurityOrigin();
+  web_frame->dataSource()->setSubresourceFilter(new DocumentSubresourceFilter(
+      activation_state_for_provisional_load_, std::move(ruleset),
+      document_origin));
 }
 
 bool SubresourceFilterAgent::OnMessageReceived(const IPC::Message& message) {
@@ -11,13 +11,17 @@
 
 namespace subresource_filter {
 
+class RulesetDealer;
+
 // The renderer-side agent of the ContentSubresourceFilterDriver. There is one
 // instance per RenderFrame, responsible for setting up the subresource filter
 // for the ongoing provisional document load in the frame when instructed to do
-// so by the driver.
+// so by the driver. The filter matches subresource loads against the ruleset
+// that |ruleset_dealer| hands out, which must outlive the agent.
 class SubresourceFilterAgent : public content::RenderFrameObserver {
  public:
-  explicit SubresourceFilterAgent(content::RenderFrame* render_frame);
+  SubresourceFilterAgent(content::RenderFrame* render_frame,
+                         RulesetDealer* ruleset_dealer);
   ~SubresourceFilterAgent() override;
 
  private:
@@ -32,6 +36,7 @@ class SubresourceFilterAgent : public content::RenderFrameObserver {
 
   void OnActivateForProvisionalLoad(ActivationState activation_state);
 
+  RulesetDealer* ruleset_dealer_;
   ActivationState activation_state_for_provisional_load_;
 
   DISALLOW_COPY_AND_ASSIGN(SubresourceFilterAgent);
@@ -0,0 +1,666 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace subresource_filter {
+
+using internal::IndexHeader;
+using internal::IndexedRule;
+using internal::NGramTableEntry;
+using internal::RulesetHeader;
+
+namespace {
+
+const uint32_t kMagic = 0x53524653;  // "SFRS"
+
+// Must be incremented whenever the layout or the meaning of the indexed data
+// changes, so that stale rulesets on disk are rejected.
+const uint32_t kVersion = 1;
+
+// Rules are indexed by N-grams of this many characters, which fit in the low
+// bytes of a uint64_t.
+const size_t kNGramSize = 5;
+const uint64_t kNGramMask = (static_cast<uint64_t>(1) << (8 * kNGramSize)) - 1;
+
+// The filter of an index has this many bits per table entry.
+const uint32_t kFilterBitsPerTableEntry = 4;
+
+// All sections of the ruleset start at offsets aligned this way.
+const size_t kAlignment = 8;
+
+const char kWildcard = '*';
+const char kSeparator = '^';
+
+enum RuleFlags : uint32_t {
+  RULE_FLAG_ANCHOR_LEFT = 1 << 0,
+  RULE_FLAG_ANCHOR_DOMAIN = 1 << 1,
+  RULE_FLAG_ANCHOR_RIGHT = 1 << 2,
+  RULE_FLAG_MATCH_CASE = 1 << 3,
+  RULE_FLAG_THIRD_PARTY = 1 << 4,
+  RULE_FLAG_FIRST_PARTY = 1 << 5,
+};
+
+const struct {
+  const char* name;
+  uint32_t type;
+} kElementTypeOptions[] = {
+    {"other", ELEMENT_TYPE_OTHER},
+    {"script", ELEMENT_TYPE_SCRIPT},
+    {"image", ELEMENT_TYPE_IMAGE},
+    {"stylesheet", ELEMENT_TYPE_STYLESHEET},
+    {"object", ELEMENT_TYPE_OBJECT},
+    {"xmlhttprequest", ELEMENT_TYPE_XMLHTTPREQUEST},
+    {"object-subrequest", ELEMENT_TYPE_OBJECT_SUBREQUEST},
+    {"subdocument", ELEMENT_TYPE_SUBDOCUMENT},
+    {"ping", ELEMENT_TYPE_PING},
+    {"media", ELEMENT_TYPE_MEDIA},
+    {"font", ELEMENT_TYPE_FONT},
+    {"websocket", ELEMENT_TYPE_WEBSOCKET},
+};
+
+// Parses the lower-cased |options| of a rule, which follow the "$". Returns
+// false if any of them is not supported.
+bool ParseOptions(base::StringPiece options, IndexedRule* rule) {
+  uint32_t included_types = 0;
+  uint32_t excluded_types = 0;
+  for (base::StringPiece option : base::SplitStringPiece(
+           options, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    bool negated = option.starts_with("~");
+    if (negated)
+      option.remove_prefix(1);
+
+    if (option == "third-party") {
+      rule->flags |= negated ? RULE_FLAG_FIRST_PARTY : RULE_FLAG_THIRD_PARTY;
+      continue;
+    }
+    if (option == "match-case" && !negated) {
+      rule->flags |= RULE_FLAG_MATCH_CASE;
+      continue;
+    }
+
+    bool found = false;
+    for (const auto& element_type_option : kElementTypeOptions) {
+      if (option == element_type_option.name) {
+        (negated ? excluded_types : included_types) |=
+            element_type_option.type;
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      return false;
+  }
+
+  rule->element_types =
+      (included_types ? included_types : ELEMENT_TYPE_ALL) & ~excluded_types;
+  return rule->element_types != 0;
+}
+
+uint32_t HashNGram(uint64_t ngram) {
+  return static_cast<uint32_t>((ngram * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+// Returns the N-grams of |pattern| that do not span a special character. The
+// N-grams are case-folded, so that URLs can be case-folded the same way when
+// looking them up.
+std::vector<uint64_t> GetPatternNGrams(base::StringPiece pattern) {
+  std::vector<uint64_t> ngrams;
+  uint64_t ngram = 0;
+  size_t length = 0;
+  for (char c : pattern) {
+    if (c == kWildcard || c == kSeparator) {
+      length = 0;
+      continue;
+    }
+    ngram = (ngram << 8) | static_cast<uint8_t>(base::ToLowerASCII(c));
+    if (++length >= kNGramSize && (ngram & kNGramMask))
+      ngrams.push_back(ngram & kNGramMask);
+  }
+  return ngrams;
+}
+
+// Appends |size| bytes at |data| to |buffer|, at the next aligned offset, and
+// returns that offset.
+uint32_t AppendToBuffer(std::vector<uint8_t>* buffer,
+                        const void* data,
+                        size_t size) {
+  size_t offset = (buffer->size() + kAlignment - 1) & ~(kAlignment - 1);
+  buffer->resize(offset + size);
+  if (size)
+    memcpy(buffer->data() + offset, data, size);
+  return base::checked_cast<uint32_t>(offset);
+}
+
+// Returns whether |count| elements of |element_size| bytes at |offset| lie
+// within a buffer of |size| bytes.
+bool IsRangeValid(size_t size,
+                  uint32_t offset,
+                  uint32_t count,
+                  size_t element_size) {
+  return offset % kAlignment == 0 && offset <= size &&
+         count <= (size - offset) / element_size;
+}
+
+bool IsSublistValid(uint32_t begin, uint32_t length, uint32_t list_size) {
+  return begin <= list_size && length <= list_size - begin;
+}
+
+bool VerifyIndex(const uint8_t* data,
+                 size_t size,
+                 const IndexHeader& index,
+                 uint32_t num_rules) {
+  if (index.table_size & (index.table_size - 1))
+    return false;
+  if (!index.filter_size || (index.filter_size & (index.filter_size - 1)))
+    return false;
+  if (!IsRangeValid(size, index.table_offset, index.table_size,
+                    sizeof(NGramTableEntry)) ||
+      !IsRangeValid(size, index.filter_offset, index.filter_size,
+                    sizeof(uint64_t)) ||
+      !IsRangeValid(size, index.rule_lists_offset, index.rule_lists_size,
+                    sizeof(uint32_t))) {
+    return false;
+  }
+
+  const NGramTableEntry* table =
+      reinterpret_cast<const NGramTableEntry*>(data + index.table_offset);
+  bool has_empty_entry = false;
+  for (uint32_t i = 0; i < index.table_size; ++i) {
+    if (!table[i].ngram) {
+      has_empty_entry = true;
+      continue;
+    }
+    if (!IsSublistValid(table[i].rule_list_begin, table[i].rule_list_length,
+                        index.rule_lists_size)) {
+      return false;
+    }
+  }
+  // Lookups stop at the first empty entry.
+  if (index.table_size && !has_empty_entry)
+    return false;
+
+  if (!IsSublistValid(index.fallback_rule_list_begin,
+                      index.fallback_rule_list_length,
+                      index.rule_lists_size)) {
+    return false;
+  }
+
+  const uint32_t* rule_lists =
+      reinterpret_cast<const uint32_t*>(data + index.rule_lists_offset);
+  for (uint32_t i = 0; i < index.rule_lists_size; ++i) {
+    if (rule_lists[i] >= num_rules)
+      return false;
+  }
+  return true;
+}
+
+// The subresource load that is being matched.
+class LoadInfo {
+ public:
+  LoadInfo(const GURL& url,
+           ElementType element_type,
+           const url::Origin& document_origin)
+      : url_(url),
+        spec_(url.possibly_invalid_spec()),
+        host_(url.parsed_for_possibly_invalid_spec().host),
+        element_type_(element_type),
+        document_origin_(document_origin),
+        is_third_party_(-1) {}
+
+  base::StringPiece spec() const { return spec_; }
+  const url::Component& host() const { return host_; }
+  ElementType element_type() const { return element_type_; }
+
+  // Worked out on first use, as only few rules depend on it.
+  bool IsThirdParty() const {
+    if (is_third_party_ < 0) {
+      is_third_party_ = !net::registry_controlled_domains::SameDomainOrHost(
+          url::Origin(url_), document_origin_,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+    }
+    return is_third_party_ > 0;
+  }
+
+ private:
+  const GURL& url_;
+  base::StringPiece spec_;
+  url::Component host_;
+  ElementType element_type_;
+  const url::Origin& document_origin_;
+  mutable int is_third_party_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadInfo);
+};
+
+// Everything but letters, digits, and "_-.%" is a separator.
+bool IsSeparatorChar(char c) {
+  return !base::IsAsciiAlpha(c) && !base::IsAsciiDigit(c) && c != '_' &&
+         c != '-' && c != '.' && c != '%';
+}
+
+// Returns whether |subpattern|, which has no wildcards, matches |spec| at
+// |position|, and if so, sets |end| to the end of the match. A separator
+// placeholder also matches the end of |spec|.
+bool SubpatternMatchesAt(base::StringPiece subpattern,
+                         base::StringPiece spec,
+                         size_t position,
+                         bool match_case,
+                         size_t* end) {
+  for (char c : subpattern) {
+    if (position == spec.size()) {
+      if (c != kSeparator)
+        return false;
+      continue;
+    }
+    char url_char =
+        match_case ? spec[position] : base::ToLowerASCII(spec[position]);
+    if (c == kSeparator ? !IsSeparatorChar(url_char) : c != url_char)
+      return false;
+    ++position;
+  }
+  *end = position;
+  return true;
+}
+
+// Returns the end of the leftmost match of |subpattern| in |spec| at or after
+// |position|, or npos.
+size_t FindSubpattern(base::StringPiece subpattern,
+                      base::StringPiece spec,
+                      size_t position,
+                      bool match_case) {
+  for (; position <= spec.size(); ++position) {
+    size_t end;
+    if (SubpatternMatchesAt(subpattern, spec, position, match_case, &end))
+      return end;
+  }
+  return base::StringPiece::npos;
+}
+
+bool PatternMatches(base::StringPiece pattern,
+                    uint32_t flags,
+                    const LoadInfo& load) {
+  const base::StringPiece spec = load.spec();
+  const bool match_case = flags & RULE_FLAG_MATCH_CASE;
+  const bool anchor_right = flags & RULE_FLAG_ANCHOR_RIGHT;
+
+  size_t wildcard = pattern.find(kWildcard);
+  base::StringPiece subpattern = pattern.substr(0, wildcard);
+
+  // The earliest match of the first subpattern leaves the most room for the
+  // rest of the pattern, so only that one needs to be tried.
+  size_t first = 0;
+  size_t last = spec.size();
+  if (flags & RULE_FLAG_ANCHOR_LEFT) {
+    last = 0;
+  } else if (flags & RULE_FLAG_ANCHOR_DOMAIN) {
+    if (!load.host().is_nonempty())
+      return false;
+    first = load.host().begin;
+    last = load.host().end() - 1;
+  }
+  size_t position = base::StringPiece::npos;
+  for (size_t start = first; start <= last; ++start) {
+    // A domain anchor matches at the start of any label of the host.
+    if ((flags & RULE_FLAG_ANCHOR_DOMAIN) && start != first &&
+        spec[start - 1] != '.') {
+      continue;
+    }
+    size_t end;
+    if (SubpatternMatchesAt(subpattern, spec, start, match_case, &end) &&
+        (wildcard != base::StringPiece::npos || !anchor_right ||
+         end == spec.size())) {
+      position = end;
+      break;
+    }
+  }
+  if (position == base::StringPiece::npos)
+    return false;
+  if (wildcard == base::StringPiece::npos)
+    return true;
+
+  pattern.remove_prefix(wildcard + 1);
+  while ((wildcard = pattern.find(kWildcard)) != base::StringPiece::npos) {
+    position = FindSubpattern(pattern.substr(0, wildcard), spec, position,
+                              match_case);
+    if (position == base::StringPiece::npos)
+      return false;
+    pattern.remove_prefix(wildcard + 1);
+  }
+  if (!anchor_right)
+    return FindSubpattern(pattern, spec, position, match_case) !=
+           base::StringPiece::npos;
+
+  // The last subpattern has to match at the very end.
+  size_t start =
+      std::max(position, spec.size() - std::min(pattern.size(), spec.size()));
+  for (; start <= spec.size(); ++start) {
+    size_t end;
+    if (SubpatternMatchesAt(pattern, spec, start, match_case, &end) &&
+        end == spec.size()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A read-only view of the blacklist or the whitelist of an indexed ruleset.
+class IndexView {
+ public:
+  IndexView(const uint8_t* data,
+            const RulesetHeader& header,
+            const IndexHeader& index)
+      : rules_(reinterpret_cast<const IndexedRule*>(data +
+                                                    header.rules_offset)),
+        patterns_(reinterpret_cast<const char*>(data +
+                                                header.patterns_offset)),
+        table_(reinterpret_cast<const NGramTableEntry*>(data +
+                                                        index.table_offset)),
+        table_mask_(index.table_size - 1),
+        filter_(reinterpret_cast<const uint64_t*>(data + index.filter_offset)),
+        filter_mask_(index.filter_size * 64 - 1),
+        rule_lists_(reinterpret_cast<const uint32_t*>(
+            data + index.rule_lists_offset)),
+        index_(index) {}
+
+  bool MatchesAny(const LoadInfo& load) const {
+    if (MatchesAnyInList(index_.fallback_rule_list_begin,
+                         index_.fallback_rule_list_length, load)) {
+      return true;
+    }
+    if (!index_.table_size)
+      return false;
+
+    const base::StringPiece spec = load.spec();
+    uint64_t ngram = 0;
+    for (size_t i = 0; i < spec.size(); ++i) {
+      ngram = ((ngram << 8) | static_cast<uint8_t>(base::ToLowerASCII(spec[i])))
+              & kNGramMask;
+      if (i + 1 < kNGramSize)
+        continue;
+      const uint32_t hash = HashNGram(ngram);
+      const uint32_t bit = hash & filter_mask_;
+      if (!(filter_[bit / 64] & (static_cast<uint64_t>(1) << (bit % 64))))
+        continue;
+      for (uint32_t slot = hash & table_mask_;;
+           slot = (slot + 1) & table_mask_) {
+        const NGramTableEntry& entry = table_[slot];
+        if (entry.ngram == ngram) {
+          if (MatchesAnyInList(entry.rule_list_begin, entry.rule_list_length,
+                               load)) {
+            return true;
+          }
+          break;
+        }
+        if (!entry.ngram)
+          break;
+      }
+    }
+    return false;
+  }
+
+ private:
+  bool MatchesAnyInList(uint32_t begin,
+                        uint32_t length,
+                        const LoadInfo& load) const {
+    for (uint32_t i = begin; i < begin + length; ++i) {
+      const IndexedRule& rule = rules_[rule_lists_[i]];
+      if (!(rule.element_types & load.element_type()))
+        continue;
+      if ((rule.flags & RULE_FLAG_THIRD_PARTY) && !load.IsThirdParty())
+        continue;
+      if ((rule.flags & RULE_FLAG_FIRST_PARTY) && load.IsThirdParty())
+        continue;
+      if (PatternMatches(base::StringPiece(patterns_ + rule.pattern_offset,
+                                           rule.pattern_length),
+                         rule.flags, load)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const IndexedRule* rules_;
+  const char* patterns_;
+  const NGramTableEntry* table_;
+  uint32_t table_mask_;
+  const uint64_t* filter_;
+  uint32_t filter_mask_;
+  const uint32_t* rule_lists_;
+  const IndexHeader& index_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexView);
+};
+
+}  // namespace
+
+// RulesetIndexer --------------------------------------------------------------
+
+RulesetIndexer::RulesetIndexer() {}
+
+RulesetIndexer::~RulesetIndexer() {}
+
+bool RulesetIndexer::AddUrlRule(base::StringPiece rule_text) {
+  DCHECK(buffer_.empty());
+  rule_text = base::TrimWhitespaceASCII(rule_text, base::TRIM_ALL);
+
+  // Comments, headers and element hiding rules.
+  if (rule_text.empty() || rule_text.starts_with("!") ||
+      rule_text.starts_with("[") ||
+      rule_text.find("##") != base::StringPiece::npos ||
+      rule_text.find("#@#") != base::StringPiece::npos) {
+    return false;
+  }
+
+  RuleListMap* index = &blacklist_;
+  if (rule_text.starts_with("@@")) {
+    index = &whitelist_;
+    rule_text.remove_prefix(2);
+  }
+
+  IndexedRule rule = {};
+  rule.element_types = ELEMENT_TYPE_ALL;
+  size_t options_begin = rule_text.rfind('$');
+  if (options_begin != base::StringPiece::npos) {
+    if (!ParseOptions(base::ToLowerASCII(rule_text.substr(options_begin + 1)),
+                      &rule)) {
+      return false;
+    }
+    rule_text = rule_text.substr(0, options_begin);
+  }
+
+  // Regular expressions.
+  if (rule_text.size() > 1 && rule_text.starts_with("/") &&
+      rule_text.ends_with("/")) {
+    return false;
+  }
+
+  if (rule_text.starts_with("||")) {
+    rule.flags |= RULE_FLAG_ANCHOR_DOMAIN;
+    rule_text.remove_prefix(2);
+  } else if (rule_text.starts_with("|")) {
+    rule.flags |= RULE_FLAG_ANCHOR_LEFT;
+    rule_text.remove_prefix(1);
+  }
+  if (rule_text.ends_with("|")) {
+    rule.flags |= RULE_FLAG_ANCHOR_RIGHT;
+    rule_text.remove_suffix(1);
+  }
+
+  std::string pattern = (rule.flags & RULE_FLAG_MATCH_CASE)
+                            ? rule_text.as_string()
+                            : base::ToLowerASCII(rule_text);
+  rule.pattern_offset = base::checked_cast<uint32_t>(patterns_.size());
+  rule.pattern_length = base::checked_cast<uint32_t>(pattern.size());
+  patterns_.append(pattern);
+
+  uint32_t rule_index = base::checked_cast<uint32_t>(rules_.size());
+  rules_.push_back(rule);
+  IndexRule(rule_index, pattern, index);
+  return true;
+}
+
+size_t RulesetIndexer::AddUrlRules(base::StringPiece filter_list) {
+  size_t num_indexed_rules = 0;
+  for (base::StringPiece line : base::SplitStringPiece(
+           filter_list, "\r\n", base::KEEP_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    if (AddUrlRule(line))
+      ++num_indexed_rules;
+  }
+  return num_indexed_rules;
+}
+
+void RulesetIndexer::IndexRule(uint32_t rule_index,
+                               base::StringPiece pattern,
+                               RuleListMap* index) {
+  // Use the N-gram with the shortest rule list so far, so that URLs that
+  // contain it are matched against as few rules as possible.
+  uint64_t best_ngram = 0;
+  size_t best_length = std::numeric_limits<size_t>::max();
+  for (uint64_t ngram : GetPatternNGrams(pattern)) {
+    auto it = index->find(ngram);
+    size_t length = it == index->end() ? 0 : it->second.size();
+    if (length < best_length) {
+      best_ngram = ngram;
+      best_length = length;
+      if (!length)
+        break;
+    }
+  }
+  (*index)[best_ngram].push_back(rule_index);
+}
+
+IndexHeader RulesetIndexer::WriteIndex(const RuleListMap& index) {
+  IndexHeader header = {};
+
+  // Keep the table at most half full, so that lookups are short and always
+  // end at an empty entry.
+  size_t num_ngrams = index.size() - index.count(0);
+  uint32_t table_size = 0;
+  if (num_ngrams) {
+    table_size = 1;
+    while (table_size < 2 * num_ngrams)
+      table_size <<= 1;
+  }
+
+  std::vector<NGramTableEntry> table(table_size);
+  std::vector<uint64_t> filter(
+      std::max<uint32_t>(1, table_size * kFilterBitsPerTableEntry / 64));
+  const uint32_t filter_mask = static_cast<uint32_t>(filter.size() * 64 - 1);
+  std::vector<uint32_t> rule_lists;
+  for (const auto& ngram_and_rules : index) {
+    uint32_t begin = base::checked_cast<uint32_t>(rule_lists.size());
+    uint32_t length = base::checked_cast<uint32_t>(ngram_and_rules.second.size());
+    rule_lists.insert(rule_lists.end(), ngram_and_rules.second.begin(),
+                      ngram_and_rules.second.end());
+    if (!ngram_and_rules.first) {
+      header.fallback_rule_list_begin = begin;
+      header.fallback_rule_list_length = length;
+      continue;
+    }
+    const uint32_t hash = HashNGram(ngram_and_rules.first);
+    filter[(hash & filter_mask) / 64] |= static_cast<uint64_t>(1)
+                                         << ((hash & filter_mask) % 64);
+    uint32_t slot = hash & (table_size - 1);
+    while (table[slot].ngram)
+      slot = (slot + 1) & (table_size - 1);
+    table[slot].ngram = ngram_and_rules.first;
+    table[slot].rule_list_begin = begin;
+    table[slot].rule_list_length = length;
+  }
+
+  header.table_size = table_size;
+  header.table_offset = AppendToBuffer(&buffer_, table.data(),
+                                       table.size() * sizeof(NGramTableEntry));
+  header.filter_size = base::checked_cast<uint32_t>(filter.size());
+  header.filter_offset = AppendToBuffer(&buffer_, filter.data(),
+                                        filter.size() * sizeof(uint64_t));
+  header.rule_lists_size = base::checked_cast<uint32_t>(rule_lists.size());
+  header.rule_lists_offset = AppendToBuffer(
+      &buffer_, rule_lists.data(), rule_lists.size() * sizeof(uint32_t));
+  return header;
+}
+
+void RulesetIndexer::Finish() {
+  DCHECK(buffer_.empty());
+  buffer_.resize(sizeof(RulesetHeader));
+
+  RulesetHeader header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.num_rules = base::checked_cast<uint32_t>(rules_.size());
+  header.rules_offset = AppendToBuffer(&buffer_, rules_.data(),
+                                       rules_.size() * sizeof(IndexedRule));
+  header.blacklist = WriteIndex(blacklist_);
+  header.whitelist = WriteIndex(whitelist_);
+  header.patterns_size = base::checked_cast<uint32_t>(patterns_.size());
+  header.patterns_offset =
+      AppendToBuffer(&buffer_, patterns_.data(), patterns_.size());
+  memcpy(buffer_.data(), &header, sizeof(header));
+}
+
+// IndexedRulesetMatcher -------------------------------------------------------
+
+// static
+bool IndexedRulesetMatcher::Verify(const uint8_t* data, size_t size) {
+  if (!data || size < sizeof(RulesetHeader) ||
+      reinterpret_cast<uintptr_t>(data) % kAlignment) {
+    return false;
+  }
+
+  const RulesetHeader* header = reinterpret_cast<const RulesetHeader*>(data);
+  if (header->magic != kMagic || header->version != kVersion)
+    return false;
+  if (!IsRangeValid(size, header->rules_offset, header->num_rules,
+                    sizeof(IndexedRule)) ||
+      !IsRangeValid(size, header->patterns_offset, header->patterns_size, 1)) {
+    return false;
+  }
+
+  const IndexedRule* rules =
+      reinterpret_cast<const IndexedRule*>(data + header->rules_offset);
+  for (uint32_t i = 0; i < header->num_rules; ++i) {
+    if (!IsSublistValid(rules[i].pattern_offset, rules[i].pattern_length,
+                        header->patterns_size)) {
+      return false;
+    }
+  }
+
+  return VerifyIndex(data, size, header->blacklist, header->num_rules) &&
+         VerifyIndex(data, size, header->whitelist, header->num_rules);
+}
+
+IndexedRulesetMatcher::IndexedRulesetMatcher(const uint8_t* data, size_t size)
+    : data_(data), header_(reinterpret_cast<const RulesetHeader*>(data)) {
+  DCHECK(Verify(data, size));
+}
+
+IndexedRulesetMatcher::~IndexedRulesetMatcher() {}
+
+bool IndexedRulesetMatcher::ShouldDisallowResourceLoad(
+    const GURL& url,
+    ElementType element_type,
+    const url::Origin& document_origin) const {
+  if (!url.is_valid())
+    return false;
+  LoadInfo load(url, element_type, document_origin);
+  return IndexView(data_, *header_, header_->blacklist).MatchesAny(load) &&
+         !IndexView(data_, *header_, header_->whitelist).MatchesAny(load);
+}
+
+}  // namespace subresource_filter
@@ -0,0 +1,186 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_INDEXED_RULESET_H_
+#define COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_INDEXED_RULESET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace url {
+class Origin;
+}  // namespace url
+
+namespace subresource_filter {
+
+// The types of subresources that URL rules can be restricted to, as a bit mask.
+enum ElementType : uint32_t {
+  ELEMENT_TYPE_OTHER = 1 << 0,
+  ELEMENT_TYPE_SCRIPT = 1 << 1,
+  ELEMENT_TYPE_IMAGE = 1 << 2,
+  ELEMENT_TYPE_STYLESHEET = 1 << 3,
+  ELEMENT_TYPE_OBJECT = 1 << 4,
+  ELEMENT_TYPE_XMLHTTPREQUEST = 1 << 5,
+  ELEMENT_TYPE_OBJECT_SUBREQUEST = 1 << 6,
+  ELEMENT_TYPE_SUBDOCUMENT = 1 << 7,
+  ELEMENT_TYPE_PING = 1 << 8,
+  ELEMENT_TYPE_MEDIA = 1 << 9,
+  ELEMENT_TYPE_FONT = 1 << 10,
+  ELEMENT_TYPE_WEBSOCKET = 1 << 11,
+  ELEMENT_TYPE_ALL = (1 << 12) - 1,
+};
+
+namespace internal {
+
+// The layout of an indexed ruleset. All offsets are in bytes from the start of
+// the ruleset, and all values are in host byte order: the ruleset is indexed on
+// the same machine as it is used.
+//
+//   RulesetHeader
+//   IndexedRule[num_rules]
+//   for the blacklist, then the whitelist:
+//     NGramTableEntry[table_size]  -- open addressing, keyed by N-gram
+//     uint64_t[filter_size]        -- a bit per hash value, set if any N-gram
+//                                     in the table has that hash
+//     uint32_t[rule_lists_size]    -- the rule lists the entries point into
+//   char[patterns_size]            -- the URL patterns of the rules
+
+struct IndexedRule {
+  uint32_t flags;
+  uint32_t element_types;
+  uint32_t pattern_offset;
+  uint32_t pattern_length;
+};
+
+struct NGramTableEntry {
+  // Zero for an empty entry.
+  uint64_t ngram;
+  uint32_t rule_list_begin;
+  uint32_t rule_list_length;
+};
+
+struct IndexHeader {
+  uint32_t table_offset;
+  // Zero, or a power of two.
+  uint32_t table_size;
+  // Most N-grams of a URL are not in the table. The filter is small enough to
+  // stay in the CPU cache, and rules most of them out without a table lookup.
+  uint32_t filter_offset;
+  // A power of two.
+  uint32_t filter_size;
+  uint32_t rule_lists_offset;
+  uint32_t rule_lists_size;
+  // The rules with no N-gram, which are matched against every URL.
+  uint32_t fallback_rule_list_begin;
+  uint32_t fallback_rule_list_length;
+};
+
+struct RulesetHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_rules;
+  uint32_t rules_offset;
+  uint32_t patterns_offset;
+  uint32_t patterns_size;
+  IndexHeader blacklist;
+  IndexHeader whitelist;
+};
+
+}  // namespace internal
+
+// Builds the indexed representation of a ruleset from the URL rules of a
+// filter list in the Adblock Plus syntax. The result is a single flat buffer
+// that IndexedRulesetMatcher can use in place, without any deserialization, so
+// that it can be memory-mapped from disk and shared by all renderers.
+//
+// Every rule is indexed under one of the N-grams of its URL pattern, picked to
+// keep the per-N-gram rule lists short. A URL is then only matched against the
+// rules listed under the N-grams it contains, plus the few rules whose pattern
+// is too short to have any N-gram.
+//
+// Supported: blacklist and "@@" whitelist rules; the "|", "||" and trailing "|"
+// anchors; the "*" and "^" special characters; the element type options, the
+// "third-party" and "match-case" options. Rules using anything else, such as
+// regular expressions, "domain=" or document-level options, as well as element
+// hiding rules, are not indexed.
+class RulesetIndexer {
+ public:
+  RulesetIndexer();
+  ~RulesetIndexer();
+
+  // Parses and indexes a single line of a filter list. Returns false if the
+  // line is not a URL rule, or uses a feature that is not supported.
+  bool AddUrlRule(base::StringPiece rule_text);
+
+  // Parses and indexes all lines of |filter_list|, and returns the number of
+  // rules that were indexed.
+  size_t AddUrlRules(base::StringPiece filter_list);
+
+  // Lays out the indexed ruleset. Must be called once, after all rules have
+  // been added.
+  void Finish();
+
+  const uint8_t* data() const { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+
+ private:
+  // The rule lists of a blacklist or a whitelist, keyed by N-gram. Rules with
+  // no N-gram are listed under 0.
+  using RuleListMap = std::map<uint64_t, std::vector<uint32_t>>;
+
+  void IndexRule(uint32_t rule_index,
+                 base::StringPiece pattern,
+                 RuleListMap* index);
+  internal::IndexHeader WriteIndex(const RuleListMap& index);
+
+  std::vector<internal::IndexedRule> rules_;
+  std::string patterns_;
+  RuleListMap blacklist_;
+  RuleListMap whitelist_;
+
+  std::vector<uint8_t> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(RulesetIndexer);
+};
+
+// Matches subresource URLs against an indexed ruleset that was built by
+// RulesetIndexer. The matcher does not own or copy the ruleset, which must
+// outlive it. Matching a URL does not allocate memory, except for working out
+// whether the load is third-party when a candidate rule depends on that.
+class IndexedRulesetMatcher {
+ public:
+  // Returns whether |data| holds a well-formed indexed ruleset of the current
+  // format version. Must be called before constructing a matcher over data that
+  // comes from outside of the process.
+  static bool Verify(const uint8_t* data, size_t size);
+
+  IndexedRulesetMatcher(const uint8_t* data, size_t size);
+  ~IndexedRulesetMatcher();
+
+  // Returns whether a subresource load of |url| of the given |element_type|
+  // from a document at |document_origin| matches a blacklist rule and no
+  // whitelist rule.
+  bool ShouldDisallowResourceLoad(const GURL& url,
+                                  ElementType element_type,
+                                  const url::Origin& document_origin) const;
+
+ private:
+  const uint8_t* data_;
+  const internal::RulesetHeader* header_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedRulesetMatcher);
+};
+
+}  // namespace subresource_filter
+
+#endif  // COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_INDEXED_RULESET_H_
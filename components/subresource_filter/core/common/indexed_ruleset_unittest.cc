@@ -0,0 +1,233 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace subresource_filter {
+
+class SubresourceFilterIndexedRulesetTest : public ::testing::Test {
+ public:
+  SubresourceFilterIndexedRulesetTest() {}
+
+ protected:
+  void Index(const char* filter_list) {
+    RulesetIndexer indexer;
+    indexer.AddUrlRules(filter_list);
+    indexer.Finish();
+    ASSERT_TRUE(IndexedRulesetMatcher::Verify(indexer.data(), indexer.size()));
+    // Copy into storage that is aligned the same way as a memory mapping.
+    ruleset_.resize((indexer.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    memcpy(ruleset_.data(), indexer.data(), indexer.size());
+    matcher_.reset(new IndexedRulesetMatcher(
+        reinterpret_cast<const uint8_t*>(ruleset_.data()), indexer.size()));
+  }
+
+  bool ShouldAllow(const char* url,
+                   ElementType element_type = ELEMENT_TYPE_SCRIPT,
+                   const char* document_url = "http://example.com/") {
+    return !matcher_->ShouldDisallowResourceLoad(
+        GURL(url), element_type, url::Origin(GURL(document_url)));
+  }
+
+ private:
+  std::vector<uint64_t> ruleset_;
+  std::unique_ptr<IndexedRulesetMatcher> matcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubresourceFilterIndexedRulesetTest);
+};
+
+TEST_F(SubresourceFilterIndexedRulesetTest, ParseRules) {
+  RulesetIndexer indexer;
+  EXPECT_TRUE(indexer.AddUrlRule("/ads/banner"));
+  EXPECT_TRUE(indexer.AddUrlRule("  ||ads.example.com^$script,image  "));
+  EXPECT_TRUE(indexer.AddUrlRule("@@||example.com/allowed$~third-party"));
+  EXPECT_TRUE(indexer.AddUrlRule("ad$"));
+  EXPECT_TRUE(indexer.AddUrlRule("Ad$Match-Case"));
+
+  EXPECT_FALSE(indexer.AddUrlRule(""));
+  EXPECT_FALSE(indexer.AddUrlRule("! Comment"));
+  EXPECT_FALSE(indexer.AddUrlRule("[Adblock Plus 2.0]"));
+  EXPECT_FALSE(indexer.AddUrlRule("example.com##.ad"));
+  EXPECT_FALSE(indexer.AddUrlRule("example.com#@#.ad"));
+  EXPECT_FALSE(indexer.AddUrlRule("/banner\\d+/"));
+  EXPECT_FALSE(indexer.AddUrlRule("/ads/"));
+  EXPECT_FALSE(indexer.AddUrlRule("ad$domain=example.com"));
+  EXPECT_FALSE(indexer.AddUrlRule("ad$popup"));
+  EXPECT_FALSE(indexer.AddUrlRule("ad$~script,script"));
+
+  EXPECT_EQ(2u, indexer.AddUrlRules("! Title\nad1\r\nad2\n\nexample.com##x"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, Substrings) {
+  Index("/ads/banner\nAD.JS\nzq");
+  EXPECT_FALSE(ShouldAllow("http://example.com/ads/banner.png"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/ADS/Banner.png"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/ad.js"));
+  // Matches the short pattern, which has no N-gram.
+  EXPECT_FALSE(ShouldAllow("http://zq.com/"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/ads/banne"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/adsjs"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, WildcardsAndSeparators) {
+  Index("/ads/*/banner*.gif\n^track^\nanalytics.js^");
+  EXPECT_FALSE(ShouldAllow("http://example.com/ads/123/banner1.gif"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/ads//banner.gif"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/ads/banner.gif"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/ads/1/banner.png"));
+
+  EXPECT_FALSE(ShouldAllow("http://example.com/track?id=1"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/track/"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/tracker/"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/a-track/"));
+
+  // A separator placeholder also matches the end of the URL.
+  EXPECT_FALSE(ShouldAllow("http://example.com/analytics.js"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/analytics.js?v=1"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/analytics.json"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, Anchors) {
+  Index("|http://ads.\n||tracker.net^\n.swf|\n|https://*/pixel.gif|");
+  EXPECT_FALSE(ShouldAllow("http://ads.example.com/"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/http://ads."));
+
+  EXPECT_FALSE(ShouldAllow("http://tracker.net/a.js"));
+  EXPECT_FALSE(ShouldAllow("https://cdn.tracker.net/a.js"));
+  EXPECT_TRUE(ShouldAllow("http://nottracker.net/a.js"));
+  EXPECT_TRUE(ShouldAllow("http://tracker.network/a.js"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/tracker.net/a.js"));
+
+  EXPECT_FALSE(ShouldAllow("http://example.com/movie.swf"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/movie.swf?autoplay"));
+
+  EXPECT_FALSE(ShouldAllow("https://example.com/pixel.gif"));
+  EXPECT_TRUE(ShouldAllow("https://example.com/pixel.gif?x"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/pixel.gif"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, MatchCase) {
+  Index("/BannerAd.$match-case");
+  EXPECT_FALSE(ShouldAllow("http://example.com/BannerAd.gif"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/bannerad.gif"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, ElementTypes) {
+  Index("/ads/*$script,image\n/track/*$~image");
+  EXPECT_FALSE(ShouldAllow("http://example.com/ads/a", ELEMENT_TYPE_SCRIPT));
+  EXPECT_FALSE(ShouldAllow("http://example.com/ads/a", ELEMENT_TYPE_IMAGE));
+  EXPECT_TRUE(ShouldAllow("http://example.com/ads/a", ELEMENT_TYPE_FONT));
+
+  EXPECT_FALSE(ShouldAllow("http://example.com/track/a", ELEMENT_TYPE_OTHER));
+  EXPECT_TRUE(ShouldAllow("http://example.com/track/a", ELEMENT_TYPE_IMAGE));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, ThirdParty) {
+  Index("/ads/*$third-party\n/own-ads/*$~third-party");
+  EXPECT_FALSE(ShouldAllow("http://ads.net/ads/a", ELEMENT_TYPE_SCRIPT,
+                           "http://example.com/"));
+  EXPECT_TRUE(ShouldAllow("http://cdn.example.com/ads/a", ELEMENT_TYPE_SCRIPT,
+                          "http://www.example.com/"));
+
+  EXPECT_FALSE(ShouldAllow("http://cdn.example.com/own-ads/a",
+                           ELEMENT_TYPE_SCRIPT, "http://www.example.com/"));
+  EXPECT_TRUE(ShouldAllow("http://ads.net/own-ads/a", ELEMENT_TYPE_SCRIPT,
+                          "http://example.com/"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, Whitelist) {
+  Index("/ads/*\n@@||example.com/ads/allowed\n@@/ads/*$image");
+  EXPECT_FALSE(ShouldAllow("http://ads.net/ads/a"));
+  EXPECT_TRUE(ShouldAllow("http://www.example.com/ads/allowed.js"));
+  EXPECT_TRUE(ShouldAllow("http://ads.net/ads/a", ELEMENT_TYPE_IMAGE));
+  // A whitelist rule alone does not disallow anything.
+  EXPECT_TRUE(ShouldAllow("http://example.com/other"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, ManyRules) {
+  std::string filter_list;
+  for (int i = 0; i < 1000; ++i)
+    filter_list += "/banner" + std::to_string(i) + ".gif\n";
+  Index(filter_list.c_str());
+  EXPECT_FALSE(ShouldAllow("http://example.com/banner0.gif"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/a/banner537.gif?x"));
+  EXPECT_FALSE(ShouldAllow("http://example.com/banner999.gif"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/banner1000.gif"));
+  EXPECT_TRUE(ShouldAllow("http://example.com/banner.gif"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, EmptyRuleset) {
+  Index("");
+  EXPECT_TRUE(ShouldAllow("http://example.com/ads/a"));
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, VerifyRejectsCorruptRulesets) {
+  RulesetIndexer indexer;
+  indexer.AddUrlRules("/ads/*\n@@/ads/ok\nx");
+  indexer.Finish();
+  std::vector<uint64_t> storage(indexer.size() / sizeof(uint64_t) + 1);
+  uint8_t* ruleset = reinterpret_cast<uint8_t*>(storage.data());
+  memcpy(ruleset, indexer.data(), indexer.size());
+  ASSERT_TRUE(IndexedRulesetMatcher::Verify(ruleset, indexer.size()));
+
+  // Truncated rulesets.
+  for (size_t size = 0; size < indexer.size(); ++size)
+    EXPECT_FALSE(IndexedRulesetMatcher::Verify(ruleset, size)) << size;
+
+  // Offsets pointing out of bounds.
+  for (size_t offset = 0; offset < sizeof(internal::RulesetHeader);
+       offset += sizeof(uint32_t)) {
+    uint32_t* value = reinterpret_cast<uint32_t*>(ruleset + offset);
+    uint32_t original_value = *value;
+    *value = 0xFFFFFFF0u;
+    EXPECT_FALSE(IndexedRulesetMatcher::Verify(ruleset, indexer.size()))
+        << offset;
+    *value = original_value;
+  }
+}
+
+TEST_F(SubresourceFilterIndexedRulesetTest, MemoryMappedRuleset) {
+  RulesetIndexer indexer;
+  indexer.AddUrlRules("/ads/*");
+  indexer.Finish();
+
+  base::ScopedTempDir scoped_temp_dir;
+  ASSERT_TRUE(scoped_temp_dir.CreateUniqueTempDir());
+  base::FilePath path = scoped_temp_dir.path().AppendASCII("Indexed Rules");
+  ASSERT_EQ(static_cast<int>(indexer.size()),
+            base::WriteFile(path, reinterpret_cast<const char*>(indexer.data()),
+                            indexer.size()));
+
+  scoped_refptr<MemoryMappedRuleset> ruleset =
+      MemoryMappedRuleset::CreateAndInitialize(
+          base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ));
+  ASSERT_TRUE(ruleset);
+  IndexedRulesetMatcher matcher(ruleset->data(), ruleset->length());
+  EXPECT_TRUE(matcher.ShouldDisallowResourceLoad(
+      GURL("http://example.com/ads/a.js"), ELEMENT_TYPE_SCRIPT,
+      url::Origin(GURL("http://example.com/"))));
+
+  ASSERT_TRUE(base::WriteFile(path, "garbage", 7));
+  EXPECT_FALSE(MemoryMappedRuleset::CreateAndInitialize(
+      base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ)));
+}
+
+}  // namespace subresource_filter
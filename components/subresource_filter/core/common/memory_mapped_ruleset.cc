@@ -0,0 +1,28 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+
+#include <utility>
+
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+
+namespace subresource_filter {
+
+// static
+scoped_refptr<MemoryMappedRuleset> MemoryMappedRuleset::CreateAndInitialize(
+    base::File ruleset_file) {
+  scoped_refptr<MemoryMappedRuleset> ruleset(new MemoryMappedRuleset);
+  if (!ruleset->ruleset_.Initialize(std::move(ruleset_file)) ||
+      !IndexedRulesetMatcher::Verify(ruleset->data(), ruleset->length())) {
+    return nullptr;
+  }
+  return ruleset;
+}
+
+MemoryMappedRuleset::MemoryMappedRuleset() {}
+
+MemoryMappedRuleset::~MemoryMappedRuleset() {}
+
+}  // namespace subresource_filter
@@ -0,0 +1,44 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_MEMORY_MAPPED_RULESET_H_
+#define COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_MEMORY_MAPPED_RULESET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+
+namespace subresource_filter {
+
+// An indexed ruleset that is memory-mapped read-only from a file. The pages are
+// backed by the file, so every process that maps the same file shares them,
+// and the matcher works on them in place.
+class MemoryMappedRuleset : public base::RefCounted<MemoryMappedRuleset> {
+ public:
+  // Maps |ruleset_file| and verifies that it holds a well-formed indexed
+  // ruleset. Returns nullptr on failure.
+  static scoped_refptr<MemoryMappedRuleset> CreateAndInitialize(
+      base::File ruleset_file);
+
+  const uint8_t* data() const { return ruleset_.data(); }
+  size_t length() const { return ruleset_.length(); }
+
+ private:
+  friend class base::RefCounted<MemoryMappedRuleset>;
+
+  MemoryMappedRuleset();
+  ~MemoryMappedRuleset();
+
+  base::MemoryMappedFile ruleset_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryMappedRuleset);
+};
+
+}  // namespace subresource_filter
+
+#endif  // COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_MEMORY_MAPPED_RULESET_H_
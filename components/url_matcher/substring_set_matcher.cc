@@ -21,6 +21,11 @@ bool ComparePatterns(const StringPattern* a, const StringPattern* b) {
   return a->pattern() < b->pattern();
 }
 
+// Orders the edges of an AhoCorasickNode by their label.
+bool CompareEdgeLabel(const std::pair<char, uint32_t>& edge, char label) {
+  return edge.first < label;
+}
+
 // Given the set of patterns, compute how many nodes will the corresponding
 // Aho-Corasick tree have. Note that |patterns| need to be sorted.
 uint32_t TreeSize(const std::vector<const StringPattern*>& patterns) {
@@ -125,8 +130,11 @@ bool SubstringSetMatcher::Match(const std::string& text,
     }
     if (edge_from_current != AhoCorasickNode::kNoSuchEdge) {
       current_node = edge_from_current;
-      matches->insert(tree_[current_node].matches().begin(),
-                      tree_[current_node].matches().end());
+      for (uint32_t node = current_node; node != AhoCorasickNode::kNoSuchEdge;
+           node = tree_[node].output_link()) {
+        matches->insert(tree_[node].matches().begin(),
+                        tree_[node].matches().end());
+      }
     } else {
       DCHECK_EQ(0u, current_node);
     }
@@ -225,7 +233,14 @@ void SubstringSetMatcher::CreateFailureEdges() {
           edge_from_failure != AhoCorasickNode::kNoSuchEdge ? edge_from_failure
                                                             : 0;
       tree_[leads_to].set_failure(follow_in_case_of_failure);
-      tree_[leads_to].AddMatches(tree_[follow_in_case_of_failure].matches());
+
+      // The failure node is closer to the root, so its output link is set.
+      // The root's matches are reported once for the whole text.
+      const AhoCorasickNode& failure_node = tree_[follow_in_case_of_failure];
+      tree_[leads_to].set_output_link(
+          follow_in_case_of_failure != 0 && !failure_node.matches().empty()
+              ? follow_in_case_of_failure
+              : failure_node.output_link());
     }
   }
 }
@@ -233,7 +248,7 @@ void SubstringSetMatcher::CreateFailureEdges() {
 const uint32_t SubstringSetMatcher::AhoCorasickNode::kNoSuchEdge = 0xFFFFFFFF;
 
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode()
-    : failure_(kNoSuchEdge) {}
+    : failure_(kNoSuchEdge), output_link_(kNoSuchEdge) {}
 
 SubstringSetMatcher::AhoCorasickNode::~AhoCorasickNode() {}
 
@@ -241,6 +256,7 @@ SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode(
     const SubstringSetMatcher::AhoCorasickNode& other)
     : edges_(other.edges_),
       failure_(other.failure_),
+      output_link_(other.output_link_),
       matches_(other.matches_) {}
 
 SubstringSetMatcher::AhoCorasickNode&
@@ -248,26 +264,32 @@ SubstringSetMatcher::AhoCorasickNode::operator=(
     const SubstringSetMatcher::AhoCorasickNode& other) {
   edges_ = other.edges_;
   failure_ = other.failure_;
+  output_link_ = other.output_link_;
   matches_ = other.matches_;
   return *this;
 }
 
 uint32_t SubstringSetMatcher::AhoCorasickNode::GetEdge(char c) const {
-  Edges::const_iterator i = edges_.find(c);
-  return i == edges_.end() ? kNoSuchEdge : i->second;
+  Edges::const_iterator i =
+      std::lower_bound(edges_.begin(), edges_.end(), c, CompareEdgeLabel);
+  return i != edges_.end() && i->first == c ? i->second : kNoSuchEdge;
 }
 
 void SubstringSetMatcher::AhoCorasickNode::SetEdge(char c, uint32_t node) {
-  edges_[c] = node;
+  // Patterns are inserted in sorted order, so new edges usually go last.
+  Edges::iterator i =
+      std::lower_bound(edges_.begin(), edges_.end(), c, CompareEdgeLabel);
+  if (i != edges_.end() && i->first == c)
+    i->second = node;
+  else
+    edges_.insert(i, Edge(c, node));
 }
 
 void SubstringSetMatcher::AhoCorasickNode::AddMatch(StringPattern::ID id) {
-  matches_.insert(id);
-}
-
-void SubstringSetMatcher::AhoCorasickNode::AddMatches(
-    const SubstringSetMatcher::AhoCorasickNode::Matches& matches) {
-  matches_.insert(matches.begin(), matches.end());
+  // A pattern string can be registered under several IDs, but each ID only
+  // once.
+  DCHECK(std::find(matches_.begin(), matches_.end(), id) == matches_.end());
+  matches_.push_back(id);
 }
 
 }  // namespace url_matcher
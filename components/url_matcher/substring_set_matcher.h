@@ -11,6 +11,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/macros.h"
@@ -81,11 +82,20 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // If your brain thinks "Forget it, let's go shopping.", don't worry.
   // Take a nap and read an introductory text on the Aho Corasick algorithm.
   // It will make sense. Eventually.
+  //
+  // Nodes keep their edges in a vector sorted by label, and only the IDs of
+  // the patterns ending at the node itself.  The matches of the shorter
+  // patterns which end at the same position are found through the output
+  // link, which points to the next node on the failure path that has matches
+  // of its own.  This keeps the tree compact for the tens of thousands of
+  // patterns that declarative rules can register, without copying match sets
+  // along the failure edges.
   class AhoCorasickNode {
    public:
-    // Key: label of the edge, value: node index in |tree_| of parent class.
-    typedef std::map<char, uint32_t> Edges;
-    typedef std::set<StringPattern::ID> Matches;
+    // Label of the edge, and node index in |tree_| of parent class.
+    typedef std::pair<char, uint32_t> Edge;
+    typedef std::vector<Edge> Edges;
+    typedef std::vector<StringPattern::ID> Matches;
 
     static const uint32_t kNoSuchEdge;  // Represents an invalid node index.
 
@@ -101,18 +111,24 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
     uint32_t failure() const { return failure_; }
     void set_failure(uint32_t failure) { failure_ = failure; }
 
+    uint32_t output_link() const { return output_link_; }
+    void set_output_link(uint32_t output_link) { output_link_ = output_link; }
+
     void AddMatch(StringPattern::ID id);
-    void AddMatches(const Matches& matches);
     const Matches& matches() const { return matches_; }
 
    private:
-    // Outgoing edges of current node.
+    // Outgoing edges of current node, sorted by label.
     Edges edges_;
 
     // Node index that failure edge leads to.
     uint32_t failure_;
 
-    // Identifiers of matches.
+    // Node index of the longest proper suffix with matches, other than the
+    // root, or kNoSuchEdge.
+    uint32_t output_link_;
+
+    // Identifiers of the patterns ending at this node.
     Matches matches_;
   };
 
@@ -162,6 +162,34 @@ TEST(SubstringSetMatcherTest, RegisterAndRemove) {
   EXPECT_TRUE(matcher.IsEmpty());
 }
 
+// Patterns ending at the same position of the text are reported through the
+// chain of output links, even when the nodes in between have no matches.
+TEST(SubstringSetMatcherTest, NestedSuffixes) {
+  StringPattern pattern_1("xabcd", 1);
+  StringPattern pattern_2("bcd", 2);
+  StringPattern pattern_3("d", 3);
+  StringPattern pattern_4("abce", 4);
+  std::vector<const StringPattern*> patterns;
+  patterns.push_back(&pattern_1);
+  patterns.push_back(&pattern_2);
+  patterns.push_back(&pattern_3);
+  patterns.push_back(&pattern_4);
+
+  SubstringSetMatcher matcher;
+  matcher.RegisterPatterns(patterns);
+
+  std::set<int> matches;
+  EXPECT_TRUE(matcher.Match("xabcd", &matches));
+  EXPECT_EQ(std::set<int>({1, 2, 3}), matches);
+
+  matches.clear();
+  EXPECT_TRUE(matcher.Match("abcd", &matches));
+  EXPECT_EQ(std::set<int>({2, 3}), matches);
+
+  matches.clear();
+  EXPECT_FALSE(matcher.Match("xabc", &matches));
+}
+
 TEST(SubstringSetMatcherTest, TestEmptyMatcher) {
   SubstringSetMatcher matcher;
   std::set<int> matches;
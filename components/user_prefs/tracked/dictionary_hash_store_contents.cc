@@ -48,6 +48,9 @@ base::DictionaryValue* MutablePreferenceMacDictionary::operator->() {
 
 }  // namespace
 
+// static
+const char DictionaryHashStoreContents::kStorageKey[] = "protection";
+
 DictionaryHashStoreContents::DictionaryHashStoreContents(
     base::DictionaryValue* storage)
     : storage_(storage) {
@@ -27,6 +27,9 @@ class DictionaryHashStoreContents : public HashStoreContents {
   // |storage|.
   explicit DictionaryHashStoreContents(base::DictionaryValue* storage);
 
+  // The top-level key of |storage| under which all MACs are stored.
+  static const char kStorageKey[];
+
   // Registers required preferences.
   static void RegisterProfilePrefs(user_prefs::PrefRegistrySyncable* registry);
 
@@ -182,6 +182,11 @@ void PrefHashFilter::FilterSerializeData(
   }
 }
 
+// FilterSerializeData() only stores hashes, which are all under the same key.
+std::string PrefHashFilter::GetSerializeDataKey() const {
+  return DictionaryHashStoreContents::kStorageKey;
+}
+
 void PrefHashFilter::FinalizeFilterOnLoad(
     const PostFilterOnLoadCallback& post_filter_on_load_callback,
     std::unique_ptr<base::DictionaryValue> pref_store_contents,
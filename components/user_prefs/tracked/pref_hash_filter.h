@@ -102,6 +102,7 @@ class PrefHashFilter : public InterceptablePrefFilter {
   // PrefFilter remaining implementation.
   void FilterUpdate(const std::string& path) override;
   void FilterSerializeData(base::DictionaryValue* pref_store_contents) override;
+  std::string GetSerializeDataKey() const override;
 
  private:
   // InterceptablePrefFilter implementation.
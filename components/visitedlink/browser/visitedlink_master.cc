@@ -56,6 +56,9 @@ const unsigned VisitedLinkMaster::kDefaultTableSize = 16381;
 
 const size_t VisitedLinkMaster::kBigDeleteThreshold = 64;
 
+// Rehashing a table of this size already takes long enough to be noticed.
+const int32_t VisitedLinkMaster::kDefaultBackgroundResizeThreshold = 262127;
+
 namespace {
 
 // Fills the given salt structure with some quasi-random values
@@ -101,6 +104,20 @@ void AsyncWrite(FILE** file, int32_t offset, const std::string& data) {
     WriteToFile(*file, offset, data.data(), data.size());
 }
 
+// Writes |header| and |table| at the start of |file|, and truncates it after
+// them. Returns true on success.
+bool WriteHeaderAndTable(FILE* file,
+                         const void* header,
+                         size_t header_size,
+                         const void* table,
+                         size_t table_size) {
+  if (!WriteToFile(file, 0, header, header_size) ||
+      !WriteToFile(file, header_size, table, table_size)) {
+    return false;
+  }
+  return base::TruncateFile(file);
+}
+
 // Truncates the file to the current position asynchronously on a background
 // thread. Double pointer to FILE is used because file may still not be opened
 // by the time of scheduling the task for execution.
@@ -161,6 +178,49 @@ VisitedLinkMaster::LoadFromFileResult::LoadFromFileResult(
 VisitedLinkMaster::LoadFromFileResult::~LoadFromFileResult() {
 }
 
+struct VisitedLinkMaster::TableResizeResult
+    : public base::RefCountedThreadSafe<TableResizeResult> {
+  TableResizeResult(int32_t serial,
+                    int32_t num_entries,
+                    const uint8_t salt[LINK_SALT_LENGTH]);
+
+  // The serial number of the shared memory the new table is built for.
+  int32_t serial;
+  int32_t num_entries;
+  uint8_t salt[LINK_SALT_LENGTH];
+
+  // The fingerprints to put in the new table. Cleared once they are.
+  Fingerprints fingerprints;
+
+  // Filled in on the background thread. |shared_memory| is null if the new
+  // table could not be allocated.
+  std::unique_ptr<base::SharedMemory> shared_memory;
+  Fingerprint* hash_table;
+  int32_t used_count;
+  bool written_to_file;
+
+ private:
+  friend class base::RefCountedThreadSafe<TableResizeResult>;
+  virtual ~TableResizeResult();
+
+  DISALLOW_COPY_AND_ASSIGN(TableResizeResult);
+};
+
+VisitedLinkMaster::TableResizeResult::TableResizeResult(
+    int32_t serial,
+    int32_t num_entries,
+    const uint8_t salt[LINK_SALT_LENGTH])
+    : serial(serial),
+      num_entries(num_entries),
+      hash_table(nullptr),
+      used_count(0),
+      written_to_file(false) {
+  memcpy(this->salt, salt, LINK_SALT_LENGTH);
+}
+
+VisitedLinkMaster::TableResizeResult::~TableResizeResult() {
+}
+
 // TableBuilder ---------------------------------------------------------------
 
 // How rebuilding from history works
@@ -259,6 +319,12 @@ VisitedLinkMaster::~VisitedLinkMaster() {
     // builder will destroy itself when it finds we are gone.
     table_builder_->DisownMaster();
   }
+  if (table_is_resizing_ && persist_to_disk_ &&
+      (!added_since_rebuild_.empty() || !deleted_since_rebuild_.empty())) {
+    // The table being resized in the background lacks the changes made
+    // meanwhile. Write the current table, which has them, after it.
+    WriteFullTable();
+  }
   FreeURLTable();
   // FreeURLTable() will schedule closing of the file and deletion of |file_|.
   // So nothing should be done here.
@@ -280,6 +346,8 @@ void VisitedLinkMaster::InitMembers() {
   shared_memory_ = NULL;
   shared_memory_serial_ = 0;
   used_items_ = 0;
+  table_is_resizing_ = false;
+  background_resize_threshold_ = kDefaultBackgroundResizeThreshold;
   table_size_override_ = 0;
   suppress_rebuild_ = false;
   sequence_token_ = base::SequencedWorkerPool::GetSequenceToken();
@@ -322,12 +390,13 @@ VisitedLinkMaster::Hash VisitedLinkMaster::TryToAddURL(const GURL& url) {
                                                   salt_);
   // If the table isn't loaded the table will be rebuilt and after
   // that accumulated fingerprints will be applied to the table.
-  if (table_builder_.get() || table_is_loading_from_file_) {
+  if (table_builder_.get() || table_is_loading_from_file_ ||
+      table_is_resizing_) {
     // If we have a pending delete for this fingerprint, cancel it.
     deleted_since_rebuild_.erase(fingerprint);
 
-    // A rebuild or load is in progress, save this addition in the temporary
-    // list so it can be added once rebuild is complete.
+    // A rebuild, load or resize is in progress, save this addition in the
+    // temporary list so it can be added once it is complete.
     added_since_rebuild_.insert(fingerprint);
   }
 
@@ -361,6 +430,7 @@ void VisitedLinkMaster::AddURL(const GURL& url) {
   Hash index = TryToAddURL(url);
   if (!table_builder_.get() &&
       !table_is_loading_from_file_ &&
+      !table_is_resizing_ &&
       index != null_hash_) {
     // Not rebuilding, so we want to keep the file on disk up to date.
     if (persist_to_disk_) {
@@ -376,6 +446,7 @@ void VisitedLinkMaster::AddURLs(const std::vector<GURL>& urls) {
     Hash index = TryToAddURL(url);
     if (!table_builder_.get() &&
         !table_is_loading_from_file_ &&
+        !table_is_resizing_ &&
         index != null_hash_)
       ResizeTableIfNecessary();
   }
@@ -383,6 +454,7 @@ void VisitedLinkMaster::AddURLs(const std::vector<GURL>& urls) {
   // Keeps the file on disk up to date.
   if (!table_builder_.get() &&
       !table_is_loading_from_file_ &&
+      !table_is_resizing_ &&
       persist_to_disk_)
     WriteFullTable();
 }
@@ -396,6 +468,10 @@ void VisitedLinkMaster::DeleteAllURLs() {
   deleted_since_load_.clear();
   table_is_loading_from_file_ = false;
 
+  // The table being built in the background is out of date, drop it when it
+  // is ready.
+  table_is_resizing_ = false;
+
   // Clear the hash table.
   used_items_ = 0;
   memset(hash_table_, 0, this->table_length_ * sizeof(Fingerprint));
@@ -418,9 +494,10 @@ void VisitedLinkMaster::DeleteURLs(URLIterator* urls) {
 
   listener_->Reset(false);
 
-  if (table_builder_.get() || table_is_loading_from_file_) {
-    // A rebuild or load is in progress, save this deletion in the temporary
-    // list so it can be added once rebuild is complete.
+  if (table_builder_.get() || table_is_loading_from_file_ ||
+      table_is_resizing_) {
+    // A rebuild, load or resize is in progress, save this deletion in the
+    // temporary list so it can be applied once it is complete.
     while (urls->HasNextURL()) {
       const GURL& url(urls->NextURL());
       if (!url.is_valid())
@@ -947,6 +1024,7 @@ void VisitedLinkMaster::FreeURLTable() {
 
 bool VisitedLinkMaster::ResizeTableIfNecessary() {
   DCHECK(table_length_ > 0) << "Must have a table";
+  DCHECK(!table_is_resizing_);
 
   // Load limits for good performance/space. We are pretty conservative about
   // keeping the table not very full. This is because we use linear probing
@@ -965,7 +1043,10 @@ bool VisitedLinkMaster::ResizeTableIfNecessary() {
   int new_size = NewTableSizeForCount(used_items_);
   DCHECK(new_size > used_items_);
   DCHECK(load <= min_table_load || new_size > table_length_);
-  ResizeTable(new_size);
+  if (new_size > table_length_ && new_size >= background_resize_threshold_)
+    ResizeTableInBackground(new_size);
+  else
+    ResizeTable(new_size);
   return true;
 }
 
@@ -1008,6 +1089,139 @@ void VisitedLinkMaster::ResizeTable(int32_t new_size) {
     WriteFullTable();
 }
 
+void VisitedLinkMaster::ResizeTableInBackground(int32_t new_size) {
+  DCHECK(shared_memory_ && shared_memory_->memory() && hash_table_);
+  DCHECK(!table_builder_.get() && !table_is_loading_from_file_);
+  shared_memory_serial_++;
+
+  // The current table keeps changing while the new one is built, so the
+  // background thread works on a copy of its fingerprints.
+  scoped_refptr<TableResizeResult> result(
+      new TableResizeResult(shared_memory_serial_, new_size, salt_));
+  result->fingerprints.reserve(used_items_);
+  for (int32_t i = 0; i < table_length_; i++) {
+    if (hash_table_[i])
+      result->fingerprints.push_back(hash_table_[i]);
+  }
+  table_is_resizing_ = true;
+
+  // The file tasks are sequenced, so any write scheduled before is done by
+  // the time the new table is written, and |file_| is open if it exists.
+  TableResizeCompleteCallback callback =
+      base::Bind(&VisitedLinkMaster::OnTableResizeComplete,
+                 weak_ptr_factory_.GetWeakPtr());
+  BrowserThread::GetBlockingPool()->PostSequencedWorkerTask(
+      sequence_token_, FROM_HERE,
+      base::Bind(&VisitedLinkMaster::ResizeApartTable, result,
+                 persist_to_disk_ ? file_ : nullptr, callback));
+}
+
+// static
+void VisitedLinkMaster::ResizeApartTable(
+    scoped_refptr<TableResizeResult> result,
+    FILE** file,
+    const TableResizeCompleteCallback& callback) {
+  Fingerprint* hash_table;
+  if (CreateApartURLTable(result->num_entries, result->salt,
+                          &result->shared_memory, &hash_table)) {
+    // The fingerprints come from a valid table, so they are all distinct and
+    // none of them is null. See AddFingerprint for the probing.
+    for (Fingerprint fingerprint : result->fingerprints) {
+      Hash cur_hash = HashFingerprint(fingerprint, result->num_entries);
+      while (hash_table[cur_hash]) {
+        if (++cur_hash == result->num_entries)
+          cur_hash = 0;
+      }
+      hash_table[cur_hash] = fingerprint;
+    }
+    result->hash_table = hash_table;
+    result->used_count = static_cast<int32_t>(result->fingerprints.size());
+
+    if (file && *file) {
+      result->written_to_file =
+          WriteApartTableToFile(*file, result->num_entries, result->used_count,
+                                result->salt, hash_table);
+    }
+  }
+  Fingerprints().swap(result->fingerprints);
+
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(callback, result));
+}
+
+void VisitedLinkMaster::OnTableResizeComplete(
+    scoped_refptr<TableResizeResult> result) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  // The table has been cleared or replaced since the resize started.
+  if (!table_is_resizing_ || result->serial != shared_memory_serial_)
+    return;
+  table_is_resizing_ = false;
+
+  // The file was not updated during the resize. When the new table has not
+  // been written either, or there are many changes to apply to it, write the
+  // whole table rather than the individual changes.
+  bool bulk_write =
+      !result->written_to_file ||
+      added_since_rebuild_.size() + deleted_since_rebuild_.size() >
+          kBigDeleteThreshold;
+  bool update_file = persist_to_disk_ && !bulk_write;
+
+  if (result->shared_memory) {
+    // Replace the current table with the new one. The changes made meanwhile
+    // are applied again below.
+    delete shared_memory_;
+    shared_memory_ = result->shared_memory.release();
+    hash_table_ = result->hash_table;
+    table_length_ = result->num_entries;
+    used_items_ = result->used_count;
+
+    for (const auto& fingerprint : added_since_rebuild_) {
+      Hash index = AddFingerprint(fingerprint, false);
+      if (update_file && index != null_hash_)
+        WriteHashRangeToFile(index, index);
+    }
+    for (const auto& fingerprint : deleted_since_rebuild_)
+      DeleteFingerprint(fingerprint, update_file);
+    if (update_file)
+      WriteUsedItemCountToFile();
+
+    // Send an update notification to all child processes so they read the new
+    // table. It has the same contents as the current one.
+    listener_->NewTable(shared_memory_);
+  }
+  // Otherwise the current table already has the changes made meanwhile, it
+  // will be grown again on the next addition.
+  added_since_rebuild_.clear();
+  deleted_since_rebuild_.clear();
+
+#ifndef NDEBUG
+  DebugValidate();
+#endif
+
+  if (persist_to_disk_ && (bulk_write || !result->shared_memory))
+    WriteFullTable();
+}
+
+// static
+bool VisitedLinkMaster::WriteApartTableToFile(
+    FILE* file,
+    int32_t num_entries,
+    int32_t used_count,
+    const uint8_t salt[LINK_SALT_LENGTH],
+    const Fingerprint* hash_table) {
+  uint8_t header[kFileHeaderSize];
+  memcpy(&header[kFileHeaderSignatureOffset], &kFileSignature,
+         sizeof(kFileSignature));
+  memcpy(&header[kFileHeaderVersionOffset], &kFileCurrentVersion,
+         sizeof(kFileCurrentVersion));
+  memcpy(&header[kFileHeaderLengthOffset], &num_entries, sizeof(num_entries));
+  memcpy(&header[kFileHeaderUsedOffset], &used_count, sizeof(used_count));
+  memcpy(&header[kFileHeaderSaltOffset], salt, LINK_SALT_LENGTH);
+  return WriteHeaderAndTable(file, header, kFileHeaderSize, hash_table,
+                             num_entries * sizeof(Fingerprint));
+}
+
 uint32_t VisitedLinkMaster::DefaultTableSize() const {
   if (table_size_override_)
     return table_size_override_;
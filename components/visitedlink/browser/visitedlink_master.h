@@ -170,6 +170,7 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, Delete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigDelete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigImport);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BackgroundResize);
 
   // Keeps the result of loading the table from the database file to the UI
   // thread.
@@ -179,6 +180,13 @@ class VisitedLinkMaster : public VisitedLinkCommon {
       bool success,
       scoped_refptr<LoadFromFileResult> load_from_file_result)>;
 
+  // Carries a copy of the fingerprints to the background thread when the table
+  // is resized there, and the resized table back to the UI thread.
+  struct TableResizeResult;
+
+  using TableResizeCompleteCallback =
+      base::Callback<void(scoped_refptr<TableResizeResult> result)>;
+
   // Object to rebuild the table on the history thread (see the .cc file).
   class TableBuilder;
 
@@ -206,6 +214,10 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // we will write the whole table to disk at once instead of individual items.
   static const size_t kBigDeleteThreshold;
 
+  // Growing a table to at least this many entries rehashes it on the
+  // background thread, see ResizeTableInBackground().
+  static const int32_t kDefaultBackgroundResizeThreshold;
+
   // Backend for the constructors initializing the members.
   void InitMembers();
 
@@ -349,6 +361,33 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // current count.
   void ResizeTable(int32_t new_size);
 
+  // Resizes the table like ResizeTable, but rehashes the fingerprints into the
+  // new table and writes it to disk on the background thread, so that growing
+  // a large table does not stall the UI thread. Until the new table is ready,
+  // the current one stays in use and is shared with the child processes: URLs
+  // added or deleted meanwhile are applied to it, and saved in the temporary
+  // lists to be applied to the new table too.
+  void ResizeTableInBackground(int32_t new_size);
+
+  // Builds the resized table described by |result| and writes it to |file| if
+  // it is not null. Calls |callback| on the UI thread when completed. It is
+  // called from the background thread.
+  static void ResizeApartTable(scoped_refptr<TableResizeResult> result,
+                               FILE** file,
+                               const TableResizeCompleteCallback& callback);
+
+  // Replaces the table with the one built by ResizeApartTable. It is called
+  // from the background thread and executed on the UI thread.
+  void OnTableResizeComplete(scoped_refptr<TableResizeResult> result);
+
+  // Writes the file header and the |num_entries| fingerprints of |hash_table|
+  // to |file|, and truncates it after them. Returns true on success.
+  static bool WriteApartTableToFile(FILE* file,
+                                    int32_t num_entries,
+                                    int32_t used_count,
+                                    const uint8_t salt[LINK_SALT_LENGTH],
+                                    const Fingerprint* hash_table);
+
   // Returns the default table size. It can be overrided in unit tests.
   uint32_t DefaultTableSize() const;
 
@@ -410,7 +449,8 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // history query is running. We must only delete it when the query is done.
   scoped_refptr<TableBuilder> table_builder_;
 
-  // Indicates URLs added and deleted since we started rebuilding the table.
+  // Indicates URLs added and deleted since we started rebuilding the table,
+  // or resizing it in the background.
   std::set<Fingerprint> added_since_rebuild_;
   std::set<Fingerprint> deleted_since_rebuild_;
 
@@ -447,6 +487,13 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // We set this to true to avoid writing to the database file.
   bool table_is_loading_from_file_;
 
+  // True while a resized table is being built on the background thread. The
+  // database file is not written to meanwhile, the new table replaces it.
+  bool table_is_resizing_;
+
+  // Growing the table to at least this many entries is done in the background.
+  int32_t background_resize_threshold_;
+
   // Testing values -----------------------------------------------------------
   //
   // The following fields exist for testing purposes. They are not used in
@@ -421,6 +421,71 @@ TEST_F(VisitedLinkTest, Resizing) {
   Reload();
 }
 
+// Tests that a table resized in the background stays usable by the slaves
+// until the new one is ready, and that the changes made meanwhile make it to
+// the new table and to the disk.
+TEST_F(VisitedLinkTest, BackgroundResize) {
+  const int32_t initial_size = 17;
+  ASSERT_TRUE(InitVisited(initial_size, true, true));
+  master_->background_resize_threshold_ = 0;
+
+  VisitedLinkSlave slave;
+  base::SharedMemoryHandle new_handle = base::SharedMemory::NULLHandle();
+  master_->shared_memory()->ShareToProcess(
+      base::GetCurrentProcessHandle(), &new_handle);
+  slave.OnUpdateVisitedLinks(new_handle);
+  g_slaves.push_back(&slave);
+
+  // Half filling the table starts the resize.
+  const int kInitialCount = initial_size / 2 + 1;
+  for (int i = 0; i < kInitialCount; i++)
+    master_->AddURL(TestURL(i));
+  EXPECT_TRUE(master_->table_is_resizing_);
+
+  // Change the table while the new one is being built.
+  const int kTotalCount = kInitialCount + 3;
+  for (int i = kInitialCount; i < kTotalCount; i++)
+    master_->AddURL(TestURL(i));
+  URLs urls_to_delete;
+  urls_to_delete.push_back(TestURL(0));
+  TestURLIterator iterator(urls_to_delete);
+  master_->DeleteURLs(&iterator);
+
+  int32_t table_size;
+  VisitedLinkCommon::Fingerprint* table;
+  master_->GetUsageStatistics(&table_size, &table);
+  EXPECT_EQ(initial_size, table_size);
+  EXPECT_FALSE(slave.IsVisited(TestURL(0)));
+  for (int i = 1; i < kTotalCount; i++)
+    EXPECT_TRUE(slave.IsVisited(TestURL(i)));
+
+  // Wait for the new table.
+  content::RunAllBlockingPoolTasksUntilIdle();
+  EXPECT_FALSE(master_->table_is_resizing_);
+  master_->GetUsageStatistics(&table_size, &table);
+  EXPECT_GT(table_size, initial_size);
+  EXPECT_EQ(kTotalCount - 1, master_->GetUsedCount());
+  master_->DebugValidate();
+
+  int32_t child_table_size;
+  VisitedLinkCommon::Fingerprint* child_table;
+  slave.GetUsageStatistics(&child_table_size, &child_table);
+  ASSERT_EQ(table_size, child_table_size);
+  EXPECT_FALSE(slave.IsVisited(TestURL(0)));
+  for (int i = 1; i < kTotalCount; i++)
+    EXPECT_TRUE(slave.IsVisited(TestURL(i)));
+  g_slaves.clear();
+
+  // Check that the file has the new table with the changes.
+  ClearDB();
+  ASSERT_TRUE(InitVisited(0, true, true));
+  master_->DebugValidate();
+  EXPECT_EQ(kTotalCount - 1, master_->GetUsedCount());
+  EXPECT_FALSE(master_->IsVisited(TestURL(0)));
+  for (int i = 1; i < kTotalCount; i++)
+    EXPECT_TRUE(master_->IsVisited(TestURL(i)));
+}
+
 // Tests that if the database doesn't exist, it will be rebuilt from history.
 TEST_F(VisitedLinkTest, Rebuild) {
   // Add half of our URLs to history. This needs to be done before we
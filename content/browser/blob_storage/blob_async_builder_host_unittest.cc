@@ -76,6 +76,8 @@ class BlobAsyncBuilderHostTest : public testing::Test {
     request_called_ = false;
     requests_.clear();
     memory_handles_.clear();
+    request_batches_.clear();
+    memory_handle_batches_.clear();
     host_.SetMemoryConstantsForTesting(kTestBlobStorageIPCThresholdBytes,
                                        kTestBlobStorageMaxSharedMemoryBytes,
                                        kTestBlobStorageMaxFileSizeBytes);
@@ -92,6 +94,8 @@ class BlobAsyncBuilderHostTest : public testing::Test {
       std::unique_ptr<std::vector<base::File>> files) {
     requests_ = std::move(*requests);
     memory_handles_ = std::move(*shared_memory_handles);
+    request_batches_.push_back(requests_);
+    memory_handle_batches_.push_back(memory_handles_);
     request_called_ = true;
   }
 
@@ -128,6 +132,9 @@ class BlobAsyncBuilderHostTest : public testing::Test {
   bool request_called_;
   std::vector<storage::BlobItemBytesRequest> requests_;
   std::vector<base::SharedMemoryHandle> memory_handles_;
+  // All the requests made, one entry per call to RequestMemoryCallback.
+  std::vector<std::vector<storage::BlobItemBytesRequest>> request_batches_;
+  std::vector<std::vector<base::SharedMemoryHandle>> memory_handle_batches_;
   std::set<std::string> completed_blob_uuid_set_;
 
   std::unique_ptr<BlobDataHandle> completed_blob_handle_;
@@ -200,64 +207,76 @@ TEST_F(BlobAsyncBuilderHostTest, TestSingleSharedMemRequest) {
 
 TEST_F(BlobAsyncBuilderHostTest, TestMultipleSharedMemRequests) {
   std::vector<DataElement> descriptions;
-  const size_t kSize = kTestBlobStorageMaxSharedMemoryBytes + 1;
+  const size_t kSize = 2 * kTestBlobStorageMaxSharedMemoryBytes + 1;
   const char kFirstBlockByte = 7;
   const char kSecondBlockByte = 19;
+  const char kThirdBlockByte = 23;
   AddMemoryItem(kSize, &descriptions);
 
   BlobDataBuilder expected(kBlobUUID);
   expected.set_content_type(kContentType);
   expected.set_content_disposition(kContentDisposition);
-  char data[kSize];
+  char data[kTestBlobStorageMaxSharedMemoryBytes];
   memset(data, kFirstBlockByte, kTestBlobStorageMaxSharedMemoryBytes);
   expected.AppendData(data, kTestBlobStorageMaxSharedMemoryBytes);
-  expected.AppendData(&kSecondBlockByte, 1);
+  memset(data, kSecondBlockByte, kTestBlobStorageMaxSharedMemoryBytes);
+  expected.AppendData(data, kTestBlobStorageMaxSharedMemoryBytes);
+  expected.AppendData(&kThirdBlockByte, 1);
 
   EXPECT_EQ(BlobTransportResult::PENDING_RESPONSES,
-            BuildBlobAsync(descriptions, std::set<std::string>(),
-                           kTestBlobStorageMaxSharedMemoryBytes + 1));
+            BuildBlobAsync(descriptions, std::set<std::string>(), kSize));
 
-  EXPECT_TRUE(request_called_);
+  // The first two blocks are requested right away, each with its own handle.
   EXPECT_EQ(1u, host_.blob_building_count());
-  ASSERT_EQ(1u, requests_.size());
-  request_called_ = false;
-
-  // We need to grab a duplicate handle so we can have two blocks open at the
-  // same time.
-  base::SharedMemoryHandle handle =
-      base::SharedMemory::DuplicateHandle(memory_handles_.at(0));
-  EXPECT_TRUE(base::SharedMemory::IsHandleValid(handle));
-  base::SharedMemory shared_memory(handle, false);
-  EXPECT_TRUE(shared_memory.Map(kTestBlobStorageMaxSharedMemoryBytes));
-
+  ASSERT_EQ(2u, request_batches_.size());
+  ASSERT_EQ(1u, request_batches_[0].size());
+  ASSERT_EQ(1u, request_batches_[1].size());
   EXPECT_EQ(BlobItemBytesRequest::CreateSharedMemoryRequest(
                 0, 0, 0, kTestBlobStorageMaxSharedMemoryBytes, 0, 0),
-            requests_.at(0));
+            request_batches_[0][0]);
+  EXPECT_EQ(BlobItemBytesRequest::CreateSharedMemoryRequest(
+                1, 0, kTestBlobStorageMaxSharedMemoryBytes,
+                kTestBlobStorageMaxSharedMemoryBytes, 0, 0),
+            request_batches_[1][0]);
+  ASSERT_EQ(1u, memory_handle_batches_[0].size());
+  ASSERT_EQ(1u, memory_handle_batches_[1].size());
 
-  memset(shared_memory.memory(), kFirstBlockByte,
+  // We need to grab duplicate handles so we can have both blocks open at the
+  // same time.
+  base::SharedMemory first_shared_memory(
+      base::SharedMemory::DuplicateHandle(memory_handle_batches_[0][0]),
+      false);
+  EXPECT_TRUE(first_shared_memory.Map(kTestBlobStorageMaxSharedMemoryBytes));
+  memset(first_shared_memory.memory(), kFirstBlockByte,
+         kTestBlobStorageMaxSharedMemoryBytes);
+  base::SharedMemory second_shared_memory(
+      base::SharedMemory::DuplicateHandle(memory_handle_batches_[1][0]),
+      false);
+  EXPECT_TRUE(second_shared_memory.Map(kTestBlobStorageMaxSharedMemoryBytes));
+  memset(second_shared_memory.memory(), kSecondBlockByte,
          kTestBlobStorageMaxSharedMemoryBytes);
 
-  BlobItemBytesResponse response(0);
-  std::vector<BlobItemBytesResponse> responses = {response};
+  // The responses can come back in any order. Once the second block is
+  // copied, its memory is reused for the third.
+  std::vector<BlobItemBytesResponse> responses = {BlobItemBytesResponse(1)};
   EXPECT_EQ(BlobTransportResult::PENDING_RESPONSES,
             host_.OnMemoryResponses(kBlobUUID, responses, &context_));
-
-  EXPECT_TRUE(request_called_);
-  EXPECT_EQ(1u, host_.blob_building_count());
-  ASSERT_EQ(1u, requests_.size());
-  request_called_ = false;
-
+  ASSERT_EQ(3u, request_batches_.size());
+  ASSERT_EQ(1u, request_batches_[2].size());
   EXPECT_EQ(BlobItemBytesRequest::CreateSharedMemoryRequest(
-                1, 0, kTestBlobStorageMaxSharedMemoryBytes, 1, 0, 0),
-            requests_.at(0));
+                2, 0, 2 * kTestBlobStorageMaxSharedMemoryBytes, 1, 0, 0),
+            request_batches_[2][0]);
+  memset(second_shared_memory.memory(), kThirdBlockByte, 1);
 
-  memset(shared_memory.memory(), kSecondBlockByte, 1);
+  responses[0] = BlobItemBytesResponse(0);
+  EXPECT_EQ(BlobTransportResult::PENDING_RESPONSES,
+            host_.OnMemoryResponses(kBlobUUID, responses, &context_));
+  EXPECT_EQ(3u, request_batches_.size());
 
-  response.request_number = 1;
-  responses[0] = response;
+  responses[0] = BlobItemBytesResponse(2);
   EXPECT_EQ(BlobTransportResult::DONE,
             host_.OnMemoryResponses(kBlobUUID, responses, &context_));
-  EXPECT_FALSE(request_called_);
+  EXPECT_EQ(3u, request_batches_.size());
   EXPECT_EQ(0u, host_.blob_building_count());
   std::unique_ptr<BlobDataHandle> blob_handle =
       context_.GetBlobDataFromUUID(kBlobUUID);
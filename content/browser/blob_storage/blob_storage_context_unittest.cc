@@ -12,9 +12,12 @@
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
 #include "content/browser/blob_storage/blob_dispatcher_host.h"
 #include "content/browser/blob_storage/chrome_blob_storage_context.h"
@@ -202,6 +205,58 @@ TEST_F(BlobStorageContextTest, MemoryUsage) {
   EXPECT_EQ(0u, context_.registry().blob_count());
 }
 
+TEST_F(BlobStorageContextTest, PageToDisk) {
+  const std::string kId1("id1");
+  const std::string kId2("id2");
+  const std::string kData1(kBlobStorageMinPagedItemBytes, 'a');
+  const std::string kData2(kBlobStorageMinPagedItemBytes, 'b');
+
+  base::MessageLoop fake_io_message_loop;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath paging_dir = temp_dir.path().AppendASCII("paging");
+  context_.EnablePaging(paging_dir, base::ThreadTaskRunnerHandle::Get(),
+                        kData1.size() + kData2.size());
+
+  BlobDataBuilder builder1(kId1);
+  builder1.AppendData(kData1);
+  builder1.AppendData("small");
+  std::unique_ptr<BlobDataHandle> blob_data_handle1 =
+      context_.AddFinishedBlob(&builder1);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kData1.size() + 5, context_.memory_usage());
+
+  // Going over the budget pages the older blob, but not its small item.
+  BlobDataBuilder builder2(kId2);
+  builder2.AppendData(kData2);
+  std::unique_ptr<BlobDataHandle> blob_data_handle2 =
+      context_.AddFinishedBlob(&builder2);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kData2.size() + 5, context_.memory_usage());
+
+  std::unique_ptr<BlobDataSnapshot> snapshot =
+      blob_data_handle1->CreateSnapshot();
+  ASSERT_EQ(2u, snapshot->items().size());
+  const BlobDataItem& paged_item = *snapshot->items()[0];
+  ASSERT_EQ(DataElement::TYPE_FILE, paged_item.type());
+  EXPECT_EQ(kData1.size(), paged_item.length());
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(paged_item.path(), &contents));
+  EXPECT_EQ(kData1, contents);
+  EXPECT_EQ(DataElement::TYPE_BYTES, snapshot->items()[1]->type());
+
+  base::FilePath paged_file = paged_item.path();
+  snapshot.reset();
+  blob_data_handle1.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kData2.size(), context_.memory_usage());
+  EXPECT_FALSE(base::PathExists(paged_file));
+
+  blob_data_handle2.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0lu, context_.memory_usage());
+}
+
 TEST_F(BlobStorageContextTest, AddFinishedBlob) {
   const std::string kId1("id1");
   const std::string kId2("id12");
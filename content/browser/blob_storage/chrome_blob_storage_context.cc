@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/files/file_path.h"
 #include "base/guid.h"
 #include "content/public/browser/blob_handle.h"
 #include "content/public/browser/browser_context.h"
@@ -14,6 +15,7 @@
 #include "storage/browser/blob/blob_data_builder.h"
 #include "storage/browser/blob/blob_data_handle.h"
 #include "storage/browser/blob/blob_storage_context.h"
+#include "storage/common/blob_storage/blob_storage_constants.h"
 
 using base::UserDataAdapter;
 using storage::BlobStorageContext;
@@ -23,6 +25,8 @@ namespace content {
 namespace {
 
 const char kBlobStorageContextKeyName[] = "content_blob_storage_context";
+const base::FilePath::CharType kBlobStorageDirectoryName[] =
+    FILE_PATH_LITERAL("blob_storage");
 
 class BlobHandleImpl : public BlobHandle {
  public:
@@ -49,11 +53,16 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
     context->SetUserData(
         kBlobStorageContextKeyName,
         new UserDataAdapter<ChromeBlobStorageContext>(blob.get()));
+    // Blobs of incognito profiles stay in memory.
+    base::FilePath blob_storage_dir;
+    if (!context->IsOffTheRecord())
+      blob_storage_dir = context->GetPath().Append(kBlobStorageDirectoryName);
     // Check first to avoid memory leak in unittests.
     if (BrowserThread::IsMessageLoopValid(BrowserThread::IO)) {
       BrowserThread::PostTask(
           BrowserThread::IO, FROM_HERE,
-          base::Bind(&ChromeBlobStorageContext::InitializeOnIOThread, blob));
+          base::Bind(&ChromeBlobStorageContext::InitializeOnIOThread, blob,
+                     blob_storage_dir));
     }
   }
 
@@ -61,9 +70,16 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
       context, kBlobStorageContextKeyName);
 }
 
-void ChromeBlobStorageContext::InitializeOnIOThread() {
+void ChromeBlobStorageContext::InitializeOnIOThread(
+    const base::FilePath& blob_storage_dir) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   context_.reset(new BlobStorageContext());
+  if (!blob_storage_dir.empty()) {
+    context_->EnablePaging(
+        blob_storage_dir,
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE),
+        storage::kBlobStorageInMemoryBudget);
+  }
 }
 
 std::unique_ptr<BlobHandle> ChromeBlobStorageContext::CreateMemoryBackedBlob(
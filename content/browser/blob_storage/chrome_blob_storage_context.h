@@ -44,7 +44,8 @@ class CONTENT_EXPORT ChromeBlobStorageContext
   static ChromeBlobStorageContext* GetFor(
       BrowserContext* browser_context);
 
-  void InitializeOnIOThread();
+  // Blobs are paged to |blob_storage_dir| unless it is empty.
+  void InitializeOnIOThread(const base::FilePath& blob_storage_dir);
 
   storage::BlobStorageContext* context() const { return context_.get(); }
 
@@ -4,6 +4,8 @@
 
 #include "content/browser/browser_child_process_host_impl.h"
 
+#include <utility>
+
 #include "base/base_switches.h"
 #include "base/bind.h"
 #include "base/command_line.h"
@@ -13,9 +15,14 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/shared_memory_handle.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/metrics/persistent_memory_allocator.h"
 #include "base/stl_util.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -236,6 +243,8 @@ void BrowserChildProcessHostImpl::Launch(
   cmd_line->CopySwitchesFrom(browser_command_line, kForwardSwitches,
                              arraysize(kForwardSwitches));
 
+  CreateMetricsAllocator();
+
   notify_child_disconnected_ = true;
   child_process_.reset(new ChildProcessLauncher(
       delegate,
@@ -283,6 +292,12 @@ ServiceRegistry* BrowserChildProcessHostImpl::GetServiceRegistry() {
   return delegate_->GetServiceRegistry();
 }
 
+std::unique_ptr<base::SharedPersistentMemoryAllocator>
+BrowserChildProcessHostImpl::TakeMetricsAllocator() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  return std::move(metrics_allocator_);
+}
+
 void BrowserChildProcessHostImpl::ForceShutdown() {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   g_child_process_list.Get().remove(this);
@@ -461,6 +476,10 @@ void BrowserChildProcessHostImpl::OnProcessLaunched() {
   data_.handle = process.Handle();
   delegate_->OnProcessLaunched();
 
+  // Share the histogram memory before any histogram the child process records
+  // would be reported over IPC.
+  ShareMetricsAllocatorToProcess();
+
   if (is_channel_connected_) {
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
                             base::Bind(&NotifyProcessLaunchedAndConnected,
@@ -468,6 +487,65 @@ void BrowserChildProcessHostImpl::OnProcessLaunched() {
   }
 }
 
+void BrowserChildProcessHostImpl::CreateMetricsAllocator() {
+  DCHECK(!metrics_allocator_);
+
+  // Create a persistent memory segment for subprocess histograms only if
+  // they're active in the browser.
+  if (!base::GlobalHistogramAllocator::Get())
+    return;
+
+  // Name the segment after the process type. These processes record few
+  // histograms so a small segment is enough for all of them.
+  const size_t kMemorySize = 64 << 10;  // 64 KiB
+  base::StringPiece metrics_name;
+  switch (data_.process_type) {
+    case PROCESS_TYPE_UTILITY:
+      metrics_name = "UtilityMetrics";
+      break;
+    case PROCESS_TYPE_ZYGOTE:
+      metrics_name = "ZygoteMetrics";
+      break;
+    case PROCESS_TYPE_SANDBOX_HELPER:
+      metrics_name = "SandboxHelperMetrics";
+      break;
+    case PROCESS_TYPE_GPU:
+      metrics_name = "GpuMetrics";
+      break;
+    case PROCESS_TYPE_PPAPI_PLUGIN:
+      metrics_name = "PpapiPluginMetrics";
+      break;
+    case PROCESS_TYPE_PPAPI_BROKER:
+      metrics_name = "PpapiBrokerMetrics";
+      break;
+    default:
+      // Embedder-defined process types keep reporting their histograms over
+      // IPC.
+      return;
+  }
+
+  // Create the shared memory segment and attach an allocator to it.
+  // Mapping the memory shouldn't fail but be safe if it does; everything
+  // will continue to work but just as if persistence weren't available.
+  std::unique_ptr<base::SharedMemory> shm(new base::SharedMemory());
+  if (!shm->CreateAndMapAnonymous(kMemorySize))
+    return;
+  metrics_allocator_.reset(new base::SharedPersistentMemoryAllocator(
+      std::move(shm), static_cast<uint64_t>(data_.id), metrics_name,
+      /*readonly=*/false));
+}
+
+void BrowserChildProcessHostImpl::ShareMetricsAllocatorToProcess() {
+  if (!metrics_allocator_)
+    return;
+
+  base::SharedMemoryHandle shm_handle;
+  metrics_allocator_->shared_memory()->ShareToProcess(data_.handle,
+                                                      &shm_handle);
+  Send(new ChildProcessMsg_SetHistogramMemory(
+      shm_handle, metrics_allocator_->shared_memory()->mapped_size()));
+}
+
 bool BrowserChildProcessHostImpl::IsProcessLaunched() const {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
@@ -29,6 +29,7 @@
 
 namespace base {
 class CommandLine;
+class SharedPersistentMemoryAllocator;
 }
 
 namespace content {
@@ -75,6 +76,8 @@ class CONTENT_EXPORT BrowserChildProcessHostImpl
   void SetName(const base::string16& name) override;
   void SetHandle(base::ProcessHandle handle) override;
   ServiceRegistry* GetServiceRegistry() override;
+  std::unique_ptr<base::SharedPersistentMemoryAllocator> TakeMetricsAllocator()
+      override;
 
   // ChildProcessHostDelegate implementation:
   bool CanShutdown() override;
@@ -120,6 +123,14 @@ class CONTENT_EXPORT BrowserChildProcessHostImpl
   // on the IO thread.
   bool IsProcessLaunched() const;
 
+  // Creates the shared memory segment in which the child process stores its
+  // histograms, if histograms are persisted in the browser.
+  void CreateMetricsAllocator();
+
+  // Passes the segment created by CreateMetricsAllocator() to the launched
+  // child process.
+  void ShareMetricsAllocatorToProcess();
+
   static void OnMojoError(
       base::WeakPtr<BrowserChildProcessHostImpl> process,
       scoped_refptr<base::SingleThreadTaskRunner> task_runner,
@@ -139,6 +150,9 @@ class CONTENT_EXPORT BrowserChildProcessHostImpl
 
   PowerMonitorMessageBroadcaster power_monitor_message_broadcaster_;
 
+  // The memory allocator, if any, in which the process will write its metrics.
+  std::unique_ptr<base::SharedPersistentMemoryAllocator> metrics_allocator_;
+
 #if defined(OS_WIN)
   // Watches to see if the child process exits before the IPC channel has
   // been connected. Thereafter, its exit is determined by an error on the
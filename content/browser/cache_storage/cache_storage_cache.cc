@@ -5,6 +5,7 @@
 #include "content/browser/cache_storage/cache_storage_cache.h"
 
 #include <stddef.h>
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -141,6 +142,13 @@ bool VaryMatches(const ServiceWorkerHeaderMap& request,
   return true;
 }
 
+void DidReadOneOfAllMetadata(std::unique_ptr<CacheMetadata>* out_metadata,
+                             const base::Closure& barrier_closure,
+                             std::unique_ptr<CacheMetadata> metadata) {
+  *out_metadata = std::move(metadata);
+  barrier_closure.Run();
+}
+
 GURL RemoveQueryParam(const GURL& url) {
   url::Replacements<char> replacements;
   replacements.ClearQuery();
@@ -200,6 +208,10 @@ struct CacheStorageCache::OpenAllEntriesContext {
   // The vector of open entries in the backend.
   Entries entries;
 
+  // The metadata of each entry in |entries|, filled in by ReadAllMetadata().
+  // Null if it couldn't be read.
+  std::vector<std::unique_ptr<CacheMetadata>> metadata;
+
   // Used for enumerating cache entries.
   std::unique_ptr<disk_cache::Backend::Iterator> backend_iterator;
   disk_cache::Entry* enumerated_entry;
@@ -584,6 +596,19 @@ void CacheStorageCache::DidOpenNextEntry(
     open_entry_callback.Run(rv);
 }
 
+void CacheStorageCache::ReadAllMetadata(
+    OpenAllEntriesContext* entries_context,
+    const base::Closure& callback) {
+  size_t num_entries = entries_context->entries.size();
+  entries_context->metadata.resize(num_entries);
+  base::Closure barrier_closure = base::BarrierClosure(num_entries, callback);
+  for (size_t i = 0; i < num_entries; ++i) {
+    ReadMetadata(entries_context->entries[i],
+                 base::Bind(&DidReadOneOfAllMetadata,
+                            &entries_context->metadata[i], barrier_closure));
+  }
+}
+
 void CacheStorageCache::MatchImpl(
     std::unique_ptr<ServiceWorkerFetchRequest> request,
     const ResponseCallback& callback) {
@@ -707,73 +732,70 @@ void CacheStorageCache::MatchAllDidOpenAllEntries(
   }
 
   context->entries_context.swap(entries_context);
-  Entries::iterator iter = context->entries_context->entries.begin();
-  MatchAllProcessNextEntry(std::move(context), iter);
-}
-
-void CacheStorageCache::MatchAllProcessNextEntry(
-    std::unique_ptr<MatchAllContext> context,
-    const Entries::iterator& iter) {
-  if (iter == context->entries_context->entries.end()) {
-    // All done. Return all of the responses.
-    context->original_callback.Run(CACHE_STORAGE_OK,
-                                   std::move(context->out_responses),
-                                   std::move(context->out_blob_data_handles));
-    return;
-  }
+  Entries& entries = context->entries_context->entries;
 
   if (context->options.ignore_search) {
+    // Drop the entries that can't match before reading any data.
     DCHECK(context->request);
-    disk_cache::Entry* entry(*iter);
-    if (RemoveQueryParam(context->request->url) !=
-        RemoveQueryParam(GURL(entry->GetKey()))) {
-      // In this case, we don't need to read data.
-      MatchAllProcessNextEntry(std::move(context), iter + 1);
-      return;
+    GURL request_url_without_query = RemoveQueryParam(context->request->url);
+    Entries::iterator matches_end = std::stable_partition(
+        entries.begin(), entries.end(),
+        [&request_url_without_query](disk_cache::Entry* entry) {
+          return RemoveQueryParam(GURL(entry->GetKey())) ==
+                 request_url_without_query;
+        });
+    for (Entries::iterator iter = matches_end; iter != entries.end(); ++iter)
+      (*iter)->Close();
+    entries.erase(matches_end, entries.end());
+  }
+
+  OpenAllEntriesContext* entries_context_ptr = context->entries_context.get();
+  ReadAllMetadata(entries_context_ptr,
+                  base::Bind(&CacheStorageCache::MatchAllDidReadAllMetadata,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             base::Passed(std::move(context))));
+}
+
+void CacheStorageCache::MatchAllDidReadAllMetadata(
+    std::unique_ptr<MatchAllContext> context) {
+  OpenAllEntriesContext* entries_context = context->entries_context.get();
+  for (size_t i = 0; i < entries_context->entries.size(); ++i) {
+    // Move ownership of the entry from the context.
+    disk_cache::ScopedEntryPtr entry(entries_context->entries[i]);
+    entries_context->entries[i] = nullptr;
+    const CacheMetadata* metadata = entries_context->metadata[i].get();
+
+    if (!metadata) {
+      entry->Doom();
+      continue;
     }
-  }
 
-  ReadMetadata(*iter, base::Bind(&CacheStorageCache::MatchAllDidReadMetadata,
-                                 weak_ptr_factory_.GetWeakPtr(),
-                                 base::Passed(std::move(context)), iter));
-}
+    ServiceWorkerResponse response;
+    PopulateResponseMetadata(*metadata, &response);
 
-void CacheStorageCache::MatchAllDidReadMetadata(
-    std::unique_ptr<MatchAllContext> context,
-    const Entries::iterator& iter,
-    std::unique_ptr<CacheMetadata> metadata) {
-  // Move ownership of the entry from the context.
-  disk_cache::ScopedEntryPtr entry(*iter);
-  *iter = nullptr;
+    if (entry->GetDataSize(INDEX_RESPONSE_BODY) == 0) {
+      context->out_responses->push_back(response);
+      continue;
+    }
 
-  if (!metadata) {
-    entry->Doom();
-    MatchAllProcessNextEntry(std::move(context), iter + 1);
-    return;
-  }
+    if (!blob_storage_context_) {
+      context->original_callback.Run(CACHE_STORAGE_ERROR_STORAGE,
+                                     std::unique_ptr<Responses>(),
+                                     std::unique_ptr<BlobDataHandles>());
+      return;
+    }
 
-  ServiceWorkerResponse response;
-  PopulateResponseMetadata(*metadata, &response);
+    std::unique_ptr<storage::BlobDataHandle> blob_data_handle =
+        PopulateResponseBody(std::move(entry), &response);
 
-  if (entry->GetDataSize(INDEX_RESPONSE_BODY) == 0) {
     context->out_responses->push_back(response);
-    MatchAllProcessNextEntry(std::move(context), iter + 1);
-    return;
-  }
-
-  if (!blob_storage_context_) {
-    context->original_callback.Run(CACHE_STORAGE_ERROR_STORAGE,
-                                   std::unique_ptr<Responses>(),
-                                   std::unique_ptr<BlobDataHandles>());
-    return;
+    context->out_blob_data_handles->push_back(*blob_data_handle);
   }
 
-  std::unique_ptr<storage::BlobDataHandle> blob_data_handle =
-      PopulateResponseBody(std::move(entry), &response);
-
-  context->out_responses->push_back(response);
-  context->out_blob_data_handles->push_back(*blob_data_handle);
-  MatchAllProcessNextEntry(std::move(context), iter + 1);
+  // All done. Return all of the responses.
+  context->original_callback.Run(CACHE_STORAGE_OK,
+                                 std::move(context->out_responses),
+                                 std::move(context->out_blob_data_handles));
 }
 
 void CacheStorageCache::WriteSideDataImpl(const ErrorCallback& callback,
@@ -1293,32 +1315,26 @@ void CacheStorageCache::KeysDidOpenAllEntries(
 
   std::unique_ptr<KeysContext> keys_context(new KeysContext(callback));
   keys_context->entries_context.swap(entries_context);
-  Entries::iterator iter = keys_context->entries_context->entries.begin();
-  KeysProcessNextEntry(std::move(keys_context), iter);
-}
-
-void CacheStorageCache::KeysProcessNextEntry(
-    std::unique_ptr<KeysContext> keys_context,
-    const Entries::iterator& iter) {
-  if (iter == keys_context->entries_context->entries.end()) {
-    // All done. Return all of the keys.
-    keys_context->original_callback.Run(CACHE_STORAGE_OK,
-                                        std::move(keys_context->out_keys));
-    return;
-  }
-
-  ReadMetadata(*iter, base::Bind(&CacheStorageCache::KeysDidReadMetadata,
-                                 weak_ptr_factory_.GetWeakPtr(),
-                                 base::Passed(std::move(keys_context)), iter));
-}
-
-void CacheStorageCache::KeysDidReadMetadata(
-    std::unique_ptr<KeysContext> keys_context,
-    const Entries::iterator& iter,
-    std::unique_ptr<CacheMetadata> metadata) {
-  disk_cache::Entry* entry = *iter;
+  OpenAllEntriesContext* entries_context_ptr =
+      keys_context->entries_context.get();
+  ReadAllMetadata(entries_context_ptr,
+                  base::Bind(&CacheStorageCache::KeysDidReadAllMetadata,
+                             weak_ptr_factory_.GetWeakPtr(),
+                             base::Passed(std::move(keys_context))));
+}
+
+void CacheStorageCache::KeysDidReadAllMetadata(
+    std::unique_ptr<KeysContext> keys_context) {
+  OpenAllEntriesContext* entries_context = keys_context->entries_context.get();
+  for (size_t i = 0; i < entries_context->entries.size(); ++i) {
+    disk_cache::Entry* entry = entries_context->entries[i];
+    const CacheMetadata* metadata = entries_context->metadata[i].get();
+
+    if (!metadata) {
+      entry->Doom();
+      continue;
+    }
 
-  if (metadata) {
     keys_context->out_keys->push_back(ServiceWorkerFetchRequest(
         GURL(entry->GetKey()), metadata->request().method(),
         ServiceWorkerHeaderMap(), Referrer(), false));
@@ -1326,17 +1342,17 @@ void CacheStorageCache::KeysDidReadMetadata(
     ServiceWorkerHeaderMap& req_headers =
         keys_context->out_keys->back().headers;
 
-    for (int i = 0; i < metadata->request().headers_size(); ++i) {
-      const CacheHeaderMap header = metadata->request().headers(i);
+    for (int j = 0; j < metadata->request().headers_size(); ++j) {
+      const CacheHeaderMap header = metadata->request().headers(j);
       DCHECK_EQ(std::string::npos, header.name().find('\0'));
       DCHECK_EQ(std::string::npos, header.value().find('\0'));
       req_headers.insert(std::make_pair(header.name(), header.value()));
     }
-  } else {
-    entry->Doom();
   }
 
-  KeysProcessNextEntry(std::move(keys_context), iter + 1);
+  // All done. Return all of the keys.
+  keys_context->original_callback.Run(CACHE_STORAGE_OK,
+                                      std::move(keys_context->out_keys));
 }
 
 void CacheStorageCache::CloseImpl(const base::Closure& callback) {
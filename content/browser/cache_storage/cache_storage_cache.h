@@ -188,6 +188,13 @@ class CONTENT_EXPORT CacheStorageCache
                         const OpenAllEntriesCallback& callback,
                         int rv);
 
+  // Reads the metadata of every entry in |entries_context| into its
+  // |metadata| and then runs |callback|. The reads are all started at once so
+  // that the backend can overlap them. |callback| should own
+  // |entries_context|, which keeps it alive until the reads are done.
+  void ReadAllMetadata(OpenAllEntriesContext* entries_context,
+                       const base::Closure& callback);
+
   // Match callbacks
   void MatchImpl(std::unique_ptr<ServiceWorkerFetchRequest> request,
                  const ResponseCallback& callback);
@@ -206,11 +213,7 @@ class CONTENT_EXPORT CacheStorageCache
       std::unique_ptr<MatchAllContext> context,
       std::unique_ptr<OpenAllEntriesContext> entries_context,
       CacheStorageError error);
-  void MatchAllProcessNextEntry(std::unique_ptr<MatchAllContext> context,
-                                const Entries::iterator& iter);
-  void MatchAllDidReadMetadata(std::unique_ptr<MatchAllContext> context,
-                               const Entries::iterator& iter,
-                               std::unique_ptr<CacheMetadata> metadata);
+  void MatchAllDidReadAllMetadata(std::unique_ptr<MatchAllContext> context);
 
   // WriteSideData callbacks
   void WriteSideDataImpl(const ErrorCallback& callback,
@@ -295,11 +298,7 @@ class CONTENT_EXPORT CacheStorageCache
       const RequestsCallback& callback,
       std::unique_ptr<OpenAllEntriesContext> entries_context,
       CacheStorageError error);
-  void KeysProcessNextEntry(std::unique_ptr<KeysContext> keys_context,
-                            const Entries::iterator& iter);
-  void KeysDidReadMetadata(std::unique_ptr<KeysContext> keys_context,
-                           const Entries::iterator& iter,
-                           std::unique_ptr<CacheMetadata> metadata);
+  void KeysDidReadAllMetadata(std::unique_ptr<KeysContext> keys_context);
 
   void CloseImpl(const base::Closure& callback);
 
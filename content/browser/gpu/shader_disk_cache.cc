@@ -4,8 +4,14 @@
 
 #include "content/browser/gpu/shader_disk_cache.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "base/macros.h"
 #include "base/threading/thread_checker.h"
+#include "base/time/time.h"
 #include "content/browser/gpu/gpu_process_host.h"
 #include "content/public/browser/browser_thread.h"
 #include "gpu/command_buffer/common/constants.h"
@@ -68,7 +74,10 @@ class ShaderDiskCacheEntry
 };
 
 // ShaderDiskReadHelper is used to load all of the cached shaders from the
-// disk cache and send to the memory cache.
+// disk cache and send to the memory cache. The shaders are sent in the order
+// they were last used, so the most recently used programs are the most recent
+// in the memory cache too, and are the last to be evicted when it is smaller
+// than the disk cache.
 class ShaderDiskReadHelper
     : public base::ThreadChecker,
       public base::RefCounted<ShaderDiskReadHelper> {
@@ -97,12 +106,20 @@ class ShaderDiskReadHelper
   int ReadComplete(int rv);
   int IterationComplete(int rv);
 
+  struct CachedShader {
+    std::string key;
+    std::string data;
+    base::Time last_used;
+  };
+
   base::WeakPtr<ShaderDiskCache> cache_;
   OpType op_type_;
   std::unique_ptr<disk_cache::Backend::Iterator> iter_;
   scoped_refptr<net::IOBufferWithSize> buf_;
   int host_id_;
   disk_cache::Entry* entry_;
+  base::Time entry_last_used_;
+  std::vector<CachedShader> cached_shaders_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderDiskReadHelper);
 };
@@ -312,6 +329,9 @@ int ShaderDiskReadHelper::OpenNextEntryComplete(int rv) {
   if (rv < 0)
     return rv;
 
+  // Reading the entry counts as a use, so remember when it was last used
+  // before that.
+  entry_last_used_ = entry_->GetLastUsed();
   op_type_ = READ_COMPLETE;
   buf_ = new net::IOBufferWithSize(entry_->GetDataSize(1));
   return entry_->ReadData(
@@ -326,10 +346,11 @@ int ShaderDiskReadHelper::ReadComplete(int rv) {
   DCHECK(CalledOnValidThread());
   // Called through OnOpComplete, so we know |cache_| is valid.
   if (rv && rv == buf_->size()) {
-    GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
-    if (host)
-      host->LoadedShader(entry_->GetKey(), std::string(buf_->data(),
-                                                       buf_->size()));
+    CachedShader shader;
+    shader.key = entry_->GetKey();
+    shader.data.assign(buf_->data(), buf_->size());
+    shader.last_used = entry_last_used_;
+    cached_shaders_.push_back(std::move(shader));
   }
 
   buf_ = NULL;
@@ -344,6 +365,18 @@ int ShaderDiskReadHelper::IterationComplete(int rv) {
   DCHECK(CalledOnValidThread());
   // Called through OnOpComplete, so we know |cache_| is valid.
   iter_.reset();
+
+  std::stable_sort(cached_shaders_.begin(), cached_shaders_.end(),
+                   [](const CachedShader& a, const CachedShader& b) {
+                     return a.last_used < b.last_used;
+                   });
+  GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
+  if (host) {
+    for (const CachedShader& shader : cached_shaders_)
+      host->LoadedShader(shader.key, shader.data);
+  }
+  cached_shaders_.clear();
+
   op_type_ = TERMINATE;
   return net::OK;
 }
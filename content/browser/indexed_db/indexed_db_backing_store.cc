@@ -1921,8 +1921,12 @@ leveldb::Status IndexedDBBackingStore::PutRecord(
   if (!s.ok())
     return s;
   DCHECK_GE(version, 0);
+  // The record, its exists entry and the index entries are all keyed by the
+  // same encoded primary key, so only encode it once.
+  std::string key_encoded;
+  EncodeIDBKey(key, &key_encoded);
   const std::string object_store_data_key =
-      ObjectStoreDataKey::Encode(database_id, object_store_id, key);
+      ObjectStoreDataKey::Encode(database_id, object_store_id, key_encoded);
 
   std::string v;
   EncodeVarInt(version, &v);
@@ -1939,13 +1943,11 @@ leveldb::Status IndexedDBBackingStore::PutRecord(
   DCHECK(!handles->size());
 
   const std::string exists_entry_key =
-      ExistsEntryKey::Encode(database_id, object_store_id, key);
+      ExistsEntryKey::Encode(database_id, object_store_id, key_encoded);
   std::string version_encoded;
   EncodeInt(version, &version_encoded);
   leveldb_transaction->Put(exists_entry_key, &version_encoded);
 
-  std::string key_encoded;
-  EncodeIDBKey(key, &key_encoded);
   record_identifier->Reset(key_encoded, version);
   return s;
 }
@@ -1040,6 +1040,12 @@ void IndexedDBDatabase::PutOperation(std::unique_ptr<PutOperationParams> params,
     return;
   }
 
+  // Values are stored inline in LevelDB, whose table blocks are already
+  // Snappy compressed. Record their sizes to find out how many would be
+  // better off in the blob store.
+  UMA_HISTOGRAM_MEMORY_KB("WebCore.IndexedDB.PutValueSize",
+                          params->value.bits.size() / 1024);
+
   // Before this point, don't do any mutation. After this point, rollback the
   // transaction in case of error.
   leveldb::Status s =
@@ -390,7 +390,7 @@ class ObjectStoreDataKey {
   static bool Decode(base::StringPiece* slice, ObjectStoreDataKey* result);
   CONTENT_EXPORT static std::string Encode(int64_t database_id,
                                            int64_t object_store_id,
-                                           const std::string encoded_user_key);
+                                           const std::string& encoded_user_key);
   static std::string Encode(int64_t database_id,
                             int64_t object_store_id,
                             const IndexedDBKey& user_key);
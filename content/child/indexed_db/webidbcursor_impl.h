@@ -61,7 +61,9 @@ class CONTENT_EXPORT WebIDBCursorImpl
   enum { kInvalidCursorId = -1 };
   enum { kPrefetchContinueThreshold = 2 };
   enum { kMinPrefetchAmount = 5 };
-  enum { kMaxPrefetchAmount = 100 };
+  // The browser also stops a prefetch once the values add up to about 10MB,
+  // so this mostly matters for cursors over small records.
+  enum { kMaxPrefetchAmount = 1000 };
 
   int32_t ipc_cursor_id_;
   int64_t transaction_id_;
@@ -150,6 +150,12 @@ base::LazyInstance<HostDiscardableSharedMemoryManager>
 
 const int kEnforceMemoryPolicyDelayMs = 1000;
 
+// In-process allocations at least this large are backed by huge pages. Huge
+// page segments are rounded up to a multiple of the huge page size, so this
+// bounds the waste to 1/8th of the allocation.
+const size_t kMinHugePagesAllocationSize =
+    8 * base::DiscardableSharedMemory::kHugePageSize;
+
 // Global atomic to generate unique discardable shared memory IDs.
 base::StaticAtomicSequenceNumber g_next_discardable_shared_memory_id;
 
@@ -200,14 +206,22 @@ HostDiscardableSharedMemoryManager::AllocateLockedDiscardableMemory(
       g_next_discardable_shared_memory_id.GetNext();
   base::ProcessHandle current_process_handle = base::GetCurrentProcessHandle();
 
+  // Large allocations, such as decoded images, are backed by huge pages to
+  // reduce TLB misses. The whole segment is always locked and unlocked at
+  // once, so the coarser lock granularity doesn't matter.
+  const base::DiscardableSharedMemory::PageType page_type =
+      size >= kMinHugePagesAllocationSize
+          ? base::DiscardableSharedMemory::HUGE_PAGES
+          : base::DiscardableSharedMemory::REGULAR_PAGES;
+
   // Note: Use DiscardableSharedMemoryHeap for in-process allocation
   // of discardable memory if the cost of each allocation is too high.
   base::SharedMemoryHandle handle;
   AllocateLockedDiscardableSharedMemory(current_process_handle,
                                         ChildProcessHost::kInvalidUniqueID,
-                                        size, new_id, &handle);
+                                        size, page_type, new_id, &handle);
   std::unique_ptr<base::DiscardableSharedMemory> memory(
-      new base::DiscardableSharedMemory(handle));
+      new base::DiscardableSharedMemory(handle, page_type));
   if (!memory->Map(size))
     base::TerminateBecauseOutOfMemory(size);
   // Close file descriptor to avoid running out.
@@ -233,6 +247,7 @@ bool HostDiscardableSharedMemoryManager::OnMemoryDump(
   }
 
   base::AutoLock lock(lock_);
+  size_t huge_pages_size = 0;
   for (const auto& process_entry : processes_) {
     const int child_process_id = process_entry.first;
     const MemorySegmentMap& process_segments = process_entry.second;
@@ -258,6 +273,14 @@ bool HostDiscardableSharedMemoryManager::OnMemoryDump(
           segment->memory()->IsMemoryLocked() ? segment->memory()->mapped_size()
                                               : 0u);
 
+      if (segment->memory()->page_type() ==
+          base::DiscardableSharedMemory::HUGE_PAGES) {
+        dump->AddScalar("huge_pages_size",
+                        base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                        segment->memory()->mapped_size());
+        huge_pages_size += segment->memory()->mapped_size();
+      }
+
       // Create the cross-process ownership edge. If the child creates a
       // corresponding dump for the same segment, this will avoid to
       // double-count them in tracing. If, instead, no other process will emit a
@@ -288,6 +311,13 @@ bool HostDiscardableSharedMemoryManager::OnMemoryDump(
 #endif  // defined(COUNT_RESIDENT_BYTES_SUPPORTED)
     }
   }
+
+  // Size of the segments that were asked to be backed by huge pages. The
+  // kernel can still back parts of them with regular pages.
+  pmd->GetOrCreateAllocatorDump("discardable")
+      ->AddScalar("huge_pages_size",
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  huge_pages_size);
   return true;
 }
 
@@ -298,8 +328,9 @@ void HostDiscardableSharedMemoryManager::
         size_t size,
         DiscardableSharedMemoryId id,
         base::SharedMemoryHandle* shared_memory_handle) {
-  AllocateLockedDiscardableSharedMemory(process_handle, child_process_id, size,
-                                        id, shared_memory_handle);
+  AllocateLockedDiscardableSharedMemory(
+      process_handle, child_process_id, size,
+      base::DiscardableSharedMemory::REGULAR_PAGES, id, shared_memory_handle);
 }
 
 void HostDiscardableSharedMemoryManager::ChildDeletedDiscardableSharedMemory(
@@ -350,6 +381,7 @@ void HostDiscardableSharedMemoryManager::AllocateLockedDiscardableSharedMemory(
     base::ProcessHandle process_handle,
     int client_process_id,
     size_t size,
+    base::DiscardableSharedMemory::PageType page_type,
     DiscardableSharedMemoryId id,
     base::SharedMemoryHandle* shared_memory_handle) {
   base::AutoLock lock(lock_);
@@ -377,7 +409,7 @@ void HostDiscardableSharedMemoryManager::AllocateLockedDiscardableSharedMemory(
     ReduceMemoryUsageUntilWithinLimit(limit);
 
   std::unique_ptr<base::DiscardableSharedMemory> memory(
-      new base::DiscardableSharedMemory);
+      new base::DiscardableSharedMemory(page_type));
   if (!memory->CreateAndMap(size)) {
     *shared_memory_handle = base::SharedMemory::NULLHandle();
     return;
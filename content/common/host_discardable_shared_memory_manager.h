@@ -107,6 +107,7 @@ class CONTENT_EXPORT HostDiscardableSharedMemoryManager
       base::ProcessHandle process_handle,
       int client_process_id,
       size_t size,
+      base::DiscardableSharedMemory::PageType page_type,
       DiscardableSharedMemoryId id,
       base::SharedMemoryHandle* shared_memory_handle);
   void DeletedDiscardableSharedMemory(DiscardableSharedMemoryId id,
@@ -54,6 +54,7 @@
 #include "third_party/WebKit/public/platform/WebCompositorMutatorClient.h"
 #include "third_party/WebKit/public/platform/WebLayoutAndPaintAsyncCallback.h"
 #include "third_party/WebKit/public/platform/WebSize.h"
+#include "third_party/WebKit/public/web/WebImageCache.h"
 #include "third_party/WebKit/public/web/WebKit.h"
 #include "third_party/WebKit/public/web/WebRuntimeFeatures.h"
 #include "third_party/WebKit/public/web/WebSelection.h"
@@ -449,6 +450,12 @@ void RenderWidgetCompositor::Initialize(float device_scale_factor) {
 
 #endif  // defined(OS_ANDROID)
 
+  // Blink keeps the decoders of images that are still loading or animating,
+  // with their decoded frames, in a cache in front of cc's decoded images.
+  // Give it a share of the same budget, so the two grow and shrink together.
+  blink::WebImageCache::setCacheLimitInBytes(
+      settings.software_decoded_image_budget_bytes / 4);
+
   if (cmd->HasSwitch(switches::kEnableLowResTiling))
     settings.create_low_res_tiling = true;
   if (cmd->HasSwitch(switches::kDisableLowResTiling))
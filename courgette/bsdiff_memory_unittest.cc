@@ -5,9 +5,14 @@
 #include "courgette/third_party/bsdiff/bsdiff.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "courgette/base_test_unittest.h"
 #include "courgette/courgette.h"
+#include "courgette/crc.h"
 #include "courgette/streams.h"
 
 class BSDiffMemoryTest : public BaseTest {
@@ -38,6 +43,31 @@ void BSDiffMemoryTest::GenerateAndTestPatch(const std::string& old_text,
   EXPECT_EQ(courgette::OK, status);
   EXPECT_EQ(new_text.length(), new2.Length());
   EXPECT_EQ(0, memcmp(new_text.c_str(), new2.Buffer(), new_text.length()));
+
+  // Apply the patch again, writing to a file through a small window.
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath new_path = temp_dir.path().AppendASCII("new");
+  base::File new_file(new_path,
+                      base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  ASSERT_TRUE(new_file.IsValid());
+
+  courgette::SourceStream old3;
+  courgette::SourceStream patch3;
+  old3.Init(old_text.c_str(), old_text.length());
+  patch3.Init(patch1);
+
+  uint32_t new_crc = 0;
+  status = ApplyBinaryPatch(&old3, &patch3, 7, &new_file, &new_crc);
+  EXPECT_EQ(courgette::OK, status);
+  new_file.Close();
+  std::string new3;
+  EXPECT_TRUE(base::ReadFileToString(new_path, &new3));
+  EXPECT_EQ(new_text, new3);
+  EXPECT_EQ(courgette::CalculateCrc(
+                reinterpret_cast<const uint8_t*>(new_text.c_str()),
+                new_text.length()),
+            new_crc);
 }
 
 std::string BSDiffMemoryTest::GenerateSyntheticInput(size_t length, int seed)
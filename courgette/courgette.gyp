@@ -42,6 +42,8 @@
       'label_manager.h',
       'memory_allocator.cc',
       'memory_allocator.h',
+      'parallel.cc',
+      'parallel.h',
       'program_detector.cc',
       'program_detector.h',
       'region.h',
@@ -60,6 +62,7 @@
       'third_party/bsdiff/bsdiff_create.cc',
       'third_party/bsdiff/paged_array.h',
       'third_party/bsdiff/qsufsort.h',
+      'third_party/bsdiff/sais.h',
       'types_elf.h',
       'types_win_pe.h',
       'patch_generator_x86_32.h',
@@ -124,12 +127,14 @@
         'image_utils_unittest.cc',
         'label_manager_unittest.cc',
         'memory_allocator_unittest.cc',
+        'parallel_unittest.cc',
         'rel32_finder_unittest.cc',
         'streams_unittest.cc',
         'typedrva_unittest.cc',
         'versioning_unittest.cc',
         'third_party/bsdiff/paged_array_unittest.cc',
         'third_party/bsdiff/qsufsort_unittest.cc',
+        'third_party/bsdiff/sais_unittest.cc',
       ],
       'dependencies': [
         'courgette_lib',
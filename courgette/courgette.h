@@ -83,6 +83,16 @@ Status ApplyEnsemblePatch(const base::FilePath::CharType* old_file_name,
                           const base::FilePath::CharType* patch_file_name,
                           const base::FilePath::CharType* new_file_name);
 
+// As above, but bounds the memory used while applying the patch: the new file
+// is written |window_size| bytes at a time, and the intermediate results are
+// kept in temporary files next to it and mapped into memory as needed rather
+// than held in heap memory. The elements are also transformed one at a time.
+Status ApplyEnsemblePatchStreaming(
+    const base::FilePath::CharType* old_file_name,
+    const base::FilePath::CharType* patch_file_name,
+    const base::FilePath::CharType* new_file_name,
+    size_t window_size);
+
 // Generates a patch that will transform the bytes in |old| into the bytes in
 // |target|.
 // Returns C_OK unless something when wrong (unexpected).
@@ -33,6 +33,7 @@ void PrintHelp() {
     "  courgette -disadj <executable_file> <reference> <binary_assembly_file>\n"
     "  courgette -gen <v1> <v2> <patch>\n"
     "  courgette -apply <v1> <patch> <v2>\n"
+    "  courgette -applystreaming <v1> <patch> <v2>\n"
     "\n");
 }
 
@@ -335,17 +336,27 @@ void GenerateEnsemblePatch(const base::FilePath& old_file,
   WriteSinkToFile(&patch_stream, patch_file);
 }
 
+// The size of the writes of -applystreaming, unless set with -window=N.
+const size_t kDefaultStreamingWindowSize = 1 << 20;
+
+// Applies the patch in memory if |window_size| is 0, or in streaming mode with
+// that window size otherwise.
 void ApplyEnsemblePatch(const base::FilePath& old_file,
                         const base::FilePath& patch_file,
-                        const base::FilePath& new_file) {
+                        const base::FilePath& new_file,
+                        size_t window_size) {
   // We do things a little differently here in order to call the same Courgette
   // entry point as the installer.  That entry point point takes file names and
   // returns an status code but does not output any diagnostics.
 
   courgette::Status status =
-      courgette::ApplyEnsemblePatch(old_file.value().c_str(),
-                                    patch_file.value().c_str(),
-                                    new_file.value().c_str());
+      window_size == 0
+          ? courgette::ApplyEnsemblePatch(old_file.value().c_str(),
+                                          patch_file.value().c_str(),
+                                          new_file.value().c_str())
+          : courgette::ApplyEnsemblePatchStreaming(
+                old_file.value().c_str(), patch_file.value().c_str(),
+                new_file.value().c_str(), window_size);
 
   if (status == courgette::C_OK)
     return;
@@ -450,6 +461,7 @@ int main(int argc, const char* argv[]) {
   bool cmd_disadj = command_line.HasSwitch("disadj");
   bool cmd_make_patch = command_line.HasSwitch("gen");
   bool cmd_apply_patch = command_line.HasSwitch("apply");
+  bool cmd_apply_patch_streaming = command_line.HasSwitch("applystreaming");
   bool cmd_make_bsdiff_patch = command_line.HasSwitch("genbsdiff");
   bool cmd_apply_bsdiff_patch = command_line.HasSwitch("applybsdiff");
   bool cmd_spread_1_adjusted = command_line.HasSwitch("gen1a");
@@ -469,14 +481,21 @@ int main(int argc, const char* argv[]) {
     if (!base::StringToInt(repeat_switch, &repeat_count))
       repeat_count = 1;
 
+  // '-window=N' sets the size of the writes of -applystreaming.
+  size_t window_size = kDefaultStreamingWindowSize;
+  std::string window_switch = command_line.GetSwitchValueASCII("window");
+  if (!window_switch.empty())
+    if (!base::StringToSizeT(window_switch, &window_size) || window_size == 0)
+      window_size = kDefaultStreamingWindowSize;
+
   if (cmd_sup + cmd_dis + cmd_asm + cmd_disadj + cmd_make_patch +
-      cmd_apply_patch + cmd_make_bsdiff_patch + cmd_apply_bsdiff_patch +
-      cmd_spread_1_adjusted + cmd_spread_1_unadjusted
+      cmd_apply_patch + cmd_apply_patch_streaming + cmd_make_bsdiff_patch +
+      cmd_apply_bsdiff_patch + cmd_spread_1_adjusted + cmd_spread_1_unadjusted
       != 1)
     UsageProblem(
         "Must have exactly one of:\n"
-        "  -supported -asm, -dis, -disadj, -gen or -apply, -genbsdiff"
-        " or -applybsdiff.");
+        "  -supported -asm, -dis, -disadj, -gen or -apply, -applystreaming,"
+        " -genbsdiff or -applybsdiff.");
 
   while (repeat_count-- > 0) {
     if (cmd_sup) {
@@ -502,7 +521,11 @@ int main(int argc, const char* argv[]) {
     } else if (cmd_apply_patch) {
       if (values.size() != 3)
         UsageProblem("-apply <old_file> <patch_file> <new_file>");
-      ApplyEnsemblePatch(values[0], values[1], values[2]);
+      ApplyEnsemblePatch(values[0], values[1], values[2], 0);
+    } else if (cmd_apply_patch_streaming) {
+      if (values.size() != 3)
+        UsageProblem("-applystreaming <old_file> <patch_file> <new_file>");
+      ApplyEnsemblePatch(values[0], values[1], values[2], window_size);
     } else if (cmd_make_bsdiff_patch) {
       if (values.size() != 3)
         UsageProblem("-genbsdiff <old_file> <new_file> <patch_file>");
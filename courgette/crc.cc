@@ -33,4 +33,13 @@ uint32_t CalculateCrc(const uint8_t* buffer, size_t size) {
   return ~crc;
 }
 
+uint32_t UpdateCrc(uint32_t crc, const uint8_t* buffer, size_t size) {
+#ifdef COURGETTE_USE_CRC_LIB
+  return ~crc32(~crc, buffer, size);
+#else
+  CrcGenerateTable();
+  return CrcUpdate(crc, buffer, size);
+#endif
+}
+
 }  // namespace
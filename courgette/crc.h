@@ -14,5 +14,10 @@ namespace courgette {
 //
 uint32_t CalculateCrc(const uint8_t* buffer, size_t size);
 
+// Extends |crc|, the result of CalculateCrc() for some data, with the given
+// buffer, so that a CRC can be calculated piecewise. CalculateCrc(NULL, 0) is
+// the starting value.
+uint32_t UpdateCrc(uint32_t crc, const uint8_t* buffer, size_t size);
+
 }  // namespace courgette
 #endif  // COURGETTE_CRC_H_
@@ -9,14 +9,22 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "base/bind.h"
+#include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/files/memory_mapped_file.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/time/time.h"
 #include "courgette/crc.h"
+#include "courgette/parallel.h"
 #include "courgette/patcher_x86_32.h"
 #include "courgette/region.h"
 #include "courgette/simple_delta.h"
@@ -24,6 +32,111 @@
 
 namespace courgette {
 
+namespace {
+
+// Transforms the element of |patcher|, the |index|-th of |count|, on any
+// thread, and sets |status| to the result.
+void TransformElement(TransformationPatcher* patcher,
+                      size_t index,
+                      size_t count,
+                      SourceStreamSet* parameters,
+                      SinkStreamSet* transformed_element,
+                      Status* status) {
+  base::Time start_time = base::Time::Now();
+  *status = patcher->Transform(parameters, transformed_element);
+  VLOG(1) << "transformed element " << index + 1 << " of " << count << " "
+          << (base::Time::Now() - start_time).InSecondsF() << "s";
+}
+
+// Reforms the element of |patcher|, the |index|-th of |count|, on any thread,
+// and sets |status| to the result.
+void ReformElement(TransformationPatcher* patcher,
+                   size_t index,
+                   size_t count,
+                   SourceStreamSet* transformed_element,
+                   SinkStream* reformed_element,
+                   Status* status) {
+  base::Time start_time = base::Time::Now();
+  *status = patcher->Reform(transformed_element, reformed_element);
+  VLOG(1) << "reformed element " << index + 1 << " of " << count << " "
+          << (base::Time::Now() - start_time).InSecondsF() << "s";
+}
+
+// Writes |length| bytes at |data| to |file|, at most |window_size| bytes at a
+// time.
+bool WriteWindowed(const uint8_t* data,
+                   size_t length,
+                   size_t window_size,
+                   base::File* file) {
+  while (length) {
+    int size = static_cast<int>(std::min(length, window_size));
+    if (file->WriteAtCurrentPos(reinterpret_cast<const char*>(data), size) !=
+        size) {
+      return false;
+    }
+    data += size;
+    length -= size;
+  }
+  return true;
+}
+
+// Writes the contents of |stream| to |file| and frees its storage.
+bool WriteAndRetire(SinkStream* stream, size_t window_size, base::File* file) {
+  bool ok = WriteWindowed(stream->Buffer(), stream->Length(), window_size,
+                          file);
+  stream->Retire();
+  return ok;
+}
+
+// Writes |set| to |file| in the layout of SinkStreamSet::CopyTo(), freeing the
+// storage of each stream once written.
+bool WriteSetAndRetire(SinkStreamSet* set,
+                       size_t window_size,
+                       base::File* file) {
+  SinkStream header;
+  if (!set->CopyHeaderTo(&header) ||
+      !WriteAndRetire(&header, window_size, file)) {
+    return false;
+  }
+  for (size_t i = 0; set->stream(i); ++i) {
+    if (!WriteAndRetire(set->stream(i), window_size, file))
+      return false;
+  }
+  return true;
+}
+
+// Creates a file in |dir| to hold an intermediate result, and opens it for
+// writing.
+bool CreateTemporaryFile(const base::FilePath& dir,
+                         base::FilePath* path,
+                         base::File* file) {
+  if (!base::CreateTemporaryFileInDir(dir, path))
+    return false;
+  file->Initialize(*path, base::File::FLAG_CREATE_ALWAYS |
+                              base::File::FLAG_WRITE);
+  return file->IsValid();
+}
+
+// Maps the file at |path| into |mapping| and points |stream| at its contents.
+// Empty files cannot be mapped, and leave |stream| empty.
+bool MapFile(const base::FilePath& path,
+             base::MemoryMappedFile* mapping,
+             SourceStream* stream) {
+  int64_t size;
+  if (!base::GetFileSize(path, &size))
+    return false;
+  if (size == 0) {
+    stream->Init(nullptr, 0);
+    return true;
+  }
+  if (!mapping->Initialize(path))
+    return false;
+  stream->Init(mapping->data(), mapping->length());
+  return true;
+}
+
+}  // namespace
+
 // EnsemblePatchApplication is all the logic and data required to apply the
 // multi-stage patch.
 class EnsemblePatchApplication {
@@ -31,6 +144,12 @@ class EnsemblePatchApplication {
   EnsemblePatchApplication();
   ~EnsemblePatchApplication() = default;
 
+  // Makes the subpatches write their results to files in |temp_dir|, at most
+  // |window_size| bytes at a time, and map them back in, and makes the
+  // elements be transformed one at a time. This bounds the memory used by
+  // the intermediate results, at the cost of disk I/O.
+  void SetStreaming(const base::FilePath& temp_dir, size_t window_size);
+
   Status ReadHeader(SourceStream* header_stream);
 
   Status InitBase(const Region& region);
@@ -59,11 +178,23 @@ class EnsemblePatchApplication {
                              SourceStream* correction,
                              SinkStream* corrected_ensemble);
 
+  // Streaming versions of TransformDown() and SubpatchFinalOutput(), which
+  // write their output to files.
+  Status TransformDownToFile(SourceStreamSet* transformed_elements,
+                             base::File* basic_elements);
+
+  Status SubpatchFinalOutputToFile(SourceStream* original,
+                                   SourceStream* correction,
+                                   base::File* corrected_ensemble);
+
  private:
+  bool streaming() const { return window_size_ != 0; }
+
   Status SubpatchStreamSets(SinkStreamSet* predicted_items,
                             SourceStream* correction,
                             SourceStreamSet* corrected_items,
-                            SinkStream* corrected_items_storage);
+                            SinkStream* corrected_items_storage,
+                            base::MemoryMappedFile* corrected_items_mapping);
 
   Region base_region_;       // Location of in-memory copy of 'old' version.
 
@@ -76,12 +207,26 @@ class EnsemblePatchApplication {
   SinkStream corrected_parameters_storage_;
   SinkStream corrected_elements_storage_;
 
+  // In streaming mode, the corrected items are mapped from files instead.
+  base::FilePath temp_dir_;
+  size_t window_size_;
+  base::MemoryMappedFile corrected_parameters_mapping_;
+  std::unique_ptr<base::MemoryMappedFile> corrected_elements_mapping_;
+
   DISALLOW_COPY_AND_ASSIGN(EnsemblePatchApplication);
 };
 
 EnsemblePatchApplication::EnsemblePatchApplication()
     : source_checksum_(0), target_checksum_(0),
-      final_patch_input_size_prediction_(0) {
+      final_patch_input_size_prediction_(0), window_size_(0),
+      corrected_elements_mapping_(new base::MemoryMappedFile) {
+}
+
+void EnsemblePatchApplication::SetStreaming(const base::FilePath& temp_dir,
+                                            size_t window_size) {
+  DCHECK_GT(window_size, 0U);
+  temp_dir_ = temp_dir;
+  window_size_ = window_size;
 }
 
 Status EnsemblePatchApplication::ReadHeader(SourceStream* header_stream) {
@@ -186,25 +331,46 @@ Status EnsemblePatchApplication::SubpatchTransformParameters(
   return SubpatchStreamSets(predicted_parameters,
                             correction,
                             corrected_parameters,
-                            &corrected_parameters_storage_);
+                            &corrected_parameters_storage_,
+                            &corrected_parameters_mapping_);
 }
 
 Status EnsemblePatchApplication::TransformUp(
     SourceStreamSet* parameters,
     SinkStreamSet* transformed_elements) {
-  for (size_t i = 0;  i < patchers_.size();  ++i) {
-    SourceStreamSet single_parameters;
-    if (!parameters->ReadSet(&single_parameters))
+  // The elements are independent of each other, so they are transformed
+  // concurrently, each into its own streams. When streaming they are
+  // transformed one at a time instead, so that only one is in memory.
+  size_t count = patchers_.size();
+  std::vector<std::unique_ptr<SourceStreamSet>> all_single_parameters;
+  std::vector<std::unique_ptr<SinkStreamSet>> all_single_transformed_elements;
+  std::vector<Status> statuses(count, C_OK);
+  std::vector<base::Closure> tasks;
+  for (size_t i = 0;  i < count;  ++i) {
+    all_single_parameters.push_back(base::WrapUnique(new SourceStreamSet));
+    if (!parameters->ReadSet(all_single_parameters.back().get()))
       return C_STREAM_ERROR;
-    SinkStreamSet single_transformed_element;
-    Status status = patchers_[i]->Transform(&single_parameters,
-                                            &single_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+    all_single_transformed_elements.push_back(
+        base::WrapUnique(new SinkStreamSet));
+    tasks.push_back(base::Bind(&TransformElement, patchers_[i].get(), i, count,
+                               all_single_parameters.back().get(),
+                               all_single_transformed_elements.back().get(),
+                               &statuses[i]));
+  }
+  if (!streaming())
+    RunConcurrently(tasks);
+
+  for (size_t i = 0;  i < count;  ++i) {
+    if (streaming())
+      tasks[i].Run();
+    if (statuses[i] != C_OK)
+      return statuses[i];
+    if (!all_single_parameters[i]->Empty())
       return C_STREAM_NOT_CONSUMED;
-    if (!transformed_elements->WriteSet(&single_transformed_element))
+    if (!transformed_elements->WriteSet(
+            all_single_transformed_elements[i].get()))
       return C_STREAM_ERROR;
+    all_single_transformed_elements[i].reset();
   }
 
   if (!parameters->Empty())
@@ -219,7 +385,8 @@ Status EnsemblePatchApplication::SubpatchTransformedElements(
   return SubpatchStreamSets(predicted_elements,
                             correction,
                             corrected_elements,
-                            &corrected_elements_storage_);
+                            &corrected_elements_storage_,
+                            corrected_elements_mapping_.get());
 }
 
 Status EnsemblePatchApplication::TransformDown(
@@ -235,23 +402,95 @@ Status EnsemblePatchApplication::TransformDown(
   if (!basic_elements->Write(base_region_.start(), base_region_.length()))
     return C_STREAM_ERROR;
 
-  for (size_t i = 0;  i < patchers_.size();  ++i) {
+  // Each element is reformed concurrently into its own stream, and the streams
+  // are then appended in order.
+  size_t count = patchers_.size();
+  std::vector<std::unique_ptr<SourceStreamSet>> all_single_corrected_elements;
+  std::vector<std::unique_ptr<SinkStream>> reformed_elements;
+  std::vector<Status> statuses(count, C_OK);
+  std::vector<base::Closure> tasks;
+  for (size_t i = 0;  i < count;  ++i) {
+    all_single_corrected_elements.push_back(
+        base::WrapUnique(new SourceStreamSet));
+    if (!transformed_elements->ReadSet(
+            all_single_corrected_elements.back().get()))
+      return C_STREAM_ERROR;
+    reformed_elements.push_back(base::WrapUnique(new SinkStream));
+    tasks.push_back(base::Bind(&ReformElement, patchers_[i].get(), i, count,
+                               all_single_corrected_elements.back().get(),
+                               reformed_elements.back().get(), &statuses[i]));
+  }
+  RunConcurrently(tasks);
+
+  for (size_t i = 0;  i < count;  ++i) {
+    if (statuses[i] != C_OK)
+      return statuses[i];
+    if (!all_single_corrected_elements[i]->Empty())
+      return C_STREAM_NOT_CONSUMED;
+    if (!basic_elements->Append(reformed_elements[i].get()))
+      return C_STREAM_ERROR;
+  }
+
+  if (!transformed_elements->Empty())
+    return C_STREAM_NOT_CONSUMED;
+  // We have totally consumed transformed_elements, so can free the
+  // storage to which it referred.
+  corrected_elements_storage_.Retire();
+
+  return C_OK;
+}
+
+Status EnsemblePatchApplication::TransformDownToFile(
+    SourceStreamSet* transformed_elements,
+    base::File* basic_elements) {
+  DCHECK(streaming());
+
+  // The original input:
+  if (!WriteWindowed(base_region_.start(), base_region_.length(), window_size_,
+                     basic_elements)) {
+    return C_WRITE_ERROR;
+  }
+
+  // Each element is reformed and written out in turn.
+  size_t count = patchers_.size();
+  for (size_t i = 0;  i < count;  ++i) {
     SourceStreamSet single_corrected_element;
     if (!transformed_elements->ReadSet(&single_corrected_element))
       return C_STREAM_ERROR;
-    Status status = patchers_[i]->Reform(&single_corrected_element,
-                                         basic_elements);
+    SinkStream reformed_element;
+    Status status;
+    ReformElement(patchers_[i].get(), i, count, &single_corrected_element,
+                  &reformed_element, &status);
     if (status != C_OK)
       return status;
     if (!single_corrected_element.Empty())
       return C_STREAM_NOT_CONSUMED;
+    if (!WriteAndRetire(&reformed_element, window_size_, basic_elements))
+      return C_WRITE_ERROR;
   }
 
   if (!transformed_elements->Empty())
     return C_STREAM_NOT_CONSUMED;
-  // We have totally consumed transformed_elements, so can free the
-  // storage to which it referred.
-  corrected_elements_storage_.Retire();
+  // We have totally consumed transformed_elements, so can unmap the file to
+  // which it referred.
+  corrected_elements_mapping_.reset();
+
+  return C_OK;
+}
+
+Status EnsemblePatchApplication::SubpatchFinalOutputToFile(
+    SourceStream* original,
+    SourceStream* correction,
+    base::File* corrected_ensemble) {
+  DCHECK(streaming());
+  uint32_t checksum;
+  Status delta_status = ApplySimpleDeltaToFile(
+      original, correction, window_size_, corrected_ensemble, &checksum);
+  if (delta_status != C_OK)
+    return delta_status;
+
+  if (checksum != target_checksum_)
+    return C_BAD_ENSEMBLE_CRC;
 
   return C_OK;
 }
@@ -276,7 +515,51 @@ Status EnsemblePatchApplication::SubpatchStreamSets(
     SinkStreamSet* predicted_items,
     SourceStream* correction,
     SourceStreamSet* corrected_items,
-    SinkStream* corrected_items_storage) {
+    SinkStream* corrected_items_storage,
+    base::MemoryMappedFile* corrected_items_mapping) {
+  if (streaming()) {
+    // Spill the prediction to a file, apply the correction to it into another
+    // file, and map that one in.
+    base::FilePath prediction_path;
+    base::File prediction_file;
+    if (!CreateTemporaryFile(temp_dir_, &prediction_path, &prediction_file))
+      return C_WRITE_OPEN_ERROR;
+    if (!WriteSetAndRetire(predicted_items, window_size_, &prediction_file))
+      return C_WRITE_ERROR;
+    prediction_file.Close();
+
+    base::FilePath corrected_items_path;
+    base::File corrected_items_file;
+    if (!CreateTemporaryFile(temp_dir_, &corrected_items_path,
+                             &corrected_items_file)) {
+      return C_WRITE_OPEN_ERROR;
+    }
+    {
+      base::MemoryMappedFile prediction_mapping;
+      SourceStream prediction;
+      if (!MapFile(prediction_path, &prediction_mapping, &prediction))
+        return C_READ_ERROR;
+      uint32_t checksum;
+      Status status = ApplySimpleDeltaToFile(&prediction, correction,
+                                             window_size_,
+                                             &corrected_items_file, &checksum);
+      if (status != C_OK)
+        return status;
+    }
+    corrected_items_file.Close();
+    base::DeleteFile(prediction_path, false);
+
+    SourceStream corrected_items_stream;
+    if (!MapFile(corrected_items_path, corrected_items_mapping,
+                 &corrected_items_stream)) {
+      return C_READ_ERROR;
+    }
+    if (!corrected_items->Init(&corrected_items_stream))
+      return C_STREAM_ERROR;
+
+    return C_OK;
+  }
+
   SinkStream linearized_predicted_items;
   if (!predicted_items->CopyTo(&linearized_predicted_items))
     return C_STREAM_ERROR;
@@ -297,72 +580,181 @@ Status EnsemblePatchApplication::SubpatchStreamSets(
   return C_OK;
 }
 
-Status ApplyEnsemblePatch(SourceStream* base,
-                          SourceStream* patch,
-                          SinkStream* output) {
+namespace {
+
+// Applies the patch up to the final subpatch, leaving its input in
+// |final_patch_prediction| and its correction in |ensemble_correction|.
+// In streaming mode, |final_patch_prediction| is mapped from a file into
+// |final_patch_prediction_mapping|, and |final_patch_prediction_storage| is
+// unused.
+Status ApplyEnsemblePatchUntilFinalOutput(
+    EnsemblePatchApplication* patch_process,
+    bool streaming,
+    const base::FilePath& temp_dir,
+    SourceStream* base,
+    SourceStream* patch,
+    SourceStreamSet* patch_streams,
+    SinkStream* final_patch_prediction_storage,
+    base::MemoryMappedFile* final_patch_prediction_mapping,
+    SourceStream* final_patch_prediction,
+    SourceStream** ensemble_correction) {
   Status status;
-  EnsemblePatchApplication patch_process;
 
-  status = patch_process.ReadHeader(patch);
+  status = patch_process->ReadHeader(patch);
   if (status != C_OK)
     return status;
 
-  status = patch_process.InitBase(Region(base->Buffer(), base->Remaining()));
+  status = patch_process->InitBase(Region(base->Buffer(), base->Remaining()));
   if (status != C_OK)
     return status;
 
-  status = patch_process.ValidateBase();
+  status = patch_process->ValidateBase();
   if (status != C_OK)
     return status;
 
   // The rest of the patch stream is a StreamSet.
-  SourceStreamSet patch_streams;
-  patch_streams.Init(patch);
+  patch_streams->Init(patch);
 
-  SourceStream* transformation_descriptions     = patch_streams.stream(0);
-  SourceStream* parameter_correction            = patch_streams.stream(1);
-  SourceStream* transformed_elements_correction = patch_streams.stream(2);
-  SourceStream* ensemble_correction             = patch_streams.stream(3);
+  SourceStream* transformation_descriptions     = patch_streams->stream(0);
+  SourceStream* parameter_correction            = patch_streams->stream(1);
+  SourceStream* transformed_elements_correction = patch_streams->stream(2);
+  *ensemble_correction                          = patch_streams->stream(3);
 
-  status = patch_process.ReadInitialParameters(transformation_descriptions);
+  status = patch_process->ReadInitialParameters(transformation_descriptions);
   if (status != C_OK)
     return status;
 
   SinkStreamSet predicted_parameters;
-  status = patch_process.PredictTransformParameters(&predicted_parameters);
+  status = patch_process->PredictTransformParameters(&predicted_parameters);
   if (status != C_OK)
     return status;
 
   SourceStreamSet corrected_parameters;
-  status = patch_process.SubpatchTransformParameters(&predicted_parameters,
-                                                     parameter_correction,
-                                                     &corrected_parameters);
+  status = patch_process->SubpatchTransformParameters(&predicted_parameters,
+                                                      parameter_correction,
+                                                      &corrected_parameters);
   if (status != C_OK)
     return status;
 
   SinkStreamSet transformed_elements;
-  status = patch_process.TransformUp(&corrected_parameters,
-                                     &transformed_elements);
+  status = patch_process->TransformUp(&corrected_parameters,
+                                      &transformed_elements);
   if (status != C_OK)
     return status;
 
   SourceStreamSet corrected_transformed_elements;
-  status = patch_process.SubpatchTransformedElements(
+  status = patch_process->SubpatchTransformedElements(
           &transformed_elements,
           transformed_elements_correction,
           &corrected_transformed_elements);
   if (status != C_OK)
     return status;
 
-  SinkStream original_ensemble_and_corrected_base_elements;
-  status = patch_process.TransformDown(
-      &corrected_transformed_elements,
-      &original_ensemble_and_corrected_base_elements);
+  if (!streaming) {
+    status = patch_process->TransformDown(&corrected_transformed_elements,
+                                          final_patch_prediction_storage);
+    if (status != C_OK)
+      return status;
+    final_patch_prediction->Init(*final_patch_prediction_storage);
+    return C_OK;
+  }
+
+  base::FilePath basic_elements_path;
+  base::File basic_elements_file;
+  if (!CreateTemporaryFile(temp_dir, &basic_elements_path,
+                           &basic_elements_file)) {
+    return C_WRITE_OPEN_ERROR;
+  }
+  status = patch_process->TransformDownToFile(&corrected_transformed_elements,
+                                              &basic_elements_file);
   if (status != C_OK)
     return status;
+  basic_elements_file.Close();
+  if (!MapFile(basic_elements_path, final_patch_prediction_mapping,
+               final_patch_prediction)) {
+    return C_READ_ERROR;
+  }
+  return C_OK;
+}
+
+Status ApplyEnsemblePatchStreaming(
+    const base::FilePath::CharType* old_file_name,
+    const base::FilePath::CharType* patch_file_name,
+    const base::FilePath::CharType* new_file_name,
+    size_t window_size) {
+  if (window_size == 0)
+    return C_GENERAL_ERROR;
+
+  base::FilePath patch_file_path(patch_file_name);
+  base::MemoryMappedFile patch_file;
+  if (!patch_file.Initialize(patch_file_path))
+    return C_READ_OPEN_ERROR;
+
+  base::FilePath old_file_path(old_file_name);
+  base::MemoryMappedFile old_file;
+  if (!old_file.Initialize(old_file_path))
+    return C_READ_ERROR;
+
+  // The intermediate results are kept next to the new file rather than in the
+  // system temporary directory, which may be backed by memory.
+  base::FilePath new_file_path(new_file_name);
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDirUnderPath(new_file_path.DirName()))
+    return C_WRITE_OPEN_ERROR;
+
+  SourceStream old_source_stream;
+  SourceStream patch_source_stream;
+  old_source_stream.Init(old_file.data(), old_file.length());
+  patch_source_stream.Init(patch_file.data(), patch_file.length());
+
+  EnsemblePatchApplication patch_process;
+  patch_process.SetStreaming(temp_dir.path(), window_size);
+  SourceStreamSet patch_streams;
+  SinkStream final_patch_prediction_storage;
+  base::MemoryMappedFile final_patch_prediction_mapping;
+  SourceStream final_patch_prediction;
+  SourceStream* ensemble_correction = nullptr;
+  Status status = ApplyEnsemblePatchUntilFinalOutput(
+      &patch_process, true, temp_dir.path(), &old_source_stream,
+      &patch_source_stream, &patch_streams, &final_patch_prediction_storage,
+      &final_patch_prediction_mapping, &final_patch_prediction,
+      &ensemble_correction);
+  if (status != C_OK)
+    return status;
+
+  base::File new_file(new_file_path, base::File::FLAG_CREATE_ALWAYS |
+                                         base::File::FLAG_WRITE);
+  if (!new_file.IsValid())
+    return C_WRITE_OPEN_ERROR;
+  status = patch_process.SubpatchFinalOutputToFile(
+      &final_patch_prediction, ensemble_correction, &new_file);
+  new_file.Close();
+  if (status != C_OK) {
+    base::DeleteFile(new_file_path, false);
+    return status;
+  }
+
+  return C_OK;
+}
+
+}  // namespace
 
+Status ApplyEnsemblePatch(SourceStream* base,
+                          SourceStream* patch,
+                          SinkStream* output) {
+  EnsemblePatchApplication patch_process;
+  SourceStreamSet patch_streams;
+  SinkStream final_patch_prediction_storage;
+  base::MemoryMappedFile final_patch_prediction_mapping;
   SourceStream final_patch_prediction;
-  final_patch_prediction.Init(original_ensemble_and_corrected_base_elements);
+  SourceStream* ensemble_correction = nullptr;
+  Status status = ApplyEnsemblePatchUntilFinalOutput(
+      &patch_process, false, base::FilePath(), base, patch, &patch_streams,
+      &final_patch_prediction_storage, &final_patch_prediction_mapping,
+      &final_patch_prediction, &ensemble_correction);
+  if (status != C_OK)
+    return status;
+
   status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
                                              ensemble_correction, output);
   if (status != C_OK)
@@ -419,4 +811,64 @@ Status ApplyEnsemblePatch(const base::FilePath::CharType* old_file_name,
   return C_OK;
 }
 
+Status ApplyEnsemblePatchStreaming(
+    const base::FilePath::CharType* old_file_name,
+    const base::FilePath::CharType* patch_file_name,
+    const base::FilePath::CharType* new_file_name,
+    size_t window_size) {
+  if (window_size == 0)
+    return C_GENERAL_ERROR;
+
+  base::FilePath patch_file_path(patch_file_name);
+  base::MemoryMappedFile patch_file;
+  if (!patch_file.Initialize(patch_file_path))
+    return C_READ_OPEN_ERROR;
+
+  base::FilePath old_file_path(old_file_name);
+  base::MemoryMappedFile old_file;
+  if (!old_file.Initialize(old_file_path))
+    return C_READ_ERROR;
+
+  // The intermediate results are kept next to the new file rather than in the
+  // system temporary directory, which may be backed by memory.
+  base::FilePath new_file_path(new_file_name);
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDirUnderPath(new_file_path.DirName()))
+    return C_WRITE_OPEN_ERROR;
+
+  SourceStream old_source_stream;
+  SourceStream patch_source_stream;
+  old_source_stream.Init(old_file.data(), old_file.length());
+  patch_source_stream.Init(patch_file.data(), patch_file.length());
+
+  EnsemblePatchApplication patch_process;
+  patch_process.SetStreaming(temp_dir.path(), window_size);
+  SourceStreamSet patch_streams;
+  SinkStream final_patch_prediction_storage;
+  base::MemoryMappedFile final_patch_prediction_mapping;
+  SourceStream final_patch_prediction;
+  SourceStream* ensemble_correction = nullptr;
+  Status status = ApplyEnsemblePatchUntilFinalOutput(
+      &patch_process, true, temp_dir.path(), &old_source_stream,
+      &patch_source_stream, &patch_streams, &final_patch_prediction_storage,
+      &final_patch_prediction_mapping, &final_patch_prediction,
+      &ensemble_correction);
+  if (status != C_OK)
+    return status;
+
+  base::File new_file(new_file_path, base::File::FLAG_CREATE_ALWAYS |
+                                         base::File::FLAG_WRITE);
+  if (!new_file.IsValid())
+    return C_WRITE_OPEN_ERROR;
+  status = patch_process.SubpatchFinalOutputToFile(
+      &final_patch_prediction, ensemble_correction, &new_file);
+  new_file.Close();
+  if (status != C_OK) {
+    base::DeleteFile(new_file_path, false);
+    return status;
+  }
+
+  return C_OK;
+}
+
 }  // namespace
@@ -17,13 +17,17 @@
 #include <stddef.h>
 
 #include <limits>
+#include <memory>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
 #include "base/time/time.h"
 
 #include "courgette/crc.h"
 #include "courgette/difference_estimator.h"
+#include "courgette/parallel.h"
 #include "courgette/patch_generator_x86_32.h"
 #include "courgette/patcher_x86_32.h"
 #include "courgette/region.h"
@@ -238,6 +242,36 @@ void FreeGenerators(std::vector<TransformationPatchGenerator*>* generators) {
   generators->clear();
 }
 
+// Transforms the element pair of |generator|, the |index|-th of |count|, on any
+// thread, and sets |status| to the result.
+void TransformElement(TransformationPatchGenerator* generator,
+                      size_t index,
+                      size_t count,
+                      SourceStreamSet* corrected_parameters,
+                      SinkStreamSet* old_transformed_element,
+                      SinkStreamSet* new_transformed_element,
+                      Status* status) {
+  base::Time start_time = base::Time::Now();
+  *status = generator->Transform(corrected_parameters, old_transformed_element,
+                                 new_transformed_element);
+  VLOG(1) << "transformed element " << index + 1 << " of " << count << " "
+          << (base::Time::Now() - start_time).InSecondsF() << "s";
+}
+
+// Reforms the element of |generator|, the |index|-th of |count|, on any
+// thread, and sets |status| to the result.
+void ReformElement(TransformationPatchGenerator* generator,
+                   size_t index,
+                   size_t count,
+                   SourceStreamSet* transformed_element,
+                   SinkStream* reformed_element,
+                   Status* status) {
+  base::Time start_time = base::Time::Now();
+  *status = generator->Reform(transformed_element, reformed_element);
+  VLOG(1) << "reformed element " << index + 1 << " of " << count << " "
+          << (base::Time::Now() - start_time).InSecondsF() << "s";
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Status GenerateEnsemblePatch(SourceStream* base,
@@ -335,27 +369,47 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
+  // The elements are independent of each other, so they are transformed
+  // concurrently, each into its own streams.
+  std::vector<std::unique_ptr<SourceStreamSet>> all_single_parameters;
+  std::vector<std::unique_ptr<SinkStreamSet>>
+      all_single_predicted_transformed_elements;
+  std::vector<std::unique_ptr<SinkStreamSet>>
+      all_single_corrected_transformed_elements;
+  std::vector<Status> transform_statuses(number_of_transformations, C_OK);
+  std::vector<base::Closure> transform_tasks;
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
+    all_single_parameters.push_back(base::WrapUnique(new SourceStreamSet));
+    if (!corrected_parameters_source_set.ReadSet(
+            all_single_parameters.back().get()))
       return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+    all_single_predicted_transformed_elements.push_back(
+        base::WrapUnique(new SinkStreamSet));
+    all_single_corrected_transformed_elements.push_back(
+        base::WrapUnique(new SinkStreamSet));
+    transform_tasks.push_back(base::Bind(
+        &TransformElement, generators[i], i, number_of_transformations,
+        all_single_parameters.back().get(),
+        all_single_predicted_transformed_elements.back().get(),
+        all_single_corrected_transformed_elements.back().get(),
+        &transform_statuses[i]));
+  }
+  RunConcurrently(transform_tasks);
+
+  for (size_t i = 0;  i < number_of_transformations;  ++i) {
+    if (transform_statuses[i] != C_OK)
+      return transform_statuses[i];
+    if (!all_single_parameters[i]->Empty())
       return C_STREAM_NOT_CONSUMED;
     if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
+            all_single_predicted_transformed_elements[i].get()))
       return C_STREAM_ERROR;
     if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
+            all_single_corrected_transformed_elements[i].get()))
       return C_STREAM_ERROR;
   }
+  all_single_predicted_transformed_elements.clear();
+  all_single_corrected_transformed_elements.clear();
 
   if (!corrected_parameters_source_set.Empty())
     return C_STREAM_NOT_CONSUMED;
@@ -402,17 +456,34 @@ Status GenerateEnsemblePatch(SourceStream* base,
       .Init(&corrected_transformed_elements_source))
     return C_STREAM_ERROR;
 
+  // Reforming is independent for each element too. Each element is reformed
+  // into its own stream, and the streams are then appended in order.
+  std::vector<std::unique_ptr<SourceStreamSet>>
+      all_single_corrected_transformed_elements_sources;
+  std::vector<std::unique_ptr<SinkStream>> reformed_elements;
+  std::vector<Status> reform_statuses(number_of_transformations, C_OK);
+  std::vector<base::Closure> reform_tasks;
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_corrected_transformed_element;
+    all_single_corrected_transformed_elements_sources.push_back(
+        base::WrapUnique(new SourceStreamSet));
     if (!corrected_transformed_elements_source_set.ReadSet(
-            &single_corrected_transformed_element))
+            all_single_corrected_transformed_elements_sources.back().get()))
       return C_STREAM_ERROR;
-    Status status = generators[i]->Reform(&single_corrected_transformed_element,
-                                          &predicted_ensemble);
-    if (status != C_OK)
-      return status;
-    if (!single_corrected_transformed_element.Empty())
+    reformed_elements.push_back(base::WrapUnique(new SinkStream));
+    reform_tasks.push_back(base::Bind(
+        &ReformElement, generators[i], i, number_of_transformations,
+        all_single_corrected_transformed_elements_sources.back().get(),
+        reformed_elements.back().get(), &reform_statuses[i]));
+  }
+  RunConcurrently(reform_tasks);
+
+  for (size_t i = 0;  i < number_of_transformations;  ++i) {
+    if (reform_statuses[i] != C_OK)
+      return reform_statuses[i];
+    if (!all_single_corrected_transformed_elements_sources[i]->Empty())
       return C_STREAM_NOT_CONSUMED;
+    if (!predicted_ensemble.Append(reformed_elements[i].get()))
+      return C_STREAM_ERROR;
   }
 
   if (!corrected_transformed_elements_source_set.Empty())
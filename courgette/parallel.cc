@@ -0,0 +1,56 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/parallel.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
+
+namespace courgette {
+
+namespace {
+
+class ClosureDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ClosureDelegate(const base::Closure& closure) : closure_(closure) {}
+  ~ClosureDelegate() override {}
+
+  void Run() override { closure_.Run(); }
+
+ private:
+  base::Closure closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClosureDelegate);
+};
+
+}  // namespace
+
+void RunConcurrently(const std::vector<base::Closure>& tasks) {
+  if (tasks.empty())
+    return;
+  if (tasks.size() == 1) {
+    tasks[0].Run();
+    return;
+  }
+
+  int num_threads = static_cast<int>(std::min<size_t>(
+      tasks.size(), std::max(base::SysInfo::NumberOfProcessors(), 1)));
+  std::vector<std::unique_ptr<ClosureDelegate>> delegates;
+  base::DelegateSimpleThreadPool pool("courgette", num_threads);
+  for (const base::Closure& task : tasks) {
+    delegates.push_back(
+        std::unique_ptr<ClosureDelegate>(new ClosureDelegate(task)));
+    pool.AddWork(delegates.back().get());
+  }
+  pool.Start();
+  pool.JoinAll();
+}
+
+}  // namespace courgette
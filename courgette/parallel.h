@@ -0,0 +1,21 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COURGETTE_PARALLEL_H_
+#define COURGETTE_PARALLEL_H_
+
+#include <vector>
+
+#include "base/callback.h"
+
+namespace courgette {
+
+// Runs |tasks| on a pool of up to one thread per processor, and returns once
+// all of them have completed. The tasks must not depend on each other. A single
+// task is run on the calling thread.
+void RunConcurrently(const std::vector<base::Closure>& tasks);
+
+}  // namespace courgette
+
+#endif  // COURGETTE_PARALLEL_H_
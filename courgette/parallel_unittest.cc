@@ -0,0 +1,52 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/parallel.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+void SetValue(size_t value, size_t* result) {
+  *result = value;
+}
+
+void RecordThread(base::PlatformThreadId* thread) {
+  *thread = base::PlatformThread::CurrentId();
+}
+
+}  // namespace
+
+TEST(ParallelTest, RunsAllTasks) {
+  const size_t kNumTasks = 37;
+  std::vector<size_t> results(kNumTasks, 0);
+  std::vector<base::Closure> tasks;
+  for (size_t i = 0; i < kNumTasks; ++i)
+    tasks.push_back(base::Bind(&SetValue, i + 1, &results[i]));
+
+  courgette::RunConcurrently(tasks);
+
+  for (size_t i = 0; i < kNumTasks; ++i)
+    EXPECT_EQ(i + 1, results[i]);
+}
+
+TEST(ParallelTest, RunsSingleTaskOnCallingThread) {
+  base::PlatformThreadId thread = base::kInvalidThreadId;
+  std::vector<base::Closure> tasks;
+  tasks.push_back(base::Bind(&RecordThread, &thread));
+
+  courgette::RunConcurrently(tasks);
+
+  EXPECT_EQ(base::PlatformThread::CurrentId(), thread);
+}
+
+TEST(ParallelTest, NoTasks) {
+  courgette::RunConcurrently(std::vector<base::Closure>());
+}
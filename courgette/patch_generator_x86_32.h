@@ -9,11 +9,14 @@
 #define COURGETTE_WIN32_X86_GENERATOR_H_
 
 #include <memory>
+#include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "courgette/assembly_program.h"
 #include "courgette/ensemble.h"
+#include "courgette/parallel.h"
 #include "courgette/patcher_x86_32.h"
 #include "courgette/program_detector.h"
 
@@ -62,42 +65,25 @@ class PatchGeneratorX86_32 : public TransformationPatchGenerator {
     if (!corrected_parameters->Empty())
       return C_GENERAL_ERROR;
 
-    // Generate old version of program using |corrected_parameters|.
-    // TODO(sra): refactor to use same code from patcher_.
+    // The old and new elements are parsed concurrently, and the old program
+    // is encoded and written while the new one may still be parsed. The two
+    // tasks share nothing but the read-only ensembles.
     std::unique_ptr<AssemblyProgram> old_program;
-    Status old_parse_status =
-        ParseDetectedExecutable(old_element_->region().start(),
-                                old_element_->region().length(),
-                                &old_program);
-    if (old_parse_status != C_OK) {
-      LOG(ERROR) << "Cannot parse an executable " << old_element_->Name();
-      return old_parse_status;
-    }
-
-    // TODO(huangs): Move the block below to right before |new_program| gets
-    // used, so we can reduce Courgette-gen peak memory.
+    Status old_status = C_OK;
     std::unique_ptr<AssemblyProgram> new_program;
-    Status new_parse_status =
-        ParseDetectedExecutable(new_element_->region().start(),
-                                new_element_->region().length(),
-                                &new_program);
-    if (new_parse_status != C_OK) {
-      LOG(ERROR) << "Cannot parse an executable " << new_element_->Name();
-      return new_parse_status;
-    }
-
-    std::unique_ptr<EncodedProgram> old_encoded;
-    Status old_encode_status = Encode(*old_program, &old_encoded);
-    if (old_encode_status != C_OK)
-      return old_encode_status;
-
-    Status old_write_status =
-        WriteEncodedProgram(old_encoded.get(), old_transformed_element);
-
-    old_encoded.reset();
-
-    if (old_write_status != C_OK)
-      return old_write_status;
+    Status new_status = C_OK;
+    std::vector<base::Closure> tasks;
+    tasks.push_back(base::Bind(&PatchGeneratorX86_32::TransformOldElement,
+                               base::Unretained(this), &old_program,
+                               old_transformed_element, &old_status));
+    tasks.push_back(base::Bind(&PatchGeneratorX86_32::ParseElement,
+                               base::Unretained(this), new_element_,
+                               &new_program, &new_status));
+    RunConcurrently(tasks);
+    if (old_status != C_OK)
+      return old_status;
+    if (new_status != C_OK)
+      return new_status;
 
     Status adjust_status = Adjust(*old_program, new_program.get());
     old_program.reset();
@@ -123,6 +109,34 @@ class PatchGeneratorX86_32 : public TransformationPatchGenerator {
   }
 
  private:
+  // Generates a version of the program in |element|.
+  // TODO(sra): refactor to use same code from patcher_.
+  void ParseElement(Element* element,
+                    std::unique_ptr<AssemblyProgram>* program,
+                    Status* status) {
+    *status = ParseDetectedExecutable(element->region().start(),
+                                      element->region().length(), program);
+    if (*status != C_OK)
+      LOG(ERROR) << "Cannot parse an executable " << element->Name();
+  }
+
+  // Parses the old element into |old_program|, and writes it encoded to
+  // |old_transformed_element|.
+  void TransformOldElement(std::unique_ptr<AssemblyProgram>* old_program,
+                           SinkStreamSet* old_transformed_element,
+                           Status* status) {
+    ParseElement(old_element_, old_program, status);
+    if (*status != C_OK)
+      return;
+
+    std::unique_ptr<EncodedProgram> old_encoded;
+    *status = Encode(**old_program, &old_encoded);
+    if (*status != C_OK)
+      return;
+
+    *status = WriteEncodedProgram(old_encoded.get(), old_transformed_element);
+  }
+
   virtual ~PatchGeneratorX86_32() { }
 
   ExecutableType kind_;
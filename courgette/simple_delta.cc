@@ -19,6 +19,7 @@ Status BSDiffStatusToStatus(BSDiffStatus status) {
   switch (status) {
     case OK: return C_OK;
     case CRC_ERROR: return C_BINARY_DIFF_CRC_ERROR;
+    case WRITE_ERROR: return C_WRITE_ERROR;
     default: return C_GENERAL_ERROR;
   }
 }
@@ -30,6 +31,13 @@ Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
   return BSDiffStatusToStatus(ApplyBinaryPatch(old, delta, target));
 }
 
+Status ApplySimpleDeltaToFile(SourceStream* old, SourceStream* delta,
+                              size_t window_size, base::File* target_file,
+                              uint32_t* target_crc) {
+  return BSDiffStatusToStatus(
+      ApplyBinaryPatch(old, delta, window_size, target_file, target_crc));
+}
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta) {
   VLOG(1) << "GenerateSimpleDelta " << old->Remaining()
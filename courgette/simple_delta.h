@@ -7,14 +7,27 @@
 #ifndef COURGETTE_SIMPLE_DELTA_H_
 #define COURGETTE_SIMPLE_DELTA_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "courgette/courgette.h"
 #include "courgette/streams.h"
 
+namespace base {
+class File;
+}
+
 namespace courgette {
 
 Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
                         SinkStream* target);
 
+// As above, but writes |target| to |target_file| through a buffer of
+// |window_size| bytes and sets |target_crc| to its CRC.
+Status ApplySimpleDeltaToFile(SourceStream* old, SourceStream* delta,
+                              size_t window_size, base::File* target_file,
+                              uint32_t* target_crc);
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta);
 
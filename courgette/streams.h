@@ -220,14 +220,16 @@ class SinkStreamSet {
   // SourceStreamSet with a buffer containing the data.
   CheckBool CopyTo(SinkStream* combined_stream) WARN_UNUSED_RESULT;
 
+  // Writes the metadata that CopyTo writes before the contents of the
+  // streams, so that they can be serialized elsewhere one at a time.
+  CheckBool CopyHeaderTo(SinkStream* stream) WARN_UNUSED_RESULT;
+
   // Writes the streams of |set| into the corresponding streams of |this|.
   // Stream zero first has some metadata written to it.  |set| becomes retired.
   // Partner to SourceStreamSet::ReadSet.
   CheckBool WriteSet(SinkStreamSet* set) WARN_UNUSED_RESULT;
 
  private:
-  CheckBool CopyHeaderTo(SinkStream* stream) WARN_UNUSED_RESULT;
-
   size_t count_;
   SinkStream streams_[kMaxStreams];
 
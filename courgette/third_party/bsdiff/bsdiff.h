@@ -42,8 +42,10 @@
 #ifndef COURGETTE_THIRD_PARTY_BSDIFF_BSDIFF_H_
 #define COURGETTE_THIRD_PARTY_BSDIFF_BSDIFF_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "base/files/file.h"
 #include "base/files/file_util.h"
 
 namespace courgette {
@@ -74,6 +76,15 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
                               SourceStream* patch_stream,
                               SinkStream* new_stream);
 
+// As above, but writes the new data to |new_file| through a buffer of
+// |window_size| bytes instead of accumulating it in memory, and sets |new_crc|
+// to its CRC, as computed by CalculateCrc().
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
+                              SourceStream* patch_stream,
+                              size_t window_size,
+                              base::File* new_file,
+                              uint32_t* new_crc);
+
 // As above, but simply takes the file paths.
 BSDiffStatus ApplyBinaryPatch(const base::FilePath& old_stream,
                               const base::FilePath& patch_stream,
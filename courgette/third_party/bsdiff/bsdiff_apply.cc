@@ -40,12 +40,96 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "base/files/file.h"
 #include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
 #include "courgette/crc.h"
 #include "courgette/streams.h"
 
 namespace courgette {
 
+namespace {
+
+// Receives the new data produced by MBS_ApplyPatch, in order.
+class PatchOutput {
+ public:
+  virtual ~PatchOutput() {}
+  virtual bool Reserve(size_t length) = 0;
+  virtual bool Write(const uint8_t* data, size_t length) = 0;
+};
+
+// Accumulates the new data in a SinkStream.
+class SinkStreamOutput : public PatchOutput {
+ public:
+  explicit SinkStreamOutput(SinkStream* stream) : stream_(stream) {}
+
+  bool Reserve(size_t length) override { return stream_->Reserve(length); }
+
+  bool Write(const uint8_t* data, size_t length) override {
+    return stream_->Write(data, length);
+  }
+
+ private:
+  SinkStream* stream_;
+
+  DISALLOW_COPY_AND_ASSIGN(SinkStreamOutput);
+};
+
+// Writes the new data to a file through a buffer of a fixed size, and computes
+// its CRC on the way.
+class WindowedFileOutput : public PatchOutput {
+ public:
+  WindowedFileOutput(size_t window_size, base::File* file)
+      : window_size_(std::max<size_t>(window_size, 1)),
+        file_(file),
+        crc_(CalculateCrc(NULL, 0)) {}
+
+  bool Reserve(size_t length) override { return true; }
+
+  bool Write(const uint8_t* data, size_t length) override {
+    while (length) {
+      if (window_.empty())
+        window_.reserve(window_size_);
+      size_t count = std::min(length, window_size_ - window_.size());
+      window_.insert(window_.end(), data, data + count);
+      data += count;
+      length -= count;
+      if (window_.size() == window_size_ && !Flush())
+        return false;
+    }
+    return true;
+  }
+
+  // Writes out the buffered data.
+  bool Flush() {
+    if (window_.empty())
+      return true;
+    crc_ = UpdateCrc(crc_, window_.data(), window_.size());
+    int size = static_cast<int>(window_.size());
+    if (file_->WriteAtCurrentPos(reinterpret_cast<const char*>(window_.data()),
+                                 size) != size) {
+      return false;
+    }
+    window_.clear();
+    return true;
+  }
+
+  uint32_t crc() const { return crc_; }
+
+ private:
+  const size_t window_size_;
+  base::File* file_;
+  std::vector<uint8_t> window_;
+  uint32_t crc_;
+
+  DISALLOW_COPY_AND_ASSIGN(WindowedFileOutput);
+};
+
+}  // namespace
+
 BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   if (!stream->Read(header->tag, sizeof(header->tag)))
     return READ_ERROR;
@@ -69,7 +153,7 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader* header,
                             SourceStream* patch_stream,
                             const uint8_t* old_start,
                             size_t old_size,
-                            SinkStream* new_stream) {
+                            PatchOutput* new_stream) {
   const uint8_t* old_end = old_start + old_size;
 
   SourceStreamSet patch_streams;
@@ -115,22 +199,28 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader* header,
     if (copy_count > static_cast<size_t>(old_end - old_position))
       return UNEXPECTED_ERROR;
 
-    // Add together bytes from the 'old' file and the 'diff' stream.
-    for (size_t i = 0; i < copy_count; ++i) {
-      uint8_t diff_byte = 0;
-      if (pending_diff_zeros) {
-        --pending_diff_zeros;
-      } else {
-        if (!diff_skips->ReadVarint32(&pending_diff_zeros))
-          return UNEXPECTED_ERROR;
-        if (!diff_bytes->Read(&diff_byte, 1))
-          return UNEXPECTED_ERROR;
+    // Add together bytes from the 'old' file and the 'diff' stream, a chunk
+    // at a time.
+    while (copy_count) {
+      uint8_t chunk[256];
+      size_t chunk_size = std::min<size_t>(copy_count, sizeof(chunk));
+      for (size_t i = 0; i < chunk_size; ++i) {
+        uint8_t diff_byte = 0;
+        if (pending_diff_zeros) {
+          --pending_diff_zeros;
+        } else {
+          if (!diff_skips->ReadVarint32(&pending_diff_zeros))
+            return UNEXPECTED_ERROR;
+          if (!diff_bytes->Read(&diff_byte, 1))
+            return UNEXPECTED_ERROR;
+        }
+        chunk[i] = old_position[i] + diff_byte;
       }
-      uint8_t byte = old_position[i] + diff_byte;
-      if (!new_stream->Write(&byte, 1))
+      if (!new_stream->Write(chunk, chunk_size))
         return MEM_ERROR;
+      old_position += chunk_size;
+      copy_count -= chunk_size;
     }
-    old_position += copy_count;
 
     // Copy bytes from the extra block.
     if (extra_count > static_cast<size_t>(extra_end - extra_position))
@@ -174,8 +264,42 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
   if (CalculateCrc(old_start, old_size) != header.scrc32)
     return CRC_ERROR;
 
-  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream);
+  SinkStreamOutput output(new_stream);
+  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, &output);
+
+  return OK;
+}
+
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
+                              SourceStream* patch_stream,
+                              size_t window_size,
+                              base::File* new_file,
+                              uint32_t* new_crc) {
+  MBSPatchHeader header;
+  BSDiffStatus ret = MBS_ReadHeader(patch_stream, &header);
+  if (ret != OK)
+    return ret;
+
+  const uint8_t* old_start = old_stream->Buffer();
+  size_t old_size = old_stream->Remaining();
+
+  if (old_size != header.slen)
+    return UNEXPECTED_ERROR;
+
+  if (CalculateCrc(old_start, old_size) != header.scrc32)
+    return CRC_ERROR;
+
+  // Like the version above, this only fails if the output cannot be written.
+  // Patches made by CreateBinaryPatch() fail the check for unused data at the
+  // end of MBS_ApplyPatch().
+  WindowedFileOutput output(window_size, new_file);
+  if (MBS_ApplyPatch(&header, patch_stream, old_start, old_size, &output) ==
+          MEM_ERROR ||
+      !output.Flush()) {
+    return WRITE_ERROR;
+  }
 
+  *new_crc = output.crc();
   return OK;
 }
 
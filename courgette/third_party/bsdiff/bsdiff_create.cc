@@ -64,6 +64,7 @@
 #include "courgette/streams.h"
 #include "courgette/third_party/bsdiff/paged_array.h"
 #include "courgette/third_party/bsdiff/qsufsort.h"
+#include "courgette/third_party/bsdiff/sais.h"
 
 namespace courgette {
 
@@ -96,7 +97,6 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
   uint32_t pending_diff_zeros = 0;
 
   PagedArray<int> I;
-  PagedArray<int> V;
 
   if (!I.Allocate(oldsize + 1)) {
     LOG(ERROR) << "Could not allocate I[], " << ((oldsize + 1) * sizeof(int))
@@ -104,17 +104,10 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
     return MEM_ERROR;
   }
 
-  if (!V.Allocate(oldsize + 1)) {
-    LOG(ERROR) << "Could not allocate V[], " << ((oldsize + 1) * sizeof(int))
-               << " bytes";
-    return MEM_ERROR;
-  }
-
   base::Time q_start_time = base::Time::Now();
-  qsuf::qsufsort<PagedArray<int>&>(I, V, old, oldsize);
-  VLOG(1) << " done qsufsort "
+  sais::SuffixSort(old, oldsize, I.begin());
+  VLOG(1) << " done SuffixSort "
           << (base::Time::Now() - q_start_time).InSecondsF();
-  V.clear();
 
   const uint8_t* newbuf = new_stream->Buffer();
   const int newsize = static_cast<int>(new_stream->Remaining());
@@ -48,6 +48,8 @@
 #ifndef COURGETTE_THIRD_PARTY_BSDIFF_QSUFSORT_H_
 #define COURGETTE_THIRD_PARTY_BSDIFF_QSUFSORT_H_
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <cstring>
 
@@ -63,6 +65,7 @@ namespace qsuf {
 // (3) using 'const',
 // (4) changing the V and I parameters from int* to template <typename T>.
 // (5) optimizing split() and search(); fix styles.
+// (6) optimizing matchlen().
 //
 // The code appears to be a rewritten version of the suffix array algorithm
 // presented in "Faster Suffix Sorting" by N. Jesper Larsson and Kunihiko
@@ -224,9 +227,19 @@ static int matchlen(const unsigned char* old,
                     int oldsize,
                     const unsigned char* newbuf,
                     int newsize) {
-  int i;
+  int size = std::min(oldsize, newsize);
+  int i = 0;
 
-  for (i = 0; (i < oldsize) && (i < newsize); i++)
+  // Skip the equal words, then find the first mismatch in the last one.
+  for (; i + static_cast<int>(sizeof(uint64_t)) <= size;
+       i += sizeof(uint64_t)) {
+    uint64_t old_word, new_word;
+    memcpy(&old_word, old + i, sizeof(old_word));
+    memcpy(&new_word, newbuf + i, sizeof(new_word));
+    if (old_word != new_word)
+      break;
+  }
+  for (; i < size; i++)
     if (old[i] != newbuf[i])
       break;
 
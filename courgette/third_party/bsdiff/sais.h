@@ -0,0 +1,198 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SA-IS suffix array construction, from "Two Efficient Algorithms for Linear
+// Time Suffix Array Construction" by Ge Nong, Sen Zhang and Wai Hong Chan.
+// It runs in linear time, unlike qsufsort() which is O(n log n), and needs no
+// array besides the suffix array itself, apart from a bit per character and
+// the character buckets.
+
+#ifndef COURGETTE_THIRD_PARTY_BSDIFF_SAIS_H_
+#define COURGETTE_THIRD_PARTY_BSDIFF_SAIS_H_
+
+#include <vector>
+
+namespace courgette {
+namespace sais {
+
+namespace internal {
+
+// The characters of the top-level text: the bytes shifted up by one, followed
+// by a sentinel 0 that is smaller than all of them.
+class ByteText {
+ public:
+  ByteText(const unsigned char* bytes, int size)
+      : bytes_(bytes), size_(size) {}
+
+  int operator[](int i) const { return i < size_ ? bytes_[i] + 1 : 0; }
+
+ private:
+  const unsigned char* bytes_;
+  int size_;
+};
+
+// Sets |buckets| to the start, or the end if |end|, of the bucket of each
+// character of |text| in the suffix array.
+template <class Text>
+void ComputeBuckets(const Text& text,
+                    int n,
+                    int k,
+                    bool end,
+                    std::vector<int>* buckets) {
+  buckets->assign(k + 1, 0);
+  for (int i = 0; i < n; ++i)
+    ++(*buckets)[text[i]];
+  int sum = 0;
+  for (int c = 0; c <= k; ++c) {
+    sum += (*buckets)[c];
+    (*buckets)[c] = end ? sum : sum - (*buckets)[c];
+  }
+}
+
+// Places the L-type suffixes after the sorted suffixes already in |sa|.
+template <class Text, class Iter>
+void InduceL(const Text& text,
+             const std::vector<bool>& is_s,
+             int n,
+             int k,
+             Iter sa,
+             std::vector<int>* buckets) {
+  ComputeBuckets(text, n, k, false, buckets);
+  for (int i = 0; i < n; ++i) {
+    int j = sa[i] - 1;
+    if (j >= 0 && !is_s[j])
+      sa[(*buckets)[text[j]]++] = j;
+  }
+}
+
+// Places the S-type suffixes before the sorted suffixes already in |sa|.
+template <class Text, class Iter>
+void InduceS(const Text& text,
+             const std::vector<bool>& is_s,
+             int n,
+             int k,
+             Iter sa,
+             std::vector<int>* buckets) {
+  ComputeBuckets(text, n, k, true, buckets);
+  for (int i = n - 1; i >= 0; --i) {
+    int j = sa[i] - 1;
+    if (j >= 0 && is_s[j])
+      sa[--(*buckets)[text[j]]] = j;
+  }
+}
+
+// Writes the suffix array of |text| to |sa|. |text| has |n| characters in
+// [0, k], and ends with a 0 that appears nowhere else. The reduced problem is
+// stored in, and solved in, the unused part of |sa|.
+template <class Text, class Iter>
+void SuffixSort(const Text& text, int n, int k, Iter sa) {
+  if (n == 1) {
+    sa[0] = 0;
+    return;
+  }
+
+  // Classify the suffixes: S-type if smaller than the next one, else L-type.
+  // The leftmost S-type suffixes (LMS) are those after an L-type one.
+  std::vector<bool> is_s(n);
+  is_s[n - 1] = true;
+  is_s[n - 2] = false;
+  for (int i = n - 3; i >= 0; --i) {
+    is_s[i] =
+        text[i] < text[i + 1] || (text[i] == text[i + 1] && is_s[i + 1]);
+  }
+  auto is_lms = [&is_s](int i) { return i > 0 && is_s[i] && !is_s[i - 1]; };
+
+  // Sort the LMS substrings by inducing from the LMS characters.
+  std::vector<int> buckets;
+  ComputeBuckets(text, n, k, true, &buckets);
+  for (int i = 0; i < n; ++i)
+    sa[i] = -1;
+  for (int i = 1; i < n; ++i) {
+    if (is_lms(i))
+      sa[--buckets[text[i]]] = i;
+  }
+  InduceL(text, is_s, n, k, sa, &buckets);
+  InduceS(text, is_s, n, k, sa, &buckets);
+
+  // Gather the sorted LMS substrings at the start of |sa|.
+  int n1 = 0;
+  for (int i = 0; i < n; ++i) {
+    if (is_lms(sa[i]))
+      sa[n1++] = sa[i];
+  }
+
+  // Name the LMS substrings by rank, equal substrings getting equal names,
+  // and store the names in text order at the end of |sa|. LMS positions are
+  // at least 2 apart, so they can be halved without colliding.
+  for (int i = n1; i < n; ++i)
+    sa[i] = -1;
+  int name = 0;
+  int prev = -1;
+  for (int i = 0; i < n1; ++i) {
+    int pos = sa[i];
+    bool diff = false;
+    for (int d = 0;; ++d) {
+      if (prev == -1 || text[pos + d] != text[prev + d] ||
+          is_s[pos + d] != is_s[prev + d]) {
+        diff = true;
+        break;
+      }
+      if (d > 0 && (is_lms(pos + d) || is_lms(prev + d)))
+        break;
+    }
+    if (diff) {
+      ++name;
+      prev = pos;
+    }
+    sa[n1 + pos / 2] = name - 1;
+  }
+  for (int i = n - 1, j = n - 1; i >= n1; --i) {
+    if (sa[i] >= 0)
+      sa[j--] = sa[i];
+  }
+
+  // Sort the LMS suffixes: directly if their names are unique, else by
+  // sorting the reduced text of names.
+  Iter reduced_text = sa + (n - n1);
+  if (name < n1) {
+    SuffixSort(reduced_text, n1, name - 1, sa);
+  } else {
+    for (int i = 0; i < n1; ++i)
+      sa[reduced_text[i]] = i;
+  }
+
+  // Induce the order of all suffixes from the sorted LMS suffixes.
+  ComputeBuckets(text, n, k, true, &buckets);
+  for (int i = 1, j = 0; i < n; ++i) {
+    if (is_lms(i))
+      reduced_text[j++] = i;
+  }
+  for (int i = 0; i < n1; ++i)
+    sa[i] = reduced_text[sa[i]];
+  for (int i = n1; i < n; ++i)
+    sa[i] = -1;
+  for (int i = n1 - 1; i >= 0; --i) {
+    int j = sa[i];
+    sa[i] = -1;
+    sa[--buckets[text[j]]] = j;
+  }
+  InduceL(text, is_s, n, k, sa, &buckets);
+  InduceS(text, is_s, n, k, sa, &buckets);
+}
+
+}  // namespace internal
+
+// Writes the suffix array of the |size| bytes at |text|, including the empty
+// suffix, to the |size + 1| elements at |sa|, in the same layout as the I
+// array of qsufsort(): sa[0] == size. |Iter| is a random access iterator to
+// int, e.g. int* or PagedArray<int>::iterator.
+template <class Iter>
+void SuffixSort(const unsigned char* text, int size, Iter sa) {
+  internal::SuffixSort(internal::ByteText(text, size), size + 1, 256, sa);
+}
+
+}  // namespace sais
+}  // namespace courgette
+
+#endif  // COURGETTE_THIRD_PARTY_BSDIFF_SAIS_H_
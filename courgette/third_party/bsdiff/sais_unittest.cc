@@ -0,0 +1,84 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/third_party/bsdiff/sais.h"
+
+#include <stddef.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "courgette/third_party/bsdiff/paged_array.h"
+#include "courgette/third_party/bsdiff/qsufsort.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Expects SuffixSort() to produce the same suffix array as qsufsort(), which
+// is unique since the suffixes are all different.
+void TestSuffixSort(const std::string& text) {
+  int size = static_cast<int>(text.size());
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(text.data());
+
+  std::vector<int> expected_sa(size + 1);
+  std::vector<int> v(size + 1);
+  courgette::qsuf::qsufsort<int*>(&expected_sa[0], &v[0], bytes, size);
+
+  std::vector<int> sa(size + 1);
+  courgette::sais::SuffixSort(bytes, size, &sa[0]);
+  EXPECT_EQ(expected_sa, sa) << "size " << size;
+
+  courgette::PagedArray<int> paged_sa;
+  ASSERT_TRUE(paged_sa.Allocate(size + 1));
+  courgette::sais::SuffixSort(bytes, size, paged_sa.begin());
+  for (int i = 0; i < size + 1; ++i)
+    EXPECT_EQ(expected_sa[i], paged_sa[i]) << "size " << size << " i " << i;
+}
+
+}  // namespace
+
+TEST(SaisTest, Sort) {
+  const char* test_cases[] = {
+      "",
+      "a",
+      "za",
+      "aa",
+      "CACAO",
+      "banana",
+      "mississippi",
+      "tobeornottobe",
+      "The quick brown fox jumps over the lazy dog.",
+      "elephantelephantelephantelephantelephant",
+      "-------------------------",
+      "011010011001011010010110011010010",
+      "3141592653589793238462643383279502884197169399375105",
+      "\xFF\xFE\xFF\xFE\xFD\x80\x30\x31\x32\x80\x30\xFF\x01\xAB\xCD",
+  };
+
+  for (size_t idx = 0; idx < arraysize(test_cases); ++idx)
+    TestSuffixSort(test_cases[idx]);
+}
+
+TEST(SaisTest, SortWithZeros) {
+  TestSuffixSort(std::string(1, '\0'));
+  TestSuffixSort(std::string(100, '\0'));
+  TestSuffixSort(std::string("\0a\0a\0a\0b\0", 9));
+}
+
+TEST(SaisTest, SortSyntheticInputs) {
+  // Inputs over small alphabets have many repeats, and recurse deeply.
+  for (int alphabet_size : {2, 3, 17, 256}) {
+    std::string text;
+    unsigned seed = alphabet_size;
+    for (int i = 0; i < 10000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      text.push_back(static_cast<char>((seed >> 16) % alphabet_size));
+    }
+    TestSuffixSort(text);
+    TestSuffixSort(text + text);
+  }
+}
@@ -25,12 +25,21 @@ Aead::Aead(AeadAlgorithm algorithm) : key_(nullptr) {
 }
 
 Aead::~Aead() {
+  if (ctx_)
+    EVP_AEAD_CTX_cleanup(ctx_.get());
 }
 
 void Aead::Init(const std::string* key) {
   DCHECK(!key_);
   DCHECK_EQ(KeyLength(), key->size());
   key_ = key;
+
+  ctx_.reset(new EVP_AEAD_CTX);
+  if (!EVP_AEAD_CTX_init(ctx_.get(), aead_,
+                         reinterpret_cast<const uint8_t*>(key_->data()),
+                         key_->size(), EVP_AEAD_DEFAULT_TAG_LENGTH, nullptr)) {
+    ctx_.reset();
+  }
 }
 
 bool Aead::Seal(const base::StringPiece& plaintext,
@@ -39,13 +48,8 @@ bool Aead::Seal(const base::StringPiece& plaintext,
                 std::string* ciphertext) const {
   DCHECK(key_);
   DCHECK_EQ(NonceLength(), nonce.size());
-  EVP_AEAD_CTX ctx;
-
-  if (!EVP_AEAD_CTX_init(&ctx, aead_,
-                         reinterpret_cast<const uint8_t*>(key_->data()),
-                         key_->size(), EVP_AEAD_DEFAULT_TAG_LENGTH, nullptr)) {
+  if (!ctx_)
     return false;
-  }
 
   std::string result;
   const size_t max_output_length =
@@ -55,12 +59,11 @@ bool Aead::Seal(const base::StringPiece& plaintext,
       base::WriteInto(&result, max_output_length + 1));
 
   if (!EVP_AEAD_CTX_seal(
-          &ctx, out_ptr, &output_length, max_output_length,
+          ctx_.get(), out_ptr, &output_length, max_output_length,
           reinterpret_cast<const uint8_t*>(nonce.data()), nonce.size(),
           reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
           reinterpret_cast<const uint8_t*>(additional_data.data()),
           additional_data.size())) {
-    EVP_AEAD_CTX_cleanup(&ctx);
     return false;
   }
 
@@ -68,7 +71,6 @@ bool Aead::Seal(const base::StringPiece& plaintext,
   result.resize(output_length);
 
   ciphertext->swap(result);
-  EVP_AEAD_CTX_cleanup(&ctx);
 
   return true;
 }
@@ -78,13 +80,8 @@ bool Aead::Open(const base::StringPiece& ciphertext,
                 const base::StringPiece& additional_data,
                 std::string* plaintext) const {
   DCHECK(key_);
-  EVP_AEAD_CTX ctx;
-
-  if (!EVP_AEAD_CTX_init(&ctx, aead_,
-                         reinterpret_cast<const uint8_t*>(key_->data()),
-                         key_->size(), EVP_AEAD_DEFAULT_TAG_LENGTH, nullptr)) {
+  if (!ctx_)
     return false;
-  }
 
   std::string result;
   const size_t max_output_length = ciphertext.size();
@@ -93,13 +90,12 @@ bool Aead::Open(const base::StringPiece& ciphertext,
       base::WriteInto(&result, max_output_length + 1));
 
   if (!EVP_AEAD_CTX_open(
-          &ctx, out_ptr, &output_length, max_output_length,
+          ctx_.get(), out_ptr, &output_length, max_output_length,
           reinterpret_cast<const uint8_t*>(nonce.data()), nonce.size(),
           reinterpret_cast<const uint8_t*>(ciphertext.data()),
           ciphertext.size(),
           reinterpret_cast<const uint8_t*>(additional_data.data()),
           additional_data.size())) {
-    EVP_AEAD_CTX_cleanup(&ctx);
     return false;
   }
 
@@ -107,7 +103,6 @@ bool Aead::Open(const base::StringPiece& ciphertext,
   result.resize(output_length);
 
   plaintext->swap(result);
-  EVP_AEAD_CTX_cleanup(&ctx);
 
   return true;
 }
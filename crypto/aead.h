@@ -7,10 +7,13 @@
 
 #include <stddef.h>
 
+#include <memory>
+
 #include "base/strings/string_piece.h"
 #include "crypto/crypto_export.h"
 
 struct evp_aead_st;
+struct evp_aead_ctx_st;
 
 namespace crypto {
 
@@ -42,6 +45,9 @@ class CRYPTO_EXPORT Aead {
  private:
   const std::string* key_;
   const evp_aead_st* aead_;
+  // Set up with |key_| by Init(), and used by every Seal() and Open(). Null if
+  // that failed.
+  std::unique_ptr<evp_aead_ctx_st> ctx_;
 };
 
 }  // namespace crypto
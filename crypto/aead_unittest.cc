@@ -27,6 +27,23 @@ TEST(AeadTest, SealOpen) {
   EXPECT_EQ(plaintext, decrypted);
 }
 
+TEST(AeadTest, SealOpenMultiple) {
+  crypto::Aead aead(crypto::Aead::AES_128_CTR_HMAC_SHA256);
+  std::string key(aead.KeyLength(), 0);
+  aead.Init(&key);
+  std::string ad("this is the additional data");
+  for (int i = 0; i < 3; ++i) {
+    std::string nonce(aead.NonceLength(), static_cast<char>(i));
+    std::string plaintext(i * 10, 'a' + i);
+    std::string ciphertext;
+    EXPECT_TRUE(aead.Seal(plaintext, nonce, ad, &ciphertext));
+
+    std::string decrypted;
+    EXPECT_TRUE(aead.Open(ciphertext, nonce, ad, &decrypted));
+    EXPECT_EQ(plaintext, decrypted);
+  }
+}
+
 TEST(AeadTest, SealOpenWrongKey) {
   crypto::Aead aead(crypto::Aead::AES_128_CTR_HMAC_SHA256);
   std::string key(aead.KeyLength(), 0);
@@ -10,7 +10,6 @@
 #include <algorithm>
 
 #include "base/logging.h"
-#include "base/stl_util.h"
 #include "crypto/openssl_util.h"
 #include "crypto/secure_util.h"
 #include "crypto/symmetric_key.h"
@@ -23,9 +22,9 @@ HMAC::HMAC(HashAlgorithm hash_alg) : hash_alg_(hash_alg), initialized_(false) {
 }
 
 HMAC::~HMAC() {
-  // Zero out key copy.
-  key_.assign(key_.size(), 0);
-  STLClearObject(&key_);
+  // Zeroes out the key material.
+  if (key_ctx_)
+    HMAC_CTX_cleanup(key_ctx_.get());
 }
 
 size_t HMAC::DigestLength() const {
@@ -44,8 +43,11 @@ bool HMAC::Init(const unsigned char* key, size_t key_length) {
   // Init must not be called more than once on the same HMAC object.
   DCHECK(!initialized_);
   initialized_ = true;
-  key_.assign(key, key + key_length);
-  return true;
+  key_ctx_.reset(new HMAC_CTX);
+  HMAC_CTX_init(key_ctx_.get());
+  return !!HMAC_Init_ex(key_ctx_.get(), key, key_length,
+                        hash_alg_ == SHA1 ? EVP_sha1() : EVP_sha256(),
+                        nullptr);
 }
 
 bool HMAC::Init(SymmetricKey* key) {
@@ -63,10 +65,15 @@ bool HMAC::Sign(const base::StringPiece& data,
   DCHECK(initialized_);
 
   ScopedOpenSSLSafeSizeBuffer<EVP_MAX_MD_SIZE> result(digest, digest_length);
-  return !!::HMAC(hash_alg_ == SHA1 ? EVP_sha1() : EVP_sha256(),
-                  key_.data(), key_.size(),
-                  reinterpret_cast<const unsigned char*>(data.data()),
-                  data.size(), result.safe_buffer(), NULL);
+  HMAC_CTX ctx;
+  HMAC_CTX_init(&ctx);
+  bool success =
+      HMAC_CTX_copy_ex(&ctx, key_ctx_.get()) &&
+      HMAC_Update(&ctx, reinterpret_cast<const unsigned char*>(data.data()),
+                  data.size()) &&
+      HMAC_Final(&ctx, result.safe_buffer(), nullptr);
+  HMAC_CTX_cleanup(&ctx);
+  return success;
 }
 
 bool HMAC::Verify(const base::StringPiece& data,
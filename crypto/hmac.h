@@ -18,6 +18,8 @@
 #include "base/strings/string_piece.h"
 #include "crypto/crypto_export.h"
 
+struct hmac_ctx_st;
+
 namespace crypto {
 
 // Simplify the interface and reduce includes by abstracting out the internals.
@@ -87,7 +89,9 @@ class CRYPTO_EXPORT HMAC {
  private:
   HashAlgorithm hash_alg_;
   bool initialized_;
-  std::vector<unsigned char> key_;
+  // Set up with the key by Init(), and copied by every Sign() so that the key
+  // is only processed once.
+  std::unique_ptr<hmac_ctx_st> key_ctx_;
 
   DISALLOW_COPY_AND_ASSIGN(HMAC);
 };
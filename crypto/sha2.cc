@@ -4,19 +4,21 @@
 
 #include "crypto/sha2.h"
 
+#include <openssl/sha.h>
 #include <stddef.h>
 
-#include <memory>
-
 #include "base/stl_util.h"
-#include "crypto/secure_hash.h"
+#include "crypto/openssl_util.h"
 
 namespace crypto {
 
 void SHA256HashString(const base::StringPiece& str, void* output, size_t len) {
-  std::unique_ptr<SecureHash> ctx(SecureHash::Create(SecureHash::SHA256));
-  ctx->Update(str.data(), str.length());
-  ctx->Finish(output, len);
+  // Hash on the stack rather than through a heap allocated SecureHash, since
+  // this is called for many small inputs in a row.
+  ScopedOpenSSLSafeSizeBuffer<SHA256_DIGEST_LENGTH> result(
+      static_cast<unsigned char*>(output), len);
+  SHA256(reinterpret_cast<const unsigned char*>(str.data()), str.size(),
+         result.safe_buffer());
 }
 
 std::string SHA256HashString(const base::StringPiece& str) {
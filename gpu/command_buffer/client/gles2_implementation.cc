@@ -805,14 +805,26 @@ bool GLES2Implementation::GetHelper(GLenum pname, GLint* params) {
       *params = bound_renderbuffer_;
       return true;
     case GL_TEXTURE_BINDING_2D:
+      if (texture_units_[active_texture_unit_].bound_texture_2d ==
+          kUnknownTextureId) {
+        return false;
+      }
       *params = texture_units_[active_texture_unit_].bound_texture_2d;
       return true;
     case GL_TEXTURE_BINDING_CUBE_MAP:
+      if (texture_units_[active_texture_unit_].bound_texture_cube_map ==
+          kUnknownTextureId) {
+        return false;
+      }
       *params = texture_units_[active_texture_unit_].bound_texture_cube_map;
       return true;
 
     // Non-standard parameters.
     case GL_TEXTURE_BINDING_EXTERNAL_OES:
+      if (texture_units_[active_texture_unit_].bound_texture_external_oes ==
+          kUnknownTextureId) {
+        return false;
+      }
       *params =
           texture_units_[active_texture_unit_].bound_texture_external_oes;
       return true;
@@ -3958,8 +3970,10 @@ void GLES2Implementation::ActiveTexture(GLenum texture) {
     return;
   }
 
-  active_texture_unit_ = texture_index;
-  helper_->ActiveTexture(texture);
+  if (active_texture_unit_ != texture_index) {
+    active_texture_unit_ = texture_index;
+    helper_->ActiveTexture(texture);
+  }
   CheckGLError();
 }
 
@@ -3976,7 +3990,25 @@ void GLES2Implementation::GenRenderbuffersHelper(
 }
 
 void GLES2Implementation::GenTexturesHelper(
-    GLsizei /* n */, const GLuint* /* textures */) {
+    GLsizei n, const GLuint* textures) {
+  // A new id can only match a cached binding if another context in the share
+  // group deleted that texture while it was bound here. The service still has
+  // the deleted texture bound, so the next bind of the id must not be skipped.
+  for (GLsizei ii = 0; ii < n; ++ii) {
+    for (GLint tt = 0; tt < capabilities_.max_combined_texture_image_units;
+         ++tt) {
+      TextureUnit& unit = texture_units_[tt];
+      if (textures[ii] == unit.bound_texture_2d) {
+        unit.bound_texture_2d = kUnknownTextureId;
+      }
+      if (textures[ii] == unit.bound_texture_cube_map) {
+        unit.bound_texture_cube_map = kUnknownTextureId;
+      }
+      if (textures[ii] == unit.bound_texture_external_oes) {
+        unit.bound_texture_external_oes = kUnknownTextureId;
+      }
+    }
+  }
 }
 
 void GLES2Implementation::GenVertexArraysOESHelper(
@@ -4229,9 +4261,11 @@ void GLES2Implementation::BindSamplerHelper(GLuint unit,
 
 void GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
   // TODO(gman): See note #1 above.
-  // TODO(gman): Change this to false once we figure out why it's failing
-  //     on daisy.
-  bool changed = true;
+  // Binding the texture which is already bound is skipped. That is not safe
+  // when binds generate resources: another context may have deleted the
+  // texture, and binding its id then creates a new one without a GenTextures
+  // call to invalidate the cached binding.
+  bool changed = share_group_->bind_generates_resource();
   TextureUnit& unit = texture_units_[active_texture_unit_];
   switch (target) {
     case GL_TEXTURE_2D:
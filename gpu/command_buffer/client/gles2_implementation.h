@@ -375,6 +375,11 @@ class GLES2_IMPL_EXPORT GLES2Implementation
     GLsizeiptr size;
   };
 
+  // Cached texture binding of an id which was generated again after another
+  // context deleted the texture, so the service may have a different texture
+  // bound.
+  static const GLuint kUnknownTextureId = 0xFFFFFFFFu;
+
   struct TextureUnit {
     TextureUnit()
         : bound_texture_2d(0),
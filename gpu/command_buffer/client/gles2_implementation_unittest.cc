@@ -3327,6 +3327,79 @@ TEST_F(GLES2ImplementationTest, BindVertexArrayOES) {
   EXPECT_TRUE(NoCommandsWritten());
 }
 
+TEST_F(GLES2ImplementationTest, ActiveTextureSkipsCurrentUnit) {
+  struct Cmds {
+    cmds::ActiveTexture cmd;
+  };
+  Cmds expected;
+  expected.cmd.Init(GL_TEXTURE1);
+
+  const void* commands = GetPut();
+  gl_->ActiveTexture(GL_TEXTURE1);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+  ClearCommands();
+  gl_->ActiveTexture(GL_TEXTURE1);
+  EXPECT_TRUE(NoCommandsWritten());
+}
+
+TEST_F(GLES2ImplementationStrictSharedTest, BindTextureSkipsBoundTexture) {
+  GLuint id = 0;
+  gl_->GenTextures(1, &id);
+  ClearCommands();
+
+  struct Cmds {
+    cmds::BindTexture cmd;
+  };
+  Cmds expected;
+  expected.cmd.Init(GL_TEXTURE_2D, id);
+
+  const void* commands = GetPut();
+  gl_->BindTexture(GL_TEXTURE_2D, id);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+  ClearCommands();
+  gl_->BindTexture(GL_TEXTURE_2D, id);
+  EXPECT_TRUE(NoCommandsWritten());
+
+  // The binding is per texture unit.
+  gl_->ActiveTexture(GL_TEXTURE1);
+  ClearCommands();
+  commands = GetPut();
+  gl_->BindTexture(GL_TEXTURE_2D, id);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+}
+
+// A texture bound in one context can be deleted by another, after which its
+// id may be generated again. Binding the new texture must not be skipped.
+TEST_F(GLES2ImplementationStrictSharedTest,
+       BindTextureAfterCrossContextIdReuse) {
+  GLES2Implementation* gl1 = test_contexts_[0].gl_.get();
+  GLES2Implementation* gl2 = test_contexts_[1].gl_.get();
+  GLES2CmdHelper* helper2 = test_contexts_[1].helper_.get();
+  GLuint id1, id2, id3;
+
+  gl2->GenTextures(1, &id1);
+  gl2->BindTexture(GL_TEXTURE_2D, id1);
+
+  // Delete the texture on context 1 and let the id be freed.
+  gl1->DeleteTextures(1, &id1);
+  gl1->Flush();
+  gl1->GenTextures(1, &id2);
+  gl1->DeleteTextures(1, &id2);
+
+  gl2->GenTextures(1, &id3);
+  ASSERT_EQ(id1, id3);
+
+  struct Cmds {
+    cmds::BindTexture cmd;
+  };
+  Cmds expected;
+  expected.cmd.Init(GL_TEXTURE_2D, id3);
+
+  const void* commands = helper2->GetSpace(0);
+  gl2->BindTexture(GL_TEXTURE_2D, id3);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+}
+
 TEST_F(GLES2ImplementationTest, BeginEndQueryEXT) {
   // Test GetQueryivEXT returns 0 if no current query.
   GLint param = -1;
@@ -0,0 +1,184 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recording.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/trace_event/trace_event.h"
+#include "gpu/command_buffer/common/buffer.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+
+namespace gpu {
+
+namespace {
+
+const size_t kNumContextAttribs = 15;
+
+struct RecordHeader {
+  uint32_t type;
+  uint32_t payload_size;
+};
+
+}  // namespace
+
+// static
+std::unique_ptr<CommandBufferRecorder> CommandBufferRecorder::Create(
+    const base::FilePath& path,
+    const gles2::ContextCreationAttribHelper& attribs,
+    const gfx::Size& size) {
+  base::File file(path, base::File::FLAG_CREATE_ALWAYS |
+                            base::File::FLAG_WRITE);
+  if (!file.IsValid()) {
+    DLOG(ERROR) << "Failed to create command buffer recording "
+                << path.value();
+    return nullptr;
+  }
+
+  std::unique_ptr<CommandBufferRecorder> recorder =
+      base::WrapUnique(new CommandBufferRecorder(std::move(file)));
+  const int32_t values[kNumContextAttribs] = {
+      attribs.alpha_size,
+      attribs.blue_size,
+      attribs.green_size,
+      attribs.red_size,
+      attribs.depth_size,
+      attribs.stencil_size,
+      attribs.samples,
+      attribs.sample_buffers,
+      attribs.buffer_preserved,
+      attribs.bind_generates_resource,
+      attribs.fail_if_major_perf_caveat,
+      attribs.lose_context_when_out_of_memory,
+      attribs.context_type,
+      size.width(),
+      size.height(),
+  };
+  recorder->WriteRecord(kContextAttribs, values, sizeof(values), nullptr, 0);
+  return recorder;
+}
+
+CommandBufferRecorder::CommandBufferRecorder(base::File file)
+    : file_(std::move(file)) {}
+
+CommandBufferRecorder::~CommandBufferRecorder() {}
+
+void CommandBufferRecorder::RecordRegisterTransferBuffer(int32_t id,
+                                                         uint32_t size) {
+  const int32_t values[] = {id, static_cast<int32_t>(size)};
+  WriteRecord(kRegisterTransferBuffer, values, sizeof(values), nullptr, 0);
+  transfer_buffer_contents_[id].clear();
+}
+
+void CommandBufferRecorder::RecordDestroyTransferBuffer(int32_t id) {
+  WriteRecord(kDestroyTransferBuffer, &id, sizeof(id), nullptr, 0);
+  transfer_buffer_contents_.erase(id);
+}
+
+void CommandBufferRecorder::RecordSetGetBuffer(int32_t id) {
+  WriteRecord(kSetGetBuffer, &id, sizeof(id), nullptr, 0);
+}
+
+void CommandBufferRecorder::RecordFlush(
+    CommandBufferServiceBase* command_buffer,
+    int32_t put_offset) {
+  TRACE_EVENT0("gpu", "CommandBufferRecorder::RecordFlush");
+  for (auto& entry : transfer_buffer_contents_) {
+    scoped_refptr<Buffer> buffer =
+        command_buffer->GetTransferBuffer(entry.first);
+    if (!buffer)
+      continue;
+    const uint8_t* memory = static_cast<const uint8_t*>(buffer->memory());
+    std::vector<uint8_t>& contents = entry.second;
+    if (contents.size() == buffer->size() &&
+        !memcmp(contents.data(), memory, contents.size())) {
+      continue;
+    }
+    contents.assign(memory, memory + buffer->size());
+    WriteRecord(kTransferBufferContents, &entry.first, sizeof(entry.first),
+                contents.data(), contents.size());
+  }
+  WriteRecord(kFlush, &put_offset, sizeof(put_offset), nullptr, 0);
+}
+
+void CommandBufferRecorder::WriteRecord(CommandBufferRecordType type,
+                                        const void* payload,
+                                        size_t payload_size,
+                                        const void* extra_payload,
+                                        size_t extra_payload_size) {
+  RecordHeader header = {
+      type, static_cast<uint32_t>(payload_size + extra_payload_size)};
+  bool succeeded =
+      file_.WriteAtCurrentPos(reinterpret_cast<const char*>(&header),
+                              sizeof(header)) == sizeof(header) &&
+      file_.WriteAtCurrentPos(static_cast<const char*>(payload),
+                              payload_size) ==
+          static_cast<int>(payload_size);
+  if (succeeded && extra_payload_size) {
+    succeeded =
+        file_.WriteAtCurrentPos(static_cast<const char*>(extra_payload),
+                                extra_payload_size) ==
+        static_cast<int>(extra_payload_size);
+  }
+  DLOG_IF(ERROR, !succeeded) << "Failed to write command buffer recording.";
+}
+
+CommandBufferRecordingReader::CommandBufferRecordingReader(base::File file)
+    : file_(std::move(file)) {}
+
+CommandBufferRecordingReader::~CommandBufferRecordingReader() {}
+
+// static
+bool CommandBufferRecordingReader::ParseContextAttribs(
+    const std::vector<uint8_t>& payload,
+    gles2::ContextCreationAttribHelper* attribs,
+    gfx::Size* size) {
+  int32_t values[kNumContextAttribs];
+  if (payload.size() != sizeof(values))
+    return false;
+  memcpy(values, payload.data(), sizeof(values));
+  if (values[12] < 0 || values[12] > gles2::CONTEXT_TYPE_LAST)
+    return false;
+
+  attribs->alpha_size = values[0];
+  attribs->blue_size = values[1];
+  attribs->green_size = values[2];
+  attribs->red_size = values[3];
+  attribs->depth_size = values[4];
+  attribs->stencil_size = values[5];
+  attribs->samples = values[6];
+  attribs->sample_buffers = values[7];
+  attribs->buffer_preserved = !!values[8];
+  attribs->bind_generates_resource = !!values[9];
+  attribs->fail_if_major_perf_caveat = !!values[10];
+  attribs->lose_context_when_out_of_memory = !!values[11];
+  attribs->context_type = static_cast<gles2::ContextType>(values[12]);
+  size->SetSize(values[13], values[14]);
+  return true;
+}
+
+bool CommandBufferRecordingReader::ReadRecord(CommandBufferRecordType* type,
+                                              std::vector<uint8_t>* payload) {
+  RecordHeader header;
+  if (file_.ReadAtCurrentPos(reinterpret_cast<char*>(&header),
+                             sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  payload->resize(header.payload_size);
+  if (header.payload_size &&
+      file_.ReadAtCurrentPos(reinterpret_cast<char*>(payload->data()),
+                             header.payload_size) !=
+          static_cast<int>(header.payload_size)) {
+    return false;
+  }
+  *type = static_cast<CommandBufferRecordType>(header.type);
+  return true;
+}
+
+}  // namespace gpu
@@ -0,0 +1,112 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDING_H_
+#define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/macros.h"
+#include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/gpu_export.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace gpu {
+
+class CommandBufferServiceBase;
+
+// A recording of a command buffer is a file holding a sequence of records,
+// each a uint32_t type and a uint32_t payload size followed by the payload.
+// It starts with a kContextAttribs record and holds everything needed to feed
+// the same commands to a decoder again, provided they do not depend on state
+// shared with other contexts (mailboxes, images, sync tokens).
+enum CommandBufferRecordType : uint32_t {
+  // Payload: the int32_t fields of ContextCreationAttribHelper in declaration
+  // order followed by the width and height of the surface.
+  kContextAttribs = 0,
+  // Payload: int32_t id, uint32_t size.
+  kRegisterTransferBuffer = 1,
+  // Payload: int32_t id.
+  kDestroyTransferBuffer = 2,
+  // Payload: int32_t id.
+  kSetGetBuffer = 3,
+  // Payload: int32_t id followed by the whole contents of the buffer.
+  kTransferBufferContents = 4,
+  // Payload: int32_t put_offset.
+  kFlush = 5,
+};
+
+// Writes a recording of the commands a client sends to a command buffer, for
+// replaying them later with a standalone tool. Before each flush it writes the
+// contents of every transfer buffer which changed since the previous flush,
+// which costs a copy of every transfer buffer and lots of disk bandwidth, so
+// this is only meant for debugging and benchmarking.
+class GPU_EXPORT CommandBufferRecorder {
+ public:
+  // Returns nullptr if |path| could not be created.
+  static std::unique_ptr<CommandBufferRecorder> Create(
+      const base::FilePath& path,
+      const gles2::ContextCreationAttribHelper& attribs,
+      const gfx::Size& size);
+  ~CommandBufferRecorder();
+
+  void RecordRegisterTransferBuffer(int32_t id, uint32_t size);
+  void RecordDestroyTransferBuffer(int32_t id);
+  void RecordSetGetBuffer(int32_t id);
+
+  // Must be called before |command_buffer| processes the flush.
+  void RecordFlush(CommandBufferServiceBase* command_buffer,
+                   int32_t put_offset);
+
+ private:
+  explicit CommandBufferRecorder(base::File file);
+
+  void WriteRecord(CommandBufferRecordType type,
+                   const void* payload,
+                   size_t payload_size,
+                   const void* extra_payload,
+                   size_t extra_payload_size);
+
+  base::File file_;
+
+  // The contents of each transfer buffer as of the last flush.
+  std::map<int32_t, std::vector<uint8_t>> transfer_buffer_contents_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecorder);
+};
+
+// Reads the records written by CommandBufferRecorder, in order.
+class GPU_EXPORT CommandBufferRecordingReader {
+ public:
+  explicit CommandBufferRecordingReader(base::File file);
+  ~CommandBufferRecordingReader();
+
+  // Decodes the payload of a kContextAttribs record.
+  static bool ParseContextAttribs(const std::vector<uint8_t>& payload,
+                                  gles2::ContextCreationAttribHelper* attribs,
+                                  gfx::Size* size);
+
+  // Returns false at the end of the file or if the file is truncated.
+  bool ReadRecord(CommandBufferRecordType* type,
+                  std::vector<uint8_t>* payload);
+
+ private:
+  base::File file_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecordingReader);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDING_H_
@@ -0,0 +1,108 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recording.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+#include "gpu/command_buffer/service/transfer_buffer_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+
+namespace {
+
+int32_t ReadInt32(const std::vector<uint8_t>& payload, size_t index) {
+  int32_t value;
+  memcpy(&value, payload.data() + index * sizeof(value), sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+TEST(CommandBufferRecordingTest, RoundTrip) {
+  scoped_refptr<TransferBufferManager> transfer_buffer_manager =
+      new TransferBufferManager(nullptr);
+  ASSERT_TRUE(transfer_buffer_manager->Initialize());
+  CommandBufferService command_buffer(transfer_buffer_manager.get());
+  int32_t id;
+  scoped_refptr<Buffer> buffer = command_buffer.CreateTransferBuffer(16, &id);
+  ASSERT_TRUE(buffer);
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.path().AppendASCII("recording");
+  gles2::ContextCreationAttribHelper attribs;
+  attribs.alpha_size = 8;
+  attribs.bind_generates_resource = false;
+  attribs.context_type = gles2::CONTEXT_TYPE_OPENGLES3;
+  {
+    std::unique_ptr<CommandBufferRecorder> recorder =
+        CommandBufferRecorder::Create(path, attribs, gfx::Size(3, 4));
+    ASSERT_TRUE(recorder);
+    recorder->RecordRegisterTransferBuffer(id, 16);
+    recorder->RecordSetGetBuffer(id);
+    memset(buffer->memory(), 1, 16);
+    recorder->RecordFlush(&command_buffer, 2);
+    // The contents did not change, so they are not written again.
+    recorder->RecordFlush(&command_buffer, 3);
+    recorder->RecordDestroyTransferBuffer(id);
+  }
+
+  CommandBufferRecordingReader reader(
+      base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ));
+  CommandBufferRecordType type;
+  std::vector<uint8_t> payload;
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kContextAttribs, type);
+  gles2::ContextCreationAttribHelper read_attribs;
+  gfx::Size size;
+  ASSERT_TRUE(CommandBufferRecordingReader::ParseContextAttribs(
+      payload, &read_attribs, &size));
+  EXPECT_EQ(8, read_attribs.alpha_size);
+  EXPECT_FALSE(read_attribs.bind_generates_resource);
+  EXPECT_EQ(gles2::CONTEXT_TYPE_OPENGLES3, read_attribs.context_type);
+  EXPECT_EQ(gfx::Size(3, 4), size);
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kRegisterTransferBuffer, type);
+  EXPECT_EQ(id, ReadInt32(payload, 0));
+  EXPECT_EQ(16, ReadInt32(payload, 1));
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kSetGetBuffer, type);
+  EXPECT_EQ(id, ReadInt32(payload, 0));
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kTransferBufferContents, type);
+  ASSERT_EQ(sizeof(int32_t) + 16, payload.size());
+  EXPECT_EQ(id, ReadInt32(payload, 0));
+  EXPECT_EQ(std::vector<uint8_t>(16, 1),
+            std::vector<uint8_t>(payload.begin() + sizeof(int32_t),
+                                 payload.end()));
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kFlush, type);
+  EXPECT_EQ(2, ReadInt32(payload, 0));
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kFlush, type);
+  EXPECT_EQ(3, ReadInt32(payload, 0));
+
+  ASSERT_TRUE(reader.ReadRecord(&type, &payload));
+  EXPECT_EQ(kDestroyTransferBuffer, type);
+  EXPECT_EQ(id, ReadInt32(payload, 0));
+
+  EXPECT_FALSE(reader.ReadRecord(&type, &payload));
+}
+
+}  // namespace gpu
@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 
+#include "base/files/file_path.h"
 #include "base/macros.h"
 #include "build/build_config.h"
 #include "gpu/command_buffer/common/constants.h"
@@ -112,6 +113,11 @@ struct GPU_EXPORT GpuPreferences {
   // round intermediate values in ANGLE.
   bool emulate_shader_precision = false;
 
+  // Record the commands of every command buffer into a file in this
+  // directory, for replaying them with command_buffer_replay. Empty if
+  // recording is off.
+  base::FilePath record_gpu_command_buffers_dir;
+
   // ===================================
   // Settings from //ui/gl/gl_switches.h
 
@@ -67,6 +67,11 @@ const char kGLShaderIntermOutput[] = "gl-shader-interm-output";
 // round intermediate values in ANGLE.
 const char kEmulateShaderPrecision[] = "emulate-shader-precision";
 
+// Records the commands of every command buffer into a file in the given
+// directory, for replaying them with command_buffer_replay. The GPU process
+// sandbox must be disabled for the files to be created.
+const char kRecordGpuCommandBuffers[] = "record-gpu-command-buffers";
+
 // Use the Pass-through command decoder, skipping all validation and state
 // tracking.
 const char kUsePassthroughCmdDecoder[] = "use-passthrough-cmd-decoder";
@@ -29,6 +29,7 @@ GPU_EXPORT extern const char kEnableShareGroupAsyncTextureUpload[];
 GPU_EXPORT extern const char kEnableThreadedTextureMailboxes[];
 GPU_EXPORT extern const char kGLShaderIntermOutput[];
 GPU_EXPORT extern const char kEmulateShaderPrecision[];
+GPU_EXPORT extern const char kRecordGpuCommandBuffers[];
 GPU_EXPORT extern const char kUsePassthroughCmdDecoder[];
 
 }  // namespace switches
@@ -210,6 +210,7 @@
         'command_buffer/common/unittest_main.cc',
         'command_buffer/service/buffer_manager_unittest.cc',
         'command_buffer/service/cmd_parser_test.cc',
+        'command_buffer/service/command_buffer_recording_unittest.cc',
         'command_buffer/service/command_buffer_service_unittest.cc',
         'command_buffer/service/command_executor_unittest.cc',
         'command_buffer/service/common_decoder_unittest.cc',
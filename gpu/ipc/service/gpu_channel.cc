@@ -69,6 +69,11 @@ const int64_t kMaxPreemptTimeMs = kVsyncIntervalMs;
 // below this threshold.
 const int64_t kStopPreemptThresholdMs = kVsyncIntervalMs;
 
+// Amount of time that the next IPC of a stream can wait while streams of
+// higher priority run. After that the stream runs ahead of them, so that a
+// busy stream cannot starve the streams of lower priority.
+const int64_t kMaxStreamStarvationTimeMs = 2 * kVsyncIntervalMs;
+
 }  // anonymous namespace
 
 scoped_refptr<GpuChannelMessageQueue> GpuChannelMessageQueue::Create(
@@ -173,6 +178,18 @@ void GpuChannelMessageQueue::OnRescheduled(bool scheduled) {
   }
 }
 
+bool GpuChannelMessageQueue::HasQueuedMessages() const {
+  base::AutoLock auto_lock(channel_lock_);
+  return !channel_messages_.empty();
+}
+
+base::TimeTicks GpuChannelMessageQueue::GetNextMessageTimeTick() const {
+  base::AutoLock auto_lock(channel_lock_);
+  if (channel_messages_.empty())
+    return base::TimeTicks();
+  return channel_messages_.front()->time_received;
+}
+
 uint32_t GpuChannelMessageQueue::GetUnprocessedOrderNum() const {
   return sync_point_order_data_->unprocessed_order_num();
 }
@@ -774,7 +791,17 @@ void GpuChannel::PostHandleOutOfOrderMessage(const IPC::Message& msg) {
 }
 
 void GpuChannel::HandleMessage(
-    const scoped_refptr<GpuChannelMessageQueue>& message_queue) {
+    const scoped_refptr<GpuChannelMessageQueue>& posting_queue) {
+  // Every queue posts a task for each message it has ready, but the task
+  // handles the next message of whichever stream should run now.
+  bool starved = false;
+  scoped_refptr<GpuChannelMessageQueue> message_queue =
+      SelectStreamToRun(&starved);
+  if (!message_queue)
+    return;
+  TRACE_EVENT2("gpu", "GpuChannel::HandleMessage", "stream_id",
+               message_queue->stream_id(), "starved", starved);
+
   const GpuChannelMessage* channel_msg =
       message_queue->BeginMessageProcessing();
   if (!channel_msg)
@@ -802,6 +829,47 @@ void GpuChannel::HandleMessage(
   }
 }
 
+scoped_refptr<GpuChannelMessageQueue> GpuChannel::SelectStreamToRun(
+    bool* starved) const {
+  const base::TimeTicks starved_time =
+      base::TimeTicks::Now() -
+      base::TimeDelta::FromMilliseconds(kMaxStreamStarvationTimeMs);
+
+  // Streams whose next message has waited too long run first, oldest first.
+  // Otherwise the stream with the highest priority runs, and the oldest
+  // message breaks ties. Descheduled streams, e.g. ones waiting for a sync
+  // token, do not run until they are rescheduled.
+  scoped_refptr<GpuChannelMessageQueue> best_queue;
+  base::TimeTicks best_time;
+  bool best_starved = false;
+  for (const auto& kv : streams_) {
+    const scoped_refptr<GpuChannelMessageQueue>& queue = kv.second;
+    if (!queue->IsScheduled())
+      continue;
+    base::TimeTicks time = queue->GetNextMessageTimeTick();
+    if (time.is_null())
+      continue;
+    bool queue_starved = time <= starved_time;
+    if (best_queue) {
+      if (queue_starved != best_starved) {
+        if (!queue_starved)
+          continue;
+      } else if (!queue_starved &&
+                 queue->stream_priority() != best_queue->stream_priority()) {
+        if (queue->stream_priority() > best_queue->stream_priority())
+          continue;
+      } else if (time >= best_time) {
+        continue;
+      }
+    }
+    best_queue = queue;
+    best_time = time;
+    best_starved = queue_starved;
+  }
+  *starved = best_starved;
+  return best_queue;
+}
+
 void GpuChannel::HandleMessageHelper(const IPC::Message& msg) {
   int32_t routing_id = msg.routing_id();
 
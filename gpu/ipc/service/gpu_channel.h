@@ -182,7 +182,13 @@ class GPU_EXPORT GpuChannel
  private:
   bool OnControlMessageReceived(const IPC::Message& msg);
 
-  void HandleMessage(const scoped_refptr<GpuChannelMessageQueue>& queue);
+  void HandleMessage(
+      const scoped_refptr<GpuChannelMessageQueue>& posting_queue);
+
+  // Returns the stream whose next message should be handled, or null if no
+  // stream can run. Sets |starved| if the stream runs ahead of streams of
+  // higher priority because its next message has waited too long.
+  scoped_refptr<GpuChannelMessageQueue> SelectStreamToRun(bool* starved) const;
 
   // Some messages such as WaitForGetOffsetInRange and WaitForTokenInRange are
   // processed as soon as possible because the client is blocked until they
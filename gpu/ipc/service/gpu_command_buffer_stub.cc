@@ -13,6 +13,7 @@
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/shared_memory.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
@@ -20,6 +21,7 @@
 #include "gpu/command_buffer/common/gpu_memory_buffer_support.h"
 #include "gpu/command_buffer/common/mailbox.h"
 #include "gpu/command_buffer/common/sync_token.h"
+#include "gpu/command_buffer/service/command_buffer_recording.h"
 #include "gpu/command_buffer/service/gl_context_virtual.h"
 #include "gpu/command_buffer/service/gl_state_restorer_impl.h"
 #include "gpu/command_buffer/service/image_manager.h"
@@ -641,6 +643,15 @@ bool GpuCommandBufferStub::Initialize(
   if (offscreen && !active_url_.is_empty())
     manager->delegate()->DidCreateOffscreenContext(active_url_);
 
+  const base::FilePath& record_dir =
+      manager->gpu_preferences().record_gpu_command_buffers_dir;
+  if (!record_dir.empty()) {
+    recorder_ = CommandBufferRecorder::Create(
+        record_dir.AppendASCII(base::StringPrintf(
+            "command_buffer_%d_%d.gpucb", channel_->client_id(), route_id_)),
+        init_params.attribs, initial_size);
+  }
+
   initialized_ = true;
   return true;
 }
@@ -663,6 +674,8 @@ void GpuCommandBufferStub::SetLatencyInfoCallback(
 void GpuCommandBufferStub::OnSetGetBuffer(int32_t shm_id,
                                           IPC::Message* reply_message) {
   TRACE_EVENT0("gpu", "GpuCommandBufferStub::OnSetGetBuffer");
+  if (recorder_)
+    recorder_->RecordSetGetBuffer(shm_id);
   if (command_buffer_)
     command_buffer_->SetGetBuffer(shm_id);
   Send(reply_message);
@@ -781,6 +794,8 @@ void GpuCommandBufferStub::OnAsyncFlush(
 
   last_flush_count_ = flush_count;
   CommandBuffer::State pre_state = command_buffer_->GetLastState();
+  if (recorder_)
+    recorder_->RecordFlush(command_buffer_.get(), put_offset);
   command_buffer_->Flush(put_offset);
   CommandBuffer::State post_state = command_buffer_->GetLastState();
 
@@ -811,12 +826,16 @@ void GpuCommandBufferStub::OnRegisterTransferBuffer(
   if (command_buffer_) {
     command_buffer_->RegisterTransferBuffer(
         id, MakeBackingFromSharedMemory(std::move(shared_memory), size));
+    if (recorder_)
+      recorder_->RecordRegisterTransferBuffer(id, size);
   }
 }
 
 void GpuCommandBufferStub::OnDestroyTransferBuffer(int32_t id) {
   TRACE_EVENT0("gpu", "GpuCommandBufferStub::OnDestroyTransferBuffer");
 
+  if (recorder_)
+    recorder_->RecordDestroyTransferBuffer(id);
   if (command_buffer_)
     command_buffer_->DestroyTransferBuffer(id);
 }
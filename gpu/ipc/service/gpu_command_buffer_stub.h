@@ -37,6 +37,7 @@
 #include "url/gurl.h"
 
 namespace gpu {
+class CommandBufferRecorder;
 struct Mailbox;
 struct SyncToken;
 class SyncPointClient;
@@ -232,6 +233,8 @@ class GPU_EXPORT GpuCommandBufferStub
   std::unique_ptr<CommandBufferService> command_buffer_;
   std::unique_ptr<gles2::GLES2Decoder> decoder_;
   std::unique_ptr<CommandExecutor> executor_;
+  // Set when --record-gpu-command-buffers is on.
+  std::unique_ptr<CommandBufferRecorder> recorder_;
   std::unique_ptr<SyncPointClient> sync_point_client_;
   scoped_refptr<gl::GLSurface> surface_;
 
@@ -0,0 +1,287 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This tool replays a command buffer recorded by the GPU process with
+// --record-gpu-command-buffers=<dir>, and reports how long the service side
+// took to process each flush. It can be used to benchmark changes to the
+// decoder and the GL driver against a real page's commands, without the rest
+// of the browser in the way.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/shared_memory.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/common/buffer.h"
+#include "gpu/command_buffer/common/constants.h"
+#include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/command_buffer/service/command_buffer_recording.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+#include "gpu/command_buffer/service/command_executor.h"
+#include "gpu/command_buffer/service/context_group.h"
+#include "gpu/command_buffer/service/framebuffer_completeness_cache.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/gpu_preferences.h"
+#include "gpu/command_buffer/service/mailbox_manager_impl.h"
+#include "gpu/command_buffer/service/shader_translator_cache.h"
+#include "gpu/config/gpu_driver_bug_workarounds.h"
+#include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gl_share_group.h"
+#include "ui/gl/gl_surface.h"
+#include "ui/gl/init/gl_factory.h"
+
+namespace gpu {
+namespace {
+
+const char kIterations[] = "iterations";
+const char kVerbose[] = "verbose";
+
+int32_t ReadInt32(const std::vector<uint8_t>& payload, size_t index) {
+  int32_t value = 0;
+  if ((index + 1) * sizeof(value) <= payload.size())
+    memcpy(&value, payload.data() + index * sizeof(value), sizeof(value));
+  return value;
+}
+
+// Feeds a recording to a decoder on an offscreen context, the way
+// GpuCommandBufferStub feeds the commands it receives from a client.
+class CommandBufferReplayer {
+ public:
+  CommandBufferReplayer(const base::CommandLine& command_line, bool verbose)
+      : command_line_(command_line), verbose_(verbose) {}
+
+  ~CommandBufferReplayer() {
+    if (decoder_) {
+      decoder_->Destroy(context_ && context_->MakeCurrent(surface_.get()));
+      decoder_.reset();
+    }
+  }
+
+  // Returns false if the recording could not be replayed to its end.
+  bool Replay(CommandBufferRecordingReader* reader) {
+    CommandBufferRecordType type;
+    std::vector<uint8_t> payload;
+    if (!reader->ReadRecord(&type, &payload) || type != kContextAttribs) {
+      LOG(ERROR) << "Not a command buffer recording.";
+      return false;
+    }
+    gles2::ContextCreationAttribHelper attribs;
+    gfx::Size size;
+    if (!CommandBufferRecordingReader::ParseContextAttribs(payload, &attribs,
+                                                           &size) ||
+        !InitializeDecoder(attribs, size)) {
+      return false;
+    }
+
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    while (reader->ReadRecord(&type, &payload)) {
+      if (!ReplayRecord(type, payload))
+        return false;
+    }
+    // Wait for the GPU so that the total accounts for the work the driver
+    // queued up rather than only for the time spent in the decoder.
+    glFinish();
+    total_time_ = base::TimeTicks::Now() - start_time;
+    return true;
+  }
+
+  void PrintResults() const {
+    base::TimeDelta flush_time;
+    base::TimeDelta max_flush_time;
+    for (const base::TimeDelta& time : flush_times_) {
+      flush_time += time;
+      max_flush_time = std::max(max_flush_time, time);
+    }
+    printf("flushes: %zu\n", flush_times_.size());
+    printf("time in flushes: %.3f ms\n", flush_time.InMillisecondsF());
+    if (!flush_times_.empty()) {
+      printf("mean flush: %.3f ms\n",
+             flush_time.InMillisecondsF() / flush_times_.size());
+      printf("max flush: %.3f ms\n", max_flush_time.InMillisecondsF());
+    }
+    printf("total including glFinish: %.3f ms\n",
+           total_time_.InMillisecondsF());
+  }
+
+ private:
+  bool InitializeDecoder(const gles2::ContextCreationAttribHelper& attribs,
+                         const gfx::Size& size) {
+    GpuDriverBugWorkarounds workarounds(&command_line_);
+    scoped_refptr<gles2::ContextGroup> context_group = new gles2::ContextGroup(
+        gpu_preferences_, new gles2::MailboxManagerImpl, nullptr,
+        new gles2::ShaderTranslatorCache(gpu_preferences_),
+        new gles2::FramebufferCompletenessCache,
+        new gles2::FeatureInfo(command_line_, workarounds),
+        attribs.bind_generates_resource);
+
+    decoder_.reset(gles2::GLES2Decoder::Create(context_group.get()));
+    command_buffer_.reset(
+        new CommandBufferService(context_group->transfer_buffer_manager()));
+    executor_.reset(new CommandExecutor(command_buffer_.get(), decoder_.get(),
+                                        decoder_.get()));
+    decoder_->set_engine(executor_.get());
+
+    surface_ = gl::init::CreateOffscreenGLSurface(gfx::Size());
+    if (!surface_) {
+      LOG(ERROR) << "Failed to create offscreen surface.";
+      return false;
+    }
+    context_ = gl::init::CreateGLContext(nullptr, surface_.get(),
+                                         gl::PreferDiscreteGpu);
+    if (!context_ || !context_->MakeCurrent(surface_.get())) {
+      LOG(ERROR) << "Failed to create context.";
+      return false;
+    }
+
+    gfx::Size offscreen_size = size.IsEmpty() ? gfx::Size(1, 1) : size;
+    if (!decoder_->Initialize(surface_, context_, true, offscreen_size,
+                              gles2::DisallowedFeatures(), attribs)) {
+      LOG(ERROR) << "Failed to initialize decoder.";
+      return false;
+    }
+
+    command_buffer_->SetPutOffsetChangeCallback(base::Bind(
+        &CommandExecutor::PutChanged, base::Unretained(executor_.get())));
+    command_buffer_->SetGetBufferChangeCallback(base::Bind(
+        &CommandExecutor::SetGetBuffer, base::Unretained(executor_.get())));
+    return true;
+  }
+
+  bool ReplayRecord(CommandBufferRecordType type,
+                    const std::vector<uint8_t>& payload) {
+    int32_t id = ReadInt32(payload, 0);
+    switch (type) {
+      case kRegisterTransferBuffer: {
+        uint32_t size = static_cast<uint32_t>(ReadInt32(payload, 1));
+        std::unique_ptr<base::SharedMemory> shared_memory(
+            new base::SharedMemory);
+        if (!shared_memory->CreateAndMapAnonymous(size)) {
+          LOG(ERROR) << "Failed to allocate transfer buffer " << id;
+          return false;
+        }
+        command_buffer_->RegisterTransferBuffer(
+            id, MakeBackingFromSharedMemory(std::move(shared_memory), size));
+        return true;
+      }
+      case kDestroyTransferBuffer:
+        command_buffer_->DestroyTransferBuffer(id);
+        return true;
+      case kSetGetBuffer:
+        command_buffer_->SetGetBuffer(id);
+        return true;
+      case kTransferBufferContents: {
+        scoped_refptr<Buffer> buffer = command_buffer_->GetTransferBuffer(id);
+        if (!buffer || payload.size() != sizeof(id) + buffer->size()) {
+          LOG(ERROR) << "Contents do not match transfer buffer " << id;
+          return false;
+        }
+        memcpy(buffer->memory(), payload.data() + sizeof(id), buffer->size());
+        return true;
+      }
+      case kFlush: {
+        base::TimeTicks flush_start_time = base::TimeTicks::Now();
+        command_buffer_->Flush(id);
+        base::TimeDelta flush_time = base::TimeTicks::Now() - flush_start_time;
+        flush_times_.push_back(flush_time);
+        if (verbose_) {
+          printf("flush %zu to %d: %.3f ms\n", flush_times_.size(), id,
+                 flush_time.InMillisecondsF());
+        }
+        CommandBuffer::State state = command_buffer_->GetLastState();
+        if (state.error != error::kNoError) {
+          LOG(ERROR) << "Decoder error " << state.error << " in flush "
+                     << flush_times_.size();
+          return false;
+        }
+        return true;
+      }
+      case kContextAttribs:
+        break;
+    }
+    LOG(ERROR) << "Unexpected record type " << type;
+    return false;
+  }
+
+  const base::CommandLine& command_line_;
+  const bool verbose_;
+  GpuPreferences gpu_preferences_;
+  scoped_refptr<gl::GLSurface> surface_;
+  scoped_refptr<gl::GLContext> context_;
+  std::unique_ptr<gles2::GLES2Decoder> decoder_;
+  std::unique_ptr<CommandBufferService> command_buffer_;
+  std::unique_ptr<CommandExecutor> executor_;
+  std::vector<base::TimeDelta> flush_times_;
+  base::TimeDelta total_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferReplayer);
+};
+
+}  // namespace
+}  // namespace gpu
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager at_exit_manager;
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+
+  if (command_line->GetArgs().size() != 1) {
+    LOG(ERROR) << "Usage: "
+               << command_line->GetProgram().BaseName().LossyDisplayName()
+               << " [--iterations=N] [--verbose] <recording>\n"
+                  "Replays a command buffer recorded with "
+                  "--record-gpu-command-buffers=<dir>.";
+    return 1;
+  }
+  base::FilePath path(command_line->GetArgs()[0]);
+
+  int iterations = 1;
+  if (command_line->HasSwitch(gpu::kIterations) &&
+      (!base::StringToInt(
+           command_line->GetSwitchValueASCII(gpu::kIterations),
+           &iterations) ||
+       iterations < 1)) {
+    LOG(ERROR) << "Invalid --iterations.";
+    return 1;
+  }
+
+  base::MessageLoopForUI message_loop;
+  if (!gl::init::InitializeGLOneOff()) {
+    LOG(ERROR) << "Failed to initialize GL.";
+    return 1;
+  }
+
+  for (int i = 0; i < iterations; ++i) {
+    base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid()) {
+      LOG(ERROR) << "Failed to open " << path.LossyDisplayName();
+      return 1;
+    }
+    gpu::CommandBufferRecordingReader reader(std::move(file));
+    // Every iteration starts from a new context, so that one does not warm up
+    // the decoder's caches for the next.
+    gpu::CommandBufferReplayer replayer(
+        *command_line, command_line->HasSwitch(gpu::kVerbose));
+    if (!replayer.Replay(&reader))
+      return 1;
+    printf("iteration %d\n", i + 1);
+    replayer.PrintResults();
+  }
+  return 0;
+}
@@ -44,6 +44,11 @@ HeadlessBrowserImpl::CreateBrowserContextBuilder() {
   return HeadlessBrowserContext::Builder(this);
 }
 
+HeadlessSessionPool::Builder HeadlessBrowserImpl::CreateSessionPoolBuilder() {
+  DCHECK(BrowserMainThread()->BelongsToCurrentThread());
+  return HeadlessSessionPool::Builder(this);
+}
+
 HeadlessWebContents* HeadlessBrowserImpl::CreateWebContents(
     HeadlessWebContents::Builder* builder) {
   DCHECK(BrowserMainThread()->BelongsToCurrentThread());
@@ -36,6 +36,7 @@ class HeadlessBrowserImpl : public HeadlessBrowser {
   // HeadlessBrowser implementation:
   HeadlessWebContents::Builder CreateWebContentsBuilder() override;
   HeadlessBrowserContext::Builder CreateBrowserContextBuilder() override;
+  HeadlessSessionPool::Builder CreateSessionPoolBuilder() override;
   HeadlessWebContents* CreateWebContents(const GURL& initial_url,
                                          const gfx::Size& size) override;
   scoped_refptr<base::SingleThreadTaskRunner> BrowserMainThread()
@@ -0,0 +1,298 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "headless/lib/browser/headless_session_pool_impl.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/single_thread_task_runner.h"
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "headless/lib/browser/headless_browser_context_impl.h"
+#include "headless/lib/browser/headless_browser_impl.h"
+#include "headless/lib/browser/headless_web_contents_impl.h"
+#include "url/gurl.h"
+#include "url/url_constants.h"
+
+namespace headless {
+
+class HeadlessSessionPoolImpl::SessionImpl
+    : public HeadlessSessionPool::Session,
+      public content::WebContentsObserver {
+ public:
+  enum State { WARMING_UP, IDLE, ACQUIRED, RESETTING };
+
+  SessionImpl(HeadlessSessionPoolImpl* pool,
+              HeadlessBrowserImpl* browser,
+              const gfx::Size& window_size)
+      : pool_(pool),
+        browser_(browser),
+        state_(WARMING_UP),
+        crashed_(false),
+        created_time_(base::TimeTicks::Now()),
+        browser_context_(browser->CreateBrowserContextBuilder().Build()),
+        web_contents_(nullptr) {
+    web_contents_ = HeadlessWebContentsImpl::From(
+        browser->CreateWebContentsBuilder()
+            .SetBrowserContext(browser_context_.get())
+            .SetWindowSize(window_size)
+            .Build());
+    Observe(web_contents_->web_contents());
+  }
+
+  ~SessionImpl() override {
+    Observe(nullptr);
+    CloseWebContents(true);
+  }
+
+  State state() const { return state_; }
+  bool crashed() const { return crashed_; }
+
+  void OnReady() {
+    if (state_ == WARMING_UP)
+      stats_.warmup_time = base::TimeTicks::Now() - created_time_;
+    state_ = IDLE;
+  }
+
+  void OnAcquired() {
+    DCHECK_EQ(IDLE, state_);
+    state_ = ACQUIRED;
+    stats_.uses++;
+    acquired_time_ = base::TimeTicks::Now();
+  }
+
+  void OnReleased() {
+    DCHECK_EQ(ACQUIRED, state_);
+    stats_.busy_time += base::TimeTicks::Now() - acquired_time_;
+  }
+
+  // Makes the session ready for its next user. OnSessionReady() is called
+  // once about:blank has loaded.
+  void Reset() {
+    DCHECK_EQ(ACQUIRED, state_);
+    state_ = RESETTING;
+    CloseWebContents(false);
+    web_contents_->OpenURL(GURL(url::kAboutBlankURL));
+  }
+
+  // HeadlessSessionPool::Session implementation:
+  HeadlessBrowserContext* GetBrowserContext() override {
+    return browser_context_.get();
+  }
+
+  HeadlessWebContents* GetWebContents() override { return web_contents_; }
+
+  const SessionStats& GetStats() const override { return stats_; }
+
+  // content::WebContentsObserver implementation:
+  void DidStopLoading() override {
+    if ((state_ == WARMING_UP || state_ == RESETTING) && !crashed_ &&
+        web_contents()->GetLastCommittedURL() == GURL(url::kAboutBlankURL)) {
+      pool_->OnSessionReady(this);
+    }
+  }
+
+  void DidFinishNavigation(
+      content::NavigationHandle* navigation_handle) override {
+    if (state_ == ACQUIRED && navigation_handle->IsInMainFrame() &&
+        navigation_handle->HasCommitted()) {
+      stats_.navigations++;
+    }
+  }
+
+  void RenderProcessGone(base::TerminationStatus status) override {
+    if (crashed_)
+      return;
+    crashed_ = true;
+    pool_->OnSessionCrashed(this);
+  }
+
+ private:
+  // Closes the tabs of the session's browser context, except for the
+  // session's own tab unless |all| is set.
+  void CloseWebContents(bool all) {
+    content::BrowserContext* browser_context =
+        HeadlessBrowserContextImpl::From(browser_context_.get());
+    for (HeadlessWebContents* web_contents : browser_->GetAllWebContents()) {
+      if (!all && web_contents == web_contents_)
+        continue;
+      if (HeadlessWebContentsImpl::From(web_contents)
+              ->web_contents()
+              ->GetBrowserContext() == browser_context) {
+        web_contents->Close();
+      }
+    }
+  }
+
+  HeadlessSessionPoolImpl* pool_;  // Not owned.
+  HeadlessBrowserImpl* browser_;   // Not owned.
+  State state_;
+  bool crashed_;
+  base::TimeTicks created_time_;
+  base::TimeTicks acquired_time_;
+  SessionStats stats_;
+  std::unique_ptr<HeadlessBrowserContext> browser_context_;
+  HeadlessWebContentsImpl* web_contents_;  // Owned by |browser_|.
+
+  DISALLOW_COPY_AND_ASSIGN(SessionImpl);
+};
+
+HeadlessSessionPoolImpl::HeadlessSessionPoolImpl(
+    HeadlessBrowserImpl* browser,
+    size_t size,
+    int max_uses_per_session,
+    const gfx::Size& window_size)
+    : browser_(browser),
+      size_(size),
+      max_uses_per_session_(max_uses_per_session),
+      window_size_(window_size),
+      weak_ptr_factory_(this) {
+  DCHECK_GE(max_uses_per_session_, 1);
+  WarmUpSessions();
+}
+
+HeadlessSessionPoolImpl::~HeadlessSessionPoolImpl() {
+  DCHECK(browser_->BrowserMainThread()->BelongsToCurrentThread());
+  idle_sessions_.clear();
+  sessions_.clear();
+}
+
+void HeadlessSessionPoolImpl::AcquireSession(const SessionCallback& callback) {
+  DCHECK(browser_->BrowserMainThread()->BelongsToCurrentThread());
+  pending_requests_.push_back(callback);
+  ServePendingRequests();
+}
+
+void HeadlessSessionPoolImpl::ReleaseSession(Session* session) {
+  DCHECK(browser_->BrowserMainThread()->BelongsToCurrentThread());
+  SessionImpl* session_impl = static_cast<SessionImpl*>(session);
+  session_impl->OnReleased();
+  if (!session_impl->crashed() &&
+      session_impl->GetStats().uses < max_uses_per_session_ &&
+      GetSpareSessionCount() < size_) {
+    session_impl->Reset();
+    return;
+  }
+  DestroySession(session_impl);
+  WarmUpSessions();
+}
+
+size_t HeadlessSessionPoolImpl::GetIdleSessionCount() const {
+  return idle_sessions_.size();
+}
+
+void HeadlessSessionPoolImpl::OnSessionReady(SessionImpl* session) {
+  session->OnReady();
+  idle_sessions_.push_back(session);
+  ServePendingRequests();
+}
+
+void HeadlessSessionPoolImpl::OnSessionCrashed(SessionImpl* session) {
+  // Acquired sessions are destroyed when they are released. Others are
+  // destroyed from a task, since the crash is reported by one of their
+  // observers.
+  if (session->state() == SessionImpl::ACQUIRED)
+    return;
+  auto it = std::find(idle_sessions_.begin(), idle_sessions_.end(), session);
+  if (it != idle_sessions_.end())
+    idle_sessions_.erase(it);
+  browser_->BrowserMainThread()->PostTask(
+      FROM_HERE, base::Bind(&HeadlessSessionPoolImpl::DestroyCrashedSessions,
+                            weak_ptr_factory_.GetWeakPtr()));
+}
+
+void HeadlessSessionPoolImpl::WarmUpSessions() {
+  while (GetSpareSessionCount() < size_) {
+    sessions_.push_back(
+        base::WrapUnique(new SessionImpl(this, browser_, window_size_)));
+  }
+}
+
+void HeadlessSessionPoolImpl::ServePendingRequests() {
+  base::WeakPtr<HeadlessSessionPoolImpl> weak_this =
+      weak_ptr_factory_.GetWeakPtr();
+  while (!idle_sessions_.empty() && !pending_requests_.empty()) {
+    SessionImpl* session = idle_sessions_.front();
+    idle_sessions_.pop_front();
+    SessionCallback callback = pending_requests_.front();
+    pending_requests_.pop_front();
+    session->OnAcquired();
+    WarmUpSessions();
+    // The callback may release the session, or delete the pool.
+    callback.Run(session);
+    if (!weak_this)
+      return;
+  }
+}
+
+void HeadlessSessionPoolImpl::DestroySession(SessionImpl* session) {
+  auto idle_it =
+      std::find(idle_sessions_.begin(), idle_sessions_.end(), session);
+  if (idle_it != idle_sessions_.end())
+    idle_sessions_.erase(idle_it);
+  for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+    if (it->get() == session) {
+      sessions_.erase(it);
+      return;
+    }
+  }
+  NOTREACHED();
+}
+
+void HeadlessSessionPoolImpl::DestroyCrashedSessions() {
+  std::vector<SessionImpl*> crashed_sessions;
+  for (const auto& session : sessions_) {
+    if (session->crashed() && session->state() != SessionImpl::ACQUIRED)
+      crashed_sessions.push_back(session.get());
+  }
+  for (SessionImpl* session : crashed_sessions)
+    DestroySession(session);
+  WarmUpSessions();
+}
+
+size_t HeadlessSessionPoolImpl::GetSpareSessionCount() const {
+  size_t count = 0;
+  for (const auto& session : sessions_) {
+    if (session->state() != SessionImpl::ACQUIRED && !session->crashed())
+      count++;
+  }
+  return count;
+}
+
+HeadlessSessionPool::SessionStats::SessionStats() : uses(0), navigations(0) {}
+
+HeadlessSessionPool::Builder::Builder(HeadlessBrowserImpl* browser)
+    : browser_(browser) {}
+
+HeadlessSessionPool::Builder::~Builder() = default;
+
+HeadlessSessionPool::Builder::Builder(Builder&&) = default;
+
+HeadlessSessionPool::Builder& HeadlessSessionPool::Builder::SetSize(
+    size_t size) {
+  size_ = size;
+  return *this;
+}
+
+HeadlessSessionPool::Builder&
+HeadlessSessionPool::Builder::SetMaxUsesPerSession(int max_uses_per_session) {
+  max_uses_per_session_ = max_uses_per_session;
+  return *this;
+}
+
+HeadlessSessionPool::Builder& HeadlessSessionPool::Builder::SetWindowSize(
+    const gfx::Size& window_size) {
+  window_size_ = window_size;
+  return *this;
+}
+
+std::unique_ptr<HeadlessSessionPool> HeadlessSessionPool::Builder::Build() {
+  return base::WrapUnique(new HeadlessSessionPoolImpl(
+      browser_, size_, max_uses_per_session_, window_size_));
+}
+
+}  // namespace headless
@@ -0,0 +1,71 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef HEADLESS_LIB_BROWSER_HEADLESS_SESSION_POOL_IMPL_H_
+#define HEADLESS_LIB_BROWSER_HEADLESS_SESSION_POOL_IMPL_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/memory/weak_ptr.h"
+#include "headless/public/headless_session_pool.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace headless {
+class HeadlessBrowserImpl;
+
+class HeadlessSessionPoolImpl : public HeadlessSessionPool {
+ public:
+  HeadlessSessionPoolImpl(HeadlessBrowserImpl* browser,
+                          size_t size,
+                          int max_uses_per_session,
+                          const gfx::Size& window_size);
+  ~HeadlessSessionPoolImpl() override;
+
+  // HeadlessSessionPool implementation:
+  void AcquireSession(const SessionCallback& callback) override;
+  void ReleaseSession(Session* session) override;
+  size_t GetIdleSessionCount() const override;
+
+ private:
+  class SessionImpl;
+
+  // Called by |session| once it has loaded about:blank.
+  void OnSessionReady(SessionImpl* session);
+
+  // Called by |session| when its renderer process has gone away.
+  void OnSessionCrashed(SessionImpl* session);
+
+  // Starts warming up new sessions until |size_| are idle or warming up.
+  void WarmUpSessions();
+
+  // Hands idle sessions to the pending requests.
+  void ServePendingRequests();
+
+  void DestroySession(SessionImpl* session);
+
+  // Destroys the sessions whose renderer crashed and that are not acquired.
+  void DestroyCrashedSessions();
+
+  // Returns the number of sessions that are idle or getting ready.
+  size_t GetSpareSessionCount() const;
+
+  HeadlessBrowserImpl* browser_;  // Not owned.
+  const size_t size_;
+  const int max_uses_per_session_;
+  const gfx::Size window_size_;
+
+  std::vector<std::unique_ptr<SessionImpl>> sessions_;
+  std::deque<SessionImpl*> idle_sessions_;
+  std::deque<SessionCallback> pending_requests_;
+
+  base::WeakPtrFactory<HeadlessSessionPoolImpl> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeadlessSessionPoolImpl);
+};
+
+}  // namespace headless
+
+#endif  // HEADLESS_LIB_BROWSER_HEADLESS_SESSION_POOL_IMPL_H_
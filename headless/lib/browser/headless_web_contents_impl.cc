@@ -96,6 +96,14 @@ HeadlessWebContentsImpl::CreateFromWebContents(
   return headless_web_contents;
 }
 
+// static
+HeadlessWebContentsImpl* HeadlessWebContentsImpl::From(
+    HeadlessWebContents* web_contents) {
+  // This downcast is safe because there is only one implementation of
+  // HeadlessWebContents.
+  return static_cast<HeadlessWebContentsImpl*>(web_contents);
+}
+
 void HeadlessWebContentsImpl::InitializeScreen(aura::Window* parent_window,
                                                const gfx::Size& initial_size) {
   aura::Window* contents = web_contents_->GetNativeView();
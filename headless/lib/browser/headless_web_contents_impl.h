@@ -45,6 +45,8 @@ class HeadlessWebContentsImpl : public HeadlessWebContents,
       content::WebContents* web_contents,
       HeadlessBrowserImpl* browser);
 
+  static HeadlessWebContentsImpl* From(HeadlessWebContents* web_contents);
+
   // HeadlessWebContents implementation:
   void AddObserver(Observer* observer) override;
   void RemoveObserver(Observer* observer) override;
@@ -0,0 +1,92 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "base/bind.h"
+#include "content/public/test/browser_test.h"
+#include "headless/public/headless_browser.h"
+#include "headless/public/headless_session_pool.h"
+#include "headless/public/headless_web_contents.h"
+#include "headless/test/headless_browser_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace headless {
+
+class HeadlessSessionPoolTest : public HeadlessBrowserTest {
+ public:
+  HeadlessSessionPoolTest() : session_(nullptr), waiting_(false) {}
+
+  HeadlessSessionPool::Session* AcquireSession(HeadlessSessionPool* pool) {
+    session_ = nullptr;
+    pool->AcquireSession(base::Bind(&HeadlessSessionPoolTest::OnSessionAcquired,
+                                    base::Unretained(this)));
+    if (!session_) {
+      waiting_ = true;
+      RunAsynchronousTest();
+    }
+    return session_;
+  }
+
+ private:
+  void OnSessionAcquired(HeadlessSessionPool::Session* session) {
+    session_ = session;
+    if (waiting_) {
+      waiting_ = false;
+      FinishAsynchronousTest();
+    }
+  }
+
+  HeadlessSessionPool::Session* session_;
+  bool waiting_;
+};
+
+IN_PROC_BROWSER_TEST_F(HeadlessSessionPoolTest, AcquireWarmedSessions) {
+  std::unique_ptr<HeadlessSessionPool> pool =
+      browser()->CreateSessionPoolBuilder().SetSize(2).Build();
+
+  HeadlessSessionPool::Session* session1 = AcquireSession(pool.get());
+  ASSERT_TRUE(session1);
+  HeadlessSessionPool::Session* session2 = AcquireSession(pool.get());
+  ASSERT_TRUE(session2);
+
+  EXPECT_NE(session1->GetBrowserContext(), session2->GetBrowserContext());
+  EXPECT_TRUE(session1->GetWebContents()->GetDevToolsTarget());
+  EXPECT_TRUE(session2->GetWebContents()->GetDevToolsTarget());
+  EXPECT_EQ(1, session1->GetStats().uses);
+  EXPECT_LT(base::TimeDelta(), session1->GetStats().warmup_time);
+
+  pool->ReleaseSession(session1);
+  pool->ReleaseSession(session2);
+}
+
+IN_PROC_BROWSER_TEST_F(HeadlessSessionPoolTest, RecycleSessions) {
+  std::unique_ptr<HeadlessSessionPool> pool = browser()
+                                                  ->CreateSessionPoolBuilder()
+                                                  .SetSize(1)
+                                                  .SetMaxUsesPerSession(2)
+                                                  .Build();
+
+  HeadlessSessionPool::Session* session = AcquireSession(pool.get());
+  ASSERT_TRUE(session);
+  EXPECT_EQ(1, session->GetStats().uses);
+  HeadlessBrowserContext* browser_context = session->GetBrowserContext();
+  pool->ReleaseSession(session);
+
+  // The session is handed out again once it has been reset.
+  session = AcquireSession(pool.get());
+  ASSERT_TRUE(session);
+  EXPECT_EQ(2, session->GetStats().uses);
+  EXPECT_EQ(browser_context, session->GetBrowserContext());
+  EXPECT_TRUE(session->GetWebContents()->GetDevToolsTarget());
+  pool->ReleaseSession(session);
+
+  // After that, it is replaced by a new one.
+  session = AcquireSession(pool.get());
+  ASSERT_TRUE(session);
+  EXPECT_EQ(1, session->GetStats().uses);
+  pool->ReleaseSession(session);
+}
+
+}  // namespace headless
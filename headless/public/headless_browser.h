@@ -15,6 +15,7 @@
 #include "base/memory/ref_counted.h"
 #include "headless/public/headless_browser_context.h"
 #include "headless/public/headless_export.h"
+#include "headless/public/headless_session_pool.h"
 #include "headless/public/headless_web_contents.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/ip_endpoint.h"
@@ -65,6 +66,10 @@ class HEADLESS_EXPORT HeadlessBrowser {
   // HeadlessWebContents from one another.
   virtual HeadlessBrowserContext::Builder CreateBrowserContextBuilder() = 0;
 
+  // Create a pool of pre-warmed browser contexts and tabs, for embedders that
+  // run many short sessions.
+  virtual HeadlessSessionPool::Builder CreateSessionPoolBuilder() = 0;
+
  protected:
   HeadlessBrowser() {}
   virtual ~HeadlessBrowser() {}
@@ -0,0 +1,127 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef HEADLESS_PUBLIC_HEADLESS_SESSION_POOL_H_
+#define HEADLESS_PUBLIC_HEADLESS_SESSION_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "headless/public/headless_export.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace headless {
+class HeadlessBrowserContext;
+class HeadlessBrowserImpl;
+class HeadlessWebContents;
+
+// Keeps a number of sessions ready for use, each an isolated browser context
+// with a tab whose renderer process has been started and has loaded
+// about:blank, so that its JavaScript engine is initialized. Acquiring a
+// session skips the process startup and first navigation setup that creating
+// a browser context and a tab would take. Should be accessed from browser
+// main thread.
+class HEADLESS_EXPORT HeadlessSessionPool {
+ public:
+  class Builder;
+
+  // Throughput metrics of a session, accumulated over all its uses.
+  struct SessionStats {
+    SessionStats();
+
+    // How long the session took to get ready when it was created.
+    base::TimeDelta warmup_time;
+    // How many times the session has been acquired.
+    int uses;
+    // The total time the session has been acquired for.
+    base::TimeDelta busy_time;
+    // The number of main frame navigations that committed while acquired.
+    int navigations;
+  };
+
+  class Session {
+   public:
+    virtual HeadlessBrowserContext* GetBrowserContext() = 0;
+
+    // The tab of the session, showing about:blank when the session is handed
+    // out. Navigate it using a HeadlessDevToolsClient, which must be detached
+    // before the session is released.
+    virtual HeadlessWebContents* GetWebContents() = 0;
+
+    virtual const SessionStats& GetStats() const = 0;
+
+   protected:
+    Session() {}
+    virtual ~Session() {}
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(Session);
+  };
+
+  using SessionCallback = base::Callback<void(Session*)>;
+
+  // Closes all the sessions, including acquired ones.
+  virtual ~HeadlessSessionPool() {}
+
+  // Passes a ready session to |callback|: right away if one is idle, otherwise
+  // once one becomes ready. Requests are served in order.
+  virtual void AcquireSession(const SessionCallback& callback) = 0;
+
+  // Gives back a session obtained from AcquireSession(). Depending on the
+  // recycling policy, the session is either reset to about:blank for the next
+  // user, keeping its browser context, or closed and replaced by a new one.
+  // Tabs that the page opened are closed.
+  virtual void ReleaseSession(Session* session) = 0;
+
+  // Returns the number of sessions that are ready to be acquired.
+  virtual size_t GetIdleSessionCount() const = 0;
+
+ protected:
+  HeadlessSessionPool() {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HeadlessSessionPool);
+};
+
+class HEADLESS_EXPORT HeadlessSessionPool::Builder {
+ public:
+  Builder(Builder&&);
+  ~Builder();
+
+  // The number of sessions that are kept ready, not counting the acquired
+  // ones. The default is 2.
+  Builder& SetSize(size_t size);
+
+  // The number of times a session is handed out before it is replaced by a
+  // fresh one. The default of 1 gives every user a new browser context; larger
+  // values share cookies, cache and storage between consecutive users of a
+  // session, but save starting a new renderer process.
+  Builder& SetMaxUsesPerSession(int max_uses_per_session);
+
+  // The window size of the tabs (default is 800x600).
+  Builder& SetWindowSize(const gfx::Size& window_size);
+
+  // Creates the pool, which starts warming up its sessions.
+  std::unique_ptr<HeadlessSessionPool> Build();
+
+ private:
+  friend class HeadlessBrowserImpl;
+
+  explicit Builder(HeadlessBrowserImpl* browser);
+
+  HeadlessBrowserImpl* browser_;
+  size_t size_ = 2;
+  int max_uses_per_session_ = 1;
+  gfx::Size window_size_ = gfx::Size(800, 600);
+
+  DISALLOW_COPY_AND_ASSIGN(Builder);
+};
+
+}  // namespace headless
+
+#endif  // HEADLESS_PUBLIC_HEADLESS_SESSION_POOL_H_
@@ -218,6 +218,8 @@ bool ChannelNacl::Send(Message* message) {
                          "ChannelNacl::Send",
                          message->header()->flags,
                          TRACE_EVENT_FLAG_FLOW_OUT);
+  // imc_sendmsg() is given a single buffer.
+  message->FlattenExternalData();
   output_queue_.push_back(linked_ptr<Message>(message_ptr.release()));
   if (!waiting_connect_)
     return ProcessOutgoingMessages();
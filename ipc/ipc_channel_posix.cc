@@ -29,6 +29,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_path.h"
@@ -41,6 +42,7 @@
 #include "base/process/process_handle.h"
 #include "base/rand_util.h"
 #include "base/stl_util.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "build/build_config.h"
@@ -171,6 +173,36 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// The most pieces of messages written by a single sendmsg(), which is the
+// smallest IOV_MAX allowed by POSIX. Any others are written by the next one.
+const size_t kMaxIOVecs = 16;
+
+// Appends what is left to write of the |num_pieces| |pieces| after
+// |bytes_written| bytes to the |*num_iovecs| entries already in |iov|, as far
+// as they go, and returns the number of bytes appended.
+size_t AppendIOVecs(const base::StringPiece* pieces,
+                    size_t num_pieces,
+                    size_t bytes_written,
+                    struct iovec* iov,
+                    size_t* num_iovecs) {
+  size_t amt_to_write = 0;
+  for (size_t i = 0; i < num_pieces; ++i) {
+    const base::StringPiece& piece = pieces[i];
+    if (*num_iovecs == kMaxIOVecs)
+      break;
+    if (bytes_written >= piece.size()) {
+      bytes_written -= piece.size();
+      continue;
+    }
+    iov[*num_iovecs].iov_base = const_cast<char*>(piece.data() + bytes_written);
+    iov[*num_iovecs].iov_len = piece.size() - bytes_written;
+    amt_to_write += iov[*num_iovecs].iov_len;
+    ++*num_iovecs;
+    bytes_written = 0;
+  }
+  return amt_to_write;
+}
+
 }  // namespace
 
 #if defined(OS_ANDROID)
@@ -196,6 +228,7 @@ ChannelPosix::ChannelPosix(const IPC::ChannelHandle& channel_handle,
       is_blocked_on_write_(false),
       waiting_connect_(true),
       message_send_bytes_written_(0),
+      num_urgent_output_elements_(0),
       pipe_name_(channel_handle.name),
       in_dtor_(false),
       must_unlink_(false) {
@@ -404,23 +437,50 @@ bool ChannelPosix::ProcessOutgoingMessages() {
   // more outgoing messages.
   while (!output_queue_.empty()) {
     OutputElement* element = output_queue_.front();
+    Message* msg = element->get_message();
 
-    size_t amt_to_write = element->size() - message_send_bytes_written_;
+    // Gather as many queued messages as a single sendmsg() takes, so that a
+    // burst of small messages costs one system call. Descriptors are sent
+    // along with the first message of the batch, so any other message which
+    // carries some starts a batch of its own.
+    struct iovec iov[kMaxIOVecs];
+    size_t num_iovecs = 0;
+    size_t amt_to_write = 0;
+    std::vector<base::StringPiece> pieces;
+    for (size_t i = 0; i < output_queue_.size() && num_iovecs < kMaxIOVecs;
+         ++i) {
+      OutputElement* batched_element = output_queue_[i];
+      Message* batched_msg = batched_element->get_message();
+      if (i > 0 && batched_msg &&
+          batched_msg->attachment_set()->num_non_brokerable_attachments()) {
+        break;
+      }
+      size_t offset = i == 0 ? message_send_bytes_written_ : 0;
+      if (batched_msg && batched_msg->has_external_data()) {
+        // Messages referencing external data are written piece by piece
+        // rather than copied into a single buffer.
+        pieces.clear();
+        batched_msg->GetPieces(&pieces);
+        amt_to_write += AppendIOVecs(pieces.data(), pieces.size(), offset, iov,
+                                     &num_iovecs);
+      } else {
+        base::StringPiece piece(
+            reinterpret_cast<const char*>(batched_element->data()),
+            batched_element->size());
+        amt_to_write += AppendIOVecs(&piece, 1, offset, iov, &num_iovecs);
+      }
+    }
     DCHECK_NE(0U, amt_to_write);
-    const char* out_bytes = reinterpret_cast<const char*>(element->data()) +
-        message_send_bytes_written_;
 
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
-    msgh.msg_iovlen = 1;
+    msgh.msg_iov = iov;
+    msgh.msg_iovlen = num_iovecs;
     char buf[CMSG_SPACE(sizeof(int) *
                         MessageAttachmentSet::kMaxDescriptorsPerMessage)];
 
     ssize_t bytes_written = 1;
     int fd_written = -1;
 
-    Message* msg = element->get_message();
     if (message_send_bytes_written_ == 0 && msg &&
         msg->attachment_set()->num_non_brokerable_attachments()) {
       // This is the first chunk of a message which has descriptors to send
@@ -484,12 +544,37 @@ bool ChannelPosix::ProcessOutgoingMessages() {
       return false;
     }
 
-    if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
+    // Drop the messages written in full, and remember how far the next one
+    // got.
+    size_t bytes_left = bytes_written > 0 ? bytes_written : 0;
+    while (bytes_left > 0) {
+      OutputElement* written_element = output_queue_.front();
+      size_t element_bytes_left =
+          written_element->size() - message_send_bytes_written_;
+      if (bytes_left < element_bytes_left) {
+        message_send_bytes_written_ += bytes_left;
+        break;
+      }
+      bytes_left -= element_bytes_left;
+      message_send_bytes_written_ = 0;
+
+      // Message sent OK!
+      if (written_element->get_message()) {
+        DVLOG(2) << "sent message @" << written_element->get_message()
+                 << " on channel @" << this << " with type "
+                 << written_element->get_message()->type() << " on fd "
+                 << pipe_.get();
+      } else {
+        DVLOG(2) << "sent buffer @" << written_element->data()
+                 << " on channel @" << this << " on fd " << pipe_.get();
       }
+      delete written_element;
+      output_queue_.pop_front();
+      if (num_urgent_output_elements_ > 0)
+        --num_urgent_output_elements_;
+    }
 
+    if (static_cast<size_t>(bytes_written) != amt_to_write) {
       // Tell libevent to call us back once things are unblocked.
       is_blocked_on_write_ = true;
       base::MessageLoopForIO::current()->WatchFileDescriptor(
@@ -499,19 +584,6 @@ bool ChannelPosix::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      if (msg) {
-        DVLOG(2) << "sent message @" << msg << " on channel @" << this
-                 << " with type " << msg->type() << " on fd " << pipe_.get();
-      } else {
-        DVLOG(2) << "sent buffer @" << element->data() << " on channel @"
-                 << this << " on fd " << pipe_.get();
-      }
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
   return true;
@@ -586,11 +658,13 @@ void ChannelPosix::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     OutputElement* element = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     if (element->get_message())
       CloseFileDescriptors(element->get_message());
     delete element;
   }
+  message_send_bytes_written_ = 0;
+  num_urgent_output_elements_ = 0;
 
   // Close any outstanding, received file descriptors.
   ClearInputFDs();
@@ -728,14 +802,14 @@ bool ChannelPosix::ProcessMessageForDelivery(Message* message) {
                          TRACE_EVENT_FLAG_FLOW_OUT);
 
   // |output_queue_| takes ownership of |message|.
-  OutputElement* element = new OutputElement(message);
-  output_queue_.push(element);
+  bool urgent = message->priority() == Message::PRIORITY_HIGH;
+  QueueOutputElement(new OutputElement(message), urgent);
 
   if (message->HasBrokerableAttachments()) {
     // |output_queue_| takes ownership of |ids.buffer|.
     Message::SerializedAttachmentIds ids =
         message->SerializedIdsOfBrokerableAttachments();
-    output_queue_.push(new OutputElement(ids.buffer, ids.size));
+    QueueOutputElement(new OutputElement(ids.buffer, ids.size), urgent);
   }
 
   return ProcessOutgoingMessages();
@@ -830,8 +904,28 @@ void ChannelPosix::QueueHelloMessage() {
   if (!msg->WriteInt(GetHelloMessageProcId())) {
     NOTREACHED() << "Unable to pickle hello message proc id";
   }
-  OutputElement* element = new OutputElement(msg.release());
-  output_queue_.push(element);
+  // The hello message goes ahead of anything queued before the connection,
+  // high priority messages included.
+  DCHECK_EQ(0u, message_send_bytes_written_);
+  output_queue_.push_front(new OutputElement(msg.release()));
+  ++num_urgent_output_elements_;
+}
+
+void ChannelPosix::QueueOutputElement(OutputElement* element, bool urgent) {
+  if (!urgent) {
+    output_queue_.push_back(element);
+    return;
+  }
+
+  // Go after the other urgent elements, and after whatever is already on its
+  // way: a partly written message, and the rest of it in the next elements.
+  size_t index = num_urgent_output_elements_;
+  if (index == 0 && message_send_bytes_written_ > 0)
+    index = 1;
+  while (index < output_queue_.size() && !output_queue_[index]->get_message())
+    ++index;
+  output_queue_.insert(output_queue_.begin() + index, element);
+  num_urgent_output_elements_ = index + 1;
 }
 
 ChannelPosix::ReadState ChannelPosix::ReadData(
@@ -988,7 +1082,7 @@ void ChannelPosix::QueueCloseFDMessage(int fd, int hops) {
       }
 
       OutputElement* element = new OutputElement(msg.release());
-      output_queue_.push(element);
+      output_queue_.push_back(element);
       break;
     }
 
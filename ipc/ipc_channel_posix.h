@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <sys/socket.h>  // for CMSG macros
 
+#include <deque>
 #include <queue>
 #include <set>
 #include <string>
@@ -118,6 +119,10 @@ class IPC_EXPORT ChannelPosix : public Channel,
   // Adds |message| to |output_queue_| and calls ProcessOutgoingMessages().
   bool ProcessMessageForDelivery(Message* message);
 
+  // Adds |element| to |output_queue_|. If |urgent|, it goes ahead of all the
+  // elements which are not, except for the rest of a partly sent message.
+  void QueueOutputElement(OutputElement* element, bool urgent);
+
   // Moves all messages from |prelim_queue_| to |output_queue_| by calling
   // ProcessMessageForDelivery().
   // Returns |false| on channel error.
@@ -142,6 +147,11 @@ class IPC_EXPORT ChannelPosix : public Channel,
   // to keep track of where we are.
   size_t message_send_bytes_written_;
 
+  // The number of elements at the front of |output_queue_| which are sent
+  // ahead of the rest: the hello message, PRIORITY_HIGH messages, and
+  // anything they jumped ahead of which was already being sent.
+  size_t num_urgent_output_elements_;
+
   // File descriptor we're listening on for new connections if we listen
   // for connections.
   base::ScopedFD server_listen_pipe_;
@@ -169,7 +179,7 @@ class IPC_EXPORT ChannelPosix : public Channel,
   std::queue<Message*> prelim_queue_;
 
   // Messages to be sent are queued here.
-  std::queue<OutputElement*> output_queue_;
+  std::deque<OutputElement*> output_queue_;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
@@ -15,7 +15,10 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -247,6 +250,109 @@ TEST_F(IPCChannelPosixTest, SendHangTest) {
   ASSERT_EQ(IPCChannelPosixTestListener::CHANNEL_ERROR, out_listener.status());
 }
 
+// Checks that the messages of each type arrive in the order they were sent
+// in, and records the order in which types were received across all of them.
+class SequenceCheckingListener : public IPC::Listener {
+ public:
+  SequenceCheckingListener() {}
+  ~SequenceCheckingListener() override {}
+
+  bool OnMessageReceived(const IPC::Message& message) override {
+    if (message.type() == kQuitMessage) {
+      base::MessageLoopForIO::current()->QuitNow();
+      return true;
+    }
+    base::PickleIterator iter(message);
+    int sequence;
+    std::string payload;
+    EXPECT_TRUE(iter.ReadInt(&sequence));
+    EXPECT_TRUE(iter.ReadString(&payload));
+    EXPECT_EQ(next_sequences_[message.type()], sequence);
+    EXPECT_EQ(std::string(sequence * 97, 'x'), payload);
+    ++next_sequences_[message.type()];
+    received_types_.push_back(message.type());
+    return true;
+  }
+
+  int next_sequence(uint32_t type) { return next_sequences_[type]; }
+  const std::vector<uint32_t>& received_types() const {
+    return received_types_;
+  }
+
+ private:
+  std::map<uint32_t, int> next_sequences_;
+  std::vector<uint32_t> received_types_;
+};
+
+void SendSequence(IPC::Channel* channel,
+                  uint32_t type,
+                  IPC::Message::PriorityValue priority,
+                  int num_messages) {
+  for (int i = 0; i < num_messages; ++i) {
+    IPC::Message* message = new IPC::Message(0, type, priority);
+    message->WriteInt(i);
+    message->WriteString(std::string(i * 97, 'x'));
+    ASSERT_TRUE(channel->Send(message));
+  }
+}
+
+// Messages queued up while the socket is full are written several to a
+// sendmsg(), and some of them only partly. Make sure they all arrive intact
+// and in order.
+TEST_F(IPCChannelPosixTest, SendQueuedMessagesInOrder) {
+  const int kNumMessages = 1000;
+  IPCChannelPosixTestListener out_listener(true);
+  SequenceCheckingListener in_listener;
+  IPC::ChannelHandle in_handle("IN");
+  std::unique_ptr<IPC::ChannelPosix> in_chan(new IPC::ChannelPosix(
+      in_handle, IPC::Channel::MODE_SERVER, &in_listener));
+  IPC::ChannelHandle out_handle(
+      "OUT", base::FileDescriptor(in_chan->TakeClientFileDescriptor()));
+  std::unique_ptr<IPC::ChannelPosix> out_chan(new IPC::ChannelPosix(
+      out_handle, IPC::Channel::MODE_CLIENT, &out_listener));
+  ASSERT_TRUE(in_chan->Connect());
+  ASSERT_TRUE(out_chan->Connect());
+  SendSequence(out_chan.get(), 1, IPC::Message::PRIORITY_NORMAL,
+               kNumMessages);
+  ASSERT_TRUE(out_chan->Send(
+      new IPC::Message(0, kQuitMessage, IPC::Message::PRIORITY_NORMAL)));
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+  EXPECT_EQ(kNumMessages, in_listener.next_sequence(1));
+}
+
+// High priority messages sent while the socket is full go out ahead of the
+// normal ones queued before them, and each kind stays in order.
+TEST_F(IPCChannelPosixTest, SendHighPriorityMessagesFirst) {
+  const uint32_t kNormalType = 1;
+  const uint32_t kHighType = 2;
+  const int kNumNormalMessages = 300;
+  const int kNumHighMessages = 5;
+  IPCChannelPosixTestListener out_listener(true);
+  SequenceCheckingListener in_listener;
+  IPC::ChannelHandle in_handle("IN");
+  std::unique_ptr<IPC::ChannelPosix> in_chan(new IPC::ChannelPosix(
+      in_handle, IPC::Channel::MODE_SERVER, &in_listener));
+  IPC::ChannelHandle out_handle(
+      "OUT", base::FileDescriptor(in_chan->TakeClientFileDescriptor()));
+  std::unique_ptr<IPC::ChannelPosix> out_chan(new IPC::ChannelPosix(
+      out_handle, IPC::Channel::MODE_CLIENT, &out_listener));
+  ASSERT_TRUE(in_chan->Connect());
+  ASSERT_TRUE(out_chan->Connect());
+  SendSequence(out_chan.get(), kNormalType, IPC::Message::PRIORITY_NORMAL,
+               kNumNormalMessages);
+  SendSequence(out_chan.get(), kHighType, IPC::Message::PRIORITY_HIGH,
+               kNumHighMessages);
+  ASSERT_TRUE(out_chan->Send(
+      new IPC::Message(0, kQuitMessage, IPC::Message::PRIORITY_NORMAL)));
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+
+  EXPECT_EQ(kNumNormalMessages, in_listener.next_sequence(kNormalType));
+  EXPECT_EQ(kNumHighMessages, in_listener.next_sequence(kHighType));
+  const std::vector<uint32_t>& types = in_listener.received_types();
+  ASSERT_FALSE(types.empty());
+  EXPECT_EQ(kNormalType, types.back());
+}
+
 // If a connection closes right before a Connect() call, we may end up closing
 // the connection without notifying the listener, which can cause hangs in
 // sync_message_filter and others. Make sure the listener is notified.
@@ -118,6 +118,9 @@ bool ChannelWin::ProcessMessageForDelivery(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif
 
+  // Named pipes are written from a single buffer.
+  message->FlattenExternalData();
+
   TRACE_EVENT_WITH_FLOW0(TRACE_DISABLED_BY_DEFAULT("ipc.flow"),
                          "ChannelWin::ProcessMessageForDelivery",
                          message->flags(),
@@ -76,6 +76,13 @@ class IPC_EXPORT Message : public base::Pickle {
     return static_cast<PriorityValue>(header()->flags & PRIORITY_MASK);
   }
 
+  // A POSIX channel sends PRIORITY_HIGH messages ahead of any others still
+  // queued on it, e.g. behind a bulk transfer. Messages of the same priority
+  // are never reordered.
+  void set_priority(PriorityValue priority) {
+    header()->flags = (header()->flags & ~PRIORITY_MASK) | priority;
+  }
+
   // True if this is a synchronous message.
   void set_sync() {
     header()->flags |= SYNC_BIT;
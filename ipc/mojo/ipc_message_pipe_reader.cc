@@ -94,6 +94,7 @@ bool MessagePipeReader::Send(std::unique_ptr<Message> message) {
   if (result != MOJO_RESULT_OK)
     return false;
 
+  message->FlattenExternalData();
   mojo::Array<uint8_t> data(message->size());
   std::copy(reinterpret_cast<const uint8_t*>(message->data()),
             reinterpret_cast<const uint8_t*>(message->data()) + message->size(),
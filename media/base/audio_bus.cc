@@ -12,10 +12,17 @@
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
 #include "media/base/audio_parameters.h"
 #include "media/base/limits.h"
 #include "media/base/vector_math.h"
 
+// NaCl does not allow intrinsics.
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#define INTERLEAVE_SSE2
+#endif
+
 namespace media {
 
 static const uint8_t kUint8Bias = 128;
@@ -41,6 +48,200 @@ static int CalculateMemorySizeInternal(int channels, int frames,
   return sizeof(float) * channels * aligned_frames;
 }
 
+#if defined(INTERLEAVE_SSE2)
+// Mono and stereo audio, by far the most common, are converted four frames at
+// a time. The results are the same as those of the scalar loops below.
+
+// Loads four frames of mono samples, without their bias.
+static __m128i LoadMonoSSE2(const uint8_t* source) {
+  int32_t packed;
+  memcpy(&packed, source, sizeof(packed));
+  __m128i samples = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed),
+                                      _mm_setzero_si128());
+  samples = _mm_sub_epi16(samples, _mm_set1_epi16(kUint8Bias));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+
+static __m128i LoadMonoSSE2(const int16_t* source) {
+  __m128i samples =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+
+static __m128i LoadMonoSSE2(const int32_t* source) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+}
+
+// Splits eight interleaved 16-bit samples into the left and right channels.
+static void SplitStereoSSE2(__m128i samples, __m128i* left, __m128i* right) {
+  *left = _mm_srai_epi32(_mm_slli_epi32(samples, 16), 16);
+  *right = _mm_srai_epi32(samples, 16);
+}
+
+// Loads four frames of stereo samples, without their bias.
+static void LoadStereoSSE2(const uint8_t* source,
+                           __m128i* left,
+                           __m128i* right) {
+  __m128i samples = _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)),
+      _mm_setzero_si128());
+  SplitStereoSSE2(_mm_sub_epi16(samples, _mm_set1_epi16(kUint8Bias)), left,
+                  right);
+}
+
+static void LoadStereoSSE2(const int16_t* source,
+                           __m128i* left,
+                           __m128i* right) {
+  SplitStereoSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)),
+                  left, right);
+}
+
+static void LoadStereoSSE2(const int32_t* source,
+                           __m128i* left,
+                           __m128i* right) {
+  __m128 first = _mm_castsi128_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+  __m128 second = _mm_castsi128_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4)));
+  *left = _mm_castps_si128(
+      _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+  *right = _mm_castps_si128(
+      _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+// Stores four frames of mono samples, adding their bias.
+static void StoreMonoSSE2(__m128i samples, uint8_t* dest) {
+  samples = _mm_add_epi16(_mm_packs_epi32(samples, samples),
+                          _mm_set1_epi16(kUint8Bias));
+  int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(samples, samples));
+  memcpy(dest, &packed, sizeof(packed));
+}
+
+static void StoreMonoSSE2(__m128i samples, int16_t* dest) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dest),
+                   _mm_packs_epi32(samples, samples));
+}
+
+static void StoreMonoSSE2(__m128i samples, int32_t* dest) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), samples);
+}
+
+// Stores four frames of stereo samples, adding their bias.
+static void StoreStereoSSE2(__m128i left, __m128i right, uint8_t* dest) {
+  __m128i samples = _mm_add_epi16(
+      _mm_packs_epi32(_mm_unpacklo_epi32(left, right),
+                      _mm_unpackhi_epi32(left, right)),
+      _mm_set1_epi16(kUint8Bias));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dest),
+                   _mm_packus_epi16(samples, samples));
+}
+
+static void StoreStereoSSE2(__m128i left, __m128i right, int16_t* dest) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packs_epi32(_mm_unpacklo_epi32(left, right),
+                                   _mm_unpackhi_epi32(left, right)));
+}
+
+static void StoreStereoSSE2(__m128i left, __m128i right, int32_t* dest) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_unpacklo_epi32(left, right));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4),
+                   _mm_unpackhi_epi32(left, right));
+}
+
+// Multiplies |values| by |negative_scale| or |positive_scale| by their sign.
+static __m128 ScaleBySignSSE2(__m128 values,
+                              __m128 negative_scale,
+                              __m128 positive_scale) {
+  __m128 negative = _mm_cmplt_ps(values, _mm_setzero_ps());
+  return _mm_mul_ps(values, _mm_or_ps(_mm_and_ps(negative, negative_scale),
+                                      _mm_andnot_ps(negative, positive_scale)));
+}
+
+// Converts |values| to samples, clipping them to [|min|, |max|].
+static __m128i FloatToSampleSSE2(__m128 values,
+                                 __m128 negative_scale,
+                                 __m128 positive_scale,
+                                 __m128i min,
+                                 __m128i max) {
+  __m128i samples = _mm_cvttps_epi32(
+      ScaleBySignSSE2(values, negative_scale, positive_scale));
+  __m128i clip_max = _mm_castps_si128(_mm_cmpge_ps(values, _mm_set1_ps(1)));
+  samples = _mm_or_si128(_mm_and_si128(clip_max, max),
+                         _mm_andnot_si128(clip_max, samples));
+  __m128i clip_min = _mm_castps_si128(_mm_cmple_ps(values, _mm_set1_ps(-1)));
+  return _mm_or_si128(_mm_and_si128(clip_min, min),
+                      _mm_andnot_si128(clip_min, samples));
+}
+
+// Deinterleaves |frames|, a multiple of four, of mono or stereo |source|.
+template <class Format>
+static void FromInterleavedSSE2(const Format* source,
+                                int start_frame,
+                                int frames,
+                                AudioBus* dest,
+                                float min,
+                                float max) {
+  const __m128 negative_scale = _mm_set1_ps(-min);
+  const __m128 positive_scale = _mm_set1_ps(max);
+  float* left = dest->channel(0) + start_frame;
+  if (dest->channels() == 1) {
+    for (int i = 0; i < frames; i += 4) {
+      _mm_storeu_ps(left + i,
+                    ScaleBySignSSE2(_mm_cvtepi32_ps(LoadMonoSSE2(source + i)),
+                                    negative_scale, positive_scale));
+    }
+    return;
+  }
+
+  DCHECK_EQ(2, dest->channels());
+  float* right = dest->channel(1) + start_frame;
+  for (int i = 0; i < frames; i += 4) {
+    __m128i left_samples;
+    __m128i right_samples;
+    LoadStereoSSE2(source + 2 * i, &left_samples, &right_samples);
+    _mm_storeu_ps(left + i, ScaleBySignSSE2(_mm_cvtepi32_ps(left_samples),
+                                            negative_scale, positive_scale));
+    _mm_storeu_ps(right + i, ScaleBySignSSE2(_mm_cvtepi32_ps(right_samples),
+                                             negative_scale, positive_scale));
+  }
+}
+
+// Interleaves |frames|, a multiple of four, of mono or stereo |source|.
+template <class Format, class Fixed>
+static void ToInterleavedSSE2(const AudioBus* source,
+                              int start_frame,
+                              int frames,
+                              Format* dest,
+                              Fixed min,
+                              Fixed max) {
+  const __m128 negative_scale = _mm_set1_ps(-static_cast<float>(min));
+  const __m128 positive_scale = _mm_set1_ps(max);
+  const __m128i min_sample = _mm_set1_epi32(min);
+  const __m128i max_sample = _mm_set1_epi32(max);
+  const float* left = source->channel(0) + start_frame;
+  if (source->channels() == 1) {
+    for (int i = 0; i < frames; i += 4) {
+      StoreMonoSSE2(FloatToSampleSSE2(_mm_loadu_ps(left + i), negative_scale,
+                                      positive_scale, min_sample, max_sample),
+                    dest + i);
+    }
+    return;
+  }
+
+  DCHECK_EQ(2, source->channels());
+  const float* right = source->channel(1) + start_frame;
+  for (int i = 0; i < frames; i += 4) {
+    StoreStereoSSE2(
+        FloatToSampleSSE2(_mm_loadu_ps(left + i), negative_scale,
+                          positive_scale, min_sample, max_sample),
+        FloatToSampleSSE2(_mm_loadu_ps(right + i), negative_scale,
+                          positive_scale, min_sample, max_sample),
+        dest + 2 * i);
+  }
+}
+#endif  // defined(INTERLEAVE_SSE2)
+
 // |Format| is the destination type.  If a bias is present, |Fixed| must be a
 // type larger than |Format| such that operations can be made without
 // overflowing.  Without a bias |Fixed| must be the same as |Format|.
@@ -52,10 +253,19 @@ static void FromInterleavedInternal(const void* src, int start_frame,
                 sizeof(Fixed) > sizeof(Format), "invalid deinterleave types");
   const Format* source = static_cast<const Format*>(src);
   const int channels = dest->channels();
+  int vectorized_frames = 0;
+#if defined(INTERLEAVE_SSE2)
+  if (channels <= 2) {
+    vectorized_frames = frames & ~3;
+    FromInterleavedSSE2(source, start_frame, vectorized_frames, dest, min,
+                        max);
+  }
+#endif
   for (int ch = 0; ch < channels; ++ch) {
     float* channel_data = dest->channel(ch);
-    for (int i = start_frame, offset = ch; i < start_frame + frames;
-         ++i, offset += channels) {
+    for (int i = start_frame + vectorized_frames,
+             offset = ch + vectorized_frames * channels;
+         i < start_frame + frames; ++i, offset += channels) {
       const Fixed v = static_cast<Fixed>(source[offset]) - Bias;
       channel_data[i] = v * (v < 0 ? -min : max);
     }
@@ -72,10 +282,18 @@ static void ToInterleavedInternal(const AudioBus* source, int start_frame,
                 sizeof(Fixed) > sizeof(Format), "invalid interleave types");
   Format* dest = static_cast<Format*>(dst);
   const int channels = source->channels();
+  int vectorized_frames = 0;
+#if defined(INTERLEAVE_SSE2)
+  if (channels <= 2) {
+    vectorized_frames = frames & ~3;
+    ToInterleavedSSE2(source, start_frame, vectorized_frames, dest, min, max);
+  }
+#endif
   for (int ch = 0; ch < channels; ++ch) {
     const float* channel_data = source->channel(ch);
-    for (int i = start_frame, offset = ch; i < start_frame + frames;
-         ++i, offset += channels) {
+    for (int i = start_frame + vectorized_frames,
+             offset = ch + vectorized_frames * channels;
+         i < start_frame + frames; ++i, offset += channels) {
       const float v = channel_data[i];
 
       Fixed sample;
@@ -254,7 +472,6 @@ void AudioBus::BuildChannelData(int channels, int aligned_frames, float* data) {
     channel_data_.push_back(data + i * aligned_frames);
 }
 
-// TODO(dalecurtis): See if intrinsic optimizations help any here.
 void AudioBus::FromInterleavedPartial(const void* source, int start_frame,
                                       int frames, int bytes_per_sample) {
   CheckOverflow(start_frame, frames, frames_);
@@ -300,7 +517,6 @@ void AudioBus::ToInterleaved(int frames, int bytes_per_sample,
   ToInterleavedPartial(0, frames, bytes_per_sample, dest);
 }
 
-// TODO(dalecurtis): See if intrinsic optimizations help any here.
 void AudioBus::ToInterleavedPartial(int start_frame, int frames,
                                     int bytes_per_sample, void* dest) const {
   CheckOverflow(start_frame, frames, frames_);
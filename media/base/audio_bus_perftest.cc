@@ -53,4 +53,15 @@ TEST(AudioBusPerfTest, Interleave) {
   RunInterleaveBench<int32_t>(bus.get(), "int32_t");
 }
 
+// Benchmark the same on mono audio, which has its own fast paths.
+TEST(AudioBusPerfTest, InterleaveMono) {
+  std::unique_ptr<AudioBus> bus = AudioBus::Create(1, 48000 * 120);
+  FakeAudioRenderCallback callback(0.2);
+  callback.Render(bus.get(), 0, 0);
+
+  RunInterleaveBench<int8_t>(bus.get(), "int8_t_mono");
+  RunInterleaveBench<int16_t>(bus.get(), "int16_t_mono");
+  RunInterleaveBench<int32_t>(bus.get(), "int32_t_mono");
+}
+
 } // namespace media
@@ -7,6 +7,7 @@
 
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/strings/stringprintf.h"
@@ -397,6 +398,80 @@ TEST_F(AudioBusTest, ToInterleavedPartial) {
       kPartialFrames * sizeof(*kTestVectorInt16) * kTestVectorChannels), 0);
 }
 
+// Interleaves the first channels of |reference| both with the others and on
+// their own in |bus|, then deinterleaves them back in two parts, and verifies
+// the results match.
+template <typename T>
+static void VerifyInterleavingMatches(AudioBus* bus, AudioBus* reference) {
+  const int channels = bus->channels();
+  const int reference_channels = reference->channels();
+  std::vector<T> interleaved(bus->frames() * channels);
+  std::vector<T> reference_interleaved(reference->frames() *
+                                       reference_channels);
+  bus->ToInterleaved(bus->frames(), sizeof(T), interleaved.data());
+  reference->ToInterleaved(reference->frames(), sizeof(T),
+                           reference_interleaved.data());
+  for (int i = 0; i < bus->frames(); ++i) {
+    for (int ch = 0; ch < channels; ++ch) {
+      ASSERT_EQ(reference_interleaved[i * reference_channels + ch],
+                interleaved[i * channels + ch])
+          << "i=" << i << ", ch=" << ch;
+    }
+  }
+
+  // The second part starts off the alignment of the channels.
+  const int kPartialStart = 3;
+  const int partial_frames = bus->frames() - kPartialStart;
+  bus->FromInterleavedPartial(interleaved.data(), 0, kPartialStart, sizeof(T));
+  reference->FromInterleavedPartial(reference_interleaved.data(), 0,
+                                    kPartialStart, sizeof(T));
+  bus->FromInterleavedPartial(interleaved.data() + kPartialStart * channels,
+                              kPartialStart, partial_frames, sizeof(T));
+  reference->FromInterleavedPartial(
+      reference_interleaved.data() + kPartialStart * reference_channels,
+      kPartialStart, partial_frames, sizeof(T));
+  for (int ch = 0; ch < channels; ++ch) {
+    for (int i = 0; i < bus->frames(); ++i) {
+      ASSERT_EQ(reference->channel(ch)[i], bus->channel(ch)[i])
+          << "i=" << i << ", ch=" << ch;
+    }
+  }
+}
+
+// Verify mono and stereo audio, which may be converted with SIMD, are
+// converted the same way as the channels of other layouts.
+TEST_F(AudioBusTest, InterleaveMonoAndStereo) {
+  for (int channels = 1; channels <= 2; ++channels) {
+    SCOPED_TRACE(base::StringPrintf("channels=%d", channels));
+    std::unique_ptr<AudioBus> bus = AudioBus::Create(channels, kFrameCount);
+    std::unique_ptr<AudioBus> reference =
+        AudioBus::Create(kChannels, kFrameCount);
+    // Sweep through values beyond [-1, 1], including both ends and zero.
+    for (int ch = 0; ch < reference->channels(); ++ch) {
+      for (int i = 0; i < reference->frames(); ++i) {
+        reference->channel(ch)[i] = -1.5f + ((i * 7 + ch * 13) % 97) / 32.0f;
+      }
+    }
+
+    for (int ch = 0; ch < channels; ++ch) {
+      memcpy(bus->channel(ch), reference->channel(ch),
+             sizeof(*bus->channel(ch)) * bus->frames());
+    }
+    {
+      SCOPED_TRACE("uint8_t");
+      VerifyInterleavingMatches<uint8_t>(bus.get(), reference.get());
+    }
+    {
+      SCOPED_TRACE("int16_t");
+      VerifyInterleavingMatches<int16_t>(bus.get(), reference.get());
+    }
+    {
+      SCOPED_TRACE("int32_t");
+      VerifyInterleavingMatches<int32_t>(bus.get(), reference.get());
+    }
+  }
+}
+
 TEST_F(AudioBusTest, Scale) {
   std::unique_ptr<AudioBus> bus = AudioBus::Create(kChannels, kFrameCount);
 
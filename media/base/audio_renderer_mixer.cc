@@ -19,11 +19,11 @@ AudioRendererMixer::AudioRendererMixer(const AudioParameters& output_params,
                                        scoped_refptr<AudioRendererSink> sink)
     : output_params_(output_params),
       audio_sink_(std::move(sink)),
-      master_converter_(output_params, output_params, true),
       pause_delay_(base::TimeDelta::FromSeconds(kPauseDelaySeconds)),
       last_play_time_(base::TimeTicks::Now()),
       // Initialize |playing_| to true since Start() results in an auto-play.
-      playing_(true) {
+      playing_(true),
+      master_converter_(output_params, output_params, true) {
   DCHECK(audio_sink_);
   audio_sink_->Initialize(output_params, this);
   audio_sink_->Start();
@@ -32,6 +32,11 @@ AudioRendererMixer::AudioRendererMixer(const AudioParameters& output_params,
 AudioRendererMixer::~AudioRendererMixer() {
   // AudioRendererSink must be stopped before mixer is destructed.
   audio_sink_->Stop();
+  {
+    base::AutoLock auto_render_lock(render_lock_);
+    base::AutoLock auto_lock(lock_);
+    AddPendingInputs();
+  }
 
   // Ensure that all mixer inputs have removed themselves prior to destruction.
   DCHECK(master_converter_.empty());
@@ -48,9 +53,11 @@ void AudioRendererMixer::AddMixerInput(const AudioParameters& input_params,
     audio_sink_->Play();
   }
 
+  // The audio thread picks up the new input on its next Render(); creating
+  // the converter happens here so that Render() never waits for it.
   int input_sample_rate = input_params.sample_rate();
   if (is_master_sample_rate(input_sample_rate)) {
-    master_converter_.AddInput(input);
+    pending_inputs_.push_back({nullptr, input});
   } else {
     AudioConvertersMap::iterator converter =
         converters_.find(input_sample_rate);
@@ -66,29 +73,39 @@ void AudioRendererMixer::AddMixerInput(const AudioParameters& input_params,
       converter = result.first;
 
       // Add newly-created resampler as an input to the master mixer.
-      master_converter_.AddInput(converter->second.get());
+      pending_inputs_.push_back({nullptr, converter->second.get()});
     }
-    converter->second->AddInput(input);
+    pending_inputs_.push_back({converter->second.get(), input});
   }
 }
 
 void AudioRendererMixer::RemoveMixerInput(
     const AudioParameters& input_params,
     AudioConverter::InputCallback* input) {
-  base::AutoLock auto_lock(lock_);
-
-  int input_sample_rate = input_params.sample_rate();
-  if (is_master_sample_rate(input_sample_rate)) {
-    master_converter_.RemoveInput(input);
-  } else {
-    AudioConvertersMap::iterator converter =
-        converters_.find(input_sample_rate);
-    DCHECK(converter != converters_.end());
-    converter->second->RemoveInput(input);
-    if (converter->second->empty()) {
-      // Remove converter when it's empty.
-      master_converter_.RemoveInput(converter->second.get());
-      converters_.erase(converter);
+  // Destroyed after the locks are released to keep |render_lock_| held only
+  // briefly.
+  std::unique_ptr<LoopbackAudioConverter> removed_converter;
+  {
+    // Waits for an in-flight Render() to finish, so |input| is never called
+    // once this returns.
+    base::AutoLock auto_render_lock(render_lock_);
+    base::AutoLock auto_lock(lock_);
+    AddPendingInputs();
+
+    int input_sample_rate = input_params.sample_rate();
+    if (is_master_sample_rate(input_sample_rate)) {
+      master_converter_.RemoveInput(input);
+    } else {
+      AudioConvertersMap::iterator converter =
+          converters_.find(input_sample_rate);
+      DCHECK(converter != converters_.end());
+      converter->second->RemoveInput(input);
+      if (converter->second->empty()) {
+        // Remove converter when it's empty.
+        master_converter_.RemoveInput(converter->second.get());
+        removed_converter = std::move(converter->second);
+        converters_.erase(converter);
+      }
     }
   }
 }
@@ -122,23 +139,48 @@ OutputDeviceInfo AudioRendererMixer::GetOutputDeviceInfo() {
 int AudioRendererMixer::Render(AudioBus* audio_bus,
                                uint32_t frames_delayed,
                                uint32_t frames_skipped) {
-  base::AutoLock auto_lock(lock_);
+  // Never block the audio thread on other threads.  |render_lock_| is only
+  // contended while RemoveMixerInput() unlinks an input, in which case this
+  // callback is skipped.
+  if (!render_lock_.Try()) {
+    audio_bus->Zero();
+    return audio_bus->frames();
+  }
 
-  // If there are no mixer inputs and we haven't seen one for a while, pause the
-  // sink to avoid wasting resources when media elements are present but remain
-  // in the pause state.
-  const base::TimeTicks now = base::TimeTicks::Now();
-  if (!master_converter_.empty()) {
-    last_play_time_ = now;
-  } else if (now - last_play_time_ >= pause_delay_ && playing_) {
-    audio_sink_->Pause();
-    playing_ = false;
+  // If |lock_| is busy, new inputs and the pause check wait for the next call.
+  if (lock_.Try()) {
+    AddPendingInputs();
+
+    // If there are no mixer inputs and we haven't seen one for a while, pause
+    // the sink to avoid wasting resources when media elements are present but
+    // remain in the pause state.
+    const base::TimeTicks now = base::TimeTicks::Now();
+    if (!master_converter_.empty()) {
+      last_play_time_ = now;
+    } else if (now - last_play_time_ >= pause_delay_ && playing_) {
+      audio_sink_->Pause();
+      playing_ = false;
+    }
+    lock_.Release();
   }
 
   master_converter_.ConvertWithDelay(frames_delayed, audio_bus);
+  render_lock_.Release();
   return audio_bus->frames();
 }
 
+void AudioRendererMixer::AddPendingInputs() {
+  render_lock_.AssertAcquired();
+  lock_.AssertAcquired();
+  for (const PendingInput& pending : pending_inputs_) {
+    if (pending.converter)
+      pending.converter->AddInput(pending.input);
+    else
+      master_converter_.AddInput(pending.input);
+  }
+  pending_inputs_.clear();
+}
+
 void AudioRendererMixer::OnRenderError() {
   // Call each mixer input and signal an error.
   base::AutoLock auto_lock(lock_);
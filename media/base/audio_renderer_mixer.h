@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/synchronization/lock.h"
@@ -31,6 +32,8 @@ class MEDIA_EXPORT AudioRendererMixer
   ~AudioRendererMixer() override;
 
   // Add or remove a mixer input from mixing; called by AudioRendererMixerInput.
+  // Added inputs are picked up by the next Render().  RemoveMixerInput() waits
+  // for an in-flight Render() so |input| is not called once it returns.
   void AddMixerInput(const AudioParameters& input_params,
                      AudioConverter::InputCallback* input);
   void RemoveMixerInput(const AudioParameters& input_params,
@@ -63,6 +66,10 @@ class MEDIA_EXPORT AudioRendererMixer
     return sample_rate == output_params_.sample_rate();
   }
 
+  // Hands the inputs queued by AddMixerInput() to their converters.  Both
+  // |render_lock_| and |lock_| must be held.
+  void AddPendingInputs();
+
   // Output parameters for this mixer.
   const AudioParameters output_params_;
 
@@ -70,6 +77,8 @@ class MEDIA_EXPORT AudioRendererMixer
   const scoped_refptr<AudioRendererSink> audio_sink_;
 
   // ---------------[ All variables below protected by |lock_| ]---------------
+  // Render() only ever tries to acquire |lock_|, so holding it never blocks
+  // the audio thread; queued changes are simply picked up by a later Render().
   base::Lock lock_;
 
   // List of error callbacks used by this mixer.
@@ -78,12 +87,17 @@ class MEDIA_EXPORT AudioRendererMixer
 
   // Each of these converters mixes inputs with a given sample rate and
   // resamples them to the output sample rate. Inputs not reqiuring resampling
-  // go directly to |master_converter_|.
+  // go directly to |master_converter_|.  The inputs of each converter are
+  // protected by |render_lock_|.
   AudioConvertersMap converters_;
 
-  // Master converter which mixes all the outputs from |converters_| as well as
-  // mixer inputs that are in the output sample rate.
-  AudioConverter master_converter_;
+  // Inputs added by AddMixerInput() which Render() has not picked up yet.  A
+  // null |converter| stands for |master_converter_|.
+  struct PendingInput {
+    LoopbackAudioConverter* converter;
+    AudioConverter::InputCallback* input;
+  };
+  std::vector<PendingInput> pending_inputs_;
 
   // Handles physical stream pause when no inputs are playing.  For latency
   // reasons we don't want to immediately pause the physical stream.
@@ -91,6 +105,16 @@ class MEDIA_EXPORT AudioRendererMixer
   base::TimeTicks last_play_time_;
   bool playing_;
 
+  // ------------[ All variables below protected by |render_lock_| ]-----------
+  // Held by Render() while mixing and by RemoveMixerInput(), which must not
+  // return while the removed input may still be rendered.  Render() only tries
+  // to acquire it and outputs silence if a removal is in progress.
+  base::Lock render_lock_;
+
+  // Master converter which mixes all the outputs from |converters_| as well as
+  // mixer inputs that are in the output sample rate.
+  AudioConverter master_converter_;
+
   DISALLOW_COPY_AND_ASSIGN(AudioRendererMixer);
 };
 
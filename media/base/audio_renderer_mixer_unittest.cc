@@ -468,6 +468,55 @@ TEST_P(AudioRendererMixerBehavioralTest, OnRenderErrorPausedInput) {
     mixer_inputs_[i]->Stop();
 }
 
+// Calls Render() a number of times, like the audio device thread does.
+class RenderLoop : public base::PlatformThread::Delegate {
+ public:
+  RenderLoop(AudioRendererSink::RenderCallback* callback, AudioBus* audio_bus)
+      : callback_(callback),
+        audio_bus_(audio_bus),
+        done_(base::WaitableEvent::ResetPolicy::MANUAL,
+              base::WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void ThreadMain() override {
+    for (int i = 0; i < 200; ++i)
+      callback_->Render(audio_bus_, 0, 0);
+    done_.Signal();
+  }
+
+  bool done() { return done_.IsSignaled(); }
+
+ private:
+  AudioRendererSink::RenderCallback* const callback_;
+  AudioBus* const audio_bus_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(RenderLoop);
+};
+
+// Ensure inputs can be added and removed while another thread renders.
+TEST_P(AudioRendererMixerBehavioralTest, AddRemoveInputsWhileRendering) {
+  InitializeInputs(kMixerInputs);
+  for (size_t i = 0; i < mixer_inputs_.size(); ++i)
+    mixer_inputs_[i]->Start();
+
+  RenderLoop render_loop(mixer_callback_, audio_bus_.get());
+  base::PlatformThreadHandle render_thread;
+  ASSERT_TRUE(base::PlatformThread::Create(0, &render_loop, &render_thread));
+  while (!render_loop.done()) {
+    for (size_t i = 0; i < mixer_inputs_.size(); ++i)
+      mixer_inputs_[i]->Play();
+    for (size_t i = 0; i < mixer_inputs_.size(); ++i)
+      mixer_inputs_[i]->Pause();
+  }
+  base::PlatformThread::Join(render_thread);
+
+  for (size_t i = 0; i < mixer_inputs_.size(); ++i)
+    mixer_inputs_[i]->Stop();
+
+  // All inputs are gone, so only silence is left.
+  EXPECT_TRUE(RenderAndValidateAudioData(0.0f));
+}
+
 // Ensure the physical stream is paused after a certain amount of time with no
 // inputs playing.  The test will hang if the behavior is incorrect.
 TEST_P(AudioRendererMixerBehavioralTest, MixerPausesStream) {
@@ -12,14 +12,15 @@
 
 #include "base/callback.h"
 #include "base/macros.h"
-#include "base/memory/scoped_vector.h"
 #include "media/base/sinc_resampler.h"
 
 namespace media {
 class AudioBus;
 
 // MultiChannelResampler is a multi channel wrapper for SincResampler; allowing
-// high quality sample rate conversion of multiple channels at once.
+// high quality sample rate conversion of multiple channels at once.  All the
+// channels go through a single SincResampler, which shares its kernels and
+// bookkeeping among them.
 class MEDIA_EXPORT MultiChannelResampler {
  public:
   // Callback type for providing more data into the resampler.  Expects AudioBus
@@ -45,7 +46,7 @@ class MEDIA_EXPORT MultiChannelResampler {
   // not call while Resample() is in progress.
   void Flush();
 
-  // Update ratio for all SincResamplers.  SetRatio() will cause reconstruction
+  // Update ratio of the SincResampler.  SetRatio() will cause reconstruction
   // of the kernels used for resampling.  Not thread safe, do not call while
   // Resample() is in progress.
   void SetRatio(double io_sample_rate_ratio);
@@ -61,23 +62,23 @@ class MEDIA_EXPORT MultiChannelResampler {
   void PrimeWithSilence();
 
  private:
-  // SincResampler::ReadCB implementation.  ProvideInput() will be called for
-  // each channel (in channel order) as SincResampler needs more data.
-  void ProvideInput(int channel, int frames, float* destination);
+  // SincResampler::MultiChannelReadCB implementation.  ProvideInput() will be
+  // called as SincResampler needs more data.
+  void ProvideInput(int frames, float* const* destinations);
 
   // Source of data for resampling.
   ReadCB read_cb_;
 
-  // Each channel has its own high quality resampler.
-  ScopedVector<SincResampler> resamplers_;
+  // The high quality resampler for all the channels.
+  std::unique_ptr<SincResampler> resampler_;
 
-  // Buffers for audio data going into SincResampler from ReadCB.
-  std::unique_ptr<AudioBus> resampler_audio_bus_;
-
-  // To avoid a memcpy() on the first channel we create a wrapped AudioBus where
-  // the first channel points to the |destination| provided to ProvideInput().
+  // To avoid a memcpy() we create a wrapped AudioBus where the channels point
+  // to the |destinations| provided to ProvideInput().
   std::unique_ptr<AudioBus> wrapped_resampler_audio_bus_;
 
+  // Where each channel goes in the AudioBus provided to Resample().
+  std::vector<float*> output_channels_;
+
   // The number of output frames that have successfully been processed during
   // the current Resample() call.
   int output_frames_ready_;
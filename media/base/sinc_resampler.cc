@@ -81,6 +81,7 @@
 #include <cmath>
 #include <limits>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "build/build_config.h"
 
@@ -116,13 +117,30 @@ static int CalculateChunkSize(int block_size_, double io_ratio) {
   return block_size_ / io_ratio;
 }
 
+static void RunSingleChannelReadCB(const SincResampler::ReadCB& read_cb,
+                                   int frames,
+                                   float* const* destinations) {
+  read_cb.Run(frames, destinations[0]);
+}
+
 SincResampler::SincResampler(double io_sample_rate_ratio,
                              int request_frames,
                              const ReadCB& read_cb)
+    : SincResampler(1,
+                    io_sample_rate_ratio,
+                    request_frames,
+                    base::Bind(&RunSingleChannelReadCB, read_cb)) {}
+
+SincResampler::SincResampler(int channels,
+                             double io_sample_rate_ratio,
+                             int request_frames,
+                             const MultiChannelReadCB& read_cb)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
+      channels_(channels),
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
+      input_channel_stride_((input_buffer_size_ + 3) & ~3),
       // Create input buffers with a 16-byte alignment for SSE optimizations.
       kernel_storage_(static_cast<float*>(
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 16))),
@@ -130,10 +148,12 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 16))),
       kernel_window_storage_(static_cast<float*>(
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 16))),
-      input_buffer_(static_cast<float*>(
-          base::AlignedAlloc(sizeof(float) * input_buffer_size_, 16))),
+      input_buffer_(static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * input_channel_stride_ * channels_, 16))),
+      read_destinations_(channels_),
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
+  CHECK_GT(channels_, 0);
   CHECK_GT(request_frames_, 0);
   Flush();
   CHECK_GT(block_size_, kKernelSize)
@@ -155,6 +175,8 @@ void SincResampler::UpdateRegions(bool second_load) {
   // Setup various region pointers in the buffer (see diagram above).  If we're
   // on the second load we need to slide r0_ to the right by kKernelSize / 2.
   r0_ = input_buffer_.get() + (second_load ? kKernelSize : kKernelSize / 2);
+  for (int ch = 0; ch < channels_; ++ch)
+    read_destinations_[ch] = r0_ + ch * input_channel_stride_;
   r3_ = r0_ + request_frames_ - kKernelSize;
   r4_ = r0_ + request_frames_ - kKernelSize / 2;
   block_size_ = r4_ - r2_;
@@ -231,11 +253,17 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
 }
 
 void SincResampler::Resample(int frames, float* destination) {
+  DCHECK_EQ(1, channels_);
+  Resample(frames, &destination);
+}
+
+void SincResampler::Resample(int frames, float* const* destinations) {
   int remaining_frames = frames;
+  int output_frame = 0;
 
   // Step (1) -- Prime the input buffer at the start of the input stream.
   if (!buffer_primed_ && remaining_frames) {
-    read_cb_.Run(request_frames_, r0_);
+    read_cb_.Run(request_frames_, read_destinations_.data());
     buffer_primed_ = true;
   }
 
@@ -272,8 +300,12 @@ void SincResampler::Resample(int frames, float* destination) {
       // Figure out how much to weight each kernel's "convolution".
       const double kernel_interpolation_factor =
           virtual_offset_idx - offset_idx;
-      *destination++ = CONVOLVE_FUNC(
-          input_ptr, k1, k2, kernel_interpolation_factor);
+      for (int ch = 0; ch < channels_; ++ch) {
+        destinations[ch][output_frame] =
+            CONVOLVE_FUNC(input_ptr + ch * input_channel_stride_, k1, k2,
+                          kernel_interpolation_factor);
+      }
+      ++output_frame;
 
       // Advance the virtual index.
       virtual_source_idx_ += current_io_ratio;
@@ -289,14 +321,18 @@ void SincResampler::Resample(int frames, float* destination) {
 
     // Step (3) -- Copy r3_, r4_ to r1_, r2_.
     // This wraps the last input frames back to the start of the buffer.
-    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+    for (int ch = 0; ch < channels_; ++ch) {
+      const int offset = ch * input_channel_stride_;
+      memcpy(r1_ + offset, r3_ + offset,
+             sizeof(*input_buffer_.get()) * kKernelSize);
+    }
 
     // Step (4) -- Reinitialize regions if necessary.
     if (r0_ == r2_)
       UpdateRegions(true);
 
     // Step (5) -- Refresh the buffer with more input.
-    read_cb_.Run(request_frames_, r0_);
+    read_cb_.Run(request_frames_, read_destinations_.data());
   }
 }
 
@@ -312,7 +348,7 @@ void SincResampler::Flush() {
   virtual_source_idx_ = 0;
   buffer_primed_ = false;
   memset(input_buffer_.get(), 0,
-         sizeof(*input_buffer_.get()) * input_buffer_size_);
+         sizeof(*input_buffer_.get()) * input_channel_stride_ * channels_);
   UpdateRegions(false);
 }
 
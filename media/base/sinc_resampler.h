@@ -6,6 +6,7 @@
 #define MEDIA_BASE_SINC_RESAMPLER_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/gtest_prod_util.h"
@@ -16,7 +17,9 @@
 
 namespace media {
 
-// SincResampler is a high-quality single-channel sample-rate converter.
+// SincResampler is a high-quality sample-rate converter.  Several channels
+// may be resampled together, in which case they share the kernels and the
+// bookkeeping for each output frame.
 class MEDIA_EXPORT SincResampler {
  public:
   enum {
@@ -41,6 +44,11 @@ class MEDIA_EXPORT SincResampler {
   // are available to satisfy the request.
   typedef base::Callback<void(int frames, float* destination)> ReadCB;
 
+  // Multi-channel version of ReadCB, which expects |frames| of each channel to
+  // be rendered into |destinations|.
+  typedef base::Callback<void(int frames, float* const* destinations)>
+      MultiChannelReadCB;
+
   // Constructs a SincResampler with the specified |read_cb|, which is used to
   // acquire audio data for resampling.  |io_sample_rate_ratio| is the ratio
   // of input / output sample rates.  |request_frames| controls the size in
@@ -50,11 +58,21 @@ class MEDIA_EXPORT SincResampler {
   SincResampler(double io_sample_rate_ratio,
                 int request_frames,
                 const ReadCB& read_cb);
+
+  // Constructs a SincResampler for |channels| channels, which are all read by
+  // each |read_cb| call and resampled by each Resample() call.
+  SincResampler(int channels,
+                double io_sample_rate_ratio,
+                int request_frames,
+                const MultiChannelReadCB& read_cb);
   ~SincResampler();
 
   // Resample |frames| of data from |read_cb_| into |destination|.
   void Resample(int frames, float* destination);
 
+  // Resample |frames| of each channel from |read_cb_| into |destinations|.
+  void Resample(int frames, float* const* destinations);
+
   // The maximum size in frames that guarantees Resample() will only make a
   // single call to |read_cb_| for more data.  Note: If PrimeWithSilence() is
   // not called, chunk size will grow after the first two Resample() calls by
@@ -116,8 +134,11 @@ class MEDIA_EXPORT SincResampler {
   // The buffer is primed once at the very beginning of processing.
   bool buffer_primed_;
 
+  // The number of channels resampled together.
+  const int channels_;
+
   // Source of data for resampling.
-  const ReadCB read_cb_;
+  const MultiChannelReadCB read_cb_;
 
   // The size (in samples) to request from each |read_cb_| execution.
   const int request_frames_;
@@ -129,8 +150,11 @@ class MEDIA_EXPORT SincResampler {
   // guarantees Resample() will only ask for input at most once.
   int chunk_size_;
 
-  // The size (in samples) of the internal buffer used by the resampler.
+  // The size (in samples) of the internal buffer used by the resampler for
+  // each channel, and the distance between the buffers of two channels, which
+  // keeps all of them 16-byte aligned.
   const int input_buffer_size_;
+  const int input_channel_stride_;
 
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
   // The kernel offsets are sub-sample shifts of a windowed sinc shifted from
@@ -139,11 +163,17 @@ class MEDIA_EXPORT SincResampler {
   std::unique_ptr<float[], base::AlignedFreeDeleter> kernel_pre_sinc_storage_;
   std::unique_ptr<float[], base::AlignedFreeDeleter> kernel_window_storage_;
 
-  // Data from the source is copied into this buffer for each processing pass.
+  // Data from the source is copied into this buffer for each processing pass,
+  // one channel after the other.
   std::unique_ptr<float[], base::AlignedFreeDeleter> input_buffer_;
 
-  // Pointers to the various regions inside |input_buffer_|.  See the diagram at
-  // the top of the .cc file for more information.
+  // Where |read_cb_| renders each channel, i.e. |r0_| in each channel's part
+  // of |input_buffer_|.
+  std::vector<float*> read_destinations_;
+
+  // Pointers to the various regions inside the first channel's part of
+  // |input_buffer_|.  See the diagram at the top of the .cc file for more
+  // information.
   float* r0_;
   float* const r1_;
   float* const r2_;
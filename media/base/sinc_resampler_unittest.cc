@@ -138,6 +138,68 @@ TEST(SincResamplerTest, Flush) {
     ASSERT_FLOAT_EQ(resampled_destination[i], 0);
 }
 
+// Fake audio source which produces a distinct, deterministic signal for each
+// channel so that mixups between channels are detected.
+class MultiChannelSource {
+ public:
+  explicit MultiChannelSource(int channels)
+      : channels_(channels), frames_provided_(0) {}
+
+  void ProvideInput(int frames, float* const* destinations) {
+    for (int ch = 0; ch < channels_; ++ch)
+      ProvideChannel(ch, frames, destinations[ch]);
+    frames_provided_ += frames;
+  }
+
+  void ProvideChannel(int channel, int frames, float* destination) {
+    for (int i = 0; i < frames; ++i) {
+      destination[i] =
+          sin((frames_provided_ + i) * 0.01 * (channel + 1)) / (channel + 1);
+    }
+  }
+
+  void ProvideSingleChannel(int channel, int frames, float* destination) {
+    ProvideChannel(channel, frames, destination);
+    frames_provided_ += frames;
+  }
+
+ private:
+  const int channels_;
+  int frames_provided_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiChannelSource);
+};
+
+// Verify resampling several channels at once produces exactly the same output
+// as resampling each channel on its own.
+TEST(SincResamplerTest, MultiChannel) {
+  static const int kChannels = 3;
+  static const int kFrames = 2000;
+
+  MultiChannelSource source(kChannels);
+  SincResampler resampler(
+      kChannels, 1.0 / kSampleRateRatio, SincResampler::kDefaultRequestSize,
+      base::Bind(&MultiChannelSource::ProvideInput, base::Unretained(&source)));
+
+  std::unique_ptr<float[]> output(new float[kChannels * kFrames]);
+  float* destinations[kChannels];
+  for (int ch = 0; ch < kChannels; ++ch)
+    destinations[ch] = output.get() + ch * kFrames;
+  resampler.Resample(kFrames, destinations);
+
+  std::unique_ptr<float[]> expected(new float[kFrames]);
+  for (int ch = 0; ch < kChannels; ++ch) {
+    MultiChannelSource channel_source(kChannels);
+    SincResampler channel_resampler(
+        1.0 / kSampleRateRatio, SincResampler::kDefaultRequestSize,
+        base::Bind(&MultiChannelSource::ProvideSingleChannel,
+                   base::Unretained(&channel_source), ch));
+    channel_resampler.Resample(kFrames, expected.get());
+    for (int i = 0; i < kFrames; ++i)
+      ASSERT_EQ(expected[i], destinations[ch][i]) << ch << ", " << i;
+  }
+}
+
 TEST(SincResamplerTest, DISABLED_SetRatioBench) {
   MockSource mock_source;
   SincResampler resampler(
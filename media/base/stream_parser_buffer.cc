@@ -6,12 +6,17 @@
 
 #include <algorithm>
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "media/base/timestamp_constants.h"
 
 namespace media {
 
+// Returned by splice_buffers() for buffers which aren't splice buffers.
+static base::LazyInstance<StreamParserBuffer::BufferQueue>::Leaky
+    g_empty_splice_buffers = LAZY_INSTANCE_INITIALIZER;
+
 static scoped_refptr<StreamParserBuffer> CopyBuffer(
     const StreamParserBuffer& buffer) {
   if (buffer.end_of_stream())
@@ -121,7 +126,7 @@ void StreamParserBuffer::SetConfigId(int config_id) {
 
 int StreamParserBuffer::GetSpliceBufferConfigId(size_t index) const {
   return index < splice_buffers().size()
-      ? splice_buffers_[index]->GetConfigId()
+      ? (*splice_buffers_)[index]->GetConfigId()
       : GetConfigId();
 }
 
@@ -145,7 +150,7 @@ const char* StreamParserBuffer::GetTypeName() const {
 
 void StreamParserBuffer::ConvertToSpliceBuffer(
     const BufferQueue& pre_splice_buffers) {
-  DCHECK(splice_buffers_.empty());
+  DCHECK(!splice_buffers_);
   DCHECK(duration() > base::TimeDelta())
       << "Only buffers with a valid duration can convert to a splice buffer."
       << " pts " << timestamp().InSecondsF()
@@ -198,6 +203,7 @@ void StreamParserBuffer::ConvertToSpliceBuffer(
       first_splice_buffer->timestamp());
 
   // Copy all pre splice buffers into our wrapper buffer.
+  splice_buffers_.reset(new BufferQueue());
   for (BufferQueue::const_iterator it = pre_splice_buffers.begin();
        it != pre_splice_buffers.end();
        ++it) {
@@ -206,11 +212,16 @@ void StreamParserBuffer::ConvertToSpliceBuffer(
     DCHECK(!buffer->preroll_buffer().get());
     DCHECK(buffer->splice_buffers().empty());
     DCHECK(!buffer->is_duration_estimated());
-    splice_buffers_.push_back(CopyBuffer(*buffer.get()));
-    splice_buffers_.back()->set_splice_timestamp(splice_timestamp());
+    splice_buffers_->push_back(CopyBuffer(*buffer.get()));
+    splice_buffers_->back()->set_splice_timestamp(splice_timestamp());
   }
 
-  splice_buffers_.push_back(overlapping_buffer);
+  splice_buffers_->push_back(overlapping_buffer);
+}
+
+const StreamParserBuffer::BufferQueue& StreamParserBuffer::splice_buffers()
+    const {
+  return splice_buffers_ ? *splice_buffers_ : g_empty_splice_buffers.Get();
 }
 
 void StreamParserBuffer::SetPrerollBuffer(
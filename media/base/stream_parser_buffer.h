@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include <deque>
+#include <memory>
 
 #include "base/macros.h"
 #include "media/base/decoder_buffer.h"
@@ -160,7 +161,7 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
   // See the Audio Splice Frame Algorithm in the MSE specification for details.
   typedef StreamParser::BufferQueue BufferQueue;
   void ConvertToSpliceBuffer(const BufferQueue& pre_splice_buffers);
-  const BufferQueue& splice_buffers() const { return splice_buffers_; }
+  const BufferQueue& splice_buffers() const;
 
   // Specifies a buffer which must be decoded prior to this one to ensure this
   // buffer can be accurately decoded.  The given buffer must be of the same
@@ -199,7 +200,10 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
   int config_id_;
   Type type_;
   TrackId track_id_;
-  BufferQueue splice_buffers_;
+  // Only allocated for splice buffers: an empty std::deque still costs a few
+  // hundred bytes of heap, and there may be hundreds of thousands of buffers
+  // held in a SourceBufferStream.
+  std::unique_ptr<BufferQueue> splice_buffers_;
   scoped_refptr<StreamParserBuffer> preroll_buffer_;
   bool is_duration_estimated_;
 
@@ -23,6 +23,7 @@ namespace {
 // Options for PaceSender.
 const char kOptionPacerMaxBurstSize[] = "pacer_max_burst_size";
 const char kOptionPacerTargetBurstSize[] = "pacer_target_burst_size";
+const char kOptionPacerMicroburstSize[] = "pacer_microburst_size";
 
 // Wifi options.
 const char kOptionWifiDisableScan[] = "disable_wifi_scan";
@@ -429,6 +430,9 @@ void CastTransportImpl::SetOptions(const base::DictionaryValue& options) {
                                        media::cast::kMaxBurstSize);
   if (burst_size != media::cast::kMaxBurstSize)
     pacer_.SetMaxBurstSize(burst_size);
+  burst_size = LookupOptionWithDefault(options, kOptionPacerMicroburstSize, 0);
+  if (burst_size > 0)
+    pacer_.SetMicroburstSize(burst_size);
 
   // Set Wifi options.
   int wifi_options = 0;
@@ -87,6 +87,9 @@ class CastTransportImpl final : public CastTransport {
   //        - Specifies how many packets to send per 10 ms ideally.
   //   "pacer_max_burst_size": int
   //        - Specifies how many pakcets to send per 10 ms, maximum.
+  //   "pacer_microburst_size": int
+  //        - Specifies how many packets to send back-to-back, maximum. Larger
+  //          bursts are spread out over the 10 ms.
   //   "send_buffer_min_size": int
   //        - Specifies the minimum socket send buffer size.
   //   "disable_wifi_scan" (value ignored)
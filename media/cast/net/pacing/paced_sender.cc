@@ -68,6 +68,8 @@ PacedSender::PacedSender(
       next_max_burst_size_(target_burst_size_),
       next_next_max_burst_size_(target_burst_size_),
       current_burst_size_(0),
+      microburst_size_(0),
+      current_microburst_size_(0),
       state_(State_Unblocked),
       has_reached_upper_bound_once_(false),
       weak_factory_(this) {}
@@ -301,12 +303,22 @@ size_t PacedSender::size() const {
   return packet_list_.size() + priority_packet_list_.size();
 }
 
+base::TimeDelta PacedSender::GetMicroburstDuration() const {
+  DCHECK_GT(microburst_size_, 0u);
+  const size_t microbursts_per_burst = std::max<size_t>(
+      1, (current_max_burst_size_ + microburst_size_ - 1) / microburst_size_);
+  return base::TimeDelta::FromMilliseconds(kPacingIntervalMs) /
+         static_cast<int64_t>(microbursts_per_burst);
+}
+
 // This function can be called from three places:
 // 1. User called one of the Send* functions and we were in an unblocked state.
 // 2. state_ == State_TransportBlocked and the transport is calling us to
 //    let us know that it's ok to send again.
 // 3. state_ == State_BurstFull and there are still packets to send. In this
 //    case we called PostDelayedTask on this function to start a new burst.
+//    The same goes for State_MicroburstFull, except that the current burst
+//    continues with a new microburst.
 void PacedSender::SendStoredPackets() {
   State previous_state = state_;
   state_ = State_Unblocked;
@@ -348,6 +360,15 @@ void PacedSender::SendStoredPackets() {
     current_max_burst_size_ = std::max(next_max_burst_size_, max_burst_size);
     next_max_burst_size_ = std::max(next_next_max_burst_size_, max_burst_size);
     next_next_max_burst_size_ = max_burst_size;
+    current_microburst_size_ = 0;
+    if (microburst_size_ > 0)
+      microburst_end_ = now + GetMicroburstDuration();
+  } else if (microburst_size_ > 0 &&
+             (now >= microburst_end_ ||
+              previous_state == State_MicroburstFull)) {
+    // Start a new microburst within the current burst.
+    current_microburst_size_ = 0;
+    microburst_end_ = std::min(burst_end_, now + GetMicroburstDuration());
   }
 
   base::Closure cb = base::Bind(&PacedSender::SendStoredPackets,
@@ -360,6 +381,14 @@ void PacedSender::SendStoredPackets() {
       state_ = State_BurstFull;
       return;
     }
+    if (microburst_size_ > 0 &&
+        current_microburst_size_ >= microburst_size_) {
+      transport_task_runner_->PostDelayedTask(FROM_HERE,
+                                              cb,
+                                              microburst_end_ - now);
+      state_ = State_MicroburstFull;
+      return;
+    }
     PacketType packet_type;
     PacketKey packet_key;
     PacketRef packet = PopNextPacket(&packet_type, &packet_key);
@@ -398,6 +427,7 @@ void PacedSender::SendStoredPackets() {
       return;
     }
     current_burst_size_++;
+    current_microburst_size_++;
   }
 
   // Keep ~0.5 seconds of data (1000 packets).
@@ -147,6 +147,14 @@ class PacedSender : public PacedPacketSender,
 
   void SetMaxBurstSize(int burst_size) { max_burst_size_ = burst_size; }
 
+  // Limits how many packets are written back-to-back within a burst. Each
+  // burst is split into microbursts of at most |microburst_size| packets,
+  // spread evenly over the pacing interval, so that a large burst does not
+  // overrun shallow router and receiver buffers. 0 disables the limit.
+  void SetMicroburstSize(int microburst_size) {
+    microburst_size_ = microburst_size;
+  }
+
  private:
   // Actually sends the packets to the transport.
   void SendStoredPackets();
@@ -181,12 +189,18 @@ class PacedSender : public PacedPacketSender,
     // Once we've written enough packets for a time slice, we go into this
     // state and PostDelayTask a call to ourselves to wake up when we can
     // send more data.
-    State_BurstFull
+    State_BurstFull,
+    // Like State_BurstFull, but only the current microburst is full. When we
+    // wake up we continue the current burst with a new microburst.
+    State_MicroburstFull
   };
 
   bool empty() const;
   size_t size() const;
 
+  // Returns how long each microburst of the current burst lasts.
+  base::TimeDelta GetMicroburstDuration() const;
+
   // Returns the next packet to send. RTCP packets have highest priority, then
   // high-priority RTP packets, then normal-priority RTP packets.  Packets
   // within a frame are selected based on fairness to ensure all have an equal
@@ -242,6 +256,13 @@ class PacedSender : public PacedPacketSender,
   // This is when the current burst ends.
   base::TimeTicks burst_end_;
 
+  // Maximum number of packets per microburst, or 0 if bursts are not split.
+  size_t microburst_size_;
+  // Number of packets already sent in the current microburst.
+  size_t current_microburst_size_;
+  // This is when the current microburst ends.
+  base::TimeTicks microburst_end_;
+
   State state_;
 
   bool has_reached_upper_bound_once_;
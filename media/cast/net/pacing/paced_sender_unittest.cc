@@ -236,6 +236,39 @@ TEST_F(PacedSenderTest, BasicPace) {
   }
 }
 
+TEST_F(PacedSenderTest, PaceWithMicrobursts) {
+  paced_sender_->SetMicroburstSize(4);
+  SendPacketVector packets = CreateSendPacketVector(kSize1, 14, false);
+
+  // A burst of 10 packets is split into three microbursts, spaced 10 / 3 ms
+  // apart.
+  mock_transport_.AddExpectedSizesAndPacketIds(kSize1, UINT16_C(0), 4);
+  EXPECT_TRUE(paced_sender_->SendPackets(packets));
+
+  // Nothing is sent before the microburst ends.
+  testing_clock_.Advance(base::TimeDelta::FromMilliseconds(2));
+  task_runner_->RunTasks();
+
+  mock_transport_.AddExpectedSizesAndPacketIds(kSize1, UINT16_C(4), 4);
+  testing_clock_.Advance(base::TimeDelta::FromMilliseconds(2));
+  task_runner_->RunTasks();
+
+  // The last microburst is cut short by the end of the burst.
+  mock_transport_.AddExpectedSizesAndPacketIds(kSize1, UINT16_C(8), 2);
+  testing_clock_.Advance(base::TimeDelta::FromMilliseconds(4));
+  task_runner_->RunTasks();
+  testing_clock_.Advance(base::TimeDelta::FromMilliseconds(1));
+  task_runner_->RunTasks();
+
+  // The next burst starts with a fresh microburst.
+  mock_transport_.AddExpectedSizesAndPacketIds(kSize1, UINT16_C(10), 4);
+  testing_clock_.Advance(base::TimeDelta::FromMilliseconds(1));
+  task_runner_->RunTasks();
+
+  EXPECT_TRUE(RunUntilEmpty(3));
+  EXPECT_EQ(14u, packet_events_.size());
+}
+
 TEST_F(PacedSenderTest, PaceWithNack) {
   // Testing what happen when we get multiple NACK requests for a fully lost
   // frames just as we sent the first packets in a frame.
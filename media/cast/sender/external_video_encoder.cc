@@ -165,8 +165,19 @@ class ExternalVideoEncoder::VEAClientImpl
         video_frame, reference_time, frame_encoded_callback,
         requested_bit_rate_));
 
+    // Frames laid out the way the encoder asked for, such as captured shared
+    // memory or GpuMemoryBuffer frames, are passed through as-is. Others are
+    // copied into one of the encoder's input buffers first.
     scoped_refptr<media::VideoFrame> frame = video_frame;
-    if (video_frame->coded_size() != frame_coded_size_) {
+    if (video_frame->coded_size() != frame_coded_size_ ||
+        !video_frame->visible_rect().origin().IsOrigin()) {
+      if (!video_frame->IsMappable()) {
+        LOG(DFATAL) << "Error: ExternalVideoEncoder: cannot read frame with "
+                    << "storage type " << video_frame->storage_type();
+        ExitEncodingWithErrors();
+        return;
+      }
+
       DCHECK_GE(frame_coded_size_.width(), video_frame->visible_rect().width());
       DCHECK_GE(frame_coded_size_.height(),
                 video_frame->visible_rect().height());
@@ -16,6 +16,7 @@
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
@@ -40,20 +41,57 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetThreadCount(AVCodecID codec_id) {
-  // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
-  int decode_threads = kDecodeThreads;
+// Number of decoded frames over which decode throughput is measured.
+static const int kStatsWindowFrames = 120;
 
+// Returns true and sets |decode_threads| if the command line holds a valid
+// --video-threads flag.
+static bool GetThreadCountFromCommandLine(int* decode_threads) {
   const base::CommandLine* cmd_line = base::CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
-  if (threads.empty() || !base::StringToInt(threads, &decode_threads))
-    return decode_threads;
+  if (threads.empty() || !base::StringToInt(threads, decode_threads))
+    return false;
+
+  *decode_threads = std::max(*decode_threads, 0);
+  *decode_threads = std::min(*decode_threads, kMaxDecodeThreads);
+  return true;
+}
+
+// Returns the most threads worth decoding with on this machine.
+static int GetMaxThreadCount() {
+  const int processors = base::SysInfo::NumberOfProcessors();
+  return std::max(kDecodeThreads, std::min(kMaxDecodeThreads, processors));
+}
+
+// Returns the number of threads to start decoding |config| with.  Larger
+// frames and heavier profiles have more work to spread across threads.
+static int GetThreadCount(const VideoDecoderConfig& config) {
+  // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
+  int decode_threads = kDecodeThreads;
 
-  decode_threads = std::max(decode_threads, 0);
-  decode_threads = std::min(decode_threads, kMaxDecodeThreads);
-  return decode_threads;
+  const int area = config.coded_size().GetArea();
+  if (area >= 3840 * 2160)
+    decode_threads = 8;
+  else if (area >= 1920 * 1080)
+    decode_threads = 4;
+  else if (area >= 1280 * 720)
+    decode_threads = 3;
+
+  // High bit depth and non-4:2:0 profiles cost considerably more per pixel.
+  switch (config.profile()) {
+    case H264PROFILE_HIGH10PROFILE:
+    case H264PROFILE_HIGH422PROFILE:
+    case H264PROFILE_HIGH444PREDICTIVEPROFILE:
+    case VP9PROFILE_PROFILE1:
+    case VP9PROFILE_PROFILE2:
+    case VP9PROFILE_PROFILE3:
+      decode_threads *= 2;
+      break;
+    default:
+      break;
+  }
+
+  return std::min(decode_threads, GetMaxThreadCount());
 }
 
 static int GetVideoBufferImpl(struct AVCodecContext* s,
@@ -74,8 +112,17 @@ bool FFmpegVideoDecoder::IsCodecSupported(VideoCodec codec) {
   return avcodec_find_decoder(VideoCodecToCodecID(codec)) != nullptr;
 }
 
-FFmpegVideoDecoder::FFmpegVideoDecoder()
-    : state_(kUninitialized), decode_nalus_(false) {
+FFmpegVideoDecoder::FFmpegVideoDecoder(
+    const scoped_refptr<MediaLog>& media_log)
+    : state_(kUninitialized),
+      decode_nalus_(false),
+      media_log_(media_log),
+      low_delay_(false),
+      thread_count_(0),
+      pending_thread_count_(0),
+      max_thread_count_(0),
+      window_frames_(0),
+      window_bytes_(0) {
   thread_checker_.DetachFromThread();
 }
 
@@ -127,10 +174,18 @@ int FFmpegVideoDecoder::GetVideoBuffer(struct AVCodecContext* codec_context,
     return AVERROR(EINVAL);
   }
 
+  scoped_refptr<VideoFrame> video_frame;
+  if (!create_frame_cb_.is_null()) {
+    video_frame =
+        create_frame_cb_.Run(format, coded_size, gfx::Rect(size), natural_size);
+  }
+
   // FFmpeg expects the initialize allocation to be zero-initialized.  Failure
   // to do so can lead to unitialized value usage.  See http://crbug.com/390941
-  scoped_refptr<VideoFrame> video_frame = frame_pool_.CreateFrame(
-      format, coded_size, gfx::Rect(size), natural_size, kNoTimestamp());
+  if (!video_frame) {
+    video_frame = frame_pool_.CreateFrame(format, coded_size, gfx::Rect(size),
+                                          natural_size, kNoTimestamp());
+  }
 
   // Prefer the color space from the codec context. If it's not specified (or is
   // set to an unsupported value), fall back on the value from the config.
@@ -187,6 +242,19 @@ void FFmpegVideoDecoder::Initialize(const VideoDecoderConfig& config,
   FFmpegGlue::InitializeFFmpeg();
   config_ = config;
 
+  // Frame threading delays output by one frame per thread, so low delay
+  // decoding uses slice threading instead.
+  low_delay_ = low_delay;
+  if (GetThreadCountFromCommandLine(&thread_count_)) {
+    // Never override an explicitly requested thread count.
+    max_thread_count_ = thread_count_;
+  } else {
+    thread_count_ = GetThreadCount(config);
+    max_thread_count_ = GetMaxThreadCount();
+  }
+  pending_thread_count_ = thread_count_;
+  window_frames_ = 0;
+
   // TODO(xhwang): Only set |config_| after we successfully configure the
   // decoder.
   if (!ConfigureDecoder(low_delay)) {
@@ -243,6 +311,15 @@ void FFmpegVideoDecoder::Decode(const scoped_refptr<DecoderBuffer>& buffer,
   // (any state) -> kNormal:
   //     Any time Reset() is called.
 
+  // Changing the thread count reopens the decoder, which is only safe at a key
+  // frame since no earlier frame is referenced from there on.
+  if (pending_thread_count_ != thread_count_ && !buffer->end_of_stream() &&
+      buffer->is_key_frame() && !ReconfigureThreads()) {
+    state_ = kError;
+    decode_cb_bound.Run(DecodeStatus::DECODE_ERROR);
+    return;
+  }
+
   bool has_produced_frame;
   do {
     has_produced_frame = false;
@@ -267,6 +344,7 @@ void FFmpegVideoDecoder::Reset(const base::Closure& closure) {
 
   avcodec_flush_buffers(codec_context_.get());
   state_ = kNormal;
+  window_frames_ = 0;
   // PostTask() to avoid calling |closure| inmediately.
   base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE, closure);
 }
@@ -299,6 +377,7 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   }
 
   int frame_decoded = 0;
+  const base::TimeTicks decode_start = base::TimeTicks::Now();
   int result = avcodec_decode_video2(codec_context_.get(),
                                      av_frame_.get(),
                                      &frame_decoded,
@@ -309,6 +388,9 @@ bool FFmpegVideoDecoder::FFmpegDecode(
     return false;
   }
 
+  if (!buffer->end_of_stream())
+    UpdateDecodeStats(buffer, base::TimeTicks::Now() - decode_start);
+
   // FFmpeg says some codecs might have multiple frames per packet.  Previous
   // discussions with rbultje@ indicate this shouldn't be true for the codecs
   // we use.
@@ -344,6 +426,69 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   return true;
 }
 
+void FFmpegVideoDecoder::UpdateDecodeStats(
+    const scoped_refptr<DecoderBuffer>& buffer,
+    base::TimeDelta decode_time) {
+  if (buffer->timestamp() == kNoTimestamp())
+    return;
+
+  if (!window_frames_) {
+    window_bytes_ = 0;
+    window_decode_time_ = base::TimeDelta();
+    window_start_timestamp_ = buffer->timestamp();
+    window_end_timestamp_ = buffer->timestamp();
+  }
+  ++window_frames_;
+  window_bytes_ += buffer->data_size();
+  window_decode_time_ += decode_time;
+  window_start_timestamp_ =
+      std::min(window_start_timestamp_, buffer->timestamp());
+  window_end_timestamp_ = std::max(window_end_timestamp_, buffer->timestamp());
+  if (window_frames_ < kStatsWindowFrames)
+    return;
+
+  // The timestamps span one frame less than the window does.
+  const int frames = window_frames_;
+  window_frames_ = 0;
+  const base::TimeDelta media_duration =
+      (window_end_timestamp_ - window_start_timestamp_) * frames /
+      (frames - 1);
+  if (media_duration <= base::TimeDelta() ||
+      window_decode_time_ <= base::TimeDelta()) {
+    return;
+  }
+
+  MEDIA_LOG(DEBUG, media_log_)
+      << GetDisplayName() << ": decoded " << frames << " frames at "
+      << frames / window_decode_time_.InSecondsF() << " fps with "
+      << thread_count_ << " threads, "
+      << window_bytes_ * 8 / media_duration.InSecondsF() / 1000 << " kbps";
+
+  // With frame threading the time spent in avcodec_decode_video2() is the
+  // per-frame throughput cost rather than the full decode time of a frame.
+  // Ask for more threads once it exceeds three quarters of the playback time,
+  // as little headroom is left for harder scenes.
+  if (window_decode_time_ * 4 > media_duration * 3 &&
+      thread_count_ < max_thread_count_) {
+    pending_thread_count_ = std::min(thread_count_ * 2, max_thread_count_);
+  }
+}
+
+bool FFmpegVideoDecoder::ReconfigureThreads() {
+  // Reopening the decoder drops the frames its frame threads still hold, so
+  // output those first.
+  scoped_refptr<DecoderBuffer> eos_buffer = DecoderBuffer::CreateEOSBuffer();
+  bool has_produced_frame;
+  do {
+    has_produced_frame = false;
+    if (!FFmpegDecode(eos_buffer, &has_produced_frame))
+      return false;
+  } while (has_produced_frame);
+
+  thread_count_ = pending_thread_count_;
+  return ConfigureDecoder(low_delay_);
+}
+
 void FFmpegVideoDecoder::ReleaseFFmpegResources() {
   codec_context_.reset();
   av_frame_.reset();
@@ -360,7 +505,7 @@ bool FFmpegVideoDecoder::ConfigureDecoder(bool low_delay) {
   codec_context_.reset(avcodec_alloc_context3(NULL));
   VideoDecoderConfigToAVCodecContext(config_, codec_context_.get());
 
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_count = thread_count_;
   codec_context_->thread_type = low_delay ? FF_THREAD_SLICE : FF_THREAD_FRAME;
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
@@ -377,6 +522,9 @@ bool FFmpegVideoDecoder::ConfigureDecoder(bool low_delay) {
   }
 
   av_frame_.reset(av_frame_alloc());
+  MEDIA_LOG(DEBUG, media_log_)
+      << GetDisplayName() << ": decoding with " << thread_count_
+      << (low_delay ? " slice" : " frame") << " threads";
   return true;
 }
 
@@ -5,12 +5,16 @@
 #ifndef MEDIA_FILTERS_FFMPEG_VIDEO_DECODER_H_
 #define MEDIA_FILTERS_FFMPEG_VIDEO_DECODER_H_
 
+#include <stdint.h>
+
 #include <list>
 #include <memory>
 
 #include "base/callback.h"
 #include "base/macros.h"
 #include "base/threading/thread_checker.h"
+#include "base/time/time.h"
+#include "media/base/media_log.h"
 #include "media/base/video_decoder.h"
 #include "media/base/video_decoder_config.h"
 #include "media/base/video_frame_pool.h"
@@ -31,13 +35,28 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
  public:
   static bool IsCodecSupported(VideoCodec codec);
 
-  FFmpegVideoDecoder();
+  // Returns a frame to decode into, or null to use the internal frame pool.
+  typedef base::Callback<scoped_refptr<VideoFrame>(
+      VideoPixelFormat format,
+      const gfx::Size& coded_size,
+      const gfx::Rect& visible_rect,
+      const gfx::Size& natural_size)>
+      CreateFrameCB;
+
+  explicit FFmpegVideoDecoder(const scoped_refptr<MediaLog>& media_log);
   ~FFmpegVideoDecoder() override;
 
   // Allow decoding of individual NALU. Entire frames are required by default.
   // Disables low-latency mode. Must be called before Initialize().
   void set_decode_nalus(bool decode_nalus) { decode_nalus_ = decode_nalus; }
 
+  // Sets a source of frames to decode into, e.g. mapped GpuMemoryBuffers, so
+  // decoded frames need no further copy.  Frames are requested on the decoder
+  // thread.  Must be called before Initialize().
+  void set_create_frame_cb(const CreateFrameCB& create_frame_cb) {
+    create_frame_cb_ = create_frame_cb;
+  }
+
   // VideoDecoder implementation.
   std::string GetDisplayName() const override;
   void Initialize(const VideoDecoderConfig& config,
@@ -72,6 +91,16 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // Returns true if initialization was successful.
   bool ConfigureDecoder(bool low_delay);
 
+  // Accounts |buffer| and the time spent decoding it to the current
+  // measurement window.  At the end of a window, logs the decode throughput
+  // and asks for more threads if decoding is falling behind playback.
+  void UpdateDecodeStats(const scoped_refptr<DecoderBuffer>& buffer,
+                         base::TimeDelta decode_time);
+
+  // Outputs the frames still held by FFmpeg's frame threads, then reopens the
+  // decoder with |pending_thread_count_| threads.
+  bool ReconfigureThreads();
+
   // Releases resources associated with |codec_context_| and |av_frame_|
   // and resets them to NULL.
   void ReleaseFFmpegResources();
@@ -90,8 +119,31 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
 
   VideoFramePool frame_pool_;
 
+  // Tried before |frame_pool_| when allocating frames, if set.
+  CreateFrameCB create_frame_cb_;
+
   bool decode_nalus_;
 
+  scoped_refptr<MediaLog> media_log_;
+
+  // Whether the decoder was initialized for low delay, which rules out frame
+  // threading.
+  bool low_delay_;
+
+  // Number of threads |codec_context_| decodes with, and the number it will be
+  // reopened with at the next key frame.  Adaptation stops once
+  // |max_thread_count_| is reached.
+  int thread_count_;
+  int pending_thread_count_;
+  int max_thread_count_;
+
+  // Statistics of the current measurement window.
+  int window_frames_;
+  int64_t window_bytes_;
+  base::TimeDelta window_decode_time_;
+  base::TimeDelta window_start_timestamp_;
+  base::TimeDelta window_end_timestamp_;
+
   DISALLOW_COPY_AND_ASSIGN(FFmpegVideoDecoder);
 };
 
@@ -18,6 +18,12 @@ namespace media {
 const int kMaxDroppedPrerollWarnings = 10;
 const int kMaxDtsBeyondPtsWarnings = 10;
 
+// Processed frames are appended to a track's stream at least this often.
+// Appending holds the stream's lock, which the media thread needs to read, so
+// a large media segment is appended in pieces rather than all at once. This
+// also lets a pending read complete as soon as the first piece is buffered.
+const size_t kMaxProcessedFramesPerAppend = 64;
+
 // Helper class to capture per-track details needed by a frame processor. Some
 // of this information may be duplicated in the short-term in the associated
 // ChunkDemuxerStream and SourceBufferStream for a track.
@@ -73,8 +79,10 @@ class MseTrackBuffer {
   // monotonically increasing.
   void SetHighestPresentationTimestampIfIncreased(base::TimeDelta timestamp);
 
-  // Adds |frame| to the end of |processed_frames_|.
-  void EnqueueProcessedFrame(const scoped_refptr<StreamParserBuffer>& frame);
+  // Adds |frame| to the end of |processed_frames_|, then flushes them if
+  // there are kMaxProcessedFramesPerAppend of them. Returns false if that
+  // flush failed, true otherwise.
+  bool EnqueueProcessedFrame(const scoped_refptr<StreamParserBuffer>& frame);
 
   // Appends |processed_frames_|, if not empty, to |stream_| and clears
   // |processed_frames_|. Returns false if append failed, true otherwise.
@@ -143,9 +151,12 @@ void MseTrackBuffer::SetHighestPresentationTimestampIfIncreased(
   }
 }
 
-void MseTrackBuffer::EnqueueProcessedFrame(
+bool MseTrackBuffer::EnqueueProcessedFrame(
     const scoped_refptr<StreamParserBuffer>& frame) {
   processed_frames_.push_back(frame);
+  if (processed_frames_.size() < kMaxProcessedFramesPerAppend)
+    return true;
+  return FlushProcessedFrames();
 }
 
 bool MseTrackBuffer::FlushProcessedFrames() {
@@ -734,9 +745,10 @@ bool FrameProcessor::ProcessFrame(
              << ", DTS=" << decode_timestamp.InSecondsF();
 
     // Steps 11-16: Note, we optimize by appending groups of contiguous
-    // processed frames for each track buffer at end of ProcessFrames() or prior
-    // to NotifyStartOfCodedFrameGroup().
-    track_buffer->EnqueueProcessedFrame(frame);
+    // processed frames for each track buffer at end of ProcessFrames(), prior
+    // to NotifyStartOfCodedFrameGroup(), or once a group grows large.
+    if (!track_buffer->EnqueueProcessedFrame(frame))
+      return false;
 
     // 17. Set last decode timestamp for track buffer to decode timestamp.
     track_buffer->set_last_decode_timestamp(decode_timestamp);
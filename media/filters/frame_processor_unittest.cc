@@ -903,6 +903,39 @@ TEST_P(FrameProcessorTest, PartialAppendWindowZeroDurationPreroll) {
             last_read_parser_buffer->preroll_buffer()->duration());
 }
 
+TEST_P(FrameProcessorTest, LargeMediaSegment) {
+  // Enough frames that they are appended to each stream in several pieces.
+  const int kFrameCount = 200;
+  InSequence s;
+  AddTestTracks(HAS_AUDIO | HAS_VIDEO);
+  frame_processor_->SetSequenceMode(GetParam());
+
+  std::string audio_timestamps;
+  std::string video_timestamps;
+  std::string expected_reads;
+  for (int i = 0; i < kFrameCount; ++i) {
+    const std::string timestamp = base::IntToString(i * 10);
+    if (i > 0) {
+      audio_timestamps += " ";
+      video_timestamps += " ";
+      expected_reads += " ";
+    }
+    audio_timestamps += timestamp + "K";
+    video_timestamps += timestamp + (i % 30 == 0 ? "K" : "");
+    expected_reads += timestamp;
+  }
+
+  EXPECT_CALL(callbacks_,
+              PossibleDurationIncrease(frame_duration_ * kFrameCount));
+  ProcessFrames(audio_timestamps, video_timestamps);
+  EXPECT_TRUE(in_coded_frame_group());
+
+  CheckExpectedRangesByTimestamp(audio_.get(), "{ [0,2000) }");
+  CheckExpectedRangesByTimestamp(video_.get(), "{ [0,2000) }");
+  CheckReadsThenReadStalls(audio_.get(), expected_reads);
+  CheckReadsThenReadStalls(video_.get(), expected_reads);
+}
+
 INSTANTIATE_TEST_CASE_P(SequenceMode, FrameProcessorTest, Values(true));
 INSTANTIATE_TEST_CASE_P(SegmentsMode, FrameProcessorTest, Values(false));
 
@@ -880,9 +880,11 @@ size_t SourceBufferStream::FreeBuffers(size_t total_bytes_to_free,
   // if the buffers surrounding it get deleted during garbage collection.
   SourceBufferRange* new_range_for_append = NULL;
 
+  // Reused for every GOP, rather than allocating a new queue for each.
+  BufferQueue buffers;
   while (!ranges_.empty() && bytes_freed < total_bytes_to_free) {
     SourceBufferRange* current_range = NULL;
-    BufferQueue buffers;
+    buffers.clear();
     size_t bytes_deleted = 0;
 
     if (reverse_direction) {
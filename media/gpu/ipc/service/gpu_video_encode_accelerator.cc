@@ -5,6 +5,8 @@
 #include "media/gpu/ipc/service/gpu_video_encode_accelerator.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/command_line.h"
@@ -54,6 +56,15 @@ static bool MakeDecoderContextCurrent(
   return true;
 }
 
+static void DestroyGpuMemoryBuffer(const gpu::SyncToken& sync_token) {}
+
+// Unmaps the planes of a frame from OnEncode2() once the encoder is done.
+static void UnmapGpuMemoryBuffers(
+    std::vector<std::unique_ptr<gpu::GpuMemoryBufferImpl>> buffers) {
+  for (const auto& buffer : buffers)
+    buffer->Unmap();
+}
+
 GpuVideoEncodeAccelerator::GpuVideoEncodeAccelerator(
     int32_t host_route_id,
     gpu::GpuCommandBufferStub* stub)
@@ -318,8 +329,77 @@ void GpuVideoEncodeAccelerator::OnEncode2(
            << ", size=" << params.size.ToString()
            << ", force_keyframe=" << params.force_keyframe
            << ", handle type=" << params.gpu_memory_buffer_handles[0].type;
-  // Encoding GpuMemoryBuffer backed frames is not supported.
-  NOTREACHED();
+  DCHECK_EQ(PIXEL_FORMAT_I420, input_format_);
+
+  if (!encoder_)
+    return;
+
+  if (params.frame_id < 0) {
+    DLOG(ERROR) << "GpuVideoEncodeAccelerator::OnEncode2(): invalid "
+                << "frame_id=" << params.frame_id;
+    NotifyError(VideoEncodeAccelerator::kPlatformFailureError);
+    return;
+  }
+
+  const size_t num_planes = VideoFrame::NumPlanes(input_format_);
+  if (params.size != input_coded_size_ ||
+      params.gpu_memory_buffer_handles.size() != num_planes) {
+    DLOG(ERROR) << "GpuVideoEncodeAccelerator::OnEncode2(): "
+                << "invalid size or number of planes for frame_id="
+                << params.frame_id;
+    NotifyError(VideoEncodeAccelerator::kPlatformFailureError);
+    return;
+  }
+
+  // Map the planes so the encoder reads them in place. As in
+  // VideoCaptureImpl, each plane is a separate R_8 buffer.
+  std::vector<std::unique_ptr<gpu::GpuMemoryBufferImpl>> buffers;
+  uint8_t* data[VideoFrame::kMaxPlanes] = {};
+  int32_t strides[VideoFrame::kMaxPlanes] = {};
+  for (size_t i = 0; i < num_planes; ++i) {
+    const gfx::Size plane_size(
+        VideoFrame::Columns(i, input_format_, input_coded_size_.width()),
+        VideoFrame::Rows(i, input_format_, input_coded_size_.height()));
+    std::unique_ptr<gpu::GpuMemoryBufferImpl> buffer =
+        gpu::GpuMemoryBufferImpl::CreateFromHandle(
+            params.gpu_memory_buffer_handles[i], plane_size,
+            gfx::BufferFormat::R_8, gfx::BufferUsage::GPU_READ_CPU_READ_WRITE,
+            base::Bind(&DestroyGpuMemoryBuffer));
+    if (!buffer || !buffer->Map()) {
+      DLOG(ERROR) << "GpuVideoEncodeAccelerator::OnEncode2(): "
+                  << "could not map frame_id=" << params.frame_id;
+      UnmapGpuMemoryBuffers(std::move(buffers));
+      NotifyError(VideoEncodeAccelerator::kPlatformFailureError);
+      return;
+    }
+    data[i] = static_cast<uint8_t*>(buffer->memory(0));
+    strides[i] = buffer->stride(0);
+    buffers.push_back(std::move(buffer));
+  }
+
+  scoped_refptr<VideoFrame> frame = VideoFrame::WrapExternalYuvGpuMemoryBuffers(
+      input_format_, input_coded_size_, gfx::Rect(input_visible_size_),
+      input_visible_size_, strides[VideoFrame::kYPlane],
+      strides[VideoFrame::kUPlane], strides[VideoFrame::kVPlane],
+      data[VideoFrame::kYPlane], data[VideoFrame::kUPlane],
+      data[VideoFrame::kVPlane],
+      params.gpu_memory_buffer_handles[VideoFrame::kYPlane],
+      params.gpu_memory_buffer_handles[VideoFrame::kUPlane],
+      params.gpu_memory_buffer_handles[VideoFrame::kVPlane], params.timestamp);
+  if (!frame) {
+    DLOG(ERROR) << "GpuVideoEncodeAccelerator::OnEncode2(): "
+                << "could not create a frame";
+    UnmapGpuMemoryBuffers(std::move(buffers));
+    NotifyError(VideoEncodeAccelerator::kPlatformFailureError);
+    return;
+  }
+  frame->AddDestructionObserver(
+      base::Bind(&UnmapGpuMemoryBuffers, base::Passed(&buffers)));
+  frame->AddDestructionObserver(BindToCurrentLoop(base::Bind(
+      &GpuVideoEncodeAccelerator::EncodeFrameFinished,
+      weak_this_factory_.GetWeakPtr(), params.frame_id,
+      base::Passed(std::unique_ptr<base::SharedMemory>()))));
+  encoder_->Encode(frame, params.force_keyframe);
 }
 
 void GpuVideoEncodeAccelerator::OnUseOutputBitstreamBuffer(
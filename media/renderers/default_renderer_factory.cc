@@ -18,6 +18,7 @@
 #include "media/renderers/gpu_video_accelerator_factories.h"
 #include "media/renderers/renderer_impl.h"
 #include "media/renderers/video_renderer_impl.h"
+#include "media/video/gpu_memory_buffer_video_frame_pool.h"
 
 #if !defined(MEDIA_DISABLE_FFMPEG)
 #include "media/filters/ffmpeg_audio_decoder.h"
@@ -66,7 +67,8 @@ ScopedVector<AudioDecoder> DefaultRendererFactory::CreateAudioDecoders(
 ScopedVector<VideoDecoder> DefaultRendererFactory::CreateVideoDecoders(
     const scoped_refptr<base::SingleThreadTaskRunner>& media_task_runner,
     const RequestSurfaceCB& request_surface_cb,
-    GpuVideoAcceleratorFactories* gpu_factories) {
+    GpuVideoAcceleratorFactories* gpu_factories,
+    GpuMemoryBufferVideoFramePool* gpu_memory_buffer_pool) {
   // Create our video decoders and renderer.
   ScopedVector<VideoDecoder> video_decoders;
 
@@ -91,7 +93,14 @@ ScopedVector<VideoDecoder> DefaultRendererFactory::CreateVideoDecoders(
 #endif
 
 #if !defined(MEDIA_DISABLE_FFMPEG) && !defined(DISABLE_FFMPEG_VIDEO_DECODERS)
-  video_decoders.push_back(new FFmpegVideoDecoder());
+  FFmpegVideoDecoder* ffmpeg_video_decoder = new FFmpegVideoDecoder(media_log_);
+  // Decode straight into the buffers the frames will be uploaded from.
+  if (gpu_memory_buffer_pool) {
+    ffmpeg_video_decoder->set_create_frame_cb(
+        base::Bind(&GpuMemoryBufferVideoFramePool::MaybeCreateMappedFrame,
+                   base::Unretained(gpu_memory_buffer_pool)));
+  }
+  video_decoders.push_back(ffmpeg_video_decoder);
 #endif
 
   return video_decoders;
@@ -113,10 +122,19 @@ std::unique_ptr<Renderer> DefaultRendererFactory::CreateRenderer(
   if (!get_gpu_factories_cb_.is_null())
     gpu_factories = get_gpu_factories_cb_.Run();
 
+  std::unique_ptr<GpuMemoryBufferVideoFramePool> gpu_memory_buffer_pool;
+  if (gpu_factories &&
+      gpu_factories->ShouldUseGpuMemoryBuffersForVideoFrames()) {
+    gpu_memory_buffer_pool.reset(new GpuMemoryBufferVideoFramePool(
+        media_task_runner, worker_task_runner, gpu_factories));
+  }
+
+  ScopedVector<VideoDecoder> video_decoders =
+      CreateVideoDecoders(media_task_runner, request_surface_cb, gpu_factories,
+                          gpu_memory_buffer_pool.get());
   std::unique_ptr<VideoRenderer> video_renderer(new VideoRendererImpl(
-      media_task_runner, worker_task_runner, video_renderer_sink,
-      CreateVideoDecoders(media_task_runner, request_surface_cb, gpu_factories),
-      true, gpu_factories, media_log_));
+      media_task_runner, video_renderer_sink, std::move(video_decoders), true,
+      std::move(gpu_memory_buffer_pool), media_log_));
 
   return base::WrapUnique(new RendererImpl(
       media_task_runner, std::move(audio_renderer), std::move(video_renderer)));
@@ -19,6 +19,7 @@ class AudioDecoder;
 class AudioHardwareConfig;
 class AudioRendererSink;
 class DecoderFactory;
+class GpuMemoryBufferVideoFramePool;
 class GpuVideoAcceleratorFactories;
 class MediaLog;
 class VideoDecoder;
@@ -47,7 +48,8 @@ class MEDIA_EXPORT DefaultRendererFactory : public RendererFactory {
   ScopedVector<VideoDecoder> CreateVideoDecoders(
       const scoped_refptr<base::SingleThreadTaskRunner>& media_task_runner,
       const RequestSurfaceCB& request_surface_cb,
-      GpuVideoAcceleratorFactories* gpu_factories);
+      GpuVideoAcceleratorFactories* gpu_factories,
+      GpuMemoryBufferVideoFramePool* gpu_memory_buffer_pool);
 
   scoped_refptr<MediaLog> media_log_;
 
@@ -28,7 +28,6 @@
 #include "media/base/video_renderer_sink.h"
 #include "media/filters/decoder_stream.h"
 #include "media/filters/video_renderer_algorithm.h"
-#include "media/renderers/gpu_video_accelerator_factories.h"
 #include "media/video/gpu_memory_buffer_video_frame_pool.h"
 
 namespace base {
@@ -52,13 +51,16 @@ class MEDIA_EXPORT VideoRendererImpl
   // down the video thread may result in losing synchronization with audio.
   //
   // Setting |drop_frames_| to true causes the renderer to drop expired frames.
+  //
+  // |gpu_memory_buffer_pool|, if not null, is used to create hardware frames
+  // from decoded software frames.  Since |decoders| may decode straight into
+  // its buffers, it is kept alive until the decoders are gone.
   VideoRendererImpl(
       const scoped_refptr<base::SingleThreadTaskRunner>& media_task_runner,
-      const scoped_refptr<base::TaskRunner>& worker_task_runner,
       VideoRendererSink* sink,
       ScopedVector<VideoDecoder> decoders,
       bool drop_frames,
-      GpuVideoAcceleratorFactories* gpu_factories,
+      std::unique_ptr<GpuMemoryBufferVideoFramePool> gpu_memory_buffer_pool,
       const scoped_refptr<MediaLog>& media_log);
   ~VideoRendererImpl() override;
 
@@ -196,12 +198,13 @@ class MEDIA_EXPORT VideoRendererImpl
 
   RendererClient* client_;
 
-  // Provides video frames to VideoRendererImpl.
-  std::unique_ptr<VideoFrameStream> video_frame_stream_;
-
   // Pool of GpuMemoryBuffers and resources used to create hardware frames.
+  // Declared before |video_frame_stream_| so it outlives the decoders.
   std::unique_ptr<GpuMemoryBufferVideoFramePool> gpu_memory_buffer_pool_;
 
+  // Provides video frames to VideoRendererImpl.
+  std::unique_ptr<VideoFrameStream> video_frame_stream_;
+
   scoped_refptr<MediaLog> media_log_;
 
   // Flag indicating low-delay mode.
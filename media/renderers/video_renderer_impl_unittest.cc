@@ -66,9 +66,9 @@ class VideoRendererImplTest : public testing::Test {
         message_loop_.task_runner()));
 
     renderer_.reset(new VideoRendererImpl(
-        message_loop_.task_runner(), message_loop_.task_runner().get(),
-        null_video_sink_.get(), std::move(decoders), true,
-        nullptr,  // gpu_factories
+        message_loop_.task_runner(), null_video_sink_.get(),
+        std::move(decoders), true,
+        nullptr,  // gpu_memory_buffer_pool
         new MediaLog()));
     renderer_->SetTickClockForTesting(
         std::unique_ptr<base::TickClock>(tick_clock_));
@@ -293,7 +293,7 @@ std::unique_ptr<Renderer> PipelineIntegrationTestBase::CreateRenderer() {
 
 // Android does not have an ffmpeg video decoder.
 #if !defined(MEDIA_DISABLE_FFMPEG) && !defined(OS_ANDROID)
-  video_decoders.push_back(new FFmpegVideoDecoder());
+  video_decoders.push_back(new FFmpegVideoDecoder(new MediaLog()));
 #endif
 
   // Simulate a 60Hz rendering sink.
@@ -305,9 +305,8 @@ std::unique_ptr<Renderer> PipelineIntegrationTestBase::CreateRenderer() {
 
   // Disable frame dropping if hashing is enabled.
   std::unique_ptr<VideoRenderer> video_renderer(new VideoRendererImpl(
-      message_loop_.task_runner(), message_loop_.task_runner().get(),
-      video_sink_.get(), std::move(video_decoders), false, nullptr,
-      new MediaLog()));
+      message_loop_.task_runner(), video_sink_.get(),
+      std::move(video_decoders), false, nullptr, new MediaLog()));
 
   ScopedVector<AudioDecoder> audio_decoders;
 
@@ -26,6 +26,7 @@
 #include "gpu/GLES2/gl2extchromium.h"
 #include "gpu/command_buffer/client/gles2_interface.h"
 #include "media/base/bind_to_current_loop.h"
+#include "media/base/timestamp_constants.h"
 #include "media/renderers/gpu_video_accelerator_factories.h"
 #include "third_party/libyuv/include/libyuv.h"
 #include "ui/gfx/buffer_format_util.h"
@@ -51,7 +52,8 @@ class GpuMemoryBufferVideoFramePool::PoolImpl
       : media_task_runner_(media_task_runner),
         worker_task_runner_(worker_task_runner),
         gpu_factories_(gpu_factories),
-        output_format_(PIXEL_FORMAT_UNKNOWN) {
+        output_format_(PIXEL_FORMAT_UNKNOWN),
+        mapped_frames_unsupported_(false) {
     DCHECK(media_task_runner_);
     DCHECK(worker_task_runner_);
   }
@@ -65,6 +67,13 @@ class GpuMemoryBufferVideoFramePool::PoolImpl
   void CreateHardwareFrame(const scoped_refptr<VideoFrame>& video_frame,
                            const FrameReadyCB& cb);
 
+  // Returns a software VideoFrame backed by mapped GpuMemoryBuffers from the
+  // pool, or null if the output format doesn't match |format|'s layout.
+  scoped_refptr<VideoFrame> CreateMappedFrame(VideoPixelFormat format,
+                                              const gfx::Size& coded_size,
+                                              const gfx::Rect& visible_rect,
+                                              const gfx::Size& natural_size);
+
   bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
                     base::trace_event::ProcessMemoryDump* pmd) override;
 
@@ -91,6 +100,9 @@ class GpuMemoryBufferVideoFramePool::PoolImpl
     const gfx::Size size;
     PlaneResource plane_resources[VideoFrame::kMaxPlanes];
 
+    // Whether the buffers are mapped into a frame from CreateMappedFrame().
+    bool mapped = false;
+
    private:
     bool in_use_ = true;
   };
@@ -135,6 +147,16 @@ class GpuMemoryBufferVideoFramePool::PoolImpl
   void MailboxHoldersReleased(FrameResources* frame_resources,
                               const gpu::SyncToken& sync_token);
 
+  // Returns the resources mapped into the frame whose Y plane is at |y_data|,
+  // or null if there are none.
+  FrameResources* FindMappedFrameResources(const uint8_t* y_data);
+
+  // Called when a frame from CreateMappedFrame(), and so any hardware frame
+  // wrapping it, is no longer referenced.  Unmaps the buffers and puts the
+  // resources back in the pool.
+  // This must be called on the thread where |media_task_runner_| is current.
+  void MappedFrameReleased(FrameResources* frame_resources);
+
   // Delete resources. This has to be called on the thread where |task_runner|
   // is current.
   static void DeleteFrameResources(GpuVideoAcceleratorFactories* gpu_factories,
@@ -155,6 +177,9 @@ class GpuMemoryBufferVideoFramePool::PoolImpl
   // BufferFormat.
   VideoPixelFormat output_format_;
 
+  // Set once mapped buffers turned out unsuitable for decoding into.
+  bool mapped_frames_unsupported_;
+
   DISALLOW_COPY_AND_ASSIGN(PoolImpl);
 };
 
@@ -333,6 +358,15 @@ gfx::Size CodedSize(const scoped_refptr<VideoFrame>& video_frame,
   DCHECK(gfx::Rect(video_frame->coded_size()).Contains(gfx::Rect(output)));
   return output;
 }
+
+size_t RoundUp(size_t value, size_t alignment) {
+  return ((value + (alignment - 1)) & ~(alignment - 1));
+}
+
+// Keeps the software frame wrapped by a hardware frame alive until the
+// hardware frame's mailboxes are released.
+void ReleaseWrappedFrame(const scoped_refptr<VideoFrame>& video_frame,
+                         const gpu::SyncToken& sync_token) {}
 }  // unnamed namespace
 
 // Creates a VideoFrame backed by native textures starting from a software
@@ -353,6 +387,18 @@ void GpuMemoryBufferVideoFramePool::PoolImpl::CreateHardwareFrame(
     frame_ready_cb.Run(video_frame);
     return;
   }
+
+  // A frame decoded straight into the pool's buffers only needs wrapping.
+  if (video_frame->storage_type() == VideoFrame::STORAGE_UNOWNED_MEMORY) {
+    FrameResources* frame_resources =
+        FindMappedFrameResources(video_frame->data(VideoFrame::kYPlane));
+    if (frame_resources) {
+      BindAndCreateMailboxesHardwareFrameResources(video_frame, frame_resources,
+                                                   frame_ready_cb);
+      return;
+    }
+  }
+
   switch (video_frame->format()) {
     // Supported cases.
     case PIXEL_FORMAT_YV12:
@@ -397,6 +443,76 @@ void GpuMemoryBufferVideoFramePool::PoolImpl::CreateHardwareFrame(
                             video_frame, frame_resources, frame_ready_cb));
 }
 
+// Creates a software VideoFrame whose planes are mapped GpuMemoryBuffers.
+// This has to be called on the thread where |media_task_runner_| is current.
+scoped_refptr<VideoFrame>
+GpuMemoryBufferVideoFramePool::PoolImpl::CreateMappedFrame(
+    VideoPixelFormat format,
+    const gfx::Size& coded_size,
+    const gfx::Rect& visible_rect,
+    const gfx::Size& natural_size) {
+  DCHECK(media_task_runner_->BelongsToCurrentThread());
+  if (output_format_ == PIXEL_FORMAT_UNKNOWN)
+    output_format_ = gpu_factories_->VideoFrameOutputFormat();
+
+  // Only I420 output keeps the planar layout software decoders write.
+  if (mapped_frames_unsupported_ || output_format_ != PIXEL_FORMAT_I420 ||
+      (format != PIXEL_FORMAT_YV12 && format != PIXEL_FORMAT_I420)) {
+    return nullptr;
+  }
+
+  // Software decoders read and write past the coded size; leave at least the
+  // room VideoFrame::AllocateYUV() does, including an extra chroma row.
+  const gfx::Size size(
+      RoundUp(coded_size.width(), 2 * VideoFrame::kFrameSizeAlignment),
+      RoundUp(coded_size.height(), 4 * VideoFrame::kFrameSizeAlignment) + 2);
+  FrameResources* frame_resources =
+      GetOrCreateFrameResources(size, output_format_);
+  if (!frame_resources)
+    return nullptr;
+
+  uint8_t* data[VideoFrame::kMaxPlanes] = {};
+  int32_t strides[VideoFrame::kMaxPlanes] = {};
+  size_t mapped_planes = 0;
+  const size_t num_planes = VideoFrame::NumPlanes(output_format_);
+  for (; mapped_planes < num_planes; ++mapped_planes) {
+    gfx::GpuMemoryBuffer* buffer =
+        frame_resources->plane_resources[mapped_planes].gpu_memory_buffer.get();
+    if (!buffer || !buffer->Map())
+      break;
+    data[mapped_planes] = static_cast<uint8_t*>(buffer->memory(0));
+    strides[mapped_planes] = buffer->stride(0);
+
+    // Decoders use aligned SIMD loads and stores on every row.
+    if (strides[mapped_planes] % VideoFrame::kFrameAddressAlignment ||
+        reinterpret_cast<uintptr_t>(data[mapped_planes]) %
+            VideoFrame::kFrameAddressAlignment) {
+      mapped_frames_unsupported_ = true;
+      buffer->Unmap();
+      break;
+    }
+  }
+  if (mapped_planes < num_planes) {
+    DLOG(ERROR) << "Could not map buffers for decoding";
+    for (size_t i = 0; i < mapped_planes; ++i)
+      frame_resources->plane_resources[i].gpu_memory_buffer->Unmap();
+    MailboxHoldersReleased(frame_resources, gpu::SyncToken());
+    return nullptr;
+  }
+
+  scoped_refptr<VideoFrame> frame = VideoFrame::WrapExternalYuvData(
+      format, coded_size, visible_rect, natural_size, strides[0], strides[1],
+      strides[2], data[0], data[1], data[2], kNoTimestamp());
+  if (!frame) {
+    MappedFrameReleased(frame_resources);
+    return nullptr;
+  }
+  frame_resources->mapped = true;
+  frame->AddDestructionObserver(BindToCurrentLoop(
+      base::Bind(&PoolImpl::MappedFrameReleased, this, frame_resources)));
+  return frame;
+}
+
 bool GpuMemoryBufferVideoFramePool::PoolImpl::OnMemoryDump(
     const base::trace_event::MemoryDumpArgs& args,
     base::trace_event::ProcessMemoryDump* pmd) {
@@ -541,7 +657,7 @@ void GpuMemoryBufferVideoFramePool::PoolImpl::
 
   const size_t num_planes = VideoFrame::NumPlanes(output_format_);
   const size_t planes_per_copy = PlanesPerCopy(output_format_);
-  const gfx::Size coded_size = CodedSize(video_frame, output_format_);
+  const gfx::Size coded_size = frame_resources->size;
   gpu::MailboxHolder mailbox_holders[VideoFrame::kMaxPlanes];
   gfx::GpuMemoryBufferId gpu_memory_buffer_ids[VideoFrame::kMaxPlanes];
   // Set up the planes creating the mailboxes needed to refer to the textures.
@@ -584,20 +700,28 @@ void GpuMemoryBufferVideoFramePool::PoolImpl::
     mailbox_holders[i].sync_token = sync_token;
 
 
+  // Mapped resources go back to the pool once the software frame they were
+  // decoded into is gone, so the hardware frame holds on to that instead.
   auto release_mailbox_callback = BindToCurrentLoop(
-      base::Bind(&PoolImpl::MailboxHoldersReleased, this, frame_resources));
+      frame_resources->mapped
+          ? base::Bind(&ReleaseWrappedFrame, video_frame)
+          : base::Bind(&PoolImpl::MailboxHoldersReleased, this,
+                       frame_resources));
 
   // Consumers should sample from NV12 textures as if they're XRGB.
   VideoPixelFormat frame_format =
       output_format_ == PIXEL_FORMAT_NV12 ? PIXEL_FORMAT_XRGB : output_format_;
   DCHECK_EQ(VideoFrame::NumPlanes(frame_format) * planes_per_copy, num_planes);
 
-  // Create the VideoFrame backed by native textures.
-  gfx::Size visible_size = video_frame->visible_rect().size();
+  // Create the VideoFrame backed by native textures.  Copies start at the
+  // visible origin, while mapped buffers hold the whole decoded frame.
+  const gfx::Rect visible_rect =
+      frame_resources->mapped ? video_frame->visible_rect()
+                              : gfx::Rect(video_frame->visible_rect().size());
   scoped_refptr<VideoFrame> frame =
       VideoFrame::WrapGpuMemoryBufferBackedNativeTextures(
           frame_format, mailbox_holders, gpu_memory_buffer_ids,
-          release_mailbox_callback, coded_size, gfx::Rect(visible_size),
+          release_mailbox_callback, coded_size, visible_rect,
           video_frame->natural_size(), video_frame->timestamp());
 
   if (!frame) {
@@ -728,6 +852,30 @@ void GpuMemoryBufferVideoFramePool::PoolImpl::DeleteFrameResources(
   }
 }
 
+GpuMemoryBufferVideoFramePool::PoolImpl::FrameResources*
+GpuMemoryBufferVideoFramePool::PoolImpl::FindMappedFrameResources(
+    const uint8_t* y_data) {
+  for (FrameResources* frame_resources : resources_pool_) {
+    if (frame_resources->mapped &&
+        frame_resources->plane_resources[VideoFrame::kYPlane]
+                .gpu_memory_buffer->memory(0) == y_data) {
+      return frame_resources;
+    }
+  }
+  return nullptr;
+}
+
+void GpuMemoryBufferVideoFramePool::PoolImpl::MappedFrameReleased(
+    FrameResources* frame_resources) {
+  DCHECK(media_task_runner_->BelongsToCurrentThread());
+  for (const auto& plane_resource : frame_resources->plane_resources) {
+    if (plane_resource.gpu_memory_buffer)
+      plane_resource.gpu_memory_buffer->Unmap();
+  }
+  frame_resources->mapped = false;
+  MailboxHoldersReleased(frame_resources, gpu::SyncToken());
+}
+
 // Called when a VideoFrame is no longer referenced.
 // Put back the resources in the pool.
 void GpuMemoryBufferVideoFramePool::PoolImpl::MailboxHoldersReleased(
@@ -768,4 +916,13 @@ void GpuMemoryBufferVideoFramePool::MaybeCreateHardwareFrame(
   pool_impl_->CreateHardwareFrame(video_frame, frame_ready_cb);
 }
 
+scoped_refptr<VideoFrame> GpuMemoryBufferVideoFramePool::MaybeCreateMappedFrame(
+    VideoPixelFormat format,
+    const gfx::Size& coded_size,
+    const gfx::Rect& visible_rect,
+    const gfx::Size& natural_size) {
+  return pool_impl_->CreateMappedFrame(format, coded_size, visible_rect,
+                                       natural_size);
+}
+
 }  // namespace media
@@ -48,6 +48,18 @@ class MEDIA_EXPORT GpuMemoryBufferVideoFramePool {
       const scoped_refptr<VideoFrame>& video_frame,
       const FrameReadyCB& frame_ready_cb);
 
+  // Returns a software VideoFrame of |format| whose planes are mapped
+  // GpuMemoryBuffers from the pool, for a software decoder to write into.
+  // Passing it to MaybeCreateHardwareFrame() afterwards wraps the same buffers
+  // in native textures instead of copying them.
+  // Returns null if the pool can't store |format| without conversion.
+  // Must be called on |media_task_runner|.
+  virtual scoped_refptr<VideoFrame> MaybeCreateMappedFrame(
+      VideoPixelFormat format,
+      const gfx::Size& coded_size,
+      const gfx::Rect& visible_rect,
+      const gfx::Size& natural_size);
+
  private:
   class PoolImpl;
   scoped_refptr<PoolImpl> pool_impl_;
@@ -61,6 +61,12 @@ struct Configuration {
   // (This will also entail some auditing to make sure I'm not messing up my
   // checks anywhere.)
   size_t max_shared_memory_num_bytes;
+
+  // Whether channels to other processes should ask to carry their messages
+  // through rings in shared memory rather than through the OS channel, where
+  // this is supported. Both processes need to support it; a process which
+  // cannot create shared memory simply does not ask. The default is false.
+  bool use_shared_memory_channel_transport;
 };
 
 }  // namespace edk
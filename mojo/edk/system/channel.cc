@@ -468,41 +468,80 @@ void Channel::ShutDown() {
   ShutDownImpl();
 }
 
+void Channel::RequestSharedMemoryTransport() {}
+
 char* Channel::GetReadBuffer(size_t *buffer_capacity) {
   DCHECK(read_buffer_);
+  return GetReadBufferImpl(read_buffer_.get(), buffer_capacity);
+}
+
+bool Channel::OnReadComplete(size_t bytes_read, size_t *next_read_size_hint) {
+  return OnReadCompleteImpl(read_buffer_.get(), bytes_read,
+                            next_read_size_hint);
+}
+
+char* Channel::GetSharedMemoryReadBuffer(size_t* buffer_capacity) {
+  if (!shared_memory_read_buffer_)
+    shared_memory_read_buffer_.reset(new ReadBuffer);
+  return GetReadBufferImpl(shared_memory_read_buffer_.get(), buffer_capacity);
+}
+
+bool Channel::OnSharedMemoryReadComplete(size_t bytes_read,
+                                         size_t* next_read_size_hint) {
+  DCHECK(shared_memory_read_buffer_);
+  return OnReadCompleteImpl(shared_memory_read_buffer_.get(), bytes_read,
+                            next_read_size_hint);
+}
+
+void Channel::OnError() {
+  if (delegate_)
+    delegate_->OnChannelError();
+}
+
+bool Channel::OnControlMessage(Message::Header::MessageType message_type,
+                               const void* payload,
+                               size_t payload_size,
+                               ScopedPlatformHandleVectorPtr handles) {
+  return false;
+}
+
+char* Channel::GetReadBufferImpl(ReadBuffer* read_buffer,
+                                 size_t* buffer_capacity) {
   size_t required_capacity = *buffer_capacity;
   if (!required_capacity)
     required_capacity = kReadBufferSize;
 
   *buffer_capacity = required_capacity;
-  return read_buffer_->Reserve(required_capacity);
+  return read_buffer->Reserve(required_capacity);
 }
 
-bool Channel::OnReadComplete(size_t bytes_read, size_t *next_read_size_hint) {
+bool Channel::OnReadCompleteImpl(ReadBuffer* read_buffer,
+                                 size_t bytes_read,
+                                 size_t* next_read_size_hint) {
   bool did_dispatch_message = false;
-  read_buffer_->Claim(bytes_read);
-  while (read_buffer_->num_occupied_bytes() >= sizeof(Message::Header)) {
+  read_buffer->Claim(bytes_read);
+  while (read_buffer->num_occupied_bytes() >= sizeof(Message::Header)) {
     // Ensure the occupied data is properly aligned. If it isn't, a SIGBUS could
     // happen on architectures that don't allow misaligned words access (i.e.
     // anything other than x86). Only re-align when necessary to avoid copies.
-    if (reinterpret_cast<uintptr_t>(read_buffer_->occupied_bytes()) %
+    if (reinterpret_cast<uintptr_t>(read_buffer->occupied_bytes()) %
         kChannelMessageAlignment != 0)
-      read_buffer_->Realign();
+      read_buffer->Realign();
 
     // We have at least enough data available for a MessageHeader.
     const Message::Header* header = reinterpret_cast<const Message::Header*>(
-        read_buffer_->occupied_bytes());
+        read_buffer->occupied_bytes());
     if (header->num_bytes < sizeof(Message::Header) ||
         header->num_bytes > kMaxChannelMessageSize) {
       LOG(ERROR) << "Invalid message size: " << header->num_bytes;
       return false;
     }
 
-    if (read_buffer_->num_occupied_bytes() < header->num_bytes) {
+    if (read_buffer->num_occupied_bytes() < header->num_bytes) {
       // Not enough data available to read the full message. Hint to the
       // implementation that it should try reading the full size of the message.
       *next_read_size_hint =
-          header->num_bytes - read_buffer_->num_occupied_bytes();
+          header->num_bytes - read_buffer->num_occupied_bytes();
       return true;
     }
 
@@ -524,7 +563,7 @@ bool Channel::OnReadComplete(size_t bytes_read, size_t *next_read_size_hint) {
     size_t payload_size = header->num_bytes - header->num_header_bytes;
     void* payload =
         payload_size ? reinterpret_cast<Message::Header*>(
-                           const_cast<char*>(read_buffer_->occupied_bytes()) +
+                           const_cast<char*>(read_buffer->occupied_bytes()) +
                            header->num_header_bytes)
                      : nullptr;
 #endif  // defined(OS_CHROMEOS) || defined(OS_ANDROID)
@@ -554,24 +593,12 @@ bool Channel::OnReadComplete(size_t bytes_read, size_t *next_read_size_hint) {
       did_dispatch_message = true;
     }
 
-    read_buffer_->Discard(header->num_bytes);
+    read_buffer->Discard(header->num_bytes);
   }
 
   *next_read_size_hint = did_dispatch_message ? 0 : kReadBufferSize;
   return true;
 }
 
-void Channel::OnError() {
-  if (delegate_)
-    delegate_->OnChannelError();
-}
-
-bool Channel::OnControlMessage(Message::Header::MessageType message_type,
-                               const void* payload,
-                               size_t payload_size,
-                               ScopedPlatformHandleVectorPtr handles) {
-  return false;
-}
-
 }  // namespace edk
 }  // namespace mojo
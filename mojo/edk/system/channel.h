@@ -40,6 +40,19 @@ class Channel : public base::RefCountedThreadSafe<Channel> {
         // A control message containing handles that can now be closed.
         HANDLES_SENT_ACK,
 #endif
+        // A control message offering a shared memory ring to write messages
+        // into, instead of the underlying I/O channel.
+        SHARED_MEMORY_RING_OFFER,
+        // A control message telling that the messages after it are written
+        // into the ring which was offered.
+        SHARED_MEMORY_RING_ACTIVATED,
+        // A control message waking up the idle reader of a ring.
+        SHARED_MEMORY_RING_WAKE,
+        // A control message telling the writer of a ring there is free space.
+        SHARED_MEMORY_RING_SPACE,
+        // A control message carrying the handles of the next message written
+        // into a ring.
+        SHARED_MEMORY_RING_HANDLES,
       };
 
       // Message size in bytes, including the header.
@@ -229,6 +242,13 @@ class Channel : public base::RefCountedThreadSafe<Channel> {
   // of closing it.
   virtual void LeakHandle() = 0;
 
+  // Asks the other end of the channel to write its messages into a ring in
+  // shared memory, and to do the same for the messages written here, which
+  // saves a system call per message while the reader is busy. Only a channel
+  // whose other end is also a Channel may do this, and only before Start().
+  // Does nothing where this is not supported.
+  virtual void RequestSharedMemoryTransport();
+
  protected:
   explicit Channel(Delegate* delegate);
   virtual ~Channel();
@@ -247,6 +267,13 @@ class Channel : public base::RefCountedThreadSafe<Channel> {
   // read done by the implementation.
   bool OnReadComplete(size_t bytes_read, size_t* next_read_size_hint);
 
+  // Like GetReadBuffer() and OnReadComplete(), for the messages read from a
+  // shared memory ring, which are a separate stream from the ones read from
+  // the underlying I/O channel.
+  char* GetSharedMemoryReadBuffer(size_t* buffer_capacity);
+  bool OnSharedMemoryReadComplete(size_t bytes_read,
+                                  size_t* next_read_size_hint);
+
   // Called by the implementation when something goes horribly wrong. It is NOT
   // OK to call this synchronously from any public interface methods.
   void OnError();
@@ -280,8 +307,14 @@ class Channel : public base::RefCountedThreadSafe<Channel> {
 
   class ReadBuffer;
 
+  char* GetReadBufferImpl(ReadBuffer* read_buffer, size_t* buffer_capacity);
+  bool OnReadCompleteImpl(ReadBuffer* read_buffer,
+                          size_t bytes_read,
+                          size_t* next_read_size_hint);
+
   Delegate* delegate_;
   const std::unique_ptr<ReadBuffer> read_buffer_;
+  std::unique_ptr<ReadBuffer> shared_memory_read_buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(Channel);
 };
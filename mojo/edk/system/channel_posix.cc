@@ -5,7 +5,9 @@
 #include "mojo/edk/system/channel.h"
 
 #include <errno.h>
+#include <string.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 
 #include <algorithm>
 #include <deque>
@@ -21,6 +23,8 @@
 #include "base/task_runner.h"
 #include "mojo/edk/embedder/platform_channel_utils_posix.h"
 #include "mojo/edk/embedder/platform_handle_vector.h"
+#include "mojo/edk/embedder/platform_shared_buffer.h"
+#include "mojo/edk/system/shared_memory_ring.h"
 
 #if !defined(OS_NACL)
 #include <sys/uio.h>
@@ -33,6 +37,10 @@ namespace {
 
 const size_t kMaxBatchReadCapacity = 256 * 1024;
 
+// The capacity of the ring each end offers for the messages it reads, when
+// RequestSharedMemoryTransport() is used.
+const uint32_t kSharedMemoryRingCapacity = 128 * 1024;
+
 // A view over a Channel::Message object. The write queue uses these since
 // large messages may need to be sent in chunks.
 class MessageView {
@@ -122,11 +130,11 @@ class ChannelPosix : public Channel,
       base::AutoLock lock(write_lock_);
       if (reject_writes_)
         return;
-      if (outgoing_messages_.empty()) {
-        if (!WriteNoLock(MessageView(std::move(message), 0)))
+      if (outgoing_ring_) {
+        if (!WriteToRingNoLock(MessageView(std::move(message), 0)))
           reject_writes_ = write_error = true;
-      } else {
-        outgoing_messages_.emplace_back(std::move(message), 0);
+      } else if (!WriteOrQueueNoLock(MessageView(std::move(message), 0))) {
+        reject_writes_ = write_error = true;
       }
     }
     if (write_error) {
@@ -142,6 +150,41 @@ class ChannelPosix : public Channel,
     leak_handle_ = true;
   }
 
+  void RequestSharedMemoryTransport() override {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+    if (incoming_ring_)
+      return;
+
+    // The ring carries the messages the other end writes to this one. If the
+    // shared memory cannot be created, e.g. in a sandboxed process, messages
+    // simply keep going through the socket.
+    const size_t num_bytes =
+        SharedMemoryRing::GetRequiredSize(kSharedMemoryRingCapacity);
+    scoped_refptr<PlatformSharedBuffer> buffer(
+        PlatformSharedBuffer::Create(num_bytes));
+    if (!buffer)
+      return;
+    std::unique_ptr<PlatformSharedBufferMapping> mapping =
+        buffer->Map(0, num_bytes);
+    ScopedPlatformHandle handle = buffer->DuplicatePlatformHandle();
+    if (!mapping || !handle.is_valid())
+      return;
+    incoming_ring_ = SharedMemoryRing::Create(mapping->GetBase(), num_bytes);
+    DCHECK(incoming_ring_);
+    incoming_ring_mapping_ = std::move(mapping);
+
+    ScopedPlatformHandleVectorPtr handles(new PlatformHandleVector);
+    handles->push_back(handle.release());
+    MessagePtr message(new Channel::Message(
+        sizeof(kSharedMemoryRingCapacity), 1,
+        Message::Header::MessageType::SHARED_MEMORY_RING_OFFER));
+    memcpy(message->mutable_payload(), &kSharedMemoryRingCapacity,
+           sizeof(kSharedMemoryRingCapacity));
+    message->SetHandles(std::move(handles));
+    Write(std::move(message));
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+  }
+
   bool GetReadPlatformHandles(
       size_t num_handles,
       const void* extra_header,
@@ -250,6 +293,15 @@ class ChannelPosix : public Channel,
 #if defined(OS_MACOSX)
     handles_to_close_.reset();
 #endif
+    incoming_ring_active_ = false;
+    incoming_ring_.reset();
+    incoming_ring_mapping_.reset();
+    {
+      base::AutoLock lock(write_lock_);
+      ring_messages_.clear();
+      outgoing_ring_.reset();
+      outgoing_ring_mapping_.reset();
+    }
 
     // May destroy the |this| if it was the last reference.
     self_ = nullptr;
@@ -384,6 +436,177 @@ class ChannelPosix : public Channel,
     return FlushOutgoingMessagesNoLock();
   }
 
+  // Writes a message to the socket, or queues it behind the messages already
+  // waiting for the socket to become writable.
+  bool WriteOrQueueNoLock(MessageView message_view) {
+    if (outgoing_messages_.empty())
+      return WriteNoLock(std::move(message_view));
+    outgoing_messages_.push_back(std::move(message_view));
+    return true;
+  }
+
+  bool WriteControlMessageNoLock(Message::Header::MessageType message_type) {
+    return WriteOrQueueNoLock(
+        MessageView(MessagePtr(new Channel::Message(0, 0, message_type)), 0));
+  }
+
+  // Writes a message into |outgoing_ring_|. Its handles cannot go through
+  // shared memory, so they are sent ahead of it through the socket, where the
+  // other end picks them up in the order it reads the messages from the ring.
+  bool WriteToRingNoLock(MessageView message_view) {
+    ScopedPlatformHandleVectorPtr handles = message_view.TakeHandles();
+    if (handles && handles->size()) {
+      MessageView handles_view(
+          MessagePtr(new Channel::Message(
+              0, 0, Message::Header::MessageType::SHARED_MEMORY_RING_HANDLES)),
+          0);
+      handles_view.SetHandles(std::move(handles));
+      if (!WriteOrQueueNoLock(std::move(handles_view)))
+        return false;
+    }
+
+    ring_messages_.push_back(std::move(message_view));
+    if (ring_messages_.size() > 1) {
+      // Still waiting for space to write the earlier messages.
+      return true;
+    }
+    return FlushRingMessagesNoLock();
+  }
+
+  // Writes as much of |ring_messages_| into |outgoing_ring_| as fits, and
+  // asks to be told about free space if that is not all of it.
+  bool FlushRingMessagesNoLock() {
+    while (!ring_messages_.empty()) {
+      MessageView& message_view = ring_messages_.front();
+      size_t bytes_written = outgoing_ring_->Write(
+          message_view.data(), message_view.data_num_bytes());
+      if (bytes_written == message_view.data_num_bytes()) {
+        ring_messages_.pop_front();
+      } else if (bytes_written > 0) {
+        message_view.advance_data_offset(bytes_written);
+      } else if (outgoing_ring_->WaitForSpace()) {
+        break;
+      }
+    }
+
+    if (!outgoing_ring_->ShouldWakeReader())
+      return true;
+    return WriteControlMessageNoLock(
+        Message::Header::MessageType::SHARED_MEMORY_RING_WAKE);
+  }
+
+  // Reads and dispatches the messages in |incoming_ring_| until it is empty,
+  // at which point the other end will wake this one up when it writes more.
+  // Returns false if the ring or a message in it was invalid.
+  bool ReadFromRing() {
+    size_t next_read_size = 0;
+    size_t total_bytes_read = 0;
+    while (incoming_ring_active_) {
+      size_t buffer_capacity = next_read_size;
+      char* buffer = GetSharedMemoryReadBuffer(&buffer_capacity);
+      size_t bytes_read = 0;
+      if (!incoming_ring_->Read(buffer, buffer_capacity, &bytes_read))
+        return false;
+      if (bytes_read > 0 && incoming_ring_->ShouldWakeWriter()) {
+        // This goes through the socket even if there is an outgoing ring,
+        // which may be full itself.
+        base::AutoLock lock(write_lock_);
+        if (!reject_writes_ &&
+            !WriteControlMessageNoLock(
+                Message::Header::MessageType::SHARED_MEMORY_RING_SPACE)) {
+          reject_writes_ = true;
+          return false;
+        }
+      }
+
+      // Also called when nothing was read, to dispatch messages which were
+      // waiting for their handles to come through the socket.
+      if (!OnSharedMemoryReadComplete(bytes_read, &next_read_size))
+        return false;
+
+      // Dispatching may have shut the channel down.
+      if (!incoming_ring_active_)
+        return true;
+      if (bytes_read == 0) {
+        if (incoming_ring_->WaitForData())
+          return true;
+      } else {
+        total_bytes_read += bytes_read;
+        if (total_bytes_read >= kMaxBatchReadCapacity) {
+          // Let other tasks run before reading the rest.
+          io_task_runner_->PostTask(
+              FROM_HERE,
+              base::Bind(&ChannelPosix::ContinueReadingFromRing, this));
+          return true;
+        }
+      }
+    }
+    return true;
+  }
+
+  void ContinueReadingFromRing() {
+    if (ReadFromRing())
+      return;
+    incoming_ring_active_ = false;
+    read_watcher_.reset();
+    OnError();
+  }
+
+  // Starts writing messages into the ring the other end offered.
+  bool AcceptRingOffer(const void* payload,
+                       size_t payload_size,
+                       ScopedPlatformHandleVectorPtr handles) {
+    uint32_t capacity;
+    if (payload_size != sizeof(capacity) || !handles || handles->size() != 1)
+      return false;
+    memcpy(&capacity, payload, sizeof(capacity));
+    if (capacity > kSharedMemoryRingCapacity)
+      return false;
+    const size_t num_bytes = SharedMemoryRing::GetRequiredSize(capacity);
+
+    ScopedPlatformHandle handle(handles->at(0));
+    handles->clear();
+#if !defined(OS_ANDROID)
+    // Make sure the memory is really there, or accessing it would crash.
+    struct stat stat_buf;
+    if (fstat(handle.get().handle, &stat_buf) != 0 ||
+        static_cast<size_t>(stat_buf.st_size) < num_bytes) {
+      return false;
+    }
+#endif
+    scoped_refptr<PlatformSharedBuffer> buffer(
+        PlatformSharedBuffer::CreateFromPlatformHandle(num_bytes, false,
+                                                       std::move(handle)));
+    if (!buffer)
+      return false;
+    std::unique_ptr<PlatformSharedBufferMapping> mapping =
+        buffer->Map(0, num_bytes);
+    if (!mapping)
+      return false;
+    std::unique_ptr<SharedMemoryRing> ring =
+        SharedMemoryRing::Create(mapping->GetBase(), num_bytes);
+    if (!ring)
+      return false;
+
+    {
+      base::AutoLock lock(write_lock_);
+      if (outgoing_ring_ || reject_writes_)
+        return false;
+      // Everything written after this goes into the ring, so the other end
+      // must read the ring only once it has read the socket up to here.
+      if (!WriteControlMessageNoLock(
+              Message::Header::MessageType::SHARED_MEMORY_RING_ACTIVATED)) {
+        return false;
+      }
+      outgoing_ring_ = std::move(ring);
+      outgoing_ring_mapping_ = std::move(mapping);
+    }
+
+    // Return the favor so that both directions use shared memory.
+    RequestSharedMemoryTransport();
+    return true;
+  }
+
   bool FlushOutgoingMessagesNoLock() {
     std::deque<MessageView> messages;
     std::swap(outgoing_messages_, messages);
@@ -411,12 +634,38 @@ class ChannelPosix : public Channel,
     return true;
   }
 
-#if defined(OS_MACOSX)
   bool OnControlMessage(Message::Header::MessageType message_type,
                         const void* payload,
                         size_t payload_size,
                         ScopedPlatformHandleVectorPtr handles) override {
     switch (message_type) {
+      case Message::Header::MessageType::SHARED_MEMORY_RING_OFFER:
+        return AcceptRingOffer(payload, payload_size, std::move(handles));
+
+      case Message::Header::MessageType::SHARED_MEMORY_RING_ACTIVATED:
+        if (!incoming_ring_ || incoming_ring_active_)
+          break;
+        incoming_ring_active_ = true;
+        return ReadFromRing();
+
+      case Message::Header::MessageType::SHARED_MEMORY_RING_WAKE:
+      case Message::Header::MessageType::SHARED_MEMORY_RING_HANDLES:
+        // The handles themselves were queued in |incoming_platform_handles_|
+        // when they were received.
+        if (!incoming_ring_active_)
+          break;
+        return ReadFromRing();
+
+      case Message::Header::MessageType::SHARED_MEMORY_RING_SPACE: {
+        base::AutoLock lock(write_lock_);
+        if (!outgoing_ring_)
+          break;
+        if (!FlushRingMessagesNoLock())
+          reject_writes_ = true;
+        return !reject_writes_;
+      }
+
+#if defined(OS_MACOSX)
       case Message::Header::MessageType::HANDLES_SENT: {
         if (payload_size == 0)
           break;
@@ -437,6 +686,7 @@ class ChannelPosix : public Channel,
           break;
         return true;
       }
+#endif  // defined(OS_MACOSX)
 
       default:
         break;
@@ -445,6 +695,7 @@ class ChannelPosix : public Channel,
     return false;
   }
 
+#if defined(OS_MACOSX)
   // Closes handles referenced by |fds|. Returns false if |num_fds| is 0, or if
   // |fds| does not match a sequence of handles in |handles_to_close_|.
   bool CloseHandles(const int* fds, size_t num_fds) {
@@ -490,12 +741,24 @@ class ChannelPosix : public Channel,
 
   std::deque<PlatformHandle> incoming_platform_handles_;
 
-  // Protects |pending_write_| and |outgoing_messages_|.
+  // Protects |pending_write_|, |outgoing_messages_| and the outgoing ring.
   base::Lock write_lock_;
   bool pending_write_ = false;
   bool reject_writes_ = false;
   std::deque<MessageView> outgoing_messages_;
 
+  // The ring the other end writes its messages into, once it has accepted the
+  // offer of it. Only accessed on the IO thread after Start().
+  std::unique_ptr<PlatformSharedBufferMapping> incoming_ring_mapping_;
+  std::unique_ptr<SharedMemoryRing> incoming_ring_;
+  bool incoming_ring_active_ = false;
+
+  // The ring offered by the other end, and the messages waiting for space in
+  // it. Protected by |write_lock_|.
+  std::unique_ptr<PlatformSharedBufferMapping> outgoing_ring_mapping_;
+  std::unique_ptr<SharedMemoryRing> outgoing_ring_;
+  std::deque<MessageView> ring_messages_;
+
   bool leak_handle_ = false;
 
 #if defined(OS_MACOSX)
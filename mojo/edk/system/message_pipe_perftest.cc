@@ -17,6 +17,7 @@
 #include "base/threading/thread.h"
 #include "mojo/edk/embedder/embedder.h"
 #include "mojo/edk/embedder/scoped_platform_handle.h"
+#include "mojo/edk/system/configuration.h"
 #include "mojo/edk/system/handle_signals_state.h"
 #include "mojo/edk/system/test_utils.h"
 #include "mojo/edk/test/mojo_test_base.h"
@@ -92,6 +93,45 @@ class MessagePipePerfTest : public test::MojoTestBase {
     SendQuitMessage(mp);
   }
 
+  // Sends messages without waiting for replies, so that the cost of writing
+  // and reading them is measured rather than the latency of a round trip.
+  void RunThroughputServer(MojoHandle mp, const char* transport) {
+    const size_t kMsgSize[4] = {12, 144, 1728, 20736};
+    const int kMessageCount[4] = {200000, 200000, 100000, 20000};
+
+    for (size_t i = 0; i < 4; i++) {
+      SetUpMeasurement(kMessageCount[i], kMsgSize[i]);
+      // Have one ping-pong to ensure channel being established.
+      WriteWaitThenRead(mp);
+
+      std::string test_name = base::StringPrintf(
+          "IPC_Throughput_%s_%dx_%u", transport, message_count_,
+          static_cast<unsigned>(message_size_));
+      base::PerfTimeLogger logger(test_name.c_str());
+      for (int j = 0; j < message_count_; ++j) {
+        CHECK_EQ(MojoWriteMessage(mp, payload_.data(),
+                                  static_cast<uint32_t>(payload_.size()),
+                                  nullptr, 0, MOJO_WRITE_MESSAGE_FLAG_NONE),
+                 MOJO_RESULT_OK);
+      }
+      // The client replies to "!" once it has read everything before it.
+      CHECK_EQ(MojoWriteMessage(mp, "!", 1, nullptr, 0,
+                                MOJO_WRITE_MESSAGE_FLAG_NONE),
+               MOJO_RESULT_OK);
+      CHECK_EQ(MojoWait(mp, MOJO_HANDLE_SIGNAL_READABLE,
+                        MOJO_DEADLINE_INDEFINITE, nullptr),
+               MOJO_RESULT_OK);
+      uint32_t read_buffer_size = static_cast<uint32_t>(read_buffer_.size());
+      CHECK_EQ(MojoReadMessage(mp, &read_buffer_[0], &read_buffer_size,
+                               nullptr, nullptr, MOJO_READ_MESSAGE_FLAG_NONE),
+               MOJO_RESULT_OK);
+      CHECK_EQ(read_buffer_size, 1u);
+      logger.Done();
+    }
+
+    SendQuitMessage(mp);
+  }
+
   static int RunPingPongClient(MojoHandle mp) {
     std::string buffer(1000000, '\0');
     int rv = 0;
@@ -125,6 +165,40 @@ class MessagePipePerfTest : public test::MojoTestBase {
     return rv;
   }
 
+  // Replies only to the first message after each "!", and to "!" itself.
+  static int RunThroughputClient(MojoHandle mp) {
+    std::string buffer(1000000, '\0');
+    bool reply_to_next = true;
+    while (true) {
+      MojoResult result = MojoWait(mp, MOJO_HANDLE_SIGNAL_READABLE,
+                                   MOJO_DEADLINE_INDEFINITE, nullptr);
+      if (result != MOJO_RESULT_OK)
+        return result;
+
+      // Read everything there is before waiting again.
+      while (true) {
+        uint32_t read_size = static_cast<uint32_t>(buffer.size());
+        result = MojoReadMessage(mp, &buffer[0], &read_size, nullptr, 0,
+                                 MOJO_READ_MESSAGE_FLAG_NONE);
+        if (result == MOJO_RESULT_SHOULD_WAIT)
+          break;
+        CHECK_EQ(result, MOJO_RESULT_OK);
+
+        // Empty message indicates quit.
+        if (read_size == 0)
+          return 0;
+
+        bool is_end = read_size == 1 && buffer[0] == '!';
+        if (reply_to_next || is_end) {
+          CHECK_EQ(MojoWriteMessage(mp, &buffer[0], read_size, nullptr, 0,
+                                    MOJO_WRITE_MESSAGE_FLAG_NONE),
+                   MOJO_RESULT_OK);
+        }
+        reply_to_next = is_end;
+      }
+    }
+  }
+
  private:
   int message_count_;
   size_t message_size_;
@@ -165,6 +239,50 @@ TEST_F(MessagePipePerfTest, MultiprocessPingPong) {
   END_CHILD()
 }
 
+// Makes the channels created while it is alive ask for the shared memory
+// transport. The child processes accept it without being told to.
+class ScopedSharedMemoryChannelTransport {
+ public:
+  ScopedSharedMemoryChannelTransport()
+      : old_value_(GetConfiguration().use_shared_memory_channel_transport) {
+    GetMutableConfiguration()->use_shared_memory_channel_transport = true;
+  }
+
+  ~ScopedSharedMemoryChannelTransport() {
+    GetMutableConfiguration()->use_shared_memory_channel_transport =
+        old_value_;
+  }
+
+ private:
+  const bool old_value_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedSharedMemoryChannelTransport);
+};
+
+TEST_F(MessagePipePerfTest, MultiprocessPingPongSharedMemory) {
+  ScopedSharedMemoryChannelTransport shared_memory_transport;
+  RUN_CHILD_ON_PIPE(PingPongClient, h)
+    RunPingPongServer(h);
+  END_CHILD()
+}
+
+DEFINE_TEST_CLIENT_WITH_PIPE(ThroughputClient, MessagePipePerfTest, h) {
+  return RunThroughputClient(h);
+}
+
+TEST_F(MessagePipePerfTest, MultiprocessThroughput) {
+  RUN_CHILD_ON_PIPE(ThroughputClient, h)
+    RunThroughputServer(h, "Socket");
+  END_CHILD()
+}
+
+TEST_F(MessagePipePerfTest, MultiprocessThroughputSharedMemory) {
+  ScopedSharedMemoryChannelTransport shared_memory_transport;
+  RUN_CHILD_ON_PIPE(ThroughputClient, h)
+    RunThroughputServer(h, "SharedMemory");
+  END_CHILD()
+}
+
 }  // namespace
 }  // namespace edk
 }  // namespace mojo
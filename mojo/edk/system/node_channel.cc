@@ -12,6 +12,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "mojo/edk/system/channel.h"
+#include "mojo/edk/system/configuration.h"
 #include "mojo/edk/system/request_context.h"
 
 #if defined(OS_MACOSX) && !defined(OS_IOS)
@@ -190,8 +191,11 @@ void NodeChannel::Start() {
 
   base::AutoLock lock(channel_lock_);
   // ShutDown() may have already been called, in which case |channel_| is null.
-  if (channel_)
+  if (channel_) {
+    if (GetConfiguration().use_shared_memory_channel_transport)
+      channel_->RequestSharedMemoryTransport();
     channel_->Start();
+  }
 }
 
 void NodeChannel::ShutDown() {
@@ -0,0 +1,153 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/shared_memory_ring.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+
+namespace mojo {
+namespace edk {
+
+// Positions count the bytes written and read since the ring was created,
+// modulo 2^32. Each side's fields sit on their own cache line.
+struct SharedMemoryRing::Header {
+  base::subtle::Atomic32 write_position;
+  base::subtle::Atomic32 writer_waiting;
+  char padding0[56];
+  base::subtle::Atomic32 read_position;
+  base::subtle::Atomic32 reader_idle;
+  char padding1[56];
+};
+
+// static
+size_t SharedMemoryRing::GetRequiredSize(uint32_t capacity) {
+  static_assert(sizeof(Header) == 128, "Header must span two cache lines");
+  return sizeof(Header) + capacity;
+}
+
+// static
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(void* memory,
+                                                           size_t num_bytes) {
+  if (num_bytes <= sizeof(Header) ||
+      num_bytes - sizeof(Header) > (1u << 31)) {
+    return nullptr;
+  }
+  uint32_t capacity = static_cast<uint32_t>(num_bytes - sizeof(Header));
+  if (capacity & (capacity - 1))
+    return nullptr;
+
+  Header* header = static_cast<Header*>(memory);
+  return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(
+      header, reinterpret_cast<char*>(header + 1), capacity));
+}
+
+SharedMemoryRing::SharedMemoryRing(Header* header,
+                                   char* data,
+                                   uint32_t capacity)
+    : header_(header),
+      data_(data),
+      capacity_(capacity),
+      write_position_(static_cast<uint32_t>(
+          base::subtle::Acquire_Load(&header->write_position))),
+      read_position_(static_cast<uint32_t>(
+          base::subtle::Acquire_Load(&header->read_position))) {}
+
+SharedMemoryRing::~SharedMemoryRing() {}
+
+size_t SharedMemoryRing::Write(const void* data, size_t num_bytes) {
+  uint32_t read_position = static_cast<uint32_t>(
+      base::subtle::Acquire_Load(&header_->read_position));
+  uint32_t num_used_bytes = write_position_ - read_position;
+  if (num_used_bytes > capacity_)
+    return 0;
+
+  size_t num_written_bytes =
+      std::min(num_bytes, static_cast<size_t>(capacity_ - num_used_bytes));
+  uint32_t offset = write_position_ & (capacity_ - 1);
+  size_t num_bytes_to_end =
+      std::min(num_written_bytes, static_cast<size_t>(capacity_ - offset));
+  memcpy(data_ + offset, data, num_bytes_to_end);
+  memcpy(data_, static_cast<const char*>(data) + num_bytes_to_end,
+         num_written_bytes - num_bytes_to_end);
+
+  write_position_ += static_cast<uint32_t>(num_written_bytes);
+  base::subtle::Release_Store(&header_->write_position,
+                              static_cast<base::subtle::Atomic32>(
+                                  write_position_));
+  return num_written_bytes;
+}
+
+bool SharedMemoryRing::ShouldWakeReader() {
+  // Pairs with the barrier in WaitForData(): either the reader sees what was
+  // written, or this sees the reader's idle flag.
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header_->reader_idle))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header_->reader_idle, 0) != 0;
+}
+
+bool SharedMemoryRing::WaitForSpace() {
+  base::subtle::NoBarrier_Store(&header_->writer_waiting, 1);
+  base::subtle::MemoryBarrier();
+  uint32_t read_position = static_cast<uint32_t>(
+      base::subtle::NoBarrier_Load(&header_->read_position));
+  if (write_position_ - read_position >= capacity_)
+    return true;
+  base::subtle::NoBarrier_Store(&header_->writer_waiting, 0);
+  return false;
+}
+
+bool SharedMemoryRing::Read(void* buffer,
+                            size_t capacity,
+                            size_t* num_bytes_read) {
+  uint32_t write_position = static_cast<uint32_t>(
+      base::subtle::Acquire_Load(&header_->write_position));
+  uint32_t num_used_bytes = write_position - read_position_;
+  if (num_used_bytes > capacity_) {
+    DLOG(ERROR) << "Shared memory ring holds more than its capacity.";
+    return false;
+  }
+
+  *num_bytes_read = std::min(capacity, static_cast<size_t>(num_used_bytes));
+  uint32_t offset = read_position_ & (capacity_ - 1);
+  size_t num_bytes_to_end =
+      std::min(*num_bytes_read, static_cast<size_t>(capacity_ - offset));
+  memcpy(buffer, data_ + offset, num_bytes_to_end);
+  memcpy(static_cast<char*>(buffer) + num_bytes_to_end, data_,
+         *num_bytes_read - num_bytes_to_end);
+
+  read_position_ += static_cast<uint32_t>(*num_bytes_read);
+  base::subtle::Release_Store(&header_->read_position,
+                              static_cast<base::subtle::Atomic32>(
+                                  read_position_));
+  return true;
+}
+
+bool SharedMemoryRing::ShouldWakeWriter() {
+  // Pairs with the barrier in WaitForSpace().
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header_->writer_waiting))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header_->writer_waiting, 0) !=
+         0;
+}
+
+bool SharedMemoryRing::WaitForData() {
+  base::subtle::NoBarrier_Store(&header_->reader_idle, 1);
+  base::subtle::MemoryBarrier();
+  if (static_cast<uint32_t>(base::subtle::NoBarrier_Load(
+          &header_->write_position)) == read_position_) {
+    return true;
+  }
+  base::subtle::NoBarrier_Store(&header_->reader_idle, 0);
+  return false;
+}
+
+}  // namespace edk
+}  // namespace mojo
@@ -0,0 +1,92 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_EDK_SYSTEM_SHARED_MEMORY_RING_H_
+#define MOJO_EDK_SYSTEM_SHARED_MEMORY_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "mojo/edk/system/system_impl_export.h"
+
+namespace mojo {
+namespace edk {
+
+// A single-producer single-consumer byte ring living in memory shared by two
+// processes, one of which only writes to it and the other only reads from it.
+// It does not block or signal by itself: each side tells the other when it
+// goes idle, so that the other knows when it has to be woken up through some
+// other channel. The reader never trusts the positions the writer stores in
+// the shared memory, and vice versa.
+class MOJO_SYSTEM_IMPL_EXPORT SharedMemoryRing {
+ public:
+  // Returns the size of the shared memory needed for a ring holding
+  // |capacity| bytes, which must be a power of two.
+  static size_t GetRequiredSize(uint32_t capacity);
+
+  // Wraps |num_bytes| of zero-initialized shared memory at |memory|, which
+  // must outlive the ring. Returns null if |num_bytes| is not a valid size
+  // for a ring.
+  static std::unique_ptr<SharedMemoryRing> Create(void* memory,
+                                                  size_t num_bytes);
+
+  ~SharedMemoryRing();
+
+  uint32_t capacity() const { return capacity_; }
+
+  // Writer side:
+
+  // Copies as many of the |num_bytes| at |data| into the ring as fit, and
+  // returns how many that was.
+  size_t Write(const void* data, size_t num_bytes);
+
+  // Returns true if the reader went idle and has to be woken up to see what
+  // Write() wrote. Clears the reader's idle flag.
+  bool ShouldWakeReader();
+
+  // Tells the reader to wake the writer up when it frees some space. Returns
+  // false if there is free space already, in which case the writer should go
+  // on writing instead of waiting.
+  bool WaitForSpace();
+
+  // Reader side:
+
+  // Copies up to |capacity| bytes out of the ring into |buffer|, and sets
+  // |*num_bytes_read| to how many that was. Returns false if the writer
+  // corrupted the ring.
+  bool Read(void* buffer, size_t capacity, size_t* num_bytes_read);
+
+  // Returns true if the writer is waiting for the space Read() freed, and has
+  // to be woken up. Clears the writer's waiting flag.
+  bool ShouldWakeWriter();
+
+  // Tells the writer to wake the reader up when it writes something. Returns
+  // false if there is data to read already, in which case the reader should
+  // go on reading instead of waiting.
+  bool WaitForData();
+
+ private:
+  struct Header;
+
+  SharedMemoryRing(Header* header, char* data, uint32_t capacity);
+
+  Header* const header_;
+  char* const data_;
+  const uint32_t capacity_;
+
+  // The positions as last stored by this side. Only the writer uses
+  // |write_position_| and only the reader uses |read_position_|.
+  uint32_t write_position_;
+  uint32_t read_position_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace edk
+}  // namespace mojo
+
+#endif  // MOJO_EDK_SYSTEM_SHARED_MEMORY_RING_H_
@@ -0,0 +1,129 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/shared_memory_ring.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace edk {
+namespace {
+
+const uint32_t kCapacity = 16;
+
+class SharedMemoryRingTest : public testing::Test {
+ public:
+  // The memory is made of uint64_ts to align the ring header.
+  SharedMemoryRingTest()
+      : memory_(SharedMemoryRing::GetRequiredSize(kCapacity) /
+                sizeof(uint64_t)) {}
+
+ protected:
+  // Creates two views of the same ring, as the two processes would have.
+  void CreateRings() {
+    size_t num_bytes = SharedMemoryRing::GetRequiredSize(kCapacity);
+    writer_ = SharedMemoryRing::Create(memory_.data(), num_bytes);
+    reader_ = SharedMemoryRing::Create(memory_.data(), num_bytes);
+    ASSERT_TRUE(writer_);
+    ASSERT_TRUE(reader_);
+  }
+
+  std::vector<uint64_t> memory_;
+  std::unique_ptr<SharedMemoryRing> writer_;
+  std::unique_ptr<SharedMemoryRing> reader_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRingTest);
+};
+
+TEST_F(SharedMemoryRingTest, RejectsInvalidSizes) {
+  EXPECT_FALSE(SharedMemoryRing::Create(memory_.data(), 0));
+  EXPECT_FALSE(SharedMemoryRing::Create(
+      memory_.data(), SharedMemoryRing::GetRequiredSize(0)));
+  EXPECT_FALSE(SharedMemoryRing::Create(
+      memory_.data(), SharedMemoryRing::GetRequiredSize(12)));
+  EXPECT_TRUE(SharedMemoryRing::Create(
+      memory_.data(), SharedMemoryRing::GetRequiredSize(8)));
+}
+
+TEST_F(SharedMemoryRingTest, WritesAndReadsAcrossTheEnd) {
+  CreateRings();
+  EXPECT_EQ(kCapacity, reader_->capacity());
+
+  const char kData[] = "0123456789abcdefghij";
+  char buffer[32];
+  size_t num_bytes_read = 0;
+
+  EXPECT_EQ(10u, writer_->Write(kData, 10));
+  ASSERT_TRUE(reader_->Read(buffer, 4, &num_bytes_read));
+  EXPECT_EQ(4u, num_bytes_read);
+  EXPECT_EQ(0, memcmp(kData, buffer, 4));
+
+  // Only 10 bytes fit now, and they wrap around the end of the ring.
+  EXPECT_EQ(10u, writer_->Write(kData + 10, 11));
+  ASSERT_TRUE(reader_->Read(buffer, sizeof(buffer), &num_bytes_read));
+  EXPECT_EQ(16u, num_bytes_read);
+  EXPECT_EQ(0, memcmp(kData + 4, buffer, 16));
+
+  ASSERT_TRUE(reader_->Read(buffer, sizeof(buffer), &num_bytes_read));
+  EXPECT_EQ(0u, num_bytes_read);
+}
+
+TEST_F(SharedMemoryRingTest, WakesIdleReader) {
+  CreateRings();
+  char buffer[kCapacity];
+  size_t num_bytes_read = 0;
+
+  // A busy reader needs no wake-up.
+  EXPECT_EQ(1u, writer_->Write("a", 1));
+  EXPECT_FALSE(writer_->ShouldWakeReader());
+
+  // The reader may not go idle while there is data to read.
+  EXPECT_FALSE(reader_->WaitForData());
+  ASSERT_TRUE(reader_->Read(buffer, sizeof(buffer), &num_bytes_read));
+  EXPECT_TRUE(reader_->WaitForData());
+
+  EXPECT_EQ(1u, writer_->Write("b", 1));
+  EXPECT_TRUE(writer_->ShouldWakeReader());
+  EXPECT_FALSE(writer_->ShouldWakeReader());
+}
+
+TEST_F(SharedMemoryRingTest, WakesWaitingWriter) {
+  CreateRings();
+  char buffer[kCapacity] = {};
+  size_t num_bytes_read = 0;
+
+  // The writer may not wait while there is space.
+  EXPECT_EQ(kCapacity - 1, writer_->Write(buffer, kCapacity - 1));
+  EXPECT_FALSE(writer_->WaitForSpace());
+  EXPECT_EQ(1u, writer_->Write(buffer, kCapacity));
+  EXPECT_TRUE(writer_->WaitForSpace());
+
+  ASSERT_TRUE(reader_->Read(buffer, 1, &num_bytes_read));
+  EXPECT_TRUE(reader_->ShouldWakeWriter());
+  ASSERT_TRUE(reader_->Read(buffer, 1, &num_bytes_read));
+  EXPECT_FALSE(reader_->ShouldWakeWriter());
+}
+
+TEST_F(SharedMemoryRingTest, RejectsCorruptPositions) {
+  CreateRings();
+  // Pretend the writer claims to have written more than the capacity.
+  uint32_t write_position = kCapacity + 1;
+  memcpy(memory_.data(), &write_position, sizeof(write_position));
+  char buffer[kCapacity];
+  size_t num_bytes_read = 0;
+  EXPECT_FALSE(reader_->Read(buffer, sizeof(buffer), &num_bytes_read));
+}
+
+}  // namespace
+}  // namespace edk
+}  // namespace mojo
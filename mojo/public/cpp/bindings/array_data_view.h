@@ -0,0 +1,191 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_PUBLIC_CPP_BINDINGS_ARRAY_DATA_VIEW_H_
+#define MOJO_PUBLIC_CPP_BINDINGS_ARRAY_DATA_VIEW_H_
+
+#include <stddef.h>
+
+#include "base/logging.h"
+#include "mojo/public/cpp/bindings/array.h"
+#include "mojo/public/cpp/bindings/lib/array_internal.h"
+#include "mojo/public/cpp/bindings/lib/array_serialization.h"
+#include "mojo/public/cpp/bindings/lib/serialization_context.h"
+#include "mojo/public/cpp/bindings/lib/serialization_forward.h"
+#include "mojo/public/cpp/bindings/string_traits.h"
+
+namespace mojo {
+
+template <typename T>
+class ArrayDataView;
+
+namespace internal {
+
+template <typename T,
+          ArraySerializerType type = GetArraySerializerType<Array<T>>::value>
+class ArrayDataViewImpl;
+
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::POD> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  const T& operator[](size_t index) const { return data_->at(index); }
+
+  const T* data() const { return data_->storage(); }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::BOOLEAN> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  bool operator[](size_t index) const { return data_->at(index); }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::ENUM> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  template <typename U>
+  bool Read(size_t index, U* output) const {
+    return Deserialize<T>(data_->at(index), output);
+  }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::HANDLE> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  // Takes the handle at |index| out of the message. It can only be taken
+  // once.
+  T Take(size_t index) {
+    using HandleType = typename T::RawHandleType;
+    return MakeScopedHandle(
+        HandleType(context_->handles.TakeHandle(data_->at(index)).value()));
+  }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+// Strings, arrays, maps and structs.
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::POINTER> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  bool IsNull(size_t index) const { return !data_->at(index); }
+
+  // For an array of arrays.
+  template <typename U>
+  void GetDataView(size_t index, ArrayDataView<U>* output) {
+    *output = ArrayDataView<U>(data_->at(index), context_);
+  }
+
+  // For an array of strings. The string at |index| must not be null.
+  StringDataView GetStringDataView(size_t index) const {
+    return StringDataView(data_->at(index));
+  }
+
+  template <typename U>
+  bool Read(size_t index, U* output) {
+    return Deserialize<T>(data_->at(index), output, context_);
+  }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+template <typename T>
+class ArrayDataViewImpl<T, ArraySerializerType::UNION> {
+ public:
+  using Data_ = typename Array<T>::Data_;
+
+  bool IsNull(size_t index) const { return data_->at(index).is_null(); }
+
+  template <typename U>
+  bool Read(size_t index, U* output) {
+    return Deserialize<T>(&data_->at(index), output, context_);
+  }
+
+ protected:
+  ArrayDataViewImpl(Data_* data, SerializationContext* context)
+      : data_(data), context_(context) {}
+
+  Data_* data_;
+  SerializationContext* context_;
+};
+
+}  // namespace internal
+
+// A view of a serialized, validated array, which reads its elements in place
+// rather than deserializing all of them up front. |T| is the mojom element
+// type, e.g. the view of a mojom array<array<uint8>> is
+// ArrayDataView<Array<uint8_t>>.
+//
+// What can be read depends on the element type:
+//   - POD: operator[] and data().
+//   - bool: operator[].
+//   - enums: Read().
+//   - handles: Take().
+//   - arrays: GetDataView(), and IsNull() or Read().
+//   - strings: GetStringDataView(), and IsNull() or Read().
+//   - maps, structs and unions: IsNull() and Read().
+//
+// The view does not own anything; it must not outlive the message it was
+// created from.
+template <typename T>
+class ArrayDataView : public internal::ArrayDataViewImpl<T> {
+ public:
+  using Element = T;
+  using Data_ = typename internal::ArrayDataViewImpl<T>::Data_;
+
+  ArrayDataView() : internal::ArrayDataViewImpl<T>(nullptr, nullptr) {}
+
+  ArrayDataView(Data_* data, internal::SerializationContext* context)
+      : internal::ArrayDataViewImpl<T>(data, context) {}
+
+  bool is_null() const { return !this->data_; }
+
+  size_t size() const {
+    DCHECK(!is_null());
+    return this->data_->size();
+  }
+};
+
+}  // namespace mojo
+
+#endif  // MOJO_PUBLIC_CPP_BINDINGS_ARRAY_DATA_VIEW_H_
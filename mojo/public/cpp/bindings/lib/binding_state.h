@@ -145,7 +145,9 @@ class BindingState<Interface, true> {
             scoped_refptr<base::SingleThreadTaskRunner> runner) {
     DCHECK(!router_);
 
-    router_ = new internal::MultiplexRouter(false, std::move(handle), runner);
+    router_ = new internal::MultiplexRouter(
+        false, std::move(handle),
+        internal::MultiplexRouter::MULTI_THREADED_ENDPOINTS, runner);
     router_->SetMasterInterfaceName(Interface::Name_);
     stub_.serialization_context()->router = router_;
 
@@ -12,6 +12,9 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/bindings/lib/may_auto_lock.h"
+#include "mojo/public/cpp/bindings/lib/message_internal.h"
 #include "mojo/public/cpp/bindings/lib/sync_handle_watcher.h"
 
 namespace mojo {
@@ -19,26 +22,9 @@ namespace internal {
 
 namespace {
 
-// Similar to base::AutoLock, except that it does nothing if |lock| passed into
-// the constructor is null.
-class MayAutoLock {
- public:
-  explicit MayAutoLock(base::Lock* lock) : lock_(lock) {
-    if (lock_)
-      lock_->Acquire();
-  }
-
-  ~MayAutoLock() {
-    if (lock_) {
-      lock_->AssertAcquired();
-      lock_->Release();
-    }
-  }
-
- private:
-  base::Lock* lock_;
-  DISALLOW_COPY_AND_ASSIGN(MayAutoLock);
-};
+// How long ReadAllAvailableMessages() may dispatch messages before it lets
+// other tasks run.
+const int64_t kMaxReadTimeMilliseconds = 10;
 
 }  // namespace
 
@@ -56,6 +42,7 @@ Connector::Connector(ScopedMessagePipeHandle message_pipe,
       enforce_errors_from_incoming_receiver_(true),
       paused_(false),
       lock_(config == MULTI_THREADED_SEND ? new base::Lock : nullptr),
+      batch_outgoing_messages_(false),
       allow_woken_up_by_others_(false),
       sync_handle_watcher_callback_count_(0),
       weak_factory_(this) {
@@ -69,6 +56,7 @@ Connector::~Connector() {
   DCHECK(thread_checker_.CalledOnValidThread());
 
   CancelWait();
+  FlushOutgoingMessages();
 }
 
 void Connector::CloseMessagePipe() {
@@ -76,6 +64,7 @@ void Connector::CloseMessagePipe() {
 
   CancelWait();
   MayAutoLock locker(lock_.get());
+  FlushOutgoingMessagesNoLock();
   message_pipe_.reset();
 }
 
@@ -84,6 +73,7 @@ ScopedMessagePipeHandle Connector::PassMessagePipe() {
 
   CancelWait();
   MayAutoLock locker(lock_.get());
+  FlushOutgoingMessagesNoLock();
   return std::move(message_pipe_);
 }
 
@@ -100,6 +90,8 @@ bool Connector::WaitForIncomingMessage(MojoDeadline deadline) {
     return false;
 
   ResumeIncomingMethodCallProcessing();
+  // The message being waited for may be the response to a queued one.
+  FlushOutgoingMessages();
 
   MojoResult rv =
       Wait(message_pipe_.get(), MOJO_HANDLE_SIGNAL_READABLE, deadline, nullptr);
@@ -149,9 +141,26 @@ bool Connector::Accept(Message* message) {
   if (!message_pipe_.is_valid() || drop_writes_)
     return true;
 
-  MojoResult rv =
-      WriteMessageNew(message_pipe_.get(), message->TakeMojoMessage(),
-                      MOJO_WRITE_MESSAGE_FLAG_NONE);
+  if (batch_outgoing_messages_ && !message->has_flag(kMessageIsSync)) {
+    if (outgoing_messages_.empty()) {
+      task_runner_->PostTask(
+          FROM_HERE,
+          base::Bind(&Connector::FlushOutgoingMessages, weak_self_));
+    }
+    outgoing_messages_.push_back(message->TakeMojoMessage());
+    return true;
+  }
+
+  // Keep the order in which messages were accepted.
+  FlushOutgoingMessagesNoLock();
+  if (!message_pipe_.is_valid() || drop_writes_)
+    return true;
+  return WriteMessageNoLock(message->TakeMojoMessage());
+}
+
+bool Connector::WriteMessageNoLock(ScopedMessageHandle message) {
+  MojoResult rv = WriteMessageNew(message_pipe_.get(), std::move(message),
+                                  MOJO_WRITE_MESSAGE_FLAG_NONE);
 
   switch (rv) {
     case MOJO_RESULT_OK:
@@ -184,6 +193,27 @@ bool Connector::Accept(Message* message) {
   return true;
 }
 
+void Connector::FlushOutgoingMessages() {
+  MayAutoLock locker(lock_.get());
+  FlushOutgoingMessagesNoLock();
+}
+
+void Connector::FlushOutgoingMessagesNoLock() {
+  if (outgoing_messages_.empty())
+    return;
+
+  std::vector<ScopedMessageHandle> messages;
+  std::swap(messages, outgoing_messages_);
+  for (ScopedMessageHandle& message : messages) {
+    if (!message_pipe_.is_valid() || drop_writes_)
+      break;
+    // The sender was told that a queued message was accepted, so a message
+    // rejected now can only be dropped.
+    if (!WriteMessageNoLock(std::move(message)))
+      DLOG(ERROR) << "Dropped a queued message rejected by the pipe.";
+  }
+}
+
 void Connector::AllowWokenUpBySyncWatchOnSameThread() {
   DCHECK(thread_checker_.CalledOnValidThread());
 
@@ -200,6 +230,7 @@ bool Connector::SyncWatch(const bool* should_stop) {
     return false;
 
   ResumeIncomingMethodCallProcessing();
+  FlushOutgoingMessages();
 
   EnsureSyncWatcherExists();
   return sync_watcher_->SyncWatch(should_stop);
@@ -290,6 +321,15 @@ bool Connector::ReadSingleMessage(MojoResult* read_result) {
 }
 
 void Connector::ReadAllAvailableMessages() {
+  // A sync watcher calls back again while there are messages left, so only
+  // the asynchronous path needs to keep track of time.
+  bool limit_time = !during_sync_handle_watcher_callback();
+  base::TimeTicks deadline;
+  if (limit_time) {
+    deadline = base::TimeTicks::Now() +
+               base::TimeDelta::FromMilliseconds(kMaxReadTimeMilliseconds);
+  }
+
   while (!error_) {
     MojoResult rv;
 
@@ -302,9 +342,28 @@ void Connector::ReadAllAvailableMessages() {
 
     if (rv == MOJO_RESULT_SHOULD_WAIT)
       break;
+
+    if (limit_time && base::TimeTicks::Now() >= deadline) {
+      // The watcher only calls back when a new message arrives, so read the
+      // rest from a task of our own.
+      task_runner_->PostTask(
+          FROM_HERE,
+          base::Bind(&Connector::ContinueReadingMessages, weak_self_));
+      return;
+    }
   }
 }
 
+void Connector::ContinueReadingMessages() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  // Messages are only read while the pipe is being watched, which it is not
+  // after the pipe was closed or while reading is paused.
+  if (error_ || paused_ || !handle_watcher_.IsWatching())
+    return;
+  ReadAllAvailableMessages();
+}
+
 void Connector::CancelWait() {
   handle_watcher_.Cancel();
   sync_watcher_.reset();
@@ -327,6 +386,7 @@ void Connector::HandleError(bool force_pipe_reset, bool force_async_handler) {
   if (force_pipe_reset) {
     CancelWait();
     MayAutoLock locker(lock_.get());
+    outgoing_messages_.clear();
     message_pipe_.reset();
     MessagePipe dummy_pipe;
     message_pipe_ = std::move(dummy_pipe.handle0);
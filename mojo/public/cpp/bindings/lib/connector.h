@@ -6,6 +6,7 @@
 #define MOJO_PUBLIC_CPP_BINDINGS_LIB_CONNECTOR_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
@@ -72,6 +73,18 @@ class Connector : public MessageReceiver {
     connection_error_handler_ = error_handler;
   }
 
+  // In batching mode, messages passed to Accept() are queued rather than
+  // written right away, and the queue is written out in one go from a task
+  // posted to |task_runner()|. This lets a burst of messages sent from one task
+  // reach the other end together, so that it is woken up once for all of them.
+  // Sync messages, and any messages queued before them, are still written
+  // immediately, and so is the queue before this connector waits for incoming
+  // messages.
+  void set_batch_outgoing_messages(bool batch) {
+    DCHECK(thread_checker_.CalledOnValidThread());
+    batch_outgoing_messages_ = batch;
+  }
+
   // Returns true if an error was encountered while reading from the pipe or
   // waiting to read from the pipe.
   bool encountered_error() const {
@@ -162,6 +175,18 @@ class Connector : public MessageReceiver {
   // |this| can be destroyed during message dispatch.
   void ReadAllAvailableMessages();
 
+  // Posted by ReadAllAvailableMessages() when it runs out of time, to read
+  // the messages left in the pipe.
+  void ContinueReadingMessages();
+
+  // Writes |message| to |message_pipe_|. Returns false if the message was
+  // rejected.
+  bool WriteMessageNoLock(ScopedMessageHandle message);
+
+  // Writes the messages queued in batching mode.
+  void FlushOutgoingMessages();
+  void FlushOutgoingMessagesNoLock();
+
   // If |force_pipe_reset| is true, this method replaces the existing
   // |message_pipe_| with a dummy message pipe handle (whose peer is closed).
   // If |force_async_handler| is true, |connection_error_handler_| is called
@@ -188,9 +213,14 @@ class Connector : public MessageReceiver {
   bool paused_;
 
   // If sending messages is allowed from multiple threads, |lock_| is used to
-  // protect modifications to |message_pipe_| and |drop_writes_|.
+  // protect modifications to |message_pipe_|, |drop_writes_| and
+  // |outgoing_messages_|.
   std::unique_ptr<base::Lock> lock_;
 
+  bool batch_outgoing_messages_;
+  // Messages waiting for the task posted by Accept() in batching mode.
+  std::vector<ScopedMessageHandle> outgoing_messages_;
+
   std::unique_ptr<SyncHandleWatcher> sync_watcher_;
   bool allow_woken_up_by_others_;
   // If non-zero, currently the control flow is inside the sync handle watcher
@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
@@ -32,8 +33,27 @@ void Message::InitializeFromMojoMessage(ScopedMessageHandle message,
                                         uint32_t num_bytes,
                                         std::vector<Handle>* handles) {
   DCHECK(!buffer_);
-  buffer_.reset(new internal::MessageBuffer(std::move(message), num_bytes));
   handles_.swap(*handles);
+
+  if (num_bytes == sizeof(internal::PromotedMessageHeader) &&
+      !handles_.empty()) {
+    void* data = nullptr;
+    MojoResult rv = GetMessageBuffer(message.get(), &data);
+    CHECK_EQ(rv, MOJO_RESULT_OK);
+    internal::PromotedMessageHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.num_bytes == sizeof(header)) {
+      ScopedSharedBufferHandle shared_buffer(
+          SharedBufferHandle(handles_.back().value()));
+      handles_.pop_back();
+      buffer_.reset(new internal::MessageBuffer(
+          std::move(message), std::move(shared_buffer),
+          header.data_num_bytes));
+      return;
+    }
+  }
+
+  buffer_.reset(new internal::MessageBuffer(std::move(message), num_bytes));
 }
 
 void Message::MoveTo(Message* destination) {
@@ -49,6 +69,9 @@ void Message::MoveTo(Message* destination) {
 }
 
 ScopedMessageHandle Message::TakeMojoMessage() {
+  if (buffer_->is_promoted())
+    return TakePromotedMojoMessage();
+
   if (handles_.empty())  // Fast path for the common case: No handles.
     return buffer_->TakeMessage();
 
@@ -79,6 +102,31 @@ ScopedMessageHandle Message::TakeMojoMessage() {
   return new_message;
 }
 
+ScopedMessageHandle Message::TakePromotedMojoMessage() {
+  internal::PromotedMessageHeader header;
+  header.num_bytes = sizeof(header);
+  header.version = 0;
+  header.data_num_bytes = data_num_bytes();
+  header.padding = 0;
+
+  handles_.push_back(buffer_->TakeSharedBuffer().release());
+  ScopedMessageHandle new_message;
+  MojoResult rv = AllocMessage(
+      sizeof(header), reinterpret_cast<const MojoHandle*>(handles_.data()),
+      handles_.size(), MOJO_ALLOC_MESSAGE_FLAG_NONE, &new_message);
+  CHECK_EQ(rv, MOJO_RESULT_OK);
+  handles_.clear();
+
+  void* new_buffer = nullptr;
+  rv = GetMessageBuffer(new_message.get(), &new_buffer);
+  CHECK_EQ(rv, MOJO_RESULT_OK);
+
+  memcpy(new_buffer, &header, sizeof(header));
+  buffer_.reset();
+
+  return new_message;
+}
+
 void Message::NotifyBadMessage(const std::string& error) {
   buffer_->NotifyBadMessage(error);
 }
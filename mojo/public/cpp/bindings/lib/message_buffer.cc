@@ -4,6 +4,8 @@
 
 #include "mojo/public/cpp/bindings/lib/message_buffer.h"
 
+#include <string.h>
+
 #include <limits>
 
 #include "mojo/public/cpp/bindings/lib/serialization_util.h"
@@ -11,10 +13,26 @@
 namespace mojo {
 namespace internal {
 
+// static
+const size_t MessageBuffer::kMinPromotedMessageSize;
+
 MessageBuffer::MessageBuffer(size_t capacity, bool zero_initialized) {
   DCHECK_LE(capacity, std::numeric_limits<uint32_t>::max());
   data_num_bytes_ = static_cast<uint32_t>(capacity);
 
+  if (capacity >= kMinPromotedMessageSize) {
+    // New shared buffers are zero-initialized. If one cannot be created, the
+    // message is sent the usual way.
+    shared_buffer_ = SharedBufferHandle::Create(capacity);
+    if (shared_buffer_.is_valid())
+      mapping_ = shared_buffer_->Map(capacity);
+    if (mapping_) {
+      buffer_ = mapping_.get();
+      return;
+    }
+    shared_buffer_.reset();
+  }
+
   MojoResult rv = AllocMessage(capacity, nullptr, 0,
                                MOJO_ALLOC_MESSAGE_FLAG_NONE, &message_);
   CHECK_EQ(rv, MOJO_RESULT_OK);
@@ -42,8 +60,31 @@ MessageBuffer::MessageBuffer(ScopedMessageHandle message, uint32_t num_bytes) {
   }
 }
 
+MessageBuffer::MessageBuffer(ScopedMessageHandle message,
+                             ScopedSharedBufferHandle shared_buffer,
+                             uint32_t num_bytes)
+    : message_(std::move(message)), buffer_(nullptr) {
+  ScopedSharedBufferMapping mapping = shared_buffer->Map(num_bytes);
+  if (!mapping)
+    return;
+
+  // The sender may still be able to write to the shared buffer, so the bytes
+  // are copied out before they are validated.
+  received_data_.reset(new uint64_t[(num_bytes + 7) / 8]);
+  memcpy(received_data_.get(), mapping.get(), num_bytes);
+  buffer_ = received_data_.get();
+  data_num_bytes_ = num_bytes;
+}
+
 MessageBuffer::~MessageBuffer() {}
 
+ScopedSharedBufferHandle MessageBuffer::TakeSharedBuffer() {
+  DCHECK(is_promoted());
+  mapping_.reset();
+  buffer_ = nullptr;
+  return std::move(shared_buffer_);
+}
+
 void* MessageBuffer::Allocate(size_t delta) {
   delta = internal::Align(delta);
 
@@ -8,24 +8,40 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
 #include <utility>
 
 #include "base/macros.h"
 #include "mojo/public/cpp/bindings/lib/buffer.h"
+#include "mojo/public/cpp/system/buffer.h"
 #include "mojo/public/cpp/system/message.h"
 
 namespace mojo {
 namespace internal {
 
 // A fixed-size Buffer implementation using a Mojo message object for storage.
+//
+// Large messages are "promoted": they are serialized into a shared buffer
+// instead, so that their bytes do not have to be copied through the message
+// pipe. See PromotedMessageHeader.
 class MessageBuffer : public Buffer {
  public:
+  // Messages of at least this many bytes are promoted.
+  static const size_t kMinPromotedMessageSize = 64 * 1024;
+
   // Initializes this buffer to carry a fixed byte capacity and no handles.
   MessageBuffer(size_t capacity, bool zero_initialized);
 
   // Initializes this buffer from an existing Mojo MessageHandle.
   MessageBuffer(ScopedMessageHandle message, uint32_t num_bytes);
 
+  // Initializes this buffer from a received promoted message, whose bytes are
+  // |num_bytes| of |shared_buffer|. If they cannot be mapped, the buffer is
+  // left empty, which fails validation.
+  MessageBuffer(ScopedMessageHandle message,
+                ScopedSharedBufferHandle shared_buffer,
+                uint32_t num_bytes);
+
   ~MessageBuffer() override;
 
   void* data() const { return buffer_; }
@@ -34,8 +50,16 @@ class MessageBuffer : public Buffer {
   // Buffer:
   void* Allocate(size_t delta) override;
 
+  // Whether the bytes are in a shared buffer rather than in a Mojo message
+  // object. TakeMessage() may not be used if so.
+  bool is_promoted() const { return shared_buffer_.is_valid(); }
+
   ScopedMessageHandle TakeMessage() { return std::move(message_); }
 
+  // Unmaps the shared buffer of a promoted message and returns it, to be sent
+  // along with a PromotedMessageHeader.
+  ScopedSharedBufferHandle TakeSharedBuffer();
+
   void NotifyBadMessage(const std::string& error);
 
  private:
@@ -43,6 +67,13 @@ class MessageBuffer : public Buffer {
   ScopedMessageHandle message_;
   void* buffer_;
 
+  // Set for a promoted message being built.
+  ScopedSharedBufferHandle shared_buffer_;
+  ScopedSharedBufferMapping mapping_;
+
+  // Set for a promoted message received.
+  std::unique_ptr<uint64_t[]> received_data_;
+
   uint32_t bytes_claimed_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(MessageBuffer);
@@ -41,6 +41,19 @@ struct MessageHeaderWithRequestID : MessageHeader {
 static_assert(sizeof(MessageHeaderWithRequestID) == 32,
               "Bad sizeof(MessageHeaderWithRequestID)");
 
+// Sent in place of the bytes of a large message, which were serialized into a
+// shared buffer instead. The shared buffer is attached as the last handle. The
+// |num_bytes| of the struct header is too small for a MessageHeader, which
+// tells the two apart.
+struct PromotedMessageHeader : internal::StructHeader {
+  // The number of bytes of the message in the shared buffer.
+  uint32_t data_num_bytes;
+  // Unused padding to make the struct size a multiple of 8 bytes.
+  uint32_t padding;
+};
+static_assert(sizeof(PromotedMessageHeader) == 16,
+              "Bad sizeof(PromotedMessageHeader)");
+
 #pragma pack(pop)
 
 }  // namespace internal
@@ -56,10 +56,21 @@ class MultiplexRouter
       public base::RefCountedDeleteOnMessageLoop<MultiplexRouter>,
       public PipeControlMessageHandlerDelegate {
  public:
+  enum Config {
+    // All endpoints are created, attached, detached and closed on the thread
+    // that creates the router, and their clients run on that thread too. The
+    // router then doesn't lock at all; the methods below that are otherwise
+    // safe to call from any threads must only be called on that thread.
+    SINGLE_THREADED_ENDPOINTS,
+    // Endpoints may be used and bound on any threads.
+    MULTI_THREADED_ENDPOINTS
+  };
+
   // If |set_interface_id_namespace_bit| is true, the interface IDs generated by
   // this router will have the highest bit set.
   MultiplexRouter(bool set_interface_id_namespace_bit,
                   ScopedMessagePipeHandle message_pipe,
+                  Config config,
                   scoped_refptr<base::SingleThreadTaskRunner> runner);
 
   // Sets the master interface name for this router. Only used when reporting
@@ -67,7 +78,8 @@ class MultiplexRouter
   void SetMasterInterfaceName(const std::string& name);
 
   // ---------------------------------------------------------------------------
-  // The following public methods are safe to call from any threads.
+  // The following public methods are safe to call from any threads, unless the
+  // router was created with SINGLE_THREADED_ENDPOINTS.
 
   // Creates a pair of interface endpoint handles. The method generates a new
   // interface ID and assigns it to the two handles. |local_endpoint| is used
@@ -228,6 +240,10 @@ class MultiplexRouter
   void UpdateEndpointStateMayRemove(InterfaceEndpoint* endpoint,
                                     EndpointStateUpdateType type);
 
+  // Checks that |lock_| is held, or that we are on the router's thread if
+  // there is no lock.
+  void AssertLockAcquired() const;
+
   void RaiseErrorInNonTestingMode();
 
   InterfaceEndpoint* FindOrInsertEndpoint(InterfaceId id, bool* inserted);
@@ -241,8 +257,10 @@ class MultiplexRouter
 
   base::ThreadChecker thread_checker_;
 
-  // Protects the following members.
-  mutable base::Lock lock_;
+  // Protects the following members. It is null for
+  // SINGLE_THREADED_ENDPOINTS, in which case they are only accessed on the
+  // router's thread.
+  std::unique_ptr<base::Lock> lock_;
   PipeControlMessageHandler control_message_handler_;
   PipeControlMessageProxy control_message_proxy_;
 
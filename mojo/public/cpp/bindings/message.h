@@ -107,6 +107,10 @@ class Message {
  private:
   void CloseHandles();
 
+  // Sends the bytes of a promoted message as a shared buffer. See
+  // internal::PromotedMessageHeader.
+  ScopedMessageHandle TakePromotedMojoMessage();
+
   std::unique_ptr<internal::MessageBuffer> buffer_;
   std::vector<Handle> handles_;
 
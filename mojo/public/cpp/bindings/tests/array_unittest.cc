@@ -4,6 +4,10 @@
 
 #include "mojo/public/cpp/bindings/array.h"
 
+#include <string>
+
+#include "mojo/public/cpp/bindings/array_data_view.h"
+#include "mojo/public/cpp/bindings/lib/fixed_buffer.h"
 #include "mojo/public/cpp/bindings/lib/serialization.h"
 #include "mojo/public/cpp/bindings/tests/array_common_test.h"
 #include "mojo/public/cpp/bindings/tests/container_test_util.h"
@@ -126,6 +130,107 @@ TEST_F(ArrayTest, MoveFromAndToSTLVector_MoveOnly) {
   ASSERT_TRUE(arr.is_null());
 }
 
+TEST_F(ArrayTest, DataView_ArrayOfPOD) {
+  Array<int32_t> array(4);
+  for (size_t i = 0; i < array.size(); ++i)
+    array[i] = static_cast<int32_t>(i * 3);
+
+  size_t size =
+      mojo::internal::PrepareToSerialize<Array<int32_t>>(array, nullptr);
+  mojo::internal::FixedBufferForTesting buf(size);
+  mojo::internal::Array_Data<int32_t>* data;
+  mojo::internal::ContainerValidateParams validate_params(0, false, nullptr);
+  mojo::internal::Serialize<Array<int32_t>>(array, &buf, &data,
+                                            &validate_params, nullptr);
+
+  ArrayDataView<int32_t> view(data, nullptr);
+  ASSERT_FALSE(view.is_null());
+  ASSERT_EQ(4u, view.size());
+  for (size_t i = 0; i < view.size(); ++i) {
+    EXPECT_EQ(static_cast<int32_t>(i * 3), view[i]);
+    EXPECT_EQ(static_cast<int32_t>(i * 3), view.data()[i]);
+  }
+
+  EXPECT_TRUE(ArrayDataView<int32_t>().is_null());
+}
+
+TEST_F(ArrayTest, DataView_ArrayOfBool) {
+  Array<bool> array(10);
+  for (size_t i = 0; i < array.size(); ++i)
+    array[i] = i % 3 == 0;
+
+  size_t size = mojo::internal::PrepareToSerialize<Array<bool>>(array, nullptr);
+  mojo::internal::FixedBufferForTesting buf(size);
+  mojo::internal::Array_Data<bool>* data;
+  mojo::internal::ContainerValidateParams validate_params(0, false, nullptr);
+  mojo::internal::Serialize<Array<bool>>(array, &buf, &data, &validate_params,
+                                         nullptr);
+
+  ArrayDataView<bool> view(data, nullptr);
+  ASSERT_EQ(10u, view.size());
+  for (size_t i = 0; i < view.size(); ++i)
+    EXPECT_EQ(i % 3 == 0, view[i]);
+}
+
+TEST_F(ArrayTest, DataView_ArrayOfArrayOfPOD) {
+  Array<Array<int32_t>> array(2);
+  array[0] = Array<int32_t>(3);
+  array[0][2] = 42;
+  array[1] = nullptr;
+
+  size_t size = mojo::internal::PrepareToSerialize<Array<Array<int32_t>>>(
+      array, nullptr);
+  mojo::internal::FixedBufferForTesting buf(size);
+  mojo::internal::Array_Data<mojo::internal::Array_Data<int32_t>*>* data;
+  mojo::internal::ContainerValidateParams validate_params(
+      0, true, new mojo::internal::ContainerValidateParams(0, false, nullptr));
+  mojo::internal::Serialize<Array<Array<int32_t>>>(array, &buf, &data,
+                                                   &validate_params, nullptr);
+
+  ArrayDataView<Array<int32_t>> view(data, nullptr);
+  ASSERT_EQ(2u, view.size());
+  EXPECT_FALSE(view.IsNull(0));
+  EXPECT_TRUE(view.IsNull(1));
+
+  ArrayDataView<int32_t> inner;
+  view.GetDataView(0, &inner);
+  ASSERT_EQ(3u, inner.size());
+  EXPECT_EQ(42, inner[2]);
+  view.GetDataView(1, &inner);
+  EXPECT_TRUE(inner.is_null());
+
+  std::vector<int32_t> copy;
+  ASSERT_TRUE(view.Read(0, &copy));
+  EXPECT_EQ(std::vector<int32_t>({0, 0, 42}), copy);
+}
+
+TEST_F(ArrayTest, DataView_ArrayOfString) {
+  Array<String> array(2);
+  array[0] = "hello";
+  array[1] = nullptr;
+
+  size_t size =
+      mojo::internal::PrepareToSerialize<Array<String>>(array, nullptr);
+  mojo::internal::FixedBufferForTesting buf(size);
+  mojo::internal::Array_Data<mojo::internal::String_Data*>* data;
+  mojo::internal::ContainerValidateParams validate_params(
+      0, true, new mojo::internal::ContainerValidateParams(0, false, nullptr));
+  mojo::internal::Serialize<Array<String>>(array, &buf, &data,
+                                           &validate_params, nullptr);
+
+  ArrayDataView<String> view(data, nullptr);
+  ASSERT_EQ(2u, view.size());
+  ASSERT_FALSE(view.IsNull(0));
+  EXPECT_TRUE(view.IsNull(1));
+
+  StringDataView string_view = view.GetStringDataView(0);
+  EXPECT_EQ("hello", std::string(string_view.storage(), string_view.size()));
+
+  std::string copy;
+  ASSERT_TRUE(view.Read(0, &copy));
+  EXPECT_EQ("hello", copy);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace mojo
@@ -135,9 +135,12 @@ TEST_F(AssociatedInterfaceTest, InterfacesAtBothEnds) {
 
   MessagePipe pipe;
   scoped_refptr<MultiplexRouter> router0(new MultiplexRouter(
-      true, std::move(pipe.handle0), base::ThreadTaskRunnerHandle::Get()));
+      true, std::move(pipe.handle0), MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
   scoped_refptr<MultiplexRouter> router1(new MultiplexRouter(
-      false, std::move(pipe.handle1), base::ThreadTaskRunnerHandle::Get()));
+      false, std::move(pipe.handle1),
+      MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
 
   AssociatedInterfaceRequest<IntegerSender> request;
   IntegerSenderAssociatedPtrInfo ptr_info;
@@ -341,9 +344,12 @@ TEST_F(AssociatedInterfaceTest, MultiThreadAccess) {
   const int32_t kMaxValue = 1000;
   MessagePipe pipe;
   scoped_refptr<MultiplexRouter> router0(new MultiplexRouter(
-      true, std::move(pipe.handle0), base::ThreadTaskRunnerHandle::Get()));
+      true, std::move(pipe.handle0), MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
   scoped_refptr<MultiplexRouter> router1(new MultiplexRouter(
-      false, std::move(pipe.handle1), base::ThreadTaskRunnerHandle::Get()));
+      false, std::move(pipe.handle1),
+      MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
 
   AssociatedInterfaceRequest<IntegerSender> requests[4];
   IntegerSenderAssociatedPtrInfo ptr_infos[4];
@@ -430,9 +436,12 @@ TEST_F(AssociatedInterfaceTest, FIFO) {
   const int32_t kMaxValue = 100;
   MessagePipe pipe;
   scoped_refptr<MultiplexRouter> router0(new MultiplexRouter(
-      true, std::move(pipe.handle0), base::ThreadTaskRunnerHandle::Get()));
+      true, std::move(pipe.handle0), MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
   scoped_refptr<MultiplexRouter> router1(new MultiplexRouter(
-      false, std::move(pipe.handle1), base::ThreadTaskRunnerHandle::Get()));
+      false, std::move(pipe.handle1),
+      MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+      base::ThreadTaskRunnerHandle::Get()));
 
   AssociatedInterfaceRequest<IntegerSender> requests[4];
   IntegerSenderAssociatedPtrInfo ptr_infos[4];
@@ -3,11 +3,19 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "base/memory/ptr_util.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "mojo/public/cpp/bindings/binding.h"
+#include "mojo/public/cpp/bindings/lib/interface_endpoint_client.h"
+#include "mojo/public/cpp/bindings/lib/message_builder.h"
+#include "mojo/public/cpp/bindings/lib/multiplex_router.h"
+#include "mojo/public/cpp/bindings/message_filter.h"
 #include "mojo/public/cpp/test_support/test_support.h"
 #include "mojo/public/cpp/test_support/test_utils.h"
 #include "mojo/public/interfaces/bindings/tests/ping_service.mojom.h"
@@ -89,6 +97,130 @@ struct BoundPingService {
   Binding<test::PingService> binding;
 };
 
+using internal::InterfaceEndpointClient;
+using internal::MultiplexRouter;
+
+void SendEmptyMessage(InterfaceEndpointClient* client) {
+  internal::MessageBuilder builder(0, 0);
+  Message message;
+  builder.message()->MoveTo(&message);
+  client->Accept(&message);
+}
+
+// Sends every message it receives back to where it came from.
+class Ponger : public MessageReceiverWithResponderStatus {
+ public:
+  Ponger() : client_(nullptr) {}
+
+  void set_client(InterfaceEndpointClient* client) { client_ = client; }
+
+  // MessageReceiverWithResponderStatus:
+  bool Accept(Message* message) override {
+    SendEmptyMessage(client_);
+    return true;
+  }
+  bool AcceptWithResponder(Message* message,
+                           MessageReceiverWithStatus* responder) override {
+    NOTREACHED();
+    return false;
+  }
+
+ private:
+  InterfaceEndpointClient* client_;
+
+  DISALLOW_COPY_AND_ASSIGN(Ponger);
+};
+
+// Sends a message over each of its endpoints in turn, each time the previous
+// one comes back.
+class Pinger : public MessageReceiverWithResponderStatus {
+ public:
+  Pinger() : iterations_to_run_(0), current_iterations_(0) {}
+
+  void AddClient(InterfaceEndpointClient* client) {
+    clients_.push_back(client);
+  }
+
+  void Run(unsigned int iterations) {
+    iterations_to_run_ = iterations;
+    current_iterations_ = 0;
+
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    SendEmptyMessage(clients_[0]);
+    run_loop.Run();
+  }
+
+  // MessageReceiverWithResponderStatus:
+  bool Accept(Message* message) override {
+    current_iterations_++;
+    if (current_iterations_ >= iterations_to_run_) {
+      quit_closure_.Run();
+      return true;
+    }
+    SendEmptyMessage(clients_[current_iterations_ % clients_.size()]);
+    return true;
+  }
+  bool AcceptWithResponder(Message* message,
+                           MessageReceiverWithStatus* responder) override {
+    NOTREACHED();
+    return false;
+  }
+
+ private:
+  std::vector<InterfaceEndpointClient*> clients_;
+  unsigned int iterations_to_run_;
+  unsigned int current_iterations_;
+  base::Closure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(Pinger);
+};
+
+// Ping-pongs over |num_endpoints| associated endpoints of a pair of routers
+// created with |config|.
+void RunMultiplexRouterPingPong(MultiplexRouter::Config config,
+                                const char* sub_test_name,
+                                size_t num_endpoints) {
+  MessagePipe pipe;
+  scoped_refptr<MultiplexRouter> router0(
+      new MultiplexRouter(true, std::move(pipe.handle0), config,
+                          base::ThreadTaskRunnerHandle::Get()));
+  scoped_refptr<MultiplexRouter> router1(
+      new MultiplexRouter(false, std::move(pipe.handle1), config,
+                          base::ThreadTaskRunnerHandle::Get()));
+
+  Pinger pinger;
+  std::vector<std::unique_ptr<Ponger>> pongers;
+  std::vector<std::unique_ptr<InterfaceEndpointClient>> clients;
+  for (size_t i = 0; i < num_endpoints; ++i) {
+    ScopedInterfaceEndpointHandle handle0;
+    ScopedInterfaceEndpointHandle handle1;
+    router0->CreateEndpointHandlePair(&handle0, &handle1);
+    handle1 = router1->CreateLocalEndpointHandle(handle1.release());
+
+    clients.push_back(base::MakeUnique<InterfaceEndpointClient>(
+        std::move(handle0), &pinger, base::WrapUnique(new PassThroughFilter()),
+        false, base::ThreadTaskRunnerHandle::Get()));
+    pinger.AddClient(clients.back().get());
+
+    pongers.push_back(base::MakeUnique<Ponger>());
+    clients.push_back(base::MakeUnique<InterfaceEndpointClient>(
+        std::move(handle1), pongers.back().get(),
+        base::WrapUnique(new PassThroughFilter()), false,
+        base::ThreadTaskRunnerHandle::Get()));
+    pongers.back()->set_client(clients.back().get());
+  }
+
+  const unsigned int kIterations = 100000;
+  const MojoTimeTicks start_time = MojoGetTimeTicksNow();
+  pinger.Run(kIterations);
+  const MojoTimeTicks end_time = MojoGetTimeTicksNow();
+  test::LogPerfResult(
+      "MultiplexRouterPingPong", sub_test_name,
+      kIterations / MojoTicksToSeconds(end_time - start_time),
+      "pings/second");
+}
+
 class MojoBindingsPerftest : public testing::Test {
  public:
   MojoBindingsPerftest() {}
@@ -132,5 +264,12 @@ TEST_F(MojoBindingsPerftest, InProcessPingPong) {
   }
 }
 
+TEST_F(MojoBindingsPerftest, MultiplexRouterPingPong) {
+  RunMultiplexRouterPingPong(MultiplexRouter::SINGLE_THREADED_ENDPOINTS,
+                             "SingleThreaded_10_Endpoints", 10);
+  RunMultiplexRouterPingPong(MultiplexRouter::MULTI_THREADED_ENDPOINTS,
+                             "MultiThreaded_10_Endpoints", 10);
+}
+
 }  // namespace
 }  // namespace mojo
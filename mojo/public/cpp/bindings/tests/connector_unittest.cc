@@ -12,6 +12,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "mojo/public/cpp/bindings/lib/message_buffer.h"
 #include "mojo/public/cpp/bindings/lib/message_builder.h"
 #include "mojo/public/cpp/bindings/tests/message_queue.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -375,6 +376,48 @@ TEST_F(ConnectorTest, MessageWithHandles) {
       std::string(reinterpret_cast<const char*>(message_received.payload())));
 }
 
+TEST_F(ConnectorTest, LargeMessageWithHandles) {
+  internal::Connector connector0(std::move(handle0_),
+                                 internal::Connector::SINGLE_THREADED_SEND,
+                                 base::ThreadTaskRunnerHandle::Get());
+  internal::Connector connector1(std::move(handle1_),
+                                 internal::Connector::SINGLE_THREADED_SEND,
+                                 base::ThreadTaskRunnerHandle::Get());
+
+  // Large enough to be sent through a shared buffer.
+  std::string text(internal::MessageBuffer::kMinPromotedMessageSize, 'x');
+  text.back() = 'y';
+
+  Message message;
+  AllocMessage(text.c_str(), &message);
+
+  MessagePipe pipe;
+  message.mutable_handles()->push_back(pipe.handle0.release());
+
+  connector0.Accept(&message);
+  EXPECT_TRUE(message.handles()->empty());
+
+  base::RunLoop run_loop;
+  MessageAccumulator accumulator(run_loop.QuitClosure());
+  connector1.set_incoming_receiver(&accumulator);
+
+  run_loop.Run();
+
+  ASSERT_FALSE(accumulator.IsEmpty());
+
+  Message message_received;
+  accumulator.Pop(&message_received);
+
+  EXPECT_EQ(1u, message_received.name());
+  EXPECT_EQ(text, std::string(reinterpret_cast<const char*>(
+                      message_received.payload())));
+  // The shared buffer is not among the handles of the message.
+  ASSERT_EQ(1U, message_received.handles()->size());
+  EXPECT_EQ(MOJO_RESULT_OK,
+            MojoWait(message_received.handles()->front().value(),
+                     MOJO_HANDLE_SIGNAL_WRITABLE, 0, nullptr));
+}
+
 TEST_F(ConnectorTest, WaitForIncomingMessageWithError) {
   internal::Connector connector0(std::move(handle0_),
                                  internal::Connector::SINGLE_THREADED_SEND,
@@ -585,6 +628,88 @@ TEST_F(ConnectorTest, ProcessWhenNested) {
   ASSERT_EQ(2u, accumulator.size());
 }
 
+TEST_F(ConnectorTest, BatchOutgoingMessages) {
+  internal::Connector connector0(std::move(handle0_),
+                                 internal::Connector::SINGLE_THREADED_SEND,
+                                 base::ThreadTaskRunnerHandle::Get());
+  connector0.set_batch_outgoing_messages(true);
+
+  const char* kText[] = {"hello", "batched", "world"};
+
+  for (size_t i = 0; i < arraysize(kText); ++i) {
+    Message message;
+    AllocMessage(kText[i], &message);
+    EXPECT_TRUE(connector0.Accept(&message));
+  }
+
+  // Nothing is written until the current task is done.
+  EXPECT_EQ(MOJO_RESULT_DEADLINE_EXCEEDED,
+            Wait(handle1_.get(), MOJO_HANDLE_SIGNAL_READABLE, 0, nullptr));
+
+  base::RunLoop().RunUntilIdle();
+
+  for (size_t i = 0; i < arraysize(kText); ++i) {
+    Message message_received;
+    ASSERT_EQ(MOJO_RESULT_OK, ReadMessage(handle1_.get(), &message_received));
+    EXPECT_EQ(
+        std::string(kText[i]),
+        std::string(reinterpret_cast<const char*>(message_received.payload())));
+  }
+}
+
+TEST_F(ConnectorTest, BatchOutgoingMessages_SyncMessageFlushes) {
+  internal::Connector connector0(std::move(handle0_),
+                                 internal::Connector::SINGLE_THREADED_SEND,
+                                 base::ThreadTaskRunnerHandle::Get());
+  connector0.set_batch_outgoing_messages(true);
+
+  const char kText[] = "hello";
+  Message message;
+  AllocMessage(kText, &message);
+  EXPECT_TRUE(connector0.Accept(&message));
+
+  const char kSyncText[] = "sync";
+  internal::MessageWithRequestIDBuilder builder(1, sizeof(kSyncText),
+                                                internal::kMessageIsSync, 0);
+  memcpy(builder.buffer()->Allocate(sizeof(kSyncText)), kSyncText,
+         sizeof(kSyncText));
+  Message sync_message;
+  builder.message()->MoveTo(&sync_message);
+  EXPECT_TRUE(connector0.Accept(&sync_message));
+
+  // The sync message is written right away, after the queued one.
+  Message message_received;
+  ASSERT_EQ(MOJO_RESULT_OK, ReadMessage(handle1_.get(), &message_received));
+  EXPECT_EQ(
+      std::string(kText),
+      std::string(reinterpret_cast<const char*>(message_received.payload())));
+  Message sync_message_received;
+  ASSERT_EQ(MOJO_RESULT_OK,
+            ReadMessage(handle1_.get(), &sync_message_received));
+  EXPECT_EQ(std::string(kSyncText),
+            std::string(reinterpret_cast<const char*>(
+                sync_message_received.payload())));
+}
+
+TEST_F(ConnectorTest, BatchOutgoingMessages_FlushedOnClose) {
+  internal::Connector connector0(std::move(handle0_),
+                                 internal::Connector::SINGLE_THREADED_SEND,
+                                 base::ThreadTaskRunnerHandle::Get());
+  connector0.set_batch_outgoing_messages(true);
+
+  const char kText[] = "hello";
+  Message message;
+  AllocMessage(kText, &message);
+  EXPECT_TRUE(connector0.Accept(&message));
+  connector0.CloseMessagePipe();
+
+  Message message_received;
+  ASSERT_EQ(MOJO_RESULT_OK, ReadMessage(handle1_.get(), &message_received));
+  EXPECT_EQ(
+      std::string(kText),
+      std::string(reinterpret_cast<const char*>(message_received.payload())));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace mojo
@@ -26,15 +26,17 @@ namespace {
 using mojo::internal::InterfaceEndpointClient;
 using mojo::internal::MultiplexRouter;
 
-class MultiplexRouterTest : public testing::Test {
+// The parameter is the router configuration under test.
+class MultiplexRouterTest
+    : public testing::TestWithParam<MultiplexRouter::Config> {
  public:
   MultiplexRouterTest() {}
 
   void SetUp() override {
     MessagePipe pipe;
-    router0_ = new MultiplexRouter(true, std::move(pipe.handle0),
+    router0_ = new MultiplexRouter(true, std::move(pipe.handle0), GetParam(),
                                    base::ThreadTaskRunnerHandle::Get());
-    router1_ = new MultiplexRouter(true, std::move(pipe.handle1),
+    router1_ = new MultiplexRouter(true, std::move(pipe.handle1), GetParam(),
                                    base::ThreadTaskRunnerHandle::Get());
     router0_->CreateEndpointHandlePair(&endpoint0_, &endpoint1_);
     endpoint1_ =
@@ -63,7 +65,7 @@ class MultiplexRouterTest : public testing::Test {
   base::MessageLoop loop_;
 };
 
-TEST_F(MultiplexRouterTest, BasicRequestResponse) {
+TEST_P(MultiplexRouterTest, BasicRequestResponse) {
   InterfaceEndpointClient client0(std::move(endpoint0_), nullptr,
                                   base::WrapUnique(new PassThroughFilter()),
                                   false, base::ThreadTaskRunnerHandle::Get());
@@ -110,7 +112,7 @@ TEST_F(MultiplexRouterTest, BasicRequestResponse) {
             std::string(reinterpret_cast<const char*>(response.payload())));
 }
 
-TEST_F(MultiplexRouterTest, BasicRequestResponse_Synchronous) {
+TEST_P(MultiplexRouterTest, BasicRequestResponse_Synchronous) {
   InterfaceEndpointClient client0(std::move(endpoint0_), nullptr,
                                   base::WrapUnique(new PassThroughFilter()),
                                   false, base::ThreadTaskRunnerHandle::Get());
@@ -154,7 +156,7 @@ TEST_F(MultiplexRouterTest, BasicRequestResponse_Synchronous) {
             std::string(reinterpret_cast<const char*>(response.payload())));
 }
 
-TEST_F(MultiplexRouterTest, RequestWithNoReceiver) {
+TEST_P(MultiplexRouterTest, RequestWithNoReceiver) {
   InterfaceEndpointClient client0(std::move(endpoint0_), nullptr,
                                   base::WrapUnique(new PassThroughFilter()),
                                   false, base::ThreadTaskRunnerHandle::Get());
@@ -185,7 +187,7 @@ TEST_F(MultiplexRouterTest, RequestWithNoReceiver) {
 
 // Tests MultiplexRouter using the LazyResponseGenerator. The responses will not
 // be sent until after the requests have been accepted.
-TEST_F(MultiplexRouterTest, LazyResponses) {
+TEST_P(MultiplexRouterTest, LazyResponses) {
   InterfaceEndpointClient client0(std::move(endpoint0_), nullptr,
                                   base::WrapUnique(new PassThroughFilter()),
                                   false, base::ThreadTaskRunnerHandle::Get());
@@ -250,7 +252,7 @@ TEST_F(MultiplexRouterTest, LazyResponses) {
 // Tests that if the receiving application destroys the responder_ without
 // sending a response, then we trigger connection error at both sides. Moreover,
 // both sides still appear to have a valid message pipe handle bound.
-TEST_F(MultiplexRouterTest, MissingResponses) {
+TEST_P(MultiplexRouterTest, MissingResponses) {
   base::RunLoop run_loop0, run_loop1;
   InterfaceEndpointClient client0(std::move(endpoint0_), nullptr,
                                   base::WrapUnique(new PassThroughFilter()),
@@ -305,7 +307,7 @@ TEST_F(MultiplexRouterTest, MissingResponses) {
   EXPECT_TRUE(router1_->is_valid());
 }
 
-TEST_F(MultiplexRouterTest, LateResponse) {
+TEST_P(MultiplexRouterTest, LateResponse) {
   // Test that things won't blow up if we try to send a message to a
   // MessageReceiver, which was given to us via AcceptWithResponder,
   // after the router has gone away.
@@ -338,6 +340,12 @@ TEST_F(MultiplexRouterTest, LateResponse) {
 
 // TODO(yzshen): add more tests.
 
+INSTANTIATE_TEST_CASE_P(
+    MultiplexRouterTest,
+    MultiplexRouterTest,
+    testing::Values(MultiplexRouter::SINGLE_THREADED_ENDPOINTS,
+                    MultiplexRouter::MULTI_THREADED_ENDPOINTS));
+
 }  // namespace
 }  // namespace test
 }  // namespace mojo
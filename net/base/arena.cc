@@ -19,12 +19,36 @@ UnsafeArena::~UnsafeArena() {}
 UnsafeArena::UnsafeArena(UnsafeArena&& other) = default;
 UnsafeArena& UnsafeArena::operator=(UnsafeArena&& other) = default;
 
-char* UnsafeArena::Memdup(const char* data, size_t size) {
+char* UnsafeArena::Alloc(size_t size) {
   Reserve(size);
   Block& b = blocks_.back();
   DCHECK_GE(b.size, b.used + size);
   char* out = b.data.get() + b.used;
   b.used += size;
+  return out;
+}
+
+char* UnsafeArena::Realloc(char* original, size_t oldsize, size_t newsize) {
+  DCHECK_GE(newsize, oldsize);
+  if (!blocks_.empty()) {
+    Block& last = blocks_.back();
+    // If |original| was the most recent allocation and the final block has
+    // room, it can grow in place.
+    if (original + oldsize == last.data.get() + last.used &&
+        last.used + newsize - oldsize <= last.size) {
+      last.used += newsize - oldsize;
+      return original;
+    }
+  }
+  char* out = Alloc(newsize);
+  if (oldsize > 0) {
+    memcpy(out, original, oldsize);
+  }
+  return out;
+}
+
+char* UnsafeArena::Memdup(const char* data, size_t size) {
+  char* out = Alloc(size);
   memcpy(out, data, size);
   return out;
 }
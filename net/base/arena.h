@@ -29,6 +29,8 @@ class NET_EXPORT_PRIVATE UnsafeArena {
   UnsafeArena(UnsafeArena&& other);
   UnsafeArena& operator=(UnsafeArena&& other);
 
+  char* Alloc(size_t size);
+  char* Realloc(char* original, size_t oldsize, size_t newsize);
   char* Memdup(const char* data, size_t size);
 
   // If |data| and |size| describe the most recent allocation made from this
@@ -89,5 +89,31 @@ TEST(UnsafeArenaTest, Free) {
   EXPECT_EQ(c4, c5);
 }
 
+TEST(UnsafeArenaTest, Realloc) {
+  UnsafeArena arena(kDefaultBlockSize);
+  const size_t length = strlen(kTestString);
+  // The most recent allocation grows in place.
+  char* c1 = arena.Memdup(kTestString, length);
+  char* c2 = arena.Realloc(c1, length, 2 * length);
+  EXPECT_EQ(c1, c2);
+  memcpy(c2 + length, kTestString, length);
+  EXPECT_EQ(std::string(kTestString) + kTestString,
+            StringPiece(c2, 2 * length));
+
+  // An older allocation is copied.
+  char* c3 = arena.Memdup("Foo", 3);
+  char* c4 = arena.Realloc(c2, 2 * length, 3 * length);
+  EXPECT_NE(c2, c4);
+  EXPECT_EQ(std::string(kTestString) + kTestString,
+            StringPiece(c4, 2 * length));
+  EXPECT_EQ("Foo", StringPiece(c3, 3));
+
+  // An allocation that no longer fits in its block is copied.
+  char* c5 = arena.Realloc(c4, 3 * length, kDefaultBlockSize + 1);
+  EXPECT_NE(c4, c5);
+  EXPECT_EQ(std::string(kTestString) + kTestString,
+            StringPiece(c5, 2 * length));
+}
+
 }  // namespace
 }  // namespace net
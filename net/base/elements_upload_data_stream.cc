@@ -101,6 +101,29 @@ void ElementsUploadDataStream::OnInitElementCompleted(size_t index,
     OnInitCompleted(result);
 }
 
+base::PlatformFile ElementsUploadDataStream::GetFileForSendFileInternal(
+    uint64_t* length) {
+  // After a failed read, the rest of the stream is padded by ReadElements().
+  if (read_failed_)
+    return base::kInvalidPlatformFile;
+
+  while (element_index_ < element_readers_.size() &&
+         element_readers_[element_index_]->BytesRemaining() == 0) {
+    ++element_index_;
+  }
+  if (element_index_ == element_readers_.size())
+    return base::kInvalidPlatformFile;
+
+  UploadElementReader* reader = element_readers_[element_index_].get();
+  *length = reader->BytesRemaining();
+  return reader->GetFileForSendFile();
+}
+
+void ElementsUploadDataStream::DidSendFileDataInternal(int bytes) {
+  DCHECK_LT(element_index_, element_readers_.size());
+  element_readers_[element_index_]->DidSendFileData(bytes);
+}
+
 int ElementsUploadDataStream::ReadElements(
     const scoped_refptr<DrainableIOBuffer>& buf) {
   while (!read_failed_ && element_index_ < element_readers_.size()) {
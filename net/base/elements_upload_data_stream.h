@@ -45,6 +45,8 @@ class NET_EXPORT ElementsUploadDataStream : public UploadDataStream {
       const override;
   int InitInternal() override;
   int ReadInternal(IOBuffer* buf, int buf_len) override;
+  base::PlatformFile GetFileForSendFileInternal(uint64_t* length) override;
+  void DidSendFileDataInternal(int bytes) override;
   void ResetInternal() override;
 
   // Runs Init() for all element readers.
@@ -45,6 +45,10 @@ bool FileStream::IsOpen() const {
   return context_->IsOpen();
 }
 
+base::PlatformFile FileStream::GetPlatformFile() const {
+  return context_->GetPlatformFile();
+}
+
 int FileStream::Seek(int64_t offset, const Int64CompletionCallback& callback) {
   if (!IsOpen())
     return ERR_UNEXPECTED;
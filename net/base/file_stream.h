@@ -67,6 +67,12 @@ class NET_EXPORT FileStream {
   // Returns true if Open succeeded and Close has not been called.
   virtual bool IsOpen() const;
 
+  // Returns the underlying platform file, for callers that move its contents
+  // with system calls such as sendfile(). Reads through the returned handle
+  // share the stream position. Returns base::kInvalidPlatformFile if the
+  // stream is not open or an asynchronous operation is in progress.
+  base::PlatformFile GetPlatformFile() const;
+
   // Adjust the position from the start of the file where data is read
   // asynchronously. Upon success, ERR_IO_PENDING is returned and |callback|
   // will be run on the thread where Seek() was called with the the stream
@@ -142,6 +142,12 @@ bool FileStream::Context::IsOpen() const {
   return file_.IsValid();
 }
 
+base::PlatformFile FileStream::Context::GetPlatformFile() const {
+  if (!file_.IsValid() || async_in_progress_)
+    return base::kInvalidPlatformFile;
+  return file_.GetPlatformFile();
+}
+
 FileStream::Context::OpenResult FileStream::Context::OpenFileImpl(
     const base::FilePath& path, int open_flags) {
 #if defined(OS_POSIX)
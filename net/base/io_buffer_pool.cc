@@ -0,0 +1,178 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_pool.h"
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
+#include "net/base/io_buffer.h"
+
+namespace net {
+
+namespace {
+
+// Sizes of the buffers the pool keeps, in increasing order. 4 KB matches the
+// HTTP header buffer increment, 8 KB SpdySession reads, and 32 KB filter
+// buffers.
+const int kSizeClasses[] = {4 * 1024, 8 * 1024, 16 * 1024,
+                            IOBufferPool::kMaxPooledBufferSize};
+
+// The most memory the pool keeps unused in each size class.
+const size_t kMaxCachedBytesPerSizeClass = 256 * 1024;
+
+}  // namespace
+
+// Gives its memory back to the pool when destroyed.
+class IOBufferPool::PooledIOBuffer : public IOBuffer {
+ public:
+  PooledIOBuffer(IOBufferPool* pool, size_t size_class_index, char* data)
+      : IOBuffer(data), pool_(pool), size_class_index_(size_class_index) {}
+
+ private:
+  ~PooledIOBuffer() override {
+    pool_->ReleaseBuffer(size_class_index_, data_);
+    // The pool owns the memory now.
+    data_ = nullptr;
+  }
+
+  IOBufferPool* const pool_;
+  const size_t size_class_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledIOBuffer);
+};
+
+IOBufferPool::SizeClass::SizeClass(int buffer_size)
+    : buffer_size(buffer_size), buffers_in_use(0) {}
+
+IOBufferPool::SizeClass::SizeClass(const SizeClass& other) = default;
+
+IOBufferPool::SizeClass::~SizeClass() {}
+
+// static
+IOBufferPool* IOBufferPool::GetInstance() {
+  return base::Singleton<IOBufferPool,
+                         base::LeakySingletonTraits<IOBufferPool>>::get();
+}
+
+scoped_refptr<IOBuffer> IOBufferPool::GetBuffer(int size) {
+  DCHECK_GT(size, 0);
+  int index = GetSizeClassIndex(size);
+  if (index < 0)
+    return new IOBuffer(size);
+
+  char* data = nullptr;
+  {
+    base::AutoLock lock(lock_);
+    SizeClass& size_class = size_classes_[index];
+    if (!size_class.free_buffers.empty()) {
+      data = size_class.free_buffers.back();
+      size_class.free_buffers.pop_back();
+    }
+    ++size_class.buffers_in_use;
+  }
+  if (!data)
+    data = new char[size_classes_[index].buffer_size];
+  return new PooledIOBuffer(this, index, data);
+}
+
+void IOBufferPool::Purge() {
+  base::AutoLock lock(lock_);
+  for (SizeClass& size_class : size_classes_) {
+    for (char* data : size_class.free_buffers)
+      delete[] data;
+    size_class.free_buffers.clear();
+  }
+}
+
+size_t IOBufferPool::GetCachedBytesForTesting() const {
+  base::AutoLock lock(lock_);
+  size_t cached_bytes = 0;
+  for (const SizeClass& size_class : size_classes_)
+    cached_bytes += size_class.free_buffers.size() * size_class.buffer_size;
+  return cached_bytes;
+}
+
+bool IOBufferPool::OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                                base::trace_event::ProcessMemoryDump* pmd) {
+  using base::trace_event::MemoryAllocatorDump;
+
+  base::AutoLock lock(lock_);
+  size_t total_cached_bytes = 0;
+  size_t total_in_use_bytes = 0;
+  for (const SizeClass& size_class : size_classes_) {
+    size_t cached_bytes =
+        size_class.free_buffers.size() * size_class.buffer_size;
+    size_t in_use_bytes = size_class.buffers_in_use * size_class.buffer_size;
+    total_cached_bytes += cached_bytes;
+    total_in_use_bytes += in_use_bytes;
+
+    if (args.level_of_detail !=
+        base::trace_event::MemoryDumpLevelOfDetail::DETAILED) {
+      continue;
+    }
+    MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(base::StringPrintf(
+        "net/io_buffer_pool/%d_bytes", size_class.buffer_size));
+    dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                    MemoryAllocatorDump::kUnitsBytes,
+                    cached_bytes + in_use_bytes);
+    dump->AddScalar("cached_size", MemoryAllocatorDump::kUnitsBytes,
+                    cached_bytes);
+    dump->AddScalar(MemoryAllocatorDump::kNameObjectCount,
+                    MemoryAllocatorDump::kUnitsObjects,
+                    size_class.free_buffers.size() + size_class.buffers_in_use);
+  }
+
+  MemoryAllocatorDump* dump = pmd->CreateAllocatorDump("net/io_buffer_pool");
+  dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes,
+                  total_cached_bytes + total_in_use_bytes);
+  dump->AddScalar("cached_size", MemoryAllocatorDump::kUnitsBytes,
+                  total_cached_bytes);
+
+  const char* system_allocator_name =
+      base::trace_event::MemoryDumpManager::GetInstance()
+          ->system_allocator_pool_name();
+  if (system_allocator_name)
+    pmd->AddSuballocation(dump->guid(), system_allocator_name);
+  return true;
+}
+
+IOBufferPool::IOBufferPool() {
+  for (int size : kSizeClasses)
+    size_classes_.push_back(SizeClass(size));
+  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+      this, "IOBufferPool", nullptr);
+}
+
+IOBufferPool::~IOBufferPool() {
+  Purge();
+}
+
+int IOBufferPool::GetSizeClassIndex(int size) const {
+  for (size_t i = 0; i < size_classes_.size(); ++i) {
+    if (size <= size_classes_[i].buffer_size)
+      return i;
+  }
+  return -1;
+}
+
+void IOBufferPool::ReleaseBuffer(size_t size_class_index, char* data) {
+  {
+    base::AutoLock lock(lock_);
+    SizeClass& size_class = size_classes_[size_class_index];
+    DCHECK_GT(size_class.buffers_in_use, 0u);
+    --size_class.buffers_in_use;
+    if ((size_class.free_buffers.size() + 1) * size_class.buffer_size <=
+        kMaxCachedBytesPerSizeClass) {
+      size_class.free_buffers.push_back(data);
+      return;
+    }
+  }
+  delete[] data;
+}
+
+}  // namespace net
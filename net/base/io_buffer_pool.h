@@ -0,0 +1,87 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_IO_BUFFER_POOL_H_
+#define NET_BASE_IO_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
+#include "base/trace_event/memory_dump_provider.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+class IOBuffer;
+
+// A process-wide pool of the fixed-size buffers that the network stack
+// allocates over and over, such as the input buffers of content decoding
+// filters and the read buffers of SPDY sessions. Buffers are grouped into a
+// few size classes, and when an IOBuffer from the pool is destroyed, its
+// memory goes back to the pool rather than to the allocator, up to a cap per
+// size class. The pool reports its size to memory-infra.
+//
+// The pool can be used from any thread.
+class NET_EXPORT IOBufferPool : public base::trace_event::MemoryDumpProvider {
+ public:
+  // The largest buffer size the pool keeps. Larger buffers are allocated and
+  // freed as usual.
+  static const int kMaxPooledBufferSize = 32 * 1024;
+
+  static IOBufferPool* GetInstance();
+
+  // Returns a buffer with room for at least |size| bytes. The buffer may be
+  // larger than |size|, but callers must not rely on that.
+  scoped_refptr<IOBuffer> GetBuffer(int size);
+
+  // Frees all the buffers the pool holds that aren't in use.
+  void Purge();
+
+  // Returns the number of bytes held by the pool that aren't in use.
+  size_t GetCachedBytesForTesting() const;
+
+  // MemoryDumpProvider implementation.
+  bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                    base::trace_event::ProcessMemoryDump* pmd) override;
+
+ private:
+  friend struct base::DefaultSingletonTraits<IOBufferPool>;
+  class PooledIOBuffer;
+
+  // Unused buffers of one size.
+  struct SizeClass {
+    explicit SizeClass(int buffer_size);
+    SizeClass(const SizeClass& other);
+    ~SizeClass();
+
+    int buffer_size;
+    std::vector<char*> free_buffers;
+    // Number of buffers of this size handed out and not yet returned.
+    size_t buffers_in_use;
+  };
+
+  IOBufferPool();
+  ~IOBufferPool() override;
+
+  // Returns the index of the smallest size class that fits |size|, or -1 if
+  // |size| is larger than all of them.
+  int GetSizeClassIndex(int size) const;
+
+  // Called by PooledIOBuffer when it's destroyed.
+  void ReleaseBuffer(size_t size_class_index, char* data);
+
+  mutable base::Lock lock_;
+  std::vector<SizeClass> size_classes_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOBufferPool);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_IO_BUFFER_POOL_H_
@@ -0,0 +1,93 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_pool.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/process_memory_dump.h"
+#include "net/base/io_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class IOBufferPoolTest : public ::testing::Test {
+ protected:
+  IOBufferPoolTest() : pool_(IOBufferPool::GetInstance()) { pool_->Purge(); }
+  ~IOBufferPoolTest() override { pool_->Purge(); }
+
+  IOBufferPool* const pool_;
+};
+
+TEST_F(IOBufferPoolTest, ReusesReleasedBuffers) {
+  scoped_refptr<IOBuffer> buffer = pool_->GetBuffer(8 * 1024);
+  memset(buffer->data(), 'a', 8 * 1024);
+  char* data = buffer->data();
+  EXPECT_EQ(0u, pool_->GetCachedBytesForTesting());
+
+  buffer = nullptr;
+  EXPECT_EQ(8u * 1024, pool_->GetCachedBytesForTesting());
+
+  buffer = pool_->GetBuffer(8 * 1024);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(0u, pool_->GetCachedBytesForTesting());
+}
+
+TEST_F(IOBufferPoolTest, RoundsUpToSizeClass) {
+  scoped_refptr<IOBuffer> buffer = pool_->GetBuffer(5000);
+  memset(buffer->data(), 'a', 5000);
+  char* data = buffer->data();
+  buffer = nullptr;
+  EXPECT_EQ(8u * 1024, pool_->GetCachedBytesForTesting());
+
+  // A request in the same size class gets the same memory; one in a smaller
+  // size class doesn't.
+  buffer = pool_->GetBuffer(1000);
+  EXPECT_NE(data, buffer->data());
+  scoped_refptr<IOBuffer> buffer2 = pool_->GetBuffer(8 * 1024);
+  EXPECT_EQ(data, buffer2->data());
+}
+
+TEST_F(IOBufferPoolTest, LargeBuffersAreNotPooled) {
+  scoped_refptr<IOBuffer> buffer =
+      pool_->GetBuffer(IOBufferPool::kMaxPooledBufferSize + 1);
+  memset(buffer->data(), 'a', IOBufferPool::kMaxPooledBufferSize + 1);
+  buffer = nullptr;
+  EXPECT_EQ(0u, pool_->GetCachedBytesForTesting());
+}
+
+TEST_F(IOBufferPoolTest, CachedBytesAreCapped) {
+  std::vector<scoped_refptr<IOBuffer>> buffers;
+  for (int i = 0; i < 100; ++i)
+    buffers.push_back(pool_->GetBuffer(IOBufferPool::kMaxPooledBufferSize));
+  buffers.clear();
+  EXPECT_LT(0u, pool_->GetCachedBytesForTesting());
+  EXPECT_GT(100u * IOBufferPool::kMaxPooledBufferSize,
+            pool_->GetCachedBytesForTesting());
+
+  pool_->Purge();
+  EXPECT_EQ(0u, pool_->GetCachedBytesForTesting());
+}
+
+TEST_F(IOBufferPoolTest, OnMemoryDump) {
+  scoped_refptr<IOBuffer> in_use = pool_->GetBuffer(4 * 1024);
+  pool_->GetBuffer(16 * 1024);
+
+  base::trace_event::MemoryDumpArgs args = {
+      base::trace_event::MemoryDumpLevelOfDetail::DETAILED};
+  base::trace_event::ProcessMemoryDump pmd(nullptr, args);
+  ASSERT_TRUE(pool_->OnMemoryDump(args, &pmd));
+  ASSERT_TRUE(pmd.GetAllocatorDump("net/io_buffer_pool"));
+  ASSERT_TRUE(pmd.GetAllocatorDump("net/io_buffer_pool/4096_bytes"));
+  ASSERT_TRUE(pmd.GetAllocatorDump("net/io_buffer_pool/16384_bytes"));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -45,9 +45,12 @@
 
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/macros.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
 #include "net/base/lookup_string_in_fixed_set.h"
 #include "net/base/net_module.h"
 #include "net/base/url_util.h"
@@ -66,9 +69,87 @@ namespace {
 const unsigned char* g_graph = kDafsa;
 size_t g_graph_length = sizeof(kDafsa);
 
-size_t GetRegistryLengthImpl(base::StringPiece host,
-                             UnknownRegistryFilter unknown_filter,
-                             PrivateRegistryFilter private_filter) {
+// Remembers the registry lengths of recently looked up hosts. Cookie access,
+// site isolation and the like look up the same few hosts over and over, each
+// time walking the graph once per label of the host. The cache is direct
+// mapped, so a lookup or insert is a hash, a string compare and at most one
+// string copy under a lock that is never held while walking the graph.
+class RegistryLengthCache {
+ public:
+  RegistryLengthCache() {}
+
+  // Returns true and sets |registry_length| if |host| was looked up with the
+  // same filters recently.
+  bool Lookup(base::StringPiece host,
+              UnknownRegistryFilter unknown_filter,
+              PrivateRegistryFilter private_filter,
+              size_t* registry_length) {
+    const int filters = GetFilters(unknown_filter, private_filter);
+    base::AutoLock lock(lock_);
+    const Entry& entry = entries_[GetIndex(host, filters)];
+    if (entry.filters != filters || host != entry.host)
+      return false;
+    *registry_length = entry.registry_length;
+    return true;
+  }
+
+  void Insert(base::StringPiece host,
+              UnknownRegistryFilter unknown_filter,
+              PrivateRegistryFilter private_filter,
+              size_t registry_length) {
+    // Very long hosts are rare enough that keeping copies of them around
+    // isn't worth it.
+    if (host.length() > kMaxHostLength)
+      return;
+    const int filters = GetFilters(unknown_filter, private_filter);
+    base::AutoLock lock(lock_);
+    Entry& entry = entries_[GetIndex(host, filters)];
+    host.CopyToString(&entry.host);
+    entry.filters = filters;
+    entry.registry_length = registry_length;
+  }
+
+  // Forgets all hosts. Called when the graph changes.
+  void Clear() {
+    base::AutoLock lock(lock_);
+    for (Entry& entry : entries_)
+      entry = Entry();
+  }
+
+ private:
+  static const size_t kNumEntries = 256;
+  static const size_t kMaxHostLength = 128;
+
+  struct Entry {
+    Entry() : filters(-1), registry_length(0) {}
+
+    std::string host;
+    // Both filters the entry was computed with, or -1 if it is unused.
+    int filters;
+    size_t registry_length;
+  };
+
+  static int GetFilters(UnknownRegistryFilter unknown_filter,
+                        PrivateRegistryFilter private_filter) {
+    return (unknown_filter << 1) | private_filter;
+  }
+
+  static size_t GetIndex(base::StringPiece host, int filters) {
+    return (base::StringPieceHash()(host) + filters) % kNumEntries;
+  }
+
+  base::Lock lock_;
+  Entry entries_[kNumEntries];
+
+  DISALLOW_COPY_AND_ASSIGN(RegistryLengthCache);
+};
+
+base::LazyInstance<RegistryLengthCache>::Leaky g_registry_length_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+size_t LookupRegistryLength(base::StringPiece host,
+                            UnknownRegistryFilter unknown_filter,
+                            PrivateRegistryFilter private_filter) {
   DCHECK(!host.empty());
 
   // Skip leading dots.
@@ -148,6 +229,20 @@ size_t GetRegistryLengthImpl(base::StringPiece host,
       (host.length() - curr_start) : 0;
 }
 
+size_t GetRegistryLengthImpl(base::StringPiece host,
+                             UnknownRegistryFilter unknown_filter,
+                             PrivateRegistryFilter private_filter) {
+  size_t registry_length;
+  if (g_registry_length_cache.Get().Lookup(host, unknown_filter,
+                                           private_filter, &registry_length)) {
+    return registry_length;
+  }
+  registry_length = LookupRegistryLength(host, unknown_filter, private_filter);
+  g_registry_length_cache.Get().Insert(host, unknown_filter, private_filter,
+                                       registry_length);
+  return registry_length;
+}
+
 std::string GetDomainAndRegistryImpl(base::StringPiece host,
                                      PrivateRegistryFilter private_filter) {
   DCHECK(!host.empty());
@@ -250,6 +345,7 @@ size_t GetRegistryLength(base::StringPiece host,
 void SetFindDomainGraph() {
   g_graph = kDafsa;
   g_graph_length = sizeof(kDafsa);
+  g_registry_length_cache.Get().Clear();
 }
 
 void SetFindDomainGraph(const unsigned char* domains, size_t length) {
@@ -257,6 +353,7 @@ void SetFindDomainGraph(const unsigned char* domains, size_t length) {
   CHECK_NE(length, 0u);
   g_graph = domains;
   g_graph_length = length;
+  g_registry_length_cache.Get().Clear();
 }
 
 }  // namespace registry_controlled_domains
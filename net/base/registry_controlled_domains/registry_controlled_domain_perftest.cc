@@ -0,0 +1,128 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "net/base/lookup_string_in_fixed_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+namespace {
+namespace real {
+#include "net/base/registry_controlled_domains/effective_tld_names-inc.cc"
+}
+}  // namespace
+
+namespace net {
+namespace registry_controlled_domains {
+
+namespace {
+
+// Sites of the kinds cookies and origins are checked against: plain .com
+// sites, multi-label registries, private registries and wildcard rules.
+const char* const kDomains[] = {
+    "google.com",           "example.co.uk",           "example.com.au",
+    "wikipedia.org",        "someone.github.io",       "someone.blogspot.com",
+    "example.appspot.com",  "bucket.s3.amazonaws.com", "example.kawasaki.jp",
+    "example.ac.jp",        "example.de",              "example.gov.br",
+};
+
+// Roughly the number of lookups each measurement does.
+const size_t kLookupsPerMeasurement = 500 * 1000;
+
+// Returns |count| distinct hosts spread over kDomains, such as
+// "www3.google.com".
+std::vector<std::string> MakeHosts(size_t count) {
+  std::vector<std::string> hosts;
+  for (size_t i = 0; i < count; ++i) {
+    hosts.push_back("www" + base::SizeTToString(i / arraysize(kDomains)) +
+                    "." + kDomains[i % arraysize(kDomains)]);
+  }
+  return hosts;
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& hosts,
+                 base::TimeDelta elapsed,
+                 size_t num_lookups) {
+  perf_test::PrintResult(measurement, "", hosts,
+                         elapsed.InMillisecondsF() * 1000000 / num_lookups,
+                         "ns/lookup", true);
+}
+
+// Looks up each of |hosts| in the same way GetRegistryLength() does, but
+// always walking the graph, one lookup per label.
+size_t WalkGraph(const std::vector<std::string>& hosts) {
+  size_t found = 0;
+  for (const std::string& host : hosts) {
+    base::StringPiece suffix(host);
+    while (true) {
+      if (LookupStringInFixedSet(real::kDafsa, sizeof(real::kDafsa),
+                                 suffix.data(),
+                                 suffix.length()) != kDafsaNotFound) {
+        ++found;
+        break;
+      }
+      size_t dot = suffix.find('.');
+      if (dot == base::StringPiece::npos)
+        break;
+      suffix.remove_prefix(dot + 1);
+    }
+  }
+  return found;
+}
+
+void MeasureLookups(const std::string& hosts_name, size_t num_hosts) {
+  const std::vector<std::string> hosts = MakeHosts(num_hosts);
+  std::vector<GURL> urls;
+  for (const std::string& host : hosts)
+    urls.push_back(GURL("https://" + host + "/"));
+  const size_t rounds = kLookupsPerMeasurement / num_hosts;
+
+  size_t found = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t round = 0; round < rounds; ++round)
+    found += WalkGraph(hosts);
+  PrintResult("graph_walk", hosts_name, base::TimeTicks::Now() - start,
+              rounds * num_hosts);
+  EXPECT_EQ(rounds * num_hosts, found);
+
+  size_t total_length = 0;
+  start = base::TimeTicks::Now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (const GURL& url : urls) {
+      total_length += GetRegistryLength(url, EXCLUDE_UNKNOWN_REGISTRIES,
+                                        INCLUDE_PRIVATE_REGISTRIES);
+    }
+  }
+  PrintResult("GetRegistryLength", hosts_name, base::TimeTicks::Now() - start,
+              rounds * num_hosts);
+  EXPECT_LT(0u, total_length);
+}
+
+}  // namespace
+
+// A working set of hosts that fits in the cache of recent lookups, as while
+// loading a page.
+TEST(RegistryControlledDomainPerfTest, FewHosts) {
+  MeasureLookups("hosts_48", 48);
+}
+
+// More hosts than the cache holds, so nearly every lookup walks the graph.
+TEST(RegistryControlledDomainPerfTest, ManyHosts) {
+  MeasureLookups("hosts_8192", 8192);
+}
+
+}  // namespace registry_controlled_domains
+}  // namespace net
@@ -369,6 +369,23 @@ TEST_F(RegistryControlledDomainTest, TestPrivateRegistryHandling) {
                                                INCLUDE_UNKNOWN_REGISTRIES));
 }
 
+TEST_F(RegistryControlledDomainTest, TestLookupsRepeatedAfterGraphChange) {
+  // Recent lookups are cached, so look up the same host twice with each
+  // graph to make sure no result outlives the graph it came from.
+  UseDomainData(test1::kDafsa);
+  EXPECT_EQ(5U, GetRegistryLengthFromHost("foo.ac.jp",
+                                          EXCLUDE_UNKNOWN_REGISTRIES));
+  EXPECT_EQ(5U, GetRegistryLengthFromHost("foo.ac.jp",
+                                          EXCLUDE_UNKNOWN_REGISTRIES));
+
+  UseDomainData(test2::kDafsa);
+  EXPECT_EQ(2U, GetRegistryLengthFromHost("foo.ac.jp",
+                                          EXCLUDE_UNKNOWN_REGISTRIES));
+  EXPECT_EQ(2U, GetRegistryLengthFromHost("foo.ac.jp",
+                                          EXCLUDE_UNKNOWN_REGISTRIES));
+  EXPECT_EQ("ac.jp", GetDomainFromHost("foo.ac.jp"));
+}
+
 TEST_F(RegistryControlledDomainTest, TestDafsaTwoByteOffsets) {
   UseDomainData(test3::kDafsa);
 
@@ -56,6 +56,27 @@ int UploadDataStream::Read(IOBuffer* buf,
   return result;
 }
 
+base::PlatformFile UploadDataStream::GetFileForSendFile(uint64_t* length) {
+  DCHECK(initialized_successfully_);
+  DCHECK(callback_.is_null());
+  if (is_eof_)
+    return base::kInvalidPlatformFile;
+  base::PlatformFile file = GetFileForSendFileInternal(length);
+  DCHECK(file == base::kInvalidPlatformFile || *length > 0);
+  return file;
+}
+
+void UploadDataStream::DidSendFileData(int bytes) {
+  DCHECK(initialized_successfully_);
+  DCHECK(!is_chunked_);
+  DCHECK_LT(0, bytes);
+  DidSendFileDataInternal(bytes);
+  current_position_ += bytes;
+  DCHECK_LE(current_position_, total_size_);
+  if (current_position_ == total_size_)
+    is_eof_ = true;
+}
+
 bool UploadDataStream::IsEOF() const {
   DCHECK(initialized_successfully_);
   DCHECK(is_chunked_ || is_eof_ == (current_position_ == total_size_));
@@ -93,6 +114,15 @@ UploadDataStream::GetElementReaders() const {
   return NULL;
 }
 
+base::PlatformFile UploadDataStream::GetFileForSendFileInternal(
+    uint64_t* length) {
+  return base::kInvalidPlatformFile;
+}
+
+void UploadDataStream::DidSendFileDataInternal(int bytes) {
+  NOTREACHED();
+}
+
 void UploadDataStream::OnInitCompleted(int result) {
   DCHECK_NE(ERR_IO_PENDING, result);
   DCHECK(!initialized_successfully_);
@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 
+#include "base/files/file.h"
 #include "base/macros.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
@@ -62,6 +63,16 @@ class NET_EXPORT UploadDataStream {
   // TODO(mmenke):  Investigate letting reads fail.
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Returns a file from whose current position the next |*length| bytes of
+  // the stream can be sent with StreamSocket::SendFile() instead of being
+  // Read(), or base::kInvalidPlatformFile if the next bytes must be Read().
+  // Must not be called while a Read() is pending.
+  base::PlatformFile GetFileForSendFile(uint64_t* length);
+
+  // Must be called after |bytes| bytes of the file returned by
+  // GetFileForSendFile() were sent, to advance the stream past them.
+  void DidSendFileData(int bytes);
+
   // Returns the total size of the data stream and the current position.
   // When the data is chunked, always returns zero. Must always return the same
   // value after each call to Initialize().
@@ -120,6 +131,11 @@ class NET_EXPORT UploadDataStream {
   // return any error, other than ERR_IO_PENDING.
   virtual int ReadInternal(IOBuffer* buf, int buf_len) = 0;
 
+  // See GetFileForSendFile() and DidSendFileData(). The default
+  // implementation never offers a file.
+  virtual base::PlatformFile GetFileForSendFileInternal(uint64_t* length);
+  virtual void DidSendFileDataInternal(int bytes);
+
   // Resets state and cancels any pending callbacks. Guaranteed to be called
   // before all but the first call to InitInternal.
   virtual void ResetInternal() = 0;
@@ -4,6 +4,8 @@
 
 #include "net/base/upload_element_reader.h"
 
+#include "base/logging.h"
+
 namespace net {
 
 const UploadBytesElementReader* UploadElementReader::AsBytesReader() const {
@@ -18,4 +20,12 @@ bool UploadElementReader::IsInMemory() const {
   return false;
 }
 
+base::PlatformFile UploadElementReader::GetFileForSendFile() const {
+  return base::kInvalidPlatformFile;
+}
+
+void UploadElementReader::DidSendFileData(int bytes) {
+  NOTREACHED();
+}
+
 }  // namespace net
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include "base/files/file.h"
 #include "base/macros.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
@@ -60,6 +61,16 @@ class NET_EXPORT UploadElementReader {
                    int buf_length,
                    const CompletionCallback& callback) = 0;
 
+  // Returns a file from whose current position the next BytesRemaining()
+  // bytes of the element can be sent with StreamSocket::SendFile() instead of
+  // being Read(), or base::kInvalidPlatformFile if they can't. The default
+  // implementation returns base::kInvalidPlatformFile.
+  virtual base::PlatformFile GetFileForSendFile() const;
+
+  // Called after |bytes| bytes of the file returned by GetFileForSendFile()
+  // were sent, to account for them as read.
+  virtual void DidSendFileData(int bytes);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(UploadElementReader);
 };
@@ -35,6 +35,7 @@ UploadFileElementReader::UploadFileElementReader(
       expected_modification_time_(expected_modification_time),
       content_length_(0),
       bytes_remaining_(0),
+      send_file_enabled_(false),
       weak_ptr_factory_(this) {
   DCHECK(task_runner_.get());
 }
@@ -93,6 +94,18 @@ int UploadFileElementReader::Read(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+base::PlatformFile UploadFileElementReader::GetFileForSendFile() const {
+  if (!send_file_enabled_ || !file_stream_ || bytes_remaining_ == 0)
+    return base::kInvalidPlatformFile;
+  return file_stream_->GetPlatformFile();
+}
+
+void UploadFileElementReader::DidSendFileData(int bytes) {
+  DCHECK_LT(0, bytes);
+  DCHECK_GE(bytes_remaining_, static_cast<uint64_t>(bytes));
+  bytes_remaining_ -= bytes;
+}
+
 void UploadFileElementReader::Reset() {
   weak_ptr_factory_.InvalidateWeakPtrs();
   bytes_remaining_ = 0;
@@ -46,6 +46,14 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
     return expected_modification_time_;
   }
 
+  // Lets the file be sent straight to plain TCP sockets with
+  // StreamSocket::SendFile(), rather than through Read() and a buffer. As the
+  // socket then reads the file on the network thread, this should only be
+  // enabled for large files on local disks. Disabled by default.
+  void set_send_file_enabled(bool send_file_enabled) {
+    send_file_enabled_ = send_file_enabled;
+  }
+
   // UploadElementReader overrides:
   const UploadFileElementReader* AsFileReader() const override;
   int Init(const CompletionCallback& callback) override;
@@ -54,6 +62,8 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   int Read(IOBuffer* buf,
            int buf_length,
            const CompletionCallback& callback) override;
+  base::PlatformFile GetFileForSendFile() const override;
+  void DidSendFileData(int bytes) override;
 
  private:
   FRIEND_TEST_ALL_PREFIXES(ElementsUploadDataStreamTest, FileSmallerThanLength);
@@ -88,6 +98,7 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   std::unique_ptr<FileStream> file_stream_;
   uint64_t content_length_;
   uint64_t bytes_remaining_;
+  bool send_file_enabled_;
   base::WeakPtrFactory<UploadFileElementReader> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(UploadFileElementReader);
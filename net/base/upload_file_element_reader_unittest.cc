@@ -201,6 +201,51 @@ TEST_F(UploadFileElementReaderTest, Range) {
   EXPECT_EQ(expected, buf);
 }
 
+TEST_F(UploadFileElementReaderTest, SendFile) {
+  // Files are only offered to the socket when enabled.
+  EXPECT_EQ(base::kInvalidPlatformFile, reader_->GetFileForSendFile());
+
+  const uint64_t kOffset = 2;
+  const uint64_t kLength = bytes_.size() - kOffset * 3;
+  std::unique_ptr<UploadFileElementReader> reader(new UploadFileElementReader(
+      base::ThreadTaskRunnerHandle::Get().get(), temp_file_path_, kOffset,
+      kLength, base::Time()));
+  reader->set_send_file_enabled(true);
+  EXPECT_EQ(base::kInvalidPlatformFile, reader->GetFileForSendFile());
+  TestCompletionCallback init_callback;
+  ASSERT_EQ(ERR_IO_PENDING, reader->Init(init_callback.callback()));
+  EXPECT_EQ(OK, init_callback.WaitForResult());
+
+  // Consume the start of the range from the file, as SendFile() would.
+  const int kSentSize = 4;
+  base::File file(reader->GetFileForSendFile());
+  ASSERT_TRUE(file.IsValid());
+  std::vector<char> sent(kSentSize);
+  EXPECT_EQ(kSentSize, file.ReadAtCurrentPos(&sent[0], kSentSize));
+  file.TakePlatformFile();
+  reader->DidSendFileData(kSentSize);
+  EXPECT_EQ(kLength - kSentSize, reader->BytesRemaining());
+  EXPECT_EQ(std::vector<char>(bytes_.begin() + kOffset,
+                              bytes_.begin() + kOffset + kSentSize),
+            sent);
+
+  // Reading picks up where sending left off.
+  std::vector<char> buf(kLength);
+  scoped_refptr<IOBuffer> wrapped_buffer = new WrappedIOBuffer(&buf[0]);
+  TestCompletionCallback read_callback;
+  ASSERT_EQ(
+      ERR_IO_PENDING,
+      reader->Read(wrapped_buffer.get(), kLength, read_callback.callback()));
+  EXPECT_EQ(static_cast<int>(kLength - kSentSize),
+            read_callback.WaitForResult());
+  buf.resize(kLength - kSentSize);
+  EXPECT_EQ(std::vector<char>(bytes_.begin() + kOffset + kSentSize,
+                              bytes_.begin() + kOffset + kLength),
+            buf);
+  EXPECT_EQ(0U, reader->BytesRemaining());
+  EXPECT_EQ(base::kInvalidPlatformFile, reader->GetFileForSendFile());
+}
+
 TEST_F(UploadFileElementReaderTest, FileChanged) {
   base::File::Info info;
   ASSERT_TRUE(base::GetFileInfo(temp_file_path_, &info));
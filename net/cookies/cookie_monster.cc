@@ -59,6 +59,7 @@
 #include "base/metrics/histogram.h"
 #include "base/profiler/scoped_tracker.h"
 #include "base/single_thread_task_runner.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -120,6 +121,15 @@ const size_t CookieMonster::kDomainCookiesQuotaHigh =
 
 const int CookieMonster::kSafeFromGlobalPurgeDays = 30;
 
+CookieMonster::CachedCookieLine::CachedCookieLine() {}
+
+CookieMonster::CachedCookieLine::~CachedCookieLine() {}
+
+CookieMonster::CookieLineCache::CookieLineCache()
+    : earliest_expiry(Time::Max()) {}
+
+CookieMonster::CookieLineCache::~CookieLineCache() {}
+
 namespace {
 
 bool ContainsControlCharacter(const std::string& s) {
@@ -1016,6 +1026,13 @@ void CookieMonster::SetPersistSessionCookies(bool persist_session_cookies) {
   persist_session_cookies_ = persist_session_cookies;
 }
 
+// This function must be called before the CookieMonster is used.
+void CookieMonster::SetFetchAllCookiesWhenFetchingAnyCookie(bool fetch_all) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK(!initialized_);
+  fetch_strategy_ = fetch_all ? kAlwaysFetch : kFetchWhenNecessary;
+}
+
 bool CookieMonster::IsCookieableScheme(const std::string& scheme) {
   DCHECK(thread_checker_.CalledOnValidThread());
 
@@ -1222,11 +1239,39 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
   if (!HasCookieableScheme(url))
     return std::string();
 
+  const Time current_time(CurrentTime());
+  RecordPeriodicStats(current_time);
+
+  // Pages request the cookies of the same few URLs over and over, so the line
+  // is only built again once the cookies of its key change.
+  const std::string key(GetKey(url.host()));
+  const std::string line_key(GetCookieLineKey(url, options));
+  auto cache_it = cookie_line_cache_.find(key);
+  if (cache_it != cookie_line_cache_.end() &&
+      current_time >= cache_it->second.earliest_expiry) {
+    // Lets FindCookiesForKey() delete the expired cookies.
+    cookie_line_cache_.erase(cache_it);
+    cache_it = cookie_line_cache_.end();
+  }
+  if (cache_it != cookie_line_cache_.end()) {
+    auto line_it = cache_it->second.lines.find(line_key);
+    if (line_it != cache_it->second.lines.end()) {
+      if (options.update_access_time()) {
+        for (CanonicalCookie* cc : line_it->second.cookies)
+          InternalUpdateCookieAccessTime(cc, current_time);
+      }
+      VLOG(kVlogGetCookies) << "GetCookies() cached result: "
+                            << line_it->second.line;
+      return line_it->second.line;
+    }
+  }
+
   std::vector<CanonicalCookie*> cookies;
-  FindCookiesForHostAndDomain(url, options, &cookies);
+  FindCookiesForKey(key, url, options, current_time, &cookies);
   std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
   std::string cookie_line = BuildCookieLine(cookies);
+  CacheCookieLine(key, line_key, &cookies, cookie_line);
 
   VLOG(kVlogGetCookies) << "GetCookies() result: " << cookie_line;
 
@@ -1716,6 +1761,8 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
     store_->AddCookie(*cc);
   CookieMap::iterator inserted =
       cookies_.insert(CookieMap::value_type(key, cc));
+  if (!cookie_line_cache_.empty())
+    cookie_line_cache_.erase(key);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(*cc, false,
                                CookieMonsterDelegate::CHANGE_COOKIE_EXPLICIT);
@@ -1894,6 +1941,8 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
   RunCookieChangedCallbacks(*cc, true);
+  if (!cookie_line_cache_.empty())
+    cookie_line_cache_.erase(it->first);
   cookies_.erase(it);
   delete cc;
 }
@@ -2201,6 +2250,56 @@ std::string CookieMonster::GetKey(const std::string& domain) const {
   return effective_domain;
 }
 
+// static
+std::string CookieMonster::GetCookieLineKey(const GURL& url,
+                                            const CookieOptions& options) {
+  base::StringPiece host = url.host_piece();
+  base::StringPiece path = url.path_piece();
+  std::string line_key;
+  line_key.reserve(3 + host.size() + path.size());
+  line_key.push_back(url.SchemeIsCryptographic() ? 's' : '-');
+  line_key.push_back(options.exclude_httponly() ? 'h' : '-');
+  line_key.push_back('0' +
+                     static_cast<char>(options.same_site_cookie_mode()));
+  host.AppendToString(&line_key);
+  path.AppendToString(&line_key);
+  return line_key;
+}
+
+void CookieMonster::CacheCookieLine(
+    const std::string& key,
+    const std::string& line_key,
+    std::vector<CanonicalCookie*>* cookies,
+    const std::string& line) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  // Keys without cookies aren't cached, so that requests to the many hosts
+  // without cookies don't fill the cache.
+  CookieMapItPair its = cookies_.equal_range(key);
+  if (its.first == its.second)
+    return;
+
+  auto cache_it = cookie_line_cache_.find(key);
+  if (cache_it == cookie_line_cache_.end()) {
+    cache_it = cookie_line_cache_.insert(
+        std::make_pair(key, CookieLineCache())).first;
+    for (; its.first != its.second; ++its.first) {
+      const CanonicalCookie* cc = its.first->second;
+      if (cc->IsPersistent() &&
+          cc->ExpiryDate() < cache_it->second.earliest_expiry) {
+        cache_it->second.earliest_expiry = cc->ExpiryDate();
+      }
+    }
+  }
+
+  CookieLineCache& cache = cache_it->second;
+  if (cache.lines.size() >= kMaxCachedCookieLinesPerKey)
+    cache.lines.clear();
+  CachedCookieLine& cached_line = cache.lines[line_key];
+  cached_line.cookies.swap(*cookies);
+  cached_line.line = line;
+}
+
 bool CookieMonster::HasCookieableScheme(const GURL& url) {
   DCHECK(thread_checker_.CalledOnValidThread());
 
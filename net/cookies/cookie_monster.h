@@ -199,6 +199,13 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // (i.e. as part of the instance initialization process).
   void SetPersistSessionCookies(bool persist_session_cookies);
 
+  // Sets whether all cookies are loaded from the backing store as soon as any
+  // cookie is needed, rather than only the cookies of the domain keys (eTLD+1)
+  // that are used, until an operation on all cookies needs the rest. Overrides
+  // the "CookieMonsterFetchStrategy" field trial. If this method is called, it
+  // must be called before first use of the instance.
+  void SetFetchAllCookiesWhenFetchingAnyCookie(bool fetch_all);
+
   // Determines if the scheme of the URL is a scheme that cookies will be
   // stored for.
   bool IsCookieableScheme(const std::string& scheme);
@@ -363,7 +370,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
     COOKIE_DELETE_EQUIVALENT_LAST_ENTRY
   };
 
-  // The strategy for fetching cookies. Controlled by Finch experiment.
+  // The strategy for fetching cookies. Controlled by Finch experiment, unless
+  // set with SetFetchAllCookiesWhenFetchingAnyCookie().
   enum FetchStrategy {
     // Fetches all cookies only when they're needed.
     kFetchWhenNecessary = 0,
@@ -381,6 +389,31 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // Record statistics every kRecordStatisticsIntervalSeconds of uptime.
   static const int kRecordStatisticsIntervalSeconds = 10 * 60;
 
+  // The most Cookie lines cached per CookieMap key; see CookieLineCache.
+  static const size_t kMaxCachedCookieLinesPerKey = 16;
+
+  // A Cookie line returned by GetCookiesWithOptions(), and the cookies it was
+  // built from.
+  struct CachedCookieLine {
+    CachedCookieLine();
+    ~CachedCookieLine();
+
+    std::vector<CanonicalCookie*> cookies;
+    std::string line;
+  };
+
+  // The Cookie lines built from the cookies of a CookieMap key, by request
+  // host, path, security and options. They stay valid until a cookie of the
+  // key is added or deleted, which drops the whole CookieLineCache of the key,
+  // or until the first of the cookies expires.
+  struct CookieLineCache {
+    CookieLineCache();
+    ~CookieLineCache();
+
+    base::Time earliest_expiry;
+    std::map<std::string, CachedCookieLine> lines;
+  };
+
   // The following are synchronous calls to which the asynchronous methods
   // delegate either immediately (if the store is loaded) or through a deferred
   // task (if the store is not yet loaded).
@@ -586,6 +619,19 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // See comment on keys before the CookieMap typedef.
   std::string GetKey(const std::string& domain) const;
 
+  // Returns the key of the Cookie line for |url| and |options| in a
+  // CookieLineCache: all the inputs of CanonicalCookie::IncludeForRequestURL().
+  static std::string GetCookieLineKey(const GURL& url,
+                                      const CookieOptions& options);
+
+  // Caches |line|, built from |cookies|, as the Cookie line of |line_key| for
+  // the cookies of |key|, taking the contents of |cookies|. Does nothing if
+  // |key| has no cookies.
+  void CacheCookieLine(const std::string& key,
+                       const std::string& line_key,
+                       std::vector<CanonicalCookie*>* cookies,
+                       const std::string& line);
+
   bool HasCookieableScheme(const GURL& url);
 
   // Statistics support
@@ -642,6 +688,9 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // By CookieMap key. Only keys with cookies have a CookieLineCache.
+  std::map<std::string, CookieLineCache> cookie_line_cache_;
+
   // Indicates whether the cookie store has been initialized.
   bool initialized_;
 
@@ -153,6 +153,18 @@ class CookieMonsterTestBase : public CookieStoreTest<T> {
     return callback.cookies();
   }
 
+  std::string GetCookieLineWithOptions(CookieMonster* cm,
+                                       const GURL& url,
+                                       const CookieOptions& options) {
+    DCHECK(cm);
+    StringResultCookieCallback callback;
+    cm->GetCookiesWithOptionsAsync(
+        url, options, base::Bind(&StringResultCookieCallback::Run,
+                                 base::Unretained(&callback)));
+    callback.WaitUntilDone();
+    return callback.result();
+  }
+
   bool SetAllCookies(CookieMonster* cm, const CookieList& list) {
     DCHECK(cm);
     ResultSavingCookieCallback<bool> callback;
@@ -1741,6 +1753,45 @@ TEST_F(CookieMonsterTest, DeleteCookieByName) {
   }
 }
 
+// Tests that the Cookie lines cached for a key change with its cookies, and are
+// kept apart by URL and options.
+TEST_F(CookieMonsterTest, CachedCookieLines) {
+  std::unique_ptr<CookieMonster> cm(new CookieMonster(nullptr, nullptr));
+  const GURL foo_url = http_www_google_.AppendPath("foo");
+  CookieOptions options;
+  CookieOptions httponly_options;
+  httponly_options.set_include_httponly();
+
+  EXPECT_TRUE(SetCookie(cm.get(), http_www_google_.url(), "A=A1; path=/"));
+  EXPECT_EQ("A=A1",
+            GetCookieLineWithOptions(cm.get(), http_www_google_.url(), options));
+  EXPECT_EQ("A=A1", GetCookieLineWithOptions(cm.get(), foo_url, options));
+
+  EXPECT_TRUE(SetCookie(cm.get(), foo_url, "B=B1; path=/foo"));
+  EXPECT_TRUE(SetCookieWithOptions(cm.get(), foo_url, "C=C1; path=/; httponly",
+                                   httponly_options));
+  EXPECT_EQ("A=A1",
+            GetCookieLineWithOptions(cm.get(), http_www_google_.url(), options));
+  EXPECT_EQ("B=B1; A=A1",
+            GetCookieLineWithOptions(cm.get(), foo_url, options));
+  EXPECT_EQ("B=B1; A=A1; C=C1",
+            GetCookieLineWithOptions(cm.get(), foo_url, httponly_options));
+
+  // Cookies of other keys leave the lines as they are.
+  EXPECT_TRUE(SetCookie(cm.get(), GURL("http://other.izzle/"), "D=D1"));
+  EXPECT_EQ("B=B1; A=A1",
+            GetCookieLineWithOptions(cm.get(), foo_url, options));
+
+  EXPECT_TRUE(SetCookie(cm.get(), http_www_google_.url(), "A=A2; path=/"));
+  EXPECT_EQ("B=B1; A=A2",
+            GetCookieLineWithOptions(cm.get(), foo_url, options));
+
+  DeleteCookie(cm.get(), foo_url, "B");
+  EXPECT_EQ("A=A2", GetCookieLineWithOptions(cm.get(), foo_url, options));
+  EXPECT_EQ("C=C1; A=A2",
+            GetCookieLineWithOptions(cm.get(), foo_url, httponly_options));
+}
+
 // Tests importing from a persistent cookie store that contains duplicate
 // equivalent cookies. This situation should be handled by removing the
 // duplicate cookie (both from the in-memory cache, and from the backing store).
@@ -2289,6 +2340,47 @@ TEST_F(CookieMonsterTest, WhileLoadingLoadCompletesBeforeKeyLoadCompletes) {
   EXPECT_EQ(1u, get_cookie_list_callback2.cookies().size());
 }
 
+// Tests that when told not to fetch all cookies when any is needed, the
+// CookieMonster only loads the keys it uses, until all cookies are needed.
+TEST_F(CookieMonsterTest, FetchOnlyNeededKeys) {
+  const GURL kUrl = GURL(kTopLevelDomainPlus1);
+
+  scoped_refptr<MockPersistentCookieStore> store(new MockPersistentCookieStore);
+  store->set_store_load_commands(true);
+  std::unique_ptr<CookieMonster> cm(new CookieMonster(store.get(), nullptr));
+  cm->SetFetchAllCookiesWhenFetchingAnyCookie(false);
+
+  ResultSavingCookieCallback<bool> set_cookie_callback;
+  cm->SetCookieWithOptionsAsync(
+      kUrl, "a=b", CookieOptions(),
+      base::Bind(&ResultSavingCookieCallback<bool>::Run,
+                 base::Unretained(&set_cookie_callback)));
+
+  // Only the key of the URL is loaded.
+  ASSERT_EQ(1u, store->commands().size());
+  ASSERT_EQ(CookieStoreCommand::LOAD_COOKIES_FOR_KEY,
+            store->commands()[0].type);
+  EXPECT_EQ("harvard.edu", store->commands()[0].key);
+  store->commands()[0].loaded_callback.Run(std::vector<CanonicalCookie*>());
+  set_cookie_callback.WaitUntilDone();
+  EXPECT_TRUE(set_cookie_callback.result());
+
+  // Once loaded, the key's cookies are used without loading anything else.
+  EXPECT_EQ("a=b", GetCookies(cm.get(), kUrl));
+  EXPECT_EQ(1u, store->commands().size());
+
+  // Getting all cookies loads the rest.
+  GetCookieListCallback get_cookie_list_callback;
+  cm->GetAllCookiesAsync(
+      base::Bind(&GetCookieListCallback::Run,
+                 base::Unretained(&get_cookie_list_callback)));
+  ASSERT_EQ(2u, store->commands().size());
+  ASSERT_EQ(CookieStoreCommand::LOAD, store->commands()[1].type);
+  store->commands()[1].loaded_callback.Run(std::vector<CanonicalCookie*>());
+  get_cookie_list_callback.WaitUntilDone();
+  EXPECT_EQ(1u, get_cookie_list_callback.cookies().size());
+}
+
 // Tests that case that DeleteAll is waiting for load to complete, and then a
 // get is queued. The get should wait to run until after all the cookies are
 // retrieved, and should return nothing, since all cookies were just deleted.
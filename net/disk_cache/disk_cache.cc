@@ -0,0 +1,26 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/disk_cache.h"
+
+#include <algorithm>
+
+#include "net/base/io_buffer.h"
+
+namespace disk_cache {
+
+int Entry::ReadDataWithHint(int index,
+                            int offset,
+                            int hint_len,
+                            scoped_refptr<net::IOBufferWithSize>* buf,
+                            const CompletionCallback& callback) {
+  *buf = nullptr;
+  const int buf_len = std::min(hint_len, GetDataSize(index) - offset);
+  if (offset < 0 || buf_len <= 0)
+    return 0;
+  *buf = new net::IOBufferWithSize(buf_len);
+  return ReadData(index, offset, buf->get(), buf_len, callback);
+}
+
+}  // namespace disk_cache
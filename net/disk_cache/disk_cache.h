@@ -28,6 +28,7 @@ class SingleThreadTaskRunner;
 
 namespace net {
 class IOBuffer;
+class IOBufferWithSize;
 class NetLog;
 }
 
@@ -202,6 +203,19 @@ class NET_EXPORT Entry {
   virtual int ReadData(int index, int offset, IOBuffer* buf, int buf_len,
                        const CompletionCallback& callback) = 0;
 
+  // Reads up to |hint_len| bytes of the data with the given index, from
+  // |offset|, into a new buffer set in |buf| and sized to the data available,
+  // all in one operation. This lets a caller about to read a small stream in
+  // several chunks read it whole instead, and serve the chunks from memory
+  // rather than waiting for the cache on each one. Returns like ReadData(),
+  // leaving |buf| null if there is no data to read; |buf| must remain valid
+  // until the callback is called.
+  virtual int ReadDataWithHint(int index,
+                               int offset,
+                               int hint_len,
+                               scoped_refptr<net::IOBufferWithSize>* buf,
+                               const CompletionCallback& callback);
+
   // Copies data from the given buffer of length |buf_len| into the cache.
   // Returns the number of bytes written or a network error code. If this
   // function returns ERR_IO_PENDING, the completion callback will be called
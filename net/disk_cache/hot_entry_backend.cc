@@ -0,0 +1,462 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/hot_entry_backend.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+
+namespace disk_cache {
+
+namespace {
+
+// The number of streams of an entry. The HTTP cache stores the response
+// headers, body and metadata in them.
+const int kNumStreams = 3;
+
+}  // namespace
+
+class HotEntryBackend::SharedEntry : public base::RefCounted<SharedEntry> {
+ public:
+  SharedEntry(const std::string& key,
+              Entry* entry,
+              const base::WeakPtr<HotEntryBackend>& backend)
+      : key_(key), entry_(entry), backend_(backend), invalidated_(false) {
+    std::fill(has_stream_, has_stream_ + kNumStreams, false);
+  }
+
+  const std::string& key() const { return key_; }
+  Entry* entry() const { return entry_; }
+  HotEntryBackend* backend() const { return backend_.get(); }
+  bool invalidated() const { return invalidated_; }
+
+  bool HasStream(int index) const { return has_stream_[index]; }
+  const std::string& stream(int index) const { return streams_[index]; }
+
+  // Records |data| as the whole of stream |index|, unless the entry has been
+  // written to since the data was read.
+  void SetStream(int index, const char* data, int len) {
+    if (invalidated_)
+      return;
+    streams_[index].assign(data, len);
+    has_stream_[index] = true;
+  }
+
+  // Returns true if every stream of the entry is known. Streams that are
+  // empty don't need to be read for that.
+  bool HasAllStreams() {
+    if (invalidated_)
+      return false;
+    for (int i = 0; i < kNumStreams; ++i) {
+      if (!has_stream_[i] && entry_->GetDataSize(i) != 0)
+        return false;
+    }
+    std::fill(has_stream_, has_stream_ + kNumStreams, true);
+    return true;
+  }
+
+  // Returns the number of bytes the entry takes in memory.
+  int64_t Size() const {
+    int64_t size = key_.size();
+    for (int i = 0; i < kNumStreams; ++i)
+      size += streams_[i].size();
+    return size;
+  }
+
+  // Forgets the streams read so far, and keeps new ones from being recorded.
+  void Invalidate() {
+    invalidated_ = true;
+    for (int i = 0; i < kNumStreams; ++i) {
+      has_stream_[i] = false;
+      std::string().swap(streams_[i]);
+    }
+  }
+
+  // Invalidates every open entry for the same key, this one included.
+  void InvalidateKey() {
+    if (backend_)
+      backend_->Invalidate(key_);
+    else
+      Invalidate();
+  }
+
+ private:
+  friend class base::RefCounted<SharedEntry>;
+
+  ~SharedEntry() {
+    if (backend_) {
+      auto range = backend_->open_entries_.equal_range(key_);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == this) {
+          backend_->open_entries_.erase(it);
+          break;
+        }
+      }
+    }
+    entry_->Close();
+  }
+
+  const std::string key_;
+  Entry* const entry_;
+  const base::WeakPtr<HotEntryBackend> backend_;
+  bool invalidated_;
+  bool has_stream_[kNumStreams];
+  std::string streams_[kNumStreams];
+
+  DISALLOW_COPY_AND_ASSIGN(SharedEntry);
+};
+
+class HotEntryBackend::EntryProxy : public Entry {
+ public:
+  explicit EntryProxy(const scoped_refptr<SharedEntry>& shared_entry)
+      : shared_entry_(shared_entry) {}
+
+  // Entry implementation.
+  void Doom() override {
+    shared_entry_->InvalidateKey();
+    entry()->Doom();
+  }
+
+  void Close() override { delete this; }
+
+  std::string GetKey() const override { return shared_entry_->key(); }
+
+  base::Time GetLastUsed() const override { return entry()->GetLastUsed(); }
+
+  base::Time GetLastModified() const override {
+    return entry()->GetLastModified();
+  }
+
+  int32_t GetDataSize(int index) const override {
+    if (index >= 0 && index < kNumStreams && shared_entry_->HasStream(index))
+      return shared_entry_->stream(index).size();
+    return entry()->GetDataSize(index);
+  }
+
+  int ReadData(int index,
+               int offset,
+               IOBuffer* buf,
+               int buf_len,
+               const CompletionCallback& callback) override {
+    if (index < 0 || index >= kNumStreams)
+      return entry()->ReadData(index, offset, buf, buf_len, callback);
+
+    if (shared_entry_->HasStream(index)) {
+      if (offset < 0 || buf_len < 0)
+        return net::ERR_INVALID_ARGUMENT;
+      const std::string& stream = shared_entry_->stream(index);
+      if (static_cast<size_t>(offset) >= stream.size())
+        return 0;
+      const int len =
+          std::min(buf_len, static_cast<int>(stream.size()) - offset);
+      memcpy(buf->data(), stream.data() + offset, len);
+      return len;
+    }
+
+    // Only a read of the whole stream can be kept.
+    const int size = entry()->GetDataSize(index);
+    if (offset != 0 || buf_len < size || size > kMaxEntrySize ||
+        shared_entry_->invalidated()) {
+      return entry()->ReadData(index, offset, buf, buf_len, callback);
+    }
+
+    scoped_refptr<IOBuffer> buffer(buf);
+    int rv = entry()->ReadData(
+        index, 0, buf, buf_len,
+        base::Bind(&EntryProxy::OnStreamRead, shared_entry_, index, size,
+                   buffer, callback));
+    if (rv != net::ERR_IO_PENDING)
+      KeepStream(shared_entry_.get(), index, size, buf, rv);
+    return rv;
+  }
+
+  int WriteData(int index,
+                int offset,
+                IOBuffer* buf,
+                int buf_len,
+                const CompletionCallback& callback,
+                bool truncate) override {
+    shared_entry_->InvalidateKey();
+    return entry()->WriteData(index, offset, buf, buf_len, callback,
+                              truncate);
+  }
+
+  int ReadSparseData(int64_t offset,
+                     IOBuffer* buf,
+                     int buf_len,
+                     const CompletionCallback& callback) override {
+    return entry()->ReadSparseData(offset, buf, buf_len, callback);
+  }
+
+  int WriteSparseData(int64_t offset,
+                      IOBuffer* buf,
+                      int buf_len,
+                      const CompletionCallback& callback) override {
+    shared_entry_->InvalidateKey();
+    return entry()->WriteSparseData(offset, buf, buf_len, callback);
+  }
+
+  int GetAvailableRange(int64_t offset,
+                        int len,
+                        int64_t* start,
+                        const CompletionCallback& callback) override {
+    return entry()->GetAvailableRange(offset, len, start, callback);
+  }
+
+  bool CouldBeSparse() const override { return entry()->CouldBeSparse(); }
+
+  void CancelSparseIO() override { entry()->CancelSparseIO(); }
+
+  int ReadyForSparseIO(const CompletionCallback& callback) override {
+    return entry()->ReadyForSparseIO(callback);
+  }
+
+ private:
+  ~EntryProxy() override {}
+
+  Entry* entry() const { return shared_entry_->entry(); }
+
+  // Records a stream read in full, and offers the entry to be kept.
+  static void KeepStream(SharedEntry* shared_entry,
+                         int index,
+                         int size,
+                         IOBuffer* buf,
+                         int result) {
+    if (result != size)
+      return;
+    shared_entry->SetStream(index, buf->data(), size);
+    if (shared_entry->backend())
+      shared_entry->backend()->MaybeKeep(shared_entry);
+  }
+
+  static void OnStreamRead(const scoped_refptr<SharedEntry>& shared_entry,
+                           int index,
+                           int size,
+                           const scoped_refptr<IOBuffer>& buf,
+                           const CompletionCallback& callback,
+                           int result) {
+    KeepStream(shared_entry.get(), index, size, buf.get(), result);
+    callback.Run(result);
+  }
+
+  const scoped_refptr<SharedEntry> shared_entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(EntryProxy);
+};
+
+class HotEntryBackend::IteratorProxy : public Backend::Iterator {
+ public:
+  IteratorProxy(std::unique_ptr<Iterator> iterator,
+                const base::WeakPtr<HotEntryBackend>& backend)
+      : iterator_(std::move(iterator)), backend_(backend) {}
+  ~IteratorProxy() override {}
+
+  int OpenNextEntry(Entry** next_entry,
+                    const CompletionCallback& callback) override {
+    if (!backend_)
+      return net::ERR_FAILED;
+    Entry** inner_entry = new Entry*(nullptr);
+    int rv = iterator_->OpenNextEntry(
+        inner_entry,
+        base::Bind(&HotEntryBackend::OnEntryOpened, backend_, std::string(),
+                   base::Owned(inner_entry), next_entry, callback));
+    if (rv == net::OK)
+      *next_entry = backend_->WrapEntry(std::string(), *inner_entry);
+    return rv;
+  }
+
+ private:
+  std::unique_ptr<Iterator> iterator_;
+  base::WeakPtr<HotEntryBackend> backend_;
+
+  DISALLOW_COPY_AND_ASSIGN(IteratorProxy);
+};
+
+HotEntryBackend::HotEntryBackend(std::unique_ptr<Backend> backend,
+                                 int max_bytes)
+    : backend_(std::move(backend)),
+      max_bytes_(max_bytes),
+      hot_entries_(HotEntryMap::NO_AUTO_EVICT),
+      hot_bytes_(0),
+      weak_factory_(this) {
+  DCHECK(backend_);
+  DCHECK_GT(max_bytes, 0);
+}
+
+HotEntryBackend::~HotEntryBackend() {
+  // Close the entries kept in memory while |backend_| is still around.
+  hot_entries_.Clear();
+}
+
+net::CacheType HotEntryBackend::GetCacheType() const {
+  return backend_->GetCacheType();
+}
+
+int32_t HotEntryBackend::GetEntryCount() const {
+  return backend_->GetEntryCount();
+}
+
+int HotEntryBackend::OpenEntry(const std::string& key,
+                               Entry** entry,
+                               const CompletionCallback& callback) {
+  HotEntryMap::iterator it = hot_entries_.Get(key);
+  if (it != hot_entries_.end()) {
+    // Let the wrapped backend know the entry is still in use, so that it
+    // doesn't evict it.
+    backend_->OnExternalCacheHit(key);
+    *entry = new EntryProxy(it->second);
+    return net::OK;
+  }
+
+  Entry** inner_entry = new Entry*(nullptr);
+  int rv = backend_->OpenEntry(
+      key, inner_entry,
+      base::Bind(&HotEntryBackend::OnEntryOpened, weak_factory_.GetWeakPtr(),
+                 key, base::Owned(inner_entry), entry, callback));
+  if (rv == net::OK)
+    *entry = WrapEntry(key, *inner_entry);
+  return rv;
+}
+
+int HotEntryBackend::CreateEntry(const std::string& key,
+                                 Entry** entry,
+                                 const CompletionCallback& callback) {
+  Invalidate(key);
+  Entry** inner_entry = new Entry*(nullptr);
+  int rv = backend_->CreateEntry(
+      key, inner_entry,
+      base::Bind(&HotEntryBackend::OnEntryOpened, weak_factory_.GetWeakPtr(),
+                 key, base::Owned(inner_entry), entry, callback));
+  if (rv == net::OK)
+    *entry = WrapEntry(key, *inner_entry);
+  return rv;
+}
+
+int HotEntryBackend::DoomEntry(const std::string& key,
+                               const CompletionCallback& callback) {
+  Invalidate(key);
+  return backend_->DoomEntry(key, callback);
+}
+
+int HotEntryBackend::DoomAllEntries(const CompletionCallback& callback) {
+  InvalidateAll();
+  return backend_->DoomAllEntries(callback);
+}
+
+int HotEntryBackend::DoomEntriesBetween(base::Time initial_time,
+                                        base::Time end_time,
+                                        const CompletionCallback& callback) {
+  InvalidateAll();
+  return backend_->DoomEntriesBetween(initial_time, end_time, callback);
+}
+
+int HotEntryBackend::DoomEntriesSince(base::Time initial_time,
+                                      const CompletionCallback& callback) {
+  InvalidateAll();
+  return backend_->DoomEntriesSince(initial_time, callback);
+}
+
+int HotEntryBackend::CalculateSizeOfAllEntries(
+    const CompletionCallback& callback) {
+  return backend_->CalculateSizeOfAllEntries(callback);
+}
+
+std::unique_ptr<Backend::Iterator> HotEntryBackend::CreateIterator() {
+  return std::unique_ptr<Iterator>(
+      new IteratorProxy(backend_->CreateIterator(),
+                        weak_factory_.GetWeakPtr()));
+}
+
+void HotEntryBackend::GetStats(base::StringPairs* stats) {
+  backend_->GetStats(stats);
+  stats->push_back(std::make_pair("Hot entries",
+                                  base::SizeTToString(hot_entries_.size())));
+  stats->push_back(
+      std::make_pair("Hot bytes", base::Int64ToString(hot_bytes_)));
+}
+
+void HotEntryBackend::OnExternalCacheHit(const std::string& key) {
+  backend_->OnExternalCacheHit(key);
+}
+
+Entry* HotEntryBackend::WrapEntry(const std::string& key, Entry* entry) {
+  scoped_refptr<SharedEntry> shared_entry(new SharedEntry(
+      key.empty() ? entry->GetKey() : key, entry, weak_factory_.GetWeakPtr()));
+  open_entries_.insert(
+      std::make_pair(shared_entry->key(), shared_entry.get()));
+  return new EntryProxy(shared_entry);
+}
+
+// static
+void HotEntryBackend::OnEntryOpened(
+    const base::WeakPtr<HotEntryBackend>& backend,
+    const std::string& key,
+    Entry** inner_entry,
+    Entry** entry,
+    const CompletionCallback& callback,
+    int result) {
+  if (result == net::OK) {
+    if (backend) {
+      *entry = backend->WrapEntry(key, *inner_entry);
+    } else {
+      (*inner_entry)->Close();
+      result = net::ERR_FAILED;
+    }
+  }
+  callback.Run(result);
+}
+
+void HotEntryBackend::MaybeKeep(SharedEntry* shared_entry) {
+  if (!shared_entry->HasAllStreams())
+    return;
+  const int64_t size = shared_entry->Size();
+  if (size > kMaxEntrySize || size > max_bytes_)
+    return;
+
+  HotEntryMap::iterator it = hot_entries_.Peek(shared_entry->key());
+  if (it != hot_entries_.end()) {
+    if (it->second.get() == shared_entry)
+      return;
+    hot_bytes_ -= it->second->Size();
+    hot_entries_.Erase(it);
+  }
+  hot_entries_.Put(shared_entry->key(), make_scoped_refptr(shared_entry));
+  hot_bytes_ += size;
+
+  while (hot_bytes_ > max_bytes_) {
+    HotEntryMap::reverse_iterator oldest = hot_entries_.rbegin();
+    hot_bytes_ -= oldest->second->Size();
+    hot_entries_.Erase(oldest);
+  }
+}
+
+void HotEntryBackend::Invalidate(const std::string& key) {
+  HotEntryMap::iterator it = hot_entries_.Peek(key);
+  if (it != hot_entries_.end()) {
+    hot_bytes_ -= it->second->Size();
+    hot_entries_.Erase(it);
+  }
+
+  auto range = open_entries_.equal_range(key);
+  for (auto open_it = range.first; open_it != range.second; ++open_it)
+    open_it->second->Invalidate();
+}
+
+void HotEntryBackend::InvalidateAll() {
+  hot_entries_.Clear();
+  hot_bytes_ = 0;
+  for (const auto& open_entry : open_entries_)
+    open_entry.second->Invalidate();
+}
+
+}  // namespace disk_cache
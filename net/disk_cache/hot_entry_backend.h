@@ -0,0 +1,120 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_HOT_ENTRY_BACKEND_H_
+#define NET_DISK_CACHE_HOT_ENTRY_BACKEND_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace disk_cache {
+
+// A Backend that sits in front of another one and keeps small entries that
+// were recently read in full in memory. Opening such an entry and reading any
+// of its streams completes synchronously, without a round trip to the cache
+// thread, so that hot entries like favicons, fonts and small JSON responses
+// are served in microseconds rather than milliseconds.
+//
+// Entries are only kept while the wrapped backend has them unchanged: writing
+// to an entry, dooming it or creating it anew drops it from memory first, as
+// do DoomAllEntries() and friends. Everything else is passed through to the
+// wrapped backend, which remains the source of truth.
+class NET_EXPORT_PRIVATE HotEntryBackend : public Backend {
+ public:
+  // Entries whose streams add up to more than this are never kept.
+  static const int kMaxEntrySize = 64 * 1024;
+
+  // Keeps up to |max_bytes| of entries in memory in front of |backend|.
+  HotEntryBackend(std::unique_ptr<Backend> backend, int max_bytes);
+  ~HotEntryBackend() override;
+
+  // Returns the number of bytes kept in memory.
+  int64_t hot_bytes() const { return hot_bytes_; }
+
+  // Backend implementation.
+  net::CacheType GetCacheType() const override;
+  int32_t GetEntryCount() const override;
+  int OpenEntry(const std::string& key,
+                Entry** entry,
+                const CompletionCallback& callback) override;
+  int CreateEntry(const std::string& key,
+                  Entry** entry,
+                  const CompletionCallback& callback) override;
+  int DoomEntry(const std::string& key,
+                const CompletionCallback& callback) override;
+  int DoomAllEntries(const CompletionCallback& callback) override;
+  int DoomEntriesBetween(base::Time initial_time,
+                         base::Time end_time,
+                         const CompletionCallback& callback) override;
+  int DoomEntriesSince(base::Time initial_time,
+                       const CompletionCallback& callback) override;
+  int CalculateSizeOfAllEntries(const CompletionCallback& callback) override;
+  std::unique_ptr<Iterator> CreateIterator() override;
+  void GetStats(base::StringPairs* stats) override;
+  void OnExternalCacheHit(const std::string& key) override;
+
+ private:
+  // An open entry of the wrapped backend, shared by all the EntryProxy
+  // objects handed out for it, along with the streams read from it so far.
+  class SharedEntry;
+  // The Entry handed out to callers.
+  class EntryProxy;
+  class IteratorProxy;
+
+  using HotEntryMap =
+      base::MRUCache<std::string, scoped_refptr<SharedEntry>>;
+
+  // Wraps |entry|, just opened or created in the wrapped backend. |key| may
+  // be empty if the caller doesn't know it.
+  Entry* WrapEntry(const std::string& key, Entry* entry);
+
+  // Completes an OpenEntry(), CreateEntry() or OpenNextEntry() call that
+  // the wrapped backend finished asynchronously.
+  static void OnEntryOpened(const base::WeakPtr<HotEntryBackend>& backend,
+                            const std::string& key,
+                            Entry** inner_entry,
+                            Entry** entry,
+                            const CompletionCallback& callback,
+                            int result);
+
+  // Keeps |shared_entry| in memory if all of its streams have been read and
+  // it is small enough, evicting the least recently used entries as needed.
+  void MaybeKeep(SharedEntry* shared_entry);
+
+  // Drops |key| from memory, and keeps any entry for it currently open from
+  // being kept later with the data it has read so far.
+  void Invalidate(const std::string& key);
+
+  // Same as Invalidate(), for every key.
+  void InvalidateAll();
+
+  std::unique_ptr<Backend> backend_;
+  const int64_t max_bytes_;
+
+  // Must be destroyed before |backend_|, since it holds entries open.
+  HotEntryMap hot_entries_;
+  int64_t hot_bytes_;
+
+  // Every SharedEntry alive, by key, so that a write through one of them
+  // invalidates the data read through the others.
+  std::multimap<std::string, SharedEntry*> open_entries_;
+
+  base::WeakPtrFactory<HotEntryBackend> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HotEntryBackend);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_HOT_ENTRY_BACKEND_H_
@@ -0,0 +1,228 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/hot_entry_backend.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/http/mock_http_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+// MockDiskCache expects keys to be the URLs of registered mock transactions.
+const char kKey[] = "http://www.google.com/";
+const char kOtherKey[] = "http://www.example.com/~foo/bar.html";
+
+class HotEntryBackendTest : public testing::Test {
+ protected:
+  explicit HotEntryBackendTest(int max_bytes = 64 * 1024) {
+    std::unique_ptr<net::MockDiskCache> mock_backend(new net::MockDiskCache());
+    mock_backend_ = mock_backend.get();
+    backend_.reset(new HotEntryBackend(std::move(mock_backend), max_bytes));
+  }
+
+  void CreateEntry(const std::string& key,
+                   const std::string& headers,
+                   const std::string& body) {
+    net::TestCompletionCallback callback;
+    Entry* entry = nullptr;
+    ASSERT_EQ(net::OK, callback.GetResult(backend_->CreateEntry(
+                           key, &entry, callback.callback())));
+    WriteStream(entry, 0, headers);
+    WriteStream(entry, 1, body);
+    entry->Close();
+  }
+
+  void WriteStream(Entry* entry, int index, const std::string& data) {
+    scoped_refptr<net::StringIOBuffer> buf(new net::StringIOBuffer(data));
+    net::TestCompletionCallback callback;
+    EXPECT_EQ(static_cast<int>(data.size()),
+              callback.GetResult(entry->WriteData(
+                  index, 0, buf.get(), data.size(), callback.callback(),
+                  true)));
+  }
+
+  Entry* OpenEntry(const std::string& key) {
+    net::TestCompletionCallback callback;
+    Entry* entry = nullptr;
+    int rv = callback.GetResult(
+        backend_->OpenEntry(key, &entry, callback.callback()));
+    return rv == net::OK ? entry : nullptr;
+  }
+
+  // Reads stream |index| of |entry| in chunks of |chunk_size| bytes.
+  std::string ReadStream(Entry* entry, int index, int chunk_size) {
+    std::string data;
+    scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(chunk_size));
+    while (true) {
+      net::TestCompletionCallback callback;
+      int rv = callback.GetResult(entry->ReadData(
+          index, data.size(), buf.get(), chunk_size, callback.callback()));
+      EXPECT_LE(0, rv);
+      if (rv <= 0)
+        return data;
+      data.append(buf->data(), rv);
+    }
+  }
+
+  // Opens |key| and reads it whole, as the HTTP cache does for a hit.
+  void ReadEntry(const std::string& key) {
+    Entry* entry = OpenEntry(key);
+    ASSERT_TRUE(entry);
+    ReadStream(entry, 0, entry->GetDataSize(0));
+    ReadStream(entry, 1, 4096);
+    entry->Close();
+  }
+
+  net::MockDiskCache* mock_backend_;
+  std::unique_ptr<HotEntryBackend> backend_;
+};
+
+TEST_F(HotEntryBackendTest, KeepsEntriesReadWhole) {
+  CreateEntry(kKey, "headers", "body");
+  EXPECT_EQ(0, backend_->hot_bytes());
+
+  ReadEntry(kKey);
+  EXPECT_LT(0, backend_->hot_bytes());
+  EXPECT_EQ(1, mock_backend_->open_count());
+
+  // The next open and reads are served from memory.
+  net::TestCompletionCallback callback;
+  Entry* entry = nullptr;
+  ASSERT_EQ(net::OK, backend_->OpenEntry(kKey, &entry, callback.callback()));
+  EXPECT_EQ(1, mock_backend_->open_count());
+  EXPECT_EQ(kKey, entry->GetKey());
+  EXPECT_EQ(7, entry->GetDataSize(0));
+  EXPECT_EQ(4, entry->GetDataSize(1));
+  EXPECT_EQ(0, entry->GetDataSize(2));
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(16));
+  EXPECT_EQ(7, entry->ReadData(0, 0, buf.get(), 16, callback.callback()));
+  EXPECT_EQ("headers", std::string(buf->data(), 7));
+  EXPECT_EQ(2, entry->ReadData(1, 2, buf.get(), 16, callback.callback()));
+  EXPECT_EQ("dy", std::string(buf->data(), 2));
+  EXPECT_EQ(0, entry->ReadData(1, 4, buf.get(), 16, callback.callback()));
+  EXPECT_FALSE(callback.have_result());
+  entry->Close();
+}
+
+TEST_F(HotEntryBackendTest, DoesNotKeepEntriesReadInChunks) {
+  CreateEntry(kKey, "headers", "a longer body");
+  Entry* entry = OpenEntry(kKey);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("headers", ReadStream(entry, 0, 100));
+  EXPECT_EQ("a longer body", ReadStream(entry, 1, 4));
+  entry->Close();
+  EXPECT_EQ(0, backend_->hot_bytes());
+}
+
+TEST_F(HotEntryBackendTest, DoesNotKeepLargeEntries) {
+  CreateEntry(kKey, "headers",
+              std::string(HotEntryBackend::kMaxEntrySize, 'a'));
+  Entry* entry = OpenEntry(kKey);
+  ASSERT_TRUE(entry);
+  ReadStream(entry, 0, 100);
+  ReadStream(entry, 1, HotEntryBackend::kMaxEntrySize * 2);
+  entry->Close();
+  EXPECT_EQ(0, backend_->hot_bytes());
+}
+
+TEST_F(HotEntryBackendTest, WriteDropsEntry) {
+  CreateEntry(kKey, "headers", "body");
+  ReadEntry(kKey);
+  ASSERT_LT(0, backend_->hot_bytes());
+
+  Entry* entry = OpenEntry(kKey);
+  ASSERT_TRUE(entry);
+  WriteStream(entry, 0, "new headers");
+  EXPECT_EQ(0, backend_->hot_bytes());
+  // Reads through the same entry see the new data.
+  EXPECT_EQ("new headers", ReadStream(entry, 0, 100));
+  entry->Close();
+
+  // Data read before the write isn't kept either.
+  Entry* reader = OpenEntry(kKey);
+  ASSERT_TRUE(reader);
+  ReadStream(reader, 0, 100);
+  Entry* writer = OpenEntry(kKey);
+  ASSERT_TRUE(writer);
+  WriteStream(writer, 1, "new body");
+  writer->Close();
+  EXPECT_EQ("new body", ReadStream(reader, 1, 100));
+  reader->Close();
+  EXPECT_EQ(0, backend_->hot_bytes());
+}
+
+TEST_F(HotEntryBackendTest, DoomDropsEntries) {
+  CreateEntry(kKey, "headers", "body");
+  CreateEntry(kOtherKey, "headers", "body");
+  ReadEntry(kKey);
+  ReadEntry(kOtherKey);
+  ASSERT_LT(0, backend_->hot_bytes());
+
+  net::TestCompletionCallback callback;
+  EXPECT_EQ(net::OK, callback.GetResult(
+                         backend_->DoomEntry(kKey, callback.callback())));
+  EXPECT_FALSE(OpenEntry(kKey));
+  EXPECT_LT(0, backend_->hot_bytes());
+
+  // MockDiskCache doesn't implement DoomAllEntries(), but the hot entries are
+  // dropped before the call reaches it.
+  callback.GetResult(backend_->DoomAllEntries(callback.callback()));
+  EXPECT_EQ(0, backend_->hot_bytes());
+}
+
+TEST_F(HotEntryBackendTest, EntryDoomDropsEntry) {
+  CreateEntry(kKey, "headers", "body");
+  ReadEntry(kKey);
+  Entry* entry = OpenEntry(kKey);
+  ASSERT_TRUE(entry);
+  entry->Doom();
+  entry->Close();
+  EXPECT_EQ(0, backend_->hot_bytes());
+  EXPECT_FALSE(OpenEntry(kKey));
+}
+
+class SmallHotEntryBackendTest : public HotEntryBackendTest {
+ protected:
+  SmallHotEntryBackendTest() : HotEntryBackendTest(100) {}
+};
+
+TEST_F(SmallHotEntryBackendTest, EvictsLeastRecentlyUsed) {
+  const std::string body(40, 'a');
+  CreateEntry(kKey, "headers", body);
+  CreateEntry(kOtherKey, "headers", body);
+
+  ReadEntry(kKey);
+  const int64_t one_entry = backend_->hot_bytes();
+  ASSERT_LT(0, one_entry);
+  ReadEntry(kOtherKey);
+  EXPECT_LT(one_entry, backend_->hot_bytes());
+  EXPECT_GE(100, backend_->hot_bytes());
+
+  // Only the most recently read entry is left.
+  EXPECT_EQ(2, mock_backend_->open_count());
+  Entry* entry = OpenEntry(kOtherKey);
+  ASSERT_TRUE(entry);
+  entry->Close();
+  EXPECT_EQ(2, mock_backend_->open_count());
+  entry = OpenEntry(kKey);
+  ASSERT_TRUE(entry);
+  entry->Close();
+  EXPECT_EQ(3, mock_backend_->open_count());
+}
+
+}  // namespace
+
+}  // namespace disk_cache
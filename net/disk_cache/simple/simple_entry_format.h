@@ -18,6 +18,7 @@ namespace disk_cache {
 const uint64_t kSimpleInitialMagicNumber = UINT64_C(0xfcfb6d1ba7725c30);
 const uint64_t kSimpleFinalMagicNumber = UINT64_C(0xf4fa6f45970d41d8);
 const uint64_t kSimpleSparseRangeMagicNumber = UINT64_C(0xeb97bf016553676b);
+const uint64_t kSimplePackedRecordMagicNumber = UINT64_C(0x9d3b5e0c71f2a846);
 
 // A file containing stream 0 and stream 1 in the Simple cache consists of:
 //   - a SimpleFileHeader.
@@ -76,6 +77,32 @@ struct SimpleFileSparseRangeHeader {
   uint32_t data_crc32;
 };
 
+// A block file of packed small entries (see SimplePackedStore) is a sequence
+// of records, each made of:
+//   - a SimplePackedRecordHeader.
+//   - the key.
+//   - the data from stream 0.
+//   - the data from stream 1.
+// A record with FLAG_REMOVED set has no key or data, and marks the entry of
+// |entry_hash| as removed by the records before it.
+struct NET_EXPORT_PRIVATE SimplePackedRecordHeader {
+  enum Flags {
+    FLAG_REMOVED = (1U << 0),
+  };
+
+  SimplePackedRecordHeader();
+
+  uint64_t magic_number;
+  uint64_t entry_hash;
+  int64_t last_modified;  // base::Time internal value.
+  uint32_t flags;
+  uint32_t key_length;
+  uint32_t stream_0_size;
+  uint32_t stream_1_size;
+  uint32_t data_crc32;    // Of the key and the data.
+  uint32_t header_crc32;  // Of the fields above.
+};
+
 }  // namespace disk_cache
 
 #endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_ENTRY_FORMAT_H_
@@ -256,6 +256,7 @@ void SimpleIndex::Insert(uint64_t entry_hash) {
   // creating the new entry, and then UpdateEntrySize will be called.
   InsertInEntrySet(
       entry_hash, EntryMetadata(base::Time::Now(), 0), &entries_set_);
+  changed_entries_.insert(entry_hash);
   if (!initialized_)
     removed_entries_.erase(entry_hash);
   PostponeWritingToDisk();
@@ -268,6 +269,7 @@ void SimpleIndex::Remove(uint64_t entry_hash) {
     UpdateEntryIteratorSize(&it, 0);
     entries_set_.erase(it);
   }
+  changed_entries_.insert(entry_hash);
 
   if (!initialized_)
     removed_entries_.insert(entry_hash);
@@ -289,6 +291,7 @@ bool SimpleIndex::UseIfExists(uint64_t entry_hash) {
     // If not initialized, always return true, forcing it to go to the disk.
     return !initialized_;
   it->second.SetLastUsedTime(base::Time::Now());
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   return true;
 }
@@ -395,6 +398,7 @@ void SimpleIndex::UpdateEntryIteratorSize(EntrySet::iterator* it,
   cache_size_ -= (*it)->second.GetEntrySize();
   cache_size_ += entry_size;
   (*it)->second.SetEntrySize(entry_size);
+  changed_entries_.insert((*it)->first);
 }
 
 void SimpleIndex::MergeInitializingSet(
@@ -485,8 +489,11 @@ void SimpleIndex::WriteToDisk(IndexWriteToDiskReason reason) {
   }
   last_write_to_disk_ = start;
 
-  index_file_->WriteToDisk(reason, entries_set_, cache_size_, start,
-                           app_on_background_, base::Closure());
+  const HashList changed_hashes(changed_entries_.begin(),
+                               changed_entries_.end());
+  changed_entries_.clear();
+  index_file_->WriteToDisk(reason, entries_set_, changed_hashes, cache_size_,
+                           start, app_on_background_, base::Closure());
 }
 
 }  // namespace disk_cache
@@ -9,11 +9,11 @@
 
 #include <list>
 #include <memory>
-#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/containers/flat_hash_map.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
@@ -126,7 +126,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   // entry.
   bool UpdateEntrySize(uint64_t entry_hash, int64_t entry_size);
 
-  using EntrySet = std::unordered_map<uint64_t, EntryMetadata>;
+  using EntrySet = base::flat_hash_map<uint64_t, EntryMetadata>;
 
   static void InsertInEntrySet(uint64_t entry_hash,
                                const EntryMetadata& entry_metadata,
@@ -163,6 +163,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteQueued);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteExecuted);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWritePostponed);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteChangedHashes);
 
   void StartEvictionIfNeeded();
   void EvictionDone(int result);
@@ -197,6 +198,9 @@ class NET_EXPORT_PRIVATE SimpleIndex
   // This stores all the entry_hash of entries that are removed during
   // initialization.
   std::unordered_set<uint64_t> removed_entries_;
+  // The entry_hash of the entries inserted, updated or removed since the index
+  // was last written to disk, so that the write can be limited to them.
+  std::unordered_set<uint64_t> changed_entries_;
   bool initialized_;
   IndexInitMethod init_method_;
 
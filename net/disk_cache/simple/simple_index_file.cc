@@ -21,6 +21,7 @@
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index.h"
+#include "net/disk_cache/simple/simple_index_table.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "third_party/zlib/zlib.h"
@@ -102,16 +103,29 @@ void UmaRecordStaleIndexQuality(int missed_entry_count,
                    STALE_INDEX_MAX);
 }
 
-bool WritePickleFile(base::Pickle* pickle, const base::FilePath& file_name) {
+void UmaRecordIndexWriteToDiskTime(const base::TimeTicks& start_time,
+                                   bool app_on_background,
+                                   net::CacheType cache_type) {
+  if (app_on_background) {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexWriteToDiskTime.Background", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  } else {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexWriteToDiskTime.Foreground", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  }
+}
+
+bool WriteIndexFile(const std::string& data, const base::FilePath& file_name) {
   File file(
       file_name,
       File::FLAG_CREATE_ALWAYS | File::FLAG_WRITE | File::FLAG_SHARE_DELETE);
   if (!file.IsValid())
     return false;
 
-  int bytes_written =
-      file.Write(0, static_cast<const char*>(pickle->data()), pickle->size());
-  if (bytes_written != base::checked_cast<int>(pickle->size())) {
+  int bytes_written = file.Write(0, data.data(), data.size());
+  if (bytes_written != base::checked_cast<int>(data.size())) {
     simple_util::SimpleCacheDeleteFile(file_name);
     return false;
   }
@@ -170,7 +184,8 @@ void ProcessEntryFile(SimpleIndex::EntrySet* entries,
 SimpleIndexLoadResult::SimpleIndexLoadResult()
     : did_load(false),
       index_write_reason(SimpleIndex::INDEX_WRITE_REASON_MAX),
-      flush_required(false) {}
+      flush_required(false),
+      table_slot_count(0) {}
 
 SimpleIndexLoadResult::~SimpleIndexLoadResult() {
 }
@@ -179,6 +194,7 @@ void SimpleIndexLoadResult::Reset() {
   did_load = false;
   index_write_reason = SimpleIndex::INDEX_WRITE_REASON_MAX;
   flush_required = false;
+  table_slot_count = 0;
   entries.clear();
 }
 
@@ -242,20 +258,26 @@ bool SimpleIndexFile::IndexMetadata::Deserialize(base::PickleIterator* it) {
   return true;
 }
 
-void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
-                                      const base::FilePath& cache_directory,
-                                      const base::FilePath& index_filename,
-                                      const base::FilePath& temp_index_filename,
-                                      std::unique_ptr<base::Pickle> pickle,
-                                      const base::TimeTicks& start_time,
-                                      bool app_on_background) {
+// static
+bool SimpleIndexFile::SyncWriteToDisk(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& index_filename,
+    const base::FilePath& temp_index_filename,
+    std::unique_ptr<SimpleIndex::EntrySet> entries,
+    SimpleIndex::IndexWriteToDiskReason reason,
+    uint64_t cache_size,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
   DCHECK_EQ(index_filename.DirName().value(),
             temp_index_filename.DirName().value());
+  // Later writes update the table in place, so the previous index file must
+  // not survive a failure.
   base::FilePath index_file_directory = temp_index_filename.DirName();
   if (!base::DirectoryExists(index_file_directory) &&
       !base::CreateDirectory(index_file_directory)) {
     LOG(ERROR) << "Could not create a directory to hold the index file";
-    return;
+    return false;
   }
 
   // There is a chance that the index containing all the necessary data about
@@ -266,30 +288,62 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   base::Time cache_dir_mtime;
   if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
     LOG(ERROR) << "Could obtain information about cache age";
-    return;
+    simple_util::SimpleCacheDeleteFile(index_filename);
+    return false;
   }
-  SerializeFinalData(cache_dir_mtime, pickle.get());
-  if (!WritePickleFile(pickle.get(), temp_index_filename)) {
+  const std::string table = SimpleIndexTable::Create(
+      *entries,
+      SimpleIndexTable::Metadata(reason, cache_size, cache_dir_mtime));
+  if (!WriteIndexFile(table, temp_index_filename)) {
     LOG(ERROR) << "Failed to write the temporary index file";
-    return;
+    simple_util::SimpleCacheDeleteFile(index_filename);
+    return false;
   }
 
   // Atomically rename the temporary index file to become the real one.
   // TODO(gavinp): DCHECK when not shutting down, since that is very strange.
   // The rename failing during shutdown is legal because it's legal to begin
   // erasing a cache as soon as the destructor has been called.
-  if (!base::ReplaceFile(temp_index_filename, index_filename, NULL))
-    return;
+  if (!base::ReplaceFile(temp_index_filename, index_filename, NULL)) {
+    simple_util::SimpleCacheDeleteFile(index_filename);
+    return false;
+  }
 
-  if (app_on_background) {
-    SIMPLE_CACHE_UMA(TIMES,
-                     "IndexWriteToDiskTime.Background", cache_type,
-                     (base::TimeTicks::Now() - start_time));
-  } else {
-    SIMPLE_CACHE_UMA(TIMES,
-                     "IndexWriteToDiskTime.Foreground", cache_type,
-                     (base::TimeTicks::Now() - start_time));
+  UmaRecordIndexWriteToDiskTime(start_time, app_on_background, cache_type);
+  return true;
+}
+
+// static
+bool SimpleIndexFile::SyncUpdateOnDisk(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& index_filename,
+    std::unique_ptr<SimpleIndex::EntrySet> updated_entries,
+    std::unique_ptr<SimpleIndex::HashList> removed_hashes,
+    SimpleIndex::IndexWriteToDiskReason reason,
+    uint64_t cache_size,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
+  base::Time cache_dir_mtime;
+  bool updated = simple_util::GetMTime(cache_directory, &cache_dir_mtime);
+  if (updated) {
+    base::MemoryMappedFile index_file_map;
+    updated = index_file_map.Initialize(index_filename,
+                                        base::MemoryMappedFile::READ_WRITE) &&
+              SimpleIndexTable::Update(
+                  index_file_map.data(), index_file_map.length(),
+                  *updated_entries, *removed_hashes,
+                  SimpleIndexTable::Metadata(reason, cache_size,
+                                             cache_dir_mtime));
   }
+  if (!updated) {
+    LOG(ERROR) << "Failed to update the index file";
+    simple_util::SimpleCacheDeleteFile(index_filename);
+    return false;
+  }
+
+  UmaRecordIndexWriteToDiskTime(start_time, app_on_background, cache_type);
+  return true;
 }
 
 bool SimpleIndexFile::IndexMetadata::CheckIndexMetadata() {
@@ -317,7 +371,9 @@ SimpleIndexFile::SimpleIndexFile(
       index_file_(cache_directory_.AppendASCII(kIndexDirectory)
                       .AppendASCII(kIndexFileName)),
       temp_index_file_(cache_directory_.AppendASCII(kIndexDirectory)
-                           .AppendASCII(kTempIndexFileName)) {
+                           .AppendASCII(kTempIndexFileName)),
+      table_slot_count_(0),
+      weak_ptr_factory_(this) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -329,26 +385,68 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
                                   cache_type_,
                                   cache_last_modified, cache_directory_,
                                   index_file_, out_result);
-  worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
+  worker_pool_->PostTaskAndReply(
+      FROM_HERE, task,
+      base::Bind(&SimpleIndexFile::OnIndexLoaded,
+                 weak_ptr_factory_.GetWeakPtr(), out_result, callback));
 }
 
 void SimpleIndexFile::WriteToDisk(SimpleIndex::IndexWriteToDiskReason reason,
                                   const SimpleIndex::EntrySet& entry_set,
+                                  const SimpleIndex::HashList& changed_hashes,
                                   uint64_t cache_size,
                                   const base::TimeTicks& start,
                                   bool app_on_background,
                                   const base::Closure& callback) {
   UmaRecordIndexWriteReason(reason, cache_type_);
-  IndexMetadata index_metadata(reason, entry_set.size(), cache_size);
-  std::unique_ptr<base::Pickle> pickle = Serialize(index_metadata, entry_set);
-  base::Closure task =
-      base::Bind(&SimpleIndexFile::SyncWriteToDisk,
-                 cache_type_, cache_directory_, index_file_, temp_index_file_,
-                 base::Passed(&pickle), start, app_on_background);
-  if (callback.is_null())
-    cache_thread_->PostTask(FROM_HERE, task);
-  else
-    cache_thread_->PostTaskAndReply(FROM_HERE, task, callback);
+  base::Callback<bool()> task;
+  if (table_slot_count_ && entry_set.size() <=
+      SimpleIndexTable::GetMaxEntryCount(table_slot_count_)) {
+    // The table holds the entries as of the previous write: only the changed
+    // ones need writing.
+    std::unique_ptr<SimpleIndex::EntrySet> updated_entries(
+        new SimpleIndex::EntrySet);
+    std::unique_ptr<SimpleIndex::HashList> removed_hashes(
+        new SimpleIndex::HashList);
+    for (uint64_t hash : changed_hashes) {
+      SimpleIndex::EntrySet::const_iterator it = entry_set.find(hash);
+      if (it == entry_set.end())
+        removed_hashes->push_back(hash);
+      else
+        SimpleIndex::InsertInEntrySet(hash, it->second, updated_entries.get());
+    }
+    task = base::Bind(&SimpleIndexFile::SyncUpdateOnDisk, cache_type_,
+                      cache_directory_, index_file_,
+                      base::Passed(&updated_entries),
+                      base::Passed(&removed_hashes), reason, cache_size, start,
+                      app_on_background);
+  } else {
+    table_slot_count_ = SimpleIndexTable::GetSlotCount(entry_set.size());
+    std::unique_ptr<SimpleIndex::EntrySet> entries(
+        new SimpleIndex::EntrySet(entry_set));
+    task = base::Bind(&SimpleIndexFile::SyncWriteToDisk, cache_type_,
+                      cache_directory_, index_file_, temp_index_file_,
+                      base::Passed(&entries), reason, cache_size, start,
+                      app_on_background);
+  }
+  base::PostTaskAndReplyWithResult(
+      cache_thread_.get(), FROM_HERE, task,
+      base::Bind(&SimpleIndexFile::OnWriteDone,
+                 weak_ptr_factory_.GetWeakPtr(), callback));
+}
+
+void SimpleIndexFile::OnIndexLoaded(SimpleIndexLoadResult* result,
+                                    const base::Closure& callback) {
+  table_slot_count_ = result->table_slot_count;
+  callback.Run();
+}
+
+void SimpleIndexFile::OnWriteDone(const base::Closure& callback,
+                                  bool success) {
+  if (!success)
+    table_slot_count_ = 0;
+  if (!callback.is_null())
+    callback.Run();
 }
 
 // static
@@ -439,11 +537,26 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
     return;
   }
 
-  SimpleIndexFile::Deserialize(
-      reinterpret_cast<const char*>(index_file_map.data()),
-      index_file_map.length(),
-      out_last_cache_seen_by_index,
-      out_result);
+  if (SimpleIndexTable::IsTable(index_file_map.data(),
+                                index_file_map.length())) {
+    SimpleIndexTable::Metadata metadata;
+    if (SimpleIndexTable::Load(index_file_map.data(), index_file_map.length(),
+                               &out_result->entries, &metadata,
+                               &out_result->table_slot_count)) {
+      *out_last_cache_seen_by_index = metadata.cache_last_modified;
+      out_result->index_write_reason = metadata.reason;
+      out_result->did_load = true;
+    } else {
+      LOG(WARNING) << "Corrupt Simple Index File.";
+      out_result->Reset();
+    }
+  } else {
+    SimpleIndexFile::Deserialize(
+        reinterpret_cast<const char*>(index_file_map.data()),
+        index_file_map.length(),
+        out_last_cache_seen_by_index,
+        out_result);
+  }
 
   if (!out_result->did_load)
     simple_util::SimpleCacheDeleteFile(index_filename);
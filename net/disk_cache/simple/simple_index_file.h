@@ -5,6 +5,7 @@
 #ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_FILE_H_
 #define NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_FILE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
@@ -15,6 +16,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "base/pickle.h"
 #include "net/base/cache_type.h"
 #include "net/base/net_export.h"
@@ -39,13 +41,16 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   SimpleIndex::IndexWriteToDiskReason index_write_reason;
   SimpleIndex::IndexInitMethod init_method;
   bool flush_required;
+  // The number of slots of the SimpleIndexTable the entries were loaded from,
+  // or 0 if they weren't.
+  size_t table_slot_count;
 };
 
-// Simple Index File format is a pickle of IndexMetadata and EntryMetadata
-// objects. The file format is as follows: one instance of |IndexMetadata|
-// followed by |EntryMetadata| repeated |entry_count| times. To learn more about
-// the format see |SimpleIndexFile::Serialize()| and
-// |SimpleIndexFile::LoadFromDisk()|.
+// The index file is a SimpleIndexTable, which writes update in place. Files in
+// the legacy format, a pickle of IndexMetadata and EntryMetadata objects,
+// are still read: one instance of |IndexMetadata| followed by |EntryMetadata|
+// repeated |entry_count| times. To learn more about the legacy format see
+// |SimpleIndexFile::Serialize()| and |SimpleIndexFile::LoadFromDisk()|.
 //
 // The non-static methods must run on the IO thread. All the real
 // work is done in the static methods, which are run on the cache thread
@@ -93,9 +98,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                 const base::Closure& callback,
                                 SimpleIndexLoadResult* out_result);
 
-  // Write the specified set of entries to disk.
+  // Write the specified set of entries to disk. |changed_hashes| lists the
+  // entries inserted, updated or removed since the previous write, or since
+  // the entries were loaded; when the index file is known to hold the rest,
+  // only those are written.
   virtual void WriteToDisk(SimpleIndex::IndexWriteToDiskReason reason,
                            const SimpleIndex::EntrySet& entry_set,
+                           const SimpleIndex::HashList& changed_hashes,
                            uint64_t cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background,
@@ -111,6 +120,14 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   // prevent reallocation on the IO thread when merging in new live entries.
   static const int kExtraSizeForMerge = 512;
 
+  // Records whether |result| was loaded from a table, then runs |callback|.
+  void OnIndexLoaded(SimpleIndexLoadResult* result,
+                     const base::Closure& callback);
+
+  // Forgets about the table after a failed write, then runs |callback| if it
+  // is not null.
+  void OnWriteDone(const base::Closure& callback, bool success);
+
   // Synchronous (IO performing) implementation of LoadIndexEntries.
   static void SyncLoadIndexEntries(net::CacheType cache_type,
                                    base::Time cache_last_modified,
@@ -154,15 +171,31 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
       const base::FilePath& cache_path,
       const EntryFileCallback& entry_file_callback);
 
-  // Writes the index file to disk atomically.
-  static void SyncWriteToDisk(net::CacheType cache_type,
+  // Writes a new table of |entries| to disk atomically. Returns false, after
+  // deleting the index file, if it fails.
+  static bool SyncWriteToDisk(net::CacheType cache_type,
                               const base::FilePath& cache_directory,
                               const base::FilePath& index_filename,
                               const base::FilePath& temp_index_filename,
-                              std::unique_ptr<base::Pickle> pickle,
+                              std::unique_ptr<SimpleIndex::EntrySet> entries,
+                              SimpleIndex::IndexWriteToDiskReason reason,
+                              uint64_t cache_size,
                               const base::TimeTicks& start_time,
                               bool app_on_background);
 
+  // Updates the table in the index file in place. Returns false, after
+  // deleting the index file, if it fails.
+  static bool SyncUpdateOnDisk(
+      net::CacheType cache_type,
+      const base::FilePath& cache_directory,
+      const base::FilePath& index_filename,
+      std::unique_ptr<SimpleIndex::EntrySet> updated_entries,
+      std::unique_ptr<SimpleIndex::HashList> removed_hashes,
+      SimpleIndex::IndexWriteToDiskReason reason,
+      uint64_t cache_size,
+      const base::TimeTicks& start_time,
+      bool app_on_background);
+
   // Scan the index directory for entries, returning an EntrySet of all entries
   // found.
   static void SyncRestoreFromDisk(const base::FilePath& cache_directory,
@@ -187,6 +220,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   const base::FilePath index_file_;
   const base::FilePath temp_index_file_;
 
+  // The number of slots of the table in the index file once the writes posted
+  // so far are done, or 0 if it is unknown and the next write must create a
+  // new table.
+  size_t table_slot_count_;
+
+  base::WeakPtrFactory<SimpleIndexFile> weak_ptr_factory_;
+
   static const char kIndexDirectory[];
   static const char kIndexFileName[];
   static const char kTempIndexFileName[];
@@ -26,6 +26,7 @@
 #include "net/disk_cache/simple/simple_backend_version.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_index.h"
+#include "net/disk_cache/simple/simple_index_table.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "net/disk_cache/simple/simple_version_upgrade.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -140,6 +141,8 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
     return temp_index_file_;
   }
 
+  size_t table_slot_count() const { return table_slot_count_; }
+
   bool CreateIndexFileDirectory() const {
     return base::CreateDirectory(index_file_.DirName());
   }
@@ -245,8 +248,8 @@ TEST_F(SimpleIndexFileTest, WriteThenLoadIndex) {
   {
     WrappedSimpleIndexFile simple_index_file(cache_dir.path());
     simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN,
-                                  entries, kCacheSize, base::TimeTicks(), false,
-                                  closure.closure());
+                                  entries, SimpleIndex::HashList(), kCacheSize,
+                                  base::TimeTicks(), false, closure.closure());
     closure.WaitForResult();
     EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
   }
@@ -268,6 +271,104 @@ TEST_F(SimpleIndexFileTest, WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+// Tests that once the index file is written, further writes update it in place
+// with the changed entries only.
+TEST_F(SimpleIndexFileTest, IncrementalWrite) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+
+  SimpleIndex::EntrySet entries;
+  for (uint64_t hash = 1; hash <= 100; ++hash)
+    SimpleIndex::InsertInEntrySet(hash, EntryMetadata(Time(), hash), &entries);
+  net::TestClosure closure;
+  simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN,
+                                entries, SimpleIndex::HashList(), 5050U,
+                                base::TimeTicks(), false, closure.closure());
+  closure.WaitForResult();
+  EXPECT_EQ(SimpleIndexTable::GetSlotCount(entries.size()),
+            simple_index_file.table_slot_count());
+
+  // An update in place doesn't go through the temporary file.
+  const std::string kDummyData = "nothing to be seen here";
+  const base::FilePath& temp_index_path =
+      simple_index_file.GetTempIndexFilePath();
+  ASSERT_EQ(
+      static_cast<int>(kDummyData.size()),
+      base::WriteFile(temp_index_path, kDummyData.data(), kDummyData.size()));
+
+  entries.erase(10);
+  entries.erase(20);
+  entries[30] = EntryMetadata(Time(), 300);
+  SimpleIndex::InsertInEntrySet(1000, EntryMetadata(Time(), 1000), &entries);
+  SimpleIndex::HashList changed_hashes = {10, 20, 30, 1000};
+  simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_IDLE, entries,
+                                changed_hashes, 6290U, base::TimeTicks(), false,
+                                closure.closure());
+  closure.WaitForResult();
+  EXPECT_TRUE(base::PathExists(temp_index_path));
+  EXPECT_NE(0U, simple_index_file.table_slot_count());
+
+  base::Time cache_mtime;
+  ASSERT_TRUE(simple_util::GetMTime(cache_dir.path(), &cache_mtime));
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(cache_mtime, closure.closure(),
+                                     &load_index_result);
+  closure.WaitForResult();
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(SimpleIndex::INDEX_WRITE_REASON_IDLE,
+            load_index_result.index_write_reason);
+  ASSERT_EQ(entries.size(), load_index_result.entries.size());
+  for (const auto& entry : entries) {
+    SimpleIndex::EntrySet::const_iterator it =
+        load_index_result.entries.find(entry.first);
+    ASSERT_TRUE(it != load_index_result.entries.end());
+    EXPECT_TRUE(CompareTwoEntryMetadata(entry.second, it->second));
+  }
+}
+
+// Tests that an index file which can't be updated is rewritten by the next
+// write.
+TEST_F(SimpleIndexFileTest, IncrementalWriteOfCorruptIndex) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 11), &entries);
+  net::TestClosure closure;
+  simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN,
+                                entries, SimpleIndex::HashList(), 11U,
+                                base::TimeTicks(), false, closure.closure());
+  closure.WaitForResult();
+
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  const std::string kDummyData = "nothing to be seen here";
+  ASSERT_EQ(static_cast<int>(kDummyData.size()),
+            base::WriteFile(index_path, kDummyData.data(), kDummyData.size()));
+  SimpleIndex::InsertInEntrySet(22, EntryMetadata(Time(), 22), &entries);
+  simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_IDLE, entries,
+                                SimpleIndex::HashList(1, 22), 33U,
+                                base::TimeTicks(), false, closure.closure());
+  closure.WaitForResult();
+  EXPECT_FALSE(base::PathExists(index_path));
+  EXPECT_EQ(0U, simple_index_file.table_slot_count());
+
+  simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_IDLE, entries,
+                                SimpleIndex::HashList(), 33U,
+                                base::TimeTicks(), false, closure.closure());
+  closure.WaitForResult();
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(index_path, &contents));
+  SimpleIndex::EntrySet loaded_entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+  EXPECT_TRUE(SimpleIndexTable::Load(contents.data(), contents.size(),
+                                     &loaded_entries, &metadata, &slot_count));
+  EXPECT_EQ(2U, loaded_entries.size());
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
@@ -353,16 +454,14 @@ TEST_F(SimpleIndexFileTest, SimpleCacheUpgrade) {
       cache_path.AppendASCII("index-dir").AppendASCII("the-real-index");
   EXPECT_TRUE(base::PathExists(index_file_path));
 
-  // Verify that the version of the index file is correct.
+  // Verify that the format of the index file is correct.
   std::string contents;
   EXPECT_TRUE(base::ReadFileToString(index_file_path, &contents));
-  base::Time when_index_last_saw_cache;
-  SimpleIndexLoadResult deserialize_result;
-  WrappedSimpleIndexFile::Deserialize(contents.data(),
-                                      contents.size(),
-                                      &when_index_last_saw_cache,
-                                      &deserialize_result);
-  EXPECT_TRUE(deserialize_result.did_load);
+  SimpleIndex::EntrySet entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+  EXPECT_TRUE(SimpleIndexTable::Load(contents.data(), contents.size(),
+                                     &entries, &metadata, &slot_count));
 }
 
 TEST_F(SimpleIndexFileTest, OverwritesStaleTempFile) {
@@ -386,8 +485,8 @@ TEST_F(SimpleIndexFileTest, OverwritesStaleTempFile) {
   SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 11), &entries);
   net::TestClosure closure;
   simple_index_file.WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN,
-                                entries, 120U, base::TimeTicks(), false,
-                                closure.closure());
+                                entries, SimpleIndex::HashList(), 120U,
+                                base::TimeTicks(), false, closure.closure());
   closure.WaitForResult();
 
   // Check that the temporary file was deleted and the index file was created.
@@ -0,0 +1,361 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_index_table.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/logging.h"
+#include "third_party/zlib/zlib.h"
+
+namespace disk_cache {
+
+namespace {
+
+const uint64_t kTableMagicNumber = UINT64_C(0x656c626174786469);
+const uint32_t kTableVersion = 1;
+
+const size_t kPageSize = 4096;
+const size_t kSlotsPerPage = 253;
+
+// Tables are created with at least twice as many slots as entries, and can be
+// updated until three quarters of the slots are used.
+const size_t kCreateSlotsPerEntry = 2;
+const size_t kMaxLoadNumerator = 3;
+const size_t kMaxLoadDenominator = 4;
+
+struct Slot {
+  uint64_t hash;
+  // An EntryMetadata, copied with memcpy() as the file holds no objects.
+  char metadata[sizeof(EntryMetadata)];
+};
+
+struct Page {
+  Slot slots[kSlotsPerPage];
+  // Bit i is set if slots[i] holds an entry.
+  uint32_t used[(kSlotsPerPage + 31) / 32];
+  uint32_t reserved[3];
+  // Of the rest of the page.
+  uint32_t crc;
+};
+static_assert(sizeof(Page) == kPageSize, "incorrect page size");
+
+// The header is at the start of the first page, and followed by zeros.
+struct Header {
+  uint64_t magic_number;
+  uint32_t version;
+  // The number of pages following the header's.
+  uint32_t page_count;
+  uint64_t entry_count;
+  uint64_t cache_size;
+  int64_t cache_last_modified;
+  uint32_t reason;
+  // Of the fields above.
+  uint32_t crc;
+};
+static_assert(sizeof(Header) <= kPageSize, "header larger than a page");
+
+uint32_t CalculateCRC(const void* data, size_t size) {
+  return crc32(crc32(0, Z_NULL, 0), static_cast<const Bytef*>(data), size);
+}
+
+uint32_t CalculatePageCRC(const Page& page) {
+  return CalculateCRC(&page, offsetof(Page, crc));
+}
+
+uint32_t CalculateHeaderCRC(const Header& header) {
+  return CalculateCRC(&header, offsetof(Header, crc));
+}
+
+void SetHeader(const SimpleIndexTable::Metadata& metadata,
+               size_t page_count,
+               size_t entry_count,
+               Header* header) {
+  header->magic_number = kTableMagicNumber;
+  header->version = kTableVersion;
+  header->page_count = static_cast<uint32_t>(page_count);
+  header->entry_count = entry_count;
+  header->cache_size = metadata.cache_size;
+  header->cache_last_modified = metadata.cache_last_modified.ToInternalValue();
+  header->reason = static_cast<uint32_t>(metadata.reason);
+  header->crc = CalculateHeaderCRC(*header);
+}
+
+// Returns the header of the table in |data|, or null if it is invalid.
+const Header* GetValidHeader(const void* data, size_t size) {
+  if (!SimpleIndexTable::IsTable(data, size))
+    return nullptr;
+  const Header* header = static_cast<const Header*>(data);
+  if (header->version != kTableVersion ||
+      header->crc != CalculateHeaderCRC(*header) || header->page_count == 0 ||
+      header->reason > SimpleIndex::INDEX_WRITE_REASON_MAX ||
+      size / kPageSize - 1 != header->page_count || size % kPageSize != 0 ||
+      header->entry_count > header->page_count * kSlotsPerPage) {
+    return nullptr;
+  }
+  return header;
+}
+
+// Gives access to the slots of a table, checking the CRC of each page the
+// first time it is read.
+class Table {
+ public:
+  Table(void* data, size_t page_count, size_t entry_count, bool check_pages)
+      : pages_(reinterpret_cast<Page*>(static_cast<char*>(data) + kPageSize)),
+        page_count_(page_count),
+        entry_count_(entry_count),
+        check_pages_(check_pages),
+        corrupt_(false),
+        checked_pages_(page_count, false),
+        dirty_pages_(page_count, false) {}
+
+  size_t entry_count() const { return entry_count_; }
+  size_t slot_count() const { return page_count_ * kSlotsPerPage; }
+
+  // Sets the metadata of the entry of |hash|, inserting it if needed. Returns
+  // false if a page is corrupt or the table is full.
+  bool Set(uint64_t hash,
+           const EntryMetadata& metadata,
+           size_t max_entry_count) {
+    size_t slot;
+    bool found;
+    if (!Find(hash, &slot, &found))
+      return false;
+    if (!found) {
+      if (entry_count_ == max_entry_count)
+        return false;
+      ++entry_count_;
+      SetUsed(slot, true);
+      GetMutableSlot(slot)->hash = hash;
+    }
+    memcpy(GetMutableSlot(slot)->metadata, &metadata, sizeof(metadata));
+    return true;
+  }
+
+  // Removes the entry of |hash|, if there is one. Returns false if a page is
+  // corrupt.
+  bool Remove(uint64_t hash) {
+    size_t slot;
+    bool found;
+    if (!Find(hash, &slot, &found))
+      return false;
+    if (!found)
+      return true;
+
+    // Moves the following entries of the probe sequence back, so that no
+    // lookup stops at the slot being freed before reaching its entry.
+    size_t next = slot;
+    for (;;) {
+      next = (next + 1) % slot_count();
+      if (!IsUsed(next))
+        break;
+      if (corrupt_)
+        return false;
+      const size_t home = GetSlot(next).hash % slot_count();
+      const bool home_between = slot <= next ? slot < home && home <= next
+                                             : slot < home || home <= next;
+      if (home_between)
+        continue;
+      *GetMutableSlot(slot) = GetSlot(next);
+      slot = next;
+    }
+    if (corrupt_)
+      return false;
+    SetUsed(slot, false);
+    --entry_count_;
+    return true;
+  }
+
+  // Updates the CRC of the pages changed since the table was opened.
+  void UpdatePageCRCs() {
+    for (size_t i = 0; i < page_count_; ++i) {
+      if (dirty_pages_[i])
+        pages_[i].crc = CalculatePageCRC(pages_[i]);
+    }
+  }
+
+ private:
+  // Finds the slot holding the entry of |hash|, or else the free slot where
+  // it would be inserted. Returns false if a page is corrupt or the table is
+  // full.
+  bool Find(uint64_t hash, size_t* slot, bool* found) {
+    size_t index = hash % slot_count();
+    for (size_t i = 0; i < slot_count(); ++i) {
+      const bool used = IsUsed(index);
+      if (corrupt_)
+        return false;
+      if (!used || GetSlot(index).hash == hash) {
+        *slot = index;
+        *found = used;
+        return true;
+      }
+      index = (index + 1) % slot_count();
+    }
+    return false;
+  }
+
+  Page* GetPage(size_t slot) {
+    const size_t index = slot / kSlotsPerPage;
+    if (check_pages_ && !checked_pages_[index]) {
+      checked_pages_[index] = true;
+      if (pages_[index].crc != CalculatePageCRC(pages_[index]))
+        corrupt_ = true;
+    }
+    return &pages_[index];
+  }
+
+  bool IsUsed(size_t slot) {
+    const size_t bit = slot % kSlotsPerPage;
+    return GetPage(slot)->used[bit / 32] & (1u << (bit % 32));
+  }
+
+  void SetUsed(size_t slot, bool used) {
+    const size_t bit = slot % kSlotsPerPage;
+    uint32_t* word = &GetPage(slot)->used[bit / 32];
+    if (used)
+      *word |= 1u << (bit % 32);
+    else
+      *word &= ~(1u << (bit % 32));
+    dirty_pages_[slot / kSlotsPerPage] = true;
+  }
+
+  const Slot& GetSlot(size_t slot) {
+    return GetPage(slot)->slots[slot % kSlotsPerPage];
+  }
+
+  Slot* GetMutableSlot(size_t slot) {
+    dirty_pages_[slot / kSlotsPerPage] = true;
+    return &GetPage(slot)->slots[slot % kSlotsPerPage];
+  }
+
+  Page* const pages_;
+  const size_t page_count_;
+  size_t entry_count_;
+  const bool check_pages_;
+  bool corrupt_;
+  std::vector<bool> checked_pages_;
+  std::vector<bool> dirty_pages_;
+
+  DISALLOW_COPY_AND_ASSIGN(Table);
+};
+
+}  // namespace
+
+SimpleIndexTable::Metadata::Metadata()
+    : reason(SimpleIndex::INDEX_WRITE_REASON_MAX), cache_size(0) {}
+
+SimpleIndexTable::Metadata::Metadata(
+    SimpleIndex::IndexWriteToDiskReason reason,
+    uint64_t cache_size,
+    base::Time cache_last_modified)
+    : reason(reason),
+      cache_size(cache_size),
+      cache_last_modified(cache_last_modified) {}
+
+// static
+bool SimpleIndexTable::IsTable(const void* data, size_t size) {
+  return size >= kPageSize &&
+         static_cast<const Header*>(data)->magic_number == kTableMagicNumber;
+}
+
+// static
+size_t SimpleIndexTable::GetSlotCount(size_t entry_count) {
+  const size_t page_count =
+      (entry_count * kCreateSlotsPerEntry + kSlotsPerPage - 1) / kSlotsPerPage;
+  return std::max<size_t>(page_count, 1) * kSlotsPerPage;
+}
+
+// static
+size_t SimpleIndexTable::GetMaxEntryCount(size_t slot_count) {
+  return slot_count * kMaxLoadNumerator / kMaxLoadDenominator;
+}
+
+// static
+std::string SimpleIndexTable::Create(const SimpleIndex::EntrySet& entries,
+                                     const Metadata& metadata) {
+  const size_t page_count = GetSlotCount(entries.size()) / kSlotsPerPage;
+  std::string data((page_count + 1) * kPageSize, '\0');
+  Table table(&data[0], page_count, 0, false);
+  for (const auto& entry : entries) {
+    const bool inserted =
+        table.Set(entry.first, entry.second, table.slot_count());
+    DCHECK(inserted);
+  }
+  for (size_t i = 0; i < page_count; ++i) {
+    Page* page = reinterpret_cast<Page*>(&data[(i + 1) * kPageSize]);
+    page->crc = CalculatePageCRC(*page);
+  }
+  SetHeader(metadata, page_count, entries.size(),
+            reinterpret_cast<Header*>(&data[0]));
+  return data;
+}
+
+// static
+bool SimpleIndexTable::Load(const void* data,
+                            size_t size,
+                            SimpleIndex::EntrySet* entries,
+                            Metadata* metadata,
+                            size_t* slot_count) {
+  const Header* header = GetValidHeader(data, size);
+  if (!header)
+    return false;
+
+  const Page* pages = reinterpret_cast<const Page*>(
+      static_cast<const char*>(data) + kPageSize);
+  entries->clear();
+  entries->reserve(header->entry_count);
+  for (size_t i = 0; i < header->page_count; ++i) {
+    const Page& page = pages[i];
+    if (page.crc != CalculatePageCRC(page))
+      return false;
+    for (size_t j = 0; j < kSlotsPerPage; ++j) {
+      if (!(page.used[j / 32] & (1u << (j % 32))))
+        continue;
+      EntryMetadata entry_metadata;
+      memcpy(&entry_metadata, page.slots[j].metadata, sizeof(entry_metadata));
+      SimpleIndex::InsertInEntrySet(page.slots[j].hash, entry_metadata,
+                                    entries);
+    }
+  }
+  if (entries->size() != header->entry_count)
+    return false;
+
+  metadata->reason =
+      static_cast<SimpleIndex::IndexWriteToDiskReason>(header->reason);
+  metadata->cache_size = header->cache_size;
+  metadata->cache_last_modified =
+      base::Time::FromInternalValue(header->cache_last_modified);
+  *slot_count = header->page_count * kSlotsPerPage;
+  return true;
+}
+
+// static
+bool SimpleIndexTable::Update(void* data,
+                              size_t size,
+                              const SimpleIndex::EntrySet& updated_entries,
+                              const SimpleIndex::HashList& removed_hashes,
+                              const Metadata& metadata) {
+  Header* header = const_cast<Header*>(GetValidHeader(data, size));
+  if (!header)
+    return false;
+
+  Table table(data, header->page_count, header->entry_count, true);
+  const size_t max_entry_count = GetMaxEntryCount(table.slot_count());
+  // Removing first makes room for the insertions.
+  for (uint64_t hash : removed_hashes) {
+    if (!table.Remove(hash))
+      return false;
+  }
+  for (const auto& entry : updated_entries) {
+    if (!table.Set(entry.first, entry.second, max_entry_count))
+      return false;
+  }
+  table.UpdatePageCRCs();
+  SetHeader(metadata, header->page_count, table.entry_count(), header);
+  return true;
+}
+
+}  // namespace disk_cache
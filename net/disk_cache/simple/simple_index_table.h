@@ -0,0 +1,85 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/simple/simple_index.h"
+
+namespace disk_cache {
+
+// The format of the index file: an open-addressing hash table of the
+// EntryMetadata of the entries, keyed by entry hash, laid out in pages which
+// each carry a CRC. The table is kept sparse, so that a write can insert,
+// update and remove entries in place, touching only the pages of the changed
+// entries and the header, rather than rewriting the whole file. Updates are
+// made through a shared mapping of the file.
+//
+// A write interrupted midway leaves pages whose CRC, or an entry count, that
+// doesn't match, so the table is rejected when loaded and the index is
+// restored from the entry files, as for any corrupt index.
+class NET_EXPORT_PRIVATE SimpleIndexTable {
+ public:
+  // What the header records besides the entries.
+  struct Metadata {
+    Metadata();
+    Metadata(SimpleIndex::IndexWriteToDiskReason reason,
+             uint64_t cache_size,
+             base::Time cache_last_modified);
+
+    SimpleIndex::IndexWriteToDiskReason reason;
+    uint64_t cache_size;  // Total cache storage size in bytes.
+    base::Time cache_last_modified;
+  };
+
+  // Returns whether |data| starts with the header of a table, valid or not.
+  // Index files that don't are in the legacy format of
+  // SimpleIndexFile::Deserialize().
+  static bool IsTable(const void* data, size_t size);
+
+  // Returns the number of slots of a new table holding |entry_count| entries.
+  static size_t GetSlotCount(size_t entry_count);
+
+  // Returns the number of entries that updates can grow a table of
+  // |slot_count| slots to.
+  static size_t GetMaxEntryCount(size_t slot_count);
+
+  // Returns a new table holding |entries|, with GetSlotCount() slots.
+  static std::string Create(const SimpleIndex::EntrySet& entries,
+                            const Metadata& metadata);
+
+  // Reads the table in |data| into |entries|, |metadata| and |slot_count|.
+  // Returns false if the table is corrupt.
+  static bool Load(const void* data,
+                   size_t size,
+                   SimpleIndex::EntrySet* entries,
+                   Metadata* metadata,
+                   size_t* slot_count);
+
+  // Updates the table in |data| in place: sets the metadata of the
+  // |updated_entries|, inserting them if needed, and removes the entries of
+  // |removed_hashes|. Only the pages read along the way are checked. Returns
+  // false if they are corrupt or the table is too full, in which case |data|
+  // may have been partially updated and must be discarded.
+  static bool Update(void* data,
+                     size_t size,
+                     const SimpleIndex::EntrySet& updated_entries,
+                     const SimpleIndex::HashList& removed_hashes,
+                     const Metadata& metadata);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(SimpleIndexTable);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
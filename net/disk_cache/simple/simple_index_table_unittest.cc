@@ -0,0 +1,191 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_index_table.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+const size_t kPageSize = 4096;
+
+SimpleIndexTable::Metadata GetTestMetadata() {
+  return SimpleIndexTable::Metadata(SimpleIndex::INDEX_WRITE_REASON_IDLE, 1234,
+                                    base::Time::FromInternalValue(5678));
+}
+
+EntryMetadata GetTestEntryMetadata(uint64_t hash) {
+  return EntryMetadata(base::Time::UnixEpoch() +
+                           base::TimeDelta::FromSeconds(hash % 100000),
+                       hash % 1000000);
+}
+
+// Expects the table in |data| to hold exactly |expected_entries|.
+void ExpectTableEntries(const std::string& data,
+                        const SimpleIndex::EntrySet& expected_entries) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+  ASSERT_TRUE(SimpleIndexTable::Load(data.data(), data.size(), &entries,
+                                     &metadata, &slot_count));
+  ASSERT_EQ(expected_entries.size(), entries.size());
+  for (const auto& entry : expected_entries) {
+    SimpleIndex::EntrySet::const_iterator it = entries.find(entry.first);
+    ASSERT_TRUE(it != entries.end()) << entry.first;
+    EXPECT_EQ(entry.second.GetLastUsedTime(), it->second.GetLastUsedTime());
+    EXPECT_EQ(entry.second.GetEntrySize(), it->second.GetEntrySize());
+  }
+}
+
+bool UpdateTable(std::string* data,
+                 const SimpleIndex::EntrySet& updated_entries,
+                 const SimpleIndex::HashList& removed_hashes) {
+  return SimpleIndexTable::Update(&(*data)[0], data->size(), updated_entries,
+                                  removed_hashes, GetTestMetadata());
+}
+
+}  // namespace
+
+TEST(SimpleIndexTableTest, CreateThenLoad) {
+  SimpleIndex::EntrySet entries;
+  for (uint64_t hash : {UINT64_C(0), UINT64_C(1), UINT64_C(0xffffffffffffffff),
+                        UINT64_C(0x123456789abcdef0)}) {
+    SimpleIndex::InsertInEntrySet(hash, GetTestEntryMetadata(hash), &entries);
+  }
+  const std::string data =
+      SimpleIndexTable::Create(entries, GetTestMetadata());
+  EXPECT_TRUE(SimpleIndexTable::IsTable(data.data(), data.size()));
+  ExpectTableEntries(data, entries);
+
+  SimpleIndex::EntrySet loaded_entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+  ASSERT_TRUE(SimpleIndexTable::Load(data.data(), data.size(), &loaded_entries,
+                                     &metadata, &slot_count));
+  EXPECT_EQ(SimpleIndex::INDEX_WRITE_REASON_IDLE, metadata.reason);
+  EXPECT_EQ(1234U, metadata.cache_size);
+  EXPECT_EQ(base::Time::FromInternalValue(5678), metadata.cache_last_modified);
+  EXPECT_EQ(SimpleIndexTable::GetSlotCount(entries.size()), slot_count);
+}
+
+TEST(SimpleIndexTableTest, SlotCount) {
+  EXPECT_LT(0U, SimpleIndexTable::GetSlotCount(0));
+  for (size_t count : {1, 100, 1000, 100000}) {
+    const size_t slot_count = SimpleIndexTable::GetSlotCount(count);
+    EXPECT_LE(2 * count, slot_count);
+    EXPECT_LT(count, SimpleIndexTable::GetMaxEntryCount(slot_count));
+    EXPECT_GT(slot_count, SimpleIndexTable::GetMaxEntryCount(slot_count));
+  }
+}
+
+TEST(SimpleIndexTableTest, IsTable) {
+  const std::string data =
+      SimpleIndexTable::Create(SimpleIndex::EntrySet(), GetTestMetadata());
+  EXPECT_TRUE(SimpleIndexTable::IsTable(data.data(), data.size()));
+  EXPECT_FALSE(SimpleIndexTable::IsTable(data.data(), 8));
+  const std::string not_a_table(kPageSize, 'x');
+  EXPECT_FALSE(
+      SimpleIndexTable::IsTable(not_a_table.data(), not_a_table.size()));
+}
+
+// Inserts, updates and removes entries, many of which share a home slot or
+// probe past the end of the table.
+TEST(SimpleIndexTableTest, Update) {
+  SimpleIndex::EntrySet entries;
+  std::string data = SimpleIndexTable::Create(entries, GetTestMetadata());
+  SimpleIndex::EntrySet loaded_entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+  ASSERT_TRUE(SimpleIndexTable::Load(data.data(), data.size(), &loaded_entries,
+                                     &metadata, &slot_count));
+  const size_t max_entry_count =
+      SimpleIndexTable::GetMaxEntryCount(slot_count);
+
+  uint64_t random = 1;
+  for (int round = 0; round < 50; ++round) {
+    SimpleIndex::EntrySet updated_entries;
+    SimpleIndex::HashList removed_hashes;
+    for (int i = 0; i < 20; ++i) {
+      random = random * UINT64_C(6364136223846793005) + 1442695040888963407;
+      // Homes to a handful of slots, the last ones wrapping around.
+      const uint64_t hash =
+          (random >> 40) % 8 * slot_count + slot_count - 4 + (random >> 60);
+      if ((random & 1) && entries.count(hash)) {
+        entries.erase(hash);
+        updated_entries.erase(hash);
+        removed_hashes.push_back(hash);
+      } else if (entries.size() < max_entry_count) {
+        entries[hash] = GetTestEntryMetadata(random);
+        updated_entries[hash] = entries[hash];
+      }
+    }
+    ASSERT_TRUE(UpdateTable(&data, updated_entries, removed_hashes));
+    ExpectTableEntries(data, entries);
+  }
+}
+
+TEST(SimpleIndexTableTest, UpdateTooFull) {
+  SimpleIndex::EntrySet entries;
+  std::string data = SimpleIndexTable::Create(entries, GetTestMetadata());
+  const size_t max_entry_count = SimpleIndexTable::GetMaxEntryCount(
+      SimpleIndexTable::GetSlotCount(0));
+  for (uint64_t hash = 0; hash < max_entry_count; ++hash)
+    entries[hash] = GetTestEntryMetadata(hash);
+  ASSERT_TRUE(UpdateTable(&data, entries, SimpleIndex::HashList()));
+  ExpectTableEntries(data, entries);
+
+  SimpleIndex::EntrySet one_more;
+  one_more[max_entry_count] = GetTestEntryMetadata(0);
+  EXPECT_FALSE(UpdateTable(&data, one_more, SimpleIndex::HashList()));
+
+  // Removing an entry first makes room.
+  data = SimpleIndexTable::Create(SimpleIndex::EntrySet(), GetTestMetadata());
+  ASSERT_TRUE(UpdateTable(&data, entries, SimpleIndex::HashList()));
+  EXPECT_TRUE(UpdateTable(&data, one_more, SimpleIndex::HashList(1, 0)));
+}
+
+TEST(SimpleIndexTableTest, CorruptPage) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(1, GetTestEntryMetadata(1), &entries);
+  std::string data = SimpleIndexTable::Create(entries, GetTestMetadata());
+  SimpleIndex::EntrySet loaded_entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+
+  // Marks slot 0 of the first page of slots as used, after the 253 slots.
+  data[kPageSize + 253 * 16] ^= 1;
+  EXPECT_TRUE(SimpleIndexTable::IsTable(data.data(), data.size()));
+  EXPECT_FALSE(SimpleIndexTable::Load(data.data(), data.size(), &loaded_entries,
+                                      &metadata, &slot_count));
+  EXPECT_FALSE(UpdateTable(&data, entries, SimpleIndex::HashList()));
+}
+
+TEST(SimpleIndexTableTest, CorruptHeader) {
+  const std::string data =
+      SimpleIndexTable::Create(SimpleIndex::EntrySet(), GetTestMetadata());
+  SimpleIndex::EntrySet entries;
+  SimpleIndexTable::Metadata metadata;
+  size_t slot_count;
+
+  // The entry count.
+  std::string corrupt = data;
+  corrupt[16] ^= 1;
+  EXPECT_FALSE(SimpleIndexTable::Load(corrupt.data(), corrupt.size(), &entries,
+                                      &metadata, &slot_count));
+  EXPECT_FALSE(UpdateTable(&corrupt, entries, SimpleIndex::HashList()));
+
+  // Truncated.
+  corrupt = data.substr(0, data.size() - kPageSize);
+  EXPECT_FALSE(SimpleIndexTable::Load(corrupt.data(), corrupt.size(), &entries,
+                                      &metadata, &slot_count));
+}
+
+}  // namespace disk_cache
@@ -69,18 +69,24 @@ class MockSimpleIndexFile : public SimpleIndexFile,
 
   void WriteToDisk(SimpleIndex::IndexWriteToDiskReason reason,
                    const SimpleIndex::EntrySet& entry_set,
+                   const SimpleIndex::HashList& changed_hashes,
                    uint64_t cache_size,
                    const base::TimeTicks& start,
                    bool app_on_background,
                    const base::Closure& callback) override {
     disk_writes_++;
     disk_write_entry_set_ = entry_set;
+    disk_write_changed_hashes_ = changed_hashes;
   }
 
   void GetAndResetDiskWriteEntrySet(SimpleIndex::EntrySet* entry_set) {
     entry_set->swap(disk_write_entry_set_);
   }
 
+  const SimpleIndex::HashList& disk_write_changed_hashes() const {
+    return disk_write_changed_hashes_;
+  }
+
   const base::Closure& load_callback() const { return load_callback_; }
   SimpleIndexLoadResult* load_result() const { return load_result_; }
   int load_index_entries_calls() const { return load_index_entries_calls_; }
@@ -92,6 +98,7 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   int load_index_entries_calls_;
   int disk_writes_;
   SimpleIndex::EntrySet disk_write_entry_set_;
+  SimpleIndex::HashList disk_write_changed_hashes_;
 };
 
 class SimpleIndexTest  : public testing::Test, public SimpleIndexDelegate {
@@ -605,6 +612,38 @@ TEST_F(SimpleIndexTest, DiskWriteExecuted) {
   EXPECT_EQ(20U, entry1.GetEntrySize());
 }
 
+// Checks that each write gets the entries changed since the previous one.
+TEST_F(SimpleIndexTest, DiskWriteChangedHashes) {
+  index()->SetMaxSize(1000);
+  InsertIntoIndexFileReturn(hashes_.at<1>(), base::Time::Now(), 10);
+  InsertIntoIndexFileReturn(hashes_.at<2>(), base::Time::Now(), 10);
+  InsertIntoIndexFileReturn(hashes_.at<3>(), base::Time::Now(), 10);
+  ReturnIndexFile();
+
+  index()->Insert(hashes_.at<4>());
+  EXPECT_TRUE(index()->UseIfExists(hashes_.at<1>()));
+  index()->Remove(hashes_.at<2>());
+  index()->WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN);
+  EXPECT_EQ(1, index_file_->disk_writes());
+  SimpleIndex::HashList changed_hashes =
+      index_file_->disk_write_changed_hashes();
+  std::sort(changed_hashes.begin(), changed_hashes.end());
+  SimpleIndex::HashList expected_hashes = {hashes_.at<1>(), hashes_.at<2>(),
+                                           hashes_.at<4>()};
+  std::sort(expected_hashes.begin(), expected_hashes.end());
+  EXPECT_EQ(expected_hashes, changed_hashes);
+
+  index()->WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN);
+  EXPECT_EQ(2, index_file_->disk_writes());
+  EXPECT_TRUE(index_file_->disk_write_changed_hashes().empty());
+
+  EXPECT_TRUE(index()->UpdateEntrySize(hashes_.at<3>(), 20));
+  index()->WriteToDisk(SimpleIndex::INDEX_WRITE_REASON_SHUTDOWN);
+  EXPECT_EQ(SimpleIndex::HashList(1, hashes_.at<3>()),
+            index_file_->disk_write_changed_hashes());
+  index()->write_to_disk_timer_.Stop();
+}
+
 TEST_F(SimpleIndexTest, DiskWritePostponed) {
   index()->SetMaxSize(1000);
   ReturnIndexFile();
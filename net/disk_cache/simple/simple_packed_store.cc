@@ -0,0 +1,363 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_packed_store.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "net/disk_cache/simple/simple_entry_format.h"
+#include "third_party/zlib/zlib.h"
+
+namespace disk_cache {
+
+namespace {
+
+const char kBlockFilePrefix[] = "block_";
+
+// Compaction starts once replaced and removed records take this much space,
+// and as much as the live ones.
+const int64_t kMinCompactionGarbageSize = 1024 * 1024;
+
+uint32_t CalculateHeaderCRC(const SimplePackedRecordHeader& header) {
+  return crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(&header),
+               offsetof(SimplePackedRecordHeader, header_crc32));
+}
+
+uint32_t CalculateDataCRC(const char* data, size_t size) {
+  return crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data),
+               size);
+}
+
+uint64_t GetPayloadSize(const SimplePackedRecordHeader& header) {
+  return static_cast<uint64_t>(header.key_length) + header.stream_0_size +
+         header.stream_1_size;
+}
+
+// Returns a record of |header|, followed by |payload|, setting the CRCs.
+std::string MakeRecord(SimplePackedRecordHeader header,
+                       const std::string& payload) {
+  header.magic_number = kSimplePackedRecordMagicNumber;
+  header.data_crc32 = CalculateDataCRC(payload.data(), payload.size());
+  header.header_crc32 = CalculateHeaderCRC(header);
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(payload);
+  return record;
+}
+
+// Parses the header of the record at the start of |data|, and checks that the
+// record is complete. Returns false if the header is invalid or the record
+// reaches past |size|, both of which mean the record was torn.
+bool ParseRecordHeader(const char* data,
+                       size_t size,
+                       SimplePackedRecordHeader* header) {
+  if (size < sizeof(*header))
+    return false;
+  memcpy(header, data, sizeof(*header));
+  return header->magic_number == kSimplePackedRecordMagicNumber &&
+         header->header_crc32 == CalculateHeaderCRC(*header) &&
+         GetPayloadSize(*header) <= size - sizeof(*header);
+}
+
+bool IsRecordDataValid(const char* record,
+                       const SimplePackedRecordHeader& header) {
+  return header.data_crc32 ==
+         CalculateDataCRC(record + sizeof(header), GetPayloadSize(header));
+}
+
+}  // namespace
+
+const size_t SimplePackedStore::kMaxPackedEntrySize;
+const int64_t SimplePackedStore::kMaxBlockFileSize;
+const char SimplePackedStore::kPackedDirectory[] = "packed-dir";
+
+SimplePackedStore::SimplePackedStore(const base::FilePath& cache_directory)
+    : directory_(cache_directory.AppendASCII(kPackedDirectory)),
+      total_size_(0),
+      live_size_(0) {}
+
+SimplePackedStore::~SimplePackedStore() {}
+
+// static
+bool SimplePackedStore::CanPack(const std::string& key,
+                                size_t stream_0_size,
+                                size_t stream_1_size) {
+  return sizeof(SimplePackedRecordHeader) + key.size() + stream_0_size +
+             stream_1_size <
+         kMaxPackedEntrySize;
+}
+
+bool SimplePackedStore::Init() {
+  DCHECK(block_files_.empty());
+  if (!base::CreateDirectory(directory_))
+    return false;
+
+  std::vector<uint32_t> file_ids;
+  base::FileEnumerator enumerator(directory_, false /* recursive */,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    const std::string name = path.BaseName().MaybeAsASCII();
+    unsigned file_id;
+    if (!base::StartsWith(name, kBlockFilePrefix,
+                          base::CompareCase::SENSITIVE) ||
+        !base::StringToUint(name.substr(strlen(kBlockFilePrefix)),
+                            &file_id)) {
+      continue;
+    }
+    file_ids.push_back(file_id);
+  }
+  std::sort(file_ids.begin(), file_ids.end());
+
+  // Older records come first, so that later ones replace them.
+  for (uint32_t file_id : file_ids) {
+    if (!OpenBlockFile(file_id, false) || !ScanBlockFile(file_id))
+      return false;
+  }
+  if (block_files_.empty())
+    return OpenBlockFile(1, true);
+  return true;
+}
+
+bool SimplePackedStore::Has(uint64_t entry_hash) const {
+  return entries_.count(entry_hash) != 0;
+}
+
+void SimplePackedStore::GetEntries(SimpleIndex::EntrySet* entries) const {
+  for (const auto& entry : entries_) {
+    SimpleIndex::InsertInEntrySet(
+        entry.first,
+        EntryMetadata(entry.second.last_modified, entry.second.size), entries);
+  }
+}
+
+bool SimplePackedStore::Write(uint64_t entry_hash,
+                              const std::string& key,
+                              base::StringPiece stream_0,
+                              base::StringPiece stream_1) {
+  DCHECK(CanPack(key, stream_0.size(), stream_1.size()));
+  SimplePackedRecordHeader header;
+  header.entry_hash = entry_hash;
+  header.last_modified = base::Time::Now().ToInternalValue();
+  header.key_length = key.size();
+  header.stream_0_size = stream_0.size();
+  header.stream_1_size = stream_1.size();
+  std::string payload = key;
+  stream_0.AppendToString(&payload);
+  stream_1.AppendToString(&payload);
+  const std::string record = MakeRecord(header, payload);
+
+  EntryLocation location;
+  if (!AppendRecord(record, &location.file_id, &location.offset))
+    return false;
+  location.size = record.size();
+  location.last_modified = base::Time::FromInternalValue(header.last_modified);
+  SetLocation(entry_hash, location);
+  return true;
+}
+
+bool SimplePackedStore::Read(uint64_t entry_hash,
+                             const std::string& key,
+                             Entry* entry) {
+  auto it = entries_.find(entry_hash);
+  if (it == entries_.end())
+    return false;
+  const EntryLocation& location = it->second;
+  std::vector<char> record(location.size);
+  SimplePackedRecordHeader header;
+  if (block_files_[location.file_id]->file.Read(location.offset, record.data(),
+                                                location.size) !=
+          location.size ||
+      !ParseRecordHeader(record.data(), record.size(), &header) ||
+      header.entry_hash != entry_hash ||
+      !IsRecordDataValid(record.data(), header)) {
+    DLOG(WARNING) << "Corrupt packed record for entry " << entry_hash;
+    ForgetLocation(entry_hash);
+    return false;
+  }
+
+  const char* data = record.data() + sizeof(header);
+  if (!key.empty() && key.compare(0, std::string::npos, data,
+                                  header.key_length) != 0) {
+    return false;
+  }
+  entry->key.assign(data, header.key_length);
+  data += header.key_length;
+  entry->stream_0.assign(data, header.stream_0_size);
+  data += header.stream_0_size;
+  entry->stream_1.assign(data, header.stream_1_size);
+  return true;
+}
+
+bool SimplePackedStore::Remove(uint64_t entry_hash) {
+  if (!Has(entry_hash))
+    return true;
+  SimplePackedRecordHeader header;
+  header.entry_hash = entry_hash;
+  header.last_modified = base::Time::Now().ToInternalValue();
+  header.flags = SimplePackedRecordHeader::FLAG_REMOVED;
+  const std::string record = MakeRecord(header, std::string());
+  uint32_t file_id;
+  int64_t offset;
+  if (!AppendRecord(record, &file_id, &offset))
+    return false;
+  ForgetLocation(entry_hash);
+  return true;
+}
+
+bool SimplePackedStore::NeedsCompaction() const {
+  const int64_t garbage_size = total_size_ - live_size_;
+  return garbage_size >= kMinCompactionGarbageSize &&
+         garbage_size >= live_size_;
+}
+
+bool SimplePackedStore::Compact() {
+  // Records are appended to the newest block file, so it can't be the one
+  // compacted.
+  if (block_files_.size() == 1 &&
+      !OpenBlockFile(block_files_.rbegin()->first + 1, true)) {
+    return false;
+  }
+
+  // Since no block file is older, the tombstones of this one only remove
+  // records of this one, and can be dropped along with them.
+  const uint32_t file_id = block_files_.begin()->first;
+  BlockFile* block_file = block_files_.begin()->second.get();
+  std::string data(block_file->size, '\0');
+  if (block_file->file.Read(0, &data[0], data.size()) !=
+      static_cast<int>(data.size())) {
+    return false;
+  }
+  for (auto& entry : entries_) {
+    EntryLocation& location = entry.second;
+    if (location.file_id != file_id)
+      continue;
+    const std::string record = data.substr(location.offset, location.size);
+    uint32_t new_file_id;
+    int64_t new_offset;
+    if (!AppendRecord(record, &new_file_id, &new_offset))
+      return false;
+    location.file_id = new_file_id;
+    location.offset = new_offset;
+  }
+
+  total_size_ -= block_file->size;
+  block_file->file.Close();
+  block_files_.erase(file_id);
+  return base::DeleteFile(GetBlockFilePath(file_id), false);
+}
+
+base::FilePath SimplePackedStore::GetBlockFilePath(uint32_t file_id) const {
+  return directory_.AppendASCII(
+      base::StringPrintf("%s%u", kBlockFilePrefix, file_id));
+}
+
+bool SimplePackedStore::OpenBlockFile(uint32_t file_id, bool create) {
+  std::unique_ptr<BlockFile> block_file(new BlockFile);
+  const int flags = (create ? base::File::FLAG_CREATE : base::File::FLAG_OPEN) |
+                    base::File::FLAG_READ | base::File::FLAG_WRITE |
+                    base::File::FLAG_SHARE_DELETE;
+  block_file->file.Initialize(GetBlockFilePath(file_id), flags);
+  if (!block_file->file.IsValid())
+    return false;
+  block_file->size = 0;
+  block_files_[file_id] = std::move(block_file);
+  return true;
+}
+
+bool SimplePackedStore::ScanBlockFile(uint32_t file_id) {
+  BlockFile* block_file = block_files_[file_id].get();
+  const int64_t length = block_file->file.GetLength();
+  if (length < 0)
+    return false;
+  // Block files are small enough to be read whole, in one call.
+  std::vector<char> data(length);
+  if (length > 0 &&
+      block_file->file.Read(0, data.data(), length) != length) {
+    return false;
+  }
+
+  size_t offset = 0;
+  SimplePackedRecordHeader header;
+  while (ParseRecordHeader(data.data() + offset, data.size() - offset,
+                           &header)) {
+    const size_t record_size = sizeof(header) + GetPayloadSize(header);
+    if (header.flags & SimplePackedRecordHeader::FLAG_REMOVED) {
+      ForgetLocation(header.entry_hash);
+    } else if (IsRecordDataValid(data.data() + offset, header)) {
+      EntryLocation location;
+      location.file_id = file_id;
+      location.offset = offset;
+      location.size = record_size;
+      location.last_modified =
+          base::Time::FromInternalValue(header.last_modified);
+      SetLocation(header.entry_hash, location);
+    } else {
+      // The earlier records of the entry are stale all the same.
+      DLOG(WARNING) << "Corrupt packed record for entry " << header.entry_hash;
+      ForgetLocation(header.entry_hash);
+    }
+    offset += record_size;
+    total_size_ += record_size;
+  }
+
+  block_file->size = offset;
+  if (offset < data.size()) {
+    DLOG(WARNING) << "Truncating torn packed record in block file " << file_id;
+    return block_file->file.SetLength(offset);
+  }
+  return true;
+}
+
+bool SimplePackedStore::AppendRecord(const std::string& record,
+                                     uint32_t* file_id,
+                                     int64_t* offset) {
+  BlockFile* block_file = block_files_.rbegin()->second.get();
+  if (block_file->size > 0 &&
+      block_file->size + static_cast<int64_t>(record.size()) >
+          kMaxBlockFileSize) {
+    if (!OpenBlockFile(block_files_.rbegin()->first + 1, true))
+      return false;
+    block_file = block_files_.rbegin()->second.get();
+  }
+
+  if (block_file->file.Write(block_file->size, record.data(),
+                             record.size()) !=
+      static_cast<int>(record.size())) {
+    // Leaves no partial record for the next one to follow.
+    block_file->file.SetLength(block_file->size);
+    return false;
+  }
+  *file_id = block_files_.rbegin()->first;
+  *offset = block_file->size;
+  block_file->size += record.size();
+  total_size_ += record.size();
+  return true;
+}
+
+void SimplePackedStore::SetLocation(uint64_t entry_hash,
+                                    const EntryLocation& location) {
+  ForgetLocation(entry_hash);
+  entries_[entry_hash] = location;
+  live_size_ += location.size;
+}
+
+void SimplePackedStore::ForgetLocation(uint64_t entry_hash) {
+  auto it = entries_.find(entry_hash);
+  if (it == entries_.end())
+    return;
+  live_size_ -= it->second.size;
+  entries_.erase(it);
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,155 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/simple/simple_index.h"
+
+namespace disk_cache {
+
+// Stores small entries as records appended to a few shared block files, rather
+// than in two or three files of their own, which saves an inode and the
+// open() calls per entry for the many tiny resources a cache holds. Entries
+// are located by their entry hash, as in SimpleIndex, and a record written
+// later replaces the earlier ones of its entry. Removal appends a tombstone
+// record. The space of replaced and removed records is reclaimed by Compact(),
+// which rewrites the oldest block file's live records into the newest one.
+//
+// The location of every record is kept in memory, and rebuilt by Init() from
+// the block files. A record torn by a crash ends its block file, and is
+// truncated away, while a record whose data doesn't match its CRC is ignored.
+//
+// Like SimpleSynchronousEntry, this does blocking IO and is not thread safe:
+// calls must be serialized on the worker pool.
+class NET_EXPORT_PRIVATE SimplePackedStore {
+ public:
+  // Entries whose key and data of streams 0 and 1 add up to less than this
+  // size can be packed.
+  static const size_t kMaxPackedEntrySize = 4096;
+
+  // Records are appended to a new block file once the newest one reaches this
+  // size.
+  static const int64_t kMaxBlockFileSize = 4 * 1024 * 1024;
+
+  // The subdirectory of the cache directory holding the block files.
+  static const char kPackedDirectory[];
+
+  struct Entry {
+    std::string key;
+    std::string stream_0;
+    std::string stream_1;
+  };
+
+  explicit SimplePackedStore(const base::FilePath& cache_directory);
+  ~SimplePackedStore();
+
+  // Returns whether an entry made of |key| and streams 0 and 1 of the given
+  // sizes can be packed. Entries with data in stream 2 or sparse data can't.
+  static bool CanPack(const std::string& key,
+                      size_t stream_0_size,
+                      size_t stream_1_size);
+
+  // Opens the block files, creating the directory if needed, and reads the
+  // location of every entry. Returns false on IO errors.
+  bool Init();
+
+  bool Has(uint64_t entry_hash) const;
+
+  // Inserts the size and last modification time of every packed entry into
+  // |entries|, for SimpleIndex to restore them.
+  void GetEntries(SimpleIndex::EntrySet* entries) const;
+
+  // Writes the entry of |entry_hash|, replacing any previous version.
+  bool Write(uint64_t entry_hash,
+             const std::string& key,
+             base::StringPiece stream_0,
+             base::StringPiece stream_1);
+
+  // Reads the entry of |entry_hash| into |entry|. Returns false if there is
+  // none, if its record is corrupt, in which case the entry is dropped, or if
+  // |key| is not empty and doesn't match the entry's.
+  bool Read(uint64_t entry_hash, const std::string& key, Entry* entry);
+
+  // Removes the entry of |entry_hash|, if there is one.
+  bool Remove(uint64_t entry_hash);
+
+  // Returns whether enough space is held by replaced and removed records for
+  // a Compact() to be worth it.
+  bool NeedsCompaction() const;
+
+  // Moves the live records of the oldest block file to the newest one, and
+  // deletes it. Entries stay readable throughout, and a crash midway leaves
+  // both copies of the moved records, which Init() resolves.
+  bool Compact();
+
+  size_t entry_count() const { return entries_.size(); }
+  size_t block_file_count() const { return block_files_.size(); }
+
+  // The total size of the block files, and of the live records in them.
+  int64_t total_size() const { return total_size_; }
+  int64_t live_size() const { return live_size_; }
+
+ private:
+  struct BlockFile {
+    base::File file;
+    int64_t size;
+  };
+
+  struct EntryLocation {
+    uint32_t file_id;
+    int64_t offset;
+    int32_t size;
+    base::Time last_modified;
+  };
+
+  base::FilePath GetBlockFilePath(uint32_t file_id) const;
+
+  bool OpenBlockFile(uint32_t file_id, bool create);
+
+  // Reads the records of the block file of |file_id|, and truncates any torn
+  // record at its end.
+  bool ScanBlockFile(uint32_t file_id);
+
+  // Appends |record| to the newest block file, starting a new one first if
+  // |record| would make it too large. Sets |file_id| and |offset| to where it
+  // was written.
+  bool AppendRecord(const std::string& record,
+                    uint32_t* file_id,
+                    int64_t* offset);
+
+  void SetLocation(uint64_t entry_hash, const EntryLocation& location);
+  void ForgetLocation(uint64_t entry_hash);
+
+  const base::FilePath directory_;
+
+  // By id, so that the first one is the oldest and the last one the newest,
+  // where records are appended.
+  std::map<uint32_t, std::unique_ptr<BlockFile>> block_files_;
+
+  std::unordered_map<uint64_t, EntryLocation> entries_;
+
+  int64_t total_size_;
+  int64_t live_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimplePackedStore);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
@@ -0,0 +1,210 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_packed_store.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "net/disk_cache/simple/simple_entry_format.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+class SimplePackedStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(Reopen());
+  }
+
+  // Replaces |store_| with a new one reading the block files.
+  bool Reopen() {
+    store_.reset(new SimplePackedStore(temp_dir_.path()));
+    return store_->Init();
+  }
+
+  base::FilePath GetBlockFilePath(int file_id) const {
+    return temp_dir_.path()
+        .AppendASCII(SimplePackedStore::kPackedDirectory)
+        .AppendASCII(base::StringPrintf("block_%d", file_id));
+  }
+
+  void ExpectEntry(uint64_t entry_hash,
+                   const std::string& key,
+                   const std::string& stream_0,
+                   const std::string& stream_1) {
+    SimplePackedStore::Entry entry;
+    ASSERT_TRUE(store_->Read(entry_hash, key, &entry));
+    EXPECT_EQ(key, entry.key);
+    EXPECT_EQ(stream_0, entry.stream_0);
+    EXPECT_EQ(stream_1, entry.stream_1);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<SimplePackedStore> store_;
+};
+
+}  // namespace
+
+TEST_F(SimplePackedStoreTest, CanPack) {
+  EXPECT_TRUE(SimplePackedStore::CanPack("key", 100, 1000));
+  EXPECT_TRUE(SimplePackedStore::CanPack("", 0, 0));
+  EXPECT_FALSE(SimplePackedStore::CanPack(
+      "key", 0, SimplePackedStore::kMaxPackedEntrySize));
+  EXPECT_FALSE(SimplePackedStore::CanPack(
+      std::string(SimplePackedStore::kMaxPackedEntrySize, 'k'), 0, 0));
+}
+
+TEST_F(SimplePackedStoreTest, WriteThenRead) {
+  EXPECT_FALSE(store_->Has(1));
+  ASSERT_TRUE(store_->Write(1, "key1", "headers1", "body1"));
+  ASSERT_TRUE(store_->Write(2, "key2", "headers2", ""));
+  EXPECT_TRUE(store_->Has(1));
+  EXPECT_EQ(2U, store_->entry_count());
+  ExpectEntry(1, "key1", "headers1", "body1");
+  ExpectEntry(2, "key2", "headers2", "");
+
+  // Without a key, any entry of the hash is returned.
+  SimplePackedStore::Entry entry;
+  ASSERT_TRUE(store_->Read(1, std::string(), &entry));
+  EXPECT_EQ("key1", entry.key);
+  // A colliding key is not.
+  EXPECT_FALSE(store_->Read(1, "key2", &entry));
+  EXPECT_FALSE(store_->Read(3, std::string(), &entry));
+}
+
+TEST_F(SimplePackedStoreTest, OverwriteAndRemove) {
+  ASSERT_TRUE(store_->Write(1, "key1", "old", "old body"));
+  ASSERT_TRUE(store_->Write(2, "key2", "headers2", "body2"));
+  ASSERT_TRUE(store_->Write(1, "key1", "new", "new body"));
+  ASSERT_TRUE(store_->Remove(2));
+  ASSERT_TRUE(store_->Remove(3));
+  ExpectEntry(1, "key1", "new", "new body");
+  EXPECT_FALSE(store_->Has(2));
+  EXPECT_LT(store_->live_size(), store_->total_size());
+
+  // Both persist.
+  ASSERT_TRUE(Reopen());
+  EXPECT_EQ(1U, store_->entry_count());
+  ExpectEntry(1, "key1", "new", "new body");
+  EXPECT_FALSE(store_->Has(2));
+
+  SimpleIndex::EntrySet entries;
+  store_->GetEntries(&entries);
+  ASSERT_EQ(1U, entries.size());
+  EXPECT_EQ(store_->live_size(),
+            static_cast<int64_t>(entries.begin()->second.GetEntrySize()));
+}
+
+TEST_F(SimplePackedStoreTest, TornRecord) {
+  ASSERT_TRUE(store_->Write(1, "key1", "headers1", "body1"));
+  ASSERT_TRUE(store_->Write(2, "key2", "headers2", "body2"));
+  const int64_t size = store_->total_size();
+  store_.reset();
+
+  // Cuts the last record short.
+  base::File file(GetBlockFilePath(1),
+                  base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.SetLength(size - 3));
+  file.Close();
+
+  ASSERT_TRUE(Reopen());
+  ExpectEntry(1, "key1", "headers1", "body1");
+  EXPECT_FALSE(store_->Has(2));
+  int64_t file_size;
+  ASSERT_TRUE(base::GetFileSize(GetBlockFilePath(1), &file_size));
+  EXPECT_EQ(store_->total_size(), file_size);
+
+  // Records written after the truncation are readable.
+  ASSERT_TRUE(store_->Write(3, "key3", "headers3", "body3"));
+  ASSERT_TRUE(Reopen());
+  ExpectEntry(3, "key3", "headers3", "body3");
+}
+
+TEST_F(SimplePackedStoreTest, CorruptRecord) {
+  ASSERT_TRUE(store_->Write(1, "key1", "headers1", "body1"));
+  ASSERT_TRUE(store_->Write(2, "key2", "headers2", "body2"));
+  ASSERT_TRUE(store_->Write(1, "key1", "headers3", "body3"));
+
+  // Flips the last byte of the body of the last record.
+  base::File file(GetBlockFilePath(1), base::File::FLAG_OPEN |
+                                           base::File::FLAG_READ |
+                                           base::File::FLAG_WRITE);
+  const int64_t offset = store_->total_size() - 1;
+  char byte;
+  ASSERT_EQ(1, file.Read(offset, &byte, 1));
+  byte ^= 1;
+  ASSERT_EQ(1, file.Write(offset, &byte, 1));
+  file.Close();
+
+  SimplePackedStore::Entry entry;
+  EXPECT_FALSE(store_->Read(1, "key1", &entry));
+  EXPECT_FALSE(store_->Has(1));
+  ExpectEntry(2, "key2", "headers2", "body2");
+
+  // The earlier record of the entry is not brought back.
+  ASSERT_TRUE(Reopen());
+  EXPECT_FALSE(store_->Has(1));
+  ExpectEntry(2, "key2", "headers2", "body2");
+}
+
+TEST_F(SimplePackedStoreTest, RollOver) {
+  const std::string body(3000, 'b');
+  const int record_count = SimplePackedStore::kMaxBlockFileSize / 3000 + 10;
+  for (int i = 0; i < record_count; ++i)
+    ASSERT_TRUE(store_->Write(i, base::StringPrintf("key%d", i), "", body));
+  EXPECT_EQ(2U, store_->block_file_count());
+  EXPECT_TRUE(base::PathExists(GetBlockFilePath(2)));
+
+  ASSERT_TRUE(Reopen());
+  EXPECT_EQ(static_cast<size_t>(record_count), store_->entry_count());
+  ExpectEntry(0, "key0", "", body);
+  ExpectEntry(record_count - 1, base::StringPrintf("key%d", record_count - 1),
+              "", body);
+}
+
+TEST_F(SimplePackedStoreTest, Compact) {
+  const std::string body(3000, 'b');
+  // Enough garbage to compact, with a few entries left in the block file.
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 400; ++i) {
+      ASSERT_TRUE(store_->Write(i, base::StringPrintf("key%d", i),
+                                base::StringPrintf("round%d", round), body));
+    }
+  }
+  for (int i = 10; i < 400; ++i)
+    ASSERT_TRUE(store_->Remove(i));
+  ASSERT_TRUE(store_->Remove(0));
+  ASSERT_EQ(1U, store_->block_file_count());
+  EXPECT_TRUE(store_->NeedsCompaction());
+
+  ASSERT_TRUE(store_->Compact());
+  EXPECT_FALSE(store_->NeedsCompaction());
+  EXPECT_FALSE(base::PathExists(GetBlockFilePath(1)));
+  EXPECT_EQ(store_->live_size(), store_->total_size());
+  EXPECT_EQ(9U, store_->entry_count());
+  EXPECT_FALSE(store_->Has(0));
+  ExpectEntry(1, "key1", "round1", body);
+  ExpectEntry(9, "key9", "round1", body);
+
+  // The dropped tombstones don't let removed entries come back.
+  ASSERT_TRUE(Reopen());
+  EXPECT_EQ(9U, store_->entry_count());
+  EXPECT_FALSE(store_->Has(0));
+  EXPECT_FALSE(store_->Has(10));
+  ExpectEntry(5, "key5", "round1", body);
+  EXPECT_EQ(store_->live_size(), store_->total_size());
+}
+
+}  // namespace disk_cache
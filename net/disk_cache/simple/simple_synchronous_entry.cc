@@ -695,26 +695,6 @@ void SimpleSynchronousEntry::Close(
     if (empty_file_omitted_[file_index])
       continue;
 
-    if (stream_index == 0) {
-      // Write stream 0 data.
-      int stream_0_offset = entry_stat.GetOffsetInFile(key_.size(), 0, 0);
-      if (files_[0].Write(stream_0_offset, stream_0_data->data(),
-                          entry_stat.data_size(0)) != entry_stat.data_size(0)) {
-        RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
-        DVLOG(1) << "Could not write stream 0 data.";
-        Doom();
-      }
-      net::SHA256HashValue hash_value;
-      CalculateSHA256OfKey(key_, &hash_value);
-      if (files_[0].Write(stream_0_offset + entry_stat.data_size(0),
-                          reinterpret_cast<char*>(hash_value.data),
-                          sizeof(hash_value)) != sizeof(hash_value)) {
-        RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
-        DVLOG(1) << "Could not write stream 0 data.";
-        Doom();
-      }
-    }
-
     SimpleFileEOF eof_record;
     eof_record.stream_size = entry_stat.data_size(stream_index);
     eof_record.final_magic_number = kSimpleFinalMagicNumber;
@@ -735,10 +715,33 @@ void SimpleSynchronousEntry::Close(
       Doom();
       break;
     }
-    if (files_[file_index].Write(eof_offset,
-                                 reinterpret_cast<const char*>(&eof_record),
-                                 sizeof(eof_record)) !=
-        sizeof(eof_record)) {
+
+    // Stream 0 data and the key SHA256 directly precede their EOF record, so
+    // the three are written at once.
+    std::vector<char> record_data;
+    int record_offset = eof_offset;
+    if (stream_index == 0) {
+      net::SHA256HashValue hash_value;
+      CalculateSHA256OfKey(key_, &hash_value);
+      record_offset = entry_stat.GetOffsetInFile(key_.size(), 0, 0);
+      record_data.reserve(entry_stat.data_size(0) + sizeof(hash_value) +
+                          sizeof(eof_record));
+      record_data.insert(record_data.end(), stream_0_data->data(),
+                         stream_0_data->data() + entry_stat.data_size(0));
+      record_data.insert(record_data.end(),
+                         reinterpret_cast<const char*>(hash_value.data),
+                         reinterpret_cast<const char*>(hash_value.data) +
+                             sizeof(hash_value));
+      DCHECK_EQ(eof_offset,
+                record_offset + static_cast<int>(record_data.size()));
+    }
+    record_data.insert(record_data.end(),
+                       reinterpret_cast<const char*>(&eof_record),
+                       reinterpret_cast<const char*>(&eof_record) +
+                           sizeof(eof_record));
+    if (files_[file_index].Write(record_offset, record_data.data(),
+                                 record_data.size()) !=
+        static_cast<int>(record_data.size())) {
       RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
       DVLOG(1) << "Could not write eof record.";
       Doom();
@@ -1121,17 +1124,17 @@ bool SimpleSynchronousEntry::InitializeCreatedFile(
   header.key_length = key_.size();
   header.key_hash = base::Hash(key_);
 
-  int bytes_written = files_[file_index].Write(
-      0, reinterpret_cast<char*>(&header), sizeof(header));
-  if (bytes_written != sizeof(header)) {
-    *out_result = CREATE_ENTRY_CANT_WRITE_HEADER;
-    return false;
-  }
-
-  bytes_written = files_[file_index].Write(sizeof(header), key_.data(),
-                                           key_.size());
-  if (bytes_written != base::checked_cast<int>(key_.size())) {
-    *out_result = CREATE_ENTRY_CANT_WRITE_KEY;
+  // The key follows the header, so both are written at once.
+  std::vector<char> header_data(reinterpret_cast<const char*>(&header),
+                                reinterpret_cast<const char*>(&header) +
+                                    sizeof(header));
+  header_data.insert(header_data.end(), key_.begin(), key_.end());
+  int bytes_written = files_[file_index].Write(0, header_data.data(),
+                                               header_data.size());
+  if (bytes_written != base::checked_cast<int>(header_data.size())) {
+    *out_result = bytes_written < static_cast<int>(sizeof(header))
+                      ? CREATE_ENTRY_CANT_WRITE_HEADER
+                      : CREATE_ENTRY_CANT_WRITE_KEY;
     return false;
   }
 
@@ -1174,20 +1177,32 @@ int SimpleSynchronousEntry::ReadAndValidateStream0(
       1,
       total_data_size - sizeof(net::SHA256HashValue) - sizeof(SimpleFileEOF));
 
+  // Reads the end of the file, with the EOF record and, usually, stream 0.
+  const int tail_size = std::min(file_size, kStream0PrefetchSize);
+  const int tail_offset = file_size - tail_size;
+  std::vector<char> tail(tail_size);
+  if (tail_size < static_cast<int>(sizeof(SimpleFileEOF)) ||
+      files_[0].Read(tail_offset, tail.data(), tail_size) != tail_size) {
+    RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_READ_FAILURE);
+    return net::ERR_CACHE_CHECKSUM_READ_FAILURE;
+  }
+  SimpleFileEOF eof_record;
+  std::memcpy(&eof_record, tail.data() + tail_size - sizeof(eof_record),
+              sizeof(eof_record));
+
   bool has_crc32;
   bool has_key_sha256;
   uint32_t read_crc32;
   int stream_0_size;
-  int ret_value_crc32 =
-      GetEOFRecordData(0, *out_entry_stat, &has_crc32, &has_key_sha256,
-                       &read_crc32, &stream_0_size);
+  int ret_value_crc32 = ParseEOFRecord(eof_record, &has_crc32, &has_key_sha256,
+                                       &read_crc32, &stream_0_size);
   if (ret_value_crc32 != net::OK)
     return ret_value_crc32;
   // Calculate and set the real values for data size.
   int stream_1_size = out_entry_stat->data_size(1) - stream_0_size;
   if (!has_key_sha256)
     stream_1_size += sizeof(net::SHA256HashValue);
-  if (stream_1_size < 0)
+  if (stream_0_size < 0 || stream_1_size < 0)
     return net::ERR_FAILED;
   out_entry_stat->set_data_size(0, stream_0_size);
   out_entry_stat->set_data_size(1, stream_1_size);
@@ -1199,9 +1214,14 @@ int SimpleSynchronousEntry::ReadAndValidateStream0(
   int read_size = stream_0_size;
   if (has_key_sha256)
     read_size += sizeof(net::SHA256HashValue);
-  if (files_[0].Read(file_offset, (*stream_0_data)->data(), read_size) !=
-      read_size)
+  if (file_offset >= tail_offset) {
+    DCHECK_LE(file_offset + read_size, file_size);
+    std::memcpy((*stream_0_data)->data(),
+                tail.data() + (file_offset - tail_offset), read_size);
+  } else if (files_[0].Read(file_offset, (*stream_0_data)->data(),
+                            read_size) != read_size) {
     return net::ERR_FAILED;
+  }
 
   // Check the CRC32.
   uint32_t expected_crc32 =
@@ -1257,7 +1277,15 @@ int SimpleSynchronousEntry::GetEOFRecordData(int index,
     RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_READ_FAILURE);
     return net::ERR_CACHE_CHECKSUM_READ_FAILURE;
   }
+  return ParseEOFRecord(eof_record, out_has_crc32, out_has_key_sha256,
+                        out_crc32, out_data_size);
+}
 
+int SimpleSynchronousEntry::ParseEOFRecord(const SimpleFileEOF& eof_record,
+                                           bool* out_has_crc32,
+                                           bool* out_has_key_sha256,
+                                           uint32_t* out_crc32,
+                                           int* out_data_size) const {
   if (eof_record.final_magic_number != kSimpleFinalMagicNumber) {
     RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_MAGIC_NUMBER_MISMATCH);
     DVLOG(1) << "EOF record had bad magic number.";
@@ -220,6 +220,11 @@ class SimpleSynchronousEntry {
   // make it likely the entire key is read.
   static const size_t kInitialHeaderRead = 64 * 1024;
 
+  // When opening an entry, this much of the end of file 0 is read at once.
+  // Stream 0 and the key SHA256 directly precede the EOF record ending the
+  // file, so a small stream 0 comes along with it in a single read.
+  static const int kStream0PrefetchSize = 16 * 1024;
+
   SimpleSynchronousEntry(net::CacheType cache_type,
                          const base::FilePath& path,
                          const std::string& key,
@@ -280,6 +285,14 @@ class SimpleSynchronousEntry {
                        bool* out_has_key_sha256,
                        uint32_t* out_crc32,
                        int* out_data_size) const;
+
+  // Checks |eof_record|, which has already been read, and extracts its fields
+  // like GetEOFRecordData().
+  int ParseEOFRecord(const SimpleFileEOF& eof_record,
+                     bool* out_has_crc32,
+                     bool* out_has_key_sha256,
+                     uint32_t* out_crc32,
+                     int* out_data_size) const;
   void Doom() const;
 
   // Opens the sparse data file and scans it if it exists.
@@ -11,18 +11,22 @@
 
 #include "base/bind.h"
 #include "base/lazy_instance.h"
+#include "base/location.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/sample_vector.h"
 #include "base/rand_util.h"
+#include "base/single_thread_task_runner.h"
 #include "base/stl_util.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/dns/dns_config_service.h"
 #include "net/dns/dns_socket_pool.h"
+#include "net/dns/dns_tcp_connection.h"
 #include "net/dns/dns_util.h"
 #include "net/socket/stream_socket.h"
 #include "net/udp/datagram_client_socket.h"
@@ -107,7 +111,8 @@ DnsSession::DnsSession(const DnsConfig& config,
                                 0,
                                 std::numeric_limits<uint16_t>::max())),
       net_log_(net_log),
-      server_index_(0) {
+      server_index_(0),
+      tcp_connections_(config_.nameservers.size()) {
   socket_pool_->Initialize(&config_.nameservers, net_log);
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "AsyncDNS.ServerCount", config_.nameservers.size(), 0, 10, 11);
@@ -289,6 +294,25 @@ std::unique_ptr<StreamSocket> DnsSession::CreateTCPSocket(
   return socket_pool_->CreateTCPSocket(server_index, source);
 }
 
+DnsTCPConnection* DnsSession::GetTCPConnection(unsigned server_index,
+                                               const NetLog::Source& source) {
+  DCHECK_LT(server_index, tcp_connections_.size());
+  std::unique_ptr<DnsTCPConnection>& connection =
+      tcp_connections_[server_index];
+  UMA_HISTOGRAM_BOOLEAN("AsyncDNS.TCPConnectionReused",
+                        connection && connection->is_usable());
+  if (!connection || !connection->is_usable()) {
+    // A closed connection may still be running the callbacks of its queries.
+    if (connection) {
+      base::ThreadTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE,
+                                                      connection.release());
+    }
+    connection.reset(
+        new DnsTCPConnection(CreateTCPSocket(server_index, source)));
+  }
+  return connection.get();
+}
+
 // Release a socket.
 void DnsSession::FreeSocket(unsigned server_index,
                             std::unique_ptr<DatagramClientSocket> socket) {
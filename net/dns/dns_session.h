@@ -30,6 +30,7 @@ namespace net {
 
 class ClientSocketFactory;
 class DatagramClientSocket;
+class DnsTCPConnection;
 class NetLog;
 class StreamSocket;
 
@@ -110,6 +111,12 @@ class NET_EXPORT_PRIVATE DnsSession
   std::unique_ptr<StreamSocket> CreateTCPSocket(unsigned server_index,
                                                 const NetLog::Source& source);
 
+  // Returns the connection over which to query the server of |server_index|
+  // over TCP. It is shared by all transactions, and kept open between their
+  // queries; a new one is made once it is closed.
+  DnsTCPConnection* GetTCPConnection(unsigned server_index,
+                                     const NetLog::Source& source);
+
  private:
   friend class base::RefCounted<DnsSession>;
   ~DnsSession() override;
@@ -147,6 +154,9 @@ class NET_EXPORT_PRIVATE DnsSession
   // Track runtime statistics of each DNS server.
   std::vector<std::unique_ptr<ServerStats>> server_stats_;
 
+  // The TCP connection to each DNS server, if one was made.
+  std::vector<std::unique_ptr<DnsTCPConnection>> tcp_connections_;
+
   // Buckets shared for all |ServerStats::rtt_histogram|.
   struct RttBuckets : public base::BucketRanges {
     RttBuckets();
@@ -0,0 +1,296 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/dns_tcp_connection.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "base/big_endian.h"
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_query.h"
+#include "net/dns/dns_response.h"
+#include "net/socket/stream_socket.h"
+
+namespace net {
+
+namespace {
+
+// How long a connection is kept open without pending queries. Servers tend to
+// close idle connections after a few seconds anyway.
+const int kIdleTimeoutSeconds = 10;
+
+}  // namespace
+
+DnsTCPConnection::DnsTCPConnection(std::unique_ptr<StreamSocket> socket)
+    : socket_(std::move(socket)),
+      state_(STATE_NONE),
+      write_pending_(false),
+      reading_length_(false),
+      length_buffer_(new IOBufferWithSize(sizeof(uint16_t))),
+      read_pending_(false),
+      weak_factory_(this) {}
+
+DnsTCPConnection::~DnsTCPConnection() {}
+
+int DnsTCPConnection::Query(const DnsQuery& query,
+                            std::unique_ptr<DnsResponse>* response,
+                            const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!IsQueryIdInUse(query.id()));
+  DCHECK(!callback.is_null());
+
+  uint16_t query_size = static_cast<uint16_t>(query.io_buffer()->size());
+  if (static_cast<int>(query_size) != query.io_buffer()->size())
+    return ERR_FAILED;
+
+  if (state_ == STATE_NONE) {
+    int rv = Connect();
+    if (rv != OK && rv != ERR_IO_PENDING)
+      return rv;
+  }
+  if (state_ == STATE_CLOSED)
+    return ERR_CONNECTION_CLOSED;
+
+  scoped_refptr<IOBufferWithSize> buffer(
+      new IOBufferWithSize(sizeof(uint16_t) + query_size));
+  base::WriteBigEndian<uint16_t>(buffer->data(), query_size);
+  memcpy(buffer->data() + sizeof(uint16_t), query.io_buffer()->data(),
+         query_size);
+  write_queue_.push_back(std::make_pair(query.id(), buffer));
+
+  PendingQuery& pending = queries_[query.id()];
+  pending.response = response;
+  pending.callback = callback;
+  idle_timer_.Stop();
+
+  // Writing is posted so that a failure doesn't run |callback| before this
+  // returns.
+  if (state_ == STATE_CONNECTED && !write_pending_) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&DnsTCPConnection::DoWriteLoop,
+                              weak_factory_.GetWeakPtr()));
+  }
+  return ERR_IO_PENDING;
+}
+
+void DnsTCPConnection::CancelQuery(uint16_t id) {
+  DCHECK(CalledOnValidThread());
+  if (!queries_.erase(id))
+    return;
+  for (auto it = write_queue_.begin(); it != write_queue_.end(); ++it) {
+    if (it->first == id) {
+      write_queue_.erase(it);
+      break;
+    }
+  }
+  if (queries_.empty())
+    StartIdleTimer();
+}
+
+bool DnsTCPConnection::IsQueryIdInUse(uint16_t id) const {
+  return queries_.count(id) > 0;
+}
+
+const BoundNetLog& DnsTCPConnection::net_log() const {
+  return socket_->NetLog();
+}
+
+base::WeakPtr<DnsTCPConnection> DnsTCPConnection::GetWeakPtr() {
+  return weak_factory_.GetWeakPtr();
+}
+
+int DnsTCPConnection::Connect() {
+  DCHECK_EQ(STATE_NONE, state_);
+  state_ = STATE_CONNECTING;
+  int rv = socket_->Connect(base::Bind(&DnsTCPConnection::OnConnectComplete,
+                                       weak_factory_.GetWeakPtr()));
+  if (rv == ERR_IO_PENDING)
+    return rv;
+  if (rv < 0) {
+    state_ = STATE_CLOSED;
+    return rv;
+  }
+  state_ = STATE_CONNECTED;
+  return OK;
+}
+
+void DnsTCPConnection::OnConnectComplete(int rv) {
+  DCHECK_EQ(STATE_CONNECTING, state_);
+  if (rv < 0) {
+    Fail(rv);
+    return;
+  }
+  state_ = STATE_CONNECTED;
+  DoWriteLoop();
+}
+
+void DnsTCPConnection::DoWriteLoop() {
+  while (state_ == STATE_CONNECTED && !write_pending_) {
+    if (!write_buffer_) {
+      if (write_queue_.empty())
+        return;
+      scoped_refptr<IOBufferWithSize> buffer = write_queue_.front().second;
+      write_queue_.pop_front();
+      write_buffer_ = new DrainableIOBuffer(buffer.get(), buffer->size());
+    }
+    int rv =
+        socket_->Write(write_buffer_.get(), write_buffer_->BytesRemaining(),
+                       base::Bind(&DnsTCPConnection::OnWriteComplete,
+                                  weak_factory_.GetWeakPtr()));
+    if (rv == ERR_IO_PENDING) {
+      write_pending_ = true;
+      return;
+    }
+    if (!HandleWriteResult(rv))
+      return;
+  }
+}
+
+void DnsTCPConnection::OnWriteComplete(int rv) {
+  DCHECK(write_pending_);
+  write_pending_ = false;
+  if (HandleWriteResult(rv))
+    DoWriteLoop();
+}
+
+bool DnsTCPConnection::HandleWriteResult(int rv) {
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  if (rv < 0) {
+    Fail(rv);
+    return false;
+  }
+  write_buffer_->DidConsume(rv);
+  if (write_buffer_->BytesRemaining() > 0)
+    return true;
+  write_buffer_ = nullptr;
+
+  // Start reading once the first query is written. From then on, a read is
+  // always pending.
+  base::WeakPtr<DnsTCPConnection> self = weak_factory_.GetWeakPtr();
+  DoReadLoop();
+  return self && state_ == STATE_CONNECTED;
+}
+
+void DnsTCPConnection::DoReadLoop() {
+  while (state_ == STATE_CONNECTED && !read_pending_) {
+    if (!read_buffer_) {
+      reading_length_ = true;
+      read_buffer_ =
+          new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
+    }
+    int rv = socket_->Read(read_buffer_.get(), read_buffer_->BytesRemaining(),
+                           base::Bind(&DnsTCPConnection::OnReadComplete,
+                                      weak_factory_.GetWeakPtr()));
+    if (rv == ERR_IO_PENDING) {
+      read_pending_ = true;
+      return;
+    }
+    if (!HandleReadResult(rv))
+      return;
+  }
+}
+
+void DnsTCPConnection::OnReadComplete(int rv) {
+  DCHECK(read_pending_);
+  read_pending_ = false;
+  if (HandleReadResult(rv))
+    DoReadLoop();
+}
+
+bool DnsTCPConnection::HandleReadResult(int rv) {
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  if (rv < 0) {
+    Fail(rv);
+    return false;
+  }
+  if (rv == 0) {
+    Fail(ERR_CONNECTION_CLOSED);
+    return false;
+  }
+
+  read_buffer_->DidConsume(rv);
+  if (read_buffer_->BytesRemaining() > 0)
+    return true;
+
+  if (!reading_length_)
+    return DispatchResponse();
+
+  uint16_t response_length;
+  base::ReadBigEndian<uint16_t>(length_buffer_->data(), &response_length);
+  // The id is needed to find the query.
+  if (response_length < sizeof(dns_protocol::Header)) {
+    Fail(ERR_DNS_MALFORMED_RESPONSE);
+    return false;
+  }
+  // Allocate more space so that DnsResponse::InitParse sanity check passes.
+  read_response_.reset(new DnsResponse(response_length + 1));
+  read_buffer_ =
+      new DrainableIOBuffer(read_response_->io_buffer(), response_length);
+  reading_length_ = false;
+  return true;
+}
+
+bool DnsTCPConnection::DispatchResponse() {
+  int size = read_buffer_->BytesConsumed();
+  read_buffer_ = nullptr;
+  std::unique_ptr<DnsResponse> response = std::move(read_response_);
+
+  uint16_t id;
+  base::ReadBigEndian<uint16_t>(response->io_buffer()->data(), &id);
+  auto it = queries_.find(id);
+  // The query may have been cancelled.
+  if (it == queries_.end())
+    return true;
+
+  PendingQuery query = it->second;
+  queries_.erase(it);
+  *query.response = std::move(response);
+  if (queries_.empty())
+    StartIdleTimer();
+
+  base::WeakPtr<DnsTCPConnection> self = weak_factory_.GetWeakPtr();
+  query.callback.Run(size);
+  return !!self;
+}
+
+void DnsTCPConnection::StartIdleTimer() {
+  if (state_ == STATE_CLOSED)
+    return;
+  idle_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromSeconds(kIdleTimeoutSeconds), this,
+                    &DnsTCPConnection::OnIdleTimeout);
+}
+
+void DnsTCPConnection::OnIdleTimeout() {
+  DCHECK(queries_.empty());
+  Fail(ERR_CONNECTION_CLOSED);
+}
+
+void DnsTCPConnection::Fail(int rv) {
+  DCHECK_NE(STATE_CLOSED, state_);
+  state_ = STATE_CLOSED;
+  idle_timer_.Stop();
+  write_queue_.clear();
+  socket_->Disconnect();
+
+  // Callbacks may cancel other queries, or destroy this.
+  base::WeakPtr<DnsTCPConnection> self = weak_factory_.GetWeakPtr();
+  while (!queries_.empty()) {
+    CompletionCallback callback = queries_.begin()->second.callback;
+    queries_.erase(queries_.begin());
+    callback.Run(rv);
+    if (!self)
+      return;
+  }
+}
+
+}  // namespace net
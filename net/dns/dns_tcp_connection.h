@@ -0,0 +1,139 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DNS_DNS_TCP_CONNECTION_H_
+#define NET_DNS_DNS_TCP_CONNECTION_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/timer/timer.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_export.h"
+#include "net/log/net_log.h"
+
+namespace net {
+
+class DnsQuery;
+class DnsResponse;
+class DrainableIOBuffer;
+class IOBufferWithSize;
+class StreamSocket;
+
+// A TCP connection to a DNS server, kept open and shared by the queries of
+// all transactions to that server, as in RFC 7766. Queries are written as soon
+// as they are made, without waiting for the responses to earlier ones, and
+// responses are matched to their queries by id, in whatever order the server
+// sends them.
+//
+// The connection is made on the first query. It is closed after being idle for
+// a while, or on any error, which fails all of its pending queries; a closed
+// connection can't be used again.
+class NET_EXPORT_PRIVATE DnsTCPConnection : public base::NonThreadSafe {
+ public:
+  explicit DnsTCPConnection(std::unique_ptr<StreamSocket> socket);
+  ~DnsTCPConnection();
+
+  // Sends |query|. Once its response is read, sets |response| to it and calls
+  // |callback| with its size, or with a network error if the connection fails
+  // first. The response is not parsed. Returns ERR_IO_PENDING, or an error if
+  // the query can't be sent, in which case |callback| is not called.
+  // |response| must stay valid until |callback| is called or the query is
+  // cancelled.
+  int Query(const DnsQuery& query,
+            std::unique_ptr<DnsResponse>* response,
+            const CompletionCallback& callback);
+
+  // Cancels the query of |id|, so that its callback isn't called. Its response
+  // is ignored if it arrives.
+  void CancelQuery(uint16_t id);
+
+  // Whether a query of |id| is pending, in which case a query can't be made
+  // with the same id.
+  bool IsQueryIdInUse(uint16_t id) const;
+
+  // Whether queries can still be made over this connection.
+  bool is_usable() const { return state_ != STATE_CLOSED; }
+
+  size_t pending_query_count() const { return queries_.size(); }
+
+  const BoundNetLog& net_log() const;
+
+  base::WeakPtr<DnsTCPConnection> GetWeakPtr();
+
+ private:
+  enum State {
+    STATE_NONE,
+    STATE_CONNECTING,
+    STATE_CONNECTED,
+    STATE_CLOSED,
+  };
+
+  struct PendingQuery {
+    std::unique_ptr<DnsResponse>* response;
+    CompletionCallback callback;
+  };
+
+  int Connect();
+  void OnConnectComplete(int rv);
+
+  // Writes the queued queries one after another.
+  void DoWriteLoop();
+  void OnWriteComplete(int rv);
+  // Returns false if the connection failed or was destroyed.
+  bool HandleWriteResult(int rv);
+
+  // Reads the length and then the body of each response, and hands it to its
+  // query. Keeps a read pending while connected, to notice when the server
+  // closes the connection.
+  void DoReadLoop();
+  void OnReadComplete(int rv);
+  // Returns false if the connection failed or was destroyed.
+  bool HandleReadResult(int rv);
+  // Returns false if this was destroyed by the callback of the query.
+  bool DispatchResponse();
+
+  void StartIdleTimer();
+  void OnIdleTimeout();
+
+  // Closes the connection and fails all pending queries with |rv|.
+  void Fail(int rv);
+
+  std::unique_ptr<StreamSocket> socket_;
+  State state_;
+
+  std::map<uint16_t, PendingQuery> queries_;
+
+  // Length-prefixed queries not yet written, with their ids, and the one being
+  // written.
+  std::deque<std::pair<uint16_t, scoped_refptr<IOBufferWithSize>>>
+      write_queue_;
+  scoped_refptr<DrainableIOBuffer> write_buffer_;
+  bool write_pending_;
+
+  // Whether the length of a response is being read, rather than its body.
+  bool reading_length_;
+  scoped_refptr<IOBufferWithSize> length_buffer_;
+  std::unique_ptr<DnsResponse> read_response_;
+  scoped_refptr<DrainableIOBuffer> read_buffer_;
+  bool read_pending_;
+
+  base::OneShotTimer idle_timer_;
+
+  base::WeakPtrFactory<DnsTCPConnection> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTCPConnection);
+};
+
+}  // namespace net
+
+#endif  // NET_DNS_DNS_TCP_CONNECTION_H_
@@ -0,0 +1,203 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/dns_tcp_connection.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/big_endian.h"
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "base/sys_byteorder.h"
+#include "net/base/address_list.h"
+#include "net/base/net_errors.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_query.h"
+#include "net/dns/dns_response.h"
+#include "net/dns/dns_test_util.h"
+#include "net/dns/dns_util.h"
+#include "net/socket/socket_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+std::unique_ptr<DnsQuery> CreateQuery(uint16_t id, const char* dotted_name) {
+  std::string qname;
+  EXPECT_TRUE(DNSDomainFromDot(dotted_name, &qname));
+  return std::unique_ptr<DnsQuery>(
+      new DnsQuery(id, qname, dns_protocol::kTypeA));
+}
+
+// Returns |message| prefixed with its length, as sent over TCP.
+std::string Frame(const char* message, size_t size) {
+  std::string framed(sizeof(uint16_t), '\0');
+  base::WriteBigEndian<uint16_t>(&framed[0], static_cast<uint16_t>(size));
+  framed.append(message, size);
+  return framed;
+}
+
+std::string FrameQuery(const DnsQuery& query) {
+  return Frame(query.io_buffer()->data(), query.io_buffer()->size());
+}
+
+// Returns a response with no answer to |query|.
+std::string FrameResponse(const DnsQuery& query) {
+  std::string response(query.io_buffer()->data(), query.io_buffer()->size());
+  dns_protocol::Header* header =
+      reinterpret_cast<dns_protocol::Header*>(&response[0]);
+  header->flags |= base::HostToNet16(dns_protocol::kFlagResponse);
+  return Frame(response.data(), response.size());
+}
+
+class DnsTCPConnectionTest : public testing::Test {
+ protected:
+  struct Result {
+    uint16_t id;
+    int rv;
+  };
+
+  DnsTCPConnectionTest()
+      : query1_(CreateQuery(1, kT0HostName)),
+        query2_(CreateQuery(2, kT1HostName)) {}
+
+  // Makes |connection_| over a socket reading and writing |data|.
+  void CreateConnection(SequencedSocketData* data) {
+    data->set_connect_data(MockConnect(SYNCHRONOUS, OK));
+    connection_.reset(new DnsTCPConnection(std::unique_ptr<StreamSocket>(
+        new MockTCPClientSocket(AddressList(), nullptr, data))));
+  }
+
+  int Query(const DnsQuery& query) {
+    return connection_->Query(
+        query, &responses_[query.id()],
+        base::Bind(&DnsTCPConnectionTest::OnQueryComplete,
+                   base::Unretained(this), query.id()));
+  }
+
+  void OnQueryComplete(uint16_t id, int rv) {
+    Result result = {id, rv};
+    results_.push_back(result);
+    if (rv > 0) {
+      ASSERT_TRUE(responses_[id]);
+      EXPECT_TRUE(responses_[id]->InitParse(
+          rv, id == query1_->id() ? *query1_ : *query2_));
+    }
+  }
+
+  std::unique_ptr<DnsQuery> query1_;
+  std::unique_ptr<DnsQuery> query2_;
+  std::unique_ptr<DnsTCPConnection> connection_;
+  std::map<uint16_t, std::unique_ptr<DnsResponse>> responses_;
+  std::vector<Result> results_;
+};
+
+TEST_F(DnsTCPConnectionTest, OutOfOrderResponses) {
+  const std::string write1 = FrameQuery(*query1_);
+  const std::string write2 = FrameQuery(*query2_);
+  const std::string read1 = FrameResponse(*query1_);
+  const std::string read2 = FrameResponse(*query2_);
+  MockWrite writes[] = {
+      MockWrite(ASYNC, write1.data(), write1.size(), 0),
+      MockWrite(ASYNC, write2.data(), write2.size(), 1),
+  };
+  MockRead reads[] = {
+      MockRead(ASYNC, read2.data(), read2.size(), 2),
+      MockRead(ASYNC, read1.data(), read1.size(), 3),
+      MockRead(SYNCHRONOUS, ERR_IO_PENDING, 4),
+  };
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  CreateConnection(&data);
+
+  // The second query is written without waiting for the first response.
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query1_));
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query2_));
+  EXPECT_TRUE(connection_->IsQueryIdInUse(query1_->id()));
+  EXPECT_EQ(2u, connection_->pending_query_count());
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(2u, results_.size());
+  EXPECT_EQ(query2_->id(), results_[0].id);
+  EXPECT_EQ(query1_->id(), results_[1].id);
+  EXPECT_EQ(0u, connection_->pending_query_count());
+  EXPECT_TRUE(connection_->is_usable());
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+}
+
+TEST_F(DnsTCPConnectionTest, CancelledQuery) {
+  const std::string write1 = FrameQuery(*query1_);
+  const std::string read1 = FrameResponse(*query1_);
+  MockWrite writes[] = {
+      MockWrite(ASYNC, write1.data(), write1.size(), 0),
+  };
+  MockRead reads[] = {
+      MockRead(ASYNC, ERR_IO_PENDING, 1),
+      MockRead(ASYNC, read1.data(), read1.size(), 2),
+      MockRead(SYNCHRONOUS, ERR_IO_PENDING, 3),
+  };
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  CreateConnection(&data);
+
+  // The first query is cancelled after being written, the second before.
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query1_));
+  data.RunUntilPaused();
+  connection_->CancelQuery(query1_->id());
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query2_));
+  connection_->CancelQuery(query2_->id());
+  EXPECT_FALSE(connection_->IsQueryIdInUse(query1_->id()));
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+
+  // The response to the first one is ignored.
+  EXPECT_TRUE(results_.empty());
+  EXPECT_TRUE(connection_->is_usable());
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+}
+
+TEST_F(DnsTCPConnectionTest, ClosedConnectionFailsAllQueries) {
+  const std::string write1 = FrameQuery(*query1_);
+  const std::string write2 = FrameQuery(*query2_);
+  MockWrite writes[] = {
+      MockWrite(ASYNC, write1.data(), write1.size(), 0),
+      MockWrite(ASYNC, write2.data(), write2.size(), 1),
+  };
+  MockRead reads[] = {
+      MockRead(ASYNC, 0, 2),
+  };
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  CreateConnection(&data);
+
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query1_));
+  EXPECT_EQ(ERR_IO_PENDING, Query(*query2_));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(2u, results_.size());
+  EXPECT_EQ(ERR_CONNECTION_CLOSED, results_[0].rv);
+  EXPECT_EQ(ERR_CONNECTION_CLOSED, results_[1].rv);
+  EXPECT_FALSE(connection_->is_usable());
+  EXPECT_EQ(ERR_CONNECTION_CLOSED, Query(*query1_));
+}
+
+TEST_F(DnsTCPConnectionTest, ConnectFailure) {
+  SequencedSocketData data(nullptr, 0, nullptr, 0);
+  data.set_connect_data(MockConnect(SYNCHRONOUS, ERR_CONNECTION_REFUSED));
+  connection_.reset(new DnsTCPConnection(std::unique_ptr<StreamSocket>(
+      new MockTCPClientSocket(AddressList(), nullptr, &data))));
+
+  EXPECT_EQ(ERR_CONNECTION_REFUSED, Query(*query1_));
+  EXPECT_FALSE(connection_->is_usable());
+  EXPECT_FALSE(connection_->IsQueryIdInUse(query1_->id()));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -10,7 +10,6 @@
 #include <utility>
 #include <vector>
 
-#include "base/big_endian.h"
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/macros.h"
@@ -18,7 +17,6 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/histogram.h"
-#include "base/profiler/scoped_tracker.h"
 #include "base/rand_util.h"
 #include "base/single_thread_task_runner.h"
 #include "base/stl_util.h"
@@ -36,9 +34,9 @@
 #include "net/dns/dns_query.h"
 #include "net/dns/dns_response.h"
 #include "net/dns/dns_session.h"
+#include "net/dns/dns_tcp_connection.h"
 #include "net/dns/dns_util.h"
 #include "net/log/net_log.h"
-#include "net/socket/stream_socket.h"
 #include "net/udp/datagram_client_socket.h"
 
 namespace net {
@@ -299,31 +297,35 @@ class DnsUDPAttempt : public DnsAttempt {
   DISALLOW_COPY_AND_ASSIGN(DnsUDPAttempt);
 };
 
+// A query over the TCP connection to a server, which is shared with the other
+// transactions, so the attempt only waits for the response matching its query.
 class DnsTCPAttempt : public DnsAttempt {
  public:
   DnsTCPAttempt(unsigned server_index,
-                std::unique_ptr<StreamSocket> socket,
+                DnsTCPConnection* connection,
                 std::unique_ptr<DnsQuery> query)
       : DnsAttempt(server_index),
-        next_state_(STATE_NONE),
-        socket_(std::move(socket)),
-        query_(std::move(query)),
-        length_buffer_(new IOBufferWithSize(sizeof(uint16_t))),
-        response_length_(0) {}
+        connection_(connection->GetWeakPtr()),
+        socket_net_log_(connection->net_log()),
+        query_(std::move(query)) {}
+
+  ~DnsTCPAttempt() override {
+    if (is_pending() && connection_)
+      connection_->CancelQuery(query_->id());
+  }
 
   // DnsAttempt:
   int Start(const CompletionCallback& callback) override {
-    DCHECK_EQ(STATE_NONE, next_state_);
     callback_ = callback;
     start_time_ = base::TimeTicks::Now();
-    next_state_ = STATE_CONNECT_COMPLETE;
-    int rv = socket_->Connect(base::Bind(&DnsTCPAttempt::OnIOComplete,
-                                         base::Unretained(this)));
+    int rv = connection_->Query(
+        *query_, &response_,
+        base::Bind(&DnsTCPAttempt::OnQueryComplete, base::Unretained(this)));
     if (rv == ERR_IO_PENDING) {
       set_result(rv);
       return rv;
     }
-    return DoLoop(rv);
+    return HandleResult(rv);
   }
 
   const DnsQuery* GetQuery() const override { return query_.get(); }
@@ -334,177 +336,32 @@ class DnsTCPAttempt : public DnsAttempt {
   }
 
   const BoundNetLog& GetSocketNetLog() const override {
-    return socket_->NetLog();
+    return socket_net_log_;
   }
 
  private:
-  enum State {
-    STATE_CONNECT_COMPLETE,
-    STATE_SEND_LENGTH,
-    STATE_SEND_QUERY,
-    STATE_READ_LENGTH,
-    STATE_READ_LENGTH_COMPLETE,
-    STATE_READ_RESPONSE,
-    STATE_READ_RESPONSE_COMPLETE,
-    STATE_NONE,
-  };
-
-  int DoLoop(int result) {
-    CHECK_NE(STATE_NONE, next_state_);
-    int rv = result;
-    do {
-      State state = next_state_;
-      next_state_ = STATE_NONE;
-      switch (state) {
-        case STATE_CONNECT_COMPLETE:
-          rv = DoConnectComplete(rv);
-          break;
-        case STATE_SEND_LENGTH:
-          rv = DoSendLength(rv);
-          break;
-        case STATE_SEND_QUERY:
-          rv = DoSendQuery(rv);
-          break;
-        case STATE_READ_LENGTH:
-          rv = DoReadLength(rv);
-          break;
-        case STATE_READ_LENGTH_COMPLETE:
-          rv = DoReadLengthComplete(rv);
-          break;
-        case STATE_READ_RESPONSE:
-          rv = DoReadResponse(rv);
-          break;
-        case STATE_READ_RESPONSE_COMPLETE:
-          rv = DoReadResponseComplete(rv);
-          break;
-        default:
-          NOTREACHED();
-          break;
-      }
-    } while (rv != ERR_IO_PENDING && next_state_ != STATE_NONE);
+  // |rv| is the size of the response, or an error.
+  int HandleResult(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv >= 0)
+      rv = ParseResponse(rv);
 
     set_result(rv);
     if (rv == OK) {
-      DCHECK_EQ(STATE_NONE, next_state_);
       DNS_HISTOGRAM("AsyncDNS.TCPAttemptSuccess",
                     base::TimeTicks::Now() - start_time_);
-    } else if (rv != ERR_IO_PENDING) {
+    } else {
       DNS_HISTOGRAM("AsyncDNS.TCPAttemptFail",
                     base::TimeTicks::Now() - start_time_);
     }
     return rv;
   }
 
-  int DoConnectComplete(int rv) {
-    // TODO(rvargas): Remove ScopedTracker below once crbug.com/462784 is fixed.
-    tracked_objects::ScopedTracker tracking_profile(
-        FROM_HERE_WITH_EXPLICIT_FUNCTION(
-            "462784 DnsTCPAttempt::DoConnectComplete"));
-
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    uint16_t query_size = static_cast<uint16_t>(query_->io_buffer()->size());
-    if (static_cast<int>(query_size) != query_->io_buffer()->size())
-      return ERR_FAILED;
-    base::WriteBigEndian<uint16_t>(length_buffer_->data(), query_size);
-    buffer_ =
-        new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
-    next_state_ = STATE_SEND_LENGTH;
-    return OK;
-  }
-
-  int DoSendLength(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_SEND_LENGTH;
-      return socket_->Write(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    buffer_ = new DrainableIOBuffer(query_->io_buffer(),
-                                    query_->io_buffer()->size());
-    next_state_ = STATE_SEND_QUERY;
-    return OK;
-  }
-
-  int DoSendQuery(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_SEND_QUERY;
-      return socket_->Write(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    buffer_ =
-        new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
-    next_state_ = STATE_READ_LENGTH;
-    return OK;
-  }
-
-  int DoReadLength(int rv) {
-    DCHECK_EQ(OK, rv);
-
-    next_state_ = STATE_READ_LENGTH_COMPLETE;
-    return ReadIntoBuffer();
-  }
-
-  int DoReadLengthComplete(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-    if (rv == 0)
-      return ERR_CONNECTION_CLOSED;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_READ_LENGTH;
-      return OK;
-    }
-
-    base::ReadBigEndian<uint16_t>(length_buffer_->data(), &response_length_);
+  int ParseResponse(int size) {
     // Check if advertised response is too short. (Optimization only.)
-    if (response_length_ < query_->io_buffer()->size())
+    if (size < query_->io_buffer()->size())
       return ERR_DNS_MALFORMED_RESPONSE;
-    // Allocate more space so that DnsResponse::InitParse sanity check passes.
-    response_.reset(new DnsResponse(response_length_ + 1));
-    buffer_ = new DrainableIOBuffer(response_->io_buffer(), response_length_);
-    next_state_ = STATE_READ_RESPONSE;
-    return OK;
-  }
-
-  int DoReadResponse(int rv) {
-    DCHECK_EQ(OK, rv);
-
-    next_state_ = STATE_READ_RESPONSE_COMPLETE;
-    return ReadIntoBuffer();
-  }
-
-  int DoReadResponseComplete(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-    if (rv == 0)
-      return ERR_CONNECTION_CLOSED;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_READ_RESPONSE;
-      return OK;
-    }
-
-    if (!response_->InitParse(buffer_->BytesConsumed(), *query_))
+    if (!response_->InitParse(size, *query_))
       return ERR_DNS_MALFORMED_RESPONSE;
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_UNEXPECTED;
@@ -517,28 +374,15 @@ class DnsTCPAttempt : public DnsAttempt {
     return OK;
   }
 
-  void OnIOComplete(int rv) {
-    rv = DoLoop(rv);
-    if (rv != ERR_IO_PENDING)
-      callback_.Run(rv);
-  }
-
-  int ReadIntoBuffer() {
-    return socket_->Read(
-        buffer_.get(),
-        buffer_->BytesRemaining(),
-        base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
+  void OnQueryComplete(int rv) {
+    callback_.Run(HandleResult(rv));
   }
 
-  State next_state_;
+  base::WeakPtr<DnsTCPConnection> connection_;
+  BoundNetLog socket_net_log_;
   base::TimeTicks start_time_;
 
-  std::unique_ptr<StreamSocket> socket_;
   std::unique_ptr<DnsQuery> query_;
-  scoped_refptr<IOBufferWithSize> length_buffer_;
-  scoped_refptr<DrainableIOBuffer> buffer_;
-
-  uint16_t response_length_;
   std::unique_ptr<DnsResponse> response_;
 
   CompletionCallback callback_;
@@ -757,11 +601,14 @@ class DnsTransactionImpl : public DnsTransaction,
 
     unsigned server_index = previous_attempt->server_index();
 
-    std::unique_ptr<StreamSocket> socket(
-        session_->CreateTCPSocket(server_index, net_log_.source()));
+    DnsTCPConnection* connection =
+        session_->GetTCPConnection(server_index, net_log_.source());
 
     // TODO(szym): Reuse the same id to help the server?
     uint16_t id = session_->NextQueryId();
+    // Responses over the connection are matched to their queries by id.
+    while (connection->IsQueryIdInUse(id))
+      id = session_->NextQueryId();
     std::unique_ptr<DnsQuery> query =
         previous_attempt->GetQuery()->CloneWithNewId(id);
 
@@ -772,7 +619,7 @@ class DnsTransactionImpl : public DnsTransaction,
     unsigned attempt_number = attempts_.size();
 
     DnsTCPAttempt* attempt =
-        new DnsTCPAttempt(server_index, std::move(socket), std::move(query));
+        new DnsTCPAttempt(server_index, connection, std::move(query));
 
     attempts_.push_back(base::WrapUnique(attempt));
     ++attempts_count_;
@@ -37,6 +37,14 @@ std::string DomainFromDot(const base::StringPiece& dotted) {
   return out;
 }
 
+// Returns |data| prefixed with its length, as sent over TCP.
+std::string FrameTCPMessage(const char* data, size_t size) {
+  uint16_t length = base::HostToNet16(static_cast<uint16_t>(size));
+  std::string framed(reinterpret_cast<const char*>(&length), sizeof(length));
+  framed.append(data, size);
+  return framed;
+}
+
 // A SocketDataProvider builder.
 class DnsSocketData {
  public:
@@ -989,6 +997,52 @@ TEST_F(DnsTransactionTest, TCPConnectionClosedSynchronous) {
   EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
 }
 
+TEST_F(DnsTransactionTest, TCPConnectionSharedByTransactions) {
+  AddAsyncQueryAndRcode(kT0HostName, kT0Qtype,
+                        dns_protocol::kRcodeNOERROR | dns_protocol::kFlagTC);
+  AddAsyncQueryAndRcode(kT1HostName, kT1Qtype,
+                        dns_protocol::kRcodeNOERROR | dns_protocol::kFlagTC);
+
+  // Both queries go over one connection, and are answered out of order.
+  DnsQuery query0(0, DomainFromDot(kT0HostName), kT0Qtype);
+  DnsQuery query1(1, DomainFromDot(kT1HostName), kT1Qtype);
+  const std::string write0 = FrameTCPMessage(query0.io_buffer()->data(),
+                                             query0.io_buffer()->size());
+  const std::string write1 = FrameTCPMessage(query1.io_buffer()->data(),
+                                             query1.io_buffer()->size());
+  const std::string read0 = FrameTCPMessage(
+      reinterpret_cast<const char*>(kT0ResponseDatagram),
+      arraysize(kT0ResponseDatagram));
+  const std::string read1 = FrameTCPMessage(
+      reinterpret_cast<const char*>(kT1ResponseDatagram),
+      arraysize(kT1ResponseDatagram));
+  MockWrite writes[] = {
+      MockWrite(ASYNC, write0.data(), write0.size(), 0),
+      MockWrite(ASYNC, write1.data(), write1.size(), 1),
+  };
+  MockRead reads[] = {
+      MockRead(ASYNC, read1.data(), read1.size(), 2),
+      MockRead(ASYNC, read0.data(), read0.size(), 3),
+      MockRead(SYNCHRONOUS, ERR_IO_PENDING, 4),
+  };
+  SequencedSocketData tcp_data(reads, arraysize(reads), writes,
+                               arraysize(writes));
+  tcp_data.set_connect_data(MockConnect(ASYNC, OK));
+  socket_factory_->AddSocketDataProvider(&tcp_data);
+  transaction_ids_.push_back(query0.id());
+  transaction_ids_.push_back(query1.id());
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  TransactionHelper helper1(kT1HostName, kT1Qtype, kT1RecordCount);
+  helper0.StartTransaction(transaction_factory_.get());
+  helper1.StartTransaction(transaction_factory_.get());
+  base::MessageLoop::current()->RunUntilIdle();
+
+  EXPECT_TRUE(helper0.has_completed());
+  EXPECT_TRUE(helper1.has_completed());
+  EXPECT_TRUE(tcp_data.AllWriteDataConsumed());
+}
+
 TEST_F(DnsTransactionTest, InvalidQuery) {
   config_.timeout = TestTimeouts::tiny_timeout();
   ConfigureFactory();
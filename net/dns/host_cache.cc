@@ -4,6 +4,7 @@
 
 #include "net/dns/host_cache.h"
 
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/field_trial.h"
@@ -102,6 +103,13 @@ void HostCache::Entry::GetStaleness(base::TimeTicks now,
   out->stale_hits = stale_hits_;
 }
 
+size_t HostCache::KeyHash::operator()(const Key& key) const {
+  return base::HashInts(
+      base::HashInts(static_cast<int>(key.address_family),
+                     key.host_resolver_flags),
+      base::Hash(key.hostname));
+}
+
 HostCache::HostCache(size_t max_entries)
     : max_entries_(max_entries), network_changes_(0) {}
 
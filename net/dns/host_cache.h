@@ -12,6 +12,7 @@
 #include <string>
 #include <tuple>
 
+#include "base/containers/flat_hash_map.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/threading/non_thread_safe.h"
@@ -44,11 +45,21 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
                       other.hostname);
     }
 
+    bool operator==(const Key& other) const {
+      return address_family == other.address_family &&
+             host_resolver_flags == other.host_resolver_flags &&
+             hostname == other.hostname;
+    }
+
     std::string hostname;
     AddressFamily address_family;
     HostResolverFlags host_resolver_flags;
   };
 
+  struct NET_EXPORT KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
   struct NET_EXPORT EntryStaleness {
     // Time since the entry's TTL has expired. Negative if not expired.
     base::TimeDelta expired_by;
@@ -112,7 +123,7 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
     int stale_hits_;
   };
 
-  using EntryMap = std::map<Key, Entry>;
+  using EntryMap = base::flat_hash_map<Key, Entry, KeyHash>;
 
   // Constructs a HostCache that stores up to |max_entries|.
   explicit HostCache(size_t max_entries);
@@ -101,6 +101,10 @@ HostResolver::RequestInfo::RequestInfo(const HostPortPair& host_port_pair)
 HostResolver::~HostResolver() {
 }
 
+void HostResolver::Preresolve(const std::vector<RequestInfo>& infos,
+                              const BoundNetLog& net_log) {
+}
+
 void HostResolver::SetDnsClientEnabled(bool enabled) {
 }
 
@@ -10,8 +10,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "net/base/address_family.h"
 #include "net/base/completion_callback.h"
 #include "net/base/host_port_pair.h"
@@ -49,6 +51,10 @@ class NET_EXPORT HostResolver {
   // resolution. Pass HostResolver::kDefaultRetryAttempts to choose a default
   // value.
   // |enable_caching| controls whether a HostCache is used.
+  // |max_stale_while_revalidate| is how long past its TTL a cached result can
+  // still be returned by Resolve(), while it is refreshed in the background.
+  // Results cached before a network change are never returned. Zero, the
+  // default, disables this.
   struct NET_EXPORT Options {
     Options();
 
@@ -57,6 +63,7 @@ class NET_EXPORT HostResolver {
     size_t max_concurrent_resolves;
     size_t max_retry_attempts;
     bool enable_caching;
+    base::TimeDelta max_stale_while_revalidate;
   };
 
   // The parameters for doing a Resolve(). A hostname and port are
@@ -175,6 +182,14 @@ class NET_EXPORT HostResolver {
                                AddressList* addresses,
                                const BoundNetLog& net_log) = 0;
 
+  // Starts resolving each of |infos| in the background, at IDLE priority, and
+  // in parallel up to the resolver's limits, so that later Resolve() calls for
+  // them are served from the cache or join the lookup in flight. Hosts that are
+  // cached or being resolved are skipped. Nothing is reported back. Meant for
+  // the hosts a page load is predicted to need. Does nothing by default.
+  virtual void Preresolve(const std::vector<RequestInfo>& infos,
+                          const BoundNetLog& net_log);
+
   // Enable or disable the built-in asynchronous DnsClient.
   virtual void SetDnsClientEnabled(bool enabled);
 
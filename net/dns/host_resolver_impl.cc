@@ -1288,6 +1288,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         priority_tracker_(priority),
         worker_task_runner_(std::move(worker_task_runner)),
         had_non_speculative_request_(false),
+        is_background_(false),
         had_dns_config_(false),
         num_occupied_job_slots_(0),
         dns_task_error_(OK),
@@ -1352,6 +1353,11 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     }
   }
 
+  // Marks this Job as started without a Request, to refresh or fill the
+  // cache. It then runs to completion, and caches its result, even without
+  // active Requests.
+  void set_is_background() { is_background_ = true; }
+
   void AddRequest(std::unique_ptr<Request> req) {
     DCHECK_EQ(key_.hostname, req->info().hostname());
 
@@ -1406,7 +1412,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                                  req->source_net_log().source(),
                                  priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_background_) {
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1449,11 +1455,13 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
-    DCHECK_GT(num_active_requests(), 0u);
+    DCHECK(num_active_requests() > 0 || is_background_);
     AddressList addr_list;
-    if (resolver_->ServeFromHosts(key(),
-                                  requests_.front()->info(),
-                                  &addr_list)) {
+    if (resolver_->ServeFromHosts(
+            key(), requests_.empty()
+                       ? RequestInfo(HostPortPair(key_.hostname, 0))
+                       : requests_.front()->info(),
+            &addr_list)) {
       // This will destroy the Job.
       CompleteRequests(
           HostCache::Entry(OK, MakeAddressListForRequest(addr_list)),
@@ -1752,7 +1760,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
       handle_.Reset();
     }
 
-    if (num_active_requests() == 0) {
+    if (num_active_requests() == 0 && !is_background_) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1762,8 +1770,6 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                       entry.error());
 
-    DCHECK(!requests_.empty());
-
     if (entry.error() == OK) {
       // Record this histogram here, when we know the system has a valid DNS
       // configuration.
@@ -1833,6 +1839,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
 
   bool had_non_speculative_request_;
 
+  // Whether this Job was started without a Request, by StartBackgroundJob().
+  bool is_background_;
+
   // Distinguishes measurements taken while DnsClient was fully configured.
   bool had_dns_config_;
 
@@ -1933,6 +1942,12 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
 
   int rv = ResolveHelper(key, info, ip_address_ptr, addresses, false, nullptr,
                          source_net_log);
+  if (rv == ERR_DNS_CACHE_MISS &&
+      ServeStaleWhileRevalidating(key, info, addresses)) {
+    source_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
+    StartBackgroundJob(key, source_net_log);
+    rv = OK;
+  }
   if (rv != ERR_DNS_CACHE_MISS) {
     LogFinishRequest(source_net_log, info, rv);
     RecordTotalTime(HaveDnsConfig(), info.is_speculative(), base::TimeDelta());
@@ -1981,6 +1996,7 @@ HostResolverImpl::HostResolverImpl(
     NetLog* net_log,
     scoped_refptr<base::TaskRunner> worker_task_runner)
     : max_queued_jobs_(0),
+      max_stale_while_revalidate_(options.max_stale_while_revalidate),
       proc_params_(NULL, options.max_retry_attempts),
       net_log_(net_log),
       received_dns_config_(false),
@@ -2102,6 +2118,30 @@ int HostResolverImpl::ResolveFromCache(const RequestInfo& info,
   return rv;
 }
 
+void HostResolverImpl::Preresolve(const std::vector<RequestInfo>& infos,
+                                  const BoundNetLog& source_net_log) {
+  DCHECK(CalledOnValidThread());
+  // Without a cache, the results would be lost.
+  if (!cache_)
+    return;
+
+  for (const RequestInfo& info : infos) {
+    std::string labeled_hostname;
+    IPAddress ip_address;
+    if (!DNSDomainFromDot(info.hostname(), &labeled_hostname) ||
+        ip_address.AssignFromIPLiteral(info.hostname())) {
+      continue;
+    }
+
+    Key key = GetEffectiveKeyForRequest(info, nullptr, source_net_log);
+    AddressList addresses;
+    if (ResolveHelper(key, info, nullptr, &addresses, false, nullptr,
+                      source_net_log) == ERR_DNS_CACHE_MISS) {
+      StartBackgroundJob(key, source_net_log);
+    }
+  }
+}
+
 void HostResolverImpl::ChangeRequestPriority(RequestHandle req_handle,
                                              RequestPriority priority) {
   DCHECK(CalledOnValidThread());
@@ -2228,6 +2268,49 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   return true;
 }
 
+bool HostResolverImpl::ServeStaleWhileRevalidating(const Key& key,
+                                                   const RequestInfo& info,
+                                                   AddressList* addresses) {
+  DCHECK(addresses);
+  if (max_stale_while_revalidate_.is_zero() || !info.allow_cached_response() ||
+      !cache_.get()) {
+    return false;
+  }
+
+  HostCache::EntryStaleness staleness;
+  const HostCache::Entry* cache_entry =
+      cache_->LookupStale(key, base::TimeTicks::Now(), &staleness);
+  if (!cache_entry || cache_entry->error() != OK ||
+      staleness.network_changes > 0 ||
+      staleness.expired_by > max_stale_while_revalidate_) {
+    return false;
+  }
+
+  *addresses = EnsurePortOnAddressList(cache_entry->addresses(), info.port());
+  return true;
+}
+
+void HostResolverImpl::StartBackgroundJob(const Key& key,
+                                          const BoundNetLog& source_net_log) {
+  if (jobs_.find(key) != jobs_.end())
+    return;
+
+  Job* job = new Job(weak_ptr_factory_.GetWeakPtr(), key, IDLE,
+                     worker_task_runner_, source_net_log);
+  job->set_is_background();
+  job->Schedule(false);
+
+  // Check for queue overflow. Being IDLE, background Jobs are the first to go.
+  if (dispatcher_->num_queued_jobs() > max_queued_jobs_) {
+    Job* evicted = static_cast<Job*>(dispatcher_->EvictOldestLowest());
+    DCHECK(evicted);
+    evicted->OnEvicted();  // Deletes |evicted|.
+    if (evicted == job)
+      return;
+  }
+  jobs_.insert(std::make_pair(key, job));
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
@@ -144,6 +145,8 @@ class NET_EXPORT HostResolverImpl
   int ResolveFromCache(const RequestInfo& info,
                        AddressList* addresses,
                        const BoundNetLog& source_net_log) override;
+  void Preresolve(const std::vector<RequestInfo>& infos,
+                  const BoundNetLog& source_net_log) override;
   void SetDnsClientEnabled(bool enabled) override;
   HostCache* GetHostCache() override;
   std::unique_ptr<base::Value> GetDnsConfigAsValue() const override;
@@ -229,6 +232,17 @@ class NET_EXPORT HostResolverImpl
                       bool allow_stale,
                       HostCache::EntryStaleness* stale_info);
 
+  // If |key| has a successful cache entry that expired less than
+  // |max_stale_while_revalidate_| ago, on the current network, returns true
+  // and fills |addresses|. Otherwise returns false.
+  bool ServeStaleWhileRevalidating(const Key& key,
+                                   const RequestInfo& info,
+                                   AddressList* addresses);
+
+  // Starts a Job without any Request to resolve |key| into the cache, unless
+  // one is already running.
+  void StartBackgroundJob(const Key& key, const BoundNetLog& source_net_log);
+
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
   bool ServeFromHosts(const Key& key,
@@ -316,6 +330,9 @@ class NET_EXPORT HostResolverImpl
   // Limit on the maximum number of jobs queued in |dispatcher_|.
   size_t max_queued_jobs_;
 
+  // How long past their TTL cache entries are returned while refreshed.
+  base::TimeDelta max_stale_while_revalidate_;
+
   // Parameters for ProcTask.
   ProcTaskParams proc_params_;
 
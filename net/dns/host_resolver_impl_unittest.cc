@@ -24,6 +24,7 @@
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/test/test_timeouts.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
 #include "net/base/address_list.h"
@@ -619,6 +620,37 @@ class HostResolverImplTest : public testing::Test {
     resolver_->GetHostCache()->OnNetworkChange();
   }
 
+  HostCache::Key GetCacheKey(const HostResolver::RequestInfo& info) {
+    return resolver_->GetEffectiveKeyForRequest(info, nullptr, BoundNetLog());
+  }
+
+  // Replaces the cache entry of |info| with one that expired |expired_by| ago.
+  void MakeCacheEntryExpired(const HostResolver::RequestInfo& info,
+                             base::TimeDelta expired_by) {
+    HostCache* cache = resolver_->GetHostCache();
+    HostCache::Key key = GetCacheKey(info);
+    const HostCache::Entry* entry = cache->Lookup(key, base::TimeTicks::Now());
+    ASSERT_TRUE(entry);
+    const base::TimeDelta ttl = base::TimeDelta::FromSeconds(1);
+    cache->Set(key, HostCache::Entry(entry->error(), entry->addresses()),
+               base::TimeTicks::Now() - expired_by - ttl, ttl);
+  }
+
+  // Runs the message loop until |info| has a fresh cache entry. Returns false
+  // when timed out.
+  bool WaitForCacheEntry(const HostResolver::RequestInfo& info) {
+    HostCache::Key key = GetCacheKey(info);
+    base::TimeTicks deadline =
+        base::TimeTicks::Now() + TestTimeouts::action_timeout();
+    while (!resolver_->GetHostCache()->Lookup(key, base::TimeTicks::Now())) {
+      if (base::TimeTicks::Now() > deadline)
+        return false;
+      base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(1));
+      base::RunLoop().RunUntilIdle();
+    }
+    return true;
+  }
+
   scoped_refptr<MockHostResolverProc> proc_;
   std::unique_ptr<HostResolverImpl> resolver_;
   std::vector<std::unique_ptr<Request>> requests_;
@@ -1425,6 +1457,106 @@ TEST_F(HostResolverImplTest, ResolveStaleFromCache) {
   EXPECT_TRUE(requests_[5]->staleness().is_stale());
 }
 
+TEST_F(HostResolverImplTest, StaleWhileRevalidate) {
+  HostResolver::Options options = DefaultOptions();
+  options.max_stale_while_revalidate = base::TimeDelta::FromMinutes(1);
+  resolver_.reset(new TestHostResolverImpl(options, NULL));
+  resolver_->set_proc_params_for_test(DefaultParams(proc_.get()));
+
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 80));
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, requests_[0]->WaitForResult());
+
+  // An expired entry within the bound is returned, and refreshed once in the
+  // background.
+  MakeCacheEntryExpired(info, base::TimeDelta::FromSeconds(30));
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.43");
+  EXPECT_EQ(OK, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  EXPECT_TRUE(requests_[1]->HasOneAddress("192.168.1.42", 80));
+  EXPECT_EQ(OK, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  EXPECT_TRUE(requests_[2]->HasOneAddress("192.168.1.42", 80));
+  ASSERT_TRUE(proc_->WaitFor(1u));
+  proc_->SignalMultiple(1u);
+  ASSERT_TRUE(WaitForCacheEntry(info));
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+
+  EXPECT_EQ(OK, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  EXPECT_TRUE(requests_[3]->HasOneAddress("192.168.1.43", 80));
+
+  // Past the bound, the request waits for a new lookup.
+  MakeCacheEntryExpired(info, base::TimeDelta::FromMinutes(2));
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, requests_[4]->WaitForResult());
+
+  // So does one for an entry cached before a network change.
+  MakeCacheStale();
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, requests_[5]->WaitForResult());
+}
+
+TEST_F(HostResolverImplTest, StaleWhileRevalidateDisabledByDefault) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 80));
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, requests_[0]->WaitForResult());
+
+  MakeCacheEntryExpired(info, base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, requests_[1]->WaitForResult());
+}
+
+TEST_F(HostResolverImplTest, Preresolve) {
+  proc_->AddRuleForAllFamilies("a", "192.168.1.1");
+  proc_->AddRuleForAllFamilies("b", "192.168.1.2");
+  proc_->AddRuleForAllFamilies("c", "192.168.1.3");
+
+  std::vector<HostResolver::RequestInfo> infos;
+  infos.push_back(HostResolver::RequestInfo(HostPortPair("a", 80)));
+  infos.push_back(HostResolver::RequestInfo(HostPortPair("b", 80)));
+  infos.push_back(HostResolver::RequestInfo(HostPortPair("1.2.3.4", 80)));
+  resolver_->Preresolve(infos, BoundNetLog());
+
+  // Both hosts are looked up in parallel, and a request joins the lookup in
+  // flight.
+  ASSERT_TRUE(proc_->WaitFor(2u));
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("a", 81)->Resolve());
+  proc_->SignalMultiple(2u);
+  EXPECT_EQ(OK, requests_[0]->WaitForResult());
+  EXPECT_TRUE(requests_[0]->HasOneAddress("192.168.1.1", 81));
+
+  // The result of a lookup without any request is cached.
+  ASSERT_TRUE(WaitForCacheEntry(infos[1]));
+  EXPECT_EQ(OK, CreateRequest("b", 82)->Resolve());
+  EXPECT_TRUE(requests_[1]->HasOneAddress("192.168.1.2", 82));
+
+  // Cached hosts are skipped.
+  infos[2] = HostResolver::RequestInfo(HostPortPair("c", 80));
+  resolver_->Preresolve(infos, BoundNetLog());
+  ASSERT_TRUE(proc_->WaitFor(1u));
+  proc_->SignalMultiple(1u);
+  ASSERT_TRUE(WaitForCacheEntry(infos[2]));
+  EXPECT_EQ(3u, proc_->GetCaptureList().size());
+}
+
+// A Request attached to a background Job can be cancelled without stopping it.
+TEST_F(HostResolverImplTest, CancelRequestOfPreresolve) {
+  proc_->AddRuleForAllFamilies("a", "192.168.1.1");
+  HostResolver::RequestInfo info(HostPortPair("a", 80));
+  resolver_->Preresolve(std::vector<HostResolver::RequestInfo>(1, info),
+                        BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info, DEFAULT_PRIORITY)->Resolve());
+  requests_[0]->Cancel();
+  proc_->SignalMultiple(1u);
+  ASSERT_TRUE(WaitForCacheEntry(info));
+  EXPECT_FALSE(requests_[0]->completed());
+}
+
 // Test the retry attempts simulating host resolver proc that takes too long.
 TEST_F(HostResolverImplTest, MultipleAttempts) {
   // Total number of attempts would be 3 and we want the 3rd attempt to resolve
@@ -4,9 +4,9 @@
 
 #include "net/extras/sqlite/sqlite_persistent_cookie_store.h"
 
-#include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
@@ -61,11 +61,12 @@ namespace net {
 //
 // SQLitePersistentCookieStore::Load is called to load all cookies.  It
 // delegates to Backend::Load, which posts a Backend::LoadAndNotifyOnDBThread
-// task to the background runner.  This task calls Backend::ChainLoadCookies(),
-// which repeatedly posts itself to the BG runner to load each eTLD+1's cookies
-// in separate tasks.  When this is complete, Backend::CompleteLoadOnIOThread is
-// posted to the client runner, which notifies the caller of
-// SQLitePersistentCookieStore::Load that the load is complete.
+// task to the background runner.  This task lists the domain keys (eTLD+1) not
+// loaded yet, and calls Backend::ChainLoadCookies(), which repeatedly posts
+// itself to the BG runner to load each eTLD+1's cookies in separate tasks.
+// When this is complete, Backend::CompleteLoadOnIOThread is posted to the
+// client runner, which notifies the caller of SQLitePersistentCookieStore::Load
+// that the load is complete.
 //
 // If a priority load request is invoked via SQLitePersistentCookieStore::
 // LoadCookiesForKey, it is delegated to Backend::LoadCookiesForKey, which posts
@@ -73,6 +74,10 @@ namespace net {
 // that single domain key (eTLD+1)'s cookies, and posts a Backend::
 // CompleteLoadForKeyOnIOThread to the client runner to notify the caller of
 // SQLitePersistentCookieStore::LoadCookiesForKey that that load is complete.
+// Each row stores its domain key, which is indexed, so that loading a key is a
+// single index lookup, and the keys are only listed when all cookies are
+// loaded. A client that never loads all cookies never reads the cookies of
+// domains it doesn't request.
 //
 // Subsequent to loading, mutations may be queued by any thread using
 // AddCookie, UpdateCookieAccessTime, and DeleteCookie. These are flushed to
@@ -213,8 +218,13 @@ class SQLitePersistentCookieStore::Backend
   // all domains are loaded).
   void ChainLoadCookies(const LoadedCallback& loaded_callback);
 
-  // Load all cookies for a set of domains/hosts
-  bool LoadCookiesForDomains(const std::set<std::string>& key);
+  // Fills |keys_to_load_| with the domain keys of the DB that haven't been
+  // loaded yet.
+  bool ListKeysToLoad();
+
+  // Loads all cookies of the domain key (eTLD+1) |key|, unless it has already
+  // been loaded.
+  bool LoadCookiesForDomainKey(const std::string& key);
 
   // Batch a cookie operation (add or delete)
   void BatchOperation(PendingOperation::OperationType op,
@@ -258,8 +268,10 @@ class SQLitePersistentCookieStore::Backend
   // response to individual load requests or when all loading completes.
   std::vector<CanonicalCookie*> cookies_;
 
-  // Map of domain keys(eTLD+1) to domains/hosts that are to be loaded from DB.
-  std::map<std::string, std::set<std::string>> keys_to_load_;
+  // Domain keys (eTLD+1) that are to be loaded from DB by ChainLoadCookies(),
+  // and those that have been loaded already.
+  std::set<std::string> keys_to_load_;
+  std::set<std::string> keys_loaded_;
 
   // Indicates if DB has been initialized.
   bool initialized_;
@@ -305,6 +317,12 @@ namespace {
 
 // Version number of the database.
 //
+// Version 10 adds the domain_key column, holding the domain key (eTLD+1) of
+// host_key, and an index on it, so that the cookies of a domain key can be
+// loaded with a single query, without first listing every host of the DB.
+// Rows written by older code have a NULL domain_key, which is filled in when
+// the DB is opened. Old clients ignore the column.
+//
 // Version 9 adds a partial index to track non-persistent cookies.
 // Non-persistent cookies sometimes need to be deleted on startup. There are
 // frequently few or no non-persistent cookies, so the partial index allows the
@@ -335,7 +353,7 @@ namespace {
 // Version 3 updated the database to include the last access time, so we can
 // expire them in decreasing order of use when we've reached the maximum
 // number of cookies.
-const int kCurrentVersionNumber = 9;
+const int kCurrentVersionNumber = 10;
 const int kCompatibleVersionNumber = 5;
 
 // Possible values for the 'priority' column.
@@ -449,7 +467,8 @@ bool InitTable(sql::Connection* db) {
       "persistent INTEGER NOT NULL DEFAULT 1,"
       "priority INTEGER NOT NULL DEFAULT %d,"
       "encrypted_value BLOB DEFAULT '',"
-      "firstpartyonly INTEGER NOT NULL DEFAULT %d)",
+      "firstpartyonly INTEGER NOT NULL DEFAULT %d,"
+      "domain_key TEXT)",
       CookiePriorityToDBCookiePriority(COOKIE_PRIORITY_DEFAULT),
       CookieSameSiteToDBCookieSameSite(CookieSameSite::DEFAULT_MODE)));
   if (!db->Execute(stmt.c_str()))
@@ -458,6 +477,9 @@ bool InitTable(sql::Connection* db) {
   if (!db->Execute("CREATE INDEX domain ON cookies(host_key)"))
     return false;
 
+  if (!db->Execute("CREATE INDEX domain_key ON cookies(domain_key)"))
+    return false;
+
 #if defined(OS_IOS)
   // iOS 8.1 and older doesn't support partial indices. iOS 8.2 supports
   // partial indices.
@@ -473,6 +495,43 @@ bool InitTable(sql::Connection* db) {
   return true;
 }
 
+// Returns the domain key (eTLD+1) the cookies of |host_key| are loaded with.
+std::string GetDomainKey(const std::string& host_key) {
+  return registry_controlled_domains::GetDomainAndRegistry(
+      host_key, registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
+// Sets the domain_key of the rows written by code older than version 10,
+// returning true on success.
+bool SetMissingDomainKeys(sql::Connection* db) {
+  sql::Statement select_smt(db->GetUniqueStatement(
+      "SELECT DISTINCT host_key FROM cookies WHERE domain_key IS NULL"));
+  if (!select_smt.is_valid())
+    return false;
+
+  std::vector<std::string> host_keys;
+  while (select_smt.Step())
+    host_keys.push_back(select_smt.ColumnString(0));
+  if (host_keys.empty())
+    return true;
+
+  sql::Transaction transaction(db);
+  if (!transaction.Begin())
+    return false;
+  sql::Statement update_smt(db->GetUniqueStatement(
+      "UPDATE cookies SET domain_key = ? WHERE host_key = ?"));
+  if (!update_smt.is_valid())
+    return false;
+  for (const std::string& host_key : host_keys) {
+    update_smt.Reset(true);
+    update_smt.BindString(0, GetDomainKey(host_key));
+    update_smt.BindString(1, host_key);
+    if (!update_smt.Run())
+      return false;
+  }
+  return transaction.Commit();
+}
+
 }  // namespace
 
 void SQLitePersistentCookieStore::Backend::Load(
@@ -509,7 +568,7 @@ void SQLitePersistentCookieStore::Backend::LoadAndNotifyInBackground(
                              base::TimeDelta::FromMilliseconds(1),
                              base::TimeDelta::FromMinutes(1), 50);
 
-  if (!InitializeDatabase()) {
+  if (!InitializeDatabase() || !ListKeysToLoad()) {
     PostClientTask(FROM_HERE, base::Bind(&Backend::CompleteLoadInForeground,
                                          this, loaded_callback, false));
   } else {
@@ -529,17 +588,7 @@ void SQLitePersistentCookieStore::Backend::LoadKeyAndNotifyInBackground(
                              base::TimeDelta::FromMilliseconds(1),
                              base::TimeDelta::FromMinutes(1), 50);
 
-  bool success = false;
-  if (InitializeDatabase()) {
-    std::map<std::string, std::set<std::string>>::iterator it =
-        keys_to_load_.find(key);
-    if (it != keys_to_load_.end()) {
-      success = LoadCookiesForDomains(it->second);
-      keys_to_load_.erase(it);
-    } else {
-      success = true;
-    }
-  }
+  bool success = InitializeDatabase() && LoadCookiesForDomainKey(key);
 
   PostClientTask(
       FROM_HERE,
@@ -680,13 +729,7 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
                              base::TimeDelta::FromMilliseconds(1),
                              base::TimeDelta::FromMinutes(1), 50);
 
-  start = base::Time::Now();
-
-  // Retrieve all the domains
-  sql::Statement smt(
-      db_->GetUniqueStatement("SELECT DISTINCT host_key FROM cookies"));
-
-  if (!smt.is_valid()) {
+  if (!SetMissingDomainKeys(db_.get())) {
     if (corruption_detected_)
       db_->Raze();
     meta_table_.Reset();
@@ -694,36 +737,6 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
     return false;
   }
 
-  std::vector<std::string> host_keys;
-  while (smt.Step())
-    host_keys.push_back(smt.ColumnString(0));
-
-  UMA_HISTOGRAM_CUSTOM_TIMES("Cookie.TimeLoadDomains",
-                             base::Time::Now() - start,
-                             base::TimeDelta::FromMilliseconds(1),
-                             base::TimeDelta::FromMinutes(1), 50);
-
-  base::Time start_parse = base::Time::Now();
-
-  // Build a map of domain keys (always eTLD+1) to domains.
-  for (size_t idx = 0; idx < host_keys.size(); ++idx) {
-    const std::string& domain = host_keys[idx];
-    std::string key = registry_controlled_domains::GetDomainAndRegistry(
-        domain, registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
-
-    keys_to_load_[key].insert(domain);
-  }
-
-  UMA_HISTOGRAM_CUSTOM_TIMES("Cookie.TimeParseDomains",
-                             base::Time::Now() - start_parse,
-                             base::TimeDelta::FromMilliseconds(1),
-                             base::TimeDelta::FromMinutes(1), 50);
-
-  UMA_HISTOGRAM_CUSTOM_TIMES("Cookie.TimeInitializeDomainMap",
-                             base::Time::Now() - start,
-                             base::TimeDelta::FromMilliseconds(1),
-                             base::TimeDelta::FromMinutes(1), 50);
-
   initialized_ = true;
 
   if (!restore_old_session_cookies_)
@@ -742,11 +755,10 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
     // Close() has been called on this store.
     load_success = false;
   } else if (keys_to_load_.size() > 0) {
-    // Load cookies for the first domain key.
-    std::map<std::string, std::set<std::string>>::iterator it =
-        keys_to_load_.begin();
-    load_success = LoadCookiesForDomains(it->second);
-    keys_to_load_.erase(it);
+    // Load cookies for the first domain key. The key is copied, as loading it
+    // removes it from |keys_to_load_|.
+    const std::string key = *keys_to_load_.begin();
+    load_success = LoadCookiesForDomainKey(key);
   }
 
   // If load is successful and there are more domain keys to be loaded,
@@ -766,23 +778,56 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
   }
 }
 
-bool SQLitePersistentCookieStore::Backend::LoadCookiesForDomains(
-    const std::set<std::string>& domains) {
+bool SQLitePersistentCookieStore::Backend::ListKeysToLoad() {
+  DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
+
+  base::Time start = base::Time::Now();
+
+  sql::Statement smt(
+      db_->GetUniqueStatement("SELECT DISTINCT domain_key FROM cookies"));
+  if (!smt.is_valid()) {
+    if (corruption_detected_)
+      db_->Raze();
+    meta_table_.Reset();
+    db_.reset();
+    return false;
+  }
+
+  keys_to_load_.clear();
+  while (smt.Step()) {
+    std::string key = smt.ColumnString(0);
+    if (keys_loaded_.find(key) == keys_loaded_.end())
+      keys_to_load_.insert(key);
+  }
+
+  UMA_HISTOGRAM_CUSTOM_TIMES("Cookie.TimeInitializeDomainMap",
+                             base::Time::Now() - start,
+                             base::TimeDelta::FromMilliseconds(1),
+                             base::TimeDelta::FromMinutes(1), 50);
+  return true;
+}
+
+bool SQLitePersistentCookieStore::Backend::LoadCookiesForDomainKey(
+    const std::string& key) {
   DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
 
+  if (!keys_loaded_.insert(key).second)
+    return true;
+  keys_to_load_.erase(key);
+
   sql::Statement smt;
   if (restore_old_session_cookies_) {
     smt.Assign(db_->GetCachedStatement(
         SQL_FROM_HERE,
         "SELECT creation_utc, host_key, name, value, encrypted_value, path, "
         "expires_utc, secure, httponly, firstpartyonly, last_access_utc, "
-        "has_expires, persistent, priority FROM cookies WHERE host_key = ?"));
+        "has_expires, persistent, priority FROM cookies WHERE domain_key = ?"));
   } else {
     smt.Assign(db_->GetCachedStatement(
         SQL_FROM_HERE,
         "SELECT creation_utc, host_key, name, value, encrypted_value, path, "
         "expires_utc, secure, httponly, firstpartyonly, last_access_utc, "
-        "has_expires, persistent, priority FROM cookies WHERE host_key = ? "
+        "has_expires, persistent, priority FROM cookies WHERE domain_key = ? "
         "AND persistent = 1"));
   }
   if (!smt.is_valid()) {
@@ -793,12 +838,8 @@ bool SQLitePersistentCookieStore::Backend::LoadCookiesForDomains(
   }
 
   std::vector<CanonicalCookie*> cookies;
-  std::set<std::string>::const_iterator it = domains.begin();
-  for (; it != domains.end(); ++it) {
-    smt.BindString(0, *it);
-    MakeCookiesFromSQLStatement(&cookies, &smt);
-    smt.Reset(true);
-  }
+  smt.BindString(0, key);
+  MakeCookiesFromSQLStatement(&cookies, &smt);
   {
     base::AutoLock locked(lock_);
     cookies_.insert(cookies_.end(), cookies.begin(), cookies.end());
@@ -1035,6 +1076,32 @@ bool SQLitePersistentCookieStore::Backend::EnsureDatabaseVersion() {
                         base::TimeTicks::Now() - start_time);
   }
 
+  if (cur_version == 9) {
+    const base::TimeTicks start_time = base::TimeTicks::Now();
+    sql::Transaction transaction(db_.get());
+    if (!transaction.Begin())
+      return false;
+
+    // The new column is filled in by InitializeDatabase().
+    if (!db_->Execute("ALTER TABLE cookies ADD COLUMN domain_key TEXT")) {
+      LOG(WARNING) << "Unable to update cookie database to version 10.";
+      return false;
+    }
+    if (!db_->Execute(
+            "CREATE INDEX IF NOT EXISTS domain_key ON cookies(domain_key)")) {
+      LOG(WARNING)
+          << "Unable to create index domain_key in update to version 10.";
+      return false;
+    }
+    ++cur_version;
+    meta_table_.SetVersionNumber(cur_version);
+    meta_table_.SetCompatibleVersionNumber(
+        std::min(cur_version, kCompatibleVersionNumber));
+    transaction.Commit();
+    UMA_HISTOGRAM_TIMES("Cookie.TimeDatabaseMigrationToV10",
+                        base::TimeTicks::Now() - start_time);
+  }
+
   // Put future migration cases here.
 
   if (cur_version < kCurrentVersionNumber) {
@@ -1121,8 +1188,8 @@ void SQLitePersistentCookieStore::Backend::Commit() {
       SQL_FROM_HERE,
       "INSERT INTO cookies (creation_utc, host_key, name, value, "
       "encrypted_value, path, expires_utc, secure, httponly, firstpartyonly, "
-      "last_access_utc, has_expires, persistent, priority) "
-      "VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?)"));
+      "last_access_utc, has_expires, persistent, priority, domain_key) "
+      "VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)"));
   if (!add_smt.is_valid())
     return;
 
@@ -1174,6 +1241,7 @@ void SQLitePersistentCookieStore::Backend::Commit() {
         add_smt.BindInt(12, po->cc().IsPersistent());
         add_smt.BindInt(13,
                         CookiePriorityToDBCookiePriority(po->cc().Priority()));
+        add_smt.BindString(14, GetDomainKey(po->cc().Domain()));
         if (!add_smt.Run())
           NOTREACHED() << "Could not add a cookie to the DB.";
         break;
@@ -6,6 +6,7 @@
 
 #include <map>
 #include <set>
+#include <utility>
 
 #include "base/bind.h"
 #include "base/callback.h"
@@ -111,6 +112,15 @@ class SQLitePersistentCookieStoreTest : public testing::Test {
     *cookies = cookies_;
   }
 
+  void LoadCookiesForKey(const std::string& key,
+                         CanonicalCookieVector* cookies) {
+    store_->LoadCookiesForKey(
+        key, base::Bind(&SQLitePersistentCookieStoreTest::OnKeyLoaded,
+                        base::Unretained(this)));
+    key_loaded_event_.Wait();
+    *cookies = cookies_;
+  }
+
   void Flush() {
     base::WaitableEvent event(base::WaitableEvent::ResetPolicy::AUTOMATIC,
                               base::WaitableEvent::InitialState::NOT_SIGNALED);
@@ -427,6 +437,39 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   STLDeleteElements(&cookies_);
 }
 
+// Test that the cookies of a domain key can be loaded without loading the
+// others, and aren't loaded again when all cookies are.
+TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKeyOnly) {
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  AddCookie(GURL("http://www.aaa.com"), "A", "B", std::string(), "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie(GURL("http://travel.aaa.com"), "A", "B", ".aaa.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie(GURL("http://www.bbb.com"), "A", "B", std::string(), "/", t);
+  DestroyStore();
+
+  Create(false, false);
+  CanonicalCookieVector cookies;
+  LoadCookiesForKey("aaa.com", &cookies);
+  ASSERT_EQ(2U, cookies.size());
+  std::set<std::string> domains;
+  for (const CanonicalCookie* cookie : cookies)
+    domains.insert(cookie->Domain());
+  EXPECT_EQ(1U, domains.count("www.aaa.com"));
+  EXPECT_EQ(1U, domains.count(".aaa.com"));
+  STLDeleteElements(&cookies);
+
+  // A key without cookies loads nothing.
+  LoadCookiesForKey("ccc.com", &cookies);
+  EXPECT_EQ(0U, cookies.size());
+
+  Load(&cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("www.bbb.com", cookies[0]->Domain());
+  STLDeleteElements(&cookies);
+}
+
 // Test that we can force the database to be written by calling Flush().
 TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   InitializeStore(false, false);
@@ -807,6 +850,82 @@ void WasCalledWithNoCookies(bool* was_called_with_no_cookies,
 }
 }
 
+// Test that the cookies of a version 9 database, which lacks the domain_key
+// column, can be loaded by key once the database is migrated.
+TEST_F(SQLitePersistentCookieStoreTest, UpgradeToDomainKey) {
+  {
+    sql::Connection db;
+    ASSERT_TRUE(db.Open(temp_dir_.path().Append(kCookieFilename)));
+    sql::MetaTable meta_table;
+    ASSERT_TRUE(meta_table.Init(&db, 9, 5));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE cookies ("
+        "creation_utc INTEGER NOT NULL UNIQUE PRIMARY KEY,"
+        "host_key TEXT NOT NULL,"
+        "name TEXT NOT NULL,"
+        "value TEXT NOT NULL,"
+        "path TEXT NOT NULL,"
+        "expires_utc INTEGER NOT NULL,"
+        "secure INTEGER NOT NULL,"
+        "httponly INTEGER NOT NULL,"
+        "last_access_utc INTEGER NOT NULL, "
+        "has_expires INTEGER NOT NULL DEFAULT 1, "
+        "persistent INTEGER NOT NULL DEFAULT 1,"
+        "priority INTEGER NOT NULL DEFAULT 1,"
+        "encrypted_value BLOB DEFAULT '',"
+        "firstpartyonly INTEGER NOT NULL DEFAULT 0)"));
+    ASSERT_TRUE(db.Execute("CREATE INDEX domain ON cookies(host_key)"));
+
+    sql::Statement smt(db.GetUniqueStatement(
+        "INSERT INTO cookies (creation_utc, host_key, name, value, path, "
+        "expires_utc, secure, httponly, last_access_utc) "
+        "VALUES (?, ?, 'A', 'B', '/', ?, 0, 0, ?)"));
+    const char* const kHosts[] = {"www.aaa.com", ".aaa.com", "www.bbb.com"};
+    base::Time t = base::Time::Now();
+    for (const char* host : kHosts) {
+      t += base::TimeDelta::FromInternalValue(10);
+      smt.Reset(true);
+      smt.BindInt64(0, t.ToInternalValue());
+      smt.BindString(1, host);
+      smt.BindInt64(2, (t + base::TimeDelta::FromDays(1)).ToInternalValue());
+      smt.BindInt64(3, t.ToInternalValue());
+      ASSERT_TRUE(smt.Run());
+    }
+  }
+
+  Create(false, false);
+  CanonicalCookieVector cookies;
+  LoadCookiesForKey("aaa.com", &cookies);
+  EXPECT_EQ(2U, cookies.size());
+  STLDeleteElements(&cookies);
+  Load(&cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("www.bbb.com", cookies[0]->Domain());
+  STLDeleteElements(&cookies);
+
+  // Cookies added after the upgrade get their domain key too.
+  AddCookie(GURL("http://www.ccc.com"), "A", "B", std::string(), "/",
+            base::Time::Now() + base::TimeDelta::FromMinutes(1));
+  DestroyStore();
+
+  sql::Connection db;
+  ASSERT_TRUE(db.Open(temp_dir_.path().Append(kCookieFilename)));
+  sql::MetaTable meta_table;
+  ASSERT_TRUE(meta_table.Init(&db, 1, 1));
+  EXPECT_EQ(10, meta_table.GetVersionNumber());
+  sql::Statement smt(db.GetUniqueStatement(
+      "SELECT host_key, domain_key FROM cookies ORDER BY creation_utc"));
+  std::vector<std::pair<std::string, std::string>> rows;
+  while (smt.Step())
+    rows.push_back(std::make_pair(smt.ColumnString(0), smt.ColumnString(1)));
+  ASSERT_EQ(4U, rows.size());
+  EXPECT_EQ("aaa.com", rows[0].second);
+  EXPECT_EQ("aaa.com", rows[1].second);
+  EXPECT_EQ("bbb.com", rows[2].second);
+  EXPECT_EQ("www.ccc.com", rows[3].first);
+  EXPECT_EQ("ccc.com", rows[3].second);
+}
+
 TEST_F(SQLitePersistentCookieStoreTest, EmptyLoadAfterClose) {
   // Create unencrypted cookie store and write something to it.
   InitializeStore(false, false);
@@ -27,6 +27,7 @@
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "net/base/io_buffer.h"
+#include "net/base/io_buffer_pool.h"
 #include "net/base/sdch_net_log_params.h"
 #include "net/filter/brotli_filter.h"
 #include "net/filter/gzip_filter.h"
@@ -370,6 +371,10 @@ Filter::FilterStatus Filter::CopyOut(char* dest_buffer, int* dest_len) {
   }
 }
 
+bool Filter::IsPassThrough() const {
+  return false;
+}
+
 // static
 std::unique_ptr<Filter> Filter::InitBrotliFilter(FilterType type_id,
                                                  int buffer_size) {
@@ -436,11 +441,15 @@ std::unique_ptr<Filter> Filter::PrependNewFilter(
 void Filter::InitBuffer(int buffer_size) {
   DCHECK(!stream_buffer());
   DCHECK_GT(buffer_size, 0);
-  stream_buffer_ = new IOBuffer(buffer_size);
+  stream_buffer_ = IOBufferPool::GetInstance()->GetBuffer(buffer_size);
   stream_buffer_size_ = buffer_size;
 }
 
 void Filter::PushDataIntoNextFilter() {
+  if (IsPassThrough() && stream_data_len_ && !next_filter_->stream_data_len()) {
+    HandOffStreamBufferToNextFilter();
+    return;
+  }
   IOBuffer* next_buffer = next_filter_->stream_buffer();
   int next_size = next_filter_->stream_buffer_size();
   last_status_ = ReadFilteredData(next_buffer->data(), &next_size);
@@ -448,4 +457,21 @@ void Filter::PushDataIntoNextFilter() {
     next_filter_->FlushStreamBuffer(next_size);
 }
 
+void Filter::HandOffStreamBufferToNextFilter() {
+  DCHECK(IsPassThrough());
+  DCHECK_EQ(0, next_filter_->stream_data_len());
+  DCHECK_EQ(stream_buffer_size_, next_filter_->stream_buffer_size());
+
+  // The data stays where it is, so the next filter starts reading at the same
+  // offset into the buffer. This filter gets the next filter's empty buffer to
+  // receive more input.
+  stream_buffer_.swap(next_filter_->stream_buffer_);
+  next_filter_->next_stream_data_ = next_stream_data_;
+  next_filter_->stream_data_len_ = stream_data_len_;
+  next_filter_->last_status_ = FILTER_OK;
+  next_stream_data_ = nullptr;
+  stream_data_len_ = 0;
+  last_status_ = FILTER_NEED_MORE_DATA;
+}
+
 }  // namespace net
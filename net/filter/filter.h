@@ -244,6 +244,7 @@ class NET_EXPORT_PRIVATE Filter {
   friend class GZipUnitTest;
   friend class SdchFilterChainingTest;
   FRIEND_TEST_ALL_PREFIXES(FilterTest, ThreeFilterChain);
+  FRIEND_TEST_ALL_PREFIXES(FilterTest, PassThroughChainHandsOffBuffers);
 
   explicit Filter(FilterType type_id);
 
@@ -263,6 +264,12 @@ class NET_EXPORT_PRIVATE Filter {
   // Copy pre-filter data directly to destination buffer without decoding.
   FilterStatus CopyOut(char* dest_buffer, int* dest_len);
 
+  // Returns true if the filter has stopped decoding and only copies its input
+  // to its output, e.g. a tentative filter that found no encoding. In a chain,
+  // such a filter hands its stream_buffer_ to the next filter instead of
+  // copying the data into the next filter's stream_buffer_.
+  virtual bool IsPassThrough() const;
+
   FilterStatus last_status() const { return last_status_; }
 
   // Buffer to hold the data to be filtered (the input queue).
@@ -306,6 +313,11 @@ class NET_EXPORT_PRIVATE Filter {
   // Helper function to empty our output into the next filter's input.
   void PushDataIntoNextFilter();
 
+  // Swaps stream buffers with the next filter, which takes over the remaining
+  // pre-filter data. Only valid when this filter is a pass-through filter and
+  // the next filter's stream buffer is empty.
+  void HandOffStreamBufferToNextFilter();
+
   // Constructs a filter with an internal buffer of the given size.
   // Only meant to be called by unit tests that need to control the buffer size.
   static std::unique_ptr<Filter> FactoryForTests(
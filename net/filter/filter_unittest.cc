@@ -26,6 +26,17 @@ class PassThroughFilter : public Filter {
   DISALLOW_COPY_AND_ASSIGN(PassThroughFilter);
 };
 
+// A PassThroughFilter that reports it is passing data through, so that it
+// hands its stream buffer to the next filter in a chain.
+class HandOffFilter : public PassThroughFilter {
+ public:
+  HandOffFilter() {}
+
+  bool IsPassThrough() const override { return true; }
+
+  DISALLOW_COPY_AND_ASSIGN(HandOffFilter);
+};
+
 }  // namespace
 
 TEST(FilterTest, ContentTypeId) {
@@ -210,4 +221,51 @@ TEST(FilterTest, ThreeFilterChain) {
   EXPECT_EQ(compare_array_index, input_array_size);
 }
 
+// Pass-through filters at the head of a chain hand their input buffer to the
+// next filter instead of copying it, and get an empty buffer back.
+TEST(FilterTest, PassThroughChainHandsOffBuffers) {
+  std::unique_ptr<HandOffFilter> filter1(new HandOffFilter);
+  std::unique_ptr<HandOffFilter> filter2(new HandOffFilter);
+  std::unique_ptr<PassThroughFilter> filter3(new PassThroughFilter);
+
+  filter1->InitBuffer(1024);
+  filter2->InitBuffer(1024);
+  filter3->InitBuffer(1024);
+  IOBuffer* buffer1 = filter1->stream_buffer();
+  IOBuffer* buffer2 = filter2->stream_buffer();
+  IOBuffer* buffer3 = filter3->stream_buffer();
+
+  Filter* filter2_ptr = filter2.get();
+  Filter* filter3_ptr = filter3.get();
+  filter2->next_filter_ = std::move(filter3);
+  filter1->next_filter_ = std::move(filter2);
+
+  const std::string kInput("data that is not encoded");
+  memcpy(filter1->stream_buffer()->data(), kInput.data(), kInput.size());
+  filter1->FlushStreamBuffer(kInput.size());
+
+  char output[1024];
+  int output_len = sizeof(output);
+  EXPECT_EQ(Filter::FILTER_NEED_MORE_DATA,
+            filter1->ReadData(output, &output_len));
+  EXPECT_EQ(kInput, std::string(output, output_len));
+
+  // The input travelled down the chain in |buffer1|, which the last filter now
+  // owns, and each filter upstream got an empty buffer in exchange.
+  EXPECT_EQ(buffer1, filter3_ptr->stream_buffer());
+  EXPECT_EQ(buffer3, filter2_ptr->stream_buffer());
+  EXPECT_EQ(buffer2, filter1->stream_buffer());
+  EXPECT_EQ(0, filter1->stream_data_len());
+  EXPECT_EQ(0, filter2_ptr->stream_data_len());
+  EXPECT_EQ(0, filter3_ptr->stream_data_len());
+
+  // Data flushed into the new buffer makes it through as well.
+  memcpy(filter1->stream_buffer()->data(), kInput.data(), kInput.size());
+  filter1->FlushStreamBuffer(kInput.size());
+  output_len = sizeof(output);
+  EXPECT_EQ(Filter::FILTER_NEED_MORE_DATA,
+            filter1->ReadData(output, &output_len));
+  EXPECT_EQ(kInput, std::string(output, output_len));
+}
+
 }  // Namespace net
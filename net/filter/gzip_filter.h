@@ -51,6 +51,9 @@ class GZipFilter : public Filter {
   // but not produce output yet.
   FilterStatus ReadFilteredData(char* dest_buffer, int* dest_len) override;
 
+  // Returns true once a tentative filter has found no gzip header.
+  bool IsPassThrough() const override;
+
  private:
   enum DecodingStatus {
     DECODING_UNINITIALIZED,
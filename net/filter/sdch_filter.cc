@@ -443,6 +443,10 @@ Filter::FilterStatus SdchFilter::ReadFilteredData(char* dest_buffer,
   return FILTER_NEED_MORE_DATA;
 }
 
+bool SdchFilter::IsPassThrough() const {
+  return decoding_status_ == PASS_THROUGH && dest_buffer_excess_.empty();
+}
+
 Filter::FilterStatus SdchFilter::InitializeDictionary() {
   size_t bytes_needed = kServerIdLength - dictionary_hash_.size();
   DCHECK_GT(bytes_needed, 0u);
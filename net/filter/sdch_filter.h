@@ -46,6 +46,10 @@ class NET_EXPORT_PRIVATE SdchFilter : public Filter {
   // written into the destination buffer.
   FilterStatus ReadFilteredData(char* dest_buffer, int* dest_len) override;
 
+  // Returns true once the content was found not to be SDCH encoded and any
+  // scanned dictionary hash has been output.
+  bool IsPassThrough() const override;
+
  private:
   // Internal status. Once we enter an error state, we stop processing data.
   enum DecodingStatus {
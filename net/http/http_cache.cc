@@ -35,6 +35,7 @@
 #include "net/base/net_errors.h"
 #include "net/base/upload_data_stream.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/hot_entry_backend.h"
 #include "net/http/disk_cache_based_quic_server_info.h"
 #include "net/http/http_cache_transaction.h"
 #include "net/http/http_network_layer.h"
@@ -96,7 +97,9 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      readable_while_writing(false),
+      incomplete_body(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -306,6 +309,7 @@ HttpCache::HttpCache(std::unique_ptr<HttpTransactionFactory> network_layer,
       bypass_lock_for_test_(false),
       fail_conditionalization_for_test_(false),
       mode_(NORMAL),
+      hot_entry_cache_size_(0),
       network_layer_(std::move(network_layer)),
       clock_(new base::DefaultClock()),
       weak_factory_(this) {
@@ -338,6 +342,7 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->readers_waiting_for_data.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -796,6 +801,15 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
+  //
+  // Once the writer starts writing the response body, transactions that may
+  // use the response as is can read the body while it is written.
+
+  if (entry->writer && entry->readable_while_writing &&
+      trans->CanReadWhileWriting()) {
+    entry->readers.push_back(trans);
+    return OK;
+  }
 
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
@@ -828,11 +842,15 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
-  if (entry->will_process_pending_queue && entry->readers.empty())
+  if (entry->will_process_pending_queue && !entry->writer &&
+      entry->readers.empty()) {
     return;
+  }
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
+  if (entry->writer == trans) {
+    // The writer stops before the end of the body, even if what it wrote is
+    // kept as a truncated entry.
+    entry->incomplete_body = true;
 
     // Assume there was a failure.
     bool success = false;
@@ -852,9 +870,15 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
+  // Only readers that joined the writer remain. They read to the end of the
+  // body, or to the failure flagged by |incomplete_body|.
+  DCHECK(entry->readers.empty() || entry->readable_while_writing);
 
   entry->writer = NULL;
+  entry->readable_while_writing = false;
+  if (!success)
+    entry->incomplete_body = true;
+  OnWriterDataWritten(entry);
 
   if (success) {
     ProcessPendingQueue(entry);
@@ -865,8 +889,14 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else if (!entry->doomed) {
+      // Kept until the readers are done with it.
+      int rv = DoomEntry(entry->disk_entry->GetKey(), NULL);
+      DCHECK_EQ(OK, rv);
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -879,13 +909,16 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
-
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
   DCHECK(it != entry->readers.end());
 
   entry->readers.erase(it);
+  entry->readers_waiting_for_data.remove(trans);
+
+  // A reader of the body being written leaves the writer to go on.
+  if (entry->writer)
+    return;
 
   ProcessPendingQueue(entry);
 }
@@ -903,6 +936,39 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::AllowReadingWhileWriting(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  entry->readable_while_writing = true;
+  entry->incomplete_body = false;
+  if (entry->pending_queue.empty())
+    return;
+
+  // The pending transactions are notified from a fresh stack, rather than from
+  // within the writer's read.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&HttpCache::OnAllowReadingWhileWriting,
+                            GetWeakPtr(), entry->disk_entry->GetKey()));
+}
+
+void HttpCache::OnWriterDataWritten(ActiveEntry* entry) {
+  TransactionList waiting_readers;
+  waiting_readers.swap(entry->readers_waiting_for_data);
+  for (Transaction* reader : waiting_readers) {
+    // Readers may go away before the task runs: |io_callback| is bound to a
+    // weak pointer, and DoneReadingFromEntry() removes them from |entry|.
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(reader->io_callback(), OK));
+  }
+}
+
+int HttpCache::WaitForWriterData(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->writer);
+  DCHECK(std::find(entry->readers.begin(), entry->readers.end(), trans) !=
+         entry->readers.end());
+  entry->readers_waiting_for_data.push_back(trans);
+  return ERR_IO_PENDING;
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1018,6 +1084,33 @@ void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   }
 }
 
+void HttpCache::OnAllowReadingWhileWriting(const std::string& key) {
+  ActiveEntry* entry = FindActiveEntry(key);
+  if (!entry || !entry->writer || !entry->readable_while_writing)
+    return;
+
+  // Like OnProcessPendingQueue(), this adds one transaction per task, as
+  // notifying it may cancel the others.
+  auto can_read = [](Transaction* trans) {
+    return trans->CanReadWhileWriting();
+  };
+  TransactionList::iterator it = std::find_if(
+      entry->pending_queue.begin(), entry->pending_queue.end(), can_read);
+  if (it == entry->pending_queue.end())
+    return;
+  Transaction* next = *it;
+  entry->pending_queue.erase(it);
+  entry->readers.push_back(next);
+
+  if (std::any_of(entry->pending_queue.begin(), entry->pending_queue.end(),
+                  can_read)) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpCache::OnAllowReadingWhileWriting, GetWeakPtr(), key));
+  }
+  next->io_callback().Run(OK);
+}
+
 void HttpCache::OnIOComplete(int result, PendingOp* pending_op) {
   WorkItemOperation op = pending_op->writer->operation();
 
@@ -1135,6 +1228,10 @@ void HttpCache::OnBackendCreated(int result, PendingOp* pending_op) {
     backend_factory_.reset();  // Reclaim memory.
     if (result == OK) {
       disk_cache_ = std::move(pending_op->backend);
+      if (hot_entry_cache_size_ > 0) {
+        disk_cache_.reset(new disk_cache::HotEntryBackend(
+            std::move(disk_cache_), hot_entry_cache_size_));
+      }
     }
   }
 
@@ -179,6 +179,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // Keeps up to |max_bytes| of small responses that were read recently in
+  // memory, in front of the backend, so that hits on them don't have to wait
+  // for the cache thread. See disk_cache::HotEntryBackend. Takes effect when
+  // the backend is created; zero, the default, keeps none.
+  void set_hot_entry_cache_size(int max_bytes) {
+    hot_entry_cache_size_ = max_bytes;
+  }
+
   // Get/Set the cache's clock. These are public only for testing.
   void SetClockForTesting(std::unique_ptr<base::Clock> clock) {
     clock_.reset(clock.release());
@@ -257,8 +265,16 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     Transaction*       writer;
     TransactionList    readers;
     TransactionList    pending_queue;
+    // Readers that reached the end of the data written so far by |writer|.
+    TransactionList    readers_waiting_for_data;
     bool               will_process_pending_queue;
     bool               doomed;
+    // Whether |writer| is writing the response body, which |readers| may read
+    // as it is written rather than wait for it to finish.
+    bool               readable_while_writing;
+    // Whether the last writer stopped before writing the whole body, which
+    // readers that joined it must fail on.
+    bool               incomplete_body;
   };
 
   using ActiveEntriesMap = std::unordered_map<std::string, ActiveEntry*>;
@@ -361,6 +377,19 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called by the writer of |entry| when it starts writing the response body,
+  // to let the pending transactions that can use the response as is read the
+  // body as it is written.
+  void AllowReadingWhileWriting(ActiveEntry* entry);
+
+  // Called by the writer of |entry| after it appends data to the body.
+  void OnWriterDataWritten(ActiveEntry* entry);
+
+  // Called by |trans|, a reader of |entry|, once it read all the data written
+  // so far by the writer. Returns ERR_IO_PENDING, and invokes the IO callback
+  // of |trans| once more data is written or the writer is done.
+  int WaitForWriterData(ActiveEntry* entry, Transaction* trans);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -382,6 +411,10 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   void OnProcessPendingQueue(ActiveEntry* entry);
 
+  // Adds the pending transactions of the entry of |key| that can read while
+  // the writer writes, if it still does.
+  void OnAllowReadingWhileWriting(const std::string& key);
+
   // Callbacks ----------------------------------------------------------------
 
   // Processes BackendCallback notifications.
@@ -411,6 +444,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   bool fail_conditionalization_for_test_;
 
   Mode mode_;
+  int hot_entry_cache_size_;
 
   std::unique_ptr<HttpTransactionFactory> network_layer_;
 
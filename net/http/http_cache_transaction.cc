@@ -53,6 +53,10 @@ namespace {
 // TODO(ricea): Move this to HttpResponseHeaders once it is standardised.
 static const char kFreshnessHeader[] = "Resource-Freshness";
 
+// Response bodies up to this size are read from the cache whole, rather than
+// one consumer buffer at a time.
+const int kMaxCacheReadAheadSize = 64 * 1024;
+
 // From http://tools.ietf.org/html/draft-ietf-httpbis-p6-cache-21#section-6
 //      a "non-error response" is one with a 2xx (Successful) or 3xx
 //      (Redirection) status code.
@@ -161,8 +165,12 @@ HttpCache::Transaction::Transaction(RequestPriority priority, HttpCache* cache)
       couldnt_conditionalize_request_(false),
       bypass_lock_for_test_(false),
       fail_conditionalization_for_test_(false),
+      read_while_write_(false),
+      bypass_read_while_write_(false),
       io_buf_len_(0),
       read_offset_(0),
+      read_ahead_len_(0),
+      reading_ahead_(false),
       effective_load_flags_(0),
       write_len_(0),
       transaction_pattern_(PATTERN_UNDEFINED),
@@ -246,6 +254,11 @@ LoadState HttpCache::Transaction::GetWriterLoadState() const {
   return LOAD_STATE_WAITING_FOR_CACHE;
 }
 
+bool HttpCache::Transaction::CanReadWhileWriting() const {
+  return (mode_ == READ || mode_ == READ_WRITE) && !partial_ &&
+         !bypass_read_while_write_ && request_->method == "GET";
+}
+
 const BoundNetLog& HttpCache::Transaction::net_log() const {
   return net_log_;
 }
@@ -376,6 +389,12 @@ int HttpCache::Transaction::Read(IOBuffer* buf, int buf_len,
   if (network_trans_) {
     DCHECK(mode_ == WRITE || mode_ == NONE ||
            (mode_ == READ_WRITE && partial_));
+    // The headers are written: other transactions may read the body as it
+    // comes.
+    if (mode_ == WRITE && entry_ && !partial_ && request_->method == "GET" &&
+        !entry_->readable_while_writing) {
+      cache_->AllowReadingWhileWriting(entry_);
+    }
     next_state_ = STATE_NETWORK_READ;
   } else {
     DCHECK(mode_ == READ || (mode_ == READ_WRITE && partial_));
@@ -1112,8 +1131,10 @@ int HttpCache::Transaction::DoAddToEntryComplete(int result) {
   DCHECK(new_entry_);
   cache_pending_ = false;
 
-  if (result == OK)
+  if (result == OK) {
     entry_ = new_entry_;
+    read_while_write_ = entry_->writer && entry_->writer != this;
+  }
 
   // If there is a failure, the cache should have taken care of new_entry_.
   new_entry_ = NULL;
@@ -1185,6 +1206,8 @@ int HttpCache::Transaction::DoCacheReadResponseComplete(int result) {
     // Either this is the first use of an entry since it was prefetched or
     // this is a prefetch. The value of response.unused_since_prefetch is valid
     // for this transaction but the bit needs to be flipped in storage.
+    if (read_while_write_)
+      return StopReadingWhileWriting();
     next_state_ = STATE_TOGGLE_UNUSED_SINCE_PREFETCH;
     return OK;
   }
@@ -1707,12 +1730,37 @@ int HttpCache::Transaction::DoCacheReadData() {
                                io_callback_);
   }
 
+  if (read_ahead_buf_) {
+    if (read_offset_ < read_ahead_len_)
+      return ReadFromReadAheadBuffer();
+    read_ahead_buf_ = NULL;
+  } else if (read_offset_ == 0 && !entry_->writer) {
+    // Saves a round trip to the cache for each of the following reads.
+    const int body_size =
+        entry_->disk_entry->GetDataSize(kResponseContentIndex);
+    if (body_size > io_buf_len_ && body_size <= kMaxCacheReadAheadSize) {
+      reading_ahead_ = true;
+      return entry_->disk_entry->ReadDataWithHint(
+          kResponseContentIndex, 0, body_size, &read_ahead_buf_, io_callback_);
+    }
+  }
+
   return entry_->disk_entry->ReadData(kResponseContentIndex, read_offset_,
                                       read_buf_.get(), io_buf_len_,
                                       io_callback_);
 }
 
 int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
+  if (reading_ahead_) {
+    reading_ahead_ = false;
+    if (result > 0) {
+      read_ahead_len_ = result;
+      result = ReadFromReadAheadBuffer();
+    } else {
+      read_ahead_buf_ = NULL;
+    }
+  }
+
   if (net_log_.IsCapturing()) {
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HTTP_CACHE_READ_DATA,
                                       result);
@@ -1730,6 +1778,15 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
 
   if (result > 0) {
     read_offset_ += result;
+  } else if (result == 0 && read_while_write_ && entry_->writer) {
+    // Waits for the writer to write more, unless it did meanwhile.
+    next_state_ = STATE_CACHE_READ_DATA;
+    if (entry_->disk_entry->GetDataSize(kResponseContentIndex) > read_offset_)
+      return OK;
+    return cache_->WaitForWriterData(entry_, this);
+  } else if (result == 0 && read_while_write_ && entry_->incomplete_body) {
+    // The writer stopped short of the end of the body.
+    return OnCacheReadError(ERR_CACHE_READ_FAILURE, false);
   } else if (result == 0) {  // End of file.
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
@@ -1780,6 +1837,10 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  // Readers of the body may go on.
+  if (entry_ && result > 0)
+    cache_->OnWriterDataWritten(entry_);
+
   if (partial_) {
     // This may be the last request.
     if (result != 0 || truncated_ ||
@@ -1971,6 +2032,9 @@ int HttpCache::Transaction::BeginCacheValidation() {
     response_.async_revalidation_required = true;
   }
 
+  if (read_while_write_ && !skip_validation)
+    return StopReadingWhileWriting();
+
   if (request_->method == "HEAD" &&
       (truncated_ || response_.headers->response_code() == 206)) {
     DCHECK(!partial_);
@@ -2027,6 +2091,9 @@ int HttpCache::Transaction::BeginPartialCacheValidation() {
   if (response_.headers->response_code() != 206 && !partial_ && !truncated_)
     return BeginCacheValidation();
 
+  if (read_while_write_)
+    return StopReadingWhileWriting();
+
   // Partial requests should not be recorded in histograms.
   UpdateTransactionPattern(PATTERN_NOT_COVERED);
   if (request_->method == "HEAD")
@@ -2464,7 +2531,8 @@ int HttpCache::Transaction::SetupEntryForRead() {
       partial_.reset();
     }
   }
-  cache_->ConvertWriterToReader(entry_);
+  if (!read_while_write_)
+    cache_->ConvertWriterToReader(entry_);
   mode_ = READ;
 
   if (request_->method == "HEAD")
@@ -2555,6 +2623,21 @@ void HttpCache::Transaction::DoneWritingToEntry(bool success) {
   mode_ = NONE;  // switch to 'pass through' mode
 }
 
+int HttpCache::Transaction::StopReadingWhileWriting() {
+  cache_->DoneWithEntry(entry_, this, false);
+  entry_ = NULL;
+  read_while_write_ = false;
+  bypass_read_while_write_ = true;
+  next_state_ = STATE_GET_BACKEND;
+  return OK;
+}
+
+int HttpCache::Transaction::ReadFromReadAheadBuffer() {
+  const int len = std::min(io_buf_len_, read_ahead_len_ - read_offset_);
+  memcpy(read_buf_->data(), read_ahead_buf_->data() + read_offset_, len);
+  return len;
+}
+
 int HttpCache::Transaction::OnCacheReadError(int result, bool restart) {
   DLOG(ERROR) << "ReadData failed: " << result;
   const int result_for_histogram = std::max(0, -result);
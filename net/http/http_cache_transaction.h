@@ -118,6 +118,10 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Returns whether this transaction, waiting for the entry being written,
+  // may read the response body while the writer writes it.
+  bool CanReadWhileWriting() const;
+
   const BoundNetLog& net_log() const;
 
   // Bypasses the cache lock whenever there is lock contention.
@@ -394,6 +398,15 @@ class HttpCache::Transaction : public HttpTransaction {
   // Called when we are done writing to the cache entry.
   void DoneWritingToEntry(bool success);
 
+  // Leaves the entry this transaction joined while it was written, as the
+  // stored response can't be used as is, and starts over to wait for the
+  // writer to finish.
+  int StopReadingWhileWriting();
+
+  // Copies the next chunk of the response body from |read_ahead_buf_| into
+  // |read_buf_|, and returns its size.
+  int ReadFromReadAheadBuffer();
+
   // Returns an error to signal the caller that the current read failed. The
   // current operation |result| is also logged. If |restart| is true, the
   // transaction should be restarted.
@@ -469,9 +482,16 @@ class HttpCache::Transaction : public HttpTransaction {
   bool couldnt_conditionalize_request_;
   bool bypass_lock_for_test_;  // A test is exercising the cache lock.
   bool fail_conditionalization_for_test_;  // Fail ConditionalizeRequest.
+  bool read_while_write_;  // We joined the entry while it was written.
+  bool bypass_read_while_write_;  // We must wait for the writer to finish.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
+  // The response body, read whole from the cache when small, and the number of
+  // bytes read into it.
+  scoped_refptr<IOBufferWithSize> read_ahead_buf_;
+  int read_ahead_len_;
+  bool reading_ahead_;  // Waiting for |read_ahead_buf_| to be read.
   int effective_load_flags_;
   int write_len_;
   std::unique_ptr<PartialData> partial_;  // We are dealing with range requests.
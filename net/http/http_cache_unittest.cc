@@ -33,6 +33,7 @@
 #include "net/cert/cert_status_flags.h"
 #include "net/cert/x509_certificate.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/hot_entry_backend.h"
 #include "net/http/http_byte_range.h"
 #include "net/http/http_cache_transaction.h"
 #include "net/http/http_request_headers.h"
@@ -835,6 +836,38 @@ TEST(HttpCache, SimpleGETWithDiskFailures3) {
   EXPECT_EQ(3, cache.disk_cache()->create_count());
 }
 
+// Tests that a small response body is read from the cache whole, and then
+// handed to the consumer in chunks from memory.
+TEST(HttpCache, SimpleGET_ReadAheadSmallBody) {
+  MockHttpCache cache;
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(kSimpleGET_Transaction.url, &entry));
+  MockDiskEntry* mock_entry = static_cast<MockDiskEntry*>(entry);
+  EXPECT_EQ(0, mock_entry->read_count(1));
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+  std::unique_ptr<HttpTransaction> trans;
+  ASSERT_EQ(OK, cache.CreateTransaction(&trans));
+  TestCompletionCallback callback;
+  int rv = trans->Start(&request, callback.callback(), BoundNetLog());
+  ASSERT_EQ(OK, callback.GetResult(rv));
+
+  std::string content;
+  do {
+    scoped_refptr<IOBuffer> buf(new IOBuffer(10));
+    rv = callback.GetResult(trans->Read(buf.get(), 10, callback.callback()));
+    ASSERT_LE(0, rv);
+    content.append(buf->data(), rv);
+  } while (rv > 0);
+  EXPECT_EQ(kSimpleGET_Transaction.data, content);
+
+  // One read of the whole body, and one at its end.
+  EXPECT_EQ(2, mock_entry->read_count(1));
+  entry->Close();
+}
+
 TEST(HttpCache, SimpleGET_LoadOnlyFromCache_Hit) {
   MockHttpCache cache;
 
@@ -1132,6 +1165,37 @@ TEST(HttpCache, SimpleGET_LoadBypassCache) {
   TestLoadTimingNetworkRequest(load_timing_info);
 }
 
+// Tests that small responses read from the cache are kept in memory when the
+// hot entry cache is enabled, and dropped when they are written again.
+TEST(HttpCache, SimpleGET_HotEntryCache) {
+  MockHttpCache cache;
+  cache.http_cache()->set_hot_entry_cache_size(64 * 1024);
+
+  // Write to the cache, then read from it.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  disk_cache::HotEntryBackend* backend =
+      static_cast<disk_cache::HotEntryBackend*>(cache.backend());
+  EXPECT_LT(0, backend->hot_bytes());
+
+  // Read from memory.
+  BoundTestNetLog log;
+  LoadTimingInfo load_timing_info;
+  RunTransactionTestAndGetTiming(cache.http_cache(), kSimpleGET_Transaction,
+                                 log.bound(), &load_timing_info);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  TestLoadTimingCachedResponse(load_timing_info);
+
+  // Writing to the cache again drops the entry.
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.load_flags |= LOAD_BYPASS_CACHE;
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, backend->hot_bytes());
+}
+
 TEST(HttpCache, SimpleGET_LoadBypassCache_Implicit) {
   MockHttpCache cache;
 
@@ -1367,11 +1431,11 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   c->result = c->callback.WaitForResult();
   ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // Now we have 2 active readers and two queued transactions.
+  // The queued transactions joined the entry as readers while the writer was
+  // reading the body, so we now have 4 active readers.
 
   EXPECT_EQ(LOAD_STATE_IDLE, context_list[2]->trans->GetLoadState());
-  EXPECT_EQ(LOAD_STATE_WAITING_FOR_CACHE,
-            context_list[3]->trans->GetLoadState());
+  EXPECT_EQ(LOAD_STATE_IDLE, context_list[3]->trans->GetLoadState());
 
   c = context_list[1];
   ASSERT_EQ(ERR_IO_PENDING, c->result);
@@ -1379,10 +1443,8 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   if (c->result == OK)
     ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // At this point we have one reader, two pending transactions and a task on
-  // the queue to move to the next transaction. Now we cancel the request that
-  // is the current reader, and expect the queued task to be able to start the
-  // next request.
+  // At this point we have three readers. Now we cancel one of them, and expect
+  // the others to be able to finish.
 
   c = context_list[2];
   c->trans.reset();
@@ -1407,6 +1469,95 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   }
 }
 
+// Tests that a transaction waiting for the writer reads the body as it is
+// written, rather than after the writer is done.
+TEST(HttpCache, SimpleGET_ReadWhileWriting) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+  const std::string expected(kSimpleGET_Transaction.data);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(OK, cache.CreateTransaction(&writer.trans));
+  ASSERT_EQ(OK, cache.CreateTransaction(&reader.trans));
+  writer.result =
+      writer.trans->Start(&request, writer.callback.callback(), BoundNetLog());
+  reader.result =
+      reader.trans->Start(&request, reader.callback.callback(), BoundNetLog());
+  ASSERT_EQ(OK, writer.callback.GetResult(writer.result));
+  ASSERT_EQ(ERR_IO_PENDING, reader.result);
+
+  scoped_refptr<IOBuffer> writer_buf(new IOBuffer(256));
+  int rv = writer.trans->Read(writer_buf.get(), 10, writer.callback.callback());
+  ASSERT_EQ(10, writer.callback.GetResult(rv));
+
+  // The reader joins the entry, and reads what has been written so far.
+  ASSERT_EQ(OK, reader.callback.WaitForResult());
+  scoped_refptr<IOBuffer> reader_buf(new IOBuffer(256));
+  rv = reader.trans->Read(reader_buf.get(), 256, reader.callback.callback());
+  ASSERT_EQ(10, reader.callback.GetResult(rv));
+  EXPECT_EQ(expected.substr(0, 10), std::string(reader_buf->data(), 10));
+
+  // Then waits for the writer.
+  rv = reader.trans->Read(reader_buf.get(), 256, reader.callback.callback());
+  ASSERT_EQ(ERR_IO_PENDING, rv);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  std::string content;
+  EXPECT_EQ(OK, ReadTransaction(writer.trans.get(), &content));
+  EXPECT_EQ(expected.substr(10), content);
+
+  rv = reader.callback.WaitForResult();
+  ASSERT_EQ(static_cast<int>(expected.size()) - 10, rv);
+  EXPECT_EQ(expected.substr(10), std::string(reader_buf->data(), rv));
+  rv = reader.trans->Read(reader_buf.get(), 256, reader.callback.callback());
+  EXPECT_EQ(0, reader.callback.GetResult(rv));
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a transaction reading the body being written fails if the writer
+// goes away before the end of the body.
+TEST(HttpCache, SimpleGET_ReadWhileWriting_WriterCancelled) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(OK, cache.CreateTransaction(&writer.trans));
+  ASSERT_EQ(OK, cache.CreateTransaction(&reader.trans));
+  writer.result =
+      writer.trans->Start(&request, writer.callback.callback(), BoundNetLog());
+  reader.result =
+      reader.trans->Start(&request, reader.callback.callback(), BoundNetLog());
+  ASSERT_EQ(OK, writer.callback.GetResult(writer.result));
+
+  scoped_refptr<IOBuffer> writer_buf(new IOBuffer(256));
+  int rv = writer.trans->Read(writer_buf.get(), 10, writer.callback.callback());
+  ASSERT_EQ(10, writer.callback.GetResult(rv));
+
+  ASSERT_EQ(OK, reader.callback.WaitForResult());
+  scoped_refptr<IOBuffer> reader_buf(new IOBuffer(256));
+  rv = reader.trans->Read(reader_buf.get(), 256, reader.callback.callback());
+  ASSERT_EQ(10, reader.callback.GetResult(rv));
+  rv = reader.trans->Read(reader_buf.get(), 256, reader.callback.callback());
+  ASSERT_EQ(ERR_IO_PENDING, rv);
+
+  writer.trans.reset();
+  EXPECT_EQ(ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+  reader.trans.reset();
+
+  // The entry was doomed, so the next request goes to the network.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+}
+
 // Tests that we can doom an entry with pending transactions and delete one of
 // the pending transactions before the first one completes.
 // See http://code.google.com/p/chromium/issues/detail?id=25588
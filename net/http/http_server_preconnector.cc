@@ -0,0 +1,144 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_server_preconnector.h"
+
+#include <algorithm>
+#include <set>
+
+#include "base/memory/memory_pressure_monitor.h"
+#include "base/power_monitor/power_monitor.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_server_properties.h"
+#include "net/http/http_stream_factory.h"
+#include "url/gurl.h"
+#include "url/scheme_host_port.h"
+
+namespace net {
+
+HttpServerPreconnector::Options::Options()
+    : max_servers(8),
+      max_connections(16),
+      connections_per_http11_server(2),
+      min_rtt(base::TimeDelta::FromMilliseconds(20)),
+      preconnect_on_battery(false),
+      preconnect_on_cellular(false),
+      preconnect_on_network_change(true) {}
+
+HttpServerPreconnector::HttpServerPreconnector(
+    HttpStreamFactory* http_stream_factory,
+    HttpServerProperties* http_server_properties,
+    const Options& options)
+    : http_stream_factory_(http_stream_factory),
+      http_server_properties_(http_server_properties),
+      options_(options) {
+  if (options_.preconnect_on_network_change)
+    NetworkChangeNotifier::AddNetworkChangeObserver(this);
+}
+
+HttpServerPreconnector::~HttpServerPreconnector() {
+  if (options_.preconnect_on_network_change)
+    NetworkChangeNotifier::RemoveNetworkChangeObserver(this);
+}
+
+int HttpServerPreconnector::PreconnectToRecentServers() {
+  if (ShouldSkipPreconnect())
+    return 0;
+
+  int connections = 0;
+  for (const url::SchemeHostPort& server : GetServersToPreconnect()) {
+    // Like HttpStreamFactoryImpl::Job::Preconnect(), only open one
+    // connection to servers that multiplex requests.
+    int num_streams = http_server_properties_->SupportsRequestPriority(server)
+                          ? 1
+                          : options_.connections_per_http11_server;
+    if (connections + num_streams > options_.max_connections)
+      continue;
+
+    HttpRequestInfo request_info;
+    request_info.method = "GET";
+    request_info.url = GURL(server.Serialize());
+    http_stream_factory_->PreconnectStreams(num_streams, request_info);
+    connections += num_streams;
+  }
+  return connections;
+}
+
+void HttpServerPreconnector::OnNetworkChanged(
+    NetworkChangeNotifier::ConnectionType type) {
+  if (type == NetworkChangeNotifier::CONNECTION_NONE)
+    return;
+  PreconnectToRecentServers();
+}
+
+bool HttpServerPreconnector::ShouldSkipPreconnect() const {
+  if (!options_.preconnect_on_battery) {
+    base::PowerMonitor* power_monitor = base::PowerMonitor::Get();
+    if (power_monitor && power_monitor->IsOnBatteryPower())
+      return true;
+  }
+
+  if (!options_.preconnect_on_cellular &&
+      NetworkChangeNotifier::IsConnectionCellular(
+          NetworkChangeNotifier::GetConnectionType())) {
+    return true;
+  }
+
+  base::MemoryPressureMonitor* memory_pressure_monitor =
+      base::MemoryPressureMonitor::Get();
+  if (memory_pressure_monitor &&
+      memory_pressure_monitor->GetCurrentPressureLevel() !=
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<url::SchemeHostPort>
+HttpServerPreconnector::GetServersToPreconnect() const {
+  const ServerNetworkStatsMap& stats_map =
+      http_server_properties_->server_network_stats_map();
+
+  // Both maps are in most recently used order. Servers with network stats
+  // come first since their RTT is known to be worth saving; servers that only
+  // advertised alternative services fill the remaining slots.
+  std::vector<url::SchemeHostPort> servers;
+  std::set<url::SchemeHostPort> seen;
+  for (const auto& entry : stats_map) {
+    if (servers.size() >= options_.max_servers)
+      break;
+    if (entry.second.srtt < options_.min_rtt)
+      continue;
+    if (seen.insert(entry.first).second)
+      servers.push_back(entry.first);
+  }
+  for (const auto& entry : http_server_properties_->alternative_service_map()) {
+    if (servers.size() >= options_.max_servers)
+      break;
+    if (stats_map.Peek(entry.first) != stats_map.end())
+      continue;
+    if (seen.insert(entry.first).second)
+      servers.push_back(entry.first);
+  }
+
+  // Preconnect to the servers furthest away first, so that if the connection
+  // budget runs out, it's the closest servers that miss out.
+  std::stable_sort(servers.begin(), servers.end(),
+                   [&stats_map](const url::SchemeHostPort& a,
+                                const url::SchemeHostPort& b) {
+                     auto a_it = stats_map.Peek(a);
+                     auto b_it = stats_map.Peek(b);
+                     base::TimeDelta a_rtt = a_it == stats_map.end()
+                                                 ? base::TimeDelta()
+                                                 : a_it->second.srtt;
+                     base::TimeDelta b_rtt = b_it == stats_map.end()
+                                                 ? base::TimeDelta()
+                                                 : b_it->second.srtt;
+                     return a_rtt > b_rtt;
+                   });
+  return servers;
+}
+
+}  // namespace net
@@ -0,0 +1,93 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_SERVER_PRECONNECTOR_H_
+#define NET_HTTP_HTTP_SERVER_PRECONNECTOR_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/base/network_change_notifier.h"
+
+namespace url {
+class SchemeHostPort;
+}
+
+namespace net {
+
+class HttpServerProperties;
+class HttpStreamFactory;
+
+// Opens connections ahead of time to the servers the user talked to most
+// recently, according to HttpServerProperties, so that the first request to
+// them after startup or a network change doesn't pay for DNS, TCP and TLS
+// setup. Servers with the highest round trip times are preconnected first,
+// since they benefit the most. Servers known to support SPDY or QUIC get a
+// single connection, other servers get a few. For QUIC servers, the
+// preconnect also loads the cached crypto config so the first request can use
+// 0-RTT.
+//
+// Preconnecting is skipped entirely while on battery power, on a cellular
+// connection or under memory pressure, unless |Options| say otherwise.
+class NET_EXPORT HttpServerPreconnector
+    : public NetworkChangeNotifier::NetworkChangeObserver {
+ public:
+  struct NET_EXPORT Options {
+    Options();
+
+    // The most servers to preconnect to.
+    size_t max_servers;
+    // The most connections to open across all servers.
+    int max_connections;
+    // Connections to open to each server that doesn't support SPDY or QUIC.
+    int connections_per_http11_server;
+    // Servers with a known round trip time shorter than this are skipped,
+    // since a warm connection saves them little.
+    base::TimeDelta min_rtt;
+    // Whether to preconnect while on battery power.
+    bool preconnect_on_battery;
+    // Whether to preconnect while on a cellular connection.
+    bool preconnect_on_cellular;
+    // Whether to preconnect again when the default network changes, since
+    // connections on the old network are no longer usable.
+    bool preconnect_on_network_change;
+  };
+
+  // |http_stream_factory| and |http_server_properties| must outlive the
+  // preconnector.
+  HttpServerPreconnector(HttpStreamFactory* http_stream_factory,
+                         HttpServerProperties* http_server_properties,
+                         const Options& options);
+  ~HttpServerPreconnector() override;
+
+  // Preconnects to the servers in |http_server_properties| that were used
+  // most recently, within the limits of |options|. Returns the number of
+  // connections requested.
+  int PreconnectToRecentServers();
+
+  // NetworkChangeNotifier::NetworkChangeObserver implementation.
+  void OnNetworkChanged(NetworkChangeNotifier::ConnectionType type) override;
+
+ private:
+  // Returns true if the device is in a state where speculative connections
+  // aren't worth their cost.
+  bool ShouldSkipPreconnect() const;
+
+  // Returns the servers to preconnect to, most important first.
+  std::vector<url::SchemeHostPort> GetServersToPreconnect() const;
+
+  HttpStreamFactory* const http_stream_factory_;
+  HttpServerProperties* const http_server_properties_;
+  const Options options_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpServerPreconnector);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_SERVER_PRECONNECTOR_H_
@@ -0,0 +1,195 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_server_preconnector.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_server_properties_impl.h"
+#include "net/http/http_stream_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/scheme_host_port.h"
+
+namespace net {
+
+namespace {
+
+// HttpStreamFactory that records the preconnects it's asked for.
+class RecordingStreamFactory : public HttpStreamFactory {
+ public:
+  RecordingStreamFactory() {}
+  ~RecordingStreamFactory() override {}
+
+  // Pairs of (URL, number of streams), in the order requested.
+  const std::vector<std::pair<std::string, int>>& preconnects() const {
+    return preconnects_;
+  }
+
+  HttpStreamRequest* RequestStream(const HttpRequestInfo& info,
+                                   RequestPriority priority,
+                                   const SSLConfig& server_ssl_config,
+                                   const SSLConfig& proxy_ssl_config,
+                                   HttpStreamRequest::Delegate* delegate,
+                                   const BoundNetLog& net_log) override {
+    ADD_FAILURE();
+    return nullptr;
+  }
+
+  HttpStreamRequest* RequestWebSocketHandshakeStream(
+      const HttpRequestInfo& info,
+      RequestPriority priority,
+      const SSLConfig& server_ssl_config,
+      const SSLConfig& proxy_ssl_config,
+      HttpStreamRequest::Delegate* delegate,
+      WebSocketHandshakeStreamBase::CreateHelper* create_helper,
+      const BoundNetLog& net_log) override {
+    ADD_FAILURE();
+    return nullptr;
+  }
+
+  HttpStreamRequest* RequestBidirectionalStreamImpl(
+      const HttpRequestInfo& info,
+      RequestPriority priority,
+      const SSLConfig& server_ssl_config,
+      const SSLConfig& proxy_ssl_config,
+      HttpStreamRequest::Delegate* delegate,
+      const BoundNetLog& net_log) override {
+    ADD_FAILURE();
+    return nullptr;
+  }
+
+  void PreconnectStreams(int num_streams,
+                         const HttpRequestInfo& info) override {
+    EXPECT_EQ("GET", info.method);
+    preconnects_.push_back(std::make_pair(info.url.spec(), num_streams));
+  }
+
+  const HostMappingRules* GetHostMappingRules() const override {
+    ADD_FAILURE();
+    return nullptr;
+  }
+
+ private:
+  std::vector<std::pair<std::string, int>> preconnects_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingStreamFactory);
+};
+
+class HttpServerPreconnectorTest : public ::testing::Test {
+ protected:
+  HttpServerPreconnectorTest() {
+    options_.preconnect_on_network_change = false;
+  }
+
+  void SetRtt(const url::SchemeHostPort& server, int rtt_ms) {
+    ServerNetworkStats stats;
+    stats.srtt = base::TimeDelta::FromMilliseconds(rtt_ms);
+    http_server_properties_.SetServerNetworkStats(server, stats);
+  }
+
+  void SetQuicAlternativeService(const url::SchemeHostPort& server) {
+    http_server_properties_.SetAlternativeService(
+        server, AlternativeService(QUIC, "", 443),
+        base::Time::Now() + base::TimeDelta::FromDays(1));
+  }
+
+  int Preconnect() {
+    HttpServerPreconnector preconnector(&stream_factory_,
+                                        &http_server_properties_, options_);
+    return preconnector.PreconnectToRecentServers();
+  }
+
+  HttpServerPreconnector::Options options_;
+  RecordingStreamFactory stream_factory_;
+  HttpServerPropertiesImpl http_server_properties_;
+};
+
+TEST_F(HttpServerPreconnectorTest, NoServers) {
+  EXPECT_EQ(0, Preconnect());
+  EXPECT_TRUE(stream_factory_.preconnects().empty());
+}
+
+TEST_F(HttpServerPreconnectorTest, SlowestServersFirst) {
+  options_.min_rtt = base::TimeDelta::FromMilliseconds(20);
+  SetRtt(url::SchemeHostPort("https", "near.example", 443), 30);
+  SetRtt(url::SchemeHostPort("https", "far.example", 443), 200);
+  SetRtt(url::SchemeHostPort("https", "local.example", 443), 5);
+
+  EXPECT_EQ(2 * options_.connections_per_http11_server, Preconnect());
+  ASSERT_EQ(2u, stream_factory_.preconnects().size());
+  EXPECT_EQ("https://far.example/", stream_factory_.preconnects()[0].first);
+  EXPECT_EQ("https://near.example/", stream_factory_.preconnects()[1].first);
+}
+
+TEST_F(HttpServerPreconnectorTest, OneConnectionToMultiplexedServers) {
+  options_.connections_per_http11_server = 3;
+  url::SchemeHostPort spdy_server("https", "spdy.example", 443);
+  url::SchemeHostPort quic_server("https", "quic.example", 443);
+  url::SchemeHostPort http11_server("https", "http11.example", 443);
+  SetRtt(spdy_server, 300);
+  SetRtt(quic_server, 200);
+  SetRtt(http11_server, 100);
+  http_server_properties_.SetSupportsSpdy(spdy_server, true);
+  SetQuicAlternativeService(quic_server);
+
+  EXPECT_EQ(5, Preconnect());
+  ASSERT_EQ(3u, stream_factory_.preconnects().size());
+  EXPECT_EQ(1, stream_factory_.preconnects()[0].second);
+  EXPECT_EQ(1, stream_factory_.preconnects()[1].second);
+  EXPECT_EQ(3, stream_factory_.preconnects()[2].second);
+}
+
+TEST_F(HttpServerPreconnectorTest, AlternativeServiceOnlyServers) {
+  url::SchemeHostPort stats_server("https", "stats.example", 443);
+  url::SchemeHostPort alt_svc_server("https", "alt-svc.example", 443);
+  SetRtt(stats_server, 100);
+  SetQuicAlternativeService(alt_svc_server);
+
+  EXPECT_EQ(1 + options_.connections_per_http11_server, Preconnect());
+  ASSERT_EQ(2u, stream_factory_.preconnects().size());
+  EXPECT_EQ("https://stats.example/", stream_factory_.preconnects()[0].first);
+  EXPECT_EQ("https://alt-svc.example/",
+            stream_factory_.preconnects()[1].first);
+  EXPECT_EQ(1, stream_factory_.preconnects()[1].second);
+}
+
+TEST_F(HttpServerPreconnectorTest, MaxServersKeepsMostRecent) {
+  options_.max_servers = 2;
+  SetRtt(url::SchemeHostPort("https", "oldest.example", 443), 500);
+  SetRtt(url::SchemeHostPort("https", "older.example", 443), 100);
+  SetRtt(url::SchemeHostPort("https", "newest.example", 443), 100);
+
+  Preconnect();
+  ASSERT_EQ(2u, stream_factory_.preconnects().size());
+  EXPECT_EQ("https://newest.example/", stream_factory_.preconnects()[0].first);
+  EXPECT_EQ("https://older.example/", stream_factory_.preconnects()[1].first);
+}
+
+TEST_F(HttpServerPreconnectorTest, ConnectionBudget) {
+  options_.max_connections = 5;
+  options_.connections_per_http11_server = 2;
+  url::SchemeHostPort quic_server("https", "quic.example", 443);
+  SetRtt(url::SchemeHostPort("https", "a.example", 443), 400);
+  SetRtt(url::SchemeHostPort("https", "b.example", 443), 300);
+  SetRtt(url::SchemeHostPort("https", "c.example", 443), 200);
+  SetRtt(quic_server, 100);
+  SetQuicAlternativeService(quic_server);
+
+  // c.example doesn't fit in the budget, but the QUIC server still does.
+  EXPECT_EQ(5, Preconnect());
+  ASSERT_EQ(3u, stream_factory_.preconnects().size());
+  EXPECT_EQ("https://a.example/", stream_factory_.preconnects()[0].first);
+  EXPECT_EQ("https://b.example/", stream_factory_.preconnects()[1].first);
+  EXPECT_EQ("https://quic.example/", stream_factory_.preconnects()[2].first);
+}
+
+}  // namespace
+
+}  // namespace net
@@ -4,6 +4,7 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/bind.h"
@@ -50,6 +51,10 @@ void RecordHeaderParserEvent(HttpHeaderParserEvent header_event) {
 const uint64_t kMaxMergedHeaderAndBodySize = 1400;
 const size_t kRequestBodyBufferSize = 1 << 14;  // 16KB
 
+// The most bytes of a request body file to send with one SendFile() call, so
+// that upload progress keeps being reported.
+const int kMaxSendFileSize = 1 << 18;  // 256KB
+
 std::string GetResponseHeaderLines(const HttpResponseHeaders& headers) {
   std::string raw_headers = headers.raw_headers();
   const char* null_separated_headers = raw_headers.c_str();
@@ -221,6 +226,7 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
       connection_(connection),
       net_log_(net_log),
       sent_last_chunk_(false),
+      can_send_file_(true),
       upload_error_(OK),
       weak_ptr_factory_(this) {
   io_callback_ = base::Bind(&HttpStreamParser::OnIOComplete,
@@ -419,6 +425,9 @@ int HttpStreamParser::DoLoop(int result) {
       case STATE_SEND_BODY_COMPLETE:
         result = DoSendBodyComplete(result);
         break;
+      case STATE_SEND_BODY_FROM_FILE_COMPLETE:
+        result = DoSendBodyFromFileComplete(result);
+        break;
       case STATE_SEND_REQUEST_READ_BODY_COMPLETE:
         result = DoSendRequestReadBodyComplete(result);
         break;
@@ -522,6 +531,21 @@ int HttpStreamParser::DoSendBody() {
     return OK;
   }
 
+  // Send file data straight from the file when the socket allows it, which
+  // saves copying it through |request_body_read_buf_|. Chunked data needs
+  // encoding, so it always goes through the buffer.
+  if (can_send_file_ && !request_->upload_data_stream->is_chunked()) {
+    uint64_t length = 0;
+    base::PlatformFile file =
+        request_->upload_data_stream->GetFileForSendFile(&length);
+    if (file != base::kInvalidPlatformFile) {
+      io_state_ = STATE_SEND_BODY_FROM_FILE_COMPLETE;
+      return connection_->socket()->SendFile(
+          file, static_cast<int>(std::min<uint64_t>(length, kMaxSendFileSize)),
+          io_callback_);
+    }
+  }
+
   request_body_read_buf_->Clear();
   io_state_ = STATE_SEND_REQUEST_READ_BODY_COMPLETE;
   return request_->upload_data_stream->Read(request_body_read_buf_.get(),
@@ -547,6 +571,31 @@ int HttpStreamParser::DoSendBodyComplete(int result) {
   return OK;
 }
 
+int HttpStreamParser::DoSendBodyFromFileComplete(int result) {
+  // If the socket can't send files, or the file is shorter than when the
+  // upload was initialized, read the rest of the body instead. In the latter
+  // case the upload data stream pads the body to the announced size.
+  if (result == ERR_NOT_IMPLEMENTED || result == 0) {
+    can_send_file_ = false;
+    io_state_ = STATE_SEND_BODY;
+    return OK;
+  }
+
+  if (result < 0) {
+    if (ShouldTryReadingOnUploadError(result)) {
+      upload_error_ = result;
+      return OK;
+    }
+    return result;
+  }
+
+  sent_bytes_ += result;
+  request_->upload_data_stream->DidSendFileData(result);
+
+  io_state_ = STATE_SEND_BODY;
+  return OK;
+}
+
 int HttpStreamParser::DoSendRequestReadBodyComplete(int result) {
   // |result| is the result of read from the request body from the last call to
   // DoSendBody().
@@ -134,6 +134,7 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
     STATE_SEND_HEADERS_COMPLETE,
     STATE_SEND_BODY,
     STATE_SEND_BODY_COMPLETE,
+    STATE_SEND_BODY_FROM_FILE_COMPLETE,
     STATE_SEND_REQUEST_READ_BODY_COMPLETE,
     STATE_READ_HEADERS,
     STATE_READ_HEADERS_COMPLETE,
@@ -166,6 +167,7 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   int DoSendHeadersComplete(int result);
   int DoSendBody();
   int DoSendBodyComplete(int result);
+  int DoSendBodyFromFileComplete(int result);
   int DoSendRequestReadBodyComplete(int result);
   int DoReadHeaders();
   int DoReadHeadersComplete(int result);
@@ -272,6 +274,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   scoped_refptr<SeekableIOBuffer> request_body_send_buf_;
   bool sent_last_chunk_;
 
+  // False once the socket turned out not to support SendFile(), after which
+  // the whole request body is read through |request_body_read_buf_|.
+  bool can_send_file_;
+
   // Error received when uploading the body, if any.
   int upload_error_;
 
@@ -4,6 +4,7 @@
 
 #include "net/http/mock_http_cache.h"
 
+#include <algorithm>
 #include <limits>
 #include <utility>
 
@@ -68,6 +69,7 @@ MockDiskEntry::MockDiskEntry(const std::string& key)
       delayed_(false),
       cancel_(false) {
   test_mode_ = GetTestModeForEntry(key);
+  std::fill(read_counts_, read_counts_ + kNumCacheEntryDataIndices, 0);
 }
 
 void MockDiskEntry::Doom() {
@@ -102,6 +104,7 @@ int MockDiskEntry::ReadData(int index,
                             const CompletionCallback& callback) {
   DCHECK(index >= 0 && index < kNumCacheEntryDataIndices);
   DCHECK(!callback.is_null());
+  read_counts_[index]++;
 
   if (fail_requests_)
     return ERR_CACHE_READ_FAILURE;
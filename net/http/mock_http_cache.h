@@ -69,6 +69,9 @@ class MockDiskEntry : public disk_cache::Entry,
 
   void set_fail_sparse_requests() { fail_sparse_requests_ = true; }
 
+  // Returns the number of ReadData() calls for the data with the given index.
+  int read_count(int index) const { return read_counts_[index]; }
+
   // If |value| is true, don't deliver any completion callbacks until called
   // again with |value| set to false.  Caution: remember to enable callbacks
   // again or all subsequent tests will fail.
@@ -98,6 +101,7 @@ class MockDiskEntry : public disk_cache::Entry,
 
   std::string key_;
   std::vector<char> data_[kNumCacheEntryDataIndices];
+  int read_counts_[kNumCacheEntryDataIndices];
   int test_mode_;
   bool doomed_;
   bool sparse_;
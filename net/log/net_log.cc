@@ -9,8 +9,10 @@
 #include "base/bind.h"
 #include "base/debug/alias.h"
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "net/base/net_errors.h"
@@ -227,14 +229,43 @@ NetLog* NetLog::ThreadSafeObserver::net_log() const {
   return net_log_;
 }
 
-void NetLog::ThreadSafeObserver::OnAddEntryData(const EntryData& entry_data) {
-  OnAddEntry(Entry(&entry_data, capture_mode()));
+bool NetLog::ThreadSafeObserver::AcceptsConcurrentEntries() const {
+  return false;
 }
 
-NetLog::NetLog() : last_id_(0), is_capturing_(0) {
+void NetLog::ThreadSafeObserver::OnAddEntryData(
+    const EntryData& entry_data,
+    NetLogCaptureMode capture_mode) {
+  OnAddEntry(Entry(&entry_data, capture_mode));
 }
 
+struct NetLog::ObserverSnapshot {
+  struct Observer {
+    ThreadSafeObserver* observer;
+    NetLogCaptureMode capture_mode;
+  };
+
+  ObserverSnapshot() : num_dispatching(0) {}
+
+  // Observers whose OnAddEntry() may be called concurrently.
+  std::vector<Observer> concurrent_observers;
+
+  // Observers whose OnAddEntry() calls are serialized by |dispatch_lock_|.
+  std::vector<Observer> serialized_observers;
+
+  // Number of threads dispatching an entry to the snapshot's observers.
+  base::subtle::Atomic32 num_dispatching;
+};
+
+NetLog::NetLog()
+    : last_id_(0),
+      is_capturing_(0),
+      snapshot_(reinterpret_cast<base::subtle::AtomicWord>(
+          new ObserverSnapshot())) {}
+
 NetLog::~NetLog() {
+  delete reinterpret_cast<ObserverSnapshot*>(
+      base::subtle::NoBarrier_Load(&snapshot_));
 }
 
 void NetLog::AddGlobalEntry(EventType type) {
@@ -265,7 +296,7 @@ void NetLog::DeprecatedAddObserver(NetLog::ThreadSafeObserver* observer,
   observers_.AddObserver(observer);
   observer->net_log_ = this;
   observer->capture_mode_ = capture_mode;
-  UpdateIsCapturing();
+  UpdateObservers();
 }
 
 void NetLog::SetObserverCaptureMode(NetLog::ThreadSafeObserver* observer,
@@ -275,6 +306,7 @@ void NetLog::SetObserverCaptureMode(NetLog::ThreadSafeObserver* observer,
   DCHECK(observers_.HasObserver(observer));
   DCHECK_EQ(this, observer->net_log_);
   observer->capture_mode_ = capture_mode;
+  UpdateObservers();
 }
 
 void NetLog::DeprecatedRemoveObserver(NetLog::ThreadSafeObserver* observer) {
@@ -285,13 +317,37 @@ void NetLog::DeprecatedRemoveObserver(NetLog::ThreadSafeObserver* observer) {
   observers_.RemoveObserver(observer);
   observer->net_log_ = NULL;
   observer->capture_mode_ = NetLogCaptureMode();
-  UpdateIsCapturing();
+  UpdateObservers();
 }
 
-void NetLog::UpdateIsCapturing() {
+void NetLog::UpdateObservers() {
   lock_.AssertAcquired();
+
+  std::unique_ptr<ObserverSnapshot> snapshot(new ObserverSnapshot());
+  base::ObserverList<ThreadSafeObserver, true>::Iterator it(&observers_);
+  while (ThreadSafeObserver* observer = it.GetNext()) {
+    ObserverSnapshot::Observer entry = {observer, observer->capture_mode_};
+    if (observer->AcceptsConcurrentEntries())
+      snapshot->concurrent_observers.push_back(entry);
+    else
+      snapshot->serialized_observers.push_back(entry);
+  }
+
+  ObserverSnapshot* old_snapshot = reinterpret_cast<ObserverSnapshot*>(
+      base::subtle::NoBarrier_Load(&snapshot_));
+  base::subtle::Release_Store(
+      &snapshot_, reinterpret_cast<base::subtle::AtomicWord>(snapshot.get()));
+  retired_snapshots_.push_back(base::WrapUnique(old_snapshot));
+  snapshot.release();
   base::subtle::NoBarrier_Store(&is_capturing_,
                                 observers_.might_have_observers() ? 1 : 0);
+
+  // Wait for threads still dispatching to the old observers, so that removed
+  // observers are not called anymore once this returns. Any thread that starts
+  // dispatching after this sees the new snapshot, see AddEntry().
+  base::subtle::MemoryBarrier();
+  while (base::subtle::Acquire_Load(&old_snapshot->num_dispatching) != 0)
+    base::PlatformThread::YieldCurrentThread();
 }
 
 // static
@@ -406,9 +462,35 @@ void NetLog::AddEntry(EventType type,
   EntryData entry_data(type, source, phase, base::TimeTicks::Now(),
                        parameters_callback);
 
+  // Register as dispatching to the current snapshot. If the snapshot was
+  // replaced in the meantime, UpdateObservers() may not have waited for this
+  // thread, so try again with the new one.
+  ObserverSnapshot* snapshot;
+  while (true) {
+    snapshot = reinterpret_cast<ObserverSnapshot*>(
+        base::subtle::Acquire_Load(&snapshot_));
+    base::subtle::Barrier_AtomicIncrement(&snapshot->num_dispatching, 1);
+    if (snapshot == reinterpret_cast<ObserverSnapshot*>(
+                        base::subtle::Acquire_Load(&snapshot_))) {
+      break;
+    }
+    base::subtle::Barrier_AtomicIncrement(&snapshot->num_dispatching, -1);
+  }
+
   // Notify all of the log observers.
-  base::AutoLock lock(lock_);
-  FOR_EACH_OBSERVER(ThreadSafeObserver, observers_, OnAddEntryData(entry_data));
+  for (const ObserverSnapshot::Observer& observer :
+       snapshot->concurrent_observers) {
+    observer.observer->OnAddEntryData(entry_data, observer.capture_mode);
+  }
+  if (!snapshot->serialized_observers.empty()) {
+    base::AutoLock lock(dispatch_lock_);
+    for (const ObserverSnapshot::Observer& observer :
+         snapshot->serialized_observers) {
+      observer.observer->OnAddEntryData(entry_data, observer.capture_mode);
+    }
+  }
+
+  base::subtle::Barrier_AtomicIncrement(&snapshot->num_dispatching, -1);
 }
 
 BoundNetLog::~BoundNetLog() {
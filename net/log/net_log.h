@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/atomicops.h"
 #include "base/callback_forward.h"
@@ -42,6 +43,10 @@ namespace net {
 // NetLog::ThreadSafeObserver functions may be called by an observer's
 // OnAddEntry() method.  Doing so will result in a deadlock.
 //
+// Adding an entry doesn't take a lock unless an observer needs its calls
+// serialized, and an entry's parameters are only built if an observer asks
+// for them.
+//
 // For a broader introduction see the design document:
 // https://sites.google.com/a/chromium.org/dev/developers/design-documents/network-stack/netlog
 class NET_EXPORT NetLog {
@@ -181,8 +186,8 @@ class NET_EXPORT NetLog {
     // OnAddEntry() is invoked on the thread which generated the NetLog entry,
     // which may be different from the thread that added this observer.
     //
-    // Whenever OnAddEntry() is invoked, the NetLog's mutex is held. The
-    // consequences of this are:
+    // Unless AcceptsConcurrentEntries() returns true, a NetLog mutex is held
+    // whenever OnAddEntry() is invoked. The consequences of this are:
     //
     //   * OnAddEntry() will never be called concurrently -- implementations
     //     can rely on this to avoid needing their own synchronization.
@@ -190,15 +195,26 @@ class NET_EXPORT NetLog {
     //   * It is illegal for an observer to call back into the NetLog, or the
     //     observer itself, as this can result in deadlock or violating
     //     expectations of non re-entrancy into ThreadSafeObserver.
+    //
+    // The parameters of the entry are only built if the observer asks for
+    // them, through Entry::ToValue() or Entry::ParametersToValue().
     virtual void OnAddEntry(const Entry& entry) = 0;
 
+    // Returns true if OnAddEntry() may be invoked on several threads at once,
+    // without the NetLog serializing the calls. Observers that don't need the
+    // serialization should return true, so that threads adding entries don't
+    // contend on a lock. Must not change while observing a NetLog. The default
+    // implementation returns false.
+    virtual bool AcceptsConcurrentEntries() const;
+
    protected:
     virtual ~ThreadSafeObserver();
 
    private:
     friend class NetLog;
 
-    void OnAddEntryData(const EntryData& entry_data);
+    void OnAddEntryData(const EntryData& entry_data,
+                        NetLogCaptureMode capture_mode);
 
     // Both of these values are only modified by the NetLog.
     NetLogCaptureMode capture_mode_;
@@ -298,18 +314,27 @@ class NET_EXPORT NetLog {
  private:
   friend class BoundNetLog;
 
+  // An immutable copy of |observers_| and their capture modes.
+  struct ObserverSnapshot;
+
   void AddEntry(EventType type,
                 const Source& source,
                 EventPhase phase,
                 const NetLog::ParametersCallback* parameters_callback);
 
-  // Called whenever an observer is added or removed, to update
-  // |has_observers_|. Must have acquired |lock_| prior to calling.
-  void UpdateIsCapturing();
+  // Called whenever an observer is added or removed, or its capture mode
+  // changes, to publish a new ObserverSnapshot and update |is_capturing_|.
+  // Returns once no thread dispatches entries to the previous snapshot. Must
+  // have acquired |lock_| prior to calling.
+  void UpdateObservers();
 
-  // |lock_| protects access to |observers_|.
+  // |lock_| protects access to |observers_| and |retired_snapshots_|.
   base::Lock lock_;
 
+  // Held while dispatching an entry to observers that don't accept concurrent
+  // entries.
+  base::Lock dispatch_lock_;
+
   // Last assigned source ID.  Incremented to get the next one.
   base::subtle::Atomic32 last_id_;
 
@@ -321,6 +346,14 @@ class NET_EXPORT NetLog {
   // |lock_| must be acquired whenever reading or writing to this.
   base::ObserverList<ThreadSafeObserver, true> observers_;
 
+  // The current ObserverSnapshot, which AddEntry() reads without a lock.
+  base::subtle::AtomicWord snapshot_;
+
+  // Snapshots that were replaced. Threads adding entries may still be about to
+  // look at them, so they are only deleted along with the NetLog. Observers
+  // change rarely, so they don't add up to much.
+  std::vector<std::unique_ptr<ObserverSnapshot>> retired_snapshots_;
+
   DISALLOW_COPY_AND_ASSIGN(NetLog);
 };
 
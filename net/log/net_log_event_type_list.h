@@ -746,6 +746,41 @@ EVENT_TYPE(CONNECT_JOB_SET_SOCKET)
 // Whether the connect job timed out.
 EVENT_TYPE(SOCKET_POOL_CONNECT_JOB_TIMED_OUT)
 
+// ------------------------------------------------------------------------
+// TransportConnectJob
+// ------------------------------------------------------------------------
+
+// This event is logged when connects to the resolved IPv6 and IPv4 addresses
+// are raced against each other. It has these parameters:
+//
+//   {
+//     "address_count": <The number of addresses to connect to>,
+//     "attempt_delay_ms": <How long each attempt gets before the next one is
+//                          started>,
+//     "has_transport_rtt": <Whether the delay is based on the transport RTT
+//                           of the network>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_RACE)
+
+// This event is logged when a connect attempt is started. It has these
+// parameters:
+//
+//   {
+//     "attempt": <The index of the attempt in the job>,
+//     "address_list": <The addresses the attempt connects to, in turn>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_ATTEMPT)
+
+// This event is logged when a connect attempt completes. It has these
+// parameters:
+//
+//   {
+//     "attempt": <The index of the attempt in the job>,
+//     "net_error": <The result of the attempt>,
+//     "duration_ms": <How long the attempt took>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_ATTEMPT_COMPLETE)
+
 // ------------------------------------------------------------------------
 // ClientSocketPoolBaseHelper
 // ------------------------------------------------------------------------
@@ -4,12 +4,16 @@
 
 #include "net/log/net_log.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/simple_thread.h"
 #include "base/values.h"
 #include "net/base/net_errors.h"
@@ -123,6 +127,29 @@ class CountingObserver : public NetLog::ThreadSafeObserver {
   int count_;
 };
 
+// A CountingObserver whose OnAddEntry() may be called on several threads at
+// once.
+class ConcurrentCountingObserver : public NetLog::ThreadSafeObserver {
+ public:
+  ConcurrentCountingObserver() : count_(0) {}
+
+  ~ConcurrentCountingObserver() override {
+    if (net_log())
+      net_log()->DeprecatedRemoveObserver(this);
+  }
+
+  void OnAddEntry(const NetLog::Entry& entry) override {
+    base::subtle::NoBarrier_AtomicIncrement(&count_, 1);
+  }
+
+  bool AcceptsConcurrentEntries() const override { return true; }
+
+  int count() const { return base::subtle::NoBarrier_Load(&count_); }
+
+ private:
+  base::subtle::Atomic32 count_;
+};
+
 class LoggingObserver : public NetLog::ThreadSafeObserver {
  public:
   LoggingObserver() {}
@@ -278,6 +305,27 @@ TEST(NetLogTest, NetLogEventThreads) {
     EXPECT_EQ(kTotalEvents, observers[i].count());
 }
 
+// Makes sure that events on multiple threads are dispatched to observers that
+// accept concurrent entries, along with those that don't.
+TEST(NetLogTest, NetLogEventThreadsConcurrentObservers) {
+  NetLog net_log;
+
+  ConcurrentCountingObserver concurrent_observers[2];
+  CountingObserver observer;
+  for (size_t i = 0; i < arraysize(concurrent_observers); ++i) {
+    net_log.DeprecatedAddObserver(&concurrent_observers[i],
+                                  NetLogCaptureMode::Default());
+  }
+  net_log.DeprecatedAddObserver(&observer, NetLogCaptureMode::Default());
+
+  RunTestThreads<AddEventsTestThread>(&net_log);
+
+  const int kTotalEvents = kThreads * kEvents;
+  for (size_t i = 0; i < arraysize(concurrent_observers); ++i)
+    EXPECT_EQ(kTotalEvents, concurrent_observers[i].count());
+  EXPECT_EQ(kTotalEvents, observer.count());
+}
+
 // Test adding and removing a single observer.
 TEST(NetLogTest, NetLogAddRemoveObserver) {
   NetLog net_log;
@@ -400,6 +448,50 @@ TEST(NetLogTest, NetLogAddRemoveObserverThreads) {
   RunTestThreads<AddRemoveObserverTestThread>(&net_log);
 }
 
+// A thread that adds events until told to stop.
+class AddEventsUntilStoppedThread : public base::SimpleThread {
+ public:
+  AddEventsUntilStoppedThread(NetLog* net_log, base::subtle::Atomic32* stop)
+      : base::SimpleThread("NetLogTest"), net_log_(net_log), stop_(stop) {}
+
+  void Run() override {
+    while (!base::subtle::Acquire_Load(stop_))
+      AddEvent(net_log_);
+  }
+
+ private:
+  NetLog* const net_log_;
+  base::subtle::Atomic32* const stop_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddEventsUntilStoppedThread);
+};
+
+// Makes sure that an observer that accepts concurrent entries isn't called
+// anymore once it has been removed, while other threads add events.
+TEST(NetLogTest, NetLogRemoveConcurrentObserverWhileAddingEvents) {
+  NetLog net_log;
+  base::subtle::Atomic32 stop = 0;
+  std::vector<std::unique_ptr<AddEventsUntilStoppedThread>> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.push_back(
+        base::WrapUnique(new AddEventsUntilStoppedThread(&net_log, &stop)));
+    threads.back()->Start();
+  }
+
+  for (int i = 0; i < kEvents; ++i) {
+    ConcurrentCountingObserver observer;
+    net_log.DeprecatedAddObserver(&observer, NetLogCaptureMode::Default());
+    net_log.DeprecatedRemoveObserver(&observer);
+    int count = observer.count();
+    base::PlatformThread::YieldCurrentThread();
+    EXPECT_EQ(count, observer.count());
+  }
+
+  base::subtle::Release_Store(&stop, 1);
+  for (const auto& thread : threads)
+    thread->Join();
+}
+
 }  // namespace
 
 }  // namespace net
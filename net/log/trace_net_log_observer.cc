@@ -56,6 +56,13 @@ TraceNetLogObserver::~TraceNetLogObserver() {
 }
 
 void TraceNetLogObserver::OnAddEntry(const NetLog::Entry& entry) {
+  // Tracing may be enabled for other categories only, in which case the
+  // parameters are not worth building.
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(kNetLogTracingCategory, &enabled);
+  if (!enabled)
+    return;
+
   std::unique_ptr<base::Value> params(entry.ParametersToValue());
   switch (entry.phase()) {
     case NetLog::PHASE_BEGIN:
@@ -85,6 +92,11 @@ void TraceNetLogObserver::OnAddEntry(const NetLog::Entry& entry) {
   }
 }
 
+bool TraceNetLogObserver::AcceptsConcurrentEntries() const {
+  // TraceLog does its own synchronization.
+  return true;
+}
+
 void TraceNetLogObserver::WatchForTraceStart(NetLog* netlog) {
   DCHECK(!net_log_to_watch_);
   DCHECK(!net_log());
@@ -23,6 +23,7 @@ class NET_EXPORT TraceNetLogObserver
 
   // net::NetLog::ThreadSafeObserver implementation:
   void OnAddEntry(const NetLog::Entry& entry) override;
+  bool AcceptsConcurrentEntries() const override;
 
   // Start to watch for TraceLog enable and disable events.
   // This can't be called if already watching for events.
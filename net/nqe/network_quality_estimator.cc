@@ -273,6 +273,8 @@ NetworkQualityEstimator::NetworkQualityEstimator(
   watcher_factory_.reset(new nqe::internal::SocketWatcherFactory(
       base::ThreadTaskRunnerHandle::Get(),
       base::Bind(&NetworkQualityEstimator::OnUpdatedRTTAvailable,
+                 base::Unretained(this)),
+      base::Bind(&NetworkQualityEstimator::GetTransportRTTEstimate,
                  base::Unretained(this))));
 
   // Record accuracy at 3 different intervals. The values used here must remain
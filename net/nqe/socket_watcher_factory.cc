@@ -4,6 +4,7 @@
 
 #include "net/nqe/socket_watcher_factory.h"
 
+#include "base/single_thread_task_runner.h"
 #include "base/time/time.h"
 #include "net/nqe/socket_watcher.h"
 
@@ -15,9 +16,11 @@ namespace internal {
 
 SocketWatcherFactory::SocketWatcherFactory(
     scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-    OnUpdatedRTTAvailableCallback updated_rtt_observation_callback)
+    OnUpdatedRTTAvailableCallback updated_rtt_observation_callback,
+    GetTransportRTTCallback get_transport_rtt_callback)
     : task_runner_(std::move(task_runner)),
-      updated_rtt_observation_callback_(updated_rtt_observation_callback) {}
+      updated_rtt_observation_callback_(updated_rtt_observation_callback),
+      get_transport_rtt_callback_(get_transport_rtt_callback) {}
 
 SocketWatcherFactory::~SocketWatcherFactory() {}
 
@@ -27,6 +30,13 @@ SocketWatcherFactory::CreateSocketPerformanceWatcher(const Protocol protocol) {
       protocol, task_runner_, updated_rtt_observation_callback_));
 }
 
+bool SocketWatcherFactory::GetTransportRTTEstimate(base::TimeDelta* rtt) const {
+  // The estimator may only be queried on its own thread.
+  if (!task_runner_->BelongsToCurrentThread())
+    return false;
+  return get_transport_rtt_callback_.Run(rtt);
+}
+
 }  // namespace internal
 
 }  // namespace nqe
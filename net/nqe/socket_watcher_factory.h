@@ -25,6 +25,8 @@ namespace {
 typedef base::Callback<void(SocketPerformanceWatcherFactory::Protocol protocol,
                             const base::TimeDelta& rtt)>
     OnUpdatedRTTAvailableCallback;
+
+typedef base::Callback<bool(base::TimeDelta* rtt)> GetTransportRTTCallback;
 }
 
 namespace nqe {
@@ -38,15 +40,19 @@ class SocketWatcherFactory : public SocketPerformanceWatcherFactory {
   // Creates a SocketWatcherFactory.  All socket watchers created by
   // SocketWatcherFactory call |updated_rtt_observation_callback| on
   // |task_runner| every time a new RTT observation is available.
+  // |get_transport_rtt_callback| provides the transport RTT estimate, and is
+  // only called on |task_runner|.
   SocketWatcherFactory(
       scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-      OnUpdatedRTTAvailableCallback updated_rtt_observation_callback);
+      OnUpdatedRTTAvailableCallback updated_rtt_observation_callback,
+      GetTransportRTTCallback get_transport_rtt_callback);
 
   ~SocketWatcherFactory() override;
 
   // SocketPerformanceWatcherFactory implementation:
   std::unique_ptr<SocketPerformanceWatcher> CreateSocketPerformanceWatcher(
       const Protocol protocol) override;
+  bool GetTransportRTTEstimate(base::TimeDelta* rtt) const override;
 
  private:
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
@@ -54,6 +60,8 @@ class SocketWatcherFactory : public SocketPerformanceWatcherFactory {
   // Called every time a new RTT observation is available.
   OnUpdatedRTTAvailableCallback updated_rtt_observation_callback_;
 
+  GetTransportRTTCallback get_transport_rtt_callback_;
+
   DISALLOW_COPY_AND_ASSIGN(SocketWatcherFactory);
 };
 
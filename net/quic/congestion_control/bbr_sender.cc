@@ -0,0 +1,393 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "net/quic/congestion_control/rtt_stats.h"
+#include "net/quic/quic_clock.h"
+
+using std::max;
+using std::min;
+
+namespace net {
+
+namespace {
+// The gain used in STARTUP, 2/ln(2), which is the smallest gain that lets the
+// sending rate double every round trip.
+const float kHighGain = 2.885f;
+// The gain used in DRAIN to drain the queue built during STARTUP in one round.
+const float kDrainGain = 1.f / kHighGain;
+// The pacing gains of the PROBE_BW phases. Each phase lasts one min RTT.
+const float kPacingGain[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+const int kGainCycleLength = arraysize(kPacingGain);
+// The congestion window gain in PROBE_BW, leaving room for delayed and
+// stretched acks.
+const float kProbeBandwidthCongestionWindowGain = 2.f;
+// STARTUP ends when the bandwidth estimate has grown by less than 25% for
+// three consecutive round trips.
+const float kStartupGrowthTarget = 1.25f;
+const uint64_t kRoundTripsWithoutGrowthBeforeExitingStartup = 3;
+// The minimum congestion window, which is also the window in PROBE_RTT.
+const QuicByteCount kMinimumCongestionWindow = 4 * kDefaultTCPMSS;
+// How long the min RTT is trusted before PROBE_RTT measures it again, and how
+// long PROBE_RTT holds the window at its minimum.
+const int64_t kMinRttExpirySeconds = 10;
+const int64_t kProbeRttTimeMs = 200;
+}  // namespace
+
+BbrSender::BbrSender(const QuicClock* clock,
+                     const RttStats* rtt_stats,
+                     QuicPacketCount initial_tcp_congestion_window,
+                     QuicPacketCount max_tcp_congestion_window)
+    : clock_(clock),
+      rtt_stats_(rtt_stats),
+      mode_(STARTUP),
+      total_bytes_acked_(0),
+      last_acked_sent_time_(QuicTime::Zero()),
+      last_acked_ack_time_(QuicTime::Zero()),
+      last_sent_packet_(0),
+      round_trip_count_(0),
+      current_round_trip_end_(0),
+      min_rtt_(QuicTime::Delta::Zero()),
+      min_rtt_timestamp_(QuicTime::Zero()),
+      initial_congestion_window_(initial_tcp_congestion_window *
+                                 kDefaultTCPMSS),
+      max_congestion_window_(max_tcp_congestion_window * kDefaultTCPMSS),
+      pacing_gain_(kHighGain),
+      congestion_window_gain_(kHighGain),
+      cycle_current_offset_(0),
+      last_cycle_start_(QuicTime::Zero()),
+      is_at_full_bandwidth_(false),
+      rounds_without_bandwidth_gain_(0),
+      bandwidth_at_last_round_(QuicBandwidth::Zero()),
+      exit_probe_rtt_at_(QuicTime::Zero()),
+      probe_rtt_round_(0) {}
+
+BbrSender::~BbrSender() {}
+
+void BbrSender::SetFromConfig(const QuicConfig& config,
+                              Perspective perspective) {}
+
+void BbrSender::ResumeConnectionState(
+    const CachedNetworkParameters& cached_network_params,
+    bool max_bandwidth_resumption) {
+  // Resumption is not yet supported; STARTUP finds the bandwidth within a few
+  // round trips.
+}
+
+void BbrSender::SetNumEmulatedConnections(int num_connections) {}
+
+void BbrSender::SetMaxCongestionWindow(QuicByteCount max_congestion_window) {
+  max_congestion_window_ = max_congestion_window;
+}
+
+bool BbrSender::OnPacketSent(QuicTime sent_time,
+                             QuicByteCount bytes_in_flight,
+                             QuicPacketNumber packet_number,
+                             QuicByteCount bytes,
+                             HasRetransmittableData is_retransmittable) {
+  last_sent_packet_ = packet_number;
+  if (is_retransmittable != HAS_RETRANSMITTABLE_DATA) {
+    return false;
+  }
+
+  // After an idle period, measure delivery rates from the start of the new
+  // flight rather than from the last ack.
+  if (bytes_in_flight == 0) {
+    last_acked_sent_time_ = sent_time;
+    last_acked_ack_time_ = sent_time;
+  }
+
+  SendState state = {sent_time, bytes, total_bytes_acked_,
+                     last_acked_sent_time_, last_acked_ack_time_};
+  sent_packets_.insert(std::make_pair(packet_number, state));
+  return true;
+}
+
+void BbrSender::OnCongestionEvent(bool rtt_updated,
+                                  QuicByteCount prior_in_flight,
+                                  const CongestionVector& acked_packets,
+                                  const CongestionVector& lost_packets) {
+  const QuicTime now = clock_->ApproximateNow();
+  QuicByteCount bytes_in_flight = prior_in_flight;
+
+  for (const auto& lost_packet : lost_packets) {
+    sent_packets_.erase(lost_packet.first);
+    bytes_in_flight -= min<QuicByteCount>(bytes_in_flight, lost_packet.second);
+  }
+
+  bool is_round_start = false;
+  for (const auto& acked_packet : acked_packets) {
+    if (acked_packet.first > current_round_trip_end_) {
+      ++round_trip_count_;
+      current_round_trip_end_ = last_sent_packet_;
+      is_round_start = true;
+    }
+    UpdateMaxBandwidth(
+        OnPacketAcked(now, acked_packet.first, acked_packet.second));
+    bytes_in_flight -= min<QuicByteCount>(bytes_in_flight, acked_packet.second);
+  }
+
+  bool min_rtt_expired = false;
+  if (rtt_updated && !rtt_stats_->latest_rtt().IsZero()) {
+    min_rtt_expired =
+        !min_rtt_.IsZero() &&
+        now > min_rtt_timestamp_.Add(
+                  QuicTime::Delta::FromSeconds(kMinRttExpirySeconds));
+    if (min_rtt_expired || min_rtt_.IsZero() ||
+        rtt_stats_->latest_rtt() <= min_rtt_) {
+      min_rtt_ = rtt_stats_->latest_rtt();
+      min_rtt_timestamp_ = now;
+    }
+  }
+
+  if (mode_ == PROBE_BW) {
+    UpdateGainCyclePhase(now, prior_in_flight);
+  }
+  if (is_round_start && !is_at_full_bandwidth_) {
+    CheckIfFullBandwidthReached();
+  }
+  MaybeExitStartupOrDrain(now, bytes_in_flight);
+  MaybeEnterOrExitProbeRtt(now, min_rtt_expired, bytes_in_flight);
+}
+
+void BbrSender::OnRetransmissionTimeout(bool packets_retransmitted) {
+  if (packets_retransmitted) {
+    // Every packet in flight has been retransmitted and will never be acked.
+    sent_packets_.clear();
+  }
+}
+
+void BbrSender::OnConnectionMigration() {
+  sent_packets_.clear();
+  for (BandwidthSample& sample : max_bandwidth_) {
+    sample.bandwidth = QuicBandwidth::Zero();
+  }
+  min_rtt_ = QuicTime::Delta::Zero();
+  min_rtt_timestamp_ = QuicTime::Zero();
+  is_at_full_bandwidth_ = false;
+  rounds_without_bandwidth_gain_ = 0;
+  bandwidth_at_last_round_ = QuicBandwidth::Zero();
+  EnterStartupMode();
+}
+
+QuicTime::Delta BbrSender::TimeUntilSend(QuicTime /* now */,
+                                         QuicByteCount bytes_in_flight) const {
+  // The pacing sender spaces out the packets; only the window limits sending.
+  if (bytes_in_flight < GetCongestionWindow()) {
+    return QuicTime::Delta::Zero();
+  }
+  return QuicTime::Delta::Infinite();
+}
+
+QuicBandwidth BbrSender::PacingRate(QuicByteCount bytes_in_flight) const {
+  QuicBandwidth bandwidth = MaxBandwidth();
+  if (bandwidth.IsZero()) {
+    QuicTime::Delta rtt =
+        min_rtt_.IsZero()
+            ? QuicTime::Delta::FromMicroseconds(rtt_stats_->initial_rtt_us())
+            : min_rtt_;
+    bandwidth =
+        QuicBandwidth::FromBytesAndTimeDelta(initial_congestion_window_, rtt);
+  }
+  return bandwidth.Scale(pacing_gain_);
+}
+
+QuicBandwidth BbrSender::BandwidthEstimate() const {
+  return MaxBandwidth();
+}
+
+QuicTime::Delta BbrSender::RetransmissionDelay() const {
+  if (rtt_stats_->smoothed_rtt().IsZero()) {
+    return QuicTime::Delta::Zero();
+  }
+  return rtt_stats_->smoothed_rtt().Add(
+      rtt_stats_->mean_deviation().Multiply(4));
+}
+
+QuicByteCount BbrSender::GetCongestionWindow() const {
+  if (mode_ == PROBE_RTT) {
+    return kMinimumCongestionWindow;
+  }
+  QuicByteCount congestion_window =
+      GetTargetCongestionWindow(congestion_window_gain_);
+  // Don't let early, low bandwidth samples shrink the window during STARTUP.
+  if (!is_at_full_bandwidth_) {
+    congestion_window = max(congestion_window, initial_congestion_window_);
+  }
+  return min(max_congestion_window_,
+             max(congestion_window, kMinimumCongestionWindow));
+}
+
+bool BbrSender::InSlowStart() const {
+  return mode_ == STARTUP;
+}
+
+bool BbrSender::InRecovery() const {
+  return false;
+}
+
+QuicByteCount BbrSender::GetSlowStartThreshold() const {
+  return 0;
+}
+
+CongestionControlType BbrSender::GetCongestionControlType() const {
+  return kBBR;
+}
+
+QuicBandwidth BbrSender::OnPacketAcked(QuicTime ack_time,
+                                       QuicPacketNumber packet_number,
+                                       QuicByteCount bytes) {
+  auto it = sent_packets_.find(packet_number);
+  if (it == sent_packets_.end()) {
+    return QuicBandwidth::Zero();
+  }
+  const SendState state = it->second;
+  sent_packets_.erase(it);
+
+  total_bytes_acked_ += bytes;
+  last_acked_sent_time_ = state.sent_time;
+  last_acked_ack_time_ = ack_time;
+
+  // The delivery rate is the bytes acked since the packet was sent, over the
+  // longer of the send and ack intervals. Using the longer one keeps ack
+  // compression from inflating the estimate.
+  QuicTime::Delta interval = QuicTime::Delta::Max(
+      state.sent_time.Subtract(state.last_acked_sent_time),
+      ack_time.Subtract(state.last_acked_ack_time));
+  if (interval <= QuicTime::Delta::Zero()) {
+    return QuicBandwidth::Zero();
+  }
+  return QuicBandwidth::FromBytesAndTimeDelta(
+      total_bytes_acked_ - state.total_bytes_acked, interval);
+}
+
+void BbrSender::UpdateMaxBandwidth(QuicBandwidth sample) {
+  BandwidthSample& current =
+      max_bandwidth_[round_trip_count_ % kBandwidthWindowSize];
+  if (current.round_trip != round_trip_count_) {
+    current.round_trip = round_trip_count_;
+    current.bandwidth = sample;
+    return;
+  }
+  current.bandwidth = max(current.bandwidth, sample);
+}
+
+QuicBandwidth BbrSender::MaxBandwidth() const {
+  QuicBandwidth bandwidth = QuicBandwidth::Zero();
+  for (const BandwidthSample& sample : max_bandwidth_) {
+    if (round_trip_count_ - sample.round_trip < kBandwidthWindowSize) {
+      bandwidth = max(bandwidth, sample.bandwidth);
+    }
+  }
+  return bandwidth;
+}
+
+QuicByteCount BbrSender::GetTargetCongestionWindow(float gain) const {
+  if (min_rtt_.IsZero()) {
+    return 0;
+  }
+  return MaxBandwidth().Scale(gain).ToBytesPerPeriod(min_rtt_);
+}
+
+void BbrSender::EnterStartupMode() {
+  mode_ = STARTUP;
+  pacing_gain_ = kHighGain;
+  congestion_window_gain_ = kHighGain;
+}
+
+void BbrSender::EnterProbeBandwidthMode(QuicTime now) {
+  mode_ = PROBE_BW;
+  congestion_window_gain_ = kProbeBandwidthCongestionWindowGain;
+  // Start in a steady phase, since DRAIN has just emptied the queue and a
+  // probe right away would rebuild it.
+  cycle_current_offset_ = 2;
+  last_cycle_start_ = now;
+  pacing_gain_ = kPacingGain[cycle_current_offset_];
+}
+
+void BbrSender::CheckIfFullBandwidthReached() {
+  QuicBandwidth target = bandwidth_at_last_round_.Scale(kStartupGrowthTarget);
+  QuicBandwidth bandwidth = MaxBandwidth();
+  if (bandwidth.IsZero()) {
+    return;
+  }
+  if (bandwidth >= target) {
+    bandwidth_at_last_round_ = bandwidth;
+    rounds_without_bandwidth_gain_ = 0;
+    return;
+  }
+  if (++rounds_without_bandwidth_gain_ >=
+      kRoundTripsWithoutGrowthBeforeExitingStartup) {
+    is_at_full_bandwidth_ = true;
+  }
+}
+
+void BbrSender::UpdateGainCyclePhase(QuicTime now,
+                                     QuicByteCount prior_in_flight) {
+  bool should_advance = now.Subtract(last_cycle_start_) > min_rtt_;
+  // Keep probing until the extra bytes have actually been put in flight.
+  if (pacing_gain_ > 1 &&
+      prior_in_flight < GetTargetCongestionWindow(pacing_gain_)) {
+    should_advance = false;
+  }
+  // Stop draining early once the queue is gone.
+  if (pacing_gain_ < 1 && prior_in_flight <= GetTargetCongestionWindow(1)) {
+    should_advance = true;
+  }
+  if (should_advance) {
+    cycle_current_offset_ = (cycle_current_offset_ + 1) % kGainCycleLength;
+    last_cycle_start_ = now;
+    pacing_gain_ = kPacingGain[cycle_current_offset_];
+  }
+}
+
+void BbrSender::MaybeExitStartupOrDrain(QuicTime now,
+                                        QuicByteCount bytes_in_flight) {
+  if (mode_ == STARTUP && is_at_full_bandwidth_) {
+    mode_ = DRAIN;
+    pacing_gain_ = kDrainGain;
+    congestion_window_gain_ = kHighGain;
+  }
+  if (mode_ == DRAIN && bytes_in_flight <= GetTargetCongestionWindow(1)) {
+    EnterProbeBandwidthMode(now);
+  }
+}
+
+void BbrSender::MaybeEnterOrExitProbeRtt(QuicTime now,
+                                         bool min_rtt_expired,
+                                         QuicByteCount bytes_in_flight) {
+  if (min_rtt_expired && mode_ != PROBE_RTT) {
+    mode_ = PROBE_RTT;
+    pacing_gain_ = 1;
+    exit_probe_rtt_at_ = QuicTime::Zero();
+  }
+  if (mode_ != PROBE_RTT) {
+    return;
+  }
+
+  // Once in flight has dropped to the minimum window, stay there for
+  // kProbeRttTimeMs and at least one round trip.
+  if (!exit_probe_rtt_at_.IsInitialized()) {
+    if (bytes_in_flight <= kMinimumCongestionWindow) {
+      exit_probe_rtt_at_ =
+          now.Add(QuicTime::Delta::FromMilliseconds(kProbeRttTimeMs));
+      probe_rtt_round_ = round_trip_count_;
+    }
+    return;
+  }
+  if (round_trip_count_ > probe_rtt_round_ && now >= exit_probe_rtt_at_) {
+    min_rtt_timestamp_ = now;
+    if (is_at_full_bandwidth_) {
+      EnterProbeBandwidthMode(now);
+    } else {
+      EnterStartupMode();
+    }
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,184 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A send algorithm in the style of BBR (Bottleneck Bandwidth and Round-trip
+// propagation time). Rather than reacting to loss, it estimates the bottleneck
+// bandwidth from the rate at which packets are acked and the propagation delay
+// from the minimum RTT, and paces at the bandwidth while keeping about one
+// bandwidth-delay product in flight. This keeps the bottleneck queue short on
+// links with deep buffers, such as cellular links.
+//
+// The sender cycles through the following modes:
+//  - STARTUP doubles the sending rate every round trip until the bandwidth
+//    estimate stops growing.
+//  - DRAIN paces below the bandwidth estimate until the queue built during
+//    STARTUP is gone.
+//  - PROBE_BW paces at the bandwidth estimate, briefly probing above it and
+//    then draining below it once every few round trips.
+//  - PROBE_RTT shrinks the congestion window for a short while when the min
+//    RTT hasn't been observed for some time, so that it can be measured again.
+
+#ifndef NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+#define NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+
+#include "base/macros.h"
+#include "net/base/net_export.h"
+#include "net/quic/congestion_control/send_algorithm_interface.h"
+#include "net/quic/quic_bandwidth.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/quic_time.h"
+
+namespace net {
+
+class RttStats;
+
+class NET_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
+ public:
+  enum Mode {
+    STARTUP,
+    DRAIN,
+    PROBE_BW,
+    PROBE_RTT,
+  };
+
+  BbrSender(const QuicClock* clock,
+            const RttStats* rtt_stats,
+            QuicPacketCount initial_tcp_congestion_window,
+            QuicPacketCount max_tcp_congestion_window);
+  ~BbrSender() override;
+
+  // SendAlgorithmInterface methods.
+  void SetFromConfig(const QuicConfig& config,
+                     Perspective perspective) override;
+  void ResumeConnectionState(
+      const CachedNetworkParameters& cached_network_params,
+      bool max_bandwidth_resumption) override;
+  void SetNumEmulatedConnections(int num_connections) override;
+  void SetMaxCongestionWindow(QuicByteCount max_congestion_window) override;
+  void OnCongestionEvent(bool rtt_updated,
+                         QuicByteCount bytes_in_flight,
+                         const CongestionVector& acked_packets,
+                         const CongestionVector& lost_packets) override;
+  bool OnPacketSent(QuicTime sent_time,
+                    QuicByteCount bytes_in_flight,
+                    QuicPacketNumber packet_number,
+                    QuicByteCount bytes,
+                    HasRetransmittableData is_retransmittable) override;
+  void OnRetransmissionTimeout(bool packets_retransmitted) override;
+  void OnConnectionMigration() override;
+  QuicTime::Delta TimeUntilSend(QuicTime now,
+                                QuicByteCount bytes_in_flight) const override;
+  QuicBandwidth PacingRate(QuicByteCount bytes_in_flight) const override;
+  QuicBandwidth BandwidthEstimate() const override;
+  QuicTime::Delta RetransmissionDelay() const override;
+  QuicByteCount GetCongestionWindow() const override;
+  bool InSlowStart() const override;
+  bool InRecovery() const override;
+  QuicByteCount GetSlowStartThreshold() const override;
+  CongestionControlType GetCongestionControlType() const override;
+  // End implementation of SendAlgorithmInterface.
+
+  Mode mode() const { return mode_; }
+  QuicTime::Delta min_rtt() const { return min_rtt_; }
+
+ private:
+  // What the sender knew when a packet was sent, used to measure the delivery
+  // rate once the packet is acked.
+  struct SendState {
+    QuicTime sent_time;
+    QuicByteCount bytes;
+    // The total bytes acked so far, and the send and ack times of the most
+    // recently acked packet.
+    QuicByteCount total_bytes_acked;
+    QuicTime last_acked_sent_time;
+    QuicTime last_acked_ack_time;
+  };
+
+  // The highest delivery rate measured in a round trip.
+  struct BandwidthSample {
+    BandwidthSample() : round_trip(0), bandwidth(QuicBandwidth::Zero()) {}
+
+    uint64_t round_trip;
+    QuicBandwidth bandwidth;
+  };
+
+  // The number of round trips over which the max bandwidth is kept.
+  static const size_t kBandwidthWindowSize = 10;
+
+  // Measures the delivery rate of the packet acked at |ack_time|. Returns
+  // zero if it can't be measured.
+  QuicBandwidth OnPacketAcked(QuicTime ack_time,
+                              QuicPacketNumber packet_number,
+                              QuicByteCount bytes);
+  void UpdateMaxBandwidth(QuicBandwidth sample);
+  QuicBandwidth MaxBandwidth() const;
+
+  // Returns the bandwidth-delay product scaled by |gain|, or zero if there is
+  // no estimate yet.
+  QuicByteCount GetTargetCongestionWindow(float gain) const;
+
+  void EnterStartupMode();
+  void EnterProbeBandwidthMode(QuicTime now);
+  void CheckIfFullBandwidthReached();
+  void UpdateGainCyclePhase(QuicTime now, QuicByteCount prior_in_flight);
+  void MaybeExitStartupOrDrain(QuicTime now, QuicByteCount bytes_in_flight);
+  void MaybeEnterOrExitProbeRtt(QuicTime now,
+                                bool min_rtt_expired,
+                                QuicByteCount bytes_in_flight);
+
+  const QuicClock* clock_;
+  const RttStats* rtt_stats_;
+
+  Mode mode_;
+
+  std::map<QuicPacketNumber, SendState> sent_packets_;
+  QuicByteCount total_bytes_acked_;
+  QuicTime last_acked_sent_time_;
+  QuicTime last_acked_ack_time_;
+  QuicPacketNumber last_sent_packet_;
+
+  // Round trips are counted by the acks of packets sent after the previous
+  // round trip ended.
+  uint64_t round_trip_count_;
+  QuicPacketNumber current_round_trip_end_;
+
+  BandwidthSample max_bandwidth_[kBandwidthWindowSize];
+
+  // The minimum RTT and when it was last measured.
+  QuicTime::Delta min_rtt_;
+  QuicTime min_rtt_timestamp_;
+
+  const QuicByteCount initial_congestion_window_;
+  QuicByteCount max_congestion_window_;
+
+  float pacing_gain_;
+  float congestion_window_gain_;
+
+  // The PROBE_BW gain cycle phase, and when it started.
+  int cycle_current_offset_;
+  QuicTime last_cycle_start_;
+
+  // Whether STARTUP found the bottleneck bandwidth, measured as the bandwidth
+  // estimate failing to grow by much over several round trips.
+  bool is_at_full_bandwidth_;
+  uint64_t rounds_without_bandwidth_gain_;
+  QuicBandwidth bandwidth_at_last_round_;
+
+  // When PROBE_RTT may end, or zero until bytes in flight have dropped to the
+  // PROBE_RTT congestion window.
+  QuicTime exit_probe_rtt_at_;
+  // The round trip in which bytes in flight dropped during PROBE_RTT.
+  uint64_t probe_rtt_round_;
+
+  DISALLOW_COPY_AND_ASSIGN(BbrSender);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
@@ -0,0 +1,175 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <deque>
+#include <memory>
+
+#include "net/quic/congestion_control/rtt_stats.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const uint32_t kInitialCongestionWindowPackets = 10;
+const uint32_t kMaxCongestionWindowPackets = 1000;
+
+class BbrSenderPeer : public BbrSender {
+ public:
+  explicit BbrSenderPeer(const QuicClock* clock)
+      : BbrSender(clock,
+                  &rtt_stats_,
+                  kInitialCongestionWindowPackets,
+                  kMaxCongestionWindowPackets) {}
+
+  RttStats rtt_stats_;
+};
+
+// Sends through a single bottleneck link with a fixed bandwidth and
+// propagation delay, pacing at the sender's pacing rate.
+class BbrSenderTest : public ::testing::Test {
+ protected:
+  struct InFlightPacket {
+    QuicPacketNumber packet_number;
+    QuicTime sent_time;
+    QuicTime ack_time;
+  };
+
+  BbrSenderTest()
+      : bandwidth_(QuicBandwidth::FromKBitsPerSecond(10000)),
+        propagation_delay_(QuicTime::Delta::FromMilliseconds(100)),
+        sender_(new BbrSenderPeer(&clock_)),
+        packet_number_(1),
+        bytes_in_flight_(0),
+        next_send_time_(QuicTime::Zero()),
+        link_free_time_(QuicTime::Zero()) {
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+  }
+
+  // Runs the connection for |duration| in one millisecond steps.
+  void RunFor(QuicTime::Delta duration) {
+    QuicTime end_time = clock_.Now().Add(duration);
+    while (clock_.Now() < end_time) {
+      AckArrivedPackets();
+      SendPackets();
+      clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+    }
+  }
+
+  void SendPackets() {
+    while (next_send_time_ <= clock_.Now() &&
+           sender_->TimeUntilSend(clock_.Now(), bytes_in_flight_).IsZero()) {
+      QuicTime now = clock_.Now();
+      sender_->OnPacketSent(now, bytes_in_flight_, packet_number_,
+                            kDefaultTCPMSS, HAS_RETRANSMITTABLE_DATA);
+      bytes_in_flight_ += kDefaultTCPMSS;
+
+      link_free_time_ = QuicTime::Max(link_free_time_, now).Add(
+          bandwidth_.TransferTime(kDefaultTCPMSS));
+      in_flight_.push_back(
+          {packet_number_, now, link_free_time_.Add(propagation_delay_)});
+      ++packet_number_;
+
+      next_send_time_ =
+          QuicTime::Max(next_send_time_, now)
+              .Add(sender_->PacingRate(bytes_in_flight_)
+                       .TransferTime(kDefaultTCPMSS));
+    }
+  }
+
+  void AckArrivedPackets() {
+    SendAlgorithmInterface::CongestionVector acked_packets;
+    SendAlgorithmInterface::CongestionVector lost_packets;
+    QuicTime now = clock_.Now();
+    while (!in_flight_.empty() && in_flight_.front().ack_time <= now) {
+      acked_packets.push_back(
+          std::make_pair(in_flight_.front().packet_number, kDefaultTCPMSS));
+      sender_->rtt_stats_.UpdateRtt(
+          now.Subtract(in_flight_.front().sent_time), QuicTime::Delta::Zero(),
+          now);
+      in_flight_.pop_front();
+    }
+    if (acked_packets.empty()) {
+      return;
+    }
+    sender_->OnCongestionEvent(true, bytes_in_flight_, acked_packets,
+                               lost_packets);
+    bytes_in_flight_ -= acked_packets.size() * kDefaultTCPMSS;
+  }
+
+  QuicByteCount BandwidthDelayProduct() const {
+    return bandwidth_.ToBytesPerPeriod(propagation_delay_);
+  }
+
+  const QuicBandwidth bandwidth_;
+  const QuicTime::Delta propagation_delay_;
+  MockClock clock_;
+  std::unique_ptr<BbrSenderPeer> sender_;
+  QuicPacketNumber packet_number_;
+  QuicByteCount bytes_in_flight_;
+  QuicTime next_send_time_;
+  QuicTime link_free_time_;
+  std::deque<InFlightPacket> in_flight_;
+};
+
+TEST_F(BbrSenderTest, InitialState) {
+  EXPECT_EQ(BbrSender::STARTUP, sender_->mode());
+  EXPECT_TRUE(sender_->InSlowStart());
+  EXPECT_FALSE(sender_->InRecovery());
+  EXPECT_EQ(kBBR, sender_->GetCongestionControlType());
+  EXPECT_EQ(kInitialCongestionWindowPackets * kDefaultTCPMSS,
+            sender_->GetCongestionWindow());
+  EXPECT_TRUE(sender_->BandwidthEstimate().IsZero());
+  EXPECT_TRUE(
+      sender_->TimeUntilSend(clock_.Now(), bytes_in_flight_).IsZero());
+}
+
+TEST_F(BbrSenderTest, ConvergesToBottleneckBandwidth) {
+  RunFor(QuicTime::Delta::FromSeconds(5));
+
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  EXPECT_FALSE(sender_->InSlowStart());
+
+  // The bandwidth estimate is close to the bottleneck bandwidth.
+  EXPECT_LE(bandwidth_.Scale(0.9f), sender_->BandwidthEstimate());
+  EXPECT_GE(bandwidth_.Scale(1.1f), sender_->BandwidthEstimate());
+
+  // The min RTT is the propagation delay plus one packet's transfer time.
+  EXPECT_GE(propagation_delay_.Add(QuicTime::Delta::FromMilliseconds(5)),
+            sender_->min_rtt());
+
+  // The window is about twice the bandwidth-delay product, and the queue at
+  // the bottleneck stays short.
+  EXPECT_LE(BandwidthDelayProduct() * 3 / 2, sender_->GetCongestionWindow());
+  EXPECT_GE(BandwidthDelayProduct() * 5 / 2, sender_->GetCongestionWindow());
+  EXPECT_GE(propagation_delay_.Multiply(1.5),
+            sender_->rtt_stats_.smoothed_rtt());
+}
+
+TEST_F(BbrSenderTest, ConnectionMigrationRestartsStartup) {
+  RunFor(QuicTime::Delta::FromSeconds(5));
+  ASSERT_EQ(BbrSender::PROBE_BW, sender_->mode());
+
+  sender_->OnConnectionMigration();
+  EXPECT_EQ(BbrSender::STARTUP, sender_->mode());
+  EXPECT_TRUE(sender_->BandwidthEstimate().IsZero());
+  EXPECT_TRUE(sender_->min_rtt().IsZero());
+}
+
+TEST_F(BbrSenderTest, CreatedForBbrCongestionControlType) {
+  QuicConnectionStats stats;
+  std::unique_ptr<SendAlgorithmInterface> sender(SendAlgorithmInterface::Create(
+      &clock_, &sender_->rtt_stats_, kBBR, &stats,
+      kInitialCongestionWindowPackets));
+  ASSERT_TRUE(sender);
+  EXPECT_EQ(kBBR, sender->GetCongestionControlType());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -4,6 +4,7 @@
 
 #include "net/quic/congestion_control/send_algorithm_interface.h"
 
+#include "net/quic/congestion_control/bbr_sender.h"
 #include "net/quic/congestion_control/tcp_cubic_sender_bytes.h"
 #include "net/quic/congestion_control/tcp_cubic_sender_packets.h"
 #include "net/quic/quic_flags.h"
@@ -44,13 +45,8 @@ SendAlgorithmInterface* SendAlgorithmInterface::Create(
                                      initial_congestion_window,
                                      max_congestion_window, stats);
     case kBBR:
-// TODO(rtenneti): Enable BbrTcpSender.
-#if 0
-      return new BbrTcpSender(clock, rtt_stats, initial_congestion_window,
-                              max_congestion_window, stats, true);
-#endif
-      LOG(DFATAL) << "BbrTcpSender is not supported.";
-      return nullptr;
+      return new BbrSender(clock, rtt_stats, initial_congestion_window,
+                           max_congestion_window);
   }
   return nullptr;
 }
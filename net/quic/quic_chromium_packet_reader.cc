@@ -28,7 +28,9 @@ QuicChromiumPacketReader::QuicChromiumPacketReader(
       yield_after_packets_(yield_after_packets),
       yield_after_duration_(yield_after_duration),
       yield_after_(QuicTime::Infinite()),
-      read_buffer_(new IOBufferWithSize(static_cast<size_t>(kMaxPacketSize))),
+      read_buffer_(new IOBufferWithSize(
+          static_cast<size_t>(kMaxPacketSize * kQuicMaxPacketsPerRead))),
+      read_multiple_(true),
       net_log_(net_log),
       weak_factory_(this) {}
 
@@ -43,24 +45,42 @@ void QuicChromiumPacketReader::StartReading() {
 
   DCHECK(socket_);
   read_pending_ = true;
-  int rv = socket_->Read(read_buffer_.get(), read_buffer_->size(),
-                         base::Bind(&QuicChromiumPacketReader::OnReadComplete,
-                                    weak_factory_.GetWeakPtr()));
+  int rv = ERR_NOT_IMPLEMENTED;
+  if (read_multiple_) {
+    rv = socket_->ReadMultiple(
+        read_buffer_.get(), kMaxPacketSize, kQuicMaxPacketsPerRead,
+        &packet_lengths_,
+        base::Bind(&QuicChromiumPacketReader::OnReadMultipleComplete,
+                   weak_factory_.GetWeakPtr()));
+    if (rv == ERR_NOT_IMPLEMENTED)
+      read_multiple_ = false;
+  }
+  if (!read_multiple_) {
+    rv = socket_->Read(read_buffer_.get(), kMaxPacketSize,
+                       base::Bind(&QuicChromiumPacketReader::OnReadComplete,
+                                  weak_factory_.GetWeakPtr()));
+  }
   UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.AsyncRead", rv == ERR_IO_PENDING);
   if (rv == ERR_IO_PENDING) {
     num_packets_read_ = 0;
     return;
   }
 
-  if (++num_packets_read_ > yield_after_packets_ ||
+  num_packets_read_ += (read_multiple_ && rv > 0) ? rv : 1;
+  if (num_packets_read_ > yield_after_packets_ ||
       clock_->Now() > yield_after_) {
     num_packets_read_ = 0;
     // Data was read, process it.
     // Schedule the work through the message loop to 1) prevent infinite
     // recursion and 2) avoid blocking the thread for too long.
     base::ThreadTaskRunnerHandle::Get()->PostTask(
-        FROM_HERE, base::Bind(&QuicChromiumPacketReader::OnReadComplete,
-                              weak_factory_.GetWeakPtr(), rv));
+        FROM_HERE,
+        base::Bind(read_multiple_
+                       ? &QuicChromiumPacketReader::OnReadMultipleComplete
+                       : &QuicChromiumPacketReader::OnReadComplete,
+                   weak_factory_.GetWeakPtr(), rv));
+  } else if (read_multiple_) {
+    OnReadMultipleComplete(rv);
   } else {
     OnReadComplete(rv);
   }
@@ -76,15 +96,50 @@ void QuicChromiumPacketReader::OnReadComplete(int result) {
     return;
   }
 
-  QuicReceivedPacket packet(read_buffer_->data(), result, clock_->Now());
+  if (!ProcessPacket(read_buffer_->data(), result))
+    return;
+
+  StartReading();
+}
+
+void QuicChromiumPacketReader::OnReadMultipleComplete(int result) {
+  read_pending_ = false;
+  if (result == 0)
+    result = ERR_CONNECTION_CLOSED;
+
+  if (result < 0) {
+    visitor_->OnReadError(result, socket_);
+    return;
+  }
+
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Net.QuicSession.PacketsPerRead", result, 1,
+                              kQuicMaxPacketsPerRead + 1,
+                              kQuicMaxPacketsPerRead + 1);
+  DCHECK_EQ(static_cast<size_t>(result), packet_lengths_.size());
+  // Copy the lengths, since the visitor may destroy this reader.
+  std::vector<int> packet_lengths;
+  packet_lengths.swap(packet_lengths_);
+  for (size_t i = 0; i < packet_lengths.size(); ++i) {
+    if (packet_lengths[i] == 0) {
+      visitor_->OnReadError(ERR_CONNECTION_CLOSED, socket_);
+      return;
+    }
+    if (!ProcessPacket(read_buffer_->data() + i * kMaxPacketSize,
+                       packet_lengths[i])) {
+      return;
+    }
+  }
+
+  StartReading();
+}
+
+bool QuicChromiumPacketReader::ProcessPacket(const char* data, int length) {
+  QuicReceivedPacket packet(data, length, clock_->Now());
   IPEndPoint local_address;
   IPEndPoint peer_address;
   socket_->GetLocalAddress(&local_address);
   socket_->GetPeerAddress(&peer_address);
-  if (!visitor_->OnPacket(packet, local_address, peer_address))
-    return;
-
-  StartReading();
+  return visitor_->OnPacket(packet, local_address, peer_address);
 }
 
 }  // namespace net
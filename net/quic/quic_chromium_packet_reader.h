@@ -6,6 +6,8 @@
 #ifndef NET_QUIC_QUIC_CHROMIUM_PACKET_READER_H_
 #define NET_QUIC_QUIC_CHROMIUM_PACKET_READER_H_
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/io_buffer.h"
@@ -25,6 +27,9 @@ class QuicClock;
 const int kQuicYieldAfterPacketsRead = 32;
 const int kQuicYieldAfterDurationMilliseconds = 20;
 
+// The most packets QuicChromiumPacketReader reads from the socket at once.
+const int kQuicMaxPacketsPerRead = 16;
+
 class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
  public:
   class NET_EXPORT_PRIVATE Visitor {
@@ -53,6 +58,14 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
   // A completion callback invoked when a read completes.
   void OnReadComplete(int result);
 
+  // A completion callback invoked when a ReadMultiple() completes. |result|
+  // is the number of packets read, or a net error code.
+  void OnReadMultipleComplete(int result);
+
+  // Hands |packet| to the visitor. Returns false if the visitor wants reading
+  // to stop.
+  bool ProcessPacket(const char* data, int length);
+
   DatagramClientSocket* socket_;
   Visitor* visitor_;
   bool read_pending_;
@@ -62,6 +75,11 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
   QuicTime::Delta yield_after_duration_;
   QuicTime yield_after_;
   scoped_refptr<IOBufferWithSize> read_buffer_;
+  // Whether the socket reads several packets at once into |read_buffer_|,
+  // which then holds kQuicMaxPacketsPerRead packets. Cleared if the socket
+  // turns out not to support it.
+  bool read_multiple_;
+  std::vector<int> packet_lengths_;
   BoundNetLog net_log_;
 
   base::WeakPtrFactory<QuicChromiumPacketReader> weak_factory_;
@@ -4,7 +4,7 @@
 
 #include "net/quic/quic_chromium_packet_writer.h"
 
-#include <string>
+#include <string.h>
 
 #include "base/location.h"
 #include "base/logging.h"
@@ -15,10 +15,15 @@
 
 namespace net {
 
-QuicChromiumPacketWriter::QuicChromiumPacketWriter() : weak_factory_(this) {}
+QuicChromiumPacketWriter::QuicChromiumPacketWriter()
+    : packet_buffer_(new IOBufferWithSize(kMaxPacketSize)),
+      weak_factory_(this) {}
 
 QuicChromiumPacketWriter::QuicChromiumPacketWriter(Socket* socket)
-    : socket_(socket), write_blocked_(false), weak_factory_(this) {}
+    : socket_(socket),
+      packet_buffer_(new IOBufferWithSize(kMaxPacketSize)),
+      write_blocked_(false),
+      weak_factory_(this) {}
 
 QuicChromiumPacketWriter::~QuicChromiumPacketWriter() {}
 
@@ -28,11 +33,13 @@ WriteResult QuicChromiumPacketWriter::WritePacket(
     const IPAddress& self_address,
     const IPEndPoint& peer_address,
     PerPacketOptions* /*options*/) {
-  scoped_refptr<StringIOBuffer> buf(
-      new StringIOBuffer(std::string(buffer, buf_len)));
   DCHECK(!IsWriteBlocked());
+  DCHECK_LE(buf_len, static_cast<size_t>(packet_buffer_->size()));
+  // Packets serialized into |packet_buffer_| are written without a copy.
+  if (buffer != packet_buffer_->data())
+    memcpy(packet_buffer_->data(), buffer, buf_len);
   base::TimeTicks now = base::TimeTicks::Now();
-  int rv = socket_->Write(buf.get(), buf_len,
+  int rv = socket_->Write(packet_buffer_.get(), buf_len,
                           base::Bind(&QuicChromiumPacketWriter::OnWriteComplete,
                                      weak_factory_.GetWeakPtr()));
   WriteStatus status = WRITE_STATUS_OK;
@@ -79,6 +86,11 @@ void QuicChromiumPacketWriter::OnWriteComplete(int rv) {
   connection_->OnCanWrite();
 }
 
+char* QuicChromiumPacketWriter::GetNextWriteLocation() {
+  // The socket holds on to the buffer until a pending write completes.
+  return write_blocked_ ? nullptr : packet_buffer_->data();
+}
+
 QuicByteCount QuicChromiumPacketWriter::GetMaxPacketSize(
     const IPEndPoint& peer_address) const {
   return kMaxPacketSize;
@@ -8,6 +8,7 @@
 #include <stddef.h>
 
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/ip_endpoint.h"
 #include "net/quic/quic_connection.h"
@@ -18,6 +19,8 @@
 
 namespace net {
 
+class IOBufferWithSize;
+
 // Chrome specific packet writer which uses a datagram Socket for writing data.
 class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
  public:
@@ -35,6 +38,7 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
   bool IsWriteBlocked() const override;
   void SetWritable() override;
   QuicByteCount GetMaxPacketSize(const IPEndPoint& peer_address) const override;
+  char* GetNextWriteLocation() override;
 
   void OnWriteComplete(int rv);
   void SetConnection(QuicConnection* connection) { connection_ = connection; }
@@ -46,6 +50,10 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
   Socket* socket_;
   QuicConnection* connection_;
 
+  // Packets are serialized directly into this buffer, which is handed to the
+  // socket as is. It can't be reused while a write is in flight.
+  scoped_refptr<IOBufferWithSize> packet_buffer_;
+
   // Whether a write is currently in flight.
   bool write_blocked_;
 
@@ -1190,6 +1190,7 @@ void QuicConnection::SendVersionNegotiationPacket() {
   }
 
   pending_version_negotiation_packet_ = false;
+  FlushWriter();
 }
 
 QuicConsumedData QuicConnection::SendStreamData(
@@ -1363,6 +1364,11 @@ void QuicConnection::ProcessUdpPacket(const IPEndPoint& self_address,
 void QuicConnection::OnCanWrite() {
   DCHECK(!writer_->IsWriteBlocked());
 
+  // Packets batched by the writer before it blocked go out first.
+  if (!FlushWriter()) {
+    return;
+  }
+
   WriteQueuedPackets();
   WritePendingRetransmissions();
 
@@ -1714,6 +1720,27 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
     return false;
   }
 
+  // Packets generated in batch mode are flushed together when the outermost
+  // ScopedPacketBundler goes away.
+  if (result.status == WRITE_STATUS_OK && !packet_generator_.InBatchMode()) {
+    FlushWriter();
+  }
+
+  return true;
+}
+
+bool QuicConnection::FlushWriter() {
+  WriteResult result = writer_->Flush();
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    visitor_->OnWriteBlocked();
+    return false;
+  }
+  if (result.status == WRITE_STATUS_ERROR) {
+    if (connected_) {
+      OnWriteError(result.error_code);
+    }
+    return false;
+  }
   return true;
 }
 
@@ -1790,6 +1817,10 @@ void QuicConnection::OnUnrecoverableError(QuicErrorCode error,
   TearDownLocalConnectionState(error, error_details, source);
 }
 
+char* QuicConnection::GetPacketBuffer() {
+  return writer_->GetNextWriteLocation();
+}
+
 void QuicConnection::OnCongestionChange() {
   visitor_->OnCongestionWindowChange(clock_->ApproximateNow());
 
@@ -2284,6 +2315,7 @@ QuicConnection::ScopedPacketBundler::~ScopedPacketBundler() {
   if (!already_in_batch_mode_) {
     DVLOG(1) << "Leaving Batch Mode.";
     connection_->packet_generator_.FinishBatchOperations();
+    connection_->FlushWriter();
   }
   DCHECK_EQ(already_in_batch_mode_,
             connection_->packet_generator_.InBatchMode());
@@ -458,6 +458,7 @@ class NET_EXPORT_PRIVATE QuicConnection
   void OnUnrecoverableError(QuicErrorCode error,
                             const std::string& error_details,
                             ConnectionCloseSource source) override;
+  char* GetPacketBuffer() override;
 
   // QuicSentPacketManager::NetworkChangeVisitor
   void OnCongestionChange() override;
@@ -744,6 +745,10 @@ class NET_EXPORT_PRIVATE QuicConnection
   // writer is write blocked.
   bool WritePacket(SerializedPacket* packet);
 
+  // Sends the packets the writer has batched. Returns false if the writer
+  // became blocked or failed.
+  bool FlushWriter();
+
   // Make sure an ack we got from our peer is sane.
   // Returns nullptr for valid acks or an error std::string if it was invalid.
   const char* ValidateAckFrame(const QuicAckFrame& incoming_ack);
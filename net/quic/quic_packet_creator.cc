@@ -25,6 +25,10 @@ using std::vector;
 
 namespace net {
 
+char* QuicPacketCreator::DelegateInterface::GetPacketBuffer() {
+  return nullptr;
+}
+
 QuicPacketCreator::QuicPacketCreator(QuicConnectionId connection_id,
                                      QuicFramer* framer,
                                      QuicRandom* random_generator,
@@ -321,7 +325,9 @@ void QuicPacketCreator::Flush() {
   // TODO(rtenneti): Change the default 64 alignas value (used the default
   // value from CACHELINE_SIZE).
   ALIGNAS(64) char seralized_packet_buffer[kMaxPacketSize];
-  SerializePacket(seralized_packet_buffer, kMaxPacketSize);
+  char* buffer = delegate_->GetPacketBuffer();
+  SerializePacket(buffer != nullptr ? buffer : seralized_packet_buffer,
+                  kMaxPacketSize);
   OnSerializedPacket();
 }
 
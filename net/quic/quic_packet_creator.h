@@ -45,6 +45,11 @@ class NET_EXPORT_PRIVATE QuicPacketCreator {
     virtual void OnUnrecoverableError(QuicErrorCode error,
                                       const std::string& error_details,
                                       ConnectionCloseSource source) = 0;
+
+    // Returns a buffer of at least kMaxPacketSize bytes to serialize the next
+    // packet into, typically owned by the packet writer so that the packet is
+    // written without being copied. Returns null to use a stack buffer.
+    virtual char* GetPacketBuffer();
   };
 
   // Interface which gets callbacks from the QuicPacketCreator at interesting
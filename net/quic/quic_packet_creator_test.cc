@@ -28,7 +28,9 @@ using std::ostream;
 using std::string;
 using std::vector;
 using testing::DoAll;
+using testing::Field;
 using testing::InSequence;
+using testing::Pointee;
 using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
@@ -76,7 +78,7 @@ vector<TestParams> GetTestParams() {
 
 class MockDelegate : public QuicPacketCreator::DelegateInterface {
  public:
-  MockDelegate() {}
+  MockDelegate() : packet_buffer_(nullptr) {}
   ~MockDelegate() override {}
 
   MOCK_METHOD1(OnSerializedPacket, void(SerializedPacket* packet));
@@ -85,7 +87,15 @@ class MockDelegate : public QuicPacketCreator::DelegateInterface {
                     const string&,
                     ConnectionCloseSource source));
 
+  char* GetPacketBuffer() override { return packet_buffer_; }
+
+  void set_packet_buffer(char* packet_buffer) {
+    packet_buffer_ = packet_buffer;
+  }
+
  private:
+  char* packet_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(MockDelegate);
 };
 
@@ -272,6 +282,32 @@ TEST_P(QuicPacketCreatorTest, SerializeFrames) {
   }
 }
 
+TEST_P(QuicPacketCreatorTest, FlushSerializesIntoDelegateBuffer) {
+  char packet_buffer[kMaxPacketSize];
+  delegate_.set_packet_buffer(packet_buffer);
+  frames_.push_back(QuicFrame(new QuicAckFrame(MakeAckFrame(0u))));
+  creator_.AddSavedFrame(frames_[0]);
+
+  EXPECT_CALL(delegate_,
+              OnSerializedPacket(Pointee(Field(
+                  &SerializedPacket::encrypted_buffer, packet_buffer))))
+      .WillOnce(Invoke(this, &QuicPacketCreatorTest::SaveSerializedPacket));
+  creator_.Flush();
+  delete frames_[0].ack_frame;
+
+  {
+    InSequence s;
+    EXPECT_CALL(framer_visitor_, OnPacket());
+    EXPECT_CALL(framer_visitor_, OnUnauthenticatedPublicHeader(_));
+    EXPECT_CALL(framer_visitor_, OnUnauthenticatedHeader(_));
+    EXPECT_CALL(framer_visitor_, OnDecryptedPacket(_));
+    EXPECT_CALL(framer_visitor_, OnPacketHeader(_));
+    EXPECT_CALL(framer_visitor_, OnAckFrame(_));
+    EXPECT_CALL(framer_visitor_, OnPacketComplete());
+  }
+  ProcessPacket(serialized_packet_);
+}
+
 TEST_P(QuicPacketCreatorTest, SerializeChangingSequenceNumberLength) {
   frames_.push_back(QuicFrame(new QuicAckFrame(MakeAckFrame(0u))));
   creator_.AddSavedFrame(frames_[0]);
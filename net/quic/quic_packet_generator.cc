@@ -137,7 +137,10 @@ QuicConsumedData QuicPacketGenerator::ConsumeDataFastPath(
          delegate_->ShouldGeneratePacket(HAS_RETRANSMITTABLE_DATA,
                                          NOT_HANDSHAKE)) {
     // Serialize and encrypt the packet.
-    ALIGNAS(64) char encrypted_buffer[kMaxPacketSize];
+    ALIGNAS(64) char stack_buffer[kMaxPacketSize];
+    char* encrypted_buffer = delegate_->GetPacketBuffer();
+    if (encrypted_buffer == nullptr)
+      encrypted_buffer = stack_buffer;
     size_t bytes_consumed = 0;
     packet_creator_.CreateAndSerializeStreamFrame(
         id, iov, total_bytes_consumed, offset + total_bytes_consumed, fin,
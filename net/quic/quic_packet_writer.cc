@@ -0,0 +1,17 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/quic_packet_writer.h"
+
+namespace net {
+
+char* QuicPacketWriter::GetNextWriteLocation() {
+  return nullptr;
+}
+
+WriteResult QuicPacketWriter::Flush() {
+  return WriteResult(WRITE_STATUS_OK, 0);
+}
+
+}  // namespace net
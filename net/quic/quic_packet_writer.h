@@ -66,6 +66,16 @@ class NET_EXPORT_PRIVATE QuicPacketWriter {
   // size of a valid QUIC packet.
   virtual QuicByteCount GetMaxPacketSize(
       const IPEndPoint& peer_address) const = 0;
+
+  // Returns a buffer of at least kMaxPacketSize bytes into which the next
+  // packet may be serialized, so that WritePacket() doesn't need to copy it,
+  // or null if the writer has no such buffer. The buffer is only valid until
+  // the next call to WritePacket() or Flush().
+  virtual char* GetNextWriteLocation();
+
+  // Sends any packets which the writer has batched rather than written out
+  // immediately. Returns WRITE_STATUS_OK if nothing was batched.
+  virtual WriteResult Flush();
 };
 
 }  // namespace net
@@ -131,7 +131,9 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
     send_algorithm_.reset(SendAlgorithmInterface::Create(
         clock_, &rtt_stats_, kCubicBytes, stats_, initial_congestion_window_));
   }
-  if (!FLAGS_quic_disable_pacing) {
+  // BBR relies on pacing to send at its bandwidth estimate.
+  if (!FLAGS_quic_disable_pacing ||
+      send_algorithm_->GetCongestionControlType() == kBBR) {
     EnablePacing();
   }
 
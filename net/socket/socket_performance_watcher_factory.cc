@@ -0,0 +1,14 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/socket_performance_watcher_factory.h"
+
+namespace net {
+
+bool SocketPerformanceWatcherFactory::GetTransportRTTEstimate(
+    base::TimeDelta* rtt) const {
+  return false;
+}
+
+}  // namespace net
@@ -10,6 +10,10 @@
 #include "base/macros.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class TimeDelta;
+}  // namespace base
+
 namespace net {
 
 class SocketPerformanceWatcher;
@@ -31,6 +35,12 @@ class NET_EXPORT_PRIVATE SocketPerformanceWatcherFactory {
   virtual std::unique_ptr<SocketPerformanceWatcher>
   CreateSocketPerformanceWatcher(const Protocol protocol) = 0;
 
+  // Sets |rtt| to the transport RTT currently expected on the network, as
+  // estimated from the watchers created so far, and returns true. Returns
+  // false if there's no estimate yet, or none is available on the calling
+  // thread.
+  virtual bool GetTransportRTTEstimate(base::TimeDelta* rtt) const;
+
  protected:
   SocketPerformanceWatcherFactory() {}
 
@@ -20,6 +20,10 @@
 #include "net/base/net_errors.h"
 #include "net/base/sockaddr_storage.h"
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <sys/sendfile.h>
+#endif
+
 namespace net {
 
 namespace {
@@ -61,6 +65,7 @@ SocketPosix::SocketPosix()
     : socket_fd_(kInvalidSocket),
       read_buf_len_(0),
       write_buf_len_(0),
+      write_file_(base::kInvalidPlatformFile),
       waiting_connect_(false) {}
 
 SocketPosix::~SocketPosix() {
@@ -272,6 +277,38 @@ int SocketPosix::Write(IOBuffer* buf,
   return rv;
 }
 
+int SocketPosix::SendFile(base::PlatformFile file,
+                          int len,
+                          const CompletionCallback& callback) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_fd_);
+  DCHECK(!waiting_connect_);
+  CHECK(write_callback_.is_null());
+  // Synchronous operation not supported
+  DCHECK(!callback.is_null());
+  DCHECK_LT(0, len);
+
+  int rv = DoSendFile(file, len);
+  if (rv != ERR_IO_PENDING)
+    return rv;
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_fd_, true, base::MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, this)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on write, errno " << errno;
+    return MapSystemError(errno);
+  }
+
+  write_file_ = file;
+  write_buf_len_ = len;
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 int SocketPosix::WaitForWrite(IOBuffer* buf,
                               int buf_len,
                               const CompletionCallback& callback) {
@@ -454,8 +491,28 @@ int SocketPosix::DoWrite(IOBuffer* buf, int buf_len) {
   return rv >= 0 ? rv : MapSystemError(errno);
 }
 
+int SocketPosix::DoSendFile(base::PlatformFile file, int len) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Unlike send(), sendfile() takes no MSG_NOSIGNAL, so this relies on the
+  // embedder ignoring SIGPIPE, as Chromium does.
+  ssize_t rv = HANDLE_EINTR(sendfile(socket_fd_, file, nullptr, len));
+  if (rv >= 0)
+    return static_cast<int>(rv);
+  // EINVAL means |file| can't be mapped, as for pipes, so let the caller
+  // fall back to reading it.
+  if (errno == EINVAL || errno == ENOSYS)
+    return ERR_NOT_IMPLEMENTED;
+  return MapSystemError(errno);
+#else
+  NOTREACHED();
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 void SocketPosix::WriteCompleted() {
-  int rv = DoWrite(write_buf_.get(), write_buf_len_);
+  int rv = write_file_ != base::kInvalidPlatformFile
+               ? DoSendFile(write_file_, write_buf_len_)
+               : DoWrite(write_buf_.get(), write_buf_len_);
   if (rv == ERR_IO_PENDING)
     return;
 
@@ -463,6 +520,7 @@ void SocketPosix::WriteCompleted() {
   DCHECK(ok);
   write_buf_ = NULL;
   write_buf_len_ = 0;
+  write_file_ = base::kInvalidPlatformFile;
   base::ResetAndReturn(&write_callback_).Run(rv);
 }
 
@@ -488,6 +546,7 @@ void SocketPosix::StopWatchingAndCleanUp() {
   if (!write_callback_.is_null()) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
+    write_file_ = base::kInvalidPlatformFile;
     write_callback_.Reset();
   }
 
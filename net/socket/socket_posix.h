@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "base/compiler_specific.h"
+#include "base/files/file.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
@@ -61,6 +62,13 @@ class NET_EXPORT_PRIVATE SocketPosix : public base::MessageLoopForIO::Watcher {
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
   int Write(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Writes up to |len| bytes of |file| from its current position with
+  // sendfile(2). Behaves like Write() otherwise, but returns 0 at the end of
+  // |file|. Returns ERR_NOT_IMPLEMENTED where sendfile(2) isn't available.
+  int SendFile(base::PlatformFile file,
+               int len,
+               const CompletionCallback& callback);
+
   // Waits for next write event. This is called by TCPSocketPosix for TCP
   // fastopen after sending first data. Returns ERR_IO_PENDING if it starts
   // waiting for write event successfully. Otherwise, returns a net error code.
@@ -98,6 +106,7 @@ class NET_EXPORT_PRIVATE SocketPosix : public base::MessageLoopForIO::Watcher {
   void ReadCompleted();
 
   int DoWrite(IOBuffer* buf, int buf_len);
+  int DoSendFile(base::PlatformFile file, int len);
   void WriteCompleted();
 
   void StopWatchingAndCleanUp();
@@ -117,6 +126,8 @@ class NET_EXPORT_PRIVATE SocketPosix : public base::MessageLoopForIO::Watcher {
   base::MessageLoopForIO::FileDescriptorWatcher write_socket_watcher_;
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
+  // File being sent instead of |write_buf_|, if any.
+  base::PlatformFile write_file_;
   // External callback; called when write or connect is complete.
   CompletionCallback write_callback_;
 
@@ -923,7 +923,16 @@ int SSLClientSocketImpl::Init() {
 
   BIO* ssl_bio = NULL;
 
-  // SSLClientSocketImpl retains ownership of the BIO buffers.
+  // SSLClientSocketImpl retains ownership of the BIO buffers. BoringSSL writes
+  // records straight into |send_buffer_| and reads them from |recv_buffer_|,
+  // which are passed to the transport as-is, so the only userspace pass over
+  // payload bytes is the encryption itself.
+  //
+  // Note that the record layer can't be handed to the kernel (Linux TLS_TX and
+  // TLS_RX) because |transport_| is any StreamSocket, such as a proxy tunnel or
+  // another SSL socket, rather than a file descriptor. Payloads also always
+  // come from IOBuffers rather than files, so there is no sendfile() path that
+  // would benefit.
   if (!BIO_new_bio_pair_external_buf(
           &ssl_bio, send_buffer_->capacity(),
           reinterpret_cast<uint8_t*>(send_buffer_->data()), &transport_bio_,
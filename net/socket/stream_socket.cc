@@ -8,9 +8,16 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/values.h"
+#include "net/base/net_errors.h"
 
 namespace net {
 
+int StreamSocket::SendFile(base::PlatformFile file,
+                           int len,
+                           const CompletionCallback& callback) {
+  return ERR_NOT_IMPLEMENTED;
+}
+
 StreamSocket::UseHistory::UseHistory()
     : was_ever_connected_(false),
       was_used_to_convey_data_(false),
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include "base/files/file.h"
 #include "base/macros.h"
 #include "net/log/net_log.h"
 #include "net/socket/connection_attempts.h"
@@ -83,6 +84,18 @@ class NET_EXPORT_PRIVATE StreamSocket : public Socket {
   // Enables use of TCP FastOpen for the underlying transport socket.
   virtual void EnableTCPFastOpenIfSupported() {}
 
+  // Writes up to |len| bytes of |file|, from its current position, straight
+  // from the file to the socket without copying them through user space, and
+  // advances the file's position by the number of bytes written. Otherwise
+  // behaves like Write(), except that it returns 0 if |file| has no more data,
+  // and ERR_NOT_IMPLEMENTED if the socket can't do this, in which case the
+  // caller should read the file and Write() it instead.
+  //
+  // The file is read synchronously, on the calling thread.
+  virtual int SendFile(base::PlatformFile file,
+                       int len,
+                       const CompletionCallback& callback);
+
   // Returns true if NPN was negotiated during the connection of this socket.
   virtual bool WasNpnNegotiated() const = 0;
 
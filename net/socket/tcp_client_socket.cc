@@ -11,6 +11,7 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/profiler/scoped_tracker.h"
 #include "base/time/time.h"
+#include "build/build_config.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
@@ -301,6 +302,24 @@ int TCPClientSocket::Write(IOBuffer* buf,
   return result;
 }
 
+int TCPClientSocket::SendFile(base::PlatformFile file,
+                              int len,
+                              const CompletionCallback& callback) {
+#if defined(OS_POSIX)
+  DCHECK(!callback.is_null());
+
+  CompletionCallback write_callback = base::Bind(
+      &TCPClientSocket::DidCompleteWrite, base::Unretained(this), callback);
+  int result = socket_->SendFile(file, len, write_callback);
+  if (result > 0)
+    use_history_.set_was_used_to_convey_data();
+
+  return result;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 int TCPClientSocket::SetReceiveBufferSize(int32_t size) {
   return socket_->SetReceiveBufferSize(size);
 }
@@ -73,6 +73,10 @@ class NET_EXPORT TCPClientSocket : public StreamSocket {
   int SetReceiveBufferSize(int32_t size) override;
   int SetSendBufferSize(int32_t size) override;
 
+  int SendFile(base::PlatformFile file,
+               int len,
+               const CompletionCallback& callback) override;
+
   virtual bool SetKeepAlive(bool enable, int delay);
   virtual bool SetNoDelay(bool no_delay);
 
@@ -312,6 +312,24 @@ int TCPSocketPosix::Write(IOBuffer* buf,
   return rv;
 }
 
+int TCPSocketPosix::SendFile(base::PlatformFile file,
+                             int len,
+                             const CompletionCallback& callback) {
+  DCHECK(socket_);
+  DCHECK(!callback.is_null());
+
+  // TCP FastOpen sends the first bytes along with the SYN, from a buffer.
+  if (use_tcp_fastopen_ && !tcp_fastopen_write_attempted_)
+    return ERR_NOT_IMPLEMENTED;
+
+  int rv = socket_->SendFile(
+      file, len, base::Bind(&TCPSocketPosix::SendFileCompleted,
+                            base::Unretained(this), callback));
+  if (rv != ERR_IO_PENDING)
+    rv = HandleSendFileCompleted(rv);
+  return rv;
+}
+
 int TCPSocketPosix::GetLocalAddress(IPEndPoint* address) const {
   DCHECK(address);
 
@@ -658,6 +676,32 @@ int TCPSocketPosix::HandleWriteCompleted(IOBuffer* buf, int rv) {
   return rv;
 }
 
+void TCPSocketPosix::SendFileCompleted(const CompletionCallback& callback,
+                                       int rv) {
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  callback.Run(HandleSendFileCompleted(rv));
+}
+
+int TCPSocketPosix::HandleSendFileCompleted(int rv) {
+  if (rv == ERR_NOT_IMPLEMENTED)
+    return rv;
+  if (rv < 0) {
+    net_log_.AddEvent(NetLog::TYPE_SOCKET_WRITE_ERROR,
+                      CreateNetLogSocketErrorCallback(rv, errno));
+    return rv;
+  }
+
+  // Notify the watcher only if at least 1 byte was written.
+  if (rv > 0)
+    NotifySocketPerformanceWatcher();
+
+  // The bytes never go through user space, so only their count is logged.
+  net_log_.AddEvent(NetLog::TYPE_SOCKET_BYTES_SENT,
+                    NetLog::IntCallback("byte_count", rv));
+  NetworkActivityMonitor::GetInstance()->IncrementBytesSent(rv);
+  return rv;
+}
+
 int TCPSocketPosix::TcpFastOpenWrite(IOBuffer* buf,
                                      int buf_len,
                                      const CompletionCallback& callback) {
@@ -11,6 +11,7 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/files/file.h"
 #include "base/macros.h"
 #include "base/time/time.h"
 #include "net/base/address_family.h"
@@ -59,6 +60,10 @@ class NET_EXPORT TCPSocketPosix {
   // Full duplex mode (reading and writing at the same time) is supported.
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
   int Write(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
+  // See StreamSocket::SendFile().
+  int SendFile(base::PlatformFile file,
+               int len,
+               const CompletionCallback& callback);
 
   int GetLocalAddress(IPEndPoint* address) const;
   int GetPeerAddress(IPEndPoint* address) const;
@@ -204,6 +209,8 @@ class NET_EXPORT TCPSocketPosix {
                       const CompletionCallback& callback,
                       int rv);
   int HandleWriteCompleted(IOBuffer* buf, int rv);
+  void SendFileCompleted(const CompletionCallback& callback, int rv);
+  int HandleSendFileCompleted(int rv);
   int TcpFastOpenWrite(IOBuffer* buf,
                        int buf_len,
                        const CompletionCallback& callback);
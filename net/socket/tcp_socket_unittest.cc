@@ -11,6 +11,9 @@
 #include <string>
 #include <vector>
 
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/ref_counted.h"
 #include "base/test/simple_test_tick_clock.h"
 #include "base/time/time.h"
@@ -385,6 +388,78 @@ TEST_F(TCPSocketTest, ReadWrite) {
   ASSERT_EQ(message, received_message);
 }
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+TEST_F(TCPSocketTest, SendFile) {
+  ASSERT_NO_FATAL_FAILURE(SetUpListenIPv4());
+
+  TestCompletionCallback connect_callback;
+  TCPSocket connecting_socket(NULL, NULL, NetLog::Source());
+  ASSERT_EQ(OK, connecting_socket.Open(ADDRESS_FAMILY_IPV4));
+  connecting_socket.Connect(local_address_, connect_callback.callback());
+
+  TestCompletionCallback accept_callback;
+  std::unique_ptr<TCPSocket> accepted_socket;
+  IPEndPoint accepted_address;
+  int result = socket_.Accept(&accepted_socket, &accepted_address,
+                              accept_callback.callback());
+  ASSERT_EQ(OK, accept_callback.GetResult(result));
+  EXPECT_EQ(OK, connect_callback.WaitForResult());
+
+  // Large enough not to fit in the socket buffers at once.
+  const std::string message(1024 * 1024, 'x');
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.path().AppendASCII("message");
+  ASSERT_EQ(static_cast<int>(message.size()),
+            base::WriteFile(path, message.data(), message.size()));
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  ASSERT_TRUE(file.IsValid());
+
+  // Send the file while reading from the other end, so that sends have to
+  // wait for the socket to become writable.
+  size_t bytes_sent = 0;
+  bool send_pending = false;
+  TestCompletionCallback send_callback;
+  std::string received;
+  while (received.size() < message.size()) {
+    if (send_pending && send_callback.have_result()) {
+      int send_result = send_callback.WaitForResult();
+      ASSERT_LT(0, send_result);
+      bytes_sent += send_result;
+      send_pending = false;
+    }
+    while (!send_pending && bytes_sent < message.size()) {
+      int send_result = accepted_socket->SendFile(
+          file.GetPlatformFile(), message.size() - bytes_sent,
+          send_callback.callback());
+      if (send_result == ERR_IO_PENDING) {
+        send_pending = true;
+      } else {
+        ASSERT_LT(0, send_result);
+        bytes_sent += send_result;
+      }
+    }
+
+    scoped_refptr<IOBufferWithSize> read_buffer(new IOBufferWithSize(4096));
+    TestCompletionCallback read_callback;
+    int read_result = connecting_socket.Read(
+        read_buffer.get(), read_buffer->size(), read_callback.callback());
+    read_result = read_callback.GetResult(read_result);
+    ASSERT_LT(0, read_result);
+    received.append(read_buffer->data(), read_result);
+  }
+  if (send_pending)
+    bytes_sent += send_callback.WaitForResult();
+  EXPECT_EQ(message.size(), bytes_sent);
+  EXPECT_EQ(message, received);
+
+  // The file is at its end now.
+  TestCompletionCallback end_callback;
+  EXPECT_EQ(0, accepted_socket->SendFile(file.GetPlatformFile(), 1,
+                                         end_callback.callback()));
+}
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 // These tests require kernel support for tcp_info struct, and so they are
 // enabled only on certain platforms.
 #if defined(TCP_INFO) || defined(OS_LINUX)
@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -35,15 +37,55 @@ namespace net {
 
 namespace {
 
-// Returns true iff all addresses in |list| are in the IPv6 family.
-bool AddressListOnlyContainsIPv6(const AddressList& list) {
+// Returns true iff |list| has both IPv6 and IPv4 addresses.
+bool AddressListContainsBothFamilies(const AddressList& list) {
   DCHECK(!list.empty());
   for (AddressList::const_iterator iter = list.begin(); iter != list.end();
        ++iter) {
-    if (iter->GetFamily() != ADDRESS_FAMILY_IPV6)
-      return false;
+    if (iter->GetFamily() != list.front().GetFamily())
+      return true;
   }
-  return true;
+  return false;
+}
+
+std::unique_ptr<base::Value> NetLogConnectAttemptRaceCallback(
+    size_t address_count,
+    base::TimeDelta attempt_delay,
+    bool has_transport_rtt,
+    NetLogCaptureMode /* capture_mode */) {
+  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue());
+  dict->SetInteger("address_count", static_cast<int>(address_count));
+  dict->SetInteger("attempt_delay_ms",
+                   static_cast<int>(attempt_delay.InMilliseconds()));
+  dict->SetBoolean("has_transport_rtt", has_transport_rtt);
+  return std::move(dict);
+}
+
+std::unique_ptr<base::Value> NetLogConnectAttemptCallback(
+    int attempt_index,
+    const AddressList* addresses,
+    NetLogCaptureMode /* capture_mode */) {
+  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue());
+  dict->SetInteger("attempt", attempt_index);
+  std::unique_ptr<base::ListValue> list(new base::ListValue());
+  for (AddressList::const_iterator iter = addresses->begin();
+       iter != addresses->end(); ++iter) {
+    list->AppendString(iter->ToString());
+  }
+  dict->Set("address_list", std::move(list));
+  return std::move(dict);
+}
+
+std::unique_ptr<base::Value> NetLogConnectAttemptCompleteCallback(
+    int attempt_index,
+    int net_error,
+    base::TimeDelta duration,
+    NetLogCaptureMode /* capture_mode */) {
+  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue());
+  dict->SetInteger("attempt", attempt_index);
+  dict->SetInteger("net_error", net_error);
+  dict->SetInteger("duration_ms", static_cast<int>(duration.InMilliseconds()));
+  return std::move(dict);
 }
 
 }  // namespace
@@ -85,11 +127,18 @@ TransportSocketParams::~TransportSocketParams() {}
 // See comment #12 at http://crbug.com/23364 for specifics.
 const int TransportConnectJob::kTimeoutInSeconds = 240;  // 4 minutes.
 
-// TODO(willchan): Base this off RTT instead of statically setting it. Note we
-// choose a timeout that is different from the backup connect job timer so they
-// don't synchronize.
+// Note we choose a timeout that is different from the backup connect job timer
+// so they don't synchronize.
 const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
+// RFC 8305 recommends keeping the delay between 100 ms and 2 s.
+const int TransportConnectJob::kMinConnectionAttemptDelayInMs = 100;
+const int TransportConnectJob::kMaxConnectionAttemptDelayInMs = 2000;
+
+TransportConnectJob::ConnectAttempt::ConnectAttempt() : index(0) {}
+
+TransportConnectJob::ConnectAttempt::~ConnectAttempt() {}
+
 TransportConnectJob::TransportConnectJob(
     const std::string& group_name,
     RequestPriority priority,
@@ -111,6 +160,11 @@ TransportConnectJob::TransportConnectJob(
       resolver_(host_resolver),
       client_socket_factory_(client_socket_factory),
       next_state_(STATE_NONE),
+      race_addresses_(false),
+      next_address_index_(0),
+      connected_to_ipv4_(false),
+      winning_attempt_index_(0),
+      connect_attempt_count_(0),
       socket_performance_watcher_factory_(socket_performance_watcher_factory),
       interval_between_connects_(CONNECT_INTERVAL_GT_20MS),
       resolve_result_(OK) {}
@@ -137,7 +191,7 @@ LoadState TransportConnectJob::GetLoadState() const {
 
 void TransportConnectJob::GetAdditionalErrorState(ClientSocketHandle* handle) {
   // If hostname resolution failed, record an empty endpoint and the result.
-  // Also record any attempts made on either of the sockets.
+  // Also record any attempts made on the sockets.
   ConnectionAttempts attempts;
   if (resolve_result_ != OK) {
     DCHECK_EQ(0u, addresses_.size());
@@ -145,8 +199,6 @@ void TransportConnectJob::GetAdditionalErrorState(ClientSocketHandle* handle) {
   }
   attempts.insert(attempts.begin(), connection_attempts_.begin(),
                   connection_attempts_.end());
-  attempts.insert(attempts.begin(), fallback_connection_attempts_.begin(),
-                  fallback_connection_attempts_.end());
   handle->set_connection_attempts(attempts);
 }
 
@@ -160,6 +212,44 @@ void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   }
 }
 
+// static
+void TransportConnectJob::InterleaveAddressFamilies(AddressList* list) {
+  if (list->empty())
+    return;
+  AddressFamily first_family = list->front().GetFamily();
+  std::vector<IPEndPoint> first_family_addresses;
+  std::vector<IPEndPoint> other_addresses;
+  for (AddressList::const_iterator iter = list->begin(); iter != list->end();
+       ++iter) {
+    if (iter->GetFamily() == first_family)
+      first_family_addresses.push_back(*iter);
+    else
+      other_addresses.push_back(*iter);
+  }
+
+  AddressList::iterator out = list->begin();
+  for (size_t i = 0;
+       i < std::max(first_family_addresses.size(), other_addresses.size());
+       ++i) {
+    if (i < first_family_addresses.size())
+      *out++ = first_family_addresses[i];
+    if (i < other_addresses.size())
+      *out++ = other_addresses[i];
+  }
+}
+
+// static
+base::TimeDelta TransportConnectJob::GetConnectionAttemptDelay(
+    base::TimeDelta transport_rtt) {
+  // A connect() takes about one round trip, so give it another one before
+  // starting the next attempt.
+  base::TimeDelta min_delay =
+      base::TimeDelta::FromMilliseconds(kMinConnectionAttemptDelayInMs);
+  base::TimeDelta max_delay =
+      base::TimeDelta::FromMilliseconds(kMaxConnectionAttemptDelayInMs);
+  return std::min(std::max(transport_rtt * 2, min_delay), max_delay);
+}
+
 // static
 base::TimeDelta TransportConnectJob::HistogramDuration(
     const LoadTimingInfo::ConnectTiming& connect_timing,
@@ -317,65 +407,64 @@ int TransportConnectJob::DoTransportConnect() {
   }
 
   next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
-  // Create a |SocketPerformanceWatcher|, and pass the ownership.
-  std::unique_ptr<SocketPerformanceWatcher> socket_performance_watcher;
-  if (socket_performance_watcher_factory_) {
-    socket_performance_watcher =
-        socket_performance_watcher_factory_->CreateSocketPerformanceWatcher(
-            SocketPerformanceWatcherFactory::PROTOCOL_TCP);
-  }
-  transport_socket_ = client_socket_factory_->CreateTransportClientSocket(
-      addresses_, std::move(socket_performance_watcher), net_log().net_log(),
-      net_log().source());
-
-  // If the list contains IPv6 and IPv4 addresses, the first address will
-  // be IPv6, and the IPv4 addresses will be tried as fallback addresses,
-  // per "Happy Eyeballs" (RFC 6555).
-  bool try_ipv6_connect_with_ipv4_fallback =
-      addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6 &&
-      !AddressListOnlyContainsIPv6(addresses_);
 
-  // Enable TCP FastOpen if indicated by transport socket params.
-  // Note: We currently do not turn on TCP FastOpen for destinations where
-  // we try a TCP connect over IPv6 with fallback to IPv4.
-  if (!try_ipv6_connect_with_ipv4_fallback &&
-      params_->combine_connect_and_write() ==
-          TransportSocketParams::COMBINE_CONNECT_AND_WRITE_DESIRED) {
-    transport_socket_->EnableTCPFastOpenIfSupported();
+  // If the list contains IPv6 and IPv4 addresses, connects to them are raced,
+  // per "Happy Eyeballs" (RFC 8305).
+  race_addresses_ = AddressListContainsBothFamilies(addresses_);
+  if (race_addresses_) {
+    InterleaveAddressFamilies(&addresses_);
+
+    base::TimeDelta transport_rtt;
+    bool has_transport_rtt =
+        socket_performance_watcher_factory_ &&
+        socket_performance_watcher_factory_->GetTransportRTTEstimate(
+            &transport_rtt);
+    connection_attempt_delay_ =
+        has_transport_rtt
+            ? GetConnectionAttemptDelay(transport_rtt)
+            : base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs);
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Attempt_Delay",
+                               connection_attempt_delay_,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromSeconds(10), 50);
+    net_log().AddEvent(
+        NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE,
+        base::Bind(&NetLogConnectAttemptRaceCallback, addresses_.size(),
+                   connection_attempt_delay_, has_transport_rtt));
   }
 
-  int rv = transport_socket_->Connect(
-      base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
-  if (rv == ERR_IO_PENDING && try_ipv6_connect_with_ipv4_fallback) {
-    fallback_timer_.Start(
-        FROM_HERE, base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
-  }
-  return rv;
+  next_address_index_ = 0;
+  return StartConnectAttempts();
 }
 
 int TransportConnectJob::DoTransportConnectComplete(int result) {
+  // Collect the attempts still pending, and stop them.
+  CopyConnectionAttemptsFromSockets();
+  connection_attempt_timer_.Stop();
+  pending_connect_attempts_.clear();
+
   if (result == OK) {
-    // Success will be returned via the main socket, so also include connection
-    // attempts made on the fallback socket up to this point. (Unfortunately,
-    // the only simple way to return information in the success case is through
-    // the successfully-connected socket.)
-    if (fallback_transport_socket_) {
-      ConnectionAttempts fallback_attempts;
-      fallback_transport_socket_->GetConnectionAttempts(&fallback_attempts);
-      transport_socket_->AddConnectionAttempts(fallback_attempts);
-    }
+    // Success will be returned via the winning socket, so also include
+    // connection attempts made on the other sockets up to this point.
+    // (Unfortunately, the only simple way to return information in the success
+    // case is through the successfully-connected socket.)
+    transport_socket_->AddConnectionAttempts(connection_attempts_);
 
-    bool is_ipv4 = addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV4;
     RaceResult race_result = RACE_UNKNOWN;
-    if (is_ipv4)
-      race_result = RACE_IPV4_SOLO;
-    else if (AddressListOnlyContainsIPv6(addresses_))
-      race_result = RACE_IPV6_SOLO;
+    if (race_addresses_)
+      race_result = connected_to_ipv4_ ? RACE_IPV4_WINS : RACE_IPV6_WINS;
     else
-      race_result = RACE_IPV6_WINS;
+      race_result = connected_to_ipv4_ ? RACE_IPV4_SOLO : RACE_IPV6_SOLO;
+    if (winning_attempt_index_ > 0)
+      connect_timing_.connect_start = winning_attempt_start_time_;
     base::TimeDelta connect_duration =
         HistogramDuration(connect_timing_, race_result);
+    if (race_addresses_) {
+      UMA_HISTOGRAM_COUNTS_100("Net.TCP_Connection_Race_Attempt_Count",
+                               connect_attempt_count_);
+      UMA_HISTOGRAM_COUNTS_100("Net.TCP_Connection_Race_Winning_Attempt",
+                               winning_attempt_index_);
+    }
     switch (interval_between_connects_) {
       case CONNECT_INTERVAL_LE_10MS:
         UMA_HISTOGRAM_CUSTOM_TIMES(
@@ -407,31 +496,33 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
     }
 
     SetSocket(std::move(transport_socket_));
-  } else {
-    // Failure will be returned via |GetAdditionalErrorState|, so save
-    // connection attempts from both sockets for use there.
-    CopyConnectionAttemptsFromSockets();
-
-    transport_socket_.reset();
   }
 
-  fallback_timer_.Stop();
-  fallback_transport_socket_.reset();
-  fallback_addresses_.reset();
-
   return result;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnect() {
-  // The timer should only fire while we're waiting for the main connect to
-  // succeed.
-  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
-    NOTREACHED();
-    return;
-  }
+int TransportConnectJob::StartConnectAttempts() {
+  DCHECK_LT(next_address_index_, addresses_.size());
+  int rv;
+  do {
+    rv = StartConnectAttempt();
+  } while (rv != OK && rv != ERR_IO_PENDING &&
+           next_address_index_ < addresses_.size());
 
-  DCHECK(!fallback_transport_socket_.get());
-  DCHECK(!fallback_addresses_.get());
+  if (rv != OK && !pending_connect_attempts_.empty())
+    return ERR_IO_PENDING;
+  return rv;
+}
+
+int TransportConnectJob::StartConnectAttempt() {
+  std::unique_ptr<ConnectAttempt> attempt(new ConnectAttempt());
+  attempt->index = connect_attempt_count_++;
+  if (race_addresses_) {
+    attempt->addresses = AddressList(addresses_[next_address_index_++]);
+  } else {
+    attempt->addresses = addresses_;
+    next_address_index_ = addresses_.size();
+  }
 
   // Create a |SocketPerformanceWatcher|, and pass the ownership.
   std::unique_ptr<SocketPerformanceWatcher> socket_performance_watcher;
@@ -440,62 +531,115 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
         socket_performance_watcher_factory_->CreateSocketPerformanceWatcher(
             SocketPerformanceWatcherFactory::PROTOCOL_TCP);
   }
+  attempt->socket = client_socket_factory_->CreateTransportClientSocket(
+      attempt->addresses, std::move(socket_performance_watcher),
+      net_log().net_log(), net_log().source());
 
-  fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddressListStartWithIPv4(fallback_addresses_.get());
-  fallback_transport_socket_ =
-      client_socket_factory_->CreateTransportClientSocket(
-          *fallback_addresses_, std::move(socket_performance_watcher),
-          net_log().net_log(), net_log().source());
-  fallback_connect_start_time_ = base::TimeTicks::Now();
-  int rv = fallback_transport_socket_->Connect(
-      base::Bind(
-          &TransportConnectJob::DoIPv6FallbackTransportConnectComplete,
-          base::Unretained(this)));
-  if (rv != ERR_IO_PENDING)
-    DoIPv6FallbackTransportConnectComplete(rv);
-}
+  // Enable TCP FastOpen if indicated by transport socket params.
+  // Note: We currently do not turn on TCP FastOpen for destinations where
+  // we race connects to IPv6 and IPv4 addresses.
+  if (!race_addresses_ &&
+      params_->combine_connect_and_write() ==
+          TransportSocketParams::COMBINE_CONNECT_AND_WRITE_DESIRED) {
+    attempt->socket->EnableTCPFastOpenIfSupported();
+  }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
-  // This should only happen when we're waiting for the main connect to succeed.
-  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
-    NOTREACHED();
-    return;
+  net_log().AddEvent(NetLog::TYPE_TRANSPORT_CONNECT_JOB_ATTEMPT,
+                     base::Bind(&NetLogConnectAttemptCallback, attempt->index,
+                                &attempt->addresses));
+  attempt->start_time = base::TimeTicks::Now();
+  ConnectAttempt* attempt_ptr = attempt.get();
+  pending_connect_attempts_.push_back(std::move(attempt));
+
+  int rv = attempt_ptr->socket->Connect(
+      base::Bind(&TransportConnectJob::OnConnectAttemptComplete,
+                 base::Unretained(this), attempt_ptr));
+  if (rv == ERR_IO_PENDING) {
+    // Give the attempt a head start before racing the next address against
+    // it.
+    if (next_address_index_ < addresses_.size()) {
+      connection_attempt_timer_.Start(
+          FROM_HERE, connection_attempt_delay_, this,
+          &TransportConnectJob::OnConnectAttemptTimer);
+    }
+    return rv;
   }
 
+  FinishConnectAttempt(attempt_ptr, rv);
+  return rv;
+}
+
+void TransportConnectJob::OnConnectAttemptComplete(ConnectAttempt* attempt,
+                                                   int result) {
+  // This should only happen when we're waiting for an attempt to succeed.
+  DCHECK_EQ(STATE_TRANSPORT_CONNECT_COMPLETE, next_state_);
   DCHECK_NE(ERR_IO_PENDING, result);
-  DCHECK(fallback_transport_socket_.get());
-  DCHECK(fallback_addresses_.get());
 
-  if (result == OK) {
-    DCHECK(!fallback_connect_start_time_.is_null());
+  FinishConnectAttempt(attempt, result);
 
-    // Success will be returned via the fallback socket, so also include
-    // connection attempts made on the main socket up to this point.
-    // (Unfortunately, the only simple way to return information in the success
-    // case is through the successfully-connected socket.)
-    if (transport_socket_) {
-      ConnectionAttempts attempts;
-      transport_socket_->GetConnectionAttempts(&attempts);
-      fallback_transport_socket_->AddConnectionAttempts(attempts);
-    }
+  // A failed attempt is followed by one to the next address right away.
+  int rv = result;
+  if (rv != OK) {
+    if (next_address_index_ < addresses_.size())
+      rv = StartConnectAttempts();
+    else if (!pending_connect_attempts_.empty())
+      rv = ERR_IO_PENDING;
+  }
+  if (rv != ERR_IO_PENDING)
+    OnIOComplete(rv);  // Deletes |this|
+}
 
-    connect_timing_.connect_start = fallback_connect_start_time_;
-    HistogramDuration(connect_timing_, RACE_IPV4_WINS);
-    SetSocket(std::move(fallback_transport_socket_));
-    next_state_ = STATE_NONE;
-  } else {
-    // Failure will be returned via |GetAdditionalErrorState|, so save
-    // connection attempts from both sockets for use there.
-    CopyConnectionAttemptsFromSockets();
+void TransportConnectJob::OnConnectAttemptTimer() {
+  // The timer should only fire while we're waiting for an attempt to succeed.
+  DCHECK_EQ(STATE_TRANSPORT_CONNECT_COMPLETE, next_state_);
 
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
-  }
+  int rv = StartConnectAttempts();
+  if (rv != ERR_IO_PENDING)
+    OnIOComplete(rv);  // Deletes |this|
+}
+
+void TransportConnectJob::FinishConnectAttempt(ConnectAttempt* attempt,
+                                               int result) {
+  base::TimeDelta duration = base::TimeTicks::Now() - attempt->start_time;
+  net_log().AddEvent(NetLog::TYPE_TRANSPORT_CONNECT_JOB_ATTEMPT_COMPLETE,
+                     base::Bind(&NetLogConnectAttemptCompleteCallback,
+                                attempt->index, result, duration));
 
-  transport_socket_.reset();
+  if (result == OK) {
+    if (race_addresses_) {
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Net.TCP_Connection_Race_Attempt_Latency_Success", duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10), 100);
+    }
+    DCHECK(!transport_socket_);
+    transport_socket_ = std::move(attempt->socket);
+    connected_to_ipv4_ =
+        attempt->addresses.front().GetFamily() == ADDRESS_FAMILY_IPV4;
+    winning_attempt_index_ = attempt->index;
+    winning_attempt_start_time_ = attempt->start_time;
+  } else {
+    if (race_addresses_) {
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Net.TCP_Connection_Race_Attempt_Latency_Failure", duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10), 100);
+    }
+    // Failure will be returned via |GetAdditionalErrorState|, or the winning
+    // socket, so save the connection attempts made on this one.
+    ConnectionAttempts attempts;
+    attempt->socket->GetConnectionAttempts(&attempts);
+    connection_attempts_.insert(connection_attempts_.end(), attempts.begin(),
+                                attempts.end());
+  }
 
-  NotifyDelegateOfCompletion(result);  // Deletes |this|
+  for (auto it = pending_connect_attempts_.begin();
+       it != pending_connect_attempts_.end(); ++it) {
+    if (it->get() == attempt) {
+      pending_connect_attempts_.erase(it);
+      break;
+    }
+  }
 }
 
 int TransportConnectJob::ConnectInternal() {
@@ -504,11 +648,11 @@ int TransportConnectJob::ConnectInternal() {
 }
 
 void TransportConnectJob::CopyConnectionAttemptsFromSockets() {
-  if (transport_socket_)
-    transport_socket_->GetConnectionAttempts(&connection_attempts_);
-  if (fallback_transport_socket_) {
-    fallback_transport_socket_->GetConnectionAttempts(
-        &fallback_connection_attempts_);
+  for (const auto& attempt : pending_connect_attempts_) {
+    ConnectionAttempts attempts;
+    attempt->socket->GetConnectionAttempts(&attempts);
+    connection_attempts_.insert(connection_attempts_.end(), attempts.begin(),
+                                attempts.end());
   }
 }
 
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -78,10 +79,12 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // and the transport (likely TCP) connect. TransportConnectJob also has fallback
 // logic for IPv6 connect() timeouts (which may happen due to networks / routers
 // with broken IPv6 support). Those timeouts take 20s, so rather than make the
-// user wait 20s for the timeout to fire, we use a fallback timer
-// (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
-// fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
-// a headstart) and return the one that completes first to the socket pool.
+// user wait 20s for the timeout to fire, when both IPv6 and IPv4 addresses are
+// resolved we race connections to them, as in "Happy Eyeballs" version 2
+// (RFC 8305): the addresses are interleaved by family, and a connect() to each
+// one is started after the previous one fails, or after a delay based on the
+// transport RTT of the network, whichever comes first. The first one to
+// complete is returned to the socket pool.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   // For recording the connection time in the appropriate bucket.
@@ -98,10 +101,15 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   static const int kTimeoutInSeconds;
 
   // In cases where both IPv6 and IPv4 addresses were returned from DNS,
-  // TransportConnectJobs will start a second connection attempt to just the
-  // IPv4 addresses after this many milliseconds. (This is "Happy Eyeballs".)
+  // TransportConnectJobs will start a connection attempt to the next address
+  // after this many milliseconds, if there's no estimate of the transport RTT
+  // to base the delay on. (This is "Happy Eyeballs".)
   static const int kIPv6FallbackTimerInMs;
 
+  // Bounds of the delay between connection attempts.
+  static const int kMinConnectionAttemptDelayInMs;
+  static const int kMaxConnectionAttemptDelayInMs;
+
   TransportConnectJob(
       const std::string& group_name,
       RequestPriority priority,
@@ -123,6 +131,15 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
+  // Reorders |addrlist| so that IPv6 and IPv4 addresses alternate, starting
+  // with the family of the first one, and otherwise keeping their order.
+  static void InterleaveAddressFamilies(AddressList* addrlist);
+
+  // Returns the delay between connection attempts, given the |transport_rtt|
+  // of the network.
+  static base::TimeDelta GetConnectionAttemptDelay(
+      base::TimeDelta transport_rtt);
+
   // Record the histograms Net.DNS_Resolution_And_TCP_Connection_Latency2 and
   // Net.TCP_Connection_Latency and return the connect duration.
   static base::TimeDelta HistogramDuration(
@@ -152,15 +169,38 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoTransportConnect();
   int DoTransportConnectComplete(int result);
 
+  // A connect() to some of |addresses_|, raced against the others.
+  struct ConnectAttempt {
+    ConnectAttempt();
+    ~ConnectAttempt();
+
+    int index;
+    AddressList addresses;
+    std::unique_ptr<StreamSocket> socket;
+    base::TimeTicks start_time;
+  };
+
   // Not part of the state machine.
-  void DoIPv6FallbackTransportConnect();
-  void DoIPv6FallbackTransportConnectComplete(int result);
+  //
+  // Starts attempts to the remaining addresses until one is pending or
+  // connects. Returns OK if one connected, ERR_IO_PENDING if any is pending,
+  // or the error of the last one otherwise.
+  int StartConnectAttempts();
+  // Returns OK, ERR_IO_PENDING, or an error if the attempt failed.
+  int StartConnectAttempt();
+  void OnConnectAttemptComplete(ConnectAttempt* attempt, int result);
+  void OnConnectAttemptTimer();
+  // Moves the socket of |attempt| to |transport_socket_|, or records its
+  // failure, and destroys the attempt.
+  void FinishConnectAttempt(ConnectAttempt* attempt, int result);
 
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
   // Otherwise, it returns a net error code.
   int ConnectInternal() override;
 
+  // Copies the connection attempts made on the sockets of
+  // |pending_connect_attempts_| to |connection_attempts_|.
   void CopyConnectionAttemptsFromSockets();
 
   scoped_refptr<TransportSocketParams> params_;
@@ -169,13 +209,24 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
 
   State next_state_;
 
+  // The connected socket, once an attempt succeeds.
   std::unique_ptr<StreamSocket> transport_socket_;
   AddressList addresses_;
 
-  std::unique_ptr<StreamSocket> fallback_transport_socket_;
-  std::unique_ptr<AddressList> fallback_addresses_;
-  base::TimeTicks fallback_connect_start_time_;
-  base::OneShotTimer fallback_timer_;
+  // Whether a connect() to each address is raced against the others, rather
+  // than trying them all in turn on a single socket.
+  bool race_addresses_;
+  base::TimeDelta connection_attempt_delay_;
+  // Index in |addresses_| of the next address to connect to.
+  size_t next_address_index_;
+  std::vector<std::unique_ptr<ConnectAttempt>> pending_connect_attempts_;
+  base::OneShotTimer connection_attempt_timer_;
+  // Whether the winning attempt was to an IPv4 address, and its start time.
+  bool connected_to_ipv4_;
+  int winning_attempt_index_;
+  base::TimeTicks winning_attempt_start_time_;
+  int connect_attempt_count_;
+
   SocketPerformanceWatcherFactory* socket_performance_watcher_factory_;
 
   // Track the interval between this connect and previous connect.
@@ -183,13 +234,12 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
 
   int resolve_result_;
 
-  // Used in the failure case to save connection attempts made on the main and
-  // fallback sockets and pass them on in |GetAdditionalErrorState|. (In the
+  // Saves connection attempts made on the sockets of finished attempts. In the
+  // failure case, they are passed on in |GetAdditionalErrorState|. (In the
   // success case, connection attempts are passed through the returned socket;
-  // attempts are copied from the other socket, if one exists, into it before
-  // it is returned.)
+  // attempts made on the other sockets are copied into it before it is
+  // returned.)
   ConnectionAttempts connection_attempts_;
-  ConnectionAttempts fallback_connection_attempts_;
 
   DISALLOW_COPY_AND_ASSIGN(TransportConnectJob);
 };
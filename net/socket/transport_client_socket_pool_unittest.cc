@@ -19,7 +19,10 @@
 #include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/log/test_net_log.h"
+#include "net/log/test_net_log_entry.h"
 #include "net/socket/client_socket_handle.h"
+#include "net/socket/socket_performance_watcher.h"
+#include "net/socket/socket_performance_watcher_factory.h"
 #include "net/socket/socket_test_util.h"
 #include "net/socket/stream_socket.h"
 #include "net/socket/transport_client_socket_pool_test_util.h"
@@ -35,6 +38,44 @@ const int kMaxSockets = 32;
 const int kMaxSocketsPerGroup = 6;
 const RequestPriority kDefaultPriority = LOW;
 
+class TestSocketPerformanceWatcher : public SocketPerformanceWatcher {
+ public:
+  TestSocketPerformanceWatcher() {}
+  ~TestSocketPerformanceWatcher() override {}
+
+  bool ShouldNotifyUpdatedRTT() const override { return false; }
+  void OnUpdatedRTTAvailable(const base::TimeDelta& rtt) override {}
+  void OnConnectionChanged() override {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TestSocketPerformanceWatcher);
+};
+
+// Estimates the transport RTT to be |transport_rtt|.
+class TestSocketPerformanceWatcherFactory
+    : public SocketPerformanceWatcherFactory {
+ public:
+  explicit TestSocketPerformanceWatcherFactory(base::TimeDelta transport_rtt)
+      : transport_rtt_(transport_rtt) {}
+  ~TestSocketPerformanceWatcherFactory() override {}
+
+  std::unique_ptr<SocketPerformanceWatcher> CreateSocketPerformanceWatcher(
+      const Protocol protocol) override {
+    return std::unique_ptr<SocketPerformanceWatcher>(
+        new TestSocketPerformanceWatcher());
+  }
+
+  bool GetTransportRTTEstimate(base::TimeDelta* rtt) const override {
+    *rtt = transport_rtt_;
+    return true;
+  }
+
+ private:
+  const base::TimeDelta transport_rtt_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestSocketPerformanceWatcherFactory);
+};
+
 class TransportClientSocketPoolTest : public testing::Test {
  protected:
   TransportClientSocketPoolTest()
@@ -172,6 +213,65 @@ TEST(TransportConnectJobTest, MakeAddrListStartWithIPv4) {
   EXPECT_EQ(ADDRESS_FAMILY_IPV6, addrlist[3].GetFamily());
 }
 
+TEST(TransportConnectJobTest, InterleaveAddressFamilies) {
+  IPEndPoint addrlist_v4_1(IPAddress(192, 168, 1, 1), 80);
+  IPEndPoint addrlist_v4_2(IPAddress(192, 168, 1, 2), 80);
+  IPAddress ip_address;
+  ASSERT_TRUE(ip_address.AssignFromIPLiteral("2001:4860:b006::64"));
+  IPEndPoint addrlist_v6_1(ip_address, 80);
+  ASSERT_TRUE(ip_address.AssignFromIPLiteral("2001:4860:b006::66"));
+  IPEndPoint addrlist_v6_2(ip_address, 80);
+
+  AddressList addrlist;
+
+  // Test 1: IPv6 only.  Expect no change.
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(2u, addrlist.size());
+  EXPECT_EQ(addrlist_v6_1, addrlist[0]);
+  EXPECT_EQ(addrlist_v6_2, addrlist[1]);
+
+  // Test 2: IPv6, IPv6, IPv4, IPv4.  Expect the families to alternate.
+  addrlist.clear();
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v4_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(4u, addrlist.size());
+  EXPECT_EQ(addrlist_v6_1, addrlist[0]);
+  EXPECT_EQ(addrlist_v4_1, addrlist[1]);
+  EXPECT_EQ(addrlist_v6_2, addrlist[2]);
+  EXPECT_EQ(addrlist_v4_2, addrlist[3]);
+
+  // Test 3: IPv4, IPv6, IPv6.  Expect the extra IPv6 address at the end.
+  addrlist.clear();
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(3u, addrlist.size());
+  EXPECT_EQ(addrlist_v4_1, addrlist[0]);
+  EXPECT_EQ(addrlist_v6_1, addrlist[1]);
+  EXPECT_EQ(addrlist_v6_2, addrlist[2]);
+}
+
+TEST(TransportConnectJobTest, ConnectionAttemptDelay) {
+  // Twice the RTT, within bounds.
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(300),
+            TransportConnectJob::GetConnectionAttemptDelay(
+                base::TimeDelta::FromMilliseconds(150)));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(
+                TransportConnectJob::kMinConnectionAttemptDelayInMs),
+            TransportConnectJob::GetConnectionAttemptDelay(
+                base::TimeDelta::FromMilliseconds(10)));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(
+                TransportConnectJob::kMaxConnectionAttemptDelayInMs),
+            TransportConnectJob::GetConnectionAttemptDelay(
+                base::TimeDelta::FromSeconds(5)));
+}
+
 TEST_F(TransportClientSocketPoolTest, Basic) {
   TestCompletionCallback callback;
   ClientSocketHandle handle;
@@ -950,6 +1050,112 @@ TEST_F(TransportClientSocketPoolTest, IPv6FallbackSocketIPv6FinishesFirst) {
   EXPECT_EQ(2, client_socket_factory_.allocation_count());
 }
 
+// Test that connects to all addresses are raced: a failed attempt is followed
+// by the next one right away, and a stalled one after the fallback delay.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackRacesAllAddresses) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets, kMaxSocketsPerGroup,
+                                 host_resolver_.get(), &client_socket_factory_,
+                                 NULL, NULL);
+
+  MockTransportClientSocketFactory::ClientSocketType case_types[] = {
+      // This is the first IPv6 socket.
+      MockTransportClientSocketFactory::MOCK_FAILING_CLIENT_SOCKET,
+      // This is the first IPv4 socket.
+      MockTransportClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+      // This is the second IPv6 socket.
+      MockTransportClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET};
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  // Resolve an AddressList with two IPv6 addresses first and then two IPv4
+  // addresses.
+  host_resolver_->rules()->AddIPLiteralRule(
+      "*", "2:abcd::3:4:ff,3:abcd::3:4:ff,2.2.2.2,3.3.3.3", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv =
+      handle.Init("a", params_, LOW, ClientSocketPool::RespectLimits::ENABLED,
+                  callback.callback(), &pool, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_TRUE(handle.is_initialized());
+  IPEndPoint endpoint;
+  handle.socket()->GetPeerAddress(&endpoint);
+  EXPECT_EQ("3:abcd::3:4:ff", endpoint.ToStringWithoutPort());
+
+  // Check that the failed connection attempt on the first socket is collected.
+  ConnectionAttempts attempts;
+  handle.socket()->GetConnectionAttempts(&attempts);
+  ASSERT_EQ(1u, attempts.size());
+  EXPECT_EQ(ERR_CONNECTION_FAILED, attempts[0].result);
+  EXPECT_EQ("2:abcd::3:4:ff", attempts[0].endpoint.ToStringWithoutPort());
+
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
+// Test that the fallback delay is based on the transport RTT, when known.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackDelayFromTransportRTT) {
+  // Create a pool without backup jobs, expecting a transport RTT that makes
+  // the fallback delay longer than the IPv6 connect takes.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TestSocketPerformanceWatcherFactory watcher_factory(
+      base::TimeDelta::FromMilliseconds(
+          TransportConnectJob::kMaxConnectionAttemptDelayInMs));
+  TransportClientSocketPool pool(kMaxSockets, kMaxSocketsPerGroup,
+                                 host_resolver_.get(), &client_socket_factory_,
+                                 &watcher_factory, &net_log_);
+
+  MockTransportClientSocketFactory::ClientSocketType case_types[] = {
+      // This is the IPv6 socket.
+      MockTransportClientSocketFactory::MOCK_DELAYED_CLIENT_SOCKET,
+      // This is the IPv4 socket, which should not be needed.
+      MockTransportClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET};
+
+  client_socket_factory_.set_client_socket_types(case_types, 2);
+  client_socket_factory_.set_delay(base::TimeDelta::FromMilliseconds(
+      TransportConnectJob::kIPv6FallbackTimerInMs + 50));
+
+  // Resolve an AddressList with a IPv6 address first and then a IPv4 address.
+  host_resolver_->rules()
+      ->AddIPLiteralRule("*", "2:abcd::3:4:ff,2.2.2.2", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv =
+      handle.Init("a", params_, LOW, ClientSocketPool::RespectLimits::ENABLED,
+                  callback.callback(), &pool, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  IPEndPoint endpoint;
+  handle.socket()->GetLocalAddress(&endpoint);
+  EXPECT_TRUE(endpoint.address().IsIPv6());
+  EXPECT_EQ(1, client_socket_factory_.allocation_count());
+
+  // The delay and the attempt are logged.
+  TestNetLogEntry::List entries;
+  net_log_.GetEntries(&entries);
+  int attempt_delay_ms = 0;
+  int attempt_count = 0;
+  int net_error = ERR_FAILED;
+  for (const auto& entry : entries) {
+    if (entry.type == NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE)
+      EXPECT_TRUE(entry.GetIntegerValue("attempt_delay_ms", &attempt_delay_ms));
+    if (entry.type == NetLog::TYPE_TRANSPORT_CONNECT_JOB_ATTEMPT)
+      ++attempt_count;
+    if (entry.type == NetLog::TYPE_TRANSPORT_CONNECT_JOB_ATTEMPT_COMPLETE)
+      EXPECT_TRUE(entry.GetNetErrorCode(&net_error));
+  }
+  EXPECT_EQ(TransportConnectJob::kMaxConnectionAttemptDelayInMs,
+            attempt_delay_ms);
+  EXPECT_EQ(1, attempt_count);
+  EXPECT_EQ(OK, net_error);
+}
+
 TEST_F(TransportClientSocketPoolTest, IPv6NoIPv4AddressesToFallbackTo) {
   // Create a pool without backup jobs.
   ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
@@ -18,6 +18,8 @@ using std::string;
 namespace {
 
 const char kCookieKey[] = "cookie";
+const char kCookieDelimiter[] = "; ";
+const char kNullDelimiter[] = "\0";
 
 }  // namespace
 
@@ -44,13 +46,17 @@ bool HpackDecoder::HandleControlFrameHeadersData(const char* headers_data,
       new_size > max_decode_buffer_size_bytes_) {
     return false;
   }
-  headers_block_buffer_.insert(headers_block_buffer_.end(), headers_data,
-                               headers_data + headers_data_length);
+  // Parse directly out of |headers_data| unless part of a representation is
+  // left over from the previous call.
+  StringPiece input(headers_data, headers_data_length);
+  if (!headers_block_buffer_.empty()) {
+    headers_block_buffer_.append(headers_data, headers_data_length);
+    input = headers_block_buffer_;
+  }
 
   // Parse as many data in buffer as possible. And remove the parsed data
   // from buffer.
-  HpackInputStream input_stream(max_string_literal_size_,
-                                headers_block_buffer_);
+  HpackInputStream input_stream(max_string_literal_size_, input);
 
   // If this is the start of the header block, process table size updates.
   if (!header_block_started_) {
@@ -68,8 +74,14 @@ bool HpackDecoder::HandleControlFrameHeadersData(const char* headers_data,
     }
   }
   uint32_t parsed_bytes = input_stream.ParsedBytes();
-  DCHECK_GE(headers_block_buffer_.size(), parsed_bytes);
-  headers_block_buffer_.erase(0, parsed_bytes);
+  DCHECK_GE(input.size(), parsed_bytes);
+  if (headers_block_buffer_.empty()) {
+    // Only buffer a trailing, incomplete representation.
+    input.remove_prefix(parsed_bytes);
+    input.CopyToString(&headers_block_buffer_);
+  } else {
+    headers_block_buffer_.erase(0, parsed_bytes);
+  }
   total_parsed_bytes_ += parsed_bytes;
   header_block_started_ = true;
   return true;
@@ -114,17 +126,10 @@ bool HpackDecoder::HandleHeaderRepresentation(StringPiece name,
   }
 
   if (handler_ == nullptr) {
-    auto it = decoded_block_.find(name);
-    if (it == decoded_block_.end()) {
-      // This is a new key.
-      decoded_block_[name] = value;
-    } else {
-      // The key already exists, append |value| with appropriate delimiter.
-      string new_value = it->second.as_string();
-      new_value.append((name == kCookieKey) ? "; " : string(1, '\0'));
-      value.AppendToString(&new_value);
-      decoded_block_.ReplaceOrAppendHeader(name, new_value);
-    }
+    decoded_block_.AppendValueOrAddHeader(
+        name, value,
+        (name == kCookieKey) ? StringPiece(kCookieDelimiter)
+                             : StringPiece(kNullDelimiter, 1));
   } else {
     DCHECK(decoded_block_.empty());
     handler_->OnHeader(name, value);
@@ -221,7 +226,7 @@ bool HpackDecoder::DecodeNextIndexedHeader(HpackInputStream* input_stream) {
 bool HpackDecoder::DecodeNextLiteralHeader(HpackInputStream* input_stream,
                                            bool should_index) {
   StringPiece name;
-  if (!DecodeNextName(input_stream, &name)) {
+  if (!DecodeNextName(input_stream, should_index, &name)) {
     return false;
   }
 
@@ -243,6 +248,7 @@ bool HpackDecoder::DecodeNextLiteralHeader(HpackInputStream* input_stream,
 }
 
 bool HpackDecoder::DecodeNextName(HpackInputStream* input_stream,
+                                  bool should_index,
                                   StringPiece* next_name) {
   uint32_t index_or_zero = 0;
   if (!input_stream->DecodeNextUint32(&index_or_zero)) {
@@ -257,7 +263,9 @@ bool HpackDecoder::DecodeNextName(HpackInputStream* input_stream,
   if (entry == NULL) {
     return false;
   }
-  if (entry->IsStatic()) {
+  if (entry->IsStatic() || !should_index) {
+    // Static entries are never evicted, and dynamic ones are only evicted by
+    // an insertion, so the name can be referenced in place.
     *next_name = entry->name();
   } else {
     // |entry| could be evicted as part of this insertion. Preemptively copy.
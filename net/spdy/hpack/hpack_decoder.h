@@ -49,9 +49,9 @@ class NET_EXPORT_PRIVATE HpackDecoder {
   }
 
   // Called as headers data arrives. Returns false if an error occurred.
-  // TODO(jgraettinger): A future version of this method will incrementally
-  // parse and deliver headers via SpdyHeadersHandlerInterface. For now,
-  // header data is buffered until HandleControlFrameHeadersComplete().
+  // Complete header representations are decoded directly from |headers_data|;
+  // only a trailing, incomplete representation is buffered until more data
+  // arrives.
   bool HandleControlFrameHeadersData(const char* headers_data,
                                      size_t headers_data_length);
 
@@ -139,7 +139,11 @@ class NET_EXPORT_PRIVATE HpackDecoder {
   bool DecodeNextIndexedHeader(HpackInputStream* input_stream);
   bool DecodeNextLiteralHeader(HpackInputStream* input_stream,
                                bool should_index);
+  // Sets |next_name| to the name of the next literal representation. The name
+  // refers to the header table where possible, and is copied only if it may
+  // be evicted when the representation is indexed.
   bool DecodeNextName(HpackInputStream* input_stream,
+                      bool should_index,
                       base::StringPiece* next_name);
   bool DecodeNextStringLiteral(HpackInputStream* input_stream,
                                bool is_header_key,  // As distinct from a value.
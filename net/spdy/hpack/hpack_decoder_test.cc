@@ -32,7 +32,12 @@ class HpackDecoderPeer {
     decoder_->HandleHeaderRepresentation(name, value);
   }
   bool DecodeNextName(HpackInputStream* in, StringPiece* out) {
-    return decoder_->DecodeNextName(in, out);
+    return decoder_->DecodeNextName(in, true, out);
+  }
+  bool DecodeNextName(HpackInputStream* in,
+                      bool should_index,
+                      StringPiece* out) {
+    return decoder_->DecodeNextName(in, should_index, out);
   }
   HpackHeaderTable* header_table() { return &decoder_->header_table_; }
   const SpdyHeaderBlock& decoded_block() const {
@@ -177,6 +182,29 @@ TEST_P(HpackDecoderTest, DecodeWithIncompleteData) {
   EXPECT_EQ(24u, size);
 }
 
+// Complete representations are decoded in place, without being buffered.
+TEST_P(HpackDecoderTest, DecodeWithoutBuffering) {
+  if (handler_exists_) {
+    decoder_.HandleControlFrameHeadersStart(&handler_);
+  }
+  EXPECT_TRUE(HandleControlFrameHeadersData("\x82\x40\x03goo\x03gar"));
+  EXPECT_EQ("", decoder_peer_.headers_block_buffer());
+
+  // A representation split across calls is buffered until it is complete.
+  EXPECT_TRUE(HandleControlFrameHeadersData("\x40\x04sp"));
+  EXPECT_EQ("\x40\x04sp", decoder_peer_.headers_block_buffer());
+  EXPECT_TRUE(HandleControlFrameHeadersData(
+      "am\x04"
+      "eggs\x90"));
+  EXPECT_EQ("", decoder_peer_.headers_block_buffer());
+
+  EXPECT_TRUE(HandleControlFrameHeadersComplete(nullptr));
+  EXPECT_THAT(decoded_block(),
+              ElementsAre(Pair(":method", "GET"), Pair("goo", "gar"),
+                          Pair("spam", "eggs"),
+                          Pair("accept-encoding", "gzip, deflate")));
+}
+
 TEST_P(HpackDecoderTest, HandleHeaderRepresentation) {
   if (handler_exists_) {
     decoder_.HandleControlFrameHeadersStart(&handler_);
@@ -298,6 +326,26 @@ TEST_P(HpackDecoderTest, DecodeNextNameIndexed) {
   EXPECT_EQ(1u, input_stream.ParsedBytes());
 }
 
+// A dynamic table name is referenced in place unless indexing the
+// representation could evict it.
+TEST_P(HpackDecoderTest, DecodeNextNameIndexedDynamic) {
+  const HpackEntry* entry =
+      decoder_peer_.header_table()->TryAddEntry("foo", "bar");
+  ASSERT_NE(nullptr, entry);
+
+  StringPiece string_piece;
+  HpackInputStream no_index_stream(kLiteralBound, "\x3e");
+  EXPECT_TRUE(
+      decoder_peer_.DecodeNextName(&no_index_stream, false, &string_piece));
+  EXPECT_EQ("foo", string_piece);
+  EXPECT_EQ(entry->name().data(), string_piece.data());
+
+  HpackInputStream index_stream(kLiteralBound, "\x3e");
+  EXPECT_TRUE(decoder_peer_.DecodeNextName(&index_stream, true, &string_piece));
+  EXPECT_EQ("foo", string_piece);
+  EXPECT_NE(entry->name().data(), string_piece.data());
+}
+
 // Decoding an encoded name with an invalid index should fail.
 TEST_P(HpackDecoderTest, DecodeNextNameInvalidIndex) {
   // One more than the number of static table entries.
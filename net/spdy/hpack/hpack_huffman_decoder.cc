@@ -25,11 +25,13 @@
 
 #include "net/spdy/hpack/hpack_huffman_decoder.h"
 
+#include <algorithm>
 #include <bitset>
 #include <limits>
 #include <utility>
 
 #include "base/logging.h"
+#include "base/memory/singleton.h"
 #include "net/spdy/hpack/hpack_input_stream.h"
 
 namespace net {
@@ -173,8 +175,67 @@ bool IsEOSPrefix(HuffmanWord bits, HuffmanCodeLength bits_available) {
 
 #endif  // NDEBUG && !defined(DCHECK_ALWAYS_ON)
 
+// The number of leading bits of input used to index the fast decoding table.
+// Every code of at most this length, which includes all of the most common
+// symbols, is decoded with a single lookup, and so are pairs of short codes.
+const HuffmanCodeLength kFastDecodeBits = 10;
+
+// What the fast decoding table knows about input starting with a given
+// |kFastDecodeBits| bit prefix.
+struct FastDecodeEntry {
+  // The source symbols whose codes fit entirely within the prefix.
+  char symbols[2];
+  // The number of entries of |symbols| that are valid. Zero if the first code
+  // is longer than |kFastDecodeBits|.
+  uint8_t symbol_count;
+  // The total length of the codes of those symbols.
+  uint8_t code_length;
+};
+
+// A lookup table built from CodeLengthOfPrefix() and DecodeToCanonical().
+// It is a 4 KB Singleton rather than a constant so that it can't get out of
+// sync with the code tables above.
 }  // namespace
 
+struct HpackHuffmanFastDecodeTable {
+  HpackHuffmanFastDecodeTable();
+
+  static HpackHuffmanFastDecodeTable* GetInstance() {
+    return base::Singleton<HpackHuffmanFastDecodeTable>::get();
+  }
+
+  FastDecodeEntry entries[1 << kFastDecodeBits];
+};
+
+HpackHuffmanFastDecodeTable::HpackHuffmanFastDecodeTable() {
+  for (HuffmanWord prefix = 0; prefix < (1u << kFastDecodeBits); ++prefix) {
+    FastDecodeEntry& entry = entries[prefix];
+    entry.symbol_count = 0;
+    entry.code_length = 0;
+
+    // Decode as many codes as fit in the prefix, left justified with zeros
+    // after it. A code is decoded correctly if all of its bits are in the
+    // prefix, whatever the bits that follow.
+    HuffmanWord bits = prefix << (kHuffmanWordLength - kFastDecodeBits);
+    HuffmanCodeLength bits_available = kFastDecodeBits;
+    while (entry.symbol_count < arraysize(entry.symbols)) {
+      HuffmanCodeLength code_length =
+          HpackHuffmanDecoder::CodeLengthOfPrefix(bits);
+      if (code_length > bits_available) {
+        break;
+      }
+      HuffmanWord canonical =
+          HpackHuffmanDecoder::DecodeToCanonical(code_length, bits);
+      DCHECK_LT(canonical, 256u);
+      entry.symbols[entry.symbol_count++] =
+          HpackHuffmanDecoder::CanonicalToSource(canonical);
+      entry.code_length += code_length;
+      bits <<= code_length;
+      bits_available -= code_length;
+    }
+  }
+}
+
 // TODO(jamessynge): Should we read these magic numbers from
 // kLengthToFirstLJCode? Would that reduce cache consumption? Slow decoding?
 // TODO(jamessynge): Is this being inlined by the compiler? Should we inline
@@ -407,4 +468,68 @@ bool HpackHuffmanDecoder::DecodeString(HpackInputStream* in,
   }
 }
 
+bool HpackHuffmanDecoder::DecodeString(base::StringPiece in,
+                                       size_t out_capacity,
+                                       std::string* out) {
+  out->clear();
+  // The shortest code is 5 bits, which bounds the output size.
+  out->reserve(std::min(out_capacity, in.size() * 8 / kMinCodeLength));
+
+  const FastDecodeEntry* fast_table = HpackHuffmanFastDecodeTable::GetInstance()->entries;
+
+  // |bits| holds the next |bits_available| bits of input, left justified.
+  // It is refilled a byte at a time, so while input remains it holds more
+  // than 56 bits, enough for any code or for a fast table lookup.
+  uint64_t bits = 0;
+  size_t bits_available = 0;
+  size_t next_byte = 0;
+  while (true) {
+    while (bits_available <= 56 && next_byte < in.size()) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(in[next_byte++]))
+              << (56 - bits_available);
+      bits_available += 8;
+    }
+
+    // Fast path: decode one or two short codes with a single lookup.
+    const FastDecodeEntry& entry = fast_table[bits >> (64 - kFastDecodeBits)];
+    if (entry.symbol_count > 0 && entry.code_length <= bits_available) {
+      if (out->size() + entry.symbol_count > out_capacity) {
+        // Fill |out| to capacity, as the slow path would.
+        out->append(entry.symbols, out_capacity - out->size());
+        DLOG(WARNING) << "Output size too large: " << out_capacity;
+        return false;
+      }
+      out->append(entry.symbols, entry.symbol_count);
+      bits <<= entry.code_length;
+      bits_available -= entry.code_length;
+      continue;
+    }
+
+    // Slow path: a long code, or the end of the input.
+    const HuffmanWord high_bits = static_cast<HuffmanWord>(bits >> 32);
+    const HuffmanCodeLength code_length = CodeLengthOfPrefix(high_bits);
+    if (code_length > bits_available) {
+      // All of the input has been read. What's left must be the padding in
+      // the final byte, which should be a prefix of EOS.
+      DLOG_IF(WARNING, !IsEOSPrefix(high_bits, bits_available))
+          << "bits: 0b" << std::bitset<32>(high_bits)
+          << " (avail=" << bits_available << ")";
+      return bits_available < 8;
+    }
+    HuffmanWord canonical = DecodeToCanonical(code_length, high_bits);
+    if (canonical >= 256) {
+      // The EOS symbol must not be explicitly encoded.
+      DLOG(WARNING) << "EOS explicitly encoded!";
+      return false;
+    }
+    if (out->size() == out_capacity) {
+      DLOG(WARNING) << "Output size too large: " << out_capacity;
+      return false;
+    }
+    out->push_back(CanonicalToSource(canonical));
+    bits <<= code_length;
+    bits_available -= code_length;
+  }
+}
+
 }  // namespace net
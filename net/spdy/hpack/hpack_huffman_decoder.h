@@ -10,6 +10,7 @@
 
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "net/base/net_export.h"
 #include "net/spdy/hpack/hpack_input_stream.h"
 
@@ -39,8 +40,16 @@ class NET_EXPORT_PRIVATE HpackHuffmanDecoder {
                            size_t out_capacity,
                            std::string* out);
 
+  // As above, but decodes all of |in|, which must hold exactly one encoded
+  // string. Short codes are decoded one or two at a time with a single table
+  // lookup, rather than symbol by symbol through |in|'s bit-peeking methods.
+  static bool DecodeString(base::StringPiece in,
+                           size_t out_capacity,
+                           std::string* out);
+
  private:
   friend class test::HpackHuffmanDecoderPeer;
+  friend struct HpackHuffmanFastDecodeTable;
 
   // The following private methods are declared here rather than simply
   // inlined into DecodeString so that they can be tested directly.
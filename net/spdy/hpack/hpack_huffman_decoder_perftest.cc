@@ -0,0 +1,98 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/hpack/hpack_huffman_decoder.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/spdy/hpack/hpack_constants.h"
+#include "net/spdy/hpack/hpack_huffman_table.h"
+#include "net/spdy/hpack/hpack_input_stream.h"
+#include "net/spdy/hpack/hpack_output_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace {
+
+// Header values typical of responses for many small resources.
+const char* const kRepresentativeValues[] = {
+    "200",
+    "Mon, 21 Oct 2013 20:13:21 GMT",
+    "private, max-age=0",
+    "text/html; charset=utf-8",
+    "application/javascript",
+    "gzip",
+    "https://www.example.com/static/js/app.min.js?v=20160512",
+    "\"5d8c72a5edda8d6a:0\"",
+    "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+    "Accept-Encoding, User-Agent",
+};
+
+std::vector<std::string> EncodeValues() {
+  const HpackHuffmanTable& table = ObtainHpackHuffmanTable();
+  std::vector<std::string> encoded;
+  for (const char* value : kRepresentativeValues) {
+    HpackOutputStream output_stream;
+    table.EncodeString(value, &output_stream);
+    std::string encoded_value;
+    output_stream.TakeString(&encoded_value);
+    encoded.push_back(encoded_value);
+  }
+  return encoded;
+}
+
+size_t EncodedSize(const std::vector<std::string>& encoded) {
+  size_t size = 0;
+  for (const std::string& value : encoded)
+    size += value.size();
+  return size;
+}
+
+void LogNanosecondsPerKB(const char* name,
+                         const base::ElapsedTimer& elapsed_timer,
+                         size_t bytes) {
+  LOG(INFO) << name << ": "
+            << (elapsed_timer.Elapsed().InMicroseconds() * 1000 * 1024 /
+                static_cast<int64_t>(bytes))
+            << "ns per KB";
+}
+
+const size_t kIterations = 1 << 15;
+
+TEST(HpackHuffmanDecoderPerfTest, DecodeFromInputStream) {
+  std::vector<std::string> encoded = EncodeValues();
+  std::string decoded;
+  base::ElapsedTimer elapsed_timer;
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (const std::string& value : encoded) {
+      HpackInputStream input_stream(std::numeric_limits<uint32_t>::max(),
+                                    value);
+      CHECK(HpackHuffmanDecoder::DecodeString(
+          &input_stream, kDefaultMaxStringLiteralSize, &decoded));
+    }
+  }
+  LogNanosecondsPerKB("HpackInputStream", elapsed_timer,
+                      EncodedSize(encoded) * kIterations);
+}
+
+TEST(HpackHuffmanDecoderPerfTest, DecodeFromStringPiece) {
+  std::vector<std::string> encoded = EncodeValues();
+  std::string decoded;
+  base::ElapsedTimer elapsed_timer;
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (const std::string& value : encoded) {
+      CHECK(HpackHuffmanDecoder::DecodeString(
+          value, kDefaultMaxStringLiteralSize, &decoded));
+    }
+  }
+  LogNanosecondsPerKB("StringPiece", elapsed_timer,
+                      EncodedSize(encoded) * kIterations);
+}
+
+}  // namespace
+}  // namespace net
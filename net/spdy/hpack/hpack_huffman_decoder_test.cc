@@ -288,5 +288,68 @@ TEST_F(HpackHuffmanDecoderTest, RoundTripSymbolSequences) {
   }
 }
 
+TEST_F(HpackHuffmanDecoderTest, DecodeStringPieceSpecExamples) {
+  // clang-format off
+  std::string test_table[] = {
+    a2b_hex("f1e3c2e5f23a6ba0ab90f4ff"),
+    "www.example.com",
+    a2b_hex("a8eb10649cbf"),
+    "no-cache",
+    a2b_hex("25a849e95bb8e8b4bf"),
+    "custom-value",
+    a2b_hex("d07abe941054d444a8200595040b8166"
+            "e082a62d1bff"),
+    "Mon, 21 Oct 2013 20:13:21 GMT",
+    a2b_hex("94e7821dd7f2e6c7b335dfdfcd5b3960"
+            "d5af27087f3672c1ab270fb5291f9587"
+            "316065c003ed4ee5b1063d5007"),
+    "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+  };
+  // clang-format on
+  std::string buffer;
+  for (size_t i = 0; i != arraysize(test_table); i += 2) {
+    const std::string& encoded(test_table[i]);
+    const std::string& decoded(test_table[i + 1]);
+    EXPECT_TRUE(
+        HpackHuffmanDecoder::DecodeString(encoded, decoded.size(), &buffer));
+    EXPECT_EQ(decoded, buffer);
+
+    // With too small an output buffer, the first |limit| chars are decoded.
+    size_t limit = base::RandInt(0, decoded.size() - 1);
+    EXPECT_FALSE(HpackHuffmanDecoder::DecodeString(encoded, limit, &buffer));
+    EXPECT_EQ(decoded.substr(0, limit), buffer);
+  }
+}
+
+TEST_F(HpackHuffmanDecoderTest, DecodeStringPieceRoundTripsAllSymbols) {
+  std::string input;
+  std::string decoded;
+  for (size_t i = 0; i != 256; i++) {
+    input.clear();
+    auto ic = static_cast<char>(i);
+    input.push_back(ic);
+    for (size_t j = 0; j != 256; j++) {
+      input.push_back(static_cast<char>(j));
+      input.push_back(ic);
+    }
+    EXPECT_TRUE(HpackHuffmanDecoder::DecodeString(EncodeString(input),
+                                                  input.size(), &decoded));
+    EXPECT_EQ(input, decoded);
+  }
+}
+
+TEST_F(HpackHuffmanDecoderTest, DecodeStringPieceInvalidInput) {
+  std::string buffer;
+  // More than seven bits of padding.
+  EXPECT_FALSE(HpackHuffmanDecoder::DecodeString(a2b_hex("a8eb10649cbfff"),
+                                                 1024, &buffer));
+  // An explicitly encoded EOS.
+  EXPECT_FALSE(
+      HpackHuffmanDecoder::DecodeString(a2b_hex("ffffffff"), 1024, &buffer));
+  // Empty input decodes to an empty string.
+  EXPECT_TRUE(HpackHuffmanDecoder::DecodeString("", 1024, &buffer));
+  EXPECT_EQ("", buffer);
+}
+
 }  // namespace test
 }  // namespace net
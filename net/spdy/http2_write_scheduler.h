@@ -18,7 +18,6 @@
 #include <utility>
 #include <vector>
 
-#include "base/containers/linked_list.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/stl_util.h"
@@ -80,7 +79,7 @@ class Http2PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
   using StreamInfoVector = std::vector<StreamInfo*>;
   using StreamInfoMap = std::unordered_map<StreamIdType, StreamInfo*>;
 
-  struct StreamInfo : public base::LinkNode<StreamInfo> {
+  struct StreamInfo {
     // ID for this stream.
     StreamIdType id;
     // StreamInfo for parent stream.
@@ -113,6 +112,15 @@ class Http2PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
     }
   };
 
+  // Orders scheduling_queue_. Since ordinals are unique, no two ready streams
+  // compare equal.
+  struct StreamInfoComparator {
+    bool operator()(const StreamInfo* lhs, const StreamInfo* rhs) const {
+      return lhs->SchedulesBefore(*rhs);
+    }
+  };
+  using StreamInfoSet = std::set<StreamInfo*, StreamInfoComparator>;
+
   static bool Remove(StreamInfoVector* stream_infos,
                      const StreamInfo* stream_info);
 
@@ -139,10 +147,13 @@ class Http2PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
   void UpdatePrioritiesUnder(StreamInfo* stream_info);
 
   // Inserts stream into scheduling_queue_ at the appropriate location given
-  // its priority and ordinal. Time complexity is O(scheduling_queue.size()).
+  // its priority and ordinal. Time complexity is
+  // O(log(scheduling_queue_.size())).
   void Schedule(StreamInfo* stream_info);
 
-  // Removes stream from scheduling_queue_.
+  // Removes stream from scheduling_queue_. Must be called before the stream's
+  // priority or ordinal changes, since those determine its position. Time
+  // complexity is O(log(scheduling_queue_.size())).
   void Unschedule(StreamInfo* stream_info);
 
   // Return true if all internal invariants hold (useful for unit tests).
@@ -165,7 +176,7 @@ class Http2PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
   // picked as the next stream: some may have ancestor stream(s) that are ready
   // and unblocked. In these situations the occluded child streams are left in
   // the queue, to reduce churn.
-  base::LinkedList<StreamInfo> scheduling_queue_;
+  StreamInfoSet scheduling_queue_;
   // Ordinal value to assign to next node inserted into scheduling_queue_ when
   // |add_to_front == true|. Decremented after each assignment.
   int64_t head_ordinal_ = -1;
@@ -484,12 +495,11 @@ bool Http2PriorityWriteScheduler<StreamIdType>::ShouldYield(
     SPDY_BUG << "Stream " << stream_id << " not registered";
     return false;
   }
-  for (base::LinkNode<StreamInfo>* s = scheduling_queue_.head();
-       s != scheduling_queue_.end(); s = s->next()) {
-    if (stream_info == s->value()) {
+  for (const StreamInfo* s : scheduling_queue_) {
+    if (stream_info == s) {
       return false;
     }
-    if (!HasReadyAncestor(*s->value())) {
+    if (!HasReadyAncestor(*s)) {
       return true;
     }
   }
@@ -579,16 +589,18 @@ template <typename StreamIdType>
 void Http2PriorityWriteScheduler<StreamIdType>::UpdatePrioritiesUnder(
     StreamInfo* stream_info) {
   for (StreamInfo* child : stream_info->children) {
-    child->priority = stream_info->priority *
-                      (static_cast<float>(child->weight) /
-                       static_cast<float>(stream_info->total_child_weights));
+    float priority = stream_info->priority *
+                     (static_cast<float>(child->weight) /
+                      static_cast<float>(stream_info->total_child_weights));
     if (child->ready) {
-      // Reposition in scheduling_queue_. Use post-order for scheduling, to
-      // benefit from the fact that children have priority <= parent priority.
+      // Reposition in scheduling_queue_. The stream has to be unscheduled
+      // before its priority changes, since the priority is part of its key.
       Unschedule(child);
+      child->priority = priority;
       UpdatePrioritiesUnder(child);
       Schedule(child);
     } else {
+      child->priority = priority;
       UpdatePrioritiesUnder(child);
     }
   }
@@ -598,15 +610,8 @@ template <typename StreamIdType>
 void Http2PriorityWriteScheduler<StreamIdType>::Schedule(
     StreamInfo* stream_info) {
   DCHECK(!stream_info->ready);
-  for (base::LinkNode<StreamInfo>* s = scheduling_queue_.head();
-       s != scheduling_queue_.end(); s = s->next()) {
-    if (stream_info->SchedulesBefore(*s->value())) {
-      stream_info->InsertBefore(s);
-      stream_info->ready = true;
-      return;
-    }
-  }
-  stream_info->InsertAfter(scheduling_queue_.tail());
+  bool inserted = scheduling_queue_.insert(stream_info).second;
+  DCHECK(inserted);
   stream_info->ready = true;
 }
 
@@ -614,7 +619,8 @@ template <typename StreamIdType>
 void Http2PriorityWriteScheduler<StreamIdType>::Unschedule(
     StreamInfo* stream_info) {
   DCHECK(stream_info->ready);
-  stream_info->RemoveFromList();
+  size_t erased = scheduling_queue_.erase(stream_info);
+  DCHECK_EQ(1u, erased);
   stream_info->ready = false;
 }
 
@@ -634,9 +640,7 @@ bool Http2PriorityWriteScheduler<StreamIdType>::HasReadyStreams() const {
 
 template <typename StreamIdType>
 StreamIdType Http2PriorityWriteScheduler<StreamIdType>::PopNextReadyStream() {
-  for (base::LinkNode<StreamInfo>* s = scheduling_queue_.head();
-       s != scheduling_queue_.end(); s = s->next()) {
-    StreamInfo* stream_info = s->value();
+  for (StreamInfo* stream_info : scheduling_queue_) {
     if (!HasReadyAncestor(*stream_info)) {
       Unschedule(stream_info);
       return stream_info->id;
@@ -648,11 +652,7 @@ StreamIdType Http2PriorityWriteScheduler<StreamIdType>::PopNextReadyStream() {
 
 template <typename StreamIdType>
 size_t Http2PriorityWriteScheduler<StreamIdType>::NumReadyStreams() const {
-  base::LinkNode<StreamInfo>* node = scheduling_queue_.head();
-  size_t size = 0;
-  while (node != scheduling_queue_.end())
-    ++size;
-  return size;
+  return scheduling_queue_.size();
 }
 
 template <typename StreamIdType>
@@ -0,0 +1,77 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/http2_write_scheduler.h"
+
+#include <stdint.h>
+
+#include "base/logging.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/spdy/priority_write_scheduler.h"
+#include "net/spdy/spdy_protocol.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace {
+
+using SpdyStreamId = uint32_t;
+
+void LogNanosecondsPerWrite(const char* name,
+                            const base::ElapsedTimer& elapsed_timer,
+                            size_t writes) {
+  LOG(INFO) << name << ": "
+            << (elapsed_timer.Elapsed().InMicroseconds() * 1000 /
+                static_cast<int64_t>(writes))
+            << "ns per write";
+}
+
+// Registers |num_streams| streams with a mix of weights and dependencies
+// typical of a page load, marks them all ready, and then repeatedly pops the
+// next stream and marks it ready again, as happens when each stream has more
+// than one frame to write.
+void RunScheduler(const char* name,
+                  WriteScheduler<SpdyStreamId>* scheduler,
+                  bool http2_precedence,
+                  size_t num_streams) {
+  for (size_t i = 0; i < num_streams; ++i) {
+    SpdyStreamId stream_id = 2 * i + 1;
+    SpdyPriority priority = i % (kV3LowestPriority + 1);
+    if (http2_precedence) {
+      SpdyStreamId parent_id = i % 4 == 0 ? 0 : stream_id - 2;
+      scheduler->RegisterStream(
+          stream_id, SpdyStreamPrecedence(parent_id, 1 + 255 * priority / 7,
+                                          false));
+    } else {
+      scheduler->RegisterStream(stream_id, SpdyStreamPrecedence(priority));
+    }
+    scheduler->MarkStreamReady(stream_id, false);
+  }
+
+  const size_t kWrites = 1 << 16;
+  base::ElapsedTimer elapsed_timer;
+  for (size_t i = 0; i < kWrites; ++i) {
+    SpdyStreamId stream_id = scheduler->PopNextReadyStream();
+    scheduler->MarkStreamReady(stream_id, false);
+  }
+  LogNanosecondsPerWrite(name, elapsed_timer, kWrites);
+}
+
+TEST(Http2WriteSchedulerPerfTest, PriorityWriteScheduler) {
+  for (size_t num_streams : {10u, 100u, 1000u}) {
+    PriorityWriteScheduler<SpdyStreamId> scheduler;
+    LOG(INFO) << num_streams << " streams";
+    RunScheduler("PriorityWriteScheduler", &scheduler, false, num_streams);
+  }
+}
+
+TEST(Http2WriteSchedulerPerfTest, Http2PriorityWriteScheduler) {
+  for (size_t num_streams : {10u, 100u, 1000u}) {
+    Http2PriorityWriteScheduler<SpdyStreamId> scheduler;
+    LOG(INFO) << num_streams << " streams";
+    RunScheduler("Http2PriorityWriteScheduler", &scheduler, true, num_streams);
+  }
+}
+
+}  // namespace
+}  // namespace net
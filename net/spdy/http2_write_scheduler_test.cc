@@ -536,6 +536,45 @@ TEST_F(Http2PriorityWriteSchedulerTest, HasReadyStreams) {
   ASSERT_TRUE(peer_.ValidateInvariants());
 }
 
+TEST_F(Http2PriorityWriteSchedulerTest, NumReadyStreams) {
+  EXPECT_EQ(0u, scheduler_.NumReadyStreams());
+  scheduler_.RegisterStream(1, SpdyStreamPrecedence(0, 10, false));
+  scheduler_.RegisterStream(3, SpdyStreamPrecedence(1, 20, false));
+  EXPECT_EQ(0u, scheduler_.NumReadyStreams());
+  scheduler_.MarkStreamReady(1, false);
+  scheduler_.MarkStreamReady(3, false);
+  EXPECT_EQ(2u, scheduler_.NumReadyStreams());
+  scheduler_.MarkStreamReady(3, true);
+  EXPECT_EQ(2u, scheduler_.NumReadyStreams());
+  EXPECT_EQ(1u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(1u, scheduler_.NumReadyStreams());
+  scheduler_.UnregisterStream(3);
+  EXPECT_EQ(0u, scheduler_.NumReadyStreams());
+  ASSERT_TRUE(peer_.ValidateInvariants());
+}
+
+TEST_F(Http2PriorityWriteSchedulerTest, UpdatePrecedenceOfReadyStreams) {
+  scheduler_.RegisterStream(1, SpdyStreamPrecedence(0, 10, false));
+  scheduler_.RegisterStream(3, SpdyStreamPrecedence(0, 20, false));
+  scheduler_.RegisterStream(5, SpdyStreamPrecedence(3, 20, false));
+  scheduler_.RegisterStream(7, SpdyStreamPrecedence(3, 20, false));
+  for (int i = 1; i < 8; i += 2) {
+    scheduler_.MarkStreamReady(i, false);
+  }
+  scheduler_.MarkStreamNotReady(3);
+
+  // Streams 5 and 7 share stream 3's share of the root, which outweighs
+  // stream 1. Moving them under stream 1 reorders the scheduling queue.
+  scheduler_.UpdateStreamPrecedence(7, SpdyStreamPrecedence(1, 20, false));
+  scheduler_.UpdateStreamPrecedence(3, SpdyStreamPrecedence(0, 1, false));
+  EXPECT_EQ(3u, scheduler_.NumReadyStreams());
+  EXPECT_EQ(1u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(7u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(5u, scheduler_.PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+  ASSERT_TRUE(peer_.ValidateInvariants());
+}
+
 TEST_F(Http2PriorityWriteSchedulerTest, CalculateRoundedWeights) {
   /* Create the tree.
 
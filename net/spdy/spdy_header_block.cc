@@ -4,6 +4,8 @@
 
 #include "net/spdy/spdy_header_block.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <ios>
 #include <utility>
@@ -47,6 +49,18 @@ class SpdyHeaderBlock::Storage {
     return StringPiece(arena_.Memdup(s.data(), s.size()), s.size());
   }
 
+  // Returns |s| followed by |separator| and |suffix|. If |s| is the most
+  // recent allocation from arena_ and fits, it is extended in place.
+  StringPiece Append(const StringPiece s,
+                     const StringPiece separator,
+                     const StringPiece suffix) {
+    const size_t size = s.size() + separator.size() + suffix.size();
+    char* out = arena_.Realloc(const_cast<char*>(s.data()), s.size(), size);
+    memcpy(out + s.size(), separator.data(), separator.size());
+    memcpy(out + s.size() + separator.size(), suffix.data(), suffix.size());
+    return StringPiece(out, size);
+  }
+
   // If |s| points to the most recent allocation from arena_, the arena will
   // reclaim the memory. Otherwise, this method is a no-op.
   void Rewind(const StringPiece s) {
@@ -218,9 +232,25 @@ void SpdyHeaderBlock::ReplaceOrAppendHeader(const StringPiece key,
   }
 }
 
+void SpdyHeaderBlock::AppendValueOrAddHeader(const StringPiece key,
+                                             const StringPiece value,
+                                             const StringPiece separator) {
+  auto iter = block_.find(key);
+  if (iter == block_.end()) {
+    DVLOG(1) << "Inserting: (" << key << ", " << value << ")";
+    AppendHeader(key, value);
+    return;
+  }
+  DVLOG(1) << "Appending to key: " << iter->first << " value: " << value;
+  iter->second = storage_->Append(iter->second, separator, value);
+}
+
 void SpdyHeaderBlock::AppendHeader(const StringPiece key,
                                    const StringPiece value) {
-  block_.insert(make_pair(storage_->Write(key), storage_->Write(value)));
+  // Write the value last, so that AppendValueOrAddHeader() can extend it in
+  // place.
+  const StringPiece out_key = storage_->Write(key);
+  block_.insert(make_pair(out_key, storage_->Write(value)));
 }
 
 std::unique_ptr<base::Value> SpdyHeaderBlockNetLogCallback(
@@ -85,6 +85,13 @@ class NET_EXPORT SpdyHeaderBlock {
   void ReplaceOrAppendHeader(const base::StringPiece key,
                              const base::StringPiece value);
 
+  // If |key| is not present, adds it with |value|. Otherwise appends
+  // |separator| and |value| to the existing value, growing it in place when it
+  // was the most recent write to the backing storage.
+  void AppendValueOrAddHeader(const base::StringPiece key,
+                              const base::StringPiece value,
+                              const base::StringPiece separator);
+
   // Allows either lookup or mutation of the value associated with a key.
   StringPieceProxy operator[](const base::StringPiece key);
 
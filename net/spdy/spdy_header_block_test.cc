@@ -13,6 +13,7 @@
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+using base::StringPiece;
 using std::make_pair;
 using std::string;
 using ::testing::ElementsAre;
@@ -96,6 +97,26 @@ TEST(SpdyHeaderBlockTest, AddHeaders) {
   EXPECT_EQ("", block1.GetHeader("key"));
 }
 
+TEST(SpdyHeaderBlockTest, AppendValueOrAddHeader) {
+  SpdyHeaderBlock block;
+  block.AppendValueOrAddHeader("foo", "bar", "; ");
+  EXPECT_EQ("bar", block.GetHeader("foo"));
+
+  // The most recently written value is extended in place.
+  const char* value_data = block.GetHeader("foo").data();
+  block.AppendValueOrAddHeader("foo", "baz", "; ");
+  EXPECT_EQ("bar; baz", block.GetHeader("foo"));
+  EXPECT_EQ(value_data, block.GetHeader("foo").data());
+
+  // Older values are copied.
+  block.AppendValueOrAddHeader("qux", "", StringPiece("\0", 1));
+  block.AppendValueOrAddHeader("foo", "", StringPiece("\0", 1));
+  block.AppendValueOrAddHeader("qux", "quux", StringPiece("\0", 1));
+  EXPECT_EQ(StringPiece("bar; baz\0", 9), block.GetHeader("foo"));
+  EXPECT_EQ(StringPiece("\0quux", 5), block.GetHeader("qux"));
+  EXPECT_EQ(2u, block.size());
+}
+
 // This test verifies that SpdyHeaderBlock can be copied.
 TEST(SpdyHeaderBlockTest, CopyBlocks) {
   SpdyHeaderBlock block1;
@@ -0,0 +1,90 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace net {
+
+// static
+const size_t QuicBatchPacketWriter::kMaxBatchSize;
+
+QuicBatchPacketWriter::QuicBatchPacketWriter(int fd)
+    : QuicDefaultPacketWriter(fd) {}
+
+QuicBatchPacketWriter::~QuicBatchPacketWriter() {}
+
+WriteResult QuicBatchPacketWriter::WritePacket(const char* buffer,
+                                               size_t buf_len,
+                                               const IPAddress& self_address,
+                                               const IPEndPoint& peer_address,
+                                               PerPacketOptions* options) {
+  DCHECK(!IsWriteBlocked());
+  DCHECK(nullptr == options)
+      << "QuicBatchPacketWriter does not accept any options.";
+  DCHECK_LE(buf_len, kMaxPacketSize);
+  char* batch_buffer = GetBuffer(buffered_writes_.size());
+  // Packets serialized into GetNextWriteLocation() are already in place.
+  if (buffer != batch_buffer)
+    memcpy(batch_buffer, buffer, buf_len);
+  buffered_writes_.push_back(QuicSocketUtils::BufferedWrite(
+      batch_buffer, buf_len, self_address, peer_address));
+  if (buffered_writes_.size() < kMaxBatchSize)
+    return WriteResult(WRITE_STATUS_OK, buf_len);
+
+  WriteResult result = Flush();
+  if (result.status == WRITE_STATUS_OK)
+    return WriteResult(WRITE_STATUS_OK, buf_len);
+  return result;
+}
+
+bool QuicBatchPacketWriter::IsWriteBlockedDataBuffered() const {
+  return true;
+}
+
+char* QuicBatchPacketWriter::GetNextWriteLocation() {
+  return GetBuffer(buffered_writes_.size());
+}
+
+WriteResult QuicBatchPacketWriter::Flush() {
+  if (IsWriteBlocked())
+    return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+  if (buffered_writes_.empty())
+    return WriteResult(WRITE_STATUS_OK, 0);
+
+  size_t num_packets_sent = 0;
+  WriteResult result = QuicSocketUtils::WriteMultiplePackets(
+      fd(), buffered_writes_.data(), buffered_writes_.size(),
+      &num_packets_sent);
+  size_t num_packets_done = num_packets_sent;
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    set_write_blocked(true);
+  } else if (result.status == WRITE_STATUS_ERROR) {
+    // Drop the packet which failed, so that the rest aren't stuck behind it.
+    ++num_packets_done;
+  }
+
+  // Move the buffers of the packets still batched to the front, along with
+  // their writes, which keep pointing into them.
+  buffered_writes_.erase(buffered_writes_.begin(),
+                         buffered_writes_.begin() + num_packets_done);
+  std::rotate(buffers_.begin(), buffers_.begin() + num_packets_done,
+              buffers_.end());
+  return result;
+}
+
+char* QuicBatchPacketWriter::GetBuffer(size_t index) {
+  DCHECK_LE(index, buffers_.size());
+  if (index == buffers_.size())
+    buffers_.push_back(std::unique_ptr<char[]>(new char[kMaxPacketSize]));
+  return buffers_[index].get();
+}
+
+}  // namespace net
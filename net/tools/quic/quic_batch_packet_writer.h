@@ -0,0 +1,58 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "net/tools/quic/quic_default_packet_writer.h"
+#include "net/tools/quic/quic_socket_utils.h"
+
+namespace net {
+
+// Packet writer which holds on to packets and writes them out together with
+// sendmmsg(), once it has a full batch or is flushed. Packets are serialized
+// straight into the buffers of the batch, so they aren't copied on the way to
+// the socket. Packets which are batched when the socket becomes write blocked
+// are written once it becomes writable and the writer is flushed again.
+class QuicBatchPacketWriter : public QuicDefaultPacketWriter {
+ public:
+  // The number of packets after which the batch is written out.
+  static const size_t kMaxBatchSize = 16;
+
+  explicit QuicBatchPacketWriter(int fd);
+  ~QuicBatchPacketWriter() override;
+
+  // QuicPacketWriter
+  WriteResult WritePacket(const char* buffer,
+                          size_t buf_len,
+                          const IPAddress& self_address,
+                          const IPEndPoint& peer_address,
+                          PerPacketOptions* options) override;
+  bool IsWriteBlockedDataBuffered() const override;
+  char* GetNextWriteLocation() override;
+  WriteResult Flush() override;
+
+  size_t batched_packet_count() const { return buffered_writes_.size(); }
+
+ private:
+  // Returns the buffer for the |index|th batched packet.
+  char* GetBuffer(size_t index);
+
+  std::vector<QuicSocketUtils::BufferedWrite> buffered_writes_;
+  // buffers_[i] holds the packet of buffered_writes_[i]. Grows beyond
+  // kMaxBatchSize only if packets are written while a full batch is blocked.
+  std::vector<std::unique_ptr<char[]>> buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBatchPacketWriter);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
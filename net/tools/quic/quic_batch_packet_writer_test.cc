@@ -0,0 +1,149 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/sockaddr_storage.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+int CreateLoopbackSocket(IPEndPoint* address) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+  EXPECT_LE(0, fd);
+  IPEndPoint any(IPAddress::IPv4Localhost(), 0);
+  SockaddrStorage storage;
+  EXPECT_TRUE(any.ToSockAddr(storage.addr, &storage.addr_len));
+  EXPECT_EQ(0, bind(fd, storage.addr, storage.addr_len));
+  storage = SockaddrStorage();
+  EXPECT_EQ(0, getsockname(fd, storage.addr, &storage.addr_len));
+  EXPECT_TRUE(address->FromSockAddr(storage.addr, storage.addr_len));
+  return fd;
+}
+
+class TestBatchPacketWriter : public QuicBatchPacketWriter {
+ public:
+  explicit TestBatchPacketWriter(int fd) : QuicBatchPacketWriter(fd) {}
+
+  using QuicBatchPacketWriter::set_write_blocked;
+};
+
+class QuicBatchPacketWriterTest : public ::testing::Test {
+ protected:
+  QuicBatchPacketWriterTest() {
+    send_fd_ = CreateLoopbackSocket(&send_address_);
+    receive_fd_ = CreateLoopbackSocket(&receive_address_);
+    writer_.reset(new TestBatchPacketWriter(send_fd_));
+  }
+
+  ~QuicBatchPacketWriterTest() override {
+    close(send_fd_);
+    close(receive_fd_);
+  }
+
+  WriteResult WritePacket(const std::string& packet) {
+    return writer_->WritePacket(packet.data(), packet.size(), IPAddress(),
+                                receive_address_, nullptr);
+  }
+
+  // Returns the packets which have arrived at |receive_fd_|.
+  std::vector<std::string> ReadPackets() {
+    std::vector<std::string> packets;
+    char buffer[kMaxPacketSize];
+    ssize_t rv;
+    while ((rv = recv(receive_fd_, buffer, sizeof(buffer), 0)) >= 0)
+      packets.push_back(std::string(buffer, rv));
+    return packets;
+  }
+
+  int send_fd_;
+  int receive_fd_;
+  IPEndPoint send_address_;
+  IPEndPoint receive_address_;
+  std::unique_ptr<TestBatchPacketWriter> writer_;
+};
+
+TEST_F(QuicBatchPacketWriterTest, BatchesUntilFlushed) {
+  EXPECT_TRUE(writer_->IsWriteBlockedDataBuffered());
+
+  WriteResult result = WritePacket("first");
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(5, result.bytes_written);
+  EXPECT_EQ(WRITE_STATUS_OK, WritePacket("second").status);
+  EXPECT_EQ(2u, writer_->batched_packet_count());
+  EXPECT_TRUE(ReadPackets().empty());
+
+  result = writer_->Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(11, result.bytes_written);
+  EXPECT_EQ(0u, writer_->batched_packet_count());
+
+  std::vector<std::string> packets = ReadPackets();
+  ASSERT_EQ(2u, packets.size());
+  EXPECT_EQ("first", packets[0]);
+  EXPECT_EQ("second", packets[1]);
+
+  // Flushing with nothing batched is a no-op.
+  EXPECT_EQ(WRITE_STATUS_OK, writer_->Flush().status);
+}
+
+TEST_F(QuicBatchPacketWriterTest, WritesFullBatch) {
+  for (size_t i = 0; i < QuicBatchPacketWriter::kMaxBatchSize; ++i)
+    EXPECT_EQ(WRITE_STATUS_OK, WritePacket(std::to_string(i)).status);
+  EXPECT_EQ(0u, writer_->batched_packet_count());
+
+  std::vector<std::string> packets = ReadPackets();
+  ASSERT_EQ(QuicBatchPacketWriter::kMaxBatchSize, packets.size());
+  for (size_t i = 0; i < packets.size(); ++i)
+    EXPECT_EQ(std::to_string(i), packets[i]);
+}
+
+TEST_F(QuicBatchPacketWriterTest, WritesInPlace) {
+  // A packet serialized into the next write location isn't copied.
+  char* location = writer_->GetNextWriteLocation();
+  ASSERT_NE(nullptr, location);
+  memcpy(location, "in place", 8);
+  EXPECT_EQ(WRITE_STATUS_OK,
+            writer_
+                ->WritePacket(location, 8, IPAddress(), receive_address_,
+                              nullptr)
+                .status);
+  EXPECT_NE(location, writer_->GetNextWriteLocation());
+
+  EXPECT_EQ(WRITE_STATUS_OK, writer_->Flush().status);
+  std::vector<std::string> packets = ReadPackets();
+  ASSERT_EQ(1u, packets.size());
+  EXPECT_EQ("in place", packets[0]);
+}
+
+TEST_F(QuicBatchPacketWriterTest, KeepsBatchWhileBlocked) {
+  EXPECT_EQ(WRITE_STATUS_OK, WritePacket("packet").status);
+  writer_->set_write_blocked(true);
+  EXPECT_EQ(WRITE_STATUS_BLOCKED, writer_->Flush().status);
+  EXPECT_EQ(1u, writer_->batched_packet_count());
+  EXPECT_TRUE(ReadPackets().empty());
+
+  writer_->SetWritable();
+  EXPECT_EQ(WRITE_STATUS_OK, writer_->Flush().status);
+  std::vector<std::string> packets = ReadPackets();
+  ASSERT_EQ(1u, packets.size());
+  EXPECT_EQ("packet", packets[0]);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -39,4 +39,12 @@ QuicByteCount QuicPerConnectionPacketWriter::GetMaxPacketSize(
   return shared_writer_->GetMaxPacketSize(peer_address);
 }
 
+char* QuicPerConnectionPacketWriter::GetNextWriteLocation() {
+  return shared_writer_->GetNextWriteLocation();
+}
+
+WriteResult QuicPerConnectionPacketWriter::Flush() {
+  return shared_writer_->Flush();
+}
+
 }  // namespace net
@@ -33,6 +33,8 @@ class QuicPerConnectionPacketWriter : public QuicPacketWriter {
   bool IsWriteBlocked() const override;
   void SetWritable() override;
   QuicByteCount GetMaxPacketSize(const IPEndPoint& peer_address) const override;
+  char* GetNextWriteLocation() override;
+  WriteResult Flush() override;
 
  private:
   QuicPacketWriter* shared_writer_;  // Not owned.
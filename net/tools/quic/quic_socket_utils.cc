@@ -10,6 +10,7 @@
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
+#include <algorithm>
 #include <string>
 
 #include "base/logging.h"
@@ -23,6 +24,13 @@
 
 namespace net {
 
+namespace {
+
+// The largest number of packets handed to a single sendmmsg() call.
+const size_t kMaxPacketsPerSendmmsg = 16;
+
+}  // namespace
+
 // static
 void QuicSocketUtils::GetAddressAndTimestampFromMsghdr(struct msghdr* hdr,
                                                        IPAddress* address,
@@ -258,6 +266,72 @@ WriteResult QuicSocketUtils::WritePacket(int fd,
                      errno);
 }
 
+// static
+WriteResult QuicSocketUtils::WriteMultiplePackets(int fd,
+                                                  const BufferedWrite* writes,
+                                                  size_t count,
+                                                  size_t* num_packets_sent) {
+  const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
+  const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
+  // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
+  const int kSpaceForIp =
+      (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
+
+  sockaddr_storage raw_addresses[kMaxPacketsPerSendmmsg];
+  iovec iovs[kMaxPacketsPerSendmmsg];
+  char cbufs[kMaxPacketsPerSendmmsg][kSpaceForIp];
+  mmsghdr hdrs[kMaxPacketsPerSendmmsg];
+
+  *num_packets_sent = 0;
+  size_t bytes_written = 0;
+  while (*num_packets_sent < count) {
+    const BufferedWrite* batch = writes + *num_packets_sent;
+    size_t batch_size =
+        std::min(count - *num_packets_sent, kMaxPacketsPerSendmmsg);
+    for (size_t i = 0; i < batch_size; ++i) {
+      socklen_t address_len = sizeof(raw_addresses[i]);
+      CHECK(batch[i].peer_address.ToSockAddr(
+          reinterpret_cast<struct sockaddr*>(&raw_addresses[i]),
+          &address_len));
+      iovs[i].iov_base = const_cast<char*>(batch[i].buffer);
+      iovs[i].iov_len = batch[i].buf_len;
+
+      msghdr* hdr = &hdrs[i].msg_hdr;
+      hdr->msg_name = &raw_addresses[i];
+      hdr->msg_namelen = address_len;
+      hdr->msg_iov = &iovs[i];
+      hdr->msg_iovlen = 1;
+      hdr->msg_flags = 0;
+      if (batch[i].self_address.empty()) {
+        hdr->msg_control = 0;
+        hdr->msg_controllen = 0;
+      } else {
+        hdr->msg_control = cbufs[i];
+        hdr->msg_controllen = kSpaceForIp;
+        cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+        SetIpInfoInCmsg(batch[i].self_address, cmsg);
+        hdr->msg_controllen = cmsg->cmsg_len;
+      }
+      hdrs[i].msg_len = 0;
+    }
+
+    int rc;
+    do {
+      rc = sendmmsg(fd, hdrs, batch_size, 0);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0) {
+      return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK)
+                             ? WRITE_STATUS_BLOCKED
+                             : WRITE_STATUS_ERROR,
+                         errno);
+    }
+    for (int i = 0; i < rc; ++i)
+      bytes_written += hdrs[i].msg_len;
+    *num_packets_sent += rc;
+  }
+  return WriteResult(WRITE_STATUS_OK, bytes_written);
+}
+
 // static
 int QuicSocketUtils::CreateUDPSocket(const IPEndPoint& address,
                                      bool* overflow_supported) {
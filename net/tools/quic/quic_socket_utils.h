@@ -104,6 +104,34 @@ class QuicSocketUtils {
                                  const IPAddress& self_address,
                                  const IPEndPoint& peer_address);
 
+  // A packet to be written by WriteMultiplePackets().
+  struct BufferedWrite {
+    BufferedWrite(const char* buffer,
+                  size_t buf_len,
+                  const IPAddress& self_address,
+                  const IPEndPoint& peer_address)
+        : buffer(buffer),
+          buf_len(buf_len),
+          self_address(self_address),
+          peer_address(peer_address) {}
+
+    const char* buffer;  // Not owned.
+    size_t buf_len;
+    IPAddress self_address;
+    IPEndPoint peer_address;
+  };
+
+  // Writes |count| packets from |writes| to the socket, with as few sendmmsg()
+  // calls as possible. Sets |num_packets_sent| to the number of packets
+  // written. If all of them are written, the result's status is
+  // WRITE_STATUS_OK and bytes_written is their total size. Otherwise the
+  // result is that of the first packet which couldn't be written, as for
+  // WritePacket().
+  static WriteResult WriteMultiplePackets(int fd,
+                                          const BufferedWrite* writes,
+                                          size_t count,
+                                          size_t* num_packets_sent);
+
   // A helper for WritePacket which fills in the cmsg with the supplied self
   // address.
   // Returns the length of the packet info structure used.
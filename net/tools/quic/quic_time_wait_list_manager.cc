@@ -247,6 +247,10 @@ bool QuicTimeWaitListManager::WriteToWire(QueuedPacket* queued_packet) {
       queued_packet->packet()->data(), queued_packet->packet()->length(),
       queued_packet->server_address().address(),
       queued_packet->client_address(), nullptr);
+  if (result.status == WRITE_STATUS_OK) {
+    // Time-wait packets are sent one at a time, so don't leave them batched.
+    result = writer_->Flush();
+  }
   if (result.status == WRITE_STATUS_BLOCKED) {
     // If blocked and unbuffered, return false to retry sending.
     DCHECK(writer_->IsWriteBlocked());
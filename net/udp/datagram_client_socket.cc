@@ -0,0 +1,19 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/udp/datagram_client_socket.h"
+
+#include "net/base/net_errors.h"
+
+namespace net {
+
+int DatagramClientSocket::ReadMultiple(IOBuffer* buf,
+                                       int packet_size,
+                                       int max_packets,
+                                       std::vector<int>* packet_lengths,
+                                       const CompletionCallback& callback) {
+  return ERR_NOT_IMPLEMENTED;
+}
+
+}  // namespace net
@@ -5,6 +5,8 @@
 #ifndef NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 #define NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 
+#include <vector>
+
 #include "net/base/network_change_notifier.h"
 #include "net/socket/socket.h"
 #include "net/udp/datagram_socket.h"
@@ -40,6 +42,18 @@ class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
   // ConnectUsingNetwork() or ConnectUsingDefaultNetwork().
   virtual NetworkChangeNotifier::NetworkHandle GetBoundNetwork() const = 0;
 
+  // Reads up to |max_packets| datagrams with a single system call where the
+  // platform allows. The i-th datagram is read into |buf| at offset
+  // i * |packet_size|, and its size is appended to |packet_lengths|, which is
+  // cleared first. Returns the number of datagrams read, or a net error code;
+  // on ERR_IO_PENDING, |callback| is run with that result later, and |buf|
+  // and |packet_lengths| must be kept alive until then. Sockets which don't
+  // support this return ERR_NOT_IMPLEMENTED, and callers should use Read().
+  virtual int ReadMultiple(IOBuffer* buf,
+                           int packet_size,
+                           int max_packets,
+                           std::vector<int>* packet_lengths,
+                           const CompletionCallback& callback);
 };
 
 }  // namespace net
@@ -83,6 +83,17 @@ int UDPClientSocket::Read(IOBuffer* buf,
   return socket_.Read(buf, buf_len, callback);
 }
 
+#if defined(OS_POSIX)
+int UDPClientSocket::ReadMultiple(IOBuffer* buf,
+                                  int packet_size,
+                                  int max_packets,
+                                  std::vector<int>* packet_lengths,
+                                  const CompletionCallback& callback) {
+  return socket_.ReadMultiple(buf, packet_size, max_packets, packet_lengths,
+                              callback);
+}
+#endif
+
 int UDPClientSocket::Write(IOBuffer* buf,
                           int buf_len,
                           const CompletionCallback& callback) {
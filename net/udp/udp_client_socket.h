@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "net/base/rand_callback.h"
 #include "net/log/net_log.h"
@@ -38,6 +40,13 @@ class NET_EXPORT_PRIVATE UDPClientSocket : public DatagramClientSocket {
   int Write(IOBuffer* buf,
             int buf_len,
             const CompletionCallback& callback) override;
+#if defined(OS_POSIX)
+  int ReadMultiple(IOBuffer* buf,
+                   int packet_size,
+                   int max_packets,
+                   std::vector<int>* packet_lengths,
+                   const CompletionCallback& callback) override;
+#endif
   void Close() override;
   int GetPeerAddress(IPEndPoint* address) const override;
   int GetLocalAddress(IPEndPoint* address) const override;
@@ -9,9 +9,12 @@
 #include <net/if.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
+#include <algorithm>
+
 #include "base/callback.h"
 #include "base/debug/alias.h"
 #include "base/files/file_util.h"
@@ -45,6 +48,11 @@ const int kBindRetries = 10;
 const int kPortStart = 1024;
 const int kPortEnd = 65535;
 
+#if defined(OS_LINUX)
+// The most datagrams read by a single recvmmsg() call.
+const int kMaxPacketsPerRecvMmsg = 16;
+#endif
+
 #if defined(OS_MACOSX)
 
 // Returns IPv4 address in network order.
@@ -84,6 +92,8 @@ UDPSocketPosix::UDPSocketPosix(DatagramSocket::BindType bind_type,
       write_watcher_(this),
       read_buf_len_(0),
       recv_from_address_(NULL),
+      read_packet_lengths_(NULL),
+      read_max_packets_(0),
       write_buf_len_(0),
       net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_UDP_SOCKET)),
       bound_network_(NetworkChangeNotifier::kInvalidNetworkHandle) {
@@ -125,6 +135,8 @@ void UDPSocketPosix::Close() {
   read_buf_len_ = 0;
   read_callback_.Reset();
   recv_from_address_ = NULL;
+  read_packet_lengths_ = NULL;
+  read_max_packets_ = 0;
   write_buf_ = NULL;
   write_buf_len_ = 0;
   write_callback_.Reset();
@@ -222,6 +234,42 @@ int UDPSocketPosix::RecvFrom(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketPosix::ReadMultiple(IOBuffer* buf,
+                                 int packet_size,
+                                 int max_packets,
+                                 std::vector<int>* packet_lengths,
+                                 const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  CHECK(read_callback_.is_null());
+  DCHECK(!recv_from_address_);
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK_GT(packet_size, 0);
+  DCHECK_GT(max_packets, 0);
+  DCHECK(packet_lengths);
+
+  int nread =
+      InternalRecvMultiple(buf, packet_size, max_packets, packet_lengths);
+  if (nread != ERR_IO_PENDING)
+    return nread;
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, base::MessageLoopForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    int result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  read_buf_ = buf;
+  read_buf_len_ = packet_size;
+  read_max_packets_ = max_packets;
+  read_packet_lengths_ = packet_lengths;
+  read_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketPosix::Write(IOBuffer* buf,
                           int buf_len,
                           const CompletionCallback& callback) {
@@ -449,12 +497,20 @@ void UDPSocketPosix::DoWriteCallback(int rv) {
 }
 
 void UDPSocketPosix::DidCompleteRead() {
-  int result =
-      InternalRecvFrom(read_buf_.get(), read_buf_len_, recv_from_address_);
+  int result;
+  if (read_packet_lengths_) {
+    result = InternalRecvMultiple(read_buf_.get(), read_buf_len_,
+                                  read_max_packets_, read_packet_lengths_);
+  } else {
+    result =
+        InternalRecvFrom(read_buf_.get(), read_buf_len_, recv_from_address_);
+  }
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    read_packet_lengths_ = NULL;
+    read_max_packets_ = 0;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -544,6 +600,49 @@ int UDPSocketPosix::InternalRecvFrom(IOBuffer* buf,
   return result;
 }
 
+int UDPSocketPosix::InternalRecvMultiple(IOBuffer* buf,
+                                         int packet_size,
+                                         int max_packets,
+                                         std::vector<int>* packet_lengths) {
+  packet_lengths->clear();
+#if defined(OS_LINUX)
+  int num_packets = std::min(max_packets, kMaxPacketsPerRecvMmsg);
+  SockaddrStorage storages[kMaxPacketsPerRecvMmsg];
+  iovec iovs[kMaxPacketsPerRecvMmsg];
+  mmsghdr hdrs[kMaxPacketsPerRecvMmsg];
+  memset(hdrs, 0, sizeof(hdrs));
+  for (int i = 0; i < num_packets; ++i) {
+    iovs[i].iov_base = buf->data() + i * packet_size;
+    iovs[i].iov_len = packet_size;
+    hdrs[i].msg_hdr.msg_name = storages[i].addr;
+    hdrs[i].msg_hdr.msg_namelen = storages[i].addr_len;
+    hdrs[i].msg_hdr.msg_iov = &iovs[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int result =
+      HANDLE_EINTR(recvmmsg(socket_, hdrs, num_packets, 0, nullptr));
+  if (result < 0) {
+    result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+  for (int i = 0; i < result; ++i) {
+    packet_lengths->push_back(hdrs[i].msg_len);
+    LogRead(hdrs[i].msg_len, buf->data() + i * packet_size,
+            hdrs[i].msg_hdr.msg_namelen, storages[i].addr);
+  }
+  return result;
+#else
+  int result = InternalRecvFrom(buf, packet_size, NULL);
+  if (result < 0)
+    return result;
+  packet_lengths->push_back(result);
+  return 1;
+#endif  // defined(OS_LINUX)
+}
+
 int UDPSocketPosix::InternalSendTo(IOBuffer* buf,
                                    int buf_len,
                                    const IPEndPoint* address) {
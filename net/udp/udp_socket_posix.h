@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -78,6 +79,18 @@ class NET_EXPORT UDPSocketPosix : public base::NonThreadSafe {
   // has been connected.
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Reads up to |max_packets| datagrams, the i-th into |buf| at offset
+  // i * |packet_size|, setting |packet_lengths| to their sizes. Uses a single
+  // recvmmsg() call on Linux, and reads one datagram elsewhere. Returns the
+  // number of datagrams read or a net error code, as for Read().
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int ReadMultiple(IOBuffer* buf,
+                   int packet_size,
+                   int max_packets,
+                   std::vector<int>* packet_lengths,
+                   const CompletionCallback& callback);
+
   // Writes to the socket.
   // Only usable from the client-side of a UDP socket, after the socket
   // has been connected.
@@ -247,6 +260,10 @@ class NET_EXPORT UDPSocketPosix : public base::NonThreadSafe {
 
   int InternalConnect(const IPEndPoint& address);
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
+  int InternalRecvMultiple(IOBuffer* buf,
+                           int packet_size,
+                           int max_packets,
+                           std::vector<int>* packet_lengths);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
 
   // Applies |socket_options_| to |socket_|. Should be called before
@@ -296,6 +313,10 @@ class NET_EXPORT UDPSocketPosix : public base::NonThreadSafe {
   scoped_refptr<IOBuffer> read_buf_;
   int read_buf_len_;
   IPEndPoint* recv_from_address_;
+  // Set while a ReadMultiple() is pending, in which case |read_buf_len_| is
+  // the size of each packet.
+  std::vector<int>* read_packet_lengths_;
+  int read_max_packets_;
 
   // The buffer used by InternalWrite() to retry Write requests
   scoped_refptr<IOBuffer> write_buf_;
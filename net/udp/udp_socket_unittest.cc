@@ -572,6 +572,61 @@ TEST_F(UDPSocketTest, ServerGetPeerAddress) {
   EXPECT_EQ(rv, ERR_SOCKET_NOT_CONNECTED);
 }
 
+#if defined(OS_POSIX)
+TEST_F(UDPSocketTest, ReadMultiple) {
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", 0, &bind_address);
+  UDPServerSocket server(NULL, NetLog::Source());
+  ASSERT_EQ(OK, server.Listen(bind_address));
+  IPEndPoint server_address;
+  ASSERT_EQ(OK, server.GetLocalAddress(&server_address));
+
+  UDPClientSocket client(DatagramSocket::DEFAULT_BIND, RandIntCallback(), NULL,
+                         NetLog::Source());
+  ASSERT_EQ(OK, client.Connect(server_address));
+  ASSERT_EQ(5, WriteSocket(&client, "hello"));
+  ASSERT_EQ("hello", RecvFromSocket(&server));
+
+  // Nothing has been sent yet, so the read completes asynchronously.
+  const int kPacketSize = 16;
+  const int kMaxPackets = 4;
+  scoped_refptr<IOBufferWithSize> buffer(
+      new IOBufferWithSize(kPacketSize * kMaxPackets));
+  std::vector<int> packet_lengths;
+  TestCompletionCallback callback;
+  int rv = client.ReadMultiple(buffer.get(), kPacketSize, kMaxPackets,
+                               &packet_lengths, callback.callback());
+  ASSERT_EQ(ERR_IO_PENDING, rv);
+  ASSERT_EQ(3, SendToSocket(&server, "one"));
+  EXPECT_EQ(1, callback.WaitForResult());
+  ASSERT_EQ(1u, packet_lengths.size());
+  EXPECT_EQ("one", std::string(buffer->data(), packet_lengths[0]));
+
+  // Queued packets are read together.
+  ASSERT_EQ(3, SendToSocket(&server, "two"));
+  ASSERT_EQ(5, SendToSocket(&server, "three"));
+  std::vector<std::string> packets;
+  while (packets.size() < 2u) {
+    rv = client.ReadMultiple(buffer.get(), kPacketSize, kMaxPackets,
+                             &packet_lengths, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_LT(0, rv);
+    ASSERT_EQ(static_cast<size_t>(rv), packet_lengths.size());
+    for (int i = 0; i < rv; ++i) {
+      packets.push_back(
+          std::string(buffer->data() + i * kPacketSize, packet_lengths[i]));
+    }
+#if defined(OS_LINUX)
+    EXPECT_EQ(2, rv);
+#endif
+  }
+  ASSERT_EQ(2u, packets.size());
+  EXPECT_EQ("two", packets[0]);
+  EXPECT_EQ("three", packets[1]);
+}
+#endif  // defined(OS_POSIX)
+
 // Close the socket while read is pending.
 TEST_F(UDPSocketTest, CloseWithPendingRead) {
   IPEndPoint bind_address;
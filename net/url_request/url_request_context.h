@@ -43,6 +43,7 @@ class ProxyService;
 class URLRequest;
 class URLRequestBackoffManager;
 class URLRequestJobFactory;
+class URLRequestScheduler;
 class URLRequestThrottlerManager;
 
 // Subclass to provide application-specific context for URLRequest
@@ -183,6 +184,12 @@ class NET_EXPORT URLRequestContext
     backoff_manager_ = backoff_manager;
   }
 
+  // May return nullptr.
+  URLRequestScheduler* request_scheduler() const { return request_scheduler_; }
+  void set_request_scheduler(URLRequestScheduler* request_scheduler) {
+    request_scheduler_ = request_scheduler;
+  }
+
   // May return nullptr.
   SdchManager* sdch_manager() const { return sdch_manager_; }
   void set_sdch_manager(SdchManager* sdch_manager) {
@@ -264,6 +271,7 @@ class NET_EXPORT URLRequestContext
   const URLRequestJobFactory* job_factory_;
   URLRequestThrottlerManager* throttler_manager_;
   URLRequestBackoffManager* backoff_manager_;
+  URLRequestScheduler* request_scheduler_;
   SdchManager* sdch_manager_;
   NetworkQualityEstimator* network_quality_estimator_;
 
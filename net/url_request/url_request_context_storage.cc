@@ -23,6 +23,7 @@
 #include "net/url_request/url_request_backoff_manager.h"
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_job_factory.h"
+#include "net/url_request/url_request_scheduler.h"
 #include "net/url_request/url_request_throttler_manager.h"
 
 namespace net {
@@ -133,6 +134,12 @@ void URLRequestContextStorage::set_backoff_manager(
   backoff_manager_ = std::move(backoff_manager);
 }
 
+void URLRequestContextStorage::set_request_scheduler(
+    std::unique_ptr<URLRequestScheduler> request_scheduler) {
+  context_->set_request_scheduler(request_scheduler.get());
+  request_scheduler_ = std::move(request_scheduler);
+}
+
 void URLRequestContextStorage::set_http_user_agent_settings(
     std::unique_ptr<HttpUserAgentSettings> http_user_agent_settings) {
   context_->set_http_user_agent_settings(http_user_agent_settings.get());
@@ -33,6 +33,7 @@ class TransportSecurityState;
 class URLRequestContext;
 class URLRequestBackoffManager;
 class URLRequestJobFactory;
+class URLRequestScheduler;
 class URLRequestThrottlerManager;
 
 // URLRequestContextStorage is a helper class that provides storage for unowned
@@ -73,6 +74,8 @@ class NET_EXPORT URLRequestContextStorage {
       std::unique_ptr<URLRequestThrottlerManager> throttler_manager);
   void set_backoff_manager(
       std::unique_ptr<URLRequestBackoffManager> backoff_manager);
+  void set_request_scheduler(
+      std::unique_ptr<URLRequestScheduler> request_scheduler);
   void set_http_user_agent_settings(
       std::unique_ptr<HttpUserAgentSettings> http_user_agent_settings);
   void set_sdch_manager(std::unique_ptr<SdchManager> sdch_manager);
@@ -114,6 +117,7 @@ class NET_EXPORT URLRequestContextStorage {
   std::unique_ptr<URLRequestJobFactory> job_factory_;
   std::unique_ptr<URLRequestThrottlerManager> throttler_manager_;
   std::unique_ptr<URLRequestBackoffManager> backoff_manager_;
+  std::unique_ptr<URLRequestScheduler> request_scheduler_;
   std::unique_ptr<SdchManager> sdch_manager_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestContextStorage);
@@ -55,6 +55,7 @@
 #include "net/url_request/url_request_error_job.h"
 #include "net/url_request/url_request_job_factory.h"
 #include "net/url_request/url_request_redirect_job.h"
+#include "net/url_request/url_request_scheduler.h"
 #include "net/url_request/url_request_throttler_manager.h"
 #include "net/websockets/websocket_handshake_stream_base.h"
 #include "url/origin.h"
@@ -333,6 +334,8 @@ void URLRequestHttpJob::SetPriority(RequestPriority priority) {
   priority_ = priority;
   if (transaction_)
     transaction_->SetPriority(priority_);
+  if (throttle_)
+    throttle_->SetPriority(priority_);
 }
 
 void URLRequestHttpJob::Start() {
@@ -380,11 +383,23 @@ void URLRequestHttpJob::Start() {
           http_user_agent_settings_->GetUserAgent() : std::string());
 
   AddExtraHeaders();
+
+  URLRequestScheduler* request_scheduler =
+      request_->context()->request_scheduler();
+  if (request_scheduler) {
+    throttle_ = request_scheduler->CreateThrottle(
+        this, priority_, (request_info_.load_flags & LOAD_IGNORE_LIMITS) != 0);
+    // Wait for OnThrottleUnblocked().
+    if (throttle_->IsBlocked())
+      return;
+  }
+
   AddCookieHeaderAndStart();
 }
 
 void URLRequestHttpJob::Kill() {
   weak_factory_.InvalidateWeakPtrs();
+  throttle_.reset();
   if (transaction_)
     DestroyTransaction();
   URLRequestJob::Kill();
@@ -761,6 +776,16 @@ void URLRequestHttpJob::AddExtraHeaders() {
   }
 }
 
+void URLRequestHttpJob::OnThrottleUnblocked(
+    URLRequestScheduler::Throttle* throttle) {
+  DCHECK_EQ(throttle_.get(), throttle);
+  // Called from within the scheduler, possibly while another job is being
+  // torn down, so start asynchronously.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&URLRequestHttpJob::AddCookieHeaderAndStart,
+                            weak_factory_.GetWeakPtr()));
+}
+
 void URLRequestHttpJob::AddCookieHeaderAndStart() {
   // If the request was destroyed, then there is no more work to do.
   if (!request_)
@@ -1642,6 +1667,9 @@ void URLRequestHttpJob::DoneWithRequest(CompletionCause reason) {
     return;
   done_ = true;
 
+  // Let the next delayable request go.
+  throttle_.reset();
+
   // Notify NetworkQualityEstimator.
   if (request()) {
     NetworkQualityEstimator* network_quality_estimator =
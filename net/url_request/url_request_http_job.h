@@ -27,6 +27,7 @@
 #include "net/socket/connection_attempts.h"
 #include "net/url_request/url_request_backoff_manager.h"
 #include "net/url_request/url_request_job.h"
+#include "net/url_request/url_request_scheduler.h"
 #include "net/url_request/url_request_throttler_entry_interface.h"
 
 namespace net {
@@ -43,7 +44,9 @@ class URLRequestContext;
 
 // A URLRequestJob subclass that is built on top of HttpTransaction. It
 // provides an implementation for both HTTP and HTTPS.
-class NET_EXPORT_PRIVATE URLRequestHttpJob : public URLRequestJob {
+class NET_EXPORT_PRIVATE URLRequestHttpJob
+    : public URLRequestJob,
+      public URLRequestScheduler::Delegate {
  public:
   static URLRequestJob* Factory(URLRequest* request,
                                 NetworkDelegate* network_delegate,
@@ -84,6 +87,9 @@ class NET_EXPORT_PRIVATE URLRequestHttpJob : public URLRequestJob {
 
   void DestroyTransaction();
 
+  // URLRequestScheduler::Delegate implementation.
+  void OnThrottleUnblocked(URLRequestScheduler::Throttle* throttle) override;
+
   void AddExtraHeaders();
   void AddCookieHeaderAndStart();
   void SaveCookiesAndNotifyHeadersComplete(int result);
@@ -271,6 +277,10 @@ class NET_EXPORT_PRIVATE URLRequestHttpJob : public URLRequestJob {
 
   URLRequestBackoffManager* backoff_manager_;
 
+  // Holds the request back while the context's URLRequestScheduler says so,
+  // and counts it as in flight from then until it is done.
+  std::unique_ptr<URLRequestScheduler::Throttle> throttle_;
+
   // Keeps track of total received bytes over the network from transactions used
   // by this job that have already been destroyed.
   int64_t total_received_bytes_from_previous_transactions_;
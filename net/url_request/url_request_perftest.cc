@@ -0,0 +1,363 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// End-to-end throughput of URLRequests through a URLRequestContext, against
+// the EmbeddedTestServer over HTTP/1.1 and, on Linux, against the QUIC test
+// server. Each run starts all of its requests at once and reports requests per
+// second, the median and 99th percentile latency of the requests, and the CPU
+// time the network thread spent per request. The servers run on threads of
+// their own, so their CPU time isn't counted.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/request_priority.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_status.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+#if defined(OS_LINUX)
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/test_data_directory.h"
+#include "net/cert/mock_cert_verifier.h"
+#include "net/cert/multi_log_ct_verifier.h"
+#include "net/dns/mapped_host_resolver.h"
+#include "net/dns/mock_host_resolver.h"
+#include "net/http/http_network_session.h"
+#include "net/quic/crypto/quic_crypto_server_config.h"
+#include "net/quic/quic_config.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/test_tools/crypto_test_utils.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+#include "net/spdy/spdy_header_block.h"
+#include "net/test/cert_test_util.h"
+#include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/quic_server.h"
+#include "net/tools/quic/test_tools/quic_in_memory_cache_peer.h"
+#include "net/tools/quic/test_tools/server_thread.h"
+#endif  // defined(OS_LINUX)
+
+namespace net {
+
+namespace {
+
+// Number of requests each run starts at once.
+const int kNumRequests = 2000;
+
+// Number of distinct URLs the requests are spread over. Requests for the same
+// URL wait on each other in the HTTP cache, so there are enough of them for
+// the cache not to serialize the whole run.
+const int kNumUrls = 100;
+
+const size_t kResponseBodySize = 4 * 1024;
+
+const int kReadBufferSize = 16 * 1024;
+
+// Cache-Control value of the responses, so that with the cache enabled a
+// second run is served from it.
+const char kCacheControl[] = "max-age=3600";
+
+std::string GetResourcePath(int index) {
+  return "/resource" + base::IntToString(index);
+}
+
+// Starts a batch of requests all at once, reads their responses and records
+// how long each of them took.
+class RequestBatch : public URLRequest::Delegate {
+ public:
+  explicit RequestBatch(URLRequestContext* context)
+      : context_(context),
+        read_buffer_(new IOBuffer(kReadBufferSize)),
+        num_completed_(0),
+        num_failed_(0) {}
+
+  ~RequestBatch() override {}
+
+  // Requests each of |urls| in turn until |num_requests| requests are in
+  // flight, and runs the message loop until they have all completed.
+  void Run(const std::vector<GURL>& urls, int num_requests, int load_flags) {
+    requests_.clear();
+    start_times_.clear();
+    latencies_.clear();
+    num_completed_ = 0;
+    num_failed_ = 0;
+
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+
+    base::ThreadTicks start_cpu;
+    if (base::ThreadTicks::IsSupported())
+      start_cpu = base::ThreadTicks::Now();
+    base::TimeTicks start = base::TimeTicks::Now();
+
+    for (int i = 0; i < num_requests; ++i) {
+      std::unique_ptr<URLRequest> request =
+          context_->CreateRequest(urls[i % urls.size()], DEFAULT_PRIORITY, this);
+      request->SetLoadFlags(load_flags);
+      start_times_[request.get()] = base::TimeTicks::Now();
+      request->Start();
+      requests_.push_back(std::move(request));
+    }
+    run_loop.Run();
+
+    elapsed_ = base::TimeTicks::Now() - start;
+    if (base::ThreadTicks::IsSupported())
+      cpu_time_ = base::ThreadTicks::Now() - start_cpu;
+  }
+
+  int num_failed() const { return num_failed_; }
+
+  // Prints the results of the last Run() for |trace|.
+  void PrintResults(const std::string& trace) {
+    ASSERT_FALSE(latencies_.empty());
+    std::sort(latencies_.begin(), latencies_.end());
+    const size_t count = latencies_.size();
+
+    perf_test::PrintResult("requests_per_second", "", trace,
+                           count / elapsed_.InSecondsF(), "requests/s", true);
+    perf_test::PrintResult("latency_p50", "", trace,
+                           latencies_[count / 2].InMillisecondsF(), "ms", true);
+    perf_test::PrintResult(
+        "latency_p99", "", trace,
+        latencies_[std::min(count - 1, count * 99 / 100)].InMillisecondsF(),
+        "ms", true);
+    if (base::ThreadTicks::IsSupported()) {
+      perf_test::PrintResult(
+          "cpu_per_request", "", trace,
+          static_cast<double>(cpu_time_.InMicroseconds()) / count, "us", true);
+    }
+  }
+
+  // URLRequest::Delegate implementation.
+  void OnResponseStarted(URLRequest* request) override {
+    if (!request->status().is_success()) {
+      OnRequestDone(request);
+      return;
+    }
+    ReadResponse(request);
+  }
+
+  void OnReadCompleted(URLRequest* request, int bytes_read) override {
+    if (bytes_read <= 0) {
+      OnRequestDone(request);
+      return;
+    }
+    ReadResponse(request);
+  }
+
+ private:
+  // Reads the response body of |request| until it would block or ends. All
+  // requests share |read_buffer_|, as the bodies are discarded.
+  void ReadResponse(URLRequest* request) {
+    int bytes_read = 0;
+    while (request->Read(read_buffer_.get(), kReadBufferSize, &bytes_read)) {
+      if (bytes_read == 0) {
+        OnRequestDone(request);
+        return;
+      }
+    }
+    if (!request->status().is_io_pending())
+      OnRequestDone(request);
+  }
+
+  void OnRequestDone(URLRequest* request) {
+    latencies_.push_back(base::TimeTicks::Now() - start_times_[request]);
+    if (!request->status().is_success())
+      ++num_failed_;
+    if (++num_completed_ == requests_.size())
+      quit_closure_.Run();
+  }
+
+  URLRequestContext* const context_;
+  scoped_refptr<IOBuffer> read_buffer_;
+
+  std::vector<std::unique_ptr<URLRequest>> requests_;
+  std::map<URLRequest*, base::TimeTicks> start_times_;
+  std::vector<base::TimeDelta> latencies_;
+  size_t num_completed_;
+  int num_failed_;
+  base::Closure quit_closure_;
+
+  base::TimeDelta elapsed_;
+  base::TimeDelta cpu_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(RequestBatch);
+};
+
+std::unique_ptr<test_server::HttpResponse> HandleRequest(
+    const test_server::HttpRequest& request) {
+  std::unique_ptr<test_server::BasicHttpResponse> response(
+      new test_server::BasicHttpResponse());
+  response->set_code(HTTP_OK);
+  response->set_content(std::string(kResponseBodySize, 'a'));
+  response->set_content_type("text/plain");
+  response->AddCustomHeader("Cache-Control", kCacheControl);
+  return std::move(response);
+}
+
+class URLRequestPerfTest : public testing::Test {
+ protected:
+  URLRequestPerfTest() : context_(true) {}
+
+  void SetUp() override {
+    server_.RegisterRequestHandler(base::Bind(&HandleRequest));
+    ASSERT_TRUE(server_.Start());
+    for (int i = 0; i < kNumUrls; ++i)
+      urls_.push_back(server_.GetURL(GetResourcePath(i)));
+    context_.Init();
+  }
+
+  base::MessageLoopForIO message_loop_;
+  test_server::EmbeddedTestServer server_;
+  TestURLRequestContext context_;
+  std::vector<GURL> urls_;
+};
+
+TEST_F(URLRequestPerfTest, HttpWithoutCache) {
+  RequestBatch batch(&context_);
+  batch.Run(urls_, kNumRequests, LOAD_DISABLE_CACHE);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("http_no_cache");
+}
+
+TEST_F(URLRequestPerfTest, HttpWithCache) {
+  RequestBatch batch(&context_);
+  batch.Run(urls_, kNumRequests, LOAD_NORMAL);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("http_cache_cold");
+
+  batch.Run(urls_, kNumRequests, LOAD_NORMAL);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("http_cache_warm");
+}
+
+// The QUIC test server is built on epoll, so it only runs on Linux.
+#if defined(OS_LINUX)
+
+const char kQuicHost[] = "test.example.com";
+
+class QuicURLRequestPerfTest : public testing::Test {
+ protected:
+  QuicURLRequestPerfTest()
+      : mock_host_resolver_(new MockHostResolver()),
+        host_resolver_(base::WrapUnique(mock_host_resolver_)),
+        context_(true) {}
+
+  void SetUp() override {
+    test::QuicInMemoryCachePeer::ResetForTests();
+    for (int i = 0; i < kNumUrls; ++i) {
+      SpdyHeaderBlock headers;
+      headers[":status"] = "200";
+      headers["content-length"] = base::SizeTToString(kResponseBodySize);
+      headers["cache-control"] = kCacheControl;
+      QuicInMemoryCache::GetInstance()->AddResponse(
+          kQuicHost, GetResourcePath(i), headers,
+          std::string(kResponseBodySize, 'a'));
+      urls_.push_back(GURL(std::string("https://") + kQuicHost +
+                           GetResourcePath(i)));
+    }
+
+    QuicConfig server_config;
+    server_config.SetInitialStreamFlowControlWindowToSend(
+        test::kInitialStreamFlowControlWindowForTest);
+    server_config.SetInitialSessionFlowControlWindowToSend(
+        test::kInitialSessionFlowControlWindowForTest);
+    server_thread_.reset(new test::ServerThread(
+        new QuicServer(test::CryptoTestUtils::ProofSourceForTesting(),
+                       server_config, QuicCryptoServerConfig::ConfigOptions(),
+                       QuicSupportedVersions()),
+        IPEndPoint(IPAddress(127, 0, 0, 1), 0), false));
+    server_thread_->Initialize();
+    server_thread_->Start();
+
+    // Send requests for the test host to the server, over QUIC only.
+    mock_host_resolver_->rules()->AddRule(kQuicHost, "127.0.0.1");
+    ASSERT_TRUE(host_resolver_.AddRuleFromString(
+        std::string("MAP ") + kQuicHost + " " + kQuicHost + ":" +
+        base::IntToString(server_thread_->GetPort())));
+
+    CertVerifyResult verify_result;
+    verify_result.verified_cert = ImportCertFromFile(
+        GetTestCertsDirectory(), "quic_test.example.com.crt");
+    cert_verifier_.AddResultForCertAndHost(verify_result.verified_cert.get(),
+                                           kQuicHost, verify_result, OK);
+    verify_result.verified_cert = ImportCertFromFile(
+        GetTestCertsDirectory(), "quic_test_ecc.example.com.crt");
+    cert_verifier_.AddResultForCertAndHost(verify_result.verified_cert.get(),
+                                           kQuicHost, verify_result, OK);
+
+    std::unique_ptr<HttpNetworkSession::Params> params(
+        new HttpNetworkSession::Params);
+    params->enable_quic = true;
+    params->origins_to_force_quic_on.insert(HostPortPair(kQuicHost, 443));
+    context_.set_http_network_session_params(std::move(params));
+    context_.set_host_resolver(&host_resolver_);
+    context_.set_cert_verifier(&cert_verifier_);
+    context_.set_cert_transparency_verifier(&cert_transparency_verifier_);
+    context_.Init();
+  }
+
+  void TearDown() override {
+    server_thread_->Quit();
+    server_thread_->Join();
+    test::QuicInMemoryCachePeer::ResetForTests();
+  }
+
+  base::MessageLoopForIO message_loop_;
+  std::unique_ptr<test::ServerThread> server_thread_;
+  MockHostResolver* mock_host_resolver_;  // Owned by |host_resolver_|.
+  MappedHostResolver host_resolver_;
+  MockCertVerifier cert_verifier_;
+  MultiLogCTVerifier cert_transparency_verifier_;
+  TestURLRequestContext context_;
+  std::vector<GURL> urls_;
+};
+
+TEST_F(QuicURLRequestPerfTest, QuicWithoutCache) {
+  RequestBatch batch(&context_);
+  batch.Run(urls_, kNumRequests, LOAD_DISABLE_CACHE);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("quic_no_cache");
+}
+
+TEST_F(QuicURLRequestPerfTest, QuicWithCache) {
+  RequestBatch batch(&context_);
+  batch.Run(urls_, kNumRequests, LOAD_NORMAL);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("quic_cache_cold");
+
+  batch.Run(urls_, kNumRequests, LOAD_NORMAL);
+  EXPECT_EQ(0, batch.num_failed());
+  batch.PrintResults("quic_cache_warm");
+}
+
+#endif  // defined(OS_LINUX)
+
+}  // namespace
+
+}  // namespace net
@@ -0,0 +1,192 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_scheduler.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/time/time.h"
+
+namespace net {
+
+namespace {
+
+// Returns the most delayable requests to allow in flight on a network of
+// effective connection type |type|, or 0 for no limit.
+size_t GetMaxDelayableRequestsForType(
+    NetworkQualityEstimator::EffectiveConnectionType type) {
+  switch (type) {
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_SLOW_2G:
+      return 2;
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_2G:
+      return 4;
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_3G:
+      return 8;
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_UNKNOWN:
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_OFFLINE:
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_4G:
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_BROADBAND:
+    case NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_LAST:
+      return 0;
+  }
+  NOTREACHED();
+  return 0;
+}
+
+}  // namespace
+
+const RequestPriority URLRequestScheduler::kDelayablePriorityThreshold;
+const int64_t URLRequestScheduler::kBytesPerDelayableRequest;
+const size_t URLRequestScheduler::kMinDelayableRequests;
+
+URLRequestScheduler::Throttle::~Throttle() {
+  if (blocked_) {
+    scheduler_->blocked_throttles_.Erase(queue_pointer_);
+  } else {
+    scheduler_->OnThrottleChanged(IsDelayable(), false);
+  }
+}
+
+void URLRequestScheduler::Throttle::SetPriority(RequestPriority priority) {
+  if (priority == priority_)
+    return;
+
+  if (blocked_) {
+    scheduler_->blocked_throttles_.Erase(queue_pointer_);
+    priority_ = priority;
+    queue_pointer_ = scheduler_->blocked_throttles_.Insert(this, priority_);
+    if (!IsDelayable())
+      scheduler_->Unblock(this);
+    return;
+  }
+
+  bool was_delayable = IsDelayable();
+  priority_ = priority;
+  scheduler_->OnThrottleChanged(was_delayable, IsDelayable());
+}
+
+URLRequestScheduler::Throttle::Throttle(URLRequestScheduler* scheduler,
+                                        Delegate* delegate,
+                                        RequestPriority priority,
+                                        bool ignore_limits)
+    : scheduler_(scheduler),
+      delegate_(delegate),
+      priority_(priority),
+      ignore_limits_(ignore_limits),
+      blocked_(false) {}
+
+bool URLRequestScheduler::Throttle::IsDelayable() const {
+  return !ignore_limits_ && priority_ < kDelayablePriorityThreshold;
+}
+
+URLRequestScheduler::URLRequestScheduler(
+    NetworkQualityEstimator* network_quality_estimator)
+    : network_quality_estimator_(network_quality_estimator),
+      max_delayable_requests_(0),
+      num_delayable_requests_in_flight_(0),
+      blocked_throttles_(NUM_PRIORITIES) {
+  if (network_quality_estimator_) {
+    network_quality_estimator_->AddEffectiveConnectionTypeObserver(this);
+    UpdateLimit();
+  }
+}
+
+URLRequestScheduler::~URLRequestScheduler() {
+  DCHECK(blocked_throttles_.empty());
+  if (network_quality_estimator_)
+    network_quality_estimator_->RemoveEffectiveConnectionTypeObserver(this);
+}
+
+std::unique_ptr<URLRequestScheduler::Throttle>
+URLRequestScheduler::CreateThrottle(Delegate* delegate,
+                                    RequestPriority priority,
+                                    bool ignore_limits) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(delegate);
+
+  std::unique_ptr<Throttle> throttle(
+      new Throttle(this, delegate, priority, ignore_limits));
+  if (!throttle->IsDelayable())
+    return throttle;
+
+  // The estimates may have moved since the effective connection type last
+  // changed, so check them again before holding a request back.
+  if (!HasRoomForDelayableRequest())
+    UpdateLimit();
+
+  if (HasRoomForDelayableRequest()) {
+    ++num_delayable_requests_in_flight_;
+  } else {
+    throttle->blocked_ = true;
+    throttle->queue_pointer_ =
+        blocked_throttles_.Insert(throttle.get(), priority);
+  }
+  return throttle;
+}
+
+void URLRequestScheduler::OnEffectiveConnectionTypeChanged(
+    NetworkQualityEstimator::EffectiveConnectionType type) {
+  UpdateLimit();
+  UnblockRequests();
+}
+
+void URLRequestScheduler::UpdateLimit() {
+  if (!network_quality_estimator_)
+    return;
+
+  size_t limit = GetMaxDelayableRequestsForType(
+      network_quality_estimator_->GetEffectiveConnectionType());
+
+  base::TimeDelta http_rtt;
+  int32_t downlink_kbps;
+  if (limit > 0 && network_quality_estimator_->GetHttpRTTEstimate(&http_rtt) &&
+      network_quality_estimator_->GetDownlinkThroughputKbpsEstimate(
+          &downlink_kbps)) {
+    // Kilobits per second times milliseconds is bits.
+    int64_t bdp_bytes = http_rtt.InMilliseconds() * downlink_kbps / 8;
+    size_t bdp_limit = static_cast<size_t>(
+        std::max<int64_t>(kMinDelayableRequests,
+                          bdp_bytes / kBytesPerDelayableRequest));
+    limit = std::min(limit, bdp_limit);
+  }
+
+  max_delayable_requests_ = limit;
+}
+
+bool URLRequestScheduler::HasRoomForDelayableRequest() const {
+  return max_delayable_requests_ == 0 ||
+         num_delayable_requests_in_flight_ < max_delayable_requests_;
+}
+
+void URLRequestScheduler::OnThrottleChanged(bool was_delayable_in_flight,
+                                            bool is_delayable_in_flight) {
+  if (was_delayable_in_flight == is_delayable_in_flight)
+    return;
+
+  if (is_delayable_in_flight) {
+    ++num_delayable_requests_in_flight_;
+    return;
+  }
+
+  DCHECK_LT(0u, num_delayable_requests_in_flight_);
+  --num_delayable_requests_in_flight_;
+  UnblockRequests();
+}
+
+void URLRequestScheduler::UnblockRequests() {
+  while (!blocked_throttles_.empty() && HasRoomForDelayableRequest())
+    Unblock(blocked_throttles_.FirstMax().value());
+}
+
+void URLRequestScheduler::Unblock(Throttle* throttle) {
+  DCHECK(throttle->blocked_);
+  blocked_throttles_.Erase(throttle->queue_pointer_);
+  throttle->blocked_ = false;
+  if (throttle->IsDelayable())
+    ++num_delayable_requests_in_flight_;
+  throttle->delegate_->OnThrottleUnblocked(throttle);
+}
+
+}  // namespace net
@@ -0,0 +1,154 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_URL_REQUEST_URL_REQUEST_SCHEDULER_H_
+#define NET_URL_REQUEST_URL_REQUEST_SCHEDULER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/threading/non_thread_safe.h"
+#include "net/base/net_export.h"
+#include "net/base/priority_queue.h"
+#include "net/base/request_priority.h"
+#include "net/nqe/network_quality_estimator.h"
+
+namespace net {
+
+// Limits the number of low priority ("delayable") HTTP requests in flight
+// according to the quality of the network, so that on slow networks a page's
+// dozens of image fetches don't starve its scripts and stylesheets of
+// bandwidth. Requests of priority MEDIUM or higher are never held back, and
+// neither are requests with LOAD_IGNORE_LIMITS.
+//
+// The limit follows the effective connection type estimated by the
+// NetworkQualityEstimator, capped further by the estimated bandwidth-delay
+// product: there is no point in having more requests in flight than it takes
+// to keep the pipe full. On fast or unknown networks there is no limit.
+//
+// This plays the same role as content's ResourceScheduler, but at the network
+// level, for all of a URLRequestContext's requests, and driven by measured
+// network quality rather than by the renderer's loading state.
+class NET_EXPORT URLRequestScheduler
+    : NON_EXPORTED_BASE(public base::NonThreadSafe),
+      public NetworkQualityEstimator::EffectiveConnectionTypeObserver {
+ public:
+  // Requests below this priority are delayable.
+  static const RequestPriority kDelayablePriorityThreshold = MEDIUM;
+
+  // Number of bytes of the bandwidth-delay product each delayable request in
+  // flight is expected to use.
+  static const int64_t kBytesPerDelayableRequest = 4 * 1024;
+
+  // Delayable requests allowed in flight whatever the bandwidth-delay product.
+  static const size_t kMinDelayableRequests = 2;
+
+  class Throttle;
+
+  // Notified when a blocked Throttle may proceed. This happens synchronously
+  // from within the scheduler, for instance while another request's Throttle
+  // is being destroyed, so delegates should not do much more than post a task.
+  class NET_EXPORT Delegate {
+   public:
+    virtual void OnThrottleUnblocked(Throttle* throttle) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  // Represents a request in the scheduler, from before it starts until it is
+  // done. Destroying it lets the next blocked request proceed.
+  class NET_EXPORT Throttle {
+   public:
+    ~Throttle();
+
+    // Whether the request must wait before going to the network. Once
+    // unblocked, a Throttle stays so.
+    bool IsBlocked() const { return blocked_; }
+
+    // Changes the priority of the request, which may unblock it.
+    void SetPriority(RequestPriority priority);
+
+   private:
+    friend class URLRequestScheduler;
+
+    Throttle(URLRequestScheduler* scheduler,
+             Delegate* delegate,
+             RequestPriority priority,
+             bool ignore_limits);
+
+    bool IsDelayable() const;
+
+    URLRequestScheduler* const scheduler_;
+    Delegate* const delegate_;
+    RequestPriority priority_;
+    const bool ignore_limits_;
+    bool blocked_;
+
+    // Position in |scheduler_->blocked_throttles_| while blocked.
+    PriorityQueue<Throttle*>::Pointer queue_pointer_;
+
+    DISALLOW_COPY_AND_ASSIGN(Throttle);
+  };
+
+  // |network_quality_estimator| may be null, in which case no request is ever
+  // held back. Otherwise it must outlive this.
+  explicit URLRequestScheduler(
+      NetworkQualityEstimator* network_quality_estimator);
+  ~URLRequestScheduler() override;
+
+  // Creates a Throttle for a request of |priority|. If the returned Throttle
+  // is blocked, |delegate| is notified once it is not anymore. |delegate| must
+  // outlive the Throttle.
+  std::unique_ptr<Throttle> CreateThrottle(Delegate* delegate,
+                                           RequestPriority priority,
+                                           bool ignore_limits);
+
+  // Returns the current limit on delayable requests in flight, or 0 if there
+  // is none.
+  size_t max_delayable_requests() const { return max_delayable_requests_; }
+
+  size_t num_delayable_requests_in_flight() const {
+    return num_delayable_requests_in_flight_;
+  }
+
+  // NetworkQualityEstimator::EffectiveConnectionTypeObserver implementation.
+  void OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EffectiveConnectionType type) override;
+
+ private:
+  // Recomputes |max_delayable_requests_| from the network quality estimates.
+  void UpdateLimit();
+
+  // Returns true if a delayable request may be put in flight now.
+  bool HasRoomForDelayableRequest() const;
+
+  // Called by an unblocked Throttle when its priority changes, or when it is
+  // destroyed, to keep |num_delayable_requests_in_flight_| up to date.
+  void OnThrottleChanged(bool was_delayable_in_flight,
+                         bool is_delayable_in_flight);
+
+  // Unblocks as many of the highest priority blocked requests as the limit
+  // allows.
+  void UnblockRequests();
+
+  // Removes |throttle| from |blocked_throttles_| and notifies its delegate.
+  void Unblock(Throttle* throttle);
+
+  NetworkQualityEstimator* const network_quality_estimator_;
+
+  size_t max_delayable_requests_;
+  size_t num_delayable_requests_in_flight_;
+
+  PriorityQueue<Throttle*> blocked_throttles_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestScheduler);
+};
+
+}  // namespace net
+
+#endif  // NET_URL_REQUEST_URL_REQUEST_SCHEDULER_H_
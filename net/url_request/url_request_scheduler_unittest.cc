@@ -0,0 +1,254 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_scheduler.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/nqe/external_estimate_provider.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class TestNetworkQualityEstimator : public NetworkQualityEstimator {
+ public:
+  TestNetworkQualityEstimator()
+      : NetworkQualityEstimator(std::unique_ptr<ExternalEstimateProvider>(),
+                                std::map<std::string, std::string>()),
+        effective_connection_type_(EFFECTIVE_CONNECTION_TYPE_UNKNOWN),
+        has_bdp_estimate_(false),
+        downlink_throughput_kbps_(0) {}
+
+  void set_effective_connection_type(EffectiveConnectionType type) {
+    effective_connection_type_ = type;
+  }
+
+  void SetBdpEstimate(base::TimeDelta http_rtt, int32_t kbps) {
+    has_bdp_estimate_ = true;
+    http_rtt_ = http_rtt;
+    downlink_throughput_kbps_ = kbps;
+  }
+
+  // NetworkQualityEstimator implementation.
+  EffectiveConnectionType GetEffectiveConnectionType() const override {
+    return effective_connection_type_;
+  }
+
+  bool GetHttpRTTEstimate(base::TimeDelta* rtt) const override {
+    *rtt = http_rtt_;
+    return has_bdp_estimate_;
+  }
+
+  bool GetDownlinkThroughputKbpsEstimate(int32_t* kbps) const override {
+    *kbps = downlink_throughput_kbps_;
+    return has_bdp_estimate_;
+  }
+
+ private:
+  EffectiveConnectionType effective_connection_type_;
+  bool has_bdp_estimate_;
+  base::TimeDelta http_rtt_;
+  int32_t downlink_throughput_kbps_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestNetworkQualityEstimator);
+};
+
+class TestDelegate : public URLRequestScheduler::Delegate {
+ public:
+  TestDelegate() {}
+  ~TestDelegate() override {}
+
+  const std::vector<URLRequestScheduler::Throttle*>& unblocked() const {
+    return unblocked_;
+  }
+
+  // URLRequestScheduler::Delegate implementation.
+  void OnThrottleUnblocked(URLRequestScheduler::Throttle* throttle) override {
+    EXPECT_FALSE(throttle->IsBlocked());
+    unblocked_.push_back(throttle);
+  }
+
+ private:
+  std::vector<URLRequestScheduler::Throttle*> unblocked_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestDelegate);
+};
+
+class URLRequestSchedulerTest : public testing::Test {
+ protected:
+  URLRequestSchedulerTest() {
+    estimator_.set_effective_connection_type(
+        NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_2G);
+    scheduler_.reset(new URLRequestScheduler(&estimator_));
+  }
+
+  std::unique_ptr<URLRequestScheduler::Throttle> CreateThrottle(
+      RequestPriority priority) {
+    return scheduler_->CreateThrottle(&delegate_, priority, false);
+  }
+
+  TestNetworkQualityEstimator estimator_;
+  TestDelegate delegate_;
+  std::unique_ptr<URLRequestScheduler> scheduler_;
+};
+
+TEST_F(URLRequestSchedulerTest, NoLimitWithoutEstimator) {
+  URLRequestScheduler scheduler(nullptr);
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 20; ++i) {
+    throttles.push_back(scheduler.CreateThrottle(&delegate_, IDLE, false));
+    EXPECT_FALSE(throttles.back()->IsBlocked());
+  }
+}
+
+TEST_F(URLRequestSchedulerTest, NoLimitOnFastNetworks) {
+  estimator_.set_effective_connection_type(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_4G);
+  scheduler_->OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_4G);
+  EXPECT_EQ(0u, scheduler_->max_delayable_requests());
+
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 20; ++i) {
+    throttles.push_back(CreateThrottle(LOWEST));
+    EXPECT_FALSE(throttles.back()->IsBlocked());
+  }
+}
+
+TEST_F(URLRequestSchedulerTest, LimitsDelayableRequests) {
+  EXPECT_EQ(4u, scheduler_->max_delayable_requests());
+
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 4; ++i) {
+    throttles.push_back(CreateThrottle(LOWEST));
+    EXPECT_FALSE(throttles.back()->IsBlocked());
+  }
+  EXPECT_EQ(4u, scheduler_->num_delayable_requests_in_flight());
+
+  std::unique_ptr<URLRequestScheduler::Throttle> blocked =
+      CreateThrottle(LOW);
+  EXPECT_TRUE(blocked->IsBlocked());
+
+  // Critical requests and those ignoring limits are never held back.
+  std::unique_ptr<URLRequestScheduler::Throttle> medium =
+      CreateThrottle(MEDIUM);
+  EXPECT_FALSE(medium->IsBlocked());
+  std::unique_ptr<URLRequestScheduler::Throttle> ignore_limits =
+      scheduler_->CreateThrottle(&delegate_, IDLE, true);
+  EXPECT_FALSE(ignore_limits->IsBlocked());
+  medium.reset();
+  ignore_limits.reset();
+  EXPECT_TRUE(blocked->IsBlocked());
+
+  throttles.pop_back();
+  EXPECT_FALSE(blocked->IsBlocked());
+  ASSERT_EQ(1u, delegate_.unblocked().size());
+  EXPECT_EQ(blocked.get(), delegate_.unblocked()[0]);
+  EXPECT_EQ(4u, scheduler_->num_delayable_requests_in_flight());
+}
+
+TEST_F(URLRequestSchedulerTest, UnblocksHighestPriorityFirst) {
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 4; ++i)
+    throttles.push_back(CreateThrottle(LOWEST));
+
+  std::unique_ptr<URLRequestScheduler::Throttle> idle = CreateThrottle(IDLE);
+  std::unique_ptr<URLRequestScheduler::Throttle> low = CreateThrottle(LOW);
+  std::unique_ptr<URLRequestScheduler::Throttle> lowest =
+      CreateThrottle(LOWEST);
+
+  throttles.clear();
+  ASSERT_EQ(3u, delegate_.unblocked().size());
+  EXPECT_EQ(low.get(), delegate_.unblocked()[0]);
+  EXPECT_EQ(lowest.get(), delegate_.unblocked()[1]);
+  EXPECT_EQ(idle.get(), delegate_.unblocked()[2]);
+}
+
+TEST_F(URLRequestSchedulerTest, RaisingPriorityUnblocks) {
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 4; ++i)
+    throttles.push_back(CreateThrottle(LOWEST));
+
+  std::unique_ptr<URLRequestScheduler::Throttle> throttle =
+      CreateThrottle(LOWEST);
+  EXPECT_TRUE(throttle->IsBlocked());
+  throttle->SetPriority(LOW);
+  EXPECT_TRUE(throttle->IsBlocked());
+  throttle->SetPriority(HIGHEST);
+  EXPECT_FALSE(throttle->IsBlocked());
+  EXPECT_EQ(1u, delegate_.unblocked().size());
+  EXPECT_EQ(4u, scheduler_->num_delayable_requests_in_flight());
+
+  // Raising the priority of a request in flight makes room for another.
+  std::unique_ptr<URLRequestScheduler::Throttle> blocked =
+      CreateThrottle(IDLE);
+  EXPECT_TRUE(blocked->IsBlocked());
+  throttles[0]->SetPriority(MEDIUM);
+  EXPECT_FALSE(blocked->IsBlocked());
+  EXPECT_EQ(4u, scheduler_->num_delayable_requests_in_flight());
+}
+
+TEST_F(URLRequestSchedulerTest, LimitFollowsBandwidthDelayProduct) {
+  // 400ms at 400 kbps is 20000 bytes, room for 4 requests of 4KB.
+  estimator_.set_effective_connection_type(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_3G);
+  estimator_.SetBdpEstimate(base::TimeDelta::FromMilliseconds(400), 400);
+  scheduler_->OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_3G);
+  EXPECT_EQ(4u, scheduler_->max_delayable_requests());
+
+  // A tiny bandwidth-delay product still allows a couple of requests.
+  estimator_.SetBdpEstimate(base::TimeDelta::FromMilliseconds(100), 10);
+  scheduler_->OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_3G);
+  EXPECT_EQ(URLRequestScheduler::kMinDelayableRequests,
+            scheduler_->max_delayable_requests());
+
+  // A large one is capped by the effective connection type.
+  estimator_.SetBdpEstimate(base::TimeDelta::FromMilliseconds(400), 10000);
+  scheduler_->OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_3G);
+  EXPECT_EQ(8u, scheduler_->max_delayable_requests());
+}
+
+TEST_F(URLRequestSchedulerTest, BetterNetworkUnblocks) {
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 6; ++i)
+    throttles.push_back(CreateThrottle(LOWEST));
+  EXPECT_TRUE(throttles[4]->IsBlocked());
+  EXPECT_TRUE(throttles[5]->IsBlocked());
+
+  estimator_.set_effective_connection_type(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_BROADBAND);
+  scheduler_->OnEffectiveConnectionTypeChanged(
+      NetworkQualityEstimator::EFFECTIVE_CONNECTION_TYPE_BROADBAND);
+  EXPECT_FALSE(throttles[4]->IsBlocked());
+  EXPECT_FALSE(throttles[5]->IsBlocked());
+  EXPECT_EQ(6u, scheduler_->num_delayable_requests_in_flight());
+}
+
+TEST_F(URLRequestSchedulerTest, DestroyBlockedThrottle) {
+  std::vector<std::unique_ptr<URLRequestScheduler::Throttle>> throttles;
+  for (int i = 0; i < 4; ++i)
+    throttles.push_back(CreateThrottle(LOWEST));
+  std::unique_ptr<URLRequestScheduler::Throttle> blocked =
+      CreateThrottle(LOWEST);
+  EXPECT_TRUE(blocked->IsBlocked());
+  blocked.reset();
+
+  throttles.clear();
+  EXPECT_TRUE(delegate_.unblocked().empty());
+  EXPECT_EQ(0u, scheduler_->num_delayable_requests_in_flight());
+}
+
+}  // namespace
+
+}  // namespace net
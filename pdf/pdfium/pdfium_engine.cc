@@ -108,6 +108,16 @@ const uint32_t kPendingPageColor = 0xFFEEEEEE;
 // painting the scrollbars > 60 Hz.
 #define kMaxInitialProgressivePaintTimeMs 10
 
+// The maximum amount of memory used to keep the pixels of rendered pages, so
+// that pages scrolled back into view don't have to be rendered again.
+const size_t kMaxRenderedPagesBytes = 32 * 1024 * 1024;
+
+// When the document is loaded with range requests, the data of the pages past
+// the visible ones is requested too, as far as the current scroll speed gets
+// in this time, but at least one and at most |kMaxReadAheadPages| pages.
+#define kReadAheadTimeMs 1000
+#define kMaxReadAheadPages 5
+
 std::vector<uint32_t> GetPageNumbersFromPrintPageNumberRange(
     const PP_PrintPageNumberRange_Dev* page_ranges,
     uint32_t page_range_count) {
@@ -529,6 +539,7 @@ PDFEngine* PDFEngine::Create(PDFEngine::Client* client) {
 PDFiumEngine::PDFiumEngine(PDFEngine::Client* client)
     : client_(client),
       current_zoom_(1.0),
+      scroll_velocity_(0),
       current_rotation_(0),
       doc_loader_(this),
       password_tries_remaining_(0),
@@ -549,6 +560,7 @@ PDFiumEngine::PDFiumEngine(PDFEngine::Client* client)
       most_visible_page_(-1),
       called_do_document_action_(false),
       render_grayscale_(false),
+      rendered_pages_bytes_(0),
       progressive_paint_timeout_(0),
       getting_password_(false) {
   find_factory_.Initialize(this);
@@ -888,6 +900,13 @@ void PDFiumEngine::ScrolledToYPosition(int position) {
   CancelPaints();
 
   int old_y = position_.y();
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!last_scroll_time_.is_null() && now > last_scroll_time_) {
+    scroll_velocity_ =
+        (position - old_y) / (now - last_scroll_time_).InSecondsF();
+  }
+  last_scroll_time_ = now;
+
   position_.set_y(position);
   CalculateVisiblePages();
   client_->Scroll(pp::Point(0, old_y - position));
@@ -947,6 +966,12 @@ void PDFiumEngine::Paint(const pp::Rect& rect,
         }
       }
 
+      if (progressive == -1 &&
+          PaintFromRenderedPage(index, dirty_in_screen, image_data)) {
+        ready->push_back(dirty_in_screen);
+        continue;
+      }
+
       if (progressive == -1) {
         progressive = StartPaint(index, dirty_in_screen);
         progressive_paint_timeout_ = kMaxInitialProgressivePaintTimeMs;
@@ -1010,6 +1035,7 @@ void PDFiumEngine::AppendPage(PDFEngine* engine, int index) {
   pp::Size new_page_size = GetPageSize(index);
   if (curr_page_size != new_page_size)
     LoadPageInfo(true);
+  EraseRenderedPage(index);
   client_->Invalidate(GetPageScreenRect(index));
 }
 
@@ -2134,6 +2160,7 @@ void PDFiumEngine::ZoomUpdated(double new_zoom_level) {
   CancelPaints();
 
   current_zoom_ = new_zoom_level;
+  ClearRenderedPages();
 
   CalculateVisiblePages();
   UpdateTickMarks();
@@ -2151,6 +2178,7 @@ void PDFiumEngine::RotateCounterclockwise() {
 
 void PDFiumEngine::InvalidateAllPages() {
   CancelPaints();
+  ClearRenderedPages();
   StopFind();
   LoadPageInfo(true);
   client_->Invalidate(pp::Rect(plugin_size_));
@@ -2280,6 +2308,8 @@ pp::Rect PDFiumEngine::GetPageContentsRect(int index) {
 }
 
 void PDFiumEngine::SetGrayscale(bool grayscale) {
+  if (render_grayscale_ != grayscale)
+    ClearRenderedPages();
   render_grayscale_ = grayscale;
 }
 
@@ -2660,6 +2690,29 @@ void PDFiumEngine::CalculateVisiblePages() {
   }
 
   SetCurrentPage(most_visible_page);
+
+  ReadAheadPages();
+}
+
+void PDFiumEngine::ReadAheadPages() {
+  if (visible_pages_.empty() || !doc_loader_.is_partial_document() ||
+      doc_loader_.IsDocumentComplete()) {
+    return;
+  }
+
+  // The requests of the visible pages were queued first, so these are only
+  // downloaded after them.
+  int step = scroll_velocity_ < 0 ? -1 : 1;
+  int index = step > 0 ? visible_pages_.back() : visible_pages_.front();
+  double distance = fabs(scroll_velocity_) * kReadAheadTimeMs / 1000;
+  const int num_pages = static_cast<int>(pages_.size());
+  for (int i = 0; i < kMaxReadAheadPages; ++i) {
+    index += step;
+    if (index < 0 || index >= num_pages || (i > 0 && distance <= 0))
+      break;
+    CheckPageAvailable(index, &pending_pages_);
+    distance -= GetPageScreenRect(index).height();
+  }
 }
 
 bool PDFiumEngine::IsPageVisible(int index) const {
@@ -2772,6 +2825,9 @@ void PDFiumEngine::FinishPaint(int progressive_index,
       form_, bitmap, pages_[page_index]->GetPage(), start_x, start_y, size_x,
       size_y, current_rotation_, GetRenderingFlags());
 
+  // Keep the page as PDFium drew it, before the highlights go on top.
+  SaveRenderedPage(page_index, dirty_in_screen, image_data);
+
   FillPageSides(progressive_index);
 
   // Paint the page shadows.
@@ -2914,6 +2970,134 @@ void PDFiumEngine::DrawSelections(int progressive_index,
   form_highlights_.clear();
 }
 
+void PDFiumEngine::SaveRenderedPage(int page_index,
+                                    const pp::Rect& dirty,
+                                    pp::ImageData* image_data) {
+  pp::Rect page_rect_in_screen = GetPageScreenRect(page_index);
+  size_t page_bytes = 4 * static_cast<size_t>(page_rect_in_screen.width()) *
+                      page_rect_in_screen.height();
+  if (page_bytes == 0 || page_bytes > kMaxRenderedPagesBytes)
+    return;
+
+  void* region = nullptr;
+  int stride;
+  GetRegion(dirty.point(), image_data, &region, &stride);
+  if (!region)
+    return;
+
+  auto it = rendered_pages_.begin();
+  while (it != rendered_pages_.end() && it->page_index != page_index)
+    ++it;
+  if (it != rendered_pages_.end() && it->size != page_rect_in_screen.size()) {
+    rendered_pages_bytes_ -= it->pixels.size();
+    rendered_pages_.erase(it);
+    it = rendered_pages_.end();
+  }
+  if (it == rendered_pages_.end()) {
+    rendered_pages_.push_front(RenderedPage());
+    it = rendered_pages_.begin();
+    it->page_index = page_index;
+    it->size = page_rect_in_screen.size();
+    it->pixels.resize(page_bytes);
+    rendered_pages_bytes_ += page_bytes;
+  } else {
+    rendered_pages_.splice(rendered_pages_.begin(), rendered_pages_, it);
+  }
+
+  // Copy the part of the page that was painted.
+  pp::Rect rect = dirty;
+  rect.Offset(-page_rect_in_screen.x(), -page_rect_in_screen.y());
+  size_t row_bytes = 4 * static_cast<size_t>(rect.width());
+  const char* src = static_cast<const char*>(region);
+  for (int y = 0; y < rect.height(); ++y) {
+    memcpy(&it->pixels[4 * ((rect.y() + y) * it->size.width() + rect.x())],
+           src + y * stride, row_bytes);
+  }
+
+  // Only a single valid rectangle is tracked, so merge the new one only when
+  // the union doesn't cover anything that wasn't painted.
+  pp::Rect& valid = it->valid_rect;
+  if (valid.IsEmpty() || rect.Contains(valid)) {
+    valid = rect;
+  } else if (valid.Contains(rect)) {
+    // Nothing new.
+  } else if (rect.x() == valid.x() && rect.width() == valid.width() &&
+             rect.y() <= valid.bottom() && valid.y() <= rect.bottom()) {
+    valid = valid.Union(rect);
+  } else if (rect.y() == valid.y() && rect.height() == valid.height() &&
+             rect.x() <= valid.right() && valid.x() <= rect.right()) {
+    valid = valid.Union(rect);
+  } else {
+    valid = rect;
+  }
+
+  // Evict the least recently used pages, never the one just saved.
+  while (rendered_pages_bytes_ > kMaxRenderedPagesBytes &&
+         rendered_pages_.size() > 1) {
+    rendered_pages_bytes_ -= rendered_pages_.back().pixels.size();
+    rendered_pages_.pop_back();
+  }
+}
+
+bool PDFiumEngine::PaintFromRenderedPage(int page_index,
+                                         const pp::Rect& dirty,
+                                         pp::ImageData* image_data) {
+  auto it = rendered_pages_.begin();
+  while (it != rendered_pages_.end() && it->page_index != page_index)
+    ++it;
+  if (it == rendered_pages_.end())
+    return false;
+
+  pp::Rect page_rect_in_screen = GetPageScreenRect(page_index);
+  pp::Rect rect = dirty;
+  rect.Offset(-page_rect_in_screen.x(), -page_rect_in_screen.y());
+  if (it->size != page_rect_in_screen.size() ||
+      !it->valid_rect.Contains(rect)) {
+    return false;
+  }
+
+  FPDF_BITMAP bitmap = CreateBitmap(dirty, image_data);
+  if (!bitmap)
+    return false;
+
+  char* dest = static_cast<char*>(FPDFBitmap_GetBuffer(bitmap));
+  int stride = FPDFBitmap_GetStride(bitmap);
+  size_t row_bytes = 4 * static_cast<size_t>(rect.width());
+  for (int y = 0; y < rect.height(); ++y) {
+    memcpy(dest + y * stride,
+           &it->pixels[4 * ((rect.y() + y) * it->size.width() + rect.x())],
+           row_bytes);
+  }
+  rendered_pages_.splice(rendered_pages_.begin(), rendered_pages_, it);
+
+  // Draw the sides, shadow and highlights the same way FinishPaint() does.
+  int progressive_index = StartPaint(page_index, dirty);
+  progressive_paints_[progressive_index].bitmap = bitmap;
+  FillPageSides(progressive_index);
+  PaintPageShadow(progressive_index, image_data);
+  DrawSelections(progressive_index, image_data);
+  FPDFBitmap_Destroy(bitmap);
+  progressive_paints_.erase(progressive_paints_.begin() + progressive_index);
+
+  client_->DocumentPaintOccurred();
+  return true;
+}
+
+void PDFiumEngine::EraseRenderedPage(int page_index) {
+  for (auto it = rendered_pages_.begin(); it != rendered_pages_.end(); ++it) {
+    if (it->page_index == page_index) {
+      rendered_pages_bytes_ -= it->pixels.size();
+      rendered_pages_.erase(it);
+      return;
+    }
+  }
+}
+
+void PDFiumEngine::ClearRenderedPages() {
+  rendered_pages_.clear();
+  rendered_pages_bytes_ = 0;
+}
+
 void PDFiumEngine::PaintUnavailablePage(int page_index,
                                         const pp::Rect& dirty,
                                         pp::ImageData* image_data) {
@@ -3388,6 +3572,7 @@ void PDFiumEngine::Form_Invalidate(FPDF_FORMFILLINFO* param,
   pp::Rect rect = engine->pages_[page_index]->PageToScreen(
       engine->GetVisibleRect().point(), engine->current_zoom_, left, top, right,
       bottom, engine->current_rotation_);
+  engine->EraseRenderedPage(page_index);
   engine->client_->Invalidate(rect);
 }
 
@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -254,6 +255,10 @@ class PDFiumEngine : public PDFEngine,
   // array if it's not already there.
   bool CheckPageAvailable(int index, std::vector<int>* pending);
 
+  // Requests the data of the pages the user is likely to scroll to next,
+  // based on the recent scroll speed and direction.
+  void ReadAheadPages();
+
   // Helper function to get a given page's size in pixels.  This is not part of
   // PDFiumPage because we might not have that structure when we need this.
   pp::Size GetPageSize(int index);
@@ -358,6 +363,22 @@ class PDFiumEngine : public PDFEngine,
   // Highlight visible find results and selections.
   void DrawSelections(int progressive_index, pp::ImageData* image_data);
 
+  // Copies the part |dirty| of a page that PDFium just drew, in screen
+  // coordinates, into |rendered_pages_|.
+  void SaveRenderedPage(int page_index,
+                        const pp::Rect& dirty,
+                        pp::ImageData* image_data);
+
+  // Paints |dirty| of a page from |rendered_pages_| if all of it was saved at
+  // the current size. Returns false if the page needs to be rendered.
+  bool PaintFromRenderedPage(int page_index,
+                             const pp::Rect& dirty,
+                             pp::ImageData* image_data);
+
+  // Drops the saved pixels of a page, or of all pages, once they are stale.
+  void EraseRenderedPage(int page_index);
+  void ClearRenderedPages();
+
   // Paints an page that hasn't finished downloading.
   void PaintUnavailablePage(int page_index,
                             const pp::Rect& dirty,
@@ -591,6 +612,9 @@ class PDFiumEngine : public PDFEngine,
   // The plugin size in screen coordinates.
   pp::Size plugin_size_;
   double current_zoom_;
+  // The speed of the last vertical scroll, in screen pixels per second.
+  double scroll_velocity_;
+  base::TimeTicks last_scroll_time_;
   unsigned int current_rotation_;
 
   DocumentLoader doc_loader_;  // Main document's loader.
@@ -703,6 +727,16 @@ class PDFiumEngine : public PDFEngine,
   };
   std::vector<ProgressivePaint> progressive_paints_;
 
+  // Pixels of recently rendered pages, most recently used first.
+  struct RenderedPage {
+    int page_index;
+    pp::Size size;  // Of the page's screen rect when it was rendered.
+    pp::Rect valid_rect;  // The part that was saved, relative to that rect.
+    std::vector<uint8_t> pixels;  // BGRx, |size.width()| pixels per row.
+  };
+  std::list<RenderedPage> rendered_pages_;
+  size_t rendered_pages_bytes_;
+
   // Keeps track of when we started the last progressive paint, so that in our
   // callback we can determine if we need to pause.
   base::Time last_progressive_start_time_;
@@ -65,6 +65,12 @@ TEST_F(VideoDecoderVp8Test, Gradient) {
   TestGradient(320, 240, 0.04, 0.02);
 }
 
+// Check the same for a frame large enough to be converted to YUV in bands by
+// multiple threads.
+TEST_F(VideoDecoderVp8Test, LargeGradient) {
+  TestGradient(1920, 1080, 0.04, 0.02);
+}
+
 //
 // Test the VP9 codec.
 //
@@ -80,4 +86,10 @@ TEST_F(VideoDecoderVp9Test, Gradient) {
   TestGradient(320, 240, 0.04, 0.02);
 }
 
+// Check the same for a frame large enough to be converted to YUV in bands by
+// multiple threads.
+TEST_F(VideoDecoderVp9Test, LargeGradient) {
+  TestGradient(1920, 1080, 0.04, 0.02);
+}
+
 }  // namespace remoting
@@ -4,12 +4,17 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
 #include "remoting/base/util.h"
 #include "remoting/proto/video.pb.h"
 #include "third_party/libyuv/include/libyuv/convert_from_argb.h"
@@ -42,6 +47,45 @@ const int kVp9I444ProfileNumber = 1;
 const int kVp9AqModeNone = 0;
 const int kVp9AqModeCyclicRefresh = 3;
 
+// Number of pixels that each encoder thread is given to encode. A 1080p
+// desktop is encoded by 2 threads, as before, while large or multi-monitor
+// desktops spread over more cores, e.g. 8 for 4K.
+const int kPixelsPerEncoderThread = 1920 * 1080 / 2;
+
+// Limit on the number of encoder threads, which is also the most token
+// partitions that VP8 supports.
+const int kMaxEncoderThreads = 8;
+
+// Returns the number of threads to encode frames of |size| with.
+int GetEncoderThreadCount(const webrtc::DesktopSize& size) {
+  // Going to multiple threads on low end windows systems can really hurt
+  // performance. http://crbug.com/99179
+  int processors = base::SysInfo::NumberOfProcessors();
+  if (processors <= 2)
+    return 1;
+
+  int pixels = size.width() * size.height();
+  int threads =
+      (pixels + kPixelsPerEncoderThread - 1) / kPixelsPerEncoderThread;
+
+  // Leave a core for capturing and sending frames.
+  int max_threads = std::min(processors - 1, kMaxEncoderThreads);
+  return std::max(2, std::min(threads, max_threads));
+}
+
+// Minimum number of updated pixels for each thread that converts them to YUV.
+// Splitting smaller updates costs more in thread hops than it saves.
+const int kMinPixelsPerConversionThread = 256 * 256;
+
+// Returns log2 of the number of partitions, rounded up, for |threads| threads
+// to work on independently.
+int GetLog2PartitionCount(int threads) {
+  int log2_partitions = 0;
+  while ((1 << log2_partitions) < threads)
+    ++log2_partitions;
+  return log2_partitions;
+}
+
 void SetCommonCodecParameters(vpx_codec_enc_cfg_t* config,
                               const webrtc::DesktopSize& size) {
   // Use millisecond granularity time base.
@@ -61,11 +105,9 @@ void SetCommonCodecParameters(vpx_codec_enc_cfg_t* config,
   config->kf_min_dist = 10000;
   config->kf_max_dist = 10000;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config->g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  // Using multiple threads gives a great boost in performance for most systems
+  // with adequate processing power, and more so for larger desktops.
+  config->g_threads = GetEncoderThreadCount(size);
 }
 
 void SetVp8CodecParameters(vpx_codec_enc_cfg_t* config,
@@ -119,6 +161,13 @@ void SetVp8CodecOptions(vpx_codec_ctx_t* codec) {
   vpx_codec_err_t ret = vpx_codec_control(codec, VP8E_SET_CPUUSED, 16);
   DCHECK_EQ(VPX_CODEC_OK, ret) << "Failed to set CPUUSED";
 
+  // Split the tokens into a partition per thread, so that the threads can
+  // also pack the bitstream in parallel.
+  ret = vpx_codec_control(
+      codec, VP8E_SET_TOKEN_PARTITIONS,
+      GetLog2PartitionCount(codec->config.enc->g_threads));
+  DCHECK_EQ(VPX_CODEC_OK, ret) << "Failed to set token partitions";
+
   // Use the lowest level of noise sensitivity so as to spend less time
   // on motion estimation and inter-prediction mode.
   ret = vpx_codec_control(codec, VP8E_SET_NOISE_SENSITIVITY, 0);
@@ -143,6 +192,13 @@ void SetVp9CodecOptions(vpx_codec_ctx_t* codec, bool lossless_encode) {
       codec, VP9E_SET_TUNE_CONTENT, VP9E_CONTENT_SCREEN);
   DCHECK_EQ(VPX_CODEC_OK, ret) << "Failed to set screen content mode";
 
+  // VP9 encodes tile columns in parallel, so use a column per thread. libvpx
+  // reduces the number of columns if the frame is too narrow for them.
+  ret = vpx_codec_control(
+      codec, VP9E_SET_TILE_COLUMNS,
+      GetLog2PartitionCount(codec->config.enc->g_threads));
+  DCHECK_EQ(VPX_CODEC_OK, ret) << "Failed to set tile columns";
+
   // Set cyclic refresh (aka "top-off") only for lossy encoding.
   int aq_mode = lossless_encode ? kVp9AqModeNone : kVp9AqModeCyclicRefresh;
   ret = vpx_codec_control(codec, VP9E_SET_AQ_MODE, aq_mode);
@@ -229,6 +285,112 @@ void CreateImage(bool use_i444,
   *out_image_buffer = std::move(image_buffer);
 }
 
+// Converts the |rects| of |frame| to YUV in |image|.
+void ConvertRectsToYuv(const webrtc::DesktopFrame& frame,
+                       const std::vector<webrtc::DesktopRect>& rects,
+                       vpx_image_t* image) {
+  const uint8_t* rgb_data = frame.data();
+  const int rgb_stride = frame.stride();
+  const int y_stride = image->stride[0];
+  DCHECK_EQ(image->stride[1], image->stride[2]);
+  const int uv_stride = image->stride[1];
+  uint8_t* y_data = image->planes[0];
+  uint8_t* u_data = image->planes[1];
+  uint8_t* v_data = image->planes[2];
+
+  switch (image->fmt) {
+    case VPX_IMG_FMT_I444:
+      for (const webrtc::DesktopRect& rect : rects) {
+        int rgb_offset = rgb_stride * rect.top() +
+                         rect.left() * kBytesPerRgbPixel;
+        int yuv_offset = uv_stride * rect.top() + rect.left();
+        libyuv::ARGBToI444(rgb_data + rgb_offset, rgb_stride,
+                           y_data + yuv_offset, y_stride,
+                           u_data + yuv_offset, uv_stride,
+                           v_data + yuv_offset, uv_stride,
+                           rect.width(), rect.height());
+      }
+      break;
+    case VPX_IMG_FMT_YV12:
+      for (const webrtc::DesktopRect& rect : rects) {
+        int rgb_offset = rgb_stride * rect.top() +
+                         rect.left() * kBytesPerRgbPixel;
+        int y_offset = y_stride * rect.top() + rect.left();
+        int uv_offset = uv_stride * rect.top() / 2 + rect.left() / 2;
+        libyuv::ARGBToI420(rgb_data + rgb_offset, rgb_stride,
+                           y_data + y_offset, y_stride,
+                           u_data + uv_offset, uv_stride,
+                           v_data + uv_offset, uv_stride,
+                           rect.width(), rect.height());
+      }
+      break;
+    default:
+      NOTREACHED();
+      break;
+  }
+}
+
+// Runs ConvertRectsToYuv() on a worker thread, then signals |done|.
+void ConvertRectsToYuvAndSignal(const webrtc::DesktopFrame* frame,
+                                const std::vector<webrtc::DesktopRect>* rects,
+                                vpx_image_t* image,
+                                base::WaitableEvent* done) {
+  ConvertRectsToYuv(*frame, *rects, image);
+  done->Signal();
+}
+
+// Converts |region| of |frame| to YUV in |image|, using up to |max_threads|
+// threads for large regions. Each thread converts a horizontal band of every
+// rectangle, and the bands start on even rows so that they share no chroma
+// samples.
+void ConvertRegionToYuv(const webrtc::DesktopFrame& frame,
+                        const webrtc::DesktopRegion& region,
+                        int max_threads,
+                        vpx_image_t* image) {
+  int pixels = 0;
+  for (webrtc::DesktopRegion::Iterator r(region); !r.IsAtEnd(); r.Advance())
+    pixels += r.rect().width() * r.rect().height();
+  int threads = std::max(
+      1, std::min(max_threads, pixels / kMinPixelsPerConversionThread));
+
+  std::vector<std::vector<webrtc::DesktopRect>> bands(threads);
+  for (webrtc::DesktopRegion::Iterator r(region); !r.IsAtEnd(); r.Advance()) {
+    const webrtc::DesktopRect& rect = r.rect();
+    int top = rect.top();
+    for (int i = 0; i < threads; ++i) {
+      int bottom = rect.bottom();
+      if (i < threads - 1)
+        bottom = rect.top() + ((rect.height() * (i + 1) / threads) & ~1);
+      if (bottom > top) {
+        bands[i].push_back(
+            webrtc::DesktopRect::MakeLTRB(rect.left(), top, rect.right(),
+                                          bottom));
+      }
+      top = bottom;
+    }
+  }
+
+  // Convert the first band on this thread while the others are converted on
+  // worker threads.
+  std::vector<std::unique_ptr<base::WaitableEvent>> done;
+  for (int i = 1; i < threads; ++i) {
+    done.push_back(base::WrapUnique(new base::WaitableEvent(
+        base::WaitableEvent::ResetPolicy::MANUAL,
+        base::WaitableEvent::InitialState::NOT_SIGNALED)));
+    if (!base::WorkerPool::PostTask(
+            FROM_HERE,
+            base::Bind(&ConvertRectsToYuvAndSignal, &frame, &bands[i], image,
+                       done.back().get()),
+            false)) {
+      ConvertRectsToYuv(frame, bands[i], image);
+      done.back()->Signal();
+    }
+  }
+  ConvertRectsToYuv(frame, bands[0], image);
+  for (const auto& event : done)
+    event->Wait();
+}
+
 }  // namespace
 
 // static
@@ -460,49 +622,8 @@ void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
   }
 
   // Convert the updated region to YUV ready for encoding.
-  const uint8_t* rgb_data = frame.data();
-  const int rgb_stride = frame.stride();
-  const int y_stride = image_->stride[0];
-  DCHECK_EQ(image_->stride[1], image_->stride[2]);
-  const int uv_stride = image_->stride[1];
-  uint8_t* y_data = image_->planes[0];
-  uint8_t* u_data = image_->planes[1];
-  uint8_t* v_data = image_->planes[2];
-
-  switch (image_->fmt) {
-    case VPX_IMG_FMT_I444:
-      for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
-           r.Advance()) {
-        const webrtc::DesktopRect& rect = r.rect();
-        int rgb_offset = rgb_stride * rect.top() +
-                         rect.left() * kBytesPerRgbPixel;
-        int yuv_offset = uv_stride * rect.top() + rect.left();
-        libyuv::ARGBToI444(rgb_data + rgb_offset, rgb_stride,
-                           y_data + yuv_offset, y_stride,
-                           u_data + yuv_offset, uv_stride,
-                           v_data + yuv_offset, uv_stride,
-                           rect.width(), rect.height());
-      }
-      break;
-    case VPX_IMG_FMT_YV12:
-      for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
-           r.Advance()) {
-        const webrtc::DesktopRect& rect = r.rect();
-        int rgb_offset = rgb_stride * rect.top() +
-                         rect.left() * kBytesPerRgbPixel;
-        int y_offset = y_stride * rect.top() + rect.left();
-        int uv_offset = uv_stride * rect.top() / 2 + rect.left() / 2;
-        libyuv::ARGBToI420(rgb_data + rgb_offset, rgb_stride,
-                           y_data + y_offset, y_stride,
-                           u_data + uv_offset, uv_stride,
-                           v_data + uv_offset, uv_stride,
-                           rect.width(), rect.height());
-      }
-      break;
-    default:
-      NOTREACHED();
-      break;
-  }
+  ConvertRegionToYuv(frame, *updated_region,
+                     codec_->config.enc->g_threads, image_.get());
 }
 
 void VideoEncoderVpx::SetActiveMapFromRegion(
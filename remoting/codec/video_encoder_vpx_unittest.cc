@@ -150,6 +150,23 @@ TEST(VideoEncoderVpxTest, Vp9SizeChangeNoCrash) {
   EXPECT_TRUE(packet);
 }
 
+// Test that frames large enough to be encoded by multiple threads, in multiple
+// partitions or tiles, are encoded.
+TEST(VideoEncoderVpxTest, LargeFrame) {
+  webrtc::DesktopSize frame_size(3840, 2160);
+  std::unique_ptr<webrtc::DesktopFrame> frame(CreateTestFrame(frame_size));
+
+  std::unique_ptr<VideoEncoderVpx> vp8_encoder(VideoEncoderVpx::CreateForVP8());
+  std::unique_ptr<VideoPacket> packet = vp8_encoder->Encode(*frame, 0);
+  ASSERT_TRUE(packet);
+  EXPECT_TRUE(packet->key_frame());
+
+  std::unique_ptr<VideoEncoderVpx> vp9_encoder(VideoEncoderVpx::CreateForVP9());
+  packet = vp9_encoder->Encode(*frame, 0);
+  ASSERT_TRUE(packet);
+  EXPECT_TRUE(packet->key_frame());
+}
+
 // Test that the DPI information is correctly propagated from the
 // webrtc::DesktopFrame to the VideoPacket.
 TEST(VideoEncoderVpxTest, DpiPropagation) {
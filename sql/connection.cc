@@ -46,6 +46,20 @@ namespace {
 // TODO(shess): Better story on this.  http://crbug.com/56559
 const int kBusyTimeoutSeconds = 1;
 
+// Roomy enough for all the statements of the history database, while keeping
+// callers which build statement ids dynamically from growing the cache without
+// bound.
+const size_t kMaxCachedStatements = 256;
+
+// In WAL mode, the log is checkpointed once the database has seen no commits
+// for this long.
+const int kCheckpointDelaySeconds = 10;
+
+// Backstop for databases which never go idle, or which have no task runner to
+// post the checkpoint to.  SQLite's own automatic checkpoint runs at 1000
+// pages.
+const int kMaxWALPages = 4000;
+
 class ScopedBusyTimeout {
  public:
   explicit ScopedBusyTimeout(sqlite3* db)
@@ -328,6 +342,7 @@ Connection::Connection()
       cache_size_(0),
       exclusive_locking_(false),
       restrict_to_user_(false),
+      statement_cache_(kMaxCachedStatements),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
@@ -335,12 +350,15 @@ Connection::Connection()
       mmap_disabled_(false),
       mmap_enabled_(false),
       total_changes_at_last_release_(0),
+      wal_mode_(false),
+      checkpoint_scheduled_(false),
       stats_histogram_(NULL),
       commit_time_histogram_(NULL),
       autocommit_time_histogram_(NULL),
       update_time_histogram_(NULL),
       query_time_histogram_(NULL),
-      clock_(new TimeSource()) {
+      clock_(new TimeSource()),
+      weak_factory_(this) {
 }
 
 Connection::~Connection() {
@@ -439,7 +457,11 @@ void Connection::CloseInternal(bool forced) {
   // sqlite3_close() needs all prepared statements to be finalized.
 
   // Release cached statements.
-  statement_cache_.clear();
+  statement_cache_.Clear();
+
+  // SQLite checkpoints the log itself when the last connection closes.
+  weak_factory_.InvalidateWeakPtrs();
+  checkpoint_scheduled_ = false;
 
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
@@ -1006,6 +1028,95 @@ void Connection::TrimMemory(bool aggressively) {
     DLOG(WARNING) << "Could not restore cache size: " << GetErrorMessage();
 }
 
+bool Connection::CheckpointDatabase() {
+  AssertIOAllowed();
+
+  if (!db_) {
+    DLOG_IF(FATAL, !poisoned_) << "Cannot checkpoint null db";
+    return false;
+  }
+
+  if (!wal_mode_)
+    return true;
+
+  // PASSIVE copies as much of the log as it can without blocking, and leaves
+  // the rest for the next checkpoint.
+  int rc = sqlite3_wal_checkpoint_v2(db_, NULL, SQLITE_CHECKPOINT_PASSIVE,
+                                     NULL, NULL);
+  if (rc != SQLITE_OK)
+    UMA_HISTOGRAM_SPARSE_SLOWLY("Sqlite.CheckpointFailure", rc);
+  return rc == SQLITE_OK;
+}
+
+// static
+int Connection::OnWALCommit(void* connection,
+                            sqlite3* db,
+                            const char* db_name,
+                            int wal_pages) {
+  Connection* self = static_cast<Connection*>(connection);
+  self->last_wal_commit_time_ = self->Now();
+
+  if (wal_pages >= kMaxWALPages) {
+    sqlite3_wal_checkpoint_v2(db, db_name, SQLITE_CHECKPOINT_PASSIVE, NULL,
+                              NULL);
+    return SQLITE_OK;
+  }
+
+  // There may not be a registered thread task runner in tests.
+  if (!self->checkpoint_scheduled_ && base::ThreadTaskRunnerHandle::IsSet()) {
+    self->checkpoint_scheduled_ = true;
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&Connection::RunScheduledCheckpoint,
+                   self->weak_factory_.GetWeakPtr()),
+        base::TimeDelta::FromSeconds(kCheckpointDelaySeconds));
+  }
+  return SQLITE_OK;
+}
+
+void Connection::RunScheduledCheckpoint() {
+  DCHECK(checkpoint_scheduled_);
+  DCHECK(db_);
+
+  // Wait for the database to go quiet, and for any open transaction to end.
+  const base::TimeDelta kCheckpointDelay =
+      base::TimeDelta::FromSeconds(kCheckpointDelaySeconds);
+  const base::TimeDelta idle_time = Now() - last_wal_commit_time_;
+  if (transaction_nesting_ || idle_time < kCheckpointDelay) {
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&Connection::RunScheduledCheckpoint,
+                   weak_factory_.GetWeakPtr()),
+        transaction_nesting_ ? kCheckpointDelay : kCheckpointDelay - idle_time);
+    return;
+  }
+
+  checkpoint_scheduled_ = false;
+  ignore_result(CheckpointDatabase());
+}
+
+bool Connection::SetJournalMode(bool wal) {
+  // Uses the SQLite API directly, because this runs from Raze() and Recovery,
+  // where errors should not reach the error callback.
+  const char* sql =
+      wal ? "PRAGMA journal_mode = WAL" : "PRAGMA journal_mode = TRUNCATE";
+  sqlite3_stmt* stmt = NULL;
+  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, NULL) != SQLITE_OK)
+    return false;
+
+  // The pragma returns the journal mode in effect afterwards, which is left
+  // unchanged if the change is not possible.
+  bool ret = false;
+  if (sqlite3_step(stmt) == SQLITE_ROW) {
+    const char* mode =
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    ret = mode && base::EqualsCaseInsensitiveASCII(mode,
+                                                   wal ? "wal" : "truncate");
+  }
+  sqlite3_finalize(stmt);
+  return ret;
+}
+
 // Create an in-memory database with the existing database's page
 // size, then backup that database over the existing database.
 bool Connection::Raze() {
@@ -1071,6 +1182,12 @@ bool Connection::Raze() {
   // page_size" can be used to query such a database.
   ScopedWritableSchema writable_schema(db_);
 
+  // The backup cannot write into a WAL database with a different page size,
+  // and would go through the log anyhow.  Razing leaves the file empty, so
+  // nothing is lost if the log cannot be copied back first.
+  if (wal_mode_)
+    ignore_result(SetJournalMode(false));
+
   const char* kMain = "main";
   int rc = BackupDatabase(null_db.db_, db_, kMain);
   UMA_HISTOGRAM_SPARSE_SLOWLY("Sqlite.RazeDatabase",rc);
@@ -1116,6 +1233,9 @@ bool Connection::Raze() {
     return false;
   }
 
+  if (wal_mode_)
+    ignore_result(SetJournalMode(true));
+
   return true;
 }
 
@@ -1420,26 +1540,32 @@ bool Connection::ExecuteWithTimeout(const char* sql, base::TimeDelta timeout) {
 }
 
 bool Connection::HasCachedStatement(const StatementID& id) const {
-  return statement_cache_.find(id) != statement_cache_.end();
+  return statement_cache_.Peek(id) != statement_cache_.end();
 }
 
 scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     const StatementID& id,
     const char* sql) {
-  CachedStatementMap::iterator i = statement_cache_.find(id);
+  CachedStatementMap::iterator i = statement_cache_.Get(id);
   if (i != statement_cache_.end()) {
     // Statement is in the cache. It should still be active (we're the only
     // one invalidating cached statements, and we'll remove it from the cache
     // if we do that. Make sure we reset it before giving out the cached one in
     // case it still has some stuff bound.
     DCHECK(i->second->is_valid());
+    RecordOneEvent(EVENT_STATEMENT_CACHE_HIT);
     sqlite3_reset(i->second->stmt());
     return i->second;
   }
 
+  RecordOneEvent(EVENT_STATEMENT_CACHE_MISS);
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
-    statement_cache_[id] = statement;  // Only cache valid statements.
+  if (statement->is_valid()) {
+    // Only cache valid statements.
+    statement_cache_.Put(id, statement);
+    if (memory_dump_provider_)
+      memory_dump_provider_->SetCachedStatementCount(statement_cache_.size());
+  }
   return statement;
 }
 
@@ -1743,7 +1869,20 @@ bool Connection::OpenInternal(const std::string& file_name,
   // TRUNCATE should be faster than DELETE because it won't need directory
   // changes for each transaction.  PERSIST may break the spirit of using
   // secure_delete.
-  ignore_result(Execute("PRAGMA journal_mode = TRUNCATE"));
+  //
+  // WAL - append to the -wal file to commit, see set_wal_mode().
+  if (wal_mode_ && !in_memory_) {
+    // The journal mode must be set before the hook, which replaces SQLite's
+    // own automatic checkpoint.
+    if (SetJournalMode(true)) {
+      ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+      sqlite3_wal_hook(db_, &Connection::OnWALCommit, this);
+    } else {
+      DLOG(WARNING) << "Could not enable WAL mode: " << GetErrorMessage();
+    }
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = TRUNCATE"));
+  }
 
   const base::TimeDelta kBusyTimeout =
     base::TimeDelta::FromSeconds(kBusyTimeoutSeconds);
@@ -15,9 +15,11 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/time/time.h"
 #include "sql/sql_export.h"
@@ -152,6 +154,21 @@ class SQL_EXPORT Connection {
   // Call to opt out of memory-mapped file I/O.
   void set_mmap_disabled() { mmap_disabled_ = true; }
 
+  // Call to use write-ahead logging instead of the rollback journal.
+  //
+  // In WAL mode a commit appends to the -wal file, and with
+  // "PRAGMA synchronous=NORMAL" the file is only synced when the log is
+  // copied back into the database.  A crash of the process cannot lose
+  // committed data, but a power failure can lose the most recent commits.
+  // Instead of copying the log back as part of a commit, a checkpoint is
+  // posted to the current thread's task runner once the database has been
+  // idle for a while.
+  //
+  // Every connection to the database should use the same mode, as Open()
+  // otherwise tries to switch the journal mode under the other connections.
+  // This must be called before Open() to have an effect.
+  void set_wal_mode() { wal_mode_ = true; }
+
   // Set an error-handling callback.  On errors, the error number (and
   // statement, if available) will be passed to the callback.
   //
@@ -218,6 +235,10 @@ class SQL_EXPORT Connection {
     EVENT_MMAP_SUCCESS_PARTIAL,      // Read but did not reach EOF.
     EVENT_MMAP_SUCCESS_NO_PROGRESS,  // Read quota exhausted.
 
+    // Track how often GetCachedStatement() finds the statement in the cache.
+    EVENT_STATEMENT_CACHE_HIT,
+    EVENT_STATEMENT_CACHE_MISS,
+
     // Leave this at the end.
     // TODO(shess): |EVENT_MAX| causes compile fail on Windows.
     EVENT_MAX_VALUE
@@ -283,6 +304,11 @@ class SQL_EXPORT Connection {
   // usage by half.
   void TrimMemory(bool aggressively);
 
+  // Copy the contents of the write-ahead log back into the database without
+  // waiting on readers or writers.  Returns true on success, or if the
+  // database is not in WAL mode.
+  bool CheckpointDatabase();
+
   // Raze the database to the ground.  This approximates creating a
   // fresh database from scratch, within the constraints of SQLite's
   // locking protocol (locks and open handles can make doing this with
@@ -679,6 +705,23 @@ class SQL_EXPORT Connection {
   // which do not participate in the total-rows-changed tracking.
   void ReleaseCacheMemoryIfNeeded(bool implicit_change_performed);
 
+  // Called by SQLite after each commit in WAL mode, with the number of pages
+  // in the log.  Schedules a checkpoint for when the database goes idle.
+  static int OnWALCommit(void* connection,
+                         sqlite3* db,
+                         const char* db_name,
+                         int wal_pages);
+
+  // Runs the checkpoint scheduled by OnWALCommit(), or reschedules it if the
+  // database is still in use.
+  void RunScheduledCheckpoint();
+
+  // Switches the database between WAL mode and the rollback journal.
+  // Raze() and Recovery copy whole databases with the backup API, which
+  // does not work into a database in exclusive WAL mode or with a different
+  // page size.
+  bool SetJournalMode(bool wal);
+
   // Returns the results of sqlite3_db_filename(), which should match the path
   // passed to Open().
   base::FilePath DbPath() const;
@@ -727,9 +770,10 @@ class SQL_EXPORT Connection {
   bool exclusive_locking_;
   bool restrict_to_user_;
 
-  // All cached statements. Keeping a reference to these statements means that
-  // they'll remain active.
-  typedef std::map<StatementID, scoped_refptr<StatementRef> >
+  // The most recently used cached statements. Keeping a reference to these
+  // statements means that they'll remain active. The least recently used
+  // statement is released once there are more than kMaxCachedStatements.
+  typedef base::MRUCache<StatementID, scoped_refptr<StatementRef>>
       CachedStatementMap;
   CachedStatementMap statement_cache_;
 
@@ -768,6 +812,16 @@ class SQL_EXPORT Connection {
   // since memory was last released.
   int total_changes_at_last_release_;
 
+  // |true| if the database should be opened in WAL mode.
+  bool wal_mode_;
+
+  // |true| if RunScheduledCheckpoint() has been posted.
+  bool checkpoint_scheduled_;
+
+  // Time of the most recent commit in WAL mode, used to tell when the
+  // database has gone idle.
+  base::TimeTicks last_wal_commit_time_;
+
   ErrorCallback error_callback_;
 
   // Tag for auxiliary histograms.
@@ -796,6 +850,8 @@ class SQL_EXPORT Connection {
   // Stores the dump provider object when db is open.
   std::unique_ptr<ConnectionMemoryDumpProvider> memory_dump_provider_;
 
+  base::WeakPtrFactory<Connection> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(Connection);
 };
 
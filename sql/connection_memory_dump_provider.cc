@@ -15,7 +15,7 @@ namespace sql {
 ConnectionMemoryDumpProvider::ConnectionMemoryDumpProvider(
     sqlite3* db,
     const std::string& name)
-    : db_(db), connection_name_(name) {}
+    : db_(db), cached_statement_count_(0), connection_name_(name) {}
 
 ConnectionMemoryDumpProvider::~ConnectionMemoryDumpProvider() {}
 
@@ -24,6 +24,11 @@ void ConnectionMemoryDumpProvider::ResetDatabase() {
   db_ = nullptr;
 }
 
+void ConnectionMemoryDumpProvider::SetCachedStatementCount(size_t count) {
+  base::AutoLock lock(lock_);
+  cached_statement_count_ = count;
+}
+
 bool ConnectionMemoryDumpProvider::OnMemoryDump(
     const base::trace_event::MemoryDumpArgs& args,
     base::trace_event::ProcessMemoryDump* pmd) {
@@ -33,6 +38,7 @@ bool ConnectionMemoryDumpProvider::OnMemoryDump(
   int cache_size = 0;
   int schema_size = 0;
   int statement_size = 0;
+  size_t cached_statement_count = 0;
   {
     // Lock is acquired here so that db_ is not reset in ResetDatabase when
     // collecting stats.
@@ -52,6 +58,7 @@ bool ConnectionMemoryDumpProvider::OnMemoryDump(
     status = sqlite3_db_status(db_, SQLITE_DBSTATUS_STMT_USED, &statement_size,
                                &dummy_int, 0 /* resetFlag */);
     DCHECK_EQ(SQLITE_OK, status);
+    cached_statement_count = cached_statement_count_;
   }
 
   std::string name = base::StringPrintf(
@@ -71,6 +78,9 @@ bool ConnectionMemoryDumpProvider::OnMemoryDump(
   dump->AddScalar("statement_size",
                   base::trace_event::MemoryAllocatorDump::kUnitsBytes,
                   statement_size);
+  dump->AddScalar("cached_statement_count",
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  cached_statement_count);
   return true;
 }
 
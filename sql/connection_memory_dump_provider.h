@@ -5,6 +5,8 @@
 #ifndef SQL_CONNECTION_MEMORY_DUMP_PROVIDER_H
 #define SQL_CONNECTION_MEMORY_DUMP_PROVIDER_H
 
+#include <stddef.h>
+
 #include <string>
 
 #include "base/macros.h"
@@ -23,6 +25,9 @@ class ConnectionMemoryDumpProvider
 
   void ResetDatabase();
 
+  // Reported along with the memory used by the statements.
+  void SetCachedStatementCount(size_t count);
+
   // base::trace_event::MemoryDumpProvider implementation.
   bool OnMemoryDump(
       const base::trace_event::MemoryDumpArgs& args,
@@ -30,6 +35,7 @@ class ConnectionMemoryDumpProvider
 
  private:
   sqlite3* db_;  // not owned.
+  size_t cached_statement_count_;
   base::Lock lock_;
   std::string connection_name_;
 
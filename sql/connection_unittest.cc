@@ -307,6 +307,28 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+// The statement cache only keeps the most recently used statements.
+TEST_F(SQLConnectionTest, CachedStatementEviction) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  const int kStatementCount = 1000;
+  for (int i = 0; i < kStatementCount; ++i) {
+    sql::Statement s(db().GetCachedStatement(sql::StatementID("foo", i),
+                                             "SELECT a FROM foo"));
+    ASSERT_TRUE(s.is_valid());
+
+    // Using the first statement again keeps it in the cache.
+    sql::Statement first(db().GetCachedStatement(sql::StatementID("foo", 0),
+                                                 "SELECT a FROM foo"));
+    ASSERT_TRUE(first.is_valid());
+  }
+
+  EXPECT_TRUE(db().HasCachedStatement(sql::StatementID("foo", 0)));
+  EXPECT_FALSE(db().HasCachedStatement(sql::StatementID("foo", 1)));
+  EXPECT_TRUE(
+      db().HasCachedStatement(sql::StatementID("foo", kStatementCount - 1)));
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -552,6 +574,72 @@ TEST_F(SQLConnectionTest, RazeMultiple) {
   ASSERT_EQ(0, SqliteMasterCount(&other_db));
 }
 
+// The Mojo VFS does not provide the shared memory WAL mode needs.
+#if !defined(MOJO_APPTEST_IMPL)
+// Test that set_wal_mode() commits to the log, and that CheckpointDatabase()
+// copies the log back into the database.
+TEST_F(SQLConnectionTest, WALMode) {
+  db().Close();
+  db().set_wal_mode();
+  ASSERT_TRUE(db().Open(db_path()));
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  // Switching to WAL mode writes the database header.
+  int64_t initial_db_size = 0;
+  ASSERT_TRUE(base::GetFileSize(db_path(), &initial_db_size));
+
+  const base::FilePath wal_path(db_path().value() + FILE_PATH_LITERAL("-wal"));
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (id INTEGER PRIMARY KEY, value)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (value) VALUES (12)"));
+  int64_t wal_size = 0;
+  ASSERT_TRUE(base::GetFileSize(wal_path, &wal_size));
+  EXPECT_GT(wal_size, 0);
+
+  // Nothing has been copied into the database yet.
+  int64_t db_size = 0;
+  ASSERT_TRUE(base::GetFileSize(db_path(), &db_size));
+  EXPECT_EQ(initial_db_size, db_size);
+
+  ASSERT_TRUE(db().CheckpointDatabase());
+  ASSERT_TRUE(base::GetFileSize(db_path(), &db_size));
+  EXPECT_GT(db_size, initial_db_size);
+
+  // Another connection sees the same data.
+  sql::Connection other_db;
+  other_db.set_wal_mode();
+  ASSERT_TRUE(other_db.Open(db_path()));
+  sql::Statement s(other_db.GetUniqueStatement("SELECT value FROM foo"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(12, s.ColumnInt(0));
+}
+
+// Test that Raze() works in WAL mode, and leaves the database in WAL mode.
+TEST_F(SQLConnectionTest, RazeWAL) {
+  db().Close();
+  db().set_wal_mode();
+  db().set_exclusive_locking();
+  ASSERT_TRUE(db().Open(db_path()));
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (id INTEGER PRIMARY KEY, value)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (value) VALUES (12)"));
+
+  ASSERT_TRUE(db().Raze());
+  EXPECT_EQ(0, SqliteMasterCount(&db()));
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  // The razed database is usable.
+  ASSERT_TRUE(db().Execute("CREATE TABLE bar (id INTEGER PRIMARY KEY)"));
+  EXPECT_EQ(1, SqliteMasterCount(&db()));
+}
+#endif  // !defined(MOJO_APPTEST_IMPL)
+
 // TODO(erg): Enable this in the next patch once I add locking.
 #if !defined(MOJO_APPTEST_IMPL)
 TEST_F(SQLConnectionTest, RazeLocked) {
@@ -186,6 +186,15 @@ bool Recovery::Init(const base::FilePath& db_path) {
   // is necessary for the final backup which rewrites things.  It
   // might be reasonable to close then re-open the handle.
   ignore_result(db_->Execute("PRAGMA writable_schema=1"));
+
+  // Leave WAL mode, which copies the log into the database.  An
+  // exclusive-mode database cannot go back to normal locking while in WAL
+  // mode, and the final backup cannot write into a WAL database with a
+  // different page size.  If the log cannot be copied back, the attached
+  // handle still reads through it in the non-exclusive case.
+  if (db_->wal_mode_)
+    ignore_result(db_->SetJournalMode(false));
+
   ignore_result(db_->Execute("PRAGMA locking_mode=NORMAL"));
   ignore_result(db_->Execute("SELECT COUNT(*) FROM sqlite_master"));
 
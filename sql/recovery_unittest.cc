@@ -179,6 +179,33 @@ TEST_F(SQLRecoveryTest, RecoverBasic) {
             ExecuteWithResults(&db(), kXSql, "|", "\n"));
 }
 
+// Test that recovery sees data which is only in the log of a WAL database.
+TEST_F(SQLRecoveryTest, RecoverWAL) {
+  db().Close();
+  db().set_wal_mode();
+  db().set_exclusive_locking();
+  ASSERT_TRUE(db().Open(db_path()));
+
+  const char kCreateSql[] = "CREATE TABLE x (t TEXT)";
+  ASSERT_TRUE(db().Execute(kCreateSql));
+  ASSERT_TRUE(db().Execute("INSERT INTO x VALUES ('This is a test')"));
+
+  {
+    std::unique_ptr<sql::Recovery> recovery =
+        sql::Recovery::Begin(&db(), db_path());
+    ASSERT_TRUE(recovery.get());
+    ASSERT_TRUE(recovery->db()->Execute(kCreateSql));
+    ASSERT_TRUE(recovery->db()->Execute(
+        "INSERT INTO x SELECT t FROM corrupt.x"));
+    ASSERT_TRUE(sql::Recovery::Recovered(std::move(recovery)));
+  }
+  EXPECT_FALSE(db().is_open());
+  ASSERT_TRUE(Reopen());
+  ASSERT_EQ("CREATE TABLE x (t TEXT)", GetSchema(&db()));
+  EXPECT_EQ("This is a test",
+            ExecuteWithResults(&db(), "SELECT * FROM x", "|", "\n"));
+}
+
 // Test operation of the virtual table used by sql::Recovery.
 TEST_F(SQLRecoveryTest, VirtualTable) {
   const char kCreateSql[] = "CREATE TABLE x (t TEXT)";
@@ -71,6 +71,13 @@ IPCBlobCreationCancelCode ConvertReferencedBlobErrorToConstructingError(
 using MemoryItemRequest =
     BlobAsyncTransportRequestBuilder::RendererMemoryItemRequest;
 
+BlobAsyncBuilderHost::SharedMemorySegment::SharedMemorySegment() {}
+
+BlobAsyncBuilderHost::SharedMemorySegment::SharedMemorySegment(
+    SharedMemorySegment&& other) = default;
+
+BlobAsyncBuilderHost::SharedMemorySegment::~SharedMemorySegment() {}
+
 BlobAsyncBuilderHost::BlobBuildingState::BlobBuildingState(
     const std::string& uuid,
     std::set<std::string> referenced_blob_uuids,
@@ -210,7 +217,7 @@ BlobTransportResult BlobAsyncBuilderHost::OnMemoryResponses(
   BlobAsyncTransportRequestBuilder& request_builder = state->request_builder;
   const auto& requests = request_builder.requests();
   for (const BlobItemBytesResponse& response : responses) {
-    if (response.request_number >= requests.size()) {
+    if (response.request_number >= state->next_request) {
       // Bad IPC, so we delete our record and ignore.
       DVLOG(1) << "Invalid request number " << response.request_number;
       CancelBuildingBlob(uuid, IPCBlobCreationCancelCode::UNKNOWN, context);
@@ -239,21 +246,19 @@ BlobTransportResult BlobAsyncBuilderHost::OnMemoryResponses(
             request.browser_item_index, &response.inline_data[0],
             request.browser_item_offset, request.message.size);
         break;
-      case IPCBlobItemRequestStrategy::SHARED_MEMORY:
-        if (state->num_shared_memory_requests == 0) {
-          DVLOG(1) << "Received too many responses for shared memory.";
-          invalid_ipc = true;
-          break;
-        }
-        state->num_shared_memory_requests--;
-        if (!state->shared_memory_block->memory()) {
+      case IPCBlobItemRequestStrategy::SHARED_MEMORY: {
+        auto segment_it =
+            state->shared_memory_segments.find(request.message.handle_index);
+        DCHECK(segment_it != state->shared_memory_segments.end());
+        SharedMemorySegment& segment = segment_it->second;
+        if (!segment.block->memory()) {
           // We just map the whole block, as we'll probably be accessing the
           // whole thing in this group of responses. Another option is to use
           // MapAt, remove the mapped boolean, and then exclude the
           // handle_offset below.
           size_t handle_size = request_builder.shared_memory_sizes()
-                                   [state->current_shared_memory_handle_index];
-          if (!state->shared_memory_block->Map(handle_size)) {
+                                   [request.message.handle_index];
+          if (!segment.block->Map(handle_size)) {
             DVLOG(1) << "Unable to map memory to size " << handle_size;
             memory_error = true;
             break;
@@ -262,10 +267,16 @@ BlobTransportResult BlobAsyncBuilderHost::OnMemoryResponses(
 
         invalid_ipc = !state->data_builder.PopulateFutureData(
             request.browser_item_index,
-            static_cast<const char*>(state->shared_memory_block->memory()) +
+            static_cast<const char*>(segment.block->memory()) +
                 request.message.handle_offset,
             request.browser_item_offset, request.message.size);
+        DCHECK_GT(segment.num_requests, 0u);
+        if (--segment.num_requests == 0) {
+          state->free_shared_memory_blocks.push_back(std::move(segment.block));
+          state->shared_memory_segments.erase(segment_it);
+        }
         break;
+      }
       case IPCBlobItemRequestStrategy::FILE:
       case IPCBlobItemRequestStrategy::UNKNOWN:
         DVLOG(1) << "Not implemented.";
@@ -348,63 +359,64 @@ BlobTransportResult BlobAsyncBuilderHost::ContinueBlobMemoryRequests(
     return BlobTransportResult::PENDING_RESPONSES;
   }
 
-  std::unique_ptr<std::vector<BlobItemBytesRequest>> byte_requests(
-      new std::vector<BlobItemBytesRequest>());
-  std::unique_ptr<std::vector<base::SharedMemoryHandle>> shared_memory(
-      new std::vector<base::SharedMemoryHandle>());
-
-  for (; state->next_request < num_requests; ++state->next_request) {
-    const MemoryItemRequest& request = requests[state->next_request];
+  while (state->next_request < num_requests) {
+    std::unique_ptr<std::vector<BlobItemBytesRequest>> byte_requests(
+        new std::vector<BlobItemBytesRequest>());
+    std::unique_ptr<std::vector<base::SharedMemoryHandle>> shared_memory(
+        new std::vector<base::SharedMemoryHandle>());
 
-    bool stop_accumulating = false;
-    bool using_shared_memory_handle = state->num_shared_memory_requests > 0;
-    switch (request.message.transport_strategy) {
+    const MemoryItemRequest& first_request = requests[state->next_request];
+    switch (first_request.message.transport_strategy) {
       case IPCBlobItemRequestStrategy::IPC:
-        byte_requests->push_back(request.message);
+        for (; state->next_request < num_requests; ++state->next_request)
+          byte_requests->push_back(requests[state->next_request].message);
         break;
-      case IPCBlobItemRequestStrategy::SHARED_MEMORY:
-        if (using_shared_memory_handle &&
-            state->current_shared_memory_handle_index !=
-                request.message.handle_index) {
-          // We only want one shared memory per requesting blob.
-          stop_accumulating = true;
-          break;
+      case IPCBlobItemRequestStrategy::SHARED_MEMORY: {
+        if (state->shared_memory_segments.size() >=
+            kBlobStorageMaxSharedMemorySegmentsInFlight) {
+          // We ask for more once the renderer is done with a segment.
+          return BlobTransportResult::PENDING_RESPONSES;
         }
-        using_shared_memory_handle = true;
-        state->current_shared_memory_handle_index =
-            request.message.handle_index;
-        state->num_shared_memory_requests++;
-
-        if (!state->shared_memory_block) {
-          state->shared_memory_block.reset(new base::SharedMemory());
-          size_t size =
-              request_builder
-                  .shared_memory_sizes()[request.message.handle_index];
-          if (!state->shared_memory_block->CreateAnonymous(size)) {
+        size_t handle_index = first_request.message.handle_index;
+        size_t size = request_builder.shared_memory_sizes()[handle_index];
+        SharedMemorySegment& segment =
+            state->shared_memory_segments[handle_index];
+        if (!state->free_shared_memory_blocks.empty()) {
+          // Only the last segment can be smaller than the others.
+          segment.block = std::move(state->free_shared_memory_blocks.back());
+          state->free_shared_memory_blocks.pop_back();
+          DCHECK_GE(segment.block->requested_size(), size);
+        } else {
+          segment.block.reset(new base::SharedMemory());
+          if (!segment.block->CreateAnonymous(size)) {
             DVLOG(1) << "Unable to allocate shared memory for blob transfer.";
+            state->shared_memory_segments.erase(handle_index);
             return BlobTransportResult::CANCEL_MEMORY_FULL;
           }
         }
-        shared_memory->push_back(state->shared_memory_block->handle());
-        byte_requests->push_back(request.message);
-        // Since we are only using one handle at a time, transform our handle
-        // index correctly back to 0.
-        byte_requests->back().handle_index = 0;
+        shared_memory->push_back(segment.block->handle());
+        for (; state->next_request < num_requests &&
+               requests[state->next_request].message.handle_index ==
+                   handle_index;
+             ++state->next_request) {
+          byte_requests->push_back(requests[state->next_request].message);
+          // Each group of requests only has the one handle, so transform our
+          // handle index correctly back to 0.
+          byte_requests->back().handle_index = 0;
+          segment.num_requests++;
+        }
         break;
+      }
       case IPCBlobItemRequestStrategy::FILE:
       case IPCBlobItemRequestStrategy::UNKNOWN:
         NOTREACHED() << "Not implemented yet.";
-        break;
-    }
-    if (stop_accumulating) {
-      break;
+        return BlobTransportResult::PENDING_RESPONSES;
     }
-  }
-  DCHECK(!requests.empty());
 
-  state->request_memory_callback.Run(
-      std::move(byte_requests), std::move(shared_memory),
-      base::WrapUnique(new std::vector<base::File>()));
+    state->request_memory_callback.Run(
+        std::move(byte_requests), std::move(shared_memory),
+        base::WrapUnique(new std::vector<base::File>()));
+  }
   return BlobTransportResult::PENDING_RESPONSES;
 }
 
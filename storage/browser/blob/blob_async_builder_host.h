@@ -132,6 +132,16 @@ class STORAGE_EXPORT BlobAsyncBuilderHost {
   }
 
  private:
+  struct SharedMemorySegment {
+    SharedMemorySegment();
+    SharedMemorySegment(SharedMemorySegment&& other);
+    ~SharedMemorySegment();
+
+    std::unique_ptr<base::SharedMemory> block;
+    // The number of requests using the block that haven't been responded to.
+    size_t num_requests = 0;
+  };
+
   struct BlobBuildingState {
     // |refernced_blob_handles| should be all handles generated from the set
     // of |refernced_blob_uuids|.
@@ -146,13 +156,12 @@ class STORAGE_EXPORT BlobAsyncBuilderHost {
     std::vector<bool> request_received;
     size_t next_request = 0;
     size_t num_fulfilled_requests = 0;
-    std::unique_ptr<base::SharedMemory> shared_memory_block;
-    // This is the number of requests that have been sent to populate the above
-    // shared data. We won't ask for more data in shared memory until all
-    // requests have been responded to.
-    size_t num_shared_memory_requests = 0;
-    // Only relevant if num_shared_memory_requests is > 0
-    size_t current_shared_memory_handle_index = 0;
+    // The shared memory handles the renderer is populating, by handle index.
+    // Up to kBlobStorageMaxSharedMemorySegmentsInFlight of them are requested
+    // at a time, so the renderer can fill one while we copy out of another.
+    std::map<size_t, SharedMemorySegment> shared_memory_segments;
+    // The blocks of the segments that have been copied out, for reuse.
+    std::vector<std::unique_ptr<base::SharedMemory>> free_shared_memory_blocks;
 
     // We save these to double check that the RegisterBlob and StartBuildingBlob
     // messages are in sync.
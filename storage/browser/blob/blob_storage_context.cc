@@ -14,11 +14,16 @@
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/trace_event.h"
 #include "storage/browser/blob/blob_data_builder.h"
@@ -26,13 +31,39 @@
 #include "storage/browser/blob/blob_data_item.h"
 #include "storage/browser/blob/blob_data_snapshot.h"
 #include "storage/browser/blob/shareable_blob_data_item.h"
+#include "storage/browser/blob/shareable_file_reference.h"
 #include "url/gurl.h"
 
 namespace storage {
 using BlobRegistryEntry = BlobStorageRegistry::Entry;
 using BlobState = BlobStorageRegistry::BlobState;
 
-BlobStorageContext::BlobStorageContext() : memory_usage_(0) {}
+namespace {
+
+// Returns the modification time of the written file, or a null time if the
+// file couldn't be written.
+base::Time WritePageFile(const base::FilePath& path,
+                         const char* bytes,
+                         int length) {
+  if (!base::CreateDirectory(path.DirName()) ||
+      base::WriteFile(path, bytes, length) != length) {
+    return base::Time();
+  }
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info))
+    return base::Time();
+  return info.last_modified;
+}
+
+}  // namespace
+
+BlobStorageContext::BlobStorageContext()
+    : memory_usage_(0),
+      in_memory_budget_(0),
+      next_page_file_id_(0),
+      pending_paging_bytes_(0),
+      blobs_in_memory_(
+          base::HashingMRUCache<std::string, bool>::NO_AUTO_EVICT) {}
 
 BlobStorageContext::~BlobStorageContext() {
 }
@@ -166,6 +197,11 @@ void BlobStorageContext::CompletePendingBlob(
                                 entry->broken_reason));
   }
   entry->build_completion_callbacks.clear();
+
+  if (file_task_runner_ && entry->state == BlobState::COMPLETE) {
+    blobs_in_memory_.Put(external_builder.uuid(), true);
+    MaybePageToDisk();
+  }
 }
 
 void BlobStorageContext::CancelPendingBlob(const std::string& uuid,
@@ -195,6 +231,9 @@ void BlobStorageContext::DecrementBlobRefCount(const std::string& uuid) {
     }
     DCHECK_LE(memory_freeing, memory_usage_);
     memory_usage_ -= memory_freeing;
+    auto blob_it = blobs_in_memory_.Peek(uuid);
+    if (blob_it != blobs_in_memory_.end())
+      blobs_in_memory_.Erase(blob_it);
     registry_.DeleteEntry(uuid);
   }
 }
@@ -207,6 +246,9 @@ std::unique_ptr<BlobDataSnapshot> BlobStorageContext::CreateSnapshot(
     return result;
   }
 
+  // Reading the blob makes it the last one to be paged to disk.
+  blobs_in_memory_.Get(uuid);
+
   const InternalBlobData& data = *entry->data;
   std::unique_ptr<BlobDataSnapshot> snapshot(new BlobDataSnapshot(
       uuid, entry->content_type, entry->content_disposition));
@@ -453,4 +495,87 @@ bool BlobStorageContext::AppendBlob(
   return true;
 }
 
+void BlobStorageContext::EnablePaging(
+    const base::FilePath& directory,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner,
+    size_t in_memory_budget) {
+  DCHECK(!file_task_runner_);
+  paging_directory_ = directory;
+  file_task_runner_ = std::move(file_task_runner);
+  in_memory_budget_ = in_memory_budget;
+  // The files of an earlier session can't be used anymore.
+  file_task_runner_->PostTask(
+      FROM_HERE, base::Bind(base::IgnoreResult(&base::DeleteFile),
+                            paging_directory_, true /* recursive */));
+}
+
+void BlobStorageContext::MaybePageToDisk() {
+  auto blob_it = blobs_in_memory_.rbegin();
+  while (memory_usage_ > in_memory_budget_ + pending_paging_bytes_ &&
+         blob_it != blobs_in_memory_.rend()) {
+    BlobRegistryEntry* entry = registry_.GetEntry(blob_it->first);
+    DCHECK(entry && entry->state == BlobState::COMPLETE);
+    for (const auto& shareable_item : entry->data->items()) {
+      const BlobDataItem& item = *shareable_item->item();
+      if (item.type() != DataElement::TYPE_BYTES ||
+          item.length() < kBlobStorageMinPagedItemBytes ||
+          items_being_paged_.count(shareable_item.get())) {
+        continue;
+      }
+      PageItemToDisk(shareable_item);
+    }
+    // The items left in memory are too small to page.
+    blob_it = blobs_in_memory_.Erase(blob_it);
+  }
+}
+
+void BlobStorageContext::PageItemToDisk(
+    scoped_refptr<ShareableBlobDataItem> item) {
+  const BlobDataItem& data_item = *item->item();
+  DCHECK_LE(data_item.length(),
+            static_cast<uint64_t>(std::numeric_limits<int>::max()));
+  base::FilePath path = paging_directory_.AppendASCII(
+      base::Uint64ToString(next_page_file_id_++));
+  // The file is deleted on |file_task_runner_| after the write with the last
+  // reference, whether or not it ends up being used.
+  scoped_refptr<ShareableFileReference> file_reference =
+      ShareableFileReference::GetOrCreate(
+          path, ShareableFileReference::DELETE_ON_FINAL_RELEASE,
+          file_task_runner_.get());
+  pending_paging_bytes_ += data_item.length();
+  items_being_paged_.insert(item.get());
+  // The reply holds on to |item|, which keeps the bytes alive while they are
+  // written.
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::Bind(&WritePageFile, path, data_item.bytes(),
+                 static_cast<int>(data_item.length())),
+      base::Bind(&BlobStorageContext::OnPageFileWritten, AsWeakPtr(), item,
+                 file_reference));
+}
+
+void BlobStorageContext::OnPageFileWritten(
+    scoped_refptr<ShareableBlobDataItem> item,
+    scoped_refptr<ShareableFileReference> file_reference,
+    base::Time modification_time) {
+  uint64_t length = item->item()->length();
+  DCHECK_LE(length, pending_paging_bytes_);
+  pending_paging_bytes_ -= length;
+  items_being_paged_.erase(item.get());
+  UMA_HISTOGRAM_BOOLEAN("Storage.Blob.PageFileWriteFailed",
+                        modification_time.is_null());
+  // The memory of an item without blobs was freed when its last blob went
+  // away.
+  if (modification_time.is_null() || item->referencing_blobs().empty())
+    return;
+
+  std::unique_ptr<DataElement> element(new DataElement());
+  element->SetToFilePathRange(file_reference->path(), 0, length,
+                              modification_time);
+  item->item_ = new BlobDataItem(std::move(element), file_reference);
+  DCHECK_LE(length, memory_usage_);
+  memory_usage_ -= length;
+  TRACE_COUNTER1("Blob", "MemoryStoreUsageBytes", memory_usage_);
+}
+
 }  // namespace storage
@@ -10,10 +10,13 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/callback_forward.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -28,7 +31,7 @@
 class GURL;
 
 namespace base {
-class FilePath;
+class SequencedTaskRunner;
 class Time;
 }
 
@@ -43,6 +46,7 @@ class BlobDataBuilder;
 class BlobDataItem;
 class BlobDataSnapshot;
 class ShareableBlobDataItem;
+class ShareableFileReference;
 
 // This class handles the logistics of blob Storage within the browser process,
 // and maintains a mapping from blob uuid to the data. The class is single
@@ -83,6 +87,15 @@ class STORAGE_EXPORT BlobStorageContext
 
   const BlobStorageRegistry& registry() { return registry_; }
 
+  // Once more than |in_memory_budget| bytes of blob data are held in memory,
+  // the bytes of the least recently used blobs are written to files in
+  // |directory| and read back from there. The files are written and deleted
+  // on |file_task_runner|. Anything already in |directory| is deleted, so it
+  // must not be shared with anything else.
+  void EnablePaging(const base::FilePath& directory,
+                    scoped_refptr<base::SequencedTaskRunner> file_task_runner,
+                    size_t in_memory_budget);
+
  private:
   using BlobRegistryEntry = BlobStorageRegistry::Entry;
   using BlobConstructedCallback = BlobStorageRegistry::BlobConstructedCallback;
@@ -156,6 +169,16 @@ class STORAGE_EXPORT BlobStorageContext
                   uint64_t length,
                   InternalBlobData::Builder* target_blob_data);
 
+  // Writes the bytes items of the least recently used blobs to disk until the
+  // memory usage, minus the bytes already being written, is within budget.
+  void MaybePageToDisk();
+  void PageItemToDisk(scoped_refptr<ShareableBlobDataItem> item);
+  // Swaps the bytes of |item| for the file if it was written, which is given a
+  // null |modification_time| otherwise.
+  void OnPageFileWritten(scoped_refptr<ShareableBlobDataItem> item,
+                         scoped_refptr<ShareableFileReference> file_reference,
+                         base::Time modification_time);
+
   BlobStorageRegistry registry_;
 
   // Used to keep track of how much memory is being utilized for blob data,
@@ -163,6 +186,18 @@ class STORAGE_EXPORT BlobStorageContext
   // items of TYPE_FILE.
   size_t memory_usage_;
 
+  // Paging is enabled when |file_task_runner_| is set.
+  base::FilePath paging_directory_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  size_t in_memory_budget_;
+  uint64_t next_page_file_id_;
+  // These bytes are still counted in |memory_usage_| until they are written.
+  size_t pending_paging_bytes_;
+  std::set<const ShareableBlobDataItem*> items_being_paged_;
+  // The uuids of the complete blobs that may still have items in memory, most
+  // recently used first. The values are unused.
+  base::HashingMRUCache<std::string, bool> blobs_in_memory_;
+
   DISALLOW_COPY_AND_ASSIGN(BlobStorageContext);
 };
 
@@ -15,6 +15,7 @@
 
 namespace storage {
 class BlobDataItem;
+class BlobStorageContext;
 class InternalBlobData;
 
 // This class allows blob items to be shared between blobs, and is only used by
@@ -36,6 +37,7 @@ class ShareableBlobDataItem : public base::RefCounted<ShareableBlobDataItem> {
 
  private:
   friend class base::RefCounted<ShareableBlobDataItem>;
+  friend class BlobStorageContext;
   friend class InternalBlobData;
   ~ShareableBlobDataItem();
 
@@ -15,10 +15,15 @@ namespace storage {
 const int64_t kBlobStorageMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
 const size_t kBlobStorageIPCThresholdBytes = 250 * 1024;
 const size_t kBlobStorageMaxSharedMemoryBytes = 10 * 1024 * 1024;
+const size_t kBlobStorageMaxSharedMemorySegmentsInFlight = 2;
 const uint64_t kBlobStorageMaxFileSizeBytes = 100 * 1024 * 1024;
 const uint64_t kBlobStorageMinFileSizeBytes = 1 * 1024 * 1024;
 const size_t kBlobStorageMaxBlobMemorySize =
     kBlobStorageMaxMemoryUsage - kBlobStorageMinFileSizeBytes;
+// Blob data past this much is paged to disk when paging is enabled, and only
+// items of at least kBlobStorageMinPagedItemBytes are worth a file.
+const size_t kBlobStorageInMemoryBudget = 200 * 1024 * 1024;
+const size_t kBlobStorageMinPagedItemBytes = 64 * 1024;
 
 enum class IPCBlobItemRequestStrategy {
   UNKNOWN = 0,
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/guid.h"
@@ -545,40 +546,51 @@ bool Directory::SafeToPurgeFromMemory(WriteTransaction* trans,
 
 void Directory::TakeSnapshotForSaveChanges(SaveChangesSnapshot* snapshot) {
   ReadTransaction trans(FROM_HERE, this);
-  ScopedKernelLock lock(this);
 
-  // If there is an unrecoverable error then just bail out.
-  if (unrecoverable_error_set(&trans))
-    return;
+  // The entries are protected by |trans|, and only the indices by the kernel
+  // lock. So the lock is only held while collecting the dirty entries, which
+  // are deep copied after it is released.
+  std::vector<EntryKernel*> dirty_entries;
+  {
+    ScopedKernelLock lock(this);
 
-  // Deep copy dirty entries from kernel_->metahandles_index into snapshot and
-  // clear dirty flags.
-  for (MetahandleSet::const_iterator i = kernel_->dirty_metahandles.begin();
-       i != kernel_->dirty_metahandles.end(); ++i) {
-    EntryKernel* entry = GetEntryByHandle(lock, *i);
-    if (!entry)
-      continue;
-    // Skip over false positives; it happens relatively infrequently.
-    if (!entry->is_dirty())
-      continue;
+    // If there is an unrecoverable error then just bail out.
+    if (unrecoverable_error_set(&trans))
+      return;
+
+    dirty_entries.reserve(kernel_->dirty_metahandles.size());
+    for (MetahandleSet::const_iterator i = kernel_->dirty_metahandles.begin();
+         i != kernel_->dirty_metahandles.end(); ++i) {
+      EntryKernel* entry = GetEntryByHandle(lock, *i);
+      if (!entry)
+        continue;
+      // Skip over false positives; it happens relatively infrequently.
+      if (!entry->is_dirty())
+        continue;
+      dirty_entries.push_back(entry);
+    }
+    ClearDirtyMetahandles(lock);
+
+    // Set purged handles.
+    DCHECK(snapshot->metahandles_to_purge.empty());
+    snapshot->metahandles_to_purge.swap(kernel_->metahandles_to_purge);
+
+    // Fill kernel_info_status and kernel_info.
+    snapshot->kernel_info = kernel_->persisted_info;
+    snapshot->kernel_info_status = kernel_->info_status;
+    // This one we reset on failure.
+    kernel_->info_status = KERNEL_SHARE_INFO_VALID;
+  }
+
+  // Deep copy dirty entries into snapshot and clear dirty flags. The specifics
+  // and attachment metadata are shared with the entries until they change, so
+  // this mostly copies the strings. The dirty flags are restored in
+  // HandleSaveChangesFailure() if the save fails.
+  for (EntryKernel* entry : dirty_entries) {
     snapshot->dirty_metas.insert(snapshot->dirty_metas.end(),
                                  new EntryKernel(*entry));
-    DCHECK_EQ(1U, kernel_->dirty_metahandles.count(*i));
-    // We don't bother removing from the index here as we blow the entire thing
-    // in a moment, and it unnecessarily complicates iteration.
     entry->clear_dirty(NULL);
   }
-  ClearDirtyMetahandles(lock);
-
-  // Set purged handles.
-  DCHECK(snapshot->metahandles_to_purge.empty());
-  snapshot->metahandles_to_purge.swap(kernel_->metahandles_to_purge);
-
-  // Fill kernel_info_status and kernel_info.
-  snapshot->kernel_info = kernel_->persisted_info;
-  snapshot->kernel_info_status = kernel_->info_status;
-  // This one we reset on failure.
-  kernel_->info_status = KERNEL_SHARE_INFO_VALID;
 
   delete_journal_->TakeSnapshotAndClear(
       &trans, &snapshot->delete_journals, &snapshot->delete_journals_to_purge);
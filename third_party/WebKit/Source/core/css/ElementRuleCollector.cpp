@@ -28,6 +28,7 @@
 
 #include "core/css/ElementRuleCollector.h"
 
+#include "core/HTMLNames.h"
 #include "core/css/CSSImportRule.h"
 #include "core/css/CSSKeyframesRule.h"
 #include "core/css/CSSMediaRule.h"
@@ -36,6 +37,7 @@
 #include "core/css/CSSStyleRule.h"
 #include "core/css/CSSStyleSheet.h"
 #include "core/css/CSSSupportsRule.h"
+#include "core/css/ParallelSelectorMatcher.h"
 #include "core/css/StylePropertySet.h"
 #include "core/css/resolver/StyleResolver.h"
 #include "core/css/resolver/StyleResolverStats.h"
@@ -46,6 +48,27 @@
 
 namespace blink {
 
+// The bits of RuleData::fastRejectMask() that |element| has.
+static unsigned fastRejectMaskForElement(const Element* element)
+{
+    if (!element)
+        return 0;
+    // The animated SVG attributes, including class, are unknown until they
+    // are synchronized.
+    if (element->animatedSVGAttributesAreDirty())
+        return ~0u;
+    unsigned mask = 0;
+    if (element->styleAttributeIsDirty())
+        mask |= RuleData::fastRejectBit(HTMLNames::styleAttr.localName());
+    if (element->isStyledElement() && element->hasClass()) {
+        for (size_t i = 0; i < element->classNames().size(); ++i)
+            mask |= RuleData::fastRejectBit(element->classNames()[i]);
+    }
+    for (const Attribute& attribute : element->attributesWithoutUpdate())
+        mask |= RuleData::fastRejectBit(attribute.localName());
+    return mask;
+}
+
 ElementRuleCollector::ElementRuleCollector(const ElementResolveContext& context,
     const SelectorFilter& filter, ComputedStyle* style)
     : m_context(context)
@@ -54,6 +77,7 @@ ElementRuleCollector::ElementRuleCollector(const ElementResolveContext& context,
     , m_pseudoStyleRequest(PseudoIdNone)
     , m_mode(SelectorChecker::ResolvingStyle)
     , m_canUseFastReject(m_selectorFilter.parentStackIsConsistent(context.parentNode()))
+    , m_fastRejectMask(fastRejectMaskForElement(context.element()))
     , m_sameOriginOnly(false)
     , m_matchingUARules(false)
     , m_includeEmptyRules(false)
@@ -115,7 +139,7 @@ static bool rulesApplicableInCurrentTreeScope(const Element* element, const Cont
 }
 
 template<typename RuleDataListType>
-void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* rules, CascadeOrder cascadeOrder, const MatchRequest& matchRequest)
+void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* rules, CascadeOrder cascadeOrder, const MatchRequest& matchRequest, const Vector<const RuleData*>* prematchedRules)
 {
     if (!rules)
         return;
@@ -136,6 +160,11 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* r
     unsigned matched = 0;
 
     for (const auto& ruleData : *rules) {
+        if (ruleData.fastRejectMask() & ~m_fastRejectMask) {
+            fastRejected++;
+            continue;
+        }
+
         if (m_canUseFastReject && m_selectorFilter.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes())) {
             fastRejected++;
             continue;
@@ -153,10 +182,17 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* r
             continue;
 
         SelectorChecker::MatchResult result;
-        context.selector = &ruleData.selector();
-        if (!checker.match(context, result)) {
-            rejected++;
-            continue;
+        if (prematchedRules && ruleData.isMatchableOffMainThread()) {
+            if (!std::binary_search(prematchedRules->begin(), prematchedRules->end(), &ruleData)) {
+                rejected++;
+                continue;
+            }
+        } else {
+            context.selector = &ruleData.selector();
+            if (!checker.match(context, result)) {
+                rejected++;
+                continue;
+            }
         }
         if (m_pseudoStyleRequest.pseudoId != PseudoIdNone && m_pseudoStyleRequest.pseudoId != result.dynamicPseudo) {
             rejected++;
@@ -198,21 +234,59 @@ void ElementRuleCollector::collectMatchingRules(const MatchRequest& matchRequest
     if (!m_matchingUARules && !matchingTreeBoundaryRules && !rulesApplicableInCurrentTreeScope(&element, matchRequest.scope))
         return;
 
+    // The rule lists looked up by id, class and tag name and the universal
+    // rules may have been matched in parallel before the style recalc.
+    const Vector<const RuleData*>* prematchedRules = nullptr;
+    if (m_parallelSelectorMatcher && m_mode == SelectorChecker::ResolvingStyle && !isCollectingForPseudoElement())
+        prematchedRules = m_parallelSelectorMatcher->matchedRules(element, matchRequest.ruleSet, matchRequest.scope);
+
     // We need to collect the rules for id, class, tag, and everything else into a buffer and
     // then sort the buffer.
     if (element.hasID())
-        collectMatchingRulesForList(matchRequest.ruleSet->idRules(element.idForStyleResolution()), cascadeOrder, matchRequest);
+        collectMatchingRulesForList(matchRequest.ruleSet->idRules(element.idForStyleResolution()), cascadeOrder, matchRequest, prematchedRules);
     if (element.isStyledElement() && element.hasClass()) {
         for (size_t i = 0; i < element.classNames().size(); ++i)
-            collectMatchingRulesForList(matchRequest.ruleSet->classRules(element.classNames()[i]), cascadeOrder, matchRequest);
+            collectMatchingRulesForList(matchRequest.ruleSet->classRules(element.classNames()[i]), cascadeOrder, matchRequest, prematchedRules);
     }
 
     if (element.isLink())
         collectMatchingRulesForList(matchRequest.ruleSet->linkPseudoClassRules(), cascadeOrder, matchRequest);
     if (SelectorChecker::matchesFocusPseudoClass(element))
         collectMatchingRulesForList(matchRequest.ruleSet->focusPseudoClassRules(), cascadeOrder, matchRequest);
-    collectMatchingRulesForList(matchRequest.ruleSet->tagRules(element.localNameForSelectorMatching()), cascadeOrder, matchRequest);
-    collectMatchingRulesForList(matchRequest.ruleSet->universalRules(), cascadeOrder, matchRequest);
+    for (size_t i = 0; i < RuleSet::statePseudoClassCount; ++i) {
+        const HeapVector<RuleData>* rules = matchRequest.ruleSet->statePseudoClassRules(i);
+        if (!rules->isEmpty() && SelectorChecker::matchesStatePseudoClass(element, RuleSet::statePseudoClasses[i]))
+            collectMatchingRulesForList(rules, cascadeOrder, matchRequest);
+    }
+    collectMatchingRulesForList(matchRequest.ruleSet->tagRules(element.localNameForSelectorMatching()), cascadeOrder, matchRequest, prematchedRules);
+    collectMatchingAttributeRules(matchRequest, cascadeOrder);
+    collectMatchingRulesForList(matchRequest.ruleSet->universalRules(), cascadeOrder, matchRequest, prematchedRules);
+}
+
+void ElementRuleCollector::collectMatchingAttributeRules(const MatchRequest& matchRequest, CascadeOrder cascadeOrder)
+{
+    Element& element = *m_context.element();
+    // Matching a rule synchronizes the attribute it looks at anyway, but the
+    // names of the animated SVG attributes are not known up front.
+    AttributeCollection attributes = element.animatedSVGAttributesAreDirty() ? element.attributes() : element.attributesWithoutUpdate();
+
+    bool hasStyleAttribute = false;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        const AtomicString& localName = attributes[i].localName();
+        // Attributes in different namespaces may share a local name, and the
+        // rules for it must only be collected once.
+        bool isDuplicate = false;
+        for (size_t j = 0; j < i && !isDuplicate; ++j)
+            isDuplicate = attributes[j].localName() == localName;
+        if (isDuplicate)
+            continue;
+        if (localName == HTMLNames::styleAttr.localName())
+            hasStyleAttribute = true;
+        collectMatchingRulesForList(matchRequest.ruleSet->attributeRules(localName), cascadeOrder, matchRequest);
+    }
+    // The style attribute is added when it is synchronized.
+    if (!hasStyleAttribute && element.styleAttributeIsDirty())
+        collectMatchingRulesForList(matchRequest.ruleSet->attributeRules(HTMLNames::styleAttr.localName()), cascadeOrder, matchRequest);
 }
 
 void ElementRuleCollector::collectMatchingShadowHostRules(const MatchRequest& matchRequest, CascadeOrder cascadeOrder)
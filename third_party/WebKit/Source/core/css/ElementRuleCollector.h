@@ -35,6 +35,7 @@ namespace blink {
 
 class CSSStyleSheet;
 class CSSRuleList;
+class ParallelSelectorMatcher;
 class RuleData;
 class RuleSet;
 class SelectorFilter;
@@ -103,6 +104,9 @@ public:
     void setSameOriginOnly(bool f) { m_sameOriginOnly = f; }
 
     void setMatchingUARules(bool matchingUARules) { m_matchingUARules = matchingUARules; }
+    // Looks up the results of |matcher| for the rules it matched in parallel
+    // instead of matching them again.
+    void setParallelSelectorMatcher(const ParallelSelectorMatcher* matcher) { m_parallelSelectorMatcher = matcher; }
     bool hasAnyMatchingRules(RuleSet*);
 
     const MatchResult& matchedResult() const;
@@ -122,7 +126,8 @@ public:
 
 private:
     template<typename RuleDataListType>
-    void collectMatchingRulesForList(const RuleDataListType*, CascadeOrder, const MatchRequest&);
+    void collectMatchingRulesForList(const RuleDataListType*, CascadeOrder, const MatchRequest&, const Vector<const RuleData*>* prematchedRules = nullptr);
+    void collectMatchingAttributeRules(const MatchRequest&, CascadeOrder);
 
     void didMatchRule(const RuleData&, const SelectorChecker::MatchResult&, CascadeOrder, const MatchRequest&);
 
@@ -143,9 +148,12 @@ private:
     PseudoStyleRequest m_pseudoStyleRequest;
     SelectorChecker::Mode m_mode;
     bool m_canUseFastReject;
+    // See RuleData::fastRejectMask().
+    unsigned m_fastRejectMask;
     bool m_sameOriginOnly;
     bool m_matchingUARules;
     bool m_includeEmptyRules;
+    Member<const ParallelSelectorMatcher> m_parallelSelectorMatcher;
 
     HeapVector<MatchedRule, 32> m_matchedRules;
 
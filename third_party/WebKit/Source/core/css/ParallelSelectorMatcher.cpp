@@ -0,0 +1,198 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/css/ParallelSelectorMatcher.h"
+
+#include "core/css/RuleSet.h"
+#include "core/css/SelectorChecker.h"
+#include "core/dom/Document.h"
+#include "platform/ThreadSafeFunctional.h"
+#include "platform/TraceEvent.h"
+#include "public/platform/Platform.h"
+#include "public/platform/WebTaskRunner.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/Atomics.h"
+#include "wtf/MainThread.h"
+#include "wtf/OwnPtr.h"
+#include <algorithm>
+
+namespace blink {
+
+namespace {
+
+// Matching is mostly pointer chasing through the DOM and the rule sets, which
+// stops scaling after a few threads.
+const size_t kMaxMatchingThreads = 3;
+
+// Elements are handed out in batches to keep the threads off each other's
+// cache lines.
+const int kElementsPerBatch = 16;
+
+// Below this many elements, waking up the threads costs more than matching
+// the selectors on the main thread.
+const size_t kMinElementsForParallelMatching = 64;
+
+Vector<OwnPtr<WebThread>>& matchingThreads()
+{
+    DEFINE_STATIC_LOCAL(Vector<OwnPtr<WebThread>>, threads, ());
+    if (threads.isEmpty()) {
+        for (size_t i = 0; i < ParallelSelectorMatcher::numberOfMatchingThreads(); ++i)
+            threads.append(adoptPtr(Platform::current()->createThread("Blink style matching thread")));
+    }
+    return threads;
+}
+
+} // namespace
+
+ParallelSelectorMatcher::ParallelSelectorMatcher()
+    : m_nextElement(0)
+    , m_runningMatchingThreads(0)
+{
+}
+
+ParallelSelectorMatcher::~ParallelSelectorMatcher()
+{
+    ASSERT(!m_runningMatchingThreads);
+}
+
+size_t ParallelSelectorMatcher::numberOfMatchingThreads()
+{
+    size_t processors = Platform::current()->numberOfProcessors();
+    if (processors <= 1)
+        return 0;
+    return std::min(processors - 1, kMaxMatchingThreads);
+}
+
+void ParallelSelectorMatcher::addRuleSet(RuleSet* ruleSet, const ContainerNode* scope)
+{
+    // The matching threads only read the rule set.
+    ruleSet->compactRulesIfNeeded();
+    m_ruleSets.append(ruleSet);
+    m_scopes.append(scope);
+}
+
+void ParallelSelectorMatcher::addElement(Element& element)
+{
+    // The tag name rules for the element are looked up by its local name,
+    // which must not need lower casing.
+    ASSERT(element.isHTMLElement() || !element.document().isHTMLDocument());
+    m_elementIndices.add(&element, m_elements.size());
+    m_elements.append(&element);
+}
+
+bool ParallelSelectorMatcher::hasEnoughElements() const
+{
+    return m_elements.size() >= kMinElementsForParallelMatching;
+}
+
+void ParallelSelectorMatcher::match()
+{
+    ASSERT(isMainThread());
+    TRACE_EVENT1("blink,blink_style", "ParallelSelectorMatcher::match", "elements", static_cast<int>(m_elements.size()));
+
+    m_matchedRules.resize(m_elements.size());
+    m_nextElement = 0;
+
+    Vector<OwnPtr<WebThread>>& threads = matchingThreads();
+    {
+        MutexLocker locker(m_mutex);
+        m_runningMatchingThreads = threads.size();
+    }
+    for (auto& thread : threads)
+        thread->getWebTaskRunner()->postTask(BLINK_FROM_HERE, threadSafeBind(&ParallelSelectorMatcher::matchingThreadMain, wrapCrossThreadPersistent(this)));
+
+    matchElements();
+
+    // Threads that started late may still be about to find out that all
+    // elements are taken. Wait for them to let go of |this|.
+    MutexLocker locker(m_mutex);
+    while (m_runningMatchingThreads)
+        m_matchingThreadsDone.wait(m_mutex);
+}
+
+void ParallelSelectorMatcher::matchingThreadMain()
+{
+    matchElements();
+
+    MutexLocker locker(m_mutex);
+    if (!--m_runningMatchingThreads)
+        m_matchingThreadsDone.signal();
+}
+
+void ParallelSelectorMatcher::matchElements()
+{
+    int size = m_elements.size();
+    for (;;) {
+        int end = atomicAdd(&m_nextElement, kElementsPerBatch);
+        int begin = end - kElementsPerBatch;
+        if (begin >= size)
+            return;
+        for (int i = begin; i < std::min(end, size); ++i)
+            matchElement(*m_elements[i], m_matchedRules[i]);
+    }
+}
+
+void ParallelSelectorMatcher::matchElement(Element& element, Vector<const RuleData*>& matchedRules) const
+{
+    // The same rule lists as ElementRuleCollector::collectMatchingRules()
+    // looks up by id, class and tag name, and the universal rules.
+    for (size_t i = 0; i < m_ruleSets.size(); ++i) {
+        const RuleSet* ruleSet = m_ruleSets[i];
+        const ContainerNode* scope = m_scopes[i];
+        if (element.hasID())
+            matchRules(element, ruleSet->idRules(element.idForStyleResolution()), scope, matchedRules);
+        if (element.isStyledElement() && element.hasClass()) {
+            for (size_t j = 0; j < element.classNames().size(); ++j)
+                matchRules(element, ruleSet->classRules(element.classNames()[j]), scope, matchedRules);
+        }
+        matchRules(element, ruleSet->tagRules(element.localName()), scope, matchedRules);
+        matchRules(element, ruleSet->universalRules(), scope, matchedRules);
+    }
+    std::sort(matchedRules.begin(), matchedRules.end());
+}
+
+template<typename RuleDataListType>
+void ParallelSelectorMatcher::matchRules(Element& element, const RuleDataListType* rules, const ContainerNode* scope, Vector<const RuleData*>& matchedRules) const
+{
+    if (!rules)
+        return;
+
+    SelectorChecker::Init init;
+    SelectorChecker checker(init);
+    SelectorChecker::SelectorCheckingContext context(&element, SelectorChecker::VisitedMatchEnabled);
+    context.scope = scope;
+
+    for (const auto& ruleData : *rules) {
+        if (!ruleData.isMatchableOffMainThread())
+            continue;
+        context.selector = &ruleData.selector();
+        if (checker.match(context))
+            matchedRules.append(&ruleData);
+    }
+}
+
+const Vector<const RuleData*>* ParallelSelectorMatcher::matchedRules(const Element& element, const RuleSet* ruleSet, const ContainerNode* scope) const
+{
+    bool matchedRuleSet = false;
+    for (size_t i = 0; i < m_ruleSets.size() && !matchedRuleSet; ++i)
+        matchedRuleSet = m_ruleSets[i].get() == ruleSet && m_scopes[i].get() == scope;
+    if (!matchedRuleSet)
+        return nullptr;
+
+    auto it = m_elementIndices.find(&element);
+    if (it == m_elementIndices.end())
+        return nullptr;
+    return &m_matchedRules[it->value];
+}
+
+DEFINE_TRACE(ParallelSelectorMatcher)
+{
+    visitor->trace(m_ruleSets);
+    visitor->trace(m_scopes);
+    visitor->trace(m_elements);
+    visitor->trace(m_elementIndices);
+}
+
+} // namespace blink
@@ -0,0 +1,95 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ParallelSelectorMatcher_h
+#define ParallelSelectorMatcher_h
+
+#include "core/CoreExport.h"
+#include "platform/heap/Handle.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/ThreadingPrimitives.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class ContainerNode;
+class Element;
+class RuleData;
+class RuleSet;
+
+// Matches selectors against the elements of a document that are about to have
+// their style recalculated, on worker threads, ahead of the recalc.
+//
+// Most of style resolution cannot leave the main thread: it allocates on the
+// Oilpan heap, creates AtomicStrings and ref counts ComputedStyles, and
+// matching many kinds of selectors records state on the element or its
+// style. What can be done elsewhere is matching the selectors built only from
+// type, class and id selectors and descendant and child combinators (see
+// RuleData::isMatchableOffMainThread()), which only read the DOM. These are
+// matched in parallel for the rule lists that ElementRuleCollector looks up
+// by id, class and tag name and the universal rules, and the collector then
+// looks the results up instead of running the SelectorChecker itself. The
+// cascade and everything else stays on the main thread, which is blocked
+// while the worker threads match, so the DOM and the rule sets stay as they
+// are.
+class CORE_EXPORT ParallelSelectorMatcher final : public GarbageCollectedFinalized<ParallelSelectorMatcher> {
+    WTF_MAKE_NONCOPYABLE(ParallelSelectorMatcher);
+public:
+    static ParallelSelectorMatcher* create()
+    {
+        return new ParallelSelectorMatcher;
+    }
+
+    ~ParallelSelectorMatcher();
+
+    // The number of worker threads matching alongside the main thread, zero
+    // if matching in parallel is not worth it on this machine.
+    static size_t numberOfMatchingThreads();
+
+    // Rules from |ruleSet| are matched as if by a MatchRequest with |scope|.
+    void addRuleSet(RuleSet*, const ContainerNode* scope);
+    void addElement(Element&);
+    // Whether there are enough elements to make up for waking up the worker
+    // threads.
+    bool hasEnoughElements() const;
+
+    // Matches the rule sets against the elements. Returns once done.
+    void match();
+
+    // The rules of |ruleSet| that are matchable off the main thread and match
+    // |element|, sorted by address, or null if |ruleSet| was not matched
+    // against |element| with |scope|.
+    const Vector<const RuleData*>* matchedRules(const Element&, const RuleSet*, const ContainerNode* scope) const;
+
+    DECLARE_TRACE();
+
+private:
+    ParallelSelectorMatcher();
+
+    void matchingThreadMain();
+    void matchElements();
+    void matchElement(Element&, Vector<const RuleData*>& matchedRules) const;
+    template<typename RuleDataListType>
+    void matchRules(Element&, const RuleDataListType*, const ContainerNode* scope, Vector<const RuleData*>& matchedRules) const;
+
+    // The rule sets to match and their scopes.
+    HeapVector<Member<RuleSet>> m_ruleSets;
+    HeapVector<Member<const ContainerNode>> m_scopes;
+
+    HeapVector<Member<Element>> m_elements;
+    HeapHashMap<Member<const Element>, unsigned> m_elementIndices;
+    // Indexed like |m_elements|.
+    Vector<Vector<const RuleData*>> m_matchedRules;
+
+    // The first element no thread has started matching yet.
+    int m_nextElement;
+
+    Mutex m_mutex;
+    ThreadCondition m_matchingThreadsDone;
+    size_t m_runningMatchingThreads;
+};
+
+} // namespace blink
+
+#endif // ParallelSelectorMatcher_h
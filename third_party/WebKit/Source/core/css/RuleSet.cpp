@@ -32,6 +32,7 @@
 #include "core/css/CSSFontSelector.h"
 #include "core/css/CSSSelector.h"
 #include "core/css/CSSSelectorList.h"
+#include "core/css/SelectorChecker.h"
 #include "core/css/SelectorFilter.h"
 #include "core/css/StyleRuleImport.h"
 #include "core/css/StyleSheetContents.h"
@@ -42,6 +43,7 @@
 #include "platform/weborigin/SecurityOrigin.h"
 
 #include "wtf/TerminatedArrayBuilder.h"
+#include <algorithm>
 
 namespace blink {
 
@@ -95,6 +97,56 @@ static bool containsUncommonAttributeSelector(const CSSSelector& selector)
     return false;
 }
 
+// Type, class and id selectors combined with descendant and child combinators
+// are matched without touching anything but the DOM, which other threads can
+// read while the main thread waits for them.
+static bool isMatchableOffMainThread(const CSSSelector& selector)
+{
+    for (const CSSSelector* component = &selector; component; component = component->tagHistory()) {
+        switch (component->match()) {
+        case CSSSelector::Tag:
+            // Type selectors are compared with the upper case names of
+            // non-HTML elements in HTML documents, which are created lazily.
+            component->tagQName().localNameUpper();
+            break;
+        case CSSSelector::Class:
+        case CSSSelector::Id:
+            break;
+        default:
+            return false;
+        }
+        if (component->relationIsAffectedByPseudoContent())
+            return false;
+        if (component->isLastInTagHistory())
+            break;
+        switch (component->relation()) {
+        case CSSSelector::SubSelector:
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// Class and attribute selectors in the rightmost compound are matched against
+// the element itself, so it has to have all of them.
+static unsigned computeFastRejectMask(const CSSSelector& selector)
+{
+    unsigned mask = 0;
+    for (const CSSSelector* component = &selector; component; component = component->tagHistory()) {
+        if (component->match() == CSSSelector::Class)
+            mask |= RuleData::fastRejectBit(component->value());
+        else if (component->isAttributeSelector())
+            mask |= RuleData::fastRejectBit(component->attribute().localName());
+        if (component->relation() != CSSSelector::SubSelector)
+            break;
+    }
+    return mask;
+}
+
 static inline PropertyWhitelistType determinePropertyWhitelistType(const AddRuleFlags addRuleFlags, const CSSSelector& selector)
 {
     for (const CSSSelector* component = &selector; component; component = component->tagHistory()) {
@@ -116,10 +168,22 @@ RuleData::RuleData(StyleRule* rule, unsigned selectorIndex, unsigned position, A
     , m_linkMatchType(selector().computeLinkMatchType())
     , m_hasDocumentSecurityOrigin(addRuleFlags & RuleHasDocumentSecurityOrigin)
     , m_propertyWhitelist(determinePropertyWhitelistType(addRuleFlags, selector()))
+    , m_isMatchableOffMainThread(blink::isMatchableOffMainThread(selector()))
+    , m_fastRejectMask(computeFastRejectMask(selector()))
 {
     SelectorFilter::collectIdentifierHashes(selector(), m_descendantSelectorIdentifierHashes, maximumIdentifierCount);
 }
 
+const CSSSelector::PseudoType RuleSet::statePseudoClasses[RuleSet::statePseudoClassCount] = {
+    CSSSelector::PseudoChecked,
+    CSSSelector::PseudoDefault,
+    CSSSelector::PseudoDisabled,
+    CSSSelector::PseudoEnabled,
+    CSSSelector::PseudoIndeterminate,
+    CSSSelector::PseudoOptional,
+    CSSSelector::PseudoRequired,
+};
+
 void RuleSet::addToRuleSet(const AtomicString& key, PendingRuleMap& map, const RuleData& ruleData)
 {
     Member<HeapLinkedStack<RuleData>>& rules = map.add(key, nullptr).storedValue->value;
@@ -128,8 +192,13 @@ void RuleSet::addToRuleSet(const AtomicString& key, PendingRuleMap& map, const R
     rules->push(ruleData);
 }
 
-static void extractValuesforSelector(const CSSSelector* selector, AtomicString& id, AtomicString& className, AtomicString& customPseudoElementName, AtomicString& tagName)
+static void extractValuesforSelector(const CSSSelector* selector, AtomicString& id, AtomicString& className, AtomicString& customPseudoElementName, AtomicString& tagName, AtomicString& attributeName, bool& hasPseudoElement)
 {
+    if (selector->isAttributeSelector()) {
+        if (attributeName.isEmpty())
+            attributeName = selector->attribute().localName();
+        return;
+    }
     switch (selector->match()) {
     case CSSSelector::Id:
         id = selector->value();
@@ -141,6 +210,9 @@ static void extractValuesforSelector(const CSSSelector* selector, AtomicString&
         if (selector->tagQName().localName() != starAtom)
             tagName = selector->tagQName().localName();
         break;
+    case CSSSelector::PseudoElement:
+        hasPseudoElement = true;
+        break;
     default:
         break;
     }
@@ -154,6 +226,8 @@ bool RuleSet::findBestRuleSetAndAdd(const CSSSelector& component, RuleData& rule
     AtomicString className;
     AtomicString customPseudoElementName;
     AtomicString tagName;
+    AtomicString attributeName;
+    bool hasPseudoElement = false;
 
 #ifndef NDEBUG
     m_allRules.append(ruleData);
@@ -161,9 +235,9 @@ bool RuleSet::findBestRuleSetAndAdd(const CSSSelector& component, RuleData& rule
 
     const CSSSelector* it = &component;
     for (; it && it->relation() == CSSSelector::SubSelector; it = it->tagHistory())
-        extractValuesforSelector(it, id, className, customPseudoElementName, tagName);
+        extractValuesforSelector(it, id, className, customPseudoElementName, tagName, attributeName, hasPseudoElement);
     if (it)
-        extractValuesforSelector(it, id, className, customPseudoElementName, tagName);
+        extractValuesforSelector(it, id, className, customPseudoElementName, tagName, attributeName, hasPseudoElement);
 
     // Prefer rule sets in order of most likely to apply infrequently.
     if (!id.isEmpty()) {
@@ -196,6 +270,13 @@ bool RuleSet::findBestRuleSetAndAdd(const CSSSelector& component, RuleData& rule
         m_focusPseudoClassRules.append(ruleData);
         return true;
     default:
+        // Scrollbar pseudo elements match the state pseudo-classes against
+        // the scrollbar rather than the element.
+        if (SelectorChecker::isStatePseudoClass(component.getPseudoType()) && !hasPseudoElement) {
+            size_t index = std::find(statePseudoClasses, statePseudoClasses + statePseudoClassCount, component.getPseudoType()) - statePseudoClasses;
+            m_statePseudoClassRules[index].append(ruleData);
+            return true;
+        }
         break;
     }
 
@@ -209,6 +290,11 @@ bool RuleSet::findBestRuleSetAndAdd(const CSSSelector& component, RuleData& rule
         return true;
     }
 
+    if (!attributeName.isEmpty()) {
+        addToRuleSet(attributeName, ensurePendingRules()->attributeRules, ruleData);
+        return true;
+    }
+
     return false;
 }
 
@@ -333,9 +419,12 @@ void RuleSet::compactRules()
     compactPendingRules(pendingRules->classRules, m_classRules);
     compactPendingRules(pendingRules->tagRules, m_tagRules);
     compactPendingRules(pendingRules->shadowPseudoElementRules, m_shadowPseudoElementRules);
+    compactPendingRules(pendingRules->attributeRules, m_attributeRules);
     m_linkPseudoClassRules.shrinkToFit();
     m_cuePseudoRules.shrinkToFit();
     m_focusPseudoClassRules.shrinkToFit();
+    for (auto& rules : m_statePseudoClassRules)
+        rules.shrinkToFit();
     m_universalRules.shrinkToFit();
     m_shadowHostRules.shrinkToFit();
     m_pageRules.shrinkToFit();
@@ -363,6 +452,7 @@ DEFINE_TRACE(RuleSet::PendingRuleMaps)
     visitor->trace(classRules);
     visitor->trace(tagRules);
     visitor->trace(shadowPseudoElementRules);
+    visitor->trace(attributeRules);
 }
 
 DEFINE_TRACE(RuleSet)
@@ -371,9 +461,12 @@ DEFINE_TRACE(RuleSet)
     visitor->trace(m_classRules);
     visitor->trace(m_tagRules);
     visitor->trace(m_shadowPseudoElementRules);
+    visitor->trace(m_attributeRules);
     visitor->trace(m_linkPseudoClassRules);
     visitor->trace(m_cuePseudoRules);
     visitor->trace(m_focusPseudoClassRules);
+    for (auto& rules : m_statePseudoClassRules)
+        visitor->trace(rules);
     visitor->trace(m_universalRules);
     visitor->trace(m_shadowHostRules);
     visitor->trace(m_features);
@@ -89,6 +89,8 @@ public:
     void setLastInArray(bool flag) { m_isLastInArray = flag; }
 
     bool containsUncommonAttributeSelector() const { return m_containsUncommonAttributeSelector; }
+    // Whether the selector can be matched on another thread; see ParallelSelectorMatcher.
+    bool isMatchableOffMainThread() const { return m_isMatchableOffMainThread; }
     unsigned specificity() const { return m_specificity; }
     unsigned linkMatchType() const { return m_linkMatchType; }
     bool hasDocumentSecurityOrigin() const { return m_hasDocumentSecurityOrigin; }
@@ -97,6 +99,13 @@ public:
     static const unsigned maximumIdentifierCount = 4;
     const unsigned* descendantSelectorIdentifierHashes() const { return m_descendantSelectorIdentifierHashes; }
 
+    // A bit for each class and attribute name the rightmost compound selector
+    // requires the element to have, see fastRejectBit(). The rule cannot
+    // match an element lacking one of these bits, which is much cheaper to
+    // check than running the SelectorChecker.
+    unsigned fastRejectMask() const { return m_fastRejectMask; }
+    static unsigned fastRejectBit(const AtomicString& name) { return 1u << (name.impl()->existingHash() % 32); }
+
     DECLARE_TRACE();
 
 private:
@@ -111,8 +120,10 @@ private:
     unsigned m_linkMatchType : 2; //  CSSSelector::LinkMatchMask
     unsigned m_hasDocumentSecurityOrigin : 1;
     unsigned m_propertyWhitelist : 2;
+    unsigned m_isMatchableOffMainThread : 1;
     // Use plain array instead of a Vector to minimize memory overhead.
     unsigned m_descendantSelectorIdentifierHashes[maximumIdentifierCount];
+    unsigned m_fastRejectMask;
 };
 
 } // namespace blink
@@ -127,6 +138,7 @@ struct SameSizeAsRuleData {
     unsigned b;
     unsigned c;
     unsigned d[4];
+    unsigned e;
 };
 
 static_assert(sizeof(RuleData) == sizeof(SameSizeAsRuleData), "RuleData should stay small");
@@ -146,9 +158,18 @@ public:
     const HeapTerminatedArray<RuleData>* classRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_classRules.get(key); }
     const HeapTerminatedArray<RuleData>* tagRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_tagRules.get(key); }
     const HeapTerminatedArray<RuleData>* shadowPseudoElementRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_shadowPseudoElementRules.get(key); }
+    // Rules that have nothing better to be bucketed on than the local name of
+    // an attribute in their rightmost compound selector.
+    const HeapTerminatedArray<RuleData>* attributeRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_attributeRules.get(key); }
     const HeapVector<RuleData>* linkPseudoClassRules() const { ASSERT(!m_pendingRules); return &m_linkPseudoClassRules; }
     const HeapVector<RuleData>* cuePseudoRules() const { ASSERT(!m_pendingRules); return &m_cuePseudoRules; }
     const HeapVector<RuleData>* focusPseudoClassRules() const { ASSERT(!m_pendingRules); return &m_focusPseudoClassRules; }
+    // Rules whose rightmost compound selector starts with the state
+    // pseudo-class statePseudoClasses[index], see
+    // SelectorChecker::isStatePseudoClass().
+    static const size_t statePseudoClassCount = 7;
+    static const CSSSelector::PseudoType statePseudoClasses[statePseudoClassCount];
+    const HeapVector<RuleData>* statePseudoClassRules(size_t index) const { ASSERT(!m_pendingRules); return &m_statePseudoClassRules[index]; }
     const HeapVector<RuleData>* universalRules() const { ASSERT(!m_pendingRules); return &m_universalRules; }
     const HeapVector<RuleData>* shadowHostRules() const { ASSERT(!m_pendingRules); return &m_shadowHostRules; }
     const HeapVector<Member<StyleRulePage>>& pageRules() const { ASSERT(!m_pendingRules); return m_pageRules; }
@@ -205,6 +226,7 @@ private:
         PendingRuleMap classRules;
         PendingRuleMap tagRules;
         PendingRuleMap shadowPseudoElementRules;
+        PendingRuleMap attributeRules;
 
         DECLARE_TRACE();
 
@@ -223,9 +245,11 @@ private:
     CompactRuleMap m_classRules;
     CompactRuleMap m_tagRules;
     CompactRuleMap m_shadowPseudoElementRules;
+    CompactRuleMap m_attributeRules;
     HeapVector<RuleData> m_linkPseudoClassRules;
     HeapVector<RuleData> m_cuePseudoRules;
     HeapVector<RuleData> m_focusPseudoClassRules;
+    HeapVector<RuleData> m_statePseudoClassRules[statePseudoClassCount];
     HeapVector<RuleData> m_universalRules;
     HeapVector<RuleData> m_shadowHostRules;
     RuleFeatureSet m_features;
@@ -209,4 +209,69 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostContextAndClass)
     ASSERT_EQ(0u, rules->size());
 }
 
+TEST(RuleSetTest, findBestRuleSetAndAdd_Attr)
+{
+    CSSTestHelper helper;
+
+    helper.addCSSRules("[attr=value] { }");
+    RuleSet& ruleSet = helper.ruleSet();
+    AtomicString str("attr");
+    const TerminatedArray<RuleData>* rules = ruleSet.attributeRules(str);
+    ASSERT_EQ(1u, rules->size());
+    ASSERT_EQ(str, rules->at(0).selector().attribute().localName());
+    ASSERT_EQ(0u, ruleSet.universalRules()->size());
+}
+
+TEST(RuleSetTest, findBestRuleSetAndAdd_TagThenAttr)
+{
+    CSSTestHelper helper;
+
+    helper.addCSSRules("div[attr] { }");
+    RuleSet& ruleSet = helper.ruleSet();
+    // The tag name is prefered over the attribute.
+    ASSERT_EQ(1u, ruleSet.tagRules(AtomicString("div"))->size());
+    ASSERT_FALSE(ruleSet.attributeRules(AtomicString("attr")));
+}
+
+TEST(RuleSetTest, findBestRuleSetAndAdd_StatePseudoClass)
+{
+    CSSTestHelper helper;
+
+    helper.addCSSRules(":checked { }");
+    RuleSet& ruleSet = helper.ruleSet();
+    ASSERT_EQ(CSSSelector::PseudoChecked, RuleSet::statePseudoClasses[0]);
+    const HeapVector<RuleData>* rules = ruleSet.statePseudoClassRules(0);
+    ASSERT_EQ(1u, rules->size());
+    ASSERT_EQ(CSSSelector::PseudoChecked, rules->at(0).selector().getPseudoType());
+    ASSERT_EQ(0u, ruleSet.universalRules()->size());
+}
+
+TEST(RuleSetTest, findBestRuleSetAndAdd_StatePseudoClassOfScrollbar)
+{
+    CSSTestHelper helper;
+
+    helper.addCSSRules("::-webkit-scrollbar-button:disabled { }");
+    RuleSet& ruleSet = helper.ruleSet();
+    for (size_t i = 0; i < RuleSet::statePseudoClassCount; ++i)
+        ASSERT_EQ(0u, ruleSet.statePseudoClassRules(i)->size());
+    ASSERT_EQ(1u, ruleSet.universalRules()->size());
+}
+
+TEST(RuleSetTest, FastRejectMask)
+{
+    CSSTestHelper helper;
+
+    helper.addCSSRules(".a.b[c] { }");
+    helper.addCSSRules(".d .e { }");
+    RuleSet& ruleSet = helper.ruleSet();
+    const TerminatedArray<RuleData>* rules = ruleSet.classRules(AtomicString("b"));
+    ASSERT_EQ(1u, rules->size());
+    unsigned expectedMask = RuleData::fastRejectBit(AtomicString("a")) | RuleData::fastRejectBit(AtomicString("b")) | RuleData::fastRejectBit(AtomicString("c"));
+    ASSERT_EQ(expectedMask, rules->at(0).fastRejectMask());
+    // Only the rightmost compound is required of the element.
+    rules = ruleSet.classRules(AtomicString("e"));
+    ASSERT_EQ(1u, rules->size());
+    ASSERT_EQ(RuleData::fastRejectBit(AtomicString("e")), rules->at(0).fastRejectMask());
+}
+
 } // namespace blink
@@ -811,22 +811,20 @@ bool SelectorChecker::checkPseudoClass(const SelectorCheckingContext& context, M
         if (InspectorInstrumentation::forcePseudoState(&element, CSSSelector::PseudoActive))
             return true;
         return element.active();
+    case CSSSelector::PseudoChecked:
+    case CSSSelector::PseudoDefault:
+    case CSSSelector::PseudoDisabled:
     case CSSSelector::PseudoEnabled:
-        return element.matchesEnabledPseudoClass();
+    case CSSSelector::PseudoIndeterminate:
+    case CSSSelector::PseudoOptional:
+    case CSSSelector::PseudoRequired:
+        return matchesStatePseudoClass(element, selector.getPseudoType());
     case CSSSelector::PseudoFullPageMedia:
         return element.document().isMediaDocument();
-    case CSSSelector::PseudoDefault:
-        return element.matchesDefaultPseudoClass();
-    case CSSSelector::PseudoDisabled:
-        return element.isDisabledFormControl();
     case CSSSelector::PseudoReadOnly:
         return element.matchesReadOnlyPseudoClass();
     case CSSSelector::PseudoReadWrite:
         return element.matchesReadWritePseudoClass();
-    case CSSSelector::PseudoOptional:
-        return element.isOptionalFormControl();
-    case CSSSelector::PseudoRequired:
-        return element.isRequiredFormControl();
     case CSSSelector::PseudoValid:
         if (m_mode == ResolvingStyle)
             element.document().setContainsValidityStyleRules();
@@ -835,24 +833,6 @@ bool SelectorChecker::checkPseudoClass(const SelectorCheckingContext& context, M
         if (m_mode == ResolvingStyle)
             element.document().setContainsValidityStyleRules();
         return element.matchesValidityPseudoClasses() && !element.isValidElement();
-    case CSSSelector::PseudoChecked:
-        {
-            if (isHTMLInputElement(element)) {
-                HTMLInputElement& inputElement = toHTMLInputElement(element);
-                // Even though WinIE allows checked and indeterminate to
-                // co-exist, the CSS selector spec says that you can't be
-                // both checked and indeterminate. We will behave like WinIE
-                // behind the scenes and just obey the CSS spec here in the
-                // test for matching the pseudo.
-                if (inputElement.shouldAppearChecked() && !inputElement.shouldAppearIndeterminate())
-                    return true;
-            } else if (isHTMLOptionElement(element) && toHTMLOptionElement(element).selected()) {
-                return true;
-            }
-            break;
-        }
-    case CSSSelector::PseudoIndeterminate:
-        return element.shouldAppearIndeterminate();
     case CSSSelector::PseudoRoot:
         return element == element.document().documentElement();
     case CSSSelector::PseudoLang:
@@ -1149,4 +1129,52 @@ bool SelectorChecker::matchesFocusPseudoClass(const Element& element)
     return element.focused() && isFrameFocused(element);
 }
 
+bool SelectorChecker::isStatePseudoClass(CSSSelector::PseudoType pseudoType)
+{
+    switch (pseudoType) {
+    case CSSSelector::PseudoChecked:
+    case CSSSelector::PseudoDefault:
+    case CSSSelector::PseudoDisabled:
+    case CSSSelector::PseudoEnabled:
+    case CSSSelector::PseudoIndeterminate:
+    case CSSSelector::PseudoOptional:
+    case CSSSelector::PseudoRequired:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool SelectorChecker::matchesStatePseudoClass(const Element& element, CSSSelector::PseudoType pseudoType)
+{
+    switch (pseudoType) {
+    case CSSSelector::PseudoChecked:
+        if (isHTMLInputElement(element)) {
+            const HTMLInputElement& inputElement = toHTMLInputElement(element);
+            // Even though WinIE allows checked and indeterminate to
+            // co-exist, the CSS selector spec says that you can't be
+            // both checked and indeterminate. We will behave like WinIE
+            // behind the scenes and just obey the CSS spec here in the
+            // test for matching the pseudo.
+            return inputElement.shouldAppearChecked() && !inputElement.shouldAppearIndeterminate();
+        }
+        return isHTMLOptionElement(element) && toHTMLOptionElement(element).selected();
+    case CSSSelector::PseudoDefault:
+        return element.matchesDefaultPseudoClass();
+    case CSSSelector::PseudoDisabled:
+        return element.isDisabledFormControl();
+    case CSSSelector::PseudoEnabled:
+        return element.matchesEnabledPseudoClass();
+    case CSSSelector::PseudoIndeterminate:
+        return element.shouldAppearIndeterminate();
+    case CSSSelector::PseudoOptional:
+        return element.isOptionalFormControl();
+    case CSSSelector::PseudoRequired:
+        return element.isRequiredFormControl();
+    default:
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+}
+
 } // namespace blink
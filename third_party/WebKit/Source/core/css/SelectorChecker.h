@@ -123,6 +123,11 @@ public:
     }
 
     static bool matchesFocusPseudoClass(const Element&);
+    // The pseudo-classes for form control states, which only depend on the
+    // element and have no side effects on it or its style when matched. See
+    // RuleSet::statePseudoClassRules().
+    static bool isStatePseudoClass(CSSSelector::PseudoType);
+    static bool matchesStatePseudoClass(const Element&, CSSSelector::PseudoType);
 
 private:
     bool checkOne(const SelectorCheckingContext&, MatchResult&) const;
@@ -28,12 +28,25 @@
 
 #include "core/css/resolver/MatchedPropertiesCache.h"
 
+#include "core/css/CSSStyleSheet.h"
 #include "core/css/StylePropertySet.h"
+#include "core/css/StyleSheetContents.h"
 #include "core/css/resolver/StyleResolverState.h"
+#include "core/dom/Document.h"
 #include "core/style/ComputedStyle.h"
+#include "wtf/StdLibExtras.h"
+#include "wtf/text/StringHasher.h"
 
 namespace blink {
 
+namespace {
+
+// The documents of a renderer rarely use more different sets of style sheets
+// than this at a time.
+const unsigned kMaxSharedMatchedPropertiesCaches = 8;
+
+} // namespace
+
 void CachedMatchedProperties::set(const ComputedStyle& style, const ComputedStyle& parentStyle, const MatchedPropertiesVector& properties)
 {
     matchedProperties.appendVector(properties);
@@ -51,6 +64,20 @@ void CachedMatchedProperties::clear()
     parentComputedStyle = nullptr;
 }
 
+bool CachedMatchedProperties::matches(const StyleResolverState& styleResolverState, const MatchedPropertiesVector& properties) const
+{
+    size_t size = properties.size();
+    if (size != matchedProperties.size())
+        return false;
+    if (computedStyle->insideLink() != styleResolverState.style()->insideLink())
+        return false;
+    for (size_t i = 0; i < size; ++i) {
+        if (properties[i] != matchedProperties[i])
+            return false;
+    }
+    return true;
+}
+
 MatchedPropertiesCache::MatchedPropertiesCache()
 {
 }
@@ -64,16 +91,8 @@ const CachedMatchedProperties* MatchedPropertiesCache::find(unsigned hash, const
         return nullptr;
     CachedMatchedProperties* cacheItem = it->value.get();
     ASSERT(cacheItem);
-
-    size_t size = properties.size();
-    if (size != cacheItem->matchedProperties.size())
+    if (!cacheItem->matches(styleResolverState, properties))
         return nullptr;
-    if (cacheItem->computedStyle->insideLink() != styleResolverState.style()->insideLink())
-        return nullptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (properties[i] != cacheItem->matchedProperties[i])
-            return nullptr;
-    }
     return cacheItem;
 }
 
@@ -134,4 +153,93 @@ DEFINE_TRACE(MatchedPropertiesCache)
     visitor->trace(m_cache);
 }
 
+SharedMatchedPropertiesCache* SharedMatchedPropertiesCache::forStyleSheets(const HeapVector<Member<CSSStyleSheet>>& authorStyleSheets, const Document& document)
+{
+    using SharedCaches = HeapHashMap<unsigned, Member<SharedMatchedPropertiesCache>>;
+    DEFINE_STATIC_LOCAL(SharedCaches, sharedCaches, (new SharedCaches));
+
+    // Documents whose style sheets hash alike share a cache. That is only
+    // less effective, as the entries are keyed on the property sets.
+    Vector<const StyleSheetContents*, 16> contents;
+    for (const auto& styleSheet : authorStyleSheets)
+        contents.append(styleSheet->contents());
+    unsigned hash = WTF::hashInts(StringHasher::hashMemory(contents.data(), contents.size() * sizeof(contents[0])), bitwise_cast<unsigned>(document.devicePixelRatio()));
+
+    SharedCaches::AddResult addResult = sharedCaches.add(hash, nullptr);
+    if (!addResult.isNewEntry)
+        return addResult.storedValue->value;
+
+    if (sharedCaches.size() > kMaxSharedMatchedPropertiesCaches) {
+        // Start over instead of keeping track of which documents still use
+        // which cache. The documents keep using the caches they have.
+        for (auto& cache : sharedCaches.values()) {
+            if (cache)
+                cache->clear();
+        }
+        sharedCaches.clear();
+        addResult = sharedCaches.add(hash, nullptr);
+    }
+    addResult.storedValue->value = new SharedMatchedPropertiesCache;
+    return addResult.storedValue->value;
+}
+
+const CachedMatchedProperties* SharedMatchedPropertiesCache::find(unsigned hash, const StyleResolverState& styleResolverState, const MatchedPropertiesVector& properties)
+{
+    ASSERT(hash);
+
+    Cache::iterator it = m_cache.find(hash);
+    if (it == m_cache.end())
+        return nullptr;
+    CachedMatchedProperties* cacheItem = it->value.get();
+    ASSERT(cacheItem);
+    if (!cacheItem->matches(styleResolverState, properties))
+        return nullptr;
+    return cacheItem;
+}
+
+void SharedMatchedPropertiesCache::add(const ComputedStyle& style, unsigned hash, const MatchedPropertiesVector& properties)
+{
+    ASSERT(hash);
+    ASSERT(isSharable(style));
+
+    // Only keep the inherited properties StyleResolver::applyMatchedProperties()
+    // compares with the style it resolves to decide what to apply. The Font
+    // made from the description has no font selector.
+    RefPtr<ComputedStyle> sharedStyle = ComputedStyle::create();
+    sharedStyle->copyNonInheritedFromCached(style);
+    sharedStyle->setFontDescription(style.getFontDescription());
+    sharedStyle->setEffectiveZoom(style.effectiveZoom());
+    sharedStyle->setInsideLink(style.insideLink());
+
+    Cache::AddResult addResult = m_cache.add(hash, nullptr);
+    if (addResult.isNewEntry)
+        addResult.storedValue->value = new CachedMatchedProperties;
+
+    CachedMatchedProperties* cacheItem = addResult.storedValue->value.get();
+    if (!addResult.isNewEntry)
+        cacheItem->clear();
+
+    // The parent style is never compared with, see StyleResolver::applyMatchedProperties().
+    cacheItem->set(*sharedStyle, *sharedStyle, properties);
+}
+
+void SharedMatchedPropertiesCache::clear()
+{
+    for (auto& cacheEntry : m_cache)
+        cacheEntry.value->clear();
+    m_cache.clear();
+}
+
+bool SharedMatchedPropertiesCache::isSharable(const ComputedStyle& style)
+{
+    // The lengths in these units depend on the document's viewport and root
+    // element.
+    return !style.hasViewportUnits() && !style.hasRemUnits();
+}
+
+DEFINE_TRACE(SharedMatchedPropertiesCache)
+{
+    visitor->trace(m_cache);
+}
+
 } // namespace blink
@@ -32,7 +32,9 @@
 
 namespace blink {
 
+class CSSStyleSheet;
 class ComputedStyle;
+class Document;
 class StyleResolverState;
 
 class CachedMatchedProperties final : public GarbageCollectedFinalized<CachedMatchedProperties> {
@@ -43,6 +45,7 @@ public:
 
     void set(const ComputedStyle&, const ComputedStyle& parentStyle, const MatchedPropertiesVector&);
     void clear();
+    bool matches(const StyleResolverState&, const MatchedPropertiesVector&) const;
     DEFINE_INLINE_TRACE()
     {
         visitor->trace(matchedProperties);
@@ -108,6 +111,41 @@ private:
     Cache m_cache;
 };
 
+// Caches the non-inherited properties computed from matched properties for
+// all the documents in the renderer with the same author style sheets, so
+// that a document reloaded in an iframe does not start over with an empty
+// MatchedPropertiesCache. Documents loading the same style sheets share their
+// StyleSheetContents, and with them the StylePropertySets the entries are
+// keyed on, through the memory cache.
+//
+// Only what does not depend on the document is shared. The entries are used
+// like MatchedPropertiesCache entries whose parent style does not match, so
+// the inherited properties, and with them the Font referring to the
+// document's font selector, are always applied again. Styles with viewport or
+// rem units are not shared.
+class SharedMatchedPropertiesCache final : public GarbageCollected<SharedMatchedPropertiesCache> {
+    WTF_MAKE_NONCOPYABLE(SharedMatchedPropertiesCache);
+public:
+    // The cache for documents with |authorStyleSheets| in their document
+    // scope and |document|'s device scale factor, which selects the images of
+    // image sets.
+    static SharedMatchedPropertiesCache* forStyleSheets(const HeapVector<Member<CSSStyleSheet>>& authorStyleSheets, const Document&);
+
+    const CachedMatchedProperties* find(unsigned hash, const StyleResolverState&, const MatchedPropertiesVector&);
+    void add(const ComputedStyle&, unsigned hash, const MatchedPropertiesVector&);
+    void clear();
+
+    static bool isSharable(const ComputedStyle&);
+
+    DECLARE_TRACE();
+
+private:
+    SharedMatchedPropertiesCache() { }
+
+    using Cache = HeapHashMap<unsigned, Member<CachedMatchedProperties>, DefaultHash<unsigned>::Hash, HashTraits<unsigned>, CachedMatchedPropertiesHashTraits>;
+    Cache m_cache;
+};
+
 } // namespace blink
 
 #endif
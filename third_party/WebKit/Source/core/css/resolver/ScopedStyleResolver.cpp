@@ -31,6 +31,7 @@
 #include "core/css/CSSStyleSheet.h"
 #include "core/css/FontFace.h"
 #include "core/css/PageRuleCollector.h"
+#include "core/css/ParallelSelectorMatcher.h"
 #include "core/css/RuleFeature.h"
 #include "core/css/StyleRule.h"
 #include "core/css/StyleSheetContents.h"
@@ -74,8 +75,10 @@ void ScopedStyleResolver::addFontFaceRules(const RuleSet& ruleSet)
         if (FontFace* fontFace = FontFace::create(&document, fontFaceRule))
             cssFontSelector->fontFaceCache()->add(cssFontSelector, fontFaceRule, fontFace);
     }
+    // The documents sharing matched properties with this one have the same
+    // font faces.
     if (fontFaceRules.size())
-        document.styleResolver()->invalidateMatchedPropertiesCache();
+        document.styleResolver()->invalidateDocumentMatchedPropertiesCache();
 }
 
 void ScopedStyleResolver::appendCSSStyleSheet(CSSStyleSheet& cssSheet, const MediaQueryEvaluator& medium)
@@ -189,6 +192,12 @@ void ScopedStyleResolver::collectViewportRulesTo(ViewportStyleResolver* resolver
         resolver->collectViewportRules(&m_authorStyleSheets[i]->contents()->ruleSet(), ViewportStyleResolver::AuthorOrigin);
 }
 
+void ScopedStyleResolver::collectRuleSetsTo(ParallelSelectorMatcher& matcher) const
+{
+    for (size_t i = 0; i < m_authorStyleSheets.size(); ++i)
+        matcher.addRuleSet(&m_authorStyleSheets[i]->contents()->ruleSet(), &m_scope->rootNode());
+}
+
 DEFINE_TRACE(ScopedStyleResolver)
 {
     visitor->trace(m_scope);
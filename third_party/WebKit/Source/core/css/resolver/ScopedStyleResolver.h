@@ -38,6 +38,7 @@
 namespace blink {
 
 class PageRuleCollector;
+class ParallelSelectorMatcher;
 class StyleSheetContents;
 class ViewportStyleResolver;
 
@@ -51,6 +52,7 @@ public:
     }
 
     const TreeScope& treeScope() const { return *m_scope; }
+    const HeapVector<Member<CSSStyleSheet>>& authorStyleSheets() const { return m_authorStyleSheets; }
     ScopedStyleResolver* parent() const;
 
     StyleRuleKeyframes* keyframeStylesForAnimation(const StringImpl* animationName);
@@ -63,6 +65,7 @@ public:
     void collectFeaturesTo(RuleFeatureSet&, HeapHashSet<Member<const StyleSheetContents>>& visitedSharedStyleSheetContents) const;
     void resetAuthorStyle();
     void collectViewportRulesTo(ViewportStyleResolver*) const;
+    void collectRuleSetsTo(ParallelSelectorMatcher&) const;
     bool hasDeepOrShadowSelector() const { return m_hasDeepOrShadowSelector; }
 
     DECLARE_TRACE();
@@ -56,6 +56,7 @@
 #include "core/css/FontFace.h"
 #include "core/css/MediaQueryEvaluator.h"
 #include "core/css/PageRuleCollector.h"
+#include "core/css/ParallelSelectorMatcher.h"
 #include "core/css/StylePropertySet.h"
 #include "core/css/StyleRuleImport.h"
 #include "core/css/StyleSheetContents.h"
@@ -71,6 +72,7 @@
 #include "core/css/resolver/StyleResolverStats.h"
 #include "core/css/resolver/ViewportStyleResolver.h"
 #include "core/dom/CSSSelectorWatch.h"
+#include "core/dom/ElementTraversal.h"
 #include "core/dom/FirstLetterPseudoElement.h"
 #include "core/dom/NodeComputedStyle.h"
 #include "core/dom/StyleEngine.h"
@@ -278,6 +280,8 @@ void StyleResolver::finishAppendAuthorStyleSheets()
     m_viewportStyleResolver->collectViewportRules();
 
     document().styleEngine().resetCSSFeatureFlags(m_features);
+
+    m_sharedMatchedPropertiesCache = nullptr;
 }
 
 void StyleResolver::resetRuleFeatures()
@@ -386,6 +390,70 @@ void StyleResolver::clearStyleSharingList()
     m_styleSharingLists.resize(0);
 }
 
+void StyleResolver::matchSelectorsInParallel(bool forceRecalc)
+{
+    ASSERT(!m_parallelSelectorMatcher);
+    if (hasPendingAuthorStyleSheets() || !ParallelSelectorMatcher::numberOfMatchingThreads())
+        return;
+    Element* documentElement = document().documentElement();
+    if (!documentElement)
+        return;
+
+    ParallelSelectorMatcher* matcher = ParallelSelectorMatcher::create();
+    collectElementsForParallelMatching(*matcher, *documentElement, forceRecalc);
+    if (!matcher->hasEnoughElements())
+        return;
+
+    // The rule sets of matchUARules(), and those of matchAuthorRules() for
+    // the elements in the document's tree scope.
+    CSSDefaultStyleSheets& defaultStyleSheets = CSSDefaultStyleSheets::instance();
+    matcher->addRuleSet(m_printMediaType ? defaultStyleSheets.defaultPrintStyle() : defaultStyleSheets.defaultStyle(), nullptr);
+    if (document().inQuirksMode())
+        matcher->addRuleSet(defaultStyleSheets.defaultQuirksStyle(), nullptr);
+    if (document().isViewSource())
+        matcher->addRuleSet(defaultStyleSheets.defaultViewSourceStyle(), nullptr);
+    if (ScopedStyleResolver* resolver = document().scopedStyleResolver())
+        resolver->collectRuleSetsTo(*matcher);
+
+    matcher->match();
+    m_parallelSelectorMatcher = matcher;
+}
+
+void StyleResolver::clearParallelSelectorMatches()
+{
+    m_parallelSelectorMatcher = nullptr;
+}
+
+void StyleResolver::collectElementsForParallelMatching(ParallelSelectorMatcher& matcher, Element& element, bool inChangedSubtree)
+{
+    // Non-HTML elements in HTML documents are matched by their upper case
+    // names, which are created lazily, so create them here for all elements
+    // that may be matched against. Their own tag name rules are looked up by
+    // a lower case name that is not kept around, so they are left to the main
+    // thread.
+    bool needsLowerCaseLocalName = !element.isHTMLElement() && document().isHTMLDocument();
+    if (needsLowerCaseLocalName)
+        element.tagQName().localNameUpper();
+
+    inChangedSubtree |= element.getStyleChangeType() >= SubtreeStyleChange;
+    if (inChangedSubtree || element.needsStyleRecalc()) {
+        // styleForElement() would add these before matching the element.
+        bool changedDefaultStyle = false;
+        CSSDefaultStyleSheets::instance().ensureDefaultStyleSheetsForElement(element, changedDefaultStyle);
+        if (changedDefaultStyle)
+            collectFeatures();
+        if (!needsLowerCaseLocalName)
+            matcher.addElement(element);
+    }
+
+    // Only the document's tree scope is matched in parallel, so this does
+    // not enter shadow trees.
+    if (!inChangedSubtree && !element.childNeedsStyleRecalc())
+        return;
+    for (Element* child = ElementTraversal::firstChild(element); child; child = ElementTraversal::nextSibling(*child))
+        collectElementsForParallelMatching(matcher, *child, inChangedSubtree);
+}
+
 static inline ScopedStyleResolver* scopedResolverFor(const Element& element)
 {
     // Ideally, returning element->treeScope().scopedStyleResolver() should be
@@ -789,6 +857,7 @@ PassRefPtr<ComputedStyle> StyleResolver::styleForElement(Element* element, const
             collectFeatures();
 
         ElementRuleCollector collector(state.elementContext(), m_selectorFilter, state.style());
+        collector.setParallelSelectorMatcher(m_parallelSelectorMatcher.get());
 
         matchAllRules(state, collector, matchingBehavior != MatchAllRulesExcludingSMIL);
 
@@ -1503,6 +1572,29 @@ static unsigned computeMatchedPropertiesHash(const MatchedProperties* properties
 void StyleResolver::invalidateMatchedPropertiesCache()
 {
     m_matchedPropertiesCache.clear();
+    // Whatever changed, e.g. a web font that finished loading, may affect
+    // the styles shared with other documents too.
+    if (m_sharedMatchedPropertiesCache) {
+        m_sharedMatchedPropertiesCache->clear();
+        m_sharedMatchedPropertiesCache = nullptr;
+    }
+}
+
+void StyleResolver::invalidateDocumentMatchedPropertiesCache()
+{
+    m_matchedPropertiesCache.clear();
+}
+
+SharedMatchedPropertiesCache* StyleResolver::sharedMatchedPropertiesCache()
+{
+    if (!RuntimeEnabledFeatures::sharedMatchedPropertiesCacheEnabled())
+        return nullptr;
+    if (!m_sharedMatchedPropertiesCache) {
+        DEFINE_STATIC_LOCAL(HeapVector<Member<CSSStyleSheet>>, noStyleSheets, (new HeapVector<Member<CSSStyleSheet>>));
+        ScopedStyleResolver* scopedResolver = document().scopedStyleResolver();
+        m_sharedMatchedPropertiesCache = SharedMatchedPropertiesCache::forStyleSheets(scopedResolver ? scopedResolver->authorStyleSheets() : noStyleSheets, document());
+    }
+    return m_sharedMatchedPropertiesCache;
 }
 
 void StyleResolver::notifyResizeForViewportUnits()
@@ -1521,6 +1613,13 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
     unsigned cacheHash = RuntimeEnabledFeatures::styleMatchedPropertiesCacheEnabled() && matchResult.isCacheable() ? computeMatchedPropertiesHash(matchResult.matchedProperties().data(), matchResult.matchedProperties().size()) : 0;
     bool applyInheritedOnly = false;
     const CachedMatchedProperties* cachedMatchedProperties = cacheHash ? m_matchedPropertiesCache.find(cacheHash, state, matchResult.matchedProperties()) : nullptr;
+    // Styles computed for other documents only provide the non-inherited
+    // properties.
+    bool isSharedCacheHit = false;
+    if (!cachedMatchedProperties && cacheHash && sharedMatchedPropertiesCache()) {
+        cachedMatchedProperties = m_sharedMatchedPropertiesCache->find(cacheHash, state, matchResult.matchedProperties());
+        isSharedCacheHit = cachedMatchedProperties;
+    }
 
     if (cachedMatchedProperties && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
         INCREMENT_STYLE_STATS_COUNTER(document().styleEngine(), matchedPropertyCacheHit, 1);
@@ -1528,7 +1627,7 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
         // style declarations. We then only need to apply the inherited properties, if any, as their values can depend on the
         // element context. This is fast and saves memory by reusing the style data structures.
         state.style()->copyNonInheritedFromCached(*cachedMatchedProperties->computedStyle);
-        if (state.parentStyle()->inheritedDataShared(*cachedMatchedProperties->parentComputedStyle) && !isAtShadowBoundary(element)
+        if (!isSharedCacheHit && state.parentStyle()->inheritedDataShared(*cachedMatchedProperties->parentComputedStyle) && !isAtShadowBoundary(element)
             && (!state.distributedToInsertionPoint() || state.style()->userModify() == READ_ONLY)) {
             INCREMENT_STYLE_STATS_COUNTER(document().styleEngine(), matchedPropertyCacheInheritedHit, 1);
 
@@ -1618,10 +1717,12 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
 
     loadPendingResources(state);
 
-    if (!cachedMatchedProperties && cacheHash && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
+    if ((!cachedMatchedProperties || isSharedCacheHit) && cacheHash && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
         ASSERT(RuntimeEnabledFeatures::styleMatchedPropertiesCacheEnabled());
         INCREMENT_STYLE_STATS_COUNTER(document().styleEngine(), matchedPropertyCacheAdded, 1);
         m_matchedPropertiesCache.add(*state.style(), *state.parentStyle(), cacheHash, matchResult.matchedProperties());
+        if (!cachedMatchedProperties && m_sharedMatchedPropertiesCache && SharedMatchedPropertiesCache::isSharable(*state.style()))
+            m_sharedMatchedPropertiesCache->add(*state.style(), cacheHash, matchResult.matchedProperties());
     }
 
     ASSERT(!state.fontBuilder().fontDirty());
@@ -1726,6 +1827,7 @@ bool StyleResolver::mediaQueryAffectedByDeviceChange() const
 DEFINE_TRACE(StyleResolver)
 {
     visitor->trace(m_matchedPropertiesCache);
+    visitor->trace(m_sharedMatchedPropertiesCache);
     visitor->trace(m_medium);
     visitor->trace(m_viewportDependentMediaQueryResults);
     visitor->trace(m_deviceDependentMediaQueryResults);
@@ -1735,6 +1837,7 @@ DEFINE_TRACE(StyleResolver)
     visitor->trace(m_siblingRuleSet);
     visitor->trace(m_uncommonAttributeRuleSet);
     visitor->trace(m_watchedSelectorsRules);
+    visitor->trace(m_parallelSelectorMatcher);
     visitor->trace(m_treeBoundaryCrossingScopes);
     visitor->trace(m_styleSharingLists);
     visitor->trace(m_pendingStyleSheets);
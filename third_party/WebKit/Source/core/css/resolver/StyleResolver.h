@@ -55,6 +55,7 @@ class Element;
 class Interpolation;
 class MatchResult;
 class MediaQueryEvaluator;
+class ParallelSelectorMatcher;
 class ScopedStyleResolver;
 class StylePropertySet;
 class StyleRule;
@@ -142,6 +143,9 @@ public:
 
     // FIXME: Rename to reflect the purpose, like didChangeFontSize or something.
     void invalidateMatchedPropertiesCache();
+    // Leaves the SharedMatchedPropertiesCache alone, for changes that do not
+    // affect the styles shared with other documents.
+    void invalidateDocumentMatchedPropertiesCache();
 
     void notifyResizeForViewportUnits();
 
@@ -168,6 +172,12 @@ public:
     void addToStyleSharingList(Element&);
     void clearStyleSharingList();
 
+    // Matches the simplest selectors against the elements that need their
+    // style recalculated, on worker threads, for styleForElement() to look up
+    // until clearParallelSelectorMatches(). See ParallelSelectorMatcher.
+    void matchSelectorsInParallel(bool forceRecalc);
+    void clearParallelSelectorMatches();
+
     void increaseStyleSharingDepth() { ++m_styleSharingDepth; }
     void decreaseStyleSharingDepth() { --m_styleSharingDepth; }
 
@@ -199,9 +209,11 @@ private:
     void matchAuthorRulesV0(const Element&, ElementRuleCollector&);
     void matchAllRules(StyleResolverState&, ElementRuleCollector&, bool includeSMILProperties);
     void collectFeatures();
+    void collectElementsForParallelMatching(ParallelSelectorMatcher&, Element&, bool inChangedSubtree);
     void collectTreeBoundaryCrossingRules(const Element&, ElementRuleCollector&);
 
     void applyMatchedProperties(StyleResolverState&, const MatchResult&);
+    SharedMatchedPropertiesCache* sharedMatchedPropertiesCache();
     bool applyAnimatedProperties(StyleResolverState&, const Element* animatingElement);
     void applyCallbackSelectors(StyleResolverState&);
 
@@ -227,6 +239,8 @@ private:
     static ComputedStyle* s_styleNotYetAvailable;
 
     MatchedPropertiesCache m_matchedPropertiesCache;
+    // Looked up again when the author style sheets change.
+    Member<SharedMatchedPropertiesCache> m_sharedMatchedPropertiesCache;
 
     Member<MediaQueryEvaluator> m_medium;
     MediaQueryResultList m_viewportDependentMediaQueryResults;
@@ -245,6 +259,7 @@ private:
     Member<RuleSet> m_siblingRuleSet;
     Member<RuleSet> m_uncommonAttributeRuleSet;
     Member<RuleSet> m_watchedSelectorsRules;
+    Member<ParallelSelectorMatcher> m_parallelSelectorMatcher;
 
     DocumentOrderedList m_treeBoundaryCrossingScopes;
 
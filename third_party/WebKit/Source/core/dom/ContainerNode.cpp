@@ -1093,7 +1093,7 @@ Element* ContainerNode::querySelector(const AtomicString& selectors, ExceptionSt
         return nullptr;
 
     NthIndexCache nthIndexCache(document());
-    return selectorQuery->queryFirst(*this);
+    return document().selectorQueryResultCache().queryFirst(selectors, *selectorQuery, *this);
 }
 
 StaticElementList* ContainerNode::querySelectorAll(const AtomicString& selectors, ExceptionState& exceptionState)
@@ -1108,7 +1108,7 @@ StaticElementList* ContainerNode::querySelectorAll(const AtomicString& selectors
         return nullptr;
 
     NthIndexCache nthIndexCache(document());
-    return selectorQuery->queryAll(*this);
+    return document().selectorQueryResultCache().queryAll(selectors, *selectorQuery, *this);
 }
 
 static void dispatchChildInsertionEvents(Node& child)
@@ -524,6 +524,13 @@ SelectorQueryCache& Document::selectorQueryCache()
     return *m_selectorQueryCache;
 }
 
+SelectorQueryResultCache& Document::selectorQueryResultCache()
+{
+    if (!m_selectorQueryResultCache)
+        m_selectorQueryResultCache = SelectorQueryResultCache::create();
+    return *m_selectorQueryResultCache;
+}
+
 MediaQueryMatcher& Document::mediaQueryMatcher()
 {
     if (!m_mediaQueryMatcher)
@@ -544,6 +551,8 @@ void Document::setCompatibilityMode(CompatibilityMode mode)
         return;
     m_compatibilityMode = mode;
     selectorQueryCache().invalidate();
+    if (m_selectorQueryResultCache)
+        m_selectorQueryResultCache->invalidate();
 }
 
 String Document::compatMode() const
@@ -1577,7 +1586,8 @@ void Document::inheritHtmlAndBodyElementStyles(StyleRecalcChange change)
     // rem units like we do for viewport styles, but we assume root font size changes are
     // rare and just invalidate the cache for now.
     if (styleEngine().usesRemUnits() && (documentElement()->needsAttach() || !documentElement()->computedStyle() || documentElement()->computedStyle()->fontSize() != documentElementStyle->fontSize())) {
-        ensureStyleResolver().invalidateMatchedPropertiesCache();
+        // Styles with rem units are not shared with other documents.
+        ensureStyleResolver().invalidateDocumentMatchedPropertiesCache();
         documentElement()->setNeedsStyleRecalc(SubtreeStyleChange, StyleChangeReasonForTracing::create(StyleChangeReason::FontSizeChange));
     }
 
@@ -1774,6 +1784,8 @@ void Document::updateStyle()
     clearNeedsStyleRecalc();
 
     StyleResolver& resolver = ensureStyleResolver();
+    if (RuntimeEnabledFeatures::parallelStyleRecalcEnabled())
+        resolver.matchSelectorsInParallel(change == Force);
 
     bool shouldRecordStats;
     TRACE_EVENT_CATEGORY_GROUP_ENABLED("blink,blink_style", &shouldRecordStats);
@@ -1793,6 +1805,7 @@ void Document::updateStyle()
     clearChildNeedsStyleRecalc();
 
     resolver.clearStyleSharingList();
+    resolver.clearParallelSelectorMatches();
 
     m_wasPrinting = m_printing;
 
@@ -2919,6 +2932,8 @@ void Document::updateBaseURL()
         m_baseURL = m_url;
 
     selectorQueryCache().invalidate();
+    if (m_selectorQueryResultCache)
+        m_selectorQueryResultCache->invalidate();
 
     if (!m_baseURL.isValid())
         m_baseURL = KURL();
@@ -5972,6 +5987,7 @@ DEFINE_TRACE(Document)
     visitor->trace(m_templateDocumentHost);
     visitor->trace(m_userActionElements);
     visitor->trace(m_svgExtensions);
+    visitor->trace(m_selectorQueryResultCache);
     visitor->trace(m_timeline);
     visitor->trace(m_compositorPendingAnimations);
     visitor->trace(m_contextDocument);
@@ -154,6 +154,7 @@ class ScriptedIdleTaskController;
 class SecurityOrigin;
 class SegmentedString;
 class SelectorQueryCache;
+class SelectorQueryResultCache;
 class SerializedScriptValue;
 class Settings;
 class SnapCoordinator;
@@ -256,6 +257,7 @@ public:
     bool canContainRangeEndPoint() const override { return true; }
 
     SelectorQueryCache& selectorQueryCache();
+    SelectorQueryResultCache& selectorQueryResultCache();
 
     // Focus Management.
     Element* activeElement() const;
@@ -1324,6 +1326,7 @@ private:
     bool m_annotatedRegionsDirty;
 
     OwnPtr<SelectorQueryCache> m_selectorQueryCache;
+    Member<SelectorQueryResultCache> m_selectorQueryResultCache;
 
     // It is safe to keep a raw, untraced pointer to this stack-allocated
     // cache object: it is set upon the cache object being allocated on
@@ -190,6 +190,10 @@ public:
     // This variant will not update the potentially invalid attributes. To be used when not interested
     // in style attribute or one of the SVG animation attributes.
     AttributeCollection attributesWithoutUpdate() const;
+    // Whether the style attribute or the animated SVG attributes may be
+    // missing from, or stale in, attributesWithoutUpdate().
+    bool styleAttributeIsDirty() const;
+    bool animatedSVGAttributesAreDirty() const;
 
     void scrollIntoView(bool alignToTop = true);
     void scrollIntoViewIfNeeded(bool centerIfNeeded = true);
@@ -804,6 +808,16 @@ inline AttributeCollection Element::attributesWithoutUpdate() const
     return elementData()->attributes();
 }
 
+inline bool Element::styleAttributeIsDirty() const
+{
+    return elementData() && elementData()->m_styleAttributeIsDirty;
+}
+
+inline bool Element::animatedSVGAttributesAreDirty() const
+{
+    return elementData() && elementData()->m_animatedSVGAttributesAreDirty;
+}
+
 inline bool Element::hasAttributes() const
 {
     return !attributes().isEmpty();
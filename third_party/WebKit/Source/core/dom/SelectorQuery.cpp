@@ -97,6 +97,34 @@ private:
     Member<Element> m_currentElement;
 };
 
+static bool selectorResultsAreCacheable(const CSSSelector& firstSelector)
+{
+    for (const CSSSelector* selector = &firstSelector; selector; selector = selector->tagHistory()) {
+        switch (selector->match()) {
+        case CSSSelector::Tag:
+        case CSSSelector::Id:
+        case CSSSelector::Class:
+            break;
+        default:
+            // Pseudo classes depend on state other than the tree and the
+            // attributes, and attributes like style are synchronized lazily,
+            // without a new DOM tree version.
+            return false;
+        }
+        switch (selector->relation()) {
+        case CSSSelector::SubSelector:
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+        case CSSSelector::DirectAdjacent:
+        case CSSSelector::IndirectAdjacent:
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
 void SelectorDataList::initialize(const CSSSelectorList& selectorList)
 {
     DCHECK(m_selectors.isEmpty());
@@ -107,6 +135,7 @@ void SelectorDataList::initialize(const CSSSelectorList& selectorList)
 
     m_usesDeepCombinatorOrShadowPseudo = false;
     m_needsUpdatedDistribution = false;
+    m_resultsAreCacheable = true;
     m_selectors.reserveInitialCapacity(selectorCount);
     unsigned index = 0;
     for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(*selector), ++index) {
@@ -115,6 +144,7 @@ void SelectorDataList::initialize(const CSSSelectorList& selectorList)
         m_selectors.uncheckedAppend(selector);
         m_usesDeepCombinatorOrShadowPseudo |= selectorList.selectorUsesDeepCombinatorOrShadowPseudo(index);
         m_needsUpdatedDistribution |= selectorList.selectorNeedsUpdatedDistribution(index);
+        m_resultsAreCacheable &= selectorResultsAreCacheable(*selector);
     }
 }
 
@@ -280,7 +310,7 @@ void SelectorDataList::findTraverseRootsAndExecute(ContainerNode& rootNode, type
 
         // If we have both CSSSelector::Id and CSSSelector::Class at the same time, we should use Id
         // to find traverse root.
-        if (!SelectorQueryTrait::shouldOnlyMatchFirstElement && !startFromParent && selector->match() == CSSSelector::Class) {
+        if (!startFromParent && selector->match() == CSSSelector::Class && (isRightmostSelector || !SelectorQueryTrait::shouldOnlyMatchFirstElement)) {
             if (isRightmostSelector) {
                 ClassElementList<AllElements> traverseRoots(rootNode, selector->value());
                 executeForTraverseRoots<SelectorQueryTrait>(*m_selectors[0], traverseRoots, MatchesTraverseRoots, rootNode, output);
@@ -556,6 +586,11 @@ Element* SelectorQuery::queryFirst(ContainerNode& rootNode) const
     return m_selectors.queryFirst(rootNode);
 }
 
+bool SelectorQuery::resultsAreCacheable() const
+{
+    return m_selectors.resultsAreCacheable();
+}
+
 SelectorQuery* SelectorQueryCache::add(const AtomicString& selectors, const Document& document, ExceptionState& exceptionState)
 {
     HashMap<AtomicString, OwnPtr<SelectorQuery>>::iterator it = m_entries.find(selectors);
@@ -581,4 +616,116 @@ void SelectorQueryCache::invalidate()
     m_entries.clear();
 }
 
+class SelectorQueryResultCache::Entry final : public GarbageCollected<SelectorQueryResultCache::Entry> {
+public:
+    Entry(const AtomicString& selectors, ContainerNode& rootNode)
+        : m_selectors(selectors)
+        , m_rootNode(&rootNode)
+        , m_hasAllElements(false)
+        , m_hasFirstElement(false)
+    {
+    }
+
+    DEFINE_INLINE_TRACE()
+    {
+        visitor->trace(m_rootNode);
+        visitor->trace(m_allElements);
+        visitor->trace(m_firstElement);
+    }
+
+    AtomicString m_selectors;
+    Member<ContainerNode> m_rootNode;
+    bool m_hasAllElements;
+    HeapVector<Member<Element>> m_allElements;
+    bool m_hasFirstElement;
+    Member<Element> m_firstElement;
+};
+
+SelectorQueryResultCache::SelectorQueryResultCache()
+    : m_domTreeVersion(0)
+{
+}
+
+StaticElementList* SelectorQueryResultCache::queryAll(const AtomicString& selectors, const SelectorQuery& selectorQuery, ContainerNode& rootNode)
+{
+    if (!selectorQuery.resultsAreCacheable())
+        return selectorQuery.queryAll(rootNode);
+
+    Entry* entry = find(selectors, rootNode);
+    if (!entry || !entry->m_hasAllElements) {
+        StaticElementList* result = selectorQuery.queryAll(rootNode);
+        if (!entry)
+            entry = add(selectors, rootNode);
+        entry->m_hasAllElements = true;
+        entry->m_allElements.reserveInitialCapacity(result->length());
+        for (unsigned i = 0; i < result->length(); ++i)
+            entry->m_allElements.uncheckedAppend(result->item(i));
+        return result;
+    }
+
+    // Every call returns a new list.
+    HeapVector<Member<Element>> elements(entry->m_allElements);
+    return StaticElementList::adopt(elements);
+}
+
+Element* SelectorQueryResultCache::queryFirst(const AtomicString& selectors, const SelectorQuery& selectorQuery, ContainerNode& rootNode)
+{
+    if (!selectorQuery.resultsAreCacheable())
+        return selectorQuery.queryFirst(rootNode);
+
+    Entry* entry = find(selectors, rootNode);
+    if (entry && entry->m_hasAllElements)
+        return entry->m_allElements.isEmpty() ? nullptr : entry->m_allElements.first().get();
+    if (!entry || !entry->m_hasFirstElement) {
+        Element* result = selectorQuery.queryFirst(rootNode);
+        if (!entry)
+            entry = add(selectors, rootNode);
+        entry->m_hasFirstElement = true;
+        entry->m_firstElement = result;
+        return result;
+    }
+    return entry->m_firstElement;
+}
+
+SelectorQueryResultCache::Entry* SelectorQueryResultCache::find(const AtomicString& selectors, const ContainerNode& rootNode)
+{
+    // Any change to the tree or to an attribute makes all the results stale.
+    uint64_t domTreeVersion = rootNode.document().domTreeVersion();
+    if (domTreeVersion != m_domTreeVersion) {
+        m_entries.clear();
+        m_domTreeVersion = domTreeVersion;
+        return nullptr;
+    }
+
+    for (const auto& entry : m_entries) {
+        if (entry->m_rootNode == &rootNode && entry->m_selectors == selectors)
+            return entry.get();
+    }
+    return nullptr;
+}
+
+SelectorQueryResultCache::Entry* SelectorQueryResultCache::add(const AtomicString& selectors, ContainerNode& rootNode)
+{
+    // Running the queries cached here does not change the DOM tree version.
+    DCHECK_EQ(m_domTreeVersion, rootNode.document().domTreeVersion());
+
+    const size_t maximumSelectorQueryResultCacheSize = 32;
+    if (m_entries.size() == maximumSelectorQueryResultCacheSize)
+        m_entries.remove(0);
+
+    Entry* entry = new Entry(selectors, rootNode);
+    m_entries.append(entry);
+    return entry;
+}
+
+void SelectorQueryResultCache::invalidate()
+{
+    m_entries.clear();
+}
+
+DEFINE_TRACE(SelectorQueryResultCache)
+{
+    visitor->trace(m_entries);
+}
+
 } // namespace blink
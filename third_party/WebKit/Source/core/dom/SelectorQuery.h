@@ -51,6 +51,7 @@ public:
     Element* closest(Element&) const;
     StaticElementList* queryAll(ContainerNode& rootNode) const;
     Element* queryFirst(ContainerNode& rootNode) const;
+    bool resultsAreCacheable() const { return m_resultsAreCacheable; }
 
 private:
     bool canUseFastQuery(const ContainerNode& rootNode) const;
@@ -83,6 +84,7 @@ private:
     Vector<const CSSSelector*> m_selectors;
     bool m_usesDeepCombinatorOrShadowPseudo : 1;
     bool m_needsUpdatedDistribution : 1;
+    bool m_resultsAreCacheable : 1;
 };
 
 class CORE_EXPORT SelectorQuery {
@@ -95,6 +97,10 @@ public:
     Element* closest(Element&) const;
     StaticElementList* queryAll(ContainerNode& rootNode) const;
     Element* queryFirst(ContainerNode& rootNode) const;
+    // Whether the results only depend on the tree and the attributes of the
+    // elements in it, which is the case for selectors made of type, id and
+    // class selectors and the descendant, child and sibling combinators.
+    bool resultsAreCacheable() const;
 private:
     explicit SelectorQuery(CSSSelectorList);
 
@@ -112,6 +118,34 @@ private:
     HashMap<AtomicString, OwnPtr<SelectorQuery>> m_entries;
 };
 
+// Remembers the results of recent queries by their selectors and root node,
+// for as long as the DOM tree version of the document stays the same. Pages
+// tend to run the same queries over and over between two mutations.
+class SelectorQueryResultCache final : public GarbageCollected<SelectorQueryResultCache> {
+public:
+    static SelectorQueryResultCache* create()
+    {
+        return new SelectorQueryResultCache;
+    }
+
+    StaticElementList* queryAll(const AtomicString& selectors, const SelectorQuery&, ContainerNode& rootNode);
+    Element* queryFirst(const AtomicString& selectors, const SelectorQuery&, ContainerNode& rootNode);
+    void invalidate();
+
+    DECLARE_TRACE();
+
+private:
+    class Entry;
+
+    SelectorQueryResultCache();
+
+    Entry* find(const AtomicString& selectors, const ContainerNode& rootNode);
+    Entry* add(const AtomicString& selectors, ContainerNode& rootNode);
+
+    HeapVector<Member<Entry>> m_entries;
+    uint64_t m_domTreeVersion;
+};
+
 } // namespace blink
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "core/css/parser/CSSParser.h"
 #include "core/dom/Document.h"
+#include "core/dom/StaticNodeList.h"
 #include "core/html/HTMLHtmlElement.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -29,4 +30,43 @@ TEST(SelectorQueryTest, NotMatchingPseudoElement)
     EXPECT_NE(nullptr, elm);
 }
 
+TEST(SelectorQueryTest, ResultsAreCacheable)
+{
+    Document* document = Document::create();
+    const char* cacheable[] = { "div", "#id", ".a.b", "div > .a + span ~ p #id" };
+    for (const char* selectors : cacheable) {
+        CSSSelectorList selectorList = CSSParser::parseSelector(CSSParserContext(*document, nullptr), nullptr, selectors);
+        EXPECT_TRUE(SelectorQuery::adopt(std::move(selectorList))->resultsAreCacheable()) << selectors;
+    }
+    const char* notCacheable[] = { "div:hover", "[style]", "div, :checked" };
+    for (const char* selectors : notCacheable) {
+        CSSSelectorList selectorList = CSSParser::parseSelector(CSSParserContext(*document, nullptr), nullptr, selectors);
+        EXPECT_FALSE(SelectorQuery::adopt(std::move(selectorList))->resultsAreCacheable()) << selectors;
+    }
+}
+
+TEST(SelectorQueryTest, ResultCacheInvalidatedByMutations)
+{
+    Document* document = Document::create();
+    HTMLHtmlElement* html = HTMLHtmlElement::create(*document);
+    document->appendChild(html);
+    document->documentElement()->setInnerHTML("<body><div class='a'></div><div></div></body>", ASSERT_NO_EXCEPTION);
+
+    StaticElementList* first = document->querySelectorAll(".a", ASSERT_NO_EXCEPTION);
+    StaticElementList* second = document->querySelectorAll(".a", ASSERT_NO_EXCEPTION);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(1u, second->length());
+    EXPECT_EQ(first->item(0), second->item(0));
+    EXPECT_EQ(first->item(0), document->querySelector(".a", ASSERT_NO_EXCEPTION));
+
+    Element* div = document->querySelectorAll("div", ASSERT_NO_EXCEPTION)->item(1);
+    div->setAttribute("class", "a");
+    EXPECT_EQ(2u, document->querySelectorAll(".a", ASSERT_NO_EXCEPTION)->length());
+
+    div->remove(ASSERT_NO_EXCEPTION);
+    EXPECT_EQ(1u, document->querySelectorAll(".a", ASSERT_NO_EXCEPTION)->length());
+    EXPECT_EQ(1u, document->querySelectorAll("div", ASSERT_NO_EXCEPTION)->length());
+    EXPECT_EQ(0u, div->querySelectorAll("div", ASSERT_NO_EXCEPTION)->length());
+}
+
 } // namespace blink
@@ -25,11 +25,17 @@
 #include "platform/Logging.h"
 #include "platform/RuntimeEnabledFeatures.h"
 #include "platform/TraceEvent.h"
+#include "platform/web_memory_allocator_dump.h"
+#include "platform/web_process_memory_dump.h"
 #include "platform/weborigin/SecurityOrigin.h"
 #include "platform/weborigin/SecurityOriginHash.h"
 #include "public/platform/Platform.h"
+#include "public/platform/WebScheduler.h"
+#include "public/platform/WebTraceLocation.h"
 #include "wtf/Assertions.h"
 #include "wtf/CurrentTime.h"
+#include "wtf/Functional.h"
+#include "wtf/HashMap.h"
 #include "wtf/MathExtras.h"
 #include "wtf/TemporaryChange.h"
 #include "wtf/text/CString.h"
@@ -108,6 +114,8 @@ DEFINE_TRACE(MemoryCacheLRUList)
 inline MemoryCache::MemoryCache()
     : m_inPruneResources(false)
     , m_prunePending(false)
+    , m_pruneAtEndOfTask(false)
+    , m_idlePruneTaskPosted(false)
     , m_maxPruneDeferralDelay(cMaxPruneDeferralDelay)
     , m_pruneTimeStamp(0.0)
     , m_pruneFrameTimeStamp(0.0)
@@ -137,7 +145,7 @@ MemoryCache* MemoryCache::create()
 
 MemoryCache::~MemoryCache()
 {
-    if (m_prunePending)
+    if (m_pruneAtEndOfTask)
         Platform::current()->currentThread()->removeTaskObserver(this);
 }
 
@@ -306,6 +314,21 @@ void MemoryCache::pruneLiveResources(PruneStrategy strategy)
     }
 }
 
+// Scripts, style sheets and fonts block parsing or rendering when they are
+// needed again, so dead ones are kept longer than images and other resources,
+// which are evicted first regardless of their LRU order.
+static bool isRetainedLonger(const Resource& resource)
+{
+    switch (resource.getType()) {
+    case Resource::Script:
+    case Resource::CSSStyleSheet:
+    case Resource::Font:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void MemoryCache::pruneDeadResources(PruneStrategy strategy)
 {
     size_t capacity = deadCapacity();
@@ -316,63 +339,66 @@ void MemoryCache::pruneDeadResources(PruneStrategy strategy)
 
     size_t targetSize = static_cast<size_t>(capacity * cTargetPrunePercentage); // Cut by a percentage to avoid immediately pruning again.
 
-    int size = m_allResources.size();
     if (targetSize && m_deadSize <= targetSize)
         return;
 
-    bool canShrinkLRULists = true;
-    for (int i = size - 1; i >= 0; i--) {
-        // Remove from the tail, since this is the least frequently accessed of the objects.
-        MemoryCacheEntry* current = m_allResources[i].m_tail;
-
-        // First flush all the decoded data in this queue.
-        while (current) {
-            Resource* resource = current->resource();
-            MemoryCacheEntry* previous = current->m_previousInAllResourcesList;
-
-            // Decoded data may reference other resources. Skip |current| if
-            // |current| somehow got kicked out of cache during
-            // destroyDecodedData().
-            if (!resource || !contains(resource)) {
+    // The first pass leaves the resources that are retained longer alone.
+    for (int pass = 0; pass < 2; ++pass) {
+        bool evictRetainedResources = pass;
+        bool canShrinkLRULists = true;
+        for (int i = m_allResources.size() - 1; i >= 0; i--) {
+            // Remove from the tail, since this is the least frequently accessed of the objects.
+            MemoryCacheEntry* current = m_allResources[i].m_tail;
+
+            // First flush all the decoded data in this queue.
+            while (current) {
+                Resource* resource = current->resource();
+                MemoryCacheEntry* previous = current->m_previousInAllResourcesList;
+
+                // Decoded data may reference other resources. Skip |current| if
+                // |current| somehow got kicked out of cache during
+                // destroyDecodedData().
+                if (!resource || !contains(resource)) {
+                    current = previous;
+                    continue;
+                }
+
+                if (!resource->hasClientsOrObservers() && !resource->isPreloaded() && resource->isLoaded() && (evictRetainedResources || !isRetainedLonger(*resource))) {
+                    // Destroy our decoded data. This will remove us from
+                    // m_liveDecodedResources, and possibly move us to a different
+                    // LRU list in m_allResources.
+                    resource->prune();
+
+                    if (targetSize && m_deadSize <= targetSize)
+                        return;
+                }
                 current = previous;
-                continue;
-            }
-
-            if (!resource->hasClientsOrObservers() && !resource->isPreloaded() && resource->isLoaded()) {
-                // Destroy our decoded data. This will remove us from
-                // m_liveDecodedResources, and possibly move us to a different
-                // LRU list in m_allResources.
-                resource->prune();
-
-                if (targetSize && m_deadSize <= targetSize)
-                    return;
             }
-            current = previous;
-        }
 
-        // Now evict objects from this queue.
-        current = m_allResources[i].m_tail;
-        while (current) {
-            Resource* resource = current->resource();
-            MemoryCacheEntry* previous = current->m_previousInAllResourcesList;
-            if (!resource || !contains(resource)) {
+            // Now evict objects from this queue.
+            current = m_allResources[i].m_tail;
+            while (current) {
+                Resource* resource = current->resource();
+                MemoryCacheEntry* previous = current->m_previousInAllResourcesList;
+                if (!resource || !contains(resource)) {
+                    current = previous;
+                    continue;
+                }
+                if (!resource->hasClientsOrObservers() && !resource->isPreloaded() && (evictRetainedResources || !isRetainedLonger(*resource))) {
+                    evict(current);
+                    if (targetSize && m_deadSize <= targetSize)
+                        return;
+                }
                 current = previous;
-                continue;
             }
-            if (!resource->hasClientsOrObservers() && !resource->isPreloaded()) {
-                evict(current);
-                if (targetSize && m_deadSize <= targetSize)
-                    return;
-            }
-            current = previous;
-        }
 
-        // Shrink the vector back down so we don't waste time inspecting
-        // empty LRU lists on future prunes.
-        if (m_allResources[i].m_head)
-            canShrinkLRULists = false;
-        else if (canShrinkLRULists)
-            m_allResources.resize(i);
+            // Shrink the vector back down so we don't waste time inspecting
+            // empty LRU lists on future prunes.
+            if (m_allResources[i].m_head)
+                canShrinkLRULists = false;
+            else if (canShrinkLRULists)
+                m_allResources.resize(i);
+        }
     }
 }
 
@@ -683,26 +709,18 @@ void MemoryCache::prune(Resource* justReleasedResource)
         return;
 
     // To avoid burdening the current thread with repetitive pruning jobs,
-    // pruning is postponed until the end of the current task. If it has
-    // been more than m_maxPruneDeferralDelay since the last prune,
+    // pruning is postponed until the thread is idle, or until the end of the
+    // current task if the cache is far over its capacity (see deferPrune()).
+    // If it has been more than m_maxPruneDeferralDelay since the last prune,
     // then we prune immediately.
     // If the current thread's run loop is not active, then pruning will happen
     // immediately only if it has been over m_maxPruneDeferralDelay
     // since the last prune.
     double currentTime = WTF::currentTime();
-    if (m_prunePending) {
-        if (currentTime - m_pruneTimeStamp >= m_maxPruneDeferralDelay) {
-            pruneNow(currentTime, AutomaticPrune);
-        }
-    } else {
-        if (currentTime - m_pruneTimeStamp >= m_maxPruneDeferralDelay) {
-            pruneNow(currentTime, AutomaticPrune); // Delay exceeded, prune now.
-        } else {
-            // Defer.
-            Platform::current()->currentThread()->addTaskObserver(this);
-            m_prunePending = true;
-        }
-    }
+    if (currentTime - m_pruneTimeStamp >= m_maxPruneDeferralDelay)
+        pruneNow(currentTime, AutomaticPrune); // Delay exceeded, prune now.
+    else
+        deferPrune();
 
     if (m_prunePending && m_deadSize > m_maxDeferredPruneDeadCapacity && justReleasedResource) {
         // The following eviction does not respect LRU order, but it can be done
@@ -720,6 +738,40 @@ void MemoryCache::prune(Resource* justReleasedResource)
     }
 }
 
+void MemoryCache::deferPrune()
+{
+    m_prunePending = true;
+
+    // Pruning walks all the dead resources, which is best kept off the
+    // critical path of parsing and layout on resource heavy pages. Once the
+    // cache has grown to twice its capacity, it can't wait for the thread to
+    // become idle though, which may take long on a busy page.
+    WebScheduler* scheduler = Platform::current()->currentThread()->scheduler();
+    bool farOverCapacity = m_liveSize + m_deadSize > cDeferredPruneDeadCapacityFactor * m_capacity || m_deadSize > m_maxDeferredPruneDeadCapacity;
+    if (!scheduler || farOverCapacity) {
+        if (!m_pruneAtEndOfTask) {
+            Platform::current()->currentThread()->addTaskObserver(this);
+            m_pruneAtEndOfTask = true;
+        }
+        return;
+    }
+
+    if (!m_idlePruneTaskPosted) {
+        scheduler->postIdleTask(BLINK_FROM_HERE, WTF::bind<double>(&MemoryCache::pruneDuringIdle, this));
+        m_idlePruneTaskPosted = true;
+    }
+}
+
+void MemoryCache::pruneDuringIdle(double)
+{
+    m_idlePruneTaskPosted = false;
+    // The prune may already have happened at the end of a task.
+    if (!m_prunePending)
+        return;
+    TRACE_EVENT0("renderer", "MemoryCache::pruneDuringIdle()");
+    pruneNow(WTF::currentTime(), AutomaticPrune);
+}
+
 void MemoryCache::willProcessTask()
 {
 }
@@ -728,6 +780,7 @@ void MemoryCache::didProcessTask()
 {
     // Perform deferred pruning
     ASSERT(m_prunePending);
+    ASSERT(m_pruneAtEndOfTask);
     pruneNow(WTF::currentTime(), AutomaticPrune);
 }
 
@@ -739,8 +792,9 @@ void MemoryCache::pruneAll()
 
 void MemoryCache::pruneNow(double currentTime, PruneStrategy strategy)
 {
-    if (m_prunePending) {
-        m_prunePending = false;
+    m_prunePending = false;
+    if (m_pruneAtEndOfTask) {
+        m_pruneAtEndOfTask = false;
         Platform::current()->currentThread()->removeTaskObserver(this);
     }
 
@@ -756,15 +810,54 @@ void MemoryCache::updateFramePaintTimestamp()
     m_lastFramePaintTimeStamp = currentTime();
 }
 
+namespace {
+
+struct ResourceTypeDumpStatistics {
+    ResourceTypeDumpStatistics()
+        : count(0)
+        , liveSize(0)
+        , deadSize(0)
+        , decodedSize(0)
+    {
+    }
+
+    size_t count;
+    size_t liveSize;
+    size_t deadSize;
+    size_t decodedSize;
+};
+
+} // namespace
+
 bool MemoryCache::onMemoryDump(WebMemoryDumpLevelOfDetail levelOfDetail, WebProcessMemoryDump* memoryDump)
 {
+    // Keyed by Resource::resourceTypeToString(), which names the parent dump
+    // of the resources of a type.
+    HashMap<String, ResourceTypeDumpStatistics> typeStatistics;
     for (const auto& resourceMapIter : m_resourceMaps) {
         for (const auto& resourceIter : *resourceMapIter.value) {
             Resource* resource = resourceIter.value->resource();
-            if (resource)
-                resource->onMemoryDump(levelOfDetail, memoryDump);
+            if (!resource)
+                continue;
+            resource->onMemoryDump(levelOfDetail, memoryDump);
+
+            ResourceTypeDumpStatistics& statistics = typeStatistics.add(Resource::resourceTypeToString(resource->getType(), resource->options().initiatorInfo), ResourceTypeDumpStatistics()).storedValue->value;
+            statistics.count++;
+            if (resource->hasClientsOrObservers())
+                statistics.liveSize += resource->size();
+            else
+                statistics.deadSize += resource->size();
+            statistics.decodedSize += resource->decodedSize();
         }
     }
+
+    for (const auto& typeStatisticsIter : typeStatistics) {
+        WebMemoryAllocatorDump* dump = memoryDump->createMemoryAllocatorDump("web_cache/" + typeStatisticsIter.key + "_resources");
+        dump->addScalar("object_count", "objects", typeStatisticsIter.value.count);
+        dump->addScalar("live_size", "bytes", typeStatisticsIter.value.liveSize);
+        dump->addScalar("dead_size", "bytes", typeStatisticsIter.value.deadSize);
+        dump->addScalar("decoded_size", "bytes", typeStatisticsIter.value.decodedSize);
+    }
     return true;
 }
 
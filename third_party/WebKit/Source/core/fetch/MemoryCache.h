@@ -257,6 +257,10 @@ private:
     void pruneDeadResources(PruneStrategy);
     void pruneLiveResources(PruneStrategy);
     void pruneNow(double currentTime, PruneStrategy);
+    // Schedules a prune for when the thread is idle, or for the end of the
+    // current task if the cache has grown too far over its capacity to wait.
+    void deferPrune();
+    void pruneDuringIdle(double deadlineSeconds);
 
     void evict(MemoryCacheEntry*);
 
@@ -266,6 +270,8 @@ private:
 
     bool m_inPruneResources;
     bool m_prunePending;
+    bool m_pruneAtEndOfTask;
+    bool m_idlePruneTaskPosted;
     double m_maxPruneDeferralDelay;
     double m_pruneTimeStamp;
     double m_pruneFrameTimeStamp;
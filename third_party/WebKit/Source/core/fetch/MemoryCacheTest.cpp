@@ -197,6 +197,36 @@ TEST_F(MemoryCacheTest, DeadResourceEviction_MultipleResourceMaps)
     TestDeadResourceEviction(resource1, resource2);
 }
 
+// Verifies that dead images are evicted before dead scripts, even if the
+// script is the least recently used.
+TEST_F(MemoryCacheTest, DeadResourceEviction_ScriptsRetainedLongerThanImages)
+{
+    Resource* script =
+        Resource::create(ResourceRequest("http://test/script"), Resource::Script);
+    Resource* image =
+        Resource::create(ResourceRequest("http://test/images"), Resource::Image);
+    const char data[5] = "abcd";
+    script->appendData(data, 4u);
+    image->appendData(data, 4u);
+
+    memoryCache()->setDelayBeforeLiveDecodedPrune(0);
+    memoryCache()->setMaxPruneDeferralDelay(0);
+    const unsigned totalCapacity = 1000000;
+    const unsigned minDeadCapacity = 0;
+    const unsigned maxDeadCapacity = script->size() + image->size() - 1;
+    memoryCache()->setCapacities(minDeadCapacity, maxDeadCapacity, totalCapacity);
+
+    memoryCache()->add(script);
+    memoryCache()->add(image);
+    ASSERT_TRUE(memoryCache()->isInSameLRUListForTest(script, image));
+    ASSERT_EQ(script->size() + image->size(), memoryCache()->deadSize());
+
+    memoryCache()->prune();
+    EXPECT_TRUE(memoryCache()->contains(script));
+    EXPECT_FALSE(memoryCache()->contains(image));
+    EXPECT_EQ(script->size(), memoryCache()->deadSize());
+}
+
 static void runTask1(Resource* live, Resource* dead)
 {
     // The resource size has to be nonzero for this test to be meaningful, but
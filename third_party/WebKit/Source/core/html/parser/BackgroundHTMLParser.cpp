@@ -34,6 +34,7 @@
 #include "public/platform/Platform.h"
 #include "public/platform/WebTaskRunner.h"
 #include "wtf/text/TextPosition.h"
+#include <algorithm>
 
 namespace blink {
 
@@ -56,6 +57,13 @@ static const size_t defaultOutstandingTokenLimit = 10000;
 // This was tuned in https://bugs.webkit.org/show_bug.cgi?id=110408.
 static const size_t defaultPendingTokenLimit = 1000;
 
+// While the main thread has not caught up with the chunks sent so far, every
+// chunk after that is made twice as large as the one before, up to this many
+// tokens, so that large documents are handed over in fewer chunks. Once the
+// main thread is waiting for tokens again, chunks go back to the pending
+// token limit.
+static const size_t maxPendingTokenLimit = 4000;
+
 using namespace HTMLNames;
 
 #if ENABLE(ASSERT)
@@ -101,6 +109,7 @@ BackgroundHTMLParser::BackgroundHTMLParser(PassRefPtr<WeakReference<BackgroundHT
     , m_outstandingTokenLimit(config->outstandingTokenLimit)
     , m_parser(config->parser)
     , m_pendingTokens(adoptPtr(new CompactHTMLTokenStream))
+    , m_initialPendingTokenLimit(config->pendingTokenLimit)
     , m_pendingTokenLimit(config->pendingTokenLimit)
     , m_xssAuditor(std::move(config->xssAuditor))
     , m_preloadScanner(adoptPtr(new TokenPreloadScanner(documentURL, std::move(cachedDocumentParameters), mediaValuesCachedData)))
@@ -307,6 +316,10 @@ void BackgroundHTMLParser::sendTokensToMainThread()
         m_loadingTaskRunner->postTask(
             BLINK_FROM_HERE,
             threadSafeBind(&HTMLDocumentParser::notifyPendingParsedChunks, m_parser));
+        m_pendingTokenLimit = m_initialPendingTokenLimit;
+    } else {
+        size_t limit = std::min(maxPendingTokenLimit, m_outstandingTokenLimit);
+        m_pendingTokenLimit = std::max(m_pendingTokenLimit, std::min(m_pendingTokenLimit * 2, limit));
     }
 
     m_pendingTokens = adoptPtr(new CompactHTMLTokenStream);
@@ -111,7 +111,9 @@ private:
     WeakPtr<HTMLDocumentParser> m_parser;
 
     OwnPtr<CompactHTMLTokenStream> m_pendingTokens;
-    const size_t m_pendingTokenLimit;
+    const size_t m_initialPendingTokenLimit;
+    // Grows while the main thread is behind, see sendTokensToMainThread().
+    size_t m_pendingTokenLimit;
     PreloadRequestStream m_pendingPreloads;
     // Indices into |m_pendingTokens|.
     Vector<int> m_likelyDocumentWriteScriptIndices;
@@ -39,6 +39,22 @@ struct SameSizeAsCompactHTMLToken  {
 
 static_assert(sizeof(CompactHTMLToken) == sizeof(SameSizeAsCompactHTMLToken), "CompactHTMLToken should stay small");
 
+// Tag and attribute names are turned into AtomicStrings on the main thread.
+// Names that are static strings already are atomic there, so that costs
+// nothing. Other names are replaced with the string shared by all threads
+// when possible, which the main thread atomizes without copying; the rest
+// are hashed here so that the main thread only has to look them up in its
+// AtomicString table.
+static String prepareNameForAtomization(String name)
+{
+    if (name.impl() && !name.impl()->isStatic()) {
+        if (StringImpl* sharedName = AtomicString::findOrAddShared(name.impl()))
+            return sharedName;
+        name.impl()->hash();
+    }
+    return name;
+}
+
 CompactHTMLToken::CompactHTMLToken(const HTMLToken* token, const TextPosition& textPosition)
     : m_type(token->type())
     , m_isAll8BitData(false)
@@ -63,11 +79,13 @@ CompactHTMLToken::CompactHTMLToken(const HTMLToken* token, const TextPosition& t
     case HTMLToken::StartTag:
         m_attributes.reserveInitialCapacity(token->attributes().size());
         for (const HTMLToken::Attribute& attribute : token->attributes())
-            m_attributes.append(Attribute(attribute.nameAttemptStaticStringCreation(), attribute.value8BitIfNecessary()));
+            m_attributes.append(Attribute(prepareNameForAtomization(attribute.nameAttemptStaticStringCreation()), attribute.value8BitIfNecessary()));
         // Fall through!
     case HTMLToken::EndTag:
         m_selfClosing = token->selfClosing();
-        // Fall through!
+        m_isAll8BitData = token->isAll8BitData();
+        m_data = prepareNameForAtomization(attemptStaticStringCreation(token->data(), token->isAll8BitData() ? Force8Bit : Force16Bit));
+        break;
     case HTMLToken::Comment:
     case HTMLToken::Character: {
         m_isAll8BitData = token->isAll8BitData();
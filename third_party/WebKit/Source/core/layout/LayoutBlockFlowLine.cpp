@@ -1871,6 +1871,22 @@ bool LayoutBlockFlow::matchedEndLine(LineLayoutState& layoutState, const InlineB
         }
     }
 
+    // No match. The clean lines that break before the point we have laid out to can never match,
+    // so drop them and let the lines we check move forward with the layout. Otherwise an edit that
+    // moves the breaks of more than |numLines| lines, like typing at the start of a long paragraph,
+    // would lay out the rest of the paragraph again. Floats are placed with |endLineStart| in mind,
+    // so don't bother when there are any.
+    if (!layoutState.floats().isEmpty())
+        return false;
+    LayoutUnit endLineLogicalTop = layoutState.endLineLogicalTop();
+    for (line = originalEndLine; line->nextRootBox() && line->lineBreakObj() == resolver.position().getLineLayoutItem() && line->lineBreakPos() < resolver.position().offset(); line = line->nextRootBox())
+        endLineLogicalTop = line->lineBottomWithLeading();
+    if (line != originalEndLine) {
+        layoutState.setEndLine(line);
+        layoutState.setEndLineLogicalTop(endLineLogicalTop);
+        deleteLineRange(layoutState, originalEndLine, line);
+    }
+
     return false;
 }
 
@@ -4,9 +4,14 @@
 
 #include "core/layout/LayoutBlock.h"
 
+#include "bindings/core/v8/ExceptionStatePlaceholder.h"
+#include "core/dom/Text.h"
+#include "core/frame/FrameView.h"
 #include "core/layout/LayoutBlockFlow.h"
 #include "core/layout/LayoutTestHelper.h"
+#include "core/layout/line/RootInlineBox.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "wtf/text/StringBuilder.h"
 
 namespace blink {
 
@@ -21,4 +26,34 @@ TEST_F(LayoutBlockTest, LayoutNameCalledWithNullStyle)
     obj->destroy();
 }
 
+TEST_F(LayoutBlockTest, KeepsCleanLinesAfterLongRunOfMovedLineBreaks)
+{
+    // Ten characters to a line. Adding a character at the start moves every
+    // line break up to the short line, after which the breaks line up again.
+    StringBuilder text;
+    for (int i = 0; i < 12; ++i)
+        text.append("aaaa bbbbb ");
+    text.append("aa bb xxxxxxxxxx");
+    for (int i = 0; i < 10; ++i)
+        text.append(" aaaa bbbbb");
+    setBodyInnerHTML("<div id='target' style='font-family: monospace; width: 10ch'>" + text.toString() + "</div>");
+    LayoutBlockFlow* target = toLayoutBlockFlow(getLayoutObjectByElementId("target"));
+
+    Vector<RootInlineBox*> lines;
+    for (RootInlineBox* line = target->firstRootBox(); line; line = line->nextRootBox())
+        lines.append(line);
+    ASSERT_EQ(24u, lines.size());
+
+    toText(target->node()->firstChild())->insertData(0, "c", ASSERT_NO_EXCEPTION);
+    document().view()->updateAllLifecyclePhases();
+
+    Vector<RootInlineBox*> newLines;
+    for (RootInlineBox* line = target->firstRootBox(); line; line = line->nextRootBox())
+        newLines.append(line);
+    ASSERT_EQ(25u, newLines.size());
+    // The lines after the one made of x's are the same as before.
+    for (size_t i = 1; i <= 10; ++i)
+        EXPECT_EQ(lines[lines.size() - i], newLines[newLines.size() - i]);
+}
+
 } // namespace blink
@@ -36,6 +36,7 @@
 #include "core/css/resolver/StyleResolver.h"
 #include "core/dom/Document.h"
 #include "core/dom/ElementTraversal.h"
+#include "core/dom/SelectorQuery.h"
 #include "core/dom/shadow/ShadowRoot.h"
 #include "core/events/Event.h"
 #include "core/frame/Settings.h"
@@ -837,6 +838,8 @@ void SVGElement::svgAttributeChanged(const QualifiedName& attrName)
 
     if (attrName == HTMLNames::classAttr) {
         classAttributeChanged(AtomicString(m_className->currentValue()->value()));
+        // Animating the class does not change the DOM tree version.
+        document().selectorQueryResultCache().invalidate();
         invalidateInstances();
         return;
     }
@@ -240,6 +240,27 @@ void PaintController::copyCachedSubsequence(const DisplayItemList& currentList,
     } while (!endSubsequenceId.matches(updatedList.last()));
 }
 
+// True if each new display item is a cached item for the next item or subsequence of the
+// current list, and together they stand for the whole current list.
+bool PaintController::newDisplayItemsAreAllCachedInOrder() const
+{
+    const DisplayItemList& currentList = m_currentPaintArtifact.getDisplayItemList();
+    size_t currentIndex = 0;
+    for (const DisplayItem& newDisplayItem : m_newDisplayItemList) {
+        if (!newDisplayItem.isCached() || currentIndex == currentList.size() || !newDisplayItem.nonCachedId().matches(currentList[currentIndex]))
+            return false;
+        if (newDisplayItem.getType() == DisplayItem::CachedSubsequence) {
+            DisplayItem::Id endSubsequenceId(newDisplayItem.client(), DisplayItem::EndSubsequence);
+            while (currentIndex < currentList.size() && !endSubsequenceId.matches(currentList[currentIndex]))
+                ++currentIndex;
+            if (currentIndex == currentList.size())
+                return false;
+        }
+        ++currentIndex;
+    }
+    return currentIndex == currentList.size();
+}
+
 static IntRect visualRectForDisplayItem(const DisplayItem& displayItem, const LayoutSize& offsetFromLayoutObject)
 {
     LayoutRect visualRect = displayItem.client().visualRect();
@@ -293,6 +314,24 @@ void PaintController::commitNewDisplayItems(const LayoutSize& offsetFromLayoutOb
         return;
     }
 
+    // When nothing but paint properties changed, such as the scroll offset in the paint chunk
+    // properties in SPv2, every new item is a cached one standing for the current list in order. Keep the current list as it is rather than moving each item into a new one; only the
+    // paint chunks, which carry the new properties, are replaced. The clients' cache generation
+    // stays valid as the same clients keep the same items.
+    bool checkingUnderInvalidation = false;
+#if DCHECK_IS_ON()
+    checkingUnderInvalidation = RuntimeEnabledFeatures::slimmingPaintUnderInvalidationCheckingEnabled();
+#endif
+    if (!checkingUnderInvalidation && newDisplayItemsAreAllCachedInOrder()) {
+        bool isSuitableForGpuRasterization = m_currentPaintArtifact.isSuitableForGpuRasterization();
+        m_currentPaintArtifact = PaintArtifact(std::move(m_currentPaintArtifact.getDisplayItemList()), m_newPaintChunks.releasePaintChunks(), isSuitableForGpuRasterization);
+        m_newDisplayItemList = DisplayItemList(kInitialDisplayItemListCapacityBytes);
+#if CHECK_DISPLAY_ITEM_CLIENT_ALIVENESS
+        DisplayItemClient::endShouldKeepAliveAllClients(this);
+#endif
+        return;
+    }
+
     // Stores indices to valid DrawingDisplayItems in m_currentDisplayItems that have not been matched
     // by CachedDisplayItems during synchronized matching. The indexed items will be matched
     // by later out-of-order CachedDisplayItems in m_newDisplayItemList. This ensures that when
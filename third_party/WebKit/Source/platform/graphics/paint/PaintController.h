@@ -189,6 +189,7 @@ private:
     DisplayItemList::iterator findOutOfOrderCachedItem(const DisplayItem::Id&, OutOfOrderIndexContext&);
     DisplayItemList::iterator findOutOfOrderCachedItemForward(const DisplayItem::Id&, OutOfOrderIndexContext&);
     void copyCachedSubsequence(const DisplayItemList& currentList, DisplayItemList::iterator& currentIt, DisplayItemList& updatedList, SkPictureGpuAnalyzer&);
+    bool newDisplayItemsAreAllCachedInOrder() const;
 
 #if DCHECK_IS_ON()
     // The following two methods are for checking under-invalidations
@@ -388,6 +388,81 @@ TEST_F(PaintControllerTest, CachedDisplayItems)
     EXPECT_FALSE(getPaintController().clientCacheIsValid(second));
 }
 
+TEST_F(PaintControllerTest, AllCachedInOrderKeepsDisplayItemList)
+{
+    FakeDisplayItemClient container("container");
+    FakeDisplayItemClient first("first");
+    FakeDisplayItemClient second("second");
+    GraphicsContext context(getPaintController());
+
+    drawRect(context, first, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    {
+        SubsequenceRecorder subsequenceRecorder(context, container);
+        drawRect(context, second, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+        drawRect(context, second, foregroundDrawingType, FloatRect(100, 100, 150, 150));
+    }
+    getPaintController().commitNewDisplayItems();
+    const DisplayItem* firstItem = &getPaintController().getDisplayItemList()[0];
+
+    drawRect(context, first, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    EXPECT_TRUE(SubsequenceRecorder::useCachedSubsequenceIfPossible(context, container));
+    getPaintController().commitNewDisplayItems();
+
+    EXPECT_DISPLAY_LIST(getPaintController().getDisplayItemList(), 5,
+        TestDisplayItem(first, backgroundDrawingType),
+        TestDisplayItem(container, DisplayItem::Subsequence),
+        TestDisplayItem(second, backgroundDrawingType),
+        TestDisplayItem(second, foregroundDrawingType),
+        TestDisplayItem(container, DisplayItem::EndSubsequence));
+    // The items were not moved into a new list.
+    EXPECT_EQ(firstItem, &getPaintController().getDisplayItemList()[0]);
+    EXPECT_TRUE(getPaintController().clientCacheIsValid(container));
+    EXPECT_TRUE(getPaintController().clientCacheIsValid(first));
+    EXPECT_TRUE(getPaintController().clientCacheIsValid(second));
+
+    // Dropping an item still updates the list.
+    EXPECT_TRUE(SubsequenceRecorder::useCachedSubsequenceIfPossible(context, container));
+    getPaintController().commitNewDisplayItems();
+
+    EXPECT_DISPLAY_LIST(getPaintController().getDisplayItemList(), 4,
+        TestDisplayItem(container, DisplayItem::Subsequence),
+        TestDisplayItem(second, backgroundDrawingType),
+        TestDisplayItem(second, foregroundDrawingType),
+        TestDisplayItem(container, DisplayItem::EndSubsequence));
+    EXPECT_FALSE(getPaintController().clientCacheIsValid(first));
+}
+
+TEST_F(PaintControllerTest, AllCachedInOrderTakesNewPaintChunks)
+{
+    RuntimeEnabledFeatures::setSlimmingPaintV2Enabled(true);
+    FakeDisplayItemClient first("first");
+    FakeDisplayItemClient second("second");
+    GraphicsContext context(getPaintController());
+
+    PaintChunkProperties properties;
+    properties.transform = TransformPaintPropertyNode::create(TransformationMatrix(), FloatPoint3D());
+    getPaintController().updateCurrentPaintChunkProperties(properties);
+    drawRect(context, first, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    drawRect(context, second, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    getPaintController().commitNewDisplayItems();
+
+    PaintChunkProperties scrolledProperties;
+    scrolledProperties.transform = TransformPaintPropertyNode::create(TransformationMatrix().translate(0, -100), FloatPoint3D());
+    getPaintController().updateCurrentPaintChunkProperties(scrolledProperties);
+    drawRect(context, first, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    drawRect(context, second, backgroundDrawingType, FloatRect(100, 100, 150, 150));
+    getPaintController().commitNewDisplayItems();
+
+    EXPECT_DISPLAY_LIST(getPaintController().getDisplayItemList(), 2,
+        TestDisplayItem(first, backgroundDrawingType),
+        TestDisplayItem(second, backgroundDrawingType));
+    const auto& paintChunks = getPaintController().paintChunks();
+    ASSERT_EQ(1u, paintChunks.size());
+    EXPECT_TRUE(scrolledProperties == paintChunks[0].properties);
+    EXPECT_EQ(0u, paintChunks[0].beginIndex);
+    EXPECT_EQ(2u, paintChunks[0].endIndex);
+}
+
 TEST_F(PaintControllerTest, ComplexUpdateSwapOrder)
 {
     FakeDisplayItemClient container1("container1");
@@ -32,6 +32,7 @@
 
 #include "base/sys_info.h"
 #include "platform/Histogram.h"
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/ScriptForbiddenScope.h"
 #include "platform/TraceEvent.h"
 #include "platform/heap/BlinkGCMemoryDumpProvider.h"
@@ -100,6 +101,29 @@ private:
     bool m_shouldResumeThreads;
 };
 
+// Locks the callback stacks of a heap if other threads may be pushing onto
+// them concurrently, i.e. while marking in parallel.
+class ThreadHeap::CallbackStackLocker final {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(CallbackStackLocker);
+public:
+    explicit CallbackStackLocker(ThreadHeap* heap)
+        : m_mutex(heap->isMarkingInParallel() ? &heap->m_callbackStackMutex : nullptr)
+    {
+        if (m_mutex)
+            m_mutex->lock();
+    }
+
+    ~CallbackStackLocker()
+    {
+        if (m_mutex)
+            m_mutex->unlock();
+    }
+
+private:
+    Mutex* m_mutex;
+};
+
 void ThreadHeap::flushHeapDoesNotContainCache()
 {
     m_heapDoesNotContainCache->flush();
@@ -114,6 +138,7 @@ void ProcessHeap::init()
     s_isLowEndDevice = base::SysInfo::IsLowEndDevice();
 
     GCInfoTable::init();
+    ParallelMarker::init();
 }
 
 void ProcessHeap::resetHeapCounters()
@@ -226,6 +251,8 @@ ThreadHeap::ThreadHeap()
     , m_postMarkingCallbackStack(adoptPtr(new CallbackStack()))
     , m_globalWeakCallbackStack(adoptPtr(new CallbackStack()))
     , m_ephemeronStack(adoptPtr(new CallbackStack(CallbackStack::kMinimalBlockSize)))
+    , m_markingInParallel(false)
+    , m_compaction(HeapCompact::create())
 {
     if (ThreadState::current()->isMainThread())
         s_mainThreadHeap = this;
@@ -347,10 +374,14 @@ Address ThreadHeap::checkAndMarkPointer(Visitor* visitor, Address address)
 
 void ThreadHeap::pushTraceCallback(void* object, TraceCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isInGCOrMarkingThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!getOrphanedPagePool()->contains(object));
+    if (UNLIKELY(m_markingInParallel)) {
+        m_parallelMarker->pushTraceCallback(object, callback);
+        return;
+    }
     CallbackStack::Item* slot = m_markingStack->allocateEntry();
     *slot = CallbackStack::Item(object, callback);
 }
@@ -366,10 +397,11 @@ bool ThreadHeap::popAndInvokeTraceCallback(Visitor* visitor)
 
 void ThreadHeap::pushPostMarkingCallback(void* object, TraceCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isInGCOrMarkingThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!getOrphanedPagePool()->contains(object));
+    CallbackStackLocker locker(this);
     CallbackStack::Item* slot = m_postMarkingCallbackStack->allocateEntry();
     *slot = CallbackStack::Item(object, callback);
 }
@@ -385,21 +417,23 @@ bool ThreadHeap::popAndInvokePostMarkingCallback(Visitor* visitor)
 
 void ThreadHeap::pushGlobalWeakCallback(void** cell, WeakCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isInGCOrMarkingThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!getOrphanedPagePool()->contains(cell));
+    CallbackStackLocker locker(this);
     CallbackStack::Item* slot = m_globalWeakCallbackStack->allocateEntry();
     *slot = CallbackStack::Item(cell, callback);
 }
 
 void ThreadHeap::pushThreadLocalWeakCallback(void* closure, void* object, WeakCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isInGCOrMarkingThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!getOrphanedPagePool()->contains(object));
     ThreadState* state = pageFromObject(object)->arena()->getThreadState();
+    CallbackStackLocker locker(this);
     state->pushThreadLocalWeakCallback(closure, callback);
 }
 
@@ -414,12 +448,15 @@ bool ThreadHeap::popAndInvokeGlobalWeakCallback(Visitor* visitor)
 
 void ThreadHeap::registerWeakTable(void* table, EphemeronCallback iterationCallback, EphemeronCallback iterationDoneCallback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isInGCOrMarkingThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!getOrphanedPagePool()->contains(table));
-    CallbackStack::Item* slot = m_ephemeronStack->allocateEntry();
-    *slot = CallbackStack::Item(table, iterationCallback);
+    {
+        CallbackStackLocker locker(this);
+        CallbackStack::Item* slot = m_ephemeronStack->allocateEntry();
+        *slot = CallbackStack::Item(table, iterationCallback);
+    }
 
     // Register a post-marking callback to tell the tables that
     // ephemeron iteration is complete.
@@ -430,6 +467,7 @@ void ThreadHeap::registerWeakTable(void* table, EphemeronCallback iterationCallb
 bool ThreadHeap::weakTableRegistered(const void* table)
 {
     ASSERT(m_ephemeronStack);
+    CallbackStackLocker locker(this);
     return m_ephemeronStack->hasCallbackForObject(table);
 }
 #endif
@@ -512,6 +550,9 @@ void ThreadHeap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType
     // finalization that happens when the visitorScope is torn down).
     ThreadState::NoAllocationScope noAllocationScope(state);
 
+    // This has to look at the free lists before preGC() clears them.
+    state->heap().compaction()->checkIfCompacting(&state->heap(), state, stackState, gcType, reason);
+
     state->heap().preGC();
 
     StackFrameDepthScope stackDepthScope;
@@ -617,8 +658,15 @@ void ThreadHeap::processMarkingStack(Visitor* visitor)
         {
             // Iteratively mark all objects that are reachable from the objects
             // currently pushed onto the marking stack.
-            TRACE_EVENT0("blink_gc", "ThreadHeap::processMarkingStackSingleThreaded");
-            while (popAndInvokeTraceCallback(visitor)) { }
+            if (shouldMarkInParallel(visitor)) {
+                TRACE_EVENT0("blink_gc", "ThreadHeap::processMarkingStackInParallel");
+                m_markingInParallel = true;
+                m_parallelMarker->processMarkingStack(visitor);
+                m_markingInParallel = false;
+            } else {
+                TRACE_EVENT0("blink_gc", "ThreadHeap::processMarkingStackSingleThreaded");
+                while (popAndInvokeTraceCallback(visitor)) { }
+            }
         }
 
         {
@@ -632,6 +680,24 @@ void ThreadHeap::processMarkingStack(Visitor* visitor)
     } while (!m_markingStack->isEmpty());
 }
 
+bool ThreadHeap::shouldMarkInParallel(Visitor* visitor)
+{
+    // Only regular GCs of the main thread heap are worth the marking threads.
+    // Thread termination GCs only mark a single thread's objects, and heap
+    // snapshots are taken rarely.
+    if (!RuntimeEnabledFeatures::parallelGCMarkingEnabled())
+        return false;
+    if (!isMainThreadHeap() || visitor->getMarkingMode() != Visitor::GlobalMarking)
+        return false;
+    if (!m_parallelMarker) {
+        size_t numberOfMarkingThreads = ParallelMarker::numberOfMarkingThreads();
+        if (!numberOfMarkingThreads)
+            return false;
+        m_parallelMarker = adoptPtr(new ParallelMarker(this, numberOfMarkingThreads));
+    }
+    return true;
+}
+
 void ThreadHeap::postMarkingProcessing(Visitor* visitor)
 {
     TRACE_EVENT0("blink_gc", "ThreadHeap::postMarkingProcessing");
@@ -33,8 +33,10 @@
 
 #include "platform/PlatformExport.h"
 #include "platform/heap/GCInfo.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/HeapPage.h"
 #include "platform/heap/PageMemory.h"
+#include "platform/heap/ParallelMarker.h"
 #include "platform/heap/ThreadState.h"
 #include "platform/heap/Visitor.h"
 #include "wtf/AddressSanitizer.h"
@@ -189,6 +191,15 @@ public:
 #if ENABLE(ASSERT)
     bool isAtSafePoint();
     BasePage* findPageFromAddress(Address);
+
+    // Returns true if the current thread may trace objects: it is either
+    // running a GC, or helping one to mark in parallel.
+    static bool isInGCOrMarkingThread()
+    {
+        if (ThreadState* state = ThreadState::current())
+            return state->isInGC();
+        return ParallelMarker::isMarkingThread();
+    }
 #endif
 
     template<typename T>
@@ -202,11 +213,15 @@ public:
         // always 'alive'.
         if (!object)
             return true;
-        // TODO(keishi): some tests create CrossThreadPersistent on non attached threads.
-        if (!ThreadState::current())
-            return true;
-        if (&ThreadState::current()->heap() != &pageFromObject(object)->arena()->getThreadState()->heap())
+        if (!ThreadState::current()) {
+            // The marking threads are not attached, but they do see the mark
+            // bits of the heap they are marking.
+            // TODO(keishi): some tests create CrossThreadPersistent on non attached threads.
+            if (!ParallelMarker::isMarkingThread())
+                return true;
+        } else if (&ThreadState::current()->heap() != &pageFromObject(object)->arena()->getThreadState()->heap()) {
             return true;
+        }
         return ObjectAliveTrait<T>::isHeapObjectAlive(object);
     }
     template<typename T>
@@ -239,6 +254,13 @@ public:
     CallbackStack* globalWeakCallbackStack() const { return m_globalWeakCallbackStack.get(); }
     CallbackStack* ephemeronStack() const { return m_ephemeronStack.get(); }
 
+    // True while the marking stack is being drained by several threads at
+    // once. Marking then has to set mark bits atomically, and the callback
+    // stacks have to be locked.
+    bool isMarkingInParallel() const { return m_markingInParallel; }
+
+    HeapCompact* compaction() const { return m_compaction.get(); }
+
     void attach(ThreadState*);
     void detach(ThreadState*);
     void lockThreadAttachMutex();
@@ -392,9 +414,13 @@ public:
     static void reportMemoryUsageForTracing();
 
 private:
+    class CallbackStackLocker;
+
     // Reset counters that track live and allocated-since-last-GC sizes.
     void resetHeapCounters();
 
+    bool shouldMarkInParallel(Visitor*);
+
     static int arenaIndexForObjectSize(size_t);
     static bool isNormalArenaIndex(int);
 
@@ -413,6 +439,12 @@ private:
     OwnPtr<CallbackStack> m_globalWeakCallbackStack;
     OwnPtr<CallbackStack> m_ephemeronStack;
     BlinkGC::GCReason m_lastGCReason;
+    OwnPtr<ParallelMarker> m_parallelMarker;
+    bool m_markingInParallel;
+    OwnPtr<HeapCompact> m_compaction;
+    // Guards the callback stacks other than the marking stack while marking
+    // in parallel. The marking stack is guarded by the ParallelMarker.
+    Mutex m_callbackStackMutex;
 
     static ThreadHeap* s_mainThreadHeap;
 
@@ -152,6 +152,12 @@ public:
         TraceCollectionIfEnabled<WTF::IsTraceableInCollectionTrait<Traits>::value, Traits::weakHandlingFlag, WTF::WeakPointersActWeak, T, Traits>::trace(visitor, t);
     }
 
+    template<typename VisitorDispatcher>
+    static void registerBackingStoreReference(VisitorDispatcher visitor, void** slot)
+    {
+        visitor->registerBackingStoreReference(slot);
+    }
+
     template<typename VisitorDispatcher>
     static void registerDelayedMarkNoTracing(VisitorDispatcher visitor, const void* object)
     {
@@ -0,0 +1,131 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/heap/HeapCompact.h"
+
+#include "platform/RuntimeEnabledFeatures.h"
+#include "platform/TraceEvent.h"
+#include "platform/heap/Heap.h"
+#include <algorithm>
+
+namespace blink {
+
+namespace {
+
+// Compacting is only worth the copying once the compactable arenas hold this
+// much free space between their objects.
+const size_t kFreeListSizeThreshold = 512 * 1024;
+
+bool relocationStartsBefore(const HeapCompact::Relocation& a, const HeapCompact::Relocation& b)
+{
+    return a.from < b.from;
+}
+
+} // namespace
+
+bool HeapCompact::s_forceCompactionForTesting = false;
+
+HeapCompact::HeapCompact()
+    : m_doCompact(false)
+    , m_state(nullptr)
+{
+}
+
+HeapCompact::~HeapCompact()
+{
+}
+
+void HeapCompact::checkIfCompacting(ThreadHeap* heap, ThreadState* state, BlinkGC::StackState stackState, BlinkGC::GCType gcType, BlinkGC::GCReason reason)
+{
+    ASSERT(!state->isInGC());
+    ASSERT(m_slots.isEmpty());
+    m_doCompact = false;
+    m_state = nullptr;
+
+    if (!s_forceCompactionForTesting && !RuntimeEnabledFeatures::heapCompactionEnabled())
+        return;
+    // References to backing stores from the stack cannot be updated.
+    if (stackState != BlinkGC::NoHeapPointersOnStack || reason == BlinkGC::ConservativeGC)
+        return;
+    if (gcType != BlinkGC::GCWithSweep && gcType != BlinkGC::GCWithoutSweep)
+        return;
+    // The references are updated after the other threads have resumed, so
+    // only compact heaps that are not shared with other threads.
+    if (heap->threads().size() != 1)
+        return;
+
+    if (!s_forceCompactionForTesting) {
+        size_t freeListSize = 0;
+        for (int i = BlinkGC::Vector1ArenaIndex; i <= BlinkGC::Vector4ArenaIndex; ++i)
+            freeListSize += static_cast<NormalPageArena*>(state->arena(i))->freeListSize();
+        if (freeListSize < kFreeListSizeThreshold)
+            return;
+    }
+
+    m_doCompact = true;
+    m_state = state;
+}
+
+void HeapCompact::registerMovingObjectReference(MovableReference* slot)
+{
+    ASSERT(m_doCompact);
+    if (!*slot)
+        return;
+    BasePage* page = pageFromObject(*slot);
+    if (page->isLargeObjectPage() || !isCompactableArena(page->arena()->arenaIndex()) || page->arena()->getThreadState() != m_state)
+        return;
+    MutexLocker locker(m_mutex);
+    m_slots.append(slot);
+}
+
+void HeapCompact::compact(ThreadState* state)
+{
+    ASSERT(m_doCompact);
+    ASSERT(state == m_state);
+    TRACE_EVENT0("blink_gc", "HeapCompact::compact");
+    m_doCompact = false;
+
+    // Weak processing may have cleared or replaced some of the references
+    // since they were registered, so look at what they point to now. A
+    // backing store found through more than one reference stays in place.
+    MovableObjects movableObjects;
+    MovableObjects sharedObjects;
+    for (MovableReference* slot : m_slots) {
+        Address object = reinterpret_cast<Address>(*slot);
+        if (object && !movableObjects.add(object).isNewEntry)
+            sharedObjects.add(object);
+    }
+    movableObjects.removeAll(sharedObjects);
+
+    for (int i = BlinkGC::Vector1ArenaIndex; i <= BlinkGC::Vector4ArenaIndex; ++i)
+        static_cast<NormalPageArena*>(state->arena(i))->evacuateSparsePages(movableObjects, m_relocations);
+    std::sort(m_relocations.begin(), m_relocations.end(), relocationStartsBefore);
+
+    // A reference may itself be inside a backing store that moved, in which
+    // case only its copy is still valid.
+    for (MovableReference* slot : m_slots) {
+        slot = reinterpret_cast<MovableReference*>(relocate(reinterpret_cast<Address>(slot)));
+        Address object = reinterpret_cast<Address>(*slot);
+        if (object && movableObjects.contains(object))
+            *slot = relocate(object);
+    }
+
+    m_slots.clear();
+    m_relocations.clear();
+    m_state = nullptr;
+}
+
+Address HeapCompact::relocate(Address address) const
+{
+    // Find the last object that starts at or before |address|.
+    const Relocation* it = std::upper_bound(m_relocations.begin(), m_relocations.end(), Relocation { address, nullptr, 0 }, relocationStartsBefore);
+    if (it == m_relocations.begin())
+        return address;
+    --it;
+    if (address >= it->from + it->size)
+        return address;
+    return it->to + (address - it->from);
+}
+
+} // namespace blink
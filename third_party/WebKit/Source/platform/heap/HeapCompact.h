@@ -0,0 +1,99 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef HeapCompact_h
+#define HeapCompact_h
+
+#include "platform/PlatformExport.h"
+#include "platform/heap/BlinkGC.h"
+#include "wtf/Allocator.h"
+#include "wtf/HashSet.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/ThreadingPrimitives.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class NormalPageArena;
+class ThreadHeap;
+class ThreadState;
+
+// A reference to a collection backing store that the collection owning it
+// has registered as safe to update, should the backing store move.
+using MovableReference = void*;
+
+// Oilpan does not move objects, so pages that lose most of their objects stay
+// around for as long as a single object on them is alive. HeapCompact lets a
+// GC evacuate the sparsely populated pages of the vector backing arenas:
+// vector backings are only referenced from the Vector that owns them, which
+// registers the location of that reference while being traced. After marking
+// and weak processing, the live backings of the sparse pages are copied into
+// new pages and the registered references are updated, leaving the old pages
+// free for the sweeper to release back to the page pool.
+//
+// As the references on the stack are not known, only precise GCs compact.
+class PLATFORM_EXPORT HeapCompact final {
+    USING_FAST_MALLOC(HeapCompact);
+    WTF_MAKE_NONCOPYABLE(HeapCompact);
+public:
+    static PassOwnPtr<HeapCompact> create()
+    {
+        return adoptPtr(new HeapCompact);
+    }
+
+    ~HeapCompact();
+
+    // Decides whether the GC that is about to start should compact. Must be
+    // called before the free lists are cleared for marking.
+    void checkIfCompacting(ThreadHeap*, ThreadState*, BlinkGC::StackState, BlinkGC::GCType, BlinkGC::GCReason);
+
+    bool isCompacting() const { return m_doCompact; }
+
+    static bool isCompactableArena(int arenaIndex)
+    {
+        return arenaIndex >= BlinkGC::Vector1ArenaIndex && arenaIndex <= BlinkGC::Vector4ArenaIndex;
+    }
+
+    // Records |slot| as the only reference to the backing store it points to.
+    // Called during marking, possibly from several marking threads.
+    void registerMovingObjectReference(MovableReference* slot);
+
+    // Moves the live backing stores out of the sparsely populated pages of
+    // |state|'s compactable arenas. Must be called after weak processing and
+    // before sweeping.
+    void compact(ThreadState*);
+
+    // Forces the next precise GCs to compact, regardless of fragmentation.
+    static void setForceCompactionForTesting(bool value) { s_forceCompactionForTesting = value; }
+
+    // The backing stores that may be moved, by payload address.
+    using MovableObjects = HashSet<Address>;
+
+    // An object moved by compaction.
+    struct Relocation {
+        Address from;
+        Address to;
+        size_t size;
+    };
+
+private:
+    HeapCompact();
+
+    // Returns where |address| ended up, if it is inside an object that moved.
+    Address relocate(Address) const;
+
+    bool m_doCompact;
+    ThreadState* m_state;
+    Mutex m_mutex;
+    Vector<MovableReference*> m_slots;
+    // Sorted by Relocation::from once all objects have moved.
+    Vector<Relocation> m_relocations;
+
+    static bool s_forceCompactionForTesting;
+};
+
+} // namespace blink
+
+#endif // HeapCompact_h
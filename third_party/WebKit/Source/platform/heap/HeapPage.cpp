@@ -452,6 +452,12 @@ bool NormalPageArena::isConsistentForGC()
                 return false;
         }
     }
+    for (size_t i = 0; i < numberOfSizeClasses; ++i) {
+        for (FreeListEntry* freeListEntry = m_freeList.m_sizeClassFreeLists[i]; freeListEntry; freeListEntry = freeListEntry->next()) {
+            if (pagesToBeSweptContains(freeListEntry->getAddress()))
+                return false;
+        }
+    }
     if (hasCurrentAllocationArea()) {
         if (pagesToBeSweptContains(currentAllocationPoint()))
             return false;
@@ -808,6 +814,15 @@ Address NormalPageArena::outOfLineAllocate(size_t allocationSize, size_t gcInfoI
 
 Address NormalPageArena::allocateFromFreeList(size_t allocationSize, size_t gcInfoIndex)
 {
+    // Small objects first try to fill a hole of exactly their size, which
+    // would otherwise only be reused once it gets coalesced with its
+    // neighbors.
+    if (allocationSize <= maxSizeClassFreeListEntrySize) {
+        size_t sizeClass = FreeList::sizeClassIndexForSize(allocationSize);
+        if (m_freeList.m_sizeClassFreeLists[sizeClass])
+            return allocateFromFreeListEntry(&m_freeList.m_sizeClassFreeLists[sizeClass], allocationSize, gcInfoIndex);
+    }
+
     // Try reusing a block from the largest bin. The underlying reasoning
     // being that we want to amortize this slow allocation call by carving
     // off as a large a free block as possible in one go; a block that will
@@ -825,18 +840,85 @@ Address NormalPageArena::allocateFromFreeList(size_t allocationSize, size_t gcIn
                 break;
         }
         if (entry) {
-            entry->unlink(&m_freeList.m_freeLists[index]);
-            setAllocationPoint(entry->getAddress(), entry->size());
-            ASSERT(hasCurrentAllocationArea());
-            ASSERT(remainingAllocationSize() >= allocationSize);
             m_freeList.m_biggestFreeListIndex = index;
-            return allocateObject(allocationSize, gcInfoIndex);
+            return allocateFromFreeListEntry(&m_freeList.m_freeLists[index], allocationSize, gcInfoIndex);
         }
     }
     m_freeList.m_biggestFreeListIndex = index;
+
+    // Finally, split the largest small block that is big enough.
+    if (allocationSize < maxSizeClassFreeListEntrySize) {
+        size_t minSizeClass = FreeList::sizeClassIndexForSize(allocationSize);
+        for (size_t sizeClass = numberOfSizeClasses - 1; sizeClass > minSizeClass; --sizeClass) {
+            if (m_freeList.m_sizeClassFreeLists[sizeClass])
+                return allocateFromFreeListEntry(&m_freeList.m_sizeClassFreeLists[sizeClass], allocationSize, gcInfoIndex);
+        }
+    }
     return nullptr;
 }
 
+Address NormalPageArena::allocateFromFreeListEntry(FreeListEntry** list, size_t allocationSize, size_t gcInfoIndex)
+{
+    FreeListEntry* entry = *list;
+    entry->unlink(list);
+    setAllocationPoint(entry->getAddress(), entry->size());
+    ASSERT(hasCurrentAllocationArea());
+    ASSERT(remainingAllocationSize() >= allocationSize);
+    return allocateObject(allocationSize, gcInfoIndex);
+}
+
+Address NormalPageArena::allocateObjectForCompaction(size_t allocationSize, size_t gcInfoIndex)
+{
+    // Unlike outOfLineAllocate(), this must neither sweep nor schedule a GC;
+    // the objects being moved still live on the unswept pages.
+    if (allocationSize <= remainingAllocationSize())
+        return allocateObject(allocationSize, gcInfoIndex);
+    updateRemainingAllocationSize();
+    Address result = allocateFromFreeList(allocationSize, gcInfoIndex);
+    if (result)
+        return result;
+    setAllocationPoint(nullptr, 0);
+    allocatePage();
+    result = allocateFromFreeList(allocationSize, gcInfoIndex);
+    RELEASE_ASSERT(result);
+    return result;
+}
+
+void NormalPageArena::evacuateSparsePages(const HeapCompact::MovableObjects& movableObjects, Vector<HeapCompact::Relocation>& relocations)
+{
+    ASSERT(HeapCompact::isCompactableArena(arenaIndex()));
+
+    // Moving the objects of a single page would just trade it for a new one.
+    Vector<NormalPage*> sparsePages;
+    for (BasePage* page = m_firstUnsweptPage; page; page = page->next()) {
+        NormalPage* normalPage = static_cast<NormalPage*>(page);
+        if (normalPage->markedObjectSize() * 2 < normalPage->payloadSize())
+            sparsePages.append(normalPage);
+    }
+    if (sparsePages.size() < 2)
+        return;
+
+    TRACE_EVENT1("blink_gc", "NormalPageArena::evacuateSparsePages", "pages", static_cast<int>(sparsePages.size()));
+    for (NormalPage* page : sparsePages) {
+        for (Address headerAddress = page->payload(); headerAddress < page->payloadEnd(); ) {
+            HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+            size_t size = header->size();
+            headerAddress += size;
+            if (header->isFree() || !header->isMarked() || !movableObjects.contains(header->payload()))
+                continue;
+
+            ASSERT(header->checkHeader());
+            Address from = header->payload();
+            size_t payloadSize = header->payloadSize();
+            Address to = allocateObjectForCompaction(size, header->gcInfoIndex());
+            memcpy(to, from, payloadSize);
+            SET_MEMORY_INACCESSIBLE(from, payloadSize);
+            new (NotNull, header) HeapObjectHeader(size, gcInfoIndexForFreeListHeader);
+            relocations.append(HeapCompact::Relocation { from, to, payloadSize });
+        }
+    }
+}
+
 LargeObjectArena::LargeObjectArena(ThreadState* state, int index)
     : BaseArena(state, index)
 {
@@ -1029,6 +1111,11 @@ void FreeList::addToFreeList(Address address, size_t size)
 #endif
     ASAN_POISON_MEMORY_REGION(address, size);
 
+    if (size <= maxSizeClassFreeListEntrySize) {
+        entry->link(&m_sizeClassFreeLists[sizeClassIndexForSize(size)]);
+        return;
+    }
+
     int index = bucketIndexForSize(size);
     entry->link(&m_freeLists[index]);
     if (index > m_biggestFreeListIndex)
@@ -1055,11 +1142,27 @@ void NEVER_INLINE FreeList::checkFreedMemoryIsZapped(Address address, size_t siz
 }
 #endif
 
+size_t FreeList::freeListSize() const
+{
+    size_t freeSize = 0;
+    for (size_t i = 0; i < blinkPageSizeLog2; ++i) {
+        for (FreeListEntry* entry = m_freeLists[i]; entry; entry = entry->next())
+            freeSize += entry->size();
+    }
+    for (size_t i = 0; i < numberOfSizeClasses; ++i) {
+        for (FreeListEntry* entry = m_sizeClassFreeLists[i]; entry; entry = entry->next())
+            freeSize += entry->size();
+    }
+    return freeSize;
+}
+
 void FreeList::clear()
 {
     m_biggestFreeListIndex = 0;
     for (size_t i = 0; i < blinkPageSizeLog2; ++i)
         m_freeLists[i] = nullptr;
+    for (size_t i = 0; i < numberOfSizeClasses; ++i)
+        m_sizeClassFreeLists[i] = nullptr;
 }
 
 int FreeList::bucketIndexForSize(size_t size)
@@ -1075,10 +1178,22 @@ int FreeList::bucketIndexForSize(size_t size)
 
 bool FreeList::takeSnapshot(const String& dumpBaseName)
 {
+    // Blocks in the size-class free lists are reported in the power-of-two
+    // bucket they fall into, so that the dumps look the same as before.
+    size_t sizeClassEntryCount[blinkPageSizeLog2] = { 0 };
+    size_t sizeClassFreeSize[blinkPageSizeLog2] = { 0 };
+    for (size_t i = 0; i < numberOfSizeClasses; ++i) {
+        for (FreeListEntry* entry = m_sizeClassFreeLists[i]; entry; entry = entry->next()) {
+            int index = bucketIndexForSize(entry->size());
+            ++sizeClassEntryCount[index];
+            sizeClassFreeSize[index] += entry->size();
+        }
+    }
+
     bool didDumpBucketStats = false;
     for (size_t i = 0; i < blinkPageSizeLog2; ++i) {
-        size_t entryCount = 0;
-        size_t freeSize = 0;
+        size_t entryCount = sizeClassEntryCount[i];
+        size_t freeSize = sizeClassFreeSize[i];
         for (FreeListEntry* entry = m_freeLists[i]; entry; entry = entry->next()) {
             ++entryCount;
             freeSize += entry->size();
@@ -1138,6 +1253,19 @@ size_t NormalPage::objectPayloadSizeForTesting()
     return objectPayloadSize;
 }
 
+size_t NormalPage::markedObjectSize()
+{
+    size_t markedObjectSize = 0;
+    for (Address headerAddress = payload(); headerAddress < payloadEnd(); ) {
+        HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+        ASSERT(header->size() < blinkPagePayloadSize());
+        if (!header->isFree() && header->isMarked())
+            markedObjectSize += header->size();
+        headerAddress += header->size();
+    }
+    return markedObjectSize;
+}
+
 bool NormalPage::isEmpty()
 {
     HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(payload());
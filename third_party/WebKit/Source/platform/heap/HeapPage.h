@@ -35,11 +35,13 @@
 #include "platform/PlatformExport.h"
 #include "platform/heap/BlinkGC.h"
 #include "platform/heap/GCInfo.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/ThreadState.h"
 #include "platform/heap/Visitor.h"
 #include "wtf/AddressSanitizer.h"
 #include "wtf/Allocator.h"
 #include "wtf/Assertions.h"
+#include "wtf/Atomics.h"
 #include "wtf/ContainerAnnotations.h"
 #include "wtf/Forward.h"
 #include "wtf/allocator/PageAllocator.h"
@@ -77,6 +79,9 @@ const size_t reservedForObjectBitMap = ((objectStartBitMapSize + allocationMask)
 const size_t maxHeapObjectSizeLog2 = 27;
 const size_t maxHeapObjectSize = 1 << maxHeapObjectSizeLog2;
 const size_t largeObjectSizeThreshold = blinkPageSize / 2;
+// Free blocks up to this size are kept in exact size-class free lists.
+const size_t maxSizeClassFreeListEntrySize = 256;
+const size_t numberOfSizeClasses = maxSizeClassFreeListEntrySize / allocationGranularity + 1;
 
 // A zap value used for freed memory that is allowed to be added to the free
 // list in the next addToFreeList().
@@ -211,6 +216,9 @@ public:
     void unmarkWrapperHeader();
     bool isMarked() const;
     void mark();
+    // Atomically sets the mark bit. Returns false if it was already set, i.e.
+    // another marking thread got there first.
+    bool atomicMark();
     void unmark();
     void markDead();
     bool isDead() const;
@@ -466,6 +474,8 @@ public:
     }
 
     size_t objectPayloadSizeForTesting() override;
+    // Returns the total size of the marked objects on this page.
+    size_t markedObjectSize();
     bool isEmpty() override;
     void removeFromHeap() override;
     void sweep() override;
@@ -634,9 +644,20 @@ public:
     // All FreeListEntries in the given bucket, n, have size >= 2^n.
     static int bucketIndexForSize(size_t);
 
+    // Returns the size-class free list for blocks of exactly the given size.
+    static size_t sizeClassIndexForSize(size_t size)
+    {
+        ASSERT(size <= maxSizeClassFreeListEntrySize);
+        ASSERT(!(size & allocationMask));
+        return size / allocationGranularity;
+    }
+
     // Returns true if the freelist snapshot is captured.
     bool takeSnapshot(const String& dumpBaseName);
 
+    // Returns the total size of the free list entries.
+    size_t freeListSize() const;
+
 #if ENABLE(ASSERT) || defined(LEAK_SANITIZER) || defined(ADDRESS_SANITIZER) || defined(MEMORY_SANITIZER)
     static void zapFreedMemory(Address, size_t);
     static void checkFreedMemoryIsZapped(Address, size_t);
@@ -645,9 +666,16 @@ public:
 private:
     int m_biggestFreeListIndex;
 
-    // All FreeListEntries in the nth list have size >= 2^n.
+    // All FreeListEntries in the nth list have size >= 2^n. Only blocks
+    // larger than maxSizeClassFreeListEntrySize go here.
     FreeListEntry* m_freeLists[blinkPageSizeLog2];
 
+    // All FreeListEntries in the nth list have size n * allocationGranularity.
+    // Small blocks are mostly the holes left by dead objects, so an exact fit
+    // lets them be reused by the next objects of the same size without
+    // splitting anything.
+    FreeListEntry* m_sizeClassFreeLists[numberOfSizeClasses];
+
     friend class NormalPageArena;
 };
 
@@ -745,10 +773,19 @@ public:
     bool isLazySweeping() const { return m_isLazySweeping; }
     void setIsLazySweeping(bool flag) { m_isLazySweeping = flag; }
 
+    size_t freeListSize() const { return m_freeList.freeListSize(); }
+
+    // Moves the objects in |movableObjects| out of the unswept pages that are
+    // less than half full, into new pages. The old copies are turned into
+    // free list headers, so the sweeper neither finalizes nor keeps them.
+    void evacuateSparsePages(const HeapCompact::MovableObjects&, Vector<HeapCompact::Relocation>&);
+
 private:
     void allocatePage();
     Address outOfLineAllocate(size_t allocationSize, size_t gcInfoIndex);
     Address allocateFromFreeList(size_t, size_t gcInfoIndex);
+    Address allocateFromFreeListEntry(FreeListEntry** list, size_t, size_t gcInfoIndex);
+    Address allocateObjectForCompaction(size_t, size_t gcInfoIndex);
 
     Address lazySweepPages(size_t, size_t gcInfoIndex) override;
 
@@ -884,6 +921,13 @@ void HeapObjectHeader::mark()
     m_encoded = m_encoded | headerMarkBitMask;
 }
 
+NO_SANITIZE_ADDRESS inline
+bool HeapObjectHeader::atomicMark()
+{
+    ASSERT(checkHeader());
+    return !(atomicFetchOr(&m_encoded, headerMarkBitMask) & headerMarkBitMask);
+}
+
 NO_SANITIZE_ADDRESS inline
 void HeapObjectHeader::unmark()
 {
@@ -28,6 +28,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/ThreadSafeFunctional.h"
 #include "platform/heap/Handle.h"
 #include "platform/heap/Heap.h"
@@ -1950,6 +1951,42 @@ TEST(HeapTest, SimpleAllocation)
     EXPECT_EQ(999 % 128, array->at(999));
 }
 
+class SizeClassObject : public GarbageCollected<SizeClassObject> {
+public:
+    static SizeClassObject* create() { return new SizeClassObject; }
+    DEFINE_INLINE_TRACE() { }
+
+private:
+    char m_data[200];
+};
+
+TEST(HeapTest, SizeClassFreeListReuse)
+{
+    clearOutOldGarbage();
+
+    // Allocate a run of objects and let every other one die, leaving holes of
+    // exactly one object's size between the survivors.
+    const size_t numberOfHoles = 100;
+    Persistent<SizeClassObject> survivors[numberOfHoles];
+    HashSet<void*> holes;
+    for (size_t i = 0; i < numberOfHoles; ++i) {
+        holes.add(SizeClassObject::create());
+        survivors[i] = SizeClassObject::create();
+    }
+    // With ENABLE(ASSERT), freed memory is only reused after a second GC.
+    preciselyCollectGarbage();
+    preciselyCollectGarbage();
+
+    // New objects of the same size should fill the holes rather than being
+    // bump allocated from the larger free block at the end of the page.
+    size_t reused = 0;
+    for (size_t i = 0; i < numberOfHoles; ++i) {
+        if (holes.contains(SizeClassObject::create()))
+            ++reused;
+    }
+    EXPECT_GE(reused, numberOfHoles / 2);
+}
+
 TEST(HeapTest, SimplePersistent)
 {
     Persistent<TraceCounter> traceCounter = TraceCounter::create();
@@ -2267,6 +2304,107 @@ TEST(HeapTest, WideTest)
     EXPECT_EQ(0u, Bar::s_live);
 }
 
+TEST(HeapTest, ParallelMarking)
+{
+    typedef HeapHashMap<Member<IntWrapper>, Member<IntWrapper>> StrongStrong;
+    typedef HeapHashMap<WeakMember<IntWrapper>, Member<IntWrapper>> WeakStrong;
+    const unsigned chains = 100;
+    const unsigned chainLength = 100;
+    const int mapSize = 1000;
+
+    RuntimeEnabledFeatures::setParallelGCMarkingEnabled(true);
+    clearOutOldGarbage();
+    IntWrapper::s_destructorCalls = 0;
+    Bar::s_live = 0;
+    {
+        // Long chains, so that the marking threads have to share work, and
+        // hash maps, so that they register weak tables and post-marking
+        // callbacks concurrently.
+        Persistent<HeapVector<Member<Foo>>> foos = new HeapVector<Member<Foo>>();
+        for (unsigned i = 0; i < chains; i++) {
+            Foo* foo = Foo::create(Bar::create());
+            for (unsigned j = 0; j < chainLength; j++)
+                foo = Foo::create(foo);
+            foos->append(foo);
+        }
+        Persistent<StrongStrong> strongStrong = new StrongStrong();
+        Persistent<WeakStrong> weakStrong = new WeakStrong();
+        for (int i = 0; i < mapSize; i++) {
+            IntWrapper* key = IntWrapper::create(i);
+            strongStrong->add(key, IntWrapper::create(i));
+            weakStrong->add(key, IntWrapper::create(-i));
+            weakStrong->add(IntWrapper::create(i), IntWrapper::create(-i));
+        }
+
+        preciselyCollectGarbage();
+        EXPECT_EQ(chains * (chainLength + 2), Bar::s_live);
+        EXPECT_EQ(mapSize, static_cast<int>(strongStrong->size()));
+        EXPECT_EQ(mapSize, static_cast<int>(weakStrong->size()));
+        // The entries with unreachable keys are gone, values included.
+        EXPECT_EQ(2 * mapSize, IntWrapper::s_destructorCalls);
+        for (const auto& entry : *weakStrong) {
+            EXPECT_TRUE(strongStrong->contains(entry.key));
+            EXPECT_EQ(-entry.key->value(), entry.value->value());
+        }
+    }
+    preciselyCollectGarbage();
+    EXPECT_EQ(0u, Bar::s_live);
+    EXPECT_EQ(5 * mapSize, IntWrapper::s_destructorCalls);
+    RuntimeEnabledFeatures::setParallelGCMarkingEnabled(false);
+}
+
+TEST(HeapTest, CompactVectorBackings)
+{
+    typedef HeapVector<Member<IntWrapper>> IntVector;
+    const int vectors = 1000;
+    const int vectorSize = 20;
+
+    HeapCompact::setForceCompactionForTesting(true);
+    clearOutOldGarbage();
+    {
+        // Interleave the backings of the kept vectors with three times as
+        // many that die, leaving the pages of the vector arenas mostly empty.
+        // The kept backings are referenced from inside another backing, which
+        // may move as well.
+        Persistent<HeapVector<IntVector>> kept = new HeapVector<IntVector>();
+        Persistent<HeapVector<IntVector>> garbage = new HeapVector<IntVector>();
+        for (int i = 0; i < vectors; ++i) {
+            kept->append(IntVector());
+            for (int j = 0; j < 3; ++j)
+                garbage->append(IntVector());
+            for (int k = 0; k < vectorSize; ++k) {
+                kept->last().append(IntWrapper::create(i * vectorSize + k));
+                for (int j = 1; j <= 3; ++j)
+                    garbage->at(garbage->size() - j).append(IntWrapper::create(-1));
+            }
+        }
+        Vector<const void*> backings;
+        for (const IntVector& vector : *kept)
+            backings.append(vector.data());
+
+        garbage.clear();
+        preciselyCollectGarbage();
+
+        int moved = 0;
+        for (int i = 0; i < vectors; ++i) {
+            if (kept->at(i).data() != backings[i])
+                ++moved;
+            ASSERT_EQ(static_cast<size_t>(vectorSize), kept->at(i).size());
+            for (int k = 0; k < vectorSize; ++k)
+                EXPECT_EQ(i * vectorSize + k, kept->at(i)[k]->value());
+        }
+        EXPECT_GT(moved, 0);
+
+        // The moved backings are ordinary objects again.
+        for (int i = 0; i < vectors; i += 2)
+            kept->at(i).clear();
+        preciselyCollectGarbage();
+        for (int i = 1; i < vectors; i += 2)
+            EXPECT_EQ(i * vectorSize, kept->at(i)[0]->value());
+    }
+    HeapCompact::setForceCompactionForTesting(false);
+}
+
 TEST(HeapTest, HashMapOfMembers)
 {
     ThreadHeap& heap = ThreadState::current()->heap();
@@ -28,6 +28,7 @@ public:
     using Impl::registerDelayedMarkNoTracing;
     using Impl::registerWeakTable;
     using Impl::registerWeakMembers;
+    using Impl::registerBackingStoreReference;
 #if ENABLE(ASSERT)
     using Impl::weakTableRegistered;
 #endif
@@ -57,6 +57,11 @@ public:
         return Impl::ensureMarked(objectPointer);
     }
 
+    void registerBackingStoreReference(void** slot) override
+    {
+        Impl::registerBackingStoreReference(slot);
+    }
+
 protected:
     void registerWeakCellWithCallback(void** cell, WeakCallback callback) override
     {
@@ -34,13 +34,14 @@ protected:
         if (header->isMarked())
             return;
 
-        ASSERT(ThreadState::current()->isInGC());
+        ASSERT(ThreadHeap::isInGCOrMarkingThread());
         ASSERT(toDerived()->getMarkingMode() != Visitor::WeakProcessing);
 
         // A GC should only mark the objects that belong in its heap.
         DCHECK(&pageFromObject(objectPointer)->arena()->getThreadState()->heap() == &toDerived()->heap());
 
-        header->mark();
+        if (!tryMarkHeader(header))
+            return;
 
         if (callback)
             toDerived()->heap().pushTraceCallback(const_cast<void*>(objectPointer), callback);
@@ -89,18 +90,37 @@ protected:
         if (!toDerived()->shouldMarkObject(objectPointer))
             return false;
 #if ENABLE(ASSERT)
-        if (HeapObjectHeader::fromPayload(objectPointer)->isMarked())
-            return false;
+        if (!toDerived()->heap().isMarkingInParallel()) {
+            if (HeapObjectHeader::fromPayload(objectPointer)->isMarked())
+                return false;
 
-        toDerived()->markNoTracing(objectPointer);
-#else
+            toDerived()->markNoTracing(objectPointer);
+            return true;
+        }
+#endif
         // Inline what the above markNoTracing() call expands to,
         // so as to make sure that we do get all the benefits.
-        HeapObjectHeader* header = HeapObjectHeader::fromPayload(objectPointer);
+        return tryMarkHeader(HeapObjectHeader::fromPayload(objectPointer));
+    }
+
+    inline void registerBackingStoreReference(void** slot)
+    {
+        if (toDerived()->getMarkingMode() != Visitor::GlobalMarking)
+            return;
+        HeapCompact* compaction = toDerived()->heap().compaction();
+        if (UNLIKELY(compaction->isCompacting()))
+            compaction->registerMovingObjectReference(slot);
+    }
+
+    // Sets the mark bit of |header|. Returns false if it was already set.
+    inline bool tryMarkHeader(HeapObjectHeader* header)
+    {
         if (header->isMarked())
             return false;
+        // Other threads may be racing to mark the same object.
+        if (UNLIKELY(toDerived()->heap().isMarkingInParallel()))
+            return header->atomicMark();
         header->mark();
-#endif
         return true;
     }
 
@@ -0,0 +1,187 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/heap/ParallelMarker.h"
+
+#include "base/sys_info.h"
+#include "platform/ThreadSafeFunctional.h"
+#include "platform/heap/Heap.h"
+#include "platform/heap/StackFrameDepth.h"
+#include "public/platform/Platform.h"
+#include "public/platform/WebTaskRunner.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/Atomics.h"
+#include <algorithm>
+
+namespace blink {
+
+namespace {
+
+// Beyond a handful of threads, the marking stack lock and the memory bandwidth
+// become the bottleneck.
+const size_t kMaxMarkingThreads = 3;
+
+} // namespace
+
+WTF::ThreadSpecific<MarkingDeque*>* ParallelMarker::s_currentDeque = nullptr;
+
+ParallelMarker::ParallelMarker(ThreadHeap* heap, size_t numberOfMarkingThreads)
+    : m_heap(heap)
+    , m_activeThreads(0)
+    , m_runningMarkingThreads(0)
+    , m_idleThreads(0)
+    , m_done(true)
+{
+    ASSERT(numberOfMarkingThreads);
+    m_deques.append(adoptPtr(new MarkingDeque));
+    for (size_t i = 0; i < numberOfMarkingThreads; ++i) {
+        m_threads.append(adoptPtr(Platform::current()->createThread("Blink GC marking thread")));
+        m_deques.append(adoptPtr(new MarkingDeque));
+    }
+}
+
+ParallelMarker::~ParallelMarker()
+{
+    ASSERT(m_done);
+    ASSERT(!m_runningMarkingThreads);
+}
+
+void ParallelMarker::init()
+{
+    ASSERT(!s_currentDeque);
+    s_currentDeque = new WTF::ThreadSpecific<MarkingDeque*>();
+}
+
+size_t ParallelMarker::numberOfMarkingThreads()
+{
+    if (ProcessHeap::isLowEndDevice())
+        return 0;
+    size_t processors = base::SysInfo::NumberOfProcessors();
+    if (processors <= 1)
+        return 0;
+    return std::min(processors - 1, kMaxMarkingThreads);
+}
+
+void ParallelMarker::processMarkingStack(Visitor* visitor)
+{
+    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(m_done);
+
+    // Eager tracing compares the stack pointer against the stack limit of the
+    // thread running the GC, which is meaningless on the marking threads.
+    // Push all objects onto the deques instead; that also leaves more work to
+    // share.
+    StackFrameDepth::disableStackLimit();
+
+    {
+        MutexLocker locker(m_mutex);
+        m_done = false;
+        m_activeThreads = 1;
+        m_runningMarkingThreads = m_threads.size();
+    }
+
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        m_threads[i]->getWebTaskRunner()->postTask(BLINK_FROM_HERE, threadSafeBind(&ParallelMarker::markingThreadMain, AllowCrossThreadAccess(this), AllowCrossThreadAccess(visitor), i + 1));
+
+    drain(visitor, m_deques[0].get());
+
+    {
+        // Marking threads that started late may still be about to find out
+        // that marking is done. Wait for them to let go of |visitor|.
+        MutexLocker locker(m_mutex);
+        while (m_runningMarkingThreads)
+            m_markingThreadsDone.wait(m_mutex);
+    }
+
+    StackFrameDepth::enableStackLimit();
+    ASSERT(m_heap->markingStack()->isEmpty());
+}
+
+void ParallelMarker::markingThreadMain(Visitor* visitor, size_t index)
+{
+    bool joined = false;
+    {
+        MutexLocker locker(m_mutex);
+        if (!m_done) {
+            ++m_activeThreads;
+            joined = true;
+        }
+    }
+    if (joined)
+        drain(visitor, m_deques[index].get());
+
+    MutexLocker locker(m_mutex);
+    if (!--m_runningMarkingThreads)
+        m_markingThreadsDone.signal();
+}
+
+void ParallelMarker::drain(Visitor* visitor, MarkingDeque* deque)
+{
+    ASSERT(deque->isEmpty());
+    **s_currentDeque = deque;
+
+    CallbackStack::Item item;
+    for (;;) {
+        while (deque->pop(&item)) {
+            item.call(visitor);
+            // Hand out work as soon as another thread runs dry, rather than
+            // waiting for this deque to overflow.
+            if (UNLIKELY(acquireLoad(&m_idleThreads)) && deque->size() > 1)
+                shareWork(deque);
+        }
+
+        MutexLocker locker(m_mutex);
+        if (takeWork(deque))
+            continue;
+
+        // The marking stack can only grow while some thread is active, so
+        // once the last active thread runs dry marking is done.
+        if (!--m_activeThreads) {
+            m_done = true;
+            m_workAvailable.broadcast();
+            break;
+        }
+
+        atomicIncrement(&m_idleThreads);
+        while (!m_done && m_heap->markingStack()->isEmpty())
+            m_workAvailable.wait(m_mutex);
+        atomicDecrement(&m_idleThreads);
+        if (m_done)
+            break;
+
+        ++m_activeThreads;
+        takeWork(deque);
+    }
+
+    **s_currentDeque = nullptr;
+}
+
+void ParallelMarker::shareWork(MarkingDeque* deque)
+{
+    MutexLocker locker(m_mutex);
+    CallbackStack* markingStack = m_heap->markingStack();
+    CallbackStack::Item item;
+    for (size_t count = deque->size() / 2; count && deque->popOldest(&item); --count)
+        *markingStack->allocateEntry() = item;
+    if (m_idleThreads)
+        m_workAvailable.broadcast();
+}
+
+bool ParallelMarker::takeWork(MarkingDeque* deque)
+{
+    ASSERT(deque->isEmpty());
+    CallbackStack* markingStack = m_heap->markingStack();
+    // Take no more than a fraction of the deque, to leave the rest of the
+    // marking stack to the other threads.
+    for (size_t count = 0; count < MarkingDeque::kCapacity / 4; ++count) {
+        CallbackStack::Item* item = markingStack->pop();
+        if (!item)
+            break;
+        deque->push(*item);
+    }
+    return !deque->isEmpty();
+}
+
+} // namespace blink
@@ -0,0 +1,159 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ParallelMarker_h
+#define ParallelMarker_h
+
+#include "platform/PlatformExport.h"
+#include "platform/heap/CallbackStack.h"
+#include "wtf/Allocator.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/ThreadSpecific.h"
+#include "wtf/ThreadingPrimitives.h"
+#include "wtf/Vector.h"
+#include <string.h>
+
+namespace blink {
+
+class ThreadHeap;
+class WebThread;
+
+// A bounded stack of trace callbacks that belongs to a single marking thread.
+// Only the owning thread pushes and pops, so no locking is needed. When the
+// deque overflows, or another thread runs out of work, its oldest entries are
+// moved to the shared marking stack of the heap.
+class MarkingDeque final {
+    USING_FAST_MALLOC(MarkingDeque);
+    WTF_MAKE_NONCOPYABLE(MarkingDeque);
+public:
+    MarkingDeque() : m_begin(0), m_end(0) { }
+
+    bool isEmpty() const { return m_begin == m_end; }
+    bool isFull() const { return size() == kCapacity; }
+    size_t size() const { return m_end - m_begin; }
+
+    void push(const CallbackStack::Item& item)
+    {
+        ASSERT(!isFull());
+        if (UNLIKELY(m_end == kCapacity)) {
+            memmove(m_items, m_items + m_begin, size() * sizeof(CallbackStack::Item));
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+        m_items[m_end++] = item;
+    }
+
+    // Pops the most recently pushed entry, so that each thread traces the
+    // object graph depth-first.
+    bool pop(CallbackStack::Item* item)
+    {
+        if (isEmpty())
+            return false;
+        *item = m_items[--m_end];
+        if (m_end == m_begin)
+            m_begin = m_end = 0;
+        return true;
+    }
+
+    // Pops the least recently pushed entry. These are the ones handed to
+    // other threads, as they tend to lead to the largest unvisited subgraphs.
+    bool popOldest(CallbackStack::Item* item)
+    {
+        if (isEmpty())
+            return false;
+        *item = m_items[m_begin++];
+        if (m_end == m_begin)
+            m_begin = m_end = 0;
+        return true;
+    }
+
+    static const size_t kCapacity = 512;
+
+private:
+    size_t m_begin;
+    size_t m_end;
+    CallbackStack::Item m_items[kCapacity];
+};
+
+// Computes the transitive closure of a heap's marking stack on several
+// threads: the thread running the GC plus a few marking threads owned by the
+// ParallelMarker. Each thread traces out of its own MarkingDeque and only
+// takes |m_mutex| to exchange entries with the heap's marking stack, which is
+// shared by all of them while marking is in progress.
+//
+// The marking threads are not attached to Oilpan. Trace methods run on them
+// exactly as they do on the GC thread, and all other threads stay parked at
+// their safe points until marking is done.
+class PLATFORM_EXPORT ParallelMarker final {
+    USING_FAST_MALLOC(ParallelMarker);
+    WTF_MAKE_NONCOPYABLE(ParallelMarker);
+public:
+    ParallelMarker(ThreadHeap*, size_t numberOfMarkingThreads);
+    ~ParallelMarker();
+
+    static void init();
+
+    // Returns how many marking threads should help the GC thread; 0 if
+    // parallel marking is not worth it on this device.
+    static size_t numberOfMarkingThreads();
+
+    // Returns true if the current thread is tracing objects for a parallel
+    // marking pass. This includes the thread running the GC.
+    static bool isMarkingThread() { return !!currentDeque(); }
+
+    // Traces everything reachable from the heap's marking stack, returning
+    // once the marking stack and every MarkingDeque are empty. Must be called
+    // on the thread running the GC.
+    void processMarkingStack(Visitor*);
+
+    // Called in place of pushing onto the heap's marking stack while
+    // processMarkingStack() is running.
+    void pushTraceCallback(void* object, TraceCallback callback)
+    {
+        MarkingDeque* deque = currentDeque();
+        ASSERT(deque);
+        if (UNLIKELY(deque->isFull()))
+            shareWork(deque);
+        deque->push(CallbackStack::Item(object, callback));
+    }
+
+private:
+    static MarkingDeque* currentDeque() { return **s_currentDeque; }
+
+    void markingThreadMain(Visitor*, size_t index);
+    void drain(Visitor*, MarkingDeque*);
+
+    // Moves the older half of |deque| to the heap's marking stack and wakes
+    // up the idle threads.
+    void shareWork(MarkingDeque*);
+
+    // Refills an empty |deque| from the heap's marking stack. Returns false
+    // if the marking stack is empty. |m_mutex| must be held.
+    bool takeWork(MarkingDeque*);
+
+    ThreadHeap* m_heap;
+    Vector<OwnPtr<WebThread>> m_threads;
+    // m_deques[0] belongs to the thread running the GC, m_deques[i] to
+    // m_threads[i - 1].
+    Vector<OwnPtr<MarkingDeque>> m_deques;
+
+    Mutex m_mutex;
+    ThreadCondition m_workAvailable;
+    ThreadCondition m_markingThreadsDone;
+    // Number of threads tracing or looking for work.
+    size_t m_activeThreads;
+    // Number of marking threads that have yet to return from a task.
+    size_t m_runningMarkingThreads;
+    // Number of threads waiting for work. Updated under |m_mutex|, but read
+    // without it by busy threads deciding whether to share their work.
+    int m_idleThreads;
+    bool m_done;
+
+    static WTF::ThreadSpecific<MarkingDeque*>* s_currentDeque;
+};
+
+} // namespace blink
+
+#endif // ParallelMarker_h
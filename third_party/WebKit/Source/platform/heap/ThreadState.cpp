@@ -1002,6 +1002,11 @@ void ThreadState::preSweep()
 
     threadLocalWeakProcessing();
 
+    // Moving objects is only safe once weak processing no longer needs their
+    // addresses, and before the pre-finalizers and the sweeper run.
+    if (m_heap->compaction()->isCompacting())
+        m_heap->compaction()->compact(this);
+
     GCState previousGCState = gcState();
     // We have to set the GCState to Sweeping before calling pre-finalizers
     // to disallow a GC during the pre-finalizers.
@@ -317,6 +317,11 @@ public:
 
     virtual bool ensureMarked(const void*) = 0;
 
+    // Collections call this with the location of their pointer to a backing
+    // store they just marked, and which they own exclusively. If the GC
+    // compacts, it may move the backing store and update the pointer.
+    virtual void registerBackingStoreReference(void** slot) { }
+
     inline MarkingMode getMarkingMode() const { return m_markingMode; }
 
 protected:
@@ -39,4 +39,9 @@ void WebImageCache::clear()
     ImageDecodingStore::instance().clear();
 }
 
+void WebImageCache::setCacheLimitInBytes(size_t cacheLimit)
+{
+    ImageDecodingStore::instance().setCacheLimitInBytes(cacheLimit);
+}
+
 }  // namespace blink
@@ -103,6 +103,12 @@ ALWAYS_INLINE void atomicSetOneToZero(int volatile* ptr)
     InterlockedExchange(reinterpret_cast<long volatile*>(ptr), 0);
 }
 
+// atomicFetchOr returns the value before the bitwise or.
+ALWAYS_INLINE unsigned atomicFetchOr(unsigned volatile* ptr, unsigned bits)
+{
+    return InterlockedOr(reinterpret_cast<long volatile*>(ptr), static_cast<long>(bits));
+}
+
 #else
 
 // atomicAdd returns the result of the addition.
@@ -132,6 +138,9 @@ ALWAYS_INLINE void atomicSetOneToZero(int volatile* ptr)
     ASSERT(*ptr == 1);
     __sync_lock_release(ptr);
 }
+
+// atomicFetchOr returns the value before the bitwise or.
+ALWAYS_INLINE unsigned atomicFetchOr(unsigned volatile* ptr, unsigned bits) { return __sync_fetch_and_or(ptr, bits); }
 #endif
 
 #if defined(THREAD_SANITIZER)
@@ -362,6 +371,7 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 using WTF::atomicTestAndSetToOne;
 using WTF::atomicSetOneToZero;
+using WTF::atomicFetchOr;
 using WTF::acquireLoad;
 using WTF::releaseStore;
 using WTF::noBarrierLoad;
@@ -31,6 +31,8 @@
 #include "wtf/PassRefPtr.h"
 #include "wtf/RefCounted.h"
 #include "wtf/Vector.h"
+#include "wtf/text/StringHash.h"
+#include "wtf/text/WTFString.h"
 #include <memory>
 
 namespace WTF {
@@ -353,6 +355,33 @@ struct MoveOnlyHash {
     static const bool safeToCompareToEmptyOrDeleted = true;
 };
 
+TEST(HashMapTest, MetadataGroups)
+{
+    using Map = HashMap<String, int, StringHash, MetadataGroupHashTraits<HashTraits<String>>>;
+    Map map;
+    for (int i = 0; i < 200; ++i)
+        EXPECT_TRUE(map.add(String::number(i), i).isNewEntry);
+    EXPECT_EQ(200u, map.size());
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(i, map.get(String::number(i)));
+    EXPECT_FALSE(map.contains("200"));
+
+    map.set("10", -10);
+    EXPECT_EQ(-10, map.get("10"));
+    EXPECT_EQ(-10, map.take("10"));
+    EXPECT_FALSE(map.contains("10"));
+    map.remove("11");
+    EXPECT_FALSE(map.contains("11"));
+    EXPECT_EQ(198u, map.size());
+    EXPECT_TRUE(map.add("10", 10).isNewEntry);
+    EXPECT_EQ(10, map.get("10"));
+
+    Map copy = map;
+    EXPECT_EQ(199u, copy.size());
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(i == 11 ? 0 : i, copy.get(String::number(i)));
+}
+
 } // anonymous namespace
 
 template <>
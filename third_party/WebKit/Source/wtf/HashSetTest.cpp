@@ -246,6 +246,59 @@ struct CountCopyHash : public PtrHash<const int*> {
     static const bool safeToCompareToEmptyOrDeleted = true;
 };
 
+// Puts all the keys at the start of the same group, so that lookups have to go
+// through the probe sequence.
+struct CollidingIntHash : IntHash<unsigned> {
+    static unsigned hash(int key) { return key << 16; }
+};
+
+template <typename Hash>
+void testMetadataGroups()
+{
+    HashSet<int, Hash, MetadataGroupHashTraits<HashTraits<int>>> set;
+    const int count = 1000;
+    for (int i = 1; i <= count; ++i)
+        EXPECT_TRUE(set.add(i).isNewEntry);
+    EXPECT_FALSE(set.add(1).isNewEntry);
+    EXPECT_EQ(static_cast<unsigned>(count), set.size());
+    for (int i = 1; i <= count; ++i)
+        EXPECT_TRUE(set.contains(i));
+    EXPECT_FALSE(set.contains(count + 1));
+
+    // Leave deleted buckets behind, and reuse some of them.
+    for (int i = 1; i <= count; i += 2)
+        set.remove(i);
+    EXPECT_EQ(static_cast<unsigned>(count / 2), set.size());
+    for (int i = 1; i <= count; ++i)
+        EXPECT_EQ(!(i % 2), set.contains(i));
+    for (int i = count + 1; i <= count + 100; ++i)
+        EXPECT_TRUE(set.add(i).isNewEntry);
+    for (int i = 2; i <= count; i += 2)
+        EXPECT_FALSE(set.add(i).isNewEntry);
+
+    unsigned found = 0;
+    for (int value : set) {
+        EXPECT_TRUE(!(value % 2) || value > count);
+        ++found;
+    }
+    EXPECT_EQ(set.size(), found);
+
+    // Shrink the table down to its minimum size.
+    for (int i = 1; i <= count + 100; ++i)
+        set.remove(i);
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_EQ(16u, set.capacity());
+    set.add(42);
+    EXPECT_TRUE(set.contains(42));
+    EXPECT_FALSE(set.contains(43));
+}
+
+TEST(HashSetTest, MetadataGroups)
+{
+    testMetadataGroups<IntHash<unsigned>>();
+    testMetadataGroups<CollidingIntHash>();
+}
+
 } // anonymous namespace
 
 template <>
@@ -23,10 +23,18 @@
 #include "wtf/Alignment.h"
 #include "wtf/Allocator.h"
 #include "wtf/Assertions.h"
+#include "wtf/CPU.h"
 #include "wtf/ConditionalDestructor.h"
 #include "wtf/HashTraits.h"
 #include "wtf/allocator/PartitionAllocator.h"
 
+#if CPU(X86) || CPU(X86_64)
+#include <emmintrin.h>
+#endif
+#if COMPILER(MSVC)
+#include <intrin.h>
+#endif
+
 #define DUMP_HASHTABLE_STATS 0
 #define DUMP_HASHTABLE_STATS_PER_TABLE 0
 
@@ -341,6 +349,83 @@ struct HashTableKeyChecker<HashTranslator, KeyTraits, true> {
     }
 };
 
+// The metadata of 16 consecutive buckets of a hash table whose key traits set
+// usesMetadataGroups. The table keeps a byte per bucket after the buckets: 0
+// for an empty bucket, 1 for a deleted one, and 7 bits of the hash of the key
+// with the top bit set for the others. A lookup loads the metadata of the 16
+// buckets starting at the bucket of the hash, compares the keys of the buckets
+// whose metadata matches, and moves on to the next group only if none of the
+// 16 buckets is empty. Most misses are then found without comparing a single
+// key, and clustered collisions cost one load instead of a probe each.
+class HashTableMetadataGroup {
+    STACK_ALLOCATED();
+public:
+    static const unsigned kSize = 16;
+    static const uint8_t kEmpty = 0;
+    static const uint8_t kDeleted = 1;
+
+    static uint8_t metadataForHash(unsigned hash)
+    {
+        // The low bits of the hash pick the bucket, so take the metadata from
+        // the top of a multiplicative hash, which depends on all of them.
+        return 0x80 | ((hash * 0x9E3779B1U) >> 25);
+    }
+
+    static unsigned countTrailingZeros(unsigned mask)
+    {
+        ASSERT(mask);
+#if COMPILER(MSVC)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    explicit HashTableMetadataGroup(const uint8_t* metadata)
+#if CPU(X86) || CPU(X86_64)
+        : m_metadata(_mm_loadu_si128(reinterpret_cast<const __m128i*>(metadata)))
+#else
+        : m_metadata(metadata)
+#endif
+    {
+    }
+
+    // Bit i of the following masks is set if bucket i of the group matches.
+    unsigned match(uint8_t metadata) const
+    {
+#if CPU(X86) || CPU(X86_64)
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(m_metadata, _mm_set1_epi8(metadata)));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < kSize; ++i)
+            mask |= (m_metadata[i] == metadata) << i;
+        return mask;
+#endif
+    }
+    unsigned matchEmpty() const { return match(kEmpty); }
+    unsigned matchEmptyOrDeleted() const
+    {
+        // Only the buckets holding a key have the top bit set.
+#if CPU(X86) || CPU(X86_64)
+        return ~_mm_movemask_epi8(m_metadata) & 0xFFFF;
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < kSize; ++i)
+            mask |= !(m_metadata[i] & 0x80) << i;
+        return mask;
+#endif
+    }
+
+private:
+#if CPU(X86) || CPU(X86_64)
+    __m128i m_metadata;
+#else
+    const uint8_t* m_metadata;
+#endif
+};
+
 // Note: empty or deleted key values are not allowed, using them may lead to
 // undefined behavior.  For pointer keys this means that null pointers are not
 // allowed unless you supply custom key traits.
@@ -514,6 +599,12 @@ private:
     LookupType lookupForWriting(const Key& key) { return lookupForWriting<IdentityTranslatorType>(key); }
     template <typename HashTranslator, typename T> FullLookupType fullLookupForWriting(const T&);
     template <typename HashTranslator, typename T> LookupType lookupForWriting(const T&);
+    template <typename HashTranslator, typename T> LookupType lookupInMetadataGroups(const T&, unsigned h) const;
+
+    // The metadata of the buckets, if KeyTraits::usesMetadataGroups.
+    static size_t metadataSize(unsigned tableSize) { return KeyTraits::usesMetadataGroups ? tableSize + HashTableMetadataGroup::kSize - 1 : 0; }
+    uint8_t* metadata() const { return reinterpret_cast<uint8_t*>(m_table + m_tableSize); }
+    void setMetadata(const ValueType* entry, uint8_t);
 
     void remove(ValueType*);
 
@@ -602,6 +693,9 @@ inline HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Alloca
 #endif
 {
     static_assert(Allocator::isGarbageCollected || (!IsPointerToGarbageCollectedType<Key>::value && !IsPointerToGarbageCollectedType<Value>::value), "Cannot put raw pointers to garbage-collected classes into an off-heap collection.");
+    // The heap reads the buckets of on-heap backings up to their end.
+    static_assert(!KeyTraits::usesMetadataGroups || !Allocator::isGarbageCollected, "Metadata groups are not supported by on-heap hash tables.");
+    static_assert(!KeyTraits::usesMetadataGroups || KeyTraits::minimumTableSize >= HashTableMetadataGroup::kSize, "Tables with metadata groups must have at least one group of buckets.");
 }
 
 inline unsigned doubleHash(unsigned key)
@@ -654,6 +748,10 @@ inline const Value* HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyT
     size_t k = 0;
     size_t sizeMask = tableSizeMask();
     unsigned h = HashTranslator::hash(key);
+    if (KeyTraits::usesMetadataGroups) {
+        LookupType result = lookupInMetadataGroups<HashTranslator>(key, h);
+        return result.second ? result.first : nullptr;
+    }
     size_t i = h & sizeMask;
 
     UPDATE_ACCESS_COUNTS();
@@ -693,6 +791,8 @@ inline typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTrait
     size_t k = 0;
     size_t sizeMask = tableSizeMask();
     unsigned h = HashTranslator::hash(key);
+    if (KeyTraits::usesMetadataGroups)
+        return lookupInMetadataGroups<HashTranslator>(key, h);
     size_t i = h & sizeMask;
 
     UPDATE_ACCESS_COUNTS();
@@ -736,6 +836,10 @@ inline typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTrait
     size_t k = 0;
     size_t sizeMask = tableSizeMask();
     unsigned h = HashTranslator::hash(key);
+    if (KeyTraits::usesMetadataGroups) {
+        LookupType result = lookupInMetadataGroups<HashTranslator>(key, h);
+        return makeLookupResult(result.first, result.second, h);
+    }
     size_t i = h & sizeMask;
 
     UPDATE_ACCESS_COUNTS();
@@ -767,6 +871,67 @@ inline typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTrait
     }
 }
 
+template <typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits, typename Allocator>
+template <typename HashTranslator, typename T>
+inline typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocator>::LookupType HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocator>::lookupInMetadataGroups(const T& key, unsigned h) const
+{
+    ASSERT(KeyTraits::usesMetadataGroups);
+    ASSERT(m_table);
+
+    ValueType* table = m_table;
+    const uint8_t* metadata = this->metadata();
+    size_t sizeMask = tableSizeMask();
+    size_t i = h & sizeMask;
+    uint8_t keyMetadata = HashTableMetadataGroup::metadataForHash(h);
+
+    UPDATE_ACCESS_COUNTS();
+
+    // The first empty or deleted bucket of the probe sequence, where the key
+    // would be added.
+    ValueType* availableEntry = nullptr;
+    size_t step = 0;
+
+    while (1) {
+        HashTableMetadataGroup group(metadata + i);
+        // Buckets with matching metadata hold a key, so comparing is safe even
+        // if !HashFunctions::safeToCompareToEmptyOrDeleted.
+        for (unsigned matches = group.match(keyMetadata); matches; matches &= matches - 1) {
+            ValueType* entry = table + ((i + HashTableMetadataGroup::countTrailingZeros(matches)) & sizeMask);
+            if (HashTranslator::equal(Extractor::extract(*entry), key))
+                return LookupType(entry, true);
+        }
+
+        if (!availableEntry) {
+            if (unsigned available = group.matchEmptyOrDeleted())
+                availableEntry = table + ((i + HashTableMetadataGroup::countTrailingZeros(available)) & sizeMask);
+        }
+        // Keys are added at the first available bucket, so none is past an
+        // empty one.
+        if (group.matchEmpty())
+            return LookupType(availableEntry, false);
+
+        UPDATE_PROBE_COUNTS();
+        // Steps growing by a group at a time visit all the groups of the
+        // table, which has a power of two size.
+        step += HashTableMetadataGroup::kSize;
+        i = (i + step) & sizeMask;
+    }
+}
+
+template <typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits, typename Allocator>
+inline void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocator>::setMetadata(const ValueType* entry, uint8_t value)
+{
+    ASSERT(KeyTraits::usesMetadataGroups);
+    unsigned index = entry - m_table;
+    ASSERT(index < m_tableSize);
+    uint8_t* metadata = this->metadata();
+    metadata[index] = value;
+    // The metadata of the first buckets is repeated after that of the last
+    // one, so that the group starting at any bucket can be loaded at once.
+    if (index < HashTableMetadataGroup::kSize - 1)
+        metadata[m_tableSize + index] = value;
+}
+
 template <bool emptyValueIsZero> struct HashTableBucketInitializer;
 
 template <> struct HashTableBucketInitializer<false> {
@@ -812,32 +977,41 @@ typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allo
     unsigned h = HashTranslator::hash(key);
     size_t i = h & sizeMask;
 
-    UPDATE_ACCESS_COUNTS();
-
     ValueType* deletedEntry = nullptr;
     ValueType* entry;
-    while (1) {
-        entry = table + i;
+    if (KeyTraits::usesMetadataGroups) {
+        LookupType result = lookupInMetadataGroups<HashTranslator>(key, h);
+        entry = result.first;
+        if (result.second)
+            return AddResult(this, entry, false);
+        if (isDeletedBucket(*entry))
+            deletedEntry = entry;
+    } else {
+        UPDATE_ACCESS_COUNTS();
 
-        if (isEmptyBucket(*entry))
-            break;
+        while (1) {
+            entry = table + i;
 
-        if (HashFunctions::safeToCompareToEmptyOrDeleted) {
-            if (HashTranslator::equal(Extractor::extract(*entry), key))
-                return AddResult(this, entry, false);
+            if (isEmptyBucket(*entry))
+                break;
 
-            if (isDeletedBucket(*entry))
-                deletedEntry = entry;
-        } else {
-            if (isDeletedBucket(*entry))
-                deletedEntry = entry;
-            else if (HashTranslator::equal(Extractor::extract(*entry), key))
-                return AddResult(this, entry, false);
+            if (HashFunctions::safeToCompareToEmptyOrDeleted) {
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return AddResult(this, entry, false);
+
+                if (isDeletedBucket(*entry))
+                    deletedEntry = entry;
+            } else {
+                if (isDeletedBucket(*entry))
+                    deletedEntry = entry;
+                else if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return AddResult(this, entry, false);
+            }
+            UPDATE_PROBE_COUNTS();
+            if (!k)
+                k = 1 | doubleHash(h);
+            i = (i + k) & sizeMask;
         }
-        UPDATE_PROBE_COUNTS();
-        if (!k)
-            k = 1 | doubleHash(h);
-        i = (i + k) & sizeMask;
     }
 
     registerModification();
@@ -852,6 +1026,8 @@ typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allo
 
     HashTranslator::translate(*entry, std::forward<T>(key), std::forward<Extra>(extra));
     ASSERT(!isEmptyOrDeletedBucket(*entry));
+    if (KeyTraits::usesMetadataGroups)
+        setMetadata(entry, HashTableMetadataGroup::metadataForHash(h));
 
     ++m_keyCount;
 
@@ -903,6 +1079,8 @@ typename HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allo
 
     HashTranslator::translate(*entry, std::forward<T>(key), std::forward<Extra>(extra), h);
     ASSERT(!isEmptyOrDeletedBucket(*entry));
+    if (KeyTraits::usesMetadataGroups)
+        setMetadata(entry, HashTableMetadataGroup::metadataForHash(h));
 
     ++m_keyCount;
     if (shouldExpand())
@@ -924,8 +1102,11 @@ Value* HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Alloca
 #if DUMP_HASHTABLE_STATS_PER_TABLE
     ++m_stats->numReinserts;
 #endif
-    Value* newEntry = lookupForWriting(Extractor::extract(entry)).first;
+    FullLookupType lookupResult = fullLookupForWriting<IdentityTranslatorType>(Extractor::extract(entry));
+    Value* newEntry = lookupResult.first.first;
     Mover<ValueType, Allocator, Traits::template NeedsToForbidGCOnMove<>::value>::move(std::move(entry), *newEntry);
+    if (KeyTraits::usesMetadataGroups)
+        setMetadata(newEntry, HashTableMetadataGroup::metadataForHash(lookupResult.second));
 
     return newEntry;
 }
@@ -978,6 +1159,8 @@ void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocato
 #if ENABLE(ASSERT)
     m_accessForbidden = false;
 #endif
+    if (KeyTraits::usesMetadataGroups)
+        setMetadata(pos, HashTableMetadataGroup::kDeleted);
     ++m_deletedCount;
     --m_keyCount;
 
@@ -1010,7 +1193,7 @@ inline void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, A
 template <typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits, typename Allocator>
 Value* HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocator>::allocateTable(unsigned size)
 {
-    size_t allocSize = size * sizeof(ValueType);
+    size_t allocSize = size * sizeof(ValueType) + metadataSize(size);
     ValueType* result;
     // Assert that we will not use memset on things with a vtable entry.  The
     // compiler will also check this on some platforms. We would like to check
@@ -1029,6 +1212,8 @@ Value* HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Alloca
         result = Allocator::template allocateHashTableBacking<ValueType, HashTable>(allocSize);
         for (unsigned i = 0; i < size; i++)
             initializeBucket(result[i]);
+        if (KeyTraits::usesMetadataGroups)
+            memset(result + size, HashTableMetadataGroup::kEmpty, metadataSize(size));
     }
     return result;
 }
@@ -61,6 +61,11 @@ template <typename T> struct GenericHashTraitsBase<false, T> {
     static const unsigned minimumTableSize = 8;
 #endif
 
+    // The usesMetadataGroups flag makes the hash table keep a byte of metadata
+    // per bucket after the buckets, which lookups scan 16 buckets at a time
+    // (see HashTableMetadataGroup). Only off-heap tables support it.
+    static const bool usesMetadataGroups = false;
+
     // When a hash table backing store is traced, its elements will be
     // traced if their class type has a trace method. However, weak-referenced
     // elements should not be traced then, but handled by the weak processing
@@ -332,6 +337,16 @@ struct KeyValuePairHashTraits : GenericHashTraits<KeyValuePair<typename KeyTrait
 template <typename Key, typename Value>
 struct HashTraits<KeyValuePair<Key, Value>> : public KeyValuePairHashTraits<HashTraits<Key>, HashTraits<Value>> { };
 
+// Opts large off-heap tables that are looked up on hot paths into metadata
+// groups. Using them as the key traits of a HashMap or the traits of a HashSet
+// makes lookups compare a byte of the hash of 16 buckets at once, and only
+// compare the keys whose byte matches.
+template <typename Traits>
+struct MetadataGroupHashTraits : Traits {
+    static const bool usesMetadataGroups = true;
+    static const unsigned minimumTableSize = 16;
+};
+
 template <typename T>
 struct NullableHashTraits : public HashTraits<T> {
     static const bool emptyValueIsZero = false;
@@ -351,6 +366,7 @@ struct TraceInCollectionTrait;
 } // namespace WTF
 
 using WTF::HashTraits;
+using WTF::MetadataGroupHashTraits;
 using WTF::PairHashTraits;
 using WTF::NullableHashTraits;
 using WTF::SimpleClassHashTraits;
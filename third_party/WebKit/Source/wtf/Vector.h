@@ -348,6 +348,7 @@ public:
 
     T* buffer() { return m_buffer; }
     const T* buffer() const { return m_buffer; }
+    T** bufferSlot() { return &m_buffer; }
     size_t capacity() const { return m_capacity; }
 
     void clearUnusedSlots(T* from, T* to)
@@ -465,6 +466,7 @@ public:
     using Base::allocationSize;
 
     using Base::buffer;
+    using Base::bufferSlot;
     using Base::capacity;
 
     using Base::clearUnusedSlots;
@@ -736,6 +738,7 @@ public:
     }
 
     using Base::buffer;
+    using Base::bufferSlot;
     using Base::capacity;
 
     bool hasOutOfLineBuffer() const
@@ -964,6 +967,7 @@ private:
 
     using Base::m_size;
     using Base::buffer;
+    using Base::bufferSlot;
     using Base::swapVectorBuffer;
     using Base::allocateBuffer;
     using Base::allocationSize;
@@ -1520,6 +1524,10 @@ void Vector<T, inlineCapacity, Allocator>::trace(VisitorDispatcher visitor)
         if (Allocator::isHeapObjectAlive(buffer()))
             return;
         Allocator::markNoTracing(visitor, buffer());
+        // The buffer may be moved by heap compaction if its elements can be
+        // moved with memcpy.
+        if (VectorTraits<T>::canMoveWithMemcpy)
+            Allocator::registerBackingStoreReference(visitor, reinterpret_cast<void**>(bufferSlot()));
     }
     const T* bufferBegin = buffer();
     const T* bufferEnd = buffer() + size();
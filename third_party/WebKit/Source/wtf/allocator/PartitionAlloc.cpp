@@ -36,6 +36,12 @@
 #include <stdio.h>
 #endif
 
+#if OS(WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 // Two partition pages are used as guard / metadata page so make sure the super
 // page size is bigger.
 static_assert(WTF::kPartitionPageSize * 4 <= WTF::kSuperPageSize, "ok super page size");
@@ -172,6 +178,7 @@ void partitionAllocGenericInit(PartitionRootGeneric* root)
     SpinLock::Guard guard(root->lock);
 
     partitionAllocBaseInit(root);
+    root->threadCacheEnabled = false;
 
     // Precalculate some shift and mask constants used in the hot path.
     // Example: malloc(41) == 101001 binary.
@@ -292,8 +299,13 @@ bool partitionAllocShutdown(PartitionRoot* root)
     return !foundLeak;
 }
 
+static void partitionThreadCacheDetach(PartitionRootGeneric*);
+
 bool partitionAllocGenericShutdown(PartitionRootGeneric* root)
 {
+    if (root->threadCacheEnabled)
+        partitionThreadCacheDetach(root);
+
     SpinLock::Guard guard(root->lock);
     bool foundLeak = false;
     size_t i;
@@ -1087,6 +1099,310 @@ void* partitionReallocGeneric(PartitionRootGeneric* root, void* ptr, size_t newS
 #endif
 }
 
+// The thread cache keeps, for each small bucket of a partition, a LIFO list of
+// slots that the thread freed or took from the partition in a batch. The slots
+// in the lists are allocated as far as their partition pages are concerned, so
+// only the thread owning the cache needs to access them, without locking.
+// Batches of slots go back to the partition when a list overflows, when the
+// cache is trimmed (periodically, see kThreadCacheTrimInterval), purged or
+// detached, and when the thread exits.
+//
+// In ENABLE(ASSERT) builds, the slots in a cache are filled with kFreedByte, and
+// get their cookies back when they leave the cache.
+
+// The lists of a bucket hold at most this many bytes and this many slots.
+static const size_t kThreadCacheMaxBytesPerBucket = 8192;
+static const uint32_t kThreadCacheMaxSlotsPerBucket = 64;
+// Every this many list overflows and refills, each list of a cache returns half
+// of its slots, so that the cache does not hang on to the sizes that the thread
+// stopped using.
+static const size_t kThreadCacheTrimInterval = 256;
+
+struct PartitionThreadCacheBucket {
+    PartitionFreelistEntry* head;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct PartitionThreadCache {
+    // The partition this cache was allocated from.
+    PartitionRootGeneric* owner;
+    PartitionRootGeneric* roots[kThreadCacheMaxRoots];
+    size_t slowPathsUntilTrim;
+    PartitionThreadCacheBucket buckets[kThreadCacheMaxRoots][kThreadCacheNumBuckets];
+};
+
+static_assert(sizeof(PartitionThreadCache) >= (1 << (kThreadCacheMaxOrder - 1)), "thread caches must not be allocated from a cached bucket");
+
+// Stored for the current thread once its cache is gone, so that the frees made
+// by the rest of the thread exit go straight to their partitions.
+static ALWAYS_INLINE PartitionThreadCache* partitionThreadCacheDestroyed()
+{
+    return reinterpret_cast<PartitionThreadCache*>(1);
+}
+
+static bool s_threadCacheKeyCreated = false;
+#if OS(WIN)
+static DWORD s_threadCacheKey;
+#else
+static pthread_key_t s_threadCacheKey;
+#endif
+
+static ALWAYS_INLINE PartitionThreadCache* partitionThreadCacheGet()
+{
+#if OS(WIN)
+    // free() must not clobber the last error code.
+    DWORD lastError = GetLastError();
+    void* cache = FlsGetValue(s_threadCacheKey);
+    SetLastError(lastError);
+    return static_cast<PartitionThreadCache*>(cache);
+#else
+    return static_cast<PartitionThreadCache*>(pthread_getspecific(s_threadCacheKey));
+#endif
+}
+
+static void partitionThreadCacheSet(PartitionThreadCache* cache)
+{
+#if OS(WIN)
+    FlsSetValue(s_threadCacheKey, cache);
+#else
+    pthread_setspecific(s_threadCacheKey, cache);
+#endif
+}
+
+// Returns |count| slots of |cacheBucket| to their partition, whose lock must
+// be held.
+static void partitionThreadCacheRelease(PartitionThreadCacheBucket* cacheBucket, size_t count)
+{
+    ASSERT(count <= cacheBucket->count);
+    while (count--) {
+        PartitionFreelistEntry* entry = cacheBucket->head;
+        cacheBucket->head = partitionFreelistMask(entry->next);
+        --cacheBucket->count;
+        PartitionPage* page = partitionPointerToPage(entry);
+#if ENABLE(ASSERT)
+        char* charEntry = reinterpret_cast<char*>(entry);
+        partitionCookieWriteValue(charEntry);
+        partitionCookieWriteValue(charEntry + page->bucket->slotSize - kCookieSize);
+#endif
+        partitionFreeWithPage(entry, page);
+    }
+}
+
+// Returns all the slots cached for |cache->roots[rootIndex]|, or just about
+// half of them if |trim| is set.
+static void partitionThreadCacheFlushRoot(PartitionThreadCache* cache, size_t rootIndex, bool trim)
+{
+    PartitionRootGeneric* root = cache->roots[rootIndex];
+    SpinLock::Guard guard(root->lock);
+    for (size_t i = 0; i < kThreadCacheNumBuckets; ++i) {
+        PartitionThreadCacheBucket* cacheBucket = &cache->buckets[rootIndex][i];
+        partitionThreadCacheRelease(cacheBucket, trim ? (cacheBucket->count + 1) / 2 : cacheBucket->count);
+    }
+}
+
+static void partitionThreadCacheSlowPathTaken(PartitionThreadCache* cache)
+{
+    if (--cache->slowPathsUntilTrim)
+        return;
+    cache->slowPathsUntilTrim = kThreadCacheTrimInterval;
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i])
+            partitionThreadCacheFlushRoot(cache, i, true);
+    }
+}
+
+#if OS(WIN)
+static void NTAPI partitionThreadCacheExit(void* data)
+#else
+static void partitionThreadCacheExit(void* data)
+#endif
+{
+    PartitionThreadCache* cache = static_cast<PartitionThreadCache*>(data);
+    partitionThreadCacheSet(partitionThreadCacheDestroyed());
+    if (cache == partitionThreadCacheDestroyed())
+        return;
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i])
+            partitionThreadCacheFlushRoot(cache, i, false);
+    }
+    partitionFreeGeneric(cache->owner, cache);
+}
+
+static NEVER_INLINE PartitionThreadCache* partitionThreadCacheCreate(PartitionRootGeneric* root)
+{
+    void* memory = partitionAllocGenericFlags(root, PartitionAllocReturnNull, sizeof(PartitionThreadCache), "PartitionThreadCache");
+    if (!memory)
+        return nullptr;
+    PartitionThreadCache* cache = static_cast<PartitionThreadCache*>(memory);
+    memset(cache, 0, sizeof(PartitionThreadCache));
+    cache->owner = root;
+    cache->slowPathsUntilTrim = kThreadCacheTrimInterval;
+    partitionThreadCacheSet(cache);
+    return cache;
+}
+
+// Returns the list of the current thread for |bucket| of |root|, or null if
+// the thread cannot cache the slots of |root|.
+static ALWAYS_INLINE PartitionThreadCacheBucket* partitionThreadCacheLookup(PartitionRootGeneric* root, const PartitionBucket* bucket, PartitionThreadCache** cacheOut)
+{
+    PartitionThreadCache* cache = partitionThreadCacheGet();
+    if (UNLIKELY(!cache)) {
+        cache = partitionThreadCacheCreate(root);
+        if (!cache)
+            return nullptr;
+    }
+    if (UNLIKELY(cache == partitionThreadCacheDestroyed()))
+        return nullptr;
+    *cacheOut = cache;
+
+    size_t bucketIndex = bucket - root->buckets;
+    ASSERT(bucketIndex < kThreadCacheNumBuckets);
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (LIKELY(cache->roots[i] == root))
+            return &cache->buckets[i][bucketIndex];
+    }
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i])
+            continue;
+        cache->roots[i] = root;
+        for (size_t j = 0; j < kThreadCacheNumBuckets; ++j) {
+            PartitionThreadCacheBucket* cacheBucket = &cache->buckets[i][j];
+            ASSERT(!cacheBucket->head && !cacheBucket->count);
+            size_t capacity = kThreadCacheMaxBytesPerBucket / root->buckets[j].slotSize;
+            cacheBucket->capacity = capacity < kThreadCacheMaxSlotsPerBucket ? capacity : kThreadCacheMaxSlotsPerBucket;
+        }
+        return &cache->buckets[i][bucketIndex];
+    }
+    return nullptr;
+}
+
+void partitionAllocGenericEnableThreadCache(PartitionRootGeneric* root)
+{
+    ASSERT(root->initialized);
+    {
+        SpinLock::Guard guard(PartitionRootBase::gInitializedLock);
+        if (!s_threadCacheKeyCreated) {
+#if OS(WIN)
+            s_threadCacheKey = FlsAlloc(partitionThreadCacheExit);
+            RELEASE_ASSERT(s_threadCacheKey != FLS_OUT_OF_INDEXES);
+#else
+            int error = pthread_key_create(&s_threadCacheKey, partitionThreadCacheExit);
+            RELEASE_ASSERT(!error);
+#endif
+            s_threadCacheKeyCreated = true;
+        }
+    }
+    root->threadCacheEnabled = true;
+}
+
+void* partitionThreadCacheAlloc(PartitionRootGeneric* root, int flags, PartitionBucket* bucket)
+{
+    PartitionThreadCache* cache;
+    PartitionThreadCacheBucket* cacheBucket = partitionThreadCacheLookup(root, bucket, &cache);
+    if (UNLIKELY(!cacheBucket)) {
+        SpinLock::Guard guard(root->lock);
+        return partitionBucketAlloc(root, flags, bucket->slotSize, bucket);
+    }
+
+    if (UNLIKELY(!cacheBucket->head)) {
+        partitionThreadCacheSlowPathTaken(cache);
+        // Only fill half of the list, to leave room for the frees that follow.
+        SpinLock::Guard guard(root->lock);
+        for (size_t i = 0; i < cacheBucket->capacity / 2; ++i) {
+            void* slot = partitionBucketAlloc(root, i ? PartitionAllocReturnNull : flags, bucket->slotSize, bucket);
+            if (!slot)
+                break;
+            PartitionFreelistEntry* entry = static_cast<PartitionFreelistEntry*>(partitionCookieFreePointerAdjust(slot));
+            entry->next = partitionFreelistMask(cacheBucket->head);
+            cacheBucket->head = entry;
+            ++cacheBucket->count;
+        }
+        if (!cacheBucket->head)
+            return nullptr;
+    }
+
+    PartitionFreelistEntry* entry = cacheBucket->head;
+    cacheBucket->head = partitionFreelistMask(entry->next);
+    --cacheBucket->count;
+#if ENABLE(ASSERT)
+    size_t noCookieSize = partitionCookieSizeAdjustSubtract(bucket->slotSize);
+    char* charRet = reinterpret_cast<char*>(entry);
+    memset(charRet + kCookieSize, kUninitializedByte, noCookieSize);
+    partitionCookieWriteValue(charRet);
+    partitionCookieWriteValue(charRet + kCookieSize + noCookieSize);
+    return charRet + kCookieSize;
+#else
+    return entry;
+#endif
+}
+
+void partitionThreadCacheFree(PartitionRootGeneric* root, void* ptr, PartitionPage* page)
+{
+    PartitionThreadCache* cache;
+    PartitionThreadCacheBucket* cacheBucket = partitionThreadCacheLookup(root, page->bucket, &cache);
+    if (UNLIKELY(!cacheBucket)) {
+        SpinLock::Guard guard(root->lock);
+        partitionFreeWithPage(ptr, page);
+        return;
+    }
+
+    // If these asserts fire, you probably corrupted memory.
+#if ENABLE(ASSERT)
+    size_t slotSize = page->bucket->slotSize;
+    partitionCookieCheckValue(ptr);
+    partitionCookieCheckValue(reinterpret_cast<char*>(ptr) + slotSize - kCookieSize);
+    memset(ptr, kFreedByte, slotSize);
+#endif
+    ASSERT(page->numAllocatedSlots);
+    SECURITY_CHECK(ptr != cacheBucket->head); // Catches an immediate double free.
+    PartitionFreelistEntry* entry = static_cast<PartitionFreelistEntry*>(ptr);
+    entry->next = partitionFreelistMask(cacheBucket->head);
+    cacheBucket->head = entry;
+    if (UNLIKELY(++cacheBucket->count > cacheBucket->capacity)) {
+        {
+            SpinLock::Guard guard(root->lock);
+            partitionThreadCacheRelease(cacheBucket, cacheBucket->count - cacheBucket->capacity / 2);
+        }
+        partitionThreadCacheSlowPathTaken(cache);
+    }
+}
+
+void partitionThreadCacheFlush(PartitionRootGeneric* root)
+{
+    if (!root->threadCacheEnabled)
+        return;
+    PartitionThreadCache* cache = partitionThreadCacheGet();
+    if (!cache || cache == partitionThreadCacheDestroyed())
+        return;
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i] == root)
+            partitionThreadCacheFlushRoot(cache, i, false);
+    }
+}
+
+static void partitionThreadCacheDetach(PartitionRootGeneric* root)
+{
+    PartitionThreadCache* cache = partitionThreadCacheGet();
+    if (!cache || cache == partitionThreadCacheDestroyed())
+        return;
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i] != root)
+            continue;
+        partitionThreadCacheFlushRoot(cache, i, false);
+        cache->roots[i] = nullptr;
+    }
+    if (cache->owner != root)
+        return;
+    // The cache itself lives in |root|, so it has to go as well.
+    for (size_t i = 0; i < kThreadCacheMaxRoots; ++i) {
+        if (cache->roots[i])
+            partitionThreadCacheFlushRoot(cache, i, false);
+    }
+    partitionThreadCacheSet(nullptr);
+    partitionFreeGeneric(root, cache);
+}
+
 static size_t partitionPurgePage(PartitionPage* page, bool discard)
 {
     const PartitionBucket* bucket = page->bucket;
@@ -1231,6 +1547,8 @@ void partitionPurgeMemory(PartitionRoot* root, int flags)
 
 void partitionPurgeMemoryGeneric(PartitionRootGeneric* root, int flags)
 {
+    partitionThreadCacheFlush(root);
+
     SpinLock::Guard guard(root->lock);
     if (flags & PartitionPurgeDecommitEmptyPages)
         partitionDecommitEmptyPages(root);
@@ -63,6 +63,8 @@
 // - Bucketing is by approximate size, for example an allocation of 4000 bytes
 // might be placed into a 4096-byte bucket. Bucket sizes are chosen to try and
 // keep worst-case waste to ~10%.
+// - Partitions may opt in to a per-thread cache of small slots, which lets most
+// small allocations and frees skip the partition lock.
 //
 // The allocators are designed to be extremely fast, thanks to the following
 // properties and design:
@@ -197,6 +199,13 @@ static const size_t kBitsPerSizet = sizeof(void*) * CHAR_BIT;
 // Constants for the memory reclaim logic.
 static const size_t kMaxFreeableSpans = 16;
 
+// Constants for the per-thread cache of partitionAllocGeneric(). Buckets of the
+// orders below kThreadCacheMaxOrder (i.e. slots smaller than 512 bytes) are
+// cached, for up to kThreadCacheMaxRoots partitions per thread.
+static const size_t kThreadCacheMaxOrder = 10;
+static const size_t kThreadCacheNumBuckets = (kThreadCacheMaxOrder - kGenericMinBucketedOrder) * kGenericNumBucketsPerOrder;
+static const size_t kThreadCacheMaxRoots = 4;
+
 // If the total size in bytes of allocated but not committed pages exceeds this
 // value (probably it is a "out of virtual address space" crash),
 // a special crash stack trace is generated at |partitionOutOfMemory|.
@@ -320,6 +329,10 @@ struct PartitionRoot : public PartitionRootBase {
 // Never instantiate a PartitionRootGeneric directly, instead use PartitionAllocatorGeneric.
 struct PartitionRootGeneric : public PartitionRootBase {
     SpinLock lock;
+    // If set, small slots freed by a thread are kept in a cache of that thread
+    // and handed out to its next allocations, without taking |lock|. Cached
+    // slots still count as allocated in the partition's pages and stats.
+    bool threadCacheEnabled;
     // Some pre-computed constants.
     size_t orderIndexShifts[kBitsPerSizet + 1];
     size_t orderSubIndexMasks[kBitsPerSizet + 1];
@@ -380,6 +393,9 @@ WTF_EXPORT void partitionAllocInit(PartitionRoot*, size_t numBuckets, size_t max
 WTF_EXPORT bool partitionAllocShutdown(PartitionRoot*);
 WTF_EXPORT void partitionAllocGenericInit(PartitionRootGeneric*);
 WTF_EXPORT bool partitionAllocGenericShutdown(PartitionRootGeneric*);
+// Must be called right after partitionAllocGenericInit(). A partition with a
+// thread cache must not be shut down while other threads still use it.
+WTF_EXPORT void partitionAllocGenericEnableThreadCache(PartitionRootGeneric*);
 
 enum PartitionPurgeFlags {
     // Decommitting the ring list of empty pages is reasonably fast.
@@ -397,6 +413,10 @@ WTF_EXPORT void partitionPurgeMemoryGeneric(PartitionRootGeneric*, int);
 WTF_EXPORT NEVER_INLINE void* partitionAllocSlowPath(PartitionRootBase*, int, size_t, PartitionBucket*);
 WTF_EXPORT NEVER_INLINE void partitionFreeSlowPath(PartitionPage*);
 WTF_EXPORT NEVER_INLINE void* partitionReallocGeneric(PartitionRootGeneric*, void*, size_t, const char* typeName);
+WTF_EXPORT void* partitionThreadCacheAlloc(PartitionRootGeneric*, int, PartitionBucket*);
+WTF_EXPORT void partitionThreadCacheFree(PartitionRootGeneric*, void*, PartitionPage*);
+// Returns the slots cached by the current thread to their partition.
+WTF_EXPORT void partitionThreadCacheFlush(PartitionRootGeneric*);
 
 WTF_EXPORT void partitionDumpStats(PartitionRoot*, const char* partitionName, bool isLightDump, PartitionStatsDumper*);
 WTF_EXPORT void partitionDumpStatsGeneric(PartitionRootGeneric*, const char* partitionName, bool isLightDump, PartitionStatsDumper*);
@@ -730,6 +750,14 @@ ALWAYS_INLINE PartitionBucket* partitionGenericSizeToBucket(PartitionRootGeneric
     return bucket;
 }
 
+ALWAYS_INLINE bool partitionBucketIsThreadCached(PartitionRootGeneric* root, const PartitionBucket* bucket)
+{
+    // The cached buckets come first in |root->buckets|. Direct mapped pages
+    // have their bucket outside of the array.
+    uintptr_t offset = reinterpret_cast<uintptr_t>(bucket) - reinterpret_cast<uintptr_t>(root->buckets);
+    return root->threadCacheEnabled && offset < kThreadCacheNumBuckets * sizeof(PartitionBucket);
+}
+
 ALWAYS_INLINE void* partitionAllocGenericFlags(PartitionRootGeneric* root, int flags, size_t size, const char* typeName)
 {
 #if defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
@@ -742,7 +770,9 @@ ALWAYS_INLINE void* partitionAllocGenericFlags(PartitionRootGeneric* root, int f
     size = partitionCookieSizeAdjustAdd(size);
     PartitionBucket* bucket = partitionGenericSizeToBucket(root, size);
     void* ret = nullptr;
-    {
+    if (partitionBucketIsThreadCached(root, bucket)) {
+        ret = partitionThreadCacheAlloc(root, flags, bucket);
+    } else {
         SpinLock::Guard guard(root->lock);
         // TODO(bashi): Remove following RELEAE_ASSERT()s once we find the cause of
         // http://crbug.com/514141
@@ -777,7 +807,9 @@ ALWAYS_INLINE void partitionFreeGeneric(PartitionRootGeneric* root, void* ptr)
     ptr = partitionCookieFreePointerAdjust(ptr);
     ASSERT(partitionPointerIsValid(ptr));
     PartitionPage* page = partitionPointerToPage(ptr);
-    {
+    if (partitionBucketIsThreadCached(root, page->bucket)) {
+        partitionThreadCacheFree(root, ptr, page);
+    } else {
         SpinLock::Guard guard(root->lock);
         partitionFreeWithPage(ptr, page);
     }
@@ -853,6 +885,7 @@ private:
 class PartitionAllocatorGeneric {
 public:
     void init() { partitionAllocGenericInit(&m_partitionRoot); }
+    void enableThreadCache() { partitionAllocGenericEnableThreadCache(&m_partitionRoot); }
     bool shutdown() { return partitionAllocGenericShutdown(&m_partitionRoot); }
     ALWAYS_INLINE PartitionRootGeneric* root() { return &m_partitionRoot; }
 private:
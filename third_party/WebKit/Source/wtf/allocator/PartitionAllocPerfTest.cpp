@@ -0,0 +1,93 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "wtf/allocator/PartitionAlloc.h"
+
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/Vector.h"
+
+#if !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+
+namespace WTF {
+
+namespace {
+
+const size_t kNumIterations = 1000000;
+const size_t kNumLiveObjects = 64;
+const size_t kMultipleThreads = 4;
+
+PartitionAllocatorGeneric genericAllocator;
+
+// Replaces the objects of a small working set with new ones of various small
+// sizes, which is what most of the malloc traffic of a renderer looks like.
+void allocateAndFree(PartitionRootGeneric* root)
+{
+    void* objects[kNumLiveObjects] = { };
+    for (size_t i = 0; i < kNumIterations; ++i) {
+        size_t index = (i * 7) % kNumLiveObjects;
+        partitionFreeGeneric(root, objects[index]);
+        objects[index] = partitionAllocGeneric(root, 16 + (i % 16) * 16, nullptr);
+    }
+    for (size_t i = 0; i < kNumLiveObjects; ++i)
+        partitionFreeGeneric(root, objects[i]);
+}
+
+class AllocatingThread final : public base::SimpleThread {
+public:
+    explicit AllocatingThread(PartitionRootGeneric* root)
+        : base::SimpleThread("PartitionAllocPerfTest")
+        , m_root(root)
+    {
+    }
+
+    void Run() override { allocateAndFree(m_root); }
+
+private:
+    PartitionRootGeneric* m_root;
+};
+
+void runTest(const char* trace, size_t numThreads, bool threadCache)
+{
+    genericAllocator.init();
+    if (threadCache)
+        genericAllocator.enableThreadCache();
+
+    Vector<OwnPtr<AllocatingThread>> threads;
+    for (size_t i = 0; i < numThreads; ++i)
+        threads.append(adoptPtr(new AllocatingThread(genericAllocator.root())));
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (auto& thread : threads)
+        thread->Start();
+    // The threads return their cached slots as they exit.
+    for (auto& thread : threads)
+        thread->Join();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    EXPECT_TRUE(genericAllocator.shutdown());
+    double nanoseconds = static_cast<double>(elapsed.InMicroseconds() * base::Time::kNanosecondsPerMicrosecond);
+    perf_test::PrintResult("partition_alloc_generic", threadCache ? "_thread_cache" : "", trace, nanoseconds / (numThreads * kNumIterations), "ns/alloc_and_free", true);
+}
+
+} // anonymous namespace
+
+TEST(PartitionAllocPerfTest, SingleThread)
+{
+    runTest("single_thread", 1, false);
+    runTest("single_thread", 1, true);
+}
+
+TEST(PartitionAllocPerfTest, MultipleThreads)
+{
+    runTest("multiple_threads", kMultipleThreads, false);
+    runTest("multiple_threads", kMultipleThreads, true);
+}
+
+} // namespace WTF
+
+#endif // !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
@@ -1937,6 +1937,55 @@ TEST(PartitionAllocTest, PurgeDiscardable)
     TestShutdown();
 }
 
+// Tests the per-thread cache of small generic allocations.
+TEST(PartitionAllocTest, GenericThreadCache)
+{
+    TestSetup();
+    genericAllocator.enableThreadCache();
+    PartitionRootGeneric* root = genericAllocator.root();
+
+    size_t size = 64 - kExtraAllocSize;
+    void* ptr1 = partitionAllocGeneric(root, size, typeName);
+    PartitionPage* page = partitionPointerToPage(partitionCookieFreePointerAdjust(ptr1));
+    // The cache took a batch of slots from the partition.
+    int numAllocatedSlots = page->numAllocatedSlots;
+    EXPECT_LT(1, numAllocatedSlots);
+
+    // A freed slot stays in the cache and is handed out again first.
+    partitionFreeGeneric(root, ptr1);
+    EXPECT_EQ(numAllocatedSlots, page->numAllocatedSlots);
+    void* ptr2 = partitionAllocGeneric(root, size, typeName);
+    EXPECT_EQ(ptr1, ptr2);
+    EXPECT_EQ(numAllocatedSlots, page->numAllocatedSlots);
+    partitionFreeGeneric(root, ptr2);
+
+    // Purging returns the cached slots to the partition.
+    partitionPurgeMemoryGeneric(root, PartitionPurgeDecommitEmptyPages);
+    EXPECT_EQ(0, page->numAllocatedSlots);
+
+    // So does a cache that overflows.
+    const size_t kNumPointers = 200;
+    void* ptrs[kNumPointers];
+    for (size_t i = 0; i < kNumPointers; ++i)
+        ptrs[i] = partitionAllocGeneric(root, size, typeName);
+    page = partitionPointerToPage(partitionCookieFreePointerAdjust(ptrs[0]));
+    EXPECT_LE(static_cast<int>(kNumPointers), page->numAllocatedSlots);
+    for (size_t i = 0; i < kNumPointers; ++i)
+        partitionFreeGeneric(root, ptrs[i]);
+    EXPECT_GT(static_cast<int>(kNumPointers / 2), page->numAllocatedSlots);
+
+    // Larger allocations bypass the cache.
+    size = 1024 - kExtraAllocSize;
+    ptr1 = partitionAllocGeneric(root, size, typeName);
+    page = partitionPointerToPage(partitionCookieFreePointerAdjust(ptr1));
+    EXPECT_EQ(1, page->numAllocatedSlots);
+    partitionFreeGeneric(root, ptr1);
+    EXPECT_EQ(0, page->numAllocatedSlots);
+
+    // Shutting down returns the cached slots and the cache itself.
+    TestShutdown();
+}
+
 // Tests that the countLeadingZeros() functions work to our satisfaction.
 // It doesn't seem worth the overhead of a whole new file for these tests, so
 // we'll put them here since partitionAllocGeneric will depend heavily on these
@@ -52,7 +52,9 @@ void Partitions::initialize(ReportPartitionAllocSizeFunction reportSizeFunction)
     if (!s_initialized) {
         partitionAllocGlobalInit(&Partitions::handleOutOfMemory);
         m_fastMallocAllocator.init();
+        m_fastMallocAllocator.enableThreadCache();
         m_bufferAllocator.init();
+        m_bufferAllocator.enableThreadCache();
         m_layoutAllocator.init();
         m_reportSizeFunction = reportSizeFunction;
         s_initialized = true;
@@ -22,13 +22,14 @@
 #ifndef ASCIIFastPath_h
 #define ASCIIFastPath_h
 
+#include "wtf/ASCIICType.h"
 #include "wtf/Alignment.h"
 #include "wtf/CPU.h"
 #include "wtf/StdLibExtras.h"
 #include "wtf/text/Unicode.h"
 #include <stdint.h>
 
-#if OS(MACOSX) && (CPU(X86) || CPU(X86_64))
+#if CPU(X86) || CPU(X86_64)
 #include <emmintrin.h>
 #endif
 
@@ -102,6 +103,77 @@ inline bool charactersAreAllASCII(const CharacterType* characters, size_t length
     return !(allCharBits & nonASCIIBitMask);
 }
 
+#if CPU(X86) || CPU(X86_64)
+// Sets all bits of the bytes of |chunk| that are ASCII upper case letters.
+// Non-ASCII bytes are negative as signed chars, so they never match.
+inline __m128i asciiUpperMask(__m128i chunk)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('Z' + 1)));
+}
+
+// Lowers the ASCII upper case letters of 16 Latin-1 characters.
+inline __m128i toASCIILowerChunk(__m128i chunk)
+{
+    return _mm_or_si128(chunk, _mm_and_si128(asciiUpperMask(chunk), _mm_set1_epi8(0x20)));
+}
+#endif
+
+// Returns the index of the first ASCII upper case letter, or |length| if there
+// is none.
+inline size_t findASCIIUpper(const LChar* characters, size_t length)
+{
+    size_t i = 0;
+#if CPU(X86) || CPU(X86_64)
+    // Skip the blocks of 16 characters without any, and find the exact index
+    // in the remaining characters.
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + i));
+        if (_mm_movemask_epi8(asciiUpperMask(chunk)))
+            break;
+    }
+#endif
+    for (; i < length; ++i) {
+        if (isASCIIUpper(characters[i]))
+            return i;
+    }
+    return length;
+}
+
+// Returns the index of the first ASCII upper case letter or non-ASCII
+// character, or |length| if there is none.
+inline size_t findASCIIUpperOrNonASCII(const LChar* characters, size_t length)
+{
+    size_t i = 0;
+#if CPU(X86) || CPU(X86_64)
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + i));
+        // The top bit of a byte is set if it is upper case or non-ASCII.
+        if (_mm_movemask_epi8(_mm_or_si128(asciiUpperMask(chunk), chunk)))
+            break;
+    }
+#endif
+    for (; i < length; ++i) {
+        if (isASCIIUpper(characters[i]) || characters[i] & ~0x7F)
+            return i;
+    }
+    return length;
+}
+
+// Copies |source| to |destination| lowering the ASCII upper case letters.
+// Other characters are copied as is.
+inline void lowerASCII(LChar* destination, const LChar* source, size_t length)
+{
+    size_t i = 0;
+#if CPU(X86) || CPU(X86_64)
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), toASCIILowerChunk(chunk));
+    }
+#endif
+    for (; i < length; ++i)
+        destination[i] = toASCIILower(source[i]);
+}
+
 inline void copyLCharsFromUCharSource(LChar* destination, const UChar* source, size_t length)
 {
 #if OS(MACOSX) && (CPU(X86) || CPU(X86_64))
@@ -23,6 +23,7 @@
 #include "wtf/text/AtomicString.h"
 
 #include "wtf/HashSet.h"
+#include "wtf/SpinLock.h"
 #include "wtf/WTFThreadData.h"
 #include "wtf/dtoa.h"
 #include "wtf/text/IntegerToStringConversion.h"
@@ -35,6 +36,75 @@ using namespace Unicode;
 
 static_assert(sizeof(AtomicString) == sizeof(String), "AtomicString and String must be same size");
 
+namespace {
+
+// The strings shared by all threads, see AtomicString::findOrAddShared(). The
+// table is split by hash into stripes of slots that are filled by linear
+// probing. Lookups read the slots without locking, inserts take the lock of
+// their stripe. Strings are never removed, and each stripe is only filled
+// half way so that probing stays short.
+const unsigned kSharedStringStripes = 16;
+const unsigned kSharedStringSlotsPerStripe = 128;
+const unsigned kMaxSharedStringsPerStripe = kSharedStringSlotsPerStripe / 2;
+const unsigned kMaxSharedStringLength = 64;
+
+struct SharedStringStripe {
+    SpinLock lock;
+    unsigned size;
+    std::atomic<StringImpl*> slots[kSharedStringSlotsPerStripe];
+};
+
+SharedStringStripe s_sharedStrings[kSharedStringStripes];
+
+template<typename CharacterType>
+StringImpl* findSharedString(const CharacterType* characters, unsigned length, unsigned hash)
+{
+    if (length > kMaxSharedStringLength)
+        return nullptr;
+    SharedStringStripe& stripe = s_sharedStrings[hash % kSharedStringStripes];
+    for (unsigned index = hash / kSharedStringStripes; ; ++index) {
+        StringImpl* string = stripe.slots[index % kSharedStringSlotsPerStripe].load(std::memory_order_acquire);
+        if (!string)
+            return nullptr;
+        if (string->existingHash() == hash && equal(string, characters, length))
+            return string;
+    }
+}
+
+StringImpl* findSharedString(const StringImpl* string)
+{
+    if (string->is8Bit())
+        return findSharedString(string->characters8(), string->length(), string->hash());
+    return findSharedString(string->characters16(), string->length(), string->hash());
+}
+
+StringImpl* addSharedString(const LChar* characters, unsigned length, unsigned hash)
+{
+    ASSERT(length && length <= kMaxSharedStringLength);
+    SharedStringStripe& stripe = s_sharedStrings[hash % kSharedStringStripes];
+    SpinLock::Guard guard(stripe.lock);
+    unsigned index = hash / kSharedStringStripes;
+    for (; ; ++index) {
+        StringImpl* string = stripe.slots[index % kSharedStringSlotsPerStripe].load(std::memory_order_relaxed);
+        if (!string)
+            break;
+        if (string->existingHash() == hash && equal(string, characters, length))
+            return string;
+    }
+    if (stripe.size == kMaxSharedStringsPerStripe)
+        return nullptr;
+    StringImpl* string = StringImpl::createShared(characters, length, hash);
+    stripe.slots[index % kSharedStringSlotsPerStripe].store(string, std::memory_order_release);
+    ++stripe.size;
+    return string;
+}
+
+} // namespace
+
+// Every AtomicString created from characters or a String is looked up here, and
+// most of the lookups from the parsers find nothing new.
+typedef HashSet<StringImpl*, StringHash, MetadataGroupHashTraits<HashTraits<StringImpl*>>> AtomicStringSet;
+
 class AtomicStringTable {
     USING_FAST_MALLOC(AtomicStringTable);
     WTF_MAKE_NONCOPYABLE(AtomicStringTable);
@@ -52,16 +122,31 @@ public:
         if (!string->length())
             return StringImpl::empty();
 
-        StringImpl* result = *m_table.add(string).storedValue;
+        AtomicStringSet::AddResult addResult = m_table.add(string);
+        StringImpl* result = *addResult.storedValue;
+
+        if (addResult.isNewEntry && !string->isStatic()) {
+            // Use the shared string instead, if there is one, so that strings
+            // from other threads are found in this table as they are.
+            if (StringImpl* sharedString = findSharedString(string)) {
+                *addResult.storedValue = sharedString;
+                return sharedString;
+            }
+        }
 
-        if (!result->isAtomic())
+        // Static strings are used by all threads and can't be written to,
+        // except for the ones from allStaticStrings(), see addStaticStrings().
+        if (!result->isAtomic() && !result->isStatic())
             result->setIsAtomic(true);
 
-        ASSERT(!string->isStatic() || result->isStatic());
+        // A thread may have had its own copy of a shared string before the
+        // string was shared, but the strings from allStaticStrings() are in
+        // the table from the start.
+        ASSERT(!string->isStatic() || !string->isAtomic() || result == string);
         return result;
     }
 
-    HashSet<StringImpl*>& table()
+    AtomicStringSet& table()
     {
         return m_table;
     }
@@ -76,13 +161,14 @@ private:
         StaticStringsTable::const_iterator it = staticStrings.begin();
         for (; it != staticStrings.end(); ++it) {
             addStringImpl(it->value);
+            it->value->setIsAtomic(true);
         }
     }
 
     static void destroy(AtomicStringTable* table)
     {
-        HashSet<StringImpl*>::iterator end = table->m_table.end();
-        for (HashSet<StringImpl*>::iterator iter = table->m_table.begin(); iter != end; ++iter) {
+        AtomicStringSet::iterator end = table->m_table.end();
+        for (AtomicStringSet::iterator iter = table->m_table.begin(); iter != end; ++iter) {
             StringImpl* string = *iter;
             if (!string->isStatic()) {
                 ASSERT(string->isAtomic());
@@ -92,7 +178,7 @@ private:
         delete table;
     }
 
-    HashSet<StringImpl*> m_table;
+    AtomicStringSet m_table;
 };
 
 static inline AtomicStringTable& getAtomicStringTable()
@@ -105,7 +191,7 @@ static inline AtomicStringTable& getAtomicStringTable()
     return *table;
 }
 
-static inline HashSet<StringImpl*>& atomicStrings()
+static inline AtomicStringSet& atomicStrings()
 {
     return getAtomicStringTable().table();
 }
@@ -118,13 +204,27 @@ void AtomicString::reserveTableCapacity(size_t size)
 template<typename T, typename HashTranslator>
 static inline PassRefPtr<StringImpl> addToStringTable(const T& value)
 {
-    HashSet<StringImpl*>::AddResult addResult = atomicStrings().addWithTranslator<HashTranslator>(value);
+    AtomicStringSet::AddResult addResult = atomicStrings().addWithTranslator<HashTranslator>(value);
 
     // If the string is newly-translated, then we need to adopt it.
     // The boolean in the pair tells us if that is so.
     return addResult.isNewEntry ? adoptRef(*addResult.storedValue) : *addResult.storedValue;
 }
 
+// Used by the translators below, so that the table of a thread gets the
+// shared string rather than a copy of its own.
+template<typename CharacterType>
+static inline bool translateToSharedString(StringImpl*& location, const CharacterType* characters, unsigned length, unsigned hash)
+{
+    StringImpl* string = findSharedString(characters, length, hash);
+    if (!string)
+        return false;
+    // Balanced by the adoptRef() in addToStringTable().
+    string->ref();
+    location = string;
+    return true;
+}
+
 template<typename CharacterType>
 struct HashTranslatorCharBuffer {
     const CharacterType* s;
@@ -145,6 +245,8 @@ struct UCharBufferTranslator {
 
     static void translate(StringImpl*& location, const UCharBuffer& buf, unsigned hash)
     {
+        if (translateToSharedString(location, buf.s, buf.length, hash))
+            return;
         location = StringImpl::create8BitIfPossible(buf.s, buf.length).leakRef();
         location->setHash(hash);
         location->setIsAtomic(true);
@@ -173,6 +275,8 @@ struct HashAndCharactersTranslator {
 
     static void translate(StringImpl*& location, const HashAndCharacters<CharacterType>& buffer, unsigned hash)
     {
+        if (translateToSharedString(location, buffer.characters, buffer.length, hash))
+            return;
         location = StringImpl::create(buffer.characters, buffer.length).leakRef();
         location->setHash(hash);
         location->setIsAtomic(true);
@@ -351,6 +455,8 @@ struct LCharBufferTranslator {
 
     static void translate(StringImpl*& location, const LCharBuffer& buf, unsigned hash)
     {
+        if (translateToSharedString(location, buf.s, buf.length, hash))
+            return;
         location = StringImpl::create(buf.s, buf.length).leakRef();
         location->setHash(hash);
         location->setIsAtomic(true);
@@ -375,12 +481,35 @@ PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* string)
 }
 
 template<typename CharacterType>
-static inline HashSet<StringImpl*>::iterator findString(const StringImpl* stringImpl)
+static inline AtomicStringSet::iterator findString(const StringImpl* stringImpl)
 {
     HashAndCharacters<CharacterType> buffer = { stringImpl->existingHash(), stringImpl->getCharacters<CharacterType>(), stringImpl->length() };
     return atomicStrings().find<HashAndCharactersTranslator<CharacterType>>(buffer);
 }
 
+StringImpl* AtomicString::findOrAddShared(StringImpl* string)
+{
+    ASSERT(string);
+    if (string->isStatic())
+        return string;
+    unsigned length = string->length();
+    if (!length || length > kMaxSharedStringLength)
+        return nullptr;
+    if (StringImpl* sharedString = findSharedString(string))
+        return sharedString;
+
+    if (string->is8Bit())
+        return addSharedString(string->characters8(), length, string->hash());
+    LChar characters[kMaxSharedStringLength];
+    for (unsigned i = 0; i < length; ++i) {
+        UChar character = string->characters16()[i];
+        if (character > 0xFF)
+            return nullptr;
+        characters[i] = static_cast<LChar>(character);
+    }
+    return addSharedString(characters, length, string->hash());
+}
+
 StringImpl* AtomicString::find(const StringImpl* stringImpl)
 {
     ASSERT(stringImpl);
@@ -389,7 +518,7 @@ StringImpl* AtomicString::find(const StringImpl* stringImpl)
     if (!stringImpl->length())
         return StringImpl::empty();
 
-    HashSet<StringImpl*>::iterator iterator;
+    AtomicStringSet::iterator iterator;
     if (stringImpl->is8Bit())
         iterator = findString<LChar>(stringImpl);
     else
@@ -401,7 +530,7 @@ StringImpl* AtomicString::find(const StringImpl* stringImpl)
 
 void AtomicString::remove(StringImpl* r)
 {
-    HashSet<StringImpl*>::iterator iterator;
+    AtomicStringSet::iterator iterator;
     if (r->is8Bit())
         iterator = findString<LChar>(r);
     else
@@ -66,6 +66,15 @@ public:
 
     static StringImpl* find(const StringImpl*);
 
+    // Returns the string with the characters of |string| from a table shared
+    // by all threads, adding it if there is room. Shared strings are static,
+    // so they can be sent to other threads, where they become AtomicStrings
+    // without copying or hashing the characters again. The table only holds
+    // a limited number of short Latin-1 strings and never shrinks, so it is
+    // meant for names, such as those of tags and attributes, rather than for
+    // arbitrary text. Returns null if the string cannot be shared.
+    static StringImpl* findOrAddShared(StringImpl*);
+
     operator const String&() const { return m_string; }
     const String& getString() const { return m_string; }
 
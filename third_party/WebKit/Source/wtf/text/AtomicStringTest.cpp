@@ -76,4 +76,30 @@ TEST(AtomicStringTest, ImplEquality)
     EXPECT_NE(bar.impl(), baz.impl());
 }
 
+TEST(AtomicStringTest, Shared)
+{
+    String name("shared-name");
+    StringImpl* shared = AtomicString::findOrAddShared(name.impl());
+    ASSERT_TRUE(shared);
+    EXPECT_TRUE(shared->isStatic());
+    EXPECT_NE(name.impl(), shared);
+    EXPECT_EQ(name, String(shared));
+    EXPECT_EQ(shared, AtomicString::findOrAddShared(String("shared-name").impl()));
+
+    // AtomicStrings of a thread use the shared string unless the thread had
+    // one of its own already.
+    EXPECT_EQ(shared, AtomicString(name).impl());
+    EXPECT_EQ(shared, AtomicString("shared-name").impl());
+    AtomicString local("local-name");
+    StringImpl* sharedLocal = AtomicString::findOrAddShared(String("local-name").impl());
+    ASSERT_TRUE(sharedLocal);
+    EXPECT_EQ(local.impl(), AtomicString(String(sharedLocal)).impl());
+
+    const UChar nonLatin1[] = { 'a', 0x3042 };
+    EXPECT_FALSE(AtomicString::findOrAddShared(String(nonLatin1, WTF_ARRAY_LENGTH(nonLatin1)).impl()));
+    const UChar latin1[] = { 'a', 0xE9 };
+    EXPECT_TRUE(AtomicString::findOrAddShared(String(latin1, WTF_ARRAY_LENGTH(latin1)).impl()));
+    EXPECT_FALSE(AtomicString::findOrAddShared(String(Vector<UChar>(100, 'a')).impl()));
+}
+
 } // namespace WTF
@@ -31,6 +31,7 @@
 #include "wtf/StdLibExtras.h"
 #include "wtf/allocator/PartitionAlloc.h"
 #include "wtf/allocator/Partitions.h"
+#include "wtf/text/ASCIIFastPath.h"
 #include "wtf/text/AtomicString.h"
 #include "wtf/text/CharacterNames.h"
 #include "wtf/text/StringBuffer.h"
@@ -355,6 +356,20 @@ StringImpl* StringImpl::createStatic(const char* string, unsigned length, unsign
         return it->value;
     }
 
+    StringImpl* impl = createShared(reinterpret_cast<const LChar*>(string), length, hash);
+
+    ASSERT(isMainThread());
+    m_highestStaticStringLength = std::max(m_highestStaticStringLength, length);
+    staticStrings().add(hash, impl);
+
+    return impl;
+}
+
+StringImpl* StringImpl::createShared(const LChar* string, unsigned length, unsigned hash)
+{
+    ASSERT(string);
+    ASSERT(length);
+
     // Allocate a single buffer large enough to contain the StringImpl
     // struct as well as the data which it contains. This removes one
     // heap allocation from this call.
@@ -371,11 +386,8 @@ StringImpl* StringImpl::createStatic(const char* string, unsigned length, unsign
     impl->assertHashIsCorrect();
 #endif
 
-    ASSERT(isMainThread());
-    m_highestStaticStringLength = std::max(m_highestStaticStringLength, length);
-    staticStrings().add(hash, impl);
     WTF_ANNOTATE_BENIGN_RACE(impl,
-        "Benign race on the reference counter of a static string created by StringImpl::createStatic");
+        "Benign race on the reference counter of a static string");
 
     return impl;
 }
@@ -489,14 +501,7 @@ PassRefPtr<StringImpl> StringImpl::lowerASCII()
 
     // First scan the string for uppercase and non-ASCII characters:
     if (is8Bit()) {
-        unsigned firstIndexToBeLowered = m_length;
-        for (unsigned i = 0; i < m_length; ++i) {
-            LChar ch = characters8()[i];
-            if (isASCIIUpper(ch)) {
-                firstIndexToBeLowered = i;
-                break;
-            }
-        }
+        unsigned firstIndexToBeLowered = findASCIIUpper(characters8(), m_length);
 
         // Nothing to do if the string is all ASCII with no uppercase.
         if (firstIndexToBeLowered == m_length) {
@@ -506,11 +511,7 @@ PassRefPtr<StringImpl> StringImpl::lowerASCII()
         LChar* data8;
         RefPtr<StringImpl> newImpl = createUninitialized(m_length, data8);
         memcpy(data8, characters8(), firstIndexToBeLowered);
-
-        for (unsigned i = firstIndexToBeLowered; i < m_length; ++i) {
-            LChar ch = characters8()[i];
-            data8[i] = isASCIIUpper(ch) ? toASCIILower(ch) : ch;
-        }
+        WTF::lowerASCII(data8 + firstIndexToBeLowered, characters8() + firstIndexToBeLowered, m_length - firstIndexToBeLowered);
         return newImpl.release();
     }
     bool noUpper = true;
@@ -546,14 +547,7 @@ PassRefPtr<StringImpl> StringImpl::lower()
 
     // First scan the string for uppercase and non-ASCII characters:
     if (is8Bit()) {
-        unsigned firstIndexToBeLowered = m_length;
-        for (unsigned i = 0; i < m_length; ++i) {
-            LChar ch = characters8()[i];
-            if (UNLIKELY(isASCIIUpper(ch) || ch & ~0x7F)) {
-                firstIndexToBeLowered = i;
-                break;
-            }
-        }
+        unsigned firstIndexToBeLowered = findASCIIUpperOrNonASCII(characters8(), m_length);
 
         // Nothing to do if the string is all ASCII with no uppercase.
         if (firstIndexToBeLowered == m_length)
@@ -563,6 +557,13 @@ PassRefPtr<StringImpl> StringImpl::lower()
         RefPtr<StringImpl> newImpl = createUninitialized(m_length, data8);
         memcpy(data8, characters8(), firstIndexToBeLowered);
 
+        const LChar* remaining = characters8() + firstIndexToBeLowered;
+        unsigned remainingLength = m_length - firstIndexToBeLowered;
+        if (charactersAreAllASCII(remaining, remainingLength)) {
+            WTF::lowerASCII(data8 + firstIndexToBeLowered, remaining, remainingLength);
+            return newImpl.release();
+        }
+
         for (unsigned i = firstIndexToBeLowered; i < m_length; ++i) {
             LChar ch = characters8()[i];
             data8[i] = UNLIKELY(ch & ~0x7F)
@@ -1151,44 +1152,52 @@ size_t StringImpl::find(CharacterMatchFunctionPtr matchFunction, unsigned start)
     return WTF::find(characters16(), m_length, matchFunction, start);
 }
 
-size_t StringImpl::find(const LChar* matchString, unsigned index)
+size_t StringImpl::find(LChar character, unsigned start)
 {
-    // Check for null or empty string to match against
-    if (!matchString)
-        return kNotFound;
-    size_t matchStringLength = strlen(reinterpret_cast<const char*>(matchString));
-    RELEASE_ASSERT(matchStringLength <= numeric_limits<unsigned>::max());
-    unsigned matchLength = matchStringLength;
-    if (!matchLength)
-        return min(index, length());
+    if (is8Bit())
+        return WTF::find(characters8(), m_length, character, start);
+    return find(static_cast<UChar>(character), start);
+}
 
-    // Optimization 1: fast case for strings of length 1.
-    if (matchLength == 1)
-        return WTF::find(characters16(), length(), *matchString, index);
+size_t StringImpl::find(UChar character, unsigned start)
+{
+    if (is8Bit())
+        return WTF::find(characters8(), m_length, character, start);
+
+    const UChar* characters = characters16();
+#if CPU(X86) || CPU(X86_64)
+    // Skip the blocks of 8 characters without a match, and find the exact
+    // index in the remaining characters.
+    const __m128i match = _mm_set1_epi16(character);
+    for (; m_length >= 8 && start <= m_length - 8; start += 8) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + start));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(chunk, match)))
+            break;
+    }
+#endif
+    return WTF::find(characters, m_length, character, start);
+}
+
+template <typename SearchCharacterType, typename MatchCharacterType>
+ALWAYS_INLINE static size_t findInternal(const SearchCharacterType* searchCharacters, const MatchCharacterType* matchCharacters, unsigned index, unsigned searchLength, unsigned matchLength)
+{
+    // Optimization: keep a running hash of the strings,
+    // only call equal() if the hashes match.
 
-    // Check index & matchLength are in range.
-    if (index > length())
-        return kNotFound;
-    unsigned searchLength = length() - index;
-    if (matchLength > searchLength)
-        return kNotFound;
     // delta is the number of additional times to test; delta == 0 means test only once.
     unsigned delta = searchLength - matchLength;
 
-    const UChar* searchCharacters = characters16() + index;
-
-    // Optimization 2: keep a running hash of the strings,
-    // only call equal if the hashes match.
     unsigned searchHash = 0;
     unsigned matchHash = 0;
+
     for (unsigned i = 0; i < matchLength; ++i) {
         searchHash += searchCharacters[i];
-        matchHash += matchString[i];
+        matchHash += matchCharacters[i];
     }
 
     unsigned i = 0;
     // keep looping until we match
-    while (searchHash != matchHash || !equal(searchCharacters + i, matchString, matchLength)) {
+    while (searchHash != matchHash || !equal(searchCharacters + i, matchCharacters, matchLength)) {
         if (i == delta)
             return kNotFound;
         searchHash += searchCharacters[i + matchLength];
@@ -1198,22 +1207,38 @@ size_t StringImpl::find(const LChar* matchString, unsigned index)
     return index + i;
 }
 
-template<typename CharType>
-ALWAYS_INLINE size_t findIgnoringCaseInternal(const CharType* searchCharacters, const LChar* matchString, unsigned index, unsigned searchLength, unsigned matchLength)
+#if CPU(X86) || CPU(X86_64)
+// Looks for the first and the last characters of |matchCharacters| at 16
+// positions at a time, and only compares the whole string where both are
+// found.
+ALWAYS_INLINE static size_t findInternal(const LChar* searchCharacters, const LChar* matchCharacters, unsigned index, unsigned searchLength, unsigned matchLength)
 {
+    ASSERT(matchLength);
     // delta is the number of additional times to test; delta == 0 means test only once.
     unsigned delta = searchLength - matchLength;
 
+    const __m128i first = _mm_set1_epi8(matchCharacters[0]);
+    const __m128i last = _mm_set1_epi8(matchCharacters[matchLength - 1]);
     unsigned i = 0;
-    while (!equalIgnoringCase(searchCharacters + i, matchString, matchLength)) {
-        if (i == delta)
-            return kNotFound;
-        ++i;
+    for (; i + 15 <= delta; i += 16) {
+        __m128i firstChunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(searchCharacters + i));
+        __m128i lastChunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(searchCharacters + i + matchLength - 1));
+        unsigned candidates = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstChunk, first), _mm_cmpeq_epi8(lastChunk, last)));
+        for (unsigned j = 0; candidates; ++j, candidates >>= 1) {
+            if ((candidates & 1) && equal(searchCharacters + i + j, matchCharacters, matchLength))
+                return index + i + j;
+        }
     }
-    return index + i;
+
+    for (; i <= delta; ++i) {
+        if (searchCharacters[i] == matchCharacters[0] && equal(searchCharacters + i, matchCharacters, matchLength))
+            return index + i;
+    }
+    return kNotFound;
 }
+#endif
 
-size_t StringImpl::findIgnoringCase(const LChar* matchString, unsigned index)
+size_t StringImpl::find(const LChar* matchString, unsigned index)
 {
     // Check for null or empty string to match against
     if (!matchString)
@@ -1224,6 +1249,10 @@ size_t StringImpl::findIgnoringCase(const LChar* matchString, unsigned index)
     if (!matchLength)
         return min(index, length());
 
+    // Optimization 1: fast case for strings of length 1.
+    if (matchLength == 1)
+        return find(*matchString, index);
+
     // Check index & matchLength are in range.
     if (index > length())
         return kNotFound;
@@ -1232,39 +1261,48 @@ size_t StringImpl::findIgnoringCase(const LChar* matchString, unsigned index)
         return kNotFound;
 
     if (is8Bit())
-        return findIgnoringCaseInternal(characters8() + index, matchString, index, searchLength, matchLength);
-    return findIgnoringCaseInternal(characters16() + index, matchString, index, searchLength, matchLength);
+        return findInternal(characters8() + index, matchString, index, searchLength, matchLength);
+    return findInternal(characters16() + index, matchString, index, searchLength, matchLength);
 }
 
-template <typename SearchCharacterType, typename MatchCharacterType>
-ALWAYS_INLINE static size_t findInternal(const SearchCharacterType* searchCharacters, const MatchCharacterType* matchCharacters, unsigned index, unsigned searchLength, unsigned matchLength)
+template<typename CharType>
+ALWAYS_INLINE size_t findIgnoringCaseInternal(const CharType* searchCharacters, const LChar* matchString, unsigned index, unsigned searchLength, unsigned matchLength)
 {
-    // Optimization: keep a running hash of the strings,
-    // only call equal() if the hashes match.
-
     // delta is the number of additional times to test; delta == 0 means test only once.
     unsigned delta = searchLength - matchLength;
 
-    unsigned searchHash = 0;
-    unsigned matchHash = 0;
-
-    for (unsigned i = 0; i < matchLength; ++i) {
-        searchHash += searchCharacters[i];
-        matchHash += matchCharacters[i];
-    }
-
     unsigned i = 0;
-    // keep looping until we match
-    while (searchHash != matchHash || !equal(searchCharacters + i, matchCharacters, matchLength)) {
+    while (!equalIgnoringCase(searchCharacters + i, matchString, matchLength)) {
         if (i == delta)
             return kNotFound;
-        searchHash += searchCharacters[i + matchLength];
-        searchHash -= searchCharacters[i];
         ++i;
     }
     return index + i;
 }
 
+size_t StringImpl::findIgnoringCase(const LChar* matchString, unsigned index)
+{
+    // Check for null or empty string to match against
+    if (!matchString)
+        return kNotFound;
+    size_t matchStringLength = strlen(reinterpret_cast<const char*>(matchString));
+    RELEASE_ASSERT(matchStringLength <= numeric_limits<unsigned>::max());
+    unsigned matchLength = matchStringLength;
+    if (!matchLength)
+        return min(index, length());
+
+    // Check index & matchLength are in range.
+    if (index > length())
+        return kNotFound;
+    unsigned searchLength = length() - index;
+    if (matchLength > searchLength)
+        return kNotFound;
+
+    if (is8Bit())
+        return findIgnoringCaseInternal(characters8() + index, matchString, index, searchLength, matchLength);
+    return findIgnoringCaseInternal(characters16() + index, matchString, index, searchLength, matchLength);
+}
+
 size_t StringImpl::find(StringImpl* matchString)
 {
     // Check for null string to match against
@@ -1273,16 +1311,8 @@ size_t StringImpl::find(StringImpl* matchString)
     unsigned matchLength = matchString->length();
 
     // Optimization 1: fast case for strings of length 1.
-    if (matchLength == 1) {
-        if (is8Bit()) {
-            if (matchString->is8Bit())
-                return WTF::find(characters8(), length(), matchString->characters8()[0]);
-            return WTF::find(characters8(), length(), matchString->characters16()[0]);
-        }
-        if (matchString->is8Bit())
-            return WTF::find(characters16(), length(), matchString->characters8()[0]);
-        return WTF::find(characters16(), length(), matchString->characters16()[0]);
-    }
+    if (matchLength == 1)
+        return find((*matchString)[0]);
 
     // Check matchLength is in range.
     if (matchLength > length())
@@ -1313,11 +1343,8 @@ size_t StringImpl::find(StringImpl* matchString, unsigned index)
     unsigned matchLength = matchString->length();
 
     // Optimization 1: fast case for strings of length 1.
-    if (matchLength == 1) {
-        if (is8Bit())
-            return WTF::find(characters8(), length(), (*matchString)[0], index);
-        return WTF::find(characters16(), length(), (*matchString)[0], index);
-    }
+    if (matchLength == 1)
+        return find((*matchString)[0], index);
 
     if (UNLIKELY(!matchLength))
         return min(index, length());
@@ -2276,6 +2303,24 @@ bool equalIgnoringNullity(StringImpl* a, StringImpl* b)
     return equal(a, b);
 }
 
+bool equalIgnoringASCIICase(const LChar* a, const LChar* b, unsigned length)
+{
+    unsigned i = 0;
+#if CPU(X86) || CPU(X86_64)
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunkA = toASCIILowerChunk(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m128i chunkB = toASCIILowerChunk(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunkA, chunkB)) != 0xFFFF)
+            return false;
+    }
+#endif
+    for (; i < length; ++i) {
+        if (toASCIILower(a[i]) != toASCIILower(b[i]))
+            return false;
+    }
+    return true;
+}
+
 bool equalIgnoringASCIICase(const StringImpl* a, const StringImpl* b)
 {
     if (!a || !b)
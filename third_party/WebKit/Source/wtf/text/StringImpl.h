@@ -198,6 +198,9 @@ public:
     ~StringImpl();
 
     static StringImpl* createStatic(const char* string, unsigned length, unsigned hash);
+    // Like createStatic(), but not added to allStaticStrings(), so it can be
+    // called on any thread. Used for AtomicString::findOrAddShared().
+    static StringImpl* createShared(const LChar*, unsigned length, unsigned hash);
     static void reserveStaticStringsCapacityForSize(unsigned size);
     static void freezeStaticStrings();
     static const StaticStringsTable& allStaticStrings();
@@ -514,6 +517,8 @@ inline bool equalIgnoringASCIICase(const CharacterTypeA* a, const CharacterTypeB
     }
     return true;
 }
+// Compares 16 characters at a time where the CPU allows.
+WTF_EXPORT bool equalIgnoringASCIICase(const LChar*, const LChar*, unsigned length);
 
 WTF_EXPORT bool equalIgnoringASCIICase(const StringImpl*, const StringImpl*);
 WTF_EXPORT bool equalIgnoringASCIICase(const StringImpl*, const LChar*, unsigned length);
@@ -658,25 +663,11 @@ inline size_t reverseFind(const LChar* characters, unsigned length, UChar matchC
     return reverseFind(characters, length, static_cast<LChar>(matchCharacter), index);
 }
 
-inline size_t StringImpl::find(LChar character, unsigned start)
-{
-    if (is8Bit())
-        return WTF::find(characters8(), m_length, character, start);
-    return WTF::find(characters16(), m_length, character, start);
-}
-
 ALWAYS_INLINE size_t StringImpl::find(char character, unsigned start)
 {
     return find(static_cast<LChar>(character), start);
 }
 
-inline size_t StringImpl::find(UChar character, unsigned start)
-{
-    if (is8Bit())
-        return WTF::find(characters8(), m_length, character, start);
-    return WTF::find(characters16(), m_length, character, start);
-}
-
 inline unsigned lengthOfNullTerminatedString(const UChar* string)
 {
     size_t length = 0;
@@ -0,0 +1,84 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "wtf/text/StringImpl.h"
+
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "wtf/text/StringBuilder.h"
+#include "wtf/text/WTFString.h"
+
+namespace WTF {
+
+namespace {
+
+const size_t kNumIterations = 100000;
+
+// About the length of a URL or a line of text, with the interesting
+// characters at the end, so the whole string has to be looked at.
+String makeString(bool is8Bit, const char* tail)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 240; ++i)
+        builder.append(static_cast<LChar>('a' + i % 26));
+    builder.append(tail);
+    String string = builder.toString();
+    if (!is8Bit)
+        string.ensure16Bit();
+    return string;
+}
+
+template<typename Function>
+void runTest(const char* measurement, const char* trace, Function function)
+{
+    base::TimeTicks start = base::TimeTicks::Now();
+    size_t result = 0;
+    for (size_t i = 0; i < kNumIterations; ++i)
+        result += function();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    // Keeps the compiler from dropping the calls.
+    EXPECT_NE(0u, result);
+    double nanoseconds = static_cast<double>(elapsed.InMicroseconds() * base::Time::kNanosecondsPerMicrosecond);
+    perf_test::PrintResult(measurement, "", trace, nanoseconds / kNumIterations, "ns/call", true);
+}
+
+} // anonymous namespace
+
+TEST(StringImplPerfTest, FindCharacter)
+{
+    String string8 = makeString(true, "!");
+    String string16 = makeString(false, "!");
+    runTest("string_impl_find_character", "8_bit", [&] { return string8.find('!'); });
+    runTest("string_impl_find_character", "16_bit", [&] { return string16.find('!'); });
+}
+
+TEST(StringImplPerfTest, FindSubstring)
+{
+    String string8 = makeString(true, "needle");
+    String string16 = makeString(false, "needle");
+    String needle = "needle";
+    runTest("string_impl_find_substring", "8_bit", [&] { return string8.find(needle); });
+    runTest("string_impl_find_substring", "16_bit", [&] { return string16.find(needle); });
+}
+
+TEST(StringImplPerfTest, EqualIgnoringASCIICase)
+{
+    String lower = makeString(true, "xyz");
+    String upper = lower.upper();
+    runTest("string_impl_equal_ignoring_ascii_case", "8_bit", [&] { return static_cast<size_t>(equalIgnoringASCIICase(lower, upper)); });
+}
+
+TEST(StringImplPerfTest, Lower)
+{
+    String lower = makeString(true, "Z");
+    String upper = lower.upper();
+    runTest("string_impl_lower", "no_upper_case", [&] { return lower.lower().length(); });
+    runTest("string_impl_lower", "upper_case", [&] { return upper.lower().length(); });
+    runTest("string_impl_lower_ascii", "no_upper_case", [&] { return lower.impl()->lowerASCII()->length(); });
+    runTest("string_impl_lower_ascii", "upper_case", [&] { return upper.impl()->lowerASCII()->length(); });
+}
+
+} // namespace WTF
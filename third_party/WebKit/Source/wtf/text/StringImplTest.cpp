@@ -80,4 +80,60 @@ TEST(StringImplTest, LowerASCII)
     EXPECT_FALSE(equal(StringImpl::create(testWithNonASCII, 2).get(), StringImpl::create(testWithNonASCIIComparison, 2)->lowerASCII().get()));
 }
 
+// The following strings are longer than the blocks the fast paths process at a
+// time, and the characters they look for are at every offset into a block.
+
+TEST(StringImplTest, LowerLongStrings)
+{
+    String lower = "abcdefghijklmnopqrstuvwxyz0123456789-abcdefghijklmnopqrstuvwxyz";
+    for (unsigned i = 0; i < lower.length(); ++i) {
+        String mixed = lower.substring(0, i) + lower.substring(i).upper();
+        EXPECT_EQ(lower, String(mixed.impl()->lowerASCII()));
+        EXPECT_EQ(lower, mixed.lower());
+    }
+    EXPECT_EQ(lower.impl(), lower.impl()->lowerASCII().get());
+    EXPECT_EQ(lower.impl(), lower.impl()->lower().get());
+
+    String latin1 = String("ABCDEFGHIJKLMNOPQRSTUVWXYZ\xC1\xE1" "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    ASSERT_TRUE(latin1.is8Bit());
+    EXPECT_EQ(String("abcdefghijklmnopqrstuvwxyz\xE1\xE1" "abcdefghijklmnopqrstuvwxyz"), latin1.lower());
+    EXPECT_EQ(String("abcdefghijklmnopqrstuvwxyz\xC1\xE1" "abcdefghijklmnopqrstuvwxyz"), String(latin1.impl()->lowerASCII()));
+}
+
+TEST(StringImplTest, FindLongStrings)
+{
+    String haystack = "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz";
+    String haystack16 = haystack;
+    haystack16.ensure16Bit();
+    for (unsigned i = 0; i < 36; ++i) {
+        EXPECT_EQ(i, haystack.find(haystack[i]));
+        EXPECT_EQ(i, haystack16.find(haystack[i]));
+        EXPECT_EQ(i + 36, haystack16.find(haystack[i], i + 1));
+        EXPECT_EQ(i, haystack.find(haystack.substring(i, 5)));
+        EXPECT_EQ(i, haystack16.find(haystack.substring(i, 5)));
+        EXPECT_EQ(i + 36, haystack.find(haystack.substring(i, 36 - i), i + 1));
+        EXPECT_EQ(i, haystack.find(haystack.substring(i, 37).utf8().data()));
+    }
+    EXPECT_EQ(kNotFound, haystack16.find('!'));
+    EXPECT_EQ(kNotFound, haystack16.find('0', 1000));
+    EXPECT_EQ(kNotFound, haystack.find("0123456789abcdefghijklmnopqrstuvwxyz!"));
+    EXPECT_EQ(kNotFound, haystack.find("z0", 36));
+    EXPECT_EQ(35u, haystack.find("z0"));
+}
+
+TEST(StringImplTest, EqualIgnoringASCIICaseLongStrings)
+{
+    String lower = "abcdefghijklmnopqrstuvwxyz@[`{\xE1";
+    String upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{\xE1";
+    EXPECT_TRUE(equalIgnoringASCIICase(lower, upper));
+    for (unsigned i = 0; i < lower.length(); ++i) {
+        String different = lower;
+        different.replace(i, 1, "!");
+        EXPECT_FALSE(equalIgnoringASCIICase(different, upper));
+    }
+    // Letters only match their own other case.
+    EXPECT_FALSE(equalIgnoringASCIICase(String("abcdefghijklmnop@"), String("ABCDEFGHIJKLMNOP`")));
+    EXPECT_FALSE(equalIgnoringASCIICase(String("abcdefghijklmnop\xC1"), String("ABCDEFGHIJKLMNOP\xE1")));
+}
+
 } // namespace WTF
@@ -55,6 +55,21 @@
         }],
       ]
     },
+    {
+      'target_name': 'wtf_perftests',
+      'type': 'executable',
+      'dependencies': [
+        'wtf.gyp:wtf',
+        '../config.gyp:unittest_config',
+        '<(DEPTH)/base/base.gyp:test_support_base',
+        '<(DEPTH)/testing/perf/perf_test.gyp:perf_test',
+      ],
+      'sources': [
+        'testing/RunAllTests.cpp',
+        '<@(wtf_perftest_files)',
+      ],
+      'msvs_disabled_warnings': [4127, 4510, 4512, 4610, 4706, 4068, 4267],
+    },
   ],
   'conditions': [
     ['OS=="android" and gtest_target_type=="shared_library"', {
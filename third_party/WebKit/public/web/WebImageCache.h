@@ -46,6 +46,10 @@ public:
     // cleared if they are actively referenced).
     BLINK_EXPORT static void clear();
 
+    // Sets how much memory the decoders of partially used images and their
+    // decoded frames may hold before the least recently used are dropped.
+    BLINK_EXPORT static void setCacheLimitInBytes(size_t);
+
 private:
     WebImageCache();  // Not intended to be instanced.
 };
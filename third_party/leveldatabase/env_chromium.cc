@@ -19,6 +19,7 @@
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/trace_event/trace_event.h"
 #include "third_party/leveldatabase/chromium_logger.h"
@@ -322,6 +323,28 @@ Status ChromiumWritableFile::Sync() {
 
 base::LazyInstance<ChromiumEnv>::Leaky default_env = LAZY_INSTANCE_INITIALIZER;
 
+// The same size as the cache leveldb creates for each database by default.
+const size_t kSharedBlockCacheSize = 8 * 1024 * 1024;
+const size_t kLowEndSharedBlockCacheSize = 1024 * 1024;
+
+class SharedBlockCacheHolder {
+ public:
+  SharedBlockCacheHolder()
+      : cache_(leveldb::NewLRUCache(base::SysInfo::IsLowEndDevice()
+                                        ? kLowEndSharedBlockCacheSize
+                                        : kSharedBlockCacheSize)) {}
+
+  leveldb::Cache* cache() { return cache_.get(); }
+
+ private:
+  std::unique_ptr<leveldb::Cache> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBlockCacheHolder);
+};
+
+base::LazyInstance<SharedBlockCacheHolder>::Leaky shared_block_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // unnamed namespace
 
 const char* MethodIDToString(MethodID method) {
@@ -500,6 +523,10 @@ bool IndicatesDiskFull(const leveldb::Status& status) {
               base::File::FILE_ERROR_NO_SPACE);
 }
 
+leveldb::Cache* SharedBlockCache() {
+  return shared_block_cache.Get().cache();
+}
+
 bool ChromiumEnv::MakeBackup(const std::string& fname) {
   FilePath original_table_name = FilePath::FromUTF8Unsafe(fname);
   FilePath backup_table_name =
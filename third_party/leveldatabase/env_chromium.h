@@ -13,6 +13,7 @@
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/metrics/histogram.h"
+#include "leveldb/cache.h"
 #include "leveldb/env.h"
 #include "port/port_chromium.h"
 #include "util/mutexlock.h"
@@ -97,6 +98,11 @@ int GetNumCorruptionCodes();
 std::string GetCorruptionMessage(const leveldb::Status& status);
 bool IndicatesDiskFull(const leveldb::Status& status);
 
+// Returns a block cache for databases to share by setting it as
+// leveldb::Options::block_cache, instead of each keeping its own 8MB cache.
+// The cache lives for the rest of the process.
+leveldb::Cache* SharedBlockCache();
+
 class UMALogger {
  public:
   virtual void RecordErrorAt(MethodID method) const = 0;
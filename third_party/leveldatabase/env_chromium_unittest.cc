@@ -183,4 +183,43 @@ TEST(ChromiumEnv, GetChildrenPriorResults) {
   EXPECT_EQ(1U, result.size());
 }
 
+TEST(ChromiumEnv, SharedBlockCache) {
+  base::ScopedTempDir scoped_temp_dir;
+  ASSERT_TRUE(scoped_temp_dir.CreateUniqueTempDir());
+  base::FilePath dir = scoped_temp_dir.path();
+
+  Options options;
+  options.create_if_missing = true;
+  options.block_cache = leveldb_env::SharedBlockCache();
+  EXPECT_EQ(options.block_cache, leveldb_env::SharedBlockCache());
+
+  // Two databases using the cache at once.
+  DB* db1;
+  Status status =
+      DB::Open(options, dir.Append(FPL("db1")).AsUTF8Unsafe(), &db1);
+  ASSERT_TRUE(status.ok()) << status.ToString();
+  DB* db2;
+  status = DB::Open(options, dir.Append(FPL("db2")).AsUTF8Unsafe(), &db2);
+  ASSERT_TRUE(status.ok()) << status.ToString();
+
+  ASSERT_TRUE(db1->Put(WriteOptions(), "key", "value1").ok());
+  ASSERT_TRUE(db2->Put(WriteOptions(), "key", "value2").ok());
+  db1->CompactRange(nullptr, nullptr);
+  db2->CompactRange(nullptr, nullptr);
+
+  std::string value;
+  ASSERT_TRUE(db1->Get(ReadOptions(), "key", &value).ok());
+  EXPECT_EQ("value1", value);
+  ASSERT_TRUE(db2->Get(ReadOptions(), "key", &value).ok());
+  EXPECT_EQ("value2", value);
+
+  // Pruning only drops cached blocks.
+  leveldb_env::SharedBlockCache()->Prune();
+  ASSERT_TRUE(db1->Get(ReadOptions(), "key", &value).ok());
+  EXPECT_EQ("value1", value);
+
+  delete db1;
+  delete db2;
+}
+
 int main(int argc, char** argv) { return base::TestSuite(argc, argv).Run(); }
@@ -16,6 +16,7 @@
 #include "ui/base/ime/input_method.h"
 #include "ui/base/ime/input_method_factory.h"
 #include "ui/base/view_prop.h"
+#include "ui/compositor/compositor.h"
 #include "ui/compositor/dip_util.h"
 #include "ui/compositor/layer.h"
 #include "ui/display/display.h"
@@ -309,6 +310,14 @@ ui::EventProcessor* WindowTreeHost::GetEventProcessor() {
   return event_processor();
 }
 
+bool WindowTreeHost::ScheduleCoalescedEventsFlush() {
+  if (!compositor_)
+    return false;
+  if (!compositor_->HasAnimationObserver(this))
+    compositor_->AddAnimationObserver(this);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // WindowTreeHost, private:
 
@@ -325,4 +334,13 @@ void WindowTreeHost::MoveCursorToInternal(const gfx::Point& root_location,
   dispatcher()->OnCursorMovedToRootLocation(root_location);
 }
 
+void WindowTreeHost::OnAnimationStep(base::TimeTicks timestamp) {
+  compositor_->RemoveAnimationObserver(this);
+  ignore_result(FlushCoalescedEvents());
+}
+
+void WindowTreeHost::OnCompositingShuttingDown(ui::Compositor* compositor) {
+  compositor->RemoveAnimationObserver(this);
+}
+
 }  // namespace aura
@@ -13,6 +13,7 @@
 #include "ui/aura/aura_export.h"
 #include "ui/base/cursor/cursor.h"
 #include "ui/base/ime/input_method_delegate.h"
+#include "ui/compositor/compositor_animation_observer.h"
 #include "ui/events/event_source.h"
 #include "ui/gfx/geometry/insets.h"
 #include "ui/gfx/native_widget_types.h"
@@ -44,7 +45,8 @@ class WindowTreeHostObserver;
 // It provides the accelerated widget and maps events from the native os to
 // aura.
 class AURA_EXPORT WindowTreeHost : public ui::internal::InputMethodDelegate,
-                                   public ui::EventSource {
+                                   public ui::EventSource,
+                                   public ui::CompositorAnimationObserver {
  public:
   ~WindowTreeHost() override;
 
@@ -216,10 +218,16 @@ class AURA_EXPORT WindowTreeHost : public ui::internal::InputMethodDelegate,
 
   // Overridden from ui::EventSource:
   ui::EventProcessor* GetEventProcessor() override;
+  bool ScheduleCoalescedEventsFlush() override;
 
  private:
   friend class test::WindowTreeHostTestApi;
 
+  // Overridden from ui::CompositorAnimationObserver, to flush the coalesced
+  // events at the start of each frame:
+  void OnAnimationStep(base::TimeTicks timestamp) override;
+  void OnCompositingShuttingDown(ui::Compositor* compositor) override;
+
   // Moves the cursor to the specified location. This method is internally used
   // by MoveCursorTo() and MoveCursorToHostLocation().
   void MoveCursorToInternal(const gfx::Point& root_location,
@@ -69,6 +69,10 @@ const size_t kPngChunkMetadataSize = 12;  // length, type, crc32
 const unsigned char kPngScaleChunkType[4] = { 'c', 's', 'C', 'l' };
 const unsigned char kPngDataChunkType[4] = { 'I', 'D', 'A', 'T' };
 
+// The most memory spent on keeping decompressed gzipped resources, which are
+// mostly WebUI pages and scripts that are requested repeatedly.
+const size_t kMaxDecompressedResourcesSize = 8 * 1024 * 1024;
+
 #if !defined(OS_MACOSX)
 const char kPakFileSuffix[] = ".pak";
 #endif
@@ -516,9 +520,7 @@ base::RefCountedMemory* ResourceBundle::LoadDataResourceBytesForScale(
     if (!data.empty()) {
       if (data.starts_with(CUSTOM_GZIP_HEADER)) {
         // Jump past special identification byte prepended to header
-        const unsigned char* gzip_start =
-            reinterpret_cast<const unsigned char*>(data.data()) + 1;
-        bytes = DecodeGzipData(gzip_start, data.length() - 1);
+        bytes = LoadDecompressedResource(resource_id, scale_factor, data);
       } else {
         bytes = new base::RefCountedStaticMemory(data.data(), data.length());
       }
@@ -528,6 +530,35 @@ base::RefCountedMemory* ResourceBundle::LoadDataResourceBytesForScale(
   return bytes;
 }
 
+base::RefCountedMemory* ResourceBundle::LoadDecompressedResource(
+    int resource_id,
+    ScaleFactor scale_factor,
+    const base::StringPiece& data) const {
+  std::pair<int, ScaleFactor> key(resource_id, scale_factor);
+  {
+    base::AutoLock lock_scope(*decompressed_resources_lock_);
+    auto it = decompressed_resources_.find(key);
+    if (it != decompressed_resources_.end())
+      return it->second.get();
+  }
+
+  // Jump past special identification byte prepended to header
+  const unsigned char* gzip_start =
+      reinterpret_cast<const unsigned char*>(data.data()) + 1;
+  base::RefCountedMemory* bytes =
+      DecodeGzipData(gzip_start, data.length() - 1);
+
+  // If another thread raced the decompression, or the cache is full, the
+  // caller gets the only reference to |bytes|.
+  base::AutoLock lock_scope(*decompressed_resources_lock_);
+  if (decompressed_resources_size_ + bytes->size() <=
+          kMaxDecompressedResourcesSize &&
+      decompressed_resources_.insert(std::make_pair(key, bytes)).second) {
+    decompressed_resources_size_ += bytes->size();
+  }
+  return bytes;
+}
+
 base::StringPiece ResourceBundle::GetRawDataResource(int resource_id) const {
   return GetRawDataResourceForScale(resource_id, ui::SCALE_FACTOR_NONE);
 }
@@ -695,6 +726,8 @@ ResourceBundle::ResourceBundle(Delegate* delegate)
     : delegate_(delegate),
       images_and_fonts_lock_(new base::Lock),
       locale_resources_data_lock_(new base::Lock),
+      decompressed_resources_lock_(new base::Lock),
+      decompressed_resources_size_(0),
       max_scale_factor_(SCALE_FACTOR_100P) {
 }
 
@@ -10,12 +10,14 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "base/containers/hash_tables.h"
 #include "base/files/file_path.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_vector.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
@@ -397,6 +399,14 @@ class UI_BASE_EXPORT ResourceBundle {
       int resource_id,
       ScaleFactor scale_factor) const;
 
+  // Returns the contents of the gzipped resource |data|. Each resource is
+  // decompressed once and kept, up to kMaxDecompressedResourcesSize bytes in
+  // total.
+  base::RefCountedMemory* LoadDecompressedResource(
+      int resource_id,
+      ScaleFactor scale_factor,
+      const base::StringPiece& data) const;
+
   // Returns true if missing scaled resources should be visually indicated when
   // drawing the fallback (e.g., by tinting the image).
   static bool ShouldHighlightMissingScaledResources();
@@ -430,10 +440,20 @@ class UI_BASE_EXPORT ResourceBundle {
   // Protects |locale_resources_data_|.
   std::unique_ptr<base::Lock> locale_resources_data_lock_;
 
+  // Protects |decompressed_resources_| and |decompressed_resources_size_|.
+  std::unique_ptr<base::Lock> decompressed_resources_lock_;
+
   // Handles for data sources.
   std::unique_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // Decompressed copies of gzipped data resources, by resource id and scale
+  // factor, and their total size.
+  mutable std::map<std::pair<int, ScaleFactor>,
+                   scoped_refptr<base::RefCountedMemory>>
+      decompressed_resources_;
+  mutable size_t decompressed_resources_size_;
+
   // The maximum scale factor currently loaded.
   ScaleFactor max_scale_factor_;
 
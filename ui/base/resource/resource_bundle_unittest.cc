@@ -307,6 +307,11 @@ TEST_F(ResourceBundleTest, LoadDataResourceBytesGzip) {
       strncmp("This is compressed\n",
               reinterpret_cast<const char*>(result->front()), result->size()),
       0);
+
+  // It is only decompressed once.
+  scoped_refptr<base::RefCountedMemory> result2 =
+      resource_bundle->LoadDataResourceBytes(4);
+  EXPECT_EQ(result.get(), result2.get());
 }
 
 TEST_F(ResourceBundleTest, DelegateGetRawDataResource) {
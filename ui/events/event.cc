@@ -332,6 +332,7 @@ Event::Event(EventType type, base::TimeTicks time_stamp, int flags)
       target_(NULL),
       phase_(EP_PREDISPATCH),
       result_(ER_UNHANDLED),
+      coalesced_events_(nullptr),
       source_device_id_(ED_UNKNOWN_DEVICE) {
   if (type_ < ET_LAST)
     name_ = EventTypeName(type_);
@@ -349,6 +350,7 @@ Event::Event(const base::NativeEvent& native_event,
       target_(NULL),
       phase_(EP_PREDISPATCH),
       result_(ER_UNHANDLED),
+      coalesced_events_(nullptr),
       source_device_id_(ED_UNKNOWN_DEVICE) {
   base::TimeDelta delta = EventTimeForNow() - time_stamp_;
   if (type_ < ET_LAST)
@@ -394,6 +396,7 @@ Event::Event(const Event& copy)
       target_(NULL),
       phase_(EP_PREDISPATCH),
       result_(ER_UNHANDLED),
+      coalesced_events_(nullptr),
       source_device_id_(copy.source_device_id_) {
   if (type_ < ET_LAST)
     name_ = EventTypeName(type_);
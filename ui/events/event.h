@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/event_types.h"
@@ -61,6 +62,9 @@ class EVENTS_EXPORT Event {
     void set_result(int result) {
       event_->result_ = static_cast<EventResult>(result);
     }
+    void set_coalesced_events(const std::vector<ScopedEvent>* events) {
+      event_->coalesced_events_ = events;
+    }
 
    private:
     DispatcherApi();
@@ -88,6 +92,14 @@ class EVENTS_EXPORT Event {
   const LatencyInfo* latency() const { return &latency_; }
   void set_latency(const LatencyInfo& latency) { latency_ = latency; }
 
+  // The continuous events that were coalesced into this one by the
+  // EventSource, oldest first, or null if there were none. Handlers that want
+  // every sample (e.g. drawing applications) can walk these; they are only
+  // valid while this event is being dispatched.
+  const std::vector<ScopedEvent>* coalesced_events() const {
+    return coalesced_events_;
+  }
+
   int source_device_id() const { return source_device_id_; }
   void set_source_device_id(int id) { source_device_id_ = id; }
 
@@ -304,6 +316,7 @@ class EVENTS_EXPORT Event {
   EventTarget* target_;
   EventPhase phase_;
   EventResult result_;
+  const std::vector<ScopedEvent>* coalesced_events_;
 
   // The device id the event came from, or ED_UNKNOWN_DEVICE if the information
   // is not available.
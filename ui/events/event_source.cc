@@ -5,13 +5,56 @@
 #include "ui/events/event_source.h"
 
 #include <algorithm>
+#include <utility>
 
+#include "base/metrics/histogram_macros.h"
+#include "base/trace_event/trace_event.h"
+#include "ui/events/event.h"
 #include "ui/events/event_processor.h"
 #include "ui/events/event_rewriter.h"
+#include "ui/events/event_utils.h"
 
 namespace ui {
 
-EventSource::EventSource() {}
+namespace {
+
+// Returns true if |event| is part of a stream of which handlers mostly only
+// need the latest event.
+bool IsContinuousEvent(const Event& event) {
+  switch (event.type()) {
+    case ET_MOUSE_MOVED:
+    case ET_MOUSE_DRAGGED:
+    case ET_TOUCH_MOVED:
+    case ET_POINTER_MOVED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if the continuous |event| is part of the same stream as
+// |held_event|, i.e. the same pointer with the same buttons and modifiers.
+bool CanCoalesce(const Event& held_event, const Event& event) {
+  if (held_event.type() != event.type() ||
+      held_event.flags() != event.flags() ||
+      held_event.source_device_id() != event.source_device_id()) {
+    return false;
+  }
+  if (event.IsTouchEvent())
+    return held_event.AsTouchEvent()->touch_id() ==
+           event.AsTouchEvent()->touch_id();
+  if (event.IsPointerEvent())
+    return held_event.AsPointerEvent()->pointer_id() ==
+           event.AsPointerEvent()->pointer_id();
+  if (event.IsMouseEvent())
+    return held_event.AsMouseEvent()->pointer_details().pointer_type ==
+           event.AsMouseEvent()->pointer_details().pointer_type;
+  return true;
+}
+
+}  // namespace
+
+EventSource::EventSource() : coalesce_continuous_events_(false) {}
 
 EventSource::~EventSource() {}
 
@@ -29,6 +72,38 @@ void EventSource::RemoveEventRewriter(EventRewriter* rewriter) {
     rewriter_list_.erase(find);
 }
 
+void EventSource::SetCoalesceContinuousEvents(bool coalesce) {
+  coalesce_continuous_events_ = coalesce;
+  if (!coalesce)
+    ignore_result(FlushCoalescedEvents());
+}
+
+EventDispatchDetails EventSource::FlushCoalescedEvents() {
+  if (!held_event_)
+    return EventDispatchDetails();
+
+  // Take the events out first, since dispatching may hold new ones.
+  std::unique_ptr<Event> event = std::move(held_event_);
+  std::vector<std::unique_ptr<Event>> coalesced_events;
+  coalesced_events.swap(coalesced_events_);
+
+  base::TimeTicks oldest_time_stamp = coalesced_events.empty()
+                                          ? event->time_stamp()
+                                          : coalesced_events[0]->time_stamp();
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Event.Latency.Coalesced",
+      (EventTimeForNow() - oldest_time_stamp).InMicroseconds(), 1, 1000000,
+      50);
+  int coalesced_count = static_cast<int>(coalesced_events.size());
+  UMA_HISTOGRAM_COUNTS_100("Event.CoalescedCount", coalesced_count);
+  TRACE_EVENT2("input", "EventSource::FlushCoalescedEvents", "type",
+               event->name(), "coalesced", coalesced_count);
+
+  if (!coalesced_events.empty())
+    Event::DispatcherApi(event.get()).set_coalesced_events(&coalesced_events);
+  return DeliverEventToProcessor(event.get());
+}
+
 EventDispatchDetails EventSource::SendEventToProcessor(Event* event) {
   std::unique_ptr<Event> rewritten_event;
   EventRewriteStatus status = EVENT_REWRITE_CONTINUE;
@@ -48,7 +123,7 @@ EventDispatchDetails EventSource::SendEventToProcessor(Event* event) {
   }
   CHECK((it == end && !rewritten_event) || rewritten_event);
   EventDispatchDetails details =
-      DeliverEventToProcessor(rewritten_event ? rewritten_event.get() : event);
+      CoalesceOrDeliverEvent(rewritten_event ? rewritten_event.get() : event);
   if (details.dispatcher_destroyed)
     return details;
 
@@ -59,7 +134,7 @@ EventDispatchDetails EventSource::SendEventToProcessor(Event* event) {
       return EventDispatchDetails();
     CHECK_NE(EVENT_REWRITE_CONTINUE, status);
     CHECK(new_event);
-    details = DeliverEventToProcessor(new_event.get());
+    details = CoalesceOrDeliverEvent(new_event.get());
     if (details.dispatcher_destroyed)
       return details;
     rewritten_event.reset(new_event.release());
@@ -67,10 +142,34 @@ EventDispatchDetails EventSource::SendEventToProcessor(Event* event) {
   return EventDispatchDetails();
 }
 
+bool EventSource::ScheduleCoalescedEventsFlush() {
+  return false;
+}
+
 EventDispatchDetails EventSource::DeliverEventToProcessor(Event* event) {
   EventProcessor* processor = GetEventProcessor();
   CHECK(processor);
   return processor->OnEventFromSource(event);
 }
 
+EventDispatchDetails EventSource::CoalesceOrDeliverEvent(Event* event) {
+  bool continuous = IsContinuousEvent(*event);
+  if (held_event_ && !(continuous && CanCoalesce(*held_event_, *event))) {
+    EventDispatchDetails details = FlushCoalescedEvents();
+    if (details.dispatcher_destroyed)
+      return details;
+  }
+  if (!coalesce_continuous_events_ || !continuous)
+    return DeliverEventToProcessor(event);
+
+  if (held_event_) {
+    held_event_->latency()->set_coalesced();
+    coalesced_events_.push_back(std::move(held_event_));
+  } else if (!ScheduleCoalescedEventsFlush()) {
+    return DeliverEventToProcessor(event);
+  }
+  held_event_ = Event::Clone(*event);
+  return EventDispatchDetails();
+}
+
 }  // namespace ui
@@ -5,6 +5,7 @@
 #ifndef UI_EVENTS_EVENT_SOURCE_H_
 #define UI_EVENTS_EVENT_SOURCE_H_
 
+#include <memory>
 #include <vector>
 
 #include "base/macros.h"
@@ -33,16 +34,45 @@ class EVENTS_EXPORT EventSource {
   void AddEventRewriter(EventRewriter* rewriter);
   void RemoveEventRewriter(EventRewriter* rewriter);
 
+  // When enabled, continuous events (mouse moves and drags, touch moves and
+  // pointer moves) are not sent to the EventProcessor as they arrive. Each run
+  // of them is held and only the latest is sent, once per frame, from
+  // FlushCoalescedEvents(); the earlier ones are available from its
+  // Event::coalesced_events(). Any other event flushes the held one first, so
+  // the order of events is preserved. This needs a source that overrides
+  // ScheduleCoalescedEventsFlush(). Disabled by default.
+  void SetCoalesceContinuousEvents(bool coalesce);
+
+  // Sends the held continuous event, if any, to the EventProcessor.
+  EventDispatchDetails FlushCoalescedEvents();
+
  protected:
   EventDispatchDetails SendEventToProcessor(Event* event);
 
+  // Called when a continuous event starts being held. Sources should call
+  // FlushCoalescedEvents() at the start of their next frame, and return true,
+  // or return false if they have no frame clock, in which case events are not
+  // coalesced.
+  virtual bool ScheduleCoalescedEventsFlush();
+
  private:
   friend class EventSourceTestApi;
 
   EventDispatchDetails DeliverEventToProcessor(Event* event);
 
+  // Sends |event| to the EventProcessor, or holds it if it is continuous and
+  // coalescing is enabled.
+  EventDispatchDetails CoalesceOrDeliverEvent(Event* event);
+
   typedef std::vector<EventRewriter*> EventRewriterList;
   EventRewriterList rewriter_list_;
+
+  bool coalesce_continuous_events_;
+
+  // The held continuous event, and the ones it replaced, oldest first.
+  std::unique_ptr<Event> held_event_;
+  std::vector<std::unique_ptr<Event>> coalesced_events_;
+
   DISALLOW_COPY_AND_ASSIGN(EventSource);
 };
 
@@ -0,0 +1,191 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ui/events/event_source.h"
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/events/event.h"
+#include "ui/events/test/test_event_processor.h"
+
+namespace ui {
+
+namespace {
+
+// Records the events it receives as "<type> <x> [<x of coalesced events>]".
+class RecordingEventProcessor : public test::TestEventProcessor {
+ public:
+  RecordingEventProcessor() {}
+  ~RecordingEventProcessor() override {}
+
+  const std::vector<std::string>& events() const { return events_; }
+
+  // EventProcessor:
+  EventDispatchDetails OnEventFromSource(Event* event) override {
+    std::string description = base::StringPrintf(
+        "%s %d [", event->name().c_str(),
+        static_cast<LocatedEvent*>(event)->x());
+    if (event->coalesced_events()) {
+      for (const auto& coalesced_event : *event->coalesced_events()) {
+        EXPECT_TRUE(coalesced_event->latency()->coalesced());
+        description += base::StringPrintf(
+            "%d ", static_cast<LocatedEvent*>(coalesced_event.get())->x());
+      }
+    }
+    description += "]";
+    events_.push_back(description);
+    EXPECT_FALSE(event->latency()->coalesced());
+    return EventDispatchDetails();
+  }
+
+ private:
+  std::vector<std::string> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingEventProcessor);
+};
+
+// EventSource that flushes coalesced events when the test says so, or never
+// coalesces if it has no frame clock.
+class TestEventSource : public EventSource {
+ public:
+  explicit TestEventSource(EventProcessor* processor)
+      : processor_(processor), has_frame_clock_(true), flush_requests_(0) {}
+  ~TestEventSource() override {}
+
+  void set_has_frame_clock(bool has_frame_clock) {
+    has_frame_clock_ = has_frame_clock;
+  }
+  int flush_requests() const { return flush_requests_; }
+
+  void Send(Event* event) { (void)SendEventToProcessor(event); }
+
+  void SendMouse(EventType type, int x, int flags) {
+    MouseEvent event(type, gfx::Point(x, 0), gfx::Point(x, 0),
+                     base::TimeTicks(), flags, 0);
+    Send(&event);
+  }
+
+  void SendTouch(EventType type, int x, int touch_id) {
+    TouchEvent event(type, gfx::Point(x, 0), touch_id, base::TimeTicks());
+    Send(&event);
+  }
+
+  // EventSource:
+  EventProcessor* GetEventProcessor() override { return processor_; }
+  bool ScheduleCoalescedEventsFlush() override {
+    ++flush_requests_;
+    return has_frame_clock_;
+  }
+
+ private:
+  EventProcessor* processor_;
+  bool has_frame_clock_;
+  int flush_requests_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestEventSource);
+};
+
+}  // namespace
+
+TEST(EventSourceTest, NoCoalescingByDefault) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.SendMouse(ET_MOUSE_MOVED, 1, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 2, 0);
+  EXPECT_EQ(0, source.flush_requests());
+  std::vector<std::string> expected = {"ET_MOUSE_MOVED 1 []",
+                                       "ET_MOUSE_MOVED 2 []"};
+  EXPECT_EQ(expected, processor.events());
+}
+
+TEST(EventSourceTest, CoalescesMouseMovesUntilFlush) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.SetCoalesceContinuousEvents(true);
+  source.SendMouse(ET_MOUSE_MOVED, 1, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 2, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 3, 0);
+  EXPECT_EQ(1, source.flush_requests());
+  EXPECT_TRUE(processor.events().empty());
+
+  EXPECT_FALSE(source.FlushCoalescedEvents().dispatcher_destroyed);
+  std::vector<std::string> expected = {"ET_MOUSE_MOVED 3 [1 2 ]"};
+  EXPECT_EQ(expected, processor.events());
+
+  // Nothing is held any more.
+  EXPECT_FALSE(source.FlushCoalescedEvents().dispatcher_destroyed);
+  EXPECT_EQ(expected, processor.events());
+
+  source.SendMouse(ET_MOUSE_MOVED, 4, 0);
+  EXPECT_EQ(2, source.flush_requests());
+  source.FlushCoalescedEvents();
+  expected.push_back("ET_MOUSE_MOVED 4 []");
+  EXPECT_EQ(expected, processor.events());
+}
+
+TEST(EventSourceTest, OtherEventsFlushFirst) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.SetCoalesceContinuousEvents(true);
+  source.SendMouse(ET_MOUSE_MOVED, 1, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 2, 0);
+  source.SendMouse(ET_MOUSE_PRESSED, 3, EF_LEFT_MOUSE_BUTTON);
+  source.SendMouse(ET_MOUSE_DRAGGED, 4, EF_LEFT_MOUSE_BUTTON);
+  source.SendMouse(ET_MOUSE_DRAGGED, 5, EF_LEFT_MOUSE_BUTTON);
+  // Different modifiers start a new run.
+  source.SendMouse(ET_MOUSE_DRAGGED, 6,
+                   EF_LEFT_MOUSE_BUTTON | EF_SHIFT_DOWN);
+  source.SendMouse(ET_MOUSE_RELEASED, 7, EF_LEFT_MOUSE_BUTTON);
+  std::vector<std::string> expected = {
+      "ET_MOUSE_MOVED 2 [1 ]", "ET_MOUSE_PRESSED 3 []",
+      "ET_MOUSE_DRAGGED 5 [4 ]", "ET_MOUSE_DRAGGED 6 []",
+      "ET_MOUSE_RELEASED 7 []"};
+  EXPECT_EQ(expected, processor.events());
+}
+
+TEST(EventSourceTest, CoalescesTouchMovesPerTouch) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.SetCoalesceContinuousEvents(true);
+  source.SendTouch(ET_TOUCH_MOVED, 1, 0);
+  source.SendTouch(ET_TOUCH_MOVED, 2, 0);
+  source.SendTouch(ET_TOUCH_MOVED, 3, 1);
+  source.SendTouch(ET_TOUCH_MOVED, 4, 1);
+  source.FlushCoalescedEvents();
+  std::vector<std::string> expected = {"ET_TOUCH_MOVED 2 [1 ]",
+                                       "ET_TOUCH_MOVED 4 [3 ]"};
+  EXPECT_EQ(expected, processor.events());
+}
+
+TEST(EventSourceTest, DisablingFlushes) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.SetCoalesceContinuousEvents(true);
+  source.SendMouse(ET_MOUSE_MOVED, 1, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 2, 0);
+  source.SetCoalesceContinuousEvents(false);
+  source.SendMouse(ET_MOUSE_MOVED, 3, 0);
+  std::vector<std::string> expected = {"ET_MOUSE_MOVED 2 [1 ]",
+                                       "ET_MOUSE_MOVED 3 []"};
+  EXPECT_EQ(expected, processor.events());
+}
+
+TEST(EventSourceTest, NoCoalescingWithoutFrameClock) {
+  RecordingEventProcessor processor;
+  TestEventSource source(&processor);
+  source.set_has_frame_clock(false);
+  source.SetCoalesceContinuousEvents(true);
+  source.SendMouse(ET_MOUSE_MOVED, 1, 0);
+  source.SendMouse(ET_MOUSE_MOVED, 2, 0);
+  EXPECT_EQ(2, source.flush_requests());
+  std::vector<std::string> expected = {"ET_MOUSE_MOVED 1 []",
+                                       "ET_MOUSE_MOVED 2 []"};
+  EXPECT_EQ(expected, processor.events());
+}
+
+}  // namespace ui
@@ -41,6 +41,7 @@
         'event_dispatcher_unittest.cc',
         'event_processor_unittest.cc',
         'event_rewriter_unittest.cc',
+        'event_source_unittest.cc',
         'event_unittest.cc',
         'gesture_detection/bitset_32_unittest.cc',
         'gesture_detection/filtered_gesture_provider_unittest.cc',
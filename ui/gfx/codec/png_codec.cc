@@ -6,9 +6,16 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
 #include "third_party/libpng/png.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
@@ -588,6 +595,11 @@ bool DoLibpngWrite(png_struct* png_ptr, png_info* info_ptr,
   }
 
   png_set_compression_level(png_ptr, compression_level);
+  // libpng picks the best of the five filters for each row by default, which
+  // can take longer than the deflating itself at the fastest level. The Sub
+  // filter alone is much cheaper.
+  if (compression_level == Z_BEST_SPEED)
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
 
   // Set our callback for libpng to give us the data.
   png_set_write_fn(png_ptr, state, EncoderWriteCallback, FakeFlushCallback);
@@ -753,6 +765,227 @@ bool InternalEncodeSkBitmap(const SkBitmap& input,
       output);
 }
 
+// Parallel encoder -----------------------------------------------------------
+//
+// Large bitmaps are split into strips of rows that are filtered and deflated
+// concurrently, the way pigz does it: each strip is a raw deflate stream that
+// ends on a byte boundary (Z_SYNC_FLUSH) and does not refer back into the
+// previous strip, so their concatenation is a single valid zlib stream. Every
+// row uses the Sub filter, which only looks at the row itself. libpng can't
+// write pre-compressed data, so the PNG chunks are written here.
+
+// The size of the unfiltered rows of a strip. Bitmaps smaller than two strips
+// are encoded by libpng on the calling thread.
+const int kBytesPerStrip = 512 * 1024;
+
+// Filter type byte of the Sub filter, which stores each byte as the
+// difference from the byte one pixel to the left.
+const unsigned char kPngFilterSub = 1;
+
+// A strip of rows and its compressed data.
+struct PngStrip {
+  PngStrip() : first_row(0), num_rows(0), adler(0), filtered_size(0),
+               success(false) {}
+
+  int first_row;
+  int num_rows;
+  std::vector<unsigned char> deflated;
+  // Adler-32 checksum and size of the filtered rows, for the zlib trailer.
+  uLong adler;
+  size_t filtered_size;
+  bool success;
+};
+
+// The bitmap being encoded in parallel. The strips are written by the
+// threads that compress them.
+struct ParallelEncodeState {
+  const unsigned char* input;
+  int width;
+  int height;
+  int row_byte_width;
+  int output_color_components;
+  FormatConverter converter;
+  std::vector<PngStrip> strips;
+};
+
+// Filters and deflates the rows of |strip|. The last strip finishes the
+// deflate stream.
+void DeflateStrip(const ParallelEncodeState* state, PngStrip* strip) {
+  const int row_size = state->width * state->output_color_components;
+  const int bpp = state->output_color_components;
+  std::vector<unsigned char> row(row_size);
+  std::vector<unsigned char> filtered(
+      static_cast<size_t>(row_size + 1) * strip->num_rows);
+  for (int y = 0; y < strip->num_rows; ++y) {
+    const unsigned char* in =
+        &state->input[static_cast<size_t>(strip->first_row + y) *
+                      state->row_byte_width];
+    state->converter(in, state->width, &row[0], NULL);
+    unsigned char* out = &filtered[static_cast<size_t>(y) * (row_size + 1)];
+    out[0] = kPngFilterSub;
+    memcpy(&out[1], &row[0], bpp);
+    for (int x = bpp; x < row_size; ++x)
+      out[x + 1] = row[x] - row[x - bpp];
+  }
+  strip->filtered_size = filtered.size();
+  strip->adler =
+      adler32(adler32(0L, Z_NULL, 0), &filtered[0], filtered.size());
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // Negative window bits give a raw deflate stream without the zlib wrapper.
+  if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return;
+  }
+  bool last = strip->first_row + strip->num_rows == state->height;
+  // deflateBound() covers finishing the stream; a sync flush adds an empty
+  // stored block instead, which is at most 5 bytes longer.
+  strip->deflated.resize(deflateBound(&stream, filtered.size()) + 8);
+  stream.next_in = &filtered[0];
+  stream.avail_in = static_cast<uInt>(filtered.size());
+  stream.next_out = &strip->deflated[0];
+  stream.avail_out = static_cast<uInt>(strip->deflated.size());
+  int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  strip->success = last ? result == Z_STREAM_END
+                        : result == Z_OK && stream.avail_in == 0 &&
+                              stream.avail_out > 0;
+  strip->deflated.resize(stream.total_out);
+  deflateEnd(&stream);
+}
+
+void DeflateStripAndSignal(const ParallelEncodeState* state,
+                           PngStrip* strip,
+                           base::WaitableEvent* done) {
+  DeflateStrip(state, strip);
+  done->Signal();
+}
+
+void AppendUint32(uint32_t value, std::vector<unsigned char>* output) {
+  output->push_back(static_cast<unsigned char>(value >> 24));
+  output->push_back(static_cast<unsigned char>(value >> 16));
+  output->push_back(static_cast<unsigned char>(value >> 8));
+  output->push_back(static_cast<unsigned char>(value));
+}
+
+// Appends a PNG chunk of |type| holding |data|.
+void AppendChunk(const char* type,
+                 const std::vector<unsigned char>& data,
+                 std::vector<unsigned char>* output) {
+  AppendUint32(static_cast<uint32_t>(data.size()), output);
+  size_t type_offset = output->size();
+  output->insert(output->end(), type, type + 4);
+  output->insert(output->end(), data.begin(), data.end());
+  uLong crc = crc32(crc32(0L, Z_NULL, 0), &(*output)[type_offset],
+                    static_cast<uInt>(output->size() - type_offset));
+  AppendUint32(static_cast<uint32_t>(crc), output);
+}
+
+// Encodes the 4 bytes per pixel |input| like InternalEncodeSkBitmap() does at
+// Z_BEST_SPEED, compressing strips of rows on worker threads. Returns false if
+// |input| is too small to be worth splitting, or on failure.
+bool ParallelEncodeSkBitmap(const SkBitmap& input,
+                            bool discard_transparency,
+                            std::vector<unsigned char>* output) {
+  if (input.empty() || input.isNull() || input.bytesPerPixel() != 4)
+    return false;
+
+  ParallelEncodeState state;
+  state.width = input.width();
+  state.height = input.height();
+  state.row_byte_width = static_cast<int>(input.rowBytes());
+  state.output_color_components = discard_transparency ? 3 : 4;
+  state.converter = discard_transparency ? ConvertSkiaToRGB : ConvertSkiaToRGBA;
+  int png_output_color_type =
+      discard_transparency ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA;
+
+  int64_t row_size =
+      static_cast<int64_t>(state.width) * state.output_color_components;
+  int rows_per_strip =
+      std::max(1, static_cast<int>(kBytesPerStrip / std::max<int64_t>(
+                                                        row_size, 1)));
+  int num_strips = (state.height + rows_per_strip - 1) / rows_per_strip;
+  if (num_strips < 2)
+    return false;
+
+  SkAutoLockPixels lock_input(input);
+  state.input = reinterpret_cast<const unsigned char*>(input.getAddr32(0, 0));
+  state.strips.resize(num_strips);
+  for (int i = 0; i < num_strips; ++i) {
+    state.strips[i].first_row = i * rows_per_strip;
+    state.strips[i].num_rows =
+        std::min(rows_per_strip, state.height - i * rows_per_strip);
+  }
+
+  // The first strip is compressed on this thread while the others are on
+  // worker threads.
+  std::vector<std::unique_ptr<base::WaitableEvent>> done(num_strips - 1);
+  for (int i = 1; i < num_strips; ++i) {
+    done[i - 1].reset(
+        new base::WaitableEvent(base::WaitableEvent::ResetPolicy::MANUAL,
+                                base::WaitableEvent::InitialState::NOT_SIGNALED));
+    base::WorkerPool::PostTask(
+        FROM_HERE,
+        base::Bind(&DeflateStripAndSignal, base::Unretained(&state),
+                   base::Unretained(&state.strips[i]),
+                   base::Unretained(done[i - 1].get())),
+        false);
+  }
+  DeflateStrip(&state, &state.strips[0]);
+  for (const auto& event : done)
+    event->Wait();
+
+  output->clear();
+  const unsigned char kPngSignature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+  output->insert(output->end(), kPngSignature,
+                 kPngSignature + arraysize(kPngSignature));
+
+  std::vector<unsigned char> header;
+  AppendUint32(state.width, &header);
+  AppendUint32(state.height, &header);
+  header.push_back(8);  // Bit depth.
+  header.push_back(static_cast<unsigned char>(png_output_color_type));
+  header.push_back(PNG_COMPRESSION_TYPE_BASE);
+  header.push_back(PNG_FILTER_TYPE_BASE);
+  header.push_back(PNG_INTERLACE_NONE);
+  AppendChunk("IHDR", header, output);
+
+  // Each strip goes in its own IDAT chunk, the first one preceded by the zlib
+  // header (deflate, 32K window, fastest compression) and the last followed by
+  // the Adler-32 checksum of all the filtered rows.
+  uLong adler = adler32(0L, Z_NULL, 0);
+  std::vector<unsigned char> data;
+  for (size_t i = 0; i < state.strips.size(); ++i) {
+    const PngStrip& strip = state.strips[i];
+    if (!strip.success)
+      return false;
+    data.clear();
+    if (i == 0) {
+      data.push_back(0x78);
+      data.push_back(0x01);
+    }
+    data.insert(data.end(), strip.deflated.begin(), strip.deflated.end());
+    adler = adler32_combine(adler, strip.adler, strip.filtered_size);
+    if (i == state.strips.size() - 1)
+      AppendUint32(static_cast<uint32_t>(adler), &data);
+    AppendChunk("IDAT", data, output);
+  }
+
+  AppendChunk("IEND", std::vector<unsigned char>(), output);
+  return true;
+}
+
+std::unique_ptr<std::vector<unsigned char>> ParallelFastEncodeToVector(
+    const SkBitmap& input,
+    bool discard_transparency) {
+  std::unique_ptr<std::vector<unsigned char>> output(
+      new std::vector<unsigned char>);
+  if (!PNGCodec::ParallelFastEncodeBGRASkBitmap(input, discard_transparency,
+                                                output.get())) {
+    output.reset();
+  }
+  return output;
+}
 
 }  // namespace
 
@@ -803,6 +1036,28 @@ bool PNGCodec::FastEncodeBGRASkBitmap(const SkBitmap& input,
                                 output);
 }
 
+// static
+bool PNGCodec::ParallelFastEncodeBGRASkBitmap(
+    const SkBitmap& input,
+    bool discard_transparency,
+    std::vector<unsigned char>* output) {
+  if (ParallelEncodeSkBitmap(input, discard_transparency, output))
+    return true;
+  return FastEncodeBGRASkBitmap(input, discard_transparency, output);
+}
+
+// static
+void PNGCodec::ParallelFastEncodeBGRASkBitmapAsync(
+    const SkBitmap& input,
+    bool discard_transparency,
+    base::TaskRunner* task_runner,
+    const EncodeCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      task_runner, FROM_HERE,
+      base::Bind(&ParallelFastEncodeToVector, input, discard_transparency),
+      callback);
+}
+
 PNGCodec::Comment::Comment(const std::string& k, const std::string& t)
     : key(k), text(t) {
 }
@@ -7,14 +7,20 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "base/callback_forward.h"
 #include "base/macros.h"
 #include "ui/gfx/gfx_export.h"
 
 class SkBitmap;
 
+namespace base {
+class TaskRunner;
+}
+
 namespace gfx {
 
 class Size;
@@ -96,6 +102,26 @@ class GFX_EXPORT PNGCodec {
                                      bool discard_transparency,
                                      std::vector<unsigned char>* output);
 
+  // Like FastEncodeBGRASkBitmap(), but bitmaps larger than about a megabyte
+  // are split into strips of rows that are compressed concurrently on worker
+  // threads. Meant for screenshots and other large images; the output is a
+  // little larger than FastEncodeBGRASkBitmap()'s. Blocks until done.
+  static bool ParallelFastEncodeBGRASkBitmap(
+      const SkBitmap& input,
+      bool discard_transparency,
+      std::vector<unsigned char>* output);
+
+  // Runs ParallelFastEncodeBGRASkBitmap() on |task_runner| and replies to
+  // |callback| on the calling thread with the PNG data, or null on failure.
+  // The pixels of |input| must not change until then.
+  typedef base::Callback<void(std::unique_ptr<std::vector<unsigned char>>)>
+      EncodeCallback;
+  static void ParallelFastEncodeBGRASkBitmapAsync(
+      const SkBitmap& input,
+      bool discard_transparency,
+      base::TaskRunner* task_runner,
+      const EncodeCallback& callback);
+
   // Call PNGCodec::Encode on the supplied SkBitmap |input|, which is assumed
   // to be kA8_Config, 8 bits per pixel. The bitmap is encoded as a grayscale
   // PNG with alpha used for color intensity. The |output| param is passed
@@ -1188,5 +1188,36 @@ TEST(PNGCodec, EncodeDecodeWithVaryingCompressionLevels) {
   EXPECT_TRUE(BitmapsAreEqual(decoded, original_bitmap));
 }
 
+TEST(PNGCodec, ParallelFastEncode) {
+  // Large enough to be split into several strips.
+  const int w = 1000, h = 700;
+  SkBitmap original_bitmap;
+  original_bitmap.allocN32Pixels(w, h);
+  uint32_t* src_data = original_bitmap.getAddr32(0, 0);
+  for (int i = 0; i < w * h; i++)
+    src_data[i] = SkPackARGB32(0xff, i % 255, i % 250, i % 245);
+
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(PNGCodec::ParallelFastEncodeBGRASkBitmap(original_bitmap, false,
+                                                       &encoded));
+  SkBitmap decoded;
+  ASSERT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(), &decoded));
+  EXPECT_TRUE(BitmapsAreEqual(decoded, original_bitmap));
+
+  ASSERT_TRUE(PNGCodec::ParallelFastEncodeBGRASkBitmap(original_bitmap, true,
+                                                       &encoded));
+  ASSERT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(), &decoded));
+  EXPECT_TRUE(BitmapsAreEqual(decoded, original_bitmap));
+
+  // Small bitmaps are encoded in one piece.
+  MakeTestBGRASkBitmap(20, 20, &original_bitmap);
+  std::vector<unsigned char> encoded_fast;
+  ASSERT_TRUE(PNGCodec::FastEncodeBGRASkBitmap(original_bitmap, false,
+                                               &encoded_fast));
+  ASSERT_TRUE(PNGCodec::ParallelFastEncodeBGRASkBitmap(original_bitmap, false,
+                                                       &encoded));
+  EXPECT_EQ(encoded_fast, encoded);
+}
+
 
 }  // namespace gfx
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <ostream>
 
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
@@ -25,6 +26,8 @@ namespace {
 
 static std::string* empty_string = NULL;
 static GURL* empty_gurl = NULL;
+// A GURL::Rep*, set by GURL::EmptyRep().
+static base::subtle::AtomicWord empty_rep = 0;
 
 #ifdef WIN32
 
@@ -65,17 +68,18 @@ const std::string& EmptyStringForGURL() {
 
 }  // namespace
 
-GURL::GURL() : is_valid_(false) {
+GURL::Rep::Rep() : is_valid(false) {
 }
 
-GURL::GURL(const GURL& other)
-    : spec_(other.spec_),
-      is_valid_(other.is_valid_),
-      parsed_(other.parsed_) {
-  if (other.inner_url_)
-    inner_url_.reset(new GURL(*other.inner_url_));
-  // Valid filesystem urls should always have an inner_url_.
-  DCHECK(!is_valid_ || !SchemeIsFileSystem() || inner_url_);
+GURL::Rep::~Rep() {
+}
+
+GURL::GURL() {
+}
+
+GURL::GURL(const GURL& other) : rep_(other.rep_) {
+  // Valid filesystem urls should always have an inner_url.
+  DCHECK(!is_valid() || !SchemeIsFileSystem() || inner_url());
 }
 
 GURL::GURL(base::StringPiece url_string) {
@@ -94,71 +98,76 @@ GURL::GURL(const char* canonical_spec,
            size_t canonical_spec_len,
            const url::Parsed& parsed,
            bool is_valid)
-    : spec_(canonical_spec, canonical_spec_len),
-      is_valid_(is_valid),
-      parsed_(parsed) {
+    : rep_(new Rep) {
+  rep_->spec.assign(canonical_spec, canonical_spec_len);
+  rep_->is_valid = is_valid;
+  rep_->parsed = parsed;
   InitializeFromCanonicalSpec();
 }
 
 GURL::GURL(std::string canonical_spec, const url::Parsed& parsed, bool is_valid)
-    : spec_(std::move(canonical_spec)), is_valid_(is_valid), parsed_(parsed) {
+    : rep_(new Rep) {
+  rep_->spec = std::move(canonical_spec);
+  rep_->is_valid = is_valid;
+  rep_->parsed = parsed;
   InitializeFromCanonicalSpec();
 }
 
 template<typename STR>
 void GURL::InitCanonical(base::BasicStringPiece<STR> input_spec,
                          bool trim_path_end) {
+  rep_ = new Rep;
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  spec_.reserve(input_spec.size() + 32);
-  url::StdStringCanonOutput output(&spec_);
-  is_valid_ = url::Canonicalize(
+  rep_->spec.reserve(input_spec.size() + 32);
+  rep_->is_valid = url::CanonicalizeToString(
       input_spec.data(), static_cast<int>(input_spec.length()), trim_path_end,
-      NULL, &output, &parsed_);
+      NULL, &rep_->spec, &rep_->parsed);
 
-  output.Complete();  // Must be done before using string.
-  if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_.reset(new GURL(spec_.data(), parsed_.Length(),
-                              *parsed_.inner_parsed(), true));
+  if (rep_->is_valid && SchemeIsFileSystem()) {
+    rep_->inner_url.reset(new GURL(rep_->spec.data(), rep_->parsed.Length(),
+                                   *rep_->parsed.inner_parsed(), true));
   }
 }
 
 void GURL::InitializeFromCanonicalSpec() {
-  if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_.reset(
-        new GURL(spec_.data(), parsed_.Length(),
-                 *parsed_.inner_parsed(), true));
+  Rep* rep = rep_.get();
+  if (rep->is_valid && SchemeIsFileSystem()) {
+    rep->inner_url.reset(
+        new GURL(rep->spec.data(), rep->parsed.Length(),
+                 *rep->parsed.inner_parsed(), true));
   }
 
 #ifndef NDEBUG
   // For testing purposes, check that the parsed canonical URL is identical to
   // what we would have produced. Skip checking for invalid URLs have no meaning
   // and we can't always canonicalize then reproducibly.
-  if (is_valid_) {
+  if (rep->is_valid) {
     url::Component scheme;
     // We can't do this check on the inner_url of a filesystem URL, as
     // canonical_spec actually points to the start of the outer URL, so we'd
     // end up with infinite recursion in this constructor.
-    if (!url::FindAndCompareScheme(spec_.data(), spec_.length(),
+    if (!url::FindAndCompareScheme(rep->spec.data(), rep->spec.length(),
                                    url::kFileSystemScheme, &scheme) ||
-        scheme.begin == parsed_.scheme.begin) {
-      // We need to retain trailing whitespace on path URLs, as the |parsed_|
+        scheme.begin == rep->parsed.scheme.begin) {
+      // We need to retain trailing whitespace on path URLs, as the |parsed|
       // spec we originally received may legitimately contain trailing white-
       // space on the path or  components e.g. if the #ref has been
       // removed from a "foo:hello #ref" URL (see http://crbug.com/291747).
-      GURL test_url(spec_, RETAIN_TRAILING_PATH_WHITEPACE);
-
-      DCHECK(test_url.is_valid_ == is_valid_);
-      DCHECK(test_url.spec_ == spec_);
-
-      DCHECK(test_url.parsed_.scheme == parsed_.scheme);
-      DCHECK(test_url.parsed_.username == parsed_.username);
-      DCHECK(test_url.parsed_.password == parsed_.password);
-      DCHECK(test_url.parsed_.host == parsed_.host);
-      DCHECK(test_url.parsed_.port == parsed_.port);
-      DCHECK(test_url.parsed_.path == parsed_.path);
-      DCHECK(test_url.parsed_.query == parsed_.query);
-      DCHECK(test_url.parsed_.ref == parsed_.ref);
+      GURL test_url(rep->spec, RETAIN_TRAILING_PATH_WHITEPACE);
+      const Rep& test_rep = test_url.rep();
+
+      DCHECK(test_rep.is_valid == rep->is_valid);
+      DCHECK(test_rep.spec == rep->spec);
+
+      DCHECK(test_rep.parsed.scheme == rep->parsed.scheme);
+      DCHECK(test_rep.parsed.username == rep->parsed.username);
+      DCHECK(test_rep.parsed.password == rep->parsed.password);
+      DCHECK(test_rep.parsed.host == rep->parsed.host);
+      DCHECK(test_rep.parsed.port == rep->parsed.port);
+      DCHECK(test_rep.parsed.path == rep->parsed.path);
+      DCHECK(test_rep.parsed.query == rep->parsed.query);
+      DCHECK(test_rep.parsed.ref == rep->parsed.ref);
     }
   }
 #endif
@@ -173,56 +182,61 @@ GURL& GURL::operator=(GURL other) {
 }
 
 const std::string& GURL::spec() const {
-  if (is_valid_ || spec_.empty())
-    return spec_;
+  const Rep& rep = this->rep();
+  if (rep.is_valid || rep.spec.empty())
+    return rep.spec;
 
   DCHECK(false) << "Trying to get the spec of an invalid URL!";
   return EmptyStringForGURL();
 }
 
 bool GURL::operator==(const GURL& other) const {
-  return spec_ == other.spec_;
+  return rep_ == other.rep_ || rep().spec == other.rep().spec;
 }
 
 bool GURL::operator!=(const GURL& other) const {
-  return spec_ != other.spec_;
+  return !(*this == other);
 }
 
 bool GURL::operator<(const GURL& other) const {
-  return spec_ < other.spec_;
+  return rep().spec < other.rep().spec;
 }
 
 bool GURL::operator>(const GURL& other) const {
-  return spec_ > other.spec_;
+  return rep().spec > other.rep().spec;
 }
 
 // Note: code duplicated below (it's inconvenient to use a template here).
 GURL GURL::Resolve(const std::string& relative) const {
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const Rep& rep = this->rep();
   GURL result;
+  result.rep_ = new Rep;
+  Rep* result_rep = result.rep_.get();
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url::StdStringCanonOutput output(&result.spec_);
-
-  if (!url::ResolveRelative(spec_.data(), static_cast<int>(spec_.length()),
-                            parsed_, relative.data(),
-                            static_cast<int>(relative.length()),
-                            nullptr, &output, &result.parsed_)) {
+  result_rep->spec.reserve(rep.spec.size() + 32);
+  url::StdStringCanonOutput output(&result_rep->spec);
+
+  if (!url::ResolveRelative(rep.spec.data(),
+                            static_cast<int>(rep.spec.length()), rep.parsed,
+                            relative.data(),
+                            static_cast<int>(relative.length()), nullptr,
+                            &output, &result_rep->parsed)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
-  result.is_valid_ = true;
+  result_rep->is_valid = true;
   if (result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
-                 *result.parsed_.inner_parsed(), true));
+    result_rep->inner_url.reset(
+        new GURL(result_rep->spec.data(), result_rep->parsed.Length(),
+                 *result_rep->parsed.inner_parsed(), true));
   }
   return result;
 }
@@ -230,30 +244,34 @@ GURL GURL::Resolve(const std::string& relative) const {
 // Note: code duplicated above (it's inconvenient to use a template here).
 GURL GURL::Resolve(const base::string16& relative) const {
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const Rep& rep = this->rep();
   GURL result;
+  result.rep_ = new Rep;
+  Rep* result_rep = result.rep_.get();
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url::StdStringCanonOutput output(&result.spec_);
-
-  if (!url::ResolveRelative(spec_.data(), static_cast<int>(spec_.length()),
-                            parsed_, relative.data(),
-                            static_cast<int>(relative.length()),
-                            nullptr, &output, &result.parsed_)) {
+  result_rep->spec.reserve(rep.spec.size() + 32);
+  url::StdStringCanonOutput output(&result_rep->spec);
+
+  if (!url::ResolveRelative(rep.spec.data(),
+                            static_cast<int>(rep.spec.length()), rep.parsed,
+                            relative.data(),
+                            static_cast<int>(relative.length()), nullptr,
+                            &output, &result_rep->parsed)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
-  result.is_valid_ = true;
+  result_rep->is_valid = true;
   if (result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
-                 *result.parsed_.inner_parsed(), true));
+    result_rep->inner_url.reset(
+        new GURL(result_rep->spec.data(), result_rep->parsed.Length(),
+                 *result_rep->parsed.inner_parsed(), true));
   }
   return result;
 }
@@ -261,26 +279,29 @@ GURL GURL::Resolve(const base::string16& relative) const {
 // Note: code duplicated below (it's inconvenient to use a template here).
 GURL GURL::ReplaceComponents(
     const url::Replacements<char>& replacements) const {
-  GURL result;
-
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const Rep& rep = this->rep();
+  GURL result;
+  result.rep_ = new Rep;
+  Rep* result_rep = result.rep_.get();
+
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url::StdStringCanonOutput output(&result.spec_);
+  result_rep->spec.reserve(rep.spec.size() + 32);
+  url::StdStringCanonOutput output(&result_rep->spec);
 
-  result.is_valid_ = url::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+  result_rep->is_valid = url::ReplaceComponents(
+      rep.spec.data(), static_cast<int>(rep.spec.length()), rep.parsed,
+      replacements, NULL, &output, &result_rep->parsed);
 
   output.Complete();
-  if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(result.spec_.data(),
-                                     result.parsed_.Length(),
-                                     *result.parsed_.inner_parsed(), true));
+  if (result_rep->is_valid && result.SchemeIsFileSystem()) {
+    result_rep->inner_url.reset(
+        new GURL(result_rep->spec.data(), result_rep->parsed.Length(),
+                 *result_rep->parsed.inner_parsed(), true));
   }
   return result;
 }
@@ -288,26 +309,29 @@ GURL GURL::ReplaceComponents(
 // Note: code duplicated above (it's inconvenient to use a template here).
 GURL GURL::ReplaceComponents(
     const url::Replacements<base::char16>& replacements) const {
-  GURL result;
-
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const Rep& rep = this->rep();
+  GURL result;
+  result.rep_ = new Rep;
+  Rep* result_rep = result.rep_.get();
+
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url::StdStringCanonOutput output(&result.spec_);
+  result_rep->spec.reserve(rep.spec.size() + 32);
+  url::StdStringCanonOutput output(&result_rep->spec);
 
-  result.is_valid_ = url::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+  result_rep->is_valid = url::ReplaceComponents(
+      rep.spec.data(), static_cast<int>(rep.spec.length()), rep.parsed,
+      replacements, NULL, &output, &result_rep->parsed);
 
   output.Complete();
-  if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(result.spec_.data(),
-                                     result.parsed_.Length(),
-                                     *result.parsed_.inner_parsed(), true));
+  if (result_rep->is_valid && result.SchemeIsFileSystem()) {
+    result_rep->inner_url.reset(
+        new GURL(result_rep->spec.data(), result_rep->parsed.Length(),
+                 *result_rep->parsed.inner_parsed(), true));
   }
   return result;
 }
@@ -315,11 +339,11 @@ GURL GURL::ReplaceComponents(
 GURL GURL::GetOrigin() const {
   // This doesn't make sense for invalid or nonstandard URLs, so return
   // the empty URL.
-  if (!is_valid_ || !IsStandard())
+  if (!is_valid() || !IsStandard())
     return GURL();
 
   if (SchemeIsFileSystem())
-    return inner_url_->GetOrigin();
+    return inner_url()->GetOrigin();
 
   url::Replacements<char> replacements;
   replacements.ClearUsername();
@@ -348,36 +372,41 @@ GURL GURL::GetAsReferrer() const {
 GURL GURL::GetWithEmptyPath() const {
   // This doesn't make sense for invalid or nonstandard URLs, so return
   // the empty URL.
-  if (!is_valid_ || !IsStandard())
+  if (!is_valid() || !IsStandard())
     return GURL();
 
-  // We could optimize this since we know that the URL is canonical, and we are
-  // appending a canonical path, so avoiding re-parsing.
-  GURL other(*this);
-  if (parsed_.path.len == 0)
-    return other;
-
-  // Clear everything after the path.
-  other.parsed_.query.reset();
-  other.parsed_.ref.reset();
-
-  // Set the path, since the path is longer than one, we can just set the
-  // first character and resize.
-  other.spec_[other.parsed_.path.begin] = '/';
-  other.parsed_.path.len = 1;
-  other.spec_.resize(other.parsed_.path.begin + 1);
+  const Rep& rep = this->rep();
+  if (rep.parsed.path.len == 0)
+    return *this;
+
+  // We know that the URL is canonical and that "/" is a canonical path, so
+  // build the new spec without re-parsing: keep everything before the path and
+  // clear everything after it.
+  GURL other;
+  other.rep_ = new Rep;
+  Rep* other_rep = other.rep_.get();
+  other_rep->spec.reserve(rep.parsed.path.begin + 1);
+  other_rep->spec.assign(rep.spec, 0, rep.parsed.path.begin);
+  other_rep->spec.push_back('/');
+  other_rep->is_valid = true;
+  other_rep->parsed = rep.parsed;
+  other_rep->parsed.path.len = 1;
+  other_rep->parsed.query.reset();
+  other_rep->parsed.ref.reset();
+  if (rep.inner_url)
+    other_rep->inner_url.reset(new GURL(*rep.inner_url));
   return other;
 }
 
 bool GURL::IsStandard() const {
-  return url::IsStandard(spec_.data(), parsed_.scheme);
+  return url::IsStandard(rep().spec.data(), rep().parsed.scheme);
 }
 
 bool GURL::SchemeIs(base::StringPiece lower_ascii_scheme) const {
   DCHECK(base::IsStringASCII(lower_ascii_scheme));
   DCHECK(base::ToLowerASCII(lower_ascii_scheme) == lower_ascii_scheme);
 
-  if (parsed_.scheme.len <= 0)
+  if (rep().parsed.scheme.len <= 0)
     return lower_ascii_scheme.empty();
   return scheme_piece() == lower_ascii_scheme;
 }
@@ -387,7 +416,8 @@ bool GURL::SchemeIsHTTPOrHTTPS() const {
 }
 
 bool GURL::SchemeIsValidForReferrer() const {
-  return is_valid_ && IsReferrerScheme(spec_.data(), parsed_.scheme);
+  return is_valid() &&
+         IsReferrerScheme(rep().spec.data(), rep().parsed.scheme);
 }
 
 bool GURL::SchemeIsWSOrWSS() const {
@@ -395,48 +425,51 @@ bool GURL::SchemeIsWSOrWSS() const {
 }
 
 int GURL::IntPort() const {
-  if (parsed_.port.is_nonempty())
-    return url::ParsePort(spec_.data(), parsed_.port);
+  const Rep& rep = this->rep();
+  if (rep.parsed.port.is_nonempty())
+    return url::ParsePort(rep.spec.data(), rep.parsed.port);
   return url::PORT_UNSPECIFIED;
 }
 
 int GURL::EffectiveIntPort() const {
   int int_port = IntPort();
   if (int_port == url::PORT_UNSPECIFIED && IsStandard())
-    return url::DefaultPortForScheme(spec_.data() + parsed_.scheme.begin,
-                                     parsed_.scheme.len);
+    return url::DefaultPortForScheme(
+        rep().spec.data() + rep().parsed.scheme.begin, rep().parsed.scheme.len);
   return int_port;
 }
 
 std::string GURL::ExtractFileName() const {
   url::Component file_component;
-  url::ExtractFileName(spec_.data(), parsed_.path, &file_component);
+  url::ExtractFileName(rep().spec.data(), rep().parsed.path, &file_component);
   return ComponentString(file_component);
 }
 
 std::string GURL::PathForRequest() const {
-  DCHECK(parsed_.path.len > 0)
+  const Rep& rep = this->rep();
+  DCHECK(rep.parsed.path.len > 0)
       << "Canonical path for requests should be non-empty";
-  if (parsed_.ref.len >= 0) {
+  if (rep.parsed.ref.len >= 0) {
     // Clip off the reference when it exists. The reference starts after the
     // #-sign, so we have to subtract one to also remove it.
-    return std::string(spec_, parsed_.path.begin,
-                       parsed_.ref.begin - parsed_.path.begin - 1);
+    return std::string(rep.spec, rep.parsed.path.begin,
+                       rep.parsed.ref.begin - rep.parsed.path.begin - 1);
   }
   // Compute the actual path length, rather than depending on the spec's
   // terminator. If we're an inner_url, our spec continues on into our outer
   // URL's path/query/ref.
-  int path_len = parsed_.path.len;
-  if (parsed_.query.is_valid())
-    path_len = parsed_.query.end() - parsed_.path.begin;
+  int path_len = rep.parsed.path.len;
+  if (rep.parsed.query.is_valid())
+    path_len = rep.parsed.query.end() - rep.parsed.path.begin;
 
-  return std::string(spec_, parsed_.path.begin, path_len);
+  return std::string(rep.spec, rep.parsed.path.begin, path_len);
 }
 
 std::string GURL::HostNoBrackets() const {
   // If host looks like an IPv6 literal, strip the square brackets.
-  url::Component h(parsed_.host);
-  if (h.len >= 2 && spec_[h.begin] == '[' && spec_[h.end() - 1] == ']') {
+  const Rep& rep = this->rep();
+  url::Component h(rep.parsed.host);
+  if (h.len >= 2 && rep.spec[h.begin] == '[' && rep.spec[h.end() - 1] == ']') {
     h.begin++;
     h.len -= 2;
   }
@@ -444,17 +477,18 @@ std::string GURL::HostNoBrackets() const {
 }
 
 std::string GURL::GetContent() const {
-  return is_valid_ ? ComponentString(parsed_.GetContent()) : std::string();
+  return is_valid() ? ComponentString(rep().parsed.GetContent())
+                    : std::string();
 }
 
 bool GURL::HostIsIPAddress() const {
-  if (!is_valid_ || spec_.empty())
+  if (!is_valid() || is_empty())
      return false;
 
   url::RawCanonOutputT<char, 128> ignored_output;
   url::CanonHostInfo host_info;
-  url::CanonicalizeIPAddress(spec_.c_str(), parsed_.host, &ignored_output,
-                             &host_info);
+  url::CanonicalizeIPAddress(rep().spec.c_str(), rep().parsed.host,
+                             &ignored_output, &host_info);
   return host_info.IsIPAddress();
 }
 
@@ -491,20 +525,21 @@ const GURL& GURL::EmptyGURL() {
 #endif  // WIN32
 
 bool GURL::DomainIs(base::StringPiece lower_ascii_domain) const {
-  if (!is_valid_ || lower_ascii_domain.empty())
+  if (!is_valid() || lower_ascii_domain.empty())
     return false;
 
-  // FileSystem URLs have empty parsed_.host, so check this first.
-  if (SchemeIsFileSystem() && inner_url_)
-    return inner_url_->DomainIs(lower_ascii_domain);
+  // FileSystem URLs have empty parsed.host, so check this first.
+  if (SchemeIsFileSystem() && inner_url())
+    return inner_url()->DomainIs(lower_ascii_domain);
 
-  if (!parsed_.host.is_nonempty())
+  const Rep& rep = this->rep();
+  if (!rep.parsed.host.is_nonempty())
     return false;
 
   // If the host name ends with a dot but the input domain doesn't,
   // then we ignore the dot in the host name.
-  const char* host_last_pos = spec_.data() + parsed_.host.end() - 1;
-  int host_len = parsed_.host.len;
+  const char* host_last_pos = rep.spec.data() + rep.parsed.host.end() - 1;
+  int host_len = rep.parsed.host.len;
   int domain_len = lower_ascii_domain.length();
   if ('.' == *host_last_pos && '.' != lower_ascii_domain[domain_len - 1]) {
     host_last_pos--;
@@ -516,7 +551,7 @@ bool GURL::DomainIs(base::StringPiece lower_ascii_domain) const {
 
   // |host_first_pos| is the start of the compared part of the host name, not
   // start of the whole host name.
-  const char* host_first_pos = spec_.data() + parsed_.host.begin +
+  const char* host_first_pos = rep.spec.data() + rep.parsed.host.begin +
                                host_len - domain_len;
 
   if (!base::LowerCaseEqualsASCII(
@@ -534,11 +569,26 @@ bool GURL::DomainIs(base::StringPiece lower_ascii_domain) const {
   return true;
 }
 
+// static
+const GURL::Rep& GURL::EmptyRep() {
+  base::subtle::AtomicWord rep = base::subtle::Acquire_Load(&empty_rep);
+  if (!rep) {
+    // The empty Rep is leaked, like the empty GURL. If another thread creates
+    // one at the same time, only the first one is kept.
+    Rep* new_rep = new Rep;
+    new_rep->AddRef();
+    rep = base::subtle::Release_CompareAndSwap(
+        &empty_rep, 0, reinterpret_cast<base::subtle::AtomicWord>(new_rep));
+    if (rep)
+      new_rep->Release();
+    else
+      rep = reinterpret_cast<base::subtle::AtomicWord>(new_rep);
+  }
+  return *reinterpret_cast<const Rep*>(rep);
+}
+
 void GURL::Swap(GURL* other) {
-  spec_.swap(other->spec_);
-  std::swap(is_valid_, other->is_valid_);
-  std::swap(parsed_, other->parsed_);
-  inner_url_.swap(other->inner_url_);
+  rep_.swap(other->rep_);
 }
 
 std::ostream& operator<<(std::ostream& out, const GURL& url) {
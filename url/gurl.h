@@ -11,6 +11,8 @@
 #include <memory>
 #include <string>
 
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
 #include "url/third_party/mozilla/url_parse.h"
@@ -51,8 +53,8 @@ class URL_EXPORT GURL {
   // Creates an empty, invalid URL.
   GURL();
 
-  // Copy construction is relatively inexpensive, with most of the time going
-  // to reallocating the string. It does not re-parse.
+  // Copy construction is inexpensive: copies share the spec and parsed
+  // components, which never change, so it neither re-parses nor allocates.
   GURL(const GURL& other);
 
   // The strings to this contructor should be UTF-8 / UTF-16.
@@ -84,14 +86,14 @@ class URL_EXPORT GURL {
   // "reasonable looking" so that the user can see how it's busted if
   // displayed to them.
   bool is_valid() const {
-    return is_valid_;
+    return rep().is_valid;
   }
 
   // Returns true if the URL is zero-length. Note that empty URLs are also
   // invalid, and is_valid() will return false for them. This is provided
   // because some users may want to treat the empty case differently.
   bool is_empty() const {
-    return spec_.empty();
+    return rep().spec.empty();
   }
 
   // Returns the raw spec, i.e., the full text of the URL, in canonical UTF-8,
@@ -117,7 +119,7 @@ class URL_EXPORT GURL {
   //
   // The returned string is guaranteed to be valid UTF-8.
   const std::string& possibly_invalid_spec() const {
-    return spec_;
+    return rep().spec;
   }
 
   // Getter for the raw parsed structure. This allows callers to locate parts
@@ -129,7 +131,7 @@ class URL_EXPORT GURL {
   // SURE YOU ARE USING possibly_invalid_spec() to get the spec, and that you
   // don't do anything "important" with invalid specs.
   const url::Parsed& parsed_for_possibly_invalid_spec() const {
-    return parsed_;
+    return rep().parsed;
   }
 
   // Defiant equality operator!
@@ -259,33 +261,33 @@ class URL_EXPORT GURL {
 
   // Not including the colon. If you are comparing schemes, prefer SchemeIs.
   bool has_scheme() const {
-    return parsed_.scheme.len >= 0;
+    return rep().parsed.scheme.len >= 0;
   }
   std::string scheme() const {
-    return ComponentString(parsed_.scheme);
+    return ComponentString(rep().parsed.scheme);
   }
   base::StringPiece scheme_piece() const {
-    return ComponentStringPiece(parsed_.scheme);
+    return ComponentStringPiece(rep().parsed.scheme);
   }
 
   bool has_username() const {
-    return parsed_.username.len >= 0;
+    return rep().parsed.username.len >= 0;
   }
   std::string username() const {
-    return ComponentString(parsed_.username);
+    return ComponentString(rep().parsed.username);
   }
   base::StringPiece username_piece() const {
-    return ComponentStringPiece(parsed_.username);
+    return ComponentStringPiece(rep().parsed.username);
   }
 
   bool has_password() const {
-    return parsed_.password.len >= 0;
+    return rep().parsed.password.len >= 0;
   }
   std::string password() const {
-    return ComponentString(parsed_.password);
+    return ComponentString(rep().parsed.password);
   }
   base::StringPiece password_piece() const {
-    return ComponentStringPiece(parsed_.password);
+    return ComponentStringPiece(rep().parsed.password);
   }
 
   // The host may be a hostname, an IPv4 address, or an IPv6 literal surrounded
@@ -293,61 +295,61 @@ class URL_EXPORT GURL {
   // HostNoBrackets() below.
   bool has_host() const {
     // Note that hosts are special, absence of host means length 0.
-    return parsed_.host.len > 0;
+    return rep().parsed.host.len > 0;
   }
   std::string host() const {
-    return ComponentString(parsed_.host);
+    return ComponentString(rep().parsed.host);
   }
   base::StringPiece host_piece() const {
-    return ComponentStringPiece(parsed_.host);
+    return ComponentStringPiece(rep().parsed.host);
   }
 
   // The port if one is explicitly specified. Most callers will want IntPort()
   // or EffectiveIntPort() instead of these. The getters will not include the
   // ':'.
   bool has_port() const {
-    return parsed_.port.len >= 0;
+    return rep().parsed.port.len >= 0;
   }
   std::string port() const {
-    return ComponentString(parsed_.port);
+    return ComponentString(rep().parsed.port);
   }
   base::StringPiece port_piece() const {
-    return ComponentStringPiece(parsed_.port);
+    return ComponentStringPiece(rep().parsed.port);
   }
 
   // Including first slash following host, up to the query. The URL
   // "http://www.google.com/" has a path of "/".
   bool has_path() const {
-    return parsed_.path.len >= 0;
+    return rep().parsed.path.len >= 0;
   }
   std::string path() const {
-    return ComponentString(parsed_.path);
+    return ComponentString(rep().parsed.path);
   }
   base::StringPiece path_piece() const {
-    return ComponentStringPiece(parsed_.path);
+    return ComponentStringPiece(rep().parsed.path);
   }
 
   // Stuff following '?' up to the ref. The getters will not include the '?'.
   bool has_query() const {
-    return parsed_.query.len >= 0;
+    return rep().parsed.query.len >= 0;
   }
   std::string query() const {
-    return ComponentString(parsed_.query);
+    return ComponentString(rep().parsed.query);
   }
   base::StringPiece query_piece() const {
-    return ComponentStringPiece(parsed_.query);
+    return ComponentStringPiece(rep().parsed.query);
   }
 
   // Stuff following '#' to the end of the string. This will be UTF-8 encoded
   // (not necessarily ASCII). The getters will not include the '#'.
   bool has_ref() const {
-    return parsed_.ref.len >= 0;
+    return rep().parsed.ref.len >= 0;
   }
   std::string ref() const {
-    return ComponentString(parsed_.ref);
+    return ComponentString(rep().parsed.ref);
   }
   base::StringPiece ref_piece() const {
-    return ComponentStringPiece(parsed_.ref);
+    return ComponentStringPiece(rep().parsed.ref);
   }
 
   // Returns a parsed version of the port. Can also be any of the special
@@ -399,7 +401,7 @@ class URL_EXPORT GURL {
   // caling spec() on the GURL itself. This should be fixed.
   // See https://crbug.com/619596
   const GURL* inner_url() const {
-    return inner_url_.get();
+    return rep().inner_url.get();
   }
 
  private:
@@ -415,33 +417,56 @@ class URL_EXPORT GURL {
   void InitCanonical(base::BasicStringPiece<STR> input_spec,
                      bool trim_path_end);
 
+  // Sets the inner URL of a filesystem: URL from |rep_|, and in debug builds,
+  // checks that |rep_| is what canonicalizing its spec would produce.
   void InitializeFromCanonicalSpec();
 
   // Returns the substring of the input identified by the given component.
   std::string ComponentString(const url::Component& comp) const {
     if (comp.len <= 0)
       return std::string();
-    return std::string(spec_, comp.begin, comp.len);
+    return std::string(rep().spec, comp.begin, comp.len);
   }
   base::StringPiece ComponentStringPiece(const url::Component& comp) const {
     if (comp.len <= 0)
       return base::StringPiece();
-    return base::StringPiece(&spec_[comp.begin], comp.len);
+    return base::StringPiece(&rep().spec[comp.begin], comp.len);
   }
 
-  // The actual text of the URL, in canonical ASCII form.
-  std::string spec_;
+  // The state of a GURL. It's never modified once the GURL that created it
+  // has been initialized, so copies of a GURL share it rather than copying
+  // the spec.
+  class Rep : public base::RefCountedThreadSafe<Rep> {
+   public:
+    Rep();
 
-  // Set when the given URL is valid. Otherwise, we may still have a spec and
-  // components, but they may not identify valid resources (for example, an
-  // invalid port number, invalid characters in the scheme, etc.).
-  bool is_valid_;
+    // The actual text of the URL, in canonical ASCII form.
+    std::string spec;
 
-  // Identified components of the canonical spec.
-  url::Parsed parsed_;
+    // Set when the given URL is valid. Otherwise, we may still have a spec and
+    // components, but they may not identify valid resources (for example, an
+    // invalid port number, invalid characters in the scheme, etc.).
+    bool is_valid;
 
-  // Used for nested schemes [currently only filesystem:].
-  std::unique_ptr<GURL> inner_url_;
+    // Identified components of the canonical spec.
+    url::Parsed parsed;
+
+    // Used for nested schemes [currently only filesystem:].
+    std::unique_ptr<GURL> inner_url;
+
+   private:
+    friend class base::RefCountedThreadSafe<Rep>;
+    ~Rep();
+
+    DISALLOW_COPY_AND_ASSIGN(Rep);
+  };
+
+  // Returns |rep_|, or an empty Rep if this is an empty GURL.
+  const Rep& rep() const { return rep_ ? *rep_ : EmptyRep(); }
+  static const Rep& EmptyRep();
+
+  // Null for empty GURLs, so that default-constructed GURLs don't allocate.
+  scoped_refptr<Rep> rep_;
 };
 
 // Stream operator so GURL can be used in assertion statements.
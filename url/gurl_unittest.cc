@@ -132,6 +132,9 @@ TEST(GURLTest, Copy) {
   EXPECT_EQ("q=a", url2.query());
   EXPECT_EQ("ref", url2.ref());
 
+  // Copies share the spec rather than copying it.
+  EXPECT_EQ(url.spec().data(), url2.spec().data());
+
   // Copying of invalid URL should be invalid
   GURL invalid;
   GURL invalid2(invalid);
@@ -385,6 +388,24 @@ TEST(GURLTest, GetWithEmptyPath) {
   }
 }
 
+// GetWithEmptyPath() builds a new URL rather than modifying a shared one.
+TEST(GURLTest, GetWithEmptyPathLeavesOriginalUnchanged) {
+  GURL url("http://www.google.com/foo/bar.html?baz=22#ref");
+  GURL copy(url);
+  EXPECT_EQ("http://www.google.com/", url.GetWithEmptyPath().spec());
+  EXPECT_EQ("http://www.google.com/foo/bar.html?baz=22#ref", url.spec());
+  EXPECT_EQ("http://www.google.com/foo/bar.html?baz=22#ref", copy.spec());
+  EXPECT_EQ("/foo/bar.html", copy.path());
+  EXPECT_EQ("baz=22", copy.query());
+
+  GURL filesystem_url("filesystem:http://www.google.com/temporary/bar.html");
+  GURL empty_path = filesystem_url.GetWithEmptyPath();
+  EXPECT_EQ("filesystem:http://www.google.com/temporary/", empty_path.spec());
+  ASSERT_TRUE(empty_path.inner_url());
+  EXPECT_EQ("/temporary", empty_path.inner_url()->path());
+  EXPECT_EQ("/bar.html", filesystem_url.path());
+}
+
 TEST(GURLTest, Replacements) {
   // The URL canonicalizer replacement test will handle most of these case.
   // The most important thing to do here is to check that the proper
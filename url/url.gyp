@@ -118,6 +118,21 @@
       # TODO(jschuh): crbug.com/167187 fix size_t to int truncations.
       'msvs_disabled_warnings': [4267, ],
     },
+    {
+      'target_name': 'url_perftests',
+      'type': 'executable',
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
+        'url_lib',
+      ],
+      'sources': [
+        'url_canon_perftest.cc',
+      ],
+    },
     {
       'target_name': 'url_interfaces_mojom',
       'type': 'none',
@@ -90,6 +90,21 @@ void ScanHostname(const CHAR* spec,
   }
 }
 
+// Returns the number of characters at the start of |host| that are already
+// canonical, such as lowercase letters, digits, '-' and '.'. |host| must be
+// entirely 7-bit.
+template<typename CHAR>
+int CanonicalHostPrefixLength(const CHAR* host, int host_len) {
+  for (int i = 0; i < host_len; i++) {
+    unsigned char ch = static_cast<unsigned char>(host[i]);
+    // A lookup value of 0 means the character is invalid, so NULs are never
+    // canonical.
+    if (ch == 0 || kHostCharLookup[ch] != ch)
+      return i;
+  }
+  return host_len;
+}
+
 // Canonicalizes a host name that is entirely 8-bit characters (even though
 // the type holding them may be 16 bits. Escaped characters will be unescaped.
 // Non-7-bit characters (for example, UTF-8) will be passed unchanged.
@@ -328,8 +343,13 @@ void DoHost(const CHAR* spec,
 
   bool success;
   if (!has_non_ascii && !has_escaped) {
-    success = DoSimpleHost(&spec[host.begin], host.len,
-                           output, &has_non_ascii);
+    // Most hosts are already canonical, so copy as much as possible as is
+    // before canonicalizing the rest character by character.
+    int canonical_len =
+        CanonicalHostPrefixLength(&spec[host.begin], host.len);
+    AppendASCIIRun(&spec[host.begin], canonical_len, output);
+    success = DoSimpleHost(&spec[host.begin + canonical_len],
+                           host.len - canonical_len, output, &has_non_ascii);
     DCHECK(!has_non_ascii);
   } else {
     success = DoComplexHost(&spec[host.begin], host.len,
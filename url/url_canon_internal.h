@@ -82,6 +82,19 @@ void AppendStringOfType(const base::char16* source, int length,
                         SharedCharTypes type,
                         CanonOutput* output);
 
+// Appends |length| characters of |source| to the output unchanged. They must
+// all be 7-bit. The canonicalizers use this to copy runs of input that are
+// already canonical in one go rather than one character at a time.
+inline void AppendASCIIRun(const char* source, int length,
+                           CanonOutput* output) {
+  output->Append(source, length);
+}
+inline void AppendASCIIRun(const base::char16* source, int length,
+                           CanonOutput* output) {
+  for (int i = 0; i < length; i++)
+    output->push_back(static_cast<char>(source[i]));
+}
+
 // Maps the hex numerical values 0x0 to 0xf to the corresponding ASCII digit
 // that will be used to represent it.
 URL_EXPORT extern const char kHexCharLookup[0x10];
@@ -77,6 +77,13 @@ const unsigned char kPathCharLookup[0x100] = {
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE};
 
+// Returns true if |ch| can be copied to the output unchanged, which is the
+// case for most of a typical path.
+template<typename UCHAR>
+inline bool IsPlainPathChar(UCHAR ch) {
+  return ch < 0x80 && !(kPathCharLookup[ch] & SPECIAL);
+}
+
 enum DotDisposition {
   // The given dot is just part of a filename and is not special.
   NOT_A_DIRECTORY,
@@ -369,8 +376,14 @@ bool DoPartialPath(const CHAR* spec,
           AppendEscapedChar(out_ch, output);
         }
       } else {
-        // Nothing special about this character, just append it.
-        output->push_back(out_ch);
+        // Nothing special about this character. Copy it along with the rest
+        // of the run of characters that have nothing special about them.
+        int run_end = i + 1;
+        while (run_end < end &&
+               IsPlainPathChar(static_cast<UCHAR>(spec[run_end])))
+          run_end++;
+        AppendASCIIRun(&spec[i], run_end - i, output);
+        i = run_end - 1;
       }
     }
   }
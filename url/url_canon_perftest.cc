@@ -0,0 +1,153 @@
+// Copyright 2016 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+#include "url/third_party/mozilla/url_parse.h"
+#include "url/url_canon_stdstring.h"
+
+namespace url {
+
+namespace {
+
+// URLs of the kinds a page load requests: navigations, search results,
+// scripts and images on CDNs with long query strings, API calls, and pages
+// with escaped paths. All are already canonical, as URLs that come from the
+// network stack or from storage usually are.
+const char* const kCanonicalURLs[] = {
+    "https://www.google.com/",
+    "https://www.google.com/search?q=chromium+url+parsing&oq=chromium+url&"
+    "aqs=chrome.0.69i59j69i57j0l4.3146j0j7&sourceid=chrome&ie=UTF-8",
+    "https://en.wikipedia.org/wiki/Uniform_Resource_Locator",
+    "https://en.wikipedia.org/wiki/%C3%89cole_normale_sup%C3%A9rieure",
+    "https://upload.wikimedia.org/wikipedia/commons/thumb/d/d6/"
+    "URI_syntax_diagram.svg/1068px-URI_syntax_diagram.svg.png",
+    "https://www.youtube.com/watch?v=dQw4w9WgXcQ&list=PL1234567890&index=3",
+    "https://i.ytimg.com/vi/dQw4w9WgXcQ/hqdefault.jpg?sqp=-oaymwEjCPYBEIoBSF"
+    "ryq4qpAxUIARUAAAAAGAElAADIQj0AgKJDeAE=&rs=AOn4CLBx",
+    "https://fonts.googleapis.com/css?family=Roboto:300,400,500,700&"
+    "display=swap",
+    "https://ajax.googleapis.com/ajax/libs/jquery/3.1.0/jquery.min.js",
+    "https://cdn.example-cdn.net/assets/app-3f9a1c2b7d.bundle.js",
+    "https://static.xx.fbcdn.net/rsrc.php/v3/yb/r/GsNJNwuI-UM.gif",
+    "https://api.example.com/v2/users/12345/repos?per_page=100&page=2&"
+    "sort=updated",
+    "https://www.amazon.com/dp/B00EXAMPLE/ref=sr_1_1?ie=UTF8&qid=1466000000&"
+    "sr=8-1&keywords=usb+c+cable",
+    "https://mail.google.com/mail/u/0/#inbox/15a1b2c3d4e5f6a7",
+    "https://docs.example.org/en-US/docs/Web/API/URL/URL#Examples",
+    "https://accounts.example.com/ServiceLogin?service=mail&passive=true&"
+    "continue=https%3A%2F%2Fmail.example.com%2Fmail%2F",
+    "https://ad.doubleclick.net/ddm/activity/src=1234567;type=invmedia;"
+    "cat=abcdefg;ord=1234567890123?",
+    "https://www.example.com:8443/path/to/resource.html",
+    "http://192.168.1.1/admin/status.cgi",
+    "http://localhost:8080/index.html",
+};
+
+// URLs as a user or a page might write them, which do need work.
+const char* const kNonCanonicalURLs[] = {
+    "HTTPS://WWW.GOOGLE.COM",
+    "https://www.Example.com/a/b/../c/./d.html",
+    "http://example.com\\windows\\style\\path",
+    "https://www.example.com/path with spaces/file name.pdf",
+    "https://example.com/search?q=caf\xC3\xA9&lang=fr",
+    "https://www.example.com:443/default/port",
+    "http://example.com/%7Euser/%41%42%43",
+    "https://EXAMPLE.com/Upper/Case/Path/Is/Kept?Q=Kept#Ref",
+};
+
+// Roughly the number of URLs each measurement canonicalizes.
+const size_t kURLsPerMeasurement = 200 * 1000;
+
+std::vector<std::string> MakeCorpus(const char* const* urls, size_t count) {
+  return std::vector<std::string>(urls, urls + count);
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& corpus,
+                 base::TimeDelta elapsed,
+                 size_t num_urls) {
+  perf_test::PrintResult(measurement, "", corpus,
+                         elapsed.InMillisecondsF() * 1000000 / num_urls,
+                         "ns/url", true);
+}
+
+void MeasureGURL(const std::string& corpus_name,
+                 const std::vector<std::string>& corpus) {
+  const size_t rounds = kURLsPerMeasurement / corpus.size();
+  size_t valid = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (const std::string& spec : corpus)
+      valid += GURL(spec).is_valid();
+  }
+  PrintResult("GURL_construct", corpus_name, base::TimeTicks::Now() - start,
+              rounds * corpus.size());
+  EXPECT_EQ(rounds * corpus.size(), valid);
+}
+
+void MeasureCanonicalizeToString(const std::string& corpus_name,
+                                 const std::vector<std::string>& corpus) {
+  const size_t rounds = kURLsPerMeasurement / corpus.size();
+  std::string output;
+  Parsed parsed;
+  size_t valid = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (const std::string& spec : corpus) {
+      valid += CanonicalizeToString(spec.data(),
+                                    static_cast<int>(spec.length()), true,
+                                    nullptr, &output, &parsed);
+    }
+  }
+  PrintResult("CanonicalizeToString", corpus_name,
+              base::TimeTicks::Now() - start, rounds * corpus.size());
+  EXPECT_EQ(rounds * corpus.size(), valid);
+}
+
+}  // namespace
+
+TEST(URLCanonPerfTest, CanonicalURLs) {
+  const std::vector<std::string> corpus =
+      MakeCorpus(kCanonicalURLs, arraysize(kCanonicalURLs));
+  MeasureGURL("canonical", corpus);
+  MeasureCanonicalizeToString("canonical", corpus);
+}
+
+TEST(URLCanonPerfTest, NonCanonicalURLs) {
+  const std::vector<std::string> corpus =
+      MakeCorpus(kNonCanonicalURLs, arraysize(kNonCanonicalURLs));
+  MeasureGURL("non_canonical", corpus);
+  MeasureCanonicalizeToString("non_canonical", corpus);
+}
+
+TEST(URLCanonPerfTest, CopyGURL) {
+  std::vector<GURL> urls;
+  for (const char* spec : kCanonicalURLs)
+    urls.push_back(GURL(spec));
+
+  const size_t rounds = kURLsPerMeasurement / urls.size();
+  size_t total_length = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (const GURL& url : urls) {
+      GURL copy(url);
+      total_length += copy.spec().length();
+    }
+  }
+  PrintResult("GURL_copy", "canonical", base::TimeTicks::Now() - start,
+              rounds * urls.size());
+  EXPECT_LT(0u, total_length);
+}
+
+}  // namespace url
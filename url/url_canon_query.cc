@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "url/url_canon.h"
 #include "url/url_canon_internal.h"
 
@@ -39,16 +41,14 @@ namespace url {
 
 namespace {
 
-// Returns true if the characters starting at |begin| and going until |end|
-// (non-inclusive) are all representable in 7-bits.
-template<typename CHAR, typename UCHAR>
-bool IsAllASCII(const CHAR* spec, const Component& query) {
-  int end = query.end();
-  for (int i = query.begin; i < end; i++) {
-    if (static_cast<UCHAR>(spec[i]) >= 0x80)
-      return false;
-  }
-  return true;
+// Returns true if the characters of |query| are all representable in 7-bits.
+// base::IsStringASCII() checks a machine word at a time.
+bool IsAllASCII(const char* spec, const Component& query) {
+  return base::IsStringASCII(base::StringPiece(&spec[query.begin], query.len));
+}
+bool IsAllASCII(const base::char16* spec, const Component& query) {
+  return base::IsStringASCII(
+      base::StringPiece16(&spec[query.begin], query.len));
 }
 
 // Appends the given string to the output, escaping characters that do not
@@ -58,11 +58,19 @@ bool IsAllASCII(const CHAR* spec, const Component& query) {
 template<typename CHAR>
 void AppendRaw8BitQueryString(const CHAR* source, int length,
                               CanonOutput* output) {
-  for (int i = 0; i < length; i++) {
-    if (!IsQueryChar(static_cast<unsigned char>(source[i])))
+  int i = 0;
+  while (i < length) {
+    // Copy the run of characters that don't need escaping, which is usually
+    // the whole query, in one go.
+    int run_begin = i;
+    while (i < length && IsQueryChar(static_cast<unsigned char>(source[i])))
+      i++;
+    AppendASCIIRun(&source[run_begin], i - run_begin, output);
+
+    if (i < length) {
       AppendEscapedChar(static_cast<unsigned char>(source[i]), output);
-    else  // Doesn't need escaping.
-      output->push_back(static_cast<char>(source[i]));
+      i++;
+    }
   }
 }
 
@@ -94,7 +102,7 @@ void DoConvertToQueryEncoding(const CHAR* spec,
                               const Component& query,
                               CharsetConverter* converter,
                               CanonOutput* output) {
-  if (IsAllASCII<CHAR, UCHAR>(spec, query)) {
+  if (IsAllASCII(spec, query)) {
     // Easy: the input can just appended with no character set conversions.
     AppendRaw8BitQueryString(&spec[query.begin], query.len, output);
 
@@ -4,8 +4,30 @@
 
 #include "url/url_canon_stdstring.h"
 
+#include "url/url_util.h"
+
 namespace url {
 
+namespace {
+
+template <typename CHAR>
+bool DoCanonicalizeToString(const CHAR* spec,
+                            int spec_len,
+                            bool trim_path_end,
+                            CharsetConverter* charset_converter,
+                            std::string* output,
+                            Parsed* output_parsed) {
+  // clear() keeps the capacity, which StdStringCanonOutput then writes into.
+  output->clear();
+  StdStringCanonOutput canon_output(output);
+  bool success = Canonicalize(spec, spec_len, trim_path_end, charset_converter,
+                              &canon_output, output_parsed);
+  canon_output.Complete();
+  return success;
+}
+
+}  // namespace
+
 StdStringCanonOutput::StdStringCanonOutput(std::string* str)
     : CanonOutput(), str_(str) {
   cur_len_ = static_cast<int>(str_->size());  // Append to existing data.
@@ -29,4 +51,24 @@ void StdStringCanonOutput::Resize(int sz) {
   buffer_len_ = sz;
 }
 
+bool CanonicalizeToString(const char* spec,
+                          int spec_len,
+                          bool trim_path_end,
+                          CharsetConverter* charset_converter,
+                          std::string* output,
+                          Parsed* output_parsed) {
+  return DoCanonicalizeToString(spec, spec_len, trim_path_end,
+                                charset_converter, output, output_parsed);
+}
+
+bool CanonicalizeToString(const base::char16* spec,
+                          int spec_len,
+                          bool trim_path_end,
+                          CharsetConverter* charset_converter,
+                          std::string* output,
+                          Parsed* output_parsed) {
+  return DoCanonicalizeToString(spec, spec_len, trim_path_end,
+                                charset_converter, output, output_parsed);
+}
+
 }  // namespace url
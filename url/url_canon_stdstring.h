@@ -48,6 +48,24 @@ class URL_EXPORT StdStringCanonOutput : public CanonOutput {
   std::string* str_;
 };
 
+// Canonicalizes |spec| like url::Canonicalize() does, replacing the contents
+// of |*output| with the canonical spec. The memory |*output| already holds is
+// reused, so callers that canonicalize many URLs into one string don't
+// allocate once it's large enough. Canonicalizing an already-canonical spec
+// into a string with at least its length in capacity never allocates.
+URL_EXPORT bool CanonicalizeToString(const char* spec,
+                                     int spec_len,
+                                     bool trim_path_end,
+                                     CharsetConverter* charset_converter,
+                                     std::string* output,
+                                     Parsed* output_parsed);
+URL_EXPORT bool CanonicalizeToString(const base::char16* spec,
+                                     int spec_len,
+                                     bool trim_path_end,
+                                     CharsetConverter* charset_converter,
+                                     std::string* output,
+                                     Parsed* output_parsed);
+
 // An extension of the Replacements class that allows the setters to use
 // StringPieces (implicitly allowing strings or char*s).
 //
@@ -2172,4 +2172,38 @@ TEST(URLCanonTest, ReplacementOverflow) {
   EXPECT_TRUE(expected == repl_str);
 }
 
+TEST(URLCanonTest, CanonicalizeToString) {
+  std::string output;
+  Parsed parsed;
+  const char kNonCanonical[] = "HTTP://www.Google.com:80/a/../b";
+  EXPECT_TRUE(CanonicalizeToString(kNonCanonical,
+                                   static_cast<int>(strlen(kNonCanonical)),
+                                   true, NULL, &output, &parsed));
+  EXPECT_EQ("http://www.google.com/b", output);
+  EXPECT_EQ("www.google.com", output.substr(parsed.host.begin,
+                                            parsed.host.len));
+
+  // The previous contents are replaced, and an already-canonical spec that
+  // fits is written into the existing buffer.
+  output.reserve(64);
+  const char* buffer = output.data();
+  const char kCanonical[] = "https://example.com/path?query#ref";
+  EXPECT_TRUE(CanonicalizeToString(kCanonical,
+                                   static_cast<int>(strlen(kCanonical)),
+                                   true, NULL, &output, &parsed));
+  EXPECT_EQ(kCanonical, output);
+  EXPECT_EQ(buffer, output.data());
+
+  base::string16 input16(WStringToUTF16(L"http://www.google.com/\\x"));
+  EXPECT_TRUE(CanonicalizeToString(input16.data(),
+                                   static_cast<int>(input16.length()), true,
+                                   NULL, &output, &parsed));
+  EXPECT_EQ("http://www.google.com//x", output);
+
+  const char kInvalid[] = "http://a:b:c/";
+  EXPECT_FALSE(CanonicalizeToString(kInvalid,
+                                    static_cast<int>(strlen(kInvalid)), true,
+                                    NULL, &output, &parsed));
+}
+
 }  // namespace url